@@ -107,6 +107,9 @@ check_type(string char16_t HAVE_CHAR16_T)
 check_type(string char32_t HAVE_CHAR32_T)
 check_type(stdint.h uint_least16_t HAVE_STDINT_H)
 check_symbol_exists(posix_fadvise fcntl.h HAVE_POSIX_FADVISE)
+set(CMAKE_REQUIRED_DEFINITIONS -D_GNU_SOURCE)
+check_symbol_exists(sync_file_range fcntl.h HAVE_SYNC_FILE_RANGE)
+unset(CMAKE_REQUIRED_DEFINITIONS)
 check_symbol_exists(PRIdMAX inttypes.h HAVE_INTTYPES_H)
 check_builtin("long* temp=0; long ret=__sync_add_and_fetch(temp, 1)" HAS_BUILTIN_SYNC_ADD_AND_FETCH)
 check_builtin("long* temp=0; long ret=__sync_sub_and_fetch(temp, 1)" HAS_BUILTIN_SYNC_SUB_AND_FETCH)
@@ -118,6 +121,9 @@ endif()
 if(HAVE_POSIX_FADVISE)
   list(APPEND SYSTEM_DEFINES -DHAVE_POSIX_FADVISE=1)
 endif()
+if(HAVE_SYNC_FILE_RANGE)
+  list(APPEND SYSTEM_DEFINES -DHAVE_SYNC_FILE_RANGE=1)
+endif()
 check_function_exists(localtime_r HAVE_LOCALTIME_R)
 if(HAVE_LOCALTIME_R)
   list(APPEND SYSTEM_DEFINES -DHAVE_LOCALTIME_R=1)
@@ -993,6 +993,18 @@ CP_C_API void cp_unregister_pcollection(cp_context_t *ctx, const char *dir) CP_G
  */
 CP_C_API void cp_unregister_pcollections(cp_context_t *ctx) CP_GCC_NONNULL(1);
 
+/**
+ * Sets the file that caches the plug-in descriptors found by
+ * ::cp_scan_plugins. A scan then only parses the descriptors whose file
+ * changed since the previous scan and rewrites the cache if anything
+ * changed. The cache is ignored if it was written by another version.
+ *
+ * @param ctx the plug-in context
+ * @param file the cache file, or NULL to disable the cache
+ * @return @ref CP_OK (zero) on success or @ref CP_ERR_RESOURCE if insufficient memory
+ */
+CP_C_API cp_status_t cp_set_plugin_cache(cp_context_t *ctx, const char *file) CP_GCC_NONNULL(1);
+
 /*@}*/
 
 
@@ -123,6 +123,7 @@ extern "C" {
 
 typedef struct cp_plugin_t cp_plugin_t;
 typedef struct cp_plugin_env_t cp_plugin_env_t;
+typedef struct cpi_pcache_t cpi_pcache_t;
 
 // Plug-in context
 struct cp_context_t {
@@ -172,6 +173,9 @@ struct cp_plugin_env_t {
 	/// List of registered plug-in directories 
 	list_t *plugin_dirs;
 
+	/// Plug-in descriptor cache file or NULL if not used
+	char *pcache_file;
+
 	/// Map of in-use reference counter information object
 	hash_t *infos;
 
@@ -557,6 +561,41 @@ CP_HIDDEN void cpi_release_info(cp_context_t *ctx, void *res) CP_GCC_NONNULL(1,
 CP_HIDDEN void cpi_release_infos(cp_context_t *ctx) CP_GCC_NONNULL(1);
 
 
+// Plug-in descriptor cache
+
+/**
+ * Opens the plug-in descriptor cache for a scan. The caller must have
+ * locked the plug-in context.
+ * 
+ * @param ctx the plug-in context
+ * @param file the cache file, which need not exist
+ * @return the cache or NULL if insufficient memory
+ */
+CP_HIDDEN cpi_pcache_t *cpi_open_pcache(cp_context_t *ctx, const char *file) CP_GCC_NONNULL(1, 2);
+
+/**
+ * Loads a plug-in descriptor like ::cp_load_plugin_descriptor, taking it
+ * from the cache if the descriptor file did not change since it was cached.
+ * The caller must have locked the plug-in context.
+ * 
+ * @param ctx the plug-in context
+ * @param cache the cache
+ * @param path the installation path of the plug-in
+ * @param status pointer to the location where status code is to be stored, or NULL
+ * @return pointer to the information structure or NULL on failure
+ */
+CP_HIDDEN cp_plugin_info_t *cpi_pcache_load_descriptor(cp_context_t *ctx, cpi_pcache_t *cache, const char *path, cp_status_t *status) CP_GCC_NONNULL(1, 2, 3);
+
+/**
+ * Closes the cache, writing it if the loaded descriptors differ from the
+ * cached ones. The caller must have locked the plug-in context.
+ * 
+ * @param ctx the plug-in context
+ * @param cache the cache
+ */
+CP_HIDDEN void cpi_close_pcache(cp_context_t *ctx, cpi_pcache_t *cache) CP_GCC_NONNULL(1, 2);
+
+
 // Serialized execution
 
 /**
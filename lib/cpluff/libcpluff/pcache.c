@@ -0,0 +1,720 @@
+/*-------------------------------------------------------------------------
+ * C-Pluff, a plug-in framework for C
+ * Copyright 2007 Johannes Lehtinen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *-----------------------------------------------------------------------*/
+
+/** @file
+ * Plug-in descriptor cache
+ *
+ * The cache file holds the parsed descriptors of the last scan together
+ * with the modification time and size of their descriptor files, so that a
+ * scan only parses the descriptors that changed since. The records are
+ * written in native byte order, a cache of another version or platform is
+ * ignored and rewritten.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "cpluff.h"
+#include "defines.h"
+#include "util.h"
+#include "internal.h"
+#if defined(_WIN32)
+#include "win32_utils.h"
+#endif
+
+
+/* ------------------------------------------------------------------------
+ * Constants
+ * ----------------------------------------------------------------------*/
+
+/// Cache file magic number, also detects a foreign byte order
+#define CP_PCACHE_MAGIC 0x58495043
+
+/// Cache format version, to be increased whenever the record layout changes
+#define CP_PCACHE_VERSION 1
+
+/// Serialized NULL string
+#define CP_PCACHE_NULL_STR UINT32_MAX
+
+/// Plugin descriptor name
+#define CP_PLUGIN_DESCRIPTOR "addon.xml"
+
+
+/* ------------------------------------------------------------------------
+ * Internal data types
+ * ----------------------------------------------------------------------*/
+
+/// A growing output buffer
+typedef struct pcache_buffer_t {
+	char *data;
+	size_t size;
+	size_t capacity;
+	int error;
+} pcache_buffer_t;
+
+/// A bounds checked input position
+typedef struct pcache_reader_t {
+	const char *pos;
+	const char *end;
+	int error;
+} pcache_reader_t;
+
+/// A descriptor record of the loaded cache file
+typedef struct pcache_entry_t {
+	char *path;
+	int64_t mtime;
+	int64_t size;
+
+	/// The whole record, copied as is when still valid
+	const char *record;
+	size_t record_size;
+
+	/// The serialized plug-in information within the record
+	const char *plugin;
+	size_t plugin_size;
+} pcache_entry_t;
+
+struct cpi_pcache_t {
+
+	/// The cache file
+	char *file;
+
+	/// Contents of the cache file, or NULL if there was none
+	char *data;
+	size_t data_size;
+
+	/// Maps plug-in directories to cache entries
+	hash_t *entries;
+
+	/// The cache file written by cpi_close_pcache
+	pcache_buffer_t out;
+
+	/// Number of descriptors taken from the cache and parsed
+	int hits;
+	int misses;
+};
+
+
+/* ------------------------------------------------------------------------
+ * Function definitions
+ * ----------------------------------------------------------------------*/
+
+// Serialization
+
+static void put_bytes(pcache_buffer_t *b, const void *src, size_t n) {
+	if (b->error) {
+		return;
+	}
+	if (b->size + n > b->capacity) {
+		size_t capacity = b->capacity ? b->capacity : 4096;
+		char *data;
+
+		while (capacity < b->size + n) {
+			capacity *= 2;
+		}
+		if ((data = realloc(b->data, capacity)) == NULL) {
+			b->error = 1;
+			return;
+		}
+		b->data = data;
+		b->capacity = capacity;
+	}
+	memcpy(b->data + b->size, src, n);
+	b->size += n;
+}
+
+static void put_uint(pcache_buffer_t *b, uint32_t v) {
+	put_bytes(b, &v, sizeof(v));
+}
+
+static void put_int64(pcache_buffer_t *b, int64_t v) {
+	put_bytes(b, &v, sizeof(v));
+}
+
+static void put_str(pcache_buffer_t *b, const char *s) {
+	if (s == NULL) {
+		put_uint(b, CP_PCACHE_NULL_STR);
+	} else {
+		size_t len = strlen(s);
+
+		put_uint(b, (uint32_t) len);
+		put_bytes(b, s, len);
+	}
+}
+
+static void put_cfg_element(pcache_buffer_t *b, const cp_cfg_element_t *ce) {
+	unsigned int i;
+
+	put_str(b, ce->name);
+	put_uint(b, ce->num_atts);
+	if (ce->num_atts > 0) {
+		size_t size = 0;
+
+		// Attribute names and values as one block, like the loader keeps them
+		for (i = 0; i < ce->num_atts * 2; i++) {
+			size += strlen(ce->atts[i]) + 1;
+		}
+		put_uint(b, (uint32_t) size);
+		for (i = 0; i < ce->num_atts * 2; i++) {
+			put_bytes(b, ce->atts[i], strlen(ce->atts[i]) + 1);
+		}
+	}
+	put_str(b, ce->value);
+	put_uint(b, ce->num_children);
+	for (i = 0; i < ce->num_children; i++) {
+		put_cfg_element(b, ce->children + i);
+	}
+}
+
+static void put_plugin(pcache_buffer_t *b, const cp_plugin_info_t *plugin) {
+	unsigned int i;
+
+	put_str(b, plugin->identifier);
+	put_str(b, plugin->name);
+	put_str(b, plugin->version);
+	put_str(b, plugin->provider_name);
+	put_str(b, plugin->plugin_path);
+	put_str(b, plugin->abi_bw_compatibility);
+	put_str(b, plugin->api_bw_compatibility);
+	put_str(b, plugin->req_cpluff_version);
+	put_uint(b, plugin->num_imports);
+	for (i = 0; i < plugin->num_imports; i++) {
+		put_str(b, plugin->imports[i].plugin_id);
+		put_str(b, plugin->imports[i].version);
+		put_uint(b, (uint32_t) plugin->imports[i].optional);
+	}
+	put_str(b, plugin->runtime_lib_name);
+	put_str(b, plugin->runtime_funcs_symbol);
+	put_uint(b, plugin->num_ext_points);
+	for (i = 0; i < plugin->num_ext_points; i++) {
+		put_str(b, plugin->ext_points[i].local_id);
+		put_str(b, plugin->ext_points[i].identifier);
+		put_str(b, plugin->ext_points[i].name);
+		put_str(b, plugin->ext_points[i].schema_path);
+	}
+	put_uint(b, plugin->num_extensions);
+	for (i = 0; i < plugin->num_extensions; i++) {
+		put_str(b, plugin->extensions[i].ext_point_id);
+		put_str(b, plugin->extensions[i].local_id);
+		put_str(b, plugin->extensions[i].identifier);
+		put_str(b, plugin->extensions[i].name);
+		put_uint(b, plugin->extensions[i].configuration != NULL);
+		if (plugin->extensions[i].configuration != NULL) {
+			put_cfg_element(b, plugin->extensions[i].configuration);
+		}
+	}
+}
+
+
+// Deserialization
+
+static void get_bytes(pcache_reader_t *r, void *dst, size_t n) {
+	if (r->error || (size_t) (r->end - r->pos) < n) {
+		r->error = 1;
+		memset(dst, 0, n);
+		return;
+	}
+	memcpy(dst, r->pos, n);
+	r->pos += n;
+}
+
+static uint32_t get_uint(pcache_reader_t *r) {
+	uint32_t v;
+
+	get_bytes(r, &v, sizeof(v));
+	return v;
+}
+
+static int64_t get_int64(pcache_reader_t *r) {
+	int64_t v;
+
+	get_bytes(r, &v, sizeof(v));
+	return v;
+}
+
+static char *get_str(pcache_reader_t *r) {
+	uint32_t len;
+	char *s;
+
+	len = get_uint(r);
+	if (r->error || len == CP_PCACHE_NULL_STR) {
+		return NULL;
+	}
+	if ((size_t) (r->end - r->pos) < len || (s = malloc(len + 1)) == NULL) {
+		r->error = 1;
+		return NULL;
+	}
+	memcpy(s, r->pos, len);
+	s[len] = '\0';
+	r->pos += len;
+	return s;
+}
+
+/**
+ * Reads the number of elements of an array that follows. Every element
+ * takes at least one byte, which bounds the allocation for broken data.
+ */
+static uint32_t get_count(pcache_reader_t *r) {
+	uint32_t n;
+
+	n = get_uint(r);
+	if (!r->error && n > (size_t) (r->end - r->pos)) {
+		r->error = 1;
+	}
+	return r->error ? 0 : n;
+}
+
+static void get_cfg_element(pcache_reader_t *r, cp_cfg_element_t *ce, cp_cfg_element_t *parent, unsigned int index) {
+	uint32_t n;
+
+	memset(ce, 0, sizeof(cp_cfg_element_t));
+	ce->parent = parent;
+	ce->index = index;
+	ce->name = get_str(r);
+	n = get_count(r);
+	if (n > 0) {
+		uint32_t size = get_count(r);
+		char *data = NULL;
+		uint32_t i, offset;
+
+		if (r->error || size == 0
+			|| (ce->atts = calloc(n * 2, sizeof(char *))) == NULL
+			|| (data = malloc(size)) == NULL) {
+			r->error = 1;
+			return;
+		}
+		get_bytes(r, data, size);
+		ce->atts[0] = data;
+		ce->num_atts = n;
+		if (r->error || data[size - 1] != '\0') {
+			r->error = 1;
+			return;
+		}
+		for (i = 0, offset = 0; i < n * 2; i++) {
+			if (offset >= size) {
+				r->error = 1;
+				return;
+			}
+			ce->atts[i] = data + offset;
+			offset += strlen(data + offset) + 1;
+		}
+	}
+	ce->value = get_str(r);
+	n = get_count(r);
+	if (n > 0) {
+		uint32_t i;
+
+		if ((ce->children = calloc(n, sizeof(cp_cfg_element_t))) == NULL) {
+			r->error = 1;
+			return;
+		}
+		for (i = 0; i < n && !r->error; i++) {
+			ce->num_children = i + 1;
+			get_cfg_element(r, ce->children + i, ce, i);
+		}
+	}
+}
+
+static cp_plugin_info_t *get_plugin(pcache_reader_t *r) {
+	cp_plugin_info_t *plugin;
+	uint32_t i, n;
+
+	if ((plugin = calloc(1, sizeof(cp_plugin_info_t))) == NULL) {
+		return NULL;
+	}
+	plugin->identifier = get_str(r);
+	plugin->name = get_str(r);
+	plugin->version = get_str(r);
+	plugin->provider_name = get_str(r);
+	plugin->plugin_path = get_str(r);
+	plugin->abi_bw_compatibility = get_str(r);
+	plugin->api_bw_compatibility = get_str(r);
+	plugin->req_cpluff_version = get_str(r);
+	if ((n = get_count(r)) > 0) {
+		if ((plugin->imports = calloc(n, sizeof(cp_plugin_import_t))) == NULL) {
+			r->error = 1;
+		} else {
+			plugin->num_imports = n;
+		}
+		for (i = 0; i < plugin->num_imports; i++) {
+			plugin->imports[i].plugin_id = get_str(r);
+			plugin->imports[i].version = get_str(r);
+			plugin->imports[i].optional = (int) get_uint(r);
+		}
+	}
+	plugin->runtime_lib_name = get_str(r);
+	plugin->runtime_funcs_symbol = get_str(r);
+	if ((n = get_count(r)) > 0) {
+		if ((plugin->ext_points = calloc(n, sizeof(cp_ext_point_t))) == NULL) {
+			r->error = 1;
+		} else {
+			plugin->num_ext_points = n;
+		}
+		for (i = 0; i < plugin->num_ext_points; i++) {
+			plugin->ext_points[i].plugin = plugin;
+			plugin->ext_points[i].local_id = get_str(r);
+			plugin->ext_points[i].identifier = get_str(r);
+			plugin->ext_points[i].name = get_str(r);
+			plugin->ext_points[i].schema_path = get_str(r);
+		}
+	}
+	if ((n = get_count(r)) > 0) {
+		if ((plugin->extensions = calloc(n, sizeof(cp_extension_t))) == NULL) {
+			r->error = 1;
+		} else {
+			plugin->num_extensions = n;
+		}
+		for (i = 0; i < plugin->num_extensions && !r->error; i++) {
+			cp_extension_t *ext = plugin->extensions + i;
+
+			ext->plugin = plugin;
+			ext->ext_point_id = get_str(r);
+			ext->local_id = get_str(r);
+			ext->identifier = get_str(r);
+			ext->name = get_str(r);
+			if (get_uint(r) && !r->error) {
+				if ((ext->configuration = malloc(sizeof(cp_cfg_element_t))) == NULL) {
+					r->error = 1;
+				} else {
+					get_cfg_element(r, ext->configuration, NULL, 0);
+				}
+			}
+		}
+	}
+
+	// Mandatory fields, as checked by the loader
+	if (!r->error && (plugin->identifier == NULL || plugin->plugin_path == NULL)) {
+		r->error = 1;
+	}
+	if (r->error || r->pos != r->end) {
+		cpi_free_plugin(plugin);
+		return NULL;
+	}
+	return plugin;
+}
+
+
+// Cache file
+
+static FILE *open_file(const char *file, const char *mode) {
+#if defined(_WIN32)
+	wchar_t *fileW = to_utf16(file, 0);
+	wchar_t *modeW = to_utf16(mode, 0);
+	FILE *fh = _wfopen(fileW, modeW);
+
+	free(fileW);
+	free(modeW);
+	return fh;
+#else
+	return fopen(file, mode);
+#endif
+}
+
+static int replace_file(const char *from, const char *to) {
+#if defined(_WIN32)
+	wchar_t *fromW = to_utf16(from, 0);
+	wchar_t *toW = to_utf16(to, 0);
+	int result;
+
+	_wremove(toW);
+	result = _wrename(fromW, toW);
+	free(fromW);
+	free(toW);
+	return result;
+#else
+	return rename(from, to);
+#endif
+}
+
+/**
+ * Gets the modification time and size of the descriptor file in the
+ * specified plug-in directory.
+ *
+ * @return non-zero on success
+ */
+static int stat_descriptor(const char *path, int64_t *mtime, int64_t *size) {
+	size_t path_len = strlen(path);
+	char *file;
+	int result;
+
+	if ((file = malloc(path_len + strlen(CP_PLUGIN_DESCRIPTOR) + 2)) == NULL) {
+		return 0;
+	}
+	strcpy(file, path);
+	file[path_len] = CP_FNAMESEP_CHAR;
+	strcpy(file + path_len + 1, CP_PLUGIN_DESCRIPTOR);
+#if defined(_WIN32)
+	{
+		wchar_t *fileW = to_utf16(file, 0);
+		struct _stat64 st;
+
+		result = _wstat64(fileW, &st) == 0;
+		free(fileW);
+		if (result) {
+			*mtime = (int64_t) st.st_mtime;
+			*size = (int64_t) st.st_size;
+		}
+	}
+#else
+	{
+		struct stat st;
+
+		result = stat(file, &st) == 0;
+		if (result) {
+			*mtime = (int64_t) st.st_mtime;
+			*size = (int64_t) st.st_size;
+		}
+	}
+#endif
+	free(file);
+	return result;
+}
+
+static void free_entries(hash_t *entries) {
+	hscan_t scan;
+	hnode_t *node;
+
+	hash_scan_begin(&scan, entries);
+	while ((node = hash_scan_next(&scan)) != NULL) {
+		pcache_entry_t *entry = hnode_get(node);
+
+		hash_scan_delfree(entries, node);
+		free(entry->path);
+		free(entry);
+	}
+	hash_destroy(entries);
+}
+
+/**
+ * Indexes the records of the loaded cache file. Stops at the first broken
+ * record, the descriptors of the following ones are parsed again.
+ */
+static void index_cache(cp_context_t *context, cpi_pcache_t *cache) {
+	pcache_reader_t r;
+
+	r.pos = cache->data;
+	r.end = cache->data + cache->data_size;
+	r.error = 0;
+	if (get_uint(&r) != CP_PCACHE_MAGIC || get_uint(&r) != CP_PCACHE_VERSION) {
+		cpi_infof(context, N_("Ignoring plug-in descriptor cache %s of another version."), cache->file);
+		return;
+	}
+	while (!r.error && r.pos < r.end) {
+		pcache_entry_t *entry;
+		const char *record = r.pos;
+		uint32_t size;
+
+		size = get_count(&r);
+		if (r.error || (entry = calloc(1, sizeof(pcache_entry_t))) == NULL) {
+			break;
+		}
+		entry->record = record;
+		entry->record_size = sizeof(uint32_t) + size;
+		r.end = r.pos + size;
+		entry->path = get_str(&r);
+		entry->mtime = get_int64(&r);
+		entry->size = get_int64(&r);
+		entry->plugin = r.pos;
+		entry->plugin_size = r.error ? 0 : (size_t) (r.end - r.pos);
+		if (r.error || entry->path == NULL
+			|| hash_lookup(cache->entries, entry->path) != NULL
+			|| !hash_alloc_insert(cache->entries, entry->path, entry)) {
+			free(entry->path);
+			free(entry);
+			break;
+		}
+		r.pos = r.end;
+		r.end = cache->data + cache->data_size;
+	}
+}
+
+CP_HIDDEN cpi_pcache_t *cpi_open_pcache(cp_context_t *context, const char *file) {
+	cpi_pcache_t *cache;
+	FILE *fh;
+
+	assert(context != NULL);
+	assert(file != NULL);
+	if ((cache = calloc(1, sizeof(cpi_pcache_t))) == NULL) {
+		return NULL;
+	}
+	if ((cache->file = strdup(file)) == NULL
+		|| (cache->entries = hash_create(HASHCOUNT_T_MAX, (int (*)(const void *, const void *)) strcmp, NULL)) == NULL) {
+		free(cache->file);
+		free(cache);
+		return NULL;
+	}
+
+	// Load the cache file, a missing one is simply empty
+	if ((fh = open_file(file, "rb")) != NULL) {
+		long size;
+
+		if (fseek(fh, 0, SEEK_END) == 0 && (size = ftell(fh)) > 0
+			&& fseek(fh, 0, SEEK_SET) == 0
+			&& (cache->data = malloc(size)) != NULL) {
+			if (fread(cache->data, 1, size, fh) == (size_t) size) {
+				cache->data_size = size;
+				index_cache(context, cache);
+			}
+		}
+		fclose(fh);
+	}
+
+	put_uint(&cache->out, CP_PCACHE_MAGIC);
+	put_uint(&cache->out, CP_PCACHE_VERSION);
+	return cache;
+}
+
+static void dealloc_plugin_info(cp_context_t *ctx, cp_plugin_info_t *plugin) {
+	cpi_free_plugin(plugin);
+}
+
+CP_HIDDEN cp_plugin_info_t *cpi_pcache_load_descriptor(cp_context_t *context, cpi_pcache_t *cache, const char *path, cp_status_t *error) {
+	cp_plugin_info_t *plugin = NULL;
+	pcache_entry_t *entry = NULL;
+	hnode_t *node;
+	int64_t mtime, size;
+	size_t record;
+
+	assert(context != NULL);
+	assert(cache != NULL);
+	assert(path != NULL);
+
+	// Let the loader report missing descriptors
+	if (!stat_descriptor(path, &mtime, &size)) {
+		return cp_load_plugin_descriptor(context, path, error);
+	}
+
+	// Take the descriptor from the cache if it did not change
+	if ((node = hash_lookup(cache->entries, path)) != NULL) {
+		entry = hnode_get(node);
+	}
+	if (entry != NULL && entry->mtime == mtime && entry->size == size) {
+		pcache_reader_t r;
+
+		r.pos = entry->plugin;
+		r.end = entry->plugin + entry->plugin_size;
+		r.error = 0;
+		if ((plugin = get_plugin(&r)) != NULL) {
+			cp_status_t status;
+
+			status = cpi_register_info(context, plugin, (void (*)(cp_context_t *, void *)) dealloc_plugin_info);
+			if (status != CP_OK) {
+				cpi_free_plugin(plugin);
+				if (error != NULL) {
+					*error = status;
+				}
+				return NULL;
+			}
+			put_bytes(&cache->out, entry->record, entry->record_size);
+			cache->hits++;
+			if (error != NULL) {
+				*error = CP_OK;
+			}
+			return plugin;
+		}
+		cpi_warnf(context, N_("Ignoring broken cache entry of the plug-in descriptor in %s."), path);
+	}
+
+	// Otherwise parse it and add it to the cache
+	if ((plugin = cp_load_plugin_descriptor(context, path, error)) == NULL) {
+		return NULL;
+	}
+	cache->misses++;
+	record = cache->out.size;
+	put_uint(&cache->out, 0);
+	put_str(&cache->out, path);
+	put_int64(&cache->out, mtime);
+	put_int64(&cache->out, size);
+	put_plugin(&cache->out, plugin);
+	if (!cache->out.error) {
+		uint32_t record_size = (uint32_t) (cache->out.size - record - sizeof(uint32_t));
+
+		memcpy(cache->out.data + record, &record_size, sizeof(record_size));
+	}
+	return plugin;
+}
+
+CP_HIDDEN void cpi_close_pcache(cp_context_t *context, cpi_pcache_t *cache) {
+	assert(context != NULL);
+	assert(cache != NULL);
+
+	cpi_infof(context, N_("Loaded %d of %d plug-in descriptors from the cache %s."),
+		cache->hits, cache->hits + cache->misses, cache->file);
+
+	// Rewrite the cache file if anything changed, including removed plug-ins
+	if (!cache->out.error
+		&& (cache->out.size != cache->data_size
+			|| memcmp(cache->out.data, cache->data, cache->data_size) != 0)) {
+		char *tmp;
+		FILE *fh = NULL;
+		int written = 0;
+
+		if ((tmp = malloc(strlen(cache->file) + 5)) != NULL) {
+			strcpy(tmp, cache->file);
+			strcat(tmp, ".tmp");
+			if ((fh = open_file(tmp, "wb")) != NULL) {
+				written = fwrite(cache->out.data, 1, cache->out.size, fh) == cache->out.size;
+				written = fclose(fh) == 0 && written;
+				written = written && replace_file(tmp, cache->file) == 0;
+			}
+			if (!written) {
+				cpi_warnf(context, N_("Could not write the plug-in descriptor cache %s."), cache->file);
+				remove(tmp);
+			}
+			free(tmp);
+		}
+	}
+
+	free_entries(cache->entries);
+	free(cache->out.data);
+	free(cache->data);
+	free(cache->file);
+	free(cache);
+}
+
+CP_C_API cp_status_t cp_set_plugin_cache(cp_context_t *context, const char *file) {
+	char *f = NULL;
+
+	CHECK_NOT_NULL(context);
+
+	if (file != NULL && (f = strdup(file)) == NULL) {
+		cpi_lock_context(context);
+		cpi_errorf(context, N_("The plug-in descriptor cache %s could not be set due to insufficient memory."), file);
+		cpi_unlock_context(context);
+		return CP_ERR_RESOURCE;
+	}
+	cpi_lock_context(context);
+	cpi_check_invocation(context, CPI_CF_ANY, __func__);
+	free(context->env->pcache_file);
+	context->env->pcache_file = f;
+	cpi_unlock_context(context);
+	return CP_OK;
+}
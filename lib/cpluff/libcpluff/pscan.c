@@ -49,6 +49,7 @@
 
 CP_C_API cp_status_t cp_scan_plugins(cp_context_t *context, int flags) {
 	hash_t *avail_plugins = NULL;
+	cpi_pcache_t *pcache = NULL;
 	list_t *started_plugins = NULL;
 	cp_plugin_info_t **plugins = NULL;
 	char *pdir_path = NULL;
@@ -72,6 +73,11 @@ CP_C_API cp_status_t cp_scan_plugins(cp_context_t *context, int flags) {
 			break;
 		}
 	
+		// Use the descriptor cache, if any
+		if (context->env->pcache_file != NULL) {
+			pcache = cpi_open_pcache(context, context->env->pcache_file);
+		}
+	
 		// Scan plug-in directories for available plug-ins 
 		lnode = list_first(context->env->plugin_dirs);
 		while (lnode != NULL) {
@@ -122,7 +128,11 @@ CP_C_API cp_status_t cp_scan_plugins(cp_context_t *context, int flags) {
 						strcpy(pdir_path + dir_path_len + 1, de->d_name);
 							
 						// Try to load a plug-in 
-						plugin = cp_load_plugin_descriptor(context, pdir_path, &s);
+						if (pcache != NULL) {
+							plugin = cpi_pcache_load_descriptor(context, pcache, pdir_path, &s);
+						} else {
+							plugin = cp_load_plugin_descriptor(context, pdir_path, &s);
+						}
 						if (plugin == NULL) {
 							status = s;
 							// continue loading plug-ins from other directories 
@@ -165,6 +175,10 @@ CP_C_API cp_status_t cp_scan_plugins(cp_context_t *context, int flags) {
 			
 			lnode = list_next(context->env->plugin_dirs, lnode);
 		}
+		if (pcache != NULL) {
+			cpi_close_pcache(context, pcache);
+			pcache = NULL;
+		}
 		
 		// Copy the list of started plug-ins, if necessary 
 		if ((flags & CP_SP_RESTART_ACTIVE)
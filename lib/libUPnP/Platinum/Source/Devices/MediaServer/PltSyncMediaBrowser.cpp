@@ -40,6 +40,14 @@
 
 NPT_SET_LOCAL_LOGGER("platinum.media.server.syncbrowser")
 
+/*----------------------------------------------------------------------
+|   constants
++---------------------------------------------------------------------*/
+// DLNA recommendations for browsing children is no more than 30 at a time
+#define PLT_SYNC_BROWSE_CHUNK_SIZE   200
+// chunks asked for at once once the number of children is known
+#define PLT_SYNC_BROWSE_MAX_REQUESTS 4
+
 /*----------------------------------------------------------------------
 |   PLT_SyncMediaBrowser::PLT_SyncMediaBrowser
 +---------------------------------------------------------------------*/
@@ -228,6 +236,14 @@ PLT_SyncMediaBrowser::OnMSStateVariablesChanged(PLT_Service*                  se
 
     device = (*it)->GetValue();
     PLT_StateVariable* var = PLT_StateVariable::Find(*vars, "ContainerUpdateIDs");
+    if (!var && PLT_StateVariable::Find(*vars, "SystemUpdateID")) {
+        // servers not evented ContainerUpdateIDs only tell something changed,
+        // anything cached for that device may be outdated
+        if (m_UseCache) m_Cache.Clear(device->GetUUID());
+
+        // notify listener
+        if (m_ContainerListener) m_ContainerListener->OnContainerChanged(device, "0", "");
+    }
     if (var) {
         // variable found, parse value
         NPT_String value = var->GetValue();
@@ -270,25 +286,45 @@ PLT_SyncMediaBrowser::BrowseSync(PLT_BrowseDataReference& browse_data,
                                  const char*              filter, 
                                  const char*              sort)
 {
-    NPT_Result res;
+    // send off the browse packet.  Note that this will
+    // not block.  There is a call to WaitForResponse in order
+    // to block until the response comes back.
+    NPT_CHECK_SEVERE(SendBrowse(browse_data,
+        device,
+        object_id,
+        index,
+        count,
+        browse_metadata,
+        filter,
+        sort));
 
+    return WaitForResponse(browse_data->shared_var);
+}
+
+/*----------------------------------------------------------------------
+|   PLT_SyncMediaBrowser::SendBrowse
++---------------------------------------------------------------------*/
+NPT_Result 
+PLT_SyncMediaBrowser::SendBrowse(PLT_BrowseDataReference& browse_data,
+                                 PLT_DeviceDataReference& device, 
+                                 const char*              object_id, 
+                                 NPT_Int32                index, 
+                                 NPT_Int32                count,
+                                 bool                     browse_metadata,
+                                 const char*              filter, 
+                                 const char*              sort)
+{
     browse_data->shared_var.SetValue(0);
     browse_data->info.si = index;
 
-    // send off the browse packet.  Note that this will
-    // not block.  There is a call to WaitForResponse in order
-    // to block until the response comes back.
-    res = PLT_MediaBrowser::Browse(device,
+    return PLT_MediaBrowser::Browse(device,
         (const char*)object_id,
         index,
         count,
         browse_metadata,
         filter,
         sort,
-        new PLT_BrowseDataReference(browse_data));		
-    NPT_CHECK_SEVERE(res);
-
-    return WaitForResponse(browse_data->shared_var);
+        new PLT_BrowseDataReference(browse_data));
 }
 
 /*----------------------------------------------------------------------
@@ -403,6 +439,7 @@ PLT_SyncMediaBrowser::BrowseSync(PLT_DeviceDataReference&      device,
     NPT_Result res = NPT_FAILURE;
     NPT_Int32  index = start;
     NPT_UInt32 count = 0;
+    NPT_UInt32 total = 0;
     
     // only cache metadata or if starting from 0 and asking for maximum
     bool cache = m_UseCache && (metadata || (start == 0 && max_results == 0));
@@ -414,58 +451,89 @@ PLT_SyncMediaBrowser::BrowseSync(PLT_DeviceDataReference&      device,
     if (cache && NPT_SUCCEEDED(m_Cache.Get(device->GetUUID(), object_id, list))) return NPT_SUCCESS;
 
     do {	
-        PLT_BrowseDataReference browse_data(new PLT_BrowseData());
+        // once the server told how many children there are, ask for the
+        // next few chunks at once instead of one after the other
+        NPT_Cardinal requests = 1;
+        if (!metadata && !max_results && total > count) {
+            requests = (total - count + PLT_SYNC_BROWSE_CHUNK_SIZE - 1) / PLT_SYNC_BROWSE_CHUNK_SIZE;
+            if (requests > PLT_SYNC_BROWSE_MAX_REQUESTS) requests = PLT_SYNC_BROWSE_MAX_REQUESTS;
+        }
 
-        // send off the browse packet.  Note that this will
+        // send off the browse packets.  Note that this will
         // not block.  There is a call to WaitForResponse in order
-        // to block until the response comes back.
-        res = BrowseSync(
-            browse_data,
-            device,
-            (const char*)object_id,
-            index,
-            metadata?1:200, // DLNA recommendations for browsing children is no more than 30 at a time
-            metadata);		
-        NPT_CHECK_LABEL_WARNING(res, done);
-        
-        if (NPT_FAILED(browse_data->res)) {
-            res = browse_data->res;
+        // to block until the responses come back.
+        NPT_Array<PLT_BrowseDataReference> pending;
+        for (NPT_Cardinal i = 0; i < requests; i++) {
+            PLT_BrowseDataReference browse_data(new PLT_BrowseData());
+            res = SendBrowse(
+                browse_data,
+                device,
+                (const char*)object_id,
+                index + i * PLT_SYNC_BROWSE_CHUNK_SIZE,
+                metadata?1:PLT_SYNC_BROWSE_CHUNK_SIZE,
+                metadata);
             NPT_CHECK_LABEL_WARNING(res, done);
+            pending.Add(browse_data);
         }
 
-        // server returned no more, bail now
-        if (browse_data->info.nr == 0)
-            break;
-
-        if (browse_data->info.nr != browse_data->info.items->GetItemCount()) {
-            NPT_LOG_WARNING_2("Server returned unexpected number of items (%d vs %d)",
-                              browse_data->info.nr, browse_data->info.items->GetItemCount());
-        }
-        count += std::max<NPT_UInt32>(browse_data->info.nr, browse_data->info.items->GetItemCount());
+        bool finished = false;
+        for (NPT_Cardinal i = 0; i < pending.GetItemCount(); i++) {
+            PLT_BrowseDataReference& browse_data = pending[i];
+            res = WaitForResponse(browse_data->shared_var);
+            NPT_CHECK_LABEL_WARNING(res, done);
 
-        if (list.IsNull()) {
-            list = browse_data->info.items;
-        } else {
-            list->Add(*browse_data->info.items);
-            // clear the list items so that the data inside is not
-            // cleaned up by PLT_MediaItemList dtor since we copied
-            // each pointer into the new list.
-            browse_data->info.items->Clear();
+            if (NPT_FAILED(browse_data->res)) {
+                res = browse_data->res;
+                NPT_CHECK_LABEL_WARNING(res, done);
+            }
+
+            // server returned no more, bail now
+            if (browse_data->info.nr == 0) {
+                finished = true;
+                break;
+            }
+
+            if (browse_data->info.nr != browse_data->info.items->GetItemCount()) {
+                NPT_LOG_WARNING_2("Server returned unexpected number of items (%d vs %d)",
+                                  browse_data->info.nr, browse_data->info.items->GetItemCount());
+            }
+            NPT_UInt32 received = std::max<NPT_UInt32>(browse_data->info.nr, browse_data->info.items->GetItemCount());
+            count += received;
+            total = browse_data->info.tm;
+
+            if (list.IsNull()) {
+                list = browse_data->info.items;
+            } else {
+                list->Add(*browse_data->info.items);
+                // clear the list items so that the data inside is not
+                // cleaned up by PLT_MediaItemList dtor since we copied
+                // each pointer into the new list.
+                browse_data->info.items->Clear();
+            }
+
+            // stop now if our list contains exactly what the server said it had.
+            // Note that the server could return 0 if it didn't know how many items were
+            // available. In this case we have to continue browsing until
+            // nothing is returned back by the server.
+            // Unless we were told to stop after reaching a certain amount to avoid
+            // length delays
+            // (some servers may return a total matches out of whack at some point too)
+            if ((total && total <= count) ||
+                (max_results && count >= max_results)) {
+                finished = true;
+                break;
+            }
+
+            // a short chunk means the following ones don't start where this
+            // one ended, drop them and ask again from here
+            if (received < PLT_SYNC_BROWSE_CHUNK_SIZE)
+                break;
         }
-
-        // stop now if our list contains exactly what the server said it had.
-        // Note that the server could return 0 if it didn't know how many items were
-        // available. In this case we have to continue browsing until
-        // nothing is returned back by the server.
-        // Unless we were told to stop after reaching a certain amount to avoid
-        // length delays
-        // (some servers may return a total matches out of whack at some point too)
-        if ((browse_data->info.tm && browse_data->info.tm <= count) ||
-            (max_results && count >= max_results))
+        if (finished)
             break;
 
         // ask for the next chunk of entries
-        index = count;
+        index = start + count;
     } while(1);
 
 done:
@@ -157,6 +157,15 @@ protected:
                           const char*              filter = PLT_DEFAULT_FILTER,
                           const char*              sort = "");
 
+    NPT_Result SendBrowse(PLT_BrowseDataReference& browse_data,
+                          PLT_DeviceDataReference& device, 
+                          const char*              object_id,
+                          NPT_Int32                index, 
+                          NPT_Int32                count,
+                          bool                     browse_metadata = false,
+                          const char*              filter = PLT_DEFAULT_FILTER,
+                          const char*              sort = "");
+
     NPT_Result SearchSync(PLT_BrowseDataReference& browse_data,
                           PLT_DeviceDataReference& device, 
                           const char*              container_id,
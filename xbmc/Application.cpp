@@ -34,6 +34,7 @@
 #include "Util.h"
 #include "URL.h"
 #include "guilib/GUIComponent.h"
+#include "guilib/GUIFrameScheduler.h"
 #include "guilib/TextureManager.h"
 #include "cores/IPlayer.h"
 #include "cores/VideoPlayer/DVDFileInfo.h"
@@ -47,6 +48,8 @@
 #include "music/MusicLibraryQueue.h"
 #include "guilib/GUIControlProfiler.h"
 #include "utils/LangCodeExpander.h"
+#include "utils/LibraryChangeJournal.h"
+#include "utils/MemoryBudget.h"
 #include "GUIInfoManager.h"
 #include "playlists/PlayListFactory.h"
 #include "guilib/GUIFontManager.h"
@@ -1105,6 +1108,16 @@ bool CApplication::Initialize()
     // rendered while we load the main window or enter the master lock key
     CServiceBroker::GetGUI()->GetWindowManager().ActivateWindow(WINDOW_SPLASH);
 
+    // load the home window now, its widgets start listing their content in the
+    // background and are populated by the time it's shown
+    if (!m_ServiceManager->GetProfileManager().UsingLoginScreen() &&
+        (g_SkinInfo->GetFirstWindow() == WINDOW_HOME || g_SkinInfo->GetFirstWindow() == WINDOW_STARTUP_ANIM))
+    {
+      CGUIWindow *home = CServiceBroker::GetGUI()->GetWindowManager().GetWindow(WINDOW_HOME);
+      if (home)
+        home->Initialize();
+    }
+
     if (m_ServiceManager->GetSettings().GetBool(CSettings::SETTING_MASTERLOCK_STARTUPLOCK) &&
         m_ServiceManager->GetProfileManager().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE &&
        !m_ServiceManager->GetProfileManager().GetMasterProfile().getLockCode().empty())
@@ -1241,12 +1254,16 @@ void CApplication::StartServices()
   CLog::Log(LOGNOTICE, "start dvd mediatype detection");
   m_DetectDVDType.Create(false, THREAD_MINSTACKSIZE);
 #endif
+
+  CMemoryBudget::GetInstance().Start();
 }
 
 void CApplication::StopServices()
 {
   m_ServiceManager->GetNetwork().NetworkMessage(CNetwork::SERVICES_DOWN, 0);
 
+  CMemoryBudget::GetInstance().Stop();
+
 #if !defined(TARGET_WINDOWS) && defined(HAS_DVD_DRIVE)
   CLog::Log(LOGNOTICE, "stop dvd detect media");
   m_DetectDVDType.StopThread();
@@ -1576,6 +1593,7 @@ bool CApplication::LoadSkin(const std::string& skinID)
 
   CLog::Log(LOGNOTICE, "  load skin from: %s (version: %s)", skin->Path().c_str(), skin->Version().asString().c_str());
   g_SkinInfo = skin;
+  CServiceBroker::GetGUI()->GetInfoManager().ResetSkinCache();
 
   CLog::Log(LOGINFO, "  load fonts for skin...");
   CServiceBroker::GetWinSystem()->GetGfxContext().SetMediaDir(skin->Path());
@@ -1824,6 +1842,8 @@ void CApplication::Render()
   // render gui layer
   if (!m_skipGuiRender)
   {
+    m_appPlayer.BeginGuiRender();
+
     if (CServiceBroker::GetWinSystem()->GetGfxContext().GetStereoMode())
     {
       CServiceBroker::GetWinSystem()->GetGfxContext().SetStereoView(RENDER_STEREO_VIEW_LEFT);
@@ -1843,6 +1863,8 @@ void CApplication::Render()
     // execute post rendering actions (finalize window closing)
     CServiceBroker::GetGUI()->GetWindowManager().AfterRender();
 
+    m_appPlayer.EndGuiRender();
+
     m_lastRenderTime = XbmcThreads::SystemClockMillis();
   }
 
@@ -1866,6 +1888,7 @@ void CApplication::Render()
   CServiceBroker::GetWinSystem()->GetGfxContext().Flip(hasRendered, m_appPlayer.IsRenderingVideoLayer());
 
   CTimeUtils::UpdateFrameTime(hasRendered);
+  CServiceBroker::GetGUI()->GetFrameScheduler().BeginFrame();
 }
 
 void CApplication::SetStandAlone(bool value)
@@ -2868,6 +2891,8 @@ void CApplication::Stop(int exitCode)
     if (CVideoLibraryQueue::GetInstance().IsRunning())
       CVideoLibraryQueue::GetInstance().CancelAllJobs();
 
+    CLibraryChangeJournal::GetInstance().Stop();
+
     CApplicationMessenger::GetInstance().Cleanup();
 
     StopServices();
@@ -4057,6 +4082,14 @@ bool CApplication::OnMessage(CGUIMessage& message)
 
   case GUI_MSG_QUEUE_NEXT_ITEM:
     {
+      // the next part of a stack is played once this one ended, don't let
+      // the player move on to the playlist
+      if (m_stackHelper.IsPlayingRegularStack() && m_stackHelper.HasNextStackPartFileItem())
+      {
+        m_appPlayer.OnNothingToQueueNotify();
+        return true;
+      }
+
       // Check to see if our playlist player has a new item for us,
       // and if so, we check whether our current player wants the file
       int iNext = CServiceBroker::GetPlaylistPlayer().GetNextSong();
@@ -4824,6 +4857,9 @@ CApplicationStackHelper& CApplication::GetAppStackHelper()
 
 void CApplication::UpdateLibraries()
 {
+  // watch the sources of the profile that logged in, changes may have been missed while asleep
+  CLibraryChangeJournal::GetInstance().Start();
+
   if (m_ServiceManager->GetSettings().GetBool(CSettings::SETTING_VIDEOLIBRARY_UPDATEONSTARTUP))
   {
     CLog::LogF(LOGNOTICE, "Starting video library startup scan");
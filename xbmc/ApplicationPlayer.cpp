@@ -347,6 +347,14 @@ void CApplicationPlayer::SeekTimeRelative(int64_t iTime)
   }
 }
 
+bool CApplicationPlayer::SeekTimePreview(int64_t iTime)
+{
+  std::shared_ptr<IPlayer> player = GetInternal();
+  if (player)
+    return player->SeekTimePreview(iTime);
+  return false;
+}
+
 int64_t CApplicationPlayer::GetTime() const
 {
   std::shared_ptr<IPlayer> player = GetInternal();
@@ -834,6 +842,20 @@ void CApplicationPlayer::Render(bool clear, uint32_t alpha, bool gui)
     player->Render(clear, alpha, gui);
 }
 
+void CApplicationPlayer::BeginGuiRender()
+{
+  std::shared_ptr<IPlayer> player = GetInternal();
+  if (player)
+    player->BeginGuiRender();
+}
+
+void CApplicationPlayer::EndGuiRender()
+{
+  std::shared_ptr<IPlayer> player = GetInternal();
+  if (player)
+    player->EndGuiRender();
+}
+
 void CApplicationPlayer::FlushRenderer()
 {
   std::shared_ptr<IPlayer> player = GetInternal();
@@ -959,6 +981,13 @@ bool CApplicationPlayer::RenderCaptureGetPixels(unsigned int captureId, unsigned
     return false;
 }
 
+void CApplicationPlayer::RenderCaptureSetCallback(unsigned int captureId, IRenderCaptureCallback* callback)
+{
+  std::shared_ptr<IPlayer> player = GetInternal();
+  if (player)
+    player->RenderCaptureSetCallback(captureId, callback);
+}
+
 bool CApplicationPlayer::IsExternalPlaying()
 {
   std::shared_ptr<IPlayer> player = GetInternal();
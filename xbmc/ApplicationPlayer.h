@@ -61,6 +61,8 @@ public:
 
   void FrameMove();
   void Render(bool clear, uint32_t alpha = 255, bool gui = true);
+  void BeginGuiRender();
+  void EndGuiRender();
   void FlushRenderer();
   void SetRenderViewMode(int mode, float zoom, float par, float shift, bool stretch);
   float GetRenderAspectRatio();
@@ -76,6 +78,7 @@ public:
   void RenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags = 0);
   void RenderCaptureRelease(unsigned int captureId);
   bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size);
+  void RenderCaptureSetCallback(unsigned int captureId, IRenderCaptureCallback* callback);
   bool IsExternalPlaying();
 
   // proxy calls
@@ -140,6 +143,7 @@ public:
   bool SeekScene(bool bPlus = true);
   void SeekTime(int64_t iTime = 0);
   void SeekTimeRelative(int64_t iTime = 0);
+  bool SeekTimePreview(int64_t iTime);
   void SetAudioStream(int iStream);
   void SetAVDelay(float fValue = 0.0f);
   void SetDynamicRangeCompression(long drc);
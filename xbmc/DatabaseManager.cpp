@@ -19,6 +19,9 @@
  */
 
 #include "DatabaseManager.h"
+
+#include <algorithm>
+
 #include "utils/log.h"
 #include "addons/AddonDatabase.h"
 #include "view/ViewDatabase.h"
@@ -28,16 +31,60 @@
 #include "pvr/PVRDatabase.h"
 #include "pvr/epg/EpgDatabase.h"
 #include "games/addons/savestates/SavestateDatabase.h"
+#include "dbwrappers/dataset.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
 
 using namespace PVR;
 
+#define DB_POOL_MAX_IDLE      4     // idle connections kept per database and access mode
+#define DB_POOL_IDLE_TIMEOUT  60000 // ms before an idle connection is closed
+#define DB_POOL_CHECK_AFTER   10000 // ms of idleness after which a connection is checked before reuse
+
+namespace
+{
+/*! \brief Checks and analyzes the databases in the background after startup.
+ */
+class CDatabaseOptimizeJob : public CJob
+{
+public:
+  const char *GetType() const override { return "databaseoptimize"; }
+
+  bool DoWork() override
+  {
+    Optimize<CAddonDatabase>(g_advancedSettings.m_databaseAddons);
+    Optimize<CTextureDatabase>(g_advancedSettings.m_databaseTextures);
+    Optimize<CMusicDatabase>(g_advancedSettings.m_databaseMusic);
+    Optimize<CVideoDatabase>(g_advancedSettings.m_databaseVideo);
+    Optimize<CPVRDatabase>(g_advancedSettings.m_databaseTV);
+    Optimize<CPVREpgDatabase>(g_advancedSettings.m_databaseEpg);
+    return true;
+  }
+
+private:
+  template<class T>
+  void Optimize(const DatabaseSettings &settings)
+  {
+    if (!settings.optimize)
+      return;
+
+    T db;
+    if (!db.Open())
+      return;
+
+    db.Optimize();
+    db.Close();
+  }
+};
+}
+
 CDatabaseManager::CDatabaseManager() :
   m_bIsUpgrading(false)
 {
   // Initialize the addon database (must be before the addon manager is init'd)
   CAddonDatabase db;
-  UpdateDatabase(db);
+  UpdateDatabase(db, &g_advancedSettings.m_databaseAddons);
 }
 
 CDatabaseManager::~CDatabaseManager() = default;
@@ -50,11 +97,14 @@ void CDatabaseManager::Initialize()
 
   CLog::Log(LOGDEBUG, "%s, updating databases...", __FUNCTION__);
 
+  // connections of the previous profile are no use anymore
+  ClearConnections();
+
   // NOTE: Order here is important. In particular, CTextureDatabase has to be updated
   //       before CVideoDatabase.
-  { CAddonDatabase db; UpdateDatabase(db); }
+  { CAddonDatabase db; UpdateDatabase(db, &g_advancedSettings.m_databaseAddons); }
   { CViewDatabase db; UpdateDatabase(db); }
-  { CTextureDatabase db; UpdateDatabase(db); }
+  { CTextureDatabase db; UpdateDatabase(db, &g_advancedSettings.m_databaseTextures); }
   { CMusicDatabase db; UpdateDatabase(db, &g_advancedSettings.m_databaseMusic); }
   { CVideoDatabase db; UpdateDatabase(db, &g_advancedSettings.m_databaseVideo); }
   { CPVRDatabase db; UpdateDatabase(db, &g_advancedSettings.m_databaseTV); }
@@ -63,6 +113,8 @@ void CDatabaseManager::Initialize()
   CLog::Log(LOGDEBUG, "%s, updating databases... DONE", __FUNCTION__);
 
   m_bIsUpgrading = false;
+
+  CJobManager::GetInstance().AddJob(new CDatabaseOptimizeJob(), nullptr, CJob::PRIORITY_LOW_PAUSABLE);
 }
 
 bool CDatabaseManager::CanOpen(const std::string &name)
@@ -208,3 +260,98 @@ void CDatabaseManager::UpdateStatus(const std::string &name, DB_STATUS status)
   CSingleLock lock(m_section);
   m_dbStatus[name] = status;
 }
+
+std::unique_ptr<dbiplus::Database> CDatabaseManager::AcquireConnection(const std::string &key, bool readOnly)
+{
+  const std::string poolKey = (readOnly ? "r|" : "w|") + key;
+  const unsigned int now = XbmcThreads::SystemClockMillis();
+
+  while (true)
+  {
+    PooledConnection pooled;
+    {
+      CSingleLock lock(m_poolSection);
+      PruneConnections(now);
+
+      auto it = m_pool.find(poolKey);
+      if (it == m_pool.end() || it->second.empty())
+        return nullptr;
+
+      // prefer the connection this thread used last, otherwise the most recent one
+      std::vector<PooledConnection> &idle = it->second;
+      auto use = idle.end() - 1;
+      for (auto i = idle.begin(); i != idle.end(); ++i)
+      {
+        if (i->thread == std::this_thread::get_id())
+        {
+          use = i;
+          break;
+        }
+      }
+      pooled = std::move(*use);
+      idle.erase(use);
+    }
+
+    if (now - pooled.released < DB_POOL_CHECK_AFTER)
+      return std::move(pooled.connection);
+
+    // the server may have dropped the connection while it was idle
+    try
+    {
+      std::unique_ptr<dbiplus::Dataset> ds(pooled.connection->CreateDataset());
+      if (ds->query("SELECT 1"))
+      {
+        ds.reset();
+        return std::move(pooled.connection);
+      }
+    }
+    catch (...)
+    {
+    }
+    CLog::Log(LOGDEBUG, "%s, dropping stale connection to %s", __FUNCTION__, key.c_str());
+  }
+}
+
+void CDatabaseManager::ReleaseConnection(const std::string &key, bool readOnly, std::unique_ptr<dbiplus::Database> connection)
+{
+  if (!connection)
+    return;
+
+  const std::string poolKey = (readOnly ? "r|" : "w|") + key;
+  const unsigned int now = XbmcThreads::SystemClockMillis();
+
+  CSingleLock lock(m_poolSection);
+  PruneConnections(now);
+
+  std::vector<PooledConnection> &idle = m_pool[poolKey];
+  if (idle.size() >= DB_POOL_MAX_IDLE)
+    return; // pool is full, the connection is closed on the way out
+
+  PooledConnection pooled;
+  pooled.connection = std::move(connection);
+  pooled.thread = std::this_thread::get_id();
+  pooled.released = now;
+  idle.push_back(std::move(pooled));
+}
+
+void CDatabaseManager::ClearConnections()
+{
+  std::map<std::string, std::vector<PooledConnection>> pool;
+  {
+    CSingleLock lock(m_poolSection);
+    pool.swap(m_pool);
+  }
+  // the connections are closed here, outside of the lock
+}
+
+void CDatabaseManager::PruneConnections(unsigned int now)
+{
+  for (auto &it : m_pool)
+  {
+    std::vector<PooledConnection> &idle = it.second;
+    idle.erase(std::remove_if(idle.begin(), idle.end(), [now](const PooledConnection &pooled)
+    {
+      return now - pooled.released >= DB_POOL_IDLE_TIMEOUT;
+    }), idle.end());
+  }
+}
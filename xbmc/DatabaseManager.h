@@ -22,12 +22,20 @@
 
 #include <atomic>
 #include <map>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 #include "threads/CriticalSection.h"
 
 class CDatabase;
 class DatabaseSettings;
 
+namespace dbiplus
+{
+  class Database;
+}
+
 /*!
  \ingroup database
  \brief Database manager class for handling database updating
@@ -62,7 +70,36 @@ public:
 
   bool IsUpgrading() const { return m_bIsUpgrading; }
 
+  /*! \brief Take an idle connection from the pool.
+
+   Connections last released by the calling thread are preferred. A connection
+   that sat idle for a while is checked with a trivial query before it's handed
+   out, and dropped if the check fails.
+
+   \param key identifies the server, credentials and database of the connection.
+   \param readOnly whether to take the connection from the pool of readers or writers.
+   \return the connection, or nullptr if a new one has to be made.
+   */
+  std::unique_ptr<dbiplus::Database> AcquireConnection(const std::string &key, bool readOnly);
+
+  /*! \brief Hand a connection back to the pool for reuse.
+   The connection is closed instead if the pool for its key is full.
+   */
+  void ReleaseConnection(const std::string &key, bool readOnly, std::unique_ptr<dbiplus::Database> connection);
+
+  /*! \brief Close all idle pooled connections.
+   */
+  void ClearConnections();
+
 private:
+  struct PooledConnection
+  {
+    std::unique_ptr<dbiplus::Database> connection;
+    std::thread::id thread;   ///< thread that released the connection
+    unsigned int released;    ///< time the connection was released
+  };
+  void PruneConnections(unsigned int now);
+
   std::atomic<bool> m_bIsUpgrading;
 
   enum DB_STATUS { DB_CLOSED, DB_UPDATING, DB_READY, DB_FAILED };
@@ -73,4 +110,7 @@ private:
 
   CCriticalSection            m_section;     ///< Critical section protecting m_dbStatus.
   std::map<std::string, DB_STATUS> m_dbStatus;    ///< Our database status map.
+
+  CCriticalSection m_poolSection;
+  std::map<std::string, std::vector<PooledConnection>> m_pool; ///< Idle connections by pool key.
 };
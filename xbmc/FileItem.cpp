@@ -2071,6 +2071,7 @@ void CFileItemList::Append(const CFileItemList& itemlist)
 {
   CSingleLock lock(m_lock);
 
+  m_items.reserve(m_items.size() + itemlist.Size());
   for (int i = 0; i < itemlist.Size(); ++i)
     Add(itemlist[i]);
 }
@@ -2091,6 +2092,34 @@ void CFileItemList::Assign(const CFileItemList& itemlist, bool append)
   m_cacheToDisc = itemlist.m_cacheToDisc;
 }
 
+void CFileItemList::Assign(CFileItemList&& itemlist, bool append)
+{
+  CSingleLock lock(m_lock);
+  CSingleLock lockOther(itemlist.m_lock);
+  if (!append)
+    Clear();
+
+  if (m_items.empty() && !m_fastLookup)
+    m_items.swap(itemlist.m_items);
+  else
+  {
+    m_items.reserve(m_items.size() + itemlist.m_items.size());
+    for (CFileItemPtr &item : itemlist.m_items)
+      Add(std::move(item));
+  }
+  itemlist.m_items.clear();
+  itemlist.m_map.clear();
+
+  SetPath(itemlist.GetPath());
+  SetLabel(itemlist.GetLabel());
+  m_sortDetails = std::move(itemlist.m_sortDetails);
+  m_sortDescription = itemlist.m_sortDescription;
+  m_replaceListing = itemlist.m_replaceListing;
+  m_content = std::move(itemlist.m_content);
+  m_mapProperties = std::move(itemlist.m_mapProperties);
+  m_cacheToDisc = itemlist.m_cacheToDisc;
+}
+
 bool CFileItemList::Copy(const CFileItemList& items, bool copyItems /* = true */)
 {
   // assign all CFileItem parts
@@ -2108,6 +2137,7 @@ bool CFileItemList::Copy(const CFileItemList& items, bool copyItems /* = true */
   if (copyItems)
   {
     // make a copy of each item
+    Reserve(Size() + items.Size());
     for (int i = 0; i < items.Size(); i++)
     {
       CFileItemPtr newItem(new CFileItem(*items[i]));
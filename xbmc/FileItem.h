@@ -675,6 +675,10 @@ public:
   bool IsEmpty() const;
   void Append(const CFileItemList& itemlist);
   void Assign(const CFileItemList& itemlist, bool append = false);
+  /*! \brief Take over the items and properties of a list that is no longer needed.
+   The items are moved rather than shared, the other list is left without items.
+   */
+  void Assign(CFileItemList&& itemlist, bool append = false);
   bool Copy  (const CFileItemList& item, bool copyItems = true);
   void Reserve(int iCount);
   void Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute sortAttributes = SortAttributeNone);
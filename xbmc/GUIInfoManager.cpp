@@ -58,7 +58,9 @@ bool InfoBoolComparator(const InfoPtr &right, const InfoPtr &left)
 CGUIInfoManager::CGUIInfoManager(void)
 : m_currentFile(new CFileItem),
   m_bools(&InfoBoolComparator),
-  m_refreshCounter(0)
+  m_refreshCounter(0),
+  m_skinRefreshCounter(1),
+  m_fixedRefreshCounter(1)
 {
 }
 
@@ -1160,6 +1162,14 @@ const infomap system_labels[] =  {{ "hasnetwork",       SYSTEM_ETHERNET_LINK_ACT
 ///                  _boolean_,
 ///     Returns true if 'hide watched items' is selected.
 ///   }
+///   \table_row3{   <b>`System.Metric(name)`</b>,
+///                  \anchor System_Metric
+///                  _string_,
+///     Displays the value of the metric with the given 'name', e.g.
+///     kodi_video_dropped_frames_total. For a histogram append .avg, .p50, .p95
+///     or .p99 to the name for the values of the last few seconds, e.g.
+///     kodi_gui_frame_time_ms.p95
+///   }
 /// \table_end
 ///
 /// -----------------------------------------------------------------------------
@@ -1168,7 +1178,8 @@ const infomap system_param[] =   {{ "hasalarm",         SYSTEM_HAS_ALARM },
                                   { "hascoreid",        SYSTEM_HAS_CORE_ID },
                                   { "setting",          SYSTEM_SETTING },
                                   { "hasaddon",         SYSTEM_HAS_ADDON },
-                                  { "coreusage",        SYSTEM_GET_CORE_USAGE }};
+                                  { "coreusage",        SYSTEM_GET_CORE_USAGE },
+                                  { "metric",           SYSTEM_METRIC }};
 
 /// \page modules__General__List_of_gui_access
 /// \section modules__General__List_of_gui_access_Network Network
@@ -2105,7 +2116,11 @@ const infomap player_process[] =
   { "audiodecoder", PLAYER_PROCESS_AUDIODECODER },
   { "audiochannels", PLAYER_PROCESS_AUDIOCHANNELS },
   { "audiosamplerate", PLAYER_PROCESS_AUDIOSAMPLERATE },
-  { "audiobitspersample", PLAYER_PROCESS_AUDIOBITSPERSAMPLE }
+  { "audiobitspersample", PLAYER_PROCESS_AUDIOBITSPERSAMPLE },
+  { "videodecodetime", PLAYER_PROCESS_VIDEODECODETIME },
+  { "videodecodetimemax", PLAYER_PROCESS_VIDEODECODETIMEMAX },
+  { "inputlatency", PLAYER_PROCESS_INPUTLATENCY },
+  { "inputlatencymax", PLAYER_PROCESS_INPUTLATENCYMAX }
 };
 
 /// \page modules__General__List_of_gui_access
@@ -6402,11 +6417,46 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
     res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refreshCounter));
 
   if (res.second)
-    res.first->get()->Initialize();
+  {
+    INFO::InfoBool *info = res.first->get();
+    info->Initialize();
+    if (info->GetDependency() == INFO::InfoDependency::NONE)
+      info->SetRefreshCounter(m_fixedRefreshCounter);
+    else if (info->GetDependency() == INFO::InfoDependency::SKIN)
+      info->SetRefreshCounter(m_skinRefreshCounter);
+  }
 
   return *(res.first);
 }
 
+INFO::InfoDependency CGUIInfoManager::GetDependency(int condition) const
+{
+  int info = std::abs(condition);
+  if (info >= MULTI_INFO_START && info <= MULTI_INFO_END)
+    info = m_multiInfo[info - MULTI_INFO_START].m_info;
+
+  switch (info)
+  {
+    case SYSTEM_ALWAYS_TRUE:
+    case SYSTEM_ALWAYS_FALSE:
+    case SYSTEM_PLATFORM_LINUX:
+    case SYSTEM_PLATFORM_WINDOWS:
+    case SYSTEM_PLATFORM_UWP:
+    case SYSTEM_PLATFORM_DARWIN:
+    case SYSTEM_PLATFORM_DARWIN_OSX:
+    case SYSTEM_PLATFORM_DARWIN_IOS:
+    case SYSTEM_PLATFORM_ANDROID:
+    case SYSTEM_PLATFORM_LINUX_RASPBERRY_PI:
+    case SYSTEM_PLATFORM_WIN10:
+      return INFO::InfoDependency::NONE;
+    case SKIN_BOOL:
+    case SKIN_STRING:
+      return INFO::InfoDependency::SKIN;
+    default:
+      return INFO::InfoDependency::ANY;
+  }
+}
+
 bool CGUIInfoManager::EvaluateBool(const std::string &expression, int contextWindow /* = 0 */, const CGUIListItemPtr &item /* = nullptr */)
 {
   INFO::InfoPtr info = Register(expression, contextWindow);
@@ -6935,6 +6985,13 @@ void CGUIInfoManager::ResetCache()
   ++m_refreshCounter;
 }
 
+void CGUIInfoManager::ResetSkinCache()
+{
+  CSingleLock lock(m_critInfo);
+  ++m_skinRefreshCounter;
+  ++m_refreshCounter;
+}
+
 void CGUIInfoManager::SetCurrentVideoTag(const CVideoInfoTag &tag)
 {
   m_currentFile->SetFromVideoInfoTag(tag);
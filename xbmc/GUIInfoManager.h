@@ -73,6 +73,10 @@ public:
   void Clear();
   void ResetCache();
 
+  /*! \brief Mark the conditions depending on skin settings as dirty, call after changing them
+   */
+  void ResetSkinCache();
+
   // KODI::MESSAGING::IMessageTarget implementation
   int GetMessageMask() override;
   void OnApplicationMessage(KODI::MESSAGING::ThreadMessage* pMsg) override;
@@ -89,6 +93,11 @@ public:
    */
   INFO::InfoPtr Register(const std::string &expression, int context = 0);
 
+  /*! \brief Get the state the value of a condition depends on
+   \param condition the condition, as returned by TranslateSingleString
+   */
+  INFO::InfoDependency GetDependency(int condition) const;
+
   /// \brief iterates through boolean conditions and compares their stored values to current values. Returns true if any condition changed value.
   bool ConditionsChangedValues(const std::map<INFO::InfoPtr, bool>& map);
 
@@ -210,6 +219,8 @@ private:
   typedef std::set<INFO::InfoPtr, bool(*)(const INFO::InfoPtr&, const INFO::InfoPtr&)> INFOBOOLTYPE;
   INFOBOOLTYPE m_bools;
   unsigned int m_refreshCounter;
+  unsigned int m_skinRefreshCounter;
+  unsigned int m_fixedRefreshCounter;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   CCriticalSection m_critInfo;
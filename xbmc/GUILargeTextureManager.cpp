@@ -21,6 +21,8 @@
 #include "threads/SystemClock.h"
 #include "GUILargeTextureManager.h"
 #include "settings/Settings.h"
+#include "guilib/GUIComponent.h"
+#include "guilib/GUIFrameScheduler.h"
 #include "guilib/Texture.h"
 #include "threads/SingleLock.h"
 #include "utils/TimeUtils.h"
@@ -29,8 +31,12 @@
 #include "utils/log.h"
 #include "TextureCache.h"
 
+#include <algorithm>
 #include <cassert>
 
+// number of images decoded at once, the rest wait in m_pending so they can be reordered or dropped
+#define MAX_LOADING_IMAGES 4
+
 CImageLoader::CImageLoader(const std::string &path, const bool useCache):
   m_path(path)
 {
@@ -91,6 +97,7 @@ CGUILargeTextureManager::CLargeTexture::CLargeTexture(const std::string &path):
 {
   m_refCount = 1;
   m_timeToDelete = 0;
+  m_uploaded = false;
 }
 
 CGUILargeTextureManager::CLargeTexture::~CLargeTexture()
@@ -136,6 +143,13 @@ void CGUILargeTextureManager::CLargeTexture::SetTexture(CBaseTexture* texture)
     m_texture.Set(texture, texture->GetWidth(), texture->GetHeight());
 }
 
+void CGUILargeTextureManager::CLargeTexture::Upload()
+{
+  for (auto texture : m_texture.m_textures)
+    texture->LoadToGPU();
+  m_uploaded = true;
+}
+
 CGUILargeTextureManager::CGUILargeTextureManager() = default;
 
 CGUILargeTextureManager::~CGUILargeTextureManager() = default;
@@ -167,13 +181,36 @@ bool CGUILargeTextureManager::GetImage(const std::string &path, CTextureArray &t
     {
       if (firstRequest)
         image->AddRef();
+      if (!image->IsUploaded() && image->GetTexture().size())
+      {
+        // spread the transfer of newly loaded images to the GPU over several frames,
+        // the caller will ask again next frame while we hand back an empty texture
+        CGUIFrameScheduler &scheduler = CServiceBroker::GetGUI()->GetFrameScheduler();
+        if (!scheduler.CanRunDeferred())
+          return true;
+        int64_t start = CurrentHostCounter();
+        image->Upload();
+        scheduler.EndDeferred(start);
+      }
       texture = image->GetTexture();
       return texture.size() > 0;
     }
   }
 
   if (firstRequest)
-    QueueImage(path, useCache);
+    QueueImage(path, useCache, inView);
+  else
+  {
+    // keep the priority of a waiting image in line with its visibility
+    for (auto &pending : m_pending)
+    {
+      if (pending.image->GetPath() == path)
+      {
+        pending.inView = inView;
+        break;
+      }
+    }
+  }
 
   return true;
 }
@@ -191,6 +228,17 @@ void CGUILargeTextureManager::ReleaseImage(const std::string &path, bool immedia
       return;
     }
   }
+  for (auto it = m_pending.begin(); it != m_pending.end(); ++it)
+  {
+    CLargeTexture *image = it->image;
+    if (image->GetPath() == path)
+    {
+      // not started yet, so there is nothing to cancel
+      if (image->DecrRef(true))
+        m_pending.erase(it);
+      return;
+    }
+  }
   for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
   {
     unsigned int id = it->first;
@@ -200,13 +248,14 @@ void CGUILargeTextureManager::ReleaseImage(const std::string &path, bool immedia
       // cancel this job
       CJobManager::GetInstance().CancelJob(id);
       m_queued.erase(it);
+      StartLoaders();
       return;
     }
   }
 }
 
 // queue the image, and start the background loader if necessary
-void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
+void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache, bool inView)
 {
   if (path.empty())
     return;
@@ -221,11 +270,41 @@ void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
       return; // already queued
     }
   }
+  for (auto &pending : m_pending)
+  {
+    if (pending.image->GetPath() == path)
+    {
+      pending.image->AddRef();
+      pending.inView |= inView;
+      return; // already waiting
+    }
+  }
 
   // queue the item
-  CLargeTexture *image = new CLargeTexture(path);
-  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, CJob::PRIORITY_NORMAL);
-  m_queued.push_back(std::make_pair(jobID, image));
+  CPendingImage pending = { new CLargeTexture(path), useCache, inView, m_requestCount++ };
+  m_pending.push_back(pending);
+  StartLoaders();
+}
+
+// hand waiting images to the job manager while there are free loader slots. Images in view
+// go first, and within each group the most recently requested, which are the ones in the
+// direction we are scrolling.
+void CGUILargeTextureManager::StartLoaders()
+{
+  CSingleLock lock(m_listSection);
+  while (m_queued.size() < MAX_LOADING_IMAGES && !m_pending.empty())
+  {
+    auto next = std::max_element(m_pending.begin(), m_pending.end(),
+                                 [](const CPendingImage &a, const CPendingImage &b)
+                                 {
+                                   if (a.inView != b.inView)
+                                     return b.inView;
+                                   return a.request < b.request;
+                                 });
+    unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(next->image->GetPath(), next->useCache), this, CJob::PRIORITY_NORMAL);
+    m_queued.push_back(std::make_pair(jobID, next->image));
+    m_pending.erase(next);
+  }
 }
 
 void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJob *job)
@@ -242,6 +321,7 @@ void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJ
       loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
       m_queued.erase(it);
       m_allocated.push_back(image);
+      StartLoaders();
       return;
     }
   }
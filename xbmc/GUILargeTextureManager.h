@@ -80,16 +80,21 @@ public:
 
    Loaded textures are reference counted, hence this call may immediately return with the texture
    object filled if the texture has been previously loaded, else will return with an empty texture
-   object if it is being loaded.
+   object if it is being loaded. Freshly loaded textures are transferred to the GPU within the
+   frame budget given by CGUIFrameScheduler, so a texture may be reported as not ready for a few
+   more frames after it has finished loading.
 
    \param path path of the image to load.
    \param texture texture object to hold the resulting texture
    \param orientation orientation of resulting texture
    \param firstRequest true if this is the first time we are requesting this texture
+   \param useCache whether the texture cache may be used to load the image
+   \param inView false if the image is outside of the visible area, e.g. for items cached by a container.
+                  Images that are in view are loaded first.
    \return true if the image exists, else false.
    \sa CGUITextureArray and CGUITexture
    */
-  bool GetImage(const std::string &path, CTextureArray &texture, bool firstRequest, bool useCache = true);
+  bool GetImage(const std::string &path, CTextureArray &texture, bool firstRequest, bool useCache = true, bool inView = true);
 
   /*!
    \brief Request a texture to be unloaded.
@@ -126,6 +131,8 @@ private:
     bool DecrRef(bool deleteImmediately);
     bool DeleteIfRequired(bool deleteImmediately = false);
     void SetTexture(CBaseTexture* texture);
+    bool IsUploaded() const { return m_uploaded; };
+    void Upload();
 
     const std::string &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
@@ -137,10 +144,25 @@ private:
     std::string m_path;
     CTextureArray m_texture;
     unsigned int m_timeToDelete;
+    bool m_uploaded;
   };
 
-  void QueueImage(const std::string &path, bool useCache = true);
+  /*!
+   \brief An image waiting for a free loader slot.
+   */
+  struct CPendingImage
+  {
+    CLargeTexture *image;
+    bool useCache;
+    bool inView;
+    unsigned int request; ///< order of the request, later requests are loaded first
+  };
+
+  void QueueImage(const std::string &path, bool useCache, bool inView);
+  void StartLoaders();
 
+  std::vector<CPendingImage> m_pending;
+  unsigned int m_requestCount = 0;
   std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
   std::vector<CLargeTexture *> m_allocated;
   typedef std::vector<CLargeTexture *>::iterator listIterator;
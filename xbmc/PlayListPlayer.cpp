@@ -41,6 +41,8 @@
 #include "filesystem/VideoDatabaseFile.h"
 #include "messaging/helpers/DialogOKHelper.h"
 
+#include <algorithm>
+
 using namespace PLAYLIST;
 using namespace KODI::MESSAGING;
 
@@ -823,11 +825,15 @@ void PLAYLIST::CPlayListPlayer::OnApplicationMessage(KODI::MESSAGING::ThreadMess
   case TMSG_PLAYLISTPLAYER_GET_ITEMS:
     if (pMsg->lpVoid)
     {
-      PLAYLIST::CPlayList playlist = GetPlaylist(pMsg->param1);
-      CFileItemList *list = static_cast<CFileItemList*>(pMsg->lpVoid);
+      const PLAYLIST::CPlayList &playlist = GetPlaylist(pMsg->param1);
+      auto range = static_cast<PlaylistItemsRange*>(pMsg->lpVoid);
+
+      // only copy what is asked for, queues can be huge
+      int end = range->end < 0 ? playlist.size() : std::min(range->end, playlist.size());
+      for (int i = std::max(range->start, 0); i < end; i++)
+        range->items->Add(std::make_shared<CFileItem>(*playlist[i]));
 
-      for (int i = 0; i < playlist.size(); i++)
-        list->Add(std::make_shared<CFileItem>(*playlist[i]));
+      pMsg->SetResult(playlist.size());
     }
     break;
 
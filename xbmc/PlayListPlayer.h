@@ -45,6 +45,18 @@ enum REPEAT_STATE { REPEAT_NONE = 0, REPEAT_ONE, REPEAT_ALL };
 
 class CPlayList;
 
+/*!
+ \brief Payload of TMSG_PLAYLISTPLAYER_GET_ITEMS, param1 is the playlist.
+ Copies of the items in the range are added to the list, so it can be used
+ on other threads. The message returns the size of the playlist.
+ */
+struct PlaylistItemsRange
+{
+  CFileItemList *items = nullptr;
+  int start = 0;
+  int end = -1; //!< one past the last item, -1 for all items from start on
+};
+
 class CPlayListPlayer : public IMsgTargetCallback,
                         public KODI::MESSAGING::IMessageTarget
 {
@@ -97,6 +97,8 @@ void CSeekHandler::Reset()
   m_seekStep = 0;
   m_seekSize = 0;
   m_timeCodePosition = 0;
+  m_previewTime = -1;
+  m_allowPreview = false;
 }
 
 int CSeekHandler::GetSeekStepSize(SeekType type, int step)
@@ -141,6 +143,9 @@ void CSeekHandler::Seek(bool forward, float amount, float duration /* = 0 */, bo
     m_requireSeek = true;
     m_analogSeek = analogSeek;
     m_seekDelay = analogSeek ? analogSeekDelay : m_seekDelays.at(type);
+    m_seekBaseTime = g_application.GetAppPlayer().GetTime();
+    m_allowPreview = g_advancedSettings.m_videoSeekPreview && type == SEEK_TYPE_VIDEO;
+    m_timerPreview.StartZero();
   }
 
   // calculate our seek amount
@@ -173,7 +178,9 @@ void CSeekHandler::Seek(bool forward, float amount, float duration /* = 0 */, bo
     }
     else
     {
-      // nothing to do, abort seeking
+      // nothing to do, abort seeking and return from a previewed position
+      if (m_previewTime >= 0)
+        g_application.GetAppPlayer().SeekTime(m_seekBaseTime);
       Reset();
     }
   }
@@ -198,13 +205,17 @@ void CSeekHandler::SeekSeconds(int seconds)
 
 int CSeekHandler::GetSeekSize() const
 {
+  // while previewing the player already sits near the target, report what is left
+  if (m_previewTime >= 0)
+    return MathUtils::round_int(m_seekSize - (g_application.GetAppPlayer().GetTime() - m_seekBaseTime) / 1000.0);
+
   return MathUtils::round_int(m_seekSize);
 }
 
 void CSeekHandler::SetSeekSize(double seekSize)
 {
   CApplicationPlayer& player = g_application.GetAppPlayer();
-  int64_t playTime = player.GetTime();
+  int64_t playTime = m_requireSeek ? m_seekBaseTime : player.GetTime();
   double minSeekSize = (player.GetMinTime() - playTime) / 1000.0;
   double maxSeekSize = (player.GetMaxTime() - playTime) / 1000.0;
 
@@ -224,13 +235,18 @@ void CSeekHandler::FrameMove()
   {
     CSingleLock lock(m_critSection);
 
-    // perform relative seek
-    g_application.GetAppPlayer().SeekTimeRelative(static_cast<int64_t>(m_seekSize * 1000));
+    // perform relative seek, or an absolute one if previews have moved the player
+    if (m_previewTime >= 0)
+      g_application.GetAppPlayer().SeekTime(m_seekBaseTime + static_cast<int64_t>(m_seekSize * 1000));
+    else
+      g_application.GetAppPlayer().SeekTimeRelative(static_cast<int64_t>(m_seekSize * 1000));
 
     m_seekChanged = true;
 
     Reset();
   }
+  else if (m_requireSeek && m_allowPreview)
+    SeekPreview();
 
   if (m_timeCodePosition > 0 && m_timerTimeCode.GetElapsedMilliseconds() >= 2500)
   {
@@ -244,6 +260,30 @@ void CSeekHandler::FrameMove()
   }
 }
 
+void CSeekHandler::SeekPreview()
+{
+  CSingleLock lock(m_critSection);
+
+  // wait for the player to show the last preview before asking for the next one
+  if (m_timerPreview.GetElapsedMilliseconds() < previewSeekInterval ||
+      CServiceBroker::GetDataCacheCore().IsSeeking())
+    return;
+
+  int64_t previewTime = m_seekBaseTime + static_cast<int64_t>(m_seekSize * 1000);
+  if (previewTime == m_previewTime)
+    return;
+
+  if (g_application.GetAppPlayer().SeekTimePreview(previewTime))
+  {
+    m_previewTime = previewTime;
+    m_seekChanged = true;
+  }
+  else
+    m_allowPreview = false;
+
+  m_timerPreview.StartZero();
+}
+
 void CSeekHandler::SettingOptionsSeekStepsFiller(SettingConstPtr setting, std::vector< std::pair<std::string, int> > &list, int &current, void *data)
 {
   std::string label;
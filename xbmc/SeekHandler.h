@@ -20,6 +20,7 @@
  */
 
 #include <map>
+#include <stdint.h>
 #include <utility>
 #include <vector>
 
@@ -66,8 +67,10 @@ protected:
 
 private:
   static const int analogSeekDelay = 500;
+  static const int previewSeekInterval = 250;
 
   void SetSeekSize(double seekSize);
+  void SeekPreview();
   int GetSeekStepSize(SeekType type, int step);
 
   int m_seekDelay;
@@ -76,11 +79,15 @@ private:
   bool m_seekChanged = false;
   bool m_analogSeek;
   double m_seekSize;
+  int64_t m_seekBaseTime = 0;
+  int64_t m_previewTime = -1;
+  bool m_allowPreview = false;
   int m_seekStep;
   std::map<SeekType, std::vector<int> > m_forwardSeekSteps;
   std::map<SeekType, std::vector<int> > m_backwardSeekSteps;
   CStopWatch m_timer;
   CStopWatch m_timerTimeCode;
+  CStopWatch m_timerPreview;
   int m_timeCodeStamp[6];
   int m_timeCodePosition;
 
@@ -32,6 +32,10 @@
 #include "peripherals/Peripherals.h"
 #include "PlayListPlayer.h"
 #include "profiles/ProfilesManager.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "input/InputManager.h"
 #include "interfaces/AnnouncementManager.h"
@@ -46,8 +50,114 @@
 #include "weather/WeatherManager.h"
 #include "DatabaseManager.h"
 
+#include <functional>
+#include <vector>
+
 using namespace KODI;
 
+namespace
+{
+  // Shared by the jobs of one stage, which may be destroyed after the stage returned
+  struct InitState
+  {
+    CCriticalSection section;
+    CEvent changed;
+    unsigned int pending = 0;
+    bool failed = false;
+  };
+
+  class CServiceInitJob : public CJob
+  {
+  public:
+    CServiceInitJob(const char *name, std::function<bool()> init, std::shared_ptr<InitState> state) :
+      m_name(name),
+      m_init(std::move(init)),
+      m_state(std::move(state))
+    {
+    }
+
+    ~CServiceInitJob() override
+    {
+      // Also destroyed without being run if a job it depends on failed
+      CSingleLock lock(m_state->section);
+      if (!m_done)
+        m_state->failed = true;
+      m_state->pending--;
+      m_state->changed.Set();
+    }
+
+    bool DoWork() override
+    {
+      {
+        // The job manager runs jobs whose dependencies already completed, failed or not
+        CSingleLock lock(m_state->section);
+        if (m_state->failed)
+          return false;
+      }
+
+      const unsigned int start = XbmcThreads::SystemClockMillis();
+      m_done = m_init();
+      CLog::Log(LOGNOTICE, "CServiceManager: %s %s in %u ms", m_done ? "initialized" : "failed to initialize",
+                m_name, XbmcThreads::SystemClockMillis() - start);
+
+      return m_done;
+    }
+
+    const char *GetType() const override { return m_name; }
+
+  private:
+    const char *const m_name;
+    const std::function<bool()> m_init;
+    const std::shared_ptr<InitState> m_state;
+    bool m_done = false;
+  };
+
+  /*!
+   * \brief Initializes services on the job manager's workers, each once the
+   *        services it depends on are initialized
+   */
+  class CServiceInitGraph
+  {
+  public:
+    CServiceInitGraph() : m_state(std::make_shared<InitState>()) { }
+
+    /*!
+     * \return the id to pass as dependency of other services
+     */
+    unsigned int Add(const char *name, std::function<bool()> init, const std::vector<unsigned int> &dependencies = {})
+    {
+      {
+        CSingleLock lock(m_state->section);
+        m_state->pending++;
+      }
+
+      return CJobManager::GetInstance().AddJob(new CServiceInitJob(name, std::move(init), m_state),
+                                               nullptr, CJob::PRIORITY_HIGH, dependencies);
+    }
+
+    /*!
+     * \brief Wait until all services are initialized or skipped
+     *
+     * \return false if a service failed, the services depending on it are skipped
+     */
+    bool Wait()
+    {
+      while (true)
+      {
+        {
+          CSingleLock lock(m_state->section);
+          if (m_state->pending == 0)
+            return !m_state->failed;
+        }
+        m_state->changed.Wait();
+      }
+    }
+
+  private:
+    const std::shared_ptr<InitState> m_state;
+  };
+}
+
 CServiceManager::CServiceManager()
 {
 }
@@ -141,40 +251,64 @@ bool CServiceManager::InitStageTwo(const CAppParamParser &params)
   m_databaseManager.reset(new CDatabaseManager);
 
   m_Platform.reset(CPlatform::CreateInstance());
-  m_Platform->Init();
 
   m_binaryAddonManager.reset(new ADDON::CBinaryAddonManager()); /* Need to constructed before, GetRunningInstance() of binary CAddonDll need to call them */
   m_addonMgr.reset(new ADDON::CAddonMgr());
-  if (!m_addonMgr->Init())
-  {
-    CLog::Log(LOGFATAL, "CServiceManager::%s: Unable to start CAddonMgr", __FUNCTION__);
-    return false;
-  }
+  m_vfsAddonCache.reset(new ADDON::CVFSAddonCache());
+  m_binaryAddonCache.reset( new ADDON::CBinaryAddonCache());
+  m_powerManager.reset(new CPowerManager());
 
-  if (!m_binaryAddonManager->Init())
+  const unsigned int start = XbmcThreads::SystemClockMillis();
+
+  // The services below only depend on what's listed, the rest of the stage
+  // is constructed on this thread in the meantime
+  CServiceInitGraph graph;
+
+  const unsigned int addonMgr = graph.Add("CAddonMgr", [this]()
   {
-    CLog::Log(LOGFATAL, "CServiceManager::%s: Unable to initialize CBinaryAddonManager", __FUNCTION__);
-    return false;
-  }
+    if (!m_addonMgr->Init())
+    {
+      CLog::Log(LOGFATAL, "CServiceManager::InitStageTwo: Unable to start CAddonMgr");
+      return false;
+    }
+    return true;
+  });
+
+  const unsigned int binaryAddonManager = graph.Add("CBinaryAddonManager", [this]()
+  {
+    if (!m_binaryAddonManager->Init())
+    {
+      CLog::Log(LOGFATAL, "CServiceManager::InitStageTwo: Unable to initialize CBinaryAddonManager");
+      return false;
+    }
+    return true;
+  }, { addonMgr });
+
+  graph.Add("CVFSAddonCache", [this]()
+  {
+    m_vfsAddonCache->Init();
+    return true;
+  }, { binaryAddonManager });
 
-  m_repositoryUpdater.reset(new ADDON::CRepositoryUpdater(*m_addonMgr));
+  graph.Add("CBinaryAddonCache", [this]()
+  {
+    m_binaryAddonCache->Init();
+    return true;
+  }, { binaryAddonManager });
 
-  m_vfsAddonCache.reset(new ADDON::CVFSAddonCache());
-  m_vfsAddonCache->Init();
+  graph.Add("CPowerManager", [this]()
+  {
+    m_powerManager->Initialize();
+    m_powerManager->SetDefaults();
+    return true;
+  });
 
-  m_PVRManager.reset(new PVR::CPVRManager());
+  m_Platform->Init();
 
   m_dataCacheCore.reset(new CDataCacheCore());
 
-  m_binaryAddonCache.reset( new ADDON::CBinaryAddonCache());
-  m_binaryAddonCache->Init();
-
   m_favouritesService.reset(new CFavouritesService(m_profileManager->GetProfileUserDataFolder()));
 
-  m_serviceAddons.reset(new ADDON::CServiceAddonManager(*m_addonMgr));
-
-  m_contextMenuManager.reset(new CContextMenuManager(*m_addonMgr.get()));
-
   m_gameControllerManager.reset(new GAME::CControllerManager);
   m_inputManager.reset(new CInputManager(params));
   m_inputManager->InitializeInputs();
@@ -185,13 +319,24 @@ bool CServiceManager::InitStageTwo(const CAppParamParser &params)
 
   m_gameRenderManager.reset(new RETRO::CGUIGameRenderManager);
 
+  if (!graph.Wait())
+    return false;
+
+  CLog::Log(LOGNOTICE, "CServiceManager: add-ons and power management initialized in %u ms",
+            XbmcThreads::SystemClockMillis() - start);
+
+  // These subscribe to the add-on manager, or query it
+  m_repositoryUpdater.reset(new ADDON::CRepositoryUpdater(*m_addonMgr));
+
+  m_PVRManager.reset(new PVR::CPVRManager());
+
+  m_serviceAddons.reset(new ADDON::CServiceAddonManager(*m_addonMgr));
+
+  m_contextMenuManager.reset(new CContextMenuManager(*m_addonMgr.get()));
+
   m_fileExtensionProvider.reset(new CFileExtensionProvider(*m_addonMgr,
                                                            *m_binaryAddonManager));
 
-  m_powerManager.reset(new CPowerManager());
-  m_powerManager->Initialize();
-  m_powerManager->SetDefaults();
-
   m_weatherManager.reset(new CWeatherManager());
 
   init_level = 2;
@@ -22,6 +22,7 @@
 #include "GUIInfoManager.h"
 #include "filesystem/DllLibCurl.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/StatCache.h"
 #include "GUIPassword.h"
 #include "utils/LangCodeExpander.h"
 #include "PartyModeManager.h"
@@ -45,6 +46,7 @@ std::map<std::string, std::string> CSpecialProtocol::m_pathMap;
   CLocalizeStrings   g_localizeStringsTemp;
 
   XFILE::CDirectoryCache g_directoryCache;
+  XFILE::CStatCache      g_statCache;
 
   CGUIPassword       g_passwordManager;
 
@@ -23,14 +23,18 @@
 #include "filesystem/File.h"
 #include "profiles/ProfilesManager.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/Crc32.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
+#include "utils/Metrics.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
 #include "URL.h"
 #include "ServiceBroker.h"
 
+#include <algorithm>
+
 using namespace XFILE;
 
 CTextureCache &CTextureCache::GetInstance()
@@ -39,24 +43,49 @@ CTextureCache &CTextureCache::GetInstance()
   return s_cache;
 }
 
-CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE)
+CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE),
+  m_hits(CMetrics::GetInstance().GetCounter("kodi_texture_cache_hits_total", "Images found in the texture cache")),
+  m_misses(CMetrics::GetInstance().GetCounter("kodi_texture_cache_misses_total", "Images not in the texture cache yet"))
 {
+  CMetrics::GetInstance().RegisterGauge("kodi_texture_cache_hit_ratio", "Share of the images found in the texture cache, 0 to 1", [this]()
+  {
+    const uint64_t hits = m_hits.GetValue();
+    const uint64_t total = hits + m_misses.GetValue();
+    return total ? static_cast<double>(hits) / total : 0.0;
+  });
 }
 
-CTextureCache::~CTextureCache() = default;
+CTextureCache::~CTextureCache()
+{
+  CMetrics::GetInstance().UnregisterGauge("kodi_texture_cache_hit_ratio");
+}
 
 void CTextureCache::Initialize()
 {
   CSingleLock lock(m_databaseSection);
   if (!m_database.IsOpen())
     m_database.Open();
+  m_useCountsFlushed = XbmcThreads::SystemClockMillis();
+  lock.Leave();
+
+  // pick up where an interrupted pre-cache run left off
+  if (CFile::Exists(GetPrecacheMarker()))
+    PrecacheLibrary();
 }
 
 void CTextureCache::Deinitialize()
 {
+  {
+    CSingleLock lock(m_precacheSection);
+    for (unsigned int jobID : m_precacheJobs)
+      CJobManager::GetInstance().CancelJob(jobID);
+    m_precacheJobs.clear();
+  }
   CancelJobs();
+  FlushUseCounts(true);
   CSingleLock lock(m_databaseSection);
   m_database.Close();
+  m_index.clear();
 }
 
 bool CTextureCache::IsCachedImage(const std::string &url) const
@@ -97,13 +126,24 @@ std::string CTextureCache::GetCachedImage(const std::string &image, CTextureDeta
   // lookup the item in the database
   if (GetCachedTexture(url, details))
   {
+    m_hits.Increment();
     if (trackUsage)
       IncrementUseCount(details);
     return GetCachedPath(details.file);
   }
+  m_misses.Increment();
   return "";
 }
 
+bool CTextureCache::UseDDS()
+{
+#if defined(HAS_GL) || defined(HAS_DX)
+  return g_advancedSettings.m_useDDSFanart;
+#else
+  return false; // no DXT support on GLES
+#endif
+}
+
 bool CTextureCache::CanCacheImageURL(const CURL &url)
 {
   return url.GetUserName().empty() || url.GetUserName() == "music" ||
@@ -116,7 +156,17 @@ std::string CTextureCache::CheckCachedImage(const std::string &url, bool &needsR
   std::string path(GetCachedImage(url, details, true));
   needsRecaching = !details.hash.empty();
   if (!path.empty())
+  {
+    if (UseDDS() && !details.file.empty())
+    {
+      std::string ddsPath = URIUtils::ReplaceExtension(path, ".dds");
+      if (CFile::Exists(ddsPath))
+        return ddsPath;
+      // compress it for next time
+      AddJob(new CTextureDDSJob(path));
+    }
     return path;
+  }
   return "";
 }
 
@@ -217,43 +267,84 @@ bool CTextureCache::ClearCachedImage(int id)
 bool CTextureCache::GetCachedTexture(const std::string &url, CTextureDetails &details)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.GetCachedTexture(url, details);
+  // every image shown hits this, so remember what the database told us rather than
+  // asking again. Images that aren't cached yet aren't remembered.
+  auto it = m_index.find(url);
+  if (it == m_index.end())
+  {
+    CIndexEntry entry;
+    if (!m_database.GetCachedTexture(url, entry.details, entry.hash, entry.lastHashCheck))
+      return false;
+    it = m_index.insert(std::make_pair(url, entry)).first;
+  }
+  details = it->second.details;
+  if (CTextureDatabase::NeedsHashCheck(it->second.lastHashCheck))
+    details.hash = it->second.hash;
+  return true;
 }
 
 bool CTextureCache::AddCachedTexture(const std::string &url, const CTextureDetails &details)
 {
   CSingleLock lock(m_databaseSection);
+  m_index.erase(url);
   return m_database.AddCachedTexture(url, details);
 }
 
 void CTextureCache::IncrementUseCount(const CTextureDetails &details)
 {
   static const size_t count_before_update = 100;
+  static const unsigned int time_before_update = 60000;
   CSingleLock lock(m_useCountSection);
   m_useCounts.reserve(count_before_update);
   m_useCounts.push_back(details);
-  if (m_useCounts.size() >= count_before_update)
+  if (m_useCounts.size() >= count_before_update ||
+      XbmcThreads::SystemClockMillis() - m_useCountsFlushed >= time_before_update)
+    FlushUseCounts();
+}
+
+void CTextureCache::FlushUseCounts(bool immediately /* = false */)
+{
+  CSingleLock lock(m_useCountSection);
+  m_useCountsFlushed = XbmcThreads::SystemClockMillis();
+  if (m_useCounts.empty())
+    return;
+
+  // all pending updates are written in a single transaction
+  if (immediately)
   {
-    AddJob(new CTextureUseCountJob(m_useCounts));
-    m_useCounts.clear();
+    CTextureUseCountJob job(m_useCounts);
+    job.DoWork();
   }
+  else
+    AddJob(new CTextureUseCountJob(m_useCounts));
+  m_useCounts.clear();
 }
 
 bool CTextureCache::SetCachedTextureValid(const std::string &url, bool updateable)
 {
   CSingleLock lock(m_databaseSection);
+  m_index.erase(url);
   return m_database.SetCachedTextureValid(url, updateable);
 }
 
 bool CTextureCache::ClearCachedTexture(const std::string &url, std::string &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
+  m_index.erase(url);
   return m_database.ClearCachedTexture(url, cachedURL);
 }
 
 bool CTextureCache::ClearCachedTexture(int id, std::string &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
+  for (auto it = m_index.begin(); it != m_index.end(); ++it)
+  {
+    if (it->second.details.id == id)
+    {
+      m_index.erase(it);
+      break;
+    }
+  }
   return m_database.ClearCachedTexture(id, cachedURL);
 }
 
@@ -279,7 +370,16 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
     if (job->m_oldHash == job->m_details.hash)
       SetCachedTextureValid(job->m_url, job->m_details.updateable);
     else
+    {
       AddCachedTexture(job->m_url, job->m_details);
+
+      // any compressed copy was made from the previous version of the image
+      std::string ddsPath = URIUtils::ReplaceExtension(GetCachedPath(job->m_details.file), ".dds");
+      if (CFile::Exists(ddsPath))
+        CFile::Delete(ddsPath);
+      if (UseDDS())
+        AddJob(new CTextureDDSJob(GetCachedPath(job->m_details.file)));
+    }
   }
 
   { // remove from our processing list
@@ -294,11 +394,61 @@ void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
 
 void CTextureCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
+  if (strcmp(job->GetType(), kJobTypePrecacheArt) == 0)
+    return OnPrecacheComplete(jobID, success); // not one of our queue's jobs
   if (strcmp(job->GetType(), kJobTypeCacheImage) == 0)
     OnCachingComplete(success, static_cast<CTextureCacheJob*>(job));
   return CJobQueue::OnJobComplete(jobID, success, job);
 }
 
+std::string CTextureCache::GetPrecacheMarker()
+{
+  return URIUtils::AddFileToFolder(CServiceBroker::GetProfileManager().GetThumbnailsFolder(), "precache.pending");
+}
+
+void CTextureCache::PrecacheLibrary()
+{
+  CSingleLock lock(m_precacheSection);
+  if (!m_precacheJobs.empty())
+    return; // already running
+
+  // leave a marker so that an interrupted run is resumed on the next start
+  std::string marker = GetPrecacheMarker();
+  if (!CFile::Exists(marker))
+  {
+    CFile file;
+    if (file.OpenForWrite(marker, true))
+      file.Close();
+  }
+
+  unsigned int jobs = std::max(g_advancedSettings.m_artPrecacheJobs, 1u);
+  CLog::Log(LOGDEBUG, "%s - caching library art using %u jobs", __FUNCTION__, jobs);
+  m_precacheFailed = false;
+  for (unsigned int i = 0; i < jobs; i++)
+    m_precacheJobs.insert(CJobManager::GetInstance().AddJob(new CTexturePrecacheJob(i, jobs, g_advancedSettings.m_artPrecacheDelay),
+                                                            this, CJob::PRIORITY_LOW_PAUSABLE));
+}
+
+bool CTextureCache::IsPrecaching() const
+{
+  CSingleLock lock(m_precacheSection);
+  return !m_precacheJobs.empty();
+}
+
+void CTextureCache::OnPrecacheComplete(unsigned int jobID, bool success)
+{
+  CSingleLock lock(m_precacheSection);
+  if (m_precacheJobs.erase(jobID) == 0)
+    return;
+  if (!success)
+    m_precacheFailed = true;
+  if (m_precacheJobs.empty() && !m_precacheFailed)
+  {
+    CLog::Log(LOGDEBUG, "%s - finished caching library art", __FUNCTION__);
+    CFile::Delete(GetPrecacheMarker());
+  }
+}
+
 void CTextureCache::OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob *job)
 {
   if (strcmp(job->GetType(), kJobTypeCacheImage) == 0 && !progress)
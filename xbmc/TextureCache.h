@@ -22,6 +22,7 @@
 
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "utils/JobManager.h"
 #include "TextureDatabase.h"
@@ -29,6 +30,7 @@
 
 class CURL;
 class CBaseTexture;
+class CMetricCounter;
 
 /*!
  \ingroup textures
@@ -100,6 +102,17 @@ public:
    */
   bool CacheImage(const std::string &image, CTextureDetails &details);
 
+  /*! \brief Cache all art of the video and music libraries in the background
+   Runs advancedsettings' artprecachejobs jobs at once. An interrupted run is resumed
+   the next time the texture cache is initialized.
+   \sa CTexturePrecacheJob
+   */
+  void PrecacheLibrary();
+
+  /*! \brief Check whether library art is currently being pre-cached
+   */
+  bool IsPrecaching() const;
+
   /*! \brief Check whether an image is in the cache
    Note: If the image url won't normally be cached (eg a skin image) this function will return false.
    \param image url of the image
@@ -168,6 +181,12 @@ private:
    */
   bool IsCachedImage(const std::string &image) const;
 
+  /*! \brief Check whether cached images should be given a DXT compressed .dds copy
+   Enabled via advancedsettings (useddsfanart) on renderers that can upload DXT textures.
+   \sa CTextureDDSJob
+   */
+  static bool UseDDS();
+
   /*! \brief retrieve the cached version of the given image (if it exists)
    \param image url of the image
    \param details [out] the details of the texture.
@@ -219,12 +238,44 @@ private:
    */
   void OnCachingComplete(bool success, CTextureCacheJob *job);
 
+  /*! \brief Called when one of the library pre-cache jobs has completed.
+   Once all jobs of a run have succeeded the run is marked as finished.
+   */
+  void OnPrecacheComplete(unsigned int jobID, bool success);
+
+  /*! \brief Path of the marker file that exists while a library pre-cache run is unfinished
+   */
+  static std::string GetPrecacheMarker();
+
+  /*! \brief Write out the use counts collected by IncrementUseCount
+   \param immediately run the update on the calling thread rather than as a background job
+   */
+  void FlushUseCounts(bool immediately = false);
+
+  /*! \brief An entry of the in-memory index of texture lookups
+   */
+  struct CIndexEntry
+  {
+    CTextureDetails details;
+    std::string hash;
+    CDateTime lastHashCheck;
+  };
+
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
+  std::unordered_map<std::string, CIndexEntry> m_index; ///< lookups already made, protected by m_databaseSection
   std::set<std::string> m_processinglist; ///< currently processing list to avoid 2 jobs being processed at once
   CCriticalSection     m_processingSection;
   CEvent               m_completeEvent; ///< Set whenever a job has finished
   std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
+  unsigned int                 m_useCountsFlushed = 0; ///< time (ms) m_useCounts were last written out
   CCriticalSection             m_useCountSection;
+
+  std::set<unsigned int> m_precacheJobs; ///< library pre-cache jobs still running
+  bool                   m_precacheFailed = false;
+  mutable CCriticalSection m_precacheSection;
+
+  CMetricCounter &m_hits;   ///< images found in the cache
+  CMetricCounter &m_misses; ///< images that weren't cached yet
 };
 
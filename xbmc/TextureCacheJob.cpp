@@ -20,6 +20,7 @@
 
 #include "TextureCacheJob.h"
 #include "TextureCache.h"
+#include "guilib/DDSImage.h"
 #include "guilib/Texture.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
@@ -33,10 +34,15 @@
 #include "FileItem.h"
 #include "music/MusicThumbLoader.h"
 #include "music/tags/MusicInfoTag.h"
+#include "music/MusicDatabase.h"
+#include "threads/Thread.h"
+#include "video/VideoDatabase.h"
 #if defined(TARGET_RASPBERRY_PI)
 #include "cores/omxplayer/OMXImage.h"
 #endif
 
+#include <algorithm>
+
 CTextureCacheJob::CTextureCacheJob(const std::string &url, const std::string &oldHash):
   m_url(url),
   m_oldHash(oldHash),
@@ -103,7 +109,14 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
     return true;
   }
 #endif
-  CBaseTexture *texture = LoadImage(image, width, height, additional_info, true);
+  // CPicture::CacheTexture never stores anything larger than the image/fanart resolution,
+  // so there is no point in decoding more than that (jpegs are reduced while decoding)
+  unsigned int maxHeight = std::max(g_advancedSettings.m_imageRes, g_advancedSettings.m_fanartRes);
+  unsigned int maxWidth = maxHeight * 16 / 9;
+  unsigned int loadWidth = width ? std::min(width, maxWidth) : maxWidth;
+  unsigned int loadHeight = height ? std::min(height, maxHeight) : maxHeight;
+
+  CBaseTexture *texture = LoadImage(image, loadWidth, loadHeight, additional_info, true);
   if (texture)
   {
     if (texture->HasAlpha())
@@ -262,6 +275,89 @@ std::string CTextureCacheJob::GetImageHash(const std::string &url)
   return "";
 }
 
+CTextureDDSJob::CTextureDDSJob(const std::string &original) : m_original(original)
+{
+}
+
+bool CTextureDDSJob::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(),GetType()) == 0)
+  {
+    const CTextureDDSJob* ddsJob = dynamic_cast<const CTextureDDSJob*>(job);
+    if (ddsJob && ddsJob->m_original == m_original)
+      return true;
+  }
+  return false;
+}
+
+bool CTextureDDSJob::DoWork()
+{
+  if (URIUtils::HasExtension(m_original, ".dds"))
+    return false;
+
+  CBaseTexture *texture = CBaseTexture::LoadFromFile(m_original);
+  if (!texture)
+    return false;
+
+  // the cached image has already been scaled and oriented, so it can be compressed as is
+  CDDSImage dds;
+  bool success = dds.Create(URIUtils::ReplaceExtension(m_original, ".dds"),
+                            texture->GetWidth(), texture->GetHeight(), texture->GetPitch(), texture->GetPixels());
+  delete texture;
+  return success;
+}
+
+CTexturePrecacheJob::CTexturePrecacheJob(unsigned int slice, unsigned int slices, unsigned int delay) :
+  m_slice(slice),
+  m_slices(slices),
+  m_delay(delay)
+{
+}
+
+bool CTexturePrecacheJob::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(),GetType()) == 0)
+  {
+    const CTexturePrecacheJob* precacheJob = dynamic_cast<const CTexturePrecacheJob*>(job);
+    if (precacheJob && precacheJob->m_slice == m_slice && precacheJob->m_slices == m_slices)
+      return true;
+  }
+  return false;
+}
+
+bool CTexturePrecacheJob::DoWork()
+{
+  std::vector<std::string> urls;
+  CVideoDatabase videodb;
+  if (videodb.Open())
+  {
+    videodb.GetArtURLs(urls);
+    videodb.Close();
+  }
+  CMusicDatabase musicdb;
+  if (musicdb.Open())
+  {
+    musicdb.GetArtURLs(urls);
+    musicdb.Close();
+  }
+  // every job sees the same list, so they can split it between them
+  std::sort(urls.begin(), urls.end());
+  urls.erase(std::unique(urls.begin(), urls.end()), urls.end());
+
+  for (size_t i = m_slice; i < urls.size(); i += m_slices)
+  {
+    if (ShouldCancel(i, urls.size()))
+      return false;
+    if (urls[i].empty() || CTextureCache::GetInstance().HasCachedImage(urls[i]))
+      continue;
+
+    CTextureCache::GetInstance().CacheImage(urls[i]);
+    if (m_delay)
+      XbmcThreads::ThreadSleep(m_delay);
+  }
+  return true;
+}
+
 CTextureUseCountJob::CTextureUseCountJob(const std::vector<CTextureDetails> &textures) : m_textures(textures)
 {
 }
@@ -127,6 +127,40 @@ private:
   std::string    m_cachePath;
 };
 
+/* \brief Job class for creating a DXT compressed .dds copy of a cached image
+ */
+class CTextureDDSJob : public CJob
+{
+public:
+  explicit CTextureDDSJob(const std::string &original);
+
+  const char* GetType() const override { return kJobTypeDDSCompress; };
+  bool operator==(const CJob *job) const override;
+  bool DoWork() override;
+
+  std::string m_original;
+};
+
+/* \brief Job class for caching the art of the video and music libraries before it is displayed
+
+ The work is shared by a number of these jobs running at once, each of them caching every
+ slices'th image that isn't cached yet.
+ */
+class CTexturePrecacheJob : public CJob
+{
+public:
+  CTexturePrecacheJob(unsigned int slice, unsigned int slices, unsigned int delay);
+
+  const char* GetType() const override { return kJobTypePrecacheArt; };
+  bool operator==(const CJob *job) const override;
+  bool DoWork() override;
+
+private:
+  unsigned int m_slice;
+  unsigned int m_slices;
+  unsigned int m_delay; ///< pause between images (ms) to limit the I/O load
+};
+
 /* \brief Job class for storing the use count of textures
  */
 class CTextureUseCountJob : public CJob
@@ -23,10 +23,13 @@
 #include "XBDateTime.h"
 #include "dbwrappers/dataset.h"
 #include "URL.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 #include "utils/DatabaseUtils.h"
 
+using namespace dbiplus;
+
 enum TextureField
 {
   TF_None = 0,
@@ -158,7 +161,7 @@ CTextureDatabase::~CTextureDatabase() = default;
 
 bool CTextureDatabase::Open()
 {
-  return CDatabase::Open();
+  return CDatabase::Open(g_advancedSettings.m_databaseTextures);
 }
 
 void CTextureDatabase::CreateTables()
@@ -248,22 +251,36 @@ bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details)
 }
 
 bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails &details)
+{
+  std::string hash;
+  CDateTime lastCheck;
+  if (!GetCachedTexture(url, details, hash, lastCheck))
+    return false;
+  if (NeedsHashCheck(lastCheck))
+    details.hash = hash;
+  return true;
+}
+
+bool CTextureDatabase::NeedsHashCheck(const CDateTime &lastHashCheck)
+{
+  return lastHashCheck.IsValid() && lastHashCheck + CDateTimeSpan(1,0,0,0) < CDateTime::GetCurrentDateTime();
+}
+
+bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails &details, std::string &imageHash, CDateTime &lastHashCheck)
 {
   try
   {
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    std::string sql = PrepareSQL("SELECT id, cachedurl, lasthashcheck, imagehash, width, height FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size=1) WHERE url='%s'", url.c_str());
-    m_pDS->query(sql);
+    m_pDS->query("SELECT id, cachedurl, lasthashcheck, imagehash, width, height FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size=1) WHERE url=?",
+                 { field_value(url) });
     if (!m_pDS->eof())
     { // have some information
       details.id = m_pDS->fv(0).get_asInt();
       details.file  = m_pDS->fv(1).get_asString();
-      CDateTime lastCheck;
-      lastCheck.SetFromDBDateTime(m_pDS->fv(2).get_asString());
-      if (lastCheck.IsValid() && lastCheck + CDateTimeSpan(1,0,0,0) < CDateTime::GetCurrentDateTime())
-        details.hash = m_pDS->fv(3).get_asString();
+      lastHashCheck.SetFromDBDateTime(m_pDS->fv(2).get_asString());
+      imageHash = m_pDS->fv(3).get_asString();
       details.width = m_pDS->fv(4).get_asInt();
       details.height = m_pDS->fv(5).get_asInt();
       m_pDS->close();
@@ -338,17 +355,16 @@ bool CTextureDatabase::AddCachedTexture(const std::string &url, const CTextureDe
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    std::string sql = PrepareSQL("DELETE FROM texture WHERE url='%s'", url.c_str());
-    m_pDS->exec(sql);
+    m_pDS->exec("DELETE FROM texture WHERE url=?", { field_value(url) });
 
     std::string date = details.updateable ? CDateTime::GetCurrentDateTime().GetAsDBDateTime() : "";
-    sql = PrepareSQL("INSERT INTO texture (id, url, cachedurl, imagehash, lasthashcheck) VALUES(NULL, '%s', '%s', '%s', '%s')", url.c_str(), details.file.c_str(), details.hash.c_str(), date.c_str());
-    m_pDS->exec(sql);
+    m_pDS->exec("INSERT INTO texture (id, url, cachedurl, imagehash, lasthashcheck) VALUES(NULL, ?, ?, ?, ?)",
+                { field_value(url), field_value(details.file), field_value(details.hash), field_value(date) });
     int textureID = (int)m_pDS->lastinsertid();
 
     // set the size information
-    sql = PrepareSQL("INSERT INTO sizes (idtexture, size, usecount, lastusetime, width, height) VALUES(%u, 1, 1, CURRENT_TIMESTAMP, %u, %u)", textureID, details.width, details.height);
-    m_pDS->exec(sql);
+    m_pDS->exec("INSERT INTO sizes (idtexture, size, usecount, lastusetime, width, height) VALUES(?, 1, 1, CURRENT_TIMESTAMP, ?, ?)",
+                { field_value(textureID), field_value(details.width), field_value(details.height) });
   }
   catch (...)
   {
@@ -26,6 +26,7 @@
 #include "dbwrappers/Database.h"
 #include "TextureCacheJob.h"
 #include "dbwrappers/DatabaseQuery.h"
+#include "XBDateTime.h"
 
 class CVariant;
 
@@ -75,6 +76,22 @@ public:
   bool Open() override;
 
   bool GetCachedTexture(const std::string &originalURL, CTextureDetails &details);
+
+  /*! \brief Get a cached texture along with its hash check state
+   Unlike GetCachedTexture, details.hash is left empty and the stored hash is always returned
+   separately, so that callers keeping the result around can decide when it needs checking.
+   \param originalURL url of the original image
+   \param details [out] texture details
+   \param imageHash [out] hash of the image when it was cached
+   \param lastHashCheck [out] time of the last hash check, invalid if the image isn't checked for updates
+   \return true if the texture is cached, false otherwise
+   */
+  bool GetCachedTexture(const std::string &originalURL, CTextureDetails &details, std::string &imageHash, CDateTime &lastHashCheck);
+
+  /*! \brief Check whether a texture is due for a hash check
+   \param lastHashCheck time of the last hash check
+   */
+  static bool NeedsHashCheck(const CDateTime &lastHashCheck);
   bool AddCachedTexture(const std::string &originalURL, const CTextureDetails &details);
   bool SetCachedTextureValid(const std::string &originalURL, bool updateable);
   bool ClearCachedTexture(const std::string &originalURL, std::string &cacheFile);
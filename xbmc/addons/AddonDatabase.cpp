@@ -22,12 +22,15 @@
 
 #include <algorithm>
 #include <iterator>
+#include <map>
+#include <set>
 #include <utility>
 
 #include "addons/AddonBuilder.h"
 #include "addons/AddonManager.h"
 #include "dbwrappers/dataset.h"
 #include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/JSONVariantParser.h"
 #include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
@@ -133,7 +136,7 @@ CAddonDatabase::~CAddonDatabase() = default;
 
 bool CAddonDatabase::Open()
 {
-  return CDatabase::Open();
+  return CDatabase::Open(g_advancedSettings.m_databaseAddons);
 }
 
 int CAddonDatabase::GetMinSchemaVersion() const
@@ -792,21 +795,60 @@ bool CAddonDatabase::UpdateRepositoryContent(const std::string& repository, cons
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    DeleteRepository(repository);
+    BeginTransaction();
 
     int idRepo = SetLastChecked(repository, version, CDateTime::GetCurrentDateTime().GetAsDBDateTime());
     if (idRepo < 0)
+    {
+      RollbackTransaction();
       return false;
+    }
     assert(idRepo > 0);
 
-    m_pDB->start_transaction();
-    m_pDS->exec(PrepareSQL("UPDATE repo SET checksum='%s' WHERE id='%d'", checksum.c_str(), idRepo));
+    // the add-ons of the last update by id and version, the ones that did not
+    // change keep their rows, so only the changes of the index are written
+    struct Row
+    {
+      int id;
+      std::string metadata;
+      std::string name;
+      std::string summary;
+      std::string description;
+      std::string news;
+    };
+    std::map<std::pair<std::string, std::string>, Row> rows;
+    std::set<int> obsolete;
+    m_pDS->query(PrepareSQL("SELECT addons.id, addons.addonID, addons.version, addons.metadata, addons.name, "
+        "addons.summary, addons.description, addons.news FROM addons "
+        "JOIN addonlinkrepo ON addons.id=addonlinkrepo.idAddon WHERE addonlinkrepo.idRepo=%i", idRepo));
+    while (!m_pDS->eof())
+    {
+      Row row = { m_pDS->fv(0).get_asInt(), m_pDS->fv(3).get_asString(), m_pDS->fv(4).get_asString(),
+                  m_pDS->fv(5).get_asString(), m_pDS->fv(6).get_asString(), m_pDS->fv(7).get_asString() };
+      obsolete.insert(row.id);
+      rows[std::make_pair(m_pDS->fv(1).get_asString(), m_pDS->fv(2).get_asString())] = std::move(row);
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    unsigned int added = 0;
     for (const auto& addon : addons)
     {
+      std::string metadata = SerializeMetadata(*addon);
+      auto row = rows.find(std::make_pair(addon->ID(), addon->Version().asString()));
+      if (row != rows.end() && row->second.metadata == metadata && row->second.name == addon->Name() &&
+          row->second.summary == addon->Summary() && row->second.description == addon->Description() &&
+          row->second.news == addon->ChangeLog())
+      {
+        obsolete.erase(row->second.id);
+        rows.erase(row);
+        continue;
+      }
+
       m_pDS->exec(PrepareSQL(
           "INSERT INTO addons (id, metadata, addonID, version, name, summary, description, news) "
           "VALUES (NULL, '%s', '%s', '%s', '%s','%s', '%s','%s')",
-          SerializeMetadata(*addon).c_str(),
+          metadata.c_str(),
           addon->ID().c_str(),
           addon->Version().asString().c_str(),
           addon->Name().c_str(),
@@ -823,9 +865,24 @@ bool CAddonDatabase::UpdateRepositoryContent(const std::string& repository, cons
       }
 
       m_pDS->exec(PrepareSQL("INSERT INTO addonlinkrepo (idRepo, idAddon) VALUES (%i, %i)", idRepo, idAddon));
+      ++added;
+    }
+
+    if (!obsolete.empty())
+    {
+      std::vector<std::string> ids;
+      for (int id : obsolete)
+        ids.push_back(std::to_string(id));
+      std::string list = StringUtils::Join(ids, ",");
+      m_pDS->exec(PrepareSQL("DELETE FROM addons WHERE id IN (%s)", list.c_str()));
+      m_pDS->exec(PrepareSQL("DELETE FROM addonlinkrepo WHERE idRepo=%i AND idAddon IN (%s)", idRepo, list.c_str()));
     }
 
-    m_pDB->commit_transaction();
+    m_pDS->exec(PrepareSQL("UPDATE repo SET checksum='%s' WHERE id='%d'", checksum.c_str(), idRepo));
+    CommitTransaction();
+
+    CLog::Log(LOGDEBUG, "%s: repo '%s' added %u, removed %zu, kept %zu add-ons", __FUNCTION__, repository.c_str(),
+        added, obsolete.size(), addons.size() - added);
     return true;
   }
   catch (...)
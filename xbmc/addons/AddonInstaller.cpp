@@ -38,6 +38,8 @@
 #include "messaging/helpers/DialogOKHelper.h"
 #include "favourites/FavouritesService.h"
 #include "FilesystemInstaller.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
 #include "utils/JobManager.h"
 #include "addons/AddonManager.h"
 #include "addons/Repository.h"
@@ -52,6 +54,9 @@
 #endif
 
 #include <functional>
+#include <memory>
+#include <set>
+#include <vector>
 
 using namespace XFILE;
 using namespace ADDON;
@@ -60,6 +65,8 @@ using namespace KODI::MESSAGING;
 using KODI::MESSAGING::HELPERS::DialogResponse;
 using KODI::UTILITY::TypedDigest;
 
+#define ADDON_DEPENDENCY_DOWNLOADS 4 // dependency packages downloaded at once
+
 CAddonInstaller::CAddonInstaller() : m_idle(true)
 { }
 
@@ -144,6 +151,30 @@ bool CAddonInstaller::GetProgress(const std::string &addonID, unsigned int &perc
   return false;
 }
 
+bool CAddonInstaller::GetDependencyDownloads(const std::string &addonID, unsigned int &downloaded, unsigned int &total) const
+{
+  CSingleLock lock(m_critSection);
+  JobMap::const_iterator i = m_downloadJobs.find(addonID);
+  if (i != m_downloadJobs.end())
+  {
+    downloaded = i->second.dependenciesDownloaded;
+    total = i->second.dependencies;
+    return true;
+  }
+  return false;
+}
+
+void CAddonInstaller::OnDependencyDownloads(const std::string &addonID, unsigned int downloaded, unsigned int total)
+{
+  CSingleLock lock(m_critSection);
+  JobMap::iterator i = m_downloadJobs.find(addonID);
+  if (i != m_downloadJobs.end())
+  {
+    i->second.dependenciesDownloaded = downloaded;
+    i->second.dependencies = total;
+  }
+}
+
 bool CAddonInstaller::Cancel(const std::string &addonID)
 {
   CSingleLock lock(m_critSection);
@@ -506,6 +537,9 @@ bool CAddonInstallJob::DoWork()
     return false;
   }
 
+  if (!DownloadDependencies())
+    return false;
+
   std::string installFrom;
   {
     // Addons are installed by downloading the .zip package on the server to the local
@@ -544,7 +578,8 @@ bool CAddonInstallJob::DoWork()
         return false;
       }
 
-      // check that we don't already have a valid copy
+      // check that we don't already have a valid copy, keep one that was
+      // downloaded along with the other dependencies of an install
       if (!hash.Empty())
       {
         std::string hashExisting;
@@ -552,7 +587,7 @@ bool CAddonInstallJob::DoWork()
         {
           db.RemovePackage(package);
         }
-        if (CFile::Exists(package))
+        if (CFile::Exists(package) && TypedDigest{hash.type, CUtil::GetFileDigest(package, hash.type)} != hash)
         {
           CFile::Delete(package);
         }
@@ -660,6 +695,141 @@ bool CAddonInstallJob::DoWork()
   return true;
 }
 
+namespace
+{
+/*!
+ \brief State of the dependency downloads of an install, shared with the download
+ jobs so that a job finishing after the install was cancelled has somewhere to report to.
+ */
+struct CDependencyDownloads
+{
+  CCriticalSection section;
+  CEvent done;
+  unsigned int pending = 0;
+  unsigned int downloaded = 0;
+};
+
+struct DependencyPackage
+{
+  std::string id;
+  std::string path;
+  std::string package;
+  TypedDigest hash;
+};
+
+bool DownloadDependencyPackage(const DependencyPackage& dependency)
+{
+  // download next to the package and move it in place once verified, so that
+  // an install of the same add-on never sees a partial package
+  std::string temp = dependency.package + "." + StringUtils::CreateUUID() + ".tmp";
+  if (!CFile::Copy(dependency.path, temp))
+  {
+    CLog::Log(LOGWARNING, "CAddonInstallJob: failed to download %s", dependency.path.c_str());
+    CFile::Delete(temp);
+    return false;
+  }
+
+  if (!dependency.hash.Empty() &&
+      TypedDigest{dependency.hash.type, CUtil::GetFileDigest(temp, dependency.hash.type)} != dependency.hash)
+  {
+    CLog::Log(LOGWARNING, "CAddonInstallJob: hash mismatch of %s", dependency.path.c_str());
+    CFile::Delete(temp);
+    return false;
+  }
+
+  if (!CFile::Rename(temp, dependency.package))
+  {
+    CFile::Delete(temp);
+    return CFile::Exists(dependency.package);
+  }
+  return true;
+}
+}
+
+bool CAddonInstallJob::DownloadDependencies()
+{
+  // the dependencies Install() and the installs of the dependencies would
+  // download one after the other, found by walking the whole dependency graph
+  std::vector<DependencyPackage> dependencies;
+  std::set<std::string> visited;
+  std::vector<AddonPtr> addons{m_addon};
+  while (!addons.empty())
+  {
+    AddonPtr addon = addons.back();
+    addons.pop_back();
+    for (const auto& dep : addon->GetDependencies())
+    {
+      if (dep.id == "xbmc.metadata" || !visited.insert(dep.id).second)
+        continue;
+
+      AddonPtr installed;
+      bool haveAddon = CServiceBroker::GetAddonMgr().GetAddon(dep.id, installed, ADDON_UNKNOWN, false);
+      if ((haveAddon && installed->MeetsVersion(dep.requiredVersion)) || (!haveAddon && dep.optional) ||
+          CAddonInstaller::GetInstance().HasJob(dep.id))
+        continue;
+
+      // failures are reported by the install of the dependency
+      RepositoryPtr repo;
+      AddonPtr dependency;
+      if (!CAddonInstallJob::GetAddon(dep.id, repo, dependency))
+        continue;
+      addons.push_back(dependency);
+
+      CRepository::ResolveResult resolved = repo->ResolvePathAndHash(dependency);
+      std::string package = URIUtils::AddFileToFolder("special://home/addons/packages/",
+                                                      URIUtils::GetFileName(dependency->Path()));
+      if (!resolved.location.empty() && !CFile::Exists(package))
+        dependencies.push_back(DependencyPackage{dep.id, resolved.location, package, resolved.digest});
+    }
+  }
+
+  if (dependencies.empty())
+    return true;
+
+  CLog::Log(LOGDEBUG, "CAddonInstallJob[%s]: downloading %zu dependencies", m_addon->ID().c_str(), dependencies.size());
+  SetText(g_localizeStrings.Get(24078));
+
+  // each download mostly waits on the network, so keep several going
+  std::shared_ptr<CDependencyDownloads> downloads = std::make_shared<CDependencyDownloads>();
+  downloads->pending = static_cast<unsigned int>(dependencies.size());
+  CJobQueue queue(false, ADDON_DEPENDENCY_DOWNLOADS, CJob::PRIORITY_NORMAL);
+  for (const auto& dependency : dependencies)
+  {
+    queue.Submit([downloads, dependency]()
+    {
+      bool success = DownloadDependencyPackage(dependency);
+
+      CSingleLock lock(downloads->section);
+      if (success)
+        downloads->downloaded++;
+      downloads->pending--;
+      downloads->done.Set();
+    });
+  }
+
+  unsigned int total = static_cast<unsigned int>(dependencies.size());
+  CSingleLock lock(downloads->section);
+  while (downloads->pending > 0)
+  {
+    unsigned int finished = total - downloads->pending;
+    unsigned int downloaded = downloads->downloaded;
+    downloads->done.Reset();
+    CSingleExit exit(downloads->section);
+
+    CAddonInstaller::GetInstance().OnDependencyDownloads(m_addon->ID(), downloaded, total);
+    if (ShouldCancel(finished, total))
+    {
+      queue.CancelJobs();
+      return false;
+    }
+    downloads->done.WaitMSec(100);
+  }
+
+  // the ones that failed are downloaded again by their install, which reports the error
+  CAddonInstaller::GetInstance().OnDependencyDownloads(m_addon->ID(), downloads->downloaded, total);
+  return true;
+}
+
 bool CAddonInstallJob::DownloadPackage(const std::string &path, const std::string &dest)
 {
   if (ShouldCancel(0, 1))
@@ -39,6 +39,15 @@ public:
   bool IsDownloading() const;
   void GetInstallList(ADDON::VECADDONS &addons) const;
   bool GetProgress(const std::string &addonID, unsigned int &percent) const;
+
+  /*! \brief Progress of the dependency packages an install downloads ahead of installing them.
+   \param addonID the add-on being installed.
+   \param downloaded [out] number of dependency packages downloaded so far.
+   \param total [out] number of dependency packages of the whole dependency graph that need a download.
+   \return false if the add-on is not being installed.
+   */
+  bool GetDependencyDownloads(const std::string &addonID, unsigned int &downloaded, unsigned int &total) const;
+  void OnDependencyDownloads(const std::string &addonID, unsigned int downloaded, unsigned int total);
   bool Cancel(const std::string &addonID);
 
   /*! \brief Installs the addon while showing a modal progress dialog
@@ -108,9 +117,13 @@ public:
     {
       jobID = id;
       progress = 0;
+      dependencies = 0;
+      dependenciesDownloaded = 0;
     }
     unsigned int jobID;
     unsigned int progress;
+    unsigned int dependencies;
+    unsigned int dependenciesDownloaded;
   };
 
   typedef std::map<std::string, CDownloadJob> JobMap;
@@ -172,6 +185,12 @@ private:
   bool Install(const std::string &installFrom, const ADDON::RepositoryPtr& repo = ADDON::RepositoryPtr());
   bool DownloadPackage(const std::string &path, const std::string &dest);
 
+  /*! \brief Download the packages of all dependencies that need installing at once,
+   so that their installs find them in the package cache.
+   \return false if cancelled.
+   */
+  bool DownloadDependencies();
+
   bool DoFileOperation(FileAction action, CFileItemList &items, const std::string &file, bool useSameJob = true);
 
   /*! \brief Queue a notification for addon installation/update failure
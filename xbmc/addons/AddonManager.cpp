@@ -27,6 +27,7 @@
 #include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -182,13 +183,16 @@ void CAddonMgr::FillCpluffMetadata(const cp_plugin_info_t* plugin, CAddonBuilder
     builder.SetLicense(CServiceBroker::GetAddonMgr().GetExtValue(metadata->configuration, "license"));
     builder.SetPackageSize(StringUtils::ToUint64(CServiceBroker::GetAddonMgr().GetExtValue(metadata->configuration, "size"), 0));
 
+    InfoMap extrainfo;
     std::string language = CServiceBroker::GetAddonMgr().GetExtValue(metadata->configuration, "language");
     if (!language.empty())
-    {
-      InfoMap extrainfo;
       extrainfo.insert(std::make_pair("language",language));
+    // python add-ons may keep their interpreter between invocations, see CScriptInvocationManager
+    std::string reuseLanguageInvoker = CServiceBroker::GetAddonMgr().GetExtValue(metadata->configuration, "reuselanguageinvoker");
+    if (!reuseLanguageInvoker.empty())
+      extrainfo.insert(std::make_pair("reuselanguageinvoker", reuseLanguageInvoker));
+    if (!extrainfo.empty())
       builder.SetExtrainfo(std::move(extrainfo));
-    }
 
     builder.SetBroken(CServiceBroker::GetAddonMgr().GetExtValue(metadata->configuration, "broken"));
 
@@ -334,6 +338,11 @@ bool CAddonMgr::Init()
     return false;
   }
 
+  // parsed descriptors of the last scan, only changed addon.xml files are parsed again
+  status = cp_set_plugin_cache(m_cp_context, CSpecialProtocol::TranslatePath("special://temp/addons.cache").c_str());
+  if (status != CP_OK)
+    CLog::Log(LOGWARNING, "ADDONS: cp_set_plugin_cache() returned status: %i", status);
+
   status = cp_register_logger(m_cp_context, cp_logger, this, CP_LOG_WARNING);
   if (status != CP_OK)
   {
@@ -673,7 +682,9 @@ bool CAddonMgr::FindAddons()
   if (m_cp_context)
   {
     result = true;
+    unsigned int start = XbmcThreads::SystemClockMillis();
     cp_scan_plugins(m_cp_context, CP_SP_UPGRADE);
+    CLog::Log(LOGDEBUG, "ADDON: scanned add-on directories in %u ms", XbmcThreads::SystemClockMillis() - start);
 
     //Sync with db
     {
@@ -0,0 +1,120 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AddonResourceUsage.h"
+
+#include <memory>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+using namespace ADDON;
+
+namespace
+{
+struct RunningThread
+{
+  CThread* thread;
+  CAddonResourceCounters* counters;
+  int64_t startTime;
+};
+
+CCriticalSection g_usageSection;
+std::map<std::string, std::unique_ptr<CAddonResourceCounters>> g_counters;
+std::vector<RunningThread> g_threads;
+
+// CThread reports its CPU time in 100ns units
+int64_t GetCpuTime(CThread* thread)
+{
+  return thread->GetAbsoluteUsage() / 10;
+}
+}
+
+CAddonResourceCounters& CAddonResourceUsage::GetCounters(const std::string& addonId)
+{
+  CSingleLock lock(g_usageSection);
+  std::unique_ptr<CAddonResourceCounters>& counters = g_counters[addonId];
+  if (!counters)
+    counters.reset(new CAddonResourceCounters());
+  return *counters;
+}
+
+void CAddonResourceUsage::ThreadStarted(const std::string& addonId)
+{
+  CThread* thread = CThread::GetCurrentThread();
+  if (!thread || addonId.empty())
+    return;
+
+  CAddonResourceCounters* counters = &GetCounters(addonId);
+  RunningThread running = { thread, counters, GetCpuTime(thread) };
+
+  CSingleLock lock(g_usageSection);
+  g_threads.push_back(running);
+}
+
+void CAddonResourceUsage::ThreadStopped()
+{
+  CThread* thread = CThread::GetCurrentThread();
+  if (!thread)
+    return;
+
+  CSingleLock lock(g_usageSection);
+  for (std::vector<RunningThread>::iterator it = g_threads.begin(); it != g_threads.end(); ++it)
+  {
+    if (it->thread == thread)
+    {
+      it->counters->m_cpuTime += GetCpuTime(thread) - it->startTime;
+      g_threads.erase(it);
+      return;
+    }
+  }
+}
+
+bool CAddonResourceUsage::Get(const std::string& addonId, AddonResourceUsage& usage)
+{
+  CSingleLock lock(g_usageSection);
+  std::map<std::string, std::unique_ptr<CAddonResourceCounters>>::const_iterator counters = g_counters.find(addonId);
+  if (counters == g_counters.end())
+    return false;
+
+  usage.cpuTime = counters->second->m_cpuTime;
+  usage.bytesRead = counters->second->m_bytesRead;
+  usage.bytesWritten = counters->second->m_bytesWritten;
+
+  // threads only leave the list under the lock, so they are still running
+  for (std::vector<RunningThread>::const_iterator it = g_threads.begin(); it != g_threads.end(); ++it)
+  {
+    if (it->counters == counters->second.get())
+      usage.cpuTime += GetCpuTime(it->thread) - it->startTime;
+  }
+  return true;
+}
+
+std::map<std::string, AddonResourceUsage> CAddonResourceUsage::GetAll()
+{
+  std::map<std::string, AddonResourceUsage> all;
+
+  CSingleLock lock(g_usageSection);
+  for (std::map<std::string, std::unique_ptr<CAddonResourceCounters>>::const_iterator it = g_counters.begin(); it != g_counters.end(); ++it)
+    Get(it->first, all[it->first]);
+  return all;
+}
@@ -0,0 +1,88 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <map>
+#include <stdint.h>
+#include <string>
+
+class CThread;
+
+namespace ADDON
+{
+
+/*!
+ \brief Resources used by an add-on since Kodi started.
+ */
+struct AddonResourceUsage
+{
+  int64_t cpuTime = 0;         //!< CPU time of the add-on's script threads in microseconds
+  uint64_t bytesRead = 0;      //!< bytes read through Kodi's VFS
+  uint64_t bytesWritten = 0;   //!< bytes written through Kodi's VFS
+};
+
+/*!
+ \brief Counters of one add-on, they live as long as Kodi so callers may keep
+ a reference.
+ */
+class CAddonResourceCounters
+{
+public:
+  void AddBytesRead(uint64_t bytes) { m_bytesRead += bytes; }
+  void AddBytesWritten(uint64_t bytes) { m_bytesWritten += bytes; }
+
+private:
+  friend class CAddonResourceUsage;
+
+  std::atomic<int64_t> m_cpuTime{0};
+  std::atomic<uint64_t> m_bytesRead{0};
+  std::atomic<uint64_t> m_bytesWritten{0};
+};
+
+/*!
+ \brief Accounts CPU time and VFS traffic per add-on, to find the add-on
+ that keeps a box busy.
+
+ CPU time is taken from the thread CPU clock of the threads running an
+ add-on's scripts, including scripts that are still running. Threads an
+ add-on starts itself, file access that bypasses Kodi's VFS and memory are
+ not accounted.
+ */
+class CAddonResourceUsage
+{
+public:
+  static CAddonResourceCounters& GetCounters(const std::string& addonId);
+
+  /*!
+   \brief Account the CPU time of the calling thread to the add-on until
+   ThreadStopped() is called on the same thread.
+   */
+  static void ThreadStarted(const std::string& addonId);
+  static void ThreadStopped();
+
+  /*!
+   \return false if nothing was accounted to the add-on.
+   */
+  static bool Get(const std::string& addonId, AddonResourceUsage& usage);
+  static std::map<std::string, AddonResourceUsage> GetAll();
+};
+
+}
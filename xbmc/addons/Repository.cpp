@@ -235,6 +235,38 @@ bool CRepository::FetchIndex(const DirInfo& repo, std::string const& digest, VEC
     return false;
   }
 
+  return ParseIndex(repo, digest, response, http.GetProperty(XFILE::FILE_PROPERTY_MIME_TYPE), addons);
+}
+
+CRepository::FetchStatus CRepository::FetchIndexIfChanged(const DirInfo& repo, std::string& etag, VECADDONS& addons) noexcept
+{
+  XFILE::CCurlFile http;
+  http.SetAcceptEncoding("gzip");
+  if (!etag.empty())
+    http.SetRequestHeader("If-None-Match", etag);
+
+  std::string response;
+  if (!http.Get(repo.info, response))
+  {
+    CLog::Log(LOGERROR, "CRepository: failed to read %s", repo.info.c_str());
+    return STATUS_ERROR;
+  }
+
+  if (!etag.empty() && http.GetHttpResponseCode() == 304)
+  {
+    CLog::Log(LOGDEBUG, "CRepository: %s not modified", repo.info.c_str());
+    return STATUS_NOT_MODIFIED;
+  }
+
+  etag = http.GetProperty(XFILE::FILE_PROPERTY_RESPONSE_HEADER, "etag");
+  if (!ParseIndex(repo, "", response, http.GetProperty(XFILE::FILE_PROPERTY_MIME_TYPE), addons))
+    return STATUS_ERROR;
+  return STATUS_OK;
+}
+
+bool CRepository::ParseIndex(const DirInfo& repo, std::string const& digest, std::string& response,
+    std::string const& mimeType, VECADDONS& addons) noexcept
+{
   if (repo.checksumType != CDigest::Type::INVALID)
   {
     std::string actualDigest = CDigest::Calculate(repo.checksumType, response);
@@ -246,7 +278,7 @@ bool CRepository::FetchIndex(const DirInfo& repo, std::string const& digest, VEC
   }
 
   if (URIUtils::HasExtension(repo.info, ".gz")
-      || CMime::GetFileTypeFromMime(http.GetProperty(XFILE::FILE_PROPERTY_MIME_TYPE)) == CMime::EFileType::FileTypeGZip)
+      || CMime::GetFileTypeFromMime(mimeType) == CMime::EFileType::FileTypeGZip)
   {
     CLog::Log(LOGDEBUG, "CRepository '%s' is gzip. decompressing", repo.info.c_str());
     std::string buffer;
@@ -264,32 +296,52 @@ bool CRepository::FetchIndex(const DirInfo& repo, std::string const& digest, VEC
 CRepository::FetchStatus CRepository::FetchIfChanged(const std::string& oldChecksum,
     std::string& checksum, VECADDONS& addons) const
 {
-  checksum = "";
-  std::vector<std::tuple<DirInfo const&, std::string>> dirChecksums;
-  for (const auto& dir : m_dirs)
+  // one line per directory: the content of its checksum file or, for
+  // directories without one, the entity tag of the index, which is then
+  // fetched conditionally
+  std::vector<std::string> oldParts = StringUtils::Split(oldChecksum, "\n");
+  if (oldParts.size() != m_dirs.size())
+    oldParts.assign(m_dirs.size(), "");
+
+  std::vector<std::string> parts;
+  std::vector<VECADDONS> dirAddons(m_dirs.size());
+  std::vector<bool> fetched(m_dirs.size(), false);
+  bool modified = false;
+  for (size_t i = 0; i < m_dirs.size(); ++i)
   {
+    const DirInfo& dir = m_dirs[i];
+    std::string part;
     if (!dir.checksum.empty())
     {
-      std::string part;
       if (!FetchChecksum(dir.checksum, part))
       {
         CLog::Log(LOGERROR, "CRepository: failed read '%s'", dir.checksum.c_str());
         return STATUS_ERROR;
       }
-      dirChecksums.emplace_back(dir, part);
-      checksum += part;
     }
+    else
+    {
+      part = oldParts[i];
+      FetchStatus status = FetchIndexIfChanged(dir, part, dirAddons[i]);
+      if (status == STATUS_ERROR)
+        return STATUS_ERROR;
+      fetched[i] = status == STATUS_OK;
+    }
+    // without checksum or entity tag the index has to be assumed changed
+    if (part.empty() || part != oldParts[i])
+      modified = true;
+    parts.push_back(std::move(part));
   }
+  checksum = StringUtils::Join(parts, "\n");
 
-  if (oldChecksum == checksum && !oldChecksum.empty())
+  if (!modified)
     return STATUS_NOT_MODIFIED;
 
-  for (const auto& dirTuple : dirChecksums)
+  for (size_t i = 0; i < m_dirs.size(); ++i)
   {
-    VECADDONS tmp;
-    if (!FetchIndex(std::get<0>(dirTuple), std::get<1>(dirTuple), tmp))
+    if (!fetched[i] && !FetchIndex(m_dirs[i], parts[i], dirAddons[i]))
       return STATUS_ERROR;
-    addons.insert(addons.end(), tmp.begin(), tmp.end());
+    addons.insert(addons.end(), dirAddons[i].begin(), dirAddons[i].end());
   }
   return STATUS_OK;
 }
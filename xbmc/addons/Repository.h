@@ -78,6 +78,13 @@ namespace ADDON
     static bool FetchChecksum(const std::string& url, std::string& checksum) noexcept;
     static bool FetchIndex(const DirInfo& repo, std::string const& digest, VECADDONS& addons) noexcept;
 
+    /*! \brief Fetch the index unless the server reports it still has the entity tag etag.
+     \param etag the entity tag of the last fetch or empty, set to the one of the fetched index.
+     */
+    static FetchStatus FetchIndexIfChanged(const DirInfo& repo, std::string& etag, VECADDONS& addons) noexcept;
+    static bool ParseIndex(const DirInfo& repo, std::string const& digest, std::string& response,
+        std::string const& mimeType, VECADDONS& addons) noexcept;
+
     static DirInfo ParseDirConfiguration(cp_cfg_element_t* configuration);
 
     DirList m_dirs;
@@ -35,6 +35,7 @@
 #include "music/infoscanner/MusicAlbumInfo.h"
 #include "music/infoscanner/MusicArtistInfo.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
 #include "utils/ScraperParser.h"
 #include "utils/ScraperUrl.h"
@@ -255,6 +256,8 @@ std::vector<std::string> CScraper::Run(const std::string &function,
                                        CCurlFile &http,
                                        const std::vector<std::string> *extras)
 {
+  // chained functions come back in here on the same thread
+  CSingleLock lock(m_parserSection);
   if (!Load())
     throw CScraperError();
 
@@ -361,6 +364,7 @@ std::string CScraper::InternalRun(const std::string &function,
 
 bool CScraper::Load()
 {
+  CSingleLock lock(m_parserSection);
   if (m_fLoaded || m_isPython)
     return true;
 
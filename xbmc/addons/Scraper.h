@@ -25,6 +25,7 @@
 
 #include "addons/Addon.h"
 #include "XBDateTime.h"
+#include "threads/CriticalSection.h"
 #include "utils/ScraperUrl.h"
 #include "utils/ScraperParser.h"
 #include "video/Episode.h"
@@ -183,6 +184,7 @@ private:
   CDateTimeSpan m_persistence;
   CONTENT_TYPE m_pathContent;
   CScraperParser m_parser;
+  CCriticalSection m_parserSection; ///< the parser holds the state of the running function
 };
 
 }
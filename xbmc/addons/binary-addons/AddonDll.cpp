@@ -19,6 +19,7 @@
  */
 
 #include "AddonDll.h"
+#include "BinaryAddonBase.h"
 
 #include "addons/AddonStatusHandler.h"
 #include "GUIUserMessages.h"
@@ -170,6 +171,9 @@ bool CAddonDll::LoadDll()
     return false;
   }
 
+  if (!m_resourceCounters)
+    m_resourceCounters = &CAddonResourceUsage::GetCounters(ID());
+
   return true;
 }
 
@@ -333,7 +337,8 @@ void CAddonDll::DestroyInstance(const std::string& instanceID)
     m_usedInstances.erase(it);
   }
 
-  if (m_usedInstances.empty())
+  // with an unload delay the add-on base unloads it once it stays unused
+  if (m_usedInstances.empty() && (!m_binaryAddonBase || m_binaryAddonBase->UnloadDelay() == 0))
     Destroy();
 }
 
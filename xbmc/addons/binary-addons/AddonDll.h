@@ -22,6 +22,7 @@
 #include "BinaryAddonManager.h"
 #include "DllAddon.h"
 #include "addons/Addon.h"
+#include "addons/AddonResourceUsage.h"
 #include "addons/interfaces/AddonInterfaces.h"
 #include "utils/XMLUtils.h"
 
@@ -79,6 +80,12 @@ namespace ADDON
 
     bool Initialized() const { return m_initialized; }
 
+    /*!
+     * @brief Counters of the resources the add-on uses through Kodi, valid
+     * once the library is loaded.
+     */
+    CAddonResourceCounters* ResourceCounters() const { return m_resourceCounters; }
+
   protected:
     static std::string GetDllPath(const std::string &strFileName);
 
@@ -107,6 +114,7 @@ namespace ADDON
     BinaryAddonBasePtr m_binaryAddonBase;
     DllAddon* m_pDll;
     bool m_initialized;
+    CAddonResourceCounters* m_resourceCounters = nullptr;
     bool LoadDll();
     std::map<std::string, std::pair<ADDON_TYPE, KODI_HANDLE>> m_usedInstances;
 
@@ -23,10 +23,14 @@
 
 #include "filesystem/SpecialProtocol.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/XMLUtils.h"
 
+// decoders create an instance per file or image, keep them loaded in between
+#define ADDON_DECODER_UNLOAD_DELAY 60
+
 using namespace ADDON;
 
 bool CBinaryAddonBase::Create()
@@ -122,10 +126,30 @@ void CBinaryAddonBase::ReleaseAddon(const IAddonInstanceHandler* handler)
   // if no handler is present anymore reset and delete the add-on class on informations
   if (m_activeAddonHandlers.empty())
   {
-    m_activeAddon.reset();
+    // keep a created add-on for the next instance, CBinaryAddonManager
+    // unloads it when it stays unused
+    if (m_unloadDelay > 0 && m_activeAddon && m_activeAddon->Initialized())
+      m_idleSince = XbmcThreads::SystemClockMillis();
+    else
+      m_activeAddon.reset();
   }
 }
 
+void CBinaryAddonBase::UnloadIdle(bool force/* = false*/)
+{
+  CSingleLock lock(m_critSection);
+
+  if (!m_activeAddon || !m_activeAddonHandlers.empty())
+    return;
+
+  if (!force && XbmcThreads::SystemClockMillis() - m_idleSince < m_unloadDelay * 1000)
+    return;
+
+  CLog::Log(LOGDEBUG, "CBinaryAddonBase::%s: Unloading unused add-on '%s'", __FUNCTION__, ID().c_str());
+  m_activeAddon->Destroy();
+  m_activeAddon.reset();
+}
+
 AddonDllPtr CBinaryAddonBase::GetActiveAddon()
 {
   CSingleLock lock(m_critSection);
@@ -187,5 +211,16 @@ bool CBinaryAddonBase::LoadAddonXML(const TiXmlElement* baseElement, const std::
   m_addonInfo.SetMainType(m_types[0].Type());
   m_addonInfo.SetLibName(m_types[0].LibName());
 
+  /*
+   * Decoders are only loaded while decoding, keep them loaded between uses
+   * unless the add-on asks for a different delay by
+   * <extension ... unloaddelay="seconds">
+   */
+  if (m_addonInfo.MainType() == ADDON_AUDIODECODER || m_addonInfo.MainType() == ADDON_IMAGEDECODER)
+    m_unloadDelay = ADDON_DECODER_UNLOAD_DELAY;
+  const SExtValue unloadDelay = m_types[0].GetValue("@unloaddelay");
+  if (!unloadDelay.empty())
+    m_unloadDelay = unloadDelay.asInteger() > 0 ? unloadDelay.asInteger() : 0;
+
   return true;
 }
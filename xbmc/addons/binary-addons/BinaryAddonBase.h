@@ -78,15 +78,31 @@ namespace ADDON
 
     AddonDllPtr GetActiveAddon();
 
+    /*!
+     * @brief Seconds the library stays loaded after its last instance is
+     * gone, so that add-ons used once per file or image are not loaded again
+     * each time. 0 unloads it together with the last instance.
+     */
+    unsigned int UnloadDelay() const { return m_unloadDelay; }
+
+    /*!
+     * @brief Unload the library if no instance used it for UnloadDelay()
+     * seconds.
+     * @param force unload an unused library regardless of the delay.
+     */
+    void UnloadIdle(bool force = false);
+
   private:
     bool LoadAddonXML(const TiXmlElement* element, const std::string& addonPath);
 
     CAddonInfo m_addonInfo;
     std::vector<CBinaryAddonType> m_types;
+    unsigned int m_unloadDelay = 0;
 
     CCriticalSection m_critSection;
     AddonDllPtr m_activeAddon;
     std::unordered_set<const IAddonInstanceHandler*> m_activeAddonHandlers;
+    unsigned int m_idleSince = 0;
   };
 
 } /* namespace ADDON */
@@ -28,10 +28,13 @@
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 
+#define ADDON_IDLE_CHECK_INTERVAL 10000
+
 using namespace ADDON;
 
 CBinaryAddonManager::CBinaryAddonManager()
-  : m_tempAddonBasePath("special://temp/binary-addons")
+  : m_tempAddonBasePath("special://temp/binary-addons"),
+    m_idleTimer(std::bind(&CBinaryAddonManager::UnloadIdleAddons, this))
 {
 }
 
@@ -61,6 +64,13 @@ bool CBinaryAddonManager::Init()
 
 void CBinaryAddonManager::DeInit()
 {
+  m_idleTimer.Stop(true);
+  {
+    CSingleLock lock(m_critSection);
+    for (auto addon : m_installedAddons)
+      addon.second->UnloadIdle(true);
+  }
+
   /* If temporary directory was used from addon delete them */
   if (XFILE::CDirectory::Exists(m_tempAddonBasePath))
     XFILE::CDirectory::RemoveRecursive(CSpecialProtocol::TranslatePath(m_tempAddonBasePath));
@@ -170,6 +180,9 @@ bool CBinaryAddonManager::AddAddonBaseEntry(BINARY_ADDON_LIST_ENTRY& entry)
   m_installedAddons[base->ID()] = base;
   if (entry.first)
     m_enabledAddons[base->ID()] = base;
+
+  if (base->UnloadDelay() > 0 && !m_idleTimer.IsRunning())
+    m_idleTimer.Start(ADDON_IDLE_CHECK_INTERVAL, true);
   return true;
 }
 
@@ -218,6 +231,7 @@ void CBinaryAddonManager::DisableEvent(const std::string& addonId)
 
   CLog::Log(LOGDEBUG, "CBinaryAddonManager::%s: Disable addon '%s' on binary addon manager", __FUNCTION__, base->ID().c_str());
   m_enabledAddons.erase(base->ID());
+  base->UnloadIdle(true);
 }
 
 void CBinaryAddonManager::InstalledChangeEvent()
@@ -248,7 +262,24 @@ void CBinaryAddonManager::InstalledChangeEvent()
   {
     CLog::Log(LOGDEBUG, "CBinaryAddonManager::%s: Removing binary addon '%s'", __FUNCTION__, addon.first.c_str());
 
+    addon.second->UnloadIdle(true);
     m_installedAddons.erase(addon.first);
     m_enabledAddons.erase(addon.first);
   }
 }
+
+void CBinaryAddonManager::UnloadIdleAddons()
+{
+  BinaryAddonBaseList addons;
+  {
+    CSingleLock lock(m_critSection);
+    for (auto addon : m_installedAddons)
+    {
+      if (addon.second->UnloadDelay() > 0)
+        addons.push_back(addon.second);
+    }
+  }
+
+  for (auto addon : addons)
+    addon->UnloadIdle();
+}
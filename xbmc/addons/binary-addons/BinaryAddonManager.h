@@ -21,6 +21,7 @@
 
 #include "addons/AddonManager.h"
 #include "threads/CriticalSection.h"
+#include "threads/Timer.h"
 
 #include <map>
 
@@ -148,6 +149,8 @@ namespace ADDON
     void DisableEvent(const std::string& addonId);
     void InstalledChangeEvent();
 
+    void UnloadIdleAddons();
+
     CCriticalSection m_critSection;
 
     typedef std::map<std::string, BinaryAddonBasePtr> BinaryAddonMgrBaseList;
@@ -155,6 +158,9 @@ namespace ADDON
     BinaryAddonMgrBaseList m_enabledAddons;
 
     const std::string m_tempAddonBasePath;
+
+    // unloads add-ons with an unload delay once they stay unused
+    CTimer m_idleTimer;
   };
 
 } /* namespace ADDON */
@@ -387,7 +387,10 @@ ssize_t Interface_Filesystem::read_file(void* kodiBase, void* file, void* ptr, s
     return -1;
   }
 
-  return static_cast<CFile*>(file)->Read(ptr, size);
+  ssize_t bytesRead = static_cast<CFile*>(file)->Read(ptr, size);
+  if (bytesRead > 0 && addon->ResourceCounters())
+    addon->ResourceCounters()->AddBytesRead(bytesRead);
+  return bytesRead;
 }
 
 bool Interface_Filesystem::read_file_string(void* kodiBase, void* file, char *szLine, int lineLength)
@@ -411,7 +414,10 @@ ssize_t Interface_Filesystem::write_file(void* kodiBase, void* file, const void*
     return -1;
   }
 
-  return static_cast<CFile*>(file)->Write(ptr, size);
+  ssize_t bytesWritten = static_cast<CFile*>(file)->Write(ptr, size);
+  if (bytesWritten > 0 && addon->ResourceCounters())
+    addon->ResourceCounters()->AddBytesWritten(bytesWritten);
+  return bytesWritten;
 }
 
 void Interface_Filesystem::flush_file(void* kodiBase, void* file)
@@ -229,6 +229,9 @@ extern "C" {
     int64_t (__cdecl* length_stream)(const AddonInstance_InputStream* instance);
     void (__cdecl* pause_stream)(const AddonInstance_InputStream* instance, double time);
     bool (__cdecl* is_real_time_stream)(const AddonInstance_InputStream* instance);
+
+    // added with 2.0.8, null for add-ons built against older versions
+    int (__cdecl* demux_read_batch)(const AddonInstance_InputStream* instance, DemuxPacket** packets, int max_packets);
   } KodiToAddonFuncTable_InputStream;
 
   typedef struct AddonInstance_InputStream /* internal */
@@ -342,6 +345,27 @@ namespace addon
      */
     virtual DemuxPacket* DemuxRead() { return nullptr; }
 
+    /*!
+     * Read up to maxPackets packets from the demultiplexer in one call.
+     * @param packets Array the packets are stored in, in stream order.
+     * @param maxPackets The size of the array.
+     * @return The number of packets stored, 0 on errors.
+     * @remarks Optional, the default returns the packet of one DemuxRead().
+     *          Kodi keeps the packets of a batch until it asked for them and
+     *          drops them on flush and seek, so only return what is already
+     *          demuxed instead of waiting for more data. End the batch after
+     *          an empty packet or one with a special stream id like
+     *          DMX_SPECIALID_STREAMCHANGE, Kodi has to handle those before
+     *          it reads on.
+     *          Packets come from AllocateDemuxPacket() as for DemuxRead(),
+     *          their buffers are recycled by Kodi.
+     */
+    virtual int DemuxReadBatch(DemuxPacket** packets, int maxPackets)
+    {
+      packets[0] = DemuxRead();
+      return packets[0] ? 1 : 0;
+    }
+
     /*!
      * Notify the InputStream addon/demuxer that Kodi wishes to seek the stream by time
      * Demuxer is required to set stream to an IDR frame
@@ -517,6 +541,8 @@ namespace addon
       m_instanceData->toAddon.length_stream = ADDON_LengthStream;
       m_instanceData->toAddon.pause_stream = ADDON_PauseStream;
       m_instanceData->toAddon.is_real_time_stream = ADDON_IsRealTimeStream;
+
+      m_instanceData->toAddon.demux_read_batch = ADDON_DemuxReadBatch;
     }
 
     inline static bool ADDON_Open(const AddonInstance_InputStream* instance, INPUTSTREAM* props)
@@ -576,6 +602,11 @@ namespace addon
       return instance->toAddon.addonInstance->DemuxRead();
     }
 
+    inline static int ADDON_DemuxReadBatch(const AddonInstance_InputStream* instance, DemuxPacket** packets, int max_packets)
+    {
+      return instance->toAddon.addonInstance->DemuxReadBatch(packets, max_packets);
+    }
+
     inline static bool ADDON_DemuxSeekTime(const AddonInstance_InputStream* instance, double time, bool backwards, double *startpts)
     {
       return instance->toAddon.addonInstance->DemuxSeekTime(time, backwards, *startpts);
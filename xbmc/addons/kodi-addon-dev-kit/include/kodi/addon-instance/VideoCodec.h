@@ -191,7 +191,24 @@ namespace kodi
       * @brief AddonToKodi interface
       */
 
-      //! \copydoc CInstanceVideoCodec::GetFrameBuffer
+      /*!
+       * @brief Get a buffer of Kodi's video buffer pool to decode a picture into
+       *
+       * The buffer is handed to the renderer as is, so a decoder that writes
+       * into it directly needs no copy of the picture. Pass it back in
+       * VIDEOCODEC_PICTURE::buffer from GetPicture(), or release it with
+       * ReleaseFrameBuffer() if it is not used.
+       *
+       * With decodedDataSize set, a buffer of that size is returned and the
+       * planes are laid out by the add-on. With decodedDataSize 0, Kodi lays
+       * out the planes of videoFormat for width and height with aligned rows
+       * and sets decodedDataSize, planeOffsets and stride, which have to be
+       * returned unchanged with the picture. Since such buffers only depend on
+       * the resolution, they are reused from frame to frame.
+       *
+       * @param[in,out] picture the picture to get the buffer for
+       * @return true on success, false if no buffer could be allocated
+       */
       bool GetFrameBuffer(VIDEOCODEC_PICTURE &picture)
       {
         return m_instanceData->toKodi.get_frame_buffer(m_instanceData->toKodi.kodiInstance, &picture);
@@ -531,6 +531,7 @@ typedef struct AddonToKodiFuncTable_Game
   game_proc_address_t (*HwGetProcAddress)(void* kodiInstance, const char* symbol);
   void (*RenderFrame)(void* kodiInstance);
   bool (*InputEvent)(void* kodiInstance, const game_input_event* event);
+  uint8_t* (*GetStreamBuffer)(void* kodiInstance, GAME_STREAM_TYPE stream, unsigned int size);
 
 } AddonToKodiFuncTable_Game;
 
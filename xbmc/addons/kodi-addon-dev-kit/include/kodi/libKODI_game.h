@@ -133,6 +133,23 @@ public:
     m_callbacks->toKodi.AddStreamData(m_callbacks->toKodi.kodiInstance, stream, data, size);
   }
 
+  /*!
+   * \brief Get memory to render the next frame of a stream into
+   *
+   * Rendering into this memory and passing it to AddStreamData() saves Kodi
+   * from copying the frame. Only the next frame can be rendered into it.
+   *
+   * \param stream The target stream
+   * \param size The size of the frame
+   *
+   * \return The memory, or NULL if the frame has to be passed in memory of
+   *         the add-on
+   */
+  uint8_t* GetStreamBuffer(GAME_STREAM_TYPE stream, unsigned int size)
+  {
+    return m_callbacks->toKodi.GetStreamBuffer(m_callbacks->toKodi.kodiInstance, stream, size);
+  }
+
   /*!
    * \brief Free the specified stream
    *
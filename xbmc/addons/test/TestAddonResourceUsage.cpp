@@ -0,0 +1,79 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "addons/AddonResourceUsage.h"
+#include "threads/Thread.h"
+
+#include "gtest/gtest.h"
+
+using namespace ADDON;
+
+namespace
+{
+class CBusyThread : public CThread
+{
+public:
+  CBusyThread() : CThread("TestAddonResourceUsage") {}
+
+protected:
+  void Process() override
+  {
+    CAddonResourceUsage::ThreadStarted("test.resourceusage.cpu");
+    volatile uint64_t sum = 0;
+    for (uint64_t i = 0; i < 50000000; i++)
+      sum += i;
+    CAddonResourceUsage::ThreadStopped();
+  }
+};
+}
+
+TEST(TestAddonResourceUsage, Unknown)
+{
+  AddonResourceUsage usage;
+  EXPECT_FALSE(CAddonResourceUsage::Get("test.resourceusage.unknown", usage));
+}
+
+TEST(TestAddonResourceUsage, Bytes)
+{
+  CAddonResourceCounters& counters = CAddonResourceUsage::GetCounters("test.resourceusage.bytes");
+  counters.AddBytesRead(100);
+  counters.AddBytesRead(20);
+  counters.AddBytesWritten(3);
+  EXPECT_EQ(&counters, &CAddonResourceUsage::GetCounters("test.resourceusage.bytes"));
+
+  AddonResourceUsage usage;
+  ASSERT_TRUE(CAddonResourceUsage::Get("test.resourceusage.bytes", usage));
+  EXPECT_EQ(120U, usage.bytesRead);
+  EXPECT_EQ(3U, usage.bytesWritten);
+  EXPECT_EQ(0, usage.cpuTime);
+
+  EXPECT_EQ(1U, CAddonResourceUsage::GetAll().count("test.resourceusage.bytes"));
+}
+
+TEST(TestAddonResourceUsage, CpuTime)
+{
+  CBusyThread thread;
+  thread.Create();
+  thread.StopThread(true);
+
+  AddonResourceUsage usage;
+  ASSERT_TRUE(CAddonResourceUsage::Get("test.resourceusage.cpu", usage));
+  EXPECT_GT(usage.cpuTime, 0);
+}
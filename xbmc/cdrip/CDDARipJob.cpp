@@ -38,6 +38,15 @@
 #include "storage/MediaManager.h"
 #include "addons/AddonManager.h"
 #include "addons/AudioEncoder.h"
+#include "threads/Condition.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+#include <atomic>
+#include <deque>
+#include <inttypes.h>
+#include <list>
+#include <vector>
 
 #if defined(TARGET_WINDOWS)
 #include "platform/win32/CharsetConverter.h"
@@ -47,6 +56,125 @@ using namespace ADDON;
 using namespace MUSIC_INFO;
 using namespace XFILE;
 
+// A whole number of CD frames of 2352 bytes, about a third of a second of audio
+#define RIP_CHUNK_SIZE       (2352 * 27)
+// Audio read ahead of the encoder, about 47 seconds
+#define RIP_READ_AHEAD_SIZE  (8 * 1024 * 1024)
+// Times a chunk is read again before the rip fails
+#define RIP_READ_RETRIES     3
+#define RIP_RETRY_DELAY_MS   500
+
+namespace
+{
+// the jobs that still have to read their track, in the order they were created
+CCriticalSection g_driveSection;
+XbmcThreads::ConditionVariable g_driveChanged;
+std::list<const CCDDARipJob*> g_driveQueue;
+
+/*!
+ \brief Chunks of a track that are read but not encoded yet
+ */
+class CChunkQueue
+{
+public:
+  //! \brief Add a chunk, waits while the encoder is too far behind
+  //! \return false if the queue was aborted
+  bool Push(std::vector<uint8_t> &&chunk)
+  {
+    CSingleLock lock(m_section);
+    while (m_size >= RIP_READ_AHEAD_SIZE && !m_aborted)
+      m_changed.wait(lock);
+    if (m_aborted)
+      return false;
+
+    m_size += chunk.size();
+    m_chunks.push_back(std::move(chunk));
+    m_changed.notifyAll();
+    return true;
+  }
+
+  //! \brief Take the next chunk, waits until one is read
+  //! \return false once the track is done, or if the queue was aborted
+  bool Pop(std::vector<uint8_t> &chunk)
+  {
+    CSingleLock lock(m_section);
+    while (m_chunks.empty() && !m_finished && !m_aborted)
+      m_changed.wait(lock);
+    if (m_aborted || m_chunks.empty())
+      return false;
+
+    chunk = std::move(m_chunks.front());
+    m_chunks.pop_front();
+    m_size -= chunk.size();
+    m_changed.notifyAll();
+    return true;
+  }
+
+  //! \brief The whole track is read
+  void Finish()
+  {
+    CSingleLock lock(m_section);
+    m_finished = true;
+    m_changed.notifyAll();
+  }
+
+  //! \brief Stop reading and encoding, the chunks left are dropped
+  void Abort()
+  {
+    CSingleLock lock(m_section);
+    m_aborted = true;
+    m_chunks.clear();
+    m_size = 0;
+    m_changed.notifyAll();
+  }
+
+private:
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_changed;
+  std::deque<std::vector<uint8_t>> m_chunks;
+  size_t m_size = 0;
+  bool m_finished = false;
+  bool m_aborted = false;
+};
+
+/*!
+ \brief Encodes the chunks of a track while the rest is read
+ */
+class CEncodeThread : public CThread
+{
+public:
+  CEncodeThread(CChunkQueue &queue, CEncoder &encoder) :
+    CThread("CDDAEncoder"), m_queue(queue), m_encoder(encoder)
+  {
+  }
+
+  bool Failed() const { return m_failed; }
+  int64_t GetEncoded() const { return m_encoded; }
+
+protected:
+  void Process() override
+  {
+    std::vector<uint8_t> chunk;
+    while (m_queue.Pop(chunk))
+    {
+      if (!m_encoder.Encode(static_cast<int>(chunk.size()), chunk.data()))
+      {
+        m_failed = true;
+        m_queue.Abort(); // stop the reader
+        break;
+      }
+      m_encoded += chunk.size();
+    }
+  }
+
+private:
+  CChunkQueue &m_queue;
+  CEncoder &m_encoder;
+  std::atomic<bool> m_failed{false};
+  std::atomic<int64_t> m_encoded{0};
+};
+}
+
 CCDDARipJob::CCDDARipJob(const std::string& input,
                          const std::string& output,
                          const CMusicInfoTag& tag, 
@@ -58,15 +186,28 @@ CCDDARipJob::CCDDARipJob(const std::string& input,
   m_input(input), m_output(CUtil::MakeLegalPath(output)), m_eject(eject),
   m_encoder(encoder)
 {
+  CSingleLock lock(g_driveSection);
+  g_driveQueue.push_back(this);
 }
 
-CCDDARipJob::~CCDDARipJob() = default;
+CCDDARipJob::~CCDDARipJob()
+{
+  // the job may be cancelled before it ran
+  ReleaseDrive();
+}
 
 bool CCDDARipJob::DoWork()
 {
   CLog::Log(LOGINFO, "Start ripping track %s to %s", m_input.c_str(),
                                                      m_output.c_str());
 
+  // tracks are read one by one, in the order they were queued
+  if (!WaitForDrive())
+  {
+    CLog::Log(LOGWARNING, "User Cancelled CDDA Rip");
+    return false;
+  }
+
   // if we are ripping to a samba share, rip it to hd first and then copy it it the share
   CFileItem file(m_output, false);
   if (file.IsRemote())
@@ -75,6 +216,7 @@ bool CCDDARipJob::DoWork()
   if (m_output.empty())
   {
     CLog::Log(LOGERROR, "CCDDARipper: Error opening file");
+    ReleaseDrive();
     return false;
   }
 
@@ -84,6 +226,7 @@ bool CCDDARipJob::DoWork()
   if (!reader.Open(m_input,READ_CACHED) || !(encoder=SetupEncoder(reader)))
   {
     CLog::Log(LOGERROR, "Error: CCDDARipper::Init failed");
+    ReleaseDrive();
     return false;
   }
 
@@ -98,14 +241,45 @@ bool CCDDARipJob::DoWork()
                                             m_tag.GetTitle().c_str());
   handle->SetText(strLine0);
 
-  // start ripping
-  int percent=0;
-  int oldpercent=0;
-  bool cancelled(false);
-  int result;
-  while (!cancelled && (result=RipChunk(reader, encoder, percent)) == 0)
+  // start ripping, the encoder works on what is read meanwhile
+  CChunkQueue queue;
+  CEncodeThread encodeThread(queue, *encoder);
+  encodeThread.Create();
+
+  const int64_t length = reader.GetLength();
+  int64_t position = 0;
+  int retries = 0;
+  int oldpercent = 0;
+  bool cancelled = false;
+  bool readError = false;
+  while (position < length)
   {
-    cancelled = ShouldCancel(percent,100);
+    std::vector<uint8_t> chunk(RIP_CHUNK_SIZE);
+    ssize_t read = reader.Read(chunk.data(), chunk.size());
+    if (read <= 0)
+    {
+      // scratched discs often read fine on the next try
+      if (++retries > RIP_READ_RETRIES)
+      {
+        readError = true;
+        break;
+      }
+      CLog::Log(LOGWARNING, "CDDARipper: Error reading %s at %" PRId64", retrying", m_input.c_str(), position);
+      XbmcThreads::ThreadSleep(RIP_RETRY_DELAY_MS);
+      reader.Seek(position, SEEK_SET);
+      continue;
+    }
+    retries = 0;
+
+    chunk.resize(read);
+    position += read;
+    if (!queue.Push(std::move(chunk)))
+      break; // the encoder failed
+
+    int percent = static_cast<int>(encodeThread.GetEncoded() * 100 / length);
+    cancelled = ShouldCancel(percent, 100);
+    if (cancelled)
+      break;
     if (percent > oldpercent)
     {
       oldpercent = percent;
@@ -113,12 +287,37 @@ bool CCDDARipJob::DoWork()
     }
   }
 
-  // close encoder ripper
+  // the next track can be read while this one is encoded
+  reader.Close();
+  ReleaseDrive();
+
+  if (cancelled || readError)
+    queue.Abort();
+  else
+    queue.Finish();
+
+  while (!encodeThread.WaitForThreadExit(250))
+  {
+    int percent = static_cast<int>(encodeThread.GetEncoded() * 100 / length);
+    if (!cancelled && ShouldCancel(percent, 100))
+    {
+      cancelled = true;
+      queue.Abort();
+    }
+    if (percent > oldpercent)
+    {
+      oldpercent = percent;
+      handle->SetPercentage(static_cast<float>(percent));
+    }
+  }
+
+  // close encoder
   encoder->CloseEncode();
   delete encoder;
-  reader.Close();
 
-  if (file.IsRemote() && !cancelled && result == 2)
+  bool success = !cancelled && !readError && !encodeThread.Failed();
+
+  if (file.IsRemote() && success)
   {
     // copy the ripped track to the share
     if (!CFile::Copy(m_output, file.GetPath()))
@@ -126,6 +325,7 @@ bool CCDDARipJob::DoWork()
       CLog::Log(LOGERROR, "CDDARipper: Error copying file from %s to %s", 
                 m_output.c_str(), file.GetPath().c_str());
       CFile::Delete(m_output);
+      handle->MarkFinished();
       return false;
     }
     // delete cached file
@@ -137,9 +337,9 @@ bool CCDDARipJob::DoWork()
     CLog::Log(LOGWARNING, "User Cancelled CDDA Rip");
     CFile::Delete(m_output);
   }
-  else if (result == 1)
+  else if (readError)
     CLog::Log(LOGERROR, "CDDARipper: Error ripping %s", m_input.c_str());
-  else if (result < 0)
+  else if (encodeThread.Failed())
     CLog::Log(LOGERROR, "CDDARipper: Error encoding %s", m_input.c_str());
   else
   {
@@ -153,32 +353,26 @@ bool CCDDARipJob::DoWork()
 
   handle->MarkFinished();
 
-  return !cancelled && result == 2;
+  return success;
 }
 
-int CCDDARipJob::RipChunk(CFile& reader, CEncoder* encoder, int& percent)
+bool CCDDARipJob::WaitForDrive()
 {
-  percent = 0;
-
-  uint8_t stream[1024];
-
-  // get data
-  int result = reader.Read(stream, 1024);
-
-  // return if rip is done or on some kind of error
-  if (result <= 0)
-    return 1;
-
-  // encode data
-  int encres=encoder->Encode(result, stream);
-
-  // Get progress indication
-  percent = static_cast<int>(reader.GetPosition()*100/reader.GetLength());
-
-  if (reader.GetPosition() == reader.GetLength())
-    return 2;
+  CSingleLock lock(g_driveSection);
+  while (g_driveQueue.front() != this)
+  {
+    if (ShouldCancel(0, 100))
+      return false;
+    g_driveChanged.wait(lock, 500);
+  }
+  return true;
+}
 
-  return -(1-encres);
+void CCDDARipJob::ReleaseDrive()
+{
+  CSingleLock lock(g_driveSection);
+  g_driveQueue.remove(this);
+  g_driveChanged.notifyAll();
 }
 
 CEncoder* CCDDARipJob::SetupEncoder(CFile& reader)
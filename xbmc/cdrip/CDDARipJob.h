@@ -29,6 +29,14 @@ namespace XFILE
 class CFile;
 }
 
+/*! \brief Rip a track from a CD
+
+ The track is read and encoded at the same time: the job reads ahead of an
+ encoder thread, so the drive doesn't wait for the encoder and the other way
+ round. The jobs take turns reading the disc in the order they were created,
+ and a job lets the next one read as soon as its track is read, so the
+ encoding of several tracks can overlap when the ripper runs jobs in parallel.
+ */
 class CCDDARipJob : public CJob
 {
 public:
@@ -59,15 +67,12 @@ protected:
   //! \brief Helper used if output is a remote url
   std::string SetupTempFile();
 
-  //! \brief Rip a chunk of audio
-  //! \param reader The input reader
-  //! \param encoder The audio encoder
-  //! \param percent The percentage completed on return
-  //! \return 0 (CDDARIP_OK) if everything went okay, or
-  //!         a positive error code from the reader, or
-  //!         -1 if the encoder failed
-  //! \sa CCDDARipper::GetData, CEncoder::Encode
-  int RipChunk(XFILE::CFile& reader, CEncoder* encoder, int& percent);
+  //! \brief Wait until the jobs created before this one have read their tracks
+  //! \return false if the job was cancelled meanwhile
+  bool WaitForDrive();
+
+  //! \brief Let the next job read the disc
+  void ReleaseDrive();
 
   unsigned int m_rate; //< The sample rate of the input file 
   unsigned int m_channels; //< The number of channels in input file
@@ -78,4 +83,3 @@ protected:
   bool m_eject; //< Should we eject tray when we are finished?
   int m_encoder; //< The audio encoder
 };
-
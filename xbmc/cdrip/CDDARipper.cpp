@@ -45,11 +45,17 @@
 #include "addons/binary-addons/BinaryAddonBase.h"
 #include "messaging/helpers/DialogOKHelper.h"
 
+#include <algorithm>
+#include <thread>
+
 using namespace ADDON;
 using namespace XFILE;
 using namespace MUSIC_INFO;
 using namespace KODI::MESSAGING;
 
+// Tracks encoded at once, the job manager doesn't run more low priority jobs anyway
+#define MAX_ENCODING_TRACKS  3u
+
 CCDDARipper& CCDDARipper::GetInstance()
 {
   static CCDDARipper sRipper;
@@ -57,7 +63,8 @@ CCDDARipper& CCDDARipper::GetInstance()
 }
 
 CCDDARipper::CCDDARipper()
-  : CJobQueue(false, 1) //enforce fifo and non-parallel processing
+  // fifo, the tracks are read one after the other but encoded in parallel
+  : CJobQueue(false, std::max(1u, std::min(std::thread::hardware_concurrency(), MAX_ENCODING_TRACKS)))
 {
 }
 
@@ -295,7 +302,10 @@ void CCDDARipper::OnJobComplete(unsigned int jobID, bool success, CJob* job)
 {
   if (success)
   {
-    if(CJobQueue::QueueEmpty())
+    CJobQueue::OnJobComplete(jobID, success, job);
+
+    // scan once the other tracks are done as well
+    if (!IsProcessing())
     {
       std::string dir = URIUtils::GetDirectory(static_cast<CCDDARipJob*>(job)->GetOutput());
       bool unimportant;
@@ -307,7 +317,7 @@ void CCDDARipper::OnJobComplete(unsigned int jobID, bool success, CJob* job)
         g_application.StartMusicScan(dir, false);
       database.Close();
     }
-    return CJobQueue::OnJobComplete(jobID, success, job);
+    return;
   }
 
   CancelJobs();
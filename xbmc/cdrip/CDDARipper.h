@@ -39,6 +39,8 @@ namespace MUSIC_INFO
  for the track file name.
  Format used to encode ripped tracks is defined by the audiocds.encoder user setting, and 
  there are several choices: wav, ogg vorbis and mp3.
+ The tracks are read from the disc one after the other, while the ones read before are still
+ being encoded.
  */
 class CCDDARipper : public CJobQueue
 {
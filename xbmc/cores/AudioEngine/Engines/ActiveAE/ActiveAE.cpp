@@ -22,6 +22,7 @@
 
 using namespace AE;
 using namespace ActiveAE;
+#include "ActiveAEResampleFFMPEG.h"
 #include "ActiveAESettings.h"
 #include "ActiveAESound.h"
 #include "ActiveAEStream.h"
@@ -34,11 +35,16 @@ using namespace ActiveAE;
 #include "settings/Settings.h"
 #include "windowing/WinSystem.h"
 #include "utils/log.h"
+#include "utils/Trace.h"
 
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
 #define MAX_BUFFER_TIME 0.1   // max time of a buffer in seconds
 
+#define LOW_LATENCY_CACHE_LEVEL 0.03 // total cache time of a low latency stream in seconds
+#define LOW_LATENCY_WATER_LEVEL 0.02 // buffered time after stream stages with low latency streams in seconds
+#define LOW_LATENCY_PERIOD      0.01 // sink period requested for low latency streams in seconds
+
 void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
 {
   CSingleLock lock(m_lock);
@@ -88,6 +94,7 @@ void CEngineStats::AddStream(unsigned int streamid)
   stream.m_streamId = streamid;
   stream.m_bufferedTime = 0;
   stream.m_resampleRatio = 1.0;
+  stream.m_resampleLoad = 0.0;
   stream.m_syncError = 0;
   stream.m_syncState = CAESyncInfo::AESyncState::SYNC_OFF;
   m_streamStats.push_back(stream);
@@ -118,11 +125,13 @@ void CEngineStats::UpdateStream(CActiveAEStream *stream)
       if (stream->m_processingBuffers)
       {
         str.m_resampleRatio = stream->m_processingBuffers->GetRR();
+        str.m_resampleLoad = stream->m_processingBuffers->GetResampleLoad();
         delay += stream->m_processingBuffers->GetDelay();
       }
       else
       {
         str.m_resampleRatio = 1.0;
+        str.m_resampleLoad = 0.0;
       }
 
       CSingleLock lock(stream->m_statsLock);
@@ -189,6 +198,7 @@ void CEngineStats::GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream)
       info.errortime = str.m_errorTime;
       info.state = str.m_syncState;
       info.rr = str.m_resampleRatio;
+      info.resampleLoad = str.m_resampleLoad;
       return;
     }
   }
@@ -275,6 +285,8 @@ CActiveAE::CActiveAE() :
   m_encoder = NULL;
   m_vizInitialized = false;
   m_sinkHasVolume = false;
+  m_sinkLowLatency = false;
+  m_waterLevel = MAX_WATER_LEVEL;
   m_aeGUISoundForce = false;
   m_stats.Reset(44100, true);
   m_streamIdGen = 0;
@@ -1140,18 +1152,31 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
   ApplySettingsToFormat(m_sinkRequestFormat, m_settings, (int*)&m_mode);
   m_extKeepConfig = 0;
 
+  // low latency streams ask the sink for a short period, sinks take a
+  // requested period as an upper bound
+  bool lowLatency = false;
+  for (auto stream : m_streams)
+    lowLatency |= stream->m_lowLatency;
+  if (m_sinkRequestFormat.m_dataFormat == AE_FMT_RAW)
+    lowLatency = false;
+  m_sinkRequestFormat.m_frames = lowLatency ? m_sinkRequestFormat.m_sampleRate * LOW_LATENCY_PERIOD : 0;
+
+  m_waterLevel = lowLatency ? LOW_LATENCY_WATER_LEVEL : MAX_WATER_LEVEL;
+
   std::string device = (m_sinkRequestFormat.m_dataFormat == AE_FMT_RAW) ? m_settings.passthroughdevice : m_settings.device;
   std::string driver;
   CAESinkFactory::ParseDevice(device, driver);
   if ((!CompareFormat(m_sinkRequestFormat, m_sinkFormat) && !CompareFormat(m_sinkRequestFormat, oldSinkRequestFormat)) ||
       m_currDevice.compare(device) != 0 ||
-      m_settings.driver.compare(driver) != 0)
+      m_settings.driver.compare(driver) != 0 ||
+      m_sinkLowLatency != lowLatency)
   {
     FlushEngine();
     if (!InitSink())
       return;
     m_settings.driver = driver;
     m_currDevice = device;
+    m_sinkLowLatency = lowLatency;
     initSink = true;
     m_stats.Reset(m_sinkFormat.m_sampleRate, m_mode == MODE_PCM);
     m_sink.m_controlPort.SendOutMessage(CSinkControlProtocol::VOLUME, &m_volume, sizeof(float));
@@ -1309,7 +1334,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
         // create buffer pool
         (*it)->m_inputBuffers = new CActiveAEBufferPool((*it)->m_format);
-        (*it)->m_inputBuffers->Create(MAX_CACHE_LEVEL*1000);
+        (*it)->m_inputBuffers->Create(GetCacheLevel(*it)*1000);
         (*it)->m_streamSpace = (*it)->m_format.m_frameSize * (*it)->m_format.m_frames;
 
         // if input format does not follow ffmpeg channel mask, we may need to remap channels
@@ -1328,9 +1353,10 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
         (*it)->m_processingBuffers = new CActiveAEStreamBuffers((*it)->m_inputBuffers->m_format, outputFormat, m_settings.resampleQuality);
         (*it)->m_processingBuffers->ForceResampler((*it)->m_forceResampler);
 
-        (*it)->m_processingBuffers->Create(MAX_CACHE_LEVEL*1000, false, m_settings.stereoupmix, m_settings.normalizelevels);
+        (*it)->m_processingBuffers->Create(GetCacheLevel(*it)*1000, false, m_settings.stereoupmix, m_settings.normalizelevels);
       }
-      if (m_mode == MODE_TRANSCODE || m_streams.size() > 1)
+      // filling up packets delays output, low latency streams hand on what they have
+      if ((m_mode == MODE_TRANSCODE || m_streams.size() > 1) && !(*it)->m_lowLatency)
         (*it)->m_processingBuffers->FillBuffer();
 
       // amplification
@@ -1350,7 +1376,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
         m_discardBufferPools.push_back(m_vizBuffersInput);
         m_vizBuffersInput = NULL;
       }
-      if (!m_vizBuffers && !m_audioCallback.empty())
+      if (!m_vizBuffers && m_vizDispatcher.HasCallbacks())
       {
         AEAudioFormat vizFormat = m_internalFormat;
         vizFormat.m_channelLayout = AE_CH_LAYOUT_2_0;
@@ -1448,6 +1474,10 @@ CActiveAEStream* CActiveAE::CreateStream(MsgStreamNew *streamMsg)
     stream->m_streamIsBuffering = true;
   }
 
+  // low latency streams skip resampling if formats match, unless they
+  // control their rate with the resample ratio
+  if (streamMsg->options & AESTREAM_LOW_LATENCY)
+    stream->m_lowLatency = true;
   if (streamMsg->options & AESTREAM_FORCE_RESAMPLE)
     stream->m_forceResampler = true;
 
@@ -1856,6 +1886,7 @@ void CActiveAE::UnconfigureSink()
 
 bool CActiveAE::RunStages()
 {
+  CTraceScope trace("audio", "CActiveAE::RunStages");
   bool busy = false;
 
   // serve input streams
@@ -1881,7 +1912,7 @@ bool CActiveAE::RunStages()
       float buftime = (float)(*it)->m_inputBuffers->m_format.m_frames / (*it)->m_inputBuffers->m_format.m_sampleRate;
       if ((*it)->m_inputBuffers->m_format.m_dataFormat == AE_FMT_RAW)
         buftime = (*it)->m_inputBuffers->m_format.m_streamInfo.GetDuration() / 1000;
-      while ((time < MAX_CACHE_LEVEL || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
+      while ((time < GetCacheLevel(*it) || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
       {
         buffer = (*it)->m_inputBuffers->GetFreeBuffer();
         (*it)->m_processingSamples.push_back(buffer);
@@ -1920,7 +1951,7 @@ bool CActiveAE::RunStages()
     }
   }
 
-  if (m_stats.GetWaterLevel() < MAX_WATER_LEVEL &&
+  if (m_stats.GetWaterLevel() < m_waterLevel &&
      (m_mode != MODE_TRANSCODE || (m_encoderBuffers && !m_encoderBuffers->m_freeSamples.empty())))
   {
     // calculate sync error
@@ -2070,15 +2101,7 @@ bool CActiveAE::RunStages()
 
               for(int j=0; j<out->pkt->planes; j++)
               {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
+                CAEUtil::MulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
               }
             }
           }
@@ -2139,24 +2162,8 @@ bool CActiveAE::RunStages()
               {
                 float *dst = (float*)out->pkt->data[j]+i*nb_floats;
                 float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
+                if (CAEUtil::MulAddArray(dst, src, volume, nb_floats))
+                  needClamp = true;
               }
             }
             mix->Return();
@@ -2180,15 +2187,12 @@ bool CActiveAE::RunStages()
       {
         // viz
         {
-          CSingleLock lock(m_vizLock);
-          if (!m_audioCallback.empty() && !m_streams.empty())
+          if (m_vizDispatcher.HasCallbacks() && !m_streams.empty())
           {
-            if (!m_vizInitialized || !m_vizBuffers)
+            if (!m_vizInitialized.exchange(true) || !m_vizBuffers)
             {
               Configure();
-              for (auto& it : m_audioCallback)
-                it->OnInitialize(2, m_vizBuffers->m_format.m_sampleRate, 32);
-              m_vizInitialized = true;
+              m_vizDispatcher.Initialize(2, m_vizBuffers->m_format.m_sampleRate, 32);
             }
 
             if (!m_vizBuffersInput->m_freeSamples.empty())
@@ -2219,8 +2223,8 @@ bool CActiveAE::RunStages()
               else
               {
                 unsigned int samples = static_cast<unsigned int>(buf->pkt->nb_samples);
-                for (auto& it : m_audioCallback)
-                  it->OnAudioData((float*)(buf->pkt->data[0]), samples);
+                if (!m_vizDispatcher.Publish((float*)(buf->pkt->data[0]), samples))
+                  CLog::Log(LOGDEBUG, "ActiveAE::%s - viz dispatcher is behind, dropping data", __FUNCTION__);
                 buf->Return();
                 m_vizBuffers->m_outputSamples.pop_front();
               }
@@ -2535,12 +2539,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEUtil::MulAddArray(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2565,13 +2564,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEUtil::MulArray(buffer, volume, nb_floats);
     }
   }
 }
@@ -2700,6 +2693,8 @@ bool CActiveAE::SupportsQualityLevel(enum AEQuality level)
 {
   if (level == AE_QUALITY_LOW || level == AE_QUALITY_MID || level == AE_QUALITY_HIGH)
     return true;
+  if (level == AE_QUALITY_REALLYHIGH)
+    return CActiveAEResampleFFMPEG::HasSoxr();
 #if defined(TARGET_RASPBERRY_PI)
   if (level == AE_QUALITY_GPU)
     return true;
@@ -2914,6 +2909,11 @@ void CActiveAE::FreeSoundSample(uint8_t **data)
   delete [] data;
 }
 
+float CActiveAE::GetCacheLevel(CActiveAEStream *stream)
+{
+  return stream->m_lowLatency ? LOW_LATENCY_CACHE_LEVEL : MAX_CACHE_LEVEL;
+}
+
 bool CActiveAE::CompareFormat(AEAudioFormat &lhs, AEAudioFormat &rhs)
 {
   if (lhs.m_channelLayout != rhs.m_channelLayout ||
@@ -2947,6 +2947,14 @@ IAESound *CActiveAE::MakeSound(const std::string& file)
   SampleConfig config;
 
   sound = new CActiveAESound(file, this);
+
+  // decoded before, skip probing and decoding
+  if (sound->LoadCache())
+  {
+    m_dataPort.SendOutMessage(CActiveAEDataProtocol::NEWSOUND, &sound, sizeof(CActiveAESound*));
+    return sound;
+  }
+
   if (!sound->Prepare())
   {
     delete sound;
@@ -3047,6 +3055,7 @@ IAESound *CActiveAE::MakeSound(const std::string& file)
           int samples = fileSize / av_get_bytes_per_sample(dec_ctx->sample_fmt) / config.channels;
           config.fmt = dec_ctx->sample_fmt;
           config.bits_per_sample = dec_ctx->bits_per_coded_sample;
+          config.dither_bits = 0;
           sound->InitSound(true, config, samples);
           init = true;
         }
@@ -3067,6 +3076,7 @@ IAESound *CActiveAE::MakeSound(const std::string& file)
   }
 
   sound->Finish();
+  sound->StoreCache();
 
   // register sound
   m_dataPort.SendOutMessage(CActiveAEDataProtocol::NEWSOUND, &sound, sizeof(CActiveAESound*));
@@ -3355,15 +3365,11 @@ void CActiveAE::SetStreamFade(CActiveAEStream *stream, float from, float target,
 
 void CActiveAE::RegisterAudioCallback(IAudioCallback* pCallback)
 {
-  CSingleLock lock(m_vizLock);
-  m_audioCallback.push_back(pCallback);
+  m_vizDispatcher.Register(pCallback);
   m_vizInitialized = false;
 }
 
 void CActiveAE::UnregisterAudioCallback(IAudioCallback* pCallback)
 {
-  CSingleLock lock(m_vizLock);
-  auto it = std::find(m_audioCallback.begin(), m_audioCallback.end(), pCallback);
-  if (it != m_audioCallback.end())
-    m_audioCallback.erase(it);
+  m_vizDispatcher.Unregister(pCallback);
 }
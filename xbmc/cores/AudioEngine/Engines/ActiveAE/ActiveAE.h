@@ -29,6 +29,7 @@
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 #include "cores/AudioEngine/Interfaces/AESound.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEVizDispatcher.h"
 
 #include "guilib/DispResource.h"
 #include <queue>
@@ -212,6 +213,7 @@ protected:
     unsigned int m_streamId;
     double m_bufferedTime;
     double m_resampleRatio;
+    double m_resampleLoad;
     double m_syncError;
     unsigned int m_errorTime;
     CAESyncInfo::AESyncState m_syncState;
@@ -320,6 +322,7 @@ protected:
   void Deamplify(CSoundPacket &dstSample);
 
   bool CompareFormat(AEAudioFormat &lhs, AEAudioFormat &rhs);
+  float GetCacheLevel(CActiveAEStream *stream);
 
   CEvent m_inMsgEvent;
   CEvent m_outMsgEvent;
@@ -380,11 +383,12 @@ protected:
   float m_volumeScaled; // multiplier to scale samples in order to achieve the volume specified in m_volume
   bool m_muted;
   bool m_sinkHasVolume;
+  bool m_sinkLowLatency; // sink was opened with a short period for low latency streams
+  float m_waterLevel; // buffered time after stream stages the engine aims for
 
   // viz
-  std::vector<IAudioCallback*> m_audioCallback;
-  bool m_vizInitialized;
-  CCriticalSection m_vizLock;
+  CActiveAEVizDispatcher m_vizDispatcher;
+  std::atomic<bool> m_vizInitialized;
 
   // polled via the interface
   float m_aeVolume;
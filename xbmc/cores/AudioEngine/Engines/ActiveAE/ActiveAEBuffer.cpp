@@ -24,6 +24,7 @@
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
+#include "utils/TimeUtils.h"
 
 using namespace ActiveAE;
 
@@ -169,6 +170,9 @@ CActiveAEBufferPoolResample::CActiveAEBufferPoolResample(const AEAudioFormat& in
   m_normalize = true;
   m_changeResampler = false;
   m_lastSamplePts = 0;
+  m_resampleTicks = 0;
+  m_resampleSamples = 0;
+  m_resampleLoad = 0.0f;
 }
 
 CActiveAEBufferPoolResample::~CActiveAEBufferPoolResample()
@@ -317,11 +321,24 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
         m_planes[i] = m_procSample->pkt->data[i] + start;
       }
 
+      int64_t ticks = CurrentHostCounter();
       int out_samples = m_resampler->Resample(m_planes,
                                               m_procSample->pkt->max_nb_samples - m_procSample->pkt->nb_samples,
                                               in ? in->pkt->data : NULL,
                                               in ? in->pkt->nb_samples : 0,
                                               m_resampleRatio);
+      if (out_samples > 0)
+      {
+        m_resampleTicks += CurrentHostCounter() - ticks;
+        m_resampleSamples += out_samples;
+        if (m_resampleSamples >= static_cast<int>(m_format.m_sampleRate))
+        {
+          double seconds = static_cast<double>(m_resampleTicks) / CurrentHostFrequency();
+          m_resampleLoad = static_cast<float>(seconds * m_format.m_sampleRate / m_resampleSamples);
+          m_resampleTicks = 0;
+          m_resampleSamples = 0;
+        }
+      }
       // in case of error, trigger re-create of resampler
       if (out_samples < 0)
       {
@@ -108,6 +108,7 @@ public:
   void FillBuffer();
   bool DoesNormalize();
   void ForceResampler(bool force);
+  float GetResampleLoad() const { return m_resampleLoad; }
   AEAudioFormat m_inputFormat;
   std::deque<CSampleBuffer*> m_inputSamples;
   std::deque<CSampleBuffer*> m_outputSamples;
@@ -129,6 +130,9 @@ protected:
   bool m_forceResampler;
   AEQuality m_resampleQuality;
   bool m_stereoUpmix;
+  int64_t m_resampleTicks; // host counter ticks spent in the resampler
+  int m_resampleSamples; // samples output during m_resampleTicks
+  float m_resampleLoad; // resampler time per output time, updated once a second
 };
 
 class CActiveAEFilter;
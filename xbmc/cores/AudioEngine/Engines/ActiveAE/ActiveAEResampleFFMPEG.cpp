@@ -20,8 +20,12 @@
 
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "ActiveAEResampleFFMPEG.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 
+#include <list>
+
 extern "C" {
 #include "libavutil/channel_layout.h"
 #include "libavutil/opt.h"
@@ -30,6 +34,89 @@ extern "C" {
 
 using namespace ActiveAE;
 
+namespace
+{
+// contexts are dropped and rebuilt on every flush, seek and reconfigure
+const size_t MAX_CACHED_CONTEXTS = 4;
+
+bool ProbeSoxr()
+{
+  SwrContext *context = swr_alloc_set_opts(NULL, AV_CH_LAYOUT_STEREO, AV_SAMPLE_FMT_FLT, 48000,
+                                           AV_CH_LAYOUT_STEREO, AV_SAMPLE_FMT_FLT, 44100, 0, NULL);
+  if (!context)
+    return false;
+
+  av_opt_set_int(context, "resampler", SWR_ENGINE_SOXR, 0);
+  bool supported = swr_init(context) >= 0;
+  swr_free(&context);
+  return supported;
+}
+}
+
+bool CActiveAEResampleFFMPEG::SConfig::operator==(const SConfig &rhs) const
+{
+  return dst_chan_layout == rhs.dst_chan_layout && src_chan_layout == rhs.src_chan_layout &&
+         dst_channels == rhs.dst_channels && src_channels == rhs.src_channels &&
+         dst_rate == rhs.dst_rate && src_rate == rhs.src_rate &&
+         dst_fmt == rhs.dst_fmt && src_fmt == rhs.src_fmt &&
+         dst_bits == rhs.dst_bits && src_bits == rhs.src_bits &&
+         dst_dither == rhs.dst_dither && src_dither == rhs.src_dither &&
+         upmix == rhs.upmix && normalize == rhs.normalize &&
+         remap == rhs.remap && (!remap || remapLayout == rhs.remapLayout) &&
+         quality == rhs.quality;
+}
+
+struct CActiveAEResampleFFMPEG::SContextCache
+{
+  ~SContextCache()
+  {
+    for (auto &entry : contexts)
+      swr_free(&entry.second);
+  }
+  CCriticalSection lock;
+  std::list<std::pair<SConfig, SwrContext*>> contexts; // most recently cached first
+};
+
+CActiveAEResampleFFMPEG::SContextCache& CActiveAEResampleFFMPEG::GetContextCache()
+{
+  static SContextCache cache;
+  return cache;
+}
+
+SwrContext* CActiveAEResampleFFMPEG::TakeCachedContext(const SConfig &config)
+{
+  SContextCache &cache = GetContextCache();
+  CSingleLock lock(cache.lock);
+  for (auto it = cache.contexts.begin(); it != cache.contexts.end(); ++it)
+  {
+    if (it->first == config)
+    {
+      SwrContext *context = it->second;
+      cache.contexts.erase(it);
+      return context;
+    }
+  }
+  return NULL;
+}
+
+void CActiveAEResampleFFMPEG::CacheContext(const SConfig &config, SwrContext *context)
+{
+  if (!swr_is_initialized(context))
+  {
+    swr_free(&context);
+    return;
+  }
+
+  SContextCache &cache = GetContextCache();
+  CSingleLock lock(cache.lock);
+  cache.contexts.push_front(std::make_pair(config, context));
+  if (cache.contexts.size() > MAX_CACHED_CONTEXTS)
+  {
+    swr_free(&cache.contexts.back().second);
+    cache.contexts.pop_back();
+  }
+}
+
 CActiveAEResampleFFMPEG::CActiveAEResampleFFMPEG()
 {
   m_pContext = NULL;
@@ -38,7 +125,14 @@ CActiveAEResampleFFMPEG::CActiveAEResampleFFMPEG()
 
 CActiveAEResampleFFMPEG::~CActiveAEResampleFFMPEG()
 {
-  swr_free(&m_pContext);
+  if (m_pContext)
+    CacheContext(m_config, m_pContext);
+}
+
+bool CActiveAEResampleFFMPEG::HasSoxr()
+{
+  static const bool hasSoxr = ProbeSoxr();
+  return hasSoxr;
 }
 
 bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, int dst_rate, AVSampleFormat dst_fmt, int dst_bits, int dst_dither, uint64_t src_chan_layout, int src_channels, int src_rate, AVSampleFormat src_fmt, int src_bits, int src_dither, bool upmix, bool normalize, CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample)
@@ -64,6 +158,40 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
   if (m_src_chan_layout == 0)
     m_src_chan_layout = av_get_default_channel_layout(m_src_channels);
 
+  // a setting stored by a build with soxr
+  if (quality == AE_QUALITY_REALLYHIGH && !HasSoxr())
+    quality = AE_QUALITY_HIGH;
+
+  if (m_pContext)
+    CacheContext(m_config, m_pContext);
+
+  m_config.dst_chan_layout = m_dst_chan_layout;
+  m_config.src_chan_layout = m_src_chan_layout;
+  m_config.dst_channels = m_dst_channels;
+  m_config.src_channels = m_src_channels;
+  m_config.dst_rate = m_dst_rate;
+  m_config.src_rate = m_src_rate;
+  m_config.dst_fmt = m_dst_fmt;
+  m_config.src_fmt = m_src_fmt;
+  m_config.dst_bits = m_dst_bits;
+  m_config.src_bits = m_src_bits;
+  m_config.dst_dither = m_dst_dither_bits;
+  m_config.src_dither = m_src_dither_bits;
+  m_config.upmix = upmix;
+  m_config.normalize = normalize;
+  m_config.remap = remapLayout != NULL;
+  m_config.remapLayout = remapLayout ? *remapLayout : CAEChannelInfo();
+  m_config.quality = quality;
+
+  // swr_init drops buffered samples and compensation of the previous user
+  m_pContext = TakeCachedContext(m_config);
+  if (m_pContext)
+  {
+    if (swr_init(m_pContext) >= 0)
+      return true;
+    swr_free(&m_pContext);
+  }
+
   m_pContext = swr_alloc_set_opts(NULL, m_dst_chan_layout, m_dst_fmt, m_dst_rate,
                                                         m_src_chan_layout, m_src_fmt, m_src_rate,
                                                         0, NULL);
@@ -74,7 +202,12 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
     return false;
   }
 
-  if(quality == AE_QUALITY_HIGH)
+  if(quality == AE_QUALITY_REALLYHIGH)
+  {
+    av_opt_set_int(m_pContext, "resampler", SWR_ENGINE_SOXR, 0);
+    av_opt_set_int(m_pContext, "precision", 28, 0);
+  }
+  else if(quality == AE_QUALITY_HIGH)
   {
     av_opt_set_double(m_pContext, "cutoff", 1.0, 0);
     av_opt_set_int(m_pContext,"filter_size", 256, 0);
@@ -48,7 +48,36 @@ public:
   int GetSrcBufferSize(int samples) override;
   int GetDstBufferSize(int samples) override;
 
+  /*!
+   * \brief true if libswresample was built with soxr, used for AE_QUALITY_REALLYHIGH
+   */
+  static bool HasSoxr();
+
 protected:
+  // all Init parameters a context is configured with, an idle context is
+  // reused for an equal configuration and swr_init keeps its filter bank
+  struct SConfig
+  {
+    uint64_t dst_chan_layout, src_chan_layout;
+    int dst_channels, src_channels;
+    int dst_rate, src_rate;
+    AVSampleFormat dst_fmt, src_fmt;
+    int dst_bits, src_bits;
+    int dst_dither, src_dither;
+    bool upmix;
+    bool normalize;
+    bool remap;
+    CAEChannelInfo remapLayout;
+    AEQuality quality;
+    bool operator==(const SConfig &rhs) const;
+  };
+
+  struct SContextCache;
+  static SContextCache& GetContextCache();
+  static SwrContext* TakeCachedContext(const SConfig &config);
+  static void CacheContext(const SConfig &config, SwrContext *context);
+
+  SConfig m_config;
   bool m_loaded;
   bool m_doesResample;
   uint64_t m_src_chan_layout, m_dst_chan_layout;
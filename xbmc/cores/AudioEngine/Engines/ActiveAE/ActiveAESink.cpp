@@ -899,7 +899,6 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
   unsigned int maxFrames;
   int retry = 0;
   unsigned int written = 0;
-  std::unique_ptr<uint8_t[]> mergebuffer;
   uint8_t* p_mergebuffer = NULL;
   AEDelayStatus status;
 
@@ -917,7 +916,6 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
           {
             int offset;
             int len;
-            m_packer->GetBuffer();
             for (int i=0; i<24; i++)
             {
               offset = i*2560;
@@ -975,13 +973,14 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
         int offset;
         int len;
         unsigned int size = 0;
-        mergebuffer.reset(new uint8_t[MAX_IEC61937_PACKET]);
-        p_mergebuffer = mergebuffer.get();
+        if (!m_mergeBuffer)
+          m_mergeBuffer.reset(new uint8_t[MAX_IEC61937_PACKET]);
+        p_mergebuffer = m_mergeBuffer.get();
         for (int i=0; i<24; i++)
         {
           offset = i*2560;
           len = (*(buffer[0] + offset+2560-2) << 8) + *(buffer[0] + offset+2560-1);
-          memcpy(&(mergebuffer.get())[size], buffer[0] + offset, len);
+          memcpy(p_mergebuffer + size, buffer[0] + offset, len);
           size += len;
         }
         buffer = &p_mergebuffer;
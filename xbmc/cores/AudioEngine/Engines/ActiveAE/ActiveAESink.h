@@ -149,6 +149,7 @@ protected:
   float m_volume;
   int m_sinkLatency;
   CAEBitstreamPacker *m_packer;
+  std::unique_ptr<uint8_t[]> m_mergeBuffer; // trueHD units merged for sinks packing themselves
   bool m_needIecPack;
   bool m_streamNoise;
 };
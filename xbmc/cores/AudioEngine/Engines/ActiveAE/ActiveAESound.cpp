@@ -18,10 +18,15 @@
  *
  */
 
+#include <string.h>
+
 #include "cores/AudioEngine/Interfaces/AESound.h"
 #include "ActiveAE.h"
 #include "ActiveAESound.h"
+#include "filesystem/Directory.h"
+#include "utils/Crc32.h"
 #include "utils/log.h"
+#include "utils/StringUtils.h"
 
 extern "C" {
 #include "libavutil/avutil.h"
@@ -30,6 +35,29 @@ extern "C" {
 using namespace ActiveAE;
 using namespace XFILE;
 
+namespace
+{
+const char* SOUNDCACHE_PATH = "special://temp/soundcache/";
+const uint32_t SOUNDCACHE_VERSION = 1;
+const int MAX_CACHED_SAMPLES = 48000 * 60;
+
+struct SoundCacheHeader
+{
+  char magic[4];
+  uint32_t version;
+  int64_t fileSize;
+  int64_t fileTime;
+  int32_t fmt;
+  uint64_t channelLayout;
+  int32_t channels;
+  int32_t sampleRate;
+  int32_t bitsPerSample;
+  int32_t ditherBits;
+  int32_t samples;
+  int32_t planes;
+};
+}
+
 CActiveAESound::CActiveAESound(const std::string &filename, CActiveAE *ae) :
   IAESound         (filename),
   m_filename       (filename),
@@ -143,6 +171,116 @@ void CActiveAESound::Finish()
   m_pFile = NULL;
 }
 
+bool CActiveAESound::GetCacheKey(std::string &cacheFile, int64_t &fileSize, int64_t &fileTime)
+{
+  // an edited sound mostly keeps name and size, the time tells them apart
+  struct __stat64 st;
+  if (CFile::Stat(m_filename, &st) != 0 || st.st_size <= 0 || st.st_mtime == 0)
+    return false;
+
+  cacheFile = StringUtils::Format("%s%08x.pcm", SOUNDCACHE_PATH, Crc32::ComputeFromLowerCase(m_filename));
+  fileSize = st.st_size;
+  fileTime = st.st_mtime;
+  return true;
+}
+
+bool CActiveAESound::LoadCache()
+{
+  std::string cacheFile;
+  int64_t fileSize, fileTime;
+  if (!GetCacheKey(cacheFile, fileSize, fileTime))
+    return false;
+
+  CFile file;
+  if (!file.Open(cacheFile))
+    return false;
+
+  SoundCacheHeader header;
+  if (file.Read(&header, sizeof(header)) != sizeof(header) ||
+      memcmp(header.magic, "KSND", 4) != 0 ||
+      header.version != SOUNDCACHE_VERSION ||
+      header.fileSize != fileSize ||
+      header.fileTime != fileTime ||
+      header.samples <= 0 || header.samples > MAX_CACHED_SAMPLES ||
+      header.channels <= 0 || header.channels > AE_CH_MAX)
+    return false;
+
+  SampleConfig config;
+  config.fmt = static_cast<AVSampleFormat>(header.fmt);
+  config.channel_layout = header.channelLayout;
+  config.channels = header.channels;
+  config.sample_rate = header.sampleRate;
+  config.bits_per_sample = header.bitsPerSample;
+  config.dither_bits = header.ditherBits;
+
+  uint8_t **data = InitSound(true, config, header.samples);
+  if (!data || m_orig_sound->planes != header.planes)
+  {
+    delete m_orig_sound;
+    m_orig_sound = NULL;
+    return false;
+  }
+
+  ssize_t planeSize = header.samples * m_orig_sound->bytes_per_sample * config.channels / m_orig_sound->planes;
+  for (int i = 0; i < m_orig_sound->planes; i++)
+  {
+    if (file.Read(data[i], planeSize) != planeSize)
+    {
+      delete m_orig_sound;
+      m_orig_sound = NULL;
+      return false;
+    }
+  }
+  m_orig_sound->nb_samples = header.samples;
+
+  return true;
+}
+
+void CActiveAESound::StoreCache()
+{
+  std::string cacheFile;
+  int64_t fileSize, fileTime;
+  if (!m_orig_sound || m_orig_sound->nb_samples <= 0 || m_orig_sound->nb_samples > MAX_CACHED_SAMPLES ||
+      !GetCacheKey(cacheFile, fileSize, fileTime))
+    return;
+
+  if (!CDirectory::Exists(SOUNDCACHE_PATH) && !CDirectory::Create(SOUNDCACHE_PATH))
+    return;
+
+  CFile file;
+  if (!file.OpenForWrite(cacheFile, true))
+  {
+    CLog::Log(LOGWARNING, "CActiveAESound::StoreCache - unable to write %s", cacheFile.c_str());
+    return;
+  }
+
+  SoundCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "KSND", 4);
+  header.version = SOUNDCACHE_VERSION;
+  header.fileSize = fileSize;
+  header.fileTime = fileTime;
+  header.fmt = m_orig_sound->config.fmt;
+  header.channelLayout = m_orig_sound->config.channel_layout;
+  header.channels = m_orig_sound->config.channels;
+  header.sampleRate = m_orig_sound->config.sample_rate;
+  header.bitsPerSample = m_orig_sound->config.bits_per_sample;
+  header.ditherBits = m_orig_sound->config.dither_bits;
+  header.samples = m_orig_sound->nb_samples;
+  header.planes = m_orig_sound->planes;
+
+  ssize_t planeSize = header.samples * m_orig_sound->bytes_per_sample * header.channels / header.planes;
+  bool success = file.Write(&header, sizeof(header)) == sizeof(header);
+  for (int i = 0; success && i < m_orig_sound->planes; i++)
+    success = file.Write(m_orig_sound->data[i], planeSize) == planeSize;
+
+  if (!success)
+  {
+    file.Close();
+    CFile::Delete(cacheFile);
+  }
+}
+
 int CActiveAESound::GetChunkSize()
 {
   return m_pFile->GetChunkSize();
@@ -57,10 +57,23 @@ public:
   int GetFileSize() { return m_fileSize; }
   bool IsSeekPossible() { return m_isSeekPossible; }
 
+  /*!
+   * \brief Loads the decoded sound from special://temp/soundcache/
+   * \return true if a stored result matches size and time of the file
+   */
+  bool LoadCache();
+
+  /*!
+   * \brief Stores the decoded sound so the next start does not decode it
+   */
+  void StoreCache();
+
   static int Read(void *h, uint8_t* buf, int size);
   static int64_t Seek(void *h, int64_t pos, int whence);
 
 protected:
+  bool GetCacheKey(std::string &cacheFile, int64_t &fileSize, int64_t &fileTime);
+
   CActiveAE *m_activeAE;
   std::string m_filename;
   XFILE::CFile *m_pFile;
@@ -52,6 +52,7 @@ CActiveAEStream::CActiveAEStream(AEAudioFormat *format, unsigned int streamid, C
   m_leftoverBuffer = new uint8_t[m_format.m_frameSize];
   m_leftoverBytes = 0;
   m_forceResampler = false;
+  m_lowLatency = false;
   m_remapper = NULL;
   m_remapBuffer = NULL;
   m_streamResampleRatio = 1.0;
@@ -370,7 +371,8 @@ double CActiveAEStream::GetCacheTime()
 
 double CActiveAEStream::GetCacheTotal()
 {
-  return m_activeAE->GetCacheTotal();
+  // low latency streams are filled to a lower level
+  return m_activeAE->GetCacheLevel(this);
 }
 
 double CActiveAEStream::GetMaxDelay()
@@ -729,6 +731,11 @@ void CActiveAEStreamBuffers::SetRR(double rr, double atempoThreshold)
   }
 }
 
+float CActiveAEStreamBuffers::GetResampleLoad()
+{
+  return m_resampleBuffers->GetResampleLoad();
+}
+
 double CActiveAEStreamBuffers::GetRR()
 {
   double tempo = m_resampleBuffers->GetRR();
@@ -113,6 +113,7 @@ public:
   bool IsDrained();
   void SetRR(double rr, double atempoThreshold);
   double GetRR();
+  float GetResampleLoad();
   void FillBuffer();
   bool DoesNormalize();
   void ForceResampler(bool force);
@@ -243,6 +244,7 @@ protected:
   enum AVMatrixEncoding m_matrixEncoding;
   enum AVAudioServiceType m_audioServiceType;
   bool m_forceResampler;
+  bool m_lowLatency;
   IAEClockCallback *m_pClock;
   CSyncError m_syncError;
   double m_lastSyncError;
@@ -0,0 +1,141 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ActiveAEVizDispatcher.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include "cores/AudioEngine/Interfaces/IAudioCallback.h"
+#include "threads/SingleLock.h"
+#include "utils/rfft.h"
+
+using namespace ActiveAE;
+
+CActiveAEVizDispatcher::CActiveAEVizDispatcher()
+  : CThread("ActiveAEViz"),
+    m_slots(new Slot[SLOT_COUNT]),
+    m_writePos(0),
+    m_readPos(0),
+    m_initialize(false),
+    m_channels(0),
+    m_sampleRate(0),
+    m_bitsPerSample(0),
+    m_callbackCount(0)
+{
+}
+
+CActiveAEVizDispatcher::~CActiveAEVizDispatcher()
+{
+  m_bStop = true;
+  m_dataEvent.Set();
+  StopThread(true);
+}
+
+void CActiveAEVizDispatcher::Register(IAudioCallback* callback)
+{
+  {
+    CSingleLock lock(m_callbackLock);
+    m_callbacks.push_back(callback);
+    m_callbackCount = static_cast<int>(m_callbacks.size());
+  }
+
+  if (!IsRunning())
+    Create();
+}
+
+void CActiveAEVizDispatcher::Unregister(IAudioCallback* callback)
+{
+  // the worker holds the lock while it calls back, the callback is not in use
+  // anymore on return
+  CSingleLock lock(m_callbackLock);
+  auto it = std::find(m_callbacks.begin(), m_callbacks.end(), callback);
+  if (it != m_callbacks.end())
+    m_callbacks.erase(it);
+  m_callbackCount = static_cast<int>(m_callbacks.size());
+}
+
+void CActiveAEVizDispatcher::Initialize(int channels, int sampleRate, int bitsPerSample)
+{
+  m_channels = channels;
+  m_sampleRate = sampleRate;
+  m_bitsPerSample = bitsPerSample;
+  m_initialize = true;
+  m_dataEvent.Set();
+}
+
+bool CActiveAEVizDispatcher::Publish(const float* data, unsigned int length)
+{
+  unsigned int writePos = m_writePos.load(std::memory_order_relaxed);
+  if (writePos - m_readPos.load(std::memory_order_acquire) >= SLOT_COUNT)
+    return false;
+
+  Slot& slot = m_slots[writePos % SLOT_COUNT];
+  slot.length = std::min(length, MAX_SAMPLES);
+  memcpy(slot.data, data, slot.length * sizeof(float));
+  m_writePos.store(writePos + 1, std::memory_order_release);
+
+  m_dataEvent.Set();
+  return true;
+}
+
+void CActiveAEVizDispatcher::Process()
+{
+  while (!m_bStop)
+  {
+    m_dataEvent.WaitMSec(100);
+
+    if (m_initialize.exchange(false))
+    {
+      // blocks of the old format are of no use anymore
+      m_readPos.store(m_writePos.load(std::memory_order_acquire), std::memory_order_release);
+
+      CSingleLock lock(m_callbackLock);
+      for (auto& callback : m_callbacks)
+        callback->OnInitialize(m_channels, m_sampleRate, m_bitsPerSample);
+    }
+
+    unsigned int readPos = m_readPos.load(std::memory_order_relaxed);
+    while (!m_bStop && readPos != m_writePos.load(std::memory_order_acquire))
+    {
+      Dispatch(m_slots[readPos % SLOT_COUNT]);
+      m_readPos.store(++readPos, std::memory_order_release);
+    }
+  }
+}
+
+void CActiveAEVizDispatcher::Dispatch(const Slot& slot)
+{
+  CSingleLock lock(m_callbackLock);
+  if (m_callbacks.empty())
+    return;
+
+  // shorter blocks are padded, the transform always takes the same size
+  unsigned int length = std::min(slot.length, FFT_SIZE);
+  memcpy(m_fftInput, slot.data, length * sizeof(float));
+  std::fill(m_fftInput + length, m_fftInput + FFT_SIZE, 0.0f);
+
+  if (!m_transform)
+    m_transform.reset(new RFFT(FFT_SIZE / 2, false)); // half due to stereo
+  m_transform->calc(m_fftInput, m_freq);
+
+  for (auto& callback : m_callbacks)
+    callback->OnAudioData(slot.data, slot.length, m_freq, FFT_SIZE / 2);
+}
@@ -0,0 +1,99 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+class IAudioCallback;
+class RFFT;
+
+namespace ActiveAE
+{
+
+/*!
+ * Hands visualization data from the audio thread to all registered
+ * callbacks. The audio thread only copies each block into a single producer,
+ * single consumer ring, a worker transforms it once and calls the callbacks,
+ * so slow visualizations never hold up audio processing.
+ */
+class CActiveAEVizDispatcher : private CThread
+{
+public:
+  CActiveAEVizDispatcher();
+  ~CActiveAEVizDispatcher() override;
+
+  void Register(IAudioCallback* callback);
+  void Unregister(IAudioCallback* callback);
+  bool HasCallbacks() const { return m_callbackCount > 0; }
+
+  /*!
+   * Called by the audio thread when the format changed or callbacks were
+   * added, the callbacks are initialized before the next block.
+   */
+  void Initialize(int channels, int sampleRate, int bitsPerSample);
+
+  /*!
+   * Called by the audio thread, drops the block if the worker lags behind.
+   * \return false if the block was dropped
+   */
+  bool Publish(const float* data, unsigned int length);
+
+protected:
+  void Process() override;
+
+private:
+  static const unsigned int SLOT_COUNT = 32;
+  static const unsigned int MAX_SAMPLES = 8192;
+  static const unsigned int FFT_SIZE = 512; // interleaved stereo
+
+  struct Slot
+  {
+    float data[MAX_SAMPLES];
+    unsigned int length;
+  };
+
+  void Dispatch(const Slot& slot);
+
+  std::unique_ptr<Slot[]> m_slots;
+  std::atomic<unsigned int> m_writePos;
+  std::atomic<unsigned int> m_readPos;
+  CEvent m_dataEvent;
+
+  std::atomic<bool> m_initialize;
+  std::atomic<int> m_channels;
+  std::atomic<int> m_sampleRate;
+  std::atomic<int> m_bitsPerSample;
+
+  CCriticalSection m_callbackLock;
+  std::vector<IAudioCallback*> m_callbacks;
+  std::atomic<int> m_callbackCount;
+
+  std::unique_ptr<RFFT> m_transform;
+  float m_fftInput[FFT_SIZE];
+  float m_freq[FFT_SIZE / 2];
+};
+
+}
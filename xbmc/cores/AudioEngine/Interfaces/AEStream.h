@@ -45,6 +45,7 @@ public:
   double delay;
   double error;
   double rr;
+  double resampleLoad = 0.0; // time spent resampling per time of audio
   unsigned int errortime;
   enum AESyncState
   {
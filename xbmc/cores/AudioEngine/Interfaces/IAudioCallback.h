@@ -30,6 +30,10 @@ public:
   IAudioCallback() = default;
   virtual ~IAudioCallback() = default;
   virtual void OnInitialize(int iChannels, int iSamplesPerSec, int iBitsPerSample) = 0;
-  virtual void OnAudioData(const float* pAudioData, unsigned int iAudioDataLength) = 0;
+  /*!
+   * Called by the visualization worker, never by the audio thread.
+   * \param pFreqData magnitudes of the first 256 stereo frames, shared by all callbacks
+   */
+  virtual void OnAudioData(const float* pAudioData, unsigned int iAudioDataLength, const float* pFreqData, unsigned int iFreqDataLength) = 0;
 };
 
@@ -500,6 +500,7 @@ bool CAESinkALSA::Initialize(AEAudioFormat &format, std::string &device)
   ALSAConfig inconfig, outconfig;
   inconfig.format = format.m_dataFormat;
   inconfig.sampleRate = format.m_sampleRate;
+  inconfig.periodSize = format.m_frames; // requested upper bound, 0 for the default
 
   /*
    * We can't use the better GetChannelLayout() at this point as the device
@@ -753,6 +754,13 @@ bool CAESinkALSA::InitializeHW(const ALSAConfig &inconfig, ALSAConfig &outconfig
   */
   periodSize = std::min(periodSize, bufferSize / 4);
 
+  /* low latency streams ask for a shorter period, keep 4 periods buffered */
+  if (inconfig.periodSize > 0 && inconfig.periodSize < periodSize)
+  {
+    periodSize = inconfig.periodSize;
+    bufferSize = periodSize * 4;
+  }
+
   CLog::Log(LOGDEBUG, "CAESinkALSA::InitializeHW - Request: periodSize %lu, bufferSize %lu", periodSize, bufferSize);
 
   snd_pcm_hw_params_copy(hw_params_copy, hw_params); // copy what we have and is already working
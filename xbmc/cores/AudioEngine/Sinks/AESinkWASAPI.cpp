@@ -825,6 +825,14 @@ initialize:
     CLog::LogF(LOGDEBUG, "detected USB device, increasing buffer size");
     audioSinkBufferDurationMsec = (REFERENCE_TIME)1000000;
   }
+  else if (format.m_frames > 0)
+  {
+    // a short period was requested, the device minimum is the lower bound
+    REFERENCE_TIME hnsRequested = (REFERENCE_TIME)(10000.0 * 1000 / format.m_sampleRate * format.m_frames + 0.5);
+    REFERENCE_TIME hnsMinimumDevicePeriod = 0;
+    if (SUCCEEDED(m_pAudioClient->GetDevicePeriod(NULL, &hnsMinimumDevicePeriod)))
+      audioSinkBufferDurationMsec = std::min(audioSinkBufferDurationMsec, std::max(hnsRequested, hnsMinimumDevicePeriod));
+  }
   audioSinkBufferDurationMsec = (REFERENCE_TIME)((audioSinkBufferDurationMsec / format.m_frameSize) * format.m_frameSize); //even number of frames
 
   if (format.m_dataFormat == AE_FMT_RAW)
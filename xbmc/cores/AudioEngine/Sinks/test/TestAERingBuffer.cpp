@@ -0,0 +1,119 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AERingBuffer.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+TEST(TestAERingBuffer, WrapAround)
+{
+  AERingBuffer buffer(8);
+  unsigned char in[6] = {1, 2, 3, 4, 5, 6};
+  unsigned char out[6] = {};
+
+  EXPECT_EQ(0, buffer.Write(in, 6));
+  EXPECT_EQ(2u, buffer.GetWriteSize());
+  EXPECT_EQ(2, buffer.Write(in, 3));
+  EXPECT_EQ(0, buffer.Read(out, 4));
+  EXPECT_EQ(0, buffer.Write(in, 6));
+  EXPECT_EQ(0u, buffer.GetWriteSize());
+
+  EXPECT_EQ(0, buffer.Read(out, 2));
+  EXPECT_EQ(5, out[0]);
+  EXPECT_EQ(6, out[1]);
+  EXPECT_EQ(0, buffer.Read(out, 6));
+  for (int i = 0; i < 6; i++)
+    EXPECT_EQ(in[i], out[i]);
+  EXPECT_EQ(1, buffer.Read(out, 1));
+}
+
+TEST(TestAERingBuffer, PlanesPublishedTogether)
+{
+  AERingBuffer buffer(16, 2);
+  unsigned char in[4] = {1, 2, 3, 4};
+
+  EXPECT_EQ(0, buffer.Write(in, 4, 0));
+  EXPECT_EQ(0u, buffer.GetReadSize());
+  EXPECT_EQ(0, buffer.Write(in, 4, 1));
+  EXPECT_EQ(4u, buffer.GetReadSize());
+}
+
+TEST(TestAERingBuffer, ProducerConsumer)
+{
+  const unsigned int total = 1 << 20;
+  AERingBuffer buffer(1000, 2);
+
+  std::thread producer([&buffer, total]()
+  {
+    unsigned char chunk[97];
+    unsigned int written = 0;
+    while (written < total)
+    {
+      unsigned int size = std::min<unsigned int>(sizeof(chunk), total - written);
+      if (buffer.GetWriteSize() < size)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      for (unsigned int i = 0; i < size; i++)
+        chunk[i] = static_cast<unsigned char>(written + i);
+      buffer.Write(chunk, size, 0);
+      buffer.Write(chunk, size, 1);
+      written += size;
+    }
+  });
+
+  unsigned char chunk[61];
+  unsigned char other[61];
+  unsigned int read = 0;
+  bool match = true;
+  while (read < total && match)
+  {
+    unsigned int size = std::min<unsigned int>(sizeof(chunk), total - read);
+    if (buffer.GetReadSize() < size)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    buffer.Read(chunk, size, 0);
+    buffer.Read(other, size, 1);
+    for (unsigned int i = 0; i < size; i++)
+      match &= chunk[i] == static_cast<unsigned char>(read + i) && other[i] == chunk[i];
+    read += size;
+  }
+
+  if (!match)
+  {
+    // drain so the producer can finish
+    while (buffer.GetReadSize() > 0 || read < total)
+    {
+      unsigned int size = buffer.GetReadSize();
+      buffer.Read(NULL, size, 0);
+      buffer.Read(NULL, size, 1);
+      read += size;
+    }
+  }
+
+  producer.join();
+  EXPECT_TRUE(match);
+}
@@ -0,0 +1,118 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+// enough for 7.1 frames and odd tails, offsets cover every alignment
+const uint32_t MAX_COUNT = 8 * 5 + 3;
+const uint32_t MAX_OFFSET = 4;
+
+std::vector<float> MakeSamples(uint32_t count, float scale)
+{
+  std::vector<float> samples(count);
+  for (uint32_t i = 0; i < count; i++)
+    samples[i] = scale * ((i * 37 % 23) / 11.0f - 1.0f);
+  return samples;
+}
+}
+
+TEST(TestAEUtilKernels, MulArray)
+{
+  for (uint32_t offset = 0; offset < MAX_OFFSET; offset++)
+  {
+    for (uint32_t count = 0; count <= MAX_COUNT; count++)
+    {
+      std::vector<float> data = MakeSamples(offset + count, 1.0f);
+      std::vector<float> expected = data;
+      for (uint32_t i = offset; i < offset + count; i++)
+        expected[i] *= 0.3f;
+
+      CAEUtil::MulArray(data.data() + offset, 0.3f, count);
+      for (uint32_t i = 0; i < offset + count; i++)
+        EXPECT_FLOAT_EQ(expected[i], data[i]);
+    }
+  }
+}
+
+TEST(TestAEUtilKernels, MulAddArray)
+{
+  for (uint32_t offset = 0; offset < MAX_OFFSET; offset++)
+  {
+    for (uint32_t count = 0; count <= MAX_COUNT; count++)
+    {
+      std::vector<float> data = MakeSamples(offset + count, 0.4f);
+      std::vector<float> add = MakeSamples(count + 1, 0.5f);
+      std::vector<float> expected = data;
+      for (uint32_t i = 0; i < count; i++)
+        expected[offset + i] += add[i + 1] * 0.5f;
+
+      // add starts misaligned to data
+      EXPECT_FALSE(CAEUtil::MulAddArray(data.data() + offset, add.data() + 1, 0.5f, count));
+      for (uint32_t i = 0; i < offset + count; i++)
+        EXPECT_NEAR(expected[i], data[i], 1e-6f);
+    }
+  }
+}
+
+TEST(TestAEUtilKernels, MulAddArrayNeedsClamp)
+{
+  for (uint32_t count = 1; count <= MAX_COUNT; count++)
+  {
+    // every position of the loud sample must be seen, also in the tail
+    for (uint32_t pos = 0; pos < count; pos++)
+    {
+      std::vector<float> data(count, 0.5f);
+      std::vector<float> add(count, 0.0f);
+      add[pos] = -2.0f;
+      EXPECT_TRUE(CAEUtil::MulAddArray(data.data(), add.data(), 1.0f, count));
+    }
+  }
+}
+
+TEST(TestAEUtilKernels, ClampArray)
+{
+  for (uint32_t offset = 0; offset < MAX_OFFSET; offset++)
+  {
+    for (uint32_t count = 0; count <= MAX_COUNT; count++)
+    {
+      std::vector<float> data = MakeSamples(offset + count, 5.0f);
+      CAEUtil::ClampArray(data.data() + offset, count);
+      for (uint32_t i = offset; i < offset + count; i++)
+      {
+        EXPECT_LE(data[i], 1.0f);
+        EXPECT_GE(data[i], -1.0f);
+      }
+    }
+  }
+
+  // in range samples are compressed, but keep their sign and order
+  std::vector<float> data = {-0.9f, -0.5f, 0.0f, 0.5f, 0.9f};
+  CAEUtil::ClampArray(data.data(), data.size());
+  EXPECT_FLOAT_EQ(0.0f, data[2]);
+  for (size_t i = 1; i < data.size(); i++)
+    EXPECT_LT(data[i - 1], data[i]);
+  EXPECT_LT(data[4], 0.9f);
+}
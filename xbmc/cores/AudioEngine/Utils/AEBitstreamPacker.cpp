@@ -33,10 +33,7 @@
 #define EAC3_MAX_BURST_PAYLOAD_SIZE (24576 - BURST_HEADER_SIZE)
 
 CAEBitstreamPacker::CAEBitstreamPacker() :
-  m_trueHD   (NULL),
   m_trueHDPos(0),
-  m_dtsHD    (NULL),
-  m_dtsHDSize(0),
   m_eac3     (NULL),
   m_eac3Size (0),
   m_eac3FramesCount(0),
@@ -49,8 +46,6 @@ CAEBitstreamPacker::CAEBitstreamPacker() :
 
 CAEBitstreamPacker::~CAEBitstreamPacker()
 {
-  delete[] m_trueHD;
-  delete[] m_dtsHD;
   delete[] m_eac3;
 }
 
@@ -155,20 +150,17 @@ void CAEBitstreamPacker::PackTrueHD(CAEStreamInfo &info, uint8_t* data, int size
   static const uint8_t mat_middle_code[12] = { 0xC3, 0xC1, 0x42, 0x49, 0x3B, 0xFA, 0x82, 0x83, 0x49, 0x80, 0x77, 0xE0 };
   static const uint8_t mat_end_code   [16] = { 0xC3, 0xC2, 0xC0, 0xC4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x97, 0x11 };
 
-  /* create the buffer if it doesnt already exist */
-  if (!m_trueHD)
-  {
-    m_trueHD    = new uint8_t[MAT_FRAME_SIZE];
-    m_trueHDPos = 0;
-  }
+  static const size_t middle_code_pos = (12 * TRUEHD_FRAME_OFFSET) - BURST_HEADER_SIZE + MAT_MIDDLE_CODE_OFFSET;
+  static const size_t end_code_pos    = MAT_FRAME_SIZE - sizeof(mat_end_code);
 
-  /* setup the frame for the data */
+  /* the frame is built straight in the payload of the burst, the codes are
+   * written for each frame as packing swaps them in place */
+  uint8_t *mat = m_packedBuffer + IEC61937_DATA_OFFSET;
   if (m_trueHDPos == 0)
   {
-    memset(m_trueHD, 0, MAT_FRAME_SIZE);
-    memcpy(m_trueHD, mat_start_code, sizeof(mat_start_code));
-    memcpy(m_trueHD + (12 * TRUEHD_FRAME_OFFSET) - BURST_HEADER_SIZE + MAT_MIDDLE_CODE_OFFSET, mat_middle_code, sizeof(mat_middle_code));
-    memcpy(m_trueHD + MAT_FRAME_SIZE - sizeof(mat_end_code), mat_end_code, sizeof(mat_end_code));
+    memcpy(mat, mat_start_code, sizeof(mat_start_code));
+    memcpy(mat + middle_code_pos, mat_middle_code, sizeof(mat_middle_code));
+    memcpy(mat + end_code_pos, mat_end_code, sizeof(mat_end_code));
   }
 
   size_t offset;
@@ -179,13 +171,27 @@ void CAEBitstreamPacker::PackTrueHD(CAEStreamInfo &info, uint8_t* data, int size
   else
     offset = (m_trueHDPos * TRUEHD_FRAME_OFFSET) - BURST_HEADER_SIZE;
 
-  memcpy(m_trueHD + offset, data, size);
+  /* only the gap up to the next unit has to be cleared, not the whole frame */
+  size_t next;
+  if (m_trueHDPos == 11)
+    next = middle_code_pos;
+  else if (m_trueHDPos == 23)
+    next = end_code_pos;
+  else
+    next = ((m_trueHDPos + 1) * TRUEHD_FRAME_OFFSET) - BURST_HEADER_SIZE;
+
+  if (offset + size > end_code_pos)
+    size = end_code_pos - offset;
+
+  memcpy(mat + offset, data, size);
+  if (offset + size < next)
+    memset(mat + offset + size, 0, next - offset - size);
 
   /* if we have a full frame */
   if (++m_trueHDPos == 24)
   {
     m_trueHDPos = 0;
-    m_dataSize  = CAEPackIEC61937::PackTrueHD(m_trueHD, MAT_FRAME_SIZE, m_packedBuffer);
+    m_dataSize  = CAEPackIEC61937::PackTrueHD(NULL, MAT_FRAME_SIZE, m_packedBuffer);
   }
 }
 
@@ -194,19 +200,25 @@ void CAEBitstreamPacker::PackDTSHD(CAEStreamInfo &info, uint8_t* data, int size)
   static const uint8_t dtshd_start_code[10] = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0xfe };
   unsigned int dataSize = sizeof(dtshd_start_code) + 2 + size;
 
-  if (dataSize > m_dtsHDSize)
+  /* the burst needs room for the padding byte of an odd frame */
+  if (dataSize + (dataSize & 0x1) > (info.m_dtsPeriod << 2) - IEC61937_DATA_OFFSET ||
+      dataSize + (dataSize & 0x1) > sizeof(m_packedBuffer) - IEC61937_DATA_OFFSET)
   {
-    delete[] m_dtsHD;
-    m_dtsHDSize = dataSize;
-    m_dtsHD     = new uint8_t[dataSize];
-    memcpy(m_dtsHD, dtshd_start_code, sizeof(dtshd_start_code));
+    CLog::Log(LOGERROR, "CAEBitstreamPacker::PackDTSHD - frame of %d bytes exceeds the burst", size);
+    m_dataSize = 0;
+    return;
   }
 
-  m_dtsHD[sizeof(dtshd_start_code) + 0] = ((uint16_t)size & 0xFF00) >> 8;
-  m_dtsHD[sizeof(dtshd_start_code) + 1] = ((uint16_t)size & 0x00FF);
-  memcpy(m_dtsHD + sizeof(dtshd_start_code) + 2, data, size);
+  /* build the frame in the payload of the burst, it gets swapped in place */
+  uint8_t *frame = m_packedBuffer + IEC61937_DATA_OFFSET;
+  memcpy(frame, dtshd_start_code, sizeof(dtshd_start_code));
+  frame[sizeof(dtshd_start_code) + 0] = ((uint16_t)size & 0xFF00) >> 8;
+  frame[sizeof(dtshd_start_code) + 1] = ((uint16_t)size & 0x00FF);
+  memcpy(frame + sizeof(dtshd_start_code) + 2, data, size);
+  if (dataSize & 0x1)
+    frame[dataSize] = 0;
 
-  m_dataSize = CAEPackIEC61937::PackDTSHD(m_dtsHD, dataSize, m_packedBuffer, info.m_dtsPeriod);
+  m_dataSize = CAEPackIEC61937::PackDTSHD(NULL, dataSize, m_packedBuffer, info.m_dtsPeriod);
 }
 
 void CAEBitstreamPacker::PackEAC3(CAEStreamInfo &info, uint8_t* data, int size)
@@ -45,13 +45,11 @@ private:
   void PackDTSHD(CAEStreamInfo &info, uint8_t* data, int size);
   void PackEAC3(CAEStreamInfo &info, uint8_t* data, int size);
 
-  /* we keep the trueHD and dtsHD buffers separate so that we can handle a fast stream switch */
-  uint8_t      *m_trueHD;
+  /* the MAT frame of trueHD and the dtsHD frame are assembled in the payload of
+   * m_packedBuffer and swapped in place, a trueHD frame is always packed within
+   * one OutputSamples call of the sink, see Reset() */
   unsigned int  m_trueHDPos;
 
-  uint8_t      *m_dtsHD;
-  unsigned int  m_dtsHDSize;
-
   uint8_t      *m_eac3;
   unsigned int  m_eac3Size;
   unsigned int  m_eac3FramesCount;
@@ -27,6 +27,7 @@
 //#define AE_RING_BUFFER_DEBUG
 
 #include "utils/log.h"  //CLog
+#include <atomic>
 #include <string.h>     //memset, memcpy
 #ifdef TARGET_POSIX
 #include "platform/linux/XMemUtils.h"
@@ -34,7 +35,10 @@
 
 /**
  * This buffer can be used by one read and one write thread at any one time
- * without the risk of data corruption.
+ * without the risk of data corruption. Neither side ever blocks, so the
+ * reader may be a real time audio callback.
+ * The writer publishes data by advancing the written count after all planes
+ * are copied, the reader frees space the same way with the read count.
  * If you intend to call the Reset() method, please use Locks.
  * All other operations are thread-safe.
  */
@@ -103,8 +107,8 @@ public:
 #ifdef AE_RING_BUFFER_DEBUG
     CLog::Log(LOGDEBUG, "AERingBuffer::Reset: Buffer reset.");
 #endif
-    m_iWritten = 0;
-    m_iRead = 0;
+    m_iWritten.store(0, std::memory_order_relaxed);
+    m_iRead.store(0, std::memory_order_relaxed);
     m_iReadPos = 0;
     m_iWritePos = 0;
   }
@@ -239,7 +243,8 @@ public:
    */
   unsigned int GetWriteSize()
   {
-    return m_iSize - ( m_iWritten - m_iRead );
+    // acquire the read count, the reader is done with the space it freed
+    return m_iSize - ( m_iWritten.load(std::memory_order_relaxed) - m_iRead.load(std::memory_order_acquire) );
   }
 
   /**
@@ -248,7 +253,8 @@ public:
    */
   unsigned int GetReadSize()
   {
-    return m_iWritten - m_iRead;
+    // acquire the written count, the data it covers is visible then
+    return m_iWritten.load(std::memory_order_acquire) - m_iRead.load(std::memory_order_relaxed);
   }
 
   /**
@@ -279,7 +285,7 @@ private:
       m_iWritePos = size - (m_iSize - m_iWritePos);
 
     //we can increase the write count now
-    m_iWritten+=size;
+    m_iWritten.fetch_add(size, std::memory_order_release);
   }
 
   /**
@@ -294,13 +300,13 @@ private:
       m_iReadPos = size - (m_iSize - m_iReadPos);
 
     //we can increase the read count now
-    m_iRead+=size;
+    m_iRead.fetch_add(size, std::memory_order_release);
   }
 
   unsigned int m_iReadPos;
   unsigned int m_iWritePos;
-  unsigned int m_iRead;
-  unsigned int m_iWritten;
+  std::atomic<unsigned int> m_iRead; // only advanced by the reader
+  std::atomic<unsigned int> m_iWritten; // only advanced by the writer
   unsigned int m_iSize;
   unsigned int m_planes;
   unsigned char **m_Buffer;
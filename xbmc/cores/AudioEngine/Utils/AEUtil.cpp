@@ -25,8 +25,13 @@
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 
+#include <algorithm>
 #include <cassert>
 
+#if defined(HAS_NEON)
+#include <arm_neon.h>
+#endif
+
 extern "C" {
 #include "libavutil/channel_layout.h"
 }
@@ -367,13 +372,11 @@ inline float CAEUtil::SoftClamp(const float x)
 
 void CAEUtil::ClampArray(float *data, uint32_t count)
 {
-#if !defined(HAVE_SSE) || !defined(__SSE__)
-  for (uint32_t i = 0; i < count; ++i)
-    data[i] = SoftClamp(data[i]);
-
-#else
+#if defined(HAVE_SSE) && defined(__SSE__)
   const __m128 c1 = _mm_set_ps1(27.0f);
-  const __m128 c2 = _mm_set_ps1(27.0f + 9.0f);
+  const __m128 c2 = _mm_set_ps1(9.0f);
+  const __m128 lo = _mm_set_ps1(-3.0f);
+  const __m128 hi = _mm_set_ps1(3.0f);
 
   /* work around invalid alignment */
   while (((uintptr_t)data & 0xF) && count > 0)
@@ -386,64 +389,126 @@ void CAEUtil::ClampArray(float *data, uint32_t count)
   uint32_t even = count & ~0x3;
   for (uint32_t i = 0; i < even; i+=4, data+=4)
   {
-    /* tanh approx clamp */
-    __m128 dt = _mm_load_ps(data);
+    /* tanh approx clamp, the approximation reaches +-1 at +-3 */
+    __m128 dt = _mm_min_ps(_mm_max_ps(_mm_load_ps(data), lo), hi);
     __m128 tmp     = _mm_mul_ps(dt, dt);
     *(__m128*)data = _mm_div_ps(
       _mm_mul_ps(
         dt,
         _mm_add_ps(c1, tmp)
       ),
-      _mm_add_ps(c2, tmp)
+      _mm_add_ps(c1, _mm_mul_ps(c2, tmp))
     );
   }
 
-  if (even != count)
+  for (uint32_t i = even; i < count; ++i, ++data)
+    data[0] = SoftClamp(data[0]);
+#elif defined(HAS_NEON)
+  const float32x4_t c1 = vdupq_n_f32(27.0f);
+  const float32x4_t c2 = vdupq_n_f32(9.0f);
+  const float32x4_t lo = vdupq_n_f32(-3.0f);
+  const float32x4_t hi = vdupq_n_f32(3.0f);
+
+  uint32_t even = count & ~0x3;
+  for (uint32_t i = 0; i < even; i+=4)
   {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] = SoftClamp(data[0]);
-    else
-    {
-      __m128 dt;
-      __m128 tmp;
-      __m128 out;
-      if (odd == 2)
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], 0, 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-      }
-      else
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], data[2], 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-        data[2] = ((float*)&out)[2];
-      }
-    }
+    float32x4_t dt  = vminq_f32(vmaxq_f32(vld1q_f32(data + i), lo), hi);
+    float32x4_t tmp = vmulq_f32(dt, dt);
+    float32x4_t num = vmulq_f32(dt, vaddq_f32(c1, tmp));
+    float32x4_t den = vmlaq_f32(c1, c2, tmp);
+#if defined(__aarch64__)
+    vst1q_f32(data + i, vdivq_f32(num, den));
+#else
+    /* no vector divide on armv7, refine the reciprocal estimate twice */
+    float32x4_t rcp = vrecpeq_f32(den);
+    rcp = vmulq_f32(vrecpsq_f32(den, rcp), rcp);
+    rcp = vmulq_f32(vrecpsq_f32(den, rcp), rcp);
+    vst1q_f32(data + i, vmulq_f32(num, rcp));
+#endif
+  }
+
+  for (uint32_t i = even; i < count; ++i)
+    data[i] = SoftClamp(data[i]);
+#else
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] = SoftClamp(data[i]);
+#endif
+}
+
+void CAEUtil::MulArray(float *data, const float mul, uint32_t count)
+{
+#if defined(HAVE_SSE) && defined(__SSE__)
+  SSEMulArray(data, mul, count);
+#elif defined(HAS_NEON)
+  const float32x4_t m = vdupq_n_f32(mul);
+
+  uint32_t even = count & ~0x3;
+  for (uint32_t i = 0; i < even; i+=4)
+    vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), m));
+
+  for (uint32_t i = even; i < count; ++i)
+    data[i] *= mul;
+#else
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] *= mul;
+#endif
+}
+
+bool CAEUtil::MulAddArray(float *data, float *add, const float mul, uint32_t count)
+{
+  float peak = 0.0f;
+
+#if defined(HAVE_SSE) && defined(__SSE__)
+  const __m128 m = _mm_set_ps1(mul);
+  const __m128 sign = _mm_set_ps1(-0.0f);
+  __m128 peak4 = _mm_setzero_ps();
+
+  /* work around invalid alignment */
+  while ((((uintptr_t)data & 0xF) || ((uintptr_t)add & 0xF)) && count > 0)
+  {
+    data[0] += add[0] * mul;
+    peak = std::max(peak, fabsf(data[0]));
+    ++add;
+    ++data;
+    --count;
   }
+
+  uint32_t even = count & ~0x3;
+  for (uint32_t i = 0; i < even; i+=4)
+  {
+    __m128 to = _mm_add_ps(_mm_load_ps(data + i), _mm_mul_ps(_mm_load_ps(add + i), m));
+    _mm_store_ps(data + i, to);
+    peak4 = _mm_max_ps(peak4, _mm_andnot_ps(sign, to));
+  }
+
+  MEMALIGN(16, float peaks[4]);
+  _mm_store_ps(peaks, peak4);
+  peak = std::max(peak, std::max(std::max(peaks[0], peaks[1]), std::max(peaks[2], peaks[3])));
+#elif defined(HAS_NEON)
+  const float32x4_t m = vdupq_n_f32(mul);
+  float32x4_t peak4 = vdupq_n_f32(0.0f);
+
+  uint32_t even = count & ~0x3;
+  for (uint32_t i = 0; i < even; i+=4)
+  {
+    float32x4_t to = vmlaq_f32(vld1q_f32(data + i), vld1q_f32(add + i), m);
+    vst1q_f32(data + i, to);
+    peak4 = vmaxq_f32(peak4, vabsq_f32(to));
+  }
+
+  float32x2_t peak2 = vpmax_f32(vget_low_f32(peak4), vget_high_f32(peak4));
+  peak = vget_lane_f32(vpmax_f32(peak2, peak2), 0);
+#else
+  const uint32_t even = 0;
 #endif
+
+  for (uint32_t i = even; i < count; ++i)
+  {
+    data[i] += add[i] * mul;
+    peak = std::max(peak, fabsf(data[i]));
+  }
+
+  return peak > 1.0f;
 }
 
 bool CAEUtil::S16NeedsByteSwap(AEDataFormat in, AEDataFormat out)
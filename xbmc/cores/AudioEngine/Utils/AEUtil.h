@@ -208,6 +208,17 @@ public:
   #endif
   static void ClampArray(float *data, uint32_t count);
 
+  /*! \brief multiply count floats in data by mul
+   Uses SSE or NEON where available, data needs no alignment.
+   */
+  static void MulArray(float *data, const float mul, uint32_t count);
+
+  /*! \brief add count floats of add multiplied by mul to data
+   Uses SSE or NEON where available, data needs no alignment.
+   \return true if a resulting sample is out of range and needs to be clamped
+   */
+  static bool MulAddArray(float *data, float *add, const float mul, uint32_t count);
+
   static bool S16NeedsByteSwap(AEDataFormat in, AEDataFormat out);
 
   static uint64_t GetAVChannelLayout(const CAEChannelInfo &info);
@@ -46,6 +46,14 @@ void CDataCacheCore::Reset()
   m_stateInfo.m_renderGuiLayer = false;
   m_stateInfo.m_renderVideoLayer = false;
   m_playerStateChanged = false;
+
+  CSingleLock renderLock(m_renderSection);
+
+  m_renderInfo.m_timings.clear();
+
+  CSingleLock audioLock(m_audioPlayerSection);
+
+  m_playerAudioInfo.syncStats = SAudioSyncStats();
 }
 
 bool CDataCacheCore::HasAVInfoChanges()
@@ -180,6 +188,50 @@ float CDataCacheCore::GetVideoDAR()
   return m_playerVideoInfo.dar;
 }
 
+void CDataCacheCore::SetVideoDecodeTime(double avg, double max)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_playerVideoInfo.decodeTime = avg;
+  m_playerVideoInfo.decodeTimeMax = max;
+}
+
+double CDataCacheCore::GetVideoDecodeTime()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decodeTime;
+}
+
+double CDataCacheCore::GetVideoDecodeTimeMax()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.decodeTimeMax;
+}
+
+void CDataCacheCore::SetInputLatency(double avg, double max)
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  m_playerVideoInfo.inputLatency = avg;
+  m_playerVideoInfo.inputLatencyMax = max;
+}
+
+double CDataCacheCore::GetInputLatency()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.inputLatency;
+}
+
+double CDataCacheCore::GetInputLatencyMax()
+{
+  CSingleLock lock(m_videoPlayerSection);
+
+  return m_playerVideoInfo.inputLatencyMax;
+}
+
 // player audio info
 void CDataCacheCore::SetAudioDecoderName(std::string name)
 {
@@ -237,6 +289,20 @@ int CDataCacheCore::GetAudioBitsPerSample()
   return m_playerAudioInfo.bitsPerSample;
 }
 
+void CDataCacheCore::SetAudioSyncStats(const SAudioSyncStats &stats)
+{
+  CSingleLock lock(m_audioPlayerSection);
+
+  m_playerAudioInfo.syncStats = stats;
+}
+
+SAudioSyncStats CDataCacheCore::GetAudioSyncStats()
+{
+  CSingleLock lock(m_audioPlayerSection);
+
+  return m_playerAudioInfo.syncStats;
+}
+
 void CDataCacheCore::SetRenderClockSync(bool enable)
 {
   CSingleLock lock(m_renderSection);
@@ -251,6 +317,20 @@ bool CDataCacheCore::IsRenderClockSync()
   return m_renderInfo.m_isClockSync;
 }
 
+void CDataCacheCore::SetRenderTimings(const std::vector<float> &timings)
+{
+  CSingleLock lock(m_renderSection);
+
+  m_renderInfo.m_timings = timings;
+}
+
+std::vector<float> CDataCacheCore::GetRenderTimings()
+{
+  CSingleLock lock(m_renderSection);
+
+  return m_renderInfo.m_timings;
+}
+
 // player states
 void CDataCacheCore::SetStateSeeking(bool active)
 {
@@ -22,8 +22,26 @@
 
 #include <atomic>
 #include <string>
+#include <vector>
 #include "threads/CriticalSection.h"
 
+/*!
+ * Percentiles of the audio timing of the playing stream over its last
+ * minutes, used to compare how well sync holds on different sinks.
+ */
+struct SAudioSyncStats
+{
+  int samples = 0;           //!< number of values the percentiles are taken of
+  float delay50 = 0.0f;      //!< sink delay in ms
+  float delay95 = 0.0f;
+  float error50 = 0.0f;      //!< absolute a/v sync error in ms
+  float error95 = 0.0f;
+  float error99 = 0.0f;
+  float correction50 = 0.0f; //!< absolute resample ratio correction in ppm
+  float correction95 = 0.0f;
+  int underruns = 0;         //!< times the audio buffer ran dry since the stream was opened
+};
+
 class CDataCacheCore
 {
 public:
@@ -51,6 +69,12 @@ public:
   float GetVideoFps();
   void SetVideoDAR(float dar);
   float GetVideoDAR();
+  void SetVideoDecodeTime(double avg, double max);
+  double GetVideoDecodeTime();
+  double GetVideoDecodeTimeMax();
+  void SetInputLatency(double avg, double max);
+  double GetInputLatency();
+  double GetInputLatencyMax();
 
   // player audio info
   void SetAudioDecoderName(std::string name);
@@ -61,10 +85,14 @@ public:
   int GetAudioSampleRate();
   void SetAudioBitsPerSample(int bitsPerSample);
   int GetAudioBitsPerSample();
+  void SetAudioSyncStats(const SAudioSyncStats &stats);
+  SAudioSyncStats GetAudioSyncStats();
 
   // render info
   void SetRenderClockSync(bool enabled);
   bool IsRenderClockSync();
+  void SetRenderTimings(const std::vector<float> &timings);
+  std::vector<float> GetRenderTimings();
 
   // player states
   void SetStateSeeking(bool active);
@@ -128,6 +156,10 @@ protected:
     int height;
     float fps;
     float dar;
+    double decodeTime;
+    double decodeTimeMax;
+    double inputLatency;
+    double inputLatencyMax;
   } m_playerVideoInfo;
 
   CCriticalSection m_audioPlayerSection;
@@ -137,12 +169,14 @@ protected:
     std::string channels;
     int sampleRate;
     int bitsPerSample;
+    SAudioSyncStats syncStats;
   } m_playerAudioInfo;
 
   CCriticalSection m_renderSection;
   struct SRenderInfo
   {
     bool m_isClockSync;
+    std::vector<float> m_timings;
   } m_renderInfo;
 
   CCriticalSection m_stateSection;
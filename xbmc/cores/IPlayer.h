@@ -37,6 +37,22 @@ class TiXmlElement;
 class CStreamDetails;
 class CAction;
 
+/*!
+ * Receives the frames of a continuous render capture as soon as they have been
+ * read back, instead of polling RenderCaptureGetPixels.
+ */
+class IRenderCaptureCallback
+{
+public:
+  virtual ~IRenderCaptureCallback() = default;
+
+  /*!
+   * Called on the render thread, implementations have to return quickly.
+   * \param pixels BGRA image of width * height * 4 bytes, only valid for the duration of the call
+   */
+  virtual void OnCaptureFrame(unsigned int captureId, const uint8_t* pixels, unsigned int width, unsigned int height) = 0;
+};
+
 class CPlayerOptions
 {
 public:
@@ -171,6 +187,14 @@ public:
    */
   virtual bool SeekTimeRelative(int64_t iTime) { return false; }
 
+  /*
+   \brief seek to the keyframe nearest to a time to preview it while a seek is being adjusted,
+   returns false if not implemented by player
+   \param iTime The absolute time in milliseconds to preview
+   \return True if the player supports preview seeking, otherwise false
+   */
+  virtual bool SeekTimePreview(int64_t iTime) { return false; }
+
   /*!
    \brief Sets the current time. This 
    can be used for injecting the current time. 
@@ -216,6 +240,11 @@ public:
    \brief hook into render loop of render thread
    */
   virtual void Render(bool clear, uint32_t alpha = 255, bool gui = true) {};
+  /*!
+   \brief bracket the gui layer pass of the render thread, used to measure its GPU time
+   */
+  virtual void BeginGuiRender() {};
+  virtual void EndGuiRender() {};
   virtual void FlushRenderer() {};
   virtual void SetRenderViewMode(int mode, float zoom, float par, float shift, bool stretch) {};
   virtual float GetRenderAspectRatio() { return 1.0; };
@@ -231,6 +260,7 @@ public:
   virtual void RenderCaptureRelease(unsigned int captureId) {};
   virtual void RenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags) {};
   virtual bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size) { return false; };
+  virtual void RenderCaptureSetCallback(unsigned int captureId, IRenderCaptureCallback* callback) {};
 
   // video and audio settings
   virtual CVideoSettings GetVideoSettings() { return CVideoSettings(); };
@@ -128,7 +128,7 @@ bool CRetroPlayer::OpenFile(const CFileItem& file, const CPlayerOptions& options
     {
       m_audio.reset(new CRetroPlayerAudio(*m_processInfo));
       m_video.reset(new CRetroPlayerVideo(*m_renderManager, *m_processInfo));
-      m_input.reset(new CRetroPlayerInput(CServiceBroker::GetPeripherals()));
+      m_input.reset(new CRetroPlayerInput(CServiceBroker::GetPeripherals(), *m_processInfo));
 
       if (!bStandalone)
       {
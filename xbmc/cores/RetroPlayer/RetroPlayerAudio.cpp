@@ -28,9 +28,15 @@
 #include "threads/Thread.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace KODI;
 using namespace RETRO;
 
+#define MAX_RATE_CONTROL_DELTA  0.005 // Resample by up to 0.5% to keep the buffer level
+#define CACHE_FILL_SMOOTHING    0.1   // Weight of the latest fill level, audio arrives in bursts of one video frame
+
 CRetroPlayerAudio::CRetroPlayerAudio(CRPProcessInfo& processInfo) :
   m_processInfo(processInfo),
   m_pAudioStream(nullptr),
@@ -90,7 +96,11 @@ bool CRetroPlayerAudio::OpenPCMStream(AEDataFormat format, unsigned int samplera
   audioFormat.m_dataFormat = format;
   audioFormat.m_sampleRate = samplerate;
   audioFormat.m_channelLayout = channelLayout;
-  m_pAudioStream = CServiceBroker::GetActiveAE()->MakeStream(audioFormat);
+
+  // Games are paced by the system clock or the display, not by the audio
+  // clock. With the small buffer of a low latency stream the drift would
+  // soon run it dry or full, so resample to keep it half full.
+  m_pAudioStream = CServiceBroker::GetActiveAE()->MakeStream(audioFormat, AESTREAM_LOW_LATENCY | AESTREAM_FORCE_RESAMPLE);
 
   if (!m_pAudioStream)
   {
@@ -98,6 +108,8 @@ bool CRetroPlayerAudio::OpenPCMStream(AEDataFormat format, unsigned int samplera
     return false;
   }
 
+  m_cacheFill = -1.0;
+
   m_processInfo.SetAudioChannels(audioFormat.m_channelLayout);
   m_processInfo.SetAudioSampleRate(audioFormat.m_sampleRate);
   m_processInfo.SetAudioBitsPerSample(CAEUtil::DataFormatToUsedBits(audioFormat.m_dataFormat));
@@ -118,12 +130,36 @@ void CRetroPlayerAudio::AddData(const uint8_t* data, size_t size)
   {
     if (m_pAudioStream)
     {
+      UpdateResampleRatio();
+
       const size_t frameSize = m_pAudioStream->GetChannelCount() * (CAEUtil::DataFormatToBits(m_pAudioStream->GetDataFormat()) >> 3);
       m_pAudioStream->AddData(&data, 0, static_cast<unsigned int>(size / frameSize));
     }
   }
 }
 
+void CRetroPlayerAudio::UpdateResampleRatio()
+{
+  const double cacheTotal = m_pAudioStream->GetCacheTotal();
+  if (cacheTotal <= 0.0)
+    return;
+
+  const double fill = std::min(m_pAudioStream->GetCacheTime() / cacheTotal, 1.0);
+  if (m_cacheFill < 0.0)
+    m_cacheFill = fill;
+  else
+    m_cacheFill += CACHE_FILL_SMOOTHING * (fill - m_cacheFill);
+
+  // Stretch audio while the buffer is less than half full, squeeze it above
+  double ratio = (1.0 + MAX_RATE_CONTROL_DELTA * (1.0 - 2.0 * m_cacheFill)) / m_playbackRate;
+
+  // Every change is a message to the audio engine, steps of 0.01% are enough
+  ratio = std::round(ratio * 10000.0) / 10000.0;
+
+  if (ratio != m_pAudioStream->GetResampleRatio())
+    m_pAudioStream->SetResampleRatio(ratio);
+}
+
 void CRetroPlayerAudio::CloseStream()
 {
   if (m_pAudioStream)
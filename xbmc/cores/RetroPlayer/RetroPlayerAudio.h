@@ -43,13 +43,18 @@ namespace RETRO
     bool OpenEncodedStream(AVCodecID codec, unsigned int samplerate, const CAEChannelInfo& channelLayout) override;
     void AddData(const uint8_t* data, size_t size) override;
     void CloseStream() override;
+    void SetPlaybackRate(double rate) override { m_playbackRate = rate; }
 
     void Enable(bool bEnabled) { m_bAudioEnabled = bEnabled; }
 
   private:
+    void UpdateResampleRatio();
+
     CRPProcessInfo& m_processInfo;
     IAEStream* m_pAudioStream;
     bool       m_bAudioEnabled;
+    double     m_playbackRate = 1.0;
+    double     m_cacheFill = -1.0; // Smoothed fill level of the audio buffer, -1 until measured
   };
 }
 }
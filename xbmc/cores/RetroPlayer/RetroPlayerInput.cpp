@@ -19,15 +19,18 @@
  */
 
 #include "RetroPlayerInput.h"
+#include "cores/RetroPlayer/process/RPProcessInfo.h"
 #include "peripherals/Peripherals.h"
 #include "peripherals/EventPollHandle.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 
 using namespace KODI;
 using namespace RETRO;
 
-CRetroPlayerInput::CRetroPlayerInput(PERIPHERALS::CPeripherals &peripheralManager) :
-  m_peripheralManager(peripheralManager)
+CRetroPlayerInput::CRetroPlayerInput(PERIPHERALS::CPeripherals &peripheralManager, CRPProcessInfo &processInfo) :
+  m_peripheralManager(peripheralManager),
+  m_processInfo(processInfo)
 {
   CLog::Log(LOGDEBUG, "RetroPlayer[INPUT]: Initializing input");
 
@@ -51,5 +54,8 @@ void CRetroPlayerInput::SetSpeed(double speed)
 
 void CRetroPlayerInput::PollInput()
 {
+  // Input latency is measured from here to when the frame is shown
+  m_processInfo.SetInputPollTime(XbmcThreads::SystemClockNanos());
+
   m_inputPollHandle->HandleEvents(true);
 }
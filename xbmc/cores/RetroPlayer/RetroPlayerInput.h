@@ -31,10 +31,12 @@ namespace KODI
 {
 namespace RETRO
 {
+  class CRPProcessInfo;
+
   class CRetroPlayerInput : public GAME::IGameInputCallback
   {
   public:
-    CRetroPlayerInput(PERIPHERALS::CPeripherals &peripheralManager);
+    CRetroPlayerInput(PERIPHERALS::CPeripherals &peripheralManager, CRPProcessInfo &processInfo);
     ~CRetroPlayerInput() override;
 
     void SetSpeed(double speed);
@@ -45,6 +47,7 @@ namespace RETRO
   private:
     // Construction parameters
     PERIPHERALS::CPeripherals &m_peripheralManager;
+    CRPProcessInfo &m_processInfo;
 
     // Input variables
     PERIPHERALS::EventPollHandlePtr m_inputPollHandle;
@@ -70,6 +70,11 @@ void CRetroPlayerVideo::AddData(const uint8_t* data, size_t size)
   m_renderManager.AddFrame(data, size);
 }
 
+uint8_t* CRetroPlayerVideo::GetBuffer(size_t size)
+{
+  return m_renderManager.GetFrameBuffer(size);
+}
+
 void CRetroPlayerVideo::CloseStream()
 {
   CLog::Log(LOGDEBUG, "RetroPlayer[VIDEO]: Closing video stream");
@@ -47,6 +47,7 @@ namespace RETRO
     bool OpenEncodedStream(AVCodecID codec) override;
     void AddData(const uint8_t* data, size_t size) override;
     void CloseStream() override;
+    uint8_t* GetBuffer(size_t size) override;
 
   private:
     // Construction parameters
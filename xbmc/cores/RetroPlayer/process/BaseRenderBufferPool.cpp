@@ -123,6 +123,7 @@ void CBaseRenderBufferPool::Return(IRenderBuffer *buffer)
 
   buffer->SetLoaded(false);
   buffer->SetRendered(false);
+  buffer->SetInputTime(0);
 
   m_free.emplace_back(buffer);
 }
@@ -62,6 +62,8 @@ namespace RETRO
     void SetLoaded(bool bLoaded) { m_bLoaded = bLoaded; }
     bool IsRendered() const { return m_bRendered; }
     void SetRendered(bool bRendered) { m_bRendered = bRendered; }
+    uint64_t GetInputTime() const { return m_inputTimeNs; }
+    void SetInputTime(uint64_t inputTimeNs) { m_inputTimeNs = inputTimeNs; }
 
   protected:
     AVPixelFormat m_format = AV_PIX_FMT_NONE;
@@ -69,6 +71,7 @@ namespace RETRO
     unsigned int m_height = 0;
     bool m_bLoaded = false;
     bool m_bRendered = false;
+    uint64_t m_inputTimeNs = 0; // When the input of this frame was polled
   };
 }
 }
@@ -35,6 +35,7 @@ extern "C" {
 #include "libavutil/pixdesc.h"
 }
 
+#include <algorithm>
 #include <utility>
 
 using namespace KODI;
@@ -167,6 +168,7 @@ void CRPProcessInfo::ResetInfo()
     m_dataCache->SetAudioChannels("");
     m_dataCache->SetAudioSampleRate(0);
     m_dataCache->SetAudioBitsPerSample(0);
+    m_dataCache->SetInputLatency(0.0, 0.0);
     m_dataCache->SetRenderClockSync(false);
     m_dataCache->SetStateSeeking(false);
     m_dataCache->SetSpeed(1.0f, 1.0f);
@@ -212,6 +214,33 @@ void CRPProcessInfo::SetVideoFps(float fps)
     m_dataCache->SetVideoFps(fps);
 }
 
+//******************************************************************************
+// player input info
+//******************************************************************************
+void CRPProcessInfo::UpdateInputLatency(double ms)
+{
+  // Only called from the render thread
+  if (m_inputLatencyFrames == 0 && m_inputLatencyAvg == 0.0)
+    m_inputLatencyAvg = ms;
+  else
+    m_inputLatencyAvg += (ms - m_inputLatencyAvg) / 16;
+
+  m_inputLatencyPeak = std::max(m_inputLatencyPeak, ms);
+
+  // report the peak of the last 100 frames
+  if (++m_inputLatencyFrames >= 100)
+  {
+    m_inputLatencyMax = m_inputLatencyPeak;
+    m_inputLatencyPeak = 0.0;
+    m_inputLatencyFrames = 0;
+  }
+  else
+    m_inputLatencyMax = std::max(m_inputLatencyMax, ms);
+
+  if (m_dataCache != nullptr)
+    m_dataCache->SetInputLatency(m_inputLatencyAvg, m_inputLatencyMax);
+}
+
 //******************************************************************************
 // player audio info
 //******************************************************************************
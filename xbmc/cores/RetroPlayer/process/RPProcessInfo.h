@@ -25,6 +25,7 @@
 
 #include "libavutil/pixfmt.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -87,6 +88,11 @@ namespace RETRO
     void SetAudioSampleRate(int sampleRate);
     void SetAudioBitsPerSample(int bitsPerSample);
 
+    // player input info
+    void SetInputPollTime(uint64_t timeNs) { m_inputPollTimeNs = timeNs; }
+    uint64_t GetInputPollTime() const { return m_inputPollTimeNs; }
+    void UpdateInputLatency(double ms);
+
     // player states
     void SetSpeed(float speed);
     void SetPlayTimes(time_t start, int64_t current, int64_t min, int64_t max);
@@ -114,6 +120,13 @@ namespace RETRO
     // Rendering parameters
     std::unique_ptr<CRenderContext> m_renderContext;
     ESCALINGMETHOD m_defaultScalingMethod = VS_SCALINGMETHOD_AUTO;
+
+    // Input parameters
+    std::atomic<uint64_t> m_inputPollTimeNs{0};
+    double m_inputLatencyAvg = 0.0;
+    double m_inputLatencyMax = 0.0;
+    double m_inputLatencyPeak = 0.0;
+    int m_inputLatencyFrames = 0;
   };
 
 }
@@ -33,6 +33,7 @@
 #include "utils/TransformMatrix.h"
 #include "messaging/ApplicationMessenger.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/Color.h"
 #include "utils/log.h"
 
@@ -74,6 +75,12 @@ void CRPRenderManager::Deinitialize()
     renderBuffer->Release();
   m_renderBuffers.clear();
 
+  if (m_frameBuffer != nullptr)
+  {
+    m_frameBuffer->Release();
+    m_frameBuffer = nullptr;
+  }
+
   m_renderers.clear();
 
   m_state = RENDER_STATE::UNCONFIGURED;
@@ -105,6 +112,20 @@ void CRPRenderManager::AddFrame(const uint8_t* data, size_t size)
   if (data == nullptr || size == 0)
     return;
 
+  // Take back the buffer from GetFrameBuffer(), if the frame was rendered into it
+  IRenderBuffer *frameBuffer = nullptr;
+  {
+    CSingleLock lock(m_bufferMutex);
+    std::swap(frameBuffer, m_frameBuffer);
+  }
+  if (frameBuffer != nullptr && data != frameBuffer->GetMemory())
+  {
+    frameBuffer->Release();
+    frameBuffer = nullptr;
+  }
+
+  const uint64_t inputTimeNs = m_processInfo.GetInputPollTime();
+
   // Copy frame to buffers with visible renderers
   std::vector<IRenderBuffer*> renderBuffers;
   for (IRenderBufferPool *bufferPool : m_processInfo.GetBufferManager().GetBufferPools())
@@ -112,10 +133,19 @@ void CRPRenderManager::AddFrame(const uint8_t* data, size_t size)
     if (!bufferPool->HasVisibleRenderer())
       continue;
 
+    if (frameBuffer != nullptr && frameBuffer->GetPool() == bufferPool)
+    {
+      frameBuffer->SetInputTime(inputTimeNs);
+      renderBuffers.emplace_back(frameBuffer);
+      frameBuffer = nullptr;
+      continue;
+    }
+
     IRenderBuffer *renderBuffer = bufferPool->GetBuffer(size);
     if (renderBuffer != nullptr)
     {
       CopyFrame(renderBuffer, data, size, m_format);
+      renderBuffer->SetInputTime(inputTimeNs);
       renderBuffers.emplace_back(renderBuffer);
     }
   }
@@ -149,6 +179,57 @@ void CRPRenderManager::AddFrame(const uint8_t* data, size_t size)
       }
     }
   }
+
+  // Its renderer went away since GetFrameBuffer(), data is still valid up to here
+  if (frameBuffer != nullptr)
+    frameBuffer->Release();
+}
+
+uint8_t *CRPRenderManager::GetFrameBuffer(size_t size)
+{
+  if (size == 0)
+    return nullptr;
+
+  {
+    CSingleLock lock(m_bufferMutex);
+
+    // The last frame was never added, e.g. because it was run ahead
+    if (m_frameBuffer != nullptr)
+      return m_frameBuffer->GetFrameSize() == size ? m_frameBuffer->GetMemory() : nullptr;
+  }
+
+  // With more than one visible renderer, the frame is copied at least once anyway
+  IRenderBufferPool *framePool = nullptr;
+  for (IRenderBufferPool *bufferPool : m_processInfo.GetBufferManager().GetBufferPools())
+  {
+    if (!bufferPool->HasVisibleRenderer())
+      continue;
+
+    if (framePool != nullptr)
+      return nullptr;
+
+    framePool = bufferPool;
+  }
+
+  if (framePool == nullptr)
+    return nullptr;
+
+  IRenderBuffer *renderBuffer = framePool->GetBuffer(size);
+  if (renderBuffer == nullptr)
+    return nullptr;
+
+  // Pixels that need converting or a different layout go through CopyFrame()
+  if (renderBuffer->GetFormat() != m_format || renderBuffer->GetFrameSize() != size)
+  {
+    renderBuffer->Release();
+    return nullptr;
+  }
+
+  CSingleLock lock(m_bufferMutex);
+
+  m_frameBuffer = renderBuffer;
+
+  return renderBuffer->GetMemory();
 }
 
 void CRPRenderManager::SetSpeed(double speed)
@@ -189,6 +270,16 @@ void CRPRenderManager::Flush()
   for (const auto &renderer : m_renderers)
     renderer->Flush();
 
+  {
+    CSingleLock lock(m_bufferMutex);
+
+    if (m_frameBuffer != nullptr)
+    {
+      m_frameBuffer->Release();
+      m_frameBuffer = nullptr;
+    }
+  }
+
   m_processInfo.GetBufferManager().FlushPools();
 }
 
@@ -307,6 +398,10 @@ void CRPRenderManager::RenderInternal(const std::shared_ptr<CRPBaseRenderer> &re
     {
       bUploaded = renderBuffer->UploadTexture();
       renderBuffer->SetLoaded(true);
+
+      // The frame is shown for the first time
+      if (renderBuffer->GetInputTime() != 0)
+        m_processInfo.UpdateInputLatency((XbmcThreads::SystemClockNanos() - renderBuffer->GetInputTime()) / 1000000.0);
     }
 
     if (bUploaded)
@@ -60,6 +60,10 @@ namespace RETRO
    * a visible renderer. For example, if a GLES and MMAL renderer are both
    * visible in the GUI, then the frame will be copied into two buffers.
    *
+   * If only one buffer pool has a visible renderer and it takes the frame in
+   * the stream's format, the game client can ask for the memory of a render
+   * buffer with GetFrameBuffer() and render into it, saving the copy.
+   *
    * When it is time to render the frame, the GUI control or window calls into
    * this class through the IRenderManager interface. RenderManager selects an
    * appropriate renderer to use to render the frame. The renderer is then
@@ -89,6 +93,18 @@ namespace RETRO
     bool Configure(AVPixelFormat format, unsigned int width, unsigned int height, unsigned int orientation);
     void AddFrame(const uint8_t* data, size_t size);
 
+    /*!
+     * \brief Get render buffer memory the next frame can be written to
+     *
+     * If the frame is then passed to AddFrame() in this memory, it is used
+     * without being copied. The memory stays valid until AddFrame() or Flush()
+     * is called.
+     *
+     * \return The memory for a frame of the given size, or nullptr if the
+     *         frame has to be copied anyway
+     */
+    uint8_t *GetFrameBuffer(size_t size);
+
     // Functions called from the player
     void SetSpeed(double speed);
 
@@ -169,6 +185,7 @@ namespace RETRO
     std::set<std::shared_ptr<CRPBaseRenderer>> m_renderers;
     std::shared_ptr<CGUIRenderTargetFactory> m_renderControlFactory;
     std::vector<IRenderBuffer*> m_renderBuffers;
+    IRenderBuffer *m_frameBuffer = nullptr; // Handed out by GetFrameBuffer()
     std::vector<uint8_t> m_cachedFrame;
     std::map<AVPixelFormat, SwsContext*> m_scalers;
     bool m_bHasCachedFrame = false;
@@ -109,6 +109,7 @@ unsigned int CAudioSinkAE::AddPackets(const DVDAudioFrame &audioframe)
     return 0;
 
   CAESyncInfo info = m_pAudioStream->GetSyncInfo();
+  m_resampleLoad = info.resampleLoad;
   if (info.state == CAESyncInfo::SYNC_INSYNC)
   {
     unsigned int newTime = info.errortime;
@@ -310,6 +311,11 @@ double CAudioSinkAE::GetResampleRatio()
   return m_resampleRatio;
 }
 
+double CAudioSinkAE::GetResampleLoad()
+{
+  return m_resampleLoad;
+}
+
 void CAudioSinkAE::SetResampleMode(int mode)
 {
   CSingleLock lock (m_critSection);
@@ -63,6 +63,11 @@ public:
    */
   double GetResampleRatio();
 
+  /*!
+   * \brief Returns time spent resampling per time of audio, 0.0 if not resampled
+   */
+  double GetResampleLoad();
+
   void SetResampleMode(int mode);
   void Flush();
   void Drain();
@@ -81,6 +86,7 @@ protected:
   double m_syncError;
   unsigned int m_syncErrorTime;
   double m_resampleRatio = 0.0; // invalid
+  double m_resampleLoad = 0.0;
   CCriticalSection m_critSection;
 
   AEDataFormat m_dataFormat;
@@ -29,6 +29,8 @@
 
 using namespace kodi::addon;
 
+#define ADDON_FRAME_ALIGN 64 // row alignment of frame buffers laid out by Kodi
+
 CAddonVideoCodec::CAddonVideoCodec(CProcessInfo &processInfo, ADDON::BinaryAddonBasePtr& addonInfo, kodi::addon::IAddonInstance* parentInstance)
   : CDVDVideoCodec(processInfo),
     IAddonInstanceHandler(ADDON_INSTANCE_VIDEOCODEC, addonInfo, parentInstance)
@@ -294,8 +296,58 @@ void CAddonVideoCodec::Reset()
     m_struct.toAddon.reset(&m_struct);
 }
 
+bool CAddonVideoCodec::LayoutFrameBuffer(VIDEOCODEC_PICTURE &picture)
+{
+  if (picture.width == 0 || picture.height == 0 ||
+      (picture.videoFormat != VIDEOCODEC_FORMAT::VideoFormatI420 &&
+       picture.videoFormat != VIDEOCODEC_FORMAT::VideoFormatYV12))
+    return false;
+
+  // rows aligned for SIMD and texture uploads, the size only depends on the
+  // resolution, so every frame of a stream is served by the same pool
+  uint32_t lumaStride = (picture.width + ADDON_FRAME_ALIGN - 1) & ~(ADDON_FRAME_ALIGN - 1);
+  uint32_t chromaStride = ((picture.width + 1) / 2 + ADDON_FRAME_ALIGN - 1) & ~(ADDON_FRAME_ALIGN - 1);
+  uint32_t lumaSize = lumaStride * picture.height;
+  uint32_t chromaSize = chromaStride * ((picture.height + 1) / 2);
+
+  picture.stride[VIDEOCODEC_PICTURE::YPlane] = lumaStride;
+  picture.stride[VIDEOCODEC_PICTURE::UPlane] = chromaStride;
+  picture.stride[VIDEOCODEC_PICTURE::VPlane] = chromaStride;
+  picture.planeOffsets[VIDEOCODEC_PICTURE::YPlane] = 0;
+  if (picture.videoFormat == VIDEOCODEC_FORMAT::VideoFormatYV12)
+  {
+    picture.planeOffsets[VIDEOCODEC_PICTURE::VPlane] = lumaSize;
+    picture.planeOffsets[VIDEOCODEC_PICTURE::UPlane] = lumaSize + chromaSize;
+  }
+  else
+  {
+    picture.planeOffsets[VIDEOCODEC_PICTURE::UPlane] = lumaSize;
+    picture.planeOffsets[VIDEOCODEC_PICTURE::VPlane] = lumaSize + chromaSize;
+  }
+  picture.decodedDataSize = lumaSize + 2 * chromaSize;
+  return true;
+}
+
 bool CAddonVideoCodec::GetFrameBuffer(VIDEOCODEC_PICTURE &picture)
 {
+  if (picture.decodedDataSize == 0 && !LayoutFrameBuffer(picture))
+  {
+    CLog::Log(LOGERROR, "CAddonVideoCodec::GetFrameBuffer no layout for format %d %ux%u", picture.videoFormat,
+              picture.width, picture.height);
+    return false;
+  }
+
+  if (picture.decodedDataSize != m_bufferSize)
+  {
+    // first picture or a resolution change, allocate the working set at once.
+    // on top of the render queue the decoder holds its reference frames
+    m_bufferSize = picture.decodedDataSize;
+    int queued, discard, free;
+    m_processInfo.GetRenderBuffers(queued, discard, free);
+    m_processInfo.GetVideoBufferManager().Preallocate(AV_PIX_FMT_YUV420P, static_cast<int>(m_bufferSize),
+                                                      queued + discard + free + 4);
+  }
+
   CVideoBuffer *videoBuffer = m_processInfo.GetVideoBufferManager().Get(AV_PIX_FMT_YUV420P, picture.decodedDataSize, nullptr);
   if (!videoBuffer)
   {
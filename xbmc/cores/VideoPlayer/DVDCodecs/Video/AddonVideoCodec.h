@@ -48,10 +48,13 @@ private:
   /*!
    * @brief All picture members can be expected to be set correctly except decodedData and pts.
    * GetFrameBuffer has to set decodedData to a valid memory adress and return true.
+   * If decodedDataSize is 0, the planes of videoFormat are laid out here and
+   * decodedDataSize, planeOffsets and stride are set as well.
    * In case buffer allocation fails, return false.
    */
   bool GetFrameBuffer(VIDEOCODEC_PICTURE &picture);
   void ReleaseFrameBuffer(void *buffer);
+  static bool LayoutFrameBuffer(VIDEOCODEC_PICTURE &picture);
 
   static bool get_frame_buffer(void* kodiInstance, VIDEOCODEC_PICTURE *picture);
   static void release_frame_buffer(void* kodiInstance, void *buffer);
@@ -61,4 +64,5 @@ private:
   VIDEOCODEC_FORMAT m_formats[VIDEOCODEC_FORMAT::MaxVideoFormats + 1];
   float m_displayAspect;
   unsigned int m_width, m_height;
+  size_t m_bufferSize = 0;
 };
@@ -819,14 +819,26 @@ bool CDVDVideoCodecAndroidMediaCodec::AddData(const DemuxPacket &packet)
       }
 
       // we have an input buffer, fill it.
+      size_t out_size;
+      uint8_t* dst_ptr = AMediaCodec_getInputBuffer(m_codec->codec(), m_indexInputBuffer, &out_size);
+
+      // annex b conversion writes into the input buffer directly if it fits
+      bool filled = false;
       if (pData && m_bitstream)
       {
-        m_bitstream->Convert(pData, iSize);
-        iSize = m_bitstream->GetConvertSize();
-        pData = m_bitstream->GetConvertBuffer();
+        int written = dst_ptr ? m_bitstream->ConvertTo(pData, iSize, dst_ptr, static_cast<int>(out_size)) : -1;
+        if (written >= 0)
+        {
+          iSize = written;
+          filled = true;
+        }
+        else
+        {
+          m_bitstream->Convert(pData, iSize);
+          iSize = m_bitstream->GetConvertSize();
+          pData = m_bitstream->GetConvertBuffer();
+        }
       }
-      size_t out_size;
-      uint8_t* dst_ptr = AMediaCodec_getInputBuffer(m_codec->codec(), m_indexInputBuffer, &out_size);
       if ((size_t)iSize > out_size)
       {
         CLog::Log(LOGERROR, "CDVDVideoCodecAndroidMediaCodec::Decode, iSize(%d) > size(%d)", iSize, out_size);
@@ -846,7 +858,7 @@ bool CDVDVideoCodecAndroidMediaCodec::AddData(const DemuxPacket &packet)
           AMEDIACODECRYPTOINFO_MODE_AES_CTR,
           &clearBytes[0], &cipherBytes[0]);
       }
-      if (dst_ptr)
+      if (dst_ptr && !filled)
       {
         // Codec specifics
         switch(m_hints.codec)
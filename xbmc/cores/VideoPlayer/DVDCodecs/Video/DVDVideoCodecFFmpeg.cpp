@@ -28,6 +28,7 @@
 #include "DVDCodecs/DVDFactoryCodec.h"
 #include "ServiceBroker.h"
 #include "utils/CPUInfo.h"
+#include "utils/TimeUtils.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "cores/VideoSettings.h"
@@ -344,6 +345,7 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg(CProcessInfo &processInfo)
   m_interlaced = false;
   m_eof = false;
   m_DAR = 1.0;
+  m_decodeTicks = 0;
 }
 
 CDVDVideoCodecFFmpeg::~CDVDVideoCodecFFmpeg()
@@ -401,12 +403,16 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     }
     else
     {
-      int num_threads = g_cpuInfo.getCPUCount() * 3 / 2;
-      num_threads = std::max(1, std::min(num_threads, 16));
-      m_pCodecContext->thread_count = num_threads;
+      VideoThreadingPolicy policy = m_processInfo.GetVideoThreadingPolicy(hints);
+      if (policy.sliceThreading && !(pCodec->capabilities & AV_CODEC_CAP_SLICE_THREADS))
+        policy.sliceThreading = false;
+
+      m_pCodecContext->thread_count = policy.threads;
+      m_pCodecContext->thread_type = policy.sliceThreading ? FF_THREAD_SLICE : FF_THREAD_FRAME;
       m_pCodecContext->thread_safe_callbacks = 1;
       m_decoderState = STATE_SW_MULTI;
-      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open frame threaded with %d threads", num_threads);
+      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open %s threaded with %d threads",
+                policy.sliceThreading ? "slice" : "frame", policy.threads);
     }
   }
   else
@@ -601,7 +607,9 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
   avpkt.side_data = static_cast<AVPacketSideData*>(packet.pSideData);
   avpkt.side_data_elems = packet.iSideDataElems;
 
+  int64_t start = CurrentHostCounter();
   int ret = avcodec_send_packet(m_pCodecContext, &avpkt);
+  m_decodeTicks += CurrentHostCounter() - start;
 
   // try again
   if (ret == AVERROR(EAGAIN))
@@ -672,6 +680,7 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
   }
 
   // process ffmpeg
+  int64_t start = CurrentHostCounter();
   if (m_codecControlFlags & DVD_CODEC_CTRL_DRAIN)
   {
     AVPacket avpkt;
@@ -684,6 +693,7 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
   }
 
   int ret = avcodec_receive_frame(m_pCodecContext, m_pDecodedFrame);
+  m_decodeTicks += CurrentHostCounter() - start;
 
   if (m_decoderState == STATE_HW_FAILED && !m_pHardware)
     return VC_REOPEN;
@@ -748,7 +758,10 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
     return VC_ERROR;
   }
 
-  // here we got a frame
+  // here we got a frame, time spent in ffmpeg since the previous one
+  m_processInfo.UpdateVideoDecodeTime(static_cast<double>(m_decodeTicks) * 1000 / CurrentHostFrequency());
+  m_decodeTicks = 0;
+
   int64_t framePTS = m_pDecodedFrame->best_effort_timestamp;
 
   if (m_pCodecContext->skip_frame > AVDISCARD_DEFAULT)
@@ -902,6 +915,7 @@ void CDVDVideoCodecFFmpeg::Reset()
   m_decoderPts = DVD_NOPTS_VALUE;
   m_skippedDeint = 0;
   m_droppedFrames = 0;
+  m_decodeTicks = 0;
   m_eof = false;
   m_iLastKeyframe = m_pCodecContext->has_b_frames;
   avcodec_flush_buffers(m_pCodecContext);
@@ -1287,6 +1301,12 @@ void CDVDVideoCodecFFmpeg::SetCodecControl(int flags)
     else
       m_requestSkipDeint = false;
 
+    // packets ahead of an accurate seek target are decoded for reference only,
+    // nothing of them is ever displayed so non-reference frames can be skipped
+    // entirely and the loop filter is not needed for them
+    if (flags & DVD_CODEC_CTRL_DROP)
+      bDrop = true;
+
     if (bDrop)
     {
       m_pCodecContext->skip_frame = AVDISCARD_NONREF;
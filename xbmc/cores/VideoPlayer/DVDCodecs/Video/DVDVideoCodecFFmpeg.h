@@ -105,6 +105,7 @@ protected:
   double m_decoderPts;
   int    m_skippedDeint;
   int    m_droppedFrames;
+  int64_t m_decodeTicks;
   bool   m_requestSkipDeint;
   int    m_codecControlFlags;
   bool m_interlaced;
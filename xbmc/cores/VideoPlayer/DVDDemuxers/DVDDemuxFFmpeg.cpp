@@ -26,6 +26,7 @@
 #include "commons/Exception.h"
 #include "cores/FFmpeg.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h" // for DVD_TIME_BASE
+#include "DemuxProbeCache.h"
 #include "DVDDemuxUtils.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #include "DVDInputStreams/DVDInputStreamFFmpeg.h"
@@ -465,8 +466,21 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
     if(m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
       av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
 
+    /* files probed before only need a short analysis, the stored result of
+     * the full one is applied afterwards */
+    CDemuxProbeCache probeCache;
+    bool probeCached = false;
+    if (m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE) && !m_pInput->IsRealtime() && !m_checkvideo)
+      probeCached = probeCache.Open(strFile, m_pInput->GetLength(), m_pFormatContext);
+    if (probeCached)
+      av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
+
     CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
     int iErr = avformat_find_stream_info(m_pFormatContext, NULL);
+    if (iErr >= 0 && probeCached)
+      probeCache.Restore(m_pFormatContext);
+    else if (iErr >= 0 && probeCache.IsOpen())
+      probeCache.Store(m_pFormatContext);
     if (iErr < 0)
     {
       CLog::Log(LOGWARNING,"could not find codec parameters for %s", CURL::GetRedacted(strFile).c_str());
@@ -569,6 +583,8 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
   m_dtsAtDisplayTime = DVD_NOPTS_VALUE;
   m_startTime = 0;
 
+  OpenSeekIndex();
+
   // seems to be a bug in ffmpeg, hls jumps back to start after a couple of seconds
   // this cures the issue
   if (m_pFormatContext->iformat && strcmp(m_pFormatContext->iformat->name, "hls,applehttp") == 0)
@@ -581,6 +597,8 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool streami
 
 void CDVDDemuxFFmpeg::Dispose()
 {
+  m_seekIndex.Close();
+
   m_pkt.result = -1;
   av_packet_unref(&m_pkt.pkt);
 
@@ -605,6 +623,7 @@ void CDVDDemuxFFmpeg::Dispose()
   m_speed = DVD_PLAYSPEED_NORMAL;
 
   DisposeStreams();
+  FreeRetiredStreams();
 
   m_pInput = NULL;
 }
@@ -942,6 +961,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
     else
     {
       ParsePacket(&m_pkt.pkt);
+      AddSeekIndexEntry(&m_pkt.pkt);
 
       if (IsProgramChange())
       {
@@ -1115,6 +1135,8 @@ bool CDVDDemuxFFmpeg::SeekTime(double time, bool backwards, double *startpts)
   if (!m_pInput)
     return false;
 
+  FreeRetiredStreams();
+
   if (time < 0)
   {
     time = 0;
@@ -1208,6 +1230,49 @@ bool CDVDDemuxFFmpeg::SeekTime(double time, bool backwards, double *startpts)
     return false;
 }
 
+void CDVDDemuxFFmpeg::OpenSeekIndex()
+{
+  // only files where the byte position of a keyframe packet is a valid
+  // point to resume reading, matroska indexes clusters on its own
+  if (!m_pFormatContext->pb || !m_pFormatContext->iformat ||
+      m_pInput->IsRealtime() || m_pInput->GetIPosTime() ||
+      !m_pInput->Seek(0, SEEK_POSSIBLE))
+    return;
+
+  if (strcmp(m_pFormatContext->iformat->name, "mpegts") != 0 &&
+      !(m_pFormatContext->iformat->flags & AVFMT_GENERIC_INDEX))
+    return;
+
+  // av_seek_frame uses the default stream for seeking
+  int idx = av_find_default_stream_index(m_pFormatContext);
+  if (idx < 0)
+    return;
+
+  AVStream* st = m_pFormatContext->streams[idx];
+  if (st->codecpar->codec_type != AVMEDIA_TYPE_VIDEO)
+    return;
+
+  if (!m_seekIndex.Open(m_pInput->GetFileName(), m_pInput->GetLength(), idx,
+                        st->time_base.num, st->time_base.den))
+    return;
+
+  for (const auto& entry : m_seekIndex.GetEntries())
+    av_add_index_entry(st, entry.second, entry.first, 0, 0, AVINDEX_KEYFRAME);
+}
+
+void CDVDDemuxFFmpeg::AddSeekIndexEntry(AVPacket* pkt)
+{
+  if (pkt->stream_index != m_seekIndex.GetStreamIdx() ||
+      !(pkt->flags & AV_PKT_FLAG_KEY) ||
+      pkt->dts == (int64_t)AV_NOPTS_VALUE)
+    return;
+
+  // ffmpeg doesn't index mpegts while reading, feed it what we have so
+  // seeks in this session benefit as well
+  if (m_seekIndex.Add(pkt->dts, pkt->pos))
+    av_add_index_entry(m_pFormatContext->streams[pkt->stream_index], pkt->pos, pkt->dts, 0, 0, AVINDEX_KEYFRAME);
+}
+
 bool CDVDDemuxFFmpeg::SeekByte(int64_t pos)
 {
   CSingleLock lock(m_critSection);
@@ -1410,11 +1475,18 @@ void CDVDDemuxFFmpeg::DisposeStreams()
 {
   std::map<int, CDemuxStream*>::iterator it;
   for(it = m_streams.begin(); it != m_streams.end(); ++it)
-    delete it->second;
+    m_retiredStreams.push_back(it->second);
   m_streams.clear();
   m_parsers.clear();
 }
 
+void CDVDDemuxFFmpeg::FreeRetiredStreams()
+{
+  for (auto stream : m_retiredStreams)
+    delete stream;
+  m_retiredStreams.clear();
+}
+
 CDemuxStream* CDVDDemuxFFmpeg::AddStream(int streamIdx)
 {
   AVStream* pStream = m_pFormatContext->streams[streamIdx];
@@ -1709,7 +1781,7 @@ void CDVDDemuxFFmpeg::AddStream(int streamIdx, CDemuxStream* stream)
   }
   else
   {
-    delete res.first->second;
+    m_retiredStreams.push_back(res.first->second);
     res.first->second = stream;
   }
   CLog::Log(LOGDEBUG, "CDVDDemuxFFmpeg::AddStream ID: %d", streamIdx);
@@ -21,6 +21,7 @@
  */
 
 #include "DVDDemux.h"
+#include "DemuxSeekIndex.h"
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
 #include <map>
@@ -128,12 +129,15 @@ protected:
   void AddStream(int streamIdx, CDemuxStream* stream);
   void CreateStreams(unsigned int program = UINT_MAX);
   void DisposeStreams();
+  void FreeRetiredStreams();
   void ParsePacket(AVPacket *pkt);
   bool IsVideoReady();
   void ResetVideoStreams();
   AVDictionary *GetFFMpegOptionsFromInput();
   double ConvertTimestamp(int64_t pts, int den, int num);
   void UpdateCurrentPTS();
+  void OpenSeekIndex();
+  void AddSeekIndexEntry(AVPacket* pkt);
   bool IsProgramChange();
   unsigned int HLSSelectProgram();
 
@@ -145,6 +149,9 @@ protected:
 
   CCriticalSection m_critSection;
   std::map<int, CDemuxStream*> m_streams;
+  // streams replaced while reading, the player may still refer to them
+  // until the next seek (see CDemuxReadAhead)
+  std::vector<CDemuxStream*> m_retiredStreams;
   std::map<int, std::unique_ptr<CDemuxParserFFmpeg>> m_parsers;
 
   AVIOContext* m_ioContext;
@@ -175,5 +182,6 @@ protected:
   double m_dtsAtDisplayTime;
   bool m_seekToKeyFrame = false;
   double m_startTime = 0;
+  CDemuxSeekIndex m_seekIndex;
 };
 
@@ -21,8 +21,13 @@
 #include "DVDDemuxUtils.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "cores/VideoPlayer/Interface/Addon/DemuxCrypto.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 
+#include <atomic>
+#include <vector>
+
 #ifdef TARGET_POSIX
 #include "platform/linux/XMemUtils.h"
 #endif
@@ -31,12 +36,133 @@ extern "C" {
 #include "libavcodec/avcodec.h"
 }
 
+namespace
+{
+
+/*!
+ * Recycles packet payload buffers, packets are allocated by the demuxer
+ * thread and released by the decoder threads at a high rate. Buffers are
+ * grouped in power of two size classes, each buffer carries its class in a
+ * small header in front of the payload. Packets larger than the biggest
+ * class bypass the pool.
+ */
+class CDemuxBufferPool
+{
+public:
+  ~CDemuxBufferPool()
+  {
+    for (auto& sizeClass : m_classes)
+    {
+      for (auto block : sizeClass.buffers)
+        _aligned_free(block);
+    }
+  }
+
+  uint8_t* Allocate(int size)
+  {
+    int sizeClass = GetSizeClass(size);
+    uint8_t* block = nullptr;
+
+    if (sizeClass != UNPOOLED)
+    {
+      FreeList& list = m_classes[sizeClass];
+      CSingleLock lock(list.section);
+      if (!list.buffers.empty())
+      {
+        block = list.buffers.back();
+        list.buffers.pop_back();
+        m_cached -= GetClassSize(sizeClass);
+      }
+    }
+
+    if (!block)
+    {
+      size_t capacity = sizeClass != UNPOOLED ? GetClassSize(sizeClass) : size;
+      block = static_cast<uint8_t*>(_aligned_malloc(HEADER_SIZE + capacity + AV_INPUT_BUFFER_PADDING_SIZE, 16));
+      if (!block)
+        return nullptr;
+
+      *reinterpret_cast<int*>(block) = sizeClass;
+    }
+
+    return block + HEADER_SIZE;
+  }
+
+  void Free(uint8_t* data)
+  {
+    uint8_t* block = data - HEADER_SIZE;
+    int sizeClass = *reinterpret_cast<int*>(block);
+
+    if (sizeClass != UNPOOLED)
+    {
+      size_t classSize = GetClassSize(sizeClass);
+      FreeList& list = m_classes[sizeClass];
+      CSingleLock lock(list.section);
+
+      // the memory limit is shared between classes and checked without a
+      // global lock, it may be exceeded by a few buffers
+      if (list.buffers.size() < MAX_BUFFERS_PER_CLASS && m_cached + classSize <= MAX_CACHED_BYTES)
+      {
+        list.buffers.push_back(block);
+        m_cached += classSize;
+        return;
+      }
+    }
+
+    _aligned_free(block);
+  }
+
+private:
+  // 1 KiB up to 4 MiB, keep the header a multiple of the alignment
+  static const int MIN_SHIFT = 10;
+  static const int MAX_SHIFT = 22;
+  static const int NUM_CLASSES = MAX_SHIFT - MIN_SHIFT + 1;
+  static const int UNPOOLED = -1;
+  static const size_t HEADER_SIZE = 16;
+  static const size_t MAX_BUFFERS_PER_CLASS = 256;
+  static const size_t MAX_CACHED_BYTES = 32 * 1024 * 1024;
+
+  static int GetSizeClass(int size)
+  {
+    if (size > (1 << MAX_SHIFT))
+      return UNPOOLED;
+
+    int shift = MIN_SHIFT;
+    while ((1 << shift) < size)
+      shift++;
+
+    return shift - MIN_SHIFT;
+  }
+
+  static size_t GetClassSize(int sizeClass)
+  {
+    return static_cast<size_t>(1) << (sizeClass + MIN_SHIFT);
+  }
+
+  struct FreeList
+  {
+    CCriticalSection section;
+    std::vector<uint8_t*> buffers;
+  };
+
+  FreeList m_classes[NUM_CLASSES];
+  std::atomic<size_t> m_cached{0};
+};
+
+CDemuxBufferPool& GetBufferPool()
+{
+  static CDemuxBufferPool pool;
+  return pool;
+}
+
+}
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
     if (pPacket->pData)
-      _aligned_free(pPacket->pData);
+      GetBufferPool().Free(pPacket->pData);
     if (pPacket->iSideDataElems)
     {
       AVPacket avPkt;
@@ -64,7 +190,7 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
      * Note, if the first 23 bits of the additional bytes are not 0 then damaged
      * MPEG bitstreams could cause overread and segfault
      */
-    pPacket->pData =(uint8_t*)_aligned_malloc(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, 16);
+    pPacket->pData = GetBufferPool().Allocate(iDataSize);
     if (!pPacket->pData)
     {
       FreeDemuxPacket(pPacket);
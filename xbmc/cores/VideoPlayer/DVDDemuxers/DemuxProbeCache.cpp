@@ -0,0 +1,293 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DemuxProbeCache.h"
+
+#include <string.h>
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+extern "C" {
+#include "libavformat/avformat.h"
+}
+
+using namespace XFILE;
+
+namespace
+{
+const char* PROBECACHE_PATH = "special://temp/probecache/";
+const uint32_t PROBECACHE_VERSION = 1;
+const uint32_t MAX_STREAMS = 256;
+const uint32_t MAX_EXTRADATA = 1 << 20;
+
+struct ProbeCacheHeader
+{
+  char magic[4];
+  uint32_t version;
+  int64_t fileLength;
+  int64_t fileTime;
+  int64_t duration;
+  int64_t startTime;
+  int64_t bitRate;
+  uint32_t layoutCount;
+  uint32_t streamCount;
+};
+
+std::vector<int32_t> GetLayout(const AVFormatContext* context)
+{
+  std::vector<int32_t> layout;
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    layout.push_back(context->streams[i]->codecpar->codec_type);
+    layout.push_back(context->streams[i]->codecpar->codec_id);
+  }
+  return layout;
+}
+}
+
+bool CDemuxProbeCache::Open(const std::string& fileName, int64_t fileLength, const AVFormatContext* context)
+{
+  m_cacheFile.clear();
+  m_streams.clear();
+  m_extradata.clear();
+
+  // files without a header get their streams created while probing
+  if (fileName.empty() || fileLength <= 0 || !context || context->nb_streams == 0 ||
+      context->nb_streams > MAX_STREAMS || (context->ctx_flags & AVFMTCTX_NOHEADER))
+    return false;
+
+  // a replaced file mostly keeps its name, the time tells them apart
+  struct __stat64 st;
+  if (CFile::Stat(fileName, &st) != 0 || st.st_mtime == 0)
+    return false;
+
+  m_cacheFile = StringUtils::Format("%s%08x.probe", PROBECACHE_PATH, Crc32::ComputeFromLowerCase(fileName));
+  m_fileLength = fileLength;
+  m_fileTime = st.st_mtime;
+  m_layout = GetLayout(context);
+
+  return Load();
+}
+
+void CDemuxProbeCache::Restore(AVFormatContext* context) const
+{
+  if (m_streams.size() != context->nb_streams)
+    return;
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const StreamInfo& info = m_streams[i];
+    AVStream* st = context->streams[i];
+    AVCodecParameters* par = st->codecpar;
+
+    par->codec_type = static_cast<AVMediaType>(info.codecType);
+    par->codec_id = static_cast<AVCodecID>(info.codecId);
+    par->codec_tag = info.codecTag;
+    par->format = info.format;
+    par->bit_rate = info.bitRate;
+    par->bits_per_coded_sample = info.bitsPerCodedSample;
+    par->bits_per_raw_sample = info.bitsPerRawSample;
+    par->profile = info.profile;
+    par->level = info.level;
+    par->width = info.width;
+    par->height = info.height;
+    par->sample_aspect_ratio = av_make_q(info.sarNum, info.sarDen);
+    par->field_order = static_cast<AVFieldOrder>(info.fieldOrder);
+    par->color_range = static_cast<AVColorRange>(info.colorRange);
+    par->color_primaries = static_cast<AVColorPrimaries>(info.colorPrimaries);
+    par->color_trc = static_cast<AVColorTransferCharacteristic>(info.colorTrc);
+    par->color_space = static_cast<AVColorSpace>(info.colorSpace);
+    par->chroma_location = static_cast<AVChromaLocation>(info.chromaLocation);
+    par->video_delay = info.videoDelay;
+    par->channel_layout = info.channelLayout;
+    par->channels = info.channels;
+    par->sample_rate = info.sampleRate;
+    par->block_align = info.blockAlign;
+    par->frame_size = info.frameSize;
+    par->initial_padding = info.initialPadding;
+    par->trailing_padding = info.trailingPadding;
+    par->seek_preroll = info.seekPreroll;
+
+    // extradata found by parsing packets is not in the header
+    const std::vector<uint8_t>& extradata = m_extradata[i];
+    if (!extradata.empty() && par->extradata_size == 0)
+    {
+      par->extradata = static_cast<uint8_t*>(av_mallocz(extradata.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+      if (par->extradata)
+      {
+        memcpy(par->extradata, extradata.data(), extradata.size());
+        par->extradata_size = static_cast<int>(extradata.size());
+      }
+    }
+
+    st->r_frame_rate = av_make_q(info.rFrameRateNum, info.rFrameRateDen);
+    st->avg_frame_rate = av_make_q(info.avgFrameRateNum, info.avgFrameRateDen);
+    st->duration = info.duration;
+    st->start_time = info.startTime;
+    if (st->codec_info_nb_frames < info.codecInfoFrames)
+      st->codec_info_nb_frames = info.codecInfoFrames;
+  }
+
+  context->duration = m_duration;
+  context->start_time = m_startTime;
+  context->bit_rate = m_bitRate;
+}
+
+bool CDemuxProbeCache::Load()
+{
+  CFile file;
+  if (!file.Open(m_cacheFile))
+    return false;
+
+  ProbeCacheHeader header;
+  if (file.Read(&header, sizeof(header)) != sizeof(header) ||
+      memcmp(header.magic, "KPRC", 4) != 0 ||
+      header.version != PROBECACHE_VERSION ||
+      header.streamCount > MAX_STREAMS)
+    return false;
+
+  if (header.fileLength != m_fileLength ||
+      header.fileTime != m_fileTime ||
+      header.layoutCount != m_layout.size() ||
+      header.streamCount * 2 != m_layout.size())
+  {
+    CLog::Log(LOGDEBUG, "CDemuxProbeCache::Load - discarding outdated result %s", m_cacheFile.c_str());
+    return false;
+  }
+
+  std::vector<int32_t> layout(header.layoutCount);
+  if (file.Read(layout.data(), layout.size() * sizeof(int32_t)) != static_cast<ssize_t>(layout.size() * sizeof(int32_t)) ||
+      layout != m_layout)
+    return false;
+
+  std::vector<StreamInfo> streams(header.streamCount);
+  std::vector<std::vector<uint8_t>> extradata(header.streamCount);
+  for (uint32_t i = 0; i < header.streamCount; i++)
+  {
+    if (file.Read(&streams[i], sizeof(StreamInfo)) != sizeof(StreamInfo) ||
+        streams[i].extradataSize > MAX_EXTRADATA)
+      return false;
+
+    extradata[i].resize(streams[i].extradataSize);
+    if (!extradata[i].empty() &&
+        file.Read(extradata[i].data(), extradata[i].size()) != static_cast<ssize_t>(extradata[i].size()))
+      return false;
+  }
+
+  m_duration = header.duration;
+  m_startTime = header.startTime;
+  m_bitRate = header.bitRate;
+  m_streams.swap(streams);
+  m_extradata.swap(extradata);
+  CLog::Log(LOGDEBUG, "CDemuxProbeCache::Load - loaded %u streams from %s", header.streamCount, m_cacheFile.c_str());
+  return true;
+}
+
+void CDemuxProbeCache::Store(const AVFormatContext* context)
+{
+  // streams added while probing would no longer match the header layout
+  if (!IsOpen() || context->nb_streams * 2 != m_layout.size())
+    return;
+
+  if (!CDirectory::Exists(PROBECACHE_PATH) && !CDirectory::Create(PROBECACHE_PATH))
+    return;
+
+  CFile file;
+  if (!file.OpenForWrite(m_cacheFile, true))
+  {
+    CLog::Log(LOGWARNING, "CDemuxProbeCache::Store - unable to write %s", m_cacheFile.c_str());
+    return;
+  }
+
+  ProbeCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "KPRC", 4);
+  header.version = PROBECACHE_VERSION;
+  header.fileLength = m_fileLength;
+  header.fileTime = m_fileTime;
+  header.duration = context->duration;
+  header.startTime = context->start_time;
+  header.bitRate = context->bit_rate;
+  header.layoutCount = static_cast<uint32_t>(m_layout.size());
+  header.streamCount = context->nb_streams;
+
+  bool success = file.Write(&header, sizeof(header)) == sizeof(header) &&
+                 file.Write(m_layout.data(), m_layout.size() * sizeof(int32_t)) == static_cast<ssize_t>(m_layout.size() * sizeof(int32_t));
+
+  for (unsigned int i = 0; success && i < context->nb_streams; i++)
+  {
+    const AVStream* st = context->streams[i];
+    const AVCodecParameters* par = st->codecpar;
+
+    StreamInfo info;
+    memset(&info, 0, sizeof(info));
+    info.codecType = par->codec_type;
+    info.codecId = par->codec_id;
+    info.codecTag = par->codec_tag;
+    info.format = par->format;
+    info.bitRate = par->bit_rate;
+    info.bitsPerCodedSample = par->bits_per_coded_sample;
+    info.bitsPerRawSample = par->bits_per_raw_sample;
+    info.profile = par->profile;
+    info.level = par->level;
+    info.width = par->width;
+    info.height = par->height;
+    info.sarNum = par->sample_aspect_ratio.num;
+    info.sarDen = par->sample_aspect_ratio.den;
+    info.fieldOrder = par->field_order;
+    info.colorRange = par->color_range;
+    info.colorPrimaries = par->color_primaries;
+    info.colorTrc = par->color_trc;
+    info.colorSpace = par->color_space;
+    info.chromaLocation = par->chroma_location;
+    info.videoDelay = par->video_delay;
+    info.channelLayout = par->channel_layout;
+    info.channels = par->channels;
+    info.sampleRate = par->sample_rate;
+    info.blockAlign = par->block_align;
+    info.frameSize = par->frame_size;
+    info.initialPadding = par->initial_padding;
+    info.trailingPadding = par->trailing_padding;
+    info.seekPreroll = par->seek_preroll;
+    info.rFrameRateNum = st->r_frame_rate.num;
+    info.rFrameRateDen = st->r_frame_rate.den;
+    info.avgFrameRateNum = st->avg_frame_rate.num;
+    info.avgFrameRateDen = st->avg_frame_rate.den;
+    info.codecInfoFrames = st->codec_info_nb_frames;
+    info.duration = st->duration;
+    info.startTime = st->start_time;
+    if (par->extradata && par->extradata_size > 0 && static_cast<uint32_t>(par->extradata_size) <= MAX_EXTRADATA)
+      info.extradataSize = par->extradata_size;
+
+    success = file.Write(&info, sizeof(info)) == sizeof(info) &&
+              (info.extradataSize == 0 ||
+               file.Write(par->extradata, info.extradataSize) == static_cast<ssize_t>(info.extradataSize));
+  }
+
+  if (!success)
+  {
+    file.Close();
+    CFile::Delete(m_cacheFile);
+  }
+}
@@ -0,0 +1,110 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct AVFormatContext;
+
+/*!
+ * Result of avformat_find_stream_info for a file, persisted under
+ * special://temp/probecache/ so a file opened again only needs a short
+ * analysis. Stored results are bound to the size and modification time of
+ * the file and to the stream layout found in its header.
+ */
+class CDemuxProbeCache
+{
+public:
+  /*!
+   * Identifies the file and loads a stored result. Must be called after
+   * avformat_open_input and before the probe.
+   * \return true if a stored result matches the file and its header
+   */
+  bool Open(const std::string& fileName, int64_t fileLength, const AVFormatContext* context);
+
+  /*!
+   * Applies the stored result to the streams of a context probed shortly.
+   */
+  void Restore(AVFormatContext* context) const;
+
+  /*!
+   * Stores the result of a full probe.
+   */
+  void Store(const AVFormatContext* context);
+
+  bool IsOpen() const { return !m_cacheFile.empty(); }
+
+private:
+  // written to the cache file as is
+  struct StreamInfo
+  {
+    int32_t codecType;
+    int32_t codecId;
+    uint32_t codecTag;
+    int32_t format;
+    int64_t bitRate;
+    int32_t bitsPerCodedSample;
+    int32_t bitsPerRawSample;
+    int32_t profile;
+    int32_t level;
+    int32_t width;
+    int32_t height;
+    int32_t sarNum;
+    int32_t sarDen;
+    int32_t fieldOrder;
+    int32_t colorRange;
+    int32_t colorPrimaries;
+    int32_t colorTrc;
+    int32_t colorSpace;
+    int32_t chromaLocation;
+    int32_t videoDelay;
+    uint64_t channelLayout;
+    int32_t channels;
+    int32_t sampleRate;
+    int32_t blockAlign;
+    int32_t frameSize;
+    int32_t initialPadding;
+    int32_t trailingPadding;
+    int32_t seekPreroll;
+    int32_t rFrameRateNum;
+    int32_t rFrameRateDen;
+    int32_t avgFrameRateNum;
+    int32_t avgFrameRateDen;
+    int32_t codecInfoFrames;
+    int64_t duration;
+    int64_t startTime;
+    uint32_t extradataSize;
+  };
+
+  bool Load();
+
+  std::string m_cacheFile;
+  int64_t m_fileLength = 0;
+  int64_t m_fileTime = 0;
+  std::vector<int32_t> m_layout; //!< codec type and id per stream as read from the header
+  int64_t m_duration = 0;
+  int64_t m_startTime = 0;
+  int64_t m_bitRate = 0;
+  std::vector<StreamInfo> m_streams;
+  std::vector<std::vector<uint8_t>> m_extradata;
+};
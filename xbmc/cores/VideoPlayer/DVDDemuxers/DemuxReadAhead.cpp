@@ -0,0 +1,463 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DemuxReadAhead.h"
+#include "DVDDemuxUtils.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+namespace
+{
+// hard limits of the buffer, independent of the buffer time
+const size_t MAX_BUFFER_BYTES = 64 * 1024 * 1024;
+const size_t MAX_BUFFER_PACKETS = 20000;
+// without timestamps fill up to this amount of data
+const size_t DEFAULT_BUFFER_BYTES = 8 * 1024 * 1024;
+// the buffer time grows on underruns, up to this factor
+const double MAX_BUFFER_TIME_FACTOR = 4.0;
+// how long Read() waits for the reader before returning an empty packet
+const unsigned int READ_TIMEOUT_MS = 50;
+
+double GetPacketTime(const DemuxPacket* packet)
+{
+  if (packet->dts != DVD_NOPTS_VALUE)
+    return packet->dts;
+  return packet->pts;
+}
+}
+
+CDemuxReadAhead::CDemuxerLock::CDemuxerLock(CDemuxReadAhead& owner) : m_owner(owner)
+{
+  // signal the reader to step back before competing for the lock
+  m_owner.m_demuxerRequests++;
+  m_owner.m_demuxSection.lock();
+}
+
+CDemuxReadAhead::CDemuxerLock::~CDemuxerLock()
+{
+  m_owner.m_demuxSection.unlock();
+  m_owner.m_demuxerRequests--;
+  m_owner.m_readerEvent.Set();
+}
+
+CDemuxReadAhead::CDemuxReadAhead(CDVDDemux* demuxer, double bufferTime)
+  : CThread("DemuxReadAhead")
+  , m_demuxer(demuxer)
+  , m_bufferStart(DVD_NOPTS_VALUE)
+  , m_bufferEnd(DVD_NOPTS_VALUE)
+  , m_baseTime(bufferTime)
+  , m_targetTime(bufferTime)
+{
+  // packets and streams are reported with the id of the wrapped demuxer
+  m_demuxerId = m_demuxer->GetDemuxerId();
+
+  UpdateSnapshot();
+
+  CLog::Log(LOGDEBUG, "CDemuxReadAhead - buffering %.1f seconds of %s", bufferTime, m_fileName.c_str());
+
+  Create();
+}
+
+CDemuxReadAhead::~CDemuxReadAhead()
+{
+  StopThread(false);
+  m_readerEvent.Set();
+  m_demuxer->Abort();
+  StopThread();
+
+  ClearBuffer();
+}
+
+bool CDemuxReadAhead::IsBufferFull() const
+{
+  if (m_buffer.size() >= MAX_BUFFER_PACKETS || m_bufferBytes >= MAX_BUFFER_BYTES)
+    return true;
+
+  if (m_bufferStart != DVD_NOPTS_VALUE && m_bufferEnd > m_bufferStart)
+    return m_bufferEnd - m_bufferStart >= m_targetTime * DVD_TIME_BASE;
+
+  return m_bufferBytes >= DEFAULT_BUFFER_BYTES;
+}
+
+void CDemuxReadAhead::ClearBuffer()
+{
+  CSingleLock lock(m_bufferSection);
+
+  for (auto& entry : m_buffer)
+    CDVDDemuxUtils::FreeDemuxPacket(entry.packet);
+
+  m_buffer.clear();
+  m_bufferBytes = 0;
+  m_bufferStart = DVD_NOPTS_VALUE;
+  m_bufferEnd = DVD_NOPTS_VALUE;
+  m_eof = false;
+  m_filled = false;
+}
+
+void CDemuxReadAhead::UpdateSnapshot()
+{
+  // m_demuxSection must be held or the reader not running
+  std::vector<ProgramInfo> programs;
+  m_demuxer->GetPrograms(programs);
+
+  std::vector<std::string> chapterNames;
+  std::vector<int64_t> chapterPos;
+  for (int i = 1; i <= m_demuxer->GetChapterCount(); i++)
+  {
+    std::string name;
+    m_demuxer->GetChapterName(name, i);
+    chapterNames.push_back(name);
+    chapterPos.push_back(m_demuxer->GetChapterPos(i));
+  }
+
+  m_streamLength = m_demuxer->GetStreamLength();
+  m_chapter = m_demuxer->GetChapter();
+
+  CSingleLock lock(m_viewSection);
+  SetView(m_demuxer->GetStreams());
+  m_programs = programs;
+  m_chapterNames = chapterNames;
+  m_chapterPos = chapterPos;
+  m_fileName = m_demuxer->GetFileName();
+}
+
+void CDemuxReadAhead::SetView(const std::vector<CDemuxStream*>& streams)
+{
+  m_view.clear();
+  for (auto stream : streams)
+  {
+    if (stream)
+      m_view[stream->uniqueId] = stream;
+  }
+}
+
+void CDemuxReadAhead::Process()
+{
+  while (!m_bStop)
+  {
+    bool wait = m_demuxerRequests > 0;
+    if (!wait)
+    {
+      CSingleLock lock(m_bufferSection);
+      if (IsBufferFull())
+      {
+        m_filled = true;
+        wait = true;
+      }
+      wait = wait || m_eof;
+    }
+
+    if (wait)
+    {
+      m_readerEvent.WaitMSec(100);
+      continue;
+    }
+
+    CSingleLock lock(m_demuxSection);
+
+    if (m_bStop || m_demuxerRequests > 0)
+      continue;
+
+    BufferedPacket entry;
+    entry.packet = m_demuxer->Read();
+    entry.stream = nullptr;
+
+    if (entry.packet)
+    {
+      if (entry.packet->iStreamId == DMX_SPECIALID_STREAMCHANGE)
+      {
+        entry.streams = m_demuxer->GetStreams();
+        m_demuxer->GetPrograms(entry.programs);
+      }
+      else if (entry.packet->iStreamId >= 0)
+        entry.stream = m_demuxer->GetStream(entry.packet->demuxerId, entry.packet->iStreamId);
+      else
+      {
+        // empty packet, only meant to keep the player loop going
+        CDVDDemuxUtils::FreeDemuxPacket(entry.packet);
+        continue;
+      }
+    }
+
+    m_streamLength = m_demuxer->GetStreamLength();
+    m_chapter = m_demuxer->GetChapter();
+
+    // publish while still holding the demuxer, so a seek can't slip in
+    // between and leave stale packets behind
+    {
+      CSingleLock bufferLock(m_bufferSection);
+
+      if (!entry.packet)
+        m_eof = true;
+      else
+      {
+        double time = GetPacketTime(entry.packet);
+        if (time != DVD_NOPTS_VALUE)
+        {
+          if (m_bufferStart == DVD_NOPTS_VALUE)
+            m_bufferStart = time;
+          if (m_bufferEnd == DVD_NOPTS_VALUE || time > m_bufferEnd)
+            m_bufferEnd = time;
+        }
+        m_bufferBytes += entry.packet->iSize;
+        m_buffer.push_back(std::move(entry));
+      }
+    }
+
+    m_packetEvent.Set();
+  }
+}
+
+DemuxPacket* CDemuxReadAhead::Read()
+{
+  CSingleLock lock(m_bufferSection);
+
+  if (m_buffer.empty() && !m_eof)
+  {
+    // ran dry after having been filled, read further ahead from now on
+    if (m_filled)
+    {
+      m_filled = false;
+      double targetTime = std::min(m_targetTime * 1.5, m_baseTime * MAX_BUFFER_TIME_FACTOR);
+      if (targetTime > m_targetTime)
+      {
+        CLog::Log(LOGDEBUG, "CDemuxReadAhead - underrun, buffering %.1f seconds", targetTime);
+        m_targetTime = targetTime;
+      }
+    }
+
+    lock.Leave();
+    m_packetEvent.WaitMSec(READ_TIMEOUT_MS);
+    lock.Enter();
+  }
+
+  if (m_buffer.empty())
+  {
+    if (m_eof)
+    {
+      // report the end once, then let the reader try again
+      m_eof = false;
+      m_readerEvent.Set();
+      return nullptr;
+    }
+
+    // keep the player responsive while the source is stalling
+    return CDVDDemuxUtils::AllocateDemuxPacket(0);
+  }
+
+  BufferedPacket entry = std::move(m_buffer.front());
+  m_buffer.pop_front();
+
+  m_bufferBytes -= entry.packet->iSize;
+  m_bufferStart = DVD_NOPTS_VALUE;
+  for (const auto& next : m_buffer)
+  {
+    double time = GetPacketTime(next.packet);
+    if (time != DVD_NOPTS_VALUE)
+    {
+      m_bufferStart = time;
+      break;
+    }
+  }
+  if (m_bufferStart == DVD_NOPTS_VALUE)
+    m_bufferEnd = DVD_NOPTS_VALUE;
+
+  lock.Leave();
+  m_readerEvent.Set();
+
+  // make the stream info matching this packet visible to the player
+  CSingleLock viewLock(m_viewSection);
+  if (entry.packet->iStreamId == DMX_SPECIALID_STREAMCHANGE)
+  {
+    SetView(entry.streams);
+    m_programs = entry.programs;
+  }
+  else if (entry.stream)
+    m_view[entry.stream->uniqueId] = entry.stream;
+
+  return entry.packet;
+}
+
+bool CDemuxReadAhead::Reset()
+{
+  CDemuxerLock lock(*this);
+  ClearBuffer();
+  bool ret = m_demuxer->Reset();
+  UpdateSnapshot();
+  return ret;
+}
+
+void CDemuxReadAhead::Abort()
+{
+  // may be called from any thread, same for the wrapped demuxer
+  m_demuxer->Abort();
+}
+
+void CDemuxReadAhead::Flush()
+{
+  CDemuxerLock lock(*this);
+  ClearBuffer();
+  m_demuxer->Flush();
+}
+
+bool CDemuxReadAhead::SeekTime(double time, bool backwards, double* startpts)
+{
+  CDemuxerLock lock(*this);
+  ClearBuffer();
+  bool ret = m_demuxer->SeekTime(time, backwards, startpts);
+  UpdateSnapshot();
+  return ret;
+}
+
+bool CDemuxReadAhead::SeekChapter(int chapter, double* startpts)
+{
+  CDemuxerLock lock(*this);
+  ClearBuffer();
+  bool ret = m_demuxer->SeekChapter(chapter, startpts);
+  UpdateSnapshot();
+  return ret;
+}
+
+int CDemuxReadAhead::GetChapterCount()
+{
+  CSingleLock lock(m_viewSection);
+  return static_cast<int>(m_chapterNames.size());
+}
+
+int CDemuxReadAhead::GetChapter()
+{
+  return m_chapter;
+}
+
+void CDemuxReadAhead::GetChapterName(std::string& strChapterName, int chapterIdx)
+{
+  CSingleLock lock(m_viewSection);
+
+  if (chapterIdx <= 0 || chapterIdx > static_cast<int>(m_chapterNames.size()))
+    chapterIdx = m_chapter;
+  if (chapterIdx <= 0 || chapterIdx > static_cast<int>(m_chapterNames.size()))
+    return;
+
+  strChapterName = m_chapterNames[chapterIdx - 1];
+}
+
+int64_t CDemuxReadAhead::GetChapterPos(int chapterIdx)
+{
+  CSingleLock lock(m_viewSection);
+
+  if (chapterIdx <= 0 || chapterIdx > static_cast<int>(m_chapterPos.size()))
+    chapterIdx = m_chapter;
+  if (chapterIdx <= 0 || chapterIdx > static_cast<int>(m_chapterPos.size()))
+    return 0;
+
+  return m_chapterPos[chapterIdx - 1];
+}
+
+void CDemuxReadAhead::SetSpeed(int iSpeed)
+{
+  CDemuxerLock lock(*this);
+  m_demuxer->SetSpeed(iSpeed);
+}
+
+int CDemuxReadAhead::GetStreamLength()
+{
+  return m_streamLength;
+}
+
+CDemuxStream* CDemuxReadAhead::GetStream(int64_t demuxerId, int iStreamId) const
+{
+  return GetStream(iStreamId);
+}
+
+CDemuxStream* CDemuxReadAhead::GetStream(int iStreamId) const
+{
+  CSingleLock lock(m_viewSection);
+
+  auto it = m_view.find(iStreamId);
+  if (it == m_view.end())
+    return nullptr;
+
+  return it->second;
+}
+
+std::vector<CDemuxStream*> CDemuxReadAhead::GetStreams() const
+{
+  CSingleLock lock(m_viewSection);
+
+  std::vector<CDemuxStream*> streams;
+  for (const auto& it : m_view)
+    streams.push_back(it.second);
+
+  return streams;
+}
+
+int CDemuxReadAhead::GetNrOfStreams() const
+{
+  CSingleLock lock(m_viewSection);
+  return static_cast<int>(m_view.size());
+}
+
+int CDemuxReadAhead::GetPrograms(std::vector<ProgramInfo>& programs)
+{
+  CSingleLock lock(m_viewSection);
+  programs = m_programs;
+  return static_cast<int>(programs.size());
+}
+
+void CDemuxReadAhead::SetProgram(int progId)
+{
+  CDemuxerLock lock(*this);
+  ClearBuffer();
+  m_demuxer->SetProgram(progId);
+  UpdateSnapshot();
+}
+
+std::string CDemuxReadAhead::GetFileName()
+{
+  CSingleLock lock(m_viewSection);
+  return m_fileName;
+}
+
+std::string CDemuxReadAhead::GetStreamCodecName(int64_t demuxerId, int iStreamId)
+{
+  CDemuxerLock lock(*this);
+  return m_demuxer->GetStreamCodecName(demuxerId, iStreamId);
+}
+
+void CDemuxReadAhead::EnableStream(int64_t demuxerId, int id, bool enable)
+{
+  CDemuxerLock lock(*this);
+  m_demuxer->EnableStream(demuxerId, id, enable);
+}
+
+void CDemuxReadAhead::OpenStream(int64_t demuxerId, int id)
+{
+  CDemuxerLock lock(*this);
+  m_demuxer->OpenStream(demuxerId, id);
+}
+
+void CDemuxReadAhead::SetVideoResolution(int width, int height)
+{
+  CDemuxerLock lock(*this);
+  m_demuxer->SetVideoResolution(width, height);
+}
@@ -0,0 +1,138 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "DVDDemux.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+ * Runs Read() of another demuxer on a dedicated thread and keeps a time
+ * based buffer of demuxed packets, so a stalling read on a remote source
+ * doesn't block packet dispatch in the player.
+ *
+ * The wrapped demuxer is only ever accessed with m_demuxSection held.
+ * Stream information handed out to the player is taken in packet order:
+ * the stream pointer resolved when a packet was read becomes visible when
+ * that packet is returned by Read(). This requires the wrapped demuxer to
+ * keep replaced stream objects alive until it is closed.
+ */
+class CDemuxReadAhead : public CDVDDemux, private CThread
+{
+public:
+  /*!
+   * \param demuxer demuxer to read from, ownership is taken
+   * \param bufferTime initial amount of data to buffer in seconds
+   */
+  CDemuxReadAhead(CDVDDemux* demuxer, double bufferTime);
+  ~CDemuxReadAhead() override;
+
+  // implementation of CDVDDemux
+  bool Reset() override;
+  void Abort() override;
+  void Flush() override;
+  DemuxPacket* Read() override;
+  bool SeekTime(double time, bool backwards = false, double* startpts = NULL) override;
+  bool SeekChapter(int chapter, double* startpts = NULL) override;
+  int GetChapterCount() override;
+  int GetChapter() override;
+  void GetChapterName(std::string& strChapterName, int chapterIdx = -1) override;
+  int64_t GetChapterPos(int chapterIdx = -1) override;
+  void SetSpeed(int iSpeed) override;
+  int GetStreamLength() override;
+  CDemuxStream* GetStream(int64_t demuxerId, int iStreamId) const override;
+  std::vector<CDemuxStream*> GetStreams() const override;
+  int GetNrOfStreams() const override;
+  int GetPrograms(std::vector<ProgramInfo>& programs) override;
+  void SetProgram(int progId) override;
+  std::string GetFileName() override;
+  std::string GetStreamCodecName(int64_t demuxerId, int iStreamId) override;
+  void EnableStream(int64_t demuxerId, int id, bool enable) override;
+  void OpenStream(int64_t demuxerId, int id) override;
+  void SetVideoResolution(int width, int height) override;
+
+protected:
+  CDemuxStream* GetStream(int iStreamId) const override;
+
+  // implementation of CThread
+  void Process() override;
+
+private:
+  struct BufferedPacket
+  {
+    DemuxPacket* packet;
+    CDemuxStream* stream;
+    std::vector<CDemuxStream*> streams; //!< full stream set, only for stream changes
+    std::vector<ProgramInfo> programs;
+  };
+
+  /*!
+   * Stops the reader and gives exclusive access to the wrapped demuxer
+   */
+  class CDemuxerLock
+  {
+  public:
+    explicit CDemuxerLock(CDemuxReadAhead& owner);
+    ~CDemuxerLock();
+  private:
+    CDemuxReadAhead& m_owner;
+  };
+
+  bool IsBufferFull() const;
+  void ClearBuffer();
+  void UpdateSnapshot();
+  void SetView(const std::vector<CDemuxStream*>& streams);
+
+  std::unique_ptr<CDVDDemux> m_demuxer;
+  CCriticalSection m_demuxSection;
+  std::atomic<int> m_demuxerRequests{0};
+
+  // buffer between reader and player
+  mutable CCriticalSection m_bufferSection;
+  CEvent m_readerEvent;
+  CEvent m_packetEvent;
+  std::deque<BufferedPacket> m_buffer;
+  size_t m_bufferBytes = 0;
+  double m_bufferStart;
+  double m_bufferEnd;
+  bool m_eof = false;
+  bool m_filled = false;
+  double m_baseTime;
+  double m_targetTime;
+
+  // stream information as seen by the player
+  mutable CCriticalSection m_viewSection;
+  std::map<int, CDemuxStream*> m_view;
+  std::vector<ProgramInfo> m_programs;
+  std::vector<std::string> m_chapterNames;
+  std::vector<int64_t> m_chapterPos;
+  std::string m_fileName;
+  std::atomic<int> m_streamLength{0};
+  std::atomic<int> m_chapter{0};
+};
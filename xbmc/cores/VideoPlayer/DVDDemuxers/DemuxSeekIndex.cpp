@@ -0,0 +1,184 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DemuxSeekIndex.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+using namespace XFILE;
+
+namespace
+{
+const char* SEEKINDEX_PATH = "special://temp/seekindex/";
+const uint32_t SEEKINDEX_VERSION = 1;
+
+struct SeekIndexHeader
+{
+  char magic[4];
+  uint32_t version;
+  int64_t fileLength;
+  int32_t streamIdx;
+  int32_t timeBaseNum;
+  int32_t timeBaseDen;
+  uint32_t count;
+};
+}
+
+bool CDemuxSeekIndex::Open(const std::string& fileName, int64_t fileLength, int streamIdx, int timeBaseNum, int timeBaseDen)
+{
+  Close();
+
+  if (fileName.empty() || streamIdx < 0 || timeBaseNum <= 0 || timeBaseDen <= 0)
+    return false;
+
+  // growing recordings keep their index, the file name is the key
+  m_cacheFile = StringUtils::Format("%s%08x.idx", SEEKINDEX_PATH, Crc32::ComputeFromLowerCase(fileName));
+  m_fileLength = fileLength;
+  m_streamIdx = streamIdx;
+  m_timeBaseNum = timeBaseNum;
+  m_timeBaseDen = timeBaseDen;
+  m_minDistance = std::max<int64_t>(1, static_cast<int64_t>(timeBaseDen) / (2 * timeBaseNum));
+
+  return Load();
+}
+
+void CDemuxSeekIndex::Close()
+{
+  if (m_changed)
+    Save();
+
+  m_cacheFile.clear();
+  m_streamIdx = -1;
+  m_entries.clear();
+  m_changed = false;
+}
+
+bool CDemuxSeekIndex::Add(int64_t timestamp, int64_t pos)
+{
+  if (!IsOpen() || pos < 0 || m_entries.size() >= MAX_ENTRIES)
+    return false;
+
+  // playback mostly appends, avoid the search in that case
+  auto it = m_entries.end();
+  if (!m_entries.empty() && timestamp <= m_entries.back().first)
+    it = std::lower_bound(m_entries.begin(), m_entries.end(), Entry(timestamp, 0),
+                          [](const Entry& a, const Entry& b) { return a.first < b.first; });
+
+  if (it != m_entries.end() && it->first - timestamp < m_minDistance)
+    return false;
+  if (it != m_entries.begin() && timestamp - (it - 1)->first < m_minDistance)
+    return false;
+
+  m_entries.insert(it, Entry(timestamp, pos));
+  m_changed = true;
+  return true;
+}
+
+bool CDemuxSeekIndex::Load()
+{
+  CFile file;
+  if (!file.Open(m_cacheFile))
+    return false;
+
+  SeekIndexHeader header;
+  if (file.Read(&header, sizeof(header)) != sizeof(header) ||
+      memcmp(header.magic, "KSIX", 4) != 0 ||
+      header.version != SEEKINDEX_VERSION ||
+      header.count > MAX_ENTRIES)
+    return false;
+
+  if (header.streamIdx != m_streamIdx ||
+      header.timeBaseNum != m_timeBaseNum ||
+      header.timeBaseDen != m_timeBaseDen ||
+      header.fileLength > m_fileLength)
+  {
+    CLog::Log(LOGDEBUG, "CDemuxSeekIndex::Load - discarding outdated index %s", m_cacheFile.c_str());
+    return false;
+  }
+
+  std::vector<Entry> entries(header.count);
+  for (Entry& entry : entries)
+  {
+    int64_t data[2];
+    if (file.Read(data, sizeof(data)) != sizeof(data))
+      return false;
+    entry.first = data[0];
+    entry.second = data[1];
+
+    if (entry.second < 0 || (m_fileLength > 0 && entry.second >= m_fileLength))
+      return false;
+  }
+
+  if (!std::is_sorted(entries.begin(), entries.end()))
+    return false;
+
+  m_entries.swap(entries);
+  CLog::Log(LOGDEBUG, "CDemuxSeekIndex::Load - loaded %u keyframes from %s",
+            static_cast<unsigned int>(m_entries.size()), m_cacheFile.c_str());
+  return true;
+}
+
+void CDemuxSeekIndex::Save()
+{
+  if (m_entries.size() < MIN_SAVE_ENTRIES)
+    return;
+
+  if (!CDirectory::Exists(SEEKINDEX_PATH) && !CDirectory::Create(SEEKINDEX_PATH))
+    return;
+
+  CFile file;
+  if (!file.OpenForWrite(m_cacheFile, true))
+  {
+    CLog::Log(LOGWARNING, "CDemuxSeekIndex::Save - unable to write %s", m_cacheFile.c_str());
+    return;
+  }
+
+  SeekIndexHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "KSIX", 4);
+  header.version = SEEKINDEX_VERSION;
+  header.fileLength = m_fileLength;
+  header.streamIdx = m_streamIdx;
+  header.timeBaseNum = m_timeBaseNum;
+  header.timeBaseDen = m_timeBaseDen;
+  header.count = static_cast<uint32_t>(m_entries.size());
+
+  std::vector<int64_t> data;
+  data.reserve(m_entries.size() * 2);
+  for (const Entry& entry : m_entries)
+  {
+    data.push_back(entry.first);
+    data.push_back(entry.second);
+  }
+
+  if (file.Write(&header, sizeof(header)) != sizeof(header) ||
+      file.Write(data.data(), data.size() * sizeof(int64_t)) != static_cast<ssize_t>(data.size() * sizeof(int64_t)))
+  {
+    file.Close();
+    CFile::Delete(m_cacheFile);
+  }
+}
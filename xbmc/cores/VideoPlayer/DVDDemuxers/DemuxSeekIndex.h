@@ -0,0 +1,77 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*!
+ * Keyframe index of one stream of a file, collected while playing and
+ * persisted under special://temp/seekindex/ so later sessions can seek
+ * without scanning. Timestamps are in units of the stream time base.
+ */
+class CDemuxSeekIndex
+{
+public:
+  typedef std::pair<int64_t, int64_t> Entry; //!< timestamp, byte position
+
+  /*!
+   * Prepares the index for a file and loads a previously stored one.
+   * A stored index is dropped if it was built for a different stream
+   * layout or if the file got smaller since.
+   * \return true if stored entries were loaded
+   */
+  bool Open(const std::string& fileName, int64_t fileLength, int streamIdx, int timeBaseNum, int timeBaseDen);
+
+  /*!
+   * Writes the index back to the cache if it has changed and resets it
+   */
+  void Close();
+
+  /*!
+   * Adds a keyframe. Entries closer than half a second to an existing one
+   * are ignored.
+   * \return true if the entry was added
+   */
+  bool Add(int64_t timestamp, int64_t pos);
+
+  bool IsOpen() const { return m_streamIdx >= 0; }
+  int GetStreamIdx() const { return m_streamIdx; }
+  const std::vector<Entry>& GetEntries() const { return m_entries; }
+
+private:
+  bool Load();
+  void Save();
+
+  static const unsigned int MAX_ENTRIES = 100000;
+  static const unsigned int MIN_SAVE_ENTRIES = 16;
+
+  std::string m_cacheFile;
+  int64_t m_fileLength = 0;
+  int m_streamIdx = -1;
+  int m_timeBaseNum = 0;
+  int m_timeBaseDen = 0;
+  int64_t m_minDistance = 0;
+  std::vector<Entry> m_entries;
+  bool m_changed = false;
+};
@@ -20,6 +20,7 @@
 
 #include "DVDFactoryInputStream.h"
 #include "DVDInputStreamPVRManager.h"
+#include "PVRTimeshiftBuffer.h"
 #include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
 #include "ServiceBroker.h"
 #include "URL.h"
@@ -32,6 +33,7 @@
 #include "pvr/channels/PVRChannelGroupsContainer.h"
 #include "pvr/recordings/PVRRecordingsPath.h"
 #include "pvr/recordings/PVRRecordings.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "cores/VideoPlayer/DVDDemuxers/DVDDemux.h"
 
@@ -140,6 +142,16 @@ bool CDVDInputStreamPVRManager::Open()
       m_demuxActive = true;
   }
 
+  if (!m_isRecording && !m_demuxActive && g_advancedSettings.m_iPVRTimeshiftBufferSize > 0 &&
+      !CServiceBroker::GetPVRManager().Clients()->CanPauseStream() &&
+      !CServiceBroker::GetPVRManager().Clients()->CanSeekStream())
+  {
+    m_timeshiftBuffer.reset(new CPVRTimeshiftBuffer(URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath, "pvrtimeshift.ts"),
+                                                    static_cast<int64_t>(g_advancedSettings.m_iPVRTimeshiftBufferSize) * 1024 * 1024));
+    if (!m_timeshiftBuffer->Open())
+      m_timeshiftBuffer.reset();
+  }
+
   CLog::Log(LOGDEBUG, "CDVDInputStreamPVRManager::Open - stream opened: %s", CURL::GetRedacted(m_item.GetDynPath()).c_str());
 
   m_StreamProps->iStreamCount = 0;
@@ -149,6 +161,9 @@ bool CDVDInputStreamPVRManager::Open()
 // close file and reset everything
 void CDVDInputStreamPVRManager::Close()
 {
+  // stop reading from the client before the stream goes away
+  m_timeshiftBuffer.reset();
+
   CServiceBroker::GetPVRManager().CloseStream();
 
   CDVDInputStream::Close();
@@ -160,7 +175,8 @@ void CDVDInputStreamPVRManager::Close()
 
 int CDVDInputStreamPVRManager::Read(uint8_t* buf, int buf_size)
 {
-  int ret = CServiceBroker::GetPVRManager().Clients()->ReadStream(buf, buf_size);
+  int ret = m_timeshiftBuffer ? m_timeshiftBuffer->Read(buf, buf_size) :
+                                CServiceBroker::GetPVRManager().Clients()->ReadStream(buf, buf_size);
   if (ret < 0)
     ret = -1;
 
@@ -175,13 +191,14 @@ int64_t CDVDInputStreamPVRManager::Seek(int64_t offset, int whence)
 {
   if (whence == SEEK_POSSIBLE)
   {
-    if (CServiceBroker::GetPVRManager().Clients()->CanSeekStream())
+    if (CanSeek())
       return 1;
     else
       return 0;
   }
 
-  int64_t ret = CServiceBroker::GetPVRManager().Clients()->SeekStream(offset, whence);
+  int64_t ret = m_timeshiftBuffer ? m_timeshiftBuffer->Seek(offset, whence) :
+                                    CServiceBroker::GetPVRManager().Clients()->SeekStream(offset, whence);
 
   // if we succeed, we are not eof anymore
   if( ret >= 0 )
@@ -192,6 +209,9 @@ int64_t CDVDInputStreamPVRManager::Seek(int64_t offset, int whence)
 
 int64_t CDVDInputStreamPVRManager::GetLength()
 {
+  if (m_timeshiftBuffer)
+    return m_timeshiftBuffer->GetLength();
+
   return CServiceBroker::GetPVRManager().Clients()->GetStreamLength();
 }
 
@@ -231,16 +251,26 @@ CDVDInputStream::ENextStream CDVDInputStreamPVRManager::NextStream()
 
 bool CDVDInputStreamPVRManager::CanPause()
 {
+  if (m_timeshiftBuffer)
+    return true;
+
   return CServiceBroker::GetPVRManager().Clients()->CanPauseStream();
 }
 
 bool CDVDInputStreamPVRManager::CanSeek()
 {
+  if (m_timeshiftBuffer)
+    return true;
+
   return CServiceBroker::GetPVRManager().Clients()->CanSeekStream();
 }
 
 void CDVDInputStreamPVRManager::Pause(bool bPaused)
 {
+  // the buffer keeps reading from the client while paused
+  if (m_timeshiftBuffer)
+    return;
+
   CServiceBroker::GetPVRManager().Clients()->PauseStream(bPaused);
 }
 
@@ -24,12 +24,14 @@
 * for DESCRIPTION see 'DVDInputStreamPVRManager.cpp'
 */
 
+#include <memory>
 #include <vector>
 #include "DVDInputStream.h"
 #include "FileItem.h"
 #include "threads/SystemClock.h"
 
 class IVideoPlayer;
+class CPVRTimeshiftBuffer;
 struct PVR_STREAM_PROPERTIES;
 class CDemuxStreamAudio;
 class CDemuxStreamVideo;
@@ -92,6 +94,7 @@ protected:
   PVR_STREAM_PROPERTIES *m_StreamProps;
   std::map<int, std::shared_ptr<CDemuxStream>> m_streamMap;
   bool m_isRecording;
+  std::unique_ptr<CPVRTimeshiftBuffer> m_timeshiftBuffer; /*!< live stream buffered on our side, for clients that can't pause or seek */
 };
 
 
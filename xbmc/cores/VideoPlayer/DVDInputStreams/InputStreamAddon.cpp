@@ -31,6 +31,8 @@
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 
+#define INPUTSTREAM_DEMUX_BATCH 32
+
 CInputStreamProvider::CInputStreamProvider(ADDON::BinaryAddonBasePtr addonBase, kodi::addon::IAddonInstance* parentInstance)
   : m_addonBase(addonBase)
   , m_parentInstance(parentInstance)
@@ -169,6 +171,7 @@ bool CInputStreamAddon::Open()
 
 void CInputStreamAddon::Close()
 {
+  ClearPackets();
   if (m_struct.toAddon.close)
     m_struct.toAddon.close(&m_struct);
   DestroyInstance();
@@ -318,12 +321,35 @@ bool CInputStreamAddon::OpenDemux()
 
 DemuxPacket* CInputStreamAddon::ReadDemux()
 {
+  if (m_packets.empty() && m_struct.toAddon.demux_read_batch)
+  {
+    DemuxPacket* packets[INPUTSTREAM_DEMUX_BATCH];
+    int count = m_struct.toAddon.demux_read_batch(&m_struct, packets, INPUTSTREAM_DEMUX_BATCH);
+    if (count <= 0)
+      return nullptr;
+    m_packets.insert(m_packets.end(), packets, packets + count);
+  }
+
+  if (!m_packets.empty())
+  {
+    DemuxPacket* packet = m_packets.front();
+    m_packets.pop_front();
+    return packet;
+  }
+
   if (!m_struct.toAddon.demux_read)
     return nullptr;
 
   return m_struct.toAddon.demux_read(&m_struct);
 }
 
+void CInputStreamAddon::ClearPackets()
+{
+  for (DemuxPacket* packet : m_packets)
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  m_packets.clear();
+}
+
 std::vector<CDemuxStream*> CInputStreamAddon::GetStreams() const
 {
   std::vector<CDemuxStream*> streams;
@@ -452,6 +478,8 @@ bool CInputStreamAddon::SeekTime(double time, bool backward, double* startpts)
   if (!m_struct.toAddon.demux_seek_time)
     return false;
 
+  ClearPackets();
+
   if ((m_caps.m_mask & INPUTSTREAM_CAPABILITIES::SUPPORTS_IPOSTIME) != 0)
   {
     if (!PosTime(static_cast<int>(time)))
@@ -475,6 +503,7 @@ void CInputStreamAddon::AbortDemux()
 
 void CInputStreamAddon::FlushDemux()
 {
+  ClearPackets();
   if (m_struct.toAddon.demux_flush)
     m_struct.toAddon.demux_flush(&m_struct);
 }
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <vector>
 
@@ -105,6 +106,8 @@ protected:
   IVideoPlayer* m_player;
 
 private:
+  void ClearPackets();
+
   std::vector<std::string> m_fileItemProps;
   INPUTSTREAM_CAPABILITIES m_caps;
 
@@ -113,6 +116,9 @@ private:
   AddonInstance_InputStream m_struct;
   std::shared_ptr<CInputStreamProvider> m_subAddonProvider;
 
+  // packets of the last demux_read_batch call not yet returned by ReadDemux()
+  std::deque<DemuxPacket*> m_packets;
+
   /*!
    * Callbacks from add-on to kodi
    */
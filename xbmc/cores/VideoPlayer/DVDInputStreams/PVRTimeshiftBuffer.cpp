@@ -0,0 +1,197 @@
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PVRTimeshiftBuffer.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <vector>
+
+#include "ServiceBroker.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include "pvr/PVRManager.h"
+#include "pvr/addons/PVRClients.h"
+
+#define PVR_TIMESHIFT_CHUNK_SIZE 65536 /* bytes read from the client at once */
+
+using namespace XFILE;
+
+CPVRTimeshiftBuffer::CPVRTimeshiftBuffer(const std::string &strPath, int64_t iSize) :
+  CThread("PVRTimeshiftBuffer"),
+  m_strPath(strPath),
+  m_iSize(iSize),
+  m_iWritePos(0),
+  m_iReadPos(0),
+  m_bEOF(false),
+  m_bOpen(false)
+{
+}
+
+CPVRTimeshiftBuffer::~CPVRTimeshiftBuffer()
+{
+  Close();
+}
+
+bool CPVRTimeshiftBuffer::Open()
+{
+  if (!m_writeFile.OpenForWrite(m_strPath, true) ||
+      !m_readFile.Open(m_strPath, READ_NO_CACHE))
+  {
+    CLog::Log(LOGERROR, "CPVRTimeshiftBuffer - %s - unable to create the buffer file '%s'", __FUNCTION__, m_strPath.c_str());
+    m_writeFile.Close();
+    return false;
+  }
+
+  m_iWritePos = 0;
+  m_iReadPos = 0;
+  m_bEOF = false;
+  m_bOpen = true;
+  Create();
+
+  CLog::Log(LOGDEBUG, "CPVRTimeshiftBuffer - %s - buffering up to %" PRId64 " bytes in '%s'", __FUNCTION__, m_iSize, m_strPath.c_str());
+  return true;
+}
+
+void CPVRTimeshiftBuffer::Close()
+{
+  StopThread(true);
+
+  if (m_bOpen)
+  {
+    m_readFile.Close();
+    m_writeFile.Close();
+    CFile::Delete(m_strPath);
+    m_bOpen = false;
+  }
+}
+
+int64_t CPVRTimeshiftBuffer::GetBegin() const
+{
+  return std::max<int64_t>(m_iWritePos - m_iSize, 0);
+}
+
+void CPVRTimeshiftBuffer::Process()
+{
+  std::vector<uint8_t> buffer(PVR_TIMESHIFT_CHUNK_SIZE);
+
+  bool bError = false;
+  while (!m_bStop && !bError)
+  {
+    int iRead = CServiceBroker::GetPVRManager().Clients()->ReadStream(buffer.data(), buffer.size());
+    if (iRead <= 0)
+      break;
+
+    /* the oldest bytes are overwritten, reads of them must not happen at the same time */
+    CSingleLock lock(m_critSection);
+    int iWritten = 0;
+    while (iWritten < iRead)
+    {
+      int64_t iFilePos = (m_iWritePos + iWritten) % m_iSize;
+      ssize_t iLength = static_cast<ssize_t>(std::min<int64_t>(iRead - iWritten, m_iSize - iFilePos));
+      if (m_writeFile.Seek(iFilePos, SEEK_SET) != iFilePos ||
+          m_writeFile.Write(buffer.data() + iWritten, iLength) != iLength)
+      {
+        CLog::Log(LOGERROR, "CPVRTimeshiftBuffer - %s - unable to write to the buffer file", __FUNCTION__);
+        bError = true;
+        break;
+      }
+      iWritten += iLength;
+    }
+
+    m_iWritePos += iWritten;
+    m_dataEvent.Set();
+  }
+
+  CSingleLock lock(m_critSection);
+  m_bEOF = true;
+  m_dataEvent.Set();
+}
+
+int CPVRTimeshiftBuffer::Read(uint8_t *buf, int iSize)
+{
+  CSingleLock lock(m_critSection);
+
+  while (m_iReadPos >= m_iWritePos && !m_bEOF)
+  {
+    m_dataEvent.Reset();
+    CSingleExit exit(m_critSection);
+    m_dataEvent.WaitMSec(100);
+  }
+
+  /* what we were about to read was overwritten while playback was paused or behind */
+  if (m_iReadPos < GetBegin())
+  {
+    CLog::Log(LOGDEBUG, "CPVRTimeshiftBuffer - %s - skipped %" PRId64 " bytes that were overwritten", __FUNCTION__, GetBegin() - m_iReadPos);
+    m_iReadPos = GetBegin();
+  }
+
+  if (m_iReadPos >= m_iWritePos)
+    return 0;
+
+  int64_t iFilePos = m_iReadPos % m_iSize;
+  int iLength = static_cast<int>(std::min<int64_t>(std::min<int64_t>(iSize, m_iWritePos - m_iReadPos), m_iSize - iFilePos));
+  if (m_readFile.Seek(iFilePos, SEEK_SET) != iFilePos)
+    return -1;
+
+  ssize_t iRead = m_readFile.Read(buf, iLength);
+  if (iRead <= 0)
+    return -1;
+
+  m_iReadPos += iRead;
+  return static_cast<int>(iRead);
+}
+
+int64_t CPVRTimeshiftBuffer::Seek(int64_t iOffset, int iWhence)
+{
+  CSingleLock lock(m_critSection);
+
+  int64_t iPos;
+  switch (iWhence)
+  {
+  case SEEK_SET:
+    iPos = iOffset;
+    break;
+  case SEEK_CUR:
+    iPos = m_iReadPos + iOffset;
+    break;
+  case SEEK_END:
+    iPos = m_iWritePos + iOffset;
+    break;
+  default:
+    return -1;
+  }
+
+  m_iReadPos = std::min(std::max(iPos, GetBegin()), m_iWritePos);
+  return m_iReadPos;
+}
+
+int64_t CPVRTimeshiftBuffer::GetLength()
+{
+  CSingleLock lock(m_critSection);
+  return m_iWritePos;
+}
+
+bool CPVRTimeshiftBuffer::IsEOF()
+{
+  CSingleLock lock(m_critSection);
+  return m_bEOF && m_iReadPos >= m_iWritePos;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+
+#include "filesystem/File.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+/*!
+ * @brief Kodi side timeshift for live streams of clients that can't pause or seek themselves.
+ *
+ * A thread reads the live stream from the playing client and writes it into a file of fixed size,
+ * wrapping around at its end. Playback reads from the file, so it may be paused and seeked within
+ * the data that is still in the file while the thread keeps reading from the client.
+ *
+ * Positions are counted from the start of the live stream. The file holds the last size bytes,
+ * a position that was overwritten in the meantime is moved to the oldest byte still available.
+ */
+class CPVRTimeshiftBuffer : private CThread
+{
+public:
+  /*!
+   * @param strPath The file to buffer in, it is overwritten.
+   * @param iSize The size of the file in bytes.
+   */
+  CPVRTimeshiftBuffer(const std::string &strPath, int64_t iSize);
+  ~CPVRTimeshiftBuffer() override;
+
+  /*!
+   * @brief Create the file and start reading from the playing client.
+   * @return True if the file could be created, false otherwise.
+   */
+  bool Open();
+
+  /*!
+   * @brief Stop reading from the client and delete the file.
+   */
+  void Close();
+
+  /*!
+   * @brief Read from the current position, wait for the client if the position is at the live end.
+   * @return The amount of bytes read, 0 at the end of the stream, -1 on errors.
+   */
+  int Read(uint8_t *buf, int iSize);
+
+  /*!
+   * @brief Move the current position, it is kept within the data that is in the file.
+   * @return The new position, -1 on errors.
+   */
+  int64_t Seek(int64_t iOffset, int iWhence);
+
+  /*!
+   * @return The position of the live end, the amount of bytes read from the client.
+   */
+  int64_t GetLength();
+
+  /*!
+   * @return True if the client ended the stream and everything was read, false otherwise.
+   */
+  bool IsEOF();
+
+protected:
+  void Process() override;
+
+private:
+  CPVRTimeshiftBuffer(const CPVRTimeshiftBuffer&) = delete;
+  CPVRTimeshiftBuffer& operator=(const CPVRTimeshiftBuffer&) = delete;
+
+  int64_t GetBegin() const;
+
+  std::string m_strPath;
+  int64_t m_iSize;
+  XFILE::CFile m_writeFile;
+  XFILE::CFile m_readFile;
+  CCriticalSection m_critSection;
+  CEvent m_dataEvent;
+  int64_t m_iWritePos;   /*!< the live end, bytes read from the client */
+  int64_t m_iReadPos;    /*!< the position of playback */
+  bool m_bEOF;           /*!< true if the client ended the stream */
+  bool m_bOpen;
+};
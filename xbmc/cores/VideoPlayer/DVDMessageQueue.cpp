@@ -51,10 +51,20 @@ void CDVDMessageQueue::Init()
   m_TimeBack = DVD_NOPTS_VALUE;
   m_TimeFront = DVD_NOPTS_VALUE;
   m_drain = false;
+
+  m_ring.Reset(m_ringSize);
+  m_overflowCount = 0;
+  m_lockedCount = 0;
 }
 
 void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
+  if (m_ringSize)
+  {
+    FlushRing(type);
+    return;
+  }
+
   CSingleLock lock(m_section);
 
   m_messages.remove_if([type](const DVDMessageListItem &item){
@@ -85,10 +95,12 @@ void CDVDMessageQueue::Abort()
 
 void CDVDMessageQueue::End()
 {
-  CSingleLock lock(m_section);
-
+  // flush before taking the lock, the ring path has to acquire its own
+  // sections first
   Flush(CDVDMsg::NONE);
 
+  CSingleLock lock(m_section);
+
   m_bInitialized = false;
   m_iDataSize = 0;
   m_bAbortRequest = false;
@@ -106,6 +118,9 @@ MsgQueueReturnCode CDVDMessageQueue::PutBack(CDVDMsg* pMsg, int priority)
 
 MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front)
 {
+  if (m_ringSize)
+    return PutRing(pMsg, priority, front);
+
   CSingleLock lock(m_section);
 
   if (!m_bInitialized)
@@ -170,6 +185,9 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
 
 MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
 {
+  if (m_ringSize)
+    return GetRing(pMsg, iTimeoutInMilliSeconds, priority);
+
   CSingleLock lock(m_section);
 
   *pMsg = NULL;
@@ -246,7 +264,7 @@ void CDVDMessageQueue::UpdateTimeFront()
           m_TimeFront = packet->pts;
 
         if (m_TimeBack == DVD_NOPTS_VALUE)
-          m_TimeBack = m_TimeFront;
+          m_TimeBack = m_TimeFront.load();
       }
     }
   }
@@ -268,7 +286,7 @@ void CDVDMessageQueue::UpdateTimeBack()
           m_TimeBack = packet->pts;
 
         if (m_TimeFront == DVD_NOPTS_VALUE)
-          m_TimeFront = m_TimeBack;
+          m_TimeFront = m_TimeBack.load();
       }
     }
   }
@@ -276,6 +294,8 @@ void CDVDMessageQueue::UpdateTimeBack()
 
 unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
 {
+  // holding the consumer side keeps the ring content stable
+  CSingleLock ringLock(m_ringGetSection);
   CSingleLock lock(m_section);
 
   if (!m_bInitialized)
@@ -292,6 +312,16 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     if(item.message->IsType(type))
       count++;
   }
+  for (const auto &item : m_overflow)
+  {
+    if(item.message->IsType(type))
+      count++;
+  }
+  for (size_t i = 0; i < m_ring.Size(); i++)
+  {
+    if((*m_ring.Peek(i))->IsType(type))
+      count++;
+  }
 
   return count;
 }
@@ -317,7 +347,16 @@ void CDVDMessageQueue::WaitUntilEmpty()
 
 int CDVDMessageQueue::GetLevel() const
 {
+  // in ring mode all values used below are maintained atomically
+  if (m_ringSize)
+    return CalcLevel();
+
   CSingleLock lock(m_section);
+  return CalcLevel();
+}
+
+int CDVDMessageQueue::CalcLevel() const
+{
 
   if (m_iDataSize > m_iMaxDataSize)
     return 100;
@@ -357,3 +396,272 @@ bool CDVDMessageQueue::IsDataBased() const
           m_TimeFront == DVD_NOPTS_VALUE ||
           m_TimeFront <= m_TimeBack);
 }
+
+namespace
+{
+double GetPacketTime(CDVDMsg* msg)
+{
+  if (!msg->IsType(CDVDMsg::DEMUXER_PACKET))
+    return DVD_NOPTS_VALUE;
+
+  DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket();
+  if (!packet)
+    return DVD_NOPTS_VALUE;
+
+  if (packet->dts != DVD_NOPTS_VALUE)
+    return packet->dts;
+  return packet->pts;
+}
+
+int GetPacketSize(CDVDMsg* msg)
+{
+  if (!msg->IsType(CDVDMsg::DEMUXER_PACKET))
+    return 0;
+
+  DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket();
+  return packet ? packet->iSize : 0;
+}
+}
+
+MsgQueueReturnCode CDVDMessageQueue::PutRing(CDVDMsg* pMsg, int priority, bool front)
+{
+  if (!pMsg)
+  {
+    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Put MSGQ_INVALID_MSG", m_owner.c_str());
+    return MSGQ_INVALID_MSG;
+  }
+  if (!m_bInitialized)
+  {
+    CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Put MSGQ_NOT_INITIALIZED", m_owner.c_str());
+    pMsg->Release();
+    return MSGQ_NOT_INITIALIZED;
+  }
+
+  if (priority > 0 || !front)
+  {
+    CSingleLock lock(m_section);
+
+    if (priority > 0)
+    {
+      int prio = priority;
+      if (!front)
+        prio++;
+
+      auto it = std::find_if(m_prioMessages.begin(), m_prioMessages.end(),
+                             [prio](const DVDMessageListItem &item){
+                               return prio <= item.priority;
+                             });
+      m_prioMessages.emplace(it, pMsg, priority);
+    }
+    else
+    {
+      // pushed back messages are the next ones to be consumed
+      m_messages.emplace_back(pMsg, priority);
+      m_iDataSize += GetPacketSize(pMsg);
+
+      double time = GetPacketTime(pMsg);
+      if (time != DVD_NOPTS_VALUE)
+      {
+        m_TimeBack = time;
+        if (m_TimeFront == DVD_NOPTS_VALUE)
+          m_TimeFront = time;
+      }
+    }
+    m_lockedCount++;
+  }
+  else
+  {
+    CSingleLock lock(m_ringPutSection);
+
+    if (m_ring.Empty() && m_overflowCount == 0)
+    {
+      m_TimeBack = DVD_NOPTS_VALUE;
+      m_TimeFront = DVD_NOPTS_VALUE;
+    }
+
+    // account before publishing, the consumer may pick it up right away
+    m_iDataSize += GetPacketSize(pMsg);
+
+    double time = GetPacketTime(pMsg);
+    if (time != DVD_NOPTS_VALUE)
+    {
+      m_TimeFront = time;
+      if (m_TimeBack == DVD_NOPTS_VALUE)
+        m_TimeBack = time;
+    }
+
+    // once something spilled to the overflow list everything has to go
+    // there until the consumer has drained it, otherwise order would break
+    CDVDMsg* msg = pMsg->Acquire();
+    if (m_overflowCount > 0 || !m_ring.Push(msg))
+    {
+      msg->Release();
+
+      CSingleLock sectionLock(m_section);
+      m_overflow.emplace_front(pMsg, priority);
+      m_overflowCount++;
+    }
+  }
+
+  pMsg->Release();
+
+  // inform waiter for new packet
+  m_hEvent.Set();
+
+  return MSGQ_OK;
+}
+
+MsgQueueReturnCode CDVDMessageQueue::GetRing(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
+{
+  *pMsg = NULL;
+
+  if (!m_bInitialized)
+  {
+    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Get MSGQ_NOT_INITIALIZED", m_owner.c_str());
+    return MSGQ_NOT_INITIALIZED;
+  }
+
+  CSingleLock ringLock(m_ringGetSection);
+
+  while (true)
+  {
+    // producers signal after publishing, so reset before looking
+    m_hEvent.Reset();
+
+    if (m_bAbortRequest)
+      return MSGQ_ABORT;
+
+    if (GetRingLocked(pMsg, priority))
+      return MSGQ_OK;
+
+    if (!iTimeoutInMilliSeconds)
+      return MSGQ_TIMEOUT;
+
+    // don't block Flush while waiting
+    ringLock.Leave();
+
+    // wait for a new message
+    if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
+      return MSGQ_TIMEOUT;
+
+    ringLock.Enter();
+  }
+}
+
+bool CDVDMessageQueue::GetRingLocked(CDVDMsg** pMsg, int &priority)
+{
+  if (m_lockedCount > 0)
+  {
+    CSingleLock lock(m_section);
+
+    if (priority > 0 || !m_prioMessages.empty())
+    {
+      if (m_prioMessages.empty() || (m_prioMessages.back().priority < priority && !m_drain))
+        return false;
+
+      DVDMessageListItem& item(m_prioMessages.back());
+      priority = item.priority;
+      *pMsg = item.message->Acquire();
+      m_prioMessages.pop_back();
+      m_lockedCount--;
+      return true;
+    }
+
+    if (!m_messages.empty())
+    {
+      DVDMessageListItem& item(m_messages.back());
+      priority = item.priority;
+      m_iDataSize -= GetPacketSize(item.message);
+      *pMsg = item.message->Acquire();
+      m_messages.pop_back();
+      m_lockedCount--;
+
+      if (!m_messages.empty())
+      {
+        double time = GetPacketTime(m_messages.back().message);
+        if (time != DVD_NOPTS_VALUE)
+          m_TimeBack = time;
+      }
+      else
+        UpdateTimeBackRing();
+      return true;
+    }
+  }
+
+  if (priority > 0)
+    return false;
+
+  CDVDMsg* msg = nullptr;
+  if (!m_ring.Pop(msg))
+  {
+    if (m_overflowCount == 0)
+      return false;
+
+    CSingleLock lock(m_section);
+
+    // the ring may have been filled up and spilled over since we looked,
+    // whatever is in there now is older than the overflow list
+    if (!m_ring.Pop(msg))
+    {
+      if (m_overflow.empty())
+        return false;
+
+      msg = m_overflow.back().message->Acquire();
+      m_overflow.pop_back();
+      m_overflowCount--;
+    }
+  }
+
+  priority = 0;
+  m_iDataSize -= GetPacketSize(msg);
+  *pMsg = msg;
+  UpdateTimeBackRing();
+  return true;
+}
+
+void CDVDMessageQueue::UpdateTimeBackRing()
+{
+  CDVDMsg* const* next = m_ring.Peek();
+  if (next)
+  {
+    double time = GetPacketTime(*next);
+    if (time != DVD_NOPTS_VALUE)
+      m_TimeBack = time;
+  }
+}
+
+void CDVDMessageQueue::FlushRing(CDVDMsg::Message type)
+{
+  CSingleLock putLock(m_ringPutSection);
+  CSingleLock getLock(m_ringGetSection);
+  CSingleLock lock(m_section);
+
+  auto match = [type](const DVDMessageListItem &item){
+    return type == CDVDMsg::NONE || item.message->IsType(type);
+  };
+
+  m_messages.remove_if(match);
+  m_prioMessages.remove_if(match);
+  m_overflow.remove_if(match);
+
+  // move whatever survives in the ring or the overflow list to the consumer
+  // end of m_messages, it is older than anything put from now on
+  CDVDMsg* msg = nullptr;
+  while (m_ring.Pop(msg))
+  {
+    if (type != CDVDMsg::NONE && !msg->IsType(type))
+      m_messages.emplace_front(msg, 0);
+    msg->Release();
+  }
+  m_messages.splice(m_messages.begin(), m_overflow);
+
+  m_overflowCount = 0;
+  m_lockedCount = static_cast<int>(m_messages.size() + m_prioMessages.size());
+
+  if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
+  {
+    m_iDataSize = 0;
+    m_TimeBack = DVD_NOPTS_VALUE;
+    m_TimeFront = DVD_NOPTS_VALUE;
+  }
+}
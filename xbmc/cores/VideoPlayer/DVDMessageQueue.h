@@ -27,6 +27,7 @@
 #include <algorithm>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "threads/SPSCQueue.h"
 
 struct DVDMessageListItem
 {
@@ -108,22 +109,38 @@ public:
   bool IsInited() const { return m_bInitialized; }
   bool IsDataBased() const;
 
+  /**
+   * Route priority 0 messages added by Put() through a bounded single
+   * producer/single consumer ring instead of the locked message list, so the
+   * demuxer and the decoder thread don't contend for the queue lock on every
+   * packet. Messages with a priority and messages added by PutBack() keep
+   * using the locked lists. Must be set before Init(), 0 disables the ring.
+   */
+  void SetPacketRingSize(unsigned int size) { m_ringSize = size; }
+
 private:
 
   MsgQueueReturnCode Put(CDVDMsg* pMsg, int priority, bool front);
   void UpdateTimeFront();
   void UpdateTimeBack();
+  int CalcLevel() const;
+
+  MsgQueueReturnCode PutRing(CDVDMsg* pMsg, int priority, bool front);
+  MsgQueueReturnCode GetRing(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority);
+  bool GetRingLocked(CDVDMsg** pMsg, int &priority);
+  void FlushRing(CDVDMsg::Message type);
+  void UpdateTimeBackRing();
 
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
 
   std::atomic<bool> m_bAbortRequest;
-  bool m_bInitialized;
+  std::atomic<bool> m_bInitialized;
   bool m_drain = false;
 
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
+  std::atomic<int> m_iDataSize;
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
   double m_TimeSize;
 
   int m_iMaxDataSize;
@@ -131,5 +148,14 @@ private:
 
   std::list<DVDMessageListItem> m_messages;
   std::list<DVDMessageListItem> m_prioMessages;
+
+  // ring mode, lock order is m_ringPutSection, m_ringGetSection, m_section
+  unsigned int m_ringSize = 0;
+  XbmcThreads::CSPSCQueue<CDVDMsg*> m_ring;
+  CCriticalSection m_ringPutSection;
+  mutable CCriticalSection m_ringGetSection;
+  std::list<DVDMessageListItem> m_overflow;
+  std::atomic<int> m_overflowCount{0};
+  std::atomic<int> m_lockedCount{0};
 };
 
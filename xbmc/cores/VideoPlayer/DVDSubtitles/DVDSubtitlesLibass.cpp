@@ -24,6 +24,7 @@
 #include "ServiceBroker.h"
 #include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
@@ -31,6 +32,9 @@
 #include "threads/SingleLock.h"
 #include "windowing/GraphicContext.h"
 
+#include <cmath>
+#include <string.h>
+
 static void libass_log(int level, const char *fmt, va_list args, void *data)
 {
   if(level >= 5)
@@ -40,7 +44,12 @@ static void libass_log(int level, const char *fmt, va_list args, void *data)
 }
 
 CDVDSubtitlesLibass::CDVDSubtitlesLibass()
+  : CThread("LibassLookAhead")
+  , m_nextPts(DVD_NOPTS_VALUE)
+  , m_lastPts(DVD_NOPTS_VALUE)
 {
+  m_lookAhead = g_advancedSettings.m_videoAssLookAhead;
+
   //Setting the font directory to the temp dir(where mkv fonts are extracted to)
   std::string strPath = "special://temp/fonts/";
 
@@ -83,6 +92,10 @@ CDVDSubtitlesLibass::CDVDSubtitlesLibass()
 
 CDVDSubtitlesLibass::~CDVDSubtitlesLibass()
 {
+  StopThread(false);
+  m_workerEvent.Set();
+  StopThread();
+
   if(m_track)
     ass_free_track(m_track);
   ass_renderer_done(m_renderer);
@@ -116,6 +129,10 @@ bool CDVDSubtitlesLibass::DecodeDemuxPkt(char* data, int size, double start, dou
   }
 
   ass_process_chunk(m_track, data, size, DVD_TIME_TO_MSEC(start), DVD_TIME_TO_MSEC(duration));
+
+  // frames rendered ahead don't contain the new event yet
+  if (m_lookAhead > 0)
+    FlushLookAhead(start);
   return true;
 }
 
@@ -139,6 +156,18 @@ bool CDVDSubtitlesLibass::CreateTrack(char* buf, size_t size)
 
 ASS_Image* CDVDSubtitlesLibass::RenderImage(int frameWidth, int frameHeight, int videoWidth, int videoHeight, double pts, int useMargin, double position, int *changes)
 {
+  RenderParams params;
+  params.frameWidth = frameWidth;
+  params.frameHeight = frameHeight;
+  params.videoWidth = videoWidth;
+  params.videoHeight = videoHeight;
+  params.useMargin = useMargin;
+  params.position = position;
+  params.pixelRatio = CServiceBroker::GetWinSystem()->GetGfxContext().GetResInfo().fPixelRatio;
+
+  if (m_lookAhead > 0)
+    return RenderImageLookAhead(params, pts, changes);
+
   CSingleLock lock(m_section);
   if(!m_renderer || !m_track)
   {
@@ -146,17 +175,188 @@ ASS_Image* CDVDSubtitlesLibass::RenderImage(int frameWidth, int frameHeight, int
     return NULL;
   }
 
-  double storage_aspect = (double)frameWidth / frameHeight;
-  ass_set_frame_size(m_renderer, frameWidth, frameHeight);
-  int topmargin = (frameHeight - videoHeight) / 2;
-  int leftmargin = (frameWidth - videoWidth) / 2;
+  return Render(params, pts, changes);
+}
+
+bool CDVDSubtitlesLibass::RenderParams::operator==(const RenderParams& other) const
+{
+  return frameWidth == other.frameWidth &&
+         frameHeight == other.frameHeight &&
+         videoWidth == other.videoWidth &&
+         videoHeight == other.videoHeight &&
+         useMargin == other.useMargin &&
+         position == other.position &&
+         pixelRatio == other.pixelRatio;
+}
+
+ASS_Image* CDVDSubtitlesLibass::Render(const RenderParams& params, double pts, int* changes)
+{
+  double storage_aspect = (double)params.frameWidth / params.frameHeight;
+  ass_set_frame_size(m_renderer, params.frameWidth, params.frameHeight);
+  int topmargin = (params.frameHeight - params.videoHeight) / 2;
+  int leftmargin = (params.frameWidth - params.videoWidth) / 2;
   ass_set_margins(m_renderer, topmargin, topmargin, leftmargin, leftmargin);
-  ass_set_use_margins(m_renderer, useMargin);
-  ass_set_line_position(m_renderer, position);
-  ass_set_aspect_ratio(m_renderer, storage_aspect / CServiceBroker::GetWinSystem()->GetGfxContext().GetResInfo().fPixelRatio, storage_aspect);
+  ass_set_use_margins(m_renderer, params.useMargin);
+  ass_set_line_position(m_renderer, params.position);
+  ass_set_aspect_ratio(m_renderer, storage_aspect / params.pixelRatio, storage_aspect);
   return ass_render_frame(m_renderer, m_track, DVD_TIME_TO_MSEC(pts), changes);
 }
 
+std::unique_ptr<CDVDSubtitlesLibass::RenderedFrame> CDVDSubtitlesLibass::RenderFrame(const RenderParams& params, double pts)
+{
+  std::unique_ptr<RenderedFrame> frame(new RenderedFrame);
+  frame->pts = pts;
+  frame->params = params;
+  frame->sequence = ++m_sequence;
+  frame->changes = 0;
+
+  ASS_Image* images = Render(params, pts, &frame->changes);
+
+  size_t count = 0;
+  size_t bytes = 0;
+  for (ASS_Image* img = images; img; img = img->next)
+  {
+    count++;
+    bytes += img->w * img->h;
+  }
+
+  frame->images.resize(count);
+  frame->bitmaps.resize(bytes);
+
+  ASS_Image* dst = frame->images.data();
+  unsigned char* bitmap = frame->bitmaps.data();
+  for (ASS_Image* img = images; img; img = img->next, dst++)
+  {
+    *dst = *img;
+    dst->stride = img->w;
+    dst->bitmap = bitmap;
+    dst->next = img->next ? dst + 1 : nullptr;
+    for (int y = 0; y < img->h; y++)
+    {
+      memcpy(bitmap, img->bitmap + y * img->stride, img->w);
+      bitmap += img->w;
+    }
+  }
+
+  return frame;
+}
+
+ASS_Image* CDVDSubtitlesLibass::RenderImageLookAhead(const RenderParams& params, double pts, int* changes)
+{
+  {
+    CSingleLock lock(m_queueSection);
+
+    // same frame shown again, e.g. while paused
+    if (m_current && m_current->pts == pts && m_current->params == params)
+    {
+      if (changes)
+        *changes = 0;
+      return m_current->GetImages();
+    }
+
+    double delta = pts - m_lastPts;
+    if (delta > 0 && delta < DVD_TIME_BASE / 5)
+      m_interval = delta;
+    m_lastPts = pts;
+
+    // skip frames the player has dropped
+    double tolerance = m_interval / 2;
+    while (!m_queue.empty() && m_queue.front()->params == params &&
+           m_queue.front()->pts < pts - tolerance)
+      m_queue.pop_front();
+
+    if (!m_queue.empty() && m_queue.front()->params == params &&
+        std::abs(m_queue.front()->pts - pts) <= tolerance)
+    {
+      std::unique_ptr<RenderedFrame> frame = std::move(m_queue.front());
+      m_queue.pop_front();
+
+      // libass reports changes relative to the frame rendered before
+      if (changes)
+        *changes = m_current && frame->sequence == m_current->sequence + 1 ? frame->changes : 2;
+
+      m_current = std::move(frame);
+      m_workerEvent.Set();
+      return m_current->GetImages();
+    }
+  }
+
+  // not rendered ahead, the look-ahead restarts from this frame
+  CSingleLock lock(m_section);
+  if(!m_renderer || !m_track)
+  {
+    CLog::Log(LOGERROR, "CDVDSubtitlesLibass: %s - Missing ASS structs(m_track or m_renderer)", __FUNCTION__);
+    return NULL;
+  }
+
+  std::unique_ptr<RenderedFrame> frame = RenderFrame(params, pts);
+
+  CSingleLock queueLock(m_queueSection);
+  if (changes)
+    *changes = m_current && frame->sequence == m_current->sequence + 1 ? frame->changes : 2;
+
+  m_queue.clear();
+  m_params = params;
+  m_nextPts = pts + m_interval;
+  m_current = std::move(frame);
+
+  if (!IsRunning())
+    Create();
+  m_workerEvent.Set();
+
+  return m_current->GetImages();
+}
+
+void CDVDSubtitlesLibass::FlushLookAhead(double pts)
+{
+  CSingleLock lock(m_queueSection);
+  while (!m_queue.empty() && m_queue.back()->pts >= pts)
+  {
+    m_nextPts = m_queue.back()->pts;
+    m_queue.pop_back();
+  }
+
+  if (m_current && m_current->pts >= pts)
+    m_current->pts = DVD_NOPTS_VALUE;
+
+  m_workerEvent.Set();
+}
+
+void CDVDSubtitlesLibass::Process()
+{
+  while (!m_bStop)
+  {
+    bool rendered = false;
+    {
+      CSingleLock lock(m_section);
+
+      RenderParams params;
+      double pts;
+      bool render;
+      {
+        CSingleLock queueLock(m_queueSection);
+        render = m_renderer && m_track && m_interval > 0 && m_queue.size() < m_lookAhead;
+        params = m_params;
+        pts = m_nextPts;
+      }
+
+      if (render)
+      {
+        std::unique_ptr<RenderedFrame> frame = RenderFrame(params, pts);
+
+        // restarts and flushes need m_section, so the queue still continues at pts
+        CSingleLock queueLock(m_queueSection);
+        m_queue.push_back(std::move(frame));
+        m_nextPts = pts + m_interval;
+        rendered = true;
+      }
+    }
+
+    if (!rendered)
+      m_workerEvent.Wait();
+  }
+}
+
 ASS_Event* CDVDSubtitlesLibass::GetEvents()
 {
   CSingleLock lock(m_section);
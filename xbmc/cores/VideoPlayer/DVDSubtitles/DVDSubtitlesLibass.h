@@ -22,12 +22,26 @@
 
 #include "DVDResource.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
 
 #include <ass/ass.h>
 
  /** Wrapper for Libass **/
 
-class CDVDSubtitlesLibass : public IDVDResourceCounted<CDVDSubtitlesLibass>
+/*!
+ * With look-ahead enabled (advancedsettings <video><asslookahead>) a worker
+ * renders the frames following the last requested one into a bounded queue,
+ * so RenderImage usually returns without calling into libass. The interval
+ * between frames is taken from consecutive requests. A request that doesn't
+ * match the queue (seek, speed or size change) is rendered synchronously and
+ * restarts the look-ahead from there.
+ */
+class CDVDSubtitlesLibass : public IDVDResourceCounted<CDVDSubtitlesLibass>, private CThread
 {
 public:
   CDVDSubtitlesLibass();
@@ -42,10 +56,55 @@ public:
   bool DecodeDemuxPkt(char* data, int size, double start, double duration);
   bool CreateTrack(char* buf, size_t size);
 
+protected:
+  // implementation of CThread
+  void Process() override;
+
 private:
+  struct RenderParams
+  {
+    int frameWidth;
+    int frameHeight;
+    int videoWidth;
+    int videoHeight;
+    int useMargin;
+    double position;
+    double pixelRatio;
+    bool operator==(const RenderParams& other) const;
+  };
+
+  //! copy of a libass image list that stays valid across ass_render_frame calls
+  struct RenderedFrame
+  {
+    double pts;
+    RenderParams params;
+    unsigned int sequence;
+    int changes;
+    std::vector<ASS_Image> images;
+    std::vector<unsigned char> bitmaps;
+    ASS_Image* GetImages() { return images.empty() ? nullptr : images.data(); }
+  };
+
+  ASS_Image* Render(const RenderParams& params, double pts, int* changes);
+  std::unique_ptr<RenderedFrame> RenderFrame(const RenderParams& params, double pts);
+  ASS_Image* RenderImageLookAhead(const RenderParams& params, double pts, int* changes);
+  void FlushLookAhead(double pts);
+
   ASS_Library* m_library = nullptr;
   ASS_Track* m_track = nullptr;
   ASS_Renderer* m_renderer = nullptr;
   CCriticalSection m_section;
+
+  // look-ahead, m_section is always taken before m_queueSection
+  unsigned int m_lookAhead = 0;
+  CCriticalSection m_queueSection;
+  CEvent m_workerEvent;
+  std::deque<std::unique_ptr<RenderedFrame>> m_queue;
+  std::unique_ptr<RenderedFrame> m_current;
+  RenderParams m_params = {};
+  double m_nextPts;
+  double m_lastPts;
+  double m_interval = 0.0;
+  unsigned int m_sequence = 0;
 };
 
@@ -20,8 +20,14 @@
 
 #include "ProcessInfo.h"
 #include "cores/DataCacheCore.h"
+#include "cores/VideoPlayer/DVDStreamInfo.h"
 #include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <stdio.h>
 
 CCriticalSection createSection;
 std::map<std::string, CreateProcessControl> CProcessInfo::m_processControls;
@@ -80,6 +86,10 @@ void CProcessInfo::ResetVideoCodecInfo()
   m_videoHeight = 0;
   m_videoFPS = 0.0;
   m_videoDAR = 0.0;
+  m_videoDecodeTimeAvg = 0.0;
+  m_videoDecodeTimeMax = 0.0;
+  m_videoDecodeTimePeak = 0.0;
+  m_videoDecodeTimeFrames = 0;
   m_deintMethods.clear();
   m_deintMethods.push_back(EINTERLACEMETHOD::VS_INTERLACEMETHOD_NONE);
   m_deintMethodDefault = EINTERLACEMETHOD::VS_INTERLACEMETHOD_NONE;
@@ -93,6 +103,7 @@ void CProcessInfo::ResetVideoCodecInfo()
     m_dataCache->SetVideoDimensions(m_videoWidth, m_videoHeight);
     m_dataCache->SetVideoFps(m_videoFPS);
     m_dataCache->SetVideoDAR(m_videoDAR);
+    m_dataCache->SetVideoDecodeTime(m_videoDecodeTimeAvg, m_videoDecodeTimeMax);
     m_dataCache->SetStateSeeking(m_stateSeeking);
     m_dataCache->SetVideoStereoMode(m_videoStereoMode);
   }
@@ -307,6 +318,111 @@ void CProcessInfo::SetPixFormats(std::vector<AVPixelFormat> &formats)
   m_pixFormats = formats;
 }
 
+namespace
+{
+// number of the fastest cores, all of them on symmetric systems
+int GetFastCoreCount(int cpuCount)
+{
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+  std::vector<long> maxFreq;
+  for (int i = 0; i < cpuCount; i++)
+  {
+    char path[64];
+    sprintf(path, "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", i);
+    FILE* file = fopen(path, "r");
+    if (!file)
+      return cpuCount;
+
+    long freq = 0;
+    if (fscanf(file, "%ld", &freq) != 1)
+      freq = 0;
+    fclose(file);
+    maxFreq.push_back(freq);
+  }
+
+  if (maxFreq.empty())
+    return cpuCount;
+
+  long fastest = *std::max_element(maxFreq.begin(), maxFreq.end());
+  return std::count(maxFreq.begin(), maxFreq.end(), fastest);
+#else
+  return cpuCount;
+#endif
+}
+}
+
+VideoThreadingPolicy CProcessInfo::GetVideoThreadingPolicy(const CDVDStreamInfo &hints)
+{
+  VideoThreadingPolicy policy;
+
+  int cpuCount = std::max(1, g_cpuInfo.getCPUCount());
+  int threads = g_advancedSettings.m_videoDecodeThreads;
+  if (threads <= 0)
+  {
+    threads = cpuCount * 3 / 2;
+
+    // frame threads run in lockstep, on big.LITTLE the slow cores would
+    // hold back the fast ones
+    int fastCores = GetFastCoreCount(cpuCount);
+    if (fastCores < cpuCount)
+      threads = std::max(2, fastCores);
+
+    // more threads than this don't help SD, they only add delay and memory
+    if (hints.width * hints.height <= 1024 * 576)
+      threads = std::min(threads, 4);
+  }
+  policy.threads = std::max(1, std::min(threads, 16));
+
+  switch (g_advancedSettings.m_videoDecodeThreadType)
+  {
+    case 1:
+      policy.sliceThreading = false;
+      break;
+    case 2:
+      policy.sliceThreading = true;
+      break;
+    default:
+      // frame threading adds a frame of delay per thread, bad for zapping
+      policy.sliceThreading = hints.realtime;
+      break;
+  }
+
+  return policy;
+}
+
+void CProcessInfo::UpdateVideoDecodeTime(double ms)
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  if (m_videoDecodeTimeFrames == 0 && m_videoDecodeTimeAvg == 0.0)
+    m_videoDecodeTimeAvg = ms;
+  else
+    m_videoDecodeTimeAvg += (ms - m_videoDecodeTimeAvg) / 16;
+
+  m_videoDecodeTimePeak = std::max(m_videoDecodeTimePeak, ms);
+
+  // report the peak of the last 100 frames
+  if (++m_videoDecodeTimeFrames >= 100)
+  {
+    m_videoDecodeTimeMax = m_videoDecodeTimePeak;
+    m_videoDecodeTimePeak = 0.0;
+    m_videoDecodeTimeFrames = 0;
+  }
+  else
+    m_videoDecodeTimeMax = std::max(m_videoDecodeTimeMax, ms);
+
+  if (m_dataCache)
+    m_dataCache->SetVideoDecodeTime(m_videoDecodeTimeAvg, m_videoDecodeTimeMax);
+}
+
+void CProcessInfo::GetVideoDecodeTime(double &avg, double &max)
+{
+  CSingleLock lock(m_videoCodecSection);
+
+  avg = m_videoDecodeTimeAvg;
+  max = m_videoDecodeTimeMax;
+}
+
 //******************************************************************************
 // player audio info
 //******************************************************************************
@@ -318,6 +434,7 @@ void CProcessInfo::ResetAudioCodecInfo()
   m_audioChannels = "unknown";
   m_audioSampleRate = 0;;
   m_audioBitsPerSample = 0;
+  m_audioResampleLoad = 0.0f;
 
   if (m_dataCache)
   {
@@ -325,6 +442,7 @@ void CProcessInfo::ResetAudioCodecInfo()
     m_dataCache->SetAudioChannels(m_audioChannels);
     m_dataCache->SetAudioSampleRate(m_audioSampleRate);
     m_dataCache->SetAudioBitsPerSample(m_audioBitsPerSample);
+    m_dataCache->SetAudioSyncStats(SAudioSyncStats());
   }
 }
 
@@ -396,6 +514,26 @@ int CProcessInfo::GetAudioBitsPerSample()
   return m_audioBitsPerSample;
 }
 
+void CProcessInfo::SetAudioResampleLoad(float load)
+{
+  CSingleLock lock(m_audioCodecSection);
+
+  m_audioResampleLoad = load;
+}
+
+float CProcessInfo::GetAudioResampleLoad()
+{
+  CSingleLock lock(m_audioCodecSection);
+
+  return m_audioResampleLoad;
+}
+
+void CProcessInfo::SetAudioSyncStats(const SAudioSyncStats &stats)
+{
+  if (m_dataCache)
+    m_dataCache->SetAudioSyncStats(stats);
+}
+
 bool CProcessInfo::AllowDTSHDDecode()
 {
   return true;
@@ -418,6 +556,12 @@ bool CProcessInfo::IsRenderClockSync()
   return m_isClockSync;
 }
 
+void CProcessInfo::SetRenderTimings(const std::vector<float> &timings)
+{
+  if (m_dataCache)
+    m_dataCache->SetRenderTimings(timings);
+}
+
 void CProcessInfo::UpdateRenderInfo(CRenderInfo &info)
 {
   CSingleLock lock(m_renderSection);
@@ -31,6 +31,17 @@
 
 class CProcessInfo;
 class CDataCacheCore;
+struct SAudioSyncStats;
+class CDVDStreamInfo;
+
+/*!
+ * Threading setup for software video decoding
+ */
+struct VideoThreadingPolicy
+{
+  int threads = 1;
+  bool sliceThreading = false; //!< slice instead of frame threading, adds no delay
+};
 
 using CreateProcessControl = CProcessInfo* (*)();
 
@@ -68,6 +79,9 @@ public:
   CVideoBufferManager& GetVideoBufferManager();
   std::vector<AVPixelFormat> GetPixFormats();
   void SetPixFormats(std::vector<AVPixelFormat> &formats);
+  virtual VideoThreadingPolicy GetVideoThreadingPolicy(const CDVDStreamInfo &hints);
+  void UpdateVideoDecodeTime(double ms);
+  void GetVideoDecodeTime(double &avg, double &max);
 
   // player audio info
   void ResetAudioCodecInfo();
@@ -79,11 +93,15 @@ public:
   int GetAudioSampleRate();
   void SetAudioBitsPerSample(int bitsPerSample);
   int GetAudioBitsPerSample();
+  void SetAudioResampleLoad(float load);
+  float GetAudioResampleLoad();
+  void SetAudioSyncStats(const SAudioSyncStats &stats);
   virtual bool AllowDTSHDDecode();
 
   // render info
   void SetRenderClockSync(bool enabled);
   bool IsRenderClockSync();
+  void SetRenderTimings(const std::vector<float> &timings);
   void UpdateRenderInfo(CRenderInfo &info);
   void UpdateRenderBuffers(int queued, int discard, int free);
   void GetRenderBuffers(int &queued, int &discard, int &free);
@@ -136,12 +154,17 @@ protected:
   CCriticalSection m_videoCodecSection;
   CVideoBufferManager m_videoBufferManager;
   std::vector<AVPixelFormat> m_pixFormats;
+  double m_videoDecodeTimeAvg;
+  double m_videoDecodeTimeMax;
+  double m_videoDecodeTimePeak;
+  int m_videoDecodeTimeFrames;
 
   // player audio info
   std::string m_audioDecoderName;
   std::string m_audioChannels;
   int m_audioSampleRate;
   int m_audioBitsPerSample;
+  float m_audioResampleLoad = 0.0f; // time spent resampling per time of audio
   CCriticalSection m_audioCodecSection;
 
   // render info
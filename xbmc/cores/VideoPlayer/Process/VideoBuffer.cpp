@@ -20,8 +20,18 @@
 
 #include "VideoBuffer.h"
 #include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
 #include <string.h>
 
+#if defined(TARGET_LINUX)
+#include <sys/mman.h>
+#endif
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 //-----------------------------------------------------------------------------
 // CVideoBuffer
 //-----------------------------------------------------------------------------
@@ -58,125 +68,108 @@ AVPixelFormat CVideoBuffer::GetFormat()
   return m_pixFormat;
 }
 
-bool CVideoBuffer::CopyPicture(YuvImage* pDst, YuvImage *pSrc)
+namespace
 {
-  uint8_t *s = pSrc->plane[0];
-  uint8_t *d = pDst->plane[0];
-  int w = pDst->width * pDst->bpp;
-  int h = pDst->height;
-  if ((w == pSrc->stride[0]) && (pSrc->stride[0] == pDst->stride[0]))
-  {
-    memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      memcpy(d, s, w);
-      s += pSrc->stride[0];
-      d += pDst->stride[0];
-    }
-  }
-  s = pSrc->plane[1];
-  d = pDst->plane[1];
-  w =(pDst->width  >> pDst->cshift_x) * pDst->bpp;
-  h =(pDst->height >> pDst->cshift_y);
-  if ((w == pSrc->stride[1]) && (pSrc->stride[1] == pDst->stride[1]))
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+void CopyRowStream(uint8_t *d, const uint8_t *s, int w)
+{
+  // stores must be aligned, the source may not be
+  int head = (16 - (reinterpret_cast<uintptr_t>(d) & 15)) & 15;
+  if (head > w)
+    head = w;
+  memcpy(d, s, head);
+  d += head;
+  s += head;
+  w -= head;
+
+  for (; w >= 64; w -= 64, d += 64, s += 64)
   {
-    memcpy(d, s, w*h);
+    __m128i x0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+    __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16));
+    __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32));
+    __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 48));
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d), x0);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 16), x1);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 32), x2);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d + 48), x3);
   }
-  else
+
+  for (; w >= 16; w -= 16, d += 16, s += 16)
+    _mm_stream_si128(reinterpret_cast<__m128i*>(d),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(s)));
+
+  memcpy(d, s, w);
+}
+#endif
+
+}
+
+void CVideoBuffer::CopyPlane(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride,
+                             int width, int height, bool streaming)
+{
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+  // write combined memory is slow to write with the partial stores memcpy uses for
+  // small rows and is never read back by the cpu, bypass the cache for it
+  if (streaming && (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2))
   {
-    for (int y = 0; y < h; y++)
+    for (int y = 0; y < height; y++)
     {
-      memcpy(d, s, w);
-      s += pSrc->stride[1];
-      d += pDst->stride[1];
+      CopyRowStream(dst, src, width);
+      src += srcStride;
+      dst += dstStride;
     }
+    _mm_sfence();
+    return;
   }
-  s = pSrc->plane[2];
-  d = pDst->plane[2];
-  if ((w == pSrc->stride[2]) && (pSrc->stride[2] == pDst->stride[2]))
+#endif
+
+  if ((width == srcStride) && (srcStride == dstStride))
   {
-    memcpy(d, s, w*h);
+    memcpy(dst, src, width * height);
   }
   else
   {
-    for (int y = 0; y < h; y++)
+    for (int y = 0; y < height; y++)
     {
-      memcpy(d, s, w);
-      s += pSrc->stride[2];
-      d += pDst->stride[2];
+      memcpy(dst, src, width);
+      src += srcStride;
+      dst += dstStride;
     }
   }
-  return true;
 }
 
-
-bool CVideoBuffer::CopyNV12Picture(YuvImage* pDst, YuvImage *pSrc)
+bool CVideoBuffer::CopyPicture(YuvImage* pDst, YuvImage *pSrc, bool streaming)
 {
-  uint8_t *s = pSrc->plane[0];
-  uint8_t *d = pDst->plane[0];
-  int w = pDst->width;
+  int w = pDst->width * pDst->bpp;
   int h = pDst->height;
+  CopyPlane(pDst->plane[0], pDst->stride[0], pSrc->plane[0], pSrc->stride[0], w, h, streaming);
+
+  w = (pDst->width  >> pDst->cshift_x) * pDst->bpp;
+  h = (pDst->height >> pDst->cshift_y);
+  CopyPlane(pDst->plane[1], pDst->stride[1], pSrc->plane[1], pSrc->stride[1], w, h, streaming);
+  CopyPlane(pDst->plane[2], pDst->stride[2], pSrc->plane[2], pSrc->stride[2], w, h, streaming);
+  return true;
+}
+
+bool CVideoBuffer::CopyNV12Picture(YuvImage* pDst, YuvImage *pSrc, bool streaming)
+{
   // Copy Y
-  if ((w == pSrc->stride[0]) && (pSrc->stride[0] == pDst->stride[0]))
-  {
-    memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      memcpy(d, s, w);
-      s += pSrc->stride[0];
-      d += pDst->stride[0];
-    }
-  }
+  CopyPlane(pDst->plane[0], pDst->stride[0], pSrc->plane[0], pSrc->stride[0],
+            pDst->width, pDst->height, streaming);
 
-  s = pSrc->plane[1];
-  d = pDst->plane[1];
-  w = pDst->width;
-  h = pDst->height >> 1;
   // Copy packed UV (width is same as for Y as it's both U and V components)
-  if ((w == pSrc->stride[1]) && (pSrc->stride[1] == pDst->stride[1]))
-  {
-    memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      memcpy(d, s, w);
-      s += pSrc->stride[1];
-      d += pDst->stride[1];
-    }
-  }
+  CopyPlane(pDst->plane[1], pDst->stride[1], pSrc->plane[1], pSrc->stride[1],
+            pDst->width, pDst->height >> 1, streaming);
 
   return true;
 }
 
-bool CVideoBuffer::CopyYUV422PackedPicture(YuvImage* pDst, YuvImage *pSrc)
+bool CVideoBuffer::CopyYUV422PackedPicture(YuvImage* pDst, YuvImage *pSrc, bool streaming)
 {
-  uint8_t *s = pSrc->plane[0];
-  uint8_t *d = pDst->plane[0];
-  int w = pDst->width;
-  int h = pDst->height;
-
   // Copy YUYV
-  if ((w * 2 == pSrc->stride[0]) && (pSrc->stride[0] == pDst->stride[0]))
-  {
-    memcpy(d, s, w*h*2);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      memcpy(d, s, w*2);
-      s += pSrc->stride[0];
-      d += pDst->stride[0];
-    }
-  }
+  CopyPlane(pDst->plane[0], pDst->stride[0], pSrc->plane[0], pSrc->stride[0],
+            pDst->width * 2, pDst->height, streaming);
 
   return true;
 }
@@ -191,6 +184,13 @@ CVideoBufferSysMem::CVideoBufferSysMem(IVideoBufferPool &pool, int id, AVPixelFo
 
 CVideoBufferSysMem::~CVideoBufferSysMem()
 {
+#if defined(TARGET_LINUX)
+  if (m_mapped)
+  {
+    munmap(m_data, m_size);
+    return;
+  }
+#endif
   delete[] m_data;
 }
 
@@ -277,6 +277,22 @@ void CVideoBufferSysMem::SetDimensions(int width, int height, const int (&stride
 
 bool CVideoBufferSysMem::Alloc()
 {
+#if defined(TARGET_LINUX) && defined(MADV_HUGEPAGE)
+  // frames of HD and above are backed by transparent huge pages if the kernel
+  // allows it, this saves most of the page faults and tlb misses
+  if (m_size >= 2 * 1024 * 1024)
+  {
+    void *data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data != MAP_FAILED)
+    {
+      madvise(data, m_size, MADV_HUGEPAGE);
+      m_data = static_cast<uint8_t*>(data);
+      m_mapped = true;
+      return true;
+    }
+  }
+#endif
+
   m_data = new uint8_t[m_size];
   return true;
 }
@@ -375,6 +391,30 @@ void CVideoBufferPoolSysMem::Discard(CVideoBufferManager *bm, ReadyToDispose cb)
     (m_bm->*m_cbDispose)(this);
 }
 
+void CVideoBufferPoolSysMem::Preallocate(int count)
+{
+  CSingleLock lock(m_critSection);
+
+  while (static_cast<int>(m_all.size()) < count)
+  {
+    int id = m_all.size();
+    CVideoBufferSysMem *buf = new CVideoBufferSysMem(*this, id, m_pixFormat, m_size);
+    buf->Alloc();
+    // fault the pages in now instead of while the first frames are decoded
+    memset(buf->GetMemPtr(), 0, m_size);
+    m_all.push_back(buf);
+    m_free.push_back(id);
+  }
+}
+
+bool CVideoBufferPoolSysMem::Reuse()
+{
+  CSingleLock lock(m_critSection);
+
+  m_bm = nullptr;
+  return true;
+}
+
 std::shared_ptr<IVideoBufferPool> CVideoBufferPoolSysMem::CreatePool()
 {
   return std::make_shared<CVideoBufferPoolSysMem>();
@@ -441,6 +481,8 @@ void CVideoBufferManager::ReadyForDisposal(IVideoBufferPool *pool)
     if ((*it).get() == pool)
     {
       pool->Released(*this);
+      if (pool->Reuse())
+        m_sparePool = *it;
       m_discardedPools.erase(it);
       break;
     }
@@ -450,6 +492,28 @@ void CVideoBufferManager::ReadyForDisposal(IVideoBufferPool *pool)
 CVideoBuffer* CVideoBufferManager::Get(AVPixelFormat format, int size, IVideoBufferPool **pPool)
 {
   CSingleLock lock(m_critSection);
+
+  std::shared_ptr<IVideoBufferPool> pool = GetPool(format, size, pPool);
+  if (!pool)
+    return nullptr;
+
+  return pool->Get();
+}
+
+void CVideoBufferManager::Preallocate(AVPixelFormat format, int size, int count)
+{
+  CSingleLock lock(m_critSection);
+
+  std::shared_ptr<IVideoBufferPool> pool = GetPool(format, size, nullptr);
+  if (!pool)
+    return;
+
+  CLog::Log(LOGDEBUG, "CVideoBufferManager::Preallocate - %d buffers of %d bytes", count, size);
+  pool->Preallocate(count);
+}
+
+std::shared_ptr<IVideoBufferPool> CVideoBufferManager::GetPool(AVPixelFormat format, int size, IVideoBufferPool **pPool)
+{
   for (auto pool: m_pools)
   {
     if (!pool->IsConfigured())
@@ -458,7 +522,21 @@ CVideoBuffer* CVideoBufferManager::Get(AVPixelFormat format, int size, IVideoBuf
     }
     if (pool->IsCompatible(format, size))
     {
-      return pool->Get();
+      return pool;
+    }
+  }
+
+  // the pool of the previous stream, e.g. the last item of a playlist
+  if (m_sparePool)
+  {
+    std::shared_ptr<IVideoBufferPool> pool = m_sparePool;
+    m_sparePool.reset();
+    if (pool->IsCompatible(format, size))
+    {
+      m_pools.push_front(pool);
+      if (pPool)
+        *pPool = pool.get();
+      return pool;
     }
   }
 
@@ -469,7 +547,7 @@ CVideoBuffer* CVideoBufferManager::Get(AVPixelFormat format, int size, IVideoBuf
     pool->Configure(format, size);
     if (pPool)
       *pPool = pool.get();
-    return pool->Get();
+    return pool;
   }
   return nullptr;
 }
@@ -89,6 +89,13 @@ public:
   // pool calls back when all buffers are back home
   virtual void Discard(CVideoBufferManager *bm, ReadyToDispose cb) { (bm->*cb)(this); };
 
+  // allocate buffers up front until the pool holds count of them
+  virtual void Preallocate(int count) {};
+
+  // called by BM after the pool was released, return true if the pool can hand
+  // out buffers again. BM keeps it for the next compatible stream
+  virtual bool Reuse() { return false; };
+
   // call on Get() before returning buffer to caller
   std::shared_ptr<IVideoBufferPool> GetPtr() { return shared_from_this(); };
 };
@@ -110,9 +117,16 @@ public:
   virtual void SetDimensions(int width, int height, const int (&strides)[YuvImage::MAX_PLANES]) {};
   virtual void SetDimensions(int width, int height, const int (&strides)[YuvImage::MAX_PLANES], const int (&planeOffsets)[YuvImage::MAX_PLANES]) {};
 
-  static bool CopyPicture(YuvImage* pDst, YuvImage *pSrc);
-  static bool CopyNV12Picture(YuvImage* pDst, YuvImage *pSrc);
-  static bool CopyYUV422PackedPicture(YuvImage* pDst, YuvImage *pSrc);
+  /*!
+   * \brief copy pictures between images of the same dimensions
+   * \param streaming the destination is write combined memory, e.g. a mapped pixel
+   * buffer object, rows are written with non temporal stores where the cpu supports it
+   */
+  static bool CopyPicture(YuvImage* pDst, YuvImage *pSrc, bool streaming = false);
+  static bool CopyNV12Picture(YuvImage* pDst, YuvImage *pSrc, bool streaming = false);
+  static bool CopyYUV422PackedPicture(YuvImage* pDst, YuvImage *pSrc, bool streaming = false);
+  static void CopyPlane(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride,
+                        int width, int height, bool streaming = false);
 
 protected:
   explicit CVideoBuffer(int id);
@@ -139,6 +153,7 @@ protected:
   int m_height = 0;
   int m_size = 0;
   uint8_t *m_data = nullptr;
+  bool m_mapped = false;
   YuvImage m_image;
 };
 
@@ -156,6 +171,8 @@ public:
   bool IsConfigured() override;
   bool IsCompatible(AVPixelFormat format, int size) override;
   void Discard(CVideoBufferManager *bm, ReadyToDispose cb) override;
+  void Preallocate(int count) override;
+  bool Reuse() override;
 
   static std::shared_ptr<IVideoBufferPool> CreatePool();
 
@@ -191,10 +208,20 @@ public:
   CVideoBuffer* Get(AVPixelFormat format, int size, IVideoBufferPool **pPool);
   void ReadyForDisposal(IVideoBufferPool *pool);
 
+  /*!
+   * \brief warm up the pool serving format and size
+   * \param count number of buffers the decoder is expected to hold at once,
+   * i.e. its reference frames plus the render queue
+   */
+  void Preallocate(AVPixelFormat format, int size, int count);
+
 protected:
+  std::shared_ptr<IVideoBufferPool> GetPool(AVPixelFormat format, int size, IVideoBufferPool **pPool);
+
   CCriticalSection m_critSection;
   std::list<std::shared_ptr<IVideoBufferPool>> m_pools;
   std::list<std::shared_ptr<IVideoBufferPool>> m_discardedPools;
+  std::shared_ptr<IVideoBufferPool> m_sparePool; // released pool kept for the next stream
   std::map<std::string, CreatePoolFunc> m_poolFactories;
 
 private:
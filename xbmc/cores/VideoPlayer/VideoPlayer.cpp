@@ -35,6 +35,7 @@
 #include "DVDDemuxers/DVDDemuxVobsub.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
 #include "DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "DVDDemuxers/DemuxReadAhead.h"
 
 #include "DVDFileInfo.h"
 
@@ -64,6 +65,7 @@
 #include "utils/log.h"
 #include "utils/StreamDetails.h"
 #include "utils/StreamUtils.h"
+#include "utils/Trace.h"
 #include "utils/Variant.h"
 #include "storage/MediaManager.h"
 #include "dialogs/GUIDialogKaiToast.h"
@@ -733,6 +735,7 @@ bool CVideoPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options
   m_playerOptions = options;
   // Try to resolve the correct mime type
   m_item.SetMimeTypeForInternetFile();
+  ResetNextFile();
 
   m_processInfo->SetPlayTimes(0,0,0,0);
   m_bAbortRequest = false;
@@ -764,6 +767,12 @@ bool CVideoPlayer::CloseFile(bool reopen)
   if(m_pInputStream)
     m_pInputStream->Abort();
 
+  {
+    CSingleLock lock(m_nextFileSection);
+    if (m_nextFile.inputStream)
+      m_nextFile.inputStream->Abort();
+  }
+
   CLog::Log(LOGNOTICE, "VideoPlayer: waiting for threads to exit");
 
   // wait for the main thread to finish up
@@ -785,6 +794,23 @@ bool CVideoPlayer::CloseFile(bool reopen)
   return true;
 }
 
+bool CVideoPlayer::QueueNextFile(const CFileItem &file)
+{
+  CSingleLock lock(m_nextFileSection);
+
+  // only accept what was asked for, the application advances the playlist
+  // on its own if the item is declined
+  if (!m_nextFile.requested || m_nextFile.queued)
+    return false;
+
+  CLog::Log(LOGDEBUG, "CVideoPlayer::QueueNextFile - %s", CURL::GetRedacted(file.GetPath()).c_str());
+
+  m_nextFile.item = file;
+  m_nextFile.item.SetMimeTypeForInternetFile();
+  m_nextFile.queued = true;
+  return true;
+}
+
 bool CVideoPlayer::IsPlaying() const
 {
   return !m_bStop;
@@ -817,17 +843,27 @@ bool CVideoPlayer::OpenInputStream()
     m_item.SetPath(g_mediaManager.TranslateDevicePath(""));
   }
 
-  m_pInputStream = CDVDFactoryInputStream::CreateInputStream(this, m_item, true);
-  if(m_pInputStream == NULL)
+  // take over a stream opened ahead of time by PreOpenNextFile
   {
-    CLog::Log(LOGERROR, "CVideoPlayer::OpenInputStream - unable to create input stream for [%s]", CURL::GetRedacted(m_item.GetPath()).c_str());
-    return false;
+    CSingleLock lock(m_nextFileSection);
+    if (m_nextFile.demuxer && m_nextFile.item.IsSamePath(&m_item))
+      m_pInputStream = std::move(m_nextFile.inputStream);
   }
 
-  if (!m_pInputStream->Open())
+  if (!m_pInputStream)
   {
-    CLog::Log(LOGERROR, "CVideoPlayer::OpenInputStream - error opening [%s]", CURL::GetRedacted(m_item.GetPath()).c_str());
-    return false;
+    m_pInputStream = CDVDFactoryInputStream::CreateInputStream(this, m_item, true);
+    if(m_pInputStream == NULL)
+    {
+      CLog::Log(LOGERROR, "CVideoPlayer::OpenInputStream - unable to create input stream for [%s]", CURL::GetRedacted(m_item.GetPath()).c_str());
+      return false;
+    }
+
+    if (!m_pInputStream->Open())
+    {
+      CLog::Log(LOGERROR, "CVideoPlayer::OpenInputStream - error opening [%s]", CURL::GetRedacted(m_item.GetPath()).c_str());
+      return false;
+    }
   }
 
   // find any available external subtitles for non dvd files
@@ -886,8 +922,18 @@ bool CVideoPlayer::OpenDemuxStream()
 
   CLog::Log(LOGNOTICE, "Creating Demuxer");
 
+  // the input stream was taken over from the next file, so is its demuxer
+  {
+    CSingleLock lock(m_nextFileSection);
+    if (m_nextFile.demuxer && !m_nextFile.inputStream)
+    {
+      m_pDemuxer = m_nextFile.demuxer;
+      m_nextFile.demuxer = nullptr;
+    }
+  }
+
   int attempts = 10;
-  while (!m_bStop && attempts-- > 0)
+  while (!m_pDemuxer && !m_bStop && attempts-- > 0)
   {
     m_pDemuxer = CDVDFactoryDemuxer::CreateDemuxer(m_pInputStream);
     if(!m_pDemuxer && m_pInputStream->IsStreamType(DVDSTREAM_TYPE_PVRMANAGER))
@@ -908,6 +954,14 @@ bool CVideoPlayer::OpenDemuxStream()
     return false;
   }
 
+  // read remote files on a separate thread, so stalling reads don't hold
+  // up dispatching of packets already demuxed
+  if (g_advancedSettings.m_cacheDemuxReadAhead > 0 &&
+      m_pInputStream->IsStreamType(DVDSTREAM_TYPE_FILE) &&
+      URIUtils::IsRemote(m_pInputStream->GetFileName()) &&
+      dynamic_cast<CDVDDemuxFFmpeg*>(m_pDemuxer))
+    m_pDemuxer = new CDemuxReadAhead(m_pDemuxer, g_advancedSettings.m_cacheDemuxReadAhead);
+
   m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_DEMUX);
   m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_NAV);
   m_SelectionStreams.Update(m_pInputStream, m_pDemuxer);
@@ -924,6 +978,132 @@ bool CVideoPlayer::OpenDemuxStream()
   return true;
 }
 
+void CVideoPlayer::SwitchFile(const CFileItem &item, const CPlayerOptions &options)
+{
+  IPlayerCallback *cb = &m_callback;
+  CFileItem fileItem(m_item);
+  UpdateFileItemStreamDetails(fileItem);
+  CVideoSettings vs = m_processInfo->GetVideoSettings();
+  m_outboundEvents->Submit([=]() {
+    cb->StoreVideoSettings(fileItem, vs);
+  });
+
+  CBookmark bookmark;
+  bookmark.totalTimeInSeconds = m_processInfo->GetMaxTime() / 1000;
+  bookmark.timeInSeconds = GetTime() / 1000;
+  bookmark.player = m_name;
+  bookmark.playerState = GetPlayerState();
+  m_outboundEvents->Submit([=]() {
+    cb->OnPlayerCloseFile(fileItem, bookmark);
+  });
+
+  m_item = item;
+  m_playerOptions = options;
+
+  m_processInfo->SetPlayTimes(0,0,0,0);
+
+  m_outboundEvents->Submit([this]() {
+    m_callback.OnPlayBackStarted(m_item);
+  });
+
+  FlushBuffers(DVD_NOPTS_VALUE, true, true);
+  m_renderManager.Flush(false);
+  SAFE_DELETE(m_pDemuxer);
+  SAFE_DELETE(m_pSubtitleDemuxer);
+  SAFE_DELETE(m_pCCDemuxer);
+  if (m_pInputStream.use_count() > 1)
+    throw std::runtime_error("m_pInputStream reference count is greater than 1");
+  m_pInputStream.reset();
+
+  m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_NONE);
+
+  Prepare();
+
+  // anything not taken over by Prepare belongs to a different file
+  ResetNextFile();
+}
+
+void CVideoPlayer::PreOpenNextFile()
+{
+  CFileItem item;
+  {
+    CSingleLock lock(m_nextFileSection);
+    if (!m_nextFile.queued || m_nextFile.inputStream)
+      return;
+    item = m_nextFile.item;
+  }
+
+  // discs, stacks and live tv have their own ways of starting, leave those
+  // to the regular open after playback ended
+  if (item.IsDiscStub() || item.IsDVDFile() || item.IsBDFile() || item.IsStack() ||
+      item.IsPVR() || item.IsInternetStream())
+  {
+    ResetNextFile();
+    return;
+  }
+
+  CLog::Log(LOGNOTICE, "CVideoPlayer::PreOpenNextFile - %s", CURL::GetRedacted(item.GetPath()).c_str());
+
+  std::shared_ptr<CDVDInputStream> inputStream = CDVDFactoryInputStream::CreateInputStream(this, item, true);
+  if (!inputStream || !inputStream->IsStreamType(DVDSTREAM_TYPE_FILE))
+  {
+    ResetNextFile();
+    return;
+  }
+
+  // publish the stream before opening, so CloseFile can abort a stalling open
+  {
+    CSingleLock lock(m_nextFileSection);
+    m_nextFile.inputStream = inputStream;
+  }
+
+  CDVDDemux *demuxer = nullptr;
+  if (inputStream->Open())
+    demuxer = CDVDFactoryDemuxer::CreateDemuxer(inputStream);
+
+  if (!demuxer || m_bAbortRequest)
+  {
+    CLog::Log(LOGERROR, "CVideoPlayer::PreOpenNextFile - failed to open %s", CURL::GetRedacted(item.GetPath()).c_str());
+    delete demuxer;
+    ResetNextFile();
+    return;
+  }
+
+  CSingleLock lock(m_nextFileSection);
+  m_nextFile.demuxer = demuxer;
+}
+
+bool CVideoPlayer::OpenNextFile()
+{
+  CFileItem item;
+  {
+    CSingleLock lock(m_nextFileSection);
+    if (!m_nextFile.demuxer)
+      return false;
+    item = m_nextFile.item;
+  }
+
+  CLog::Log(LOGNOTICE, "VideoPlayer: switching to next file %s", CURL::GetRedacted(item.GetPath()).c_str());
+
+  CPlayerOptions options;
+  options.fullscreen = m_playerOptions.fullscreen;
+  SwitchFile(item, options);
+  return true;
+}
+
+void CVideoPlayer::ResetNextFile()
+{
+  CSingleLock lock(m_nextFileSection);
+
+  // the demuxer holds a reference to the input stream
+  delete m_nextFile.demuxer;
+  m_nextFile.demuxer = nullptr;
+  m_nextFile.inputStream.reset();
+  m_nextFile.item.Reset();
+  m_nextFile.requested = false;
+  m_nextFile.queued = false;
+}
+
 void CVideoPlayer::CloseDemuxer()
 {
   delete m_pDemuxer;
@@ -1392,6 +1572,13 @@ void CVideoPlayer::Process()
 
   while (!m_bAbortRequest)
   {
+    CTraceScope trace("player", "CVideoPlayer::Process");
+    if (CTrace::IsRunning())
+    {
+      CTrace::Counter("audio queue level", m_VideoPlayerAudio->GetLevel());
+      CTrace::Counter("video queue level", m_processInfo->GetLevelVQ());
+    }
+
 #ifdef TARGET_RASPBERRY_PI
     if (m_omxplayer_mode && OMXDoProcessing(m_OmxPlayerState, m_playSpeed, m_VideoPlayerVideo, m_VideoPlayerAudio, m_CurrentAudio, m_CurrentVideo, m_HasVideo, m_HasAudio, *m_processInfo))
     {
@@ -1574,6 +1761,21 @@ void CVideoPlayer::Process()
       // if we are caching, start playing it again
       SetCaching(CACHESTATE_DONE);
 
+      // ask for the next playlist item and open it while the queues drain
+      if (g_advancedSettings.m_videoPreOpenNext && !m_omxplayer_mode &&
+          m_pInputStream->IsStreamType(DVDSTREAM_TYPE_FILE))
+      {
+        bool request = false;
+        {
+          CSingleLock lock(m_nextFileSection);
+          if (!m_nextFile.requested)
+            request = m_nextFile.requested = true;
+        }
+        if (request)
+          m_callback.OnQueueNextItem();
+        PreOpenNextFile();
+      }
+
       // while players are still playing, keep going to allow seekbacks
       if (m_VideoPlayerAudio->HasData() ||
           m_VideoPlayerVideo->HasData())
@@ -1592,6 +1794,9 @@ void CVideoPlayer::Process()
       if (!m_pInputStream->IsEOF())
         CLog::Log(LOGINFO, "%s - eof reading from demuxer", __FUNCTION__);
 
+      if (OpenNextFile())
+        continue;
+
       break;
     }
 
@@ -2508,6 +2713,7 @@ void CVideoPlayer::OnExit()
   });
     
   // destroy objects
+  ResetNextFile();
   SAFE_DELETE(m_pDemuxer);
   SAFE_DELETE(m_pSubtitleDemuxer);
   SAFE_DELETE(m_pCCDemuxer);
@@ -2553,44 +2759,8 @@ void CVideoPlayer::HandleMessages()
     {
       CDVDMsgOpenFile &msg(*static_cast<CDVDMsgOpenFile*>(pMsg));
 
-      IPlayerCallback *cb = &m_callback;
-      CFileItem fileItem(m_item);
-      UpdateFileItemStreamDetails(fileItem);
-      CVideoSettings vs = m_processInfo->GetVideoSettings();
-      m_outboundEvents->Submit([=]() {
-        cb->StoreVideoSettings(fileItem, vs);
-      });
-
-      CBookmark bookmark;
-      bookmark.totalTimeInSeconds = m_processInfo->GetMaxTime() / 1000;
-      bookmark.timeInSeconds = GetTime() / 1000;
-      bookmark.player = m_name;
-      bookmark.playerState = GetPlayerState();
-      m_outboundEvents->Submit([=]() {
-        cb->OnPlayerCloseFile(fileItem, bookmark);
-      });
-
-      m_item = msg.GetItem();
-      m_playerOptions = msg.GetOptions();
-
-      m_processInfo->SetPlayTimes(0,0,0,0);
-
-      m_outboundEvents->Submit([this]() {
-        m_callback.OnPlayBackStarted(m_item);
-      });
-
-      FlushBuffers(DVD_NOPTS_VALUE, true, true);
-      m_renderManager.Flush(false);
-      SAFE_DELETE(m_pDemuxer);
-      SAFE_DELETE(m_pSubtitleDemuxer);
-      SAFE_DELETE(m_pCCDemuxer);
-      if (m_pInputStream.use_count() > 1)
-        throw std::runtime_error("m_pInputStream reference count is greater than 1");
-      m_pInputStream.reset();
-
-      m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_NONE);
-
-      Prepare();
+      ResetNextFile();
+      SwitchFile(msg.GetItem(), msg.GetOptions());
     }
     else if (pMsg->IsType(CDVDMsg::PLAYER_SEEK) &&
         m_messenger.GetPacketCount(CDVDMsg::PLAYER_SEEK) == 0 &&
@@ -3412,7 +3582,7 @@ bool CVideoPlayer::SeekTimeRelative(int64_t iTime)
   mode.time = (int)iTime;
   mode.relative = true;
   mode.backward = (iTime < 0) ? true : false;
-  mode.accurate = false;
+  mode.accurate = g_advancedSettings.m_videoAccurateSeek;
   mode.trickplay = false;
   mode.sync = true;
 
@@ -3423,6 +3593,22 @@ bool CVideoPlayer::SeekTimeRelative(int64_t iTime)
   return true;
 }
 
+bool CVideoPlayer::SeekTimePreview(int64_t iTime)
+{
+  // keyframe only, the final seek issued when the user is done is the accurate one
+  CDVDMsgPlayerSeek::CMode mode;
+  mode.time = static_cast<double>(iTime);
+  mode.backward = true;
+  mode.accurate = false;
+  mode.restore = false;
+  mode.trickplay = true;
+  mode.sync = true;
+
+  m_messenger.Put(new CDVDMsgPlayerSeek(mode));
+  m_processInfo->SetStateSeeking(true);
+  return true;
+}
+
 // return the time in milliseconds
 int64_t CVideoPlayer::GetTime()
 {
@@ -4807,6 +4993,16 @@ void CVideoPlayer::Render(bool clear, uint32_t alpha, bool gui)
   m_renderManager.Render(clear, 0, alpha, gui);
 }
 
+void CVideoPlayer::BeginGuiRender()
+{
+  m_renderManager.BeginGuiRender();
+}
+
+void CVideoPlayer::EndGuiRender()
+{
+  m_renderManager.EndGuiRender();
+}
+
 void CVideoPlayer::FlushRenderer()
 {
   m_renderManager.Flush(true);
@@ -4879,6 +5075,11 @@ bool CVideoPlayer::RenderCaptureGetPixels(unsigned int captureId, unsigned int m
   return m_renderManager.RenderCaptureGetPixels(captureId, millis, buffer, size);
 }
 
+void CVideoPlayer::RenderCaptureSetCallback(unsigned int captureId, IRenderCaptureCallback* callback)
+{
+  m_renderManager.SetRenderCaptureCallback(captureId, callback);
+}
+
 void CVideoPlayer::VideoParamsChange()
 {
   m_messenger.Put(new CDVDMsg(CDVDMsg::PLAYER_AVCHANGE));
@@ -4916,6 +5117,11 @@ void CVideoPlayer::UpdateVideoRender(bool video)
   m_processInfo->SetVideoRender(video);
 }
 
+void CVideoPlayer::UpdateRenderTimings(const std::vector<float> &timings)
+{
+  m_processInfo->SetRenderTimings(timings);
+}
+
 // IDispResource interface
 void CVideoPlayer::OnLostDisplay()
 {
@@ -294,6 +294,7 @@ public:
   ~CVideoPlayer() override;
   bool OpenFile(const CFileItem& file, const CPlayerOptions &options) override;
   bool CloseFile(bool reopen = false) override;
+  bool QueueNextFile(const CFileItem &file) override;
   bool IsPlaying() const override;
   void Pause() override;
   bool HasVideo() const override;
@@ -351,6 +352,7 @@ public:
 
   void SeekTime(int64_t iTime) override;
   bool SeekTimeRelative(int64_t iTime) override;
+  bool SeekTimePreview(int64_t iTime) override;
   void SetSpeed(float speed) override;
   void SetTempo(float tempo) override;
   bool SupportsTempo() override;
@@ -364,6 +366,8 @@ public:
 
   void FrameMove() override;
   void Render(bool clear, uint32_t alpha = 255, bool gui = true) override;
+  void BeginGuiRender() override;
+  void EndGuiRender() override;
   void FlushRenderer() override;
   void SetRenderViewMode(int mode, float zoom, float par, float shift, bool stretch) override;
   float GetRenderAspectRatio() override;
@@ -378,6 +382,7 @@ public:
   void RenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags) override;
   void RenderCaptureRelease(unsigned int captureId) override;
   bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size) override;
+  void RenderCaptureSetCallback(unsigned int captureId, IRenderCaptureCallback* callback) override;
 
   // IDispResource interface
   void OnLostDisplay() override;
@@ -407,6 +412,7 @@ protected:
   void UpdateRenderBuffers(int queued, int discard, int free) override;
   void UpdateGuiRender(bool gui) override;
   void UpdateVideoRender(bool video) override;
+  void UpdateRenderTimings(const std::vector<float> &timings) override;
 
   void CreatePlayers();
   void DestroyPlayers();
@@ -479,6 +485,11 @@ protected:
   bool OpenInputStream();
   bool OpenDemuxStream();
   void CloseDemuxer();
+  void SwitchFile(const CFileItem &item, const CPlayerOptions &options);
+
+  void PreOpenNextFile();
+  bool OpenNextFile();
+  void ResetNextFile();
   void OpenDefaultStreams(bool reset = true);
 
   void UpdatePlayState(double timeout);
@@ -555,6 +566,17 @@ protected:
   CDVDDemux* m_pSubtitleDemuxer;
   CDVDDemuxCC* m_pCCDemuxer;
 
+  // next playlist item, opened while the queues of the current one drain
+  struct SNextFile
+  {
+    CFileItem item;
+    bool requested = false;
+    bool queued = false;
+    std::shared_ptr<CDVDInputStream> inputStream;
+    CDVDDemux* demuxer = nullptr;
+  } m_nextFile;
+  CCriticalSection m_nextFileSection;
+
   CRenderManager m_renderManager;
 
   struct SDVDInfo
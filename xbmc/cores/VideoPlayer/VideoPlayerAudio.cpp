@@ -30,6 +30,7 @@
 #include "utils/MathUtils.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/DataCacheCore.h"
 #ifdef TARGET_RASPBERRY_PI
 #include "platform/linux/RBP.h"
 #endif
@@ -38,6 +39,11 @@
 #include <iomanip>
 #include <math.h>
 
+// the windows hold about two minutes of audio frames
+#define SYNCSTATS_WINDOW 4096
+// below this much buffered audio the sink is about to run dry
+#define UNDERRUN_CACHE_TIME 0.01
+
 class CDVDMsgAudioCodecChange : public CDVDMsg
 {
 public:
@@ -60,6 +66,9 @@ CVideoPlayerAudio::CVideoPlayerAudio(CDVDClock* pClock, CDVDMessageQueue& parent
 , m_messageQueue("audio")
 , m_messageParent(parent)
 , m_audioSink(pClock)
+, m_delayHistogram(1.0, 1000, SYNCSTATS_WINDOW)
+, m_errorHistogram(0.25, 400, SYNCSTATS_WINDOW)
+, m_correctionHistogram(50.0, 1000, SYNCSTATS_WINDOW)
 {
   m_pClock = pClock;
   m_pAudioCodec = NULL;
@@ -76,6 +85,7 @@ CVideoPlayerAudio::CVideoPlayerAudio(CDVDClock* pClock, CDVDMessageQueue& parent
 
   m_messageQueue.SetMaxDataSize(6 * 1024 * 1024);
   m_messageQueue.SetMaxTimeSize(8.0);
+  m_messageQueue.SetPacketRingSize(2048);
 }
 
 CVideoPlayerAudio::~CVideoPlayerAudio()
@@ -155,6 +165,12 @@ void CVideoPlayerAudio::OpenStream(CDVDStreamInfo &hints, CDVDAudioCodec* codec)
 
   m_maxspeedadjust = 5.0;
 
+  m_delayHistogram.Reset();
+  m_errorHistogram.Reset();
+  m_correctionHistogram.Reset();
+  m_underruns = 0;
+  m_underrun = false;
+
   m_messageParent.Put(new CDVDMsg(CDVDMsg::PLAYER_AVCHANGE));
   m_syncState = IDVDStreamPlayer::SYNC_STARTING;
 }
@@ -217,6 +233,29 @@ void CVideoPlayerAudio::UpdatePlayerInfo()
   if (m_synctype == SYNC_RESAMPLE)
     s << ", rr:" << std::fixed << std::setprecision(5) << 1.0 / m_audioSink.GetResampleRatio();
 
+  float resampleLoad = m_processInfo.GetAudioResampleLoad();
+  if (resampleLoad > 0.0f)
+    s << ", rs:" << std::fixed << std::setprecision(1) << resampleLoad * 100 << "%";
+
+  SAudioSyncStats stats;
+  stats.samples = m_errorHistogram.GetCount();
+  if (stats.samples > 0)
+  {
+    stats.delay50 = static_cast<float>(m_delayHistogram.GetPercentile(0.5));
+    stats.delay95 = static_cast<float>(m_delayHistogram.GetPercentile(0.95));
+    stats.error50 = static_cast<float>(m_errorHistogram.GetPercentile(0.5));
+    stats.error95 = static_cast<float>(m_errorHistogram.GetPercentile(0.95));
+    stats.error99 = static_cast<float>(m_errorHistogram.GetPercentile(0.99));
+    stats.correction50 = static_cast<float>(m_correctionHistogram.GetPercentile(0.5));
+    stats.correction95 = static_cast<float>(m_correctionHistogram.GetPercentile(0.95));
+
+    s << ", se95:" << std::fixed << std::setprecision(2) << stats.error95 << "ms";
+  }
+  stats.underruns = m_underruns;
+  if (m_underruns > 0)
+    s << ", ur:" << m_underruns;
+  m_processInfo.SetAudioSyncStats(stats);
+
   SInfo info;
   info.info        = s.str();
   info.pts         = m_audioSink.GetPlayingPts();
@@ -501,7 +540,10 @@ bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe)
     }
   }
 
+  UpdateSyncStats();
+
   int framesOutput = m_audioSink.AddPackets(audioframe);
+  m_processInfo.SetAudioResampleLoad(static_cast<float>(m_audioSink.GetResampleLoad()));
 
   // guess next pts
   m_audioClock += audioframe.duration * ((double)framesOutput / audioframe.nb_frames);
@@ -536,6 +578,29 @@ bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe)
   return true;
 }
 
+void CVideoPlayerAudio::UpdateSyncStats()
+{
+  // only playback at normal speed tells something about the sink
+  if (m_syncState != IDVDStreamPlayer::SYNC_INSYNC || m_speed != DVD_PLAYSPEED_NORMAL || m_paused)
+  {
+    m_underrun = false;
+    return;
+  }
+
+  m_delayHistogram.Add(m_audioSink.GetDelay() * 1000 / DVD_TIME_BASE);
+  m_errorHistogram.Add(fabs(m_audioSink.GetSyncError()) * 1000 / DVD_TIME_BASE);
+  if (m_synctype == SYNC_RESAMPLE && m_audioSink.GetResampleRatio() > 0.0)
+    m_correctionHistogram.Add(fabs(1.0 / m_audioSink.GetResampleRatio() - 1.0) * 1000000.0);
+  else
+    m_correctionHistogram.Add(0.0);
+
+  // count every time the buffer runs dry once
+  bool underrun = !m_stalled && m_audioSink.GetCacheTime() < UNDERRUN_CACHE_TIME;
+  if (underrun && !m_underrun)
+    m_underruns++;
+  m_underrun = underrun;
+}
+
 void CVideoPlayerAudio::SetSyncType(bool passthrough)
 {
   //set the synctype from the gui
@@ -30,6 +30,7 @@
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "threads/Thread.h"
 #include "utils/BitstreamStats.h"
+#include "utils/RollingHistogram.h"
 
 
 class CVideoPlayer;
@@ -79,6 +80,7 @@ protected:
   //! Switch codec if needed. Called when the sample rate gotten from the
   //! codec changes, in which case we may want to switch passthrough on/off.
   bool SwitchCodecIfNeeded();
+  void UpdateSyncStats();
 
   CDVDMessageQueue m_messageQueue;
   CDVDMessageQueue& m_messageParent;
@@ -93,6 +95,13 @@ protected:
   CDVDAudioCodec* m_pAudioCodec; // audio codec
   BitstreamStats m_audioStats;
 
+  // timing telemetry of the stream, published through process info
+  CRollingHistogram m_delayHistogram;
+  CRollingHistogram m_errorHistogram;
+  CRollingHistogram m_correctionHistogram;
+  int m_underruns = 0;
+  bool m_underrun = false;
+
   int m_speed;
   bool m_stalled;
   bool m_paused;
@@ -23,6 +23,8 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "utils/MathUtils.h"
+#include "utils/Metrics.h"
+#include "utils/TimeUtils.h"
 #include "VideoPlayerVideo.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
 #include "DVDCodecs/DVDCodecUtils.h"
@@ -35,6 +37,7 @@
 #include <iomanip>
 #include <numeric>
 #include <iterator>
+#include <algorithm>
 #include "utils/log.h"
 
 class CDVDMsgVideoCodecChange : public CDVDMsg
@@ -53,6 +56,36 @@ public:
   CDVDStreamInfo  m_hints;
 };
 
+static void CountDroppedFrame()
+{
+  static CMetricCounter &droppedFrames = CMetrics::GetInstance().GetCounter("kodi_video_dropped_frames_total",
+                                                                            "Video frames dropped by the player");
+  droppedFrames.Increment();
+}
+
+// Channels of a live tv network mostly share one video format. Decoders fed
+// with in-band parameter sets can continue on such a stream after a reset.
+static bool IsZapCompatible(const CDVDStreamInfo &current, const CDVDStreamInfo &hint)
+{
+  if (!current.realtime || !hint.realtime)
+    return false;
+
+  if (hint.codec != AV_CODEC_ID_H264 &&
+      hint.codec != AV_CODEC_ID_HEVC &&
+      hint.codec != AV_CODEC_ID_MPEG2VIDEO)
+    return false;
+
+  return current.codec == hint.codec &&
+         current.codec_tag == hint.codec_tag &&
+         current.profile == hint.profile &&
+         current.width == hint.width &&
+         current.height == hint.height &&
+         current.flags == hint.flags &&
+         current.stills == hint.stills &&
+         current.bitsperpixel == hint.bitsperpixel &&
+         current.stereo_mode == hint.stereo_mode;
+}
+
 
 CVideoPlayerVideo::CVideoPlayerVideo(CDVDClock* pClock
                                 ,CDVDOverlayContainer* pOverlayContainer
@@ -80,6 +113,7 @@ CVideoPlayerVideo::CVideoPlayerVideo(CDVDClock* pClock
   m_fForcedAspectRatio = 0;
   m_messageQueue.SetMaxDataSize(40 * 1024 * 1024);
   m_messageQueue.SetMaxTimeSize(8.0);
+  m_messageQueue.SetPacketRingSize(1024);
 
   m_iDroppedFrames = 0;
   m_fFrameRate = 25;
@@ -132,6 +166,13 @@ bool CVideoPlayerVideo::OpenStream(CDVDStreamInfo hint)
 
   if (m_messageQueue.IsInited())
   {
+    if (m_pVideoCodec && g_advancedSettings.m_bPVRFastZap && IsZapCompatible(m_hints, hint))
+    {
+      // keep the running decoder
+      SendMessage(new CDVDMsgVideoCodecChange(hint, nullptr), 0);
+      return true;
+    }
+
     if (m_pVideoCodec && !m_processInfo.IsVideoHwDecoder())
     {
       hint.codecOptions |= CODEC_ALLOW_FALLBACK;
@@ -166,7 +207,11 @@ void CVideoPlayerVideo::OpenStream(CDVDStreamInfo &hint, CDVDVideoCodec* codec)
 {
   CLog::Log(LOGDEBUG, "CVideoPlayerVideo::OpenStream - open stream with codec id: %i", hint.codec);
 
-  m_processInfo.GetVideoBufferManager().ReleasePools();
+  // fast channel zap, the decoder keeps its buffer pools
+  bool zap = !codec && m_pVideoCodec && g_advancedSettings.m_bPVRFastZap && IsZapCompatible(m_hints, hint);
+
+  if (!zap)
+    m_processInfo.GetVideoBufferManager().ReleasePools();
 
   //reported fps is usually not completely correct
   if (hint.fpsrate && hint.fpsscale)
@@ -188,6 +233,11 @@ void CVideoPlayerVideo::OpenStream(CDVDStreamInfo &hint, CDVDVideoCodec* codec)
   m_iDroppedRequest = 0;
   m_iLateFrames = 0;
 
+  m_predictiveDrop = g_advancedSettings.m_videoPredictiveDrop;
+  m_decodeTimes.Reset();
+  m_renderTimes.Reset();
+  m_decodeTicks = 0;
+
   if( m_fFrameRate > 120 || m_fFrameRate < 5 )
   {
     CLog::Log(LOGERROR, "CVideoPlayerVideo::OpenStream - Invalid framerate %d, using forced 25fps and just trust timestamps", (int)m_fFrameRate);
@@ -200,7 +250,13 @@ void CVideoPlayerVideo::OpenStream(CDVDStreamInfo &hint, CDVDVideoCodec* codec)
   else
     m_fForcedAspectRatio = 0.0f;
 
-  if (m_pVideoCodec && m_pVideoCodec->Reconfigure(hint))
+  if (zap)
+  {
+    CLog::Log(LOGDEBUG, "CVideoPlayerVideo::OpenStream - reusing video codec for channel switch");
+    m_pVideoCodec->Reset();
+    codec = m_pVideoCodec;
+  }
+  else if (m_pVideoCodec && m_pVideoCodec->Reconfigure(hint))
   {
     // reuse old decoder
     codec = m_pVideoCodec;
@@ -546,8 +602,13 @@ void CVideoPlayerVideo::Process()
       if (iDropDirective & DROP_DROPPED)
       {
         m_iDroppedFrames++;
+        CountDroppedFrame();
         m_ptsTracker.Flush();
       }
+      // skip non-reference frames before we are late if the decoder
+      // can't keep up anyway
+      if (!bRequestDrop && m_bAllowDrop && !bPacketDrop && PredictLate(frametime))
+        bRequestDrop = true;
       if (m_messageQueue.GetDataSize() == 0 ||  m_speed < 0)
       {
         bRequestDrop = false;
@@ -568,7 +629,11 @@ void CVideoPlayerVideo::Process()
         codecControl |= DVD_CODEC_CTRL_ROTATE;
       m_pVideoCodec->SetCodecControl(codecControl);
 
-      if (m_pVideoCodec->AddData(*pPacket))
+      int64_t start = CurrentHostCounter();
+      bool added = m_pVideoCodec->AddData(*pPacket);
+      m_decodeTicks += CurrentHostCounter() - start;
+
+      if (added)
       {
         // buffer packets so we can recover should decoder flush for some reason
         if (m_pVideoCodec->GetConvergeCount() > 0)
@@ -600,7 +665,9 @@ void CVideoPlayerVideo::Process()
 
 bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
 {
+  int64_t start = CurrentHostCounter();
   CDVDVideoCodec::VCReturn decoderState = m_pVideoCodec->GetPicture(&m_picture);
+  m_decodeTicks += CurrentHostCounter() - start;
 
   if (decoderState == CDVDVideoCodec::VC_BUFFER)
   {
@@ -667,6 +734,10 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
   {
     bool hasTimestamp = true;
 
+    m_decodeTimes.Add(static_cast<double>(m_decodeTicks) * 1000 / CurrentHostFrequency());
+    m_renderTimes.Add(m_renderManager.GetRenderTime());
+    m_decodeTicks = 0;
+
     m_picture.iDuration = frametime;
 
     // validate picture timing,
@@ -741,6 +812,7 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
     else if ((m_outputSate == OUTPUT_DROPPED) && !(m_picture.iFlags & DVP_FLAG_DROPPED))
     {
       m_iDroppedFrames++;
+      CountDroppedFrame();
       m_ptsTracker.Flush();
     }
 
@@ -1123,6 +1195,69 @@ int CVideoPlayerVideo::CalcDropRequirement(double pts)
   return result;
 }
 
+bool CVideoPlayerVideo::PredictLate(double frametime)
+{
+  if (!m_predictiveDrop || m_speed != DVD_PLAYSPEED_NORMAL || frametime <= 0)
+    return false;
+
+  if (m_decodeTimes.GetCount() < 30)
+    return false;
+
+  // decoder and renderer work in parallel, the slower one sets the pace
+  double budget = frametime * 1000 / DVD_TIME_BASE;
+  double cost = std::max(m_decodeTimes.GetPercentile(0.9), m_renderTimes.GetPercentile(0.9));
+  if (cost <= budget)
+    return false;
+
+  int lateframes, queued, discard;
+  double renderPts;
+  m_renderManager.GetStats(lateframes, renderPts, queued, discard);
+
+  // drop if the queued frames won't cover the deficit for the next 8 frames
+  double cushion = queued * budget;
+  if (cushion >= (cost - budget) * 8)
+    return false;
+
+  CLog::Log(LOGDEBUG, LOGVIDEO, "CVideoPlayerVideo::PredictLate - cost: %.1fms budget: %.1fms queued: %d",
+            cost, budget, queued);
+  return true;
+}
+
+void CFrameTimeHistogram::Reset()
+{
+  for (int& bucket : m_buckets)
+    bucket = 0;
+  m_pos = 0;
+  m_count = 0;
+}
+
+void CFrameTimeHistogram::Add(double ms)
+{
+  int bucket = std::min(std::max(static_cast<int>(ms * 2), 0), BUCKETS - 1);
+
+  if (m_count == WINDOW)
+    m_buckets[m_samples[m_pos]]--;
+  else
+    m_count++;
+
+  m_samples[m_pos] = bucket;
+  m_buckets[bucket]++;
+  m_pos = (m_pos + 1) % WINDOW;
+}
+
+double CFrameTimeHistogram::GetPercentile(double p) const
+{
+  int target = static_cast<int>(m_count * p);
+  int sum = 0;
+  for (int i = 0; i < BUCKETS; i++)
+  {
+    sum += m_buckets[i];
+    if (sum > target)
+      return (i + 1) * 0.5;
+  }
+  return BUCKETS * 0.5;
+}
+
 void CDroppingStats::Reset()
 {
   m_gain.clear();
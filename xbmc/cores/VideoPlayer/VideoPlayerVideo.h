@@ -53,6 +53,26 @@ public:
   double m_lastPts;
 };
 
+/**
+ * Histogram over the processing times of the last frames
+ */
+class CFrameTimeHistogram
+{
+public:
+  void Reset();
+  void Add(double ms);
+  double GetPercentile(double p) const;
+  int GetCount() const { return m_count; }
+
+private:
+  static const int BUCKETS = 128; // 0.5ms each
+  static const int WINDOW = 120;
+  int m_buckets[BUCKETS] = {};
+  int m_samples[WINDOW] = {};
+  int m_pos = 0;
+  int m_count = 0;
+};
+
 class CVideoPlayerVideo : public CThread, public IDVDStreamPlayerVideo
 {
 public:
@@ -112,6 +132,7 @@ protected:
   void ResetFrameRateCalc();
   void CalcFrameRate();
   int CalcDropRequirement(double pts);
+  bool PredictLate(double frametime);
 
   double m_iSubtitleDelay;
 
@@ -146,6 +167,10 @@ protected:
   CPtsTracker m_ptsTracker;
   std::list<DVDMessageListItem> m_packets;
   CDroppingStats m_droppingStats;
+  CFrameTimeHistogram m_decodeTimes;
+  CFrameTimeHistogram m_renderTimes;
+  int64_t m_decodeTicks = 0;
+  bool m_predictiveDrop = false;
   CRenderManager& m_renderManager;
   VideoPicture m_picture;
 
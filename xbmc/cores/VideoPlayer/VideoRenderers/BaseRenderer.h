@@ -55,6 +55,7 @@ enum RenderMethods
 
 struct VideoPicture;
 class CRenderCapture;
+class CRenderTimer;
 
 class CBaseRenderer
 {
@@ -101,6 +102,9 @@ public:
 
   void SetVideoSettings(const CVideoSettings &settings);
 
+  // timer for the GPU time of the render stages, owned by the render manager
+  void SetRenderTimer(CRenderTimer *timer) { m_renderTimer = timer; }
+
 protected:
   void CalcNormalRenderRect(float offsetX, float offsetY, float width, float height,
                             float inputFrameRatio, float zoomAmount, float verticalShift);
@@ -136,4 +140,5 @@ protected:
   AVPixelFormat m_format = AV_PIX_FMT_NONE;
 
   CVideoSettings m_videoSettings;
+  CRenderTimer *m_renderTimer = nullptr;
 };
@@ -0,0 +1,161 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DRMPRIMEEGL.h"
+
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodecDRMPRIME.h"
+#include "utils/EGLUtils.h"
+#include "utils/log.h"
+
+#include <drm_fourcc.h>
+
+namespace
+{
+const int MAX_PLANES = 3;
+
+const EGLint planeAttribs[MAX_PLANES][5] =
+{
+  { EGL_DMA_BUF_PLANE0_FD_EXT, EGL_DMA_BUF_PLANE0_OFFSET_EXT, EGL_DMA_BUF_PLANE0_PITCH_EXT,
+    EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT },
+  { EGL_DMA_BUF_PLANE1_FD_EXT, EGL_DMA_BUF_PLANE1_OFFSET_EXT, EGL_DMA_BUF_PLANE1_PITCH_EXT,
+    EGL_DMA_BUF_PLANE1_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE1_MODIFIER_HI_EXT },
+  { EGL_DMA_BUF_PLANE2_FD_EXT, EGL_DMA_BUF_PLANE2_OFFSET_EXT, EGL_DMA_BUF_PLANE2_PITCH_EXT,
+    EGL_DMA_BUF_PLANE2_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE2_MODIFIER_HI_EXT },
+};
+}
+
+CDRMPRIMETexture::~CDRMPRIMETexture()
+{
+  Unmap();
+
+  if (m_texture)
+    glDeleteTextures(1, &m_texture);
+}
+
+bool CDRMPRIMETexture::Init(EGLDisplay eglDisplay)
+{
+  if (m_eglDisplay == eglDisplay)
+    return true;
+
+  if (!CEGLUtils::HasExtension(eglDisplay, "EGL_EXT_image_dma_buf_import"))
+  {
+    CLog::Log(LOGDEBUG, "CDRMPRIMETexture::%s - EGL_EXT_image_dma_buf_import not supported", __FUNCTION__);
+    return false;
+  }
+
+  m_eglCreateImageKHR = reinterpret_cast<PFNEGLCREATEIMAGEKHRPROC>(eglGetProcAddress("eglCreateImageKHR"));
+  m_eglDestroyImageKHR = reinterpret_cast<PFNEGLDESTROYIMAGEKHRPROC>(eglGetProcAddress("eglDestroyImageKHR"));
+  m_glEGLImageTargetTexture2DOES = reinterpret_cast<PFNGLEGLIMAGETARGETTEXTURE2DOESPROC>(eglGetProcAddress("glEGLImageTargetTexture2DOES"));
+  if (!m_eglCreateImageKHR || !m_eglDestroyImageKHR || !m_glEGLImageTargetTexture2DOES)
+    return false;
+
+  m_hasPlaneModifiers = CEGLUtils::HasExtension(eglDisplay, "EGL_EXT_image_dma_buf_import_modifiers");
+  m_eglDisplay = eglDisplay;
+  return true;
+}
+
+bool CDRMPRIMETexture::Map(CVideoBufferDRMPRIME* buffer)
+{
+  if (m_primebuffer == buffer)
+    return true;
+
+  Unmap();
+
+  if (m_eglDisplay == EGL_NO_DISPLAY)
+    return false;
+
+  AVDRMFrameDescriptor* descriptor = buffer->GetDescriptor();
+  if (!descriptor || descriptor->nb_layers != 1)
+  {
+    // split layers would need one texture per layer and a yuv shader
+    CLog::Log(LOGDEBUG, "CDRMPRIMETexture::%s - unsupported layer count %d", __FUNCTION__,
+              descriptor ? descriptor->nb_layers : 0);
+    return false;
+  }
+
+  AVDRMLayerDescriptor* layer = &descriptor->layers[0];
+  if (layer->nb_planes > MAX_PLANES)
+    return false;
+
+  CEGLAttributes<3 + MAX_PLANES * 5> attribs;
+  attribs.Add({{EGL_LINUX_DRM_FOURCC_EXT, static_cast<EGLint>(layer->format)},
+               {EGL_WIDTH, static_cast<EGLint>(buffer->GetWidth())},
+               {EGL_HEIGHT, static_cast<EGLint>(buffer->GetHeight())}});
+
+  for (int plane = 0; plane < layer->nb_planes; plane++)
+  {
+    AVDRMObjectDescriptor* object = &descriptor->objects[layer->planes[plane].object_index];
+
+    attribs.Add({{planeAttribs[plane][0], object->fd},
+                 {planeAttribs[plane][1], static_cast<EGLint>(layer->planes[plane].offset)},
+                 {planeAttribs[plane][2], static_cast<EGLint>(layer->planes[plane].pitch)}});
+
+    if (m_hasPlaneModifiers && object->format_modifier != DRM_FORMAT_MOD_INVALID)
+    {
+      attribs.Add({{planeAttribs[plane][3], static_cast<EGLint>(object->format_modifier)},
+                   {planeAttribs[plane][4], static_cast<EGLint>(object->format_modifier >> 32)}});
+    }
+  }
+
+  m_eglImage = m_eglCreateImageKHR(m_eglDisplay, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, nullptr, attribs.Get());
+  if (m_eglImage == EGL_NO_IMAGE_KHR)
+  {
+    CEGLUtils::LogError("Failed to import DRM PRIME buffer into EGL image");
+    return false;
+  }
+
+  if (!m_texture)
+  {
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_EXTERNAL_OES, m_texture);
+    glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_EXTERNAL_OES, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  }
+  else
+    glBindTexture(GL_TEXTURE_EXTERNAL_OES, m_texture);
+
+  m_glEGLImageTargetTexture2DOES(GL_TEXTURE_EXTERNAL_OES, m_eglImage);
+  glBindTexture(GL_TEXTURE_EXTERNAL_OES, 0);
+
+  m_textureSize.Set(buffer->GetWidth(), buffer->GetHeight());
+
+  // keep the frame alive while the texture refers to its dmabufs
+  m_primebuffer = buffer;
+  m_primebuffer->Acquire();
+
+  return true;
+}
+
+void CDRMPRIMETexture::Unmap()
+{
+  if (m_eglImage != EGL_NO_IMAGE_KHR)
+  {
+    m_eglDestroyImageKHR(m_eglDisplay, m_eglImage);
+    m_eglImage = EGL_NO_IMAGE_KHR;
+  }
+
+  if (m_primebuffer)
+  {
+    m_primebuffer->Release();
+    m_primebuffer = nullptr;
+  }
+}
@@ -0,0 +1,63 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "utils/Geometry.h"
+
+class CVideoBufferDRMPRIME;
+
+/**
+ * Imports a DRM PRIME frame into an external GL texture via
+ * EGL_EXT_image_dma_buf_import, the frame is sampled from its dmabufs
+ * directly without a copy.
+ */
+class CDRMPRIMETexture
+{
+public:
+  CDRMPRIMETexture() = default;
+  ~CDRMPRIMETexture();
+
+  bool Init(EGLDisplay eglDisplay);
+  bool Map(CVideoBufferDRMPRIME* buffer);
+  void Unmap();
+
+  GLuint GetTexture() const { return m_texture; }
+  GLenum GetTextureTarget() const { return GL_TEXTURE_EXTERNAL_OES; }
+  CSizeInt GetTextureSize() const { return m_textureSize; }
+
+private:
+  EGLDisplay m_eglDisplay = EGL_NO_DISPLAY;
+  PFNEGLCREATEIMAGEKHRPROC m_eglCreateImageKHR = nullptr;
+  PFNEGLDESTROYIMAGEKHRPROC m_eglDestroyImageKHR = nullptr;
+  PFNGLEGLIMAGETARGETTEXTURE2DOESPROC m_glEGLImageTargetTexture2DOES = nullptr;
+  bool m_hasPlaneModifiers = false;
+
+  CVideoBufferDRMPRIME* m_primebuffer = nullptr;
+  EGLImageKHR m_eglImage = EGL_NO_IMAGE_KHR;
+  GLuint m_texture = 0;
+  CSizeInt m_textureSize;
+};
@@ -20,10 +20,17 @@
 
 #include "RendererDRMPRIME.h"
 
+#include "ServiceBroker.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderCapture.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderFactory.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderFlags.h"
+#include "guilib/MatrixGLES.h"
+#include "rendering/gles/RenderSystemGLES.h"
+#include "utils/GLUtils.h"
 #include "utils/log.h"
+#include "windowing/GraphicContext.h"
+
+#include <utility>
 
 #include <drm_fourcc.h>
 #include <errno.h>
@@ -37,6 +44,7 @@ CRendererDRMPRIME::CRendererDRMPRIME(std::shared_ptr<CDRMUtils> drm)
 
 CRendererDRMPRIME::~CRendererDRMPRIME()
 {
+  m_texture.Unmap();
   Reset();
 }
 
@@ -141,11 +149,95 @@ void CRendererDRMPRIME::RenderUpdate(int index, int index2, bool clear, unsigned
 
 bool CRendererDRMPRIME::RenderCapture(CRenderCapture* capture)
 {
+  CVideoBufferDRMPRIME* buffer = nullptr;
+  if (m_iLastRenderBuffer >= 0)
+    buffer = dynamic_cast<CVideoBufferDRMPRIME*>(m_buffers[m_iLastRenderBuffer].videoBuffer);
+
+  // sample the frame straight from its dmabufs, the video plane itself
+  // can't be read back
+  if (!buffer || !m_texture.Init(m_pWinSystem->GetEGLDisplay()) || !m_texture.Map(buffer))
+  {
+    capture->BeginRender();
+    capture->EndRender();
+    return true;
+  }
+
+  glDisable(GL_BLEND);
+
+  // invert Y axis to get non-inverted image
+  glMatrixModview.Push();
+  glMatrixModview->Translatef(0.0f, capture->GetHeight(), 0.0f);
+  glMatrixModview->Scalef(1.0f, -1.0f, 1.0f);
+  glMatrixModview.Load();
+
   capture->BeginRender();
+
+  RenderTexture(static_cast<float>(capture->GetWidth()), static_cast<float>(capture->GetHeight()));
+
+  glReadPixels(0, CServiceBroker::GetWinSystem()->GetGfxContext().GetHeight() - capture->GetHeight(), capture->GetWidth(), capture->GetHeight(),
+               GL_RGBA, GL_UNSIGNED_BYTE, capture->GetRenderBuffer());
+
+  // OpenGLES returns in RGBA order but CRenderCapture needs BGRA order
+  unsigned char* pixels = static_cast<unsigned char*>(capture->GetRenderBuffer());
+  for (unsigned int i = 0; i < capture->GetWidth() * capture->GetHeight(); i++, pixels += 4)
+    std::swap(pixels[0], pixels[2]);
+
   capture->EndRender();
+
+  glMatrixModview.PopLoad();
+
+  // don't hold on to the frame, the next capture maps the current one
+  m_texture.Unmap();
+
   return true;
 }
 
+void CRendererDRMPRIME::RenderTexture(float width, float height)
+{
+  CRenderSystemGLES* renderSystem = dynamic_cast<CRenderSystemGLES*>(CServiceBroker::GetRenderSystem());
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(m_texture.GetTextureTarget(), m_texture.GetTexture());
+
+  renderSystem->EnableGUIShader(SM_TEXTURE_RGBA_OES);
+
+  glUniform1f(renderSystem->GUIShaderGetContrast(), m_videoSettings.m_Contrast * 0.02f);
+  glUniform1f(renderSystem->GUIShaderGetBrightness(), m_videoSettings.m_Brightness * 0.01f - 0.5f);
+
+  GLubyte idx[4] = {0, 1, 3, 2}; // determines order of triangle strip
+  GLfloat ver[4][4] = {
+    {0.0f, 0.0f, 0.0f, 1.0f},
+    {width, 0.0f, 0.0f, 1.0f},
+    {width, height, 0.0f, 1.0f},
+    {0.0f, height, 0.0f, 1.0f},
+  };
+  GLfloat tex[4][4] = {
+    {0.0f, 0.0f, 0.0f, 1.0f},
+    {1.0f, 0.0f, 0.0f, 1.0f},
+    {1.0f, 1.0f, 0.0f, 1.0f},
+    {0.0f, 1.0f, 0.0f, 1.0f},
+  };
+
+  GLint posLoc = renderSystem->GUIShaderGetPos();
+  GLint texLoc = renderSystem->GUIShaderGetCoord0();
+
+  glVertexAttribPointer(posLoc, 4, GL_FLOAT, 0, 0, ver);
+  glVertexAttribPointer(texLoc, 4, GL_FLOAT, 0, 0, tex);
+
+  glEnableVertexAttribArray(posLoc);
+  glEnableVertexAttribArray(texLoc);
+
+  glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_BYTE, idx);
+
+  glDisableVertexAttribArray(posLoc);
+  glDisableVertexAttribArray(texLoc);
+
+  renderSystem->DisableGUIShader();
+
+  glBindTexture(m_texture.GetTextureTarget(), 0);
+  VerifyGLState();
+}
+
 bool CRendererDRMPRIME::ConfigChanged(const VideoPicture& picture)
 {
   if (picture.videoBuffer->GetFormat() != m_format)
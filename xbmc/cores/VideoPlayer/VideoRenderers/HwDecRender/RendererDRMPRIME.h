@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include "DRMPRIMEEGL.h"
 #include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodecDRMPRIME.h"
 #include "cores/VideoPlayer/VideoRenderers/BaseRenderer.h"
 #include "windowing/gbm/WinSystemGbmGLESContext.h"
@@ -57,12 +58,14 @@ public:
 private:
   void Reset();
   void SetVideoPlane(CVideoBufferDRMPRIME* buffer);
+  void RenderTexture(float width, float height);
 
   bool m_bConfigured = false;
   int m_iLastRenderBuffer = -1;
   static const int m_numRenderBuffers = 4;
 
   std::shared_ptr<CDRMUtils> m_DRM;
+  CDRMPRIMETexture m_texture;
 
   struct BUFFER
   {
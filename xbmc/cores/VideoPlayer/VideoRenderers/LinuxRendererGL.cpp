@@ -43,6 +43,7 @@
 #include "utils/GLUtils.h"
 #include "utils/StringUtils.h"
 #include "RenderCapture.h"
+#include "RenderTimer.h"
 #include "cores/IPlayer.h"
 #include "cores/VideoPlayer/DVDCodecs/DVDCodecUtils.h"
 #include "cores/FFmpeg.h"
@@ -104,6 +105,7 @@ CLinuxRendererGL::CPictureBuffer::CPictureBuffer()
   memset(&fields, 0, sizeof(fields));
   memset(&image , 0, sizeof(image));
   memset(&pbo   , 0, sizeof(pbo));
+  memset(&pboMap, 0, sizeof(pboMap));
   videoBuffer = nullptr;
   loaded = false;
 }
@@ -149,6 +151,7 @@ CLinuxRendererGL::CLinuxRendererGL()
   m_clearColour = 0.0f;
   m_pboSupported = false;
   m_pboUsed = false;
+  m_pboPersistent = false;
   m_nonLinStretch = false;
   m_nonLinStretchGui = false;
   m_pixelRatio = 0.0f;
@@ -978,6 +981,21 @@ void CLinuxRendererGL::LoadShaders(int field)
   }
   else
     m_pboUsed = false;
+
+  m_pboPersistent = false;
+#if defined(GL_ARB_buffer_storage)
+  if (m_pboUsed)
+  {
+    unsigned int major, minor;
+    m_renderSystem->GetRenderVersion(major, minor);
+    if (major > 4 || (major == 4 && minor >= 4) ||
+        m_renderSystem->IsExtSupported("GL_ARB_buffer_storage"))
+    {
+      CLog::Log(LOGNOTICE, "GL: Using persistent mapped pixel buffer objects");
+      m_pboPersistent = true;
+    }
+  }
+#endif
 }
 
 void CLinuxRendererGL::UnInit()
@@ -1014,7 +1032,12 @@ bool CLinuxRendererGL::Render(unsigned int flags, int renderBuffer)
     m_currentField = FIELD_FULL;
 
   // call texture load function
-  if (!UploadTexture(renderBuffer))
+  if (m_renderTimer)
+    m_renderTimer->Begin(RENDER_STAGE_UPLOAD);
+  bool uploaded = UploadTexture(renderBuffer);
+  if (m_renderTimer)
+    m_renderTimer->End(RENDER_STAGE_UPLOAD);
+  if (!uploaded)
   {
     return false;
   }
@@ -1028,13 +1051,27 @@ bool CLinuxRendererGL::Render(unsigned int flags, int renderBuffer)
     {
     case RQ_LOW:
     case RQ_SINGLEPASS:
+      // conversion and scaling are a single shader pass, accounted as conversion
+      if (m_renderTimer)
+        m_renderTimer->Begin(RENDER_STAGE_YUV2RGB);
       RenderSinglePass(renderBuffer, m_currentField);
+      if (m_renderTimer)
+        m_renderTimer->End(RENDER_STAGE_YUV2RGB);
       VerifyGLState();
       break;
 
     case RQ_MULTIPASS:
+      if (m_renderTimer)
+        m_renderTimer->Begin(RENDER_STAGE_YUV2RGB);
       RenderToFBO(renderBuffer, m_currentField);
+      if (m_renderTimer)
+      {
+        m_renderTimer->End(RENDER_STAGE_YUV2RGB);
+        m_renderTimer->Begin(RENDER_STAGE_SCALING);
+      }
       RenderFromFBO();
+      if (m_renderTimer)
+        m_renderTimer->End(RENDER_STAGE_SCALING);
       VerifyGLState();
       break;
     }
@@ -1758,6 +1795,13 @@ void CLinuxRendererGL::DeleteTexture(int index)
 {
   ReleaseBuffer(index);
 
+  CPictureBuffer &buf = m_buffers[index];
+  if (buf.pboFence)
+  {
+    glDeleteSync(buf.pboFence);
+    buf.pboFence = nullptr;
+  }
+
   if (m_format == AV_PIX_FMT_NV12)
     DeleteNV12Texture(index);
   else if (m_format == AV_PIX_FMT_YUYV422 ||
@@ -1785,26 +1829,31 @@ bool CLinuxRendererGL::UploadTexture(int index)
 
     UnBindPbo(m_buffers[index]);
 
+    // mapped pbos are write combined memory
+    bool streaming = m_buffers[index].pbo[0] != 0;
+
     if (m_format == AV_PIX_FMT_NV12)
     {
-      CVideoBuffer::CopyNV12Picture(&dst, &src);
+      CVideoBuffer::CopyNV12Picture(&dst, &src, streaming);
       BindPbo(m_buffers[index]);
       ret = UploadNV12Texture(index);
     }
     else if (m_format == AV_PIX_FMT_YUYV422 ||
              m_format == AV_PIX_FMT_UYVY422)
     {
-      CVideoBuffer::CopyYUV422PackedPicture(&dst, &src);
+      CVideoBuffer::CopyYUV422PackedPicture(&dst, &src, streaming);
       BindPbo(m_buffers[index]);
       ret = UploadYUV422PackedTexture(index);
     }
     else
     {
-      CVideoBuffer::CopyPicture(&dst, &src);
+      CVideoBuffer::CopyPicture(&dst, &src, streaming);
       BindPbo(m_buffers[index]);
       ret = UploadYV12Texture(index);
     }
 
+    FencePbo(m_buffers[index]);
+
     if (ret)
       m_buffers[index].loaded = true;
   }
@@ -1877,8 +1926,7 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
     for (int i = 0; i < 3; i++)
     {
       glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo[i]);
-      glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, im.planesize[i] + PBO_OFFSET, 0, GL_STREAM_DRAW_ARB);
-      void* pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+      void* pboPtr = CreatePboStorage(im.planesize[i] + PBO_OFFSET);
       if (pboPtr)
       {
         im.plane[i] = (uint8_t*) pboPtr + PBO_OFFSET;
@@ -2180,8 +2228,7 @@ bool CLinuxRendererGL::CreateNV12Texture(int index)
     for (int i = 0; i < 2; i++)
     {
       glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo[i]);
-      glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, im.planesize[i] + PBO_OFFSET, 0, GL_STREAM_DRAW_ARB);
-      void* pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+      void* pboPtr = CreatePboStorage(im.planesize[i] + PBO_OFFSET);
       if (pboPtr)
       {
         im.plane[i] = (uint8_t*)pboPtr + PBO_OFFSET;
@@ -2446,8 +2493,7 @@ bool CLinuxRendererGL::CreateYUV422PackedTexture(int index)
     glGenBuffersARB(1, pbo);
 
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo[0]);
-    glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, im.planesize[0] + PBO_OFFSET, 0, GL_STREAM_DRAW_ARB);
-    void* pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+    void* pboPtr = CreatePboStorage(im.planesize[0] + PBO_OFFSET);
     if (pboPtr)
     {
       im.plane[0] = (uint8_t*)pboPtr + PBO_OFFSET;
@@ -2615,8 +2661,39 @@ bool CLinuxRendererGL::Supports(ESCALINGMETHOD method)
   return false;
 }
 
+void* CLinuxRendererGL::CreatePboStorage(GLsizeiptr size)
+{
+  // pbo is assumed to be bound
+#if defined(GL_ARB_buffer_storage)
+  if (m_pboPersistent)
+  {
+    // mapped once for the lifetime of the buffer, coherent so no flush is needed before upload
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER_ARB, size, nullptr, flags);
+    return glMapBufferRange(GL_PIXEL_UNPACK_BUFFER_ARB, 0, size, flags);
+  }
+#endif
+
+  glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, size, 0, GL_STREAM_DRAW_ARB);
+  return glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+}
+
 void CLinuxRendererGL::BindPbo(CPictureBuffer& buff)
 {
+  if (m_pboPersistent)
+  {
+    // buffers stay mapped, only switch the planes to offsets into the bound pbo
+    for(int plane = 0; plane < YuvImage::MAX_PLANES; plane++)
+    {
+      if(!buff.pbo[plane] || buff.image.plane[plane] == (uint8_t*)PBO_OFFSET)
+        continue;
+
+      buff.pboMap[plane] = buff.image.plane[plane];
+      buff.image.plane[plane] = (uint8_t*)PBO_OFFSET;
+    }
+    return;
+  }
+
   bool pbo = false;
   for(int plane = 0; plane < YuvImage::MAX_PLANES; plane++)
   {
@@ -2634,6 +2711,27 @@ void CLinuxRendererGL::BindPbo(CPictureBuffer& buff)
 
 void CLinuxRendererGL::UnBindPbo(CPictureBuffer& buff)
 {
+  if (m_pboPersistent)
+  {
+    // the gpu may still read the previous picture of this buffer, there are
+    // NUM_BUFFERS pictures in flight so this rarely has to wait
+    if (buff.pboFence)
+    {
+      glClientWaitSync(buff.pboFence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+      glDeleteSync(buff.pboFence);
+      buff.pboFence = nullptr;
+    }
+
+    for(int plane = 0; plane < YuvImage::MAX_PLANES; plane++)
+    {
+      if(!buff.pbo[plane] || buff.image.plane[plane] != (uint8_t*)PBO_OFFSET)
+        continue;
+
+      buff.image.plane[plane] = buff.pboMap[plane];
+    }
+    return;
+  }
+
   bool pbo = false;
   for(int plane = 0; plane < YuvImage::MAX_PLANES; plane++)
   {
@@ -2649,6 +2747,16 @@ void CLinuxRendererGL::UnBindPbo(CPictureBuffer& buff)
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
 }
 
+void CLinuxRendererGL::FencePbo(CPictureBuffer& buff)
+{
+  if (!m_pboPersistent || !buff.pbo[0])
+    return;
+
+  if (buff.pboFence)
+    glDeleteSync(buff.pboFence);
+  buff.pboFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
 CRenderInfo CLinuxRendererGL::GetRenderInfo()
 {
   CRenderInfo info;
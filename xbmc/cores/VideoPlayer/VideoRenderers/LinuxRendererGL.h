@@ -192,6 +192,8 @@ protected:
     YUVPLANE fields[MAX_FIELDS][YuvImage::MAX_PLANES];
     YuvImage image;
     GLuint pbo[3]; // one pbo for 3 planes
+    uint8_t *pboMap[3]; // persistent mapping of each pbo
+    GLsync pboFence = nullptr; // signaled once the gpu is done reading the pbos
 
     CVideoBuffer *videoBuffer;
     bool loaded;
@@ -233,8 +235,11 @@ protected:
 
   void BindPbo(CPictureBuffer& buff);
   void UnBindPbo(CPictureBuffer& buff);
+  void FencePbo(CPictureBuffer& buff);
+  void* CreatePboStorage(GLsizeiptr size);
   bool m_pboSupported;
   bool m_pboUsed;
+  bool m_pboPersistent;
 
   bool  m_nonLinStretch;
   bool  m_nonLinStretchGui;
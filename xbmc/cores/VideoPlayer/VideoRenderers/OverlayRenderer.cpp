@@ -33,6 +33,7 @@
 #include "settings/Settings.h"
 #include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
+#include "utils/Crc32.h"
 #include "utils/MathUtils.h"
 #include "OverlayRendererUtil.h"
 #include "OverlayRendererGUI.h"
@@ -44,6 +45,40 @@
 
 using namespace OVERLAY;
 
+namespace
+{
+uint32_t ContentKey(CDVDOverlayImage* o)
+{
+  if (!o->data)
+    return 0;
+
+  Crc32 crc;
+  const int header[] = { o->x, o->y, o->width, o->height,
+                         o->source_width, o->source_height,
+                         o->linesize, o->palette_colors };
+  crc.Compute(reinterpret_cast<const char*>(header), sizeof(header));
+  if (o->palette)
+    crc.Compute(reinterpret_cast<const char*>(o->palette), o->palette_colors * 4);
+  crc.Compute(reinterpret_cast<const char*>(o->data), o->linesize * o->height);
+  return crc;
+}
+
+uint32_t ContentKey(ASS_Image* images, int targetWidth, int targetHeight, int videoWidth, int videoHeight)
+{
+  Crc32 crc;
+  const int header[] = { targetWidth, targetHeight, videoWidth, videoHeight };
+  crc.Compute(reinterpret_cast<const char*>(header), sizeof(header));
+  for (ASS_Image* img = images; img; img = img->next)
+  {
+    const int image[] = { img->w, img->h, img->dst_x, img->dst_y, static_cast<int>(img->color) };
+    crc.Compute(reinterpret_cast<const char*>(image), sizeof(image));
+    for (int y = 0; y < img->h; y++)
+      crc.Compute(reinterpret_cast<const char*>(img->bitmap + y * img->stride), img->w);
+  }
+  return crc;
+}
+}
+
 COverlay::COverlay()
 {
   m_x      = 0.0f;
@@ -113,11 +148,8 @@ void CRenderer::Release(int idx)
 
 void CRenderer::ReleaseCache()
 {
-  for (auto& overlay : m_textureCache)
-  {
-    delete overlay.second;
-  }
   m_textureCache.clear();
+  m_contentCache.clear();
   m_textureid++;
 }
 
@@ -140,10 +172,7 @@ void CRenderer::ReleaseUnused()
         break;
     }
     if (!found)
-    {
-      delete it->second;
       it = m_textureCache.erase(it);
-    }
     else
       ++it;
   }
@@ -360,13 +389,19 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   {
     if(changes == 0)
     {
-      std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
+      auto it = m_textureCache.find(o->m_textureid);
       if (it != m_textureCache.end())
-        return it->second;
+        return it->second.get();
     }
   }
 
-  COverlay *overlay = NULL;
+  // karaoke and fades change with every frame, but static lines get here
+  // again whenever another line starts or ends
+  uint32_t key = ContentKey(images, targetWidth, targetHeight, videoWidth, videoHeight);
+  COverlay *overlay = FindContent(o, key);
+  if (overlay)
+    return overlay;
+
 #if defined(HAS_GL) || defined(HAS_GLES)
   overlay = new COverlayGlyphGL(images, targetWidth, targetHeight);
 #elif defined(HAS_DX)
@@ -380,10 +415,7 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
     overlay->m_x = ((float)videoWidth - targetWidth) / 2 / videoWidth;
     overlay->m_y = ((float)videoHeight - targetHeight) / 2 / videoHeight;
   }
-  m_textureCache[m_textureid] = overlay;
-  o->m_textureid = m_textureid;
-  m_textureid++;
-  return overlay;
+  return AddCache(o, key, overlay);
 }
 
 
@@ -395,9 +427,9 @@ COverlay* CRenderer::Convert(CDVDOverlay* o, double pts)
     r = Convert(static_cast<CDVDOverlaySSA*>(o), pts);
   else if(o->m_textureid)
   {
-    std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
+    auto it = m_textureCache.find(o->m_textureid);
     if (it != m_textureCache.end())
-      r = it->second;
+      r = it->second.get();
   }
 
   if (r)
@@ -405,6 +437,16 @@ COverlay* CRenderer::Convert(CDVDOverlay* o, double pts)
     return r;
   }
 
+  // image subtitles (pgs, dvb) resend identical images regularly
+  uint32_t key = 0;
+  if (o->IsOverlayType(DVDOVERLAY_TYPE_IMAGE))
+  {
+    key = ContentKey(static_cast<CDVDOverlayImage*>(o));
+    r = FindContent(o, key);
+    if (r)
+      return r;
+  }
+
 #if defined(HAS_GL) || defined(HAS_GLES)
   if (o->IsOverlayType(DVDOVERLAY_TYPE_IMAGE))
     r = new COverlayTextureGL(static_cast<CDVDOverlayImage*>(o));
@@ -420,9 +462,40 @@ COverlay* CRenderer::Convert(CDVDOverlay* o, double pts)
   if(!r && o->IsOverlayType(DVDOVERLAY_TYPE_TEXT))
     r = new COverlayText(static_cast<CDVDOverlayText*>(o));
 
-  m_textureCache[m_textureid] = r;
+  return AddCache(o, key, r);
+}
+
+COverlay* CRenderer::FindContent(CDVDOverlay* o, uint32_t key)
+{
+  if (!key)
+    return nullptr;
+
+  for (auto it = m_contentCache.begin(); it != m_contentCache.end(); ++it)
+  {
+    if (it->first == key)
+    {
+      m_contentCache.splice(m_contentCache.begin(), m_contentCache, it);
+      m_textureCache[m_textureid] = it->second;
+      o->m_textureid = m_textureid;
+      m_textureid++;
+      return it->second.get();
+    }
+  }
+  return nullptr;
+}
+
+COverlay* CRenderer::AddCache(CDVDOverlay* o, uint32_t key, COverlay* overlay)
+{
+  std::shared_ptr<COverlay> cached(overlay);
+  m_textureCache[m_textureid] = cached;
   o->m_textureid = m_textureid;
   m_textureid++;
 
-  return r;
+  if (key && overlay)
+  {
+    m_contentCache.emplace_front(key, cached);
+    if (m_contentCache.size() > CONTENT_CACHE_SIZE)
+      m_contentCache.pop_back();
+  }
+  return overlay;
 }
@@ -24,8 +24,11 @@
 #include "threads/CriticalSection.h"
 #include "BaseRenderer.h"
 
-#include <vector>
+#include <list>
 #include <map>
+#include <memory>
+#include <utility>
+#include <vector>
 
 class CDVDOverlay;
 class CDVDOverlayImage;
@@ -105,13 +108,24 @@ namespace OVERLAY {
     COverlay* Convert(CDVDOverlay* o, double pts);
     COverlay* Convert(CDVDOverlaySSA* o, double pts);
 
+    /*!
+     * Looks up an overlay with identical content that has been uploaded before,
+     * so repeated subtitle images don't cost a new texture.
+     * \param key content hash, 0 disables the lookup
+     */
+    COverlay* FindContent(CDVDOverlay* o, uint32_t key);
+    COverlay* AddCache(CDVDOverlay* o, uint32_t key, COverlay* overlay);
+
     void Release(std::vector<SElement>& list);
     void ReleaseCache();
     void ReleaseUnused();
 
     CCriticalSection m_section;
     std::vector<SElement> m_buffers[NUM_BUFFERS];
-    std::map<unsigned int, COverlay*> m_textureCache;
+    std::map<unsigned int, std::shared_ptr<COverlay>> m_textureCache;
+    // recently used overlays by content, most recent first
+    std::list<std::pair<uint32_t, std::shared_ptr<COverlay>>> m_contentCache;
+    static const size_t CONTENT_CACHE_SIZE = 8;
     static unsigned int m_textureid;
     CRect m_rv, m_rs, m_rd;
     std::string m_font, m_fontBorder;
@@ -0,0 +1,260 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RenderBenchmark.h"
+
+#include <algorithm>
+#include <memory>
+#include <string.h>
+#include <vector>
+
+#include "system_gl.h"
+
+#include "BaseRenderer.h"
+#include "RenderFactory.h"
+#include "RenderFlags.h"
+#include "ServiceBroker.h"
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodec.h"
+#include "cores/VideoPlayer/Process/VideoBuffer.h"
+#include "filesystem/File.h"
+#include "rendering/RenderSystem.h"
+#include "settings/MediaSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/log.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+#include "windowing/GraphicContext.h"
+#include "windowing/WinSystem.h"
+
+namespace
+{
+
+struct ScalingMethodName
+{
+  ESCALINGMETHOD method;
+  const char* name;
+};
+
+const ScalingMethodName scalingMethods[] =
+{
+  { VS_SCALINGMETHOD_NEAREST,       "nearest" },
+  { VS_SCALINGMETHOD_LINEAR,        "linear" },
+  { VS_SCALINGMETHOD_CUBIC,         "cubic" },
+  { VS_SCALINGMETHOD_LANCZOS2,      "lanczos2" },
+  { VS_SCALINGMETHOD_LANCZOS3_FAST, "lanczos3fast" },
+  { VS_SCALINGMETHOD_LANCZOS3,      "lanczos3" },
+  { VS_SCALINGMETHOD_SPLINE36_FAST, "spline36fast" },
+  { VS_SCALINGMETHOD_SPLINE36,      "spline36" },
+};
+
+// frames rendered before measuring, the first ones create textures and compile shaders
+const unsigned int warmupFrames = 3;
+
+void FillPicture(CVideoBuffer *buffer, unsigned int width, unsigned int height)
+{
+  uint8_t *planes[YuvImage::MAX_PLANES];
+  int strides[YuvImage::MAX_PLANES];
+  buffer->GetPlanes(planes);
+  buffer->GetStrides(strides);
+
+  for (unsigned int y = 0; y < height; y++)
+    memset(planes[0] + y * strides[0], 16 + (y * 219 / height), width);
+
+  for (unsigned int y = 0; y < height / 2; y++)
+  {
+    memset(planes[1] + y * strides[1], 128, width / 2);
+    memset(planes[2] + y * strides[2], 128, width / 2);
+  }
+}
+
+}
+
+bool CRenderBenchmark::Run(const CParams &params)
+{
+  CRenderSystemBase *renderSystem = CServiceBroker::GetRenderSystem();
+  unsigned int major, minor;
+  renderSystem->GetRenderVersion(major, minor);
+  if ((major < 3 || (major == 3 && minor < 3)) &&
+      !renderSystem->IsExtSupported("GL_ARB_timer_query"))
+  {
+    CLog::Log(LOGERROR, "CRenderBenchmark::Run - GPU timer queries not supported");
+    return false;
+  }
+
+  if (params.width < 16 || params.height < 16 || params.frames == 0)
+    return false;
+
+  CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+
+  // planes are packed without padding, chroma subsampled in both directions
+  unsigned int width = params.width & ~1;
+  unsigned int height = params.height & ~1;
+  int strides[YuvImage::MAX_PLANES] = { static_cast<int>(width),
+                                        static_cast<int>(width / 2),
+                                        static_cast<int>(width / 2) };
+
+  std::shared_ptr<IVideoBufferPool> pool = CVideoBufferPoolSysMem::CreatePool();
+  pool->Configure(AV_PIX_FMT_YUV420P, width * height * 3 / 2);
+
+  VideoPicture picture;
+  picture.Reset();
+  picture.videoBuffer = pool->Get();
+  picture.videoBuffer->SetDimensions(width, height, strides);
+  picture.iWidth = picture.iDisplayWidth = width;
+  picture.iHeight = picture.iDisplayHeight = height;
+  picture.color_primaries = AVCOL_PRI_BT709;
+  picture.color_space = AVCOL_SPC_BT709;
+  picture.color_range = 0;
+  picture.colorBits = 8;
+  FillPicture(picture.videoBuffer, width, height);
+
+  std::unique_ptr<CBaseRenderer> renderer(VIDEOPLAYER::CRendererFactory::CreateRenderer("default", picture.videoBuffer));
+  if (!renderer)
+  {
+    picture.Reset();
+    return false;
+  }
+
+  CVideoSettings settings = CMediaSettings::GetInstance().GetDefaultVideoSettings();
+  settings.m_ScalingMethod = VS_SCALINGMETHOD_LINEAR;
+  renderer->SetVideoSettings(settings);
+
+  if (!renderer->Configure(picture, 25.0f, 0))
+  {
+    CLog::Log(LOGERROR, "CRenderBenchmark::Run - failed to configure renderer");
+    picture.Reset();
+    return false;
+  }
+  renderer->SetBufferSize(2);
+  renderer->Update();
+
+  CVariant result(CVariant::VariantTypeObject);
+  result["gl"]["vendor"] = renderSystem->GetRenderVendor();
+  result["gl"]["renderer"] = renderSystem->GetRenderRenderer();
+  result["gl"]["version"] = renderSystem->GetRenderVersionString();
+  result["source"]["width"] = width;
+  result["source"]["height"] = height;
+  result["destination"]["width"] = CServiceBroker::GetWinSystem()->GetGfxContext().GetWidth();
+  result["destination"]["height"] = CServiceBroker::GetWinSystem()->GetGfxContext().GetHeight();
+  result["frames"] = params.frames;
+  result["results"] = CVariant(CVariant::VariantTypeArray);
+
+  // shaders are selected on first render, supported scalers depend on them
+  CVariant discard;
+  Measure(*renderer, picture, false, 1, discard);
+
+  for (const ScalingMethodName &scaling : scalingMethods)
+  {
+    if (!renderer->Supports(scaling.method))
+      continue;
+
+    settings.m_ScalingMethod = scaling.method;
+    renderer->SetVideoSettings(settings);
+
+    for (EINTERLACEMETHOD interlace : { VS_INTERLACEMETHOD_NONE, VS_INTERLACEMETHOD_RENDER_BOB })
+    {
+      CVariant entry(CVariant::VariantTypeObject);
+      entry["scalingmethod"] = scaling.name;
+      entry["interlacemethod"] = interlace == VS_INTERLACEMETHOD_NONE ? "none" : "renderbob";
+      if (Measure(*renderer, picture, interlace == VS_INTERLACEMETHOD_RENDER_BOB, params.frames, entry))
+        result["results"].push_back(entry);
+    }
+  }
+
+  renderer->ReleaseBuffer(0);
+  renderer->UnInit();
+  renderer.reset();
+  picture.Reset();
+
+  std::string json;
+  if (!CJSONVariantWriter::Write(result, json, false))
+    return false;
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(params.file, true) ||
+      file.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    CLog::Log(LOGERROR, "CRenderBenchmark::Run - failed to write %s", params.file.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGNOTICE, "CRenderBenchmark::Run - results written to %s", params.file.c_str());
+  return true;
+}
+
+bool CRenderBenchmark::Measure(CBaseRenderer &renderer, const VideoPicture &picture, bool bob,
+                               unsigned int frames, CVariant &result)
+{
+  if (frames == 0)
+    return false;
+
+  std::vector<GLuint> queries(frames);
+  glGenQueries(frames, queries.data());
+
+  int64_t cpuTicks = 0;
+  for (unsigned int i = 0; i < warmupFrames + frames; i++)
+  {
+    bool measure = i >= warmupFrames;
+    if (measure)
+      glBeginQuery(GL_TIME_ELAPSED, queries[i - warmupFrames]);
+
+    int64_t start = CurrentHostCounter();
+
+    // re-adding the picture marks it not loaded, upload is part of every frame
+    renderer.ReleaseBuffer(0);
+    renderer.AddVideoPicture(picture, 0, 0.0);
+    if (bob)
+    {
+      renderer.RenderUpdate(0, -1, true, RENDER_FLAG_TOP | RENDER_FLAG_FIELD0, 255);
+      renderer.RenderUpdate(0, -1, true, RENDER_FLAG_BOT | RENDER_FLAG_FIELD1, 255);
+    }
+    else
+      renderer.RenderUpdate(0, -1, true, 0, 255);
+
+    if (measure)
+    {
+      cpuTicks += CurrentHostCounter() - start;
+      glEndQuery(GL_TIME_ELAPSED);
+    }
+  }
+
+  glFinish();
+
+  double total = 0.0;
+  double minimum = 0.0;
+  double maximum = 0.0;
+  for (unsigned int i = 0; i < frames; i++)
+  {
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &elapsed);
+    double ms = elapsed / 1000000.0;
+    minimum = i == 0 ? ms : std::min(minimum, ms);
+    maximum = std::max(maximum, ms);
+    total += ms;
+  }
+  glDeleteQueries(frames, queries.data());
+
+  result["gpu"]["average"] = total / frames;
+  result["gpu"]["min"] = minimum;
+  result["gpu"]["max"] = maximum;
+  result["cpu"]["average"] = static_cast<double>(cpuTicks) * 1000.0 / CurrentHostFrequency() / frames;
+  return true;
+}
@@ -0,0 +1,56 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <string>
+
+class CBaseRenderer;
+class CVariant;
+struct VideoPicture;
+
+/*!
+ * \brief Measures the GPU cost of the scaling and field rendering paths of
+ * the GL video renderer.
+ *
+ * Synthetic YUV420P frames are uploaded and rendered once per frame for
+ * every supported ESCALINGMETHOD, progressive and with render bob
+ * deinterlacing. The time spent on the GPU is taken with GL_TIME_ELAPSED
+ * queries and the result is written as JSON.
+ *
+ * Must be called from the rendering thread while no video is playing.
+ */
+class CRenderBenchmark
+{
+public:
+  struct CParams
+  {
+    std::string file = "special://temp/renderbenchmark.json";
+    unsigned int width = 1280;
+    unsigned int height = 720;
+    unsigned int frames = 100;
+  };
+
+  static bool Run(const CParams &params);
+
+private:
+  static bool Measure(CBaseRenderer &renderer, const VideoPicture &picture, bool bob,
+                      unsigned int frames, CVariant &result);
+};
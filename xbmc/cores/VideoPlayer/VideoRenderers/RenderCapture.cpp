@@ -101,27 +101,19 @@ void CRenderCaptureDispmanX::ReadOut()
 
 CRenderCaptureGL::CRenderCaptureGL()
 {
-  m_pbo   = 0;
-  m_query = 0;
+#ifndef HAS_GLES
+  m_ringWrite = 0;
+  m_ringCount = 0;
+#endif
   m_occlusionQuerySupported = false;
+  m_syncSupported = false;
 }
 
 CRenderCaptureGL::~CRenderCaptureGL()
 {
 #ifndef HAS_GLES
   if (m_asyncSupported)
-  {
-    if (m_pbo)
-    {
-      glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, m_pbo);
-      glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
-      glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
-      glDeleteBuffersARB(1, &m_pbo);
-    }
-
-    if (m_query)
-      glDeleteQueriesARB(1, &m_query);
-  }
+    FreeRing();
 #endif
 
   delete[] m_pixels;
@@ -139,14 +131,15 @@ void CRenderCaptureGL::BeginRender()
 #ifndef HAS_GLES
     m_asyncSupported = CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_pixel_buffer_object");
     m_occlusionQuerySupported = CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_occlusion_query");
+    m_syncSupported = CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_sync");
 
     if (m_flags & CAPTUREFLAG_CONTINUOUS)
     {
-      if (!m_occlusionQuerySupported)
+      if (!m_occlusionQuerySupported && !m_syncSupported)
         CLog::Log(LOGWARNING, "CRenderCaptureGL: GL_ARB_occlusion_query not supported, performance might suffer");
       if (!CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_pixel_buffer_object"))
         CLog::Log(LOGWARNING, "CRenderCaptureGL: GL_ARB_pixel_buffer_object not supported, performance might suffer");
-      if (UseOcclusionQuery())
+      if (!UseOcclusionQuery() && !m_syncSupported)
         CLog::Log(LOGWARNING, "CRenderCaptureGL: GL_ARB_occlusion_query disabled, performance might suffer");
     }
 #endif
@@ -156,38 +149,63 @@ void CRenderCaptureGL::BeginRender()
 #ifndef HAS_GLES
   if (m_asyncSupported)
   {
-    if (!m_pbo)
-      glGenBuffersARB(1, &m_pbo);
+    if (m_bufferSize != m_width * m_height * 4)
+    {
+      //frames in flight have the old size
+      FreeRing();
+      m_bufferSize = m_width * m_height * 4;
+      delete[] m_pixels;
+      m_pixels = new uint8_t[m_bufferSize];
+    }
+
+    //only continuous captures may return a frame older than the current one
+    if (!(m_flags & CAPTUREFLAG_CONTINUOUS) || (m_flags & CAPTUREFLAG_IMMEDIATELY))
+      ClearRing();
+    else if (m_ringCount == PBO_COUNT)
+    {
+      //ring is full, drop the oldest frame
+      CapturePbo& oldest = m_ring[m_ringWrite];
+      if (oldest.fence)
+      {
+        glDeleteSync(oldest.fence);
+        oldest.fence = nullptr;
+      }
+      m_ringCount--;
+    }
+
+    CapturePbo& slot = m_ring[m_ringWrite];
 
-    if (UseOcclusionQuery() && m_occlusionQuerySupported)
+    //allocate data on the pbo
+    if (!slot.pbo)
+    {
+      glGenBuffersARB(1, &slot.pbo);
+      glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, slot.pbo);
+      glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, m_bufferSize, 0, GL_STREAM_READ_ARB);
+      glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+    }
+
+    //a fence tells reliably when the transfer is done, fall back to an occlusion query without it
+    if (!m_syncSupported && UseOcclusionQuery() && m_occlusionQuerySupported)
     {
       //generate an occlusion query if we don't have one
-      if (!m_query)
-        glGenQueriesARB(1, &m_query);
+      if (!slot.query)
+        glGenQueriesARB(1, &slot.query);
     }
     else
     {
       //don't use an occlusion query, clean up any old one
-      if (m_query)
+      if (slot.query)
       {
-        glDeleteQueriesARB(1, &m_query);
-        m_query = 0;
+        glDeleteQueriesARB(1, &slot.query);
+        slot.query = 0;
       }
     }
 
     //start the occlusion query
-    if (m_query)
-      glBeginQueryARB(GL_SAMPLES_PASSED_ARB, m_query);
+    if (slot.query)
+      glBeginQueryARB(GL_SAMPLES_PASSED_ARB, slot.query);
 
-    //allocate data on the pbo and pixel buffer
-    glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, m_pbo);
-    if (m_bufferSize != m_width * m_height * 4)
-    {
-      m_bufferSize = m_width * m_height * 4;
-      glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, m_bufferSize, 0, GL_STREAM_READ_ARB);
-      delete[] m_pixels;
-      m_pixels = new uint8_t[m_bufferSize];
-    }
+    glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, slot.pbo);
   }
   else
 #endif
@@ -206,13 +224,21 @@ void CRenderCaptureGL::EndRender()
 #ifndef HAS_GLES
   if (m_asyncSupported)
   {
+    CapturePbo& slot = m_ring[m_ringWrite];
+
     glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
 
-    if (m_query)
+    if (slot.query)
       glEndQueryARB(GL_SAMPLES_PASSED_ARB);
 
+    if (m_syncSupported)
+      slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    m_ringWrite = (m_ringWrite + 1) % PBO_COUNT;
+    m_ringCount++;
+
     if (m_flags & CAPTUREFLAG_IMMEDIATELY)
-      PboToBuffer();
+      PboToBuffer(slot);
     else
       SetState(CAPTURESTATE_NEEDSREADOUT);
   }
@@ -240,26 +266,57 @@ void* CRenderCaptureGL::GetRenderBuffer()
 void CRenderCaptureGL::ReadOut()
 {
 #ifndef HAS_GLES
-  if (m_asyncSupported)
+  if (m_asyncSupported && m_ringCount > 0)
   {
-    //we don't care about the occlusion query, we just want to know if the result is available
-    //when it is, the write into the pbo is probably done as well,
-    //so it can be mapped and read without a busy wait
-
-    GLuint readout = 1;
-    if (m_query)
-      glGetQueryObjectuivARB(m_query, GL_QUERY_RESULT_AVAILABLE_ARB, &readout);
+    CapturePbo& oldest = m_ring[(m_ringWrite + PBO_COUNT - m_ringCount) % PBO_COUNT];
 
-    if (readout)
-      PboToBuffer();
+    if (PboReady(oldest))
+      PboToBuffer(oldest);
   }
 #endif
 }
 
-void CRenderCaptureGL::PboToBuffer()
+bool CRenderCaptureGL::CanQueueRender()
 {
 #ifndef HAS_GLES
-  glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, m_pbo);
+  return m_asyncSupported &&
+         (m_flags & CAPTUREFLAG_CONTINUOUS) &&
+         !(m_flags & CAPTUREFLAG_IMMEDIATELY) &&
+         m_ringCount < PBO_COUNT;
+#else
+  return false;
+#endif
+}
+
+#ifndef HAS_GLES
+bool CRenderCaptureGL::PboReady(CapturePbo& slot)
+{
+  if (slot.fence)
+  {
+    GLenum result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+  }
+
+  //we don't care about the occlusion query, we just want to know if the result is available
+  //when it is, the write into the pbo is probably done as well,
+  //so it can be mapped and read without a busy wait
+  GLuint readout = 1;
+  if (slot.query)
+    glGetQueryObjectuivARB(slot.query, GL_QUERY_RESULT_AVAILABLE_ARB, &readout);
+
+  return readout != 0;
+}
+
+void CRenderCaptureGL::PboToBuffer(CapturePbo& slot)
+{
+  if (slot.fence)
+  {
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+  }
+  m_ringCount--;
+
+  glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, slot.pbo);
   GLvoid* pboPtr = glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB);
 
   if (pboPtr)
@@ -275,9 +332,38 @@ void CRenderCaptureGL::PboToBuffer()
 
   glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
   glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
-#endif
 }
 
+void CRenderCaptureGL::ClearRing()
+{
+  for (CapturePbo& slot : m_ring)
+  {
+    if (slot.fence)
+    {
+      glDeleteSync(slot.fence);
+      slot.fence = nullptr;
+    }
+  }
+  m_ringCount = 0;
+}
+
+void CRenderCaptureGL::FreeRing()
+{
+  ClearRing();
+
+  for (CapturePbo& slot : m_ring)
+  {
+    if (slot.pbo)
+      glDeleteBuffersARB(1, &slot.pbo);
+    if (slot.query)
+      glDeleteQueriesARB(1, &slot.query);
+    slot.pbo = 0;
+    slot.query = 0;
+  }
+  m_ringWrite = 0;
+}
+#endif
+
 #elif HAS_DX /*HAS_GL*/
 
 CRenderCaptureDX::CRenderCaptureDX()
@@ -27,6 +27,8 @@
 
 #include "threads/Event.h"
 
+class IRenderCaptureCallback;
+
 enum ECAPTURESTATE
 {
   CAPTURESTATE_WORKING,
@@ -93,6 +95,17 @@ class CRenderCaptureBase
     */
     bool  IsAsync() { return m_asyncSupported; }
 
+    /* \brief Called by the rendermanager to know if another frame can be rendered while earlier ones
+       are still waiting for readout, should not be called by anything else.
+    */
+    virtual bool CanQueueRender() { return false; }
+
+    /* \brief Called by the rendermanager to set the callback receiving captured frames */
+    void SetCallback(IRenderCaptureCallback* callback) { m_callback = callback; }
+
+    /* \brief Called by the rendermanager to get the callback, should not be called by anything else */
+    IRenderCaptureCallback* GetCallback() { return m_callback; }
+
   protected:
     bool UseOcclusionQuery();
 
@@ -100,6 +113,7 @@ class CRenderCaptureBase
     ECAPTURESTATE  m_userState; //state for the thread that wants the capture
     int m_flags;
     CEvent m_event;
+    IRenderCaptureCallback* m_callback = nullptr;
 
     uint8_t*  m_pixels;
     unsigned int m_width;
@@ -154,11 +168,32 @@ class CRenderCaptureGL : public CRenderCaptureBase
 
     void* GetRenderBuffer();
 
+    bool  CanQueueRender() override;
+
   private:
-    void   PboToBuffer();
-    GLuint m_pbo;
-    GLuint m_query;
+#ifndef HAS_GLES
+    //continuous captures render into a ring of pbos, so the readout
+    //of a frame can lag behind by a few frames without a stall
+    static const int PBO_COUNT = 3;
+
+    struct CapturePbo
+    {
+      GLuint pbo = 0;
+      GLuint query = 0;
+      GLsync fence = nullptr;
+    };
+
+    bool   PboReady(CapturePbo& slot);
+    void   PboToBuffer(CapturePbo& slot);
+    void   ClearRing();
+    void   FreeRing();
+
+    CapturePbo m_ring[PBO_COUNT];
+    int    m_ringWrite; //slot the next frame is rendered to
+    int    m_ringCount; //slots waiting for readout
+#endif
     bool   m_occlusionQuerySupported;
+    bool   m_syncSupported;
 };
 
 //used instead of typedef CRenderCaptureGL CRenderCapture
@@ -27,6 +27,7 @@
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "windowing/WinSystem.h"
 
 #include "Application.h"
@@ -42,6 +43,7 @@
 #endif
 
 #include "RenderCapture.h"
+#include "rendering/RenderSystem.h"
 
 /* to use the same as player */
 #include "../VideoPlayer/DVDClock.h"
@@ -293,6 +295,19 @@ void CRenderManager::FrameMove()
   bool firstFrame = false;
   UpdateResolution();
 
+  bool timings = m_renderDebug || g_advancedSettings.m_videoRenderTimings;
+  if (timings != m_renderTimer.IsEnabled())
+  {
+    m_renderTimer.SetEnabled(timings);
+    if (!timings)
+      m_playerPort->UpdateRenderTimings(std::vector<float>());
+  }
+  if (m_renderTimer.IsEnabled())
+  {
+    m_renderTimer.NextFrame();
+    m_playerPort->UpdateRenderTimings(m_renderTimer.GetTimings());
+  }
+
   {
     CSingleLock lock(m_statelock);
 
@@ -405,6 +420,7 @@ void CRenderManager::UnInit()
 
   m_overlays.Flush();
   m_debugRenderer.Flush();
+  m_renderTimer.SetEnabled(false);
 
   DeleteRenderer();
 
@@ -467,6 +483,16 @@ bool CRenderManager::Flush(bool wait)
   return true;
 }
 
+void CRenderManager::BeginGuiRender()
+{
+  m_renderTimer.Begin(RENDER_STAGE_GUI);
+}
+
+void CRenderManager::EndGuiRender()
+{
+  m_renderTimer.End(RENDER_STAGE_GUI);
+}
+
 void CRenderManager::CreateRenderer()
 {
   if (!m_pRenderer)
@@ -483,11 +509,12 @@ void CRenderManager::CreateRenderer()
 
       m_pRenderer = VIDEOPLAYER::CRendererFactory::CreateRenderer(id, buffer);
       if (m_pRenderer)
-      {
-        return;
-      }
+        break;
     }
-    m_pRenderer = VIDEOPLAYER::CRendererFactory::CreateRenderer("default", buffer);
+    if (!m_pRenderer)
+      m_pRenderer = VIDEOPLAYER::CRendererFactory::CreateRenderer("default", buffer);
+    if (m_pRenderer)
+      m_pRenderer->SetRenderTimer(&m_renderTimer);
   }
 }
 
@@ -517,7 +544,10 @@ void CRenderManager::ReleaseRenderCapture(unsigned int captureId)
   it = m_captures.find(captureId);
 
   if (it != m_captures.end())
+  {
+    it->second->SetCallback(nullptr);
     it->second->SetState(CAPTURESTATE_NEEDSDELETE);
+  }
 }
 
 void CRenderManager::StartRenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags)
@@ -547,8 +577,7 @@ void CRenderManager::StartRenderCapture(unsigned int captureId, unsigned int wid
     {
       //render capture and read out immediately
       RenderCapture(capture);
-      capture->SetUserState(capture->GetState());
-      capture->GetEvent().Set();
+      DeliverCapture(captureId, capture);
     }
   }
 
@@ -591,6 +620,16 @@ bool CRenderManager::RenderCaptureGetPixels(unsigned int captureId, unsigned int
   return true;
 }
 
+void CRenderManager::SetRenderCaptureCallback(unsigned int captureId, IRenderCaptureCallback* callback)
+{
+  CSingleLock lock(m_captCritSect);
+
+  std::map<unsigned int, CRenderCapture*>::iterator it;
+  it = m_captures.find(captureId);
+  if (it != m_captures.end())
+    it->second->SetCallback(callback);
+}
+
 void CRenderManager::ManageCaptures()
 {
   //no captures, return here so we don't do an unnecessary lock
@@ -614,13 +653,18 @@ void CRenderManager::ManageCaptures()
     if (capture->GetState() == CAPTURESTATE_NEEDSRENDER)
       RenderCapture(capture);
     else if (capture->GetState() == CAPTURESTATE_NEEDSREADOUT)
+    {
       capture->ReadOut();
 
+      //keep the readout ring filled while the oldest frame is still in flight
+      if (capture->GetState() == CAPTURESTATE_NEEDSREADOUT && capture->CanQueueRender())
+        RenderCapture(capture);
+    }
+
     if (capture->GetState() == CAPTURESTATE_DONE || capture->GetState() == CAPTURESTATE_FAILED)
     {
       //tell the thread that the capture is done or has failed
-      capture->SetUserState(capture->GetState());
-      capture->GetEvent().Set();
+      DeliverCapture(it->first, capture);
 
       if (capture->GetFlags() & CAPTUREFLAG_CONTINUOUS)
       {
@@ -644,10 +688,20 @@ void CRenderManager::ManageCaptures()
 
 void CRenderManager::RenderCapture(CRenderCapture* capture)
 {
+  CServiceBroker::GetRenderSystem()->FlushBatch();
   if (!m_pRenderer || !m_pRenderer->RenderCapture(capture))
     capture->SetState(CAPTURESTATE_FAILED);
 }
 
+void CRenderManager::DeliverCapture(unsigned int captureId, CRenderCapture* capture)
+{
+  capture->SetUserState(capture->GetState());
+  capture->GetEvent().Set();
+
+  if (capture->GetState() == CAPTURESTATE_DONE && capture->GetCallback())
+    capture->GetCallback()->OnCaptureFrame(captureId, capture->GetPixels(), capture->GetWidth(), capture->GetHeight());
+}
+
 void CRenderManager::RemoveCaptures()
 {
   CSingleLock lock(m_captCritSect);
@@ -704,16 +758,24 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
   if (!gui && m_pRenderer->IsGuiLayer())
     return;
 
+  // GUI textures queued so far go below the video
+  CServiceBroker::GetRenderSystem()->FlushBatch();
+
   if (!gui || m_pRenderer->IsGuiLayer())
   {
     SPresent& m = m_Queue[m_presentsource];
 
+    int64_t start = CurrentHostCounter();
+
     if( m.presentmethod == PRESENT_METHOD_BOB )
       PresentFields(clear, flags, alpha);
     else if( m.presentmethod == PRESENT_METHOD_BLEND )
       PresentBlend(clear, flags, alpha);
     else
       PresentSingle(clear, flags, alpha);
+
+    int elapsed = static_cast<int>((CurrentHostCounter() - start) * 1000000 / CurrentHostFrequency());
+    m_renderTime = m_renderTime + (elapsed - m_renderTime) / 8;
   }
 
   if (gui)
@@ -725,7 +787,9 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
     CRect src, dst, view;
     m_pRenderer->GetVideoRect(src, dst, view);
     m_overlays.SetVideoRect(src, dst, view);
+    m_renderTimer.Begin(RENDER_STAGE_OVERLAY);
     m_overlays.Render(m_presentsource);
+    m_renderTimer.End(RENDER_STAGE_OVERLAY);
 
     if (m_renderDebug)
     {
@@ -744,6 +808,17 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
                                      clockspeed * 100);
       }
 
+      std::vector<float> gpu = m_renderTimer.GetTimings();
+      if (gpu.size() == RENDER_STAGE_MAX)
+      {
+        vsync += StringUtils::Format("  GPU ms: up:%.2f yuv:%.2f scale:%.2f ovl:%.2f gui:%.2f",
+                                     gpu[RENDER_STAGE_UPLOAD],
+                                     gpu[RENDER_STAGE_YUV2RGB],
+                                     gpu[RENDER_STAGE_SCALING],
+                                     gpu[RENDER_STAGE_OVERLAY],
+                                     gpu[RENDER_STAGE_GUI]);
+      }
+
       m_debugRenderer.SetInfo(audio, video, player, vsync);
       m_debugRenderer.Render(src, dst, view);
 
@@ -30,6 +30,7 @@
 #include "cores/VideoSettings.h"
 #include "OverlayRenderer.h"
 #include "DebugRenderer.h"
+#include "RenderTimer.h"
 #include <deque>
 #include <map>
 #include <atomic>
@@ -38,6 +39,7 @@
 #include "DVDClock.h"
 
 class CRenderCapture;
+class IRenderCaptureCallback;
 struct VideoPicture;
 
 class CWinRenderer;
@@ -60,6 +62,7 @@ protected:
   virtual void UpdateRenderBuffers(int queued, int discard, int free) = 0;
   virtual void UpdateGuiRender(bool gui) = 0;
   virtual void UpdateVideoRender(bool video) = 0;
+  virtual void UpdateRenderTimings(const std::vector<float> &timings) = 0;
   virtual CVideoSettings GetVideoSettings() = 0;
 };
 
@@ -75,6 +78,12 @@ public:
   void FrameMove();
   void FrameWait(int ms);
   void Render(bool clear, DWORD flags = 0, DWORD alpha = 255, bool gui = true);
+
+  /*!
+   * \brief Bracket the gui layer pass, only used to measure its GPU time
+   */
+  void BeginGuiRender();
+  void EndGuiRender();
   bool IsVideoLayer();
   RESOLUTION GetResolution();
   void UpdateResolution();
@@ -91,6 +100,12 @@ public:
   void StartRenderCapture(unsigned int captureId, unsigned int width, unsigned int height, int flags);
   bool RenderCaptureGetPixels(unsigned int captureId, unsigned int millis, uint8_t *buffer, unsigned int size);
 
+  /*!
+   * Frames of the capture are handed to callback on the render thread once read back.
+   * No call is made anymore after the callback has been reset or the capture released.
+   */
+  void SetRenderCaptureCallback(unsigned int captureId, IRenderCaptureCallback* callback);
+
   // Functions called from GUI
   bool Supports(ERENDERFEATURE feature);
   bool Supports(ESCALINGMETHOD method);
@@ -116,6 +131,11 @@ public:
    */
   bool GetStats(int &lateframes, double &pts, int &queued, int &discard);
 
+  /**
+   * Average time in ms the render thread spent presenting a video frame
+   */
+  double GetRenderTime() const { return m_renderTime / 1000.0; }
+
   /**
    * Video player call this on flush in oder to discard any queued frames
    */
@@ -147,6 +167,7 @@ protected:
   CBaseRenderer *m_pRenderer = nullptr;
   OVERLAY::CRenderer m_overlays;
   CDebugRenderer m_debugRenderer;
+  CRenderTimer m_renderTimer;
   CCriticalSection m_statelock;
   CCriticalSection m_presentlock;
   CCriticalSection m_datalock;
@@ -215,6 +236,7 @@ protected:
 
   int m_lateframes = -1;
   double m_presentpts = 0.0;
+  std::atomic_int m_renderTime{0}; // us
   EPRESENTSTEP m_presentstep = PRESENT_IDLE;
   XbmcThreads::EndTime m_presentTimer;
   bool m_forceNext = false;
@@ -237,6 +259,7 @@ protected:
   CClockSync m_clockSync;
 
   void RenderCapture(CRenderCapture* capture);
+  void DeliverCapture(unsigned int captureId, CRenderCapture* capture);
   void RemoveCaptures();
   CCriticalSection m_captCritSect;
   std::map<unsigned int, CRenderCapture*> m_captures;
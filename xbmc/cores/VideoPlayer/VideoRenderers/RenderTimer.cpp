@@ -0,0 +1,191 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RenderTimer.h"
+
+#if defined(HAS_GL)
+
+#include "ServiceBroker.h"
+#include "rendering/RenderSystem.h"
+#include "utils/log.h"
+
+CRenderTimerGL::CRenderTimerGL()
+{
+  for (int &open : m_open)
+    open = -1;
+}
+
+CRenderTimerGL::~CRenderTimerGL()
+{
+  FreeQueries();
+}
+
+void CRenderTimerGL::SetEnabled(bool enabled)
+{
+  if (enabled == m_enabled)
+    return;
+
+  if (enabled && m_supported < 0)
+  {
+    // timestamps are core in 3.3, older contexts need the extension
+    CRenderSystemBase *renderSystem = CServiceBroker::GetRenderSystem();
+    unsigned int major, minor;
+    renderSystem->GetRenderVersion(major, minor);
+    m_supported = (major > 3 || (major == 3 && minor >= 3) ||
+                   renderSystem->IsExtSupported("GL_ARB_timer_query")) ? 1 : 0;
+    if (!m_supported)
+      CLog::Log(LOGNOTICE, "CRenderTimerGL - GPU timer queries not supported");
+  }
+
+  if (enabled && !m_supported)
+    return;
+
+  if (!enabled)
+    FreeQueries();
+
+  m_enabled = enabled;
+}
+
+void CRenderTimerGL::Begin(ERENDERSTAGE stage)
+{
+  if (!m_enabled || m_open[stage] >= 0)
+    return;
+
+  Frame &frame = m_frames[m_current];
+  if (frame.used == frame.samples.size())
+  {
+    Sample sample;
+    GLuint queries[2];
+    glGenQueries(2, queries);
+    sample.begin = queries[0];
+    sample.end = queries[1];
+    frame.samples.push_back(sample);
+  }
+
+  Sample &sample = frame.samples[frame.used];
+  sample.stage = stage;
+  glQueryCounter(sample.begin, GL_TIMESTAMP);
+  m_open[stage] = frame.used++;
+}
+
+void CRenderTimerGL::End(ERENDERSTAGE stage)
+{
+  if (!m_enabled || m_open[stage] < 0)
+    return;
+
+  glQueryCounter(m_frames[m_current].samples[m_open[stage]].end, GL_TIMESTAMP);
+  m_open[stage] = -1;
+}
+
+void CRenderTimerGL::NextFrame()
+{
+  if (!m_enabled)
+    return;
+
+  // a stage left open has no end timestamp, the frame can't be read back
+  for (int &open : m_open)
+  {
+    if (open >= 0)
+      m_frames[m_current].used = 0;
+    open = -1;
+  }
+
+  m_current = (m_current + 1) % FRAME_COUNT;
+
+  // the oldest frame is reused now, read it if the GPU is done with it
+  Frame &frame = m_frames[m_current];
+  if (frame.used > 0)
+    Collect(frame);
+  frame.used = 0;
+}
+
+bool CRenderTimerGL::Collect(Frame &frame)
+{
+  GLint available = 0;
+  glGetQueryObjectiv(frame.samples[frame.used - 1].end, GL_QUERY_RESULT_AVAILABLE, &available);
+  if (!available)
+    return false;
+
+  std::vector<GLuint64> begin(frame.used);
+  std::vector<GLuint64> end(frame.used);
+  for (size_t i = 0; i < frame.used; i++)
+  {
+    glGetQueryObjectui64v(frame.samples[i].begin, GL_QUERY_RESULT, &begin[i]);
+    glGetQueryObjectui64v(frame.samples[i].end, GL_QUERY_RESULT, &end[i]);
+  }
+
+  double ms[RENDER_STAGE_MAX] = {};
+  for (size_t i = 0; i < frame.used; i++)
+  {
+    if (end[i] < begin[i])
+      continue;
+
+    double elapsed = (end[i] - begin[i]) / 1000000.0;
+    ms[frame.samples[i].stage] += elapsed;
+
+    // video rendered as part of the gui layer is not gui time
+    if (frame.samples[i].stage == RENDER_STAGE_GUI)
+      continue;
+    for (size_t j = 0; j < frame.used; j++)
+    {
+      if (frame.samples[j].stage == RENDER_STAGE_GUI &&
+          begin[i] >= begin[j] && end[i] <= end[j])
+      {
+        ms[RENDER_STAGE_GUI] -= elapsed;
+        break;
+      }
+    }
+  }
+
+  if (ms[RENDER_STAGE_GUI] < 0.0)
+    ms[RENDER_STAGE_GUI] = 0.0;
+
+  if (m_timings.empty())
+  {
+    m_timings.assign(ms, ms + RENDER_STAGE_MAX);
+    return true;
+  }
+
+  for (int i = 0; i < RENDER_STAGE_MAX; i++)
+    m_timings[i] += (static_cast<float>(ms[i]) - m_timings[i]) / 8;
+
+  return true;
+}
+
+void CRenderTimerGL::FreeQueries()
+{
+  for (Frame &frame : m_frames)
+  {
+    for (Sample &sample : frame.samples)
+    {
+      glDeleteQueries(1, &sample.begin);
+      glDeleteQueries(1, &sample.end);
+    }
+    frame.samples.clear();
+    frame.used = 0;
+  }
+
+  for (int &open : m_open)
+    open = -1;
+
+  m_timings.clear();
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#if defined(HAS_GL)
+#include "system_gl.h"
+#endif
+
+enum ERENDERSTAGE
+{
+  RENDER_STAGE_UPLOAD = 0,
+  RENDER_STAGE_YUV2RGB,
+  RENDER_STAGE_SCALING,
+  RENDER_STAGE_OVERLAY,
+  RENDER_STAGE_GUI, // gui layer without the video stages rendered inside of it
+  RENDER_STAGE_MAX
+};
+
+/*!
+ * \brief Collects GPU time per render stage.
+ *
+ * Stages are bracketed with Begin() and End() on the render thread, they may
+ * be entered several times per frame, e.g. once per field. Results are read
+ * back a few frames later so the GPU is never waited for, frames whose
+ * results are not ready in time are skipped.
+ */
+class CRenderTimerBase
+{
+public:
+  virtual ~CRenderTimerBase() = default;
+
+  virtual void SetEnabled(bool enabled) {}
+  bool IsEnabled() const { return m_enabled; }
+
+  virtual void Begin(ERENDERSTAGE stage) {}
+  virtual void End(ERENDERSTAGE stage) {}
+
+  // call once per frame before its first stage, collects results of earlier frames
+  virtual void NextFrame() {}
+
+  // averaged milliseconds per frame, indexed by ERENDERSTAGE, empty if nothing was measured
+  std::vector<float> GetTimings() const { return m_timings; }
+
+protected:
+  bool m_enabled = false;
+  std::vector<float> m_timings;
+};
+
+#if defined(HAS_GL)
+
+class CRenderTimerGL : public CRenderTimerBase
+{
+public:
+  CRenderTimerGL();
+  ~CRenderTimerGL() override;
+
+  void SetEnabled(bool enabled) override;
+  void Begin(ERENDERSTAGE stage) override;
+  void End(ERENDERSTAGE stage) override;
+  void NextFrame() override;
+
+protected:
+  static const int FRAME_COUNT = 4;
+
+  struct Sample
+  {
+    ERENDERSTAGE stage;
+    GLuint begin;
+    GLuint end;
+  };
+
+  struct Frame
+  {
+    std::vector<Sample> samples;
+    size_t used = 0;
+  };
+
+  bool Collect(Frame &frame);
+  void FreeQueries();
+
+  Frame m_frames[FRAME_COUNT];
+  int m_current = 0;
+  int m_open[RENDER_STAGE_MAX];
+  int m_supported = -1; // unknown until first enabled on the render thread
+};
+
+//used instead of typedef CRenderTimerGL CRenderTimer
+//since C++ doesn't allow you to forward declare a typedef
+class CRenderTimer : public CRenderTimerGL
+{
+};
+
+#else
+
+class CRenderTimer : public CRenderTimerBase
+{
+};
+
+#endif
@@ -0,0 +1,156 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/Process/VideoBuffer.h"
+#include "utils/TimeUtils.h"
+
+#include <iostream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+void Fill(std::vector<uint8_t> &data)
+{
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+}
+
+void CheckPlane(bool streaming, int width, int height, int srcStride, int dstStride, int dstOffset)
+{
+  std::vector<uint8_t> src(srcStride * height);
+  std::vector<uint8_t> dst(dstStride * height + dstOffset, 0);
+  Fill(src);
+
+  CVideoBuffer::CopyPlane(dst.data() + dstOffset, dstStride, src.data(), srcStride,
+                          width, height, streaming);
+
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < width; x++)
+      ASSERT_EQ(src[y * srcStride + x], dst[dstOffset + y * dstStride + x]) << "row " << y << " column " << x;
+    // padding of the destination must not be touched
+    for (int x = width; x < dstStride && dstOffset + y * dstStride + x < static_cast<int>(dst.size()); x++)
+      ASSERT_EQ(0, dst[dstOffset + y * dstStride + x]) << "row " << y << " column " << x;
+  }
+  for (int i = 0; i < dstOffset; i++)
+    ASSERT_EQ(0, dst[i]);
+}
+
+double MeasurePlane(bool streaming, int width, int height, int frames)
+{
+  std::vector<uint8_t> src(width * height);
+  std::vector<uint8_t> dst(width * height);
+  Fill(src);
+
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < frames; i++)
+    CVideoBuffer::CopyPlane(dst.data(), width, src.data(), width, width, height, streaming);
+  return static_cast<double>(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency() / frames;
+}
+
+}
+
+TEST(TestVideoBuffer, CopyPlane)
+{
+  for (bool streaming : { false, true })
+  {
+    SCOPED_TRACE(streaming ? "streaming" : "memcpy");
+    CheckPlane(streaming, 64, 4, 64, 64, 0);
+    CheckPlane(streaming, 1920, 8, 1920, 1920, 0);
+    CheckPlane(streaming, 1921, 5, 1984, 2048, 0);
+    CheckPlane(streaming, 100, 6, 128, 112, 3);
+    CheckPlane(streaming, 15, 3, 16, 16, 1);
+    CheckPlane(streaming, 1, 2, 4, 4, 5);
+  }
+}
+
+TEST(TestVideoBuffer, CopyNV12Picture)
+{
+  const int width = 322;
+  const int height = 182;
+  std::vector<uint8_t> src(384 * height * 3 / 2);
+  std::vector<uint8_t> dst(width * height * 3 / 2);
+  Fill(src);
+
+  YuvImage srcImage = {};
+  srcImage.plane[0] = src.data();
+  srcImage.plane[1] = src.data() + 384 * height;
+  srcImage.stride[0] = srcImage.stride[1] = 384;
+
+  YuvImage dstImage = {};
+  dstImage.plane[0] = dst.data();
+  dstImage.plane[1] = dst.data() + width * height;
+  dstImage.stride[0] = dstImage.stride[1] = width;
+  dstImage.width = width;
+  dstImage.height = height;
+
+  EXPECT_TRUE(CVideoBuffer::CopyNV12Picture(&dstImage, &srcImage, true));
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      ASSERT_EQ(srcImage.plane[0][y * 384 + x], dstImage.plane[0][y * width + x]);
+  for (int y = 0; y < height / 2; y++)
+    for (int x = 0; x < width; x++)
+      ASSERT_EQ(srcImage.plane[1][y * 384 + x], dstImage.plane[1][y * width + x]);
+}
+
+TEST(TestVideoBuffer, PoolReuse)
+{
+  CVideoBufferManager manager;
+  IVideoBufferPool *first = nullptr;
+  manager.Preallocate(AV_PIX_FMT_YUV420P, 4096, 3);
+  CVideoBuffer *buffer = manager.Get(AV_PIX_FMT_YUV420P, 4096, &first);
+  ASSERT_NE(nullptr, buffer);
+  EXPECT_EQ(nullptr, first);
+  buffer->Release();
+
+  // the released pool serves the next compatible stream
+  manager.ReleasePools();
+  IVideoBufferPool *second = nullptr;
+  buffer = manager.Get(AV_PIX_FMT_YUV420P, 4096, &second);
+  ASSERT_NE(nullptr, buffer);
+  EXPECT_NE(nullptr, second);
+  EXPECT_GT(3, buffer->GetId());
+  buffer->Release();
+
+  // but not an incompatible one
+  manager.ReleasePools();
+  IVideoBufferPool *third = nullptr;
+  buffer = manager.Get(AV_PIX_FMT_YUV420P, 8192, &third);
+  ASSERT_NE(nullptr, buffer);
+  EXPECT_EQ(0, buffer->GetId());
+  buffer->Release();
+}
+
+// microbenchmark, run with --gtest_also_run_disabled_tests
+TEST(TestVideoBuffer, DISABLED_CopyPlaneSpeed)
+{
+  const int frames = 50;
+  const int sizes[][2] = { { 1920, 1080 }, { 3840, 2160 } };
+  for (const auto &size : sizes)
+  {
+    double copy = MeasurePlane(false, size[0], size[1], frames);
+    double stream = MeasurePlane(true, size[0], size[1], frames);
+    std::cout << size[0] << "x" << size[1] << " luma plane: memcpy " << copy
+              << " ms, streaming " << stream << " ms" << std::endl;
+  }
+}
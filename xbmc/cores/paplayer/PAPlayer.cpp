@@ -26,7 +26,9 @@
 #include "music/tags/MusicInfoTag.h"
 #include "utils/log.h"
 #include "utils/JobManager.h"
+#include "utils/Metrics.h"
 #include "video/Bookmark.h"
+#include "URL.h"
 
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
@@ -35,8 +37,8 @@
 #include "cores/VideoPlayer/Process/ProcessInfo.h"
 #include "Util.h"
 
-#define TIME_TO_CACHE_NEXT_FILE 5000 /* 5 seconds before end of song, start caching the next song */
 #define FAST_XFADE_TIME           80 /* 80 milliseconds */
+#define UNDERRUN_CACHE_TIME     0.05 /* a started stream holding less than 50ms of data is starving */
 #define MAX_SKIP_XFADE_TIME     2000 /* max 2 seconds crossfade on track skip */
 
 // PAP: Psycho-acoustic Audio Player
@@ -396,10 +398,7 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   si->m_prepareNextAtFrame = 0;
   // cd drives don't really like it to be crossfaded or prepared
   if(!file.IsCDDA())
-  {
-    if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-      si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
-  }
+    si->m_prepareNextAtFrame = GetPrepareNextAtFrame(si, streamTotalTime);
 
   if (m_currentStream && ((m_currentStream->m_audioFormat.m_dataFormat == AE_FMT_RAW) || (si->m_audioFormat.m_dataFormat == AE_FMT_RAW)))
   {
@@ -437,6 +436,41 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   return true;
 }
 
+int PAPlayer::GetPrepareNextAtFrame(const StreamInfo *si, int64_t streamTotalTime)
+{
+  // the next song is not known yet, assume it comes from the same source and
+  // give network shares enough time to wake up their disks
+  int64_t prefetchTime = si->m_fileItem.IsHD() ? g_advancedSettings.m_musicPrefetchTime : g_advancedSettings.m_musicPrefetchTimeRemote;
+  prefetchTime = prefetchTime * 1000 + m_defaultCrossfadeMS;
+
+  if (streamTotalTime < prefetchTime)
+    return 0;
+
+  return (int)((streamTotalTime - prefetchTime) * si->m_audioFormat.m_sampleRate / 1000.0f);
+}
+
+void PAPlayer::CheckUnderrun(StreamInfo *si, bool hasData)
+{
+  if (hasData || !si->m_started || m_isPaused || si->m_playNextTriggered ||
+      si->m_decoder.GetStatus() == STATUS_ENDING || si->m_decoder.GetStatus() == STATUS_ENDED)
+  {
+    si->m_underrun = false;
+    return;
+  }
+
+  // count every period of starving once
+  if (!si->m_underrun && si->m_stream->GetCacheTime() < UNDERRUN_CACHE_TIME)
+  {
+    si->m_underrun = true;
+    si->m_underruns++;
+    CLog::Log(LOGDEBUG, "PAPlayer::CheckUnderrun - decoder can't keep up, %d underruns", si->m_underruns);
+
+    static CMetricCounter &underruns = CMetrics::GetInstance().GetCounter("kodi_audio_underruns_total",
+      "Times the audio engine stream of the music player ran dry while playing");
+    underruns.Increment();
+  }
+}
+
 void PAPlayer::UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime)
 {
   // if no crossfading or cue sheet, wait for eof
@@ -665,6 +699,10 @@ inline void PAPlayer::ProcessStreams(double &freeBufferTime)
         }
       }
 
+      if (si->m_underruns)
+        CLog::Log(LOGNOTICE, "PAPlayer::ProcessStreams - decoder ran dry %d times playing %s",
+                  si->m_underruns, CURL::GetRedacted(si->m_fileItem.GetDynPath()).c_str());
+
       /* unregister the audio callback */
       si->m_stream->UnRegisterAudioCallback();
       si->m_decoder.Destroy();      
@@ -791,9 +829,7 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
         streamTotalTime = si->m_endOffset - si->m_startOffset;
 
       // calculate time when to prepare next stream
-      si->m_prepareNextAtFrame = 0;
-      if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-        si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
+      si->m_prepareNextAtFrame = GetPrepareNextAtFrame(si, streamTotalTime);
 
       si->m_prepareTriggered = false;
       si->m_playNextAtFrame = 0;
@@ -845,7 +881,10 @@ bool PAPlayer::QueueData(StreamInfo *si)
 
   if (si->m_audioFormat.m_dataFormat != AE_FMT_RAW)
   {
-    unsigned int samples = std::min(si->m_decoder.GetDataSize(false), space / si->m_bytesPerSample);
+    unsigned int available = si->m_decoder.GetDataSize(false);
+    CheckUnderrun(si, available > 0);
+
+    unsigned int samples = std::min(available, space / si->m_bytesPerSample);
     if (!samples)
       return true;
 
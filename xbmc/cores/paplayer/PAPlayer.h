@@ -120,6 +120,9 @@ private:
 
     bool m_isSlaved;                     /* true if the stream has been slaved to another */
     bool m_waitOnDrain;                  /* wait for stream being drained in AE */
+
+    int m_underruns = 0;                 /* number of times the decoder could not keep up */
+    bool m_underrun = false;             /* if the stream is starving right now */
   };
 
   typedef std::list<StreamInfo*> StreamList;
@@ -154,6 +157,8 @@ private:
   bool ProcessStream(StreamInfo *si, double &freeBufferTime);
   bool QueueData(StreamInfo *si);
   int64_t GetTotalTime64();
+  int GetPrepareNextAtFrame(const StreamInfo *si, int64_t streamTotalTime);
+  void CheckUnderrun(StreamInfo *si, bool hasData);
   void UpdateCrossfadeTime(const CFileItem& file);
   void UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime);
   void UpdateGUIData(StreamInfo *si);
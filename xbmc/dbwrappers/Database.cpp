@@ -23,6 +23,7 @@
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/File.h"
 #include "profiles/ProfilesManager.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
@@ -31,6 +32,9 @@
 #include "DbUrl.h"
 #include "ServiceBroker.h"
 
+#include <cctype>
+#include <cstdlib>
+
 #if defined(HAS_MYSQL) || defined(HAS_MARIADB) 
 #include "mysqldataset.h"
 #endif
@@ -42,6 +46,7 @@
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
+#define BATCH_SAVEPOINT    "batch_item"
 
 void CDatabase::Filter::AppendField(const std::string &strField)
 {
@@ -157,6 +162,13 @@ CDatabase::CDatabase() :
   m_sqlite = true;
   m_bMultiWrite = false;
   m_multipleExecute = false;
+  m_batch = false;
+  m_batchMaxItems = 0;
+  m_batchMaxMillis = 0;
+  m_batchItems = 0;
+  m_batchStart = 0;
+  m_batchDepth = 0;
+  m_readOnly = false;
 }
 
 CDatabase::~CDatabase(void)
@@ -373,7 +385,28 @@ bool CDatabase::Open(const DatabaseSettings &settings)
 
   std::string dbName = dbSettings.name;
   dbName += StringUtils::Format("%d", GetSchemaVersion());
-  return Connect(dbName, dbSettings, false);
+  return ConnectPooled(dbName, dbSettings);
+}
+
+bool CDatabase::ConnectPooled(const std::string &dbName, const DatabaseSettings &dbSettings)
+{
+  CDatabaseManager &manager = CServiceBroker::GetDatabaseManager();
+  std::string key = StringUtils::Format("%s|%s|%s|%s|%s", dbSettings.type.c_str(), dbSettings.host.c_str(),
+                                        dbSettings.port.c_str(), dbSettings.user.c_str(), dbName.c_str());
+
+  std::unique_ptr<dbiplus::Database> connection = manager.AcquireConnection(key, m_readOnly);
+  if (connection)
+  {
+    m_pDB = std::move(connection);
+    m_pDS.reset(m_pDB->CreateDataset());
+    m_pDS2.reset(m_pDB->CreateDataset());
+    m_openCount = 1;
+  }
+  else if (!Connect(dbName, dbSettings, false))
+    return false;
+
+  m_poolKey = key;
+  return true;
 }
 
 void CDatabase::InitSettings(DatabaseSettings &dbSettings)
@@ -475,12 +508,9 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
         //  Modern file systems have a cluster/block size of 4k.
         //  To gain better performance when performing write
         //  operations to the database, set the page size of the
-        //  database file to 4k.
+        //  database file to match (4k unless configured otherwise).
         //  This needs to be done before any table is created.
-        m_pDS->exec("PRAGMA page_size=4096\n");
-
-        //  Also set the memory cache size to 16k
-        m_pDS->exec("PRAGMA default_cache_size=4096\n");
+        m_pDS->exec(StringUtils::Format("PRAGMA page_size=%u\n", dbSettings.pageSize));
       }
       CreateDatabase();
     }
@@ -488,9 +518,33 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
     // sqlite3 post connection operations
     if (dbSettings.type == "sqlite3")
     {
-      m_pDS->exec("PRAGMA cache_size=4096\n");
+      // a negative cache size is in KB rather than pages
+      m_pDS->exec(StringUtils::Format("PRAGMA cache_size=-%u\n", dbSettings.cacheSize));
       m_pDS->exec("PRAGMA synchronous='NORMAL'\n");
       m_pDS->exec("PRAGMA count_changes='OFF'\n");
+
+      // in WAL mode readers keep working on the last committed state while
+      // a library scan writes, instead of waiting on the busy handler
+      try
+      {
+        m_pDS->exec(dbSettings.walMode ? "PRAGMA journal_mode=WAL\n" : "PRAGMA journal_mode=DELETE\n");
+        if (dbSettings.walMode)
+          m_pDS->exec(StringUtils::Format("PRAGMA wal_autocheckpoint=%u\n", dbSettings.walAutoCheckpoint));
+        m_pDS->exec(StringUtils::Format("PRAGMA mmap_size=%u\n", dbSettings.mmapSize * 1024 * 1024));
+      }
+      catch (DbErrors &error)
+      {
+        // leaving WAL mode needs exclusive access, just keep going with the current mode
+        CLog::Log(LOGWARNING, "%s unable to apply sqlite tuning to %s: '%s'", __FUNCTION__, dbName.c_str(), error.getMsg());
+      }
+    }
+
+    if (m_readOnly)
+    {
+      if (dbSettings.type == "sqlite3")
+        m_pDS->exec("PRAGMA query_only=ON\n");
+      else
+        m_pDS->exec("SET SESSION TRANSACTION READ ONLY");
     }
   }
   catch (DbErrors &error)
@@ -532,12 +586,25 @@ void CDatabase::Close()
   m_openCount = 0;
   m_multipleExecute = false;
 
+  if (m_batch)
+    EndBatch();
+
+  std::string poolKey;
+  poolKey.swap(m_poolKey);
+
   if (NULL == m_pDB.get() ) return ;
   if (NULL != m_pDS.get()) m_pDS->close();
-  m_pDB->disconnect();
-  m_pDB.reset();
   m_pDS.reset();
   m_pDS2.reset();
+
+  // hand the connection back for reuse, unless it was left in a transaction
+  if (!poolKey.empty() && !m_pDB->in_transaction())
+  {
+    CServiceBroker::GetDatabaseManager().ReleaseConnection(poolKey, m_readOnly, std::move(m_pDB));
+    return;
+  }
+  m_pDB->disconnect();
+  m_pDB.reset();
 }
 
 bool CDatabase::Compress(bool bForce /* =true */)
@@ -576,6 +643,43 @@ bool CDatabase::Compress(bool bForce /* =true */)
   return true;
 }
 
+bool CDatabase::Optimize()
+{
+  if (!m_sqlite)
+    return true;
+
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    m_pDS->exec("PRAGMA quick_check\n");
+    const result_set *res = static_cast<const result_set*>(m_pDS->getExecRes());
+    std::string check = res && !res->records.empty() && res->records[0] ? res->records[0]->at(0).get_asString() : "";
+    if (check != "ok")
+    {
+      CLog::Log(LOGERROR, "%s - %s failed its integrity check: %s", __FUNCTION__, GetBaseDBName(), check.c_str());
+      return false;
+    }
+
+    // PRAGMA optimize only analyzes the tables whose statistics are out of date,
+    // older sqlite versions silently ignore it so analyze everything there
+    if (sqlite3_libversion_number() >= 3018000)
+      m_pDS->exec("PRAGMA optimize\n");
+    else
+      m_pDS->exec("ANALYZE\n");
+
+    CLog::Log(LOGDEBUG, "%s - %s optimized in %u ms", __FUNCTION__, GetBaseDBName(), XbmcThreads::SystemClockMillis() - start);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - Optimizing the database failed", __FUNCTION__);
+    return false;
+  }
+  return true;
+}
+
 void CDatabase::Interrupt()
 {
   m_pDS->interrupt();
@@ -585,7 +689,22 @@ void CDatabase::BeginTransaction()
 {
   try
   {
-    if (NULL != m_pDB.get())
+    if (NULL == m_pDB.get())
+      return;
+
+    if (m_batch)
+    {
+      // the shared transaction is started lazily so nothing is held open between items
+      if (!m_pDB->in_transaction())
+      {
+        m_pDB->start_transaction();
+        m_batchStart = XbmcThreads::SystemClockMillis();
+        m_batchItems = 0;
+      }
+      m_pDB->savepoint(BATCH_SAVEPOINT);
+      m_batchDepth++;
+    }
+    else
       m_pDB->start_transaction();
   }
   catch (...)
@@ -598,7 +717,15 @@ bool CDatabase::CommitTransaction()
 {
   try
   {
-    if (NULL != m_pDB.get())
+    if (NULL == m_pDB.get())
+      return true;
+
+    if (m_batch && m_batchDepth > 0)
+    {
+      m_pDB->release_savepoint(BATCH_SAVEPOINT);
+      m_batchDepth--;
+    }
+    else
       m_pDB->commit_transaction();
   }
   catch (...)
@@ -613,7 +740,15 @@ void CDatabase::RollbackTransaction()
 {
   try
   {
-    if (NULL != m_pDB.get())
+    if (NULL == m_pDB.get())
+      return;
+
+    if (m_batch && m_batchDepth > 0)
+    {
+      m_pDB->rollback_to_savepoint(BATCH_SAVEPOINT);
+      m_batchDepth--;
+    }
+    else
       m_pDB->rollback_transaction();
   }
   catch (...)
@@ -624,10 +759,80 @@ void CDatabase::RollbackTransaction()
 
 bool CDatabase::InTransaction()
 {
-  if (NULL != m_pDB.get()) return false;
+  if (NULL == m_pDB.get()) return false;
   return m_pDB->in_transaction();
 }
 
+void CDatabase::BeginBatch(unsigned int maxItems /* = 100 */, unsigned int maxMillis /* = 1000 */)
+{
+  if (NULL == m_pDB.get() || m_batch)
+    return;
+
+  // writes already in a transaction of their own are left alone
+  if (m_pDB->in_transaction())
+  {
+    CLog::Log(LOGWARNING, "%s - called while in a transaction, not batching", __FUNCTION__);
+    return;
+  }
+
+  m_batch = true;
+  m_batchMaxItems = maxItems > 0 ? maxItems : 1;
+  m_batchMaxMillis = maxMillis;
+  m_batchItems = 0;
+  m_batchDepth = 0;
+}
+
+bool CDatabase::BatchItemDone()
+{
+  if (!m_batch || NULL == m_pDB.get() || !m_pDB->in_transaction())
+    return true;
+
+  m_batchItems++;
+  if (m_batchDepth > 0 ||
+      (m_batchItems < m_batchMaxItems && XbmcThreads::SystemClockMillis() - m_batchStart < m_batchMaxMillis))
+    return true;
+
+  return FlushBatch();
+}
+
+bool CDatabase::FlushBatch()
+{
+  if (!m_batch || NULL == m_pDB.get() || !m_pDB->in_transaction())
+    return true;
+
+  // an item still being written can't be split across commits
+  if (m_batchDepth > 0)
+    return true;
+
+  try
+  {
+    unsigned int items = m_batchItems;
+    m_pDB->commit_transaction();
+    m_batchItems = 0;
+    CLog::Log(LOGDEBUG, "%s - committed %u items in %u ms", __FUNCTION__, items, XbmcThreads::SystemClockMillis() - m_batchStart);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - committing the batch failed", __FUNCTION__);
+    return false;
+  }
+  return true;
+}
+
+bool CDatabase::EndBatch()
+{
+  if (!m_batch)
+    return true;
+
+  // drop the writes of an item that never finished, like an unbatched transaction would
+  while (m_batchDepth > 0)
+    RollbackTransaction();
+
+  bool ret = FlushBatch();
+  m_batch = false;
+  return ret;
+}
+
 bool CDatabase::CreateDatabase()
 {
   BeginTransaction();
@@ -675,6 +880,182 @@ bool CDatabase::BuildSQL(const std::string &strQuery, const Filter &filter, std:
   return true;
 }
 
+bool CDatabase::CreateFullTextIndex(const std::string &index, const std::string &table, const std::string &key, const std::vector<std::string> &columns)
+{
+  if (!m_sqlite || NULL == m_pDB.get() || NULL == m_pDS.get() || columns.empty())
+    return false;
+
+  try
+  {
+    m_pDS->exec(PrepareSQL("DROP TABLE IF EXISTS %s", index.c_str()));
+    m_pDS->exec(PrepareSQL("CREATE VIRTUAL TABLE %s USING fts5(%s, tokenize = 'unicode61 remove_diacritics 1')",
+                           index.c_str(), StringUtils::Join(columns, ", ").c_str()));
+  }
+  catch (...)
+  {
+    CLog::Log(LOGINFO, "%s - full-text search is not available, not indexing %s", __FUNCTION__, table.c_str());
+    return false;
+  }
+
+  try
+  {
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    std::string fields = StringUtils::Join(columns, ", ");
+    std::string values = "new." + key;
+    for (const auto &column : columns)
+      values += ", new." + column;
+
+    // the index holds its own copy of the text so that REPLACE INTO on the
+    // table, which skips the delete trigger, can't leave it inconsistent
+    m_pDS->exec(PrepareSQL("CREATE TRIGGER %s_insert AFTER INSERT ON %s FOR EACH ROW BEGIN "
+                           "INSERT OR REPLACE INTO %s (rowid, %s) VALUES (%s); END",
+                           index.c_str(), table.c_str(), index.c_str(), fields.c_str(), values.c_str()));
+    m_pDS->exec(PrepareSQL("CREATE TRIGGER %s_update AFTER UPDATE OF %s ON %s FOR EACH ROW BEGIN "
+                           "INSERT OR REPLACE INTO %s (rowid, %s) VALUES (%s); END",
+                           index.c_str(), fields.c_str(), table.c_str(), index.c_str(), fields.c_str(), values.c_str()));
+    m_pDS->exec(PrepareSQL("CREATE TRIGGER %s_delete AFTER DELETE ON %s FOR EACH ROW BEGIN "
+                           "DELETE FROM %s WHERE rowid = old.%s; END",
+                           index.c_str(), table.c_str(), index.c_str(), key.c_str()));
+    m_pDS->exec(PrepareSQL("INSERT INTO %s (rowid, %s) SELECT %s, %s FROM %s",
+                           index.c_str(), fields.c_str(), key.c_str(), fields.c_str(), table.c_str()));
+    CLog::Log(LOGDEBUG, "%s - indexed %s in %u ms", __FUNCTION__, table.c_str(), XbmcThreads::SystemClockMillis() - start);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - unable to index %s", __FUNCTION__, table.c_str());
+    try
+    {
+      m_pDS->exec(PrepareSQL("DROP TABLE IF EXISTS %s", index.c_str()));
+    }
+    catch (...)
+    {
+    }
+    return false;
+  }
+  return true;
+}
+
+bool CDatabase::HasFullTextIndex(const std::string &index)
+{
+  if (!m_sqlite)
+    return false;
+
+  return GetSingleValue(PrepareSQL("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = '%s'", index.c_str())) == "1";
+}
+
+bool CDatabase::AppendFullTextSearch(const std::string &index, const std::string &key, const std::vector<std::string> &columns, const std::string &search, Filter &filter)
+{
+  std::string query = GetFullTextQuery(StringUtils::Split(search, " "));
+  if (query.empty() || !HasFullTextIndex(index))
+    return false;
+
+  if (!columns.empty())
+    query = "{" + StringUtils::Join(columns, " ") + "} : (" + query + ")";
+
+  filter.AppendJoin(PrepareSQL(" JOIN %s ON %s.rowid = %s", index.c_str(), index.c_str(), key.c_str()));
+  filter.AppendWhere(PrepareSQL("%s MATCH '%s'", index.c_str(), query.c_str()));
+  filter.AppendOrder(index + ".rank");
+  return true;
+}
+
+std::string CDatabase::GetFullTextQuery(const std::vector<std::string> &terms, bool matchAll /* = true */)
+{
+  std::vector<std::string> phrases;
+  for (const auto &term : terms)
+  {
+    // terms without letters or digits are dropped by the tokenizer, and
+    // an empty phrase would make the whole query fail
+    bool hasWord = false;
+    for (unsigned char c : term)
+    {
+      if (isalnum(c) || c >= 0x80)
+      {
+        hasWord = true;
+        break;
+      }
+    }
+    if (!hasWord)
+      continue;
+
+    std::string phrase(term);
+    StringUtils::Replace(phrase, "\"", "\"\"");
+    phrases.push_back("\"" + phrase + "\"*");
+  }
+  return StringUtils::Join(phrases, matchAll ? " AND " : " OR ");
+}
+
+void CDatabase::CreateRevisionTable()
+{
+  // SQLite hands out the rowid of a replaced row again unless told otherwise, which would
+  // move a changed item back to a revision a client may have seen already. MySQL gets
+  // auto_increment added to the integer primary key by the dataset.
+  m_pDS->exec(PrepareSQL("CREATE TABLE revision (revision INTEGER PRIMARY KEY%s, media_id INTEGER, media_type TEXT, deleted INTEGER)",
+                         m_sqlite ? " AUTOINCREMENT" : ""));
+}
+
+void CDatabase::CreateRevisionIndex()
+{
+  m_pDS->exec("CREATE UNIQUE INDEX ix_revision_1 ON revision (media_type(20), media_id)");
+  m_pDS->exec("CREATE INDEX ix_revision_2 ON revision (media_type(20), revision)");
+}
+
+void CDatabase::CreateRevisionTriggers(const std::string &mediaType, const std::string &table, const std::string &key)
+{
+  std::string revision = GetRevisionSQL(mediaType, "new." + key, false);
+  m_pDS->exec(PrepareSQL("CREATE TRIGGER revision_%s_insert AFTER INSERT ON %s FOR EACH ROW BEGIN %sEND",
+                         table.c_str(), table.c_str(), revision.c_str()));
+  m_pDS->exec(PrepareSQL("CREATE TRIGGER revision_%s_update AFTER UPDATE ON %s FOR EACH ROW BEGIN %sEND",
+                         table.c_str(), table.c_str(), revision.c_str()));
+}
+
+std::string CDatabase::GetRevisionSQL(const std::string &mediaType, const std::string &id, bool deleted, const std::string &from /* = "" */)
+{
+  // replacing the row of the item gives it the next revision, deleted ones are kept so
+  // that clients learn about the removal
+  if (from.empty())
+    return StringUtils::Format("REPLACE INTO revision (media_id, media_type, deleted) VALUES (%s, '%s', %i); ",
+                               id.c_str(), mediaType.c_str(), deleted ? 1 : 0);
+  return StringUtils::Format("REPLACE INTO revision (media_id, media_type, deleted) SELECT %s, '%s', %i FROM %s; ",
+                             id.c_str(), mediaType.c_str(), deleted ? 1 : 0, from.c_str());
+}
+
+std::string CDatabase::GetChangedSinceCondition(const std::string &key, const std::string &mediaType, int revision) const
+{
+  return PrepareSQL("%s IN (SELECT media_id FROM revision WHERE media_type = '%s' AND revision > %i AND deleted = 0)",
+                    key.c_str(), mediaType.c_str(), revision);
+}
+
+int CDatabase::GetRevision()
+{
+  return static_cast<int>(strtol(GetSingleValue("SELECT MAX(revision) FROM revision").c_str(), nullptr, 10));
+}
+
+bool CDatabase::GetRemovedSince(const std::string &mediaType, int revision, std::vector<int> &ids)
+{
+  if (NULL == m_pDB.get() || NULL == m_pDS.get())
+    return false;
+
+  try
+  {
+    if (!m_pDS->query(PrepareSQL("SELECT media_id FROM revision WHERE media_type = '%s' AND revision > %i AND deleted = 1",
+                                 mediaType.c_str(), revision)))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      ids.push_back(m_pDS->fv(0).get_asInt());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed for %s since %i", __FUNCTION__, mediaType.c_str(), revision);
+  }
+  return false;
+}
+
 bool CDatabase::BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl)
 {
   SortDescription sorting;
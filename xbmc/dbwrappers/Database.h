@@ -79,14 +79,54 @@ public:
   bool IsOpen();
   virtual void Close();
   bool Compress(bool bForce=true);
+  /*! \brief Check the integrity of an sqlite database and refresh the statistics used by the query planner.
+   \return false if the database is damaged or the check couldn't be run.
+   */
+  bool Optimize();
   void Interrupt();
 
   bool Open(const DatabaseSettings &db);
 
+  /*! \brief Only read from the database through this instance.
+   Must be called before Open(). Read only instances take their connection from a separate
+   pool, and the connection refuses writes.
+   */
+  void SetReadOnly(bool readOnly) { m_readOnly = readOnly; }
+
   void BeginTransaction();
   virtual bool CommitTransaction();
   void RollbackTransaction();
   bool InTransaction();
+
+  /*! \brief Group the transactions of the following writes into larger ones.
+   Meant for bulk writers like the library scanners. While batching, BeginTransaction(),
+   CommitTransaction() and RollbackTransaction() work on a savepoint inside one shared
+   transaction, so a rolled back item still only undoes its own writes. The shared
+   transaction is committed by BatchItemDone() once it covers \p maxItems items or has
+   been open for \p maxMillis, which bounds both the work lost if Kodi goes away mid scan
+   and how long other connections wait to write.
+   \param maxItems number of items to commit at once.
+   \param maxMillis longest time to keep the shared transaction open.
+   \sa BatchItemDone, FlushBatch, EndBatch
+   */
+  void BeginBatch(unsigned int maxItems = 100, unsigned int maxMillis = 1000);
+
+  /*! \brief Mark the end of one item's writes, committing the batch if it is due.
+   \return false if committing failed.
+   */
+  bool BatchItemDone();
+
+  /*! \brief Commit the writes batched so far, e.g. before waiting on something slow.
+   \return false if committing failed.
+   */
+  bool FlushBatch();
+
+  /*! \brief Commit the pending writes and return to one transaction per BeginTransaction().
+   \return false if committing failed.
+   */
+  bool EndBatch();
+
+  bool InBatch() const { return m_batch; }
   void CopyDB(const std::string& latestDb);
   void DropAnalytics();
 
@@ -170,6 +210,22 @@ public:
    */
   bool CommitInsertQueries();
 
+  /*! \brief Get the current revision of the library.
+   Every change to an item of a table with revision triggers moves the library to a new
+   revision, see CreateRevisionTriggers(). Clients keep the revision of their last listing
+   and ask for the items changed and removed since, rather than listing everything again.
+   \return the revision, 0 if nothing was changed yet or the database has no revisions.
+   */
+  int GetRevision();
+
+  /*! \brief Get the items of a media type that were removed after a revision.
+   \param mediaType the media type of the items, e.g. "movie".
+   \param revision the revision the client last saw.
+   \param ids the ids of the removed items.
+   \return false if the query failed.
+   */
+  bool GetRemovedSince(const std::string &mediaType, int revision, std::vector<int> &ids);
+
   virtual bool GetFilter(CDbUrl &dbUrl, Filter &filter, SortDescription &sorting) { return true; }
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl);
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl, SortDescription &sorting);
@@ -217,6 +273,75 @@ protected:
 
   bool BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL);
 
+  /*! \brief Create a full-text index over some columns of a table, kept up to date by triggers.
+   Only SQLite builds with FTS5 support this, elsewhere searches fall back to LIKE.
+   Meant to be called from CreateAnalytics(), an existing index is dropped and rebuilt.
+   \param index name of the index table to create.
+   \param table the table to index.
+   \param key the integer primary key of the table.
+   \param columns the text columns to index.
+   \return true if the index was created, false otherwise.
+   */
+  bool CreateFullTextIndex(const std::string &index, const std::string &table, const std::string &key, const std::vector<std::string> &columns);
+
+  /*! \brief Check whether an index created by CreateFullTextIndex() is available.
+   */
+  bool HasFullTextIndex(const std::string &index);
+
+  /*! \brief Restrict a query to the rows matching a full-text search, best matches first.
+   Every word of the search has to match the start of a word in one of the searched columns.
+   \param index the index created by CreateFullTextIndex().
+   \param key the column the rowid of the index refers to, e.g. "movie.idMovie".
+   \param columns the indexed columns to search, all of them if empty.
+   \param search the words to search for.
+   \param filter the filter to add the join, condition and ordering to.
+   \return false if the index isn't available or the search has no words. The filter is left untouched then.
+   */
+  bool AppendFullTextSearch(const std::string &index, const std::string &key, const std::vector<std::string> &columns, const std::string &search, Filter &filter);
+
+  /*! \brief Build a full-text query from a list of terms, each matched as a (phrase) prefix.
+   \param terms the words or phrases to search for.
+   \param matchAll true if all terms have to match, false if any of them is enough.
+   \return the query, or an empty string if none of the terms contains anything to search for.
+   */
+  static std::string GetFullTextQuery(const std::vector<std::string> &terms, bool matchAll = true);
+
+  /*! \brief Create the table holding the revision each item was last changed in.
+   Called from CreateTables() and from UpdateTables() of the version adding it.
+   */
+  void CreateRevisionTable();
+
+  /*! \brief Create the indexes of the revision table.
+   Meant to be called from CreateAnalytics(), before any revision triggers are created.
+   */
+  void CreateRevisionIndex();
+
+  /*! \brief Create the triggers moving the items of a table to a new revision when they are
+   added or changed.
+   Meant to be called from CreateAnalytics(). Deletes have to append GetRevisionSQL() to the
+   delete trigger of the table, as MySQL allows only one trigger per table and event.
+   \param mediaType the media type of the items, e.g. "movie".
+   \param table the table of the items.
+   \param key the integer primary key of the table.
+   */
+  void CreateRevisionTriggers(const std::string &mediaType, const std::string &table, const std::string &key);
+
+  /*! \brief Statement for a trigger body moving items to a new revision.
+   \param mediaType the media type of the items.
+   \param id the id of the item, e.g. "old.idMovie", or the id column if \p from is given.
+   \param deleted true if the item was removed.
+   \param from FROM and WHERE clause selecting several items, e.g. "movie WHERE idFile=new.idFile".
+   \return the statement, terminated with "; ".
+   */
+  static std::string GetRevisionSQL(const std::string &mediaType, const std::string &id, bool deleted, const std::string &from = "");
+
+  /*! \brief Condition restricting a query to the items changed after a revision.
+   \param key the column holding the id of the items, e.g. "movie_view.idMovie".
+   \param mediaType the media type of the items.
+   \param revision the revision the client last saw.
+   */
+  std::string GetChangedSinceCondition(const std::string &key, const std::string &mediaType, int revision) const;
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::unique_ptr<dbiplus::Database> m_pDB;
@@ -230,10 +355,21 @@ protected:
 private:
   void InitSettings(DatabaseSettings &dbSettings);
   void UpdateVersionNumber();
+  bool ConnectPooled(const std::string &dbName, const DatabaseSettings &dbSettings);
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  bool m_batch;                 ///< true between BeginBatch() and EndBatch()
+  unsigned int m_batchMaxItems;
+  unsigned int m_batchMaxMillis;
+  unsigned int m_batchItems;    ///< items written in the open batch transaction
+  unsigned int m_batchStart;    ///< when the open batch transaction was started
+  unsigned int m_batchDepth;    ///< number of open savepoints
+
+  bool m_readOnly;
+  std::string m_poolKey; ///< key of the connection pool m_pDB goes back to on Close(), empty if not pooled
 };
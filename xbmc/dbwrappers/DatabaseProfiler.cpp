@@ -0,0 +1,214 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DatabaseProfiler.h"
+#include "dataset.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#include "utils/Metrics.h"
+#include "utils/StringUtils.h"
+#include "utils/Trace.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <cctype>
+#include <vector>
+
+#define MAX_TEMPLATES 1000 // statements of further templates are only counted as dropped
+
+CDatabaseProfiler& CDatabaseProfiler::GetInstance()
+{
+  static CDatabaseProfiler sProfiler;
+  return sProfiler;
+}
+
+bool CDatabaseProfiler::IsActive()
+{
+  return g_advancedSettings.m_databaseProfiling || g_advancedSettings.m_databaseSlowQueryTime > 0;
+}
+
+void CDatabaseProfiler::Record(dbiplus::Database *db, const std::string &sql, double duration, int rows)
+{
+  std::string database = URIUtils::GetFileName(db->getDatabase());
+  std::string query = GetTemplate(sql);
+
+  unsigned int slowQueryTime = g_advancedSettings.m_databaseSlowQueryTime;
+  if (slowQueryTime > 0 && duration >= slowQueryTime)
+  {
+    std::string plan;
+    try
+    {
+      plan = db->explain_query(sql);
+    }
+    catch (...)
+    {
+    }
+    CLog::Log(LOGWARNING, "CDatabaseProfiler: %.1f ms, %d rows on %s: %s%s%s", duration, rows,
+              database.c_str(), query.c_str(), plan.empty() ? "" : "\n", plan.c_str());
+  }
+
+  if (!g_advancedSettings.m_databaseProfiling)
+    return;
+
+  CSingleLock lock(m_section);
+  auto key = std::make_pair(database, query);
+  auto it = m_statistics.find(key);
+  if (it == m_statistics.end())
+  {
+    if (m_statistics.size() >= MAX_TEMPLATES)
+    {
+      m_dropped++;
+      return;
+    }
+    it = m_statistics.insert(std::make_pair(key, Statistics())).first;
+  }
+
+  Statistics &stats = it->second;
+  stats.count++;
+  stats.totalTime += duration;
+  stats.maxTime = std::max(stats.maxTime, duration);
+  if (rows >= 0)
+    stats.rows += rows;
+  else
+    stats.failed++;
+}
+
+void CDatabaseProfiler::GetStatistics(CVariant &result, unsigned int limit) const
+{
+  CSingleLock lock(m_section);
+
+  std::vector<StatisticsMap::const_iterator> sorted;
+  sorted.reserve(m_statistics.size());
+  for (auto it = m_statistics.begin(); it != m_statistics.end(); ++it)
+    sorted.push_back(it);
+  std::sort(sorted.begin(), sorted.end(), [](StatisticsMap::const_iterator a, StatisticsMap::const_iterator b)
+  {
+    return a->second.totalTime > b->second.totalTime;
+  });
+
+  result["queries"] = CVariant(CVariant::VariantTypeArray);
+  result["dropped"] = m_dropped;
+
+  for (unsigned int i = 0; i < sorted.size() && i < limit; i++)
+  {
+    const Statistics &stats = sorted[i]->second;
+    CVariant entry(CVariant::VariantTypeObject);
+    entry["database"] = sorted[i]->first.first;
+    entry["query"] = sorted[i]->first.second;
+    entry["count"] = stats.count;
+    entry["failed"] = stats.failed;
+    entry["totaltime"] = stats.totalTime;
+    entry["averagetime"] = stats.totalTime / stats.count;
+    entry["maxtime"] = stats.maxTime;
+    entry["rows"] = stats.rows;
+    result["queries"].push_back(entry);
+  }
+}
+
+void CDatabaseProfiler::Reset()
+{
+  CSingleLock lock(m_section);
+  m_statistics.clear();
+  m_dropped = 0;
+}
+
+std::string CDatabaseProfiler::GetTemplate(const std::string &sql)
+{
+  std::string result;
+  result.reserve(sql.size());
+
+  for (size_t i = 0; i < sql.size(); i++)
+  {
+    char c = sql[i];
+    char last = result.empty() ? ' ' : result.back();
+    if (c == '\'')
+    {
+      // string literal, quotes in it are doubled
+      size_t end = i + 1;
+      while (end < sql.size())
+      {
+        if (sql[end] == '\'' && end + 1 < sql.size() && sql[end + 1] == '\'')
+          end += 2;
+        else if (sql[end] == '\'')
+          break;
+        else
+          end++;
+      }
+      result += '?';
+      i = end;
+    }
+    else if (isdigit(static_cast<unsigned char>(c)) && !isalnum(static_cast<unsigned char>(last)) && last != '_' && last != '.')
+    {
+      // numeric literal, but not the digits of an identifier like c05
+      while (i + 1 < sql.size() && (isalnum(static_cast<unsigned char>(sql[i + 1])) || sql[i + 1] == '.'))
+        i++;
+      result += '?';
+    }
+    else if (isspace(static_cast<unsigned char>(c)))
+    {
+      if (last != ' ')
+        result += ' ';
+    }
+    else
+      result += c;
+  }
+  StringUtils::Trim(result);
+
+  // lists of values differ in length only, so collapse them
+  std::string collapsed;
+  while (collapsed != result)
+  {
+    collapsed = result;
+    StringUtils::Replace(result, "?, ?", "?");
+    StringUtils::Replace(result, "?,?", "?");
+    StringUtils::Replace(result, "(?), (?)", "(?)");
+    StringUtils::Replace(result, "(?),(?)", "(?)");
+  }
+  return result;
+}
+
+CDatabaseProfileScope::CDatabaseProfileScope(dbiplus::Database *db, const std::string &sql)
+  : m_db(db)
+  , m_sql(sql)
+  , m_start(static_cast<int64_t>(XbmcThreads::SystemClockNanos()))
+  , m_traceStart(CTrace::IsRunning() ? CTrace::Now() : -1)
+  , m_profile(CDatabaseProfiler::IsActive())
+{
+}
+
+CDatabaseProfileScope::~CDatabaseProfileScope()
+{
+  if (m_traceStart >= 0)
+    CTrace::Span("database", "query", m_traceStart, m_sql);
+
+  double duration = (XbmcThreads::SystemClockNanos() - m_start) / 1000000.0;
+
+  static CMetricHistogram &queryTimes = CMetrics::GetInstance().GetHistogram("kodi_database_query_time_ms",
+    "Time the database statements took in ms", { 0.1, 0.5, 1, 2, 5, 10, 25, 50, 100, 250, 1000 });
+  queryTimes.Observe(duration);
+
+  if (!m_profile || !m_db)
+    return;
+
+  CDatabaseProfiler::GetInstance().Record(m_db, m_sql, duration, m_rows);
+}
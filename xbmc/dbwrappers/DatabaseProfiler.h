@@ -0,0 +1,124 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "threads/CriticalSection.h"
+
+class CVariant;
+
+namespace dbiplus
+{
+  class Database;
+}
+
+/*!
+ \brief Collects timings and row counts of the statements run through the dbiplus datasets.
+
+ Statements are grouped by template, i.e. with their literals replaced by ?, so that
+ the lookups of different items add up. Statements taking longer than the slow query
+ time are logged along with their query plan.
+
+ Configured in advancedsettings.xml:
+ \code
+ <databaseprofiler>
+   <enabled>true</enabled>             <!-- collect statistics per template -->
+   <slowquerytime>200</slowquerytime>  <!-- log statements slower than this many ms, 0 to disable -->
+ </databaseprofiler>
+ \endcode
+ */
+class CDatabaseProfiler
+{
+public:
+  static CDatabaseProfiler& GetInstance();
+
+  /*! \brief Whether statements have to be timed at all.
+   */
+  static bool IsActive();
+
+  /*! \brief Record a statement that ran.
+   \param db the connection it ran on, used to get the plan of slow statements.
+   \param sql the statement.
+   \param duration how long it took, in ms.
+   \param rows number of rows returned or changed, -1 if it failed.
+   */
+  void Record(dbiplus::Database *db, const std::string &sql, double duration, int rows);
+
+  /*! \brief Get the statistics per template, largest total time first.
+   \param result object to fill with the "queries" array and the number of "dropped" statements.
+   \param limit maximum number of templates to return.
+   */
+  void GetStatistics(CVariant &result, unsigned int limit) const;
+
+  /*! \brief Forget the statistics collected so far.
+   */
+  void Reset();
+
+  /*! \brief Replace the literals of a statement with ? and collapse lists of them.
+   */
+  static std::string GetTemplate(const std::string &sql);
+
+private:
+  CDatabaseProfiler() = default;
+  CDatabaseProfiler(const CDatabaseProfiler&) = delete;
+  CDatabaseProfiler& operator=(const CDatabaseProfiler&) = delete;
+
+  struct Statistics
+  {
+    unsigned int count = 0;
+    unsigned int failed = 0;
+    double totalTime = 0.0;
+    double maxTime = 0.0;
+    uint64_t rows = 0;
+  };
+
+  typedef std::map<std::pair<std::string, std::string>, Statistics> StatisticsMap;
+
+  mutable CCriticalSection m_section;
+  StatisticsMap m_statistics;   ///< by database and template
+  unsigned int m_dropped = 0;   ///< statements not counted as there were too many templates
+};
+
+/*!
+ \brief Times a statement for CDatabaseProfiler while in scope.
+
+ The time is also counted into the kodi_database_query_time_ms metric, which
+ doesn't depend on the profiler being enabled.
+ */
+class CDatabaseProfileScope
+{
+public:
+  CDatabaseProfileScope(dbiplus::Database *db, const std::string &sql);
+  ~CDatabaseProfileScope();
+
+  void SetRows(int rows) { m_rows = rows; }
+
+private:
+  dbiplus::Database *m_db;
+  const std::string &m_sql;
+  int64_t m_start;
+  int64_t m_traceStart;
+  bool m_profile;
+  int m_rows = -1;
+};
@@ -82,6 +82,48 @@ std::string Database::prepare(const char *format, ...)
   return result;
 }
 
+std::string Database::bind(const std::string &sql, const sql_record &params)
+{
+  std::string result;
+  result.reserve(sql.size());
+  size_t param = 0;
+  bool quoted = false;
+  for (char c : sql)
+  {
+    if (c == '\'')
+      quoted = !quoted;
+    if (c != '?' || quoted)
+    {
+      result += c;
+      continue;
+    }
+    if (param >= params.size())
+      throw DbErrors("Missing value for parameter %u of %s", static_cast<unsigned int>(param + 1), sql.c_str());
+
+    const field_value &value = params[param++];
+    if (value.get_isNull())
+      result += "NULL";
+    else switch (value.get_fType())
+    {
+    case ft_String:
+    case ft_Char:
+    case ft_WChar:
+    case ft_WideString:
+      result += prepare("'%s'", value.get_asString().c_str());
+      break;
+    case ft_Boolean:
+      result += value.get_asBool() ? "1" : "0";
+      break;
+    default:
+      result += value.get_asString();
+      break;
+    }
+  }
+  if (param != params.size())
+    throw DbErrors("Too many values for %s", sql.c_str());
+  return result;
+}
+
 //************* Dataset implementation ***************
 
 Dataset::Dataset():
@@ -202,6 +244,19 @@ void Dataset::parse_sql(std::string &sql) {
 }
 
 
+bool Dataset::query(const std::string &sql, const sql_record &params) {
+  return query(db->bind(sql, params));
+}
+
+int Dataset::exec(const std::string &sql, const sql_record &params) {
+  return exec(db->bind(sql, params));
+}
+
+bool Dataset::query_forward_only(const std::string &sql) {
+  return query(sql);
+}
+
+
 void Dataset::close(void) {
   haveError  = false;
   frecno = 0;
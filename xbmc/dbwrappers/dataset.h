@@ -147,6 +147,16 @@ public:
   virtual void commit_transaction() {};
   virtual void rollback_transaction() {};
 
+/* savepoints nest inside a transaction, used to batch several transactions into one */
+
+  virtual void savepoint(const char *name) {};
+  virtual void release_savepoint(const char *name) {};
+  virtual void rollback_to_savepoint(const char *name) {};
+
+/* describe how a statement is executed, one step per line, empty if not supported */
+
+  virtual std::string explain_query(const std::string &sql) { return ""; }
+
 /* virtual methods for formatting */
 
   /*! \brief Prepare a SQL statement for execution or querying using C printf nomenclature.
@@ -163,6 +173,14 @@ public:
    */
   virtual std::string vprepare(const char *format, va_list args) = 0;
 
+  /*! \brief Substitute values for the ? placeholders of a SQL statement.
+   Used by backends that can't bind the values to a prepared statement.
+   \param sql - statement with one ? per value.
+   \param params - values for the placeholders, strings are quoted and escaped.
+   \return the statement with the values filled in.
+   */
+  virtual std::string bind(const std::string &sql, const sql_record &params);
+
   virtual bool in_transaction() {return false;};
 
 };
@@ -308,6 +326,14 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
+/* as query and exec, with the values bound to the ? placeholders of the statement.
+   Backends that can, keep the parsed statement for the next call with the same sql */
+  virtual bool query(const std::string &sql, const sql_record &params);
+  virtual int  exec(const std::string &sql, const sql_record &params);
+/* as query, but the rows are read one at a time while moving through them with next().
+   Only eof(), next(), fv(), get_sql_record() and num_rows() (the rows read so far) may be
+   used on the result. Backends without cursors read the whole result as query does */
+  virtual bool query_forward_only(const std::string &sql);
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
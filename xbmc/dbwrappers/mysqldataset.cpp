@@ -29,6 +29,7 @@
 #include "utils/StringUtils.h"
 
 #include "mysqldataset.h"
+#include "DatabaseProfiler.h"
 #ifdef HAS_MYSQL
 #include "mysql/errmsg.h"
 #elif defined(HAS_MARIADB)
@@ -530,6 +531,59 @@ void MysqlDatabase::rollback_transaction() {
   }
 }
 
+void MysqlDatabase::savepoint(const char *name) {
+  if (active)
+    query_with_reconnect(("SAVEPOINT " + std::string(name)).c_str());
+}
+
+void MysqlDatabase::release_savepoint(const char *name) {
+  if (active)
+    query_with_reconnect(("RELEASE SAVEPOINT " + std::string(name)).c_str());
+}
+
+void MysqlDatabase::rollback_to_savepoint(const char *name) {
+  if (active)
+  {
+    // rolling back to a savepoint leaves it in place
+    query_with_reconnect(("ROLLBACK TO SAVEPOINT " + std::string(name)).c_str());
+    query_with_reconnect(("RELEASE SAVEPOINT " + std::string(name)).c_str());
+  }
+}
+
+std::string MysqlDatabase::explain_query(const std::string &sql) {
+  std::string plan;
+  // only selects can be explained on all supported server versions
+  std::string statement = sql;
+  StringUtils::TrimLeft(statement);
+  if (!active || !StringUtils::StartsWithNoCase(statement, "select"))
+    return plan;
+
+  if (query_with_reconnect(("EXPLAIN " + sql).c_str()) != MYSQL_OK)
+    return plan;
+
+  MYSQL_RES *res = mysql_store_result(conn);
+  if (res == NULL)
+    return plan;
+
+  const unsigned int numColumns = mysql_num_fields(res);
+  MYSQL_FIELD *fields = mysql_fetch_fields(res);
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(res)))
+  {
+    if (!plan.empty())
+      plan += "\n";
+    for (unsigned int i = 0; i < numColumns; i++)
+    {
+      if (row[i] == NULL)
+        continue;
+      plan += StringUtils::Format("%s=%s ", fields[i].name, row[i]);
+    }
+    StringUtils::TrimRight(plan);
+  }
+  mysql_free_result(res);
+  return plan;
+}
+
 bool MysqlDatabase::exists(void) {
   bool ret = false;
 
@@ -1519,6 +1573,7 @@ int MysqlDataset::exec(const std::string &sql) {
 
   CLog::Log(LOGDEBUG,"Mysql execute: %s", qry.c_str());
 
+  CDatabaseProfileScope profile(db, qry);
   if (db->setErr( static_cast<MysqlDatabase*>(db)->query_with_reconnect(qry.c_str()), qry.c_str()) != MYSQL_OK)
   {
     throw DbErrors(db->getErrorMsg());
@@ -1526,6 +1581,7 @@ int MysqlDataset::exec(const std::string &sql) {
   else
   {
     //! @todo collect results and store in exec_res
+    profile.SetRows(static_cast<int>(mysql_affected_rows(handle())));
     return res;
   }
 }
@@ -1556,6 +1612,7 @@ bool MysqlDataset::query(const std::string &query) {
 
   MYSQL_RES *stmt = NULL;
 
+  CDatabaseProfileScope profile(db, qry);
   if ( static_cast<MysqlDatabase*>(db)->setErr(static_cast<MysqlDatabase*>(db)->query_with_reconnect(qry.c_str()), qry.c_str()) != MYSQL_OK )
     throw DbErrors(db->getErrorMsg());
 
@@ -1576,10 +1633,9 @@ bool MysqlDataset::query(const std::string &query) {
   while ((row = mysql_fetch_row(stmt)))
   { // have a row of data
     sql_record *res = new sql_record;
-    res->resize(numColumns);
     for (unsigned int i = 0; i < numColumns; i++)
     {
-      field_value &v = res->at(i);
+      field_value v;
       switch (fields[i].type)
       {
         case MYSQL_TYPE_LONGLONG:
@@ -1627,10 +1683,12 @@ bool MysqlDataset::query(const std::string &query) {
           v.set_isNull();
           break;
       }
+      res->push_back(v);
     }
     result.records.push_back(res);
   }
   mysql_free_result(stmt);
+  profile.SetRows(result.records.size());
   active = true;
   ds_state = dsSelect;
   this->first();
@@ -83,6 +83,12 @@ public:
   void commit_transaction() override;
   void rollback_transaction() override;
 
+  void savepoint(const char *name) override;
+  void release_savepoint(const char *name) override;
+  void rollback_to_savepoint(const char *name) override;
+
+  std::string explain_query(const std::string &sql) override;
+
 /* virtual methods for formatting */
   std::string vprepare(const char *format, va_list args) override;
 
@@ -150,9 +156,11 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   int  exec () override;
   int  exec (const std::string &sql) override;
+  using Dataset::exec;
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+  using Dataset::query;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
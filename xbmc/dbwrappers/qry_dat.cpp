@@ -35,6 +35,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <cstring>
+#include <stdexcept>
 
 #ifndef __GNUC__
 #pragma warning (disable:4800)
@@ -56,6 +58,13 @@ field_value::field_value(const char *s):
   field_type = ft_String;
   is_null = false;
 }
+
+field_value::field_value(const std::string &s):
+  str_value(s)
+{
+  field_type = ft_String;
+  is_null = false;
+}
   
 field_value::field_value(const bool b) {
   bool_value = b; 
@@ -740,4 +749,187 @@ std::string field_value::gft() {
   return tmp;
   }
 
+
+//************* sql_record implementation ***************
+
+// tag of a null cell, other cells are tagged with their fType
+#define CELL_NULL 0xff
+
+sql_record::sql_record(std::initializer_list<field_value> values)
+{
+  for (const field_value &value : values)
+    push_back(value);
+}
+
+void sql_record::clear()
+{
+  offsets.clear();
+  data.clear();
+}
+
+void sql_record::reserve(size_t cells, size_t bytes)
+{
+  offsets.reserve(cells);
+  data.reserve(bytes);
+}
+
+size_t sql_record::string_size(size_t length)
+{
+  return 1 + sizeof(uint32_t) + length + 1;
+}
+
+size_t sql_record::number_size()
+{
+  return 1 + sizeof(int64_t);
+}
+
+void sql_record::push_back(const field_value &value)
+{
+  if (value.get_isNull())
+  {
+    push_null();
+    return;
+  }
+
+  const unsigned char tag = static_cast<unsigned char>(value.get_fType());
+  switch (value.get_fType())
+  {
+  case ft_Boolean:
+  case ft_Char:
+  case ft_Short:
+  case ft_UShort:
+  case ft_Int:
+  case ft_UInt:
+  case ft_Int64:
+  {
+    int64_t number = value.get_asInt64();
+    push_number(tag, &number);
+    break;
+  }
+  case ft_Float:
+  case ft_Double:
+  case ft_LongDouble:
+  {
+    double number = value.get_asDouble();
+    push_number(tag, &number);
+    break;
+  }
+  default:
+  {
+    std::string str = value.get_asString();
+    push_string(str.c_str(), str.size());
+    break;
+  }
+  }
+}
+
+void sql_record::push_null()
+{
+  offsets.push_back(static_cast<uint32_t>(data.size()));
+  data.push_back(static_cast<char>(CELL_NULL));
+}
+
+void sql_record::push_int64(int64_t value)
+{
+  push_number(ft_Int64, &value);
+}
+
+void sql_record::push_double(double value)
+{
+  push_number(ft_Double, &value);
+}
+
+void sql_record::push_number(unsigned char tag, const void *value)
+{
+  offsets.push_back(static_cast<uint32_t>(data.size()));
+  data.push_back(static_cast<char>(tag));
+  const char *bytes = static_cast<const char*>(value);
+  data.insert(data.end(), bytes, bytes + sizeof(int64_t));
+}
+
+void sql_record::push_string(const char *str, size_t length)
+{
+  offsets.push_back(static_cast<uint32_t>(data.size()));
+  data.push_back(static_cast<char>(ft_String));
+  uint32_t len = static_cast<uint32_t>(length);
+  const char *bytes = reinterpret_cast<const char*>(&len);
+  data.insert(data.end(), bytes, bytes + sizeof(len));
+  data.insert(data.end(), str, str + length);
+  data.push_back('\0');
+}
+
+const char *sql_record::cell(size_t index) const
+{
+  if (index >= offsets.size())
+    throw std::out_of_range("sql_record::at");
+  return data.data() + offsets[index];
+}
+
+bool sql_record::is_null(size_t index) const
+{
+  return static_cast<unsigned char>(*cell(index)) == CELL_NULL;
+}
+
+bool sql_record::get_string(size_t index, const char *&str, size_t &length) const
+{
+  const char *c = cell(index);
+  if (static_cast<unsigned char>(*c) != ft_String)
+    return false;
+
+  uint32_t len;
+  memcpy(&len, c + 1, sizeof(len));
+  str = c + 1 + sizeof(len);
+  length = len;
+  return true;
+}
+
+field_value sql_record::at(size_t index) const
+{
+  const char *c = cell(index);
+  const unsigned char tag = static_cast<unsigned char>(*c);
+  field_value value;
+  switch (tag)
+  {
+  case CELL_NULL:
+    value.set_isNull();
+    break;
+  case ft_String:
+  {
+    uint32_t len;
+    memcpy(&len, c + 1, sizeof(len));
+    value.set_asString(std::string(c + 1 + sizeof(len), len));
+    break;
+  }
+  case ft_Float:
+  case ft_Double:
+  case ft_LongDouble:
+  {
+    double number;
+    memcpy(&number, c + 1, sizeof(number));
+    if (tag == ft_Float)
+      value.set_asFloat(static_cast<float>(number));
+    else
+      value.set_asDouble(number);
+    break;
+  }
+  default:
+  {
+    int64_t number;
+    memcpy(&number, c + 1, sizeof(number));
+    switch (tag)
+    {
+    case ft_Boolean: value.set_asBool(number != 0); break;
+    case ft_Char:    value.set_asChar(static_cast<char>(number)); break;
+    case ft_Short:   value.set_asShort(static_cast<short>(number)); break;
+    case ft_UShort:  value.set_asUShort(static_cast<unsigned short>(number)); break;
+    case ft_Int:     value.set_asInt(static_cast<int>(number)); break;
+    case ft_UInt:    value.set_asUInt(static_cast<unsigned int>(number)); break;
+    default:         value.set_asInt64(number); break;
+    }
+    break;
+  }
+  }
+  return value;
+}
+
 } //namespace 
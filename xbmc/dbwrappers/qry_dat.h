@@ -28,6 +28,7 @@
  *
  **********************************************************************/
 
+#include <initializer_list>
 #include <map>
 #include <vector>
 #include <iostream>
@@ -81,6 +82,7 @@ private:
 public:
   field_value();
   explicit field_value(const char *s);
+  explicit field_value(const std::string &s);
   explicit field_value(const bool b);
   explicit field_value(const char c);
   explicit field_value(const short s);
@@ -212,13 +214,52 @@ struct field {
 
 
 typedef std::vector<field> Fields;
-typedef std::vector<field_value> sql_record;
+
+/* One row of a result set.
+   The cells are packed into a single buffer, each one a type tag followed by its
+   value (8 bytes for numbers, a length and the characters for strings), with an
+   offset table for direct access. at() decodes a cell into a field_value on demand,
+   get_string() gives access to a string cell without copying it. */
+class sql_record {
+public:
+  sql_record() {}
+  sql_record(std::initializer_list<field_value> values);
+
+  size_t size() const {return offsets.size();}
+  bool empty() const {return offsets.empty();}
+  void clear();
+/* reserve room for the given number of cells holding bytes of values in total */
+  void reserve(size_t cells, size_t bytes);
+/* bytes needed to store a string cell of the given length */
+  static size_t string_size(size_t length);
+/* bytes needed to store a numeric or null cell */
+  static size_t number_size();
+
+  void push_back(const field_value &value);
+  void push_null();
+  void push_int64(int64_t value);
+  void push_double(double value);
+  void push_string(const char *str, size_t length);
+
+  field_value at(size_t index) const;
+  field_value operator[](size_t index) const {return at(index);}
+  bool is_null(size_t index) const;
+/* points str at the characters of a string cell, they stay valid as long as the record does */
+  bool get_string(size_t index, const char *&str, size_t &length) const;
+
+private:
+  void push_number(unsigned char tag, const void *value);
+  const char *cell(size_t index) const;
+
+  std::vector<uint32_t> offsets;
+  std::vector<char> data;
+};
+
 typedef std::vector<field_prop> record_prop;
 typedef std::vector<sql_record*> query_data;
 typedef field_value variant;
 
 //typedef Fields::iterator fld_itor;
-typedef sql_record::iterator rec_itor;
 typedef record_prop::iterator recprop_itor;
 typedef query_data::iterator qry_itor;
 
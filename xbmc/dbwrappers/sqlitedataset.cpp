@@ -26,10 +26,12 @@
  *
  **********************************************************************/
 
+#include <cstring>
 #include <iostream>
 #include <string>
 
 #include "sqlitedataset.h"
+#include "DatabaseProfiler.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 
@@ -37,6 +39,10 @@
 #include "platform/linux/XTimeUtils.h"
 #endif
 
+// statements are finalized once this many distinct ones have been cached, so that
+// queries built with literal values can't grow the cache without bound
+#define MAX_CACHED_STATEMENTS 100
+
 namespace dbiplus {
 //************* Callback function ***************************
 
@@ -57,19 +63,13 @@ int callback(void* res_ptr,int ncol, char** result,char** cols)
   if (result != NULL)
   {
     sql_record *rec = new sql_record;
-    rec->resize(ncol);
+    rec->reserve(ncol, ncol * sql_record::number_size());
     for (int i=0; i<ncol; i++)
     { 
-      field_value &v = rec->at(i);
       if (result[i] == NULL)
-      {
-        v.set_asString("");
-        v.set_isNull();
-      }
+        rec->push_null();
       else
-      {
-        v.set_asString(result[i]);
-      }
+        rec->push_string(result[i], strlen(result[i]));
     }
     r->records.push_back(rec);
   }
@@ -267,6 +267,7 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clearStatements();
   sqlite3_close(conn);
   active = false;
 }
@@ -421,9 +422,72 @@ void SqliteDatabase::rollback_transaction() {
   }  
 }
 
+void SqliteDatabase::savepoint(const char *name) {
+  if (active)
+    sqlite3_exec(conn, ("SAVEPOINT " + std::string(name)).c_str(), NULL, NULL, NULL);
+}
+
+void SqliteDatabase::release_savepoint(const char *name) {
+  if (active)
+    sqlite3_exec(conn, ("RELEASE SAVEPOINT " + std::string(name)).c_str(), NULL, NULL, NULL);
+}
+
+void SqliteDatabase::rollback_to_savepoint(const char *name) {
+  if (active) {
+    // rolling back to a savepoint leaves it on the stack
+    sqlite3_exec(conn, ("ROLLBACK TO SAVEPOINT " + std::string(name)).c_str(), NULL, NULL, NULL);
+    sqlite3_exec(conn, ("RELEASE SAVEPOINT " + std::string(name)).c_str(), NULL, NULL, NULL);
+  }
+}
+
+static int explain_callback(void *res_ptr, int ncol, char **result, char **cols)
+{
+  // the last column of EXPLAIN QUERY PLAN is the description of the step
+  std::string *plan = static_cast<std::string*>(res_ptr);
+  if (ncol > 0 && result[ncol - 1])
+  {
+    if (!plan->empty())
+      *plan += "\n";
+    *plan += result[ncol - 1];
+  }
+  return 0;
+}
+
+std::string SqliteDatabase::explain_query(const std::string &sql) {
+  std::string plan;
+  if (active)
+    sqlite3_exec(conn, ("EXPLAIN QUERY PLAN " + sql).c_str(), &explain_callback, &plan, NULL);
+  return plan;
+}
+
 
 // methods for formatting
 // ---------------------------------------------
+sqlite3_stmt *SqliteDatabase::getStatement(const std::string &sql) {
+  std::map<std::string, sqlite3_stmt*>::iterator it = statements.find(sql);
+  if (it != statements.end())
+  {
+    sqlite3_reset(it->second);
+    sqlite3_clear_bindings(it->second);
+    return it->second;
+  }
+
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+    throw DbErrors(getErrorMsg());
+
+  if (statements.size() >= MAX_CACHED_STATEMENTS)
+    clearStatements();
+  statements.insert(std::make_pair(sql, stmt));
+  return stmt;
+}
+
+void SqliteDatabase::clearStatements() {
+  for (std::map<std::string, sqlite3_stmt*>::iterator it = statements.begin(); it != statements.end(); ++it)
+    sqlite3_finalize(it->second);
+  statements.clear();
+}
+
 std::string SqliteDatabase::vprepare(const char *format, va_list args)
 {
   std::string strFormat = format;
@@ -461,6 +525,9 @@ SqliteDataset::SqliteDataset():Dataset() {
   db = NULL;
   errmsg = NULL;
   autorefresh = false;
+  cursor = NULL;
+  forward_only = false;
+  cursor_rows = 0;
 }
 
 
@@ -469,9 +536,13 @@ SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
   db = newDb;
   errmsg = NULL;
   autorefresh = false;
+  cursor = NULL;
+  forward_only = false;
+  cursor_rows = 0;
 }
 
  SqliteDataset::~SqliteDataset(){
+   if (cursor) sqlite3_finalize(cursor);
    if (errmsg) sqlite3_free(errmsg);
  }
 
@@ -587,6 +658,7 @@ bool SqliteDataset::dropIndex(const char *table, const char *index)
 
 int SqliteDataset::exec(const std::string &sql) {
   if (!handle()) throw DbErrors("No Database Connection");
+  CDatabaseProfileScope profile(db, sql);
   std::string qry = sql;
   int res;
   exec_res.clear();
@@ -630,7 +702,10 @@ int SqliteDataset::exec(const std::string &sql) {
   }
 
   if((res = db->setErr(sqlite3_exec(handle(),qry.c_str(),&callback,&exec_res,&errmsg),qry.c_str())) == SQLITE_OK)
+  {
+    profile.SetRows(sqlite3_changes(handle()));
     return res;
+  }
   else
     {
       throw DbErrors(db->getErrorMsg());
@@ -646,6 +721,129 @@ const void* SqliteDataset::getExecRes() {
 }
 
 
+void SqliteDataset::fetch_rows(sqlite3_stmt *stmt) {
+  // column headers
+  const unsigned int numColumns = sqlite3_column_count(stmt);
+  result.record_header.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+    result.record_header[i].name = sqlite3_column_name(stmt, i);
+
+  // returned rows
+  while (sqlite3_step(stmt) == SQLITE_ROW)
+  { // have a row of data
+    sql_record *res = new sql_record;
+    read_row(stmt, *res);
+    result.records.push_back(res);
+  }
+}
+
+void SqliteDataset::read_row(sqlite3_stmt *stmt, sql_record &row) {
+  const unsigned int numColumns = sqlite3_column_count(stmt);
+
+  // size the record up front so its values end up in a single allocation
+  size_t bytes = 0;
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    const int type = sqlite3_column_type(stmt, i);
+    if (type == SQLITE_TEXT || type == SQLITE_BLOB)
+      bytes += sql_record::string_size(sqlite3_column_bytes(stmt, i));
+    else
+      bytes += sql_record::number_size();
+  }
+  row.clear();
+  row.reserve(numColumns, bytes);
+
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    switch (sqlite3_column_type(stmt, i))
+    {
+    case SQLITE_INTEGER:
+      row.push_int64(sqlite3_column_int64(stmt, i));
+      break;
+    case SQLITE_FLOAT:
+      row.push_double(sqlite3_column_double(stmt, i));
+      break;
+    case SQLITE_TEXT:
+    {
+      const char *text = (const char *)sqlite3_column_text(stmt, i);
+      row.push_string(text, text ? sqlite3_column_bytes(stmt, i) : 0);
+      break;
+    }
+    case SQLITE_BLOB:
+    {
+      const char *text = (const char *)sqlite3_column_text(stmt, i);
+      row.push_string(text, text ? strlen(text) : 0);
+      break;
+    }
+    case SQLITE_NULL:
+    default:
+      row.push_null();
+      break;
+    }
+  }
+}
+
+void SqliteDataset::step_cursor() {
+  int rc = sqlite3_step(cursor);
+  if (rc == SQLITE_ROW)
+  {
+    // the single row slot is reused for every row of the cursor
+    if (result.records.empty())
+      result.records.push_back(new sql_record);
+    read_row(cursor, *result.records[0]);
+    frecno = 0;
+    feof = false;
+    cursor_rows++;
+    return;
+  }
+
+  result.clear();
+  feof = true;
+  rc = sqlite3_finalize(cursor);
+  cursor = NULL;
+  if (db->setErr(rc, select_sql.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+}
+
+sqlite3_stmt *SqliteDataset::bind_statement(const std::string &sql, const sql_record &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  SqliteDatabase *sqlitedb = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt *stmt = sqlitedb->getStatement(sql);
+
+  if (sqlite3_bind_parameter_count(stmt) != static_cast<int>(params.size()))
+    throw DbErrors("Expected %d values for %s, got %u", sqlite3_bind_parameter_count(stmt), sql.c_str(), static_cast<unsigned int>(params.size()));
+
+  for (unsigned int i = 0; i < params.size(); i++)
+  {
+    const field_value &v = params[i];
+    int rc;
+    if (v.get_isNull())
+      rc = sqlite3_bind_null(stmt, i + 1);
+    else switch (v.get_fType())
+    {
+    case ft_Boolean:
+    case ft_Short:
+    case ft_UShort:
+    case ft_Int:
+    case ft_UInt:
+    case ft_Int64:
+      rc = sqlite3_bind_int64(stmt, i + 1, v.get_asInt64());
+      break;
+    case ft_Float:
+    case ft_Double:
+    case ft_LongDouble:
+      rc = sqlite3_bind_double(stmt, i + 1, v.get_asDouble());
+      break;
+    default:
+      rc = sqlite3_bind_text(stmt, i + 1, v.get_asString().c_str(), -1, SQLITE_TRANSIENT);
+      break;
+    }
+    if (db->setErr(rc, sql.c_str()) != SQLITE_OK)
+      throw DbErrors(db->getErrorMsg());
+  }
+  return stmt;
+}
+
 bool SqliteDataset::query(const std::string &query) {
     if(!handle()) throw DbErrors("No Database Connection");
     std::string qry = query;
@@ -656,49 +854,15 @@ bool SqliteDataset::query(const std::string &query) {
 
   close();
 
+  CDatabaseProfileScope profile(db, query);
   sqlite3_stmt *stmt = NULL;
   if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
     throw DbErrors(db->getErrorMsg());
 
-  // column headers
-  const unsigned int numColumns = sqlite3_column_count(stmt);
-  result.record_header.resize(numColumns);
-  for (unsigned int i = 0; i < numColumns; i++)
-    result.record_header[i].name = sqlite3_column_name(stmt, i);
-
-  // returned rows
-  while (sqlite3_step(stmt) == SQLITE_ROW)
-  { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
-    for (unsigned int i = 0; i < numColumns; i++)
-    {
-      field_value &v = res->at(i);
-      switch (sqlite3_column_type(stmt, i))
-      {
-      case SQLITE_INTEGER:
-        v.set_asInt64(sqlite3_column_int64(stmt, i));
-        break;
-      case SQLITE_FLOAT:
-        v.set_asDouble(sqlite3_column_double(stmt, i));
-        break;
-      case SQLITE_TEXT:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_BLOB:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_NULL:
-      default:
-        v.set_asString("");
-        v.set_isNull();
-        break;
-      }
-    }
-    result.records.push_back(res);
-  }
+  fetch_rows(stmt);
   if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
   {
+    profile.SetRows(result.records.size());
     active = true;
     ds_state = dsSelect;
     this->first();
@@ -710,6 +874,74 @@ bool SqliteDataset::query(const std::string &query) {
   }  
 }
 
+bool SqliteDataset::query(const std::string &query, const sql_record &params) {
+  close();
+
+  CDatabaseProfileScope profile(db, query);
+  sqlite3_stmt *stmt = bind_statement(query, params);
+  fetch_rows(stmt);
+
+  // reset rather than finalize, the statement stays cached for the next call
+  if (db->setErr(sqlite3_reset(stmt), query.c_str()) == SQLITE_OK)
+  {
+    profile.SetRows(result.records.size());
+    sqlite3_clear_bindings(stmt);
+    active = true;
+    ds_state = dsSelect;
+    this->first();
+    return true;
+  }
+  else
+  {
+    throw DbErrors(db->getErrorMsg());
+  }
+}
+
+int SqliteDataset::exec(const std::string &sql, const sql_record &params) {
+  exec_res.clear();
+
+  CDatabaseProfileScope profile(db, sql);
+  sqlite3_stmt *stmt = bind_statement(sql, params);
+  int res = sqlite3_step(stmt);
+  if (res == SQLITE_DONE || res == SQLITE_ROW)
+    res = sqlite3_reset(stmt);
+  else
+    sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  if ((res = db->setErr(res, sql.c_str())) == SQLITE_OK)
+  {
+    profile.SetRows(sqlite3_changes(handle()));
+    return res;
+  }
+  else
+    throw DbErrors(db->getErrorMsg());
+}
+
+bool SqliteDataset::query_forward_only(const std::string &query) {
+  if (!handle()) throw DbErrors("No Database Connection");
+
+  close();
+
+  if (db->setErr(sqlite3_prepare_v2(handle(), query.c_str(), -1, &cursor, NULL), query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  const unsigned int numColumns = sqlite3_column_count(cursor);
+  result.record_header.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+    result.record_header[i].name = sqlite3_column_name(cursor, i);
+
+  select_sql = query;
+  forward_only = true;
+  active = true;
+  ds_state = dsSelect;
+  fbof = true;
+  step_cursor();
+  if (!feof)
+    fill_fields();
+  return true;
+}
+
 void SqliteDataset::open(const std::string &sql) {
   set_select_sql(sql);
   open();
@@ -726,6 +958,13 @@ void SqliteDataset::open() {
 
 
 void SqliteDataset::close() {
+  if (cursor)
+  {
+    sqlite3_finalize(cursor);
+    cursor = NULL;
+  }
+  forward_only = false;
+  cursor_rows = 0;
   Dataset::close();
   result.clear();
   edit_object->clear();
@@ -746,6 +985,8 @@ void SqliteDataset::cancel() {
 
 
 int SqliteDataset::num_rows() {
+  if (forward_only)
+    return cursor_rows;
   return result.records.size();
 }
 
@@ -761,22 +1002,36 @@ bool SqliteDataset::bof() {
 
 
 void SqliteDataset::first() {
+  if (forward_only)
+    throw DbErrors("Can't rewind a forward only dataset");
   Dataset::first();
   this->fill_fields();
 }
 
 void SqliteDataset::last() {
+  if (forward_only)
+    throw DbErrors("Can't seek in a forward only dataset");
   Dataset::last();
   fill_fields();
 }
 
 void SqliteDataset::prev(void) {
+  if (forward_only)
+    throw DbErrors("Can't rewind a forward only dataset");
   Dataset::prev();
   fill_fields();
 }
 
 void SqliteDataset::next(void) {
-  Dataset::next();
+  if (forward_only)
+  {
+    if (ds_state != dsSelect || feof)
+      return;
+    fbof = false;
+    step_cursor();
+  }
+  else
+    Dataset::next();
   if (!eof()) 
       fill_fields();
 }
@@ -795,6 +1050,8 @@ void SqliteDataset::free_row(void)
 }
 
 bool SqliteDataset::seek(int pos) {
+  if (forward_only)
+    throw DbErrors("Can't seek in a forward only dataset");
   if (ds_state == dsSelect) {
     Dataset::seek(pos);
     fill_fields();
@@ -29,6 +29,7 @@
  **********************************************************************/
 
 #include <stdio.h>
+#include <map>
 #include "dataset.h"
 #include <sqlite3.h>
 
@@ -44,6 +45,8 @@ protected:
   sqlite3 *conn;
   bool _in_transaction;
   int last_err;
+/* prepared statements kept for reuse, keyed on their sql */
+  std::map<std::string, sqlite3_stmt*> statements;
 
 public:
 /* default constructor */
@@ -91,11 +94,22 @@ public:
   void commit_transaction() override;
   void rollback_transaction() override;
 
+  void savepoint(const char *name) override;
+  void release_savepoint(const char *name) override;
+  void rollback_to_savepoint(const char *name) override;
+
+  std::string explain_query(const std::string &sql) override;
+
 /* virtual methods for formatting */
   std::string vprepare(const char *format, va_list args) override;
 
   bool in_transaction() override {return _in_transaction;}; 	
 
+/* func. returns a reset prepared statement for sql, compiling it on first use */
+  sqlite3_stmt *getStatement(const std::string &sql);
+/* func. finalizes all cached statements */
+  void clearStatements();
+
 };
 
 
@@ -126,6 +140,19 @@ protected:
   void fill_fields() override;
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
+/* Reads all rows of an executed statement into the result set */
+  void fetch_rows(sqlite3_stmt *stmt);
+/* Binds the parameters to a cached statement for sql */
+  sqlite3_stmt *bind_statement(const std::string &sql, const sql_record &params);
+/* Converts the current row of a statement */
+  static void read_row(sqlite3_stmt *stmt, sql_record &row);
+/* Steps the forward only cursor to its next row */
+  void step_cursor();
+
+/* statement of a forward only query, NULL once all rows have been read */
+  sqlite3_stmt *cursor;
+  bool forward_only;
+  int cursor_rows;
 
 public:
 /* constructor */
@@ -145,9 +172,12 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   int  exec () override;
   int  exec (const std::string &sql) override;
+  int  exec (const std::string &sql, const sql_record &params) override;
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+  bool query(const std::string &query, const sql_record &params) override;
+  bool query_forward_only(const std::string &query) override;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -29,6 +29,7 @@
 #include "utils/log.h"
 #include "SpecialProtocol.h"
 #include "URL.h"
+#include "settings/AdvancedSettings.h"
 #if defined(TARGET_POSIX)
 #include "platform/posix/filesystem/PosixFile.h"
 #define CacheLocalFile CPosixFile
@@ -109,6 +110,14 @@ int CSimpleFileCache::Open()
     return CACHE_RC_ERROR;
   }
 
+  // the data is read once, don't let it push everything else out of memory
+  if (g_advancedSettings.m_cacheBypassPageCache)
+  {
+    bool bypass = true;
+    m_cacheFileWrite->IoControl(IOCTRL_BYPASS_PAGECACHE, &bypass);
+    m_cacheFileRead->IoControl(IOCTRL_BYPASS_PAGECACHE, &bypass);
+  }
+
   return CACHE_RC_OK;
 }
 
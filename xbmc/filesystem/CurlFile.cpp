@@ -29,6 +29,7 @@
 #include "threads/SystemClock.h"
 #include "utils/Base64.h"
 
+#include <algorithm>
 #include <vector>
 #include <climits>
 #include <cassert>
@@ -47,6 +48,7 @@
 #include "utils/CharsetConverter.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/Trace.h"
 
 using namespace XFILE;
 using namespace XCURL;
@@ -66,6 +68,14 @@ curl_proxytype proxyType2CUrlProxyType[] = {
 #define FILLBUFFER_NO_DATA    1
 #define FILLBUFFER_FAIL       2
 
+// size of the ranges fetched in parallel, adapted to take between
+// RANGE_FAST_MS and RANGE_SLOW_MS each
+#define RANGE_SIZE_MIN        (256 * 1024)
+#define RANGE_SIZE_INITIAL    (1024 * 1024)
+#define RANGE_SIZE_MAX        (8 * 1024 * 1024)
+#define RANGE_FAST_MS         1000
+#define RANGE_SLOW_MS         4000
+
 // curl calls this routine to debug
 extern "C" int debug_callback(CURL_HANDLE *handle, curl_infotype info, char *output, size_t size, void *data)
 {
@@ -271,6 +281,8 @@ CCurlFile::CReadState::CReadState()
   m_bRetry = true;
   m_curlHeaderList = NULL;
   m_curlAliasList = NULL;
+  m_rangeEnd = 0;
+  m_rangeStarted = 0;
 }
 
 CCurlFile::CReadState::~CReadState()
@@ -323,6 +335,15 @@ bool CCurlFile::CReadState::Seek(int64_t pos)
 
 void CCurlFile::CReadState::SetResume(void)
 {
+  if (m_rangeEnd > 0)
+  {
+    // a range fetched in parallel to the others ends where the next one starts
+    std::string range = StringUtils::Format("%" PRId64"-%" PRId64, m_filePos, m_rangeEnd - 1);
+    g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RANGE, range.c_str());
+    g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RESUME_FROM_LARGE, static_cast<int64_t>(0));
+    return;
+  }
+
   /*
    * Explicitly set RANGE header when filepos=0 as some http servers require us to always send the range
    * request header. If we don't the server may provide different content causing seeking to fail.
@@ -395,6 +416,7 @@ void CCurlFile::CReadState::Disconnect()
   m_fileSize = 0;
   m_bufferSize = 0;
   m_readBuffer = 0;
+  m_rangeEnd = 0;
 
   /* cleanup */
   if( m_curlHeaderList )
@@ -441,6 +463,7 @@ CCurlFile::CCurlFile()
   m_cipherlist = "";
   m_state = new CReadState();
   m_oldState = NULL;
+  m_rangeSize = 0;
   m_skipshout = false;
   m_httpresponse = -1;
   m_acceptCharset = "UTF-8,*;q=0.8"; /* prefer UTF-8 if available */
@@ -458,6 +481,8 @@ void CCurlFile::Close()
   if (m_opened && m_forWrite && !m_inError)
       Write(NULL, 0);
 
+  ClearRanges();
+  m_rangeSize = 0;
   m_state->Disconnect();
   delete m_oldState;
   m_oldState = NULL;
@@ -479,6 +504,10 @@ void CCurlFile::SetCommonOptions(CReadState* state)
 
   g_curlInterface.easy_setopt(h, CURLOPT_DEBUGFUNCTION, debug_callback);
 
+  // reuse DNS results, TLS sessions and connections of other transfers
+  if (g_curlInterface.GetShare())
+    g_curlInterface.easy_setopt(h, CURLOPT_SHARE, g_curlInterface.GetShare());
+
   if( g_advancedSettings.m_logLevel >= LOG_LEVEL_DEBUG )
     g_curlInterface.easy_setopt(h, CURLOPT_VERBOSE, CURL_ON);
   else
@@ -540,8 +569,8 @@ void CCurlFile::SetCommonOptions(CReadState* state)
   if (!m_verifyPeer)
     g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYPEER, 0);
 
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_URL, m_url.c_str());
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_TRANSFERTEXT, CURL_OFF);
+  g_curlInterface.easy_setopt(h, CURLOPT_URL, m_url.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_TRANSFERTEXT, CURL_OFF);
 
   // setup POST data if it is set (and it may be empty)
   if (m_postdataset)
@@ -612,6 +641,12 @@ void CCurlFile::SetCommonOptions(CReadState* state)
   if (g_advancedSettings.m_curlDisableIPV6)
     g_curlInterface.easy_setopt(h, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
 
+#if LIBCURL_VERSION_NUM >= 0x072F00
+  // HTTP/2 where the server offers it during the TLS handshake
+  if (!g_advancedSettings.m_curlDisableHTTP2)
+    g_curlInterface.easy_setopt(h, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#endif
+
   if (!m_proxyhost.empty())
   {
     g_curlInterface.easy_setopt(h, CURLOPT_PROXYTYPE, proxyType2CUrlProxyType[m_proxytype]);
@@ -1093,6 +1128,16 @@ bool CCurlFile::Open(const CURL& url)
     m_url = efurl;
   }
 
+  // a server answering the ranged request may as well serve several at once
+  if (g_advancedSettings.m_curlParallelRanges > 0 && m_seekable && m_multisession &&
+      m_httpresponse == 206 && m_state->m_fileSize > 2 * RANGE_SIZE_INITIAL)
+  {
+    CLog::Log(LOGDEBUG, "CCurlFile::Open - fetching %d ranges in parallel", g_advancedSettings.m_curlParallelRanges);
+    m_rangeSize = RANGE_SIZE_INITIAL;
+    m_state->m_rangeEnd = m_rangeSize;
+    AddRanges();
+  }
+
   return true;
 }
 
@@ -1295,6 +1340,9 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   // We can't seek beyond EOF
   if (m_state->m_fileSize && nextPos > m_state->m_fileSize) return -1;
 
+  if (m_rangeSize > 0)
+    return SeekRanges(nextPos);
+
   if(m_state->Seek(nextPos))
     return nextPos;
 
@@ -1763,6 +1811,183 @@ int8_t CCurlFile::CReadState::FillBuffer(unsigned int want)
   return FILLBUFFER_OK;
 }
 
+ssize_t CCurlFile::Read(void* lpBuf, size_t uiBufSize)
+{
+  CTraceScope trace("network", "CCurlFile::Read");
+  if (m_rangeSize > 0)
+  {
+    if (m_state->m_filePos >= m_state->m_rangeEnd && !m_ranges.empty())
+      NextRange();
+
+    // keep the ranges ahead going while waiting for the current one
+    while (m_state->m_stillRunning && !m_state->m_cancelled &&
+           m_state->m_buffer.getMaxReadSize() == 0 && m_state->m_overflowSize == 0)
+      PerformRanges(100);
+    PerformRanges(0);
+
+    // a connection opened without an end may deliver more than its range
+    uiBufSize = static_cast<size_t>(std::min<int64_t>(uiBufSize, m_state->m_rangeEnd - m_state->m_filePos));
+  }
+  return m_state->Read(lpBuf, uiBufSize);
+}
+
+void CCurlFile::StartRange(CReadState* state, int64_t start, int64_t fileSize)
+{
+  if (!state->m_easyHandle)
+  {
+    CURL url(m_url);
+    g_curlInterface.easy_acquire(url.GetProtocol().c_str(),
+                                url.GetHostName().c_str(),
+                                &state->m_easyHandle,
+                                &state->m_multiHandle);
+  }
+
+  SetCommonOptions(state);
+  SetRequestHeaders(state);
+
+  state->m_fileSize = fileSize;
+  state->m_filePos = start;
+  state->m_rangeEnd = std::min(start + m_rangeSize, fileSize);
+  state->m_bRetry = m_allowRetry;
+  state->m_bufferSize = static_cast<unsigned int>(state->m_rangeEnd - start);
+  state->m_buffer.Destroy();
+  state->m_buffer.Create(state->m_bufferSize);
+  state->m_httpheader.Clear();
+  state->m_rangeStarted = XbmcThreads::SystemClockMillis();
+
+  // unlike Connect() this doesn't wait for the first data
+  state->SetResume();
+  g_curlInterface.multi_add_handle(state->m_multiHandle, state->m_easyHandle);
+  state->m_stillRunning = 1;
+}
+
+void CCurlFile::AddRanges()
+{
+  int64_t start = m_ranges.empty() ? m_state->m_rangeEnd : m_ranges.back()->m_rangeEnd;
+  while (m_ranges.size() < static_cast<size_t>(g_advancedSettings.m_curlParallelRanges) &&
+         start < m_state->m_fileSize)
+  {
+    CReadState* state = new CReadState();
+    StartRange(state, start, m_state->m_fileSize);
+    m_ranges.push_back(state);
+    start = state->m_rangeEnd;
+  }
+}
+
+void CCurlFile::NextRange()
+{
+  delete m_state;
+  m_state = m_ranges.front();
+  m_ranges.erase(m_ranges.begin());
+  AddRanges();
+}
+
+void CCurlFile::ClearRanges()
+{
+  for (auto state : m_ranges)
+    delete state;
+  m_ranges.clear();
+}
+
+void CCurlFile::PerformRanges(unsigned int timeout)
+{
+  fd_set fdread;
+  fd_set fdwrite;
+  fd_set fdexcep;
+  FD_ZERO(&fdread);
+  FD_ZERO(&fdwrite);
+  FD_ZERO(&fdexcep);
+  int maxfd = -1;
+
+  std::vector<CReadState*> states(m_ranges);
+  // the current range is left to FillBuffer() as soon as it has data
+  if (m_state->m_buffer.getMaxReadSize() == 0 && m_state->m_overflowSize == 0)
+    states.push_back(m_state);
+
+  for (auto state : states)
+  {
+    if (!state->m_stillRunning)
+      continue;
+
+    // errors are left to FillBuffer() of the range once it is read
+    g_curlInterface.multi_perform(state->m_multiHandle, &state->m_stillRunning);
+    if (state->m_bFirstLoop && state->m_buffer.getMaxReadSize() > 0)
+      state->m_bFirstLoop = false;
+
+    if (!state->m_stillRunning)
+    {
+      if (state != m_state && state->m_buffer.getMaxReadSize() == state->m_bufferSize &&
+          state->m_bufferSize == m_rangeSize)
+      {
+        unsigned int elapsed = XbmcThreads::SystemClockMillis() - state->m_rangeStarted;
+        if (elapsed < RANGE_FAST_MS && m_rangeSize < RANGE_SIZE_MAX)
+          m_rangeSize *= 2;
+        else if (elapsed > RANGE_SLOW_MS && m_rangeSize > RANGE_SIZE_MIN)
+          m_rangeSize /= 2;
+      }
+      continue;
+    }
+
+    int fd = -1;
+    g_curlInterface.multi_fdset(state->m_multiHandle, &fdread, &fdwrite, &fdexcep, &fd);
+    maxfd = std::max(maxfd, fd);
+  }
+
+  if (timeout == 0)
+    return;
+
+  if (maxfd == -1)
+  {
+    // no sockets yet, see FillBuffer()
+    Sleep(timeout);
+    return;
+  }
+
+  struct timeval wait = { (int)timeout / 1000, ((int)timeout % 1000) * 1000 };
+  select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &wait);
+}
+
+int64_t CCurlFile::SeekRanges(int64_t pos)
+{
+  if (pos < m_state->m_rangeEnd && m_state->Seek(pos))
+    return pos;
+
+  // use what was fetched ahead, up to the position
+  for (size_t i = 0; i < m_ranges.size(); i++)
+  {
+    if (pos < m_ranges[i]->m_filePos || pos >= m_ranges[i]->m_rangeEnd)
+      continue;
+
+    delete m_state;
+    m_state = m_ranges[i];
+    for (size_t j = 0; j < i; j++)
+      delete m_ranges[j];
+    m_ranges.erase(m_ranges.begin(), m_ranges.begin() + i + 1);
+    AddRanges();
+
+    if (m_state->Seek(pos))
+      return pos;
+    break;
+  }
+
+  int64_t fileSize = m_state->m_fileSize;
+  ClearRanges();
+  m_state->Disconnect();
+
+  if (pos >= fileSize)
+  {
+    m_state->m_fileSize = fileSize;
+    m_state->m_filePos = pos;
+    m_state->m_rangeEnd = pos;
+    m_state->m_stillRunning = 0;
+    return pos;
+  }
+
+  StartRange(m_state, pos, fileSize);
+  AddRanges();
+  return pos;
+}
+
 void CCurlFile::CReadState::SetReadBuffer(const void* lpBuf, int64_t uiBufSize)
 {
   m_readBuffer = (char*)lpBuf;
@@ -1785,6 +2010,11 @@ void CCurlFile::SetRequestHeader(const std::string& header, long value)
   m_requestheaders[header] = StringUtils::Format("%ld", value);
 }
 
+void CCurlFile::RemoveRequestHeader(const std::string& header)
+{
+  m_requestheaders.erase(header);
+}
+
 std::string CCurlFile::GetURL(void)
 {
   return m_url;
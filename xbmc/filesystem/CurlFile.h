@@ -23,6 +23,7 @@
 #include "utils/RingBuffer.h"
 #include <map>
 #include <string>
+#include <vector>
 #include "utils/HttpHeader.h"
 
 namespace XCURL
@@ -59,7 +60,7 @@ namespace XFILE
       int Stat(const CURL& url, struct __stat64* buffer) override;
       void Close() override;
       bool ReadString(char *szLine, int iLineLength) override { return m_state->ReadString(szLine, iLineLength); }
-      ssize_t Read(void* lpBuf, size_t uiBufSize) override { return m_state->Read(lpBuf, uiBufSize); }
+      ssize_t Read(void* lpBuf, size_t uiBufSize) override;
       ssize_t Write(const void* lpBuf, size_t uiBufSize) override;
       const std::string GetProperty(XFILE::FileProperty type, const std::string &name = "") const override;
       const std::vector<std::string> GetPropertyValues(XFILE::FileProperty type, const std::string &name = "") const override;
@@ -87,11 +88,13 @@ namespace XFILE
       void SetMimeType(std::string mimetype) { SetRequestHeader("Content-Type", mimetype); }
       void SetRequestHeader(const std::string& header, const std::string& value);
       void SetRequestHeader(const std::string& header, long value);
+      void RemoveRequestHeader(const std::string& header);
 
       void ClearRequestHeaders();
       void SetBufferSize(unsigned int size);
 
       const CHttpHeader& GetHttpHeader() const { return m_state->m_httpheader; }
+      long GetHttpResponseCode() const { return m_httpresponse; }
       std::string GetURL(void);
       std::string GetRedirectURL();
 
@@ -125,6 +128,8 @@ namespace XFILE
           bool m_sendRange;
           bool m_bLastError;
           bool m_bRetry;
+          int64_t m_rangeEnd; // end of the range fetched, 0 to read until the end of the file
+          unsigned int m_rangeStarted;
 
           char* m_readBuffer;
 
@@ -158,9 +163,27 @@ namespace XFILE
       bool Service(const std::string& strURL, std::string& strHTML);
       std::string GetInfoString(int infoType);
 
+      /*! \name Parallel ranges
+       Instead of a single connection for the whole file, a seekable file is
+       read in consecutive ranges, each over its own connection. The ranges
+       following the one read are fetched ahead in parallel, which gets the
+       most out of links with a high latency. Enabled by
+       <network><curlparallelranges>.
+       */
+      //@{
+      void StartRange(CReadState* state, int64_t start, int64_t fileSize);
+      void AddRanges();
+      void NextRange();
+      void ClearRanges();
+      void PerformRanges(unsigned int timeout);
+      int64_t SeekRanges(int64_t pos);
+      //@}
+
     protected:
       CReadState* m_state;
       CReadState* m_oldState;
+      std::vector<CReadState*> m_ranges; // ranges fetched ahead of m_state
+      unsigned int m_rangeSize; // size of new ranges, 0 if ranges aren't used
       unsigned int m_bufferSize;
       int64_t m_writeOffset;
 
@@ -25,12 +25,61 @@
 #include "URL.h"
 #include "CurlFile.h"
 #include "FileItem.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/StringUtils.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 
 using namespace XFILE;
 
+namespace
+{
+/*
+ * Finds the next <response> start tag, or </response> end tag if closing is
+ * set, whatever the namespace prefix. Returns the position of its '<' and
+ * sets end to its '>', or std::string::npos if the data doesn't contain the
+ * complete tag yet.
+ */
+size_t FindResponseTag(const std::string& data, size_t pos, bool closing, size_t& end)
+{
+  while ((pos = data.find('<', pos)) != std::string::npos)
+  {
+    size_t nameStart = pos + 1;
+    if (closing)
+    {
+      if (nameStart >= data.size())
+        return std::string::npos;
+      if (data[nameStart] != '/')
+      {
+        pos = nameStart;
+        continue;
+      }
+      nameStart++;
+    }
+
+    size_t nameEnd = data.find_first_of(" \t\r\n/>", nameStart);
+    if (nameEnd == std::string::npos)
+      return std::string::npos;
+
+    size_t prefix = data.find(':', nameStart);
+    if (prefix != std::string::npos && prefix < nameEnd)
+      nameStart = prefix + 1;
+
+    if (data.compare(nameStart, nameEnd - nameStart, "response") == 0)
+    {
+      end = data.find('>', nameEnd);
+      return end == std::string::npos ? std::string::npos : pos;
+    }
+    pos = nameEnd;
+  }
+  return std::string::npos;
+}
+}
+
+std::map<std::string, CDAVDirectory::CCachedListing> CDAVDirectory::m_cachedListings;
+CCriticalSection CDAVDirectory::m_cacheLock;
+
 CDAVDirectory::CDAVDirectory(void) = default;
 CDAVDirectory::~CDAVDirectory(void) = default;
 
@@ -41,7 +90,7 @@ CDAVDirectory::~CDAVDirectory(void) = default;
  * <!ELEMENT propstat (prop, status, responsedescription?) >
  *
  */
-void CDAVDirectory::ParseResponse(const TiXmlElement *pElement, CFileItem &item)
+void CDAVDirectory::ParseResponse(const TiXmlElement *pElement, CFileItem &item, std::string &etag)
 {
   const TiXmlElement *pResponseChild;
   const TiXmlNode *pPropstatChild;
@@ -86,6 +135,11 @@ void CDAVDirectory::ParseResponse(const TiXmlElement *pElement, CFileItem &item)
                 item.SetLabel(pPropChild->FirstChild()->ValueStr());
               }
               else
+              if (CDAVCommon::ValueWithoutNamespace(pPropChild, "getetag") && !pPropChild->NoChildren())
+              {
+                etag = pPropChild->FirstChild()->ValueStr();
+              }
+              else
               if (!item.m_dateTime.IsValid() && CDAVCommon::ValueWithoutNamespace(pPropChild, "creationdate") && !pPropChild->NoChildren())
               {
                 struct tm timeDate = {0};
@@ -125,38 +179,89 @@ bool CDAVDirectory::GetDirectory(const CURL& url, CFileItemList &items)
     "     <D:getlastmodified/>"
     "     <D:creationdate/>"
     "     <D:displayname/>"
+    "     <D:getetag/>"
     "    </D:prop>"
     "  </D:propfind>");
 
+  // servers that support it answer 304 if the collection didn't change
+  const std::string strPath = url.Get();
+  CCachedListing cached;
+  bool haveCached = GetCachedListing(strPath, cached);
+  if (haveCached)
+    dav.SetRequestHeader("If-None-Match", cached.etag);
+
   if (!dav.Open(url))
   {
     CLog::Log(LOGERROR, "%s - Unable to get dav directory (%s)", __FUNCTION__, url.GetRedacted().c_str());
     return false;
   }
 
-  std::string strResponse;
-  dav.ReadData(strResponse);
-
-  std::string fileCharset(dav.GetProperty(XFILE::FILE_PROPERTY_CONTENT_CHARSET));
-  CXBMCTinyXML davResponse;
-  davResponse.Parse(strResponse, fileCharset);
-
-  if (!davResponse.Parse(strResponse))
+  if (haveCached && dav.GetHttpResponseCode() == 304)
   {
-    CLog::Log(LOGERROR, "%s - Unable to process dav directory (%s)", __FUNCTION__, url.GetRedacted().c_str());
     dav.Close();
-    return false;
+    items.Copy(*cached.items);
+    return true;
   }
 
-  TiXmlNode *pChild;
-  // Iterate over all responses
-  for (pChild = davResponse.RootElement()->FirstChild(); pChild != 0; pChild = pChild->NextSibling())
+  std::string fileCharset(dav.GetProperty(XFILE::FILE_PROPERTY_CONTENT_CHARSET));
+  CURL url2(url);
+  std::string etag;
+  bool found = false;
+
+  // parse one <response> after the other as the data comes in, rather than
+  // loading the whole multistatus document of a large collection
+  std::string data;
+  char chunk[16384];
+  ssize_t read;
+  while ((read = dav.Read(chunk, sizeof(chunk))) > 0)
   {
-    if (CDAVCommon::ValueWithoutNamespace(pChild, "response"))
+    data.append(chunk, read);
+
+    if (fileCharset.empty())
+    {
+      // the responses don't repeat the encoding of the document
+      fileCharset = "UTF-8";
+      size_t decl = data.find("encoding=");
+      if (decl != std::string::npos && decl < data.find("?>") && decl + 10 < data.size())
+      {
+        size_t declEnd = data.find_first_of("\"'", decl + 10);
+        if (declEnd != std::string::npos)
+          fileCharset = data.substr(decl + 10, declEnd - decl - 10);
+      }
+    }
+
+    size_t pos = 0;
+    while (true)
     {
+      size_t startEnd, end;
+      size_t start = FindResponseTag(data, pos, false, startEnd);
+      if (start == std::string::npos)
+      {
+        // keep what might be the beginning of the next tag
+        size_t last = data.rfind('<');
+        pos = (last != std::string::npos && last >= pos) ? last : data.size();
+        break;
+      }
+      if (FindResponseTag(data, startEnd, true, end) == std::string::npos)
+      {
+        pos = start;
+        break;
+      }
+
+      CXBMCTinyXML davResponse;
+      if (!davResponse.Parse(data.substr(start, end + 1 - start), fileCharset) ||
+          !davResponse.RootElement())
+      {
+        CLog::Log(LOGERROR, "%s - Unable to process dav directory (%s)", __FUNCTION__, url.GetRedacted().c_str());
+        dav.Close();
+        return false;
+      }
+      pos = end + 1;
+      found = true;
+
       CFileItem item;
-      ParseResponse(pChild->ToElement(), item);
-      CURL url2(url);
+      std::string itemEtag;
+      ParseResponse(davResponse.RootElement(), item, itemEtag);
       CURL url3(item.GetPath());
 
       std::string itemPath(URIUtils::AddFileToFolder(url2.GetWithoutFilename(), url3.GetFileName()));
@@ -181,14 +286,63 @@ bool CDAVDirectory::GetDirectory(const CURL& url, CFileItemList &items)
         CFileItemPtr pItem(new CFileItem(item));
         items.Add(pItem);
       }
+      else
+        etag = itemEtag;
     }
+    data.erase(0, pos);
   }
 
   dav.Close();
 
+  if (!found)
+  {
+    CLog::Log(LOGERROR, "%s - Unable to process dav directory (%s)", __FUNCTION__, url.GetRedacted().c_str());
+    return false;
+  }
+
+  if (!etag.empty())
+    CacheListing(strPath, etag, items);
+
   return true;
 }
 
+bool CDAVDirectory::GetCachedListing(const std::string& strPath, CCachedListing& listing)
+{
+  CSingleLock lock(m_cacheLock);
+  auto it = m_cachedListings.find(strPath);
+  if (it == m_cachedListings.end())
+    return false;
+
+  it->second.time = XbmcThreads::SystemClockMillis();
+  listing = it->second;
+  return true;
+}
+
+void CDAVDirectory::CacheListing(const std::string& strPath, const std::string& etag, const CFileItemList& items)
+{
+  std::shared_ptr<CFileItemList> listing(new CFileItemList);
+  listing->Copy(items);
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+
+  CSingleLock lock(m_cacheLock);
+  if (m_cachedListings.size() >= MAX_CACHED_LISTINGS && m_cachedListings.find(strPath) == m_cachedListings.end())
+  {
+    auto oldest = m_cachedListings.begin();
+    for (auto it = m_cachedListings.begin(); it != m_cachedListings.end(); ++it)
+    {
+      if (now - it->second.time > now - oldest->second.time)
+        oldest = it;
+    }
+    m_cachedListings.erase(oldest);
+  }
+
+  CCachedListing& cached = m_cachedListings[strPath];
+  cached.etag = etag;
+  cached.items = listing;
+  cached.time = now;
+}
+
 bool CDAVDirectory::Create(const CURL& url)
 {
   CDAVFile dav;
@@ -19,7 +19,12 @@
  *
  */
 
+#include <map>
+#include <memory>
+#include <string>
+
 #include "IDirectory.h"
+#include "threads/CriticalSection.h"
 #include "utils/XBMCTinyXML.h"
 #include "FileItem.h"
 
@@ -36,6 +41,24 @@ namespace XFILE
       bool Remove(const CURL& url) override;
       DIR_CACHE_TYPE GetCacheType(const CURL& url) const override { return DIR_CACHE_ONCE; };
     private:
-      void ParseResponse(const TiXmlElement *pElement, CFileItem &item);
+      void ParseResponse(const TiXmlElement *pElement, CFileItem &item, std::string &etag);
+
+      /*!
+       \brief Listing of a collection kept with its ETag, it is used again
+       when the server answers a conditional PROPFIND with 304.
+       */
+      struct CCachedListing
+      {
+        std::string etag;
+        std::shared_ptr<CFileItemList> items;
+        unsigned int time;
+      };
+
+      static bool GetCachedListing(const std::string& strPath, CCachedListing& listing);
+      static void CacheListing(const std::string& strPath, const std::string& etag, const CFileItemList& items);
+
+      static const size_t MAX_CACHED_LISTINGS = 16;
+      static std::map<std::string, CCachedListing> m_cachedListings;
+      static CCriticalSection m_cacheLock;
   };
 }
@@ -25,6 +25,7 @@
 #include "commons/Exception.h"
 #include "FileItem.h"
 #include "DirectoryCache.h"
+#include "StatCache.h"
 #include "settings/Settings.h"
 #include "utils/log.h"
 #include "utils/Job.h"
@@ -41,6 +42,58 @@ using namespace XFILE;
 
 #define TIME_TO_BUSY_DIALOG 500
 
+namespace
+{
+// IsAllowed of the directory only knows the mask once the directory is read
+class CMaskFilter : public IDirectory
+{
+public:
+  bool GetDirectory(const CURL& url, CFileItemList &items) override { return false; }
+};
+
+// drops the items CDirectory::GetDirectory would filter before passing them on,
+// it's the items callback of the directory as long as it exists
+class CFilteredItemsCallback : public IDirectoryItemsCallback
+{
+public:
+  CFilteredItemsCallback(IDirectoryItemsCallback &callback, IDirectory &directory, const CDirectory::CHints &hints)
+    : m_callback(callback), m_directory(directory), m_allowAll(directory.AllowAll())
+  {
+    m_showHidden = CServiceBroker::GetSettings().GetBool(CSettings::SETTING_FILELISTS_SHOWHIDDEN) || (hints.flags & DIR_FLAG_GET_HIDDEN);
+    m_mask.SetMask(hints.mask);
+    m_directory.SetItemsCallback(this);
+  }
+
+  ~CFilteredItemsCallback() override
+  {
+    m_directory.SetItemsCallback(nullptr);
+  }
+
+  void OnDirectoryItems(const CFileItemList &items) override
+  {
+    CFileItemList filtered;
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      CFileItemPtr item = items[i];
+      if (!m_allowAll && !item->m_bIsFolder && !m_mask.IsAllowed(item->GetURL()))
+        continue;
+      if (!m_showHidden && item->GetProperty("file:hidden").asBoolean())
+        continue;
+      filtered.Add(item);
+    }
+    if (!filtered.IsEmpty())
+      m_callback.OnDirectoryItems(filtered);
+  }
+
+private:
+  IDirectoryItemsCallback &m_callback;
+  IDirectory &m_directory;
+  CMaskFilter m_mask;
+  bool m_allowAll;
+  bool m_showHidden;
+};
+}
+
 class CGetDirectory
 {
 private:
@@ -187,6 +240,10 @@ bool CDirectory::GetDirectory(const CURL& url, std::shared_ptr<IDirectory> pDire
 
       pDirectory->SetFlags(hints.flags);
 
+      std::unique_ptr<CFilteredItemsCallback> callback;
+      if (hints.callback)
+        callback.reset(new CFilteredItemsCallback(*hints.callback, *pDirectory, hints));
+
       bool result = false, cancel = false;
       CURL authUrl = CURL(realURL);
 
@@ -219,6 +276,7 @@ bool CDirectory::GetDirectory(const CURL& url, std::shared_ptr<IDirectory> pDire
           return false;
         }
       }
+      callback.reset();
 
       // hide credentials if necessary
       if (CPasswordManager::GetInstance().IsURLSupported(realURL))
@@ -336,7 +394,10 @@ bool CDirectory::Create(const CURL& url)
     std::unique_ptr<IDirectory> pDirectory(CDirectoryFactory::Create(realURL));
     if (pDirectory.get())
       if(pDirectory->Create(realURL))
+      {
+        g_statCache.ClearSubPaths(realURL.Get());
         return true;
+      }
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (...)
@@ -410,6 +471,7 @@ bool CDirectory::Remove(const CURL& url)
       if(pDirectory->Remove(authUrl))
       {
         g_directoryCache.ClearFile(realURL.Get());
+        g_statCache.ClearSubPaths(realURL.Get());
         return true;
       }
   }
@@ -436,6 +498,7 @@ bool CDirectory::RemoveRecursive(const CURL& url)
       if(pDirectory->RemoveRecursive(authUrl))
       {
         g_directoryCache.ClearFile(realURL.Get());
+        g_statCache.ClearSubPaths(realURL.Get());
         return true;
       }
   }
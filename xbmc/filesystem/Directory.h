@@ -38,11 +38,12 @@ public:
   class CHints
   {
   public:
-    CHints() : flags(DIR_FLAG_DEFAULTS)
+    CHints() : flags(DIR_FLAG_DEFAULTS), callback(nullptr)
     {
     };
     std::string mask;
     int flags;
+    IDirectoryItemsCallback *callback; ///< receives filtered items while they are read, see IDirectory::SetItemsCallback
   };
 
   static bool GetDirectory(const CURL& url
@@ -24,70 +24,92 @@
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
+#include "music/tags/MusicInfoTag.h"
+#include "video/VideoInfoTag.h"
 #include "URL.h"
 #include "climits"
 
 #include <algorithm>
-
-// Maximum number of directories to keep in our cache
-#define MAX_CACHED_DIRS 50
+#include <functional>
 
 using namespace XFILE;
 
+namespace
+{
+std::shared_ptr<CFileItemList> NewList()
+{
+  std::shared_ptr<CFileItemList> items(new CFileItemList);
+  items->SetIgnoreURLOptions(true);
+  items->SetFastLookup(true);
+  return items;
+}
+}
+
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
   m_lastAccess = 0;
-  m_Items = new CFileItemList;
-  m_Items->SetIgnoreURLOptions(true);
-  m_Items->SetFastLookup(true);
+  m_size = 0;
+  m_Items = NewList();
 }
 
-CDirectoryCache::CDir::~CDir()
-{
-  delete m_Items;
-}
+CDirectoryCache::CDir::~CDir() = default;
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
+void CDirectoryCache::CDir::SetLastAccess(std::atomic<unsigned int> &accessCounter)
 {
   m_lastAccess = accessCounter++;
 }
 
-CDirectoryCache::CDirectoryCache(void)
+CDirectoryCache::CDirectoryCache(size_t maxSize /* = MAX_CACHE_SIZE */)
+  : m_maxSize(maxSize),
+    m_size(0),
+    m_accessCounter(0),
+    m_cacheHits(0),
+    m_cacheMisses(0)
 {
-  m_accessCounter = 0;
-#ifdef _DEBUG
-  m_cacheHits = 0;
-  m_cacheMisses = 0;
-#endif
+  CMemoryBudget::GetInstance().Register(this, "Directory listings", 0);
 }
 
-CDirectoryCache::~CDirectoryCache(void) = default;
+CDirectoryCache::~CDirectoryCache(void)
+{
+  CMemoryBudget::GetInstance().Unregister(this);
+}
 
 bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  std::shared_ptr<CFileItemList> cached;
   {
-    CDir* dir = i->second;
-    if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
-       (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
+    Shard& shard = GetShard(storedPath);
+    CSingleLock lock(shard.m_cs);
+
+    ciCache i = shard.m_cache.find(storedPath);
+    if (i != shard.m_cache.end())
     {
-      items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-      m_cacheHits+=items.Size();
-#endif
-      return true;
+      CDir* dir = i->second;
+      if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
+         (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
+      {
+        cached = dir->m_Items;
+        dir->SetLastAccess(m_accessCounter);
+      }
     }
   }
-  return false;
+
+  if (!cached)
+  {
+    m_cacheMisses++;
+    return false;
+  }
+
+  // the caller alters the items, so it gets copies of its own. The snapshot
+  // isn't changed while we hold it, copying doesn't block the shard.
+  items.Copy(*cached);
+  m_cacheHits++;
+  return true;
 }
 
 void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
@@ -106,7 +128,6 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  CSingleLock lock (m_cs);
 
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
@@ -114,12 +135,31 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
 
   ClearDirectory(storedPath);
 
-  CheckIfFull();
-
   CDir* dir = new CDir(cacheType);
   dir->m_Items->Copy(items);
+  dir->m_size = GetSize(*dir->m_Items);
+
+  // a listing larger than the whole cache would only push out all others
+  if (dir->m_size > m_maxSize)
+  {
+    CLog::Log(LOGDEBUG, "%s - not caching %s, %u items exceed the cache size", __FUNCTION__, storedPath.c_str(), dir->m_Items->Size());
+    delete dir;
+    return;
+  }
+
+  CheckIfFull(dir->m_size);
+
+  Shard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
+
+  // another thread may have cached the same path meanwhile
+  iCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
+    Delete(shard, i);
+
   dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+  m_size += dir->m_size;
+  shard.m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
 }
 
 void CDirectoryCache::ClearFile(const std::string& strFile)
@@ -132,55 +172,72 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  iCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
-    Delete(i);
+  Shard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
+
+  iCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
+    Delete(shard, i);
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (Shard& shard : m_shards)
   {
-    if (URIUtils::PathHasParent(i->first, storedPath))
-      Delete(i++);
-    else
-      i++;
+    CSingleLock lock(shard.m_cs);
+
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end())
+    {
+      if (URIUtils::PathHasParent(i->first, storedPath))
+        Delete(shard, i++);
+      else
+        i++;
+    }
   }
 }
 
 void CDirectoryCache::AddFile(const std::string& strFile)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string strPath = URIUtils::GetDirectory(CURL(strFile).GetWithoutOptions());
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
+  Shard& shard = GetShard(strPath);
+  CSingleLock lock(shard.m_cs);
+
+  ciCache i = shard.m_cache.find(strPath);
+  if (i != shard.m_cache.end())
   {
     CDir *dir = i->second;
+    // a reader is copying the snapshot, give the cache a new one. The items
+    // themselves are never altered and can be shared.
+    if (dir->m_Items.use_count() > 1)
+    {
+      std::shared_ptr<CFileItemList> items = NewList();
+      items->Copy(*dir->m_Items, false);
+      items->Append(*dir->m_Items);
+      dir->m_Items = items;
+    }
     CFileItemPtr item(new CFileItem(strFile, false));
     dir->m_Items->Add(item);
     dir->SetLastAccess(m_accessCounter);
+
+    size_t size = GetSize(*item);
+    dir->m_size += size;
+    m_size += size;
   }
 }
 
 bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 {
-  CSingleLock lock (m_cs);
   bInCache = false;
 
   // Get rid of any URL options, else the compare may be wrong
@@ -189,31 +246,33 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
   std::string storedPath = URIUtils::GetDirectory(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  Shard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
+
+  ciCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
   {
     bInCache = true;
     CDir *dir = i->second;
     dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
     m_cacheHits++;
-#endif
     return (URIUtils::PathEquals(strPath, storedPath) || dir->m_Items->Contains(strFile));
   }
-#ifdef _DEBUG
   m_cacheMisses++;
-#endif
   return false;
 }
 
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
-  CSingleLock lock (m_cs);
+  for (Shard& shard : m_shards)
+  {
+    CSingleLock lock(shard.m_cs);
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end() )
-    Delete(i++);
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end())
+      Delete(shard, i++);
+  }
 }
 
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
@@ -230,60 +289,134 @@ void CDirectoryCache::InitCache(std::set<std::string>& dirs)
 
 void CDirectoryCache::ClearCache(std::set<std::string>& dirs)
 {
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (Shard& shard : m_shards)
   {
-    if (dirs.find(i->first) != dirs.end())
-      Delete(i++);
-    else
-      i++;
+    CSingleLock lock(shard.m_cs);
+
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end())
+    {
+      if (dirs.find(i->first) != dirs.end())
+        Delete(shard, i++);
+      else
+        i++;
+    }
   }
 }
 
-void CDirectoryCache::CheckIfFull()
+void CDirectoryCache::OnMemoryPressure(MemoryPressure level)
 {
-  CSingleLock lock (m_cs);
+  // listings are cheap to get again, compared to what the OS does when it runs out
+  if (level == MemoryPressure::CRITICAL)
+    Clear();
+  else
+    Shrink(m_size / 2);
+}
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+void CDirectoryCache::CheckIfFull(size_t size)
+{
+  // remove the last accessed folders until the new one fits
+  Shrink(size < m_maxSize ? m_maxSize - size : 0);
+}
+
+void CDirectoryCache::Shrink(size_t maxSize)
+{
+  // remove the last accessed folders until the cache fits. Only one shard is
+  // locked at a time, so the oldest folder is looked up again before removing it.
+  while (m_size > maxSize)
   {
-    // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    Shard* oldestShard = nullptr;
+    std::string oldestPath;
+    unsigned int oldestAccess = UINT_MAX;
+    for (Shard& shard : m_shards)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      CSingleLock lock(shard.m_cs);
+      for (ciCache i = shard.m_cache.begin(); i != shard.m_cache.end(); i++)
+      {
+        // ensure dirs that are always cached aren't cleared
+        if (i->second->m_cacheType != DIR_CACHE_ALWAYS && i->second->GetLastAccess() < oldestAccess)
+        {
+          oldestShard = &shard;
+          oldestPath = i->first;
+          oldestAccess = i->second->GetLastAccess();
+        }
+      }
     }
+
+    if (!oldestShard)
+      break;
+
+    CSingleLock lock(oldestShard->m_cs);
+    iCache i = oldestShard->m_cache.find(oldestPath);
+    if (i != oldestShard->m_cache.end() && i->second->GetLastAccess() == oldestAccess)
+      Delete(*oldestShard, i);
   }
-  if (lastAccessed != m_cache.end() && numCached >= MAX_CACHED_DIRS)
-    Delete(lastAccessed);
 }
 
-void CDirectoryCache::Delete(iCache it)
+CDirectoryCache::Shard& CDirectoryCache::GetShard(const std::string& storedPath)
+{
+  return m_shards[std::hash<std::string>()(storedPath) % SHARD_COUNT];
+}
+
+void CDirectoryCache::Delete(Shard& shard, iCache it)
 {
   CDir* dir = it->second;
+  m_size -= dir->m_size;
   delete dir;
-  m_cache.erase(it);
+  shard.m_cache.erase(it);
+}
+
+size_t CDirectoryCache::GetSize(const CFileItemList& items)
+{
+  size_t size = sizeof(CFileItemList);
+  for (int i = 0; i < items.Size(); i++)
+    size += GetSize(*items.Get(i));
+  return size;
+}
+
+size_t CDirectoryCache::GetSize(const CFileItem& item)
+{
+  // an estimate, the tags hold further strings and lists
+  size_t size = sizeof(CFileItem) + item.GetPath().size() + item.GetLabel().size();
+  if (item.HasVideoInfoTag())
+    size += sizeof(CVideoInfoTag);
+  if (item.HasMusicInfoTag())
+    size += sizeof(MUSIC_INFO::CMusicInfoTag);
+  return size;
+}
+
+CDirectoryCache::Stats CDirectoryCache::GetStats() const
+{
+  Stats stats;
+  stats.hits = m_cacheHits;
+  stats.misses = m_cacheMisses;
+  stats.size = m_size;
+  for (const Shard& shard : m_shards)
+  {
+    CSingleLock lock(shard.m_cs);
+    for (ciCache i = shard.m_cache.begin(); i != shard.m_cache.end(); i++)
+    {
+      stats.items += i->second->m_Items->Size();
+      stats.dirs++;
+    }
+  }
+  return stats;
 }
 
 #ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
-  CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
-  // run through and find the oldest and the number of items cached
+  Stats stats = GetStats();
+  CLog::Log(LOGDEBUG, "%s - total of %" PRIu64" cache hits, and %" PRIu64" cache misses", __FUNCTION__, stats.hits, stats.misses);
+  // run through and find the oldest
   unsigned int oldest = UINT_MAX;
-  unsigned int numItems = 0;
-  unsigned int numDirs = 0;
-  for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
+  for (const Shard& shard : m_shards)
   {
-    CDir *dir = i->second;
-    oldest = std::min(oldest, dir->GetLastAccess());
-    numItems += dir->m_Items->Size();
-    numDirs++;
+    CSingleLock lock(shard.m_cs);
+    for (ciCache i = shard.m_cache.begin(); i != shard.m_cache.end(); i++)
+      oldest = std::min(oldest, i->second->GetLastAccess());
   }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total, %zu bytes.  Oldest is %u, current is %u", __FUNCTION__,
+            stats.dirs, stats.items, stats.size, oldest, m_accessCounter.load());
 }
 #endif
@@ -22,15 +22,28 @@
 #include "IDirectory.h"
 #include "Directory.h"
 #include "threads/CriticalSection.h"
+#include "utils/MemoryBudget.h"
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <set>
 
 class CFileItem;
 
 namespace XFILE
 {
-  class CDirectoryCache
+  /*!
+   \brief Cache of directory listings, shared by all threads.
+
+   The listings are spread over shards by path, each with a lock of its own, so
+   lookups of different paths don't wait for each other. A cached listing is an
+   immutable snapshot which is copied for the caller outside of any lock. The
+   cache is limited by the estimated memory of the listings, the least recently
+   used ones are removed first. Under memory pressure the cache is shrunk to half
+   its size, or emptied if the pressure is critical.
+   */
+  class CDirectoryCache : public IMemoryConsumer
   {
     class CDir
     {
@@ -38,18 +51,31 @@ namespace XFILE
       explicit CDir(DIR_CACHE_TYPE cacheType);
       virtual ~CDir();
 
-      void SetLastAccess(unsigned int &accessCounter);
+      void SetLastAccess(std::atomic<unsigned int> &accessCounter);
       unsigned int GetLastAccess() const { return m_lastAccess; };
 
-      CFileItemList* m_Items;
+      std::shared_ptr<CFileItemList> m_Items; //!< replaced rather than changed while shared
       DIR_CACHE_TYPE m_cacheType;
+      size_t m_size; //!< estimated memory used by m_Items
     private:
       CDir(const CDir&) = delete;
       CDir& operator=(const CDir&) = delete;
       unsigned int m_lastAccess;
     };
   public:
-    CDirectoryCache(void);
+    struct Stats
+    {
+      uint64_t hits = 0; //!< lookups of listings and files answered by the cache
+      uint64_t misses = 0; //!< lookups the cache had no listing for
+      unsigned int dirs = 0;
+      unsigned int items = 0;
+      size_t size = 0; //!< estimated memory used by the cached listings
+    };
+
+    /*!
+     \param maxSize memory the cached listings may use
+     */
+    explicit CDirectoryCache(size_t maxSize = MAX_CACHE_SIZE);
     virtual ~CDirectoryCache(void);
     bool GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll = false);
     void SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType);
@@ -59,27 +85,45 @@ namespace XFILE
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
+    Stats GetStats() const;
+
+    // IMemoryConsumer implementation
+    size_t GetMemoryBudgetUsage() const override { return m_size; }
+    void OnMemoryPressure(MemoryPressure level) override;
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
   protected:
+    static const size_t MAX_CACHE_SIZE = 64 * 1024 * 1024;
+    static const unsigned int SHARD_COUNT = 16;
+
+    typedef std::map<std::string, CDir*> tCache;
+    typedef tCache::iterator iCache;
+    typedef tCache::const_iterator ciCache;
+
+    struct Shard
+    {
+      mutable CCriticalSection m_cs;
+      tCache m_cache;
+    };
+
     void InitCache(std::set<std::string>& dirs);
     void ClearCache(std::set<std::string>& dirs);
-    void CheckIfFull();
+    void CheckIfFull(size_t size);
+    void Shrink(size_t maxSize);
 
-    std::map<std::string, CDir*> m_cache;
-    typedef std::map<std::string, CDir*>::iterator iCache;
-    typedef std::map<std::string, CDir*>::const_iterator ciCache;
-    void Delete(iCache i);
+    Shard& GetShard(const std::string& storedPath);
+    void Delete(Shard& shard, iCache i);
+    static size_t GetSize(const CFileItemList& items);
+    static size_t GetSize(const CFileItem& item);
 
-    CCriticalSection m_cs;
+    Shard m_shards[SHARD_COUNT];
+    size_t m_maxSize;
+    std::atomic<size_t> m_size;
 
-    unsigned int m_accessCounter;
-
-#ifdef _DEBUG
-    unsigned int m_cacheHits;
-    unsigned int m_cacheMisses;
-#endif
+    std::atomic<unsigned int> m_accessCounter;
+    std::atomic<uint64_t> m_cacheHits;
+    std::atomic<uint64_t> m_cacheMisses;
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
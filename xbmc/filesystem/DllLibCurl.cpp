@@ -124,6 +124,16 @@ const char* DllLibCurl::easy_strerror(CURLcode code)
   return curl_easy_strerror(code);
 }
 
+CURLSH* DllLibCurl::share_init()
+{
+  return curl_share_init();
+}
+
+CURLSHcode DllLibCurl::share_cleanup(CURLSH* share)
+{
+  return curl_share_cleanup(share);
+}
+
 #if defined(HAS_CURL_STATIC)
 void DllLibCurl::crypto_set_id_callback(unsigned long (*cb)())
 {
@@ -142,14 +152,41 @@ DllLibCurlGlobal::DllLibCurlGlobal()
   {
     CLog::Log(LOGERROR, "Error initializing libcurl");
   }
+
+  m_share = share_init();
+  if (m_share)
+  {
+    share_setopt(m_share, CURLSHOPT_LOCKFUNC, share_lock);
+    share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, share_unlock);
+    share_setopt(m_share, CURLSHOPT_USERDATA, this);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+  }
 }
 
 DllLibCurlGlobal::~DllLibCurlGlobal()
 {
+  // fails if a handle still uses it, it goes away with the process then
+  if (m_share)
+    share_cleanup(m_share);
+
   // close libcurl
   curl_global_cleanup();
 }
 
+void DllLibCurlGlobal::share_lock(CURL_HANDLE* handle, curl_lock_data data, curl_lock_access access, void* userptr)
+{
+  static_cast<DllLibCurlGlobal*>(userptr)->m_shareLocks[data].lock();
+}
+
+void DllLibCurlGlobal::share_unlock(CURL_HANDLE* handle, curl_lock_data data, void* userptr)
+{
+  static_cast<DllLibCurlGlobal*>(userptr)->m_shareLocks[data].unlock();
+}
+
 void DllLibCurlGlobal::CheckIdle()
 {
   CSingleLock lock(m_critSection);
@@ -71,6 +71,13 @@ public:
   struct curl_slist* slist_append(struct curl_slist* list, const char* to_append);
   void slist_free_all(struct curl_slist* list);
   const char* easy_strerror(CURLcode code);
+  CURLSH* share_init();
+  template<typename... Args>
+  CURLSHcode share_setopt(CURLSH* share, CURLSHoption option, Args... args)
+  {
+    return curl_share_setopt(share, option, std::forward<Args>(args)...);
+  }
+  CURLSHcode share_cleanup(CURLSH* share);
 };
 
 class DllLibCurlGlobal : public DllLibCurl
@@ -88,6 +95,13 @@ public:
   CURL_HANDLE* easy_duphandle(CURL_HANDLE* easy_handle) override;
   void CheckIdle();
 
+  /*!
+   \brief Share handle all handles should use, so DNS results, TLS sessions
+   and (with libcurl 7.57 or later) open connections are reused by every
+   transfer, not only by the next one of the same session.
+   */
+  CURLSH* GetShare() const { return m_share; }
+
   /* overloaded load and unload with reference counter */
 
   /* structure holding a session info */
@@ -105,6 +119,13 @@ public:
 
   VEC_CURLSESSIONS m_sessions;
   CCriticalSection m_critSection;
+
+private:
+  static void share_lock(CURL_HANDLE* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+  static void share_unlock(CURL_HANDLE* handle, curl_lock_data data, void* userptr);
+
+  CURLSH* m_share = nullptr;
+  CCriticalSection m_shareLocks[CURL_LOCK_DATA_LAST];
 };
 } // namespace XCURL
 
@@ -89,6 +89,11 @@ public:
   virtual int nfs_pread(struct nfs_context *nfs,     struct nfsfh *nfsfh,  uint64_t offset, uint64_t count, char *buf)=0;
   virtual int nfs_pwrite(struct nfs_context *nfs,    struct nfsfh *nfsfh,  uint64_t offset, uint64_t count, char *buf)=0;
   virtual int nfs_lseek(struct nfs_context *nfs,     struct nfsfh *nfsfh,  uint64_t offset, int whence,   uint64_t *current_offset)=0;
+  virtual int nfs_pread_async(struct nfs_context *nfs, struct nfsfh *nfsfh, uint64_t offset, uint64_t count, nfs_cb cb, void *private_data)=0;
+  virtual int nfs_get_fd(struct nfs_context *nfs)=0;
+  virtual int nfs_which_events(struct nfs_context *nfs)=0;
+  virtual int nfs_service(struct nfs_context *nfs,   int revents)=0;
+  virtual void nfs_set_readmax(struct nfs_context *nfs, uint64_t readmax)=0;
 };
 
 class DllLibNfs : public DllDynamic, DllLibNfsInterface
@@ -135,6 +140,11 @@ class DllLibNfs : public DllDynamic, DllLibNfsInterface
   DEFINE_METHOD5(int, nfs_pread,     (struct nfs_context *p1, struct nfsfh *p2,  uint64_t p3,   uint64_t p4,  char *p5))
   DEFINE_METHOD5(int, nfs_pwrite,    (struct nfs_context *p1, struct nfsfh *p2,  uint64_t p3,   uint64_t p4,  char *p5))
   DEFINE_METHOD5(int, nfs_lseek,     (struct nfs_context *p1, struct nfsfh *p2,  uint64_t p3,   int p4,     uint64_t *p5))
+  DEFINE_METHOD6(int, nfs_pread_async, (struct nfs_context *p1, struct nfsfh *p2, uint64_t p3, uint64_t p4, nfs_cb p5, void *p6))
+  DEFINE_METHOD1(int, nfs_get_fd,    (struct nfs_context *p1))
+  DEFINE_METHOD1(int, nfs_which_events, (struct nfs_context *p1))
+  DEFINE_METHOD2(int, nfs_service,   (struct nfs_context *p1, int p2))
+  DEFINE_METHOD2(void, nfs_set_readmax, (struct nfs_context *p1, uint64_t p2))
 
 
 
@@ -160,6 +170,11 @@ class DllLibNfs : public DllDynamic, DllLibNfsInterface
     RESOLVE_METHOD_RENAME(nfs_pwrite,    nfs_pwrite)
     RESOLVE_METHOD_RENAME(nfs_write,     nfs_write)
     RESOLVE_METHOD_RENAME(nfs_lseek,     nfs_lseek)
+    RESOLVE_METHOD_RENAME(nfs_pread_async, nfs_pread_async)
+    RESOLVE_METHOD_RENAME(nfs_get_fd,    nfs_get_fd)
+    RESOLVE_METHOD_RENAME(nfs_which_events, nfs_which_events)
+    RESOLVE_METHOD_RENAME(nfs_service,   nfs_service)
+    RESOLVE_METHOD_OPTIONAL(nfs_set_readmax)
     RESOLVE_METHOD_RENAME(nfs_fsync,     nfs_fsync)
     RESOLVE_METHOD_RENAME(nfs_truncate,  nfs_truncate)
     RESOLVE_METHOD_RENAME(nfs_ftruncate, nfs_ftruncate)
@@ -181,5 +196,9 @@ class DllLibNfs : public DllDynamic, DllLibNfsInterface
     RESOLVE_METHOD_RENAME(nfs_rename,    nfs_rename)
     RESOLVE_METHOD_RENAME(nfs_link,      nfs_link)      
   END_METHOD_RESOLVE()
+
+public:
+  //nfs_set_readmax is missing in old versions of libnfs
+  bool CanSetReadMax() const { return m_nfs_set_readmax_ptr != nullptr; }
 };
 
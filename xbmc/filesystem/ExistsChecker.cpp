@@ -0,0 +1,162 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ExistsChecker.h"
+
+#include <algorithm>
+
+#include "Directory.h"
+#include "File.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "URL.h"
+
+using namespace XFILE;
+
+// how often the progress callback is called, in milliseconds
+#define PROGRESS_INTERVAL 100
+
+CExistsChecker::CExistsChecker(unsigned int maxPerServer /* = MAX_PER_SERVER */,
+                               unsigned int maxThreads /* = MAX_THREADS */)
+  : m_maxPerServer(std::max(1u, maxPerServer)),
+    m_maxThreads(std::max(1u, maxThreads))
+{
+}
+
+CExistsChecker::~CExistsChecker() = default;
+
+std::vector<CExistsChecker::Result> CExistsChecker::Check(const std::vector<std::string> &paths,
+                                                          bool directories /* = false */,
+                                                          const ProgressCallback &progress /* = ProgressCallback() */)
+{
+  {
+    CSingleLock lock(m_section);
+    m_paths = &paths;
+    m_results.assign(paths.size(), UNCHECKED);
+    m_directories = directories;
+    m_cancelled = false;
+    m_done = 0;
+    m_servers.clear();
+
+    // shares of the same server are limited together, the server is the bottleneck
+    for (size_t i = paths.size(); i > 0; i--)
+    {
+      const CURL url(paths[i - 1]);
+      m_servers[url.GetProtocol() + "://" + url.GetHostName()].pending.push_back(i - 1);
+    }
+  }
+
+  size_t threads = 0;
+  for (const auto &server : m_servers)
+    threads += std::min<size_t>(server.second.pending.size(), m_maxPerServer);
+  threads = std::min<size_t>(threads, m_maxThreads);
+
+  std::vector<std::unique_ptr<CThread>> workers;
+  for (size_t i = 0; i < threads; i++)
+  {
+    workers.emplace_back(new CThread(this, "ExistsChecker"));
+    {
+      CSingleLock lock(m_section);
+      m_running++;
+    }
+    workers.back()->Create();
+  }
+
+  CSingleLock lock(m_section);
+  while (m_running > 0)
+  {
+    if (progress && !m_cancelled)
+    {
+      const size_t done = m_done;
+      CSingleExit exit(m_section);
+      if (!progress(done, paths.size()))
+      {
+        CSingleLock cancelLock(m_section);
+        m_cancelled = true;
+        m_serverIdle.notifyAll();
+      }
+    }
+
+    m_finished.wait(lock, PROGRESS_INTERVAL);
+  }
+  lock.Leave();
+
+  workers.clear();
+
+  m_paths = nullptr;
+  m_servers.clear();
+  return std::move(m_results);
+}
+
+void CExistsChecker::Run()
+{
+  size_t index;
+  std::string server;
+  while (Next(index, server))
+  {
+    const std::string &path = (*m_paths)[index];
+    bool exists;
+    if (m_directories)
+      exists = CDirectory::Exists(path, false);
+    else
+      exists = CFile::Exists(path, false);
+
+    CSingleLock lock(m_section);
+    m_results[index] = exists ? EXISTS : MISSING;
+    m_servers[server].active--;
+    m_done++;
+    m_serverIdle.notifyAll();
+  }
+
+  CSingleLock lock(m_section);
+  m_running--;
+  m_finished.notifyAll();
+}
+
+bool CExistsChecker::Next(size_t &index, std::string &server)
+{
+  CSingleLock lock(m_section);
+  while (!m_cancelled)
+  {
+    bool pending = false;
+    for (auto &it : m_servers)
+    {
+      if (it.second.pending.empty())
+        continue;
+
+      pending = true;
+      if (it.second.active < m_maxPerServer)
+      {
+        index = it.second.pending.back();
+        it.second.pending.pop_back();
+        it.second.active++;
+        server = it.first;
+        return true;
+      }
+    }
+
+    if (!pending)
+      break;
+
+    // every server with paths left is busy, wait for one of its tests to finish
+    m_serverIdle.wait(lock);
+  }
+  return false;
+}
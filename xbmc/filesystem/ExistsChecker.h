@@ -0,0 +1,109 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/IRunnable.h"
+
+class CThread;
+
+namespace XFILE
+{
+  /*!
+   \brief Tests if many files or folders exist, a few at once per server.
+
+   Each test of a path on a network share waits for a round trip to the
+   server, so checking a whole library one path after the other takes long.
+   The paths are tested by a few threads instead, with at most a few requests
+   to the same server at once so it isn't flooded.
+   */
+  class CExistsChecker : private IRunnable
+  {
+  public:
+    enum Result
+    {
+      MISSING,
+      EXISTS,
+      UNCHECKED ///< the check was cancelled before the path was tested
+    };
+
+    /*!
+     \brief Called on the calling thread while the paths are tested.
+     \param done number of paths tested so far
+     \param total number of paths to test
+     \return false to cancel the check
+     */
+    typedef std::function<bool(size_t done, size_t total)> ProgressCallback;
+
+    /*!
+     \param maxPerServer paths on the same server that are tested at once
+     \param maxThreads threads testing paths at once
+     */
+    explicit CExistsChecker(unsigned int maxPerServer = MAX_PER_SERVER,
+                            unsigned int maxThreads = MAX_THREADS);
+    ~CExistsChecker() override;
+
+    /*!
+     \brief Test the paths, without the caches of CFile or CDirectory.
+     \param directories test for folders instead of files
+     \param progress called every now and then, may be empty
+     \return the result of each path, in the order of the paths
+     */
+    std::vector<Result> Check(const std::vector<std::string> &paths, bool directories = false,
+                              const ProgressCallback &progress = ProgressCallback());
+
+  private:
+    static const unsigned int MAX_PER_SERVER = 4;
+    static const unsigned int MAX_THREADS = 16;
+
+    CExistsChecker(const CExistsChecker&) = delete;
+    CExistsChecker& operator=(const CExistsChecker&) = delete;
+
+    struct CServer
+    {
+      std::vector<size_t> pending; ///< indices of the paths, tested from the back
+      unsigned int active = 0;
+    };
+
+    void Run() override;
+    bool Next(size_t &index, std::string &server);
+
+    unsigned int m_maxPerServer;
+    unsigned int m_maxThreads;
+
+    CCriticalSection m_section;
+    XbmcThreads::ConditionVariable m_serverIdle; ///< a test finished, its server may take the next
+    XbmcThreads::ConditionVariable m_finished; ///< a thread ran out of paths
+    std::map<std::string, CServer> m_servers;
+    const std::vector<std::string> *m_paths = nullptr;
+    std::vector<Result> m_results;
+    bool m_directories = false;
+    bool m_cancelled = false;
+    size_t m_done = 0;
+    unsigned int m_running = 0;
+  };
+}
@@ -28,7 +28,11 @@
 #include "Directory.h"
 #include "FileCache.h"
 #include "PasswordManager.h"
+#include "SpecialProtocol.h"
+#include "StatCache.h"
 #include "system.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/BitstreamStats.h"
@@ -37,8 +41,224 @@
 
 #include "commons/Exception.h"
 
+#include <atomic>
+#include <memory>
+
+#if defined(TARGET_LINUX)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 using namespace XFILE;
 
+namespace
+{
+/*!
+ \brief Reads the source of a copy on its own thread, filling one buffer while
+ the caller writes the other.
+ */
+class CCopyReader : public CThread
+{
+public:
+  CCopyReader(CFile& file, size_t bufferSize)
+    : CThread("FileCopy"),
+      m_file(file),
+      m_bufferSize(bufferSize)
+  {
+    for (auto& buffer : m_buffers)
+      buffer.data.reset(new char[bufferSize]);
+  }
+
+  ~CCopyReader() override
+  {
+    Stop();
+  }
+
+  void Stop()
+  {
+    m_bStop = true;
+    m_free.Set();
+    StopThread(true);
+  }
+
+  /*!
+   \brief Wait for the next block read.
+   \param length number of bytes read, 0 at the end and negative on error
+   */
+  const char* Next(ssize_t& length)
+  {
+    Buffer& buffer = m_buffers[m_next % BUFFERS];
+    while (!buffer.full)
+      m_filled.Wait();
+    length = buffer.length;
+    return buffer.data.get();
+  }
+
+  /*!
+   \brief Hand the block returned by Next() back to the reader.
+   */
+  void Release()
+  {
+    m_buffers[m_next++ % BUFFERS].full = false;
+    m_free.Set();
+  }
+
+protected:
+  void Process() override
+  {
+    for (unsigned int i = 0; !m_bStop; i++)
+    {
+      Buffer& buffer = m_buffers[i % BUFFERS];
+      while (buffer.full && !m_bStop)
+        m_free.Wait();
+      if (m_bStop)
+        break;
+
+      buffer.length = m_file.Read(buffer.data.get(), m_bufferSize);
+      buffer.full = true;
+      m_filled.Set();
+      if (buffer.length <= 0)
+        break;
+    }
+  }
+
+private:
+  static const unsigned int BUFFERS = 2;
+
+  struct Buffer
+  {
+    std::unique_ptr<char[]> data;
+    ssize_t length = 0;
+    std::atomic<bool> full{false};
+  };
+
+  CFile& m_file;
+  size_t m_bufferSize;
+  Buffer m_buffers[BUFFERS];
+  unsigned int m_next = 0;
+  CEvent m_filled;
+  CEvent m_free;
+};
+
+/*!
+ \brief Reports the progress of a copy twice a second, the speed is the one
+ of the last seconds rather than the average since the start.
+ */
+class CCopyProgress
+{
+public:
+  CCopyProgress(IFileCallback* pCallback, void* pContext, uint64_t fileSize)
+    : m_callback(pCallback),
+      m_context(pContext),
+      m_fileSize(fileSize)
+  {
+    m_timer.StartZero();
+  }
+
+  //! \return false if the user aborted the copy
+  bool Update(uint64_t pos)
+  {
+    g_application.ResetScreenSaver();
+
+    float now = m_timer.GetElapsedSeconds();
+    if (!m_callback || now - m_lastTime <= 0.5f)
+      return true;
+
+    float speed = (pos - m_lastPos) / (now - m_lastTime);
+    m_speed = m_speed > 0.0f ? (m_speed + speed) / 2 : speed;
+    m_lastTime = now;
+    m_lastPos = pos;
+
+    int ipercent = 0;
+    if (m_fileSize)
+      ipercent = 100 * pos / m_fileSize;
+
+    return m_callback->OnFileCallback(m_context, ipercent, m_speed);
+  }
+
+private:
+  IFileCallback* m_callback;
+  void* m_context;
+  uint64_t m_fileSize;
+  CStopWatch m_timer;
+  float m_lastTime = 0.0f;
+  uint64_t m_lastPos = 0;
+  float m_speed = 0.0f;
+};
+
+#if defined(TARGET_LINUX) && defined(SYS_copy_file_range)
+/*!
+ \brief Copy a local file inside the kernel. Some file systems clone the data
+ then, network file systems mounted in the OS (NFS 4.2, CIFS) copy on the server.
+ \return 1 on success, -1 on failure and 0 if the kernel or file system can't
+ do it and the data has to be copied by reading and writing
+ */
+int CopyFileRange(const std::string& source, const std::string& dest,
+                  IFileCallback* pCallback, void* pContext)
+{
+  const std::string sourcePath = CSpecialProtocol::TranslatePath(source);
+  const std::string destPath = CSpecialProtocol::TranslatePath(dest);
+  if (URIUtils::IsURL(sourcePath) || URIUtils::IsURL(destPath))
+    return 0;
+
+  int in = open(sourcePath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (in < 0)
+    return 0;
+
+  struct stat st;
+  if (fstat(in, &st) != 0 || !S_ISREG(st.st_mode))
+  {
+    close(in);
+    return 0;
+  }
+
+  int out = open(destPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+  if (out < 0)
+  {
+    close(in);
+    return 0;
+  }
+
+  CCopyProgress progress(pCallback, pContext, st.st_size);
+  uint64_t pos = 0;
+  int result = 1;
+  while (pos < static_cast<uint64_t>(st.st_size))
+  {
+    ssize_t copied = syscall(SYS_copy_file_range, in, nullptr, out, nullptr, 16 * 1024 * 1024, 0);
+    if (copied < 0 && pos == 0 &&
+        (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP))
+    {
+      result = 0;
+      break;
+    }
+    if (copied <= 0)
+    {
+      CLog::Log(LOGERROR, "%s - Failed to copy %s (%d)", __FUNCTION__, CURL::GetRedacted(source).c_str(), errno);
+      result = -1;
+      break;
+    }
+
+    pos += copied;
+    if (!progress.Update(pos))
+    {
+      CLog::Log(LOGERROR, "%s - User aborted copy", __FUNCTION__);
+      result = -1;
+      break;
+    }
+  }
+
+  close(in);
+  if (close(out) != 0 && result > 0)
+    result = -1;
+  if (result < 0)
+    unlink(destPath.c_str());
+  return result;
+}
+#endif
+}
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -132,28 +352,36 @@ bool CFile::Copy(const CURL& url2, const CURL& dest, XFILE::IFileCallback* pCall
     }
     if (CFile::Exists(dest))
       CFile::Delete(dest);
+
+#if defined(TARGET_LINUX) && defined(SYS_copy_file_range)
+    int copied = CopyFileRange(url.Get(), pathToUrl, pCallback, pContext);
+    if (copied != 0)
+    {
+      file.Close();
+      g_statCache.ClearFile(pathToUrl);
+      return copied > 0;
+    }
+#endif
+
     if (!newFile.OpenForWrite(dest, true))  // overwrite always
     {
       file.Close();
       return false;
     }
 
-    int iBufferSize = GetChunkSize(file.GetChunkSize(), 128 * 1024);
-
-    auto_buffer buffer(iBufferSize);
-    ssize_t iRead, iWrite;
-
+    // read on another thread while writing, copies between network shares
+    // otherwise wait for one side at a time
     unsigned long long llFileSize = file.GetLength();
     unsigned long long llPos = 0;
 
-    CStopWatch timer;
-    timer.StartZero();
-    float start = 0.0f;
+    CCopyReader reader(file, GetChunkSize(file.GetChunkSize(), 1024 * 1024));
+    reader.Create();
+
+    CCopyProgress progress(pCallback, pContext, llFileSize);
     while (true)
     {
-      g_application.ResetScreenSaver();
-
-      iRead = file.Read(buffer.get(), iBufferSize);
+      ssize_t iRead;
+      const char* buffer = reader.Next(iRead);
       if (iRead == 0) break;
       else if (iRead < 0)
       {
@@ -163,14 +391,15 @@ bool CFile::Copy(const CURL& url2, const CURL& dest, XFILE::IFileCallback* pCall
       }
 
       /* write data and make sure we managed to write it all */
-      iWrite = 0;
+      ssize_t iWrite = 0;
       while(iWrite < iRead)
       {
-        ssize_t iWrite2 = newFile.Write(buffer.get() + iWrite, iRead - iWrite);
+        ssize_t iWrite2 = newFile.Write(buffer + iWrite, iRead - iWrite);
         if(iWrite2 <=0)
           break;
         iWrite+=iWrite2;
       }
+      reader.Release();
 
       if (iWrite != iRead)
       {
@@ -181,26 +410,14 @@ bool CFile::Copy(const CURL& url2, const CURL& dest, XFILE::IFileCallback* pCall
 
       llPos += iRead;
 
-      // calculate the current and average speeds
-      float end = timer.GetElapsedSeconds();
-
-      if (pCallback && end - start > 0.5 && end)
+      if (!progress.Update(llPos))
       {
-        start = end;
-
-        float averageSpeed = llPos / end;
-        int ipercent = 0;
-        if(llFileSize)
-          ipercent = 100 * llPos / llFileSize;
-
-        if(!pCallback->OnFileCallback(pContext, ipercent, averageSpeed))
-        {
-          CLog::Log(LOGERROR, "%s - User aborted copy", __FUNCTION__);
-          llFileSize = (uint64_t)-1;
-          break;
-        }
+        CLog::Log(LOGERROR, "%s - User aborted copy", __FUNCTION__);
+        llFileSize = (uint64_t)-1;
+        break;
       }
     }
+    reader.Stop();
 
     /* close both files */
     newFile.Close();
@@ -412,6 +629,7 @@ bool CFile::OpenForWrite(const CURL& file, bool bOverWrite)
     {
       // add this file to our directory cache (if it's stored)
       g_directoryCache.AddFile(url.Get());
+      g_statCache.ClearFile(url.Get());
       return true;
     }
     return false;
@@ -447,13 +665,19 @@ bool CFile::Exists(const CURL& file, bool bUseCache /* = true */)
         return true;
       if (bPathInCache)
         return false;
+
+      bool exists;
+      if (g_statCache.GetExists(url, exists))
+        return exists;
     }
 
     std::unique_ptr<IFile> pFile(CFileFactory::CreateLoader(url));
     if (!pFile.get())
       return false;
 
-    return pFile->Exists(authUrl);
+    bool exists = pFile->Exists(authUrl);
+    g_statCache.SetExists(url, exists);
+    return exists;
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (CRedirectException *pRedirectEx)
@@ -533,10 +757,16 @@ int CFile::Stat(const CURL& file, struct __stat64* buffer)
 
   try
   {
+    int result;
+    if (g_statCache.GetStat(url, buffer, result))
+      return result;
+
     std::unique_ptr<IFile> pFile(CFileFactory::CreateLoader(url));
     if (!pFile.get())
       return -1;
-    return pFile->Stat(authUrl, buffer);
+    result = pFile->Stat(authUrl, buffer);
+    g_statCache.SetStat(url, buffer, result);
+    return result;
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (CRedirectException *pRedirectEx)
@@ -888,6 +1118,7 @@ bool CFile::Delete(const CURL& file)
     if(pFile->Delete(authUrl))
     {
       g_directoryCache.ClearFile(url.Get());
+      g_statCache.ClearFile(url.Get());
       return true;
     }
   }
@@ -930,6 +1161,8 @@ bool CFile::Rename(const CURL& file, const CURL& newFile)
     {
       g_directoryCache.ClearFile(url.Get());
       g_directoryCache.AddFile(urlnew.Get());
+      g_statCache.ClearFile(url.Get());
+      g_statCache.ClearFile(urlnew.Get());
       return true;
     }
   }
@@ -961,6 +1194,7 @@ bool CFile::SetHidden(const CURL& file, bool hidden)
     if (!pFile.get())
       return false;
 
+    g_statCache.ClearFile(url.Get());
     return pFile->SetHidden(authUrl, hidden);
   }
   catch(...)
@@ -25,8 +25,10 @@
 #include "URL.h"
 
 #include "CircularCache.h"
+#include "PersistentFileCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "utils/Metrics.h"
 #include "settings/AdvancedSettings.h"
 
 #if !defined(TARGET_WINDOWS)
@@ -44,6 +46,21 @@
 using namespace XFILE;
 
 #define READ_CACHE_CHUNK_SIZE (128*1024)
+#define READAHEAD_CONTROL_TIME 4 // seconds
+
+namespace
+{
+// files are rarely cached in parallel, the one cached last is the one played
+void PublishCacheStatus(const SCacheStatus &status)
+{
+  static CMetricGauge &level = CMetrics::GetInstance().GetGauge("kodi_filecache_level",
+    "Fill level of the read ahead of the file cached last, 0 to 1");
+  static CMetricGauge &forward = CMetrics::GetInstance().GetGauge("kodi_filecache_forward_bytes",
+    "Bytes read ahead by the file cached last");
+  level.Set(status.level);
+  forward.Set(static_cast<double>(status.forward));
+}
+}
 
 class CWriteRate
 {
@@ -90,6 +107,49 @@ private:
   int64_t  m_size;
 };
 
+/*!
+ \brief Rate the cache is read at, following rises quickly and falls slowly
+ so peaks of the bitrate are covered.
+ */
+class CReadRate
+{
+public:
+  CReadRate()
+  {
+    Reset(0);
+  }
+
+  void Reset(int64_t pos)
+  {
+    m_stamp = XbmcThreads::SystemClockMillis();
+    m_pos = pos;
+    m_rate = 0.0;
+  }
+
+  unsigned Rate(int64_t pos)
+  {
+    const unsigned ts = XbmcThreads::SystemClockMillis();
+    const unsigned elapsed = ts - m_stamp;
+    if (elapsed < 1000)
+      return (unsigned)m_rate;
+
+    const double rate = 1000.0 * (pos - m_pos) / elapsed;
+    if (m_rate == 0.0)
+      m_rate = rate;
+    else
+      m_rate += (rate - m_rate) * (rate > m_rate ? 0.5 : 0.1);
+
+    m_pos = pos;
+    m_stamp = ts;
+    return (unsigned)m_rate;
+  }
+
+private:
+  unsigned m_stamp;
+  int64_t  m_pos;
+  double   m_rate;
+};
+
 
 CFileCache::CFileCache(const unsigned int flags)
   : CThread("FileCache")
@@ -103,7 +163,9 @@ CFileCache::CFileCache(const unsigned int flags)
   , m_chunkSize(0)
   , m_writeRate(0)
   , m_writeRateActual(0)
+  , m_readRate(0)
   , m_forwardCacheSize(0)
+  , m_forwardTarget(0)
   , m_fileSize(0)
   , m_flags(flags)
 {
@@ -115,7 +177,9 @@ CFileCache::CFileCache(CCacheStrategy *pCache, bool bDeleteCache /* = true */)
   , m_chunkSize(0)
   , m_writeRate(0)
   , m_writeRateActual(0)
+  , m_readRate(0)
   , m_forwardCacheSize(0)
+  , m_forwardTarget(0)
 {
   m_pCache = pCache;
   m_bDeleteCache = bDeleteCache;
@@ -177,6 +241,26 @@ bool CFileCache::Open(const CURL& url)
   m_chunkSize = CFile::GetChunkSize(m_source.GetChunkSize(), READ_CACHE_CHUNK_SIZE);
   m_fileSize = m_source.GetLength();
 
+  bool cacheOpen = false;
+  if (!m_pCache && (m_flags & READ_AUDIO_VIDEO) && m_seekPossible > 0 &&
+      CPersistentFileCache::CanCache(m_fileSize))
+  {
+    // keep what was read for seeking back or playing the file again, the
+    // forward limit follows the memory cache it replaces
+    size_t front = g_advancedSettings.m_cacheMemSize - g_advancedSettings.m_cacheMemSize / 4;
+    m_pCache = new CPersistentFileCache(m_sourcePath, m_fileSize, front);
+    if (m_pCache->Open() == CACHE_RC_OK)
+    {
+      cacheOpen = true;
+      m_forwardCacheSize = front;
+    }
+    else
+    {
+      delete m_pCache;
+      m_pCache = NULL;
+    }
+  }
+
   if (!m_pCache)
   {
     if (g_advancedSettings.m_cacheMemSize == 0)
@@ -219,7 +303,7 @@ bool CFileCache::Open(const CURL& url)
   }
 
   // open cache strategy
-  if (!m_pCache || m_pCache->Open() != CACHE_RC_OK)
+  if (!m_pCache || (!cacheOpen && m_pCache->Open() != CACHE_RC_OK))
   {
     CLog::Log(LOGERROR,"CFileCache::Open - failed to open cache");
     Close();
@@ -230,6 +314,8 @@ bool CFileCache::Open(const CURL& url)
   m_writePos = 0;
   m_writeRate = 1024 * 1024;
   m_writeRateActual = 0;
+  m_readRate = 0;
+  m_forwardTarget = 0;
   m_seekEvent.Reset();
   m_seekEnded.Reset();
 
@@ -256,6 +342,7 @@ void CFileCache::Process()
 
   CWriteRate limiter;
   CWriteRate average;
+  CReadRate reader;
   bool cacheReachEOF = false;
 
   while (!m_bStop)
@@ -288,13 +375,46 @@ void CFileCache::Process()
         assert(m_writePos == cacheMaxPos);
         average.Reset(m_writePos, bCompleteReset); // Can only recalculate new average from scratch after a full reset (empty cache)
         limiter.Reset(m_writePos);
+        reader.Reset(m_readPos);
         m_nSeekResult = m_seekPos;
       }
 
       m_seekEnded.Set();
     }
 
-    while (m_writeRate)
+    while (g_advancedSettings.m_cacheReadAheadTime > 0.0f)
+    {
+      // keep the given time of media cached, at the rate it is actually read
+      // or the average rate of the media, whichever is higher
+      m_readRate = reader.Rate(m_readPos);
+      const unsigned rate = std::max(m_readRate, m_writeRate);
+      int64_t target = (int64_t)(rate * g_advancedSettings.m_cacheReadAheadTime);
+      if (m_forwardCacheSize > 0)
+        target = std::min(target, m_forwardCacheSize);
+      m_forwardTarget = target;
+
+      // fill at full speed when far below the target, else at a rate that
+      // closes the gap within READAHEAD_CONTROL_TIME
+      const int64_t forward = m_writePos - m_readPos;
+      if (rate == 0 || forward < target / 2)
+      {
+        limiter.Reset(m_writePos);
+        break;
+      }
+
+      if (forward < target &&
+          limiter.Rate(m_writePos) < rate + (target - forward) / READAHEAD_CONTROL_TIME)
+        break;
+
+      if (m_seekEvent.WaitMSec(100))
+      {
+        if (!m_bStop)
+          m_seekEvent.Set();
+        break;
+      }
+    }
+
+    while (m_writeRate && g_advancedSettings.m_cacheReadAheadTime <= 0.0f)
     {
       if (m_writePos - m_readPos < m_writeRate * g_advancedSettings.m_cacheReadFactor)
       {
@@ -411,6 +531,10 @@ void CFileCache::Process()
     // under estimate write rate by a second, to
     // avoid uncertainty at start of caching
     m_writeRateActual = average.Rate(m_writePos, 1000);
+
+    SCacheStatus status;
+    IoControl(IOCTRL_CACHE_STATUS, &status);
+    PublishCacheStatus(status);
   }
 }
 
@@ -541,6 +665,8 @@ void CFileCache::Close()
 {
   StopThread();
 
+  PublishCacheStatus(SCacheStatus());
+
   CSingleLock lock(m_sync);
   if (m_pCache)
     m_pCache->Close();
@@ -580,9 +706,13 @@ int CFileCache::IoControl(EIoControl request, void* param)
   {
     SCacheStatus* status = (SCacheStatus*)param;
     status->forward = m_pCache->WaitForData(0, 0);
-    status->level   = (m_forwardCacheSize == 0) ? 0.0 : (float) status->forward / m_forwardCacheSize;
+    if (m_forwardTarget > 0)
+      status->level = std::min(1.0f, (float) status->forward / m_forwardTarget);
+    else
+      status->level = (m_forwardCacheSize == 0) ? 0.0 : (float) status->forward / m_forwardCacheSize;
     status->maxrate = m_writeRate;
     status->currate = m_writeRateActual;
+    status->readrate = m_readRate;
     return 0;
   }
 
@@ -81,7 +81,9 @@ namespace XFILE
     unsigned m_chunkSize;
     unsigned m_writeRate;
     unsigned m_writeRateActual;
+    unsigned m_readRate;
     int64_t m_forwardCacheSize;
+    int64_t m_forwardTarget; // bytes to keep cached with <cache><readaheadtime>
     std::atomic<int64_t> m_fileSize;
     unsigned int m_flags;
     CCriticalSection m_sync;
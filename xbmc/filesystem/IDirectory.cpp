@@ -23,6 +23,8 @@
 #include "messaging/helpers/DialogOKHelper.h"
 #include "URL.h"
 #include "PasswordManager.h"
+#include "FileItem.h"
+#include "threads/SystemClock.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
 #include "ServiceBroker.h"
@@ -30,10 +32,17 @@
 using namespace KODI::MESSAGING;
 using namespace XFILE;
 
+// items handed out at once by PublishItems, unless they waited for long
+#define PUBLISH_BATCH_SIZE 100
+#define PUBLISH_BATCH_TIME 200
+
 IDirectory::IDirectory() :
   m_profileManager(CServiceBroker::GetProfileManager())
 {
   m_flags = DIR_FLAG_DEFAULTS;
+  m_itemsCallback = nullptr;
+  m_publishedItems = 0;
+  m_publishTime = 0;
 }
 
 IDirectory::~IDirectory(void) = default;
@@ -117,6 +126,32 @@ void IDirectory::SetFlags(int flags)
   m_flags = flags;
 }
 
+void IDirectory::SetItemsCallback(IDirectoryItemsCallback *callback)
+{
+  m_itemsCallback = callback;
+  m_publishedItems = 0;
+  m_publishTime = XbmcThreads::SystemClockMillis();
+}
+
+void IDirectory::PublishItems(const CFileItemList &items, bool force /* = false */)
+{
+  if (!m_itemsCallback || items.Size() <= m_publishedItems)
+    return;
+
+  if (!force && items.Size() - m_publishedItems < PUBLISH_BATCH_SIZE &&
+      XbmcThreads::SystemClockMillis() - m_publishTime < PUBLISH_BATCH_TIME)
+    return;
+
+  // the items are still changed by the implementation and CDirectory
+  CFileItemList batch;
+  for (int i = m_publishedItems; i < items.Size(); i++)
+    batch.Add(CFileItemPtr(new CFileItem(*items[i])));
+
+  m_publishedItems = items.Size();
+  m_publishTime = XbmcThreads::SystemClockMillis();
+  m_itemsCallback->OnDirectoryItems(batch);
+}
+
 bool IDirectory::ProcessRequirements()
 {
   std::string type = m_requirements["type"].asString();
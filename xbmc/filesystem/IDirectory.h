@@ -49,6 +49,23 @@ namespace XFILE
     DIR_FLAG_READ_CACHE    = (2 << 4), ///< Force reading from the directory cache (if available)
     DIR_FLAG_BYPASS_CACHE  = (2 << 5)  ///< Completely bypass the directory cache (no reading, no writing)
   };
+/*!
+ \ingroup filesystem
+ \brief Receives the items of a directory while it is read.
+ \sa IDirectory::SetItemsCallback
+ */
+class IDirectoryItemsCallback
+{
+public:
+  virtual ~IDirectoryItemsCallback() = default;
+  /*!
+   \brief Called from the thread reading the directory with the next items.
+   \param items copies of the items read since the last call, owned by the callback
+   from now on. They are a preview, the complete listing is still returned by GetDirectory.
+   */
+  virtual void OnDirectoryItems(const CFileItemList &items) = 0;
+};
+
 /*!
  \ingroup filesystem
  \brief Interface to the directory on a file system.
@@ -131,6 +148,13 @@ public:
   void SetMask(const std::string& strMask);
   void SetFlags(int flags);
 
+  /*!
+   \brief Set the callback receiving the items while the next GetDirectory reads them.
+   Implementations reading directories slowly hand out their items with PublishItems.
+   \param callback the callback, nullptr to stop
+   */
+  void SetItemsCallback(IDirectoryItemsCallback *callback);
+
   /*! \brief Process additional requirements before the directory fetch is performed.
    Some directory fetches may require authentication, keyboard input etc.  The IDirectory subclass
    should call GetKeyboardInput, SetErrorDialog or RequireAuthentication and then return false 
@@ -171,6 +195,17 @@ protected:
    */
   void RequireAuthentication(const CURL& url);
 
+  /*! \brief Hand the items added since the last call to the items callback.
+   Call this method from the GetDirectory method whenever items were added. Batches are held
+   back until they are large or old enough, so it's cheap to call it for each item.
+   \param items the items read so far, only items appended since the last call are handed out
+   \param force hand out the items regardless of the batch size
+   \sa SetItemsCallback
+   */
+  void PublishItems(const CFileItemList &items, bool force = false);
+
+  IDirectoryItemsCallback *m_itemsCallback; ///< Callback set by SetItemsCallback()
+
   // Construction parameters
   const CProfilesManager &m_profileManager;
 
@@ -179,5 +214,9 @@ protected:
   int m_flags; ///< Directory flags - see DIR_FLAG
 
   CVariant m_requirements;
+
+private:
+  int m_publishedItems;
+  unsigned int m_publishTime;
 };
 }
@@ -63,7 +63,8 @@ struct SCacheStatus
   uint64_t forward;  /**< number of bytes cached forward of current position */
   unsigned maxrate;  /**< maximum number of bytes per second cache is allowed to fill */
   unsigned currate;  /**< average read rate from source file since last position change */
-  float    level;    /**< cache level (0.0 - 1.0) */
+  float    level;    /**< cache level (0.0 - 1.0), relative to the read-ahead target if there is one */
+  unsigned readrate; /**< rate the cache is read at in bytes per second, 0 if unknown */
 };
 
 typedef enum {
@@ -73,6 +74,7 @@ typedef enum {
   IOCTRL_CACHE_SETRATE = 4,  /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE     = 8,  /**< CFileCache */
   IOCTRL_SET_RETRY     = 16, /**< Enable/disable retry within the protocol handler (if supported) */
+  IOCTRL_BYPASS_PAGECACHE = 32, /**< bool, keep data read or written out of the OS page cache (if supported) */
 } EIoControl;
 
 enum CURLOPTIONTYPE
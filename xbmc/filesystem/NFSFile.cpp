@@ -29,12 +29,19 @@
 #include "utils/URIUtils.h"
 #include "network/DNSNameCache.h"
 #include "threads/SystemClock.h"
+#include "settings/AdvancedSettings.h"
 
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
 #include <nfsc/libnfs-raw-mount.h>
 
 #ifdef TARGET_WINDOWS
 #include <fcntl.h>
 #include <sys\stat.h>
+#define poll WSAPoll
+#else
+#include <poll.h>
 #endif
 
 //KEEP_ALIVE_TIMEOUT is decremented every half a second
@@ -46,6 +53,12 @@
 //6 mins (360s) cached context timeout
 #define CONTEXT_TIMEOUT 360000
 
+//idle private read contexts kept per export
+#define READ_CONTEXT_POOL_SIZE 4
+
+//give up on outstanding reads after 30s
+#define READ_TIMEOUT 30000
+
 //return codes for getContextForExport
 #define CONTEXT_INVALID  0    //getcontext failed
 #define CONTEXT_NEW      1    //new context created
@@ -141,6 +154,70 @@ void CNfsConnection::destroyOpenContexts()
     m_pLibNfs->nfs_destroy_context(it->second.pContext);
   }
   m_openContextMap.clear();
+
+  for(tReadContextPool::iterator it = m_readContextPool.begin();it!=m_readContextPool.end();++it)
+  {
+    m_pLibNfs->nfs_destroy_context(it->second.pContext);
+  }
+  m_readContextPool.clear();
+}
+
+struct nfs_context *CNfsConnection::AcquireReadContext()
+{
+  CSingleLock lock(*this);
+  if (!m_pNfsContext)
+    return NULL;
+
+  const std::string contextId = GetContextMapId();
+  uint64_t now = XbmcThreads::SystemClockMillis();
+  {
+    CSingleLock poolLock(openContextLock);
+    std::pair<tReadContextPool::iterator, tReadContextPool::iterator> range = m_readContextPool.equal_range(contextId);
+    for (tReadContextPool::iterator it = range.first; it != range.second;)
+    {
+      struct nfs_context *pContext = it->second.pContext;
+      bool timedOut = (now - it->second.lastAccessedTime) >= CONTEXT_TIMEOUT;
+      it = m_readContextPool.erase(it);
+      if (!timedOut)
+        return pContext;
+      m_pLibNfs->nfs_destroy_context(pContext);
+    }
+  }
+
+  struct nfs_context *pContext = m_pLibNfs->nfs_init_context();
+  if (!pContext)
+    return NULL;
+
+  if (m_pLibNfs->nfs_mount(pContext, m_resolvedHostName.c_str(), m_exportPath.c_str()) != 0)
+  {
+    CLog::Log(LOGERROR,"NFS: Failed to mount read context for %s (%s)", m_exportPath.c_str(), m_pLibNfs->nfs_get_error(pContext));
+    m_pLibNfs->nfs_destroy_context(pContext);
+    return NULL;
+  }
+
+  //the size offered by the server is the upper limit, it can only be lowered
+  uint64_t readSize = static_cast<uint64_t>(g_advancedSettings.m_nfsreadsize) * 1024;
+  if (readSize > 0 && readSize < m_pLibNfs->nfs_get_readmax(pContext) && m_pLibNfs->CanSetReadMax())
+    m_pLibNfs->nfs_set_readmax(pContext, readSize);
+
+  CLog::Log(LOGDEBUG,"NFS: Mounted read context for %s, chunks: r %i", contextId.c_str(), (int)m_pLibNfs->nfs_get_readmax(pContext));
+  return pContext;
+}
+
+void CNfsConnection::ReleaseReadContext(const std::string &contextId, struct nfs_context *pContext, bool reusable)
+{
+  CSingleLock lock(openContextLock);
+  if (reusable && m_readContextPool.count(contextId) < READ_CONTEXT_POOL_SIZE)
+  {
+    struct contextTimeout tmp;
+    tmp.pContext = pContext;
+    tmp.lastAccessedTime = XbmcThreads::SystemClockMillis();
+    m_readContextPool.insert(std::make_pair(contextId, tmp));
+  }
+  else
+  {
+    m_pLibNfs->nfs_destroy_context(pContext);
+  }
 }
 
 void CNfsConnection::destroyContext(const std::string &exportName)
@@ -383,9 +460,9 @@ void CNfsConnection::CheckIfIdle()
       }
       else
       {
-        keepAlive(it->second.exportPath, it->first);
+        keepAlive(it->second.exportPath, it->first, it->second.pContext, it->second.pLock);
         //reset timeout
-        resetKeepAlive(it->second.exportPath, it->first);
+        resetKeepAlive(it->second.exportPath, it->first, it->second.pContext, it->second.pLock);
       }
     }
   }
@@ -399,7 +476,7 @@ void CNfsConnection::removeFromKeepAliveList(struct nfsfh  *_pFileHandle)
 }
 
 //reset timeouts on read
-void CNfsConnection::resetKeepAlive(std::string _exportPath, struct nfsfh  *_pFileHandle)
+void CNfsConnection::resetKeepAlive(std::string _exportPath, struct nfsfh  *_pFileHandle, struct nfs_context *_pContext, CCriticalSection *_pLock)
 {
   CSingleLock lock(keepAliveLock);
   //refresh last access time of the context aswell
@@ -415,26 +492,33 @@ void CNfsConnection::resetKeepAlive(std::string _exportPath, struct nfsfh  *_pFi
   //adds new keys - refreshs existing ones
   m_KeepAliveTimeouts[_pFileHandle].exportPath = _exportPath;
   m_KeepAliveTimeouts[_pFileHandle].refreshCounter = KEEP_ALIVE_TIMEOUT;
+  m_KeepAliveTimeouts[_pFileHandle].pContext = _pContext;
+  m_KeepAliveTimeouts[_pFileHandle].pLock = _pLock;
 }
 
 //keep alive the filehandles nfs connection
 //by blindly doing a read 32bytes - seek back to where
 //we were before
-void CNfsConnection::keepAlive(std::string _exportPath, struct nfsfh  *_pFileHandle)
+void CNfsConnection::keepAlive(std::string _exportPath, struct nfsfh  *_pFileHandle, struct nfs_context *_pContext, CCriticalSection *_pLock)
 {
   uint64_t offset = 0;
   char buffer[32];
-  // this also refreshs the last accessed time for the context
-  // true forces a cachehit regardless the context is timedout
-  // on this call we are sure its not timedout even if the last accessed
-  // time suggests it.
-  struct nfs_context *pContext = getContextFromMap(_exportPath, true);
-  
-  if (!pContext)// this should normally never happen - paranoia
-    pContext = m_pNfsContext;
-  
+  struct nfs_context *pContext = _pContext;
+
+  if (!pContext)
+  {
+    // this also refreshs the last accessed time for the context
+    // true forces a cachehit regardless the context is timedout
+    // on this call we are sure its not timedout even if the last accessed
+    // time suggests it.
+    pContext = getContextFromMap(_exportPath, true);
+
+    if (!pContext)// this should normally never happen - paranoia
+      pContext = m_pNfsContext;
+  }
+
   CLog::Log(LOGNOTICE, "NFS: sending keep alive after %i s.",KEEP_ALIVE_TIMEOUT/2);
-  CSingleLock lock(*this);
+  CSingleLock lock(_pLock ? *_pLock : static_cast<CCriticalSection&>(*this));
   m_pLibNfs->nfs_lseek(pContext, _pFileHandle, 0, SEEK_CUR, &offset);
   m_pLibNfs->nfs_read(pContext, _pFileHandle, 32, buffer);
   m_pLibNfs->nfs_lseek(pContext, _pFileHandle, offset, SEEK_SET, &offset);
@@ -504,6 +588,12 @@ CNFSFile::CNFSFile()
 : m_fileSize(0)
 , m_pFileHandle(NULL)
 , m_pNfsContext(NULL)
+, m_privateContext(false)
+, m_contextBroken(false)
+, m_chunkSize(0)
+, m_readPos(0)
+, m_bufferStart(0)
+, m_bufferLength(0)
 {
   gNfsConnection.AddActiveConnection();
 }
@@ -516,19 +606,28 @@ CNFSFile::~CNFSFile()
 
 int64_t CNFSFile::GetPosition()
 {
-  int ret = 0;
-  uint64_t offset = 0;
-  CSingleLock lock(gNfsConnection);
-  
-  if (gNfsConnection.GetNfsContext() == NULL || m_pFileHandle == NULL) return 0;
-  
-  ret = (int)gNfsConnection.GetImpl()->nfs_lseek(gNfsConnection.GetNfsContext(), m_pFileHandle, 0, SEEK_CUR, &offset);
-  
-  if (ret < 0) 
-  {
-    CLog::Log(LOGERROR, "NFS: Failed to lseek(%s)",gNfsConnection.GetImpl()->nfs_get_error(gNfsConnection.GetNfsContext()));
-  }
-  return offset;
+  CSingleLock lock(GetLock());
+
+  if (m_pNfsContext == NULL || m_pFileHandle == NULL) return 0;
+
+  //reads are positioned, the position of the filehandle isn't moved by them
+  return m_readPos;
+}
+
+int CNFSFile::GetChunkSize()
+{
+  uint64_t chunkSize = m_chunkSize ? m_chunkSize : gNfsConnection.GetMaxReadChunkSize();
+  //a pipelined read returns the data of all outstanding requests
+  if (m_privateContext)
+    chunkSize *= std::max(1, g_advancedSettings.m_nfsreaddepth);
+  return static_cast<int>(chunkSize);
+}
+
+CCriticalSection &CNFSFile::GetLock()
+{
+  if (m_privateContext)
+    return m_readLock;
+  return gNfsConnection;
 }
 
 int64_t CNFSFile::GetLength()
@@ -556,18 +655,33 @@ bool CNFSFile::Open(const CURL& url)
   if(!gNfsConnection.Connect(url, filename))
     return false;
   
-  m_pNfsContext = gNfsConnection.GetNfsContext(); 
   m_exportPath = gNfsConnection.GetContextMapId();
+
+  //reading on a context of our own doesn't wait for directory listings
+  //and other files on the shared context
+  m_pNfsContext = gNfsConnection.AcquireReadContext();
+  m_privateContext = m_pNfsContext != NULL;
+  if (m_privateContext)
+    lock.Leave();
+  else
+    m_pNfsContext = gNfsConnection.GetNfsContext();
   
   ret = gNfsConnection.GetImpl()->nfs_open(m_pNfsContext, filename.c_str(), O_RDONLY, &m_pFileHandle);
   
   if (ret != 0) 
   {
     CLog::Log(LOGINFO, "CNFSFile::Open: Unable to open file : '%s'  error : '%s'", url.GetFileName().c_str(), gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
+    if (m_privateContext)
+      gNfsConnection.ReleaseReadContext(m_exportPath, m_pNfsContext, true);
+    m_privateContext = false;
     m_pNfsContext = NULL;
+    m_pFileHandle = NULL;
     m_exportPath.clear();
     return false;
   } 
+
+  m_chunkSize = gNfsConnection.GetImpl()->nfs_get_readmax(m_pNfsContext);
+  m_readPos = 0;
   
   CLog::Log(LOGDEBUG,"CNFSFile::Open - opened %s",url.GetFileName().c_str());
   m_url=url;
@@ -649,16 +763,33 @@ ssize_t CNFSFile::Read(void *lpBuf, size_t uiBufSize)
     uiBufSize = SSIZE_MAX;
 
   ssize_t numberOfBytesRead = 0;
-  CSingleLock lock(gNfsConnection);
+  CSingleLock lock(GetLock());
   
-  if (m_pFileHandle == NULL || m_pNfsContext == NULL )
+  if (m_pFileHandle == NULL || m_pNfsContext == NULL || m_contextBroken)
     return -1;
 
-  numberOfBytesRead = gNfsConnection.GetImpl()->nfs_read(m_pNfsContext, m_pFileHandle, uiBufSize, (char *)lpBuf);  
+  if (!m_privateContext || g_advancedSettings.m_nfsreaddepth <= 1)
+  {
+    numberOfBytesRead = gNfsConnection.GetImpl()->nfs_pread(m_pNfsContext, m_pFileHandle, m_readPos, uiBufSize, (char *)lpBuf);
+  }
+  else if ((m_readPos >= m_bufferStart && m_readPos < m_bufferStart + (int64_t)m_bufferLength) || FillBuffer())
+  {
+    numberOfBytesRead = (ssize_t)std::min<uint64_t>(uiBufSize, m_bufferStart + m_bufferLength - m_readPos);
+    memcpy(lpBuf, m_buffer.data() + (m_readPos - m_bufferStart), numberOfBytesRead);
+  }
+  else
+  {
+    numberOfBytesRead = -1;
+  }
+
+  if (numberOfBytesRead > 0)
+    m_readPos += numberOfBytesRead;
 
+  struct nfs_context *pContext = m_privateContext ? m_pNfsContext : NULL;
+  CCriticalSection *pLock = m_privateContext ? &m_readLock : NULL;
   lock.Leave();//no need to keep the connection lock after that
   
-  gNfsConnection.resetKeepAlive(m_exportPath, m_pFileHandle);//triggers keep alive timer reset for this filehandle
+  gNfsConnection.resetKeepAlive(m_exportPath, m_pFileHandle, pContext, pLock);//triggers keep alive timer reset for this filehandle
   
   //something went wrong ...
   if (numberOfBytesRead < 0) 
@@ -672,9 +803,15 @@ int64_t CNFSFile::Seek(int64_t iFilePosition, int iWhence)
   int ret = 0;
   uint64_t offset = 0;
 
-  CSingleLock lock(gNfsConnection);  
-  if (m_pFileHandle == NULL || m_pNfsContext == NULL) return -1;
+  CSingleLock lock(GetLock());
+  if (m_pFileHandle == NULL || m_pNfsContext == NULL || m_contextBroken) return -1;
   
+  //the filehandle doesn't follow the positioned reads
+  if (iWhence == SEEK_CUR)
+  {
+    iFilePosition += m_readPos;
+    iWhence = SEEK_SET;
+  }
  
   ret = (int)gNfsConnection.GetImpl()->nfs_lseek(m_pNfsContext, m_pFileHandle, iFilePosition, iWhence, &offset);
   if (ret < 0) 
@@ -682,15 +819,98 @@ int64_t CNFSFile::Seek(int64_t iFilePosition, int iWhence)
     CLog::Log(LOGERROR, "%s - Error( seekpos: %" PRId64", whence: %i, fsize: %" PRId64", %s)", __FUNCTION__, iFilePosition, iWhence, m_fileSize, gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
     return -1;
   }
-  return (int64_t)offset;
+  //data of the pipeline stays valid, seeking within it needs no new requests
+  m_readPos = (int64_t)offset;
+  return m_readPos;
+}
+
+void CNFSFile::ReadCallback(int err, struct nfs_context *nfs, void *data, void *private_data)
+{
+  ReadRequest *request = static_cast<ReadRequest *>(private_data);
+  request->result = err;
+  if (err > 0)
+    memcpy(request->buffer, data, std::min<uint64_t>(err, request->size));
+  request->done = true;
+}
+
+//issue consecutive reads from m_readPos on and wait for all of them, so the
+//server is busy with the next request while the one before is transferred
+bool CNFSFile::FillBuffer()
+{
+  DllLibNfs *pLibNfs = gNfsConnection.GetImpl();
+  size_t depth = g_advancedSettings.m_nfsreaddepth;
+
+  m_bufferStart = m_readPos;
+  m_bufferLength = 0;
+  m_buffer.resize(m_chunkSize * depth);
+  m_requests.assign(depth, ReadRequest());
+
+  size_t issued = 0;
+  for (; issued < depth; issued++)
+  {
+    ReadRequest &request = m_requests[issued];
+    request.buffer = m_buffer.data() + issued * m_chunkSize;
+    request.size = m_chunkSize;
+    request.result = 0;
+    request.done = false;
+    if (pLibNfs->nfs_pread_async(m_pNfsContext, m_pFileHandle, m_readPos + issued * m_chunkSize, m_chunkSize, ReadCallback, &request) != 0)
+      break;
+  }
+
+  if (issued == 0)
+  {
+    CLog::Log(LOGERROR, "%s - Error( %s )", __FUNCTION__, pLibNfs->nfs_get_error(m_pNfsContext));
+    return false;
+  }
+
+  uint64_t start = XbmcThreads::SystemClockMillis();
+  size_t done = 0;
+  while (done < issued)
+  {
+    struct pollfd pfd;
+    pfd.fd = pLibNfs->nfs_get_fd(m_pNfsContext);
+    pfd.events = pLibNfs->nfs_which_events(m_pNfsContext);
+    pfd.revents = 0;
+
+    if ((poll(&pfd, 1, 100) < 0 && errno != EINTR) ||
+        pLibNfs->nfs_service(m_pNfsContext, pfd.revents) < 0 ||
+        XbmcThreads::SystemClockMillis() - start > READ_TIMEOUT)
+    {
+      CLog::Log(LOGERROR, "%s - Error( %s )", __FUNCTION__, pLibNfs->nfs_get_error(m_pNfsContext));
+      //the callbacks of the outstanding requests may still come
+      m_contextBroken = true;
+      return false;
+    }
+
+    done = std::count_if(m_requests.begin(), m_requests.begin() + issued, [](const ReadRequest &request) { return request.done; });
+  }
+
+  //use the data up to the first short or failed read
+  for (size_t i = 0; i < issued; i++)
+  {
+    const ReadRequest &request = m_requests[i];
+    if (request.result < 0)
+    {
+      if (i == 0)
+      {
+        CLog::Log(LOGERROR, "%s - Error( %d, %s )", __FUNCTION__, request.result, pLibNfs->nfs_get_error(m_pNfsContext));
+        return false;
+      }
+      break;
+    }
+    m_bufferLength += request.result;
+    if ((uint64_t)request.result < request.size)
+      break;
+  }
+  return true;
 }
 
 int CNFSFile::Truncate(int64_t iSize)
 {
   int ret = 0;
   
-  CSingleLock lock(gNfsConnection);  
-  if (m_pFileHandle == NULL || m_pNfsContext == NULL) return -1;
+  CSingleLock lock(GetLock());
+  if (m_pFileHandle == NULL || m_pNfsContext == NULL || m_contextBroken) return -1;
   
   
   ret = (int)gNfsConnection.GetImpl()->nfs_ftruncate(m_pNfsContext, m_pFileHandle, iSize);
@@ -704,25 +924,38 @@ int CNFSFile::Truncate(int64_t iSize)
 
 void CNFSFile::Close()
 {
-  CSingleLock lock(gNfsConnection);
+  // remove it from keep alive list before closing
+  // so keep alive code doesn't process it anymore
+  // keep alive takes the locks in the opposite order
+  if (m_pFileHandle != NULL)
+    gNfsConnection.removeFromKeepAliveList(m_pFileHandle);
+
+  CSingleLock lock(GetLock());
   
   if (m_pFileHandle != NULL && m_pNfsContext != NULL)
   {
     int ret = 0;
     CLog::Log(LOGDEBUG,"CNFSFile::Close closing file %s", m_url.GetFileName().c_str());
-    // remove it from keep alive list before closing
-    // so keep alive code doesn't process it anymore
-    gNfsConnection.removeFromKeepAliveList(m_pFileHandle);
-    ret = gNfsConnection.GetImpl()->nfs_close(m_pNfsContext, m_pFileHandle);
+    if (!m_contextBroken)
+      ret = gNfsConnection.GetImpl()->nfs_close(m_pNfsContext, m_pFileHandle);
         
 	  if (ret < 0) 
     {
       CLog::Log(LOGERROR, "Failed to close(%s) - %s\n", m_url.GetFileName().c_str(), gNfsConnection.GetImpl()->nfs_get_error(m_pNfsContext));
     }
+    if (m_privateContext)
+      gNfsConnection.ReleaseReadContext(m_exportPath, m_pNfsContext, !m_contextBroken);
     m_pFileHandle = NULL;
     m_pNfsContext = NULL;    
     m_fileSize = 0;
     m_exportPath.clear();
+    m_privateContext = false;
+    m_contextBroken = false;
+    m_chunkSize = 0;
+    m_readPos = 0;
+    m_bufferStart = 0;
+    m_bufferLength = 0;
+    m_buffer.clear();
   }
 }
 
@@ -769,6 +1002,7 @@ ssize_t CNFSFile::Write(const void* lpBuf, size_t uiBufSize)
       break;
     }     
   }
+  m_readPos += numberOfBytesWritten;
   //return total number of written bytes
   return numberOfBytesWritten;
 }
@@ -27,6 +27,7 @@
 #include "threads/CriticalSection.h"
 #include <list>
 #include <map>
+#include <vector>
 #include "DllLibNfs.h" // for define NFSSTAT
 
 #ifdef TARGET_WINDOWS
@@ -54,6 +55,8 @@ public:
   {
     std::string exportPath;
     uint64_t refreshCounter;
+    struct nfs_context *pContext;//context the filehandle belongs to - NULL for m_pNfsContext
+    CCriticalSection *pLock;//lock guarding pContext - NULL for this connection
   };
   typedef std::map<struct nfsfh  *, struct keepAliveStruct> tFileKeepAliveMap;  
 
@@ -64,6 +67,7 @@ public:
   };
 
   typedef std::map<std::string, struct contextTimeout> tOpenContextMap;    
+  typedef std::multimap<std::string, struct contextTimeout> tReadContextPool;
   
   CNfsConnection();
   ~CNfsConnection();
@@ -73,6 +77,11 @@ public:
   uint64_t GetMaxWriteChunkSize() {return m_writeChunkSize;} 
   DllLibNfs *GetImpl() {return m_pLibNfs;}
   std::list<std::string> GetExportList(const CURL &url);
+  //returns a mounted context for the currently connected export which is used
+  //by a single file only, so its reads don't wait for the shared context - NULL on failure
+  struct nfs_context *AcquireReadContext();
+  //hands a context from AcquireReadContext back to the pool of its export
+  void ReleaseReadContext(const std::string &contextId, struct nfs_context *pContext, bool reusable);
   //this functions splits the url into the exportpath (feed to mount) and the rest of the path
   //relative to the mounted export
   bool splitUrlIntoExportAndPath(const CURL& url, std::string &exportPath, std::string &relativePath, std::list<std::string> &exportList);
@@ -89,7 +98,7 @@ public:
   bool HandleDyLoad();//loads the lib if needed
   //adds the filehandle to the keep alive list or resets
   //the timeout for this filehandle if already in list
-  void resetKeepAlive(std::string _exportPath, struct nfsfh  *_pFileHandle);
+  void resetKeepAlive(std::string _exportPath, struct nfsfh  *_pFileHandle, struct nfs_context *_pContext = NULL, CCriticalSection *_pLock = NULL);
   //removes file handle from keep alive list
   void removeFromKeepAliveList(struct nfsfh  *_pFileHandle);  
   
@@ -108,6 +117,7 @@ private:
   unsigned int m_IdleTimeout;//timeout for idle connection close and dyunload
   tFileKeepAliveMap m_KeepAliveTimeouts;//mapping filehandles to its idle timeout
   tOpenContextMap m_openContextMap;//unique map for tracking all open contexts
+  tReadContextPool m_readContextPool;//idle private read contexts per export
   uint64_t m_lastAccessedTime;//last access time for m_pNfsContext
   DllLibNfs *m_pLibNfs;//the lib
   std::list<std::string> m_exportList;//list of exported paths of current connected servers
@@ -120,7 +130,7 @@ private:
   void destroyOpenContexts();
   void destroyContext(const std::string &exportName);
   void resolveHost(const CURL &url);//resolve hostname by dnslookup
-  void keepAlive(std::string _exportPath, struct nfsfh  *_pFileHandle);
+  void keepAlive(std::string _exportPath, struct nfsfh  *_pFileHandle, struct nfs_context *_pContext, CCriticalSection *_pLock);
 };
 
 extern CNfsConnection gNfsConnection;
@@ -147,7 +157,7 @@ namespace XFILE
     //implement iocontrol for seek_possible for preventing the stat in File class for
     //getting this info ...
     int IoControl(EIoControl request, void* param) override{ return request == IOCTRL_SEEK_POSSIBLE ? 1 : -1; };    
-    int GetChunkSize() override {return static_cast<int>(gNfsConnection.GetMaxReadChunkSize());}
+    int GetChunkSize() override;
     
     bool OpenForWrite(const CURL& url, bool bOverWrite = false) override;
     bool Delete(const CURL& url) override;
@@ -159,6 +169,29 @@ namespace XFILE
     struct nfsfh *m_pFileHandle;
     struct nfs_context *m_pNfsContext;//current nfs context
     std::string m_exportPath;
+
+  private:
+    struct ReadRequest
+    {
+      char *buffer;
+      uint64_t size;
+      int result;
+      bool done;
+    };
+
+    static void ReadCallback(int err, struct nfs_context *nfs, void *data, void *private_data);
+    CCriticalSection &GetLock();
+    bool FillBuffer();
+
+    bool m_privateContext;//m_pNfsContext is ours only and guarded by m_readLock
+    bool m_contextBroken;//requests are still outstanding, the context can't be used anymore
+    CCriticalSection m_readLock;
+    uint64_t m_chunkSize;//read size of m_pNfsContext
+    int64_t m_readPos;
+    std::vector<char> m_buffer;//data of the last pipelined reads
+    int64_t m_bufferStart;
+    size_t m_bufferLength;
+    std::vector<ReadRequest> m_requests;
   };
 }
 #endif // FILENFS_H_
@@ -0,0 +1,498 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PersistentFileCache.h"
+
+#include <algorithm>
+#include <set>
+#include <string.h>
+#include <time.h>
+
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "IFile.h"
+#include "SpecialProtocol.h"
+#include "URL.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#if defined(TARGET_POSIX)
+#include "platform/posix/filesystem/PosixFile.h"
+#define CacheLocalFile CPosixFile
+#elif defined(TARGET_WINDOWS)
+#include "platform/win32/filesystem/Win32File.h"
+#define CacheLocalFile CWin32File
+#endif // TARGET_WINDOWS
+
+using namespace XFILE;
+
+namespace
+{
+const char* PERSISTENTCACHE_PATH = "special://temp/persistentcache/";
+const uint32_t PERSISTENTCACHE_VERSION = 1;
+const int64_t CHUNK_SIZE = 1024 * 1024;
+const int64_t MAX_SEEK_AHEAD = 500000; // same as CSimpleFileCache
+const uint32_t MAX_URL_LENGTH = 16384;
+
+struct IndexHeader
+{
+  char magic[4];
+  uint32_t version;
+  uint32_t chunkSize;
+  uint32_t urlLength;
+  int64_t fileSize;
+  int64_t lastUsed;
+  int64_t cachedBytes;
+};
+
+// copies of a file opened twice would overwrite each other's index
+CCriticalSection s_inUseSection;
+std::set<std::string> s_inUse;
+
+bool ReadHeader(CFile& file, IndexHeader& header)
+{
+  return file.Read(&header, sizeof(header)) == sizeof(header) &&
+         memcmp(header.magic, "KPFC", 4) == 0 &&
+         header.version == PERSISTENTCACHE_VERSION &&
+         header.chunkSize == CHUNK_SIZE &&
+         header.urlLength <= MAX_URL_LENGTH &&
+         header.fileSize > 0;
+}
+
+void DeleteCopy(const std::string& indexFile)
+{
+  CFile::Delete(indexFile);
+  CFile::Delete(URIUtils::ReplaceExtension(indexFile, ".data"));
+}
+}
+
+CPersistentFileCache::CPersistentFileCache(const std::string& url, int64_t fileSize, size_t forwardSize)
+  : m_url(url),
+    m_fileSize(fileSize),
+    m_forwardSize(forwardSize),
+    m_dataRead(new CacheLocalFile()),
+    m_dataWrite(new CacheLocalFile())
+{
+}
+
+CPersistentFileCache::~CPersistentFileCache()
+{
+  Close();
+}
+
+bool CPersistentFileCache::CanCache(int64_t fileSize)
+{
+  return fileSize > 0 && fileSize <= static_cast<int64_t>(g_advancedSettings.m_cachePersistentSize) * 1024 * 1024;
+}
+
+int CPersistentFileCache::Open()
+{
+  Close();
+
+  if (!CanCache(m_fileSize))
+    return CACHE_RC_ERROR;
+
+  const std::string name = StringUtils::Format("%08x", Crc32::Compute(m_url));
+  {
+    CSingleLock lock(s_inUseSection);
+    if (!s_inUse.insert(name).second)
+    {
+      CLog::Log(LOGDEBUG, "CPersistentFileCache::Open - copy %s is in use", name.c_str());
+      return CACHE_RC_ERROR;
+    }
+  }
+
+  m_indexFile = PERSISTENTCACHE_PATH + name + ".index";
+  m_dataFile = CSpecialProtocol::TranslatePath(PERSISTENTCACHE_PATH + name + ".data");
+
+  if (!CDirectory::Exists(PERSISTENTCACHE_PATH) && !CDirectory::Create(PERSISTENTCACHE_PATH))
+  {
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  m_chunks.assign(static_cast<size_t>((m_fileSize + CHUNK_SIZE - 1) / CHUNK_SIZE + 7) / 8, 0);
+  bool loaded = LoadIndex();
+  MakeRoom();
+
+  // without its index nothing in an old copy can be trusted
+  CURL dataURL(m_dataFile);
+  if (!m_dataWrite->OpenForWrite(dataURL, !loaded) || !m_dataRead->Open(dataURL))
+  {
+    CLog::LogF(LOGERROR, "failed to open file \"%s\"", m_dataFile.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  m_sessionStart = 0;
+  m_writePos = 0;
+  m_readPos = 0;
+  return CACHE_RC_OK;
+}
+
+void CPersistentFileCache::Close()
+{
+  if (m_indexFile.empty())
+    return;
+
+  m_dataWrite->Close();
+  m_dataRead->Close();
+  if (!m_dataFile.empty())
+    StoreIndex();
+
+  CSingleLock lock(s_inUseSection);
+  s_inUse.erase(URIUtils::GetFileName(URIUtils::ReplaceExtension(m_indexFile, "")));
+  m_indexFile.clear();
+  m_dataFile.clear();
+}
+
+bool CPersistentFileCache::LoadIndex()
+{
+  CFile file;
+  if (!file.Open(m_indexFile))
+    return false;
+
+  IndexHeader header;
+  if (!ReadHeader(file, header) || header.fileSize != m_fileSize)
+    return false;
+
+  std::string url(header.urlLength, '\0');
+  if (file.Read(&url[0], url.size()) != static_cast<ssize_t>(url.size()) || url != m_url)
+    return false;
+
+  std::vector<uint8_t> chunks(m_chunks.size());
+  if (file.Read(chunks.data(), chunks.size()) != static_cast<ssize_t>(chunks.size()))
+    return false;
+
+  m_chunks.swap(chunks);
+  CLog::Log(LOGDEBUG, "CPersistentFileCache::LoadIndex - %" PRId64" bytes of %s cached", header.cachedBytes,
+            CURL::GetRedacted(m_url).c_str());
+  return true;
+}
+
+void CPersistentFileCache::StoreIndex()
+{
+  IndexHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "KPFC", 4);
+  header.version = PERSISTENTCACHE_VERSION;
+  header.chunkSize = CHUNK_SIZE;
+  header.urlLength = static_cast<uint32_t>(std::min<size_t>(m_url.size(), MAX_URL_LENGTH));
+  header.fileSize = m_fileSize;
+  header.lastUsed = time(nullptr);
+  for (size_t i = 0; i < m_chunks.size(); i++)
+  {
+    for (uint8_t bits = m_chunks[i]; bits; bits &= bits - 1)
+      header.cachedBytes += CHUNK_SIZE;
+  }
+
+  if (header.cachedBytes == 0 || header.urlLength != m_url.size())
+  {
+    DeleteCopy(m_indexFile);
+    return;
+  }
+
+  CFile file;
+  if (!file.OpenForWrite(m_indexFile, true) ||
+      file.Write(&header, sizeof(header)) != sizeof(header) ||
+      file.Write(m_url.c_str(), m_url.size()) != static_cast<ssize_t>(m_url.size()) ||
+      file.Write(m_chunks.data(), m_chunks.size()) != static_cast<ssize_t>(m_chunks.size()))
+  {
+    CLog::Log(LOGWARNING, "CPersistentFileCache::StoreIndex - unable to write %s", m_indexFile.c_str());
+    file.Close();
+    DeleteCopy(m_indexFile);
+  }
+}
+
+void CPersistentFileCache::MakeRoom() const
+{
+  struct Copy
+  {
+    std::string indexFile;
+    int64_t lastUsed;
+    int64_t size;
+  };
+
+  CFileItemList items;
+  CDirectory::GetDirectory(PERSISTENTCACHE_PATH, items, ".index", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+
+  const std::string own = URIUtils::GetFileName(m_indexFile);
+  std::vector<Copy> copies;
+  int64_t used = 0;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    const std::string path = items[i]->GetPath();
+    const std::string fileName = URIUtils::GetFileName(path);
+    if (fileName == own)
+      continue;
+    {
+      CSingleLock lock(s_inUseSection);
+      if (s_inUse.find(URIUtils::ReplaceExtension(fileName, "")) != s_inUse.end())
+        continue;
+    }
+
+    CFile file;
+    IndexHeader header;
+    if (!file.Open(path) || !ReadHeader(file, header))
+    {
+      file.Close();
+      DeleteCopy(path);
+      continue;
+    }
+    copies.push_back({ path, header.lastUsed, header.cachedBytes });
+    used += header.cachedBytes;
+  }
+
+  // this copy may grow up to the size of its file
+  const int64_t limit = static_cast<int64_t>(g_advancedSettings.m_cachePersistentSize) * 1024 * 1024 - m_fileSize;
+  std::sort(copies.begin(), copies.end(), [](const Copy& a, const Copy& b) { return a.lastUsed < b.lastUsed; });
+  for (const Copy& copy : copies)
+  {
+    if (used <= limit)
+      break;
+    CLog::Log(LOGDEBUG, "CPersistentFileCache::MakeRoom - removing %s", copy.indexFile.c_str());
+    DeleteCopy(copy.indexFile);
+    used -= copy.size;
+  }
+}
+
+bool CPersistentFileCache::IsChunkValid(int64_t chunk) const
+{
+  return chunk >= 0 && static_cast<size_t>(chunk / 8) < m_chunks.size() &&
+         (m_chunks[static_cast<size_t>(chunk / 8)] & (1 << (chunk % 8))) != 0;
+}
+
+int64_t CPersistentFileCache::GetCachedEnd(int64_t iFilePosition) const
+{
+  int64_t end = iFilePosition;
+  while (end < m_fileSize)
+  {
+    if (end >= m_sessionStart && end < m_writePos)
+    {
+      end = m_writePos;
+      continue;
+    }
+
+    int64_t chunk = end / CHUNK_SIZE;
+    if (!IsChunkValid(chunk))
+      break;
+    end = std::min((chunk + 1) * CHUNK_SIZE, m_fileSize);
+  }
+  return end;
+}
+
+int64_t CPersistentFileCache::GetAvailableRead() const
+{
+  CSingleLock lock(m_sync);
+  return GetCachedEnd(m_readPos) - m_readPos;
+}
+
+size_t CPersistentFileCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  if (m_forwardSize == 0)
+    return iRequestSize;
+
+  CSingleLock lock(m_sync);
+  int64_t ahead = m_writePos - m_readPos;
+  if (ahead >= static_cast<int64_t>(m_forwardSize))
+    return 0;
+  if (ahead <= 0)
+    return iRequestSize;
+  return std::min(iRequestSize, m_forwardSize - static_cast<size_t>(ahead));
+}
+
+int CPersistentFileCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  int64_t writePos;
+  {
+    CSingleLock lock(m_sync);
+    writePos = m_writePos;
+  }
+
+  if (m_dataWrite->Seek(writePos, SEEK_SET) != writePos)
+  {
+    CLog::LogF(LOGERROR, "can't seek file");
+    return CACHE_RC_ERROR;
+  }
+
+  size_t written = 0;
+  while (iSize > 0)
+  {
+    const ssize_t lastWritten = m_dataWrite->Write(pBuffer + written, (iSize > SSIZE_MAX) ? SSIZE_MAX : iSize);
+    if (lastWritten <= 0)
+    {
+      CLog::LogF(LOGERROR, "failed to write to file");
+      return CACHE_RC_ERROR;
+    }
+    iSize -= lastWritten;
+    written += lastWritten;
+  }
+
+  {
+    CSingleLock lock(m_sync);
+    m_writePos += written;
+
+    // a chunk is valid once written from its start within one session
+    for (int64_t chunk = writePos / CHUNK_SIZE; chunk * CHUNK_SIZE < m_writePos; chunk++)
+    {
+      if (chunk * CHUNK_SIZE < m_sessionStart ||
+          std::min((chunk + 1) * CHUNK_SIZE, m_fileSize) > m_writePos ||
+          static_cast<size_t>(chunk / 8) >= m_chunks.size())
+        continue;
+      m_chunks[static_cast<size_t>(chunk / 8)] |= 1 << (chunk % 8);
+    }
+  }
+
+  m_dataAvailable.Set();
+  return written;
+}
+
+int CPersistentFileCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  int64_t readPos;
+  int64_t iAvailable;
+  {
+    CSingleLock lock(m_sync);
+    readPos = m_readPos;
+    iAvailable = GetCachedEnd(readPos) - readPos;
+  }
+
+  if (iAvailable <= 0)
+    return (m_bEndOfInput || readPos >= m_fileSize) ? 0 : CACHE_RC_WOULD_BLOCK;
+
+  if (m_dataRead->Seek(readPos, SEEK_SET) != readPos)
+  {
+    CLog::LogF(LOGERROR, "can't seek file");
+    return CACHE_RC_ERROR;
+  }
+
+  size_t toRead = ((int64_t)iMaxSize > iAvailable) ? (size_t)iAvailable : iMaxSize;
+  size_t readBytes = 0;
+  while (toRead > 0)
+  {
+    const ssize_t lastRead = m_dataRead->Read(pBuffer + readBytes, (toRead > SSIZE_MAX) ? SSIZE_MAX : toRead);
+    if (lastRead == 0)
+      break;
+    if (lastRead < 0)
+    {
+      CLog::LogF(LOGERROR, "failed to read from file");
+      return CACHE_RC_ERROR;
+    }
+    toRead -= lastRead;
+    readBytes += lastRead;
+  }
+
+  if (readBytes > 0)
+  {
+    CSingleLock lock(m_sync);
+    m_readPos += readBytes;
+    m_space.Set();
+  }
+
+  return readBytes;
+}
+
+int64_t CPersistentFileCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  if (iMillis == 0 || IsEndOfInput())
+    return GetAvailableRead();
+
+  XbmcThreads::EndTime endTime(iMillis);
+  while (!IsEndOfInput())
+  {
+    int64_t iAvail = GetAvailableRead();
+    if (iAvail >= iMinAvail || m_readPos + iAvail >= m_fileSize)
+      return iAvail;
+
+    if (!m_dataAvailable.WaitMSec(endTime.MillisLeft()))
+      return CACHE_RC_TIMEOUT;
+  }
+  return GetAvailableRead();
+}
+
+int64_t CPersistentFileCache::Seek(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  // the reader must not run into data the source won't deliver from where it is
+  int64_t end = GetCachedEnd(iFilePosition);
+  if (iFilePosition <= m_writePos ? end < m_writePos : end - m_writePos > MAX_SEEK_AHEAD)
+  {
+    CLog::Log(LOGDEBUG, "CPersistentFileCache::Seek - %" PRId64" needs the source to seek", iFilePosition);
+    return CACHE_RC_ERROR;
+  }
+
+  m_readPos = iFilePosition;
+  m_space.Set();
+  return iFilePosition;
+}
+
+bool CPersistentFileCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  // valid data is never discarded, clearAnyway doesn't apply
+  CSingleLock lock(m_sync);
+  int64_t end = CachedDataEndPosIfSeekTo(iSourcePosition);
+
+  // a continued session keeps completing the chunk it is in
+  if (end < m_sessionStart || GetCachedEnd(m_sessionStart) < end)
+    m_sessionStart = end;
+  m_writePos = end;
+  m_readPos = iSourcePosition;
+  return end <= iSourcePosition;
+}
+
+void CPersistentFileCache::EndOfInput()
+{
+  CCacheStrategy::EndOfInput();
+  m_dataAvailable.Set();
+}
+
+int64_t CPersistentFileCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  int64_t end = GetCachedEnd(iFilePosition);
+  if (end > iFilePosition || iFilePosition >= m_fileSize)
+    return end;
+
+  // start where the valid data of the chunk ends, a chunk written in part is lost
+  return GetCachedEnd(iFilePosition - iFilePosition % CHUNK_SIZE);
+}
+
+int64_t CPersistentFileCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  return m_writePos;
+}
+
+bool CPersistentFileCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return iFilePosition == m_writePos || GetCachedEnd(iFilePosition) > iFilePosition;
+}
+
+CCacheStrategy *CPersistentFileCache::CreateNew()
+{
+  return new CPersistentFileCache(m_url, m_fileSize, m_forwardSize);
+}
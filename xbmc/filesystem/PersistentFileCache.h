@@ -0,0 +1,107 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+namespace XFILE {
+
+/*!
+ \brief Cache strategy keeping the data of a remote file in a local, sparse
+ copy below special://temp/persistentcache/ that outlives the cache.
+
+ The copy is kept in chunks of a fixed size, a chunk is known to be valid once
+ it was written completely. Seeking back, resuming or playing the file again
+ reads valid chunks from disk and the source is only read where chunks are
+ missing. The copies of all files together are capped, the least recently
+ used ones are removed to make room for a new one.
+ */
+class CPersistentFileCache : public CCacheStrategy
+{
+public:
+  /*!
+   \param url the url of the source, identifies the copy
+   \param fileSize size of the source, a copy of another size is discarded
+   \param forwardSize maximum amount of data to read ahead, 0 for no limit
+   */
+  CPersistentFileCache(const std::string& url, int64_t fileSize, size_t forwardSize);
+  ~CPersistentFileCache() override;
+
+  /*!
+   \brief Whether the copies may grow up to fileSize bytes, see m_cachePersistentSize.
+   */
+  static bool CanCache(int64_t fileSize);
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *pBuffer, size_t iSize) override;
+  int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
+  int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t iFilePosition) override;
+  bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
+  void EndOfInput() override;
+
+  /*!
+   \brief End of the valid data from the given position on. If there is none,
+   the start of the chunk is returned so the source fills whole chunks.
+   */
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy *CreateNew() override;
+
+private:
+  int64_t GetCachedEnd(int64_t iFilePosition) const;
+  bool IsChunkValid(int64_t chunk) const;
+  int64_t GetAvailableRead() const;
+
+  bool LoadIndex();
+  void StoreIndex();
+  void MakeRoom() const;
+
+  std::string m_url;
+  std::string m_dataFile;
+  std::string m_indexFile;
+  int64_t m_fileSize;
+  size_t m_forwardSize;
+
+  std::unique_ptr<IFile> m_dataRead;
+  std::unique_ptr<IFile> m_dataWrite;
+  CEvent m_dataAvailable;
+
+  mutable CCriticalSection m_sync;
+  std::vector<uint8_t> m_chunks; //!< one bit per chunk written completely
+  int64_t m_sessionStart = 0; //!< data from here to m_writePos was written since the last reset
+  int64_t m_writePos = 0;
+  int64_t m_readPos = 0;
+};
+
+} // namespace XFILE
@@ -22,24 +22,26 @@
 #include "threads/SingleLock.h"
 #include "utils/StringUtils.h"
 
-#ifndef min
-#define min(a,b) ((a) < (b) ? (a) : (b))
-#endif
+#include <algorithm>
+#include <string.h>
 
 using namespace XFILE;
 
 
 Pipe::Pipe(const std::string &name, int nMaxSize)
+  : m_bOpen(true),
+    m_bReadyForRead(true), // open threshold disabled atm
+    m_bEof(false),
+    m_buffer(new char[nMaxSize]),
+    m_bufferSize(nMaxSize),
+    m_readPos(0),
+    m_writePos(0)
 {
-  m_buffer.Create(nMaxSize);
   m_nRefCount = 1;
   m_readEvent.Reset();
   m_writeEvent.Set();
   m_strPipeName = name;
-  m_bOpen = true;
-  m_bEof = false;
   m_nOpenThreshold = PIPE_DEFAULT_MAX_SIZE / 2;
-  m_bReadyForRead = true; // open threshold disabled atm
 }
 
 Pipe::~Pipe() = default;
@@ -75,6 +77,7 @@ int  Pipe::RefCount()
 void Pipe::SetEof()
 {
   m_bEof = true;
+  CheckStatus();
 }
 
 bool Pipe::IsEof()
@@ -84,24 +87,61 @@ bool Pipe::IsEof()
 
 bool Pipe::IsEmpty()
 {
-  return (m_buffer.getMaxReadSize() == 0);
+  return (GetMaxReadSize() == 0);
+}
+
+size_t Pipe::GetMaxReadSize() const
+{
+  const size_t readPos = m_readPos.load(std::memory_order_acquire);
+  return m_writePos.load(std::memory_order_acquire) - readPos;
+}
+
+size_t Pipe::GetMaxWriteSize() const
+{
+  const size_t readPos = m_readPos.load(std::memory_order_acquire);
+  return m_bufferSize - (m_writePos.load(std::memory_order_acquire) - readPos);
+}
+
+size_t Pipe::ReadData(char *buf, size_t nMaxSize)
+{
+  const size_t readPos = m_readPos.load(std::memory_order_relaxed);
+  const size_t nSize = std::min(m_writePos.load(std::memory_order_acquire) - readPos, nMaxSize);
+  const size_t offset = readPos % m_bufferSize;
+  const size_t first = std::min(nSize, m_bufferSize - offset);
+
+  memcpy(buf, m_buffer.get() + offset, first);
+  memcpy(buf + first, m_buffer.get(), nSize - first);
+  m_readPos.store(readPos + nSize, std::memory_order_release);
+  return nSize;
+}
+
+void Pipe::WriteData(const char *buf, size_t nSize)
+{
+  const size_t writePos = m_writePos.load(std::memory_order_relaxed);
+  const size_t offset = writePos % m_bufferSize;
+  const size_t first = std::min(nSize, m_bufferSize - offset);
+
+  memcpy(m_buffer.get() + offset, buf, first);
+  memcpy(m_buffer.get(), buf + first, nSize - first);
+  m_writePos.store(writePos + nSize, std::memory_order_release);
 }
 
 void Pipe::Flush()
 {
-  CSingleLock lock(m_lock);
+  CSingleLock lock(m_readLock);
 
   if (!m_bOpen || !m_bReadyForRead || m_bEof)
   {
     return;
   }
-  m_buffer.Clear();
+  // dropping the data is a read, the write side may go on meanwhile
+  m_readPos.store(m_writePos.load(std::memory_order_acquire), std::memory_order_release);
   CheckStatus();
 }
 
 int  Pipe::Read(char *buf, int nMaxSize, int nWaitMillis)
 {
-  CSingleLock lock(m_lock);
+  CSingleLock lock(m_readLock);
   
   if (!m_bOpen)
   {
@@ -111,26 +151,14 @@ int  Pipe::Read(char *buf, int nMaxSize, int nWaitMillis)
   while (!m_bReadyForRead && !m_bEof)
     m_readEvent.WaitMSec(100);
 
-  int nResult = 0;
-  if (!IsEmpty())
-  {
-    int nToRead = min((int)m_buffer.getMaxReadSize(), nMaxSize);
-    m_buffer.ReadData(buf, nToRead);
-    nResult = nToRead;
-  }
-  else if (m_bEof)
+  int nResult = ReadData(buf, nMaxSize);
+  if (nResult == 0 && !m_bEof)
   {
-    nResult = 0;
-  }
-  else
-  {
-    // we're leaving the guard - add ref to make sure we are not getting erased.
+    // make sure we are not getting erased while waiting.
     // at the moment we leave m_listeners unprotected which might be a problem in future
     // but as long as we only have 1 listener attaching at startup and detaching on close we're fine
     AddRef();
-    lock.Leave();
 
-    bool bHasData = false;
     int nMillisLeft = nWaitMillis;
     if (nMillisLeft < 0)
       nMillisLeft = 5*60*1000; // arbitrary. 5 min.
@@ -140,65 +168,51 @@ int  Pipe::Read(char *buf, int nMaxSize, int nWaitMillis)
       for (size_t l=0; l<m_listeners.size(); l++)
         m_listeners[l]->OnPipeUnderFlow();
 
-      bHasData = m_readEvent.WaitMSec(min(200,nMillisLeft));
+      m_readEvent.WaitMSec(std::min(200,nMillisLeft));
       nMillisLeft -= 200;
-    } while (!bHasData && nMillisLeft > 0 && !m_bEof);
+    } while (IsEmpty() && nMillisLeft > 0 && !m_bEof && m_bOpen);
 
-    lock.Enter();
     DecRef();
     
     if (!m_bOpen)
       return -1;
     
-    if (bHasData)
-    {
-      int nToRead = min((int)m_buffer.getMaxReadSize(), nMaxSize);
-      m_buffer.ReadData(buf, nToRead);
-      nResult = nToRead;
-    }
+    nResult = ReadData(buf, nMaxSize);
   }
   
-  CheckStatus();
+  if (nResult > 0)
+    m_writeEvent.Set();
   
   return nResult;
 }
 
 bool Pipe::Write(const char *buf, int nSize, int nWaitMillis)
 {
-  CSingleLock lock(m_lock);
-  if (!m_bOpen)
+  CSingleLock lock(m_writeLock);
+  if (!m_bOpen || nSize < 0 || static_cast<size_t>(nSize) > m_bufferSize)
     return false;
   bool bOk = false;
-  int writeSize = m_buffer.getMaxWriteSize();
-  if (writeSize > nSize)
-  {
-    m_buffer.WriteData((char*)buf, nSize);
-    bOk = true;
-  }
-  else
+  while (m_bOpen)
   {
-    while ( (int)m_buffer.getMaxWriteSize() < nSize && m_bOpen )
+    if (GetMaxWriteSize() >= static_cast<size_t>(nSize))
     {
-      lock.Leave();
-      for (size_t l=0; l<m_listeners.size(); l++)
-        m_listeners[l]->OnPipeOverFlow();
-
-      bool bClear = nWaitMillis < 0 ? m_writeEvent.Wait() : m_writeEvent.WaitMSec(nWaitMillis);
-      lock.Enter();
-      if (bClear && (int)m_buffer.getMaxWriteSize() >= nSize)
-      {
-        m_buffer.WriteData((char*)buf, nSize);
-        bOk = true;
-        break;
-      }
-
-      // FIXME: is this right? Shouldn't we see if the time limit has been reached?
-      if (nWaitMillis > 0)
-        break;
+      WriteData(buf, nSize);
+      bOk = true;
+      break;
     }
+
+    for (size_t l=0; l<m_listeners.size(); l++)
+      m_listeners[l]->OnPipeOverFlow();
+
+    bool bClear = nWaitMillis < 0 ? m_writeEvent.Wait() : m_writeEvent.WaitMSec(nWaitMillis);
+
+    // give up after a timed wait if there is still no room
+    if (nWaitMillis >= 0 && (!bClear || GetMaxWriteSize() < static_cast<size_t>(nSize)))
+      break;
   }
 
-  CheckStatus();
+  if (bOk)
+    m_readEvent.Set();
   
   return bOk && m_bOpen;
 }
@@ -212,16 +226,17 @@ void Pipe::CheckStatus()
     return;
   }
   
-  if (m_buffer.getMaxWriteSize() == 0)
+  if (GetMaxWriteSize() == 0)
     m_writeEvent.Reset();
   else
     m_writeEvent.Set();
   
-  if (m_buffer.getMaxReadSize() == 0)
+  size_t readSize = GetMaxReadSize();
+  if (readSize == 0)
     m_readEvent.Reset();
   else
   {
-    if (!m_bReadyForRead  && (int)m_buffer.getMaxReadSize() >= m_nOpenThreshold)
+    if (!m_bReadyForRead  && (int)readSize >= m_nOpenThreshold)
       m_bReadyForRead = true;
     m_readEvent.Set();  
   }
@@ -229,7 +244,6 @@ void Pipe::CheckStatus()
 
 void Pipe::Close()
 {
-  CSingleLock lock(m_lock);
   m_bOpen = false;
   m_readEvent.Set();
   m_writeEvent.Set();
@@ -261,8 +275,7 @@ void Pipe::RemoveListener(IPipeListener *l)
 
 int	Pipe::GetAvailableRead()
 {
-  CSingleLock lock(m_lock);
-  return m_buffer.getMaxReadSize();
+  return GetMaxReadSize();
 }
 
 PipesManager::PipesManager() : m_nGenIdHelper(1)
@@ -25,9 +25,10 @@
 
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
-#include "utils/RingBuffer.h"
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -44,6 +45,14 @@ public:
   virtual void OnPipeUnderFlow() = 0;
 };
   
+/**
+ * Pipe between a writer and readers of a stream.
+ *
+ * The data is kept in a single-producer/single-consumer ring. The write side
+ * and the read side each have their own lock, those only serialize several
+ * writers or several readers of the same pipe, a reader never waits for a
+ * writer copying its data and the other way round.
+ */
 class Pipe
   {
   public:
@@ -90,12 +99,19 @@ class Pipe
     void SetOpenThreshold(int threshold);
 
   protected:
+    size_t GetMaxReadSize() const;
+    size_t GetMaxWriteSize() const;
+    size_t ReadData(char *buf, size_t nMaxSize);
+    void WriteData(const char *buf, size_t nSize);
     
-    bool        m_bOpen;
-    bool        m_bReadyForRead;
+    std::atomic<bool> m_bOpen;
+    std::atomic<bool> m_bReadyForRead;
 
-    bool        m_bEof;
-    CRingBuffer m_buffer;
+    std::atomic<bool> m_bEof;
+    std::unique_ptr<char[]> m_buffer;
+    size_t      m_bufferSize;
+    std::atomic<size_t> m_readPos;  //!< total bytes read, only advanced by the read side
+    std::atomic<size_t> m_writePos; //!< total bytes written, only advanced by the write side
     std::string  m_strPipeName;
     int         m_nRefCount;
     int         m_nOpenThreshold;
@@ -106,6 +122,8 @@ class Pipe
     std::vector<XFILE::IPipeListener *> m_listeners;
     
     CCriticalSection m_lock;
+    CCriticalSection m_readLock;
+    CCriticalSection m_writeLock;
   };
 
   
@@ -38,6 +38,8 @@
 #include "messaging/ApplicationMessenger.h"
 #include "URL.h"
 
+#include <algorithm>
+
 using namespace XFILE;
 using namespace ADDON;
 using namespace KODI::MESSAGING;
@@ -45,6 +47,11 @@ using namespace KODI::MESSAGING;
 std::map<int, CPluginDirectory *> CPluginDirectory::globalHandles;
 int CPluginDirectory::handleCounter = 0;
 CCriticalSection CPluginDirectory::m_handleLock;
+std::map<std::string, CPluginDirectory::CCachedListing> CPluginDirectory::m_cachedListings;
+CCriticalSection CPluginDirectory::m_cacheLock;
+
+#define MAX_CACHED_LISTINGS 32
+#define MAX_CACHE_TTL 86400
 
 CPluginDirectory::CScriptObserver::CScriptObserver(int scriptId, CEvent &event) :
   CThread("scriptobs"), m_scriptId(scriptId), m_event(event)
@@ -75,6 +82,7 @@ CPluginDirectory::CPluginDirectory()
   , m_cancelled(false)
   , m_success(false)
   , m_totalItems(0)
+  , m_cacheTTL(0)
 {
   m_listItems = new CFileItemList;
   m_fileResult = new CFileItem;
@@ -142,6 +150,7 @@ bool CPluginDirectory::StartScript(const std::string& strPath, bool retrievingDi
   m_cancelled = false;
   m_success = false;
   m_totalItems = 0;
+  m_cacheTTL = 0;
 
   // setup our parameters to send the script
   std::string strHandle = StringUtils::Format("%i", handle);
@@ -206,6 +215,7 @@ bool CPluginDirectory::AddItem(int handle, const CFileItem *item, int totalItems
   CFileItemPtr pItem(new CFileItem(*item));
   dir->m_listItems->Add(pItem);
   dir->m_totalItems = totalItems;
+  dir->PublishItems(*dir->m_listItems);
 
   return !dir->m_cancelled;
 }
@@ -221,6 +231,8 @@ bool CPluginDirectory::AddItems(int handle, const CFileItemList *items, int tota
   pItemList.Copy(*items);
   dir->m_listItems->Append(pItemList);
   dir->m_totalItems = totalItems;
+  // the script hands out its items in batches already
+  dir->PublishItems(*dir->m_listItems, true);
 
   return !dir->m_cancelled;
 }
@@ -434,7 +446,12 @@ void CPluginDirectory::AddSortMethod(int handle, SORT_METHOD sortMethod, const s
 bool CPluginDirectory::GetDirectory(const CURL& url, CFileItemList& items)
 {
   const std::string pathToUrl(url.Get());
+  if (GetCachedListing(pathToUrl, items))
+    return true;
+
   bool success = StartScript(pathToUrl, true, false);
+  if (success && m_cacheTTL > 0)
+    CacheListing(pathToUrl, *m_listItems, m_cacheTTL);
 
   // append the items to the list
   items.Assign(*m_listItems, true); // true to keep the current items
@@ -442,6 +459,72 @@ bool CPluginDirectory::GetDirectory(const CURL& url, CFileItemList& items)
   return success;
 }
 
+bool CPluginDirectory::GetCachedListing(const std::string& strPath, CFileItemList& items)
+{
+  std::shared_ptr<CFileItemList> listing;
+  {
+    CSingleLock lock(m_cacheLock);
+    auto it = m_cachedListings.find(strPath);
+    if (it == m_cachedListings.end())
+      return false;
+
+    if (XbmcThreads::SystemClockMillis() - it->second.time >= it->second.ttl)
+    {
+      m_cachedListings.erase(it);
+      return false;
+    }
+    listing = it->second.items;
+  }
+
+  CLog::Log(LOGDEBUG, "%s - using cached listing of %s", __FUNCTION__, CURL::GetRedacted(strPath).c_str());
+
+  // the caller may change the items, it gets copies
+  CFileItemList copy;
+  copy.Copy(*listing);
+  items.Assign(copy, true);
+  return true;
+}
+
+void CPluginDirectory::CacheListing(const std::string& strPath, const CFileItemList& items, int seconds)
+{
+  std::shared_ptr<CFileItemList> listing(new CFileItemList);
+  listing->Copy(items);
+
+  CSingleLock lock(m_cacheLock);
+  if (m_cachedListings.size() >= MAX_CACHED_LISTINGS && m_cachedListings.find(strPath) == m_cachedListings.end())
+  {
+    auto oldest = m_cachedListings.begin();
+    for (auto it = m_cachedListings.begin(); it != m_cachedListings.end(); ++it)
+    {
+      if (it->second.time < oldest->second.time)
+        oldest = it;
+    }
+    m_cachedListings.erase(oldest);
+  }
+
+  CCachedListing& cached = m_cachedListings[strPath];
+  cached.addonId = CURL(strPath).GetHostName();
+  cached.items = listing;
+  cached.time = XbmcThreads::SystemClockMillis();
+  cached.ttl = std::min(seconds, MAX_CACHE_TTL) * 1000;
+}
+
+void CPluginDirectory::ClearCachedListings(const std::string& strPath)
+{
+  CURL url(strPath);
+  if (!url.IsProtocol("plugin"))
+    return;
+
+  CSingleLock lock(m_cacheLock);
+  for (auto it = m_cachedListings.begin(); it != m_cachedListings.end();)
+  {
+    if (it->second.addonId == url.GetHostName())
+      it = m_cachedListings.erase(it);
+    else
+      ++it;
+  }
+}
+
 bool CPluginDirectory::RunScriptWithParams(const std::string& strPath, bool resume)
 {
   CURL url(strPath);
@@ -559,6 +642,14 @@ void CPluginDirectory::SetSetting(int handle, const std::string &strID, const st
     dir->m_addon->UpdateSetting(strID, value);
 }
 
+void CPluginDirectory::SetCacheTTL(int handle, int seconds)
+{
+  CSingleLock lock(m_handleLock);
+  CPluginDirectory *dir = dirFromHandle(handle);
+  if (dir)
+    dir->m_cacheTTL = seconds;
+}
+
 void CPluginDirectory::SetContent(int handle, const std::string &strContent)
 {
   CSingleLock lock(m_handleLock);
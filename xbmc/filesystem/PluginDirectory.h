@@ -23,6 +23,7 @@
 #include "SortFileItem.h"
 
 #include <atomic>
+#include <memory>
 #include <string>
 #include <map>
 #include "threads/CriticalSection.h"
@@ -63,6 +64,13 @@ public:
   static void SetProperty(int handle, const std::string &strProperty, const std::string &strValue);
   static void SetResolvedUrl(int handle, bool success, const CFileItem* resultItem);
   static void SetLabel2(int handle, const std::string& ident);
+  static void SetCacheTTL(int handle, int seconds);
+
+  /*!
+   \brief Drop the cached listings of the add-on the path belongs to, e.g. when
+   the add-on asks for a refresh.
+   */
+  static void ClearCachedListings(const std::string& strPath);
 
 private:
   ADDON::AddonPtr m_addon;
@@ -76,6 +84,22 @@ private:
   static CCriticalSection m_handleLock;
   static int handleCounter;
 
+  /*!
+   \brief Listing an add-on allowed to be reused for a while, see SetCacheTTL().
+   Shared and never changed once cached.
+   */
+  struct CCachedListing
+  {
+    std::string addonId;
+    std::shared_ptr<CFileItemList> items;
+    unsigned int time;
+    unsigned int ttl; // milliseconds
+  };
+  static bool GetCachedListing(const std::string& strPath, CFileItemList& items);
+  static void CacheListing(const std::string& strPath, const CFileItemList& items, int seconds);
+  static std::map<std::string, CCachedListing> m_cachedListings;
+  static CCriticalSection m_cacheLock;
+
   CFileItemList* m_listItems;
   CFileItem*     m_fileResult;
   CEvent         m_fetchComplete;
@@ -83,6 +107,7 @@ private:
   std::atomic<bool> m_cancelled;
   bool          m_success;      // set by script in EndOfDirectory
   int    m_totalItems;   // set by script in AddDirectoryItem
+  int    m_cacheTTL;     // set by script in SetCacheTTL, seconds
 
   class CScriptObserver : public CThread
   {
@@ -26,9 +26,13 @@
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "filesystem/FileDirectoryFactory.h"
+#include "interfaces/AnnouncementManager.h"
 #include "music/MusicDatabase.h"
 #include "playlists/SmartPlayList.h"
+#include "profiles/ProfilesManager.h"
 #include "settings/Settings.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -40,6 +44,84 @@
 #define PROPERTY_GROUP_BY           "group.by"
 #define PROPERTY_GROUP_MIXED        "group.mixed"
 
+// The cache is cleared when it holds more playlists
+#define MAX_CACHED_PLAYLISTS        20
+
+using namespace ANNOUNCEMENT;
+
+namespace
+{
+  /*!
+   * \brief Items of the smart playlists, until the library changes
+   *
+   * Home screen widgets list the same playlists on every load of the window.
+   */
+  class CPlaylistItemsCache : public IAnnouncer
+  {
+  public:
+    // Never destroyed, the announcement manager is gone by then
+    static CPlaylistItemsCache& GetInstance()
+    {
+      static CPlaylistItemsCache *cache = new CPlaylistItemsCache;
+      return *cache;
+    }
+
+    bool Get(const std::string &key, CFileItemList &items, unsigned int &generation)
+    {
+      CSingleLock lock(m_section);
+      generation = m_generation;
+
+      auto it = m_items.find(key);
+      if (it == m_items.end())
+        return false;
+
+      items.Copy(*it->second);
+      return true;
+    }
+
+    // generation as returned by Get(), items listed meanwhile may be outdated
+    void Set(const std::string &key, const CFileItemList &items, unsigned int generation)
+    {
+      std::unique_ptr<CFileItemList> copy(new CFileItemList);
+      copy->Copy(items);
+
+      CSingleLock lock(m_section);
+      if (generation != m_generation)
+        return;
+
+      if (m_items.size() >= MAX_CACHED_PLAYLISTS)
+        m_items.clear();
+      m_items[key] = std::move(copy);
+    }
+
+    void Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data) override
+    {
+      if ((flag & (VideoLibrary | AudioLibrary)) == 0)
+        return;
+
+      if (strcmp(message, "OnScanFinished") == 0 ||
+          strcmp(message, "OnCleanFinished") == 0 ||
+          strcmp(message, "OnUpdate") == 0 ||
+          strcmp(message, "OnRemove") == 0)
+      {
+        CSingleLock lock(m_section);
+        m_items.clear();
+        m_generation++;
+      }
+    }
+
+  private:
+    CPlaylistItemsCache()
+    {
+      CAnnouncementManager::GetInstance().AddAnnouncer(this);
+    }
+
+    CCriticalSection m_section;
+    std::map<std::string, std::unique_ptr<CFileItemList>> m_items;
+    unsigned int m_generation = 0;
+  };
+}
+
 namespace XFILE
 {
   CSmartPlaylistDirectory::CSmartPlaylistDirectory() = default;
@@ -52,10 +134,28 @@ namespace XFILE
     CSmartPlaylist playlist;
     if (!playlist.Load(url))
       return false;
+
+    // random playlists are supposed to change, the others are kept until the library changes
+    std::string key;
+    const bool cacheable = CServiceBroker::IsServiceManagerUp() && playlist.IsCacheable() &&
+                           playlist.GetOrder() != SortByRandom && playlist.SaveAsJson(key);
+    unsigned int generation = 0;
+    if (cacheable)
+    {
+      key += StringUtils::Format("|%u|%d", CServiceBroker::GetProfileManager().GetCurrentProfileIndex(),
+                                 CServiceBroker::GetSettings().GetBool(CSettings::SETTING_FILELISTS_IGNORETHEWHENSORTING));
+      if (CPlaylistItemsCache::GetInstance().Get(key, items, generation))
+        return true;
+    }
+
     bool result = GetDirectory(playlist, items);
     if (result)
+    {
       items.SetProperty("library.smartplaylist", true);
-    
+      if (cacheable)
+        CPlaylistItemsCache::GetInstance().Set(key, items, generation);
+    }
+
     return result;
   }
   
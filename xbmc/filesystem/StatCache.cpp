@@ -0,0 +1,198 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StatCache.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "URL.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+using namespace XFILE;
+
+CStatCache::CStatCache(unsigned int ttl, unsigned int negativeTtl, size_t maxEntries)
+  : m_ttl(ttl),
+    m_negativeTtl(negativeTtl),
+    m_maxEntries(maxEntries),
+    m_cacheHits(0),
+    m_cacheMisses(0)
+{
+}
+
+bool CStatCache::IsCacheable(const CURL& url)
+{
+  return url.IsProtocol("smb") || url.IsProtocol("nfs") ||
+         url.IsProtocol("dav") || url.IsProtocol("davs");
+}
+
+const CStatCache::CEntry* CStatCache::Find(const std::string& path, unsigned int now) const
+{
+  tCache::const_iterator i = m_cache.find(path);
+  if (i == m_cache.end())
+    return nullptr;
+
+  if (now - i->second.time >= (i->second.exists ? m_ttl : m_negativeTtl))
+    return nullptr;
+
+  return &i->second;
+}
+
+bool CStatCache::GetExists(const CURL& url, bool& exists)
+{
+  if (!IsCacheable(url))
+    return false;
+
+  CSingleLock lock(m_cs);
+  const CEntry* entry = Find(url.Get(), XbmcThreads::SystemClockMillis());
+  if (entry == nullptr)
+  {
+    m_cacheMisses++;
+    return false;
+  }
+
+  m_cacheHits++;
+  exists = entry->exists;
+  return true;
+}
+
+void CStatCache::SetExists(const CURL& url, bool exists)
+{
+  if (!IsCacheable(url))
+    return;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  std::string path = url.Get();
+
+  CSingleLock lock(m_cs);
+  // keep a stat that is still valid, it tells more
+  const CEntry* current = Find(path, now);
+  if (current != nullptr && current->exists == exists)
+    return;
+
+  CheckIfFull(now);
+  CEntry& entry = m_cache[path];
+  entry.time = now;
+  entry.exists = exists;
+  entry.hasStat = false;
+}
+
+bool CStatCache::GetStat(const CURL& url, struct __stat64* buffer, int& result)
+{
+  if (!IsCacheable(url))
+    return false;
+
+  CSingleLock lock(m_cs);
+  const CEntry* entry = Find(url.Get(), XbmcThreads::SystemClockMillis());
+  if (entry == nullptr || (entry->exists && !entry->hasStat))
+  {
+    m_cacheMisses++;
+    return false;
+  }
+
+  m_cacheHits++;
+  if (entry->exists)
+  {
+    *buffer = entry->stat;
+    result = 0;
+  }
+  else
+  {
+    memset(buffer, 0, sizeof(struct __stat64));
+    result = -1;
+  }
+  return true;
+}
+
+void CStatCache::SetStat(const CURL& url, const struct __stat64* buffer, int result)
+{
+  if (!IsCacheable(url))
+    return;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  std::string path = url.Get();
+
+  CSingleLock lock(m_cs);
+  CheckIfFull(now);
+  CEntry& entry = m_cache[path];
+  entry.time = now;
+  entry.exists = (result == 0);
+  entry.hasStat = entry.exists;
+  if (entry.hasStat)
+    entry.stat = *buffer;
+}
+
+void CStatCache::ClearFile(const std::string& strFile)
+{
+  CSingleLock lock(m_cs);
+  m_cache.erase(strFile);
+}
+
+void CStatCache::ClearSubPaths(const std::string& strPath)
+{
+  std::string path(strPath);
+  URIUtils::RemoveSlashAtEnd(path);
+  std::string prefix(path);
+  URIUtils::AddSlashAtEnd(prefix);
+
+  CSingleLock lock(m_cs);
+  m_cache.erase(path);
+  tCache::iterator i = m_cache.lower_bound(prefix);
+  while (i != m_cache.end() && StringUtils::StartsWith(i->first, prefix))
+    m_cache.erase(i++);
+}
+
+void CStatCache::Clear()
+{
+  CSingleLock lock(m_cs);
+  m_cache.clear();
+}
+
+void CStatCache::CheckIfFull(unsigned int now)
+{
+  if (m_cache.size() < m_maxEntries)
+    return;
+
+  // drop the expired results, then everything if that wasn't enough
+  unsigned int ttl = std::max(m_ttl, m_negativeTtl);
+  for (tCache::iterator i = m_cache.begin(); i != m_cache.end();)
+  {
+    if (now - i->second.time >= ttl)
+      m_cache.erase(i++);
+    else
+      ++i;
+  }
+  if (m_cache.size() >= m_maxEntries)
+    m_cache.clear();
+}
+
+CStatCache::Stats CStatCache::GetStats() const
+{
+  Stats stats;
+  stats.hits = m_cacheHits;
+  stats.misses = m_cacheMisses;
+
+  CSingleLock lock(m_cs);
+  stats.entries = static_cast<unsigned int>(m_cache.size());
+  return stats;
+}
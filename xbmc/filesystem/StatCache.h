@@ -0,0 +1,105 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <map>
+#include <string>
+
+#include "IFile.h"
+#include "threads/CriticalSection.h"
+
+class CURL;
+
+namespace XFILE
+{
+  /*!
+   \brief Short lived cache of CFile::Exists and CFile::Stat results of files
+   on network shares, each of which is a round trip to the server.
+
+   Results are kept for a few seconds, files found missing for a shorter time.
+   Writes through CFile and CDirectory clear the results they affect.
+   */
+  class CStatCache
+  {
+  public:
+    struct Stats
+    {
+      uint64_t hits = 0; //!< lookups answered by the cache
+      uint64_t misses = 0; //!< lookups of cacheable paths passed to the filesystem
+      unsigned int entries = 0;
+    };
+
+    /*!
+     \param ttl milliseconds an existing file is cached for
+     \param negativeTtl milliseconds a missing file is cached for
+     \param maxEntries number of files that may be cached
+     */
+    explicit CStatCache(unsigned int ttl = TTL, unsigned int negativeTtl = NEGATIVE_TTL,
+                        size_t maxEntries = MAX_ENTRIES);
+
+    /*!
+     \brief Whether results for the url are cached, only done for network shares.
+     */
+    static bool IsCacheable(const CURL& url);
+
+    bool GetExists(const CURL& url, bool& exists);
+    void SetExists(const CURL& url, bool exists);
+    bool GetStat(const CURL& url, struct __stat64* buffer, int& result);
+    void SetStat(const CURL& url, const struct __stat64* buffer, int result);
+
+    void ClearFile(const std::string& strFile);
+    /*!
+     \brief Clear the results of the path and of everything below it.
+     */
+    void ClearSubPaths(const std::string& strPath);
+    void Clear();
+
+    Stats GetStats() const;
+
+  private:
+    static const unsigned int TTL = 10000;
+    static const unsigned int NEGATIVE_TTL = 3000;
+    static const size_t MAX_ENTRIES = 8192;
+
+    struct CEntry
+    {
+      unsigned int time;
+      bool exists;
+      bool hasStat; //!< stat is set, exists alone may be known without it
+      struct __stat64 stat;
+    };
+    typedef std::map<std::string, CEntry> tCache;
+
+    const CEntry* Find(const std::string& path, unsigned int now) const;
+    void CheckIfFull(unsigned int now);
+
+    unsigned int m_ttl;
+    unsigned int m_negativeTtl;
+    size_t m_maxEntries;
+
+    mutable CCriticalSection m_cs;
+    tCache m_cache;
+
+    std::atomic<uint64_t> m_cacheHits;
+    std::atomic<uint64_t> m_cacheMisses;
+  };
+}
+extern XFILE::CStatCache g_statCache;
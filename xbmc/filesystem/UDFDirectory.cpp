@@ -50,17 +50,17 @@ bool CUDFDirectory::GetDirectory(const CURL& url,
   URIUtils::AddSlashAtEnd(strRoot);
   URIUtils::AddSlashAtEnd(strSub);
 
-  udf25 udfIsoReader;
-  if(!udfIsoReader.Open(url2.GetHostName().c_str()))
+  std::shared_ptr<udf25> udfIsoReader = udf25::GetImage(url2.GetHostName());
+  if(!udfIsoReader)
      return false;
 
-  udf_dir_t *dirp = udfIsoReader.OpenDir(strSub.c_str());
+  udf_dir_t *dirp = udfIsoReader->OpenDir(strSub.c_str());
 
   if (dirp == NULL)
     return false;
 
   udf_dirent_t *dp = NULL;
-  while ((dp = udfIsoReader.ReadDir(dirp)) != NULL)
+  while ((dp = udfIsoReader->ReadDir(dirp)) != NULL)
   {
     if (dp->d_type == DVD_DT_DIR)
     {
@@ -87,7 +87,7 @@ bool CUDFDirectory::GetDirectory(const CURL& url,
     }	
   }
 
-  udfIsoReader.CloseDir(dirp);
+  udfIsoReader->CloseDir(dirp);
 
   return true;
 }
@@ -50,10 +50,10 @@ CUDFFile::~CUDFFile()
 //*********************************************************************************************
 bool CUDFFile::Open(const CURL& url)
 {
-  if(!m_udfIsoReaderLocal.Open(url.GetHostName().c_str()) || url.GetFileName().empty())
+  if(!(m_udfIsoReaderLocal = udf25::GetImage(url.GetHostName())) || url.GetFileName().empty())
      return false;
 
-  m_hFile = m_udfIsoReaderLocal.OpenFile(url.GetFileName().c_str());
+  m_hFile = m_udfIsoReaderLocal->OpenFile(url.GetFileName().c_str());
   if (m_hFile == INVALID_HANDLE_VALUE)
   {
     m_bOpened = false;
@@ -76,14 +76,14 @@ ssize_t CUDFFile::Read(void *lpBuf, size_t uiBufSize)
     return -1;
   char *pData = (char *)lpBuf;
 
-  return m_udfIsoReaderLocal.ReadFile( m_hFile, (unsigned char*)pData, (long)uiBufSize);
+  return m_udfIsoReaderLocal->ReadFile( m_hFile, (unsigned char*)pData, (long)uiBufSize);
 }
 
 //*********************************************************************************************
 void CUDFFile::Close()
 {
   if (!m_bOpened) return ;
-  m_udfIsoReaderLocal.CloseFile( m_hFile);
+  m_udfIsoReaderLocal->CloseFile( m_hFile);
   m_bOpened = false;
 }
 
@@ -91,7 +91,7 @@ void CUDFFile::Close()
 int64_t CUDFFile::Seek(int64_t iFilePosition, int iWhence)
 {
   if (!m_bOpened) return -1;
-  int64_t lNewPos = m_udfIsoReaderLocal.Seek(m_hFile, iFilePosition, iWhence);
+  int64_t lNewPos = m_udfIsoReaderLocal->Seek(m_hFile, iFilePosition, iWhence);
   return lNewPos;
 }
 
@@ -99,33 +99,33 @@ int64_t CUDFFile::Seek(int64_t iFilePosition, int iWhence)
 int64_t CUDFFile::GetLength()
 {
   if (!m_bOpened) return -1;
-  return m_udfIsoReaderLocal.GetFileSize(m_hFile);
+  return m_udfIsoReaderLocal->GetFileSize(m_hFile);
 }
 
 //*********************************************************************************************
 int64_t CUDFFile::GetPosition()
 {
   if (!m_bOpened) return -1;
-  return m_udfIsoReaderLocal.GetFilePosition(m_hFile);
+  return m_udfIsoReaderLocal->GetFilePosition(m_hFile);
 }
 
 bool CUDFFile::Exists(const CURL& url)
 {
-  if(!m_udfIsoReaderLocal.Open(url.GetHostName().c_str()))
+  if(!(m_udfIsoReaderLocal = udf25::GetImage(url.GetHostName())))
      return false;
 
-  m_hFile = m_udfIsoReaderLocal.OpenFile(url.GetFileName().c_str());
+  m_hFile = m_udfIsoReaderLocal->OpenFile(url.GetFileName().c_str());
   if (m_hFile == INVALID_HANDLE_VALUE)
     return false;
 
-  m_udfIsoReaderLocal.CloseFile(m_hFile);
+  m_udfIsoReaderLocal->CloseFile(m_hFile);
   m_hFile = INVALID_HANDLE_VALUE;
   return true;
 }
 
 int CUDFFile::Stat(const CURL& url, struct __stat64* buffer)
 {
-  if(!m_udfIsoReaderLocal.Open(url.GetHostName().c_str()))
+  if(!(m_udfIsoReaderLocal = udf25::GetImage(url.GetHostName())))
      return -1;
 
   if (url.GetFileName().empty())
@@ -134,12 +134,12 @@ int CUDFFile::Stat(const CURL& url, struct __stat64* buffer)
     return 0;
   }
 
-  m_hFile = m_udfIsoReaderLocal.OpenFile(url.GetFileName().c_str());
+  m_hFile = m_udfIsoReaderLocal->OpenFile(url.GetFileName().c_str());
   if (m_hFile != INVALID_HANDLE_VALUE)
   {
-    buffer->st_size = m_udfIsoReaderLocal.GetFileSize(m_hFile);
+    buffer->st_size = m_udfIsoReaderLocal->GetFileSize(m_hFile);
     buffer->st_mode = _S_IFREG;
-    m_udfIsoReaderLocal.CloseFile(m_hFile);
+    m_udfIsoReaderLocal->CloseFile(m_hFile);
     return 0;
   }
   errno = ENOENT;
@@ -45,7 +45,7 @@ public:
 protected:
   bool m_bOpened;
   HANDLE m_hFile;
-  udf25 m_udfIsoReaderLocal;
+  std::shared_ptr<udf25> m_udfIsoReaderLocal;
 };
 }
 
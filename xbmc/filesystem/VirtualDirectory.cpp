@@ -77,7 +77,11 @@ bool CVirtualDirectory::GetDirectory(const CURL& url, CFileItemList &items, bool
     CURL realURL = URIUtils::SubstitutePath(url);
     if (!m_pDir)
       m_pDir.reset(CDirectoryFactory::Create(realURL));
-    bool ret = CDirectory::GetDirectory(strPath, m_pDir, items, m_strFileMask, flags);
+    CDirectory::CHints hints;
+    hints.flags = flags;
+    hints.mask = m_strFileMask;
+    hints.callback = m_itemsCallback;
+    bool ret = CDirectory::GetDirectory(CURL(strPath), m_pDir, items, hints);
     if (!keepImpl)
       m_pDir.reset();
     return ret;
@@ -24,12 +24,15 @@
 #include "utils/auto_buffer.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <sys/stat.h>
 
 #if defined (TARGET_WINDOWS)
 #pragma comment(lib, "zlib.lib")
 #endif
 #define ZIP_CACHE_LIMIT 4*1024*1024
+#define ZIP_SEEK_POINT_INTERVAL 256*1024
+#define ZIP_MAX_SEEK_POINTS 32
 
 using namespace XFILE;
 
@@ -39,6 +42,7 @@ CZipFile::CZipFile()
   m_szStartOfStringBuffer = NULL;
   m_iDataInStringBuffer = 0;
   m_bCached = false;
+  m_bSeekPoints = false;
   m_iRead = -1;
 }
 
@@ -87,7 +91,12 @@ bool CZipFile::Open(const CURL&url)
     return false;
   }
   mFile.Seek(mZipItem.offset,SEEK_SET);
-  return InitDecompress();
+  if (!InitDecompress())
+    return false;
+
+  // only a stream read from the archive can be restarted at a seek point
+  m_bSeekPoints = (mZipItem.method == 8);
+  return true;
 }
 
 bool CZipFile::InitDecompress()
@@ -97,6 +106,8 @@ bool CZipFile::InitDecompress()
   m_iZipFilePos = 0;
   m_iAvailBuffer = 0;
   m_bFlush = false;
+  m_bSeekPoints = false;
+  ClearSeekPoints();
   m_ZStream.zalloc = Z_NULL;
   m_ZStream.zfree = Z_NULL;
   m_ZStream.opaque = Z_NULL;
@@ -182,27 +193,11 @@ int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
         return -1;
       // read until position in 128k blocks.. only way to do it due to format.
       // can't start in the middle of data since then we'd have no clue where
-      // we are in uncompressed data..
-      if (iFilePosition < m_iFilePos)
-      {
-        m_iFilePos = 0;
-        m_iZipFilePos = 0;
-        inflateEnd(&m_ZStream);
-        inflateInit2(&m_ZStream,-MAX_WBITS); // simply restart zlib
-        mFile.Seek(mZipItem.offset,SEEK_SET);
-        m_ZStream.next_in = (Bytef*)m_szBuffer;
-        m_ZStream.avail_in = 0;
-        m_ZStream.total_out = 0;
-        while (m_iFilePos < iFilePosition)
-        {
-          unsigned int iToRead = (iFilePosition - m_iFilePos)>blockSize ? blockSize : (int)(iFilePosition - m_iFilePos);
-          if (Read(buf.get(),iToRead) != iToRead)
-            return -1;
-        }
-        return m_iFilePos;
-      }
-      else // seek forward
-        return Seek(iFilePosition-m_iFilePos,SEEK_CUR);
+      // we are in uncompressed data, unless we passed there before and kept
+      // the state of zlib
+      if (!RestoreSeekPoint(iFilePosition) && iFilePosition < m_iFilePos)
+        Rewind();
+      return Seek(iFilePosition-m_iFilePos,SEEK_CUR);
       break;
 
     case SEEK_CUR:
@@ -223,15 +218,7 @@ int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
 
     case SEEK_END:
       // now this is a nasty bastard, possibly takes lotsoftime
-      // uncompress, minding m_ZStream.total_out
-
-      while( (int)m_ZStream.total_out < mZipItem.usize+iFilePosition)
-      {
-        unsigned int iToRead = (mZipItem.usize + iFilePosition - m_ZStream.total_out > blockSize) ? blockSize : (int)(mZipItem.usize + iFilePosition - m_ZStream.total_out);
-        if (Read(buf.get(), iToRead) != iToRead)
-          return -1;
-      }
-      return m_iFilePos;
+      return Seek(mZipItem.usize+iFilePosition,SEEK_SET);
       break;
     default:
       return -1;
@@ -344,6 +331,8 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
       iDecompressed = m_ZStream.total_out-prevOut;
     }
     m_iFilePos += iDecompressed;
+    if (m_bSeekPoints && !m_bFlush)
+      AddSeekPoint();
     return static_cast<unsigned int>(iDecompressed);
   }
   else if (mZipItem.method == 0) // uncompressed. just read from file, but mind our boundaries.
@@ -370,6 +359,7 @@ void CZipFile::Close()
   if (mZipItem.method == 8 && !m_bCached && m_iRead != -1)
     inflateEnd(&m_ZStream);
 
+  ClearSeekPoints();
   mFile.Close();
 }
 
@@ -390,6 +380,71 @@ bool CZipFile::FillBuffer()
   return true;
 }
 
+void CZipFile::Rewind()
+{
+  m_iFilePos = 0;
+  m_iZipFilePos = 0;
+  m_bFlush = false;
+  inflateEnd(&m_ZStream);
+  inflateInit2(&m_ZStream,-MAX_WBITS); // simply restart zlib
+  mFile.Seek(mZipItem.offset,SEEK_SET);
+  m_ZStream.next_in = (Bytef*)m_szBuffer;
+  m_ZStream.avail_in = 0;
+  m_ZStream.total_out = 0;
+}
+
+void CZipFile::AddSeekPoint()
+{
+  // the interval grows with the entry to bound the memory, each copy holds
+  // the state and the 32k window of zlib
+  int64_t interval = std::max<int64_t>(ZIP_SEEK_POINT_INTERVAL, mZipItem.usize / ZIP_MAX_SEEK_POINTS);
+  int64_t last = m_seekPoints.empty() ? 0 : m_seekPoints.back().pos;
+  if (m_iFilePos < last + interval || m_iFilePos >= mZipItem.usize)
+    return;
+
+  SeekPoint point;
+  point.stream.reset(new z_stream);
+  if (inflateCopy(point.stream.get(), &m_ZStream) != Z_OK)
+    return;
+  point.pos = m_iFilePos;
+  point.zipPos = m_iZipFilePos - m_ZStream.avail_in;
+  m_seekPoints.push_back(std::move(point));
+}
+
+bool CZipFile::RestoreSeekPoint(int64_t iFilePosition)
+{
+  auto it = std::upper_bound(m_seekPoints.begin(), m_seekPoints.end(), iFilePosition,
+                             [](int64_t pos, const SeekPoint& point) { return pos < point.pos; });
+  if (it == m_seekPoints.begin())
+    return false;
+  --it;
+
+  // reading on is cheaper if we are past the closest point already
+  if (iFilePosition >= m_iFilePos && it->pos <= m_iFilePos)
+    return false;
+
+  inflateEnd(&m_ZStream);
+  if (inflateCopy(&m_ZStream, it->stream.get()) != Z_OK)
+  {
+    Rewind();
+    return true;
+  }
+  m_iFilePos = it->pos;
+  m_iZipFilePos = it->zipPos;
+  m_bFlush = false;
+  mFile.Seek(mZipItem.offset+m_iZipFilePos,SEEK_SET);
+  m_ZStream.next_in = (Bytef*)m_szBuffer;
+  m_ZStream.avail_in = 0;
+  return true;
+}
+
+void CZipFile::ClearSeekPoints()
+{
+  for (auto& point : m_seekPoints)
+    inflateEnd(point.stream.get());
+  m_seekPoints.clear();
+}
+
 void CZipFile::DestroyBuffer(void* lpBuffer, int iBufSize)
 {
   if (!m_bFlush)
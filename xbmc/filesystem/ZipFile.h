@@ -21,6 +21,8 @@
  */
 
 #include "IFile.h"
+#include <memory>
+#include <vector>
 #include <zlib.h>
 #include "File.h"
 #include "ZipManager.h"
@@ -51,9 +53,24 @@ namespace XFILE
     static bool DecompressGzip(const std::string& in, std::string& out);
 
   private:
+    /*!
+     \brief Copy of the inflate state at a position of the uncompressed data,
+     seeking restarts from the closest one instead of from the start.
+     */
+    struct SeekPoint
+    {
+      int64_t pos; // position in _uncompressed_ data
+      int64_t zipPos; // position of the next byte of _compressed_ data
+      std::unique_ptr<z_stream> stream;
+    };
+
     bool InitDecompress();
     bool FillBuffer();
     void DestroyBuffer(void* lpBuffer, int iBufSize);
+    void Rewind();
+    void AddSeekPoint();
+    bool RestoreSeekPoint(int64_t iFilePosition);
+    void ClearSeekPoints();
     CFile mFile;
     SZipEntry mZipItem;
     int64_t m_iFilePos; // position in _uncompressed_ data read
@@ -67,6 +84,8 @@ namespace XFILE
     int m_iRead;
     bool m_bFlush;
     bool m_bCached;
+    bool m_bSeekPoints;
+    std::vector<SeekPoint> m_seekPoints;
   };
 }
 
@@ -26,6 +26,7 @@
 #include "File.h"
 #include "URL.h"
 #include "platform/linux/PlatformDefs.h"
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
 #include "utils/EndianSwap.h"
 #include "utils/log.h"
@@ -35,6 +36,7 @@
 using namespace XFILE;
 
 static const size_t ZC_FLAG_EFS = 1 << 11; // general purpose bit 11 - zip holds utf-8 filenames
+static const size_t ZIP_INDEX_MAX_ENTRIES = 50000; // about 15MB of cached central directories
 
 CZipManager::CZipManager() = default;
 
@@ -42,30 +44,114 @@ CZipManager::~CZipManager() = default;
 
 bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
 {
-  struct __stat64 m_StatData = {};
+  ZipIndexPtr index = GetIndex(url, true);
+  if (!index)
+    return false;
+
+  items = index->entries;
+  return true;
+}
+
+bool CZipManager::GetZipEntry(const CURL& url, SZipEntry& item)
+{
+  ZipIndexPtr index = GetIndex(url, false);
+  if (!index)
+    return false;
+
+  std::string strFileName = url.GetFileName();
+  const std::vector<SZipEntry>& entries = index->entries;
+  auto it = std::lower_bound(index->byName.begin(), index->byName.end(), strFileName,
+                             [&entries](unsigned int entry, const std::string& name)
+                             {
+                               return name.compare(entries[entry].name) > 0;
+                             });
+  if (it == index->byName.end() || strFileName != entries[*it].name)
+    return false;
 
+  memcpy(&item, &entries[*it], sizeof(SZipEntry));
+  return true;
+}
+
+CZipManager::ZipIndexPtr CZipManager::GetIndex(const CURL& url, bool checkDate)
+{
   std::string strFile = url.GetHostName();
 
+  ZipIndexPtr index;
+  {
+    CSingleLock lock(m_lock);
+    auto it = mZipMap.find(strFile);
+    if (it != mZipMap.end())
+    {
+      index = it->second;
+      index->lastUsed = ++m_useCount;
+    }
+  }
+  if (index && !checkDate)
+    return index;
+
+  struct __stat64 m_StatData = {};
   if (CFile::Stat(strFile,&m_StatData))
   {
     CLog::Log(LOGDEBUG,"CZipManager::GetZipList: failed to stat file %s", url.GetRedacted().c_str());
-    return false;
+    return ZipIndexPtr();
   }
 
-  std::map<std::string, std::vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
-  if (it != mZipMap.end()) // already listed, just return it if not changed, else release and reread
+  // already listed, just return it if not changed, else reread
+  if (index && index->mtime == m_StatData.st_mtime)
+    return index;
+
+  if (index)
+    release(url.Get());
+
+  index.reset(new SZipIndex);
+  if (!ReadCentralDirectory(strFile, index->entries))
+    return ZipIndexPtr();
+  index->mtime = m_StatData.st_mtime;
+  index->entries.shrink_to_fit();
+
+  const std::vector<SZipEntry>& entries = index->entries;
+  index->byName.resize(entries.size());
+  for (unsigned int i = 0; i < index->byName.size(); i++)
+    index->byName[i] = i;
+  std::stable_sort(index->byName.begin(), index->byName.end(),
+                   [&entries](unsigned int a, unsigned int b)
+                   {
+                     return strcmp(entries[a].name, entries[b].name) < 0;
+                   });
+
+  CSingleLock lock(m_lock);
+  auto it = mZipMap.find(strFile);
+  if (it != mZipMap.end()) // listed by another thread meanwhile
   {
-    std::map<std::string,int64_t>::iterator it2=mZipDate.find(strFile);
+    it->second->lastUsed = ++m_useCount;
+    return it->second;
+  }
+  CheckIfFull(entries.size());
+  index->lastUsed = ++m_useCount;
+  mZipMap.insert(std::make_pair(strFile, index));
+  m_cachedEntries += entries.size();
+  return index;
+}
 
-    if (m_StatData.st_mtime == it2->second)
+void CZipManager::CheckIfFull(size_t entries)
+{
+  // drop the least recently used indices, an archive on its own may exceed
+  // the limit and is cached anyway
+  while (!mZipMap.empty() && m_cachedEntries + entries > ZIP_INDEX_MAX_ENTRIES)
+  {
+    auto oldest = mZipMap.begin();
+    for (auto it = mZipMap.begin(); it != mZipMap.end(); ++it)
     {
-      items = it->second;
-      return true;
+      if (it->second->lastUsed < oldest->second->lastUsed)
+        oldest = it;
     }
-    mZipMap.erase(it);
-    mZipDate.erase(it2);
+    m_cachedEntries -= oldest->second->entries.size();
+    mZipMap.erase(oldest);
   }
+}
 
+bool CZipManager::ReadCentralDirectory(const std::string& strFile, std::vector<SZipEntry>& items)
+{
   CFile mFile;
   if (!mFile.Open(strFile))
   {
@@ -86,10 +172,6 @@ bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
   if (Endian_SwapLE32(hdr) == ZIP_SPLIT_ARCHIVE_HEADER)
     CLog::LogF(LOGWARNING, "ZIP split archive header found. Trying to process as a single archive..");
 
-  // push date for update detection
-  mZipDate.insert(make_pair(strFile,m_StatData.st_mtime));
-
-
   // Look for end of central directory record
   // Zipfile comment may be up to 65535 bytes
   // End of central directory record is 22 bytes (ECDREC_SIZE)
@@ -223,38 +305,10 @@ bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
 
   }
 
-  mZipMap.insert(make_pair(strFile,items));
   mFile.Close();
   return true;
 }
 
-bool CZipManager::GetZipEntry(const CURL& url, SZipEntry& item)
-{
-  std::string strFile = url.GetHostName();
-
-  std::map<std::string, std::vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
-  std::vector<SZipEntry> items;
-  if (it == mZipMap.end()) // we need to list the zip
-  {
-    GetZipList(url,items);
-  }
-  else
-  {
-    items = it->second;
-  }
-
-  std::string strFileName = url.GetFileName();
-  for (std::vector<SZipEntry>::iterator it2=items.begin();it2 != items.end();++it2)
-  {
-    if (std::string(it2->name) == strFileName)
-    {
-      memcpy(&item,&(*it2),sizeof(SZipEntry));
-      return true;
-    }
-  }
-  return false;
-}
-
 bool CZipManager::ExtractArchive(const std::string& strArchive, const std::string& strPath)
 {
   const CURL pathToUrl(strArchive);
@@ -320,12 +374,12 @@ void CZipManager::readCHeader(const char* buffer, SZipEntry& info)
 void CZipManager::release(const std::string& strPath)
 {
   CURL url(strPath);
-  std::map<std::string, std::vector<SZipEntry> >::iterator it= mZipMap.find(url.GetHostName());
+  CSingleLock lock(m_lock);
+  auto it = mZipMap.find(url.GetHostName());
   if (it != mZipMap.end())
   {
-    std::map<std::string,int64_t>::iterator it2=mZipDate.find(url.GetHostName());
+    m_cachedEntries -= it->second->entries.size();
     mZipMap.erase(it);
-    mZipDate.erase(it2);
   }
 }
 
@@ -32,9 +32,12 @@
 #define ECDREC_SIZE 22
 
 #include <memory.h>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
-#include <map>
+
+#include "threads/CriticalSection.h"
 
 class CURL;
 
@@ -113,8 +116,31 @@ public:
   static void readHeader(const char* buffer, SZipEntry& info);
   static void readCHeader(const char* buffer, SZipEntry& info);
 private:
-  std::map<std::string,std::vector<SZipEntry> > mZipMap;
-  std::map<std::string,int64_t> mZipDate;
+  /*!
+   \brief Parsed central directory of an archive. An index is never changed
+   once listed, readers share it and only look entries up by name.
+   */
+  struct SZipIndex
+  {
+    int64_t mtime = 0;
+    std::vector<SZipEntry> entries;
+    std::vector<unsigned int> byName; //!< indices into entries, sorted by name
+    unsigned int lastUsed = 0;
+  };
+  typedef std::shared_ptr<SZipIndex> ZipIndexPtr;
+
+  /*!
+   \brief Get the index of the archive, listing it if it is not cached
+   \param checkDate relist a cached index if the archive was changed
+   */
+  ZipIndexPtr GetIndex(const CURL& url, bool checkDate);
+  static bool ReadCentralDirectory(const std::string& strFile, std::vector<SZipEntry>& items);
+  void CheckIfFull(size_t entries);
+
+  CCriticalSection m_lock;
+  std::map<std::string, ZipIndexPtr> mZipMap;
+  size_t m_cachedEntries = 0; //!< entries of all indices in mZipMap
+  unsigned int m_useCount = 0;
 };
 
 extern CZipManager g_ZipManager;
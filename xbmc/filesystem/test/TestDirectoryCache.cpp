@@ -0,0 +1,114 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/DirectoryCache.h"
+#include "FileItem.h"
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+void AddItems(CFileItemList& items, const std::string& path, int count)
+{
+  for (int i = 0; i < count; i++)
+    items.Add(CFileItemPtr(new CFileItem(path + "/file" + std::to_string(i) + ".mkv", false)));
+}
+}
+
+TEST(TestDirectoryCache, GetDirectory)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  AddItems(items, "smb://server/share", 3);
+  cache.SetDirectory("smb://server/share/", items, DIR_CACHE_ALWAYS);
+
+  CFileItemList cached;
+  EXPECT_TRUE(cache.GetDirectory("smb://server/share", cached));
+  ASSERT_EQ(3, cached.Size());
+  EXPECT_EQ("smb://server/share/file0.mkv", cached[0]->GetPath());
+
+  // the caller gets copies, altering them doesn't change the cache
+  cached[0]->SetPath("smb://server/share/other.mkv");
+  CFileItemList again;
+  EXPECT_TRUE(cache.GetDirectory("smb://server/share", again));
+  EXPECT_EQ("smb://server/share/file0.mkv", again[0]->GetPath());
+
+  CFileItemList missing;
+  EXPECT_FALSE(cache.GetDirectory("smb://server/other", missing));
+
+  CDirectoryCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(2u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+  EXPECT_EQ(1u, stats.dirs);
+  EXPECT_EQ(3u, stats.items);
+}
+
+TEST(TestDirectoryCache, CacheOnce)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  AddItems(items, "nfs://server/export", 2);
+  cache.SetDirectory("nfs://server/export", items, DIR_CACHE_ONCE);
+
+  CFileItemList cached;
+  EXPECT_FALSE(cache.GetDirectory("nfs://server/export", cached));
+  EXPECT_TRUE(cache.GetDirectory("nfs://server/export", cached, true));
+
+  bool inCache = false;
+  EXPECT_TRUE(cache.FileExists("nfs://server/export/file1.mkv", inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(cache.FileExists("nfs://server/export/file2.mkv", inCache));
+  EXPECT_TRUE(inCache);
+
+  cache.AddFile("nfs://server/export/file2.mkv");
+  EXPECT_TRUE(cache.FileExists("nfs://server/export/file2.mkv", inCache));
+
+  // the copy handed out before isn't affected by added files
+  EXPECT_EQ(2, cached.Size());
+  cache.Clear();
+}
+
+TEST(TestDirectoryCache, MemoryBudget)
+{
+  CFileItemList items;
+  AddItems(items, "smb://server/share/a", 100);
+
+  // room for about two of the listings
+  CDirectoryCache cache(2 * sizeof(CFileItem) * 120);
+  cache.SetDirectory("smb://server/share/a", items, DIR_CACHE_ALWAYS);
+  cache.SetDirectory("smb://server/share/b", items, DIR_CACHE_ONCE);
+  cache.SetDirectory("smb://server/share/c", items, DIR_CACHE_ONCE);
+
+  // the least recently used one is gone, dirs cached always are kept
+  CFileItemList cached;
+  EXPECT_TRUE(cache.GetDirectory("smb://server/share/a", cached));
+  EXPECT_FALSE(cache.GetDirectory("smb://server/share/b", cached, true));
+  EXPECT_TRUE(cache.GetDirectory("smb://server/share/c", cached, true));
+  EXPECT_GE(2 * sizeof(CFileItem) * 120, cache.GetStats().size);
+
+  // a listing larger than the cache isn't cached at all
+  CFileItemList large;
+  AddItems(large, "smb://server/share/d", 300);
+  cache.SetDirectory("smb://server/share/d", large, DIR_CACHE_ALWAYS);
+  EXPECT_FALSE(cache.GetDirectory("smb://server/share/d", cached));
+  cache.Clear();
+}
@@ -0,0 +1,80 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/ExistsChecker.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+TEST(TestExistsChecker, Files)
+{
+  CFile *file;
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(""));
+  const std::string path = XBMC_TEMPFILEPATH(file);
+  const std::string directory = CXBMCTestUtils::Instance().TempFileDirectory(file);
+
+  // more paths than threads, so some wait for a free one
+  std::vector<std::string> paths;
+  for (int i = 0; i < 20; i++)
+  {
+    paths.push_back(path);
+    paths.push_back(URIUtils::AddFileToFolder(directory, "missing_exists_checker_file"));
+  }
+
+  CExistsChecker checker(2, 3);
+  std::vector<CExistsChecker::Result> results = checker.Check(paths);
+  ASSERT_EQ(paths.size(), results.size());
+  for (size_t i = 0; i < results.size(); i++)
+    EXPECT_EQ(i % 2 == 0 ? CExistsChecker::EXISTS : CExistsChecker::MISSING, results[i]);
+
+  // a file is no folder
+  results = checker.Check({ directory, path }, true);
+  ASSERT_EQ(2u, results.size());
+  EXPECT_EQ(CExistsChecker::EXISTS, results[0]);
+  EXPECT_EQ(CExistsChecker::MISSING, results[1]);
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
+TEST(TestExistsChecker, Cancel)
+{
+  std::vector<std::string> paths(10000, "/this/path/does/not/exist");
+
+  CExistsChecker checker(1, 1);
+  std::vector<CExistsChecker::Result> results = checker.Check(paths, false,
+    [](size_t done, size_t total)
+    {
+      return false;
+    });
+
+  // the progress is asked right away, before most paths are tested
+  ASSERT_EQ(paths.size(), results.size());
+  EXPECT_EQ(CExistsChecker::UNCHECKED, results.back());
+}
+
+TEST(TestExistsChecker, Empty)
+{
+  CExistsChecker checker;
+  EXPECT_TRUE(checker.Check({}).empty());
+}
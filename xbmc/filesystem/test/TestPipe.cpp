@@ -0,0 +1,84 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/PipesManager.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+#include <thread>
+
+using namespace XFILE;
+
+TEST(TestPipe, WrapAround)
+{
+  Pipe pipe("pipe://test/", 10);
+  char buf[10];
+
+  EXPECT_TRUE(pipe.Write("abcdefg", 7, 0));
+  EXPECT_EQ(5, pipe.Read(buf, 5, 0));
+  EXPECT_EQ(0, memcmp(buf, "abcde", 5));
+
+  // wraps at the end of the buffer
+  EXPECT_TRUE(pipe.Write("hijklmn", 7, 0));
+  EXPECT_EQ(9, pipe.GetAvailableRead());
+  EXPECT_EQ(9, pipe.Read(buf, 10, 0));
+  EXPECT_EQ(0, memcmp(buf, "fghijklmn", 9));
+  EXPECT_TRUE(pipe.IsEmpty());
+}
+
+TEST(TestPipe, Full)
+{
+  Pipe pipe("pipe://test/", 8);
+  EXPECT_TRUE(pipe.Write("12345678", 8, 0));
+  EXPECT_FALSE(pipe.Write("9", 1, 10));
+  EXPECT_FALSE(pipe.Write("123456789", 9, 0));
+}
+
+TEST(TestPipe, Threads)
+{
+  Pipe pipe("pipe://test/", 1000);
+  const int total = 100000;
+
+  std::thread writer([&pipe, total]() {
+    char block[100];
+    for (int pos = 0; pos < total; pos += sizeof(block))
+    {
+      for (size_t i = 0; i < sizeof(block); i++)
+        block[i] = static_cast<char>((pos + i) % 251);
+      pipe.Write(block, sizeof(block));
+    }
+    pipe.SetEof();
+  });
+
+  int pos = 0;
+  bool ordered = true;
+  char buf[333];
+  int read;
+  while ((read = pipe.Read(buf, sizeof(buf), 1000)) > 0)
+  {
+    for (int i = 0; i < read; i++, pos++)
+      ordered &= buf[i] == static_cast<char>(pos % 251);
+  }
+  writer.join();
+
+  EXPECT_EQ(total, pos);
+  EXPECT_TRUE(ordered);
+}
@@ -0,0 +1,112 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/StatCache.h"
+#include "URL.h"
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+TEST(TestStatCache, Exists)
+{
+  CStatCache cache;
+  CURL file("smb://server/share/movie.nfo");
+  bool exists = true;
+  EXPECT_FALSE(cache.GetExists(file, exists));
+
+  cache.SetExists(file, false);
+  EXPECT_TRUE(cache.GetExists(file, exists));
+  EXPECT_FALSE(exists);
+
+  // local files are never cached
+  CURL local("/tmp/movie.nfo");
+  cache.SetExists(local, true);
+  EXPECT_FALSE(cache.GetExists(local, exists));
+
+  CStatCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+  EXPECT_EQ(1u, stats.entries);
+}
+
+TEST(TestStatCache, Stat)
+{
+  CStatCache cache;
+  CURL file("nfs://server/export/movie.mkv");
+  struct __stat64 buffer = {};
+  buffer.st_size = 1234;
+  cache.SetStat(file, &buffer, 0);
+
+  struct __stat64 cached = {};
+  int result = -1;
+  ASSERT_TRUE(cache.GetStat(file, &cached, result));
+  EXPECT_EQ(0, result);
+  EXPECT_EQ(1234, cached.st_size);
+
+  bool exists = false;
+  EXPECT_TRUE(cache.GetExists(file, exists));
+  EXPECT_TRUE(exists);
+
+  // knowing that a file exists doesn't answer a stat
+  CURL other("nfs://server/export/other.mkv");
+  cache.SetExists(other, true);
+  EXPECT_FALSE(cache.GetStat(other, &cached, result));
+
+  CURL missing("nfs://server/export/missing.mkv");
+  cache.SetStat(missing, &buffer, -1);
+  ASSERT_TRUE(cache.GetStat(missing, &cached, result));
+  EXPECT_EQ(-1, result);
+}
+
+TEST(TestStatCache, Expire)
+{
+  CStatCache cache(0, 0);
+  CURL file("smb://server/share/movie.nfo");
+  cache.SetExists(file, true);
+  bool exists;
+  EXPECT_FALSE(cache.GetExists(file, exists));
+}
+
+TEST(TestStatCache, Clear)
+{
+  CStatCache cache;
+  CURL file("smb://server/share/dir/movie.nfo");
+  CURL sibling("smb://server/share/dir2/movie.nfo");
+  cache.SetExists(file, false);
+  cache.SetExists(sibling, false);
+
+  cache.ClearSubPaths("smb://server/share/dir/");
+  bool exists;
+  EXPECT_FALSE(cache.GetExists(file, exists));
+  EXPECT_TRUE(cache.GetExists(sibling, exists));
+
+  cache.ClearFile(sibling.Get());
+  EXPECT_FALSE(cache.GetExists(sibling, exists));
+}
+
+TEST(TestStatCache, Full)
+{
+  CStatCache cache(10000, 10000, 2);
+  cache.SetExists(CURL("smb://server/share/a"), true);
+  cache.SetExists(CURL("smb://server/share/b"), true);
+  cache.SetExists(CURL("smb://server/share/c"), true);
+  EXPECT_GE(2u, cache.GetStats().entries);
+}
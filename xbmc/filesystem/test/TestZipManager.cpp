@@ -19,7 +19,10 @@
  */
 
 #include "filesystem/ZipManager.h"
+#include "test/TestUtils.h"
 #include "utils/RegExp.h"
+#include "utils/URIUtils.h"
+#include "URL.h"
 
 #include "gtest/gtest.h"
 
@@ -40,3 +43,20 @@ TEST(TestZipManager, PathTraversal)
   ASSERT_FALSE(pathTraversal.RegFind("test.txt..") >= 0);
   ASSERT_FALSE(pathTraversal.RegFind("test..test.txt") >= 0);
 }
+
+TEST(TestZipManager, GetZipEntry)
+{
+  CURL archive(XBMC_REF_FILE_PATH("xbmc/filesystem/test/reffile.txt.zip"));
+  CZipManager manager;
+  SZipEntry entry;
+
+  ASSERT_TRUE(manager.GetZipEntry(URIUtils::CreateArchivePath("zip", archive, "reffile.txt"), entry));
+  EXPECT_STREQ("reffile.txt", entry.name);
+  EXPECT_EQ(1616U, entry.usize);
+  EXPECT_FALSE(manager.GetZipEntry(URIUtils::CreateArchivePath("zip", archive, "reffile.txt.bak"), entry));
+  EXPECT_FALSE(manager.GetZipEntry(URIUtils::CreateArchivePath("zip", archive, "a.txt"), entry));
+
+  std::vector<SZipEntry> items;
+  ASSERT_TRUE(manager.GetZipList(URIUtils::CreateArchivePath("zip", archive), items));
+  EXPECT_EQ(1U, items.size());
+}
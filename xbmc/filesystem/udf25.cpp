@@ -28,6 +28,11 @@
 #include "utils/log.h"
 #include "udf25.h"
 #include "File.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+
+#include <algorithm>
+#include <cstring>
 
 /* For direct data access, LSB first */
 #define GETN1(p) ((uint8_t)data[p])
@@ -285,6 +290,37 @@ uint32_t UDFFilePos(struct FileAD *File, uint64_t pos, uint64_t *res)
   return File->AD_chain[i].Length - (uint32_t)pos;
 }
 
+/* Same as UDFFilePos, starts the lookup at the AD of the previous one of the
+ * file if the position is not before it */
+static uint32_t UDFFilePosHint(BD_FILE bdfile, uint64_t pos, uint64_t *res)
+{
+  struct FileAD *File = bdfile->file;
+  uint32_t i = 0;
+  uint64_t start = 0;
+
+  if (pos >= bdfile->ad_start && bdfile->ad_index < File->num_AD) {
+    i = bdfile->ad_index;
+    start = bdfile->ad_start;
+  }
+
+  for (; i < File->num_AD; i++) {
+
+    if (pos - start < File->AD_chain[i].Length)
+      break;
+
+    start += File->AD_chain[i].Length;
+  }
+
+  if (i == File->num_AD)
+    return 0;
+
+  bdfile->ad_index = i;
+  bdfile->ad_start = start;
+
+  *res = (uint64_t)(File->Partition_Start + File->AD_chain[i].Location) * DVD_VIDEO_LB_LEN + (pos - start);
+  return File->AD_chain[i].Length - (uint32_t)(pos - start);
+}
+
 uint32_t UDFFileBlockPos(struct FileAD *File, uint32_t lb)
 {
   uint64_t res;
@@ -585,7 +621,9 @@ int udf25::GetUDFCache(UDFCacheType type, uint32_t nr, void *data)
   return 0;
 }
 
-int udf25::ReadAt( int64_t pos, size_t len, unsigned char *data )
+#define UDF_READ_BATCH (128 * DVD_VIDEO_LB_LEN)
+
+int udf25::ReadImage( int64_t pos, size_t len, unsigned char *data )
 {
   if (m_fp->Seek(pos, SEEK_SET) != pos)
     return -1;
@@ -599,6 +637,39 @@ int udf25::ReadAt( int64_t pos, size_t len, unsigned char *data )
   return (int)ret;
 }
 
+int udf25::ReadAt( int64_t pos, size_t len, unsigned char *data )
+{
+  CSingleLock lock(m_lock);
+
+  // small reads, a few sectors of a stream or of descriptors, come from an
+  // aligned batch so an image on a share isn't read a few KB at a time
+  if (pos < m_readBufferPos || pos + (int64_t)len > m_readBufferPos + (int64_t)m_readBufferLen)
+  {
+    int64_t start = pos - pos % UDF_READ_BATCH;
+    if (pos + (int64_t)len > start + UDF_READ_BATCH)
+      start = pos - pos % DVD_VIDEO_LB_LEN;
+    if (pos + (int64_t)len > start + UDF_READ_BATCH)
+      return ReadImage(pos, len, data);
+
+    if (!m_readBuffer)
+      m_readBuffer.reset(new unsigned char[UDF_READ_BATCH]);
+
+    m_readBufferLen = 0;
+    ssize_t ret = m_fp->Seek(start, SEEK_SET) == start ? m_fp->Read(m_readBuffer.get(), UDF_READ_BATCH) : -1;
+    if (ret < 0)
+      return -1;
+    m_readBufferPos = start;
+    m_readBufferLen = ret;
+  }
+
+  size_t offset = pos - m_readBufferPos;
+  size_t ret = std::min(len, m_readBufferLen > offset ? m_readBufferLen - offset : 0);
+  memcpy(data, m_readBuffer.get() + offset, ret);
+  if (ret > 0 && ret < len)
+    CLog::Log(LOGERROR, "udf25::ReadFile - less data than requested available!" );
+  return (int)ret;
+}
+
 int udf25::DVDReadLBUDF( uint32_t lb_number, size_t block_count, unsigned char *data, int encrypted )
 {
   int ret;
@@ -956,11 +1027,51 @@ int udf25::UDFScanDir(const struct FileAD& Dir, char *FileName, struct Partition
   return 0;
 }
 
+std::map<std::string, udf25::CachedImage> udf25::m_images;
+CCriticalSection udf25::m_imagesLock;
+
 udf25::udf25( )
 {
   m_fp = NULL;
   m_udfcache_level = 1;
   m_udfcache = NULL;
+  m_readBufferPos = 0;
+  m_readBufferLen = 0;
+}
+
+std::shared_ptr<udf25> udf25::GetImage(const std::string& isofile)
+{
+  /* images nobody uses are kept for browsing back and forth for a while */
+  static const unsigned int IDLE_TIME = 60 * 1000;
+  static const size_t MAX_IMAGES = 4;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+
+  CSingleLock lock(m_imagesLock);
+  for (auto it = m_images.begin(); it != m_images.end();)
+  {
+    if (it->second.reader.use_count() == 1 &&
+        (now - it->second.lastUsed > IDLE_TIME || m_images.size() > MAX_IMAGES))
+      it = m_images.erase(it);
+    else
+      ++it;
+  }
+
+  auto it = m_images.find(isofile);
+  if (it != m_images.end())
+  {
+    it->second.lastUsed = now;
+    return it->second.reader;
+  }
+
+  std::shared_ptr<udf25> reader(new udf25());
+  if (!reader->Open(isofile.c_str()))
+    return nullptr;
+
+  CachedImage& image = m_images[isofile];
+  image.reader = reader;
+  image.lastUsed = now;
+  return reader;
 }
 
 udf25::~udf25( )
@@ -1088,6 +1199,7 @@ bool udf25::Open(const char *isofile)
 
 HANDLE udf25::OpenFile( const char* filename )
 {
+  CSingleLock lock(m_lock);
   uint64_t filesize;
   UDF_FILE file = NULL;
   BD_FILE bdfile = NULL;
@@ -1122,7 +1234,7 @@ long udf25::ReadFile(HANDLE hFile, unsigned char *pBuffer, long lSize)
   len_origin = lSize;
   while(lSize > 0)
   {
-    len = UDFFilePos(bdfile->file, bdfile->seek_pos, &pos);
+    len = UDFFilePosHint(bdfile, bdfile->seek_pos, &pos);
     if(len == 0)
       break;
 
@@ -1243,6 +1355,7 @@ udf_dir_t *udf25::OpenDir( const char *subdir )
 
 udf_dirent_t *udf25::ReadDir( udf_dir_t *dirp )
 {
+  CSingleLock lock(m_lock);
   if (!UDFScanDirX(dirp)) {
     dirp->current_p = 0;
     dirp->dir_current = dirp->dir_location; // this is a rewind, wanted?
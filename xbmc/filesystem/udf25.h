@@ -26,6 +26,11 @@
  *
  */
 #include "File.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <memory>
+#include <string>
 
 /**
  * The length of one Logical Block of a DVD.
@@ -177,6 +182,8 @@ typedef struct _BD_FILE
   UDF_FILE file;
   uint64_t seek_pos;  // in bytes
   uint64_t filesize;  // in bytes
+  uint32_t ad_index;  // AD of the last read, lookups start there
+  uint64_t ad_start;  // file position the AD at ad_index starts at
 
 } *BD_FILE;
 
@@ -188,6 +195,14 @@ public:
   udf25( );
   virtual ~udf25( );
 
+  /*!
+   \brief Get the opened reader of an image. Readers are shared by all files
+   and directories of an image, so its handle and the cached partition,
+   directory and extent data are reused.
+   \return the reader or nullptr if the image can't be opened
+   */
+  static std::shared_ptr<udf25> GetImage(const std::string& isofile);
+
   DWORD SetFilePointer(HANDLE hFile, long lDistanceToMove, long* lpDistanceToMoveHigh, DWORD dwMoveMethod );
   int64_t GetFileSize(HANDLE hFile);
   int64_t GetFilePosition(HANDLE hFile);
@@ -219,11 +234,28 @@ private:
   int UDFMapICB( struct AD ICB, struct Partition *partition, struct FileAD *File );
   int UDFScanDir( const struct FileAD& Dir, char *FileName, struct Partition *partition, struct AD *FileICB, int cache_file_info);
   int SetUDFCache(UDFCacheType type, uint32_t nr, void *data);
+  int ReadImage( int64_t pos, size_t len, unsigned char *data );
 protected:
     /* Filesystem cache */
   int m_udfcache_level; /* 0 - turned off, 1 - on */
   void *m_udfcache;
   XFILE::CFile* m_fp;
+
+  /* aligned block of the image small reads are served from */
+  std::unique_ptr<unsigned char[]> m_readBuffer;
+  int64_t m_readBufferPos;
+  size_t m_readBufferLen;
+
+  /* serializes the users of a shared reader */
+  CCriticalSection m_lock;
+
+  struct CachedImage
+  {
+    std::shared_ptr<udf25> reader;
+    unsigned int lastUsed;
+  };
+  static std::map<std::string, CachedImage> m_images;
+  static CCriticalSection m_imagesLock;
 };
 
 #endif
@@ -31,6 +31,9 @@ CGameSettings::CGameSettings(CSettings &settings) :
   m_settings.RegisterCallback(this, {
     CSettings::SETTING_GAMES_ENABLEREWIND,
     CSettings::SETTING_GAMES_REWINDTIME,
+    CSettings::SETTING_GAMES_REWINDMEMORY,
+    CSettings::SETTING_GAMES_RUNAHEAD,
+    CSettings::SETTING_GAMES_SYNCTODISPLAY,
   });
 }
 
@@ -47,7 +50,10 @@ void CGameSettings::OnSettingChanged(std::shared_ptr<const CSetting> setting)
   const std::string& settingId = setting->GetId();
 
   if (settingId == CSettings::SETTING_GAMES_ENABLEREWIND ||
-      settingId == CSettings::SETTING_GAMES_REWINDTIME)
+      settingId == CSettings::SETTING_GAMES_REWINDTIME ||
+      settingId == CSettings::SETTING_GAMES_REWINDMEMORY ||
+      settingId == CSettings::SETTING_GAMES_RUNAHEAD ||
+      settingId == CSettings::SETTING_GAMES_SYNCTODISPLAY)
   {
     SetChanged();
     NotifyObservers(ObservableMessageSettingsChanged);
@@ -214,6 +214,7 @@ bool CGameClient::Initialize(void)
   m_struct.toKodi.OpenAudioStream = cb_open_audio_stream;
   m_struct.toKodi.AddStreamData = cb_add_stream_data;
   m_struct.toKodi.CloseStream = cb_close_stream;
+  m_struct.toKodi.GetStreamBuffer = cb_get_stream_buffer;
   m_struct.toKodi.EnableHardwareRendering = cb_enable_hardware_rendering;
   m_struct.toKodi.HwGetCurrentFramebuffer = cb_hw_get_current_framebuffer;
   m_struct.toKodi.HwGetProcAddress = cb_hw_get_proc_address;
@@ -515,6 +516,11 @@ void CGameClient::CloseFile()
 }
 
 void CGameClient::RunFrame()
+{
+  RunFrame(true, true);
+}
+
+void CGameClient::RunFrame(bool bAudio, bool bVideo)
 {
   IGameInputCallback *input;
 
@@ -530,8 +536,15 @@ void CGameClient::RunFrame()
 
   if (m_bIsPlaying)
   {
+    // The add-on hands over the frame's audio and video from inside RunFrame()
+    m_bAudioEnabled = bAudio;
+    m_bVideoEnabled = bVideo;
+
     try { LogError(m_struct.toAddon.RunFrame(), "RunFrame()"); }
     catch (...) { LogException("RunFrame()"); }
+
+    m_bAudioEnabled = true;
+    m_bVideoEnabled = true;
   }
 }
 
@@ -641,13 +654,13 @@ void CGameClient::AddStreamData(GAME_STREAM_TYPE stream, const uint8_t* data, un
   {
   case GAME_STREAM_AUDIO:
   {
-    if (m_audio)
+    if (m_audio && m_bAudioEnabled)
       m_audio->AddData(data, size);
     break;
   }
   case GAME_STREAM_VIDEO:
   {
-    if (m_video)
+    if (m_video && m_bVideoEnabled)
       m_video->AddData(data, size);
     break;
   }
@@ -677,6 +690,29 @@ void CGameClient::CloseStream(GAME_STREAM_TYPE stream)
   }
 }
 
+uint8_t* CGameClient::GetStreamBuffer(GAME_STREAM_TYPE stream, unsigned int size)
+{
+  switch (stream)
+  {
+  case GAME_STREAM_VIDEO:
+  {
+    if (m_video)
+      return m_video->GetBuffer(size);
+    break;
+  }
+  default:
+    break;
+  }
+
+  return nullptr;
+}
+
+void CGameClient::SetPlaybackRate(double rate)
+{
+  if (m_audio)
+    m_audio->SetPlaybackRate(rate);
+}
+
 size_t CGameClient::GetSerializeSize()
 {
   CSingleLock lock(m_critSection);
@@ -816,6 +852,15 @@ void CGameClient::cb_close_stream(void* kodiInstance, GAME_STREAM_TYPE stream)
   gameClient->CloseStream(stream);
 }
 
+uint8_t* CGameClient::cb_get_stream_buffer(void* kodiInstance, GAME_STREAM_TYPE stream, unsigned int size)
+{
+  CGameClient *gameClient = static_cast<CGameClient*>(kodiInstance);
+  if (!gameClient)
+    return nullptr;
+
+  return gameClient->GetStreamBuffer(stream, size);
+}
+
 void CGameClient::cb_enable_hardware_rendering(void* kodiInstance, const game_hw_info *hw_info)
 {
   CGameClient *gameClient = static_cast<CGameClient*>(kodiInstance);
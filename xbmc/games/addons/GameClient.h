@@ -96,6 +96,14 @@ public:
   const CGameClientTiming& Timing() const { return m_timing; }
   void RunFrame();
 
+  /*!
+   * @brief Run a frame, dropping the audio and/or video it produces
+   *
+   * Used for frames that are emulated but never presented, like the frames
+   * run ahead of the real one.
+   */
+  void RunFrame(bool bAudio, bool bVideo);
+
   // Audio/video callbacks
   bool OpenPixelStream(GAME_PIXEL_FORMAT format, unsigned int width, unsigned int height, GAME_VIDEO_ROTATION rotation);
   bool OpenVideoStream(GAME_VIDEO_CODEC codec);
@@ -103,6 +111,8 @@ public:
   bool OpenAudioStream(GAME_AUDIO_CODEC codec, const GAME_AUDIO_CHANNEL* channelMap);
   void AddStreamData(GAME_STREAM_TYPE stream, const uint8_t* data, unsigned int size);
   void CloseStream(GAME_STREAM_TYPE stream);
+  uint8_t* GetStreamBuffer(GAME_STREAM_TYPE stream, unsigned int size);
+  void SetPlaybackRate(double rate);
 
   // Access memory
   size_t SerializeSize() const { return m_serializeSize; }
@@ -147,6 +157,7 @@ private:
   static int cb_open_audio_stream(void* kodiInstance, GAME_AUDIO_CODEC codec, const GAME_AUDIO_CHANNEL* channel_map);
   static void cb_add_stream_data(void* kodiInstance, GAME_STREAM_TYPE stream, const uint8_t* data, unsigned int size);
   static void cb_close_stream(void* kodiInstance, GAME_STREAM_TYPE stream);
+  static uint8_t* cb_get_stream_buffer(void* kodiInstance, GAME_STREAM_TYPE stream, unsigned int size);
   static void cb_enable_hardware_rendering(void* kodiInstance, const game_hw_info* hw_info);
   static uintptr_t cb_hw_get_current_framebuffer(void* kodiInstance);
   static game_proc_address_t cb_hw_get_proc_address(void* kodiInstance, const char* sym);
@@ -171,6 +182,8 @@ private:
   IGameAudioCallback*   m_audio;               // The audio callback passed to OpenFile()
   IGameVideoCallback*   m_video;               // The video callback passed to OpenFile()
   IGameInputCallback*   m_input = nullptr;     // The input callback passed to OpenFile()
+  bool                  m_bAudioEnabled = true; // False while running a frame whose audio is dropped
+  bool                  m_bVideoEnabled = true; // False while running a frame whose video is dropped
   CGameClientTiming     m_timing;              // Class to scale playback to avoid resampling audio
   std::unique_ptr<IGameClientPlayback> m_playback; // Interface to control playback
   GAME_REGION           m_region;              // Region of the loaded game
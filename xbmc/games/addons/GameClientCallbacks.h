@@ -42,6 +42,12 @@ namespace GAME
     virtual bool OpenEncodedStream(AVCodecID codec, unsigned int samplerate, const CAEChannelInfo& channelLayout) = 0;
     virtual void AddData(const uint8_t* data, size_t size) = 0;
     virtual void CloseStream() = 0;
+
+    /*!
+     * \brief The game runs this much faster than its nominal rate, so its
+     *        audio arrives this much faster too
+     */
+    virtual void SetPlaybackRate(double rate) { }
   };
 
   class IGameVideoCallback
@@ -53,6 +59,15 @@ namespace GAME
     virtual bool OpenEncodedStream(AVCodecID codec) = 0;
     virtual void AddData(const uint8_t* data, size_t size) = 0;
     virtual void CloseStream() = 0;
+
+    /*!
+     * \brief Get memory the next frame can be rendered into
+     *
+     * Passing this memory to AddData() saves copying the frame.
+     *
+     * \return Memory for a frame of the given size, or nullptr if unavailable
+     */
+    virtual uint8_t* GetBuffer(size_t size) { return nullptr; }
   };
 
   class IGameInputCallback
@@ -30,10 +30,14 @@
 #include "games/GameSettings.h"
 #include "settings/Settings.h"
 #include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "windowing/GraphicContext.h"
+#include "windowing/WinSystem.h"
 #include "utils/MathUtils.h"
 #include "ServiceBroker.h"
 
 #include <algorithm>
+#include <cstring>
 
 using namespace KODI;
 using namespace GAME;
@@ -53,6 +57,8 @@ CGameClientReversiblePlayback::CGameClientReversiblePlayback(CGameClient* gameCl
   m_cacheTimeMs(0)
 {
   UpdateMemoryStream();
+  UpdateRunAhead();
+  UpdateDisplaySync();
 
   CServiceBroker::GetGameServices().GameSettings().RegisterObserver(this);
 
@@ -215,6 +221,13 @@ bool CGameClientReversiblePlayback::LoadSavestate(const std::string& path)
 
 void CGameClientReversiblePlayback::FrameEvent()
 {
+  // The refresh rate changes with the resolution
+  if (m_bSyncToDisplay && m_displaySyncFrames-- == 0)
+    UpdateDisplaySync();
+
+  if (RunAhead())
+    return;
+
   m_gameClient->RunFrame();
 
   AddFrame();
@@ -227,13 +240,55 @@ void CGameClientReversiblePlayback::RewindEvent()
   m_gameClient->RunFrame();
 }
 
-void CGameClientReversiblePlayback::AddFrame()
+bool CGameClientReversiblePlayback::RunAhead()
+{
+  CSingleLock lock(m_mutex);
+
+  if (m_runAheadFrames == 0 || m_runAheadState.empty())
+    return false;
+
+  // The real frame, which is heard but not seen. Its state is kept, so the
+  // frames after it are predicted from the input of this frame and thrown
+  // away again: the next frame starts from real state with new input.
+  m_gameClient->RunFrame(true, false);
+
+  if (!m_gameClient->Serialize(m_runAheadState.data(), m_runAheadState.size()))
+  {
+    CLog::Log(LOGERROR, "GAME: Failed to serialize, disabling run-ahead");
+    m_runAheadState.clear();
+    AddFrame();
+    return true;
+  }
+
+  AddFrame(m_runAheadState.data());
+
+  for (unsigned int i = 1; i < m_runAheadFrames; i++)
+    m_gameClient->RunFrame(false, false);
+
+  // The predicted frame, which is seen
+  m_gameClient->RunFrame(false, true);
+
+  m_gameClient->Deserialize(m_runAheadState.data(), m_runAheadState.size());
+
+  return true;
+}
+
+void CGameClientReversiblePlayback::AddFrame(const uint8_t* state /* = nullptr */)
 {
   CSingleLock lock(m_mutex);
 
   if (m_memoryStream)
   {
-    if (m_gameClient->Serialize(m_memoryStream->BeginFrame(), m_memoryStream->FrameSize()))
+    bool bSuccess;
+    if (state != nullptr)
+    {
+      std::memcpy(m_memoryStream->BeginFrame(), state, m_memoryStream->FrameSize());
+      bSuccess = true;
+    }
+    else
+      bSuccess = m_gameClient->Serialize(m_memoryStream->BeginFrame(), m_memoryStream->FrameSize());
+
+    if (bSuccess)
     {
       m_memoryStream->SubmitFrame();
       UpdatePlaybackStats();
@@ -291,6 +346,8 @@ void CGameClientReversiblePlayback::Notify(const Observable &obs, const Observab
   {
   case ObservableMessageSettingsChanged:
     UpdateMemoryStream();
+    UpdateRunAhead();
+    UpdateDisplaySync();
     break;
   default:
     break;
@@ -324,6 +381,9 @@ void CGameClientReversiblePlayback::UpdateMemoryStream()
     {
       m_memoryStream->SetMaxFrameCount(frameCount);
     }
+
+    const uint64_t rewindMemoryMB = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_GAMES_REWINDMEMORY);
+    m_memoryStream->SetMaxMemory(rewindMemoryMB * 1024 * 1024);
   }
   else
   {
@@ -337,3 +397,34 @@ void CGameClientReversiblePlayback::UpdateMemoryStream()
     m_cacheTimeMs = 0;
   }
 }
+
+void CGameClientReversiblePlayback::UpdateRunAhead()
+{
+  CSingleLock lock(m_mutex);
+
+  unsigned int runAheadFrames = 0;
+
+  if (m_gameClient->SerializeSize() > 0)
+    runAheadFrames = std::min(CServiceBroker::GetSettings().GetInt(CSettings::SETTING_GAMES_RUNAHEAD), 3);
+
+  m_runAheadFrames = runAheadFrames;
+
+  if (m_runAheadFrames > 0)
+    m_runAheadState.resize(m_gameClient->SerializeSize());
+  else
+    m_runAheadState.clear();
+}
+
+void CGameClientReversiblePlayback::UpdateDisplaySync()
+{
+  m_bSyncToDisplay = CServiceBroker::GetSettings().GetBool(CSettings::SETTING_GAMES_SYNCTODISPLAY);
+
+  double refreshRate = 0.0;
+  if (m_bSyncToDisplay && CServiceBroker::GetWinSystem() != nullptr)
+    refreshRate = CServiceBroker::GetWinSystem()->GetGfxContext().GetFPS();
+
+  const double rateFactor = m_gameLoop.SyncToDisplay(refreshRate);
+  m_gameClient->SetPlaybackRate(rateFactor);
+
+  m_displaySyncFrames = static_cast<unsigned int>(m_gameLoop.FPS());
+}
@@ -27,6 +27,7 @@
 #include <memory>
 #include <stddef.h>
 #include <stdint.h>
+#include <vector>
 
 namespace KODI
 {
@@ -67,11 +68,14 @@ namespace GAME
     virtual void Notify(const Observable &obs, const ObservableMessage msg) override;
 
   private:
-    void AddFrame();
+    void AddFrame(const uint8_t* state = nullptr);
+    bool RunAhead();
     void RewindFrames(uint64_t frames);
     void AdvanceFrames(uint64_t frames);
     void UpdatePlaybackStats();
     void UpdateMemoryStream();
+    void UpdateRunAhead();
+    void UpdateDisplaySync();
 
     // Construction parameter
     CGameClient* const m_gameClient;
@@ -81,10 +85,18 @@ namespace GAME
     std::unique_ptr<IMemoryStream> m_memoryStream;
     CCriticalSection m_mutex;
 
+    // Run-ahead functionality
+    unsigned int m_runAheadFrames = 0;
+    std::vector<uint8_t> m_runAheadState; // Allocated once, the real frame is restored from it
+
     // Savestate functionality
     std::unique_ptr<CSavestateWriter> m_savestateWriter;
     std::unique_ptr<CSavestateReader> m_savestateReader;
 
+    // Display sync functionality
+    bool m_bSyncToDisplay = false;
+    unsigned int m_displaySyncFrames = 0; // Frames until the refresh rate is checked again
+
     // Playback stats
     uint64_t m_totalFrameCount;
     uint64_t m_pastFrameCount;
@@ -29,6 +29,7 @@ using namespace GAME;
 
 #define DEFAULT_FPS  60  // In case fps is 0 (shouldn't happen)
 #define FOREVER_MS   (7 * 24 * 60 * 60 * 1000) // 1 week is large enough
+#define MAX_DISPLAY_SYNC_ADJUST  0.01 // Sync to display if rates differ by up to 1%
 
 CGameLoop::CGameLoop(IGameLoopCallback* callback, double fps) :
   CThread("GameLoop"),
@@ -77,6 +78,24 @@ void CGameLoop::PauseAsync()
   m_sleepEvent.Set();
 }
 
+double CGameLoop::SyncToDisplay(double refreshRate)
+{
+  double rateFactor = 1.0;
+
+  if (refreshRate > 0.0)
+  {
+    const double factor = refreshRate / m_fps;
+    if (std::abs(factor - 1.0) <= MAX_DISPLAY_SYNC_ADJUST)
+      rateFactor = factor;
+  }
+
+  CSingleLock lock(m_mutex);
+
+  m_rateFactor = rateFactor;
+
+  return rateFactor;
+}
+
 void CGameLoop::Process(void)
 {
   double nextFrameMs = NowMs();
@@ -137,7 +156,7 @@ void CGameLoop::Process(void)
 double CGameLoop::FrameTimeMs() const
 {
   if (m_speedFactor != 0.0)
-    return 1000.0 / m_fps / std::abs(m_speedFactor);
+    return 1000.0 / (m_fps * m_rateFactor) / std::abs(m_speedFactor);
   else
     return FOREVER_MS;
 }
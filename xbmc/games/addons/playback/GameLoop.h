@@ -59,6 +59,19 @@ namespace GAME
     void SetSpeed(double speedFactor);
     void PauseAsync();
 
+    /*!
+     * \brief Run at the display's refresh rate if it is close to the game's
+     *
+     * Showing exactly one frame per refresh avoids the judder of repeated
+     * frames where e.g. 60 fps games meet a 59.94 Hz display.
+     *
+     * \param refreshRate The display refresh rate, or 0 to run at the game's
+     *                    frame rate
+     *
+     * \return The factor the game runs faster than its frame rate
+     */
+    double SyncToDisplay(double refreshRate);
+
   protected:
     // implementation of CThread
     virtual void Process() override;
@@ -71,6 +84,7 @@ namespace GAME
     IGameLoopCallback* const m_callback;
     const double             m_fps;
     double                   m_speedFactor;
+    double                   m_rateFactor = 1.0; // Set by SyncToDisplay()
     bool                     m_bPauseAsync = false;
     double                   m_lastFrameMs;
     CEvent                   m_sleepEvent;
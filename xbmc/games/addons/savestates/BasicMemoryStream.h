@@ -40,6 +40,7 @@ namespace GAME
     virtual size_t FrameSize() const override { return m_frameSize; }
     virtual uint64_t MaxFrameCount() const override { return 1; }
     virtual void SetMaxFrameCount(uint64_t maxFrameCount) override { }
+    virtual void SetMaxMemory(uint64_t maxMemory) override { }
     virtual uint8_t* BeginFrame() override;
     virtual void SubmitFrame() override;
     virtual const uint8_t* CurrentFrame() const override;
@@ -21,37 +21,107 @@
 #include "DeltaPairMemoryStream.h"
 #include "utils/log.h"
 
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(HAS_NEON)
+#include <arm_neon.h>
+#endif
+
 using namespace KODI;
 using namespace GAME;
 
+// Equal words that end a run, a shorter gap costs less inside the run than
+// the header of a new one
+#define DELTA_RUN_GAP  2
+
+namespace
+{
+  // Return the index of the first word from pos on that differs
+  size_t SkipEqual(const uint32_t* a, const uint32_t* b, size_t pos, size_t size)
+  {
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; pos + 8 <= size; pos += 8)
+    {
+      __m128i lo = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + pos)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + pos)));
+      __m128i hi = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + pos + 4)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + pos + 4)));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_or_si128(lo, hi), zero)) != 0xFFFF)
+        break;
+    }
+#elif defined(HAS_NEON)
+    for (; pos + 8 <= size; pos += 8)
+    {
+      uint32x4_t diff = vorrq_u32(veorq_u32(vld1q_u32(a + pos), vld1q_u32(b + pos)),
+                                  veorq_u32(vld1q_u32(a + pos + 4), vld1q_u32(b + pos + 4)));
+      uint32x2_t half = vorr_u32(vget_low_u32(diff), vget_high_u32(diff));
+      if (vget_lane_u32(vpmax_u32(half, half), 0) != 0)
+        break;
+    }
+#endif
+
+    while (pos < size && a[pos] == b[pos])
+      pos++;
+
+    return pos;
+  }
+}
+
 void CDeltaPairMemoryStream::Reset()
 {
   CLinearMemoryStream::Reset();
 
   m_rewindBuffer.clear();
+  m_rewindBufferBytes = 0;
+  m_scratch.clear();
+  m_scratch.shrink_to_fit();
 }
 
 void CDeltaPairMemoryStream::SubmitFrameInternal()
 {
-  m_rewindBuffer.push_back(MemoryFrame());
-  MemoryFrame& frame = m_rewindBuffer.back();
-
-  // Record frame history
-  frame.frameHistoryCount = m_currentFrameHistory++;
+  const uint32_t* currentFrame = m_currentFrame.get();
+  const uint32_t* nextFrame = m_nextFrame.get();
 
-  uint32_t* currentFrame = m_currentFrame.get();
-  uint32_t* nextFrame = m_nextFrame.get();
+  m_scratch.clear();
 
-  for (size_t i = 0; i < m_paddedFrameSize; i++)
+  size_t pos = 0; // End of the previous run
+  while (pos < m_paddedFrameSize)
   {
-    uint32_t xor_val = currentFrame[i] ^ nextFrame[i];
-    if (xor_val)
+    const size_t start = SkipEqual(currentFrame, nextFrame, pos, m_paddedFrameSize);
+    if (start >= m_paddedFrameSize)
+      break;
+
+    // Extend the run over short gaps of equal words
+    size_t end = start + 1;
+    size_t gap = 0;
+    while (end + gap < m_paddedFrameSize && gap < DELTA_RUN_GAP)
     {
-      DeltaPair pair = { i, xor_val };
-      frame.buffer.push_back(pair);
+      if (currentFrame[end + gap] != nextFrame[end + gap])
+      {
+        end += gap + 1;
+        gap = 0;
+      }
+      else
+        gap++;
     }
+
+    m_scratch.push_back(static_cast<uint32_t>(start - pos));
+    m_scratch.push_back(static_cast<uint32_t>(end - start));
+    for (size_t i = start; i < end; i++)
+      m_scratch.push_back(currentFrame[i] ^ nextFrame[i]);
+
+    pos = end;
   }
 
+  m_rewindBuffer.push_back(MemoryFrame());
+  MemoryFrame& frame = m_rewindBuffer.back();
+
+  // Record frame history
+  frame.frameHistoryCount = m_currentFrameHistory++;
+  frame.buffer.assign(m_scratch.begin(), m_scratch.end());
+  m_rewindBufferBytes += sizeof(MemoryFrame) + frame.buffer.size() * sizeof(uint32_t);
+
   // Delta is generated, bring the new frame forward (m_nextFrame is now disposable)
   std::swap(m_currentFrame, m_nextFrame);
 
@@ -59,6 +129,9 @@ void CDeltaPairMemoryStream::SubmitFrameInternal()
 
   if (PastFramesAvailable() + 1 > MaxFrameCount())
     CullPastFrames(1);
+
+  while (m_maxMemory > 0 && m_rewindBufferBytes > m_maxMemory && m_rewindBuffer.size() > 1)
+    CullPastFrames(1);
 }
 
 uint64_t CDeltaPairMemoryStream::PastFramesAvailable() const
@@ -76,18 +149,29 @@ uint64_t CDeltaPairMemoryStream::RewindFrames(uint64_t frameCount)
       break;
 
     const MemoryFrame& frame = m_rewindBuffer.back();
-    const DeltaPair* buffer = frame.buffer.data();
+    const uint32_t* runs = frame.buffer.data();
+    const uint32_t* runsEnd = runs + frame.buffer.size();
 
-    size_t bufferSize = frame.buffer.size();
+    uint32_t* currentFrame = m_currentFrame.get();
 
-    // buffer pointer redirection violates data-dependency requirements...
-    // no vectorization for us :(
-    for (size_t i = 0; i < bufferSize; i++)
-      m_currentFrame[buffer[i].pos] ^= buffer[i].delta;
+    while (runs < runsEnd)
+    {
+      currentFrame += runs[0];
+      const uint32_t length = runs[1];
+      runs += 2;
+
+      // Contiguous, so this loop vectorizes
+      for (uint32_t i = 0; i < length; i++)
+        currentFrame[i] ^= runs[i];
+
+      currentFrame += length;
+      runs += length;
+    }
 
     // Restore frame history
     m_currentFrameHistory = frame.frameHistoryCount;
 
+    m_rewindBufferBytes -= sizeof(MemoryFrame) + frame.buffer.size() * sizeof(uint32_t);
     m_rewindBuffer.pop_back();
   }
 
@@ -103,6 +187,7 @@ void CDeltaPairMemoryStream::CullPastFrames(uint64_t frameCount)
       CLog::Log(LOGDEBUG, "CDeltaPairMemoryStream: Tried to cull %d frames too many. Check your math!", frameCount - removedCount);
       break;
     }
+    m_rewindBufferBytes -= sizeof(MemoryFrame) + m_rewindBuffer.front().buffer.size() * sizeof(uint32_t);
     m_rewindBuffer.pop_front();
   }
 }
@@ -53,26 +53,29 @@ namespace GAME
      * the save state buffer which have changed. In practice, this is very fast
      * and simple (linear scan) and allows deltas to be compressed down to 1-3%
      * of original save state size depending on the system. The algorithm runs
-     * on 32 bits at a time for speed.
+     * on 32 bits at a time, skipping equal blocks with SIMD where available.
+     *
+     * A delta is a sequence of runs of changed words, each stored as the
+     * number of unchanged words before it, the number of words in the run and
+     * the XOR values of these words. Changes separated by less than a run
+     * header are merged into one run.
      *
      * Use std::deque here to achieve amortized O(1) on pop/push to front and
      * back.
      */
-    struct DeltaPair
-    {
-      size_t pos;
-      uint32_t delta;
-    };
-
-    using DeltaPairVector = std::vector<DeltaPair>;
+    using DeltaRuns = std::vector<uint32_t>;
 
     struct MemoryFrame
     {
-      DeltaPairVector buffer;
+      DeltaRuns buffer;
       uint64_t frameHistoryCount;
     };
 
     std::deque<MemoryFrame> m_rewindBuffer;
+    uint64_t m_rewindBufferBytes = 0;
+
+  private:
+    DeltaRuns m_scratch; // Deltas are built here and copied to a buffer of the exact size
   };
 }
 }
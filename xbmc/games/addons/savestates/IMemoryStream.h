@@ -86,6 +86,16 @@ namespace GAME
      */
     virtual void SetMaxFrameCount(uint64_t maxFrameCount) = 0;
 
+    /*!
+     * \brief Limit the memory used to keep past frames
+     *
+     * Old frames are deleted when either the max frame count or this limit is
+     * reached.
+     *
+     * \param maxMemory The limit in bytes, or 0 for no limit
+     */
+    virtual void SetMaxMemory(uint64_t maxMemory) = 0;
+
     /*!
      * \ brief Get a pointer to which FrameSize() bytes can be written
      *
@@ -41,6 +41,7 @@ namespace GAME
     virtual size_t FrameSize() const override { return m_frameSize; }
     virtual uint64_t MaxFrameCount() const override { return m_maxFrames; }
     virtual void SetMaxFrameCount(uint64_t maxFrameCount) override;
+    virtual void SetMaxMemory(uint64_t maxMemory) override { m_maxMemory = maxMemory; }
     virtual uint8_t* BeginFrame() override;
     virtual void SubmitFrame() override;
     virtual const uint8_t* CurrentFrame() const override;
@@ -60,6 +61,7 @@ namespace GAME
 
     size_t m_paddedFrameSize;
     uint64_t m_maxFrames;
+    uint64_t m_maxMemory = 0;
 
     /**
      * Simple double-buffering. After XORing the two states, the next becomes
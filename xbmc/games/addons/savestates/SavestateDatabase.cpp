@@ -24,20 +24,117 @@
 #include "SavestateUtils.h"
 #include "ServiceBroker.h"
 #include "addons/AddonManager.h"
+#include "filesystem/File.h"
 #include "games/GameTypes.h"
 #include "games/tags/GameInfoTag.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 #include "FileItem.h"
+#include "TextureCache.h"
 
 using namespace KODI;
 using namespace GAME;
 
+#define SAVESTATES_INDEX_PATH  "special://profile/Database/" SAVESTATES_DATABASE_NAME ".json"
+
+namespace
+{
+  CCriticalSection g_indexSection;
+  CVariant g_index(CVariant::VariantTypeArray); // Serialized savestates
+  bool g_indexLoaded = false;
+
+  void LoadIndex()
+  {
+    if (g_indexLoaded)
+      return;
+
+    g_indexLoaded = true;
+
+    XFILE::CFile file;
+    XUTILS::auto_buffer buffer;
+    if (!XFILE::CFile::Exists(SAVESTATES_INDEX_PATH) || file.LoadFile(SAVESTATES_INDEX_PATH, buffer) <= 0)
+      return;
+
+    CVariant index;
+    if (CJSONVariantParser::Parse(std::string(buffer.get(), buffer.size()), index) &&
+        index["savestates"].isArray())
+      g_index = index["savestates"];
+    else
+      CLog::Log(LOGERROR, "Failed to parse savestate index %s", SAVESTATES_INDEX_PATH);
+  }
+
+  bool SaveIndex()
+  {
+    CVariant index;
+    index["savestates"] = g_index;
+
+    std::string json;
+    if (!CJSONVariantWriter::Write(index, json, true))
+      return false;
+
+    XFILE::CFile file;
+    if (!file.OpenForWrite(SAVESTATES_INDEX_PATH, true) ||
+        file.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+    {
+      CLog::Log(LOGERROR, "Failed to write savestate index %s", SAVESTATES_INDEX_PATH);
+      return false;
+    }
+
+    return true;
+  }
+
+  int FindSavestate(const std::string& path)
+  {
+    for (unsigned int i = 0; i < g_index.size(); i++)
+    {
+      if (g_index[i][SAVESTATE_FIELD_PATH].asString() == path)
+        return static_cast<int>(i);
+    }
+    return -1;
+  }
+
+  bool MatchesGame(const CVariant& object, const std::string& gamePath, const std::string& gameClient)
+  {
+    return object[SAVESTATE_FIELD_GAME_PATH].asString() == gamePath &&
+           (gameClient.empty() || object[SAVESTATE_FIELD_GAMECLIENT].asString() == gameClient);
+  }
+}
+
 CSavestateDatabase::CSavestateDatabase() = default;
 
 bool CSavestateDatabase::AddSavestate(const CSavestate& save)
 {
-  return save.Serialize(CSavestateUtils::MakeMetadataPath(save.GamePath()));
+  if (!save.Serialize(CSavestateUtils::MakeMetadataPath(save.GamePath())))
+    return false;
+
+  CVariant object;
+  save.Serialize(object);
+
+  CSingleLock lock(g_indexSection);
+
+  LoadIndex();
+
+  int position = FindSavestate(save.Path());
+  if (position >= 0)
+  {
+    // The thumbnail may have been overwritten in place
+    const std::string thumbnail = g_index[position][SAVESTATE_FIELD_THUMBNAIL].asString();
+    if (!thumbnail.empty())
+      CTextureCache::GetInstance().ClearCachedImage(thumbnail);
+
+    g_index[position] = std::move(object);
+  }
+  else
+    g_index.push_back(std::move(object));
+
+  SaveIndex();
+
+  return true;
 }
 
 bool CSavestateDatabase::GetSavestate(const std::string& path, CSavestate& save)
@@ -47,26 +144,88 @@ bool CSavestateDatabase::GetSavestate(const std::string& path, CSavestate& save)
 
 bool CSavestateDatabase::GetSavestatesNav(CFileItemList& items, const std::string& gamePath, const std::string& gameClient /* = "" */)
 {
-  //! @todo
-  return false;
+  CSingleLock lock(g_indexSection);
+
+  LoadIndex();
+
+  for (auto it = g_index.begin_array(); it != g_index.end_array(); ++it)
+  {
+    if (MatchesGame(*it, gamePath, gameClient))
+      items.Add(CFileItemPtr(CreateFileItem(*it)));
+  }
+
+  return true;
 }
 
 bool CSavestateDatabase::RenameSavestate(const std::string& path, const std::string& label)
 {
-  //! @todo
-  return false;
+  CSingleLock lock(g_indexSection);
+
+  LoadIndex();
+
+  int position = FindSavestate(path);
+  if (position < 0)
+    return false;
+
+  CSavestate save;
+  save.Deserialize(g_index[position]);
+  save.SetLabel(label);
+
+  if (!save.Serialize(CSavestateUtils::MakeMetadataPath(save.GamePath())))
+    return false;
+
+  g_index[position][SAVESTATE_FIELD_LABEL] = label;
+
+  return SaveIndex();
 }
 
 bool CSavestateDatabase::DeleteSavestate(const std::string& path)
 {
-  //! @todo
-  return false;
+  CSingleLock lock(g_indexSection);
+
+  LoadIndex();
+
+  int position = FindSavestate(path);
+  if (position < 0)
+    return false;
+
+  RemoveSavestate(position);
+
+  return SaveIndex();
 }
 
 bool CSavestateDatabase::ClearSavestatesOfGame(const std::string& gamePath, const std::string& gameClient /* = "" */)
 {
-  //! @todo
-  return false;
+  CSingleLock lock(g_indexSection);
+
+  LoadIndex();
+
+  for (unsigned int i = g_index.size(); i > 0; i--)
+  {
+    if (MatchesGame(g_index[i - 1], gamePath, gameClient))
+      RemoveSavestate(i - 1);
+  }
+
+  return SaveIndex();
+}
+
+void CSavestateDatabase::RemoveSavestate(unsigned int position)
+{
+  using namespace XFILE;
+
+  CSavestate save;
+  save.Deserialize(g_index[position]);
+
+  CFile::Delete(save.Path());
+
+  const std::string metadataPath = CSavestateUtils::MakeMetadataPath(save.GamePath());
+  if (CFile::Exists(metadataPath))
+    CFile::Delete(metadataPath);
+
+  if (!save.Thumbnail().empty())
+    CTextureCache::GetInstance().ClearCachedImage(save.Thumbnail(), true);
+
+  g_index.erase(position);
 }
 
 CFileItem* CSavestateDatabase::CreateFileItem(const CVariant& object) const
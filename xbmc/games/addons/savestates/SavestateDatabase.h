@@ -33,6 +33,14 @@ namespace GAME
 {
   class CSavestate;
 
+  /*!
+   * \brief Savestate metadata
+   *
+   * Next to each savestate its metadata is stored, which can be on slow
+   * storage together with the game. An index of all savestates in the profile
+   * is kept in sync with it, so savestates can be listed without touching the
+   * storage of the games. It is loaded once and shared by all instances.
+   */
   class CSavestateDatabase
   {
   public:
@@ -53,6 +61,12 @@ namespace GAME
 
   private:
     CFileItem* CreateFileItem(const CVariant& object) const;
+
+    /*!
+     * \brief Remove the files and the index entry of a savestate, the index
+     *        lock has to be held
+     */
+    void RemoveSavestate(unsigned int position);
   };
 }
 }
@@ -27,6 +27,7 @@
 #include "games/addons/savestates/SavestateDatabase.h"
 #include "games/addons/savestates/SavestateUtils.h"
 #include "games/addons/GameClient.h"
+#include "games/tags/GameInfoTag.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/LocalizeStrings.h"
@@ -51,19 +52,26 @@ std::string CGUIDialogSelectGameClient::ShowAndGetGameClient(const std::string &
   std::string extension = URIUtils::GetExtension(gamePath);
   std::string xmlPath = CSavestateUtils::MakeMetadataPath(gamePath);
 
-  // Load savestate
-  CSavestate save;
-  CSavestateDatabase db;
-  CLog::Log(LOGDEBUG, "Select game client dialog: Loading savestate metadata %s", CURL::GetRedacted(xmlPath).c_str());
-  const bool bLoaded = db.GetSavestate(xmlPath, save);
-
-  // Get savestate game client
+  // Get savestate game client, the index avoids reading the game's storage
   std::string saveGameClient;
-  if (bLoaded)
+  CSavestateDatabase db;
+  CFileItemList savestates;
+  if (db.GetSavestatesNav(savestates, gamePath) && !savestates.IsEmpty())
   {
-    saveGameClient = save.GameClient();
-    CLog::Log(LOGDEBUG, "Select game client dialog: Auto-selecting %s", saveGameClient.c_str());
+    savestates.Sort(SortByDate, SortOrderDescending);
+    saveGameClient = savestates[0]->GetGameInfoTag()->GetGameClient();
   }
+  else
+  {
+    // Load savestate
+    CSavestate save;
+    CLog::Log(LOGDEBUG, "Select game client dialog: Loading savestate metadata %s", CURL::GetRedacted(xmlPath).c_str());
+    if (db.GetSavestate(xmlPath, save))
+      saveGameClient = save.GameClient();
+  }
+
+  if (!saveGameClient.empty())
+    CLog::Log(LOGDEBUG, "Select game client dialog: Auto-selecting %s", saveGameClient.c_str());
 
   // "Select emulator for {0:s}"
   CGUIDialogSelect *dialog = GetDialog(StringUtils::Format(g_localizeStrings.Get(35258), extension));
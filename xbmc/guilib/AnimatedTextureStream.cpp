@@ -0,0 +1,182 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "AnimatedTextureStream.h"
+#include "FFmpegImage.h"
+#include "Texture.h"
+#include "threads/SingleLock.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+// frames decoded ahead of the one on screen
+#define ANIM_STREAM_FRAMES 3
+
+class CAnimatedTextureDecodeJob : public CJob
+{
+public:
+  explicit CAnimatedTextureDecodeJob(const std::shared_ptr<CAnimatedTextureStream> &stream)
+    : m_stream(stream)
+  {
+  }
+
+  const char *GetType() const override { return "animatedtexture"; }
+
+  bool DoWork() override
+  {
+    m_stream->Decode();
+    return true;
+  }
+
+private:
+  std::shared_ptr<CAnimatedTextureStream> m_stream;
+};
+
+CAnimatedTextureStream::CAnimatedTextureStream(const std::string &mimeType, std::vector<uint8_t> &&data, unsigned int frameCount, unsigned int shownFrame)
+  : m_mimeType(mimeType),
+    m_data(std::move(data)),
+    m_frameCount(std::max(frameCount, 1u)),
+    m_decoderFrame(0),
+    m_shownFrame(shownFrame),
+    m_queuedFrame((shownFrame + 1) % m_frameCount),
+    m_seekFrame(m_queuedFrame),
+    m_decoding(false)
+{
+}
+
+CAnimatedTextureStream::~CAnimatedTextureStream() = default;
+
+void CAnimatedTextureStream::ShowFrame(CBaseTexture *texture, unsigned int frame)
+{
+  if (!texture || frame >= m_frameCount)
+    return;
+
+  CSingleLock lock(m_section);
+  if (frame == m_shownFrame)
+    return;
+
+  auto it = std::find_if(m_frames.begin(), m_frames.end(), [frame](const DecodedFrame &decoded) { return decoded.index == frame; });
+  if (it == m_frames.end())
+  {
+    // if it's not the one being decoded the animation has been reset or
+    // skipped ahead, start over from the wanted frame
+    if (frame != m_queuedFrame)
+    {
+      m_frames.clear();
+      m_seekFrame = frame;
+      m_queuedFrame = frame;
+    }
+    StartDecoding();
+    return;
+  }
+
+  texture->Update(it->width, it->height, it->pitch, XB_FMT_A8R8G8B8, it->pixels.data(), false);
+  m_shownFrame = frame;
+  m_frames.erase(m_frames.begin(), it + 1);
+  StartDecoding();
+}
+
+void CAnimatedTextureStream::StartDecoding()
+{
+  // called with m_section held
+  if (m_decoding)
+    return;
+  m_decoding = true;
+  CJobManager::GetInstance().AddJob(new CAnimatedTextureDecodeJob(shared_from_this()), nullptr, CJob::PRIORITY_NORMAL);
+}
+
+bool CAnimatedTextureStream::Restart()
+{
+  m_decoder.reset(new CFFmpegImage(m_mimeType));
+  m_decoderFrame = 0;
+  if (!m_decoder->Initialize(m_data.data(), m_data.size()))
+  {
+    m_decoder.reset();
+    return false;
+  }
+  return true;
+}
+
+void CAnimatedTextureStream::Decode()
+{
+  for (;;)
+  {
+    int seekFrame;
+    {
+      CSingleLock lock(m_section);
+      if (m_seekFrame < 0 && m_frames.size() >= ANIM_STREAM_FRAMES)
+      {
+        m_decoding = false;
+        return;
+      }
+      seekFrame = m_seekFrame;
+      m_seekFrame = -1;
+    }
+
+    if (seekFrame >= 0 && (!m_decoder || m_decoderFrame > static_cast<unsigned int>(seekFrame)))
+    {
+      if (!Restart())
+        break;
+    }
+
+    // skip up to the wanted frame, they still have to be decoded to build up the picture
+    std::shared_ptr<Frame> frame = m_decoder ? m_decoder->ReadFrame() : nullptr;
+    while (frame && seekFrame >= 0 && m_decoderFrame < static_cast<unsigned int>(seekFrame))
+    {
+      m_decoderFrame++;
+      frame = m_decoder->ReadFrame();
+    }
+    if (!frame)
+    {
+      // end of the animation, continue from the start
+      if (!Restart())
+        break;
+      frame = m_decoder->ReadFrame();
+      if (!frame)
+        break;
+    }
+
+    DecodedFrame decoded;
+    decoded.index = m_decoderFrame++ % m_frameCount;
+    decoded.width = m_decoder->Width();
+    decoded.height = m_decoder->Height();
+    decoded.pitch = frame->GetPitch();
+    decoded.pixels.assign(frame->m_pImage, frame->m_pImage + decoded.pitch * decoded.height);
+
+    CSingleLock lock(m_section);
+    if (m_seekFrame >= 0)
+      continue; // reset while we were decoding
+    if (decoded.index != m_queuedFrame)
+    {
+      m_seekFrame = m_queuedFrame;
+      continue;
+    }
+    m_frames.push_back(std::move(decoded));
+    m_queuedFrame = (m_queuedFrame + 1) % m_frameCount;
+  }
+
+  CLog::Log(LOGERROR, "%s - unable to decode animated image", __FUNCTION__);
+  CSingleLock lock(m_section);
+  m_decoding = false;
+}
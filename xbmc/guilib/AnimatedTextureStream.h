@@ -0,0 +1,95 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+
+class CBaseTexture;
+class CFFmpegImage;
+
+/*!
+ \ingroup textures
+ \brief Decodes the frames of a long animated image while it plays.
+
+ Instead of holding every frame of the animation in memory and on the GPU, only
+ a few frames ahead of the one on screen are kept. They are decoded on the job
+ manager's workers and copied into a single texture when they are due.
+ */
+class CAnimatedTextureStream : public std::enable_shared_from_this<CAnimatedTextureStream>
+{
+public:
+  /*!
+   \param mimeType type of the image, as passed to CFFmpegImage.
+   \param data the encoded file, the stream keeps its own copy.
+   \param frameCount number of frames in the animation.
+   \param shownFrame the frame the texture has been loaded with.
+   */
+  CAnimatedTextureStream(const std::string &mimeType, std::vector<uint8_t> &&data, unsigned int frameCount, unsigned int shownFrame = 0);
+  ~CAnimatedTextureStream();
+
+  /*! \brief Make the texture show the given frame.
+   If the frame hasn't been decoded yet the texture keeps showing the previous one.
+   Only to be called from the rendering thread.
+   \param texture the texture the animation is shown in, owned by the caller.
+   \param frame the wanted frame.
+   */
+  void ShowFrame(CBaseTexture *texture, unsigned int frame);
+
+private:
+  CAnimatedTextureStream(const CAnimatedTextureStream&) = delete;
+  CAnimatedTextureStream& operator=(const CAnimatedTextureStream&) = delete;
+
+  friend class CAnimatedTextureDecodeJob;
+
+  struct DecodedFrame
+  {
+    unsigned int index;
+    unsigned int width;
+    unsigned int height;
+    unsigned int pitch;
+    std::vector<uint8_t> pixels;
+  };
+
+  void StartDecoding();
+  void Decode();
+  bool Restart();
+
+  std::string m_mimeType;
+  std::vector<uint8_t> m_data;
+  unsigned int m_frameCount;
+
+  // only used by the decoding job
+  std::unique_ptr<CFFmpegImage> m_decoder;
+  unsigned int m_decoderFrame;
+
+  CCriticalSection m_section;
+  std::deque<DecodedFrame> m_frames;  // decoded frames following the one on screen, in playing order
+  unsigned int m_shownFrame;
+  unsigned int m_queuedFrame;         // frame the decoder is going to queue next
+  int m_seekFrame;                    // frame the decoder has to restart from, -1 if none
+  bool m_decoding;
+};
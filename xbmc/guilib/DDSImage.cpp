@@ -22,6 +22,8 @@
 #include "DDSImage.h"
 #include "XBTF.h"
 #include "utils/log.h"
+#include <climits>
+#include <cstdlib>
 #include <string.h>
 
 #ifndef NO_XBMC_FILESYSTEM
@@ -31,6 +33,164 @@ using namespace XFILE;
 #include "SimpleFS.h"
 #endif
 
+namespace
+{
+uint16_t To565(const int rgb[3])
+{
+  return static_cast<uint16_t>(((rgb[0] * 31 + 127) / 255) << 11 |
+                               ((rgb[1] * 63 + 127) / 255) << 5 |
+                               ((rgb[2] * 31 + 127) / 255));
+}
+
+void From565(uint16_t color, int rgb[3])
+{
+  rgb[0] = (color >> 11) & 31;
+  rgb[1] = (color >> 5) & 63;
+  rgb[2] = color & 31;
+  rgb[0] = (rgb[0] << 3) | (rgb[0] >> 2);
+  rgb[1] = (rgb[1] << 2) | (rgb[1] >> 4);
+  rgb[2] = (rgb[2] << 3) | (rgb[2] >> 2);
+}
+
+// fetch a 4x4 block of pixels, repeating the last row/column for blocks at the edge
+void GetBlock(const unsigned char *bgra, unsigned int width, unsigned int height, unsigned int pitch,
+              unsigned int x, unsigned int y, unsigned char block[16][4])
+{
+  for (unsigned int j = 0; j < 4; j++)
+  {
+    const unsigned char *row = bgra + std::min(y + j, height - 1) * pitch;
+    for (unsigned int i = 0; i < 4; i++)
+      memcpy(block[j * 4 + i], row + std::min(x + i, width - 1) * 4, 4);
+  }
+}
+
+// DXT1 colour block. The end points are the corners of the (slightly inset) bounding box
+// of the block's colours, using the diagonal that follows the trend of the colours.
+void CompressColorBlock(const unsigned char block[16][4], unsigned char *dest)
+{
+  int minColor[3] = { 255, 255, 255 };
+  int maxColor[3] = { 0, 0, 0 };
+  int mean[3] = { 0, 0, 0 };
+  for (unsigned int i = 0; i < 16; i++)
+  {
+    for (unsigned int c = 0; c < 3; c++)
+    {
+      int value = block[i][2 - c]; // BGRA -> RGB
+      minColor[c] = std::min(minColor[c], value);
+      maxColor[c] = std::max(maxColor[c], value);
+      mean[c] += value;
+    }
+  }
+  for (unsigned int c = 0; c < 3; c++)
+  {
+    int inset = (maxColor[c] - minColor[c]) >> 4;
+    minColor[c] += inset;
+    maxColor[c] -= inset;
+    mean[c] = (mean[c] + 8) / 16;
+  }
+
+  int covRG = 0, covBG = 0;
+  for (unsigned int i = 0; i < 16; i++)
+  {
+    int g = block[i][1] - mean[1];
+    covRG += (block[i][2] - mean[0]) * g;
+    covBG += (block[i][0] - mean[2]) * g;
+  }
+  if (covRG < 0)
+    std::swap(minColor[0], maxColor[0]);
+  if (covBG < 0)
+    std::swap(minColor[2], maxColor[2]);
+
+  uint16_t color0 = To565(maxColor);
+  uint16_t color1 = To565(minColor);
+  uint32_t indices = 0;
+  if (color0 != color1)
+  {
+    // color0 > color1 selects the four colour mode
+    if (color0 < color1)
+      std::swap(color0, color1);
+
+    int palette[4][3];
+    From565(color0, palette[0]);
+    From565(color1, palette[1]);
+    for (unsigned int c = 0; c < 3; c++)
+    {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    for (unsigned int i = 0; i < 16; i++)
+    {
+      unsigned int best = 0;
+      int bestError = INT_MAX;
+      for (unsigned int p = 0; p < 4; p++)
+      {
+        int dr = block[i][2] - palette[p][0];
+        int dg = block[i][1] - palette[p][1];
+        int db = block[i][0] - palette[p][2];
+        int error = dr * dr + dg * dg + db * db;
+        if (error < bestError)
+        {
+          bestError = error;
+          best = p;
+        }
+      }
+      indices |= best << (2 * i);
+    }
+  }
+
+  dest[0] = color0 & 0xff;
+  dest[1] = color0 >> 8;
+  dest[2] = color1 & 0xff;
+  dest[3] = color1 >> 8;
+  for (unsigned int i = 0; i < 4; i++)
+    dest[4 + i] = (indices >> (8 * i)) & 0xff;
+}
+
+// DXT5 alpha block, interpolating 8 levels between the lowest and highest alpha
+void CompressAlphaBlock(const unsigned char block[16][4], unsigned char *dest)
+{
+  int minAlpha = 255;
+  int maxAlpha = 0;
+  for (unsigned int i = 0; i < 16; i++)
+  {
+    minAlpha = std::min(minAlpha, static_cast<int>(block[i][3]));
+    maxAlpha = std::max(maxAlpha, static_cast<int>(block[i][3]));
+  }
+
+  uint64_t indices = 0;
+  if (maxAlpha > minAlpha)
+  {
+    int palette[8];
+    palette[0] = maxAlpha;
+    palette[1] = minAlpha;
+    for (int p = 1; p < 7; p++)
+      palette[p + 1] = ((7 - p) * maxAlpha + p * minAlpha) / 7;
+
+    for (unsigned int i = 0; i < 16; i++)
+    {
+      unsigned int best = 0;
+      int bestError = INT_MAX;
+      for (unsigned int p = 0; p < 8; p++)
+      {
+        int error = std::abs(block[i][3] - palette[p]);
+        if (error < bestError)
+        {
+          bestError = error;
+          best = p;
+        }
+      }
+      indices |= static_cast<uint64_t>(best) << (3 * i);
+    }
+  }
+
+  dest[0] = static_cast<unsigned char>(maxAlpha);
+  dest[1] = static_cast<unsigned char>(minAlpha);
+  for (unsigned int i = 0; i < 6; i++)
+    dest[2 + i] = (indices >> (8 * i)) & 0xff;
+}
+}
+
 CDDSImage::CDDSImage()
 {
   m_data = NULL;
@@ -115,6 +275,71 @@ bool CDDSImage::ReadFile(const std::string &inputFile)
   return true;
 }
 
+bool CDDSImage::Create(const std::string &outputFile, unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *bgra)
+{
+  if (!bgra || !width || !height)
+    return false;
+
+  bool hasAlpha = false;
+  for (unsigned int y = 0; y < height && !hasAlpha; y++)
+  {
+    const unsigned char *row = bgra + y * pitch;
+    for (unsigned int x = 0; x < width; x++)
+    {
+      if (row[x * 4 + 3] != 0xff)
+      {
+        hasAlpha = true;
+        break;
+      }
+    }
+  }
+
+  Allocate(width, height, hasAlpha ? XB_FMT_DXT5 : XB_FMT_DXT1);
+  if (!m_data)
+    return false;
+
+  Compress(width, height, pitch, bgra);
+  return WriteFile(outputFile);
+}
+
+void CDDSImage::Compress(unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *bgra)
+{
+  bool hasAlpha = GetFormat() == XB_FMT_DXT5;
+  unsigned char *dest = m_data;
+  unsigned char block[16][4];
+  for (unsigned int y = 0; y < height; y += 4)
+  {
+    for (unsigned int x = 0; x < width; x += 4)
+    {
+      GetBlock(bgra, width, height, pitch, x, y, block);
+      if (hasAlpha)
+      {
+        CompressAlphaBlock(block, dest);
+        dest += 8;
+      }
+      CompressColorBlock(block, dest);
+      dest += 8;
+    }
+  }
+}
+
+bool CDDSImage::WriteFile(const std::string &outputFile) const
+{
+  CFile file;
+  if (!file.OpenForWrite(outputFile, true))
+    return false;
+
+  bool success = file.Write("DDS ", 4) == 4 &&
+                 file.Write(&m_desc, sizeof(m_desc)) == static_cast<ssize_t>(sizeof(m_desc)) &&
+                 file.Write(m_data, m_desc.linearSize) == static_cast<ssize_t>(m_desc.linearSize);
+  file.Close();
+#ifndef NO_XBMC_FILESYSTEM
+  if (!success)
+    CFile::Delete(outputFile); // don't leave a truncated file behind
+#endif
+  return success;
+}
+
 unsigned int CDDSImage::GetStorageRequirements(unsigned int width, unsigned int height, unsigned int format)
 {
   switch (format)
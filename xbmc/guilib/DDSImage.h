@@ -38,8 +38,21 @@ public:
 
   bool ReadFile(const std::string &file);
 
+  /*! \brief Compress an image to DXT and write it out as a .dds file.
+   Opaque images are stored as DXT1, images with an alpha channel as DXT5.
+   \param outputFile the file to write.
+   \param width width of the image.
+   \param height height of the image.
+   \param pitch number of bytes between rows of the image.
+   \param bgra the image in XB_FMT_A8R8G8B8 format.
+   \return true if the file was written.
+   */
+  bool Create(const std::string &outputFile, unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *bgra);
+
 private:
   void Allocate(unsigned int width, unsigned int height, unsigned int format);
+  void Compress(unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *bgra);
+  bool WriteFile(const std::string &file) const;
   static const char *GetFourCC(unsigned int format);
 
   static unsigned int GetStorageRequirements(unsigned int width, unsigned int height, unsigned int format);
@@ -161,7 +161,9 @@ CFFmpegImage::~CFFmpegImage()
 bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSize,
                                       unsigned int width, unsigned int height)
 {
-    
+  m_targetWidth = width;
+  m_targetHeight = height;
+
   if (!Initialize(buffer, bufSize))
   {
     //log
@@ -269,6 +271,19 @@ bool CFFmpegImage::Initialize(unsigned char* buffer, unsigned int bufSize)
     return false;
   }
 
+  // the jpeg decoder can reduce the image by 1/2, 1/4 or 1/8 while decoding, which is
+  // much cheaper than decoding the full image and scaling it down afterwards
+  if (m_targetWidth && m_targetHeight && codec->max_lowres > 0 &&
+      codec_params->width > 0 && codec_params->height > 0)
+  {
+    float scale = std::min(static_cast<float>(m_targetWidth) / codec_params->width,
+                           static_cast<float>(m_targetHeight) / codec_params->height);
+    int lowres = 0;
+    while (lowres < codec->max_lowres && (1 << (lowres + 1)) * scale <= 1.0f)
+      lowres++;
+    m_codec_ctx->lowres = lowres;
+  }
+
   if (avcodec_open2(m_codec_ctx, codec, NULL) < 0)
   {
     avformat_close_input(&m_fctx);
@@ -313,8 +328,9 @@ AVFrame* CFFmpegImage::ExtractFrame()
   frame->pkt_duration = av_rescale_q(frame->pkt_duration, m_fctx->streams[0]->time_base, AVRational{ 1, 1000 });
   m_height = frame->height;
   m_width = frame->width;
-  m_originalWidth = m_width;
-  m_originalHeight = m_height;
+  // the frame is smaller than the image if it was reduced while decoding
+  m_originalWidth = std::max(m_width, static_cast<unsigned int>(m_fctx->streams[0]->codecpar->width));
+  m_originalHeight = std::max(m_height, static_cast<unsigned int>(m_fctx->streams[0]->codecpar->height));
 
   const AVPixFmtDescriptor* pixDescriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
   if (pixDescriptor && ((pixDescriptor->flags & (AV_PIX_FMT_FLAG_ALPHA | AV_PIX_FMT_FLAG_PAL)) != 0))
@@ -488,8 +504,8 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
 
   // assumption quadratic maximums e.g. 2048x2048
   float ratio = m_width / (float)m_height;
-  unsigned int nHeight = m_originalHeight;
-  unsigned int nWidth = m_originalWidth;
+  unsigned int nHeight = frame->height;
+  unsigned int nWidth = frame->width;
   if (nHeight > height)
   {
     nHeight = height;
@@ -501,7 +517,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     nHeight = (unsigned int)(nWidth / ratio + 0.5f);
   }
 
-  struct SwsContext* context = sws_getContext(m_originalWidth, m_originalHeight, pixFormat,
+  struct SwsContext* context = sws_getContext(frame->width, frame->height, pixFormat,
     nWidth, nHeight, AV_PIX_FMT_RGB32, SWS_BICUBIC, NULL, NULL, NULL);
 
   if (range == AVCOL_RANGE_JPEG)
@@ -514,7 +530,7 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     sws_setColorspaceDetails(context, inv_table, srcRange, table, dstRange, brightness, contrast, saturation);
   }
 
-  sws_scale(context, frame->data, frame->linesize, 0, m_originalHeight,
+  sws_scale(context, frame->data, frame->linesize, 0, frame->height,
     pictureRGB->data, pictureRGB->linesize);
   sws_freeContext(context);
 
@@ -104,4 +104,9 @@ private:
 
   AVFrame* m_pFrame;
   uint8_t* m_outputBuffer;
+
+  // size the image is going to be scaled down to, decoders able to scale while
+  // decoding (jpeg) use it to skip work on detail that would be thrown away
+  unsigned int m_targetWidth = 0;
+  unsigned int m_targetHeight = 0;
 };
@@ -40,6 +40,7 @@
 #define HOLD_TIME_END   3000
 #define SCROLLING_GAP   200U
 #define SCROLLING_THRESHOLD 300U
+#define MAX_POOLED_LAYOUTS  128   // layouts kept for reuse, per pool
 
 CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, float posY, float width, float height, ORIENTATION orientation, const CScroller& scroller, int preloadItems)
     : IGUIContainer(parentID, controlID, posX, posY, width, height)
@@ -156,6 +157,9 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
 {
   if (!m_focusedLayout || !m_layout) return;
 
+  // clip to our bounds so that images of cached items outside of the view are loaded last
+  bool clipped = CServiceBroker::GetWinSystem()->GetGfxContext().SetClipRegion(m_posX, m_posY, m_width, m_height);
+
   // set the origin
   CServiceBroker::GetWinSystem()->GetGfxContext().SetOrigin(posX, posY);
 
@@ -165,7 +169,7 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
   {
     if (!item->GetFocusedLayout())
     {
-      item->SetFocusedLayout(CGUIListItemLayoutPtr(new CGUIListItemLayout(*m_focusedLayout, this)));
+      item->SetFocusedLayout(CreateItemLayout(true));
     }
     if (item->GetFocusedLayout())
     {
@@ -191,9 +195,7 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
       item->GetFocusedLayout()->SetFocusedItem(0);  // focus is not set
     if (!item->GetLayout())
     {
-      CGUIListItemLayoutPtr layout(new CGUIListItemLayout(*m_layout));
-      layout->SetParentControl(this);
-      item->SetLayout(std::move(layout));
+      item->SetLayout(CreateItemLayout(false));
     }
     if (item->GetFocusedLayout())
       item->GetFocusedLayout()->Process(item.get(), m_parentID, currentTime, dirtyregions);
@@ -202,6 +204,8 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
   }
 
   CServiceBroker::GetWinSystem()->GetGfxContext().RestoreOrigin();
+  if (clipped)
+    CServiceBroker::GetWinSystem()->GetGfxContext().RestoreClipRegion();
 }
 
 void CGUIBaseContainer::Render()
@@ -866,6 +870,7 @@ void CGUIBaseContainer::AllocResources()
 void CGUIBaseContainer::FreeResources(bool immediately)
 {
   CGUIControl::FreeResources(immediately);
+  ClearLayoutPool();
   if (m_listProvider)
   {
     if (immediately)
@@ -883,6 +888,7 @@ void CGUIBaseContainer::UpdateLayout(bool updateAllItems)
   { // free memory of items
     for (iItems it = m_items.begin(); it != m_items.end(); ++it)
       (*it)->FreeMemory();
+    ClearLayoutPool();
   }
   // and recalculate the layout
   CalculateLayout();
@@ -1004,6 +1010,9 @@ void CGUIBaseContainer::CalculateLayout()
   if (oldLayout == m_layout && oldFocusedLayout == m_focusedLayout)
     return; // nothing has changed, so don't update stuff
 
+  // pooled layouts are copies of the old templates
+  ClearLayoutPool();
+
   m_itemsPerPage = std::max((int)((Size() - m_focusedLayout->Size(m_orientation)) / m_layout->Size(m_orientation)) + 1, 1);
 
   // ensure that the scroll offset is a multiple of our size
@@ -1189,15 +1198,50 @@ void CGUIBaseContainer::FreeMemory(int keepStart, int keepEnd)
   if (keepStart < keepEnd)
   { // remove before keepStart and after keepEnd
     for (int i = 0; i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+      RecycleItemLayouts(m_items[i].get());
     for (int i = std::max(keepEnd + 1, 0); i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+      RecycleItemLayouts(m_items[i].get());
   }
   else
   { // wrapping
     for (int i = std::max(keepEnd + 1, 0); i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+      RecycleItemLayouts(m_items[i].get());
+  }
+}
+
+CGUIListItemLayoutPtr CGUIBaseContainer::CreateItemLayout(bool focused)
+{
+  std::vector<CGUIListItemLayoutPtr> &pool = focused ? m_layoutPool.focusedLayouts : m_layoutPool.layouts;
+  const CGUIListItemLayout *from = focused ? m_focusedLayout : m_layout;
+  if (!pool.empty())
+  {
+    // copying the template clones every control in it, so reuse a layout
+    // from an item that has scrolled out of view instead
+    CGUIListItemLayoutPtr layout = std::move(pool.back());
+    pool.pop_back();
+    layout->Recycle();
+    return layout;
   }
+  return CGUIListItemLayoutPtr(new CGUIListItemLayout(*from, this));
+}
+
+void CGUIBaseContainer::RecycleItemLayouts(CGUIListItem *item)
+{
+  if (!item->GetLayout() && !item->GetFocusedLayout())
+    return;
+
+  CGUIListItemLayoutPtr layout, focusedLayout;
+  item->ReleaseLayouts(layout, focusedLayout);
+  if (layout && m_layoutPool.layouts.size() < MAX_POOLED_LAYOUTS)
+    m_layoutPool.layouts.push_back(std::move(layout));
+  if (focusedLayout && m_layoutPool.focusedLayouts.size() < MAX_POOLED_LAYOUTS)
+    m_layoutPool.focusedLayouts.push_back(std::move(focusedLayout));
+}
+
+void CGUIBaseContainer::ClearLayoutPool()
+{
+  m_layoutPool.layouts.clear();
+  m_layoutPool.focusedLayouts.clear();
 }
 
 bool CGUIBaseContainer::InsideLayout(const CGUIListItemLayout *layout, const CPoint &point) const
@@ -25,9 +25,10 @@
  *
  */
 
+#include <list>
+#include <memory>
 #include <utility>
 #include <vector>
-#include <list>
 
 #include "IGUIContainer.h"
 #include "GUIAction.h"
@@ -41,6 +42,7 @@
 class IListProvider;
 class TiXmlNode;
 class CGUIListItemLayout;
+using CGUIListItemLayoutPtr = std::unique_ptr<CGUIListItemLayout>;
 
 class CGUIBaseContainer : public IGUIContainer
 {
@@ -222,6 +224,24 @@ protected:
 private:
   bool OnContextMenu();
 
+  /*! \brief Get a layout for an item scrolling into view, reusing one from an item that scrolled out if possible */
+  CGUIListItemLayoutPtr CreateItemLayout(bool focused);
+  /*! \brief Free an item's layouts, keeping them for reuse by CreateItemLayout() */
+  void RecycleItemLayouts(CGUIListItem *item);
+  void ClearLayoutPool();
+
+  /*! \brief Layouts of items that scrolled out of view. Copies of a container start with an empty pool. */
+  struct CLayoutPool
+  {
+    CLayoutPool() = default;
+    CLayoutPool(const CLayoutPool&) {}
+    CLayoutPool& operator=(const CLayoutPool&) { return *this; }
+
+    std::vector<CGUIListItemLayoutPtr> layouts;         // unused copies of m_layout
+    std::vector<CGUIListItemLayoutPtr> focusedLayouts;  // unused copies of m_focusedLayout
+  };
+  CLayoutPool m_layoutPool;
+
   int m_cursor;
   int m_offset;
   int m_cacheItems;
@@ -19,6 +19,7 @@
  */
 
 #include "GUIComponent.h"
+#include "GUIFrameScheduler.h"
 #include "GUIInfoManager.h"
 #include "GUILargeTextureManager.h"
 #include "GUIWindowManager.h"
@@ -35,6 +36,7 @@ CGUIComponent::CGUIComponent()
   m_pLargeTextureManager.reset(new CGUILargeTextureManager());
   m_stereoscopicsManager.reset(new CStereoscopicsManager(CServiceBroker::GetSettings()));
   m_guiInfoManager.reset(new CGUIInfoManager());
+  m_frameScheduler.reset(new CGUIFrameScheduler());
 }
 
 CGUIComponent::~CGUIComponent()
@@ -86,6 +88,11 @@ CGUIInfoManager &CGUIComponent::GetInfoManager()
   return *m_guiInfoManager;
 }
 
+CGUIFrameScheduler &CGUIComponent::GetFrameScheduler()
+{
+  return *m_frameScheduler;
+}
+
 bool CGUIComponent::ConfirmDelete(std::string path)
 {
   CGUIDialogYesNo* pDialog = GetWindowManager().GetWindow<CGUIDialogYesNo>(WINDOW_DIALOG_YES_NO);
@@ -28,6 +28,7 @@ class CGUITextureManager;
 class CGUILargeTextureManager;
 class CStereoscopicsManager;
 class CGUIInfoManager;
+class CGUIFrameScheduler;
 
 class CGUIComponent
 {
@@ -42,6 +43,7 @@ public:
   CGUILargeTextureManager& GetLargeTextureManager();
   CStereoscopicsManager &GetStereoscopicsManager();
   CGUIInfoManager &GetInfoManager();
+  CGUIFrameScheduler &GetFrameScheduler();
 
   bool ConfirmDelete(std::string path);
 
@@ -52,4 +54,5 @@ protected:
   std::unique_ptr<CGUILargeTextureManager> m_pLargeTextureManager;
   std::unique_ptr<CStereoscopicsManager> m_stereoscopicsManager;
   std::unique_ptr<CGUIInfoManager> m_guiInfoManager;
+  std::unique_ptr<CGUIFrameScheduler> m_frameScheduler;
 };
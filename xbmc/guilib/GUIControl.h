@@ -94,6 +94,16 @@ public:
   virtual ~CGUIControl(void);
   virtual CGUIControl *Clone() const=0;
 
+  /*! \brief Update animations, conditions and layout before rendering.
+
+   Processing runs on the render thread with the graphic context locked, and
+   controls may rely on that: DoProcess pushes the control's transform and
+   camera onto the graphic context for its children, Process reads it back to
+   compute the render region, and visibility conditions, info labels and fonts
+   are shared between controls without locking of their own. Siblings can
+   therefore not be processed concurrently, and a control must not hand work
+   that touches any of these to another thread.
+   */
   virtual void DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregions);
   virtual void Process(unsigned int currentTime, CDirtyRegionList &dirtyregions);
   virtual void DoRender();
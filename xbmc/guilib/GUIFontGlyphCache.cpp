@@ -0,0 +1,205 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIFontGlyphCache.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/auto_buffer.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+#include <cinttypes>
+#include <cstring>
+
+#define GLYPH_CACHE_PATH     "special://temp/fontcache/"
+#define GLYPH_CACHE_MAGIC    0x4b474331 // "KGC1"
+#define GLYPH_CACHE_VERSION  1
+#define GLYPH_CACHE_MAX      8192       // don't grow the on-disk cache beyond this many glyphs
+
+namespace
+{
+struct GlyphHeader
+{
+  uint32_t letterAndStyle;
+  int16_t left;
+  int16_t top;
+  uint16_t width;
+  uint16_t rows;
+  int32_t advance;
+};
+}
+
+CCriticalSection CGUIFontGlyphCache::m_cachesSection;
+std::map<std::string, std::weak_ptr<CGUIFontGlyphCache>> CGUIFontGlyphCache::m_caches;
+
+CGUIFontGlyphCache::CGUIFontGlyphCache(const std::string &cacheFile)
+  : m_cacheFile(cacheFile)
+{
+}
+
+CGUIFontGlyphCache::~CGUIFontGlyphCache()
+{
+  if (m_dirty)
+    Save();
+}
+
+std::shared_ptr<CGUIFontGlyphCache> CGUIFontGlyphCache::Get(const std::string &fontFile, float size, float aspect, bool border)
+{
+  // the file's size and modification time are part of the key so that an
+  // updated font never picks up bitmaps rendered from an older version
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(fontFile, &st) != 0)
+    return nullptr;
+
+  std::string key = StringUtils::Format("%s|%" PRId64 "|%" PRId64 "|%.3f|%.3f|%d",
+                                        fontFile.c_str(), static_cast<int64_t>(st.st_size),
+                                        static_cast<int64_t>(st.st_mtime), size, aspect, border ? 1 : 0);
+
+  CSingleLock lock(m_cachesSection);
+  auto it = m_caches.find(key);
+  if (it != m_caches.end())
+  {
+    std::shared_ptr<CGUIFontGlyphCache> cache = it->second.lock();
+    if (cache)
+      return cache;
+  }
+
+  std::string cacheFile = StringUtils::Format(GLYPH_CACHE_PATH "%08x.glyphs", Crc32::Compute(key));
+  std::shared_ptr<CGUIFontGlyphCache> cache(new CGUIFontGlyphCache(cacheFile));
+  cache->Load();
+  m_caches[key] = cache;
+
+  // drop entries for caches that have since been released
+  for (auto i = m_caches.begin(); i != m_caches.end();)
+  {
+    if (i->second.expired())
+      i = m_caches.erase(i);
+    else
+      ++i;
+  }
+  return cache;
+}
+
+const CGUIFontGlyphCache::Glyph* CGUIFontGlyphCache::Find(uint32_t letterAndStyle) const
+{
+  CSingleLock lock(m_section);
+  auto it = m_glyphs.find(letterAndStyle);
+  if (it == m_glyphs.end())
+    return nullptr;
+  return &it->second;
+}
+
+const CGUIFontGlyphCache::Glyph* CGUIFontGlyphCache::Add(uint32_t letterAndStyle, Glyph &&glyph)
+{
+  CSingleLock lock(m_section);
+  auto result = m_glyphs.insert(std::make_pair(letterAndStyle, std::move(glyph)));
+  if (result.second && m_glyphs.size() <= GLYPH_CACHE_MAX)
+    m_dirty = true;
+  return &result.first->second;
+}
+
+void CGUIFontGlyphCache::Load()
+{
+  if (!XFILE::CFile::Exists(m_cacheFile))
+    return;
+
+  XUTILS::auto_buffer buffer;
+  XFILE::CFile file;
+  if (file.LoadFile(m_cacheFile, buffer) <= 0)
+    return;
+
+  const uint8_t *data = reinterpret_cast<const uint8_t*>(buffer.get());
+  const uint8_t *end = data + buffer.size();
+
+  uint32_t header[3];
+  if (end - data < static_cast<ptrdiff_t>(sizeof(header)))
+    return;
+  memcpy(header, data, sizeof(header));
+  data += sizeof(header);
+  if (header[0] != GLYPH_CACHE_MAGIC || header[1] != GLYPH_CACHE_VERSION)
+  {
+    CLog::Log(LOGDEBUG, "%s: ignoring incompatible glyph cache %s", __FUNCTION__, m_cacheFile.c_str());
+    return;
+  }
+
+  for (uint32_t i = 0; i < header[2]; i++)
+  {
+    GlyphHeader gh;
+    if (end - data < static_cast<ptrdiff_t>(sizeof(gh)))
+      break;
+    memcpy(&gh, data, sizeof(gh));
+    data += sizeof(gh);
+
+    size_t pixels = static_cast<size_t>(gh.width) * gh.rows;
+    if (static_cast<size_t>(end - data) < pixels)
+      break;
+
+    Glyph glyph;
+    glyph.left = gh.left;
+    glyph.top = gh.top;
+    glyph.width = gh.width;
+    glyph.rows = gh.rows;
+    glyph.advance = gh.advance;
+    glyph.pixels.assign(data, data + pixels);
+    data += pixels;
+
+    m_glyphs.insert(std::make_pair(gh.letterAndStyle, std::move(glyph)));
+  }
+  CLog::Log(LOGDEBUG, "%s: loaded %u glyphs from %s", __FUNCTION__, static_cast<unsigned int>(m_glyphs.size()), m_cacheFile.c_str());
+}
+
+void CGUIFontGlyphCache::Save() const
+{
+  CSingleLock lock(m_section);
+
+  std::vector<uint8_t> buffer;
+  uint32_t count = 0;
+  buffer.resize(3 * sizeof(uint32_t));
+  for (const auto &it : m_glyphs)
+  {
+    if (count >= GLYPH_CACHE_MAX)
+      break;
+    const Glyph &glyph = it.second;
+    GlyphHeader gh = { it.first, glyph.left, glyph.top, glyph.width, glyph.rows, glyph.advance };
+    const uint8_t *ghData = reinterpret_cast<const uint8_t*>(&gh);
+    buffer.insert(buffer.end(), ghData, ghData + sizeof(gh));
+    buffer.insert(buffer.end(), glyph.pixels.begin(), glyph.pixels.end());
+    count++;
+  }
+  uint32_t header[3] = { GLYPH_CACHE_MAGIC, GLYPH_CACHE_VERSION, count };
+  memcpy(buffer.data(), header, sizeof(header));
+
+  if (!XFILE::CDirectory::Exists(GLYPH_CACHE_PATH))
+    XFILE::CDirectory::Create(GLYPH_CACHE_PATH);
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(m_cacheFile, true))
+  {
+    CLog::Log(LOGDEBUG, "%s: unable to write glyph cache %s", __FUNCTION__, m_cacheFile.c_str());
+    return;
+  }
+  if (file.Write(buffer.data(), buffer.size()) != static_cast<ssize_t>(buffer.size()))
+  {
+    file.Close();
+    XFILE::CFile::Delete(m_cacheFile);
+  }
+}
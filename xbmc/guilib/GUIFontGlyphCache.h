@@ -0,0 +1,88 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+
+/*!
+ \ingroup textures
+ \brief Persistent cache of rasterised glyph bitmaps for one font face at one size.
+
+ Glyphs rendered by FreeType are kept in memory keyed on letter and style, and
+ written to special://temp/fontcache/ when the last font using the cache goes
+ away. The next time the same face is loaded at the same size the bitmaps are
+ read back instead of being rasterised again.
+
+ Caches are shared between all fonts resolving to the same key (file, file size,
+ modification time, point size, aspect and border).
+ */
+class CGUIFontGlyphCache
+{
+public:
+  struct Glyph
+  {
+    int16_t left = 0;                  // bitmap offset from the pen position
+    int16_t top = 0;
+    uint16_t width = 0;                // bitmap size in pixels, rows are tightly packed
+    uint16_t rows = 0;
+    int32_t advance = 0;               // horizontal advance in 26.6 fixed point
+    std::vector<uint8_t> pixels;       // 8bit alpha
+  };
+
+  ~CGUIFontGlyphCache();
+
+  /*! \brief Get the cache for the given face and size, loading it from disk if needed.
+   \return the shared cache, or nullptr if the font file can't be identified.
+   */
+  static std::shared_ptr<CGUIFontGlyphCache> Get(const std::string &fontFile, float size, float aspect, bool border);
+
+  /*! \brief Look up a previously rasterised glyph.
+   \return the glyph, or nullptr if it isn't cached. The pointer remains valid for the lifetime of the cache.
+   */
+  const Glyph* Find(uint32_t letterAndStyle) const;
+
+  /*! \brief Store a freshly rasterised glyph.
+   \return the stored glyph. The pointer remains valid for the lifetime of the cache.
+   */
+  const Glyph* Add(uint32_t letterAndStyle, Glyph &&glyph);
+
+private:
+  explicit CGUIFontGlyphCache(const std::string &cacheFile);
+  CGUIFontGlyphCache(const CGUIFontGlyphCache&) = delete;
+  CGUIFontGlyphCache& operator=(const CGUIFontGlyphCache&) = delete;
+
+  void Load();
+  void Save() const;
+
+  std::string m_cacheFile;
+  std::map<uint32_t, Glyph> m_glyphs;
+  bool m_dirty = false;
+  mutable CCriticalSection m_section;
+
+  static CCriticalSection m_cachesSection;
+  static std::map<std::string, std::weak_ptr<CGUIFontGlyphCache>> m_caches;
+};
@@ -27,6 +27,7 @@
 #include "addons/FontResource.h"
 #include "GUIFontTTF.h"
 #include "GUIFont.h"
+#include "GUITextLayout.h"
 #include "utils/XMLUtils.h"
 #include "GUIControlFactory.h"
 #include "filesystem/Directory.h"
@@ -221,6 +222,7 @@ void GUIFontManager::ReloadTTFFonts(void)
   if (!m_vecFonts.size())
     return;   // we haven't even loaded fonts in yet
 
+  CGUITextLayout::ClearCache();
   for (unsigned int i = 0; i < m_vecFonts.size(); i++)
   {
     CGUIFont* font = m_vecFonts[i];
@@ -259,6 +261,7 @@ void GUIFontManager::Unload(const std::string& strFontName)
   {
     if (StringUtils::EqualsNoCase((*iFont)->GetFontName(), strFontName))
     {
+      CGUITextLayout::ClearCache();
       delete (*iFont);
       m_vecFonts.erase(iFont);
       return;
@@ -340,6 +343,7 @@ CGUIFont* GUIFontManager::GetDefaultFont(bool border)
 
 void GUIFontManager::Clear()
 {
+  CGUITextLayout::ClearCache();
   for (int i = 0; i < (int)m_vecFonts.size(); ++i)
   {
     CGUIFont* pFont = m_vecFonts[i];
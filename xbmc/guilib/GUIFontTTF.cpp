@@ -241,6 +241,9 @@ void CGUIFontTTFBase::Clear()
   if (m_face)
     g_freeTypeLibrary.ReleaseFont(m_face);
   m_face = NULL;
+
+  m_glyphCache.reset();
+
   if (m_stroker)
     g_freeTypeLibrary.ReleaseStroker(m_stroker);
   m_stroker = NULL;
@@ -261,6 +264,8 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
   if (!m_face)
     return false;
 
+  m_glyphCache = CGUIFontGlyphCache::Get(strFilename, height, aspect, border);
+
   /*
    the values used are described below
 
@@ -698,7 +703,7 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   return m_char + low;
 }
 
-bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
+bool CGUIFontTTFBase::RasterizeCharacter(wchar_t letter, uint32_t style, CGUIFontGlyphCache::Glyph &glyphOut)
 {
   int glyph_index = FT_Get_Char_Index( m_face, letter );
 
@@ -729,25 +734,70 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
   {
     CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, static_cast<uint32_t>(letter));
+    FT_Done_Glyph(glyph);
     return false;
   }
   FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
   FT_Bitmap bitmap = bitGlyph->bitmap;
+
+  glyphOut.left = static_cast<int16_t>(bitGlyph->left);
+  glyphOut.top = static_cast<int16_t>(bitGlyph->top);
+  glyphOut.width = static_cast<uint16_t>(bitmap.width);
+  glyphOut.rows = static_cast<uint16_t>(bitmap.rows);
+  glyphOut.advance = static_cast<int32_t>(m_face->glyph->advance.x);
+
+  // keep the rows tightly packed, independent of the pitch freetype chose
+  glyphOut.pixels.resize(static_cast<size_t>(glyphOut.width) * glyphOut.rows);
+  for (unsigned int y = 0; y < glyphOut.rows; y++)
+    memcpy(&glyphOut.pixels[y * glyphOut.width], bitmap.buffer + y * bitmap.pitch, glyphOut.width);
+
+  // free the glyph
+  FT_Done_Glyph(glyph);
+
+  return true;
+}
+
+bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
+{
+  character_t letterAndStyle = (style << 16) | letter;
+
+  // bitmaps rendered previously (possibly in an earlier run) don't need freetype at all
+  const CGUIFontGlyphCache::Glyph *glyph = m_glyphCache ? m_glyphCache->Find(letterAndStyle) : nullptr;
+  CGUIFontGlyphCache::Glyph rendered;
+  if (!glyph)
+  {
+    if (!RasterizeCharacter(letter, style, rendered))
+      return false;
+    glyph = m_glyphCache ? m_glyphCache->Add(letterAndStyle, std::move(rendered)) : &rendered;
+  }
+
+  // wrap the cached bitmap so the texture upload can treat it like a freetype one
+  FT_BitmapGlyphRec bitGlyph;
+  memset(&bitGlyph, 0, sizeof(bitGlyph));
+  bitGlyph.left = glyph->left;
+  bitGlyph.top = glyph->top;
+  bitGlyph.bitmap.width = glyph->width;
+  bitGlyph.bitmap.rows = glyph->rows;
+  bitGlyph.bitmap.pitch = glyph->width;
+  bitGlyph.bitmap.buffer = const_cast<unsigned char*>(glyph->pixels.data());
+  bitGlyph.bitmap.num_grays = 256;
+  bitGlyph.bitmap.pixel_mode = FT_PIXEL_MODE_GRAY;
+  const FT_Bitmap &bitmap = bitGlyph.bitmap;
   bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
 
   if (!isEmptyGlyph)
   {
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
+    if (bitGlyph.left < 0)
+      m_posX += -bitGlyph.left;
 
     // check we have enough room for the character.
     // cast-fest is here to avoid warnings due to freeetype version differences (signedness of width).
-    if (static_cast<int>(m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_textureWidth))
+    if (static_cast<int>(m_posX + bitGlyph.left + bitmap.width) > static_cast<int>(m_textureWidth))
     { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
       m_posX = 0;
       m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
+      if (bitGlyph.left < 0)
+        m_posX += -bitGlyph.left;
 
       if(m_posY + GetTextureLineHeight() >= m_textureHeight)
       {
@@ -757,7 +807,6 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
         if (newHeight > m_renderSystem->GetMaxTextureSize())
         {
           CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, m_renderSystem->GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
           return false;
         }
 
@@ -765,7 +814,6 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
         newTexture = ReallocTexture(newHeight);
         if(newTexture == NULL)
         {
-          FT_Done_Glyph(glyph);
           CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
           return false;
         }
@@ -775,20 +823,19 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
 
     if(m_texture == NULL)
     {
-      FT_Done_Glyph(glyph);
       CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
       return false;
     }
   }
   // set the character in our table
-  ch->letterAndStyle = (style << 16) | letter;
-  ch->offsetX = (short)bitGlyph->left;
-  ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
+  ch->letterAndStyle = letterAndStyle;
+  ch->offsetX = (short)bitGlyph.left;
+  ch->offsetY = (short)m_cellBaseLine - bitGlyph.top;
   ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
   ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->advance = (float)MathUtils::round_int( (float)glyph->advance / 64 );
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
@@ -798,15 +845,12 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
     unsigned int y1 = std::max(m_posY + ch->offsetY, 0);
     unsigned int x2 = std::min(x1 + bitmap.width, m_textureWidth);
     unsigned int y2 = std::min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
+    CopyCharToTexture(&bitGlyph, x1, y1, x2, y2);
   
     m_posX += spacing_between_characters_in_texture + (unsigned short)std::max(ch->right - ch->left + ch->offsetX, ch->advance);
   }
   m_numChars++;
 
-  // free the glyph
-  FT_Done_Glyph(glyph);
-
   return true;
 }
 
@@ -20,6 +20,7 @@
  *
  */
 
+#include <memory>
 #include <string>
 #include <stdint.h>
 #include <vector>
@@ -74,6 +75,7 @@ struct SVertex
 
 
 #include "GUIFontCache.h"
+#include "GUIFontGlyphCache.h"
 
 
 class CGUIFontTTFBase
@@ -124,6 +126,7 @@ protected:
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  bool RasterizeCharacter(wchar_t letter, uint32_t style, CGUIFontGlyphCache::Glyph &glyph);
   void RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
 
@@ -166,6 +169,8 @@ protected:
   FT_Face    m_face;
   FT_Stroker m_stroker;
 
+  std::shared_ptr<CGUIFontGlyphCache> m_glyphCache; // rasterised glyphs, shared and persisted across runs
+
   float m_originX;
   float m_originY;
 
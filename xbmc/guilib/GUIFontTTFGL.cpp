@@ -124,48 +124,6 @@ void CGUIFontTTFGL::LastEnd()
   GLint colLoc = renderSystem->ShaderGetCol();
   GLint tex0Loc = renderSystem->ShaderGetCoord0();
   GLint modelLoc = renderSystem->ShaderGetModel();
-
-  CreateStaticVertexBuffers();
-
-  // Enable the attributes used by this shader
-  glEnableVertexAttribArray(posLoc);
-  glEnableVertexAttribArray(colLoc);
-  glEnableVertexAttribArray(tex0Loc);
-
-  if (!m_vertex.empty())
-  {
-
-    // Deal with vertices that had to use software clipping
-    std::vector<SVertex> vecVertices(6 * (m_vertex.size() / 4));
-    SVertex *vertices = &vecVertices[0];
-    for (size_t i=0; i<m_vertex.size(); i+=4)
-    {
-      *vertices++ = m_vertex[i];
-      *vertices++ = m_vertex[i+1];
-      *vertices++ = m_vertex[i+2];
-
-      *vertices++ = m_vertex[i+1];
-      *vertices++ = m_vertex[i+3];
-      *vertices++ = m_vertex[i+2];
-    }
-    vertices = &vecVertices[0];
-
-    GLuint VertexVBO;
-
-    glGenBuffers(1, &VertexVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VertexVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(SVertex)*vecVertices.size(), &vecVertices[0], GL_STATIC_DRAW);
-
-    glVertexAttribPointer(posLoc, 3, GL_FLOAT, GL_FALSE, sizeof(SVertex), BUFFER_OFFSET(offsetof(SVertex, x)));
-    glVertexAttribPointer(colLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SVertex), BUFFER_OFFSET(offsetof(SVertex, r)));
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, GL_FALSE, sizeof(SVertex), BUFFER_OFFSET(offsetof(SVertex, u)));
-
-    glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glDeleteBuffers(1, &VertexVBO);
-  }
-
 #else
   // GLES 2.0 version.
   CRenderSystemGLES* renderSystem = dynamic_cast<CRenderSystemGLES*>(CServiceBroker::GetRenderSystem());
@@ -175,7 +133,7 @@ void CGUIFontTTFGL::LastEnd()
   GLint colLoc  = renderSystem->GUIShaderGetCol();
   GLint tex0Loc = renderSystem->GUIShaderGetCoord0();
   GLint modelLoc = renderSystem->GUIShaderGetModel();
-
+#endif
 
   CreateStaticVertexBuffers();
 
@@ -186,30 +144,38 @@ void CGUIFontTTFGL::LastEnd()
 
   if (!m_vertex.empty())
   {
-    // Deal with vertices that had to use software clipping
-    std::vector<SVertex> vecVertices( 6 * (m_vertex.size() / 4) );
-    SVertex *vertices = &vecVertices[0];
-
-    for (size_t i=0; i<m_vertex.size(); i+=4)
+    // Deal with vertices that had to use software clipping. These are kept in
+    // a buffer object owned by the font, and only re-uploaded when the text
+    // drawn this frame differs from what was drawn last frame.
+    if (m_vertexHandle == 0)
+      glGenBuffers(1, &m_vertexHandle);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexHandle);
+
+    if (m_vertex.size() != m_vertexUploaded.size() ||
+        memcmp(m_vertex.data(), m_vertexUploaded.data(), m_vertex.size() * sizeof(SVertex)) != 0)
     {
-      *vertices++ = m_vertex[i];
-      *vertices++ = m_vertex[i+1];
-      *vertices++ = m_vertex[i+2];
-
-      *vertices++ = m_vertex[i+1];
-      *vertices++ = m_vertex[i+3];
-      *vertices++ = m_vertex[i+2];
+      glBufferData(GL_ARRAY_BUFFER, sizeof(SVertex) * m_vertex.size(), m_vertex.data(), GL_DYNAMIC_DRAW);
+      m_vertexUploaded = m_vertex;
     }
 
-    vertices = &vecVertices[0];
+    // Use the shared quad index buffer rather than expanding each quad to two triangles
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementArrayHandle);
+
+    size_t quads = m_vertex.size() / 4;
+    for (size_t character = 0; quads > character; character += ELEMENT_ARRAY_MAX_CHAR_INDEX)
+    {
+      size_t count = std::min<size_t>(quads - character, ELEMENT_ARRAY_MAX_CHAR_INDEX);
+
+      glVertexAttribPointer(posLoc,  3, GL_FLOAT,         GL_FALSE, sizeof(SVertex), BUFFER_OFFSET(character*sizeof(SVertex)*4 + offsetof(SVertex, x)));
+      glVertexAttribPointer(colLoc,  4, GL_UNSIGNED_BYTE, GL_TRUE,  sizeof(SVertex), BUFFER_OFFSET(character*sizeof(SVertex)*4 + offsetof(SVertex, r)));
+      glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), BUFFER_OFFSET(character*sizeof(SVertex)*4 + offsetof(SVertex, u)));
 
-    glVertexAttribPointer(posLoc,  3, GL_FLOAT, GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, x));
-    glVertexAttribPointer(colLoc,  4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, r));
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,  GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, u));
+      glDrawElements(GL_TRIANGLES, 6 * count, GL_UNSIGNED_SHORT, 0);
+    }
 
-    glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
   }
-#endif
 
   if (!m_vertexTrans.empty())
   {
@@ -406,6 +372,13 @@ void CGUIFontTTFGL::DeleteHardwareTexture()
     m_textureStatus = TEXTURE_VOID;
     m_updateY1 = m_updateY2 = 0;
   }
+
+  if (m_vertexHandle != 0)
+  {
+    glDeleteBuffers(1, &m_vertexHandle);
+    m_vertexHandle = 0;
+  }
+  m_vertexUploaded.clear();
 }
 
 void CGUIFontTTFGL::CreateStaticVertexBuffers(void)
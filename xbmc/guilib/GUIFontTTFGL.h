@@ -61,6 +61,9 @@ private:
   
   TextureStatus m_textureStatus;
 
+  GLuint m_vertexHandle = 0;             // buffer object holding the software clipped vertices
+  std::vector<SVertex> m_vertexUploaded; // what m_vertexHandle currently holds
+
   static bool m_staticVertexBufferCreated;
 };
 
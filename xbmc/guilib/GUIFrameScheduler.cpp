@@ -0,0 +1,75 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIFrameScheduler.h"
+#include "ServiceBroker.h"
+#include "utils/TimeUtils.h"
+#include "windowing/GraphicContext.h"
+#include "windowing/WinSystem.h"
+
+// share of a display refresh that deferrable work may use
+#define DEFERRED_BUDGET   0.2
+// don't start deferrable work once this much of the refresh has passed
+#define DEFERRED_DEADLINE 0.6
+
+CGUIFrameScheduler::CGUIFrameScheduler()
+{
+  m_frameStart = CurrentHostCounter();
+  m_deferredTime = 0;
+  m_deferredCount = 0;
+}
+
+void CGUIFrameScheduler::BeginFrame()
+{
+  m_frameStart = CurrentHostCounter();
+  m_deferredTime = 0;
+  m_deferredCount = 0;
+}
+
+bool CGUIFrameScheduler::CanRunDeferred() const
+{
+  if (m_deferredCount == 0)
+    return true;
+
+  int64_t period = GetFramePeriod();
+  if (m_deferredTime >= static_cast<int64_t>(period * DEFERRED_BUDGET))
+    return false;
+
+  return CurrentHostCounter() - m_frameStart < static_cast<int64_t>(period * DEFERRED_DEADLINE);
+}
+
+void CGUIFrameScheduler::EndDeferred(int64_t start)
+{
+  m_deferredTime += CurrentHostCounter() - start;
+  m_deferredCount++;
+}
+
+int64_t CGUIFrameScheduler::GetFramePeriod() const
+{
+  float fps = 60.0f;
+  CWinSystemBase *winSystem = CServiceBroker::GetWinSystem();
+  if (winSystem)
+  {
+    float refresh = winSystem->GetGfxContext().GetFPS();
+    if (refresh > 0.0f)
+      fps = refresh;
+  }
+  return static_cast<int64_t>(CurrentHostFrequency() / fps);
+}
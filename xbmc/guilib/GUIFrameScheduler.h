@@ -0,0 +1,65 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*!
+ \ingroup textures
+ \brief Keeps track of the time spent in the current GUI frame.
+
+ The application marks the start of every frame right after presenting the
+ previous one. Work that doesn't have to happen in a particular frame (such as
+ uploading a freshly decoded image to the GPU) checks CanRunDeferred() first and
+ reports its cost through EndDeferred(), so that a burst of such work is spread
+ over several frames instead of stretching a single one.
+
+ Only to be used from the rendering thread.
+ */
+class CGUIFrameScheduler
+{
+public:
+  CGUIFrameScheduler();
+
+  /*! \brief Mark the start of a new frame.
+   */
+  void BeginFrame();
+
+  /*! \brief Check whether deferrable work may be done now.
+   The first piece of deferrable work in a frame is always allowed, so queued work keeps progressing.
+   \return true if there is budget left in this frame.
+   */
+  bool CanRunDeferred() const;
+
+  /*! \brief Account for deferrable work that has just finished.
+   \param start value of CurrentHostCounter() taken when the work started.
+   */
+  void EndDeferred(int64_t start);
+
+  /*! \brief Length of one display refresh in host counter ticks.
+   */
+  int64_t GetFramePeriod() const;
+
+private:
+  int64_t m_frameStart;
+  int64_t m_deferredTime;    // time spent on deferrable work this frame
+  unsigned int m_deferredCount;
+};
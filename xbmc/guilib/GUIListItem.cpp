@@ -20,17 +20,19 @@
 
 #include "GUIListItem.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "GUIListItemLayout.h"
 #include "utils/Archive.h"
 #include "utils/CharsetConverter.h"
+#include "utils/StringPool.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
-bool CGUIListItem::icompare::operator()(const std::string &s1, const std::string &s2) const
+static bool PropertyNameLess(const std::pair<const std::string*, CVariant> &property, const std::string &strKey)
 {
-  return StringUtils::CompareNoCase(s1, s2) < 0;
+  return StringUtils::CompareNoCase(*property.first, strKey) < 0;
 }
 
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
@@ -258,7 +260,7 @@ void CGUIListItem::Archive(CArchive &ar)
     ar << (int)m_mapProperties.size();
     for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); ++it)
     {
-      ar << it->first;
+      ar << *it->first;
       ar << it->second;
     }
     ar << (int)m_art.size();
@@ -327,7 +329,7 @@ void CGUIListItem::Serialize(CVariant &value)
 
   for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); ++it)
   {
-    value["properties"][it->first] = it->second;
+    value["properties"][*it->first] = it->second;
   }
   for (ArtMap::const_iterator it = m_art.begin(); it != m_art.end(); ++it)
     value["art"][it->first] = it->second;
@@ -355,6 +357,16 @@ void CGUIListItem::FreeMemory(bool immediately)
   }
 }
 
+void CGUIListItem::ReleaseLayouts(CGUIListItemLayoutPtr &layout, CGUIListItemLayoutPtr &focusedLayout)
+{
+  if (m_layout)
+    m_layout->FreeResources();
+  if (m_focusedLayout)
+    m_focusedLayout->FreeResources();
+  layout = std::move(m_layout);
+  focusedLayout = std::move(m_focusedLayout);
+}
+
 void CGUIListItem::SetLayout(CGUIListItemLayoutPtr layout)
 {
   m_layout = std::move(layout);
@@ -381,12 +393,28 @@ void CGUIListItem::SetInvalid()
   if (m_focusedLayout) m_focusedLayout->SetInvalid();
 }
 
+CGUIListItem::PropertyMap::iterator CGUIListItem::FindProperty(const std::string &strKey)
+{
+  PropertyMap::iterator iter = std::lower_bound(m_mapProperties.begin(), m_mapProperties.end(), strKey, PropertyNameLess);
+  if (iter != m_mapProperties.end() && StringUtils::EqualsNoCase(*iter->first, strKey))
+    return iter;
+  return m_mapProperties.end();
+}
+
+CGUIListItem::PropertyMap::const_iterator CGUIListItem::FindProperty(const std::string &strKey) const
+{
+  PropertyMap::const_iterator iter = std::lower_bound(m_mapProperties.begin(), m_mapProperties.end(), strKey, PropertyNameLess);
+  if (iter != m_mapProperties.end() && StringUtils::EqualsNoCase(*iter->first, strKey))
+    return iter;
+  return m_mapProperties.end();
+}
+
 void CGUIListItem::SetProperty(const std::string &strKey, const CVariant &value)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  PropertyMap::iterator iter = std::lower_bound(m_mapProperties.begin(), m_mapProperties.end(), strKey, PropertyNameLess);
+  if (iter == m_mapProperties.end() || !StringUtils::EqualsNoCase(*iter->first, strKey))
   {
-    m_mapProperties.insert(make_pair(strKey, value));
+    m_mapProperties.insert(iter, std::make_pair(&CStringPool::Get(strKey), value));
     SetInvalid();
   }
   else if (iter->second != value)
@@ -398,7 +426,7 @@ void CGUIListItem::SetProperty(const std::string &strKey, const CVariant &value)
 
 const CVariant &CGUIListItem::GetProperty(const std::string &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
+  PropertyMap::const_iterator iter = FindProperty(strKey);
   static CVariant nullVariant = CVariant(CVariant::VariantTypeNull);
   
   if (iter == m_mapProperties.end())
@@ -407,9 +435,14 @@ const CVariant &CGUIListItem::GetProperty(const std::string &strKey) const
   return iter->second;
 }
 
+bool CGUIListItem::HasProperties() const
+{
+  return !m_mapProperties.empty();
+}
+
 bool CGUIListItem::HasProperty(const std::string &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
+  PropertyMap::const_iterator iter = FindProperty(strKey);
   if (iter == m_mapProperties.end())
     return false;
 
@@ -418,7 +451,7 @@ bool CGUIListItem::HasProperty(const std::string &strKey) const
 
 void CGUIListItem::ClearProperty(const std::string &strKey)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
+  PropertyMap::iterator iter = FindProperty(strKey);
   if (iter != m_mapProperties.end())
   {
     m_mapProperties.erase(iter);
@@ -452,5 +485,5 @@ void CGUIListItem::IncrementProperty(const std::string &strKey, double dVal)
 void CGUIListItem::AppendProperties(const CGUIListItem &item)
 {
   for (PropertyMap::const_iterator i = item.m_mapProperties.begin(); i != item.m_mapProperties.end(); ++i)
-    SetProperty(i->first, i->second);
+    SetProperty(*i->first, i->second);
 }
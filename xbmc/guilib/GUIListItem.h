@@ -31,6 +31,8 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <utility>
+#include <vector>
 
 //  Forward
 class CGUIListItemLayout;
@@ -152,6 +154,11 @@ public:
 
   void FreeIcons();
   void FreeMemory(bool immediately = false);
+  /*! \brief Free the resources of the item's layouts and hand the layouts over for reuse
+   \param layout [out] the item's layout, if any
+   \param focusedLayout [out] the item's focused layout, if any
+   */
+  void ReleaseLayouts(CGUIListItemLayoutPtr &layout, CGUIListItemLayoutPtr &focusedLayout);
   void SetInvalid();
 
   bool m_bIsFolder;     ///< is item a folder or a file
@@ -174,7 +181,7 @@ public:
   void Serialize(CVariant& value);
 
   bool       HasProperty(const std::string &strKey) const;
-  bool       HasProperties() const { return !m_mapProperties.empty(); };
+  bool       HasProperties() const;
   void       ClearProperty(const std::string &strKey);
 
   const CVariant &GetProperty(const std::string &strKey) const;
@@ -188,14 +195,16 @@ protected:
   CGUIListItemLayoutPtr m_focusedLayout;
   bool m_bSelected;     // item is selected or not
 
-  struct icompare
-  {
-    bool operator()(const std::string &s1, const std::string &s2) const;
-  };
-
-  typedef std::map<std::string, CVariant, icompare> PropertyMap;
+  /*! \brief Properties by name, sorted case insensitively.
+   Items mostly have a few properties and the items of a list share their names, so
+   the names are pooled and kept along with the values in a vector rather than a map.
+   */
+  typedef std::vector<std::pair<const std::string*, CVariant>> PropertyMap;
   PropertyMap m_mapProperties;
 private:
+  PropertyMap::iterator FindProperty(const std::string &strKey);
+  PropertyMap::const_iterator FindProperty(const std::string &strKey) const;
+
   std::wstring m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
   std::string m_strLabel;      // text of column1
 
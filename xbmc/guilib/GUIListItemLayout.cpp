@@ -86,6 +86,13 @@ void CGUIListItemLayout::Process(CGUIListItem *item, int parentID, unsigned int
   m_group.DoProcess(currentTime, dirtyregions);
 }
 
+void CGUIListItemLayout::Recycle()
+{
+  m_group.ResetAnimations();
+  m_group.SetFocusedItem(0);
+  m_invalidated = true;
+}
+
 void CGUIListItemLayout::Render(CGUIListItem *item, int parentID)
 {
   m_group.DoRender();
@@ -42,6 +42,10 @@ public:
   bool IsAnimating(ANIMATION_TYPE animType);
   void ResetAnimation(ANIMATION_TYPE animType);
   void SetInvalid() { m_invalidated = true; };
+  /*! \brief Prepare a layout that was used for one item to be used for another.
+   Resources must have been freed beforehand.
+   */
+  void Recycle();
   void FreeResources(bool immediately = false);
   void SetParentControl(CGUIControl *control) { m_group.SetParentControl(control); };
 
@@ -171,6 +171,11 @@
  */
 #define GUI_MSG_STATE_CHANGED  51
 
+ /*!
+ \brief Items of the directory read in the background are waiting to be shown
+ */
+#define GUI_MSG_DIRECTORY_ITEMS  52
+
 
 #define GUI_MSG_USER         1000
 
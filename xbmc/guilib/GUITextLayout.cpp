@@ -22,9 +22,67 @@
 #include "GUIFont.h"
 #include "GUIControl.h"
 #include "GUIColorManager.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
 
+#include <list>
+#include <unordered_map>
+
+#define TEXT_LAYOUT_CACHE_SIZE 2000 // laid out texts shared by all controls
+
+namespace
+{
+/* Everything UpdateCommon() depends on. The text is the utf8 text given to
+   Update() or the raw bytes of the wide text given to UpdateW(). */
+struct CTextLayoutKey
+{
+  std::string text;
+  bool wide;
+  const CGUIFont *font;
+  float maxWidth;
+  float maxHeight;
+  bool wrap;
+  UTILS::Color textColor;
+  bool forceLTRReadingOrder;
+
+  bool operator==(const CTextLayoutKey &right) const
+  {
+    return font == right.font && maxWidth == right.maxWidth && maxHeight == right.maxHeight &&
+           wrap == right.wrap && textColor == right.textColor && wide == right.wide &&
+           forceLTRReadingOrder == right.forceLTRReadingOrder && text == right.text;
+  }
+};
+
+struct CTextLayoutKeyHash
+{
+  size_t operator()(const CTextLayoutKey &key) const
+  {
+    size_t hash = std::hash<std::string>()(key.text);
+    hash ^= std::hash<const void*>()(key.font) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<float>()(key.maxWidth) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+  }
+};
+
+struct CTextLayoutEntry
+{
+  CTextLayoutKey key;
+  std::vector<CGUIString> lines;
+  std::vector<UTILS::Color> colors;
+  float textWidth;
+  float textHeight;
+};
+
+typedef std::list<CTextLayoutEntry> TextLayoutList;
+
+/* least recently used first, the map points into the list */
+CCriticalSection g_textLayoutSection;
+TextLayoutList g_textLayouts;
+std::unordered_map<CTextLayoutKey, TextLayoutList::iterator, CTextLayoutKeyHash> g_textLayoutIndex;
+}
+
 CGUIString::CGUIString(iString start, iString end, bool carriageReturn)
 {
   m_text.assign(start, end);
@@ -219,9 +277,13 @@ bool CGUITextLayout::Update(const std::string &text, float maxWidth, bool forceU
 
   m_lastUtf8Text = text;
   m_lastUpdateW = false;
+  if (UpdateFromCache(text, false, maxWidth, forceLTRReadingOrder))
+    return true;
+
   std::wstring utf16;
   g_charsetConverter.utf8ToW(text, utf16, false);
   UpdateCommon(utf16, maxWidth, forceLTRReadingOrder);
+  AddToCache(text, false, maxWidth, forceLTRReadingOrder);
   return true;
 }
 
@@ -232,10 +294,62 @@ bool CGUITextLayout::UpdateW(const std::wstring &text, float maxWidth /*= 0*/, b
 
   m_lastText = text;
   m_lastUpdateW = true;
+  const std::string bytes(reinterpret_cast<const char*>(text.c_str()), text.size() * sizeof(wchar_t));
+  if (UpdateFromCache(bytes, true, maxWidth, forceLTRReadingOrder))
+    return true;
+
   UpdateCommon(text, maxWidth, forceLTRReadingOrder);
+  AddToCache(bytes, true, maxWidth, forceLTRReadingOrder);
   return true;
 }
 
+bool CGUITextLayout::UpdateFromCache(const std::string &text, bool wide, float maxWidth, bool forceLTRReadingOrder)
+{
+  const CTextLayoutKey key = { text, wide, m_font, maxWidth, m_maxHeight, m_wrap, m_textColor, forceLTRReadingOrder };
+
+  CSingleLock lock(g_textLayoutSection);
+  auto it = g_textLayoutIndex.find(key);
+  if (it == g_textLayoutIndex.end())
+    return false;
+
+  // most recently used goes to the back
+  g_textLayouts.splice(g_textLayouts.end(), g_textLayouts, it->second);
+  const CTextLayoutEntry &entry = *it->second;
+  m_lines = entry.lines;
+  m_colors = entry.colors;
+  m_textWidth = entry.textWidth;
+  m_textHeight = entry.textHeight;
+  return true;
+}
+
+void CGUITextLayout::AddToCache(const std::string &text, bool wide, float maxWidth, bool forceLTRReadingOrder) const
+{
+  if (!m_font)
+    return;
+
+  CTextLayoutEntry entry = { { text, wide, m_font, maxWidth, m_maxHeight, m_wrap, m_textColor, forceLTRReadingOrder },
+                             m_lines, m_colors, m_textWidth, m_textHeight };
+
+  CSingleLock lock(g_textLayoutSection);
+  if (g_textLayoutIndex.find(entry.key) != g_textLayoutIndex.end())
+    return;
+
+  if (g_textLayouts.size() >= TEXT_LAYOUT_CACHE_SIZE)
+  {
+    g_textLayoutIndex.erase(g_textLayouts.front().key);
+    g_textLayouts.pop_front();
+  }
+  g_textLayouts.push_back(std::move(entry));
+  g_textLayoutIndex.insert(std::make_pair(g_textLayouts.back().key, std::prev(g_textLayouts.end())));
+}
+
+void CGUITextLayout::ClearCache()
+{
+  CSingleLock lock(g_textLayoutSection);
+  g_textLayoutIndex.clear();
+  g_textLayouts.clear();
+}
+
 void CGUITextLayout::UpdateCommon(const std::wstring &text, float maxWidth, bool forceLTRReadingOrder)
 {
   // parse the text for style information
@@ -111,6 +111,12 @@ public:
   static void DrawText(CGUIFont *font, float x, float y, UTILS::Color color, UTILS::Color shadowColor, const std::string &text, uint32_t align);
   static void Filter(std::string &text);
 
+  /*! \brief Drop the laid out text shared by all layouts.
+   Has to be called whenever fonts are deleted or change their metrics, as the
+   cached layouts are keyed by font.
+   */
+  static void ClearCache();
+
 protected:
   void LineBreakText(const vecText &text, std::vector<CGUIString> &lines);
   void WrapText(const vecText &text, float maxWidth);
@@ -118,6 +124,8 @@ protected:
   static std::wstring BidiFlip(const std::wstring &text, bool forceLTRReadingOrder);
   void CalcTextExtent();
   void UpdateCommon(const std::wstring &text, float maxWidth, bool forceLTRReadingOrder);
+  bool UpdateFromCache(const std::string &text, bool wide, float maxWidth, bool forceLTRReadingOrder);
+  void AddToCache(const std::string &text, bool wide, float maxWidth, bool forceLTRReadingOrder) const;
   
   /*! \brief Returns the text, utf8 encoded
    \return utf8 text
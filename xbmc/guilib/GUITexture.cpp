@@ -248,6 +248,10 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
   int orientation = GetOrientation();
   OrientateTexture(texture, u3, v3, orientation);
 
+  // images packed into an atlas page sit at an offset within it
+  if (m_texture.m_texOffsetX || m_texture.m_texOffsetY)
+    texture += CPoint(m_texture.m_texOffsetX * m_texCoordsScaleU, m_texture.m_texOffsetY * m_texCoordsScaleV);
+
   if (m_diffuse.size())
   {
     // flip the texture as necessary.  Diffuse just gets flipped according to m_info.orientation.
@@ -256,6 +260,8 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
     diffuse.y1 *= m_diffuseScaleV / v3; diffuse.y2 *= m_diffuseScaleV / v3;
     diffuse += m_diffuseOffset;
     OrientateTexture(diffuse, m_diffuseU, m_diffuseV, m_info.orientation);
+    if (m_diffuse.m_texOffsetX || m_diffuse.m_texOffsetY)
+      diffuse += CPoint((float)m_diffuse.m_texOffsetX / m_diffuse.m_texWidth, (float)m_diffuse.m_texOffsetY / m_diffuse.m_texHeight);
   }
 
   float x[4], y[4], z[4];
@@ -312,7 +318,10 @@ bool CGUITextureBase::AllocResources()
     if (m_isAllocated != NORMAL)
     { // use our large image background loader
       CTextureArray texture;
-      if (CServiceBroker::GetGUI()->GetLargeTextureManager().GetImage(m_info.filename, texture, !IsAllocated(), m_use_cache))
+      // images outside of the current clip region (e.g. cached container items) are loaded last
+      CRect clip = CServiceBroker::GetWinSystem()->GetGfxContext().GetClipRegion();
+      bool inView = !clip.Intersect(CRect(m_posX, m_posY, m_posX + m_width, m_posY + m_height)).IsEmpty();
+      if (CServiceBroker::GetGUI()->GetLargeTextureManager().GetImage(m_info.filename, texture, !IsAllocated(), m_use_cache, inView))
       {
         m_isAllocated = LARGE;
 
@@ -40,7 +40,7 @@ CGUITextureD3D::~CGUITextureD3D()
 
 void CGUITextureD3D::Begin(UTILS::Color color)
 {
-  CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
+  CBaseTexture* texture = m_texture.GetFrame(m_currentFrame);
   texture->LoadToGPU();
 
   if (m_diffuse.size()) 
@@ -117,7 +117,7 @@ void CGUITextureD3D::Draw(float *x, float *y, float *z, const CRect &texture, co
   }
   verts[3].color = xcolor;
 
-  CDXTexture* tex = (CDXTexture *)m_texture.m_textures[m_currentFrame];
+  CDXTexture* tex = (CDXTexture *)m_texture.GetFrame(m_currentFrame);
   CGUIShaderDX* pGUIShader = DX::Windowing()->GetGUIShader();
 
   pGUIShader->Begin(m_diffuse.size() ? SHADER_METHOD_RENDER_MULTI_TEXTURE_BLEND : SHADER_METHOD_RENDER_TEXTURE_BLEND);
@@ -21,6 +21,7 @@
 #include "GUITextureGL.h"
 #include "ServiceBroker.h"
 #include "Texture.h"
+#include "TextureGL.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "utils/Geometry.h"
@@ -33,54 +34,112 @@ CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height,
 : CGUITextureBase(posX, posY, width, height, texture)
 {
   memset(m_col, 0, sizeof(m_col));
-  m_renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
 }
 
+CGUITextureGL::BatchState CGUITextureGL::m_batchState;
+std::vector<CGUITextureGL::PackedVertex> CGUITextureGL::m_batchVertices;
+std::vector<GLushort> CGUITextureGL::m_batchIdx;
+
 void CGUITextureGL::Begin(UTILS::Color color)
 {
-  CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
+  CBaseTexture* texture = m_texture.GetFrame(m_currentFrame);
   texture->LoadToGPU();
   if (m_diffuse.size())
     m_diffuse.m_textures[0]->LoadToGPU();
 
-  texture->BindToUnit(0);
-
   // Setup Colors
   m_col[0] = (GLubyte)GET_R(color);
   m_col[1] = (GLubyte)GET_G(color);
   m_col[2] = (GLubyte)GET_B(color);
   m_col[3] = (GLubyte)GET_A(color);
 
-  bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_col[3] < 255;
+  BatchState state;
+  state.texture = static_cast<CGLTexture*>(texture)->GetTextureObject();
+  state.diffuse = 0;
+  state.color = color;
+  state.blend = texture->HasAlpha() || m_col[3] < 255;
+  state.modview = glMatrixModview.Get();
+  state.project = glMatrixProject.Get();
 
   if (m_diffuse.size())
   {
     if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255 )
     {
-      m_renderSystem->EnableShader(SM_MULTI);
+      state.method = SM_MULTI;
     }
     else
     {
-      m_renderSystem->EnableShader(SM_MULTI_BLENDCOLOR);
+      state.method = SM_MULTI_BLENDCOLOR;
     }
 
-    hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
+    state.blend |= m_diffuse.m_textures[0]->HasAlpha();
 
-    m_diffuse.m_textures[0]->BindToUnit(1);
+    state.diffuse = static_cast<CGLTexture*>(m_diffuse.m_textures[0])->GetTextureObject();
   }
   else
   {
     if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255)
     {
-      m_renderSystem->EnableShader(SM_TEXTURE_NOBLEND);
+      state.method = SM_TEXTURE_NOBLEND;
     }
     else
     {
-      m_renderSystem->EnableShader(SM_TEXTURE);
+      state.method = SM_TEXTURE;
     }
   }
 
-  if (hasAlpha)
+  // quads are drawn when a texture with different state comes along or
+  // anything else is rendered, see CRenderSystemGL::FlushBatch
+  if (!m_batchVertices.empty() && !SameState(state, m_batchState))
+    Flush();
+  m_batchState = state;
+}
+
+void CGUITextureGL::End()
+{
+}
+
+bool CGUITextureGL::SameState(const BatchState &a, const BatchState &b)
+{
+  return a.texture == b.texture &&
+         a.diffuse == b.diffuse &&
+         a.method == b.method &&
+         a.color == b.color &&
+         a.blend == b.blend &&
+         memcmp(a.modview.m_pMatrix, b.modview.m_pMatrix, sizeof(a.modview.m_pMatrix)) == 0 &&
+         memcmp(a.project.m_pMatrix, b.project.m_pMatrix, sizeof(a.project.m_pMatrix)) == 0;
+}
+
+void CGUITextureGL::Flush()
+{
+  if (m_batchVertices.empty())
+    return;
+
+  // enabling the shader flushes the batch again, take the quads out first
+  std::vector<PackedVertex> vertices;
+  vertices.swap(m_batchVertices);
+
+  CRenderSystemGL *renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
+  const BatchState &state = m_batchState;
+
+  // the shader picks up the matrices the quads were queued with
+  glMatrixModview.Push();
+  glMatrixModview.Get() = state.modview;
+  glMatrixProject.Push();
+  glMatrixProject.Get() = state.project;
+  renderSystem->EnableShader(state.method);
+  glMatrixProject.Pop();
+  glMatrixModview.Pop();
+
+  if (state.diffuse)
+  {
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, state.diffuse);
+  }
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, state.texture);
+
+  if (state.blend)
   {
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
     glEnable(GL_BLEND);
@@ -89,65 +148,70 @@ void CGUITextureGL::Begin(UTILS::Color color)
   {
     glDisable(GL_BLEND);
   }
-  m_packedVertices.clear();
-  m_idx.clear();
-}
 
-void CGUITextureGL::End()
-{
-  if (m_packedVertices.size())
-  {
-    GLint posLoc  = m_renderSystem->ShaderGetPos();
-    GLint tex0Loc = m_renderSystem->ShaderGetCoord0();
-    GLint tex1Loc = m_renderSystem->ShaderGetCoord1();
-    GLint uniColLoc = m_renderSystem->ShaderGetUniCol();
+  GLint posLoc  = renderSystem->ShaderGetPos();
+  GLint tex0Loc = renderSystem->ShaderGetCoord0();
+  GLint tex1Loc = renderSystem->ShaderGetCoord1();
+  GLint uniColLoc = renderSystem->ShaderGetUniCol();
 
-    GLuint VertexVBO;
-    GLuint IndexVBO;
+  GLuint VertexVBO;
+  GLuint IndexVBO;
 
-    glGenBuffers(1, &VertexVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VertexVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex)*m_packedVertices.size(), &m_packedVertices[0], GL_STATIC_DRAW);
+  glGenBuffers(1, &VertexVBO);
+  glBindBuffer(GL_ARRAY_BUFFER, VertexVBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex)*vertices.size(), &vertices[0], GL_STATIC_DRAW);
 
-    if (uniColLoc >= 0)
-    {
-      glUniform4f(uniColLoc,(m_col[0] / 255.0f), (m_col[1] / 255.0f), (m_col[2] / 255.0f), (m_col[3] / 255.0f));
-    }
+  if (uniColLoc >= 0)
+  {
+    glUniform4f(uniColLoc, (GET_R(state.color) / 255.0f), (GET_G(state.color) / 255.0f), (GET_B(state.color) / 255.0f), (GET_A(state.color) / 255.0f));
+  }
 
-    if (m_diffuse.size())
-    {
-      glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u2)));
-      glEnableVertexAttribArray(tex1Loc);
-    }
+  if (state.diffuse)
+  {
+    glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u2)));
+    glEnableVertexAttribArray(tex1Loc);
+  }
 
-    glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, x)));
-    glEnableVertexAttribArray(posLoc);
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u1)));
-    glEnableVertexAttribArray(tex0Loc);
+  glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, x)));
+  glEnableVertexAttribArray(posLoc);
+  glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u1)));
+  glEnableVertexAttribArray(tex0Loc);
 
-    glGenBuffers(1, &IndexVBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexVBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ushort)*m_idx.size(), m_idx.data(), GL_STATIC_DRAW);
+  // indices only ever grow, quads of earlier batches index the same slots
+  for (size_t i = m_batchIdx.size() / 6 * 4; i < vertices.size(); i += 4)
+  {
+    m_batchIdx.push_back(i+0);
+    m_batchIdx.push_back(i+1);
+    m_batchIdx.push_back(i+2);
+    m_batchIdx.push_back(i+2);
+    m_batchIdx.push_back(i+3);
+    m_batchIdx.push_back(i+0);
+  }
 
-    glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, 0);
+  glGenBuffers(1, &IndexVBO);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexVBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort)*vertices.size()*6 / 4, m_batchIdx.data(), GL_STATIC_DRAW);
 
-    if (m_diffuse.size())
-      glDisableVertexAttribArray(tex1Loc);
+  glDrawElements(GL_TRIANGLES, vertices.size()*6 / 4, GL_UNSIGNED_SHORT, 0);
 
-    glDisableVertexAttribArray(posLoc);
-    glDisableVertexAttribArray(tex0Loc);
+  if (state.diffuse)
+    glDisableVertexAttribArray(tex1Loc);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glDeleteBuffers(1, &VertexVBO);
-    glDeleteBuffers(1, &IndexVBO);
-  }
+  glDisableVertexAttribArray(posLoc);
+  glDisableVertexAttribArray(tex0Loc);
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  glDeleteBuffers(1, &VertexVBO);
+  glDeleteBuffers(1, &IndexVBO);
 
-  if (m_diffuse.size())
-    glActiveTexture(GL_TEXTURE0);
   glEnable(GL_BLEND);
 
-  m_renderSystem->DisableShader();
+  renderSystem->DisableShader();
+
+  // keep the allocation for the next batch
+  vertices.clear();
+  m_batchVertices.swap(vertices);
 }
 
 void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
@@ -222,23 +286,16 @@ void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, con
     }
   }
 
+  // 16 bit indices
+  if (m_batchVertices.size() + 4 > 65536)
+    Flush();
+
   for (int i=0; i<4; i++)
   {
     vertices[i].x = x[i];
     vertices[i].y = y[i];
     vertices[i].z = z[i];
-    m_packedVertices.push_back(vertices[i]);
-  }
-
-  if ((m_packedVertices.size() / 4) > (m_idx.size() / 6))
-  {
-    size_t i = m_packedVertices.size() - 4;
-    m_idx.push_back(i+0);
-    m_idx.push_back(i+1);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+3);
-    m_idx.push_back(i+0);
+    m_batchVertices.push_back(vertices[i]);
   }
 }
 
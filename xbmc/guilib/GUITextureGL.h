@@ -23,9 +23,11 @@
 #include "system_gl.h"
 
 #include "GUITexture.h"
+#include "MatrixGLES.h"
+#include "rendering/gl/RenderSystemGL.h"
 #include "utils/Color.h"
 
-class CRenderSystemGL;
+#include <vector>
 
 class CGUITextureGL : public CGUITextureBase
 {
@@ -33,6 +35,12 @@ public:
   CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo& texture);
   static void DrawQuad(const CRect &coords, UTILS::Color color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
 
+  /*!
+   \brief Draw the quads queued by consecutive textures sharing textures,
+   shader, color and blending with a single draw call.
+   */
+  static void Flush();
+
 protected:
   void Begin(UTILS::Color color) override;
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation) override;
@@ -48,8 +56,20 @@ private:
     float u2, v2;
   };
 
-  std::vector<PackedVertex> m_packedVertices;
-  std::vector<GLushort> m_idx;
-  CRenderSystemGL *m_renderSystem;
-};
+  struct BatchState
+  {
+    GLuint texture;
+    GLuint diffuse;
+    ESHADERMETHOD method;
+    UTILS::Color color;
+    bool blend;
+    CMatrixGL modview;
+    CMatrixGL project;
+  };
+
+  static bool SameState(const BatchState &a, const BatchState &b);
 
+  static BatchState m_batchState;
+  static std::vector<PackedVertex> m_batchVertices;
+  static std::vector<GLushort> m_batchIdx;
+};
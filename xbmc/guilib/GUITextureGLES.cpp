@@ -34,18 +34,19 @@
 CGUITextureGLES::CGUITextureGLES(float posX, float posY, float width, float height, const CTextureInfo &texture)
 : CGUITextureBase(posX, posY, width, height, texture)
 {
-  m_renderSystem = dynamic_cast<CRenderSystemGLES*>(CServiceBroker::GetRenderSystem());
 }
 
+CGUITextureGLES::BatchState CGUITextureGLES::m_batchState;
+PackedVertices CGUITextureGLES::m_batchVertices;
+std::vector<GLushort> CGUITextureGLES::m_batchIdx;
+
 void CGUITextureGLES::Begin(UTILS::Color color)
 {
-  CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
+  CBaseTexture* texture = m_texture.GetFrame(m_currentFrame);
   texture->LoadToGPU();
   if (m_diffuse.size())
     m_diffuse.m_textures[0]->LoadToGPU();
 
-  texture->BindToUnit(0);
-
   // Setup Colors
   m_col[0] = (GLubyte)GET_R(color);
   m_col[1] = (GLubyte)GET_G(color);
@@ -59,37 +60,93 @@ void CGUITextureGLES::Begin(UTILS::Color color)
     m_col[2] = (235 - 16) * m_col[2] / 255 + 16;
   }
 
-  bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_col[3] < 255;
+  BatchState state;
+  state.texture = static_cast<CGLTexture*>(texture)->GetTextureObject();
+  state.diffuse = 0;
+  memcpy(state.col, m_col, sizeof(m_col));
+  state.blend = texture->HasAlpha() || m_col[3] < 255;
+  state.modview = glMatrixModview.Get();
+  state.project = glMatrixProject.Get();
 
   if (m_diffuse.size())
   {
     if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255 )
     {
-      m_renderSystem->EnableGUIShader(SM_MULTI);
+      state.method = SM_MULTI;
     }
     else
     {
-      m_renderSystem->EnableGUIShader(SM_MULTI_BLENDCOLOR);
+      state.method = SM_MULTI_BLENDCOLOR;
     }
 
-    hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
-
-    m_diffuse.m_textures[0]->BindToUnit(1);
+    state.blend |= m_diffuse.m_textures[0]->HasAlpha();
 
+    state.diffuse = static_cast<CGLTexture*>(m_diffuse.m_textures[0])->GetTextureObject();
   }
   else
   {
     if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255)
     {
-      m_renderSystem->EnableGUIShader(SM_TEXTURE_NOBLEND);
+      state.method = SM_TEXTURE_NOBLEND;
     }
     else
     {
-      m_renderSystem->EnableGUIShader(SM_TEXTURE);
+      state.method = SM_TEXTURE;
     }
   }
 
-  if ( hasAlpha )
+  // quads are drawn when a texture with different state comes along or
+  // anything else is rendered, see CRenderSystemGLES::FlushBatch
+  if (!m_batchVertices.empty() && !SameState(state, m_batchState))
+    Flush();
+  m_batchState = state;
+}
+
+void CGUITextureGLES::End()
+{
+}
+
+bool CGUITextureGLES::SameState(const BatchState &a, const BatchState &b)
+{
+  return a.texture == b.texture &&
+         a.diffuse == b.diffuse &&
+         a.method == b.method &&
+         memcmp(a.col, b.col, sizeof(a.col)) == 0 &&
+         a.blend == b.blend &&
+         memcmp(a.modview.m_pMatrix, b.modview.m_pMatrix, sizeof(a.modview.m_pMatrix)) == 0 &&
+         memcmp(a.project.m_pMatrix, b.project.m_pMatrix, sizeof(a.project.m_pMatrix)) == 0;
+}
+
+void CGUITextureGLES::Flush()
+{
+  if (m_batchVertices.empty())
+    return;
+
+  // enabling the shader flushes the batch again, take the quads out first
+  PackedVertices vertices;
+  vertices.swap(m_batchVertices);
+
+  CRenderSystemGLES *renderSystem = dynamic_cast<CRenderSystemGLES*>(CServiceBroker::GetRenderSystem());
+  const BatchState &state = m_batchState;
+
+  // the shader picks up the matrices the quads were queued with
+  glMatrixModview.Push();
+  glMatrixModview.Get() = state.modview;
+  glMatrixProject.Push();
+  glMatrixProject.Get() = state.project;
+  renderSystem->EnableGUIShader(state.method);
+  glMatrixProject.Pop();
+  glMatrixModview.Pop();
+
+  if (state.diffuse)
+  {
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, state.diffuse);
+  }
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, state.texture);
+
+  if (state.blend)
   {
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
     glEnable( GL_BLEND );
@@ -98,46 +155,52 @@ void CGUITextureGLES::Begin(UTILS::Color color)
   {
     glDisable(GL_BLEND);
   }
-  m_packedVertices.clear();
-}
 
-void CGUITextureGLES::End()
-{
-  if (m_packedVertices.size())
+  GLint posLoc  = renderSystem->GUIShaderGetPos();
+  GLint tex0Loc = renderSystem->GUIShaderGetCoord0();
+  GLint tex1Loc = renderSystem->GUIShaderGetCoord1();
+  GLint uniColLoc = renderSystem->GUIShaderGetUniCol();
+
+  if(uniColLoc >= 0)
   {
-    GLint posLoc  = m_renderSystem->GUIShaderGetPos();
-    GLint tex0Loc = m_renderSystem->GUIShaderGetCoord0();
-    GLint tex1Loc = m_renderSystem->GUIShaderGetCoord1();
-    GLint uniColLoc = m_renderSystem->GUIShaderGetUniCol();
+    glUniform4f(uniColLoc,(state.col[0] / 255.0f), (state.col[1] / 255.0f), (state.col[2] / 255.0f), (state.col[3] / 255.0f));
+  }
 
-    if(uniColLoc >= 0)
-    {
-      glUniform4f(uniColLoc,(m_col[0] / 255.0f), (m_col[1] / 255.0f), (m_col[2] / 255.0f), (m_col[3] / 255.0f));
-    }
+  if(state.diffuse)
+  {
+    glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&vertices[0] + offsetof(PackedVertex, u2));
+    glEnableVertexAttribArray(tex1Loc);
+  }
+  glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&vertices[0] + offsetof(PackedVertex, x));
+  glEnableVertexAttribArray(posLoc);
+  glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&vertices[0] + offsetof(PackedVertex, u1));
+  glEnableVertexAttribArray(tex0Loc);
 
-    if(m_diffuse.size())
-    {
-      glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, u2));
-      glEnableVertexAttribArray(tex1Loc);
-    }
-    glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, x));
-    glEnableVertexAttribArray(posLoc);
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, u1));
-    glEnableVertexAttribArray(tex0Loc);
+  // indices only ever grow, quads of earlier batches index the same slots
+  for (size_t i = m_batchIdx.size() / 6 * 4; i < vertices.size(); i += 4)
+  {
+    m_batchIdx.push_back(i+0);
+    m_batchIdx.push_back(i+1);
+    m_batchIdx.push_back(i+2);
+    m_batchIdx.push_back(i+2);
+    m_batchIdx.push_back(i+3);
+    m_batchIdx.push_back(i+0);
+  }
 
-    glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, m_idx.data());
+  glDrawElements(GL_TRIANGLES, vertices.size()*6 / 4, GL_UNSIGNED_SHORT, m_batchIdx.data());
 
-    if (m_diffuse.size())
-      glDisableVertexAttribArray(tex1Loc);
+  if (state.diffuse)
+    glDisableVertexAttribArray(tex1Loc);
 
-    glDisableVertexAttribArray(posLoc);
-    glDisableVertexAttribArray(tex0Loc);
-  }
+  glDisableVertexAttribArray(posLoc);
+  glDisableVertexAttribArray(tex0Loc);
 
-  if (m_diffuse.size())
-    glActiveTexture(GL_TEXTURE0);
   glEnable(GL_BLEND);
-  m_renderSystem->DisableGUIShader();
+  renderSystem->DisableGUIShader();
+
+  // keep the allocation for the next batch
+  vertices.clear();
+  m_batchVertices.swap(vertices);
 }
 
 void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
@@ -206,23 +269,16 @@ void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, c
     }
   }
 
+  // 16 bit indices
+  if (m_batchVertices.size() + 4 > 65536)
+    Flush();
+
   for (int i=0; i<4; i++)
   {
     vertices[i].x = x[i];
     vertices[i].y = y[i];
     vertices[i].z = z[i];
-    m_packedVertices.push_back(vertices[i]);
-  }
-
-  if ((m_packedVertices.size() / 4) > (m_idx.size() / 6))
-  {
-    size_t i = m_packedVertices.size() - 4;
-    m_idx.push_back(i+0);
-    m_idx.push_back(i+1);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+3);
-    m_idx.push_back(i+0);
+    m_batchVertices.push_back(vertices[i]);
   }
 }
 
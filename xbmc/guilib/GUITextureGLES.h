@@ -21,9 +21,11 @@
  */
 
 #include "GUITexture.h"
+#include "MatrixGLES.h"
 
 #include "system_gl.h"
 #include <vector>
+#include "rendering/gles/RenderSystemGLES.h"
 #include "utils/Color.h"
 
 struct PackedVertex
@@ -34,13 +36,18 @@ struct PackedVertex
 };
 typedef std::vector<PackedVertex> PackedVertices;
 
-class CRenderSystemGLES;
-
 class CGUITextureGLES : public CGUITextureBase
 {
 public:
   CGUITextureGLES(float posX, float posY, float width, float height, const CTextureInfo& texture);
   static void DrawQuad(const CRect &coords, UTILS::Color color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
+
+  /*!
+   \brief Draw the quads queued by consecutive textures sharing textures,
+   shader, color and blending with a single draw call.
+   */
+  static void Flush();
+
 protected:
   void Begin(UTILS::Color color);
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
@@ -48,8 +55,20 @@ protected:
 
   GLubyte m_col[4];
 
-  PackedVertices m_packedVertices;
-  std::vector<GLushort> m_idx;
-  CRenderSystemGLES *m_renderSystem;
-};
+  struct BatchState
+  {
+    GLuint texture;
+    GLuint diffuse;
+    ESHADERMETHOD method;
+    GLubyte col[4];
+    bool blend;
+    CMatrixGL modview;
+    CMatrixGL project;
+  };
+
+  static bool SameState(const BatchState &a, const BatchState &b);
 
+  static BatchState m_batchState;
+  static PackedVertices m_batchVertices;
+  static std::vector<GLushort> m_batchIdx;
+};
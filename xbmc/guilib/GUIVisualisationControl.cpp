@@ -20,6 +20,8 @@
 
 #include "GUIVisualisationControl.h"
 
+#include <algorithm>
+
 #include "Application.h"
 #include "GUIComponent.h"
 #include "GUIInfoManager.h"
@@ -33,6 +35,7 @@
 #include "music/tags/MusicInfoTag.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 
@@ -73,6 +76,17 @@ void CAudioBuffer::Set(const float* psBuffer, int iSize)
     m_pBuffer[i] = 0;
 }
 
+void CAudioBuffer::SetFreq(const float* psFreq, int iSize)
+{
+  if (iSize < 0)
+    return;
+
+  iSize = std::min(iSize, AUDIO_BUFFER_SIZE / 2);
+  memcpy(m_freq, psFreq, iSize * sizeof(float));
+  for (int i = iSize; i < AUDIO_BUFFER_SIZE / 2; ++i)
+    m_freq[i] = 0;
+}
+
 CGUIVisualisationControl::CGUIVisualisationControl(int parentID, int controlID, float posX, float posY, float width, float height)
   : CGUIControl(parentID, controlID, posX, posY, width, height),
     m_callStart(false),
@@ -184,6 +198,8 @@ void CGUIVisualisationControl::Process(unsigned int currentTime, CDirtyRegionLis
         songTitle = tag->GetTitle();
       m_alreadyStarted = m_instance->Start(m_channels, m_samplesPerSec, m_bitsPerSample, songTitle);
       CServiceBroker::GetWinSystem()->GetGfxContext().ApplyStateBlock();
+      // sync delay and transform are only known once started
+      CreateBuffers();
       m_callStart = false;
       m_updateTrack = true;
     }
@@ -257,41 +273,36 @@ void CGUIVisualisationControl::OnInitialize(int channels, int samplesPerSec, int
   m_callStart = true;
 }
 
-void CGUIVisualisationControl::OnAudioData(const float* audioData, unsigned int audioDataLength)
+void CGUIVisualisationControl::OnAudioData(const float* audioData, unsigned int audioDataLength, const float* freqData, unsigned int freqDataLength)
 {
   if (!m_instance || !m_alreadyStarted)
     return;
 
-  // Save our audio data in the buffers
-  std::unique_ptr<CAudioBuffer> pBuffer(new CAudioBuffer(audioDataLength));
-  pBuffer->Set(audioData, audioDataLength);
-  //m_vecBuffers.push_back(pBuffer.release());
-  m_vecBuffers.emplace_back(std::move(pBuffer));
-
-  if (m_vecBuffers.size() < m_numBuffers)
-    return;
-
-  std::unique_ptr<CAudioBuffer> ptrAudioBuffer = std::move(m_vecBuffers.front());
-  m_vecBuffers.pop_front();
-
-  // Fourier transform the data if the vis wants it...
-  if (m_wantsFreq)
+  std::unique_ptr<CAudioBuffer> ptrAudioBuffer;
+  bool wantsFreq;
   {
-    const float *psAudioData = ptrAudioBuffer->Get();
+    CSingleLock lock(m_buffersSection);
+    wantsFreq = m_wantsFreq;
 
-    if (!m_transform)
-      m_transform.reset(new RFFT(AUDIO_BUFFER_SIZE/2, false)); // half due to stereo
+    // Save our audio data in the buffers, the transform is shared with other viz
+    std::unique_ptr<CAudioBuffer> pBuffer(new CAudioBuffer(audioDataLength));
+    pBuffer->Set(audioData, audioDataLength);
+    if (wantsFreq)
+      pBuffer->SetFreq(freqData, freqDataLength);
+    m_vecBuffers.emplace_back(std::move(pBuffer));
 
-    m_transform->calc(psAudioData, m_freq);
+    if (m_vecBuffers.size() < m_numBuffers)
+      return;
 
-    // Transfer data to our visualisation
-    m_instance->AudioData(psAudioData, ptrAudioBuffer->Size(), m_freq, AUDIO_BUFFER_SIZE/2); // half due to complex-conjugate
+    ptrAudioBuffer = std::move(m_vecBuffers.front());
+    m_vecBuffers.pop_front();
   }
+
+  // Transfer data to our visualisation
+  if (wantsFreq)
+    m_instance->AudioData(ptrAudioBuffer->Get(), ptrAudioBuffer->Size(), ptrAudioBuffer->GetFreq(), AUDIO_BUFFER_SIZE/2); // half due to complex-conjugate
   else
-  { // Transfer data to our visualisation
     m_instance->AudioData(ptrAudioBuffer->Get(), ptrAudioBuffer->Size(), nullptr, 0);
-  }
-  return;
 }
 
 void CGUIVisualisationControl::UpdateTrack()
@@ -453,6 +464,7 @@ void CGUIVisualisationControl::CreateBuffers()
   if (m_instance && m_alreadyStarted)
     m_instance->GetInfo(&info);
 
+  CSingleLock lock(m_buffersSection);
   m_numBuffers = info.iSyncDelay + 1;
   m_wantsFreq = info.bWantsFreq;
   if (m_numBuffers > MAX_AUDIO_BUFFERS)
@@ -463,15 +475,8 @@ void CGUIVisualisationControl::CreateBuffers()
 
 void CGUIVisualisationControl::ClearBuffers()
 {
+  CSingleLock lock(m_buffersSection);
   m_wantsFreq = false;
   m_numBuffers = 0;
   m_vecBuffers.clear();
-
-  for (int j = 0; j < AUDIO_BUFFER_SIZE; ++j)
-  {
-    m_freq[j] = 0.0f;
-  }
-
-  if (m_transform)
-    m_transform.reset();
 }
@@ -22,7 +22,7 @@
 #include "GUIControl.h"
 #include "addons/Visualization.h"
 #include "cores/AudioEngine/Interfaces/IAudioCallback.h"
-#include "utils/rfft.h"
+#include "threads/CriticalSection.h"
 
 #include <string>
 #include <vector>
@@ -39,12 +39,15 @@ public:
   const float* Get() const;
   int Size() const;
   void Set(const float* psBuffer, int iSize);
+  float* GetFreq() { return m_freq; }
+  void SetFreq(const float* psFreq, int iSize);
 private:
   CAudioBuffer(const CAudioBuffer&) = delete;
   CAudioBuffer& operator=(const CAudioBuffer&) = delete;
   CAudioBuffer();
   float* m_pBuffer;
   int m_iLen;
+  float m_freq[AUDIO_BUFFER_SIZE / 2];
 };
 
 class CGUIVisualisationControl : public CGUIControl, public IAudioCallback
@@ -56,7 +59,7 @@ public:
 
   // Child functions related to IAudioCallback
   void OnInitialize(int channels, int samplesPerSec, int bitsPerSample) override;
-  void OnAudioData(const float* audioData, unsigned int audioDataLength) override;
+  void OnAudioData(const float* audioData, unsigned int audioDataLength, const float* freqData, unsigned int freqDataLength) override;
 
   // Child functions related to CGUIControl
   void FreeResources(bool immediately = false) override;
@@ -89,12 +92,11 @@ private:
   bool m_attemptedLoad;
   bool m_updateTrack;
 
+  CCriticalSection m_buffersSection; /*!< buffers are filled by the audio engine's viz worker */
   std::list<std::unique_ptr<CAudioBuffer>> m_vecBuffers;
   unsigned int m_numBuffers; /*!< Number of Audio buffers */
   bool m_wantsFreq;
-  float m_freq[AUDIO_BUFFER_SIZE]; /*!< Frequency data */
   std::vector<std::string> m_presets; /*!< cached preset list */
-  std::unique_ptr<RFFT> m_transform;
 
   /* values set from "OnInitialize" IAudioCallback  */
   int m_channels;
@@ -170,13 +170,23 @@ std::unique_ptr<TiXmlElement> CGUIWindow::Prepare(TiXmlElement *pRootElement)
   if (!pRootElement)
     return nullptr;
 
+  // resolving includes is only needed again if one of the include conditions changed value,
+  // otherwise a copy of the last result is all we need
+  if (m_preparedXMLRootElement && m_preparedXMLSource == pRootElement &&
+      !CServiceBroker::GetGUI()->GetInfoManager().ConditionsChangedValues(m_xmlIncludeConditions))
+    return std::unique_ptr<TiXmlElement>(static_cast<TiXmlElement*>(m_preparedXMLRootElement->Clone()));
+
   // clone the root element as we will manipulate it
   auto preparedRoot = std::unique_ptr<TiXmlElement>(static_cast<TiXmlElement*>(pRootElement->Clone()));
 
   // Resolve any includes, constants, expressions that may be present
   // and save include's conditions to the given map
+  m_xmlIncludeConditions.clear();
   g_SkinInfo->ResolveIncludes(preparedRoot.get(), &m_xmlIncludeConditions);
 
+  m_preparedXMLRootElement.reset(static_cast<TiXmlElement*>(preparedRoot->Clone()));
+  m_preparedXMLSource = pRootElement;
+
   return preparedRoot;
 }
 
@@ -822,6 +832,8 @@ void CGUIWindow::FreeResources(bool forceUnload /*= false */)
     delete m_windowXMLRootElement;
     m_windowXMLRootElement = nullptr;
     m_xmlIncludeConditions.clear();
+    m_preparedXMLRootElement.reset();
+    m_preparedXMLSource = nullptr;
   }
 }
 
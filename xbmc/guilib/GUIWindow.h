@@ -323,6 +323,8 @@ protected:
 private:
   std::map<std::string, CVariant, icompare> m_mapProperties;
   std::map<INFO::InfoPtr, bool> m_xmlIncludeConditions; ///< \brief used to store conditions used to resolve includes for this window
+  std::unique_ptr<TiXmlElement> m_preparedXMLRootElement; ///< \brief result of the last Prepare(), reused while m_xmlIncludeConditions keep their values
+  const TiXmlElement* m_preparedXMLSource = nullptr; ///< \brief the element m_preparedXMLRootElement was prepared from
 };
 
 #endif
@@ -27,6 +27,7 @@
 #include "GUIPassword.h"
 #include "GUIInfoManager.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/URIUtils.h"
 #include "SeekHandler.h"
 #include "settings/AdvancedSettings.h"
@@ -35,7 +36,9 @@
 #include "utils/Variant.h"
 #include "input/Key.h"
 #include "utils/log.h"
+#include "utils/Metrics.h"
 #include "utils/StringUtils.h"
+#include "utils/Trace.h"
 
 #include "windows/GUIWindowHome.h"
 #include "events/windows/GUIWindowEventLog.h"
@@ -1114,6 +1117,7 @@ bool RenderOrderSortFunction(CGUIWindow *first, CGUIWindow *second)
 void CGUIWindowManager::Process(unsigned int currentTime)
 {
   assert(g_application.IsCurrentThread());
+  CTraceScope trace("gui", "CGUIWindowManager::Process");
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
   m_dirtyregions.clear();
@@ -1195,6 +1199,7 @@ void CGUIWindowManager::RenderEx() const
 bool CGUIWindowManager::Render()
 {
   assert(g_application.IsCurrentThread());
+  CTraceScope trace("gui", "CGUIWindowManager::Render");
   CSingleExit lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
@@ -1216,6 +1221,12 @@ bool CGUIWindowManager::Render()
   }
   else
   {
+    // let the window system extend the regions to whatever its back buffer is missing
+    // (only once per frame, the right eye of a stereo frame covers the same regions)
+    if (!dirtyRegions.empty() &&
+        CServiceBroker::GetWinSystem()->GetGfxContext().GetStereoView() != RENDER_STEREO_VIEW_RIGHT)
+      CServiceBroker::GetWinSystem()->SetDamagedRegions(dirtyRegions);
+
     for (CDirtyRegionList::const_iterator i = dirtyRegions.begin(); i != dirtyRegions.end(); ++i)
     {
       if (i->IsEmpty())
@@ -1266,6 +1277,15 @@ void CGUIWindowManager::AfterRender()
 void CGUIWindowManager::FrameMove()
 {
   assert(g_application.IsCurrentThread());
+
+  // one frame is moved per frame rendered, so the time in between is the frame time
+  static CMetricHistogram &frameTimes = CMetrics::GetInstance().GetHistogram("kodi_gui_frame_time_ms",
+    "Time between two frames of the GUI in ms", { 10, 17, 20, 25, 34, 42, 50, 67, 100, 250, 1000 });
+  const uint64_t now = XbmcThreads::SystemClockNanos();
+  if (m_lastFrameMove > 0)
+    frameTimes.Observe((now - m_lastFrameMove) / 1000000.0);
+  m_lastFrameMove = now;
+
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
   if(m_iNested == 0)
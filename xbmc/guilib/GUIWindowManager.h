@@ -275,6 +275,7 @@ private:
 
   int  m_iNested;
   bool m_initialized;
+  uint64_t m_lastFrameMove{0}; ///< ns, for the frame time metric
   mutable bool m_touchGestureActive{false};
   mutable bool m_inhibitTouchGestureEvents{false};
 
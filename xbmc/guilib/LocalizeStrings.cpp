@@ -26,10 +26,22 @@
 #include "utils/URIUtils.h"
 #include "utils/POUtils.h"
 #include "filesystem/Directory.h"
+#include "filesystem/File.h"
 #include "threads/SharedSection.h"
 #include "threads/SingleLock.h"
+#include "utils/Digest.h"
 #include "utils/StringUtils.h"
 
+#include <cstring>
+#include <vector>
+
+using KODI::UTILITY::CDigest;
+
+// Parsed string tables, by path and language. Bump the version when the format changes.
+#define STRINGS_CACHE_PATH     "special://temp/stringcache/"
+#define STRINGS_CACHE_MAGIC    "KSTR"
+#define STRINGS_CACHE_VERSION  1
+
 
 /*! \brief Tries to load ids and strings from a strings.xml file to the `strings` map..
  * It should only be called from the LoadStr2Mem function to try a PO file first.
@@ -146,10 +158,12 @@ static bool LoadPO(const std::string &filename, std::map<uint32_t, LocStr>& stri
  \param strings [out] The resulting strings map.
  \param encoding Encoding of the strings. For PO files we only use utf-8.
  \param offset An offset value to place strings from the id value.
+ \param sources [out] The files that were tried, to tell if a cached result is still valid.
  \return false if no strings.po or strings.xml file was loaded.
  */
 static bool LoadStr2Mem(const std::string &pathname_in, const std::string &language,
-    std::map<uint32_t, LocStr>& strings,  std::string &encoding, uint32_t offset = 0 )
+    std::map<uint32_t, LocStr>& strings,  std::string &encoding, std::vector<std::string> &sources,
+    uint32_t offset = 0)
 {
   std::string pathname = CSpecialProtocol::TranslatePathConvertCase(pathname_in + language);
   if (!XFILE::CDirectory::Exists(pathname))
@@ -164,20 +178,205 @@ static bool LoadStr2Mem(const std::string &pathname_in, const std::string &langu
     }
 
     if (!exists)
+    {
+      // the cached result becomes invalid once the language is installed
+      sources.push_back(URIUtils::AddFileToFolder(pathname, "strings.po"));
       return false;
+    }
   }
 
   bool useSourceLang = StringUtils::EqualsNoCase(language, LANGUAGE_DEFAULT) || StringUtils::EqualsNoCase(language, LANGUAGE_OLD_DEFAULT);
-  if (LoadPO(URIUtils::AddFileToFolder(pathname, "strings.po"), strings, encoding, offset, useSourceLang))
+  sources.push_back(URIUtils::AddFileToFolder(pathname, "strings.po"));
+  if (LoadPO(sources.back(), strings, encoding, offset, useSourceLang))
+    return true;
+
+  sources.push_back(URIUtils::AddFileToFolder(pathname, "strings.xml"));
+  return LoadXML(sources.back(), strings, encoding, offset);
+}
+
+namespace
+{
+struct CacheSource
+{
+  std::string path;
+  int64_t mtime;
+  int64_t size;
+};
+
+CacheSource StatSource(const std::string &path)
+{
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(path, &st) != 0)
+    return { path, -1, -1 };
+  return { path, static_cast<int64_t>(st.st_mtime), static_cast<int64_t>(st.st_size) };
+}
+
+std::string GetCacheFile(const std::string& path, const std::string& language)
+{
+  return STRINGS_CACHE_PATH + CDigest::Calculate(CDigest::Type::MD5, path + "|" + language) + ".bin";
+}
+
+void WriteInt(std::string &buffer, uint32_t value)
+{
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteInt64(std::string &buffer, int64_t value)
+{
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::string &buffer, const std::string &value)
+{
+  WriteInt(buffer, static_cast<uint32_t>(value.size()));
+  buffer.append(value);
+}
+
+// Reads the cache file, every read is checked against its end
+class CCacheReader
+{
+public:
+  CCacheReader(const char *data, size_t size) : m_pos(data), m_end(data + size) { }
+
+  bool Read(void *value, size_t size)
+  {
+    if (static_cast<size_t>(m_end - m_pos) < size)
+      return false;
+    std::memcpy(value, m_pos, size);
+    m_pos += size;
     return true;
+  }
+
+  bool ReadString(std::string &value)
+  {
+    uint32_t size;
+    if (!Read(&size, sizeof(size)) || static_cast<size_t>(m_end - m_pos) < size)
+      return false;
+    value.assign(m_pos, size);
+    m_pos += size;
+    return true;
+  }
+
+private:
+  const char *m_pos;
+  const char *const m_end;
+};
+
+bool LoadCache(const std::string &cacheFile, std::map<uint32_t, LocStr>& strings)
+{
+  if (!XFILE::CFile::Exists(cacheFile))
+    return false;
+
+  XFILE::CFile file;
+  XUTILS::auto_buffer data;
+  if (file.LoadFile(cacheFile, data) <= 0)
+    return false;
+
+  CCacheReader reader(data.get(), data.size());
+
+  char magic[4];
+  uint32_t version;
+  uint32_t count;
+  if (!reader.Read(magic, sizeof(magic)) || std::memcmp(magic, STRINGS_CACHE_MAGIC, sizeof(magic)) != 0 ||
+      !reader.Read(&version, sizeof(version)) || version != STRINGS_CACHE_VERSION ||
+      !reader.Read(&count, sizeof(count)))
+    return false;
+
+  // the strings are parsed again if one of the files changed, appeared or was removed
+  for (uint32_t i = 0; i < count; i++)
+  {
+    CacheSource source;
+    if (!reader.ReadString(source.path) ||
+        !reader.Read(&source.mtime, sizeof(source.mtime)) ||
+        !reader.Read(&source.size, sizeof(source.size)))
+      return false;
+
+    const CacheSource current = StatSource(source.path);
+    if (current.mtime != source.mtime || current.size != source.size)
+      return false;
+  }
+
+  if (!reader.Read(&count, sizeof(count)))
+    return false;
+
+  std::map<uint32_t, LocStr> cached;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    uint32_t id;
+    LocStr str;
+    if (!reader.Read(&id, sizeof(id)) ||
+        !reader.ReadString(str.strTranslated) ||
+        !reader.ReadString(str.strOriginal))
+      return false;
+    cached.emplace_hint(cached.end(), id, std::move(str));
+  }
+
+  strings = std::move(cached);
+  return true;
+}
+
+void SaveCache(const std::string &cacheFile, const std::vector<std::string> &sources,
+               const std::map<uint32_t, LocStr>& strings)
+{
+  std::string buffer(STRINGS_CACHE_MAGIC);
+  WriteInt(buffer, STRINGS_CACHE_VERSION);
+
+  WriteInt(buffer, static_cast<uint32_t>(sources.size()));
+  for (const auto &path : sources)
+  {
+    const CacheSource source = StatSource(path);
+    WriteString(buffer, source.path);
+    WriteInt64(buffer, source.mtime);
+    WriteInt64(buffer, source.size);
+  }
 
-  return LoadXML(URIUtils::AddFileToFolder(pathname, "strings.xml"), strings, encoding, offset);
+  WriteInt(buffer, static_cast<uint32_t>(strings.size()));
+  for (const auto &str : strings)
+  {
+    WriteInt(buffer, str.first);
+    WriteString(buffer, str.second.strTranslated);
+    WriteString(buffer, str.second.strOriginal);
+  }
+
+  if (!XFILE::CDirectory::Exists(STRINGS_CACHE_PATH))
+    XFILE::CDirectory::Create(STRINGS_CACHE_PATH);
+
+  XFILE::CFile file;
+  if (file.OpenForWrite(cacheFile, true))
+  {
+    if (file.Write(buffer.c_str(), buffer.size()) != static_cast<ssize_t>(buffer.size()))
+    {
+      file.Close();
+      XFILE::CFile::Delete(cacheFile);
+    }
+  }
+  else
+    CLog::Log(LOGDEBUG, "LocalizeStrings: unable to write cache %s", cacheFile.c_str());
+}
 }
 
+/*! \brief Loads the strings of a language and the English fallback.
+ * The parsed strings are cached, the cache is used as long as the files it was
+ * parsed from didn't change.
+ \param path The directory that holds the language folders.
+ \param language The language to load.
+ \param strings [out] The resulting strings map, replaced if the strings were loaded.
+ \return false if no strings were loaded.
+ */
 static bool LoadWithFallback(const std::string& path, const std::string& language, std::map<uint32_t, LocStr>& strings)
 {
+  const std::string cacheFile = GetCacheFile(path, language);
+  if (LoadCache(cacheFile, strings))
+  {
+    CLog::Log(LOGDEBUG, "LocalizeStrings: loaded %lu cached strings of %s for %s",
+              static_cast<unsigned long>(strings.size()), language.c_str(), path.c_str());
+    return true;
+  }
+
+  std::map<uint32_t, LocStr> parsed;
+  std::vector<std::string> sources;
   std::string encoding;
-  if (!LoadStr2Mem(path, language, strings, encoding))
+  if (!LoadStr2Mem(path, language, parsed, encoding, sources))
   {
     if (StringUtils::EqualsNoCase(language, LANGUAGE_DEFAULT)) // no fallback, nothing to do
       return false;
@@ -185,8 +384,11 @@ static bool LoadWithFallback(const std::string& path, const std::string& languag
 
   // load the fallback
   if (!StringUtils::EqualsNoCase(language, LANGUAGE_DEFAULT))
-    LoadStr2Mem(path, LANGUAGE_DEFAULT, strings, encoding);
+    LoadStr2Mem(path, LANGUAGE_DEFAULT, parsed, encoding, sources);
+
+  SaveCache(cacheFile, sources, parsed);
 
+  strings = std::move(parsed);
   return true;
 }
 
@@ -203,11 +405,14 @@ void CLocalizeStrings::ClearSkinStrings()
 
 bool CLocalizeStrings::LoadSkinStrings(const std::string& path, const std::string& language)
 {
-  //! @todo shouldn't hold lock while loading file
+  std::map<uint32_t, LocStr> strings;
+  const bool loaded = LoadWithFallback(path, language, strings);
+
   CExclusiveLock lock(m_stringsMutex);
   ClearSkinStrings();
-  // load the skin strings in.
-  return LoadWithFallback(path, language, m_strings);
+  // strings of the skin don't replace the ones of the core
+  m_strings.insert(strings.begin(), strings.end());
+  return loaded;
 }
 
 bool CLocalizeStrings::Load(const std::string& strPathName, const std::string& strLanguage)
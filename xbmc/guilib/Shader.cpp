@@ -20,19 +20,68 @@
 
 #include "ServiceBroker.h"
 #include "Shader.h"
+#include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "utils/Digest.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "rendering/RenderSystem.h"
 
+#include <cstring>
+#include <vector>
+
 #ifdef HAS_GLES
 #define GLchar char
 #endif
 
+#if defined(HAS_GL) || HAS_GLES == 3
+#define HAS_PROGRAM_BINARY
+#endif
+
 #define LOG_SIZE 1024
 
+#define PROGRAM_CACHE_PATH "special://temp/shadercache/"
+
 using namespace Shaders;
 using namespace XFILE;
+using KODI::UTILITY::CDigest;
+
+namespace
+{
+#if defined(HAS_PROGRAM_BINARY)
+bool IsProgramBinarySupported()
+{
+  CRenderSystemBase *renderSystem = CServiceBroker::GetRenderSystem();
+  if (renderSystem == nullptr)
+    return false;
+
+#if defined(HAS_GL)
+  unsigned int major, minor;
+  renderSystem->GetRenderVersion(major, minor);
+  if (major * 10 + minor < 41 && !renderSystem->IsExtSupported("GL_ARB_get_program_binary"))
+    return false;
+#endif
+
+  GLint formats = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  return formats > 0;
+}
+
+// A driver update changes the version string, which invalidates the binaries
+std::string GetProgramCacheFile(const std::string& vertexSource, const std::string& pixelSource)
+{
+  CRenderSystemBase *renderSystem = CServiceBroker::GetRenderSystem();
+
+  std::string key = renderSystem->GetRenderVendor();
+  key += '\n' + renderSystem->GetRenderRenderer();
+  key += '\n' + renderSystem->GetRenderVersionString();
+  key += '\n' + vertexSource;
+  key += '\n' + pixelSource;
+
+  return PROGRAM_CACHE_PATH + CDigest::Calculate(CDigest::Type::MD5, key) + ".bin";
+}
+#endif
+}
 
 //////////////////////////////////////////////////////////////////////
 // CShader
@@ -260,6 +309,22 @@ bool CGLSLShaderProgram::CompileAndLink()
   // free resources
   Free();
 
+#if defined(HAS_PROGRAM_BINARY)
+  std::string cacheFile;
+  if (IsProgramBinarySupported())
+  {
+    cacheFile = GetProgramCacheFile(m_pVP->GetSource(), m_pFP->GetSource());
+    if (LoadProgramBinary(cacheFile))
+    {
+      m_validated = false;
+      m_ok = true;
+      OnCompiledAndLinked();
+      VerifyGLState();
+      return true;
+    }
+  }
+#endif
+
   // compiled vertex shader
   if (!m_pVP->Compile())
   {
@@ -294,6 +359,11 @@ bool CGLSLShaderProgram::CompileAndLink()
     VerifyGLState();
   }
 
+#if defined(HAS_PROGRAM_BINARY)
+  if (!cacheFile.empty())
+    glProgramParameteri(m_shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+
   // link the program
   glLinkProgram(m_shaderProgram);
   glGetProgramiv(m_shaderProgram, GL_LINK_STATUS, params);
@@ -307,6 +377,11 @@ bool CGLSLShaderProgram::CompileAndLink()
   }
   VerifyGLState();
 
+#if defined(HAS_PROGRAM_BINARY)
+  if (!cacheFile.empty())
+    SaveProgramBinary(cacheFile);
+#endif
+
   m_validated = false;
   m_ok = true;
   OnCompiledAndLinked();
@@ -319,6 +394,74 @@ bool CGLSLShaderProgram::CompileAndLink()
   return false;
 }
 
+bool CGLSLShaderProgram::LoadProgramBinary(const std::string& file)
+{
+#if defined(HAS_PROGRAM_BINARY)
+  if (!CFile::Exists(file))
+    return false;
+
+  CFile cache;
+  XUTILS::auto_buffer data;
+  if (cache.LoadFile(file, data) <= static_cast<ssize_t>(sizeof(GLenum)))
+    return false;
+
+  GLenum format;
+  std::memcpy(&format, data.get(), sizeof(format));
+
+  if (!(m_shaderProgram = glCreateProgram()))
+    return false;
+
+  glProgramBinary(m_shaderProgram, format, data.get() + sizeof(format), data.size() - sizeof(format));
+
+  GLint params[4];
+  glGetProgramiv(m_shaderProgram, GL_LINK_STATUS, params);
+  if (params[0] != GL_TRUE)
+  {
+    // rejected by the driver, compile and store a new binary
+    CLog::Log(LOGDEBUG, "GL: Cached shader program %s rejected", file.c_str());
+    glDeleteProgram(m_shaderProgram);
+    m_shaderProgram = 0;
+    CFile::Delete(file);
+    return false;
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CGLSLShaderProgram::SaveProgramBinary(const std::string& file)
+{
+#if defined(HAS_PROGRAM_BINARY)
+  GLint length = 0;
+  glGetProgramiv(m_shaderProgram, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0)
+    return;
+
+  // the format goes in front of the binary
+  std::vector<char> data(sizeof(GLenum) + length);
+  GLenum format = 0;
+  GLsizei written = 0;
+  glGetProgramBinary(m_shaderProgram, length, &written, &format, data.data() + sizeof(format));
+  if (written <= 0)
+    return;
+  std::memcpy(data.data(), &format, sizeof(format));
+
+  if (!CDirectory::Exists(PROGRAM_CACHE_PATH))
+    CDirectory::Create(PROGRAM_CACHE_PATH);
+
+  CFile cache;
+  if (cache.OpenForWrite(file, true))
+  {
+    cache.Write(data.data(), sizeof(format) + written);
+    cache.Close();
+  }
+  else
+    CLog::Log(LOGDEBUG, "GL: Unable to write shader program cache %s", file.c_str());
+#endif
+}
+
 bool CGLSLShaderProgram::Enable()
 {
   if (OK())
@@ -42,6 +42,7 @@ namespace Shaders {
     virtual bool LoadSource(const std::string& filename, const std::string& prefix = "");
     virtual bool AppendSource(const std::string& filename);
     virtual bool InsertSource(const std::string& filename, const std::string& loc);
+    const std::string& GetSource() const { return m_source; }
     bool OK() const { return m_compiled; }
 
   protected:
@@ -171,6 +172,10 @@ namespace Shaders {
   protected:
     void Free();
 
+    // link from / store to the program binary cache, keyed by sources and driver
+    bool LoadProgramBinary(const std::string& file);
+    void SaveProgramBinary(const std::string& file);
+
     GLint m_lastProgram;
     bool m_validated;
   };
@@ -127,8 +127,10 @@ void CBaseTexture::Update(unsigned int width, unsigned int height, unsigned int
   if (pixels == NULL)
     return;
 
+#if defined(HAS_GLES)
   if (format & XB_FMT_DXT_MASK)
-    return;
+    return; // no s3tc upload path on GLES
+#endif
 
   Allocate(width, height, format);
   
@@ -213,48 +213,23 @@ int CTextureBundleXBT::LoadAnim(const std::string& Filename, CBaseTexture*** ppT
 
 bool CTextureBundleXBT::ConvertFrameToTexture(const std::string& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
-  // found texture - allocate the necessary buffers
-  unsigned char *buffer = new unsigned char [(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
+  // frames that aren't packed are uploaded straight from a mapped bundle
+  const uint8_t* data = frame.IsPacked() ? nullptr : m_XBTFReader->GetFrameData(frame);
+  uint8_t* buffer = nullptr;
+  if (data == nullptr)
   {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
-    return false;
-  }
-
-  // load the compressed texture
-  if (!m_XBTFReader->Load(frame, buffer))
-  {
-    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
-    delete[] buffer;
-    return false;
-  }
-
-  // check if it's packed with lzo
-  if (frame.IsPacked())
-  { // unpack
-    unsigned char *unpacked = new unsigned char[(size_t)frame.GetUnpackedSize()];
-    if (unpacked == NULL)
-    {
-      CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
-      delete[] buffer;
-      return false;
-    }
-    lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress_safe(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
-        s != frame.GetUnpackedSize())
+    buffer = UnpackFrame(*m_XBTFReader, frame);
+    if (buffer == nullptr)
     {
-      CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
-      delete[] buffer;
-      delete[] unpacked;
+      CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
       return false;
     }
-    delete[] buffer;
-    buffer = unpacked;
+    data = buffer;
   }
 
   // create an xbmc texture
   *ppTexture = new CTexture();
-  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), buffer);
+  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), data);
 
   delete[] buffer;
 
@@ -281,19 +256,26 @@ std::string CTextureBundleXBT::Normalize(const std::string &name)
 
 uint8_t* CTextureBundleXBT::UnpackFrame(const CXBTFReader& reader, const CXBTFFrame& frame)
 {
-  uint8_t* packedBuffer = new uint8_t[static_cast<size_t>(frame.GetPackedSize())];
-  if (packedBuffer == nullptr)
+  // a mapped bundle is decompressed from the mapping, without reading the frame first
+  const uint8_t* packedData = reader.GetFrameData(frame);
+  uint8_t* packedBuffer = nullptr;
+  if (packedData == nullptr || !frame.IsPacked())
   {
-    CLog::Log(LOGERROR, "CTextureBundleXBT: out of memory loading frame with %" PRIu64" packed bytes", frame.GetPackedSize());
-    return nullptr;
-  }
+    packedBuffer = new uint8_t[static_cast<size_t>(frame.GetPackedSize())];
+    if (packedBuffer == nullptr)
+    {
+      CLog::Log(LOGERROR, "CTextureBundleXBT: out of memory loading frame with %" PRIu64" packed bytes", frame.GetPackedSize());
+      return nullptr;
+    }
 
-  // load the compressed texture
-  if (!reader.Load(frame, packedBuffer))
-  {
-    CLog::Log(LOGERROR, "CTextureBundleXBT: error loading frame");
-    delete[] packedBuffer;
-    return nullptr;
+    // load the compressed texture
+    if (!reader.Load(frame, packedBuffer))
+    {
+      CLog::Log(LOGERROR, "CTextureBundleXBT: error loading frame");
+      delete[] packedBuffer;
+      return nullptr;
+    }
+    packedData = packedBuffer;
   }
 
   // if the frame isn't packed there's nothing else to be done
@@ -318,7 +300,7 @@ uint8_t* CTextureBundleXBT::UnpackFrame(const CXBTFReader& reader, const CXBTFFr
   }
 
   lzo_uint size = static_cast<lzo_uint>(frame.GetUnpackedSize());
-  if (lzo1x_decompress_safe(packedBuffer, static_cast<lzo_uint>(frame.GetPackedSize()), unpackedBuffer, &size, nullptr) != LZO_E_OK || size != frame.GetUnpackedSize())
+  if (lzo1x_decompress_safe(packedData, static_cast<lzo_uint>(frame.GetPackedSize()), unpackedBuffer, &size, nullptr) != LZO_E_OK || size != frame.GetUnpackedSize())
   {
     CLog::Log(LOGERROR, "CTextureBundleXBT: failed to decompress frame with %" PRIu64" unpacked bytes to %" PRIu64" bytes", frame.GetPackedSize(), frame.GetUnpackedSize());
     delete[] packedBuffer;
@@ -20,6 +20,7 @@
 
 #include "TextureManager.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "addons/Skin.h"
@@ -27,6 +28,7 @@
 #include "filesystem/File.h"
 #include "windowing/GraphicContext.h"
 #include "Texture.h"
+#include "rendering/RenderSystem.h"
 #include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "URL.h"
@@ -41,8 +43,12 @@
 #include "ServiceBroker.h"
 #include "windowing/osx/WinSystemIOS.h" // for g_Windowing in CGUITextureManager::FreeUnusedTextures
 #endif
+#include "AnimatedTextureStream.h"
 #include "FFmpegImage.h"
 
+// animations with more frames than this are decoded while they play
+#define ANIM_PREDECODE_FRAMES 8
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -54,6 +60,8 @@ CTextureArray::CTextureArray(int width, int height, int loops,  bool texCoordsAr
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_texOffsetX = 0;
+  m_texOffsetY = 0;
   m_texCoordsArePixels = false;
 }
 
@@ -66,20 +74,35 @@ CTextureArray::~CTextureArray() = default;
 
 unsigned int CTextureArray::size() const
 {
+  if (m_stream)
+    return m_delays.size();
   return m_textures.size();
 }
 
+CBaseTexture* CTextureArray::GetFrame(unsigned int frame) const
+{
+  if (m_stream)
+  {
+    m_stream->ShowFrame(m_textures[0], frame);
+    return m_textures[0];
+  }
+  return m_textures[frame];
+}
+
 
 void CTextureArray::Reset()
 {
   m_textures.clear();
   m_delays.clear();
+  m_stream.reset();
   m_width = 0;
   m_height = 0;
   m_loops = 0;
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_texOffsetX = 0;
+  m_texOffsetY = 0;
   m_texCoordsArePixels = false;
 }
 
@@ -105,6 +128,18 @@ void CTextureArray::Set(CBaseTexture *texture, int width, int height)
   Add(texture, 2);
 }
 
+void CTextureArray::SetStream(const std::shared_ptr<CAnimatedTextureStream> &stream, const std::vector<int> &delays)
+{
+  if (m_textures.empty() || !stream)
+    return;
+
+  for (unsigned int i = 1; i < m_textures.size(); i++)
+    delete m_textures[i];
+  m_textures.resize(1);
+  m_delays = delays;
+  m_stream = stream;
+}
+
 void CTextureArray::Free()
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
@@ -120,6 +155,143 @@ void CTextureArray::Free()
 }
 
 
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+
+// images up to this size are packed, in pages of this size
+#define ATLAS_MAX_IMAGE_SIZE 128
+#define ATLAS_PAGE_SIZE 1024
+
+CTextureAtlas::~CTextureAtlas()
+{
+  for (auto page : m_pages)
+  {
+    delete page->texture;
+    delete page;
+  }
+}
+
+bool CTextureAtlas::Place(Page &page, int width, int height, int &x, int &y)
+{
+  // first shelf that is tall enough and has room left, else a new shelf
+  for (auto& shelf : page.shelves)
+  {
+    if (height <= shelf.height && shelf.x + width <= page.size)
+    {
+      x = shelf.x;
+      y = shelf.y;
+      shelf.x += width;
+      return true;
+    }
+  }
+
+  int top = page.shelves.empty() ? 0 : page.shelves.back().y + page.shelves.back().height;
+  if (top + height > page.size || width > page.size)
+    return false;
+
+  Shelf shelf = { top, height, width };
+  page.shelves.push_back(shelf);
+  x = 0;
+  y = top;
+  return true;
+}
+
+CBaseTexture* CTextureAtlas::Add(const CBaseTexture *texture, int &x, int &y)
+{
+  if (!texture || !texture->GetPixels() ||
+      texture->GetPixelFormat() != XB_FMT_A8R8G8B8 ||
+      texture->IsMipmapped() ||
+      texture->GetOrientation() ||
+      texture->GetScalingMethod() != TEXTURE_SCALING::LINEAR)
+    return nullptr;
+
+  int width = texture->GetWidth();
+  int height = texture->GetHeight();
+  if (width == 0 || height == 0 ||
+      width > ATLAS_MAX_IMAGE_SIZE || height > ATLAS_MAX_IMAGE_SIZE)
+    return nullptr;
+
+  // one pixel of padding around each image, repeating its edges, so
+  // filtering doesn't pick up the neighbours
+  int paddedWidth = width + 2;
+  int paddedHeight = height + 2;
+
+  Page *page = nullptr;
+  int px = 0, py = 0;
+  for (auto p : m_pages)
+  {
+    if (Place(*p, paddedWidth, paddedHeight, px, py))
+    {
+      page = p;
+      break;
+    }
+  }
+
+  if (!page)
+  {
+    int size = std::min(ATLAS_PAGE_SIZE, (int)CServiceBroker::GetRenderSystem()->GetMaxTextureSize());
+    page = new Page;
+    page->texture = new CTexture(size, size, XB_FMT_A8R8G8B8);
+    page->pixels.resize(size * size * 4);
+    page->size = size;
+    page->images = 0;
+    if (!Place(*page, paddedWidth, paddedHeight, px, py))
+    {
+      delete page->texture;
+      delete page;
+      return nullptr;
+    }
+    m_pages.push_back(page);
+  }
+
+  const unsigned char *src = texture->GetPixels();
+  unsigned int srcPitch = texture->GetPitch();
+  unsigned int dstPitch = page->size * 4;
+  for (int row = -1; row <= height; row++)
+  {
+    const unsigned char *srcRow = src + std::min(std::max(row, 0), height - 1) * srcPitch;
+    unsigned char *dst = &page->pixels[(py + 1 + row) * dstPitch + px * 4];
+    memcpy(dst, srcRow, 4);
+    memcpy(dst + 4, srcRow, width * 4);
+    memcpy(dst + 4 + width * 4, srcRow + (width - 1) * 4, 4);
+  }
+
+  // the page goes to the GPU on its next draw, if it hasn't been drawn since
+  // the last image was added, only the new one needs copying
+  unsigned char *pending = page->texture->GetPixels();
+  if (pending && page->texture->GetPitch() == dstPitch)
+  {
+    for (int row = py; row < py + paddedHeight; row++)
+      memcpy(pending + row * dstPitch + px * 4, &page->pixels[row * dstPitch + px * 4], paddedWidth * 4);
+  }
+  else
+    page->texture->Update(page->size, page->size, dstPitch, XB_FMT_A8R8G8B8, page->pixels.data(), false);
+  page->images++;
+
+  x = px + 1;
+  y = py + 1;
+  return page->texture;
+}
+
+void CTextureAtlas::Release(CBaseTexture *page)
+{
+  for (auto it = m_pages.begin(); it != m_pages.end(); ++it)
+  {
+    if ((*it)->texture != page)
+      continue;
+
+    // space isn't reused before the whole page is empty
+    if (--(*it)->images == 0)
+    {
+      delete (*it)->texture;
+      delete *it;
+      m_pages.erase(it);
+    }
+    return;
+  }
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -192,6 +364,14 @@ void CTextureMap::Flush()
 
 void CTextureMap::FreeTexture()
 {
+  if (m_atlas)
+  {
+    if (!m_texture.m_textures.empty())
+      m_atlas->Release(m_texture.m_textures[0]);
+    m_atlas = nullptr;
+    m_texture.Reset();
+    return;
+  }
   m_texture.Free();
 }
 
@@ -210,6 +390,16 @@ bool CTextureMap::IsEmpty() const
   return m_texture.m_textures.empty();
 }
 
+void CTextureMap::SetStream(const std::shared_ptr<CAnimatedTextureStream> &stream, const std::vector<int> &delays)
+{
+  m_texture.SetStream(stream, delays);
+
+  // only one texture is left
+  m_memUsage = 0;
+  if (!m_texture.m_textures.empty())
+    m_memUsage = sizeof(CTexture) + (m_texture.m_textures[0]->GetTextureWidth() * m_texture.m_textures[0]->GetTextureHeight() * 4);
+}
+
 void CTextureMap::Add(CBaseTexture* texture, int delay)
 {
   m_texture.Add(texture, delay);
@@ -218,6 +408,16 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
     m_memUsage += sizeof(CTexture) + (texture->GetTextureWidth() * texture->GetTextureHeight() * 4);
 }
 
+void CTextureMap::AddFromAtlas(CTextureAtlas *atlas, CBaseTexture *page, int x, int y)
+{
+  m_texture.Add(page, 100);
+  m_texture.m_texOffsetX = x;
+  m_texture.m_texOffsetY = y;
+  m_atlas = atlas;
+
+  m_memUsage += m_texture.m_width * m_texture.m_height * 4;
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -225,10 +425,13 @@ CGUITextureManager::CGUITextureManager(void)
 {
   // we set the theme bundle to be the first bundle (thus prioritizing it)
   m_TexBundle[0].SetThemeBundle(true);
+
+  CMemoryBudget::GetInstance().Register(this, "Unused textures", 10);
 }
 
 CGUITextureManager::~CGUITextureManager(void)
 {
+  CMemoryBudget::GetInstance().Unregister(this);
   Cleanup();
 }
 
@@ -398,29 +601,31 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
     CTextureMap* pMap = new CTextureMap(strTextureName, 0, 0, 0);
     unsigned int maxWidth = 0;
     unsigned int maxHeight = 0;
-    uint64_t maxMemoryUsage = 91238400;// 1920*1080*4*11 bytes, i.e, a total of approx. 12 full hd frames
+    std::vector<int> delays;
 
+    // short animations are kept decoded, for longer ones only the frame
+    // count and delays are gathered here and the frames are decoded while
+    // the animation plays
     auto frame = anim.ReadFrame();
     while (frame)
     {
-      CTexture *glTexture = new CTexture();
-      if (glTexture)
+      delays.push_back(frame->m_delay);
+      if (delays.size() <= ANIM_PREDECODE_FRAMES)
       {
+        CTexture *glTexture = new CTexture();
         glTexture->LoadFromMemory(anim.Width(), anim.Height(), frame->GetPitch(), XB_FMT_A8R8G8B8, true, frame->m_pImage);
         pMap->Add(glTexture, frame->m_delay);
         maxWidth = std::max(maxWidth, glTexture->GetWidth());
         maxHeight = std::max(maxHeight, glTexture->GetHeight());
       }
+      frame = anim.ReadFrame();
+    }
 
-      if (pMap->GetMemoryUsage() <= maxMemoryUsage)
-      {
-        frame = anim.ReadFrame();
-      } 
-      else
-      {
-        CLog::Log(LOGDEBUG, "Memory limit (%" PRIu64 " bytes) exceeded, %i frames extracted from file : %s", (maxMemoryUsage/11)*12,pMap->GetTexture().size(), CURL::GetRedacted(strPath).c_str());
-        break;
-      }
+    if (delays.size() > ANIM_PREDECODE_FRAMES)
+    {
+      CLog::Log(LOGDEBUG, "%s - streaming %u frames of %s", __FUNCTION__, static_cast<unsigned int>(delays.size()), CURL::GetRedacted(strPath).c_str());
+      std::vector<uint8_t> data(buf.get(), buf.get() + buf.size());
+      pMap->SetStream(std::make_shared<CAnimatedTextureStream>(mimeType, std::move(data), delays.size()), delays);
     }
 
     pMap->SetWidth((int)maxWidth);
@@ -454,7 +659,17 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
   if (!pTexture) return emptyTexture;
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
-  pMap->Add(pTexture, 100);
+  int x, y;
+  CBaseTexture *page = nullptr;
+  if (width == (int)pTexture->GetWidth() && height == (int)pTexture->GetHeight())
+    page = m_atlas.Add(pTexture, x, y);
+  if (page)
+  {
+    delete pTexture;
+    pMap->AddFromAtlas(&m_atlas, page, x, y);
+  }
+  else
+    pMap->Add(pTexture, 100);
   m_vecTextures.push_back(pMap);
 
 #ifdef _DEBUG_TEXTURES
@@ -497,8 +712,12 @@ void CGUITextureManager::ReleaseTexture(const std::string& strTextureName, bool
 
 void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
 {
+  if (m_freeUnused.exchange(false))
+    timeDelay = 0;
+
   unsigned int currFrameTime = XbmcThreads::SystemClockMillis();
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  size_t unusedMemory = 0;
   for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end();)
   {
     if (currFrameTime - i->second >= timeDelay)
@@ -507,8 +726,12 @@ void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
       i = m_unusedTextures.erase(i);
     }
     else
+    {
+      unusedMemory += i->first->GetMemoryUsage();
       ++i;
+    }
   }
+  m_unusedMemory = unusedMemory;
 
 #if defined(HAS_GL) || defined(HAS_GLES)
   for (unsigned int i = 0; i < m_unusedHwTextures.size(); ++i)
@@ -20,16 +20,21 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
+#include <memory>
 #include <vector>
 #include <utility>
 
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
+#include "utils/MemoryBudget.h"
 
 #include "GUIComponent.h"
 #include "ServiceBroker.h"
 
+class CAnimatedTextureStream;
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -45,20 +50,77 @@ public:
 
   void Add(CBaseTexture *texture, int delay);
   void Set(CBaseTexture *texture, int width, int height);
+  /*! \brief Play a long animation from a stream rather than from decoded frames.
+   Keeps the first texture to show the frames in and drops the others.
+   \param stream the decoder, starting out with the first texture showing frame 0.
+   \param delays the delays of all frames of the animation.
+   */
+  void SetStream(const std::shared_ptr<CAnimatedTextureStream> &stream, const std::vector<int> &delays);
   void Free();
   unsigned int size() const;
 
+  /*! \brief Get the texture to draw for a frame.
+   Only to be called from the rendering thread.
+   */
+  CBaseTexture* GetFrame(unsigned int frame) const;
+
   std::vector<CBaseTexture* > m_textures;
   std::vector<int> m_delays;
+  std::shared_ptr<CAnimatedTextureStream> m_stream; ///< set if the frames are decoded while playing
   int m_width;
   int m_height;
   int m_orientation;
   int m_loops;
   int m_texWidth;
   int m_texHeight;
+  int m_texOffsetX; ///< position of the image within the texture, for images in an atlas page
+  int m_texOffsetY;
   bool m_texCoordsArePixels;
 };
 
+/*!
+ \ingroup textures
+ \brief Packs small images into shared pages, so drawing them doesn't switch textures.
+ */
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+class CTextureAtlas
+{
+public:
+  CTextureAtlas() = default;
+  ~CTextureAtlas();
+
+  /*! \brief Copy an image into a page.
+   \param texture the loaded image, left untouched.
+   \param x,y [out] position of the image within the page.
+   \return the page, nullptr if the image isn't small enough or is in a format that can't be packed.
+   */
+  CBaseTexture* Add(const CBaseTexture *texture, int &x, int &y);
+
+  /*! \brief Drop one image of a page, the page is freed with its last image */
+  void Release(CBaseTexture *page);
+
+private:
+  struct Shelf
+  {
+    int y;
+    int height;
+    int x;
+  };
+  struct Page
+  {
+    CBaseTexture *texture;
+    std::vector<unsigned char> pixels;
+    std::vector<Shelf> shelves;
+    int size;
+    unsigned int images;
+  };
+  bool Place(Page &page, int width, int height, int &x, int &y);
+
+  std::vector<Page*> m_pages;
+};
+
 /*!
  \ingroup textures
  \brief
@@ -74,6 +136,8 @@ public:
   virtual ~CTextureMap();
 
   void Add(CBaseTexture* texture, int delay);
+  void SetStream(const std::shared_ptr<CAnimatedTextureStream> &stream, const std::vector<int> &delays);
+  void AddFromAtlas(CTextureAtlas *atlas, CBaseTexture *page, int x, int y);
   bool Release();
 
   const std::string& GetName() const;
@@ -91,6 +155,7 @@ protected:
   std::string m_textureName;
   unsigned int m_referenceCount;
   uint32_t m_memUsage;
+  CTextureAtlas *m_atlas = nullptr;
 };
 
 /*!
@@ -100,7 +165,7 @@ protected:
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
-class CGUITextureManager
+class CGUITextureManager : public IMemoryConsumer
 {
 public:
   CGUITextureManager(void);
@@ -123,6 +188,10 @@ public:
 
   void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
   void ReleaseHwTexture(unsigned int texture);
+
+  // IMemoryConsumer implementation, unused textures are freed on the next FreeUnusedTextures()
+  size_t GetMemoryBudgetUsage() const override { return m_unusedMemory; }
+  void OnMemoryPressure(MemoryPressure level) override { m_freeUnused = true; }
 protected:
   std::vector<CTextureMap*> m_vecTextures;
   std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
@@ -131,8 +200,12 @@ protected:
   typedef std::list<std::pair<CTextureMap*, unsigned int> >::iterator ilistUnused;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
+  CTextureAtlas m_atlas;
 
   std::vector<std::string> m_texturePaths;
   CCriticalSection m_section;
+
+  std::atomic<size_t> m_unusedMemory{0}; ///< of m_unusedTextures, as of the last FreeUnusedTextures()
+  std::atomic<bool> m_freeUnused{false};
 };
 
@@ -22,10 +22,16 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <system_error>
 
 #include "XBTFReader.h"
 #include "guilib/XBTF.h"
 #include "utils/EndianSwap.h"
+#include "utils/log.h"
+
+#ifdef TARGET_POSIX
+#include "platform/posix/utils/Mmap.h"
+#endif
 
 #ifdef TARGET_WINDOWS
 #include "filesystem/SpecialProtocol.h"
@@ -177,6 +183,23 @@ bool CXBTFReader::Open(const std::string& path)
   if (pos != GetHeaderSize())
     return false;
 
+#ifdef TARGET_POSIX
+  // frames are taken from the mapping, without seeking and reading each one
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == 0 && fileStat.st_size > 0)
+  {
+    try
+    {
+      m_mapping.reset(new KODI::UTILS::POSIX::CMmap(nullptr, static_cast<size_t>(fileStat.st_size),
+                                                    PROT_READ, MAP_SHARED, fileno(m_file), 0));
+    }
+    catch (const std::system_error& e)
+    {
+      CLog::Log(LOGDEBUG, "CXBTFReader: unable to map %s, reading frames instead: %s", m_path.c_str(), e.what());
+    }
+  }
+#endif
+
   return true;
 }
 
@@ -187,6 +210,10 @@ bool CXBTFReader::IsOpen() const
 
 void CXBTFReader::Close()
 {
+#ifdef TARGET_POSIX
+  m_mapping.reset();
+#endif
+
   if (m_file != nullptr)
   {
     fclose(m_file);
@@ -214,6 +241,13 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
   if (m_file == nullptr)
     return false;
 
+  const uint8_t* data = GetFrameData(frame);
+  if (data != nullptr)
+  {
+    memcpy(buffer, data, static_cast<size_t>(frame.GetPackedSize()));
+    return true;
+  }
+
 #if defined(TARGET_DARWIN) || defined(TARGET_FREEBSD)
   if (fseeko(m_file, static_cast<off_t>(frame.GetOffset()), SEEK_SET) == -1)
 #elif defined(TARGET_ANDROID)
@@ -228,3 +262,14 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
 
   return true;
 }
+
+const uint8_t* CXBTFReader::GetFrameData(const CXBTFFrame& frame) const
+{
+#ifdef TARGET_POSIX
+  if (m_mapping != nullptr && frame.GetOffset() <= m_mapping->Size() &&
+      frame.GetPackedSize() <= m_mapping->Size() - frame.GetOffset())
+    return static_cast<const uint8_t*>(m_mapping->Data()) + frame.GetOffset();
+#endif
+
+  return nullptr;
+}
@@ -27,6 +27,17 @@
 
 #include "XBTF.h"
 
+namespace KODI
+{
+namespace UTILS
+{
+namespace POSIX
+{
+class CMmap;
+}
+}
+}
+
 class CXBTFReader : public CXBTFBase
 {
 public:
@@ -41,9 +52,18 @@ public:
 
   bool Load(const CXBTFFrame& frame, unsigned char* buffer) const;
 
+  /*!
+   \brief Get the packed data of a frame without reading it.
+   \return the data inside the mapped file, nullptr if the file isn't mapped
+   */
+  const uint8_t* GetFrameData(const CXBTFFrame& frame) const;
+
 private:
   std::string m_path;
   FILE* m_file;
+#ifdef TARGET_POSIX
+  std::unique_ptr<KODI::UTILS::POSIX::CMmap> m_mapping;
+#endif
 };
 
 typedef std::shared_ptr<CXBTFReader> CXBTFReaderPtr;
@@ -428,6 +428,7 @@
 #define SYSTEM_CAN_SUSPEND          751
 #define SYSTEM_CAN_HIBERNATE        752
 #define SYSTEM_CAN_REBOOT           753
+#define SYSTEM_METRIC               754
 
 #define SLIDESHOW_ISPAUSED          800
 #define SLIDESHOW_ISRANDOM          801
@@ -656,6 +657,10 @@
 #define PLAYER_PROCESS_AUDIOCHANNELS (PLAYER_PROCESS + 9)
 #define PLAYER_PROCESS_AUDIOSAMPLERATE (PLAYER_PROCESS + 10)
 #define PLAYER_PROCESS_AUDIOBITSPERSAMPLE (PLAYER_PROCESS + 11)
+#define PLAYER_PROCESS_VIDEODECODETIME (PLAYER_PROCESS + 12)
+#define PLAYER_PROCESS_VIDEODECODETIMEMAX (PLAYER_PROCESS + 13)
+#define PLAYER_PROCESS_INPUTLATENCY (PLAYER_PROCESS + 14)
+#define PLAYER_PROCESS_INPUTLATENCYMAX (PLAYER_PROCESS + 15)
 
 #define WINDOW_PROPERTY             9993
 #define WINDOW_IS_VISIBLE           9995
@@ -352,6 +352,22 @@ bool CPlayerGUIInfo::GetLabel(std::string& value, const CFileItem *item, int con
     case PLAYER_PROCESS_AUDIOBITSPERSAMPLE:
       value = StringUtils::FormatNumber(CServiceBroker::GetDataCacheCore().GetAudioBitsPerSample());
       return true;
+    case PLAYER_PROCESS_VIDEODECODETIME:
+      if (CServiceBroker::GetDataCacheCore().GetVideoDecodeTime() > 0.0)
+        value = StringUtils::Format("%.1f", CServiceBroker::GetDataCacheCore().GetVideoDecodeTime());
+      return true;
+    case PLAYER_PROCESS_VIDEODECODETIMEMAX:
+      if (CServiceBroker::GetDataCacheCore().GetVideoDecodeTimeMax() > 0.0)
+        value = StringUtils::Format("%.1f", CServiceBroker::GetDataCacheCore().GetVideoDecodeTimeMax());
+      return true;
+    case PLAYER_PROCESS_INPUTLATENCY:
+      if (CServiceBroker::GetDataCacheCore().GetInputLatency() > 0.0)
+        value = StringUtils::Format("%.1f", CServiceBroker::GetDataCacheCore().GetInputLatency());
+      return true;
+    case PLAYER_PROCESS_INPUTLATENCYMAX:
+      if (CServiceBroker::GetDataCacheCore().GetInputLatencyMax() > 0.0)
+        value = StringUtils::Format("%.1f", CServiceBroker::GetDataCacheCore().GetInputLatencyMax());
+      return true;
 
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // PLAYLIST_*
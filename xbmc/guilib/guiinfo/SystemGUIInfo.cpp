@@ -20,6 +20,8 @@
 
 #include "guilib/guiinfo/SystemGUIInfo.h"
 
+#include <cmath>
+
 #include "Application.h"
 #include "LangInfo.h"
 #include "ServiceBroker.h"
@@ -43,6 +45,7 @@
 #include "storage/MediaManager.h"
 #include "utils/AlarmClock.h"
 #include "utils/CPUInfo.h"
+#include "utils/Metrics.h"
 #include "utils/StringUtils.h"
 #include "utils/SystemInfo.h"
 #include "utils/TimeUtils.h"
@@ -302,6 +305,18 @@ bool CSystemGUIInfo::GetLabel(std::string& value, const CFileItem *item, int con
     case SYSTEM_GET_CORE_USAGE:
       value = StringUtils::Format("%4.2f", g_cpuInfo.GetCoreInfo(std::atoi(info.GetData3().c_str())).m_fPct);
       return true;
+    case SYSTEM_METRIC:
+    {
+      double metric;
+      if (!CMetrics::GetInstance().GetValue(info.GetData3(), metric))
+        return false;
+      // counters are whole numbers, don't show them with decimals
+      if (metric == std::floor(metric))
+        value = StringUtils::Format("%.0f", metric);
+      else
+        value = StringUtils::Format("%.2f", metric);
+      return true;
+    }
     case SYSTEM_RENDER_VENDOR:
       value = CServiceBroker::GetRenderSystem()->GetRenderVendor();
       return true;
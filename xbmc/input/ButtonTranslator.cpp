@@ -134,6 +134,8 @@ bool CButtonTranslator::Load()
     }
   }
 
+  CompileActions();
+
   if (!success)
   {
     CLog::Log(LOGERROR, "Error loading keymaps from: %s or %s or %s",
@@ -196,24 +198,89 @@ bool CButtonTranslator::LoadKeymap(const std::string &keymapPath)
 CAction CButtonTranslator::GetAction(int window, const CKey &key, bool fallback)
 {
   std::string strAction;
+  const uint32_t code = key.GetButtonCode();
 
   // handle virtual windows
   window = CWindowTranslator::GetVirtualWindow(window);
 
+  if (!fallback)
+  {
+    unsigned int actionID = GetActionCode(window, code, strAction);
+    return CAction(actionID, strAction, key);
+  }
+
+  // windows without mappings of their own resolve like their first fallback with some
+  int compiledWindow = window;
+  auto it = m_compiledMap.find(compiledWindow);
+  while (it == m_compiledMap.end() && compiledWindow > -1)
+  {
+    compiledWindow = CWindowTranslator::GetFallbackWindow(compiledWindow);
+    it = m_compiledMap.find(compiledWindow);
+  }
+
+  if (it != m_compiledMap.end())
+  {
+    auto it2 = it->second.find(code);
+    if (it2 != it->second.end())
+      return CAction(it2->second.id, it2->second.strID, key);
+  }
+
+  // not mapped anywhere, but the lookup can still strip modifiers
+  unsigned int actionID = GetFallbackActionCode(window, code, strAction);
+
+  return CAction(actionID, strAction, key);
+}
+
+unsigned int CButtonTranslator::GetFallbackActionCode(int window, uint32_t code, std::string &strAction) const
+{
   // try to get the action from the current window
-  unsigned int actionID = GetActionCode(window, key, strAction);
+  unsigned int actionID = GetActionCode(window, code, strAction);
+
+  // if it's invalid, try to get it from fallback windows or the global map (window == -1)
+  while (actionID == ACTION_NONE && window > -1)
+  {
+    window = CWindowTranslator::GetFallbackWindow(window);
+    actionID = GetActionCode(window, code, strAction);
+  }
+
+  return actionID;
+}
+
+void CButtonTranslator::CompileActions()
+{
+  m_compiledMap.clear();
 
-  if (fallback)
+  for (const auto &windowMap : m_translatorMap)
   {
-    // if it's invalid, try to get it from fallback windows or the global map (window == -1)
-    while (actionID == ACTION_NONE && window > -1)
+    const int windowID = windowMap.first;
+
+    // every button the lookup of this window can end at, pressed short and long
+    std::set<uint32_t> codes;
+    for (int window = windowID; ; window = CWindowTranslator::GetFallbackWindow(window))
     {
-      window = CWindowTranslator::GetFallbackWindow(window);
-      actionID = GetActionCode(window, key, strAction);
+      auto it = m_translatorMap.find(window);
+      if (it != m_translatorMap.end())
+      {
+        for (const auto &button : it->second)
+        {
+          codes.insert(button.first);
+          codes.insert(button.first | CKey::MODIFIER_LONG);
+        }
+      }
+      if (window <= -1)
+        break;
     }
-  }
 
-  return CAction(actionID, strAction, key);
+    actionTable &table = m_compiledMap[windowID];
+    table.reserve(codes.size());
+    for (uint32_t code : codes)
+    {
+      CButtonAction action;
+      action.id = GetFallbackActionCode(windowID, code, action.strID);
+      if (action.id != ACTION_NONE)
+        table.insert(std::make_pair(code, std::move(action)));
+    }
+  }
 }
 
 bool CButtonTranslator::HasLongpressMapping(int window, const CKey &key)
@@ -262,10 +329,8 @@ bool CButtonTranslator::HasLongpressMapping_Internal(int window, const CKey &key
   return false;
 }
 
-unsigned int CButtonTranslator::GetActionCode(int window, const CKey &key, std::string &strAction) const
+unsigned int CButtonTranslator::GetActionCode(int window, uint32_t code, std::string &strAction) const
 {
-  uint32_t code = key.GetButtonCode();
-
   std::map<int, buttonMap>::const_iterator it = m_translatorMap.find(window);
   if (it == m_translatorMap.end())
     return ACTION_NONE;
@@ -407,6 +472,7 @@ void CButtonTranslator::MapWindowActions(const TiXmlNode *pWindow, int windowID)
 void CButtonTranslator::Clear()
 {
   m_translatorMap.clear();
+  m_compiledMap.clear();
 
   for (auto it : m_buttonMappers)
     it.second->Clear();
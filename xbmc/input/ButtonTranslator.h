@@ -22,6 +22,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 
 #include "Action.h"
 
@@ -86,10 +87,18 @@ private:
   // m_translatorMap contains all mappings i.e. m_BaseMap + HID device mappings
   std::map<int, buttonMap> m_translatorMap;
 
+  // m_compiledMap contains the result of the fallback lookup for every button
+  // mapped in a window or its fallbacks, rebuilt by Load()
+  using actionTable = std::unordered_map<uint32_t, CButtonAction>;
+  std::unordered_map<int, actionTable> m_compiledMap;
+
   // m_deviceList contains the list of connected HID devices
   std::set<std::string> m_deviceList;
 
-  unsigned int GetActionCode(int window, const CKey &key, std::string &strAction) const;
+  unsigned int GetActionCode(int window, uint32_t code, std::string &strAction) const;
+  unsigned int GetFallbackActionCode(int window, uint32_t code, std::string &strAction) const;
+
+  void CompileActions();
 
   void MapWindowActions(const TiXmlNode *pWindow, int wWindowID);
   void MapAction(uint32_t buttonCode, const std::string &szAction, buttonMap &map);
@@ -22,8 +22,8 @@
 #include "IKeymap.h"
 #include "input/joysticks/JoystickTypes.h"
 
-#include <map>
 #include <string>
+#include <unordered_map>
 
 class CWindowKeymap : public IWindowKeymap
 {
@@ -40,10 +40,10 @@ private:
   const std::string m_controllerId;
 
   using KeyName = std::string;
-  using Keymap = std::map<KeyName, KODI::JOYSTICK::KeymapActionGroup>;
+  using Keymap = std::unordered_map<KeyName, KODI::JOYSTICK::KeymapActionGroup>;
 
   using WindowID = int;
-  using WindowMap = std::map<WindowID, Keymap>;
+  using WindowMap = std::unordered_map<WindowID, Keymap>;
 
   WindowMap m_windowKeymap;
 };
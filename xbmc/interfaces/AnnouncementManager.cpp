@@ -25,6 +25,7 @@
 #include "utils/Variant.h"
 #include "utils/StringUtils.h"
 #include "FileItem.h"
+#include "interfaces/json-rpc/JSONUtils.h"
 #include "music/tags/MusicInfoTag.h"
 #include "music/MusicDatabase.h"
 #include "video/VideoDatabase.h"
@@ -118,12 +119,60 @@ void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, c
     announcement.item = CFileItemPtr(new CFileItem(*item));
 
   {
-    CSingleLock lock (m_critSection);
+    CSingleLock lock (m_queueCritSection);
+    if (Coalesce(announcement))
+      return;
     m_announcementQueue.push_back(announcement);
   }
   m_queueEvent.Set();
 }
 
+bool CAnnouncementManager::Coalesce(const CAnnounceData &announcement)
+{
+  // only the last one, merging with an older one would reorder the announcements in between
+  if (m_announcementQueue.empty())
+    return false;
+
+  CAnnounceData &queued = m_announcementQueue.back();
+  if (queued.flag != announcement.flag || queued.sender != announcement.sender || queued.message != announcement.message)
+    return false;
+
+  if (announcement.flag == Application && announcement.message == "OnVolumeChanged")
+  {
+    queued.data = announcement.data;
+    return true;
+  }
+
+  const CVariant &queuedData = queued.data;
+  if (announcement.flag != Player ||
+      queuedData["player"]["playerid"] != announcement.data["player"]["playerid"])
+    return false;
+
+  if (announcement.message == "OnSeek")
+  {
+    if (queued.item == nullptr || announcement.item == nullptr || queued.item->GetPath() != announcement.item->GetPath())
+      return false;
+
+    // the offset is the sum of both seeks, everything else is the state after the last one
+    int seekOffset = JSONRPC::CJSONUtils::TimeObjectToMilliseconds(queuedData["player"]["seekoffset"]) +
+                     JSONRPC::CJSONUtils::TimeObjectToMilliseconds(announcement.data["player"]["seekoffset"]);
+    queued.data = announcement.data;
+    JSONRPC::CJSONUtils::MillisecondsToTimeObject(seekOffset, queued.data["player"]["seekoffset"]);
+    queued.item = announcement.item;
+    return true;
+  }
+
+  if (announcement.message == "OnPropertyChanged" && queued.item == nullptr && announcement.item == nullptr)
+  {
+    const CVariant &properties = announcement.data["property"];
+    for (CVariant::const_iterator_map it = properties.begin_map(); it != properties.end_map(); ++it)
+      queued.data["property"][it->first] = it->second;
+    return true;
+  }
+
+  return false;
+}
+
 void CAnnouncementManager::DoAnnounce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
   CLog::Log(LOGDEBUG, "CAnnouncementManager - Announcement: %s from %s", message, sender);
@@ -289,19 +338,19 @@ void CAnnouncementManager::Process()
 
   while (!m_bStop)
   {
-    CSingleLock lock (m_critSection);
+    CSingleLock lock (m_queueCritSection);
     if (!m_announcementQueue.empty())
     {
       auto announcement = m_announcementQueue.front();
       m_announcementQueue.pop_front();
       {
-        CSingleExit ex(m_critSection);
+        CSingleExit ex(m_queueCritSection);
         DoAnnounce(announcement.flag, announcement.sender.c_str(), announcement.message.c_str(), announcement.item, announcement.data);
       }
     }
     else
     {
-      CSingleExit ex(m_critSection);
+      CSingleExit ex(m_queueCritSection);
       m_queueEvent.Wait();
     }
   }
@@ -73,7 +73,15 @@ namespace ANNOUNCEMENT
     CAnnouncementManager(const CAnnouncementManager&) = delete;
     CAnnouncementManager const& operator=(CAnnouncementManager const&) = delete;
 
-    CCriticalSection m_critSection;
+    /*!
+     \brief Merge an announcement into the last queued one if both report the same
+     frequently changing state, e.g. while a slider is dragged.
+     \return true if the announcement was merged and must not be queued.
+     */
+    bool Coalesce(const CAnnounceData &announcement);
+
+    CCriticalSection m_critSection;       ///< held while announcers are called
     std::vector<IAnnouncer *> m_announcers;
+    CCriticalSection m_queueCritSection;  ///< never held while announcers are called, announcing doesn't wait for them
   };
 }
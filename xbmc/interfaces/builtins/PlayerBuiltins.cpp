@@ -49,6 +49,10 @@
 #include "Autorun.h"
 #endif
 
+#ifdef HAS_GL
+#include "cores/VideoPlayer/VideoRenderers/RenderBenchmark.h"
+#endif
+
 /*! \brief Clear current playlist
  *  \param params (ignored)
  */
@@ -502,6 +506,37 @@ static int PlayWith(const std::vector<std::string>& params)
  *  \param params The parameters.
  *  \details params[0] = Number of seconds to seek.
  */
+#ifdef HAS_GL
+/*! \brief Benchmark the video renderer scaling and deinterlacing paths.
+ *  \param params The parameters.
+ *  \details params[0] = output file (optional).
+ *           params[1] = width of the synthetic source (optional).
+ *           params[2] = height of the synthetic source (optional).
+ *           params[3] = number of frames per method (optional).
+ */
+static int RenderBenchmark(const std::vector<std::string>& params)
+{
+  if (g_application.GetAppPlayer().IsPlaying())
+  {
+    CLog::Log(LOGERROR, "RenderBenchmark called while playing");
+    return -1;
+  }
+
+  CRenderBenchmark::CParams benchmark;
+  if (params.size() > 0 && !params[0].empty())
+    benchmark.file = params[0];
+  if (params.size() > 2)
+  {
+    benchmark.width = atoi(params[1].c_str());
+    benchmark.height = atoi(params[2].c_str());
+  }
+  if (params.size() > 3)
+    benchmark.frames = atoi(params[3].c_str());
+
+  return CRenderBenchmark::Run(benchmark) ? 0 : -1;
+}
+#endif
+
 static int Seek(const std::vector<std::string>& params)
 {
   if (g_application.GetAppPlayer().IsPlaying())
@@ -581,6 +616,18 @@ static int Seek(const std::vector<std::string>& params)
 ///     @param[in] core                  Name of playback core.
 ///   }
 ///   \table_row2_l{
+///     <b>`RenderBenchmark([file][\,width\,height][\,frames])`</b>
+///     ,
+///     Measures the GPU time per frame of every supported video scaling method\,
+///     progressive and with render bob deinterlacing\, using synthetic frames. The
+///     results are written as JSON. Only available with OpenGL and while nothing
+///     is playing.
+///     @param[in] file                  Output file\, defaults to special://temp/renderbenchmark.json (optional).
+///     @param[in] width                 Width of the synthetic frames (optional).
+///     @param[in] height                Height of the synthetic frames (optional).
+///     @param[in] frames                Number of frames measured per method (optional).
+///   }
+///   \table_row2_l{
 ///     <b>`Seek(seconds)`</b>
 ///     ,
 ///     Seeks to the specified relative amount of seconds within the current
@@ -600,6 +647,9 @@ CBuiltins::CommandMap CPlayerBuiltins::GetOperations() const
            {"playercontrol",       {"Control the music or video player", 1, PlayerControl}},
            {"playmedia",           {"Play the specified media file (or playlist)", 1, PlayMedia}},
            {"playwith",            {"Play the selected item with the specified core", 1, PlayWith}},
+#ifdef HAS_GL
+           {"renderbenchmark",     {"Measures the GPU time of the video scaling and deinterlacing methods", 0, RenderBenchmark}},
+#endif
            {"seek",                {"Performs a seek in seconds on the current playing media file", 1, Seek}}
          };
 }
@@ -20,8 +20,11 @@
 
 #include "SystemBuiltins.h"
 
+#include "CompileInfo.h"
+#include "filesystem/SpecialProtocol.h"
 #include "messaging/ApplicationMessenger.h"
 #include "utils/StringUtils.h"
+#include "utils/Trace.h"
 
 using namespace KODI::MESSAGING;
 
@@ -142,6 +145,36 @@ static int Suspend(const std::vector<std::string>& params)
   return 0;
 }
 
+/*! \brief Start recording a trace.
+ *  \param params The parameters.
+ *  \details params[0] = The file to write the trace to (optional).
+ */
+static int StartTrace(const std::vector<std::string>& params)
+{
+  std::string file;
+  if (!params.empty())
+    file = params[0];
+  else
+  {
+    std::string appName = CCompileInfo::GetAppName();
+    StringUtils::ToLower(appName);
+    file = "special://logpath/" + appName + ".trace.json";
+  }
+  CTrace::Start(CSpecialProtocol::TranslatePath(file));
+
+  return 0;
+}
+
+/*! \brief Stop recording a trace and write it.
+ *  \param params (ignored)
+ */
+static int StopTrace(const std::vector<std::string>& params)
+{
+  CTrace::Stop();
+
+  return 0;
+}
+
 
 // Note: For new Texts with comma add a "\" before!!! Is used for table text.
 //
@@ -211,6 +244,18 @@ static int Suspend(const std::vector<std::string>& params)
 ///     Trigger default Shutdown action defined in System Settings
 ///   }
 ///   \table_row2_l{
+///     <b>`StartTrace([file])`</b>
+///     ,
+///     Records what the player\, GUI\, jobs\, network and database do until StopTrace
+///     @param[in] file                  The file to write the trace to\, viewable in chrome://tracing
+///                                      or the Perfetto UI (optional\, default special://logpath/kodi.trace.json).
+///   }
+///   \table_row2_l{
+///     <b>`StopTrace`</b>
+///     ,
+///     Stops recording and writes the trace started by StartTrace
+///   }
+///   \table_row2_l{
 ///     <b>`Suspend`</b>
 ///     ,
 ///     Suspends (S3 / S1 depending on bios setting) the System
@@ -244,6 +289,8 @@ CBuiltins::CommandMap CSystemBuiltins::GetOperations() const
            {"restart",             {"Restart the system (same as reboot)", 0, Reboot}},
            {"restartapp",          {"Restart Kodi", 0, RestartApp}},
            {"shutdown",            {"Shutdown the system", 0, Shutdown}},
+           {"starttrace",          {"Start recording a trace", 0, StartTrace}},
+           {"stoptrace",           {"Stop recording a trace and write it", 0, StopTrace}},
            {"suspend",             {"Suspends the system", 0, Suspend}},
            {"system.exec",         {"Execute shell commands", 1, Exec<0>}},
            {"system.execwait",     {"Execute shell commands and freezes Kodi until shell is closed", 1, Exec<1>}}
@@ -27,6 +27,7 @@
 ILanguageInvoker::ILanguageInvoker(ILanguageInvocationHandler *invocationHandler)
   : m_id(-1),
     m_state(InvokerStateUninitialized),
+    m_reusable(false),
     m_invocationHandler(invocationHandler)
 { }
 
@@ -55,6 +56,15 @@ bool ILanguageInvoker::IsRunning() const
   return GetState() == InvokerStateRunning;
 }
 
+bool ILanguageInvoker::Reset()
+{
+  if (IsActive())
+    return false;
+
+  m_state = InvokerStateUninitialized;
+  return true;
+}
+
 bool ILanguageInvoker::IsStopping() const
 {
   return GetState() == InvokerStateStopping;
@@ -55,6 +55,23 @@ public:
   bool IsActive() const;
   bool IsRunning() const;
 
+  /*!
+   * \brief Whether the invoker may keep the language runtime it set up for
+   * executing further scripts of the same add-on, see Reset().
+   */
+  void SetReusable(bool reusable) { m_reusable = reusable; }
+  bool IsReusable() const { return m_reusable; }
+
+  /*!
+   * \brief Prepares a finished invoker for executing another script.
+   *
+   * \details Used by CLanguageInvokerThread for add-ons that opted into
+   * reusing their invoker, which keeps the language runtime it set up.
+   *
+   * \return false if the invoker can't execute another script
+   */
+  virtual bool Reset();
+
 protected:
   friend class CLanguageInvokerThread;
 
@@ -67,6 +84,8 @@ protected:
   virtual void onExecutionFailed();
   virtual void onExecutionDone();
   virtual void onExecutionFinalized();
+  // frees what a reusable invoker kept between scripts, on the executing thread
+  virtual void onExecutionReleased() { }
 
   void setState(InvokerState state);
 
@@ -75,6 +94,7 @@ protected:
 private:
   int m_id;
   InvokerState m_state;
+  bool m_reusable;
   ILanguageInvocationHandler *m_invocationHandler;
 };
 
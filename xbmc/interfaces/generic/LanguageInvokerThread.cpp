@@ -20,13 +20,18 @@
 
 #include "LanguageInvokerThread.h"
 #include "ScriptInvocationManager.h"
+#include "addons/AddonResourceUsage.h"
+#include "threads/SingleLock.h"
 
-CLanguageInvokerThread::CLanguageInvokerThread(LanguageInvokerPtr invoker, CScriptInvocationManager *invocationManager)
+CLanguageInvokerThread::CLanguageInvokerThread(LanguageInvokerPtr invoker, CScriptInvocationManager *invocationManager, bool reusable /* = false */)
   : ILanguageInvoker(NULL),
     CThread("LanguageInvoker"),
     m_invoker(invoker),
-    m_invocationManager(invocationManager)
-{ }
+    m_invocationManager(invocationManager),
+    m_idle(false)
+{
+  SetReusable(reusable);
+}
 
 CLanguageInvokerThread::~CLanguageInvokerThread()
 {
@@ -41,6 +46,25 @@ InvokerState CLanguageInvokerThread::GetState()
   return m_invoker->GetState();
 }
 
+bool CLanguageInvokerThread::IsIdle() const
+{
+  CSingleLock lock(m_critical);
+  return m_idle;
+}
+
+bool CLanguageInvokerThread::Reuse(const std::string &script, const std::vector<std::string> &arguments)
+{
+  CSingleLock lock(m_critical);
+  if (!m_idle)
+    return false;
+
+  m_idle = false;
+  m_script = script;
+  m_args = arguments;
+  m_reuseEvent.Set();
+  return true;
+}
+
 bool CLanguageInvokerThread::execute(const std::string &script, const std::vector<std::string> &arguments)
 {
   if (m_invoker == NULL || script.empty())
@@ -69,6 +93,11 @@ bool CLanguageInvokerThread::stop(bool wait)
     // stop the thread
     CThread::StopThread(wait);
   }
+  else if (IsReusable())
+  {
+    // waiting for the next script
+    CThread::StopThread(wait);
+  }
 
   return result;
 }
@@ -79,6 +108,7 @@ void CLanguageInvokerThread::OnStartup()
     return;
 
   m_invoker->SetId(GetId());
+  m_invoker->SetReusable(IsReusable());
   if (m_addon != NULL)
     m_invoker->SetAddon(m_addon);
 }
@@ -88,7 +118,41 @@ void CLanguageInvokerThread::Process()
   if (m_invoker == NULL)
     return;
 
+  // the script's CPU time counts for its add-on
+  std::string addonId = m_addon != NULL ? m_addon->ID() : "";
+  ADDON::CAddonResourceUsage::ThreadStarted(addonId);
   m_invoker->Execute(m_script, m_args);
+  ADDON::CAddonResourceUsage::ThreadStopped();
+
+  // a reusable invoker keeps what it set up and waits for the next script
+  while (IsReusable() && !m_bStop && m_invoker->Reset())
+  {
+    // once idle the invocation manager may hand out the next id
+    int id = GetId();
+    {
+      CSingleLock lock(m_critical);
+      m_idle = true;
+    }
+    m_invoker->onExecutionDone();
+    m_invocationManager->OnScriptEnded(id);
+
+    if (AbortableWait(m_reuseEvent) != WAIT_SIGNALED)
+      break;
+
+    m_invoker->SetId(GetId());
+    ADDON::CAddonResourceUsage::ThreadStarted(addonId);
+    m_invoker->Execute(m_script, m_args);
+    ADDON::CAddonResourceUsage::ThreadStopped();
+  }
+
+  if (IsReusable())
+  {
+    {
+      CSingleLock lock(m_critical);
+      m_idle = false;
+    }
+    m_invoker->onExecutionReleased();
+  }
 }
 
 void CLanguageInvokerThread::OnExit()
@@ -23,6 +23,8 @@
 #include <vector>
 
 #include "interfaces/generic/ILanguageInvoker.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "threads/Thread.h"
 
 class CScriptInvocationManager;
@@ -30,11 +32,23 @@ class CScriptInvocationManager;
 class CLanguageInvokerThread : public ILanguageInvoker, protected CThread
 {
 public:
-  CLanguageInvokerThread(LanguageInvokerPtr invoker, CScriptInvocationManager *invocationManager);
+  CLanguageInvokerThread(LanguageInvokerPtr invoker, CScriptInvocationManager *invocationManager, bool reusable = false);
   ~CLanguageInvokerThread() override;
 
   virtual InvokerState GetState();
 
+  /*!
+   * \brief Whether a reusable thread finished its script and waits for the next one.
+   */
+  bool IsIdle() const;
+  /*!
+   * \brief Executes another script on an idle reusable thread, with the
+   * invoker and language runtime set up for the previous one.
+   *
+   * \return false if the thread isn't idle (anymore)
+   */
+  bool Reuse(const std::string &script, const std::vector<std::string> &arguments);
+
 protected:
   bool execute(const std::string &script, const std::vector<std::string> &arguments) override;
   bool stop(bool wait) override;
@@ -49,4 +63,8 @@ private:
   CScriptInvocationManager *m_invocationManager;
   std::string m_script;
   std::vector<std::string> m_args;
+
+  bool m_idle;
+  CEvent m_reuseEvent;
+  mutable CCriticalSection m_critical;
 };
\ No newline at end of file
@@ -29,6 +29,7 @@
 #include "interfaces/generic/ILanguageInvoker.h"
 #include "interfaces/generic/LanguageInvokerThread.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
@@ -37,6 +38,8 @@
 #include "platform/linux/XTimeUtils.h"
 #endif
 
+#define REUSABLE_INVOKER_IDLE_TIME 60000 // ms
+
 using namespace XFILE;
 
 CScriptInvocationManager::CScriptInvocationManager()
@@ -72,14 +75,39 @@ void CScriptInvocationManager::Process()
 
   // remove the finished scripts from the script path map as well
   for (std::vector<LanguageInvokerThread>::const_iterator it = tempList.begin(); it != tempList.end(); ++it)
+  {
     m_scriptPaths.erase(it->script);
 
+    // keep idle reusable threads for the next execution of their script
+    if (it->thread->IsReusable() && it->thread->IsIdle() &&
+        m_reusableThreads.find(it->script) == m_reusableThreads.end())
+    {
+      ReusableInvokerThread reusable = { it->thread, XbmcThreads::SystemClockMillis() };
+      m_reusableThreads.insert(std::make_pair(it->script, reusable));
+    }
+  }
+
+  // and drop those which weren't needed for a while
+  std::vector<CLanguageInvokerThreadPtr> expiredList;
+  for (ReusableInvokerThreadMap::iterator it = m_reusableThreads.begin(); it != m_reusableThreads.end(); )
+  {
+    if (!it->second.thread->IsIdle() ||
+        XbmcThreads::SystemClockMillis() - it->second.idleSince > REUSABLE_INVOKER_IDLE_TIME)
+    {
+      expiredList.push_back(it->second.thread);
+      m_reusableThreads.erase(it++);
+    }
+    else
+      ++it;
+  }
+
   // we can leave the lock now
   lock.Leave();
 
   // finally remove the finished threads but we do it outside of any locks in
   // case of any callbacks from the destruction of the CLanguageInvokerThread
   tempList.clear();
+  expiredList.clear();
 
   // let the invocation handlers do their processing
   for (LanguageInvocationHandlerMap::iterator it = m_invocationHandlers.begin(); it != m_invocationHandlers.end(); ++it)
@@ -98,8 +126,13 @@ void CScriptInvocationManager::Uninitialize()
   for (LanguageInvokerThreadMap::iterator script = m_scripts.begin(); script != m_scripts.end(); ++script)
     tempList.push_back(script->second);
 
+  std::vector<CLanguageInvokerThreadPtr> reusableList;
+  for (ReusableInvokerThreadMap::iterator it = m_reusableThreads.begin(); it != m_reusableThreads.end(); ++it)
+    reusableList.push_back(it->second.thread);
+
   m_scripts.clear();
   m_scriptPaths.clear();
+  m_reusableThreads.clear();
 
   // we can leave the lock now
   lock.Leave();
@@ -114,6 +147,10 @@ void CScriptInvocationManager::Uninitialize()
   }
   tempList.clear();
 
+  for (std::vector<CLanguageInvokerThreadPtr>::iterator it = reusableList.begin(); it != reusableList.end(); ++it)
+    (*it)->Stop(true);
+  reusableList.clear();
+
   lock.Enter();
   // uninitialize all invocation handlers and then remove them
   for (LanguageInvocationHandlerMap::iterator it = m_invocationHandlers.begin(); it != m_invocationHandlers.end(); ++it)
@@ -215,11 +252,26 @@ int CScriptInvocationManager::ExecuteAsync(const std::string &script, const ADDO
     return -1;
   }
 
+  // add-ons opt into keeping the interpreter between executions of a script
+  bool reuseInvoker = false;
+  if (addon != NULL)
+  {
+    ADDON::InfoMap::const_iterator reuse = addon->ExtraInfo().find("reuselanguageinvoker");
+    reuseInvoker = reuse != addon->ExtraInfo().end() && reuse->second == "true";
+  }
+
+  if (reuseInvoker)
+  {
+    int id = reuseInvokerThread(script, addon, arguments);
+    if (id >= 0)
+      return id;
+  }
+
   LanguageInvokerPtr invoker = GetLanguageInvoker(script);
-  return ExecuteAsync(script, invoker, addon, arguments);
+  return ExecuteAsync(script, invoker, addon, arguments, reuseInvoker);
 }
 
-int CScriptInvocationManager::ExecuteAsync(const std::string &script, LanguageInvokerPtr languageInvoker, const ADDON::AddonPtr &addon /* = ADDON::AddonPtr() */, const std::vector<std::string> &arguments /* = std::vector<std::string>() */)
+int CScriptInvocationManager::ExecuteAsync(const std::string &script, LanguageInvokerPtr languageInvoker, const ADDON::AddonPtr &addon /* = ADDON::AddonPtr() */, const std::vector<std::string> &arguments /* = std::vector<std::string>() */, bool reuseInvoker /* = false */)
 {
   if (script.empty() || languageInvoker == NULL)
     return -1;
@@ -230,7 +282,7 @@ int CScriptInvocationManager::ExecuteAsync(const std::string &script, LanguageIn
     return -1;
   }
 
-  CLanguageInvokerThreadPtr invokerThread = CLanguageInvokerThreadPtr(new CLanguageInvokerThread(languageInvoker, this));
+  CLanguageInvokerThreadPtr invokerThread = CLanguageInvokerThreadPtr(new CLanguageInvokerThread(languageInvoker, this, reuseInvoker));
   if (invokerThread == NULL)
     return -1;
 
@@ -349,6 +401,36 @@ void CScriptInvocationManager::OnScriptEnded(int scriptId)
     script->second.done = true;
 }
 
+int CScriptInvocationManager::reuseInvokerThread(const std::string &script, const ADDON::AddonPtr &addon, const std::vector<std::string> &arguments)
+{
+  // declared before the lock so a dropped thread is destroyed outside of it
+  CLanguageInvokerThreadPtr invokerThread;
+
+  CSingleLock lock(m_critSection);
+  ReusableInvokerThreadMap::iterator reusable = m_reusableThreads.find(script);
+  if (reusable == m_reusableThreads.end())
+    return -1;
+
+  invokerThread = reusable->second.thread;
+  m_reusableThreads.erase(reusable);
+
+  // an updated add-on gets a fresh interpreter
+  if (invokerThread->GetAddon() == NULL || invokerThread->GetAddon()->Version() != addon->Version())
+    return -1;
+
+  int id = m_nextId++;
+  invokerThread->SetId(id);
+  if (!invokerThread->Reuse(script, arguments))
+    return -1;
+
+  LanguageInvokerThread thread = { invokerThread, script, false };
+  m_scripts.insert(std::make_pair(id, thread));
+  m_scriptPaths.insert(std::make_pair(script, id));
+
+  CLog::Log(LOGDEBUG, "%s - reusing the language invoker of %s", __FUNCTION__, script.c_str());
+  return id;
+}
+
 CScriptInvocationManager::LanguageInvokerThread CScriptInvocationManager::getInvokerThread(int scriptId) const
 {
   if (scriptId < 0)
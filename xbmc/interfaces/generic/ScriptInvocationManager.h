@@ -48,6 +48,10 @@ public:
   /*!
    * \brief Executes the given script asynchronously in a separate thread.
    *
+   * \details Add-ons with <reuselanguageinvoker>true</reuselanguageinvoker> in
+   * their metadata keep the thread and the language runtime of a finished
+   * script for a while, the next execution of the same script reuses them.
+   *
    * \param script Path to the script to be executed
    * \param addon (Optional) Addon to which the script belongs
    * \param arguments (Optional) List of arguments passed to the script
@@ -61,9 +65,10 @@ public:
   * \param languageInvoker Language invoker to be used to execute the script
   * \param addon (Optional) Addon to which the script belongs
   * \param arguments (Optional) List of arguments passed to the script
+  * \param reuseInvoker (Optional) Whether to keep the thread and the invoker for the next execution of the script
   * \return -1 if an error occurred, otherwise the ID of the script
   */
-  int ExecuteAsync(const std::string &script, LanguageInvokerPtr languageInvoker, const ADDON::AddonPtr &addon = ADDON::AddonPtr(), const std::vector<std::string> &arguments = std::vector<std::string>());
+  int ExecuteAsync(const std::string &script, LanguageInvokerPtr languageInvoker, const ADDON::AddonPtr &addon = ADDON::AddonPtr(), const std::vector<std::string> &arguments = std::vector<std::string>(), bool reuseInvoker = false);
 
   /*!
   * \brief Executes the given script synchronously.
@@ -125,11 +130,19 @@ private:
   typedef std::map<int, LanguageInvokerThread> LanguageInvokerThreadMap;
   typedef std::map<std::string, ILanguageInvocationHandler*> LanguageInvocationHandlerMap;
 
+  typedef struct {
+    CLanguageInvokerThreadPtr thread;
+    unsigned int idleSince;
+  } ReusableInvokerThread;
+  typedef std::map<std::string, ReusableInvokerThread> ReusableInvokerThreadMap;
+
   LanguageInvokerThread getInvokerThread(int scriptId) const;
+  int reuseInvokerThread(const std::string &script, const ADDON::AddonPtr &addon, const std::vector<std::string> &arguments);
 
   LanguageInvocationHandlerMap m_invocationHandlers;
   LanguageInvokerThreadMap m_scripts;
   std::map<std::string, int> m_scriptPaths;
+  ReusableInvokerThreadMap m_reusableThreads;
   int m_nextId;
   CCriticalSection m_critSection;
 };
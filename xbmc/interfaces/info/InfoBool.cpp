@@ -27,9 +27,10 @@ namespace INFO
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
+      m_dependency(InfoDependency::ANY),
       m_expression(expression),
       m_refreshCounter(0),
-      m_parentRefreshCounter(refreshCounter)
+      m_parentRefreshCounter(&refreshCounter)
   {
     StringUtils::ToLower(m_expression);
   }
@@ -27,6 +27,18 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief State the value of an info bool depends on, from least to most volatile.
+ Info bools are evaluated again only once their state has changed.
+ */
+enum class InfoDependency
+{
+  NONE,   ///< fixed for the session, e.g. the platform
+  SKIN,   ///< skin settings, see CGUIInfoManager::ResetSkinCache
+  ANY     ///< anything else, evaluated again every frame
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -47,10 +59,10 @@ public:
   {
     if (item && m_listItemDependent)
       Update(item);
-    else if (m_refreshCounter != m_parentRefreshCounter || m_refreshCounter == 0)
+    else if (m_refreshCounter != *m_parentRefreshCounter || m_refreshCounter == 0)
     {
       Update(NULL);
-      m_refreshCounter = m_parentRefreshCounter;
+      m_refreshCounter = *m_parentRefreshCounter;
     }
     return m_value;
   }
@@ -78,16 +90,22 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+  InfoDependency GetDependency() const { return m_dependency; }
+
+  /*! \brief Set the counter telling when the state this info bool depends on has changed
+   */
+  void SetRefreshCounter(unsigned int &refreshCounter) { m_parentRefreshCounter = &refreshCounter; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  InfoDependency m_dependency; ///< state the value depends on
   std::string  m_expression;   ///< original expression
 
 private:
   unsigned int m_refreshCounter;
-  unsigned int &m_parentRefreshCounter;
+  unsigned int *m_parentRefreshCounter;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
@@ -19,6 +19,7 @@
  */
 
 #include "InfoExpression.h"
+#include <algorithm>
 #include <stack>
 #include "utils/log.h"
 #include "GUIInfoManager.h"
@@ -31,7 +32,9 @@ using namespace INFO;
 
 void InfoSingle::Initialize()
 {
-  m_condition = CServiceBroker::GetGUI()->GetInfoManager().TranslateSingleString(m_expression, m_listItemDependent);
+  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
+  m_condition = infoMgr.TranslateSingleString(m_expression, m_listItemDependent);
+  m_dependency = m_listItemDependent ? InfoDependency::ANY : infoMgr.GetDependency(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -41,10 +44,13 @@ void InfoSingle::Update(const CGUIListItem *item)
 
 void InfoExpression::Initialize()
 {
+  // an expression depends on whatever its operands depend on
+  m_dependency = InfoDependency::NONE;
   if (!Parse(m_expression))
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", m_expression.c_str());
     m_expression_tree = std::make_shared<InfoLeaf>(CServiceBroker::GetGUI()->GetInfoManager().Register("false", 0), false);
+    m_dependency = InfoDependency::NONE;
   }
 }
 
@@ -254,6 +260,7 @@ bool InfoExpression::Parse(const std::string &expression)
         }
         /* Propagate any listItem dependency from the operand to the expression */
         m_listItemDependent |= info->ListItemDependent();
+    m_dependency = std::max(m_dependency, info->GetDependency());
         nodes.push(std::make_shared<InfoLeaf>(info, invert));
         /* Reuse operand string for next operand */
         operand.clear();
@@ -305,6 +312,7 @@ bool InfoExpression::Parse(const std::string &expression)
     }
     /* Propagate any listItem dependency from the operand to the expression */
     m_listItemDependent |= info->ListItemDependent();
+    m_dependency = std::max(m_dependency, info->GetDependency());
     nodes.push(std::make_shared<InfoLeaf>(info, invert));
   }
   while (!operator_stack.empty())
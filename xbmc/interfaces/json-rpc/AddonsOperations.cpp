@@ -23,6 +23,7 @@
 #include "ServiceBroker.h"
 #include "addons/AddonManager.h"
 #include "addons/AddonDatabase.h"
+#include "addons/AddonResourceUsage.h"
 #include "addons/PluginSource.h"
 #include "messaging/ApplicationMessenger.h"
 #include "TextureCache.h"
@@ -286,6 +287,14 @@ void CAddonsOperations::FillDetails(AddonPtr addon, const CVariant& fields, CVar
     {
       object[field] = CServiceBroker::GetAddonMgr().IsAddonInstalled(addon->ID());
     }
+    else if (field == "resources")
+    {
+      AddonResourceUsage usage;
+      CAddonResourceUsage::Get(addon->ID(), usage);
+      object[field]["cputime"] = usage.cpuTime / 1000;
+      object[field]["bytesread"] = usage.bytesRead;
+      object[field]["byteswritten"] = usage.bytesWritten;
+    }
     else if (field == "fanart" || field == "thumbnail")
     {
       std::string url = addonInfo[field].asString();
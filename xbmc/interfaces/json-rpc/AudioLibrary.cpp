@@ -62,6 +62,7 @@ JSONRPC_STATUS CAudioLibrary::GetProperties(const std::string &method, ITranspor
 JSONRPC_STATUS CAudioLibrary::GetArtists(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CMusicDatabase musicdatabase;
+  musicdatabase.SetReadOnly(true);
   if (!musicdatabase.Open())
     return InternalError;
 
@@ -115,6 +116,9 @@ JSONRPC_STATUS CAudioLibrary::GetArtists(const std::string &method, ITransportLa
   if (!ParseSorting(parameterObject, sorting.sortBy, sorting.sortOrder, sorting.sortAttributes))
     return InvalidParams;
 
+  if (!HandleRevision(musicdatabase, MediaTypeArtist, parameterObject, musicUrl, result))
+    return InternalError;
+
   CFileItemList items;
   musicdatabase.SetTranslateBlankArtist(false);  
   if (!musicdatabase.GetArtistsNav(musicUrl.ToString(), items, albumArtistsOnly, genreID, albumID, songID, CDatabase::Filter(), sorting))
@@ -175,6 +179,7 @@ JSONRPC_STATUS CAudioLibrary::GetArtistDetails(const std::string &method, ITrans
 JSONRPC_STATUS CAudioLibrary::GetAlbums(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CMusicDatabase musicdatabase;
+  musicdatabase.SetReadOnly(true);
   if (!musicdatabase.Open())
     return InternalError;
 
@@ -220,6 +225,9 @@ JSONRPC_STATUS CAudioLibrary::GetAlbums(const std::string &method, ITransportLay
   if (!ParseSorting(parameterObject, sorting.sortBy, sorting.sortOrder, sorting.sortAttributes))
     return InvalidParams;
 
+  if (!HandleRevision(musicdatabase, MediaTypeAlbum, parameterObject, musicUrl, result))
+    return InternalError;
+
   int total;
   VECALBUMS albums;
   if (!musicdatabase.GetAlbumsByWhere(musicUrl.ToString(), CDatabase::Filter(), albums, total, sorting))
@@ -284,6 +292,7 @@ JSONRPC_STATUS CAudioLibrary::GetAlbumDetails(const std::string &method, ITransp
 JSONRPC_STATUS CAudioLibrary::GetSongs(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CMusicDatabase musicdatabase;
+  musicdatabase.SetReadOnly(true);
   if (!musicdatabase.Open())
     return InternalError;
 
@@ -347,6 +356,9 @@ JSONRPC_STATUS CAudioLibrary::GetSongs(const std::string &method, ITransportLaye
   std::set<std::string> additionalProperties;
   bool artistData = CheckForAdditionalProperties(parameterObject["properties"], checkProperties, additionalProperties);
  
+  if (!HandleRevision(musicdatabase, MediaTypeSong, parameterObject, musicUrl, result))
+    return InternalError;
+
   CFileItemList items;
   if (!musicdatabase.GetSongsFullByWhere(musicUrl.ToString(), CDatabase::Filter(), items, sorting, artistData))
     return InternalError; 
@@ -487,6 +499,7 @@ JSONRPC_STATUS CAudioLibrary::GetRecentlyPlayedSongs(const std::string &method,
 JSONRPC_STATUS CAudioLibrary::GetGenres(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CMusicDatabase musicdatabase;
+  musicdatabase.SetReadOnly(true);
   if (!musicdatabase.Open())
     return InternalError;
 
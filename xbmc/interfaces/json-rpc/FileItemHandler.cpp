@@ -25,6 +25,8 @@
 #include "AudioLibrary.h"
 #include "VideoLibrary.h"
 #include "FileOperations.h"
+#include "DbUrl.h"
+#include "dbwrappers/Database.h"
 #include "utils/SortUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/ISerializable.h"
@@ -241,6 +243,8 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
       fields.insert(field->asString());
   }
 
+  FillVideoDetails(items, start, end, fields);
+
   for (int i = start; i < end; i++)
   {
     CFileItemPtr item = items.Get(i);
@@ -385,6 +389,45 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
   }
 }
 
+void CFileItemHandler::FillVideoDetails(CFileItemList &items, int start, int end, const std::set<std::string> &fields)
+{
+  static const std::map<std::string, int> detailFields = {
+    { "cast",          VideoDbDetailsCast },
+    { "ratings",       VideoDbDetailsRating },
+    { "uniqueid",      VideoDbDetailsUniqueID },
+    { "showlink",      VideoDbDetailsShowLink },
+    { "streamdetails", VideoDbDetailsStream },
+    { "tag",           VideoDbDetailsTag }
+  };
+
+  int details = VideoDbDetailsNone;
+  for (const auto &field : fields)
+  {
+    auto detail = detailFields.find(field);
+    if (detail != detailFields.end())
+      details |= detail->second;
+  }
+  if (details == VideoDbDetailsNone)
+    return;
+
+  // library items listed without their heavy details (e.g. through Files.GetDirectory)
+  // get them here, for the returned page only and with one query per section
+  CFileItemList page;
+  for (int i = start; i < end; i++)
+  {
+    CFileItemPtr item = items.Get(i);
+    if (item->HasVideoInfoTag() && item->GetVideoInfoTag()->m_iDbId > 0 &&
+        (item->GetVideoInfoTag()->m_parsedDetails & details) != details)
+      page.Add(item);
+  }
+  if (page.IsEmpty())
+    return;
+
+  CVideoDatabase videodatabase;
+  if (videodatabase.Open())
+    videodatabase.GetDetailsForItems(page, details);
+}
+
 bool CFileItemHandler::FillFileItemList(const CVariant &parameterObject, CFileItemList &list)
 {
   CAudioLibrary::FillFileItemList(parameterObject, list);
@@ -426,6 +469,26 @@ bool CFileItemHandler::FillFileItemList(const CVariant &parameterObject, CFileIt
   return (list.Size() > 0);
 }
 
+bool CFileItemHandler::HandleRevision(CDatabase &database, const std::string &mediaType, const CVariant &parameterObject, CDbUrl &url, CVariant &result)
+{
+  result["revision"] = database.GetRevision();
+
+  int since = (int)parameterObject["since"].asInteger();
+  if (since < 0)
+    return true;
+
+  std::vector<int> removed;
+  if (!database.GetRemovedSince(mediaType, since, removed))
+    return false;
+
+  url.AddOption("revision", since);
+  result["removed"] = CVariant(CVariant::VariantTypeArray);
+  for (int id : removed)
+    result["removed"].push_back(id);
+
+  return true;
+}
+
 void CFileItemHandler::Sort(CFileItemList &items, const CVariant &parameterObject)
 {
   SortDescription sorting;
@@ -25,6 +25,8 @@
 #include "JSONUtils.h"
 #include "FileItem.h"
 
+class CDatabase;
+class CDbUrl;
 class CThumbLoader;
 class CVariant;
 
@@ -40,8 +42,23 @@ namespace JSONRPC
     static void HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const std::set<std::string> &validFields, CVariant &result, bool append = true, CThumbLoader *thumbLoader = NULL);
 
     static bool FillFileItemList(const CVariant &parameterObject, CFileItemList &list);
+
+    /*!
+     \brief Handle the "since" parameter of the library listings.
+     Adds the current revision of the library to the result and, if "since" is given, restricts
+     the listing to the items changed after that revision and lists the ids of the removed ones.
+     Has to be called before listing, so that changes made meanwhile are listed again next time.
+     \param database the opened library database.
+     \param mediaType the media type of the listed items.
+     \param parameterObject the parameters of the request.
+     \param url the url of the listing, the revision filter is added to it.
+     \param result the result of the request.
+     \return false if the removed items couldn't be read.
+     */
+    static bool HandleRevision(CDatabase &database, const std::string &mediaType, const CVariant &parameterObject, CDbUrl &url, CVariant &result);
   private:
     static void Sort(CFileItemList &items, const CVariant& parameterObject);
+    static void FillVideoDetails(CFileItemList &items, int start, int end, const std::set<std::string> &fields);
     static bool GetField(const std::string &field, const CVariant &info, const CFileItemPtr &item, CVariant &result, bool &fetchedArt, CThumbLoader *thumbLoader = NULL);
   };
 }
@@ -18,7 +18,10 @@
  *
  */
 
+#include <memory>
 #include <string.h>
+#include <utility>
+#include <vector>
 
 #include "JSONRPC.h"
 #include "ServiceDescription.h"
@@ -30,6 +33,9 @@
 #include "interfaces/AnnouncementManager.h"
 #include "playlists/SmartPlayList.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
@@ -40,6 +46,28 @@ using namespace JSONRPC;
 
 bool CJSONRPC::m_initialized = false;
 
+namespace
+{
+  struct BatchCall
+  {
+    enum State { Queued, Running, Done, Skipped };
+
+    bool parallel = false;
+    State state = Queued;
+    unsigned int jobId = 0;
+    bool hasResponse = false;
+    CVariant response;
+  };
+
+  /* shared with the jobs, which may still be queued when the batch was cancelled */
+  struct Batch
+  {
+    CCriticalSection section;
+    CEvent done;
+    std::vector<BatchCall> calls;
+  };
+}
+
 void CJSONRPC::Initialize()
 {
   if (m_initialized)
@@ -234,14 +262,62 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const std::string &method, ITransportLayer *t
   return ACK;
 }
 
-std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client)
+bool CJSONRPC::ParseRequest(const std::string &inputString, CVariant &inputroot)
 {
-  CVariant inputroot, outputroot, result;
-  bool hasResponse = false;
-
   CLog::Log(LOGDEBUG, LOGJSONRPC, "JSONRPC: Incoming request: %s", inputString.c_str());
 
   if (CJSONVariantParser::Parse(inputString, inputroot) && !inputroot.isNull())
+    return true;
+
+  CLog::Log(LOGERROR, "JSONRPC: Failed to parse '%s'\n", inputString.c_str());
+  return false;
+}
+
+std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client)
+{
+  CVariant inputroot;
+  CVariant outputroot;
+  std::string str;
+  bool parsed = ParseRequest(inputString, inputroot);
+  if (HandleRequest(inputroot, parsed, transport, client, outputroot))
+    CJSONVariantWriter::Write(outputroot, str, g_advancedSettings.m_jsonOutputCompact);
+
+  return str;
+}
+
+bool CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, const CJSONVariantWriter::OutputFunction &output)
+{
+  CVariant inputroot;
+  bool parsed = ParseRequest(inputString, inputroot);
+  if (parsed && inputroot.isArray() && inputroot.size() > 0)
+  {
+    // every response of the batch goes out as soon as it and the ones before it are ready
+    bool first = true;
+    bool ok = HandleBatch(inputroot, transport, client, [&first, &output](CVariant &&response)
+    {
+      if (!output(first ? "[" : ",", 1))
+        return false;
+      first = false;
+      return CJSONVariantWriter::Write(response, output, g_advancedSettings.m_jsonOutputCompact);
+    });
+
+    if (ok && !first)
+      ok = output("]", 1);
+    return ok;
+  }
+
+  CVariant outputroot;
+  if (!HandleRequest(inputroot, parsed, transport, client, outputroot))
+    return true;
+
+  return CJSONVariantWriter::Write(outputroot, output, g_advancedSettings.m_jsonOutputCompact);
+}
+
+bool CJSONRPC::HandleRequest(const CVariant &inputroot, bool parsed, ITransportLayer *transport, IClient *client, CVariant &outputroot)
+{
+  bool hasResponse = false;
+
+  if (parsed)
   {
     if (inputroot.isArray())
     {
@@ -253,15 +329,12 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
       }
       else
       {
-        for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
+        HandleBatch(inputroot, transport, client, [&outputroot, &hasResponse](CVariant &&response)
         {
-          CVariant response;
-          if (HandleMethodCall(*itr, response, transport, client))
-          {
-            outputroot.append(response);
-            hasResponse = true;
-          }
-        }
+          outputroot.append(std::move(response));
+          hasResponse = true;
+          return true;
+        });
       }
     }
     else
@@ -269,16 +342,91 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
   }
   else
   {
-    CLog::Log(LOGERROR, "JSONRPC: Failed to parse '%s'\n", inputString.c_str());
     BuildResponse(inputroot, ParseError, CVariant(), outputroot);
     hasResponse = true;
   }
 
-  std::string str;
-  if (hasResponse)
-    CJSONVariantWriter::Write(outputroot, str, g_advancedSettings.m_jsonOutputCompact);
+  return hasResponse;
+}
 
-  return str;
+bool CJSONRPC::HandleBatch(const CVariant &inputroot, ITransportLayer *transport, IClient *client, const BatchOutput &output)
+{
+  std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+  batch->calls.resize(inputroot.size());
+
+  for (unsigned int index = 0; index < inputroot.size() && inputroot.size() > 1; index++)
+  {
+    const CVariant &request = inputroot[index];
+    if (!IsProperJSONRPC(request))
+      continue;
+
+    std::string methodName = request["method"].asString();
+    StringUtils::ToLower(methodName);
+    if (!CJSONServiceDescription::IsThreadSafe(methodName.c_str()))
+      continue;
+
+    batch->calls[index].parallel = true;
+
+    // the job only touches the request, the transport and the client while it is running,
+    // the batch isn't left before it is done
+    auto call = [batch, index, &request, transport, client]()
+    {
+      {
+        CSingleLock lock(batch->section);
+        if (batch->calls[index].state != BatchCall::Queued)
+          return;
+        batch->calls[index].state = BatchCall::Running;
+      }
+
+      CVariant response;
+      bool hasResponse = HandleMethodCall(request, response, transport, client);
+
+      CSingleLock lock(batch->section);
+      batch->calls[index].response = std::move(response);
+      batch->calls[index].hasResponse = hasResponse;
+      batch->calls[index].state = BatchCall::Done;
+      batch->done.Set();
+    };
+    batch->calls[index].jobId = CJobManager::GetInstance().AddJob(new CLambdaJob<decltype(call)>(std::move(call)), nullptr, CJob::PRIORITY_NORMAL);
+  }
+
+  bool ok = true;
+  for (unsigned int index = 0; index < inputroot.size(); index++)
+  {
+    BatchCall &call = batch->calls[index];
+    bool execute = !call.parallel;
+
+    if (call.parallel)
+    {
+      CSingleLock lock(batch->section);
+      if (call.state == BatchCall::Queued)
+      {
+        // not picked up by a worker yet, don't wait for one
+        execute = ok;
+        call.state = ok ? BatchCall::Running : BatchCall::Skipped;
+        CSingleExit exit(batch->section);
+        CJobManager::GetInstance().CancelJob(call.jobId);
+      }
+
+      // a cancelled batch still waits for the calls that are running
+      while (call.state == BatchCall::Running && !execute)
+      {
+        CSingleExit exit(batch->section);
+        batch->done.WaitMSec(100);
+      }
+    }
+
+    if (!ok)
+      continue;
+
+    if (execute)
+      call.hasResponse = HandleMethodCall(inputroot[index], call.response, transport, client);
+
+    if (call.hasResponse)
+      ok = output(std::move(call.response));
+  }
+
+  return ok;
 }
 
 bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
@@ -311,7 +459,7 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     errorCode = InvalidRequest;
   }
 
-  BuildResponse(request, errorCode, result, response);
+  BuildResponse(request, errorCode, std::move(result), response);
 
   return !isNotification;
 }
@@ -321,7 +469,7 @@ inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
   return inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
 }
 
-inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response)
+inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response)
 {
   response["jsonrpc"] = "2.0";
   response["id"] = request.isMember("id") ? request["id"] : CVariant();
@@ -329,7 +477,8 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
   switch (code)
   {
     case OK:
-      response["result"] = result;
+      // the result may be the whole library, it isn't needed afterwards
+      response["result"] = std::move(result);
       break;
     case ACK:
       response["result"] = "OK";
@@ -342,7 +491,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
       response["error"]["code"] = InvalidParams;
       response["error"]["message"] = "Invalid params.";
       if (!result.isNull())
-        response["error"]["data"] = result;
+        response["error"]["data"] = std::move(result);
       break;
     case MethodNotFound:
       response["error"]["code"] = MethodNotFound;
@@ -19,6 +19,7 @@
  *
  */
 
+#include <functional>
 #include <iostream>
 #include <map>
 #include <stdio.h>
@@ -26,6 +27,7 @@
 
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
+#include "utils/JSONVariantWriter.h"
 
 class CVariant;
 
@@ -64,6 +66,20 @@ namespace JSONRPC
      */
     static std::string MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON-RPC request, streaming the response
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param output gets the JSON-RPC response in pieces while it is serialised
+     \return false if the response couldn't be serialised or the output gave up
+
+     Same as MethodCall above, except that the response isn't built as a string
+     first. The responses of a batch are output one after the other as soon as
+     they are ready. Nothing is output for notifications.
+     */
+    static bool MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, const CJSONVariantWriter::OutputFunction &output);
+
     static JSONRPC_STATUS Introspect(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -73,10 +89,24 @@ namespace JSONRPC
     static JSONRPC_STATUS NotifyAll(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
   
   private:
+    typedef std::function<bool(CVariant &&response)> BatchOutput;
+
+    static bool ParseRequest(const std::string &inputString, CVariant &inputroot);
+    static bool HandleRequest(const CVariant &inputroot, bool parsed, ITransportLayer *transport, IClient *client, CVariant &outputroot);
+
+    /*
+     \brief Executes the calls of a batch request
+     \param output gets the responses in the order of the calls, returns false to cancel the remaining calls
+     \return false if the output cancelled the batch
+
+     Calls of methods marked as "threadsafe" are executed in parallel by the
+     job manager, the others one after the other on the calling thread.
+     */
+    static bool HandleBatch(const CVariant &inputroot, ITransportLayer *transport, IClient *client, const BatchOutput &output);
     static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
-    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
+    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response);
 
     static bool m_initialized;
   };
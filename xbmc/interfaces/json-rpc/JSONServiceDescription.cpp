@@ -232,6 +232,7 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
 // Textures operations
   { "Textures.GetTextures",                         CTextureOperations::GetTextures },
   { "Textures.RemoveTexture",                       CTextureOperations::RemoveTexture },
+  { "Textures.PrecacheLibrary",                     CTextureOperations::PrecacheLibrary },
 
 // Settings operations
   { "Settings.GetSections",                         CSettingsOperations::GetSections },
@@ -243,7 +244,9 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
 
 // XBMC operations
   { "XBMC.GetInfoLabels",                           CXBMCOperations::GetInfoLabels },
-  { "XBMC.GetInfoBooleans",                         CXBMCOperations::GetInfoBooleans }
+  { "XBMC.GetInfoBooleans",                         CXBMCOperations::GetInfoBooleans },
+  { "XBMC.GetDatabaseStatistics",                   CXBMCOperations::GetDatabaseStatistics },
+  { "XBMC.GetMetrics",                              CXBMCOperations::GetMetrics }
 };
 
 JSONSchemaTypeDefinition::JSONSchemaTypeDefinition()
@@ -1226,6 +1229,7 @@ JsonRpcMethod::JsonRpcMethod()
     method(NULL),
     transportneed(Response),
     permission(ReadData),
+    threadsafe(false),
     description(),
     parameters(),
     returns(new JSONSchemaTypeDefinition())
@@ -1256,6 +1260,8 @@ bool JsonRpcMethod::Parse(const CVariant &value)
   else
     permission = StringToPermission(value.isMember("permission") ? value["permission"].asString() : "");
 
+  threadsafe = value.isMember("threadsafe") && value["threadsafe"].isBoolean() && value["threadsafe"].asBoolean();
+
   description = GetString(value["description"], "");
 
   // Check whether there are parameters defined
@@ -1895,6 +1901,12 @@ JSONRPC_STATUS CJSONServiceDescription::CheckCall(const char* const method, cons
   return MethodNotFound;
 }
 
+bool CJSONServiceDescription::IsThreadSafe(const char* const method)
+{
+  CJsonRpcMethodMap::JsonRpcMethodIterator iter = m_actionMap.find(method);
+  return iter != m_actionMap.end() && iter->second.threadsafe;
+}
+
 JSONSchemaTypeDefinitionPtr CJSONServiceDescription::GetType(const std::string &identification)
 {
   std::map<std::string, JSONSchemaTypeDefinitionPtr>::iterator iter = m_types.find(identification);
@@ -262,6 +262,11 @@ namespace JSONRPC
      to execute the method
      */
     OperationPermission permission;
+    /*!
+     \brief Whether the method may be executed
+     at the same time as others
+     */
+    bool threadsafe;
     /*!
      \brief Description of the method
      */
@@ -390,6 +395,13 @@ namespace JSONRPC
      given parameters from the request against the json schema description for the given method.
      */
     static JSONRPC_STATUS CheckCall(const char* method, const CVariant &requestParameters, ITransportLayer *transport, IClient *client, bool notification, MethodCall &methodCall, CVariant &outputParameters);
+
+    /*!
+     \brief Checks whether the given method is marked as "threadsafe"
+     \param method Called method (in lower case)
+     \return True if the method may be executed in parallel to other methods
+     */
+    static bool IsThreadSafe(const char* method);
     
     static JSONSchemaTypeDefinitionPtr GetType(const std::string &identification);
 
@@ -73,6 +73,12 @@ namespace JSONRPC
       result["hours"] = time;
     }
 
+    static int TimeObjectToMilliseconds(const CVariant &time)
+    {
+      return static_cast<int>(((time["hours"].asInteger() * 60 + time["minutes"].asInteger()) * 60 +
+                               time["seconds"].asInteger()) * 1000 + time["milliseconds"].asInteger());
+    }
+
   protected:
     static void HandleLimits(const CVariant &parameterObject, CVariant &result, int size, int &start, int &end)
     {
@@ -21,6 +21,7 @@
 #include "PlayerOperations.h"
 #include "Application.h"
 #include "PlayListPlayer.h"
+#include "ServiceBroker.h"
 #include "guilib/GUIWindowManager.h"
 #include "input/Key.h"
 #include "GUIUserMessages.h"
@@ -39,7 +40,9 @@
 #include "pvr/channels/PVRChannelGroupsContainer.h"
 #include "pvr/epg/EpgInfoTag.h"
 #include "pvr/recordings/PVRRecordings.h"
+#include "cores/DataCacheCore.h"
 #include "cores/IPlayer.h"
+#include "cores/VideoPlayer/VideoRenderers/RenderTimer.h"
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "SeekHandler.h"
 #include "utils/Variant.h"
@@ -1625,6 +1628,48 @@ JSONRPC_STATUS CPlayerOperations::GetPropertyValue(PlayerType player, const std:
       break;
     }
   }
+  else if (property == "rendertimings")
+  {
+    // GPU milliseconds per frame, only measured while enabled by advanced settings or the debug OSD
+    std::vector<float> timings;
+    if (player == Video)
+      timings = CServiceBroker::GetDataCacheCore().GetRenderTimings();
+
+    if (timings.size() == RENDER_STAGE_MAX)
+    {
+      result = CVariant(CVariant::VariantTypeObject);
+      result["upload"] = timings[RENDER_STAGE_UPLOAD];
+      result["yuv2rgb"] = timings[RENDER_STAGE_YUV2RGB];
+      result["scaling"] = timings[RENDER_STAGE_SCALING];
+      result["overlay"] = timings[RENDER_STAGE_OVERLAY];
+      result["gui"] = timings[RENDER_STAGE_GUI];
+    }
+    else
+      result = CVariant(CVariant::VariantTypeNull);
+  }
+  else if (property == "audiosync")
+  {
+    // percentiles over the last minutes of the playing audio stream
+    SAudioSyncStats stats;
+    if (player == Video || player == Audio)
+      stats = CServiceBroker::GetDataCacheCore().GetAudioSyncStats();
+
+    if (stats.samples > 0)
+    {
+      result = CVariant(CVariant::VariantTypeObject);
+      result["samples"] = stats.samples;
+      result["delay"]["median"] = stats.delay50;
+      result["delay"]["p95"] = stats.delay95;
+      result["error"]["median"] = stats.error50;
+      result["error"]["p95"] = stats.error95;
+      result["error"]["p99"] = stats.error99;
+      result["correction"]["median"] = stats.correction50;
+      result["correction"]["p95"] = stats.correction95;
+      result["underruns"] = stats.underruns;
+    }
+    else
+      result = CVariant(CVariant::VariantTypeNull);
+  }
   else if (property == "videostreams")
   {
     result = CVariant(CVariant::VariantTypeArray);
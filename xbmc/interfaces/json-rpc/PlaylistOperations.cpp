@@ -79,8 +79,27 @@ JSONRPC_STATUS CPlaylistOperations::GetItems(const std::string &method, ITranspo
   {
     case PLAYLIST_VIDEO:
     case PLAYLIST_MUSIC:
-      CApplicationMessenger::GetInstance().SendMsg(TMSG_PLAYLISTPLAYER_GET_ITEMS, playlist, -1, static_cast<void*>(&list));
+    {
+      PlaylistItemsRange range;
+      range.items = &list;
+
+      // unsorted, only the requested page has to be copied from the playlist
+      SortDescription sorting;
+      if (!ParseSorting(parameterObject, sorting.sortBy, sorting.sortOrder, sorting.sortAttributes) ||
+          sorting.sortBy == SortByNone)
+      {
+        ParseLimits(parameterObject, range.start, range.end);
+        if (range.end <= 0)
+          range.end = -1;
+
+        int size = CApplicationMessenger::GetInstance().SendMsg(TMSG_PLAYLISTPLAYER_GET_ITEMS, playlist, -1, static_cast<void*>(&range));
+        HandleFileItemList("id", true, "items", list, parameterObject, result, size, false);
+        return OK;
+      }
+
+      CApplicationMessenger::GetInstance().SendMsg(TMSG_PLAYLISTPLAYER_GET_ITEMS, playlist, -1, static_cast<void*>(&range));
       break;
+    }
 
     case PLAYLIST_PICTURE:
       slideshow = CServiceBroker::GetGUI()->GetWindowManager().GetWindow<CGUIWindowSlideShow>(WINDOW_SLIDESHOW);
@@ -274,9 +293,14 @@ JSONRPC_STATUS CPlaylistOperations::GetPropertyValue(int playlist, const std::st
     {
       case PLAYLIST_MUSIC:
       case PLAYLIST_VIDEO:
-        CApplicationMessenger::GetInstance().SendMsg(TMSG_PLAYLISTPLAYER_GET_ITEMS, playlist, -1, static_cast<void*>(&list));
-        result = list.Size();
+      {
+        // no items needed, the message returns the size
+        PlaylistItemsRange range;
+        range.items = &list;
+        range.end = 0;
+        result = CApplicationMessenger::GetInstance().SendMsg(TMSG_PLAYLISTPLAYER_GET_ITEMS, playlist, -1, static_cast<void*>(&range));
         break;
+      }
 
       case PLAYLIST_PICTURE:
         slideshow = CServiceBroker::GetGUI()->GetWindowManager().GetWindow<CGUIWindowSlideShow>(WINDOW_SLIDESHOW);
@@ -102,3 +102,9 @@ JSONRPC_STATUS CTextureOperations::RemoveTexture(const std::string &method, ITra
 
   return ACK;
 }
+
+JSONRPC_STATUS CTextureOperations::PrecacheLibrary(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CTextureCache::GetInstance().PrecacheLibrary();
+  return ACK;
+}
@@ -19,7 +19,10 @@
  */
 
 #include "XBMCOperations.h"
+#include "dbwrappers/DatabaseProfiler.h"
 #include "messaging/ApplicationMessenger.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/Metrics.h"
 #include "utils/Variant.h"
 #include "powermanagement/PowerManager.h"
 #include "ServiceBroker.h"
@@ -96,3 +99,22 @@ JSONRPC_STATUS CXBMCOperations::GetInfoBooleans(const std::string &method, ITran
 
   return OK;
 }
+
+JSONRPC_STATUS CXBMCOperations::GetDatabaseStatistics(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  result["enabled"] = g_advancedSettings.m_databaseProfiling;
+  result["slowquerytime"] = g_advancedSettings.m_databaseSlowQueryTime;
+
+  CDatabaseProfiler &profiler = CDatabaseProfiler::GetInstance();
+  profiler.GetStatistics(result, static_cast<unsigned int>(parameterObject["limit"].asUnsignedInteger()));
+  if (parameterObject["reset"].asBoolean())
+    profiler.Reset();
+
+  return OK;
+}
+
+JSONRPC_STATUS CXBMCOperations::GetMetrics(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CMetrics::GetInstance().GetMetrics(result["metrics"]);
+  return OK;
+}
@@ -25,6 +25,8 @@
 #include "CallbackHandler.h"
 #include "LanguageHook.h"
 
+#include <functional>
+
 namespace XBMCAddon
 {
 
@@ -51,5 +53,14 @@ namespace XBMCAddon
 
     inline void setHandler(CallbackHandler* _handler) { handler = _handler; }
     void invokeCallback(Callback* callback);
+
+#ifndef SWIG
+    /**
+     * Called once the language side object exists, with a function telling
+     *  whether it implements a callback method. Classes can use it to not
+     *  queue callbacks that would only run the empty default.
+     */
+    virtual void checkOverrides(const std::function<bool(const char* method)>& overrides) {}
+#endif
   };
 }
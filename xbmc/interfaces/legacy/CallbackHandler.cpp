@@ -77,60 +77,81 @@ namespace XBMCAddon
   void RetardedAsyncCallbackHandler::makePendingCalls()
   {
     XBMC_TRACE;
-    CSingleLock lock(critSection);
-    CallbackQueue::iterator iter = g_callQueue.begin();
-    while (iter != g_callQueue.end())
+    // take all the calls for this thread out of the queue in one pass and
+    //  run them as a batch. Calls queued while the batch runs are left for
+    //  the next time.
+    CallbackQueue calls;
     {
-      AddonClass::Ref<AsyncCallbackMessage> p(*iter);
+      CSingleLock lock(critSection);
 
-      // only call when we are in the right thread state
-      if(p->handler->isStateOk(p->cb->getObject()))
+      // the thread state check only depends on handler and object
+      std::vector<std::pair<std::pair<RetardedAsyncCallbackHandler*, AddonClass*>, bool> > states;
+      CallbackQueue::iterator iter = g_callQueue.begin();
+      while (iter != g_callQueue.end())
       {
-        // remove it from the queue. No matter what we're done with
-        //  this. Even if it doesn't execute for some reason.
-        g_callQueue.erase(iter);
+        AsyncCallbackMessage* p = iter->get();
+        std::pair<RetardedAsyncCallbackHandler*, AddonClass*> key(p->handler.get(), p->cb->getObject());
+
+        bool stateOk = false;
+        bool known = false;
+        for (const auto& state : states)
+        {
+          if (state.first == key)
+          {
+            stateOk = state.second;
+            known = true;
+            break;
+          }
+        }
+        if (!known)
+        {
+          stateOk = p->handler->isStateOk(key.second);
+          states.push_back(std::make_pair(key, stateOk));
+        }
 
-        // we need to release the critSection lock prior to grabbing the
-        //  lock on the object. Not doing so results in deadlocks. We no
-        //  longer are accessing the g_callQueue so it's fine to do this now
+        // only call when we are in the right thread state. Once taken from
+        //  the queue it's done with, even if it doesn't execute for some reason.
+        if (stateOk)
         {
-          XBMCAddonUtils::InvertSingleLockGuard unlock(lock);
+          calls.push_back(*iter);
+          iter = g_callQueue.erase(iter);
+        }
+        else
+          ++iter;
+      }
+    }
 
-          // make sure the object is not deallocating
+    // we must not hold the critSection while grabbing the lock on the
+    //  objects, doing so results in deadlocks.
+    for (CallbackQueue::iterator iter = calls.begin(); iter != calls.end(); ++iter)
+    {
+      AddonClass::Ref<AsyncCallbackMessage> p(*iter);
 
-          // we need to grab the object lock to see if the object of the call 
-          //  is deallocating. holding this lock should prevent it from 
-          //  deallocating during the execution of this call.
+      // make sure the object is not deallocating
+
+      // we need to grab the object lock to see if the object of the call 
+      //  is deallocating. holding this lock should prevent it from 
+      //  deallocating during the execution of this call.
 #ifdef ENABLE_XBMC_TRACE_API
-          CLog::Log(LOGDEBUG,"%sNEWADDON executing callback 0x%lx",_tg.getSpaces(),(long)(p->cb.get()));
+      CLog::Log(LOGDEBUG,"%sNEWADDON executing callback 0x%lx",_tg.getSpaces(),(long)(p->cb.get()));
 #endif
-          AddonClass* obj = (p->cb->getObject());
-          AddonClass::Ref<AddonClass> ref(obj);
-          CSingleLock lock2(*obj);
-          if (!p->cb->getObject()->isDeallocating())
-          {
-            try
-            {
-              // need to make the call
-              p->cb->executeCallback();
-            }
-            catch (XbmcCommons::Exception& e) { e.LogThrowMessage(); }
-            catch (...)
-            {
-              CLog::Log(LOGERROR,"Unknown exception while executing callback 0x%lx", (long)(p->cb.get()));
-            }
-          }
+      AddonClass* obj = (p->cb->getObject());
+      AddonClass::Ref<AddonClass> ref(obj);
+      CSingleLock lock2(*obj);
+      if (!p->cb->getObject()->isDeallocating())
+      {
+        try
+        {
+          // need to make the call
+          p->cb->executeCallback();
+        }
+        catch (XbmcCommons::Exception& e) { e.LogThrowMessage(); }
+        catch (...)
+        {
+          CLog::Log(LOGERROR,"Unknown exception while executing callback 0x%lx", (long)(p->cb.get()));
         }
-
-        // since the state of the iterator may have been corrupted by
-        //  the changing state of the list from another thread during
-        //  the releasing fo the lock in the immediately preceeding 
-        //  codeblock, we need to reset it before continuing the loop
-        iter = g_callQueue.begin();
       }
-      else // if we're not in the right thread for this callback...
-        ++iter;
-    }  
+    }
   }
 
   void RetardedAsyncCallbackHandler::clearPendingCalls(void* userData)
@@ -46,6 +46,8 @@ namespace XBMCAddon
           return ret;
         }
         ret.forward(bytesRead);
+        if (counters)
+          counters->AddBytesRead(bytesRead);
       }
       ret.flip();
       return ret;
@@ -65,6 +67,8 @@ namespace XBMCAddon
         else if (bytesWritten < 0)   // But, if we get something less than zero, we KNOW it's an error.
           return false;
         buffer.forward(bytesWritten);// Otherwise, we advance the buffer by the amount written.
+        if (counters)
+          counters->AddBytesWritten(bytesWritten);
       }
       return true;
     }
@@ -21,6 +21,7 @@
 #pragma once
 
 #include "filesystem/File.h"
+#include "addons/AddonResourceUsage.h"
 #include "AddonString.h"
 #include "AddonClass.h"
 #include "LanguageHook.h"
@@ -61,10 +62,13 @@ namespace XBMCAddon
     class File : public AddonClass
     {
       XFILE::CFile* file;
+      ADDON::CAddonResourceCounters* counters = nullptr;
     public:
       inline File(const String& filepath, const char* mode = NULL) : file(new XFILE::CFile())
       {
         DelayedCallGuard dg(languageHook);
+        if (languageHook && !languageHook->GetAddonId().empty())
+          counters = &ADDON::CAddonResourceUsage::GetCounters(languageHook->GetAddonId());
         if (mode && strncmp(mode, "w", 1) == 0)
           file->OpenForWrite(filepath,true);
         else
@@ -62,6 +62,49 @@ namespace XBMCAddon
       return XFILE::CPluginDirectory::AddItems(handle, &fitems, totalItems);
     }
 
+    bool addDirectoryItemColumns(int handle, const std::vector<String>& urls,
+                                 const std::vector<String>& labels,
+                                 const std::vector<bool>& isFolders,
+                                 const std::vector<Properties>& art,
+                                 const char* infoType,
+                                 const std::vector<xbmcgui::InfoLabelDict>& infoLabels,
+                                 const std::vector<Properties>& properties,
+                                 int totalItems)
+    {
+      const size_t count = urls.size();
+      if ((!labels.empty() && labels.size() != count) ||
+          (!isFolders.empty() && isFolders.size() != count) ||
+          (!art.empty() && art.size() != count) ||
+          (!infoLabels.empty() && infoLabels.size() != count) ||
+          (!properties.empty() && properties.size() != count))
+        throw WrongTypeException("The lists passed to addDirectoryItemColumns need as many entries as urls");
+
+      CFileItemList fitems;
+      fitems.Reserve(count);
+      for (size_t i = 0; i < count; ++i)
+      {
+        // an offscreen ListItem applies the same conversions as the setters a
+        // plugin would call, but without a python object and the gui lock
+        AddonClass::Ref<xbmcgui::ListItem> listItem(new xbmcgui::ListItem(labels.empty() ? emptyString : labels[i],
+                                                                          emptyString, emptyString, emptyString,
+                                                                          urls[i], true));
+        listItem->item->m_bIsFolder = !isFolders.empty() && isFolders[i];
+        if (!art.empty())
+          listItem->setArt(art[i]);
+        if (!infoLabels.empty())
+          listItem->setInfo(infoType, infoLabels[i]);
+        if (!properties.empty())
+        {
+          for (const auto& property : properties[i])
+            listItem->setProperty(property.first.c_str(), property.second);
+        }
+        fitems.Add(listItem->item);
+      }
+
+      // call the directory class to add our items
+      return XFILE::CPluginDirectory::AddItems(handle, &fitems, totalItems);
+    }
+
     void endOfDirectory(int handle, bool succeeded, bool updateListing, 
                         bool cacheToDisc)
     {
@@ -107,6 +150,11 @@ namespace XBMCAddon
       XFILE::CPluginDirectory::SetProperty(handle, "plugincategory", category);
     }
 
+    void setCacheTTL(int handle, int seconds)
+    {
+      XFILE::CPluginDirectory::SetCacheTTL(handle, seconds);
+    }
+
     void setPluginFanart(int handle, const char* image, 
                          const char* color1,
                          const char* color2,
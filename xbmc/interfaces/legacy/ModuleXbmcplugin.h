@@ -116,6 +116,62 @@ namespace XBMCAddon
                            int totalItems = 0);
 #endif
 
+#ifdef DOXYGEN_SHOULD_USE_THIS
+    ///
+    /// \ingroup python_xbmcplugin
+    /// @brief \python_func{ xbmcplugin.addDirectoryItemColumns(handle, urls[, labels, isFolders, art, infoType, infoLabels, properties, totalItems]) }
+    ///-------------------------------------------------------------------------
+    /// Callback function to pass directory contents back to Kodi as columns,
+    /// one list per attribute with one entry per item.
+    ///
+    /// @param handle               integer - handle the plugin was started
+    ///                             with.
+    /// @param urls                 List - url of each item.
+    /// @param labels               [opt] List - label of each item.
+    /// @param isFolders            [opt] List - True for each item that is a
+    ///                             folder.
+    /// @param art                  [opt] List - art of each item as a
+    ///                             dictionary, see ListItem.setArt().
+    /// @param infoType             [opt] string - type of the info labels
+    ///                             (video, music, pictures or game).
+    ///                             (default video)
+    /// @param infoLabels           [opt] List - info labels of each item as a
+    ///                             dictionary, see ListItem.setInfo().
+    /// @param properties           [opt] List - properties of each item as a
+    ///                             dictionary, see ListItem.setProperty().
+    /// @param totalItems           [opt] integer - total number of items
+    ///                             that will be passed.(used for progressbar)
+    /// @return                     Returns a bool for successful completion.
+    ///
+    /// @remark The items are built in one call without creating a ListItem
+    /// for each of them, which makes this the fastest way for large lists.
+    /// Optional lists may be left empty, otherwise they need as many entries
+    /// as urls. You may call this more than once to add items in chunks.
+    ///
+    ///
+    /// ------------------------------------------------------------------------
+    ///
+    /// **Example:**
+    /// ~~~~~~~~~~~~~{.py}
+    /// ..
+    /// xbmcplugin.addDirectoryItemColumns(int(sys.argv[1]), urls, labels=titles,
+    ///                                    art=[{'thumb': thumb} for thumb in thumbs],
+    ///                                    infoLabels=[{'plot': plot} for plot in plots])
+    /// ..
+    /// ~~~~~~~~~~~~~
+    ///
+    addDirectoryItemColumns(...);
+#else
+    bool addDirectoryItemColumns(int handle, const std::vector<String>& urls,
+                                 const std::vector<String>& labels = std::vector<String>(),
+                                 const std::vector<bool>& isFolders = std::vector<bool>(),
+                                 const std::vector<XBMCAddon::Properties>& art = std::vector<XBMCAddon::Properties>(),
+                                 const char* infoType = "video",
+                                 const std::vector<XBMCAddon::xbmcgui::InfoLabelDict>& infoLabels = std::vector<XBMCAddon::xbmcgui::InfoLabelDict>(),
+                                 const std::vector<XBMCAddon::Properties>& properties = std::vector<XBMCAddon::Properties>(),
+                                 int totalItems = 0);
+#endif
+
 #ifdef DOXYGEN_SHOULD_USE_THIS
     ///
     /// \ingroup python_xbmcplugin
@@ -385,6 +441,37 @@ namespace XBMCAddon
     void setPluginCategory(int handle, const String& category);
 #endif
 
+#ifdef DOXYGEN_SHOULD_USE_THIS
+    ///
+    /// \ingroup python_xbmcplugin
+    /// @brief \python_func{ xbmcplugin.setCacheTTL(handle, seconds) }
+    ///-------------------------------------------------------------------------
+    /// Allows Kodi to reuse the listing for the given time instead of running
+    /// the plugin again, e.g. when navigating back to it.
+    ///
+    /// @param handle      integer - handle the plugin was started with.
+    /// @param seconds     integer - time the listing stays valid, at most a day.
+    ///
+    /// @note Only use it for listings that don't change meanwhile, refreshing
+    /// the container drops all cached listings of the plugin.
+    ///
+    ///
+    /// ------------------------------------------------------------------------
+    /// @python_v18
+    /// New function added.
+    ///
+    /// **Example:**
+    /// ~~~~~~~~~~~~~{.py}
+    /// ..
+    /// xbmcplugin.setCacheTTL(int(sys.argv[1]), 600)
+    /// ..
+    /// ~~~~~~~~~~~~~
+    ///
+    setCacheTTL(...);
+#else
+    void setCacheTTL(int handle, int seconds);
+#endif
+
 #ifdef DOXYGEN_SHOULD_USE_THIS
     ///
     /// \ingroup python_xbmcplugin
@@ -41,7 +41,43 @@ namespace XBMCAddon
     {
       XBMC_TRACE;
       abortEvent.Set();
-      invokeCallback(new CallbackFunction<Monitor>(this,&Monitor::onAbortRequested));
+      if (IsSubscribed(CALLBACK_ABORTREQUESTED))
+        invokeCallback(new CallbackFunction<Monitor>(this,&Monitor::onAbortRequested));
+    }
+
+    void Monitor::SettingsChanged()
+    {
+      XBMC_TRACE;
+      settingsChangedPending = false;
+      onSettingsChanged();
+    }
+
+    void Monitor::checkOverrides(const std::function<bool(const char* method)>& overrides)
+    {
+      XBMC_TRACE;
+      static const std::pair<Callbacks, const char*> callbacks[] = {
+        { CALLBACK_SETTINGSCHANGED, "onSettingsChanged" },
+        { CALLBACK_SCREENSAVERACTIVATED, "onScreensaverActivated" },
+        { CALLBACK_SCREENSAVERDEACTIVATED, "onScreensaverDeactivated" },
+        { CALLBACK_DPMSACTIVATED, "onDPMSActivated" },
+        { CALLBACK_DPMSDEACTIVATED, "onDPMSDeactivated" },
+        { CALLBACK_SCANSTARTED, "onScanStarted" },
+        { CALLBACK_SCANFINISHED, "onScanFinished" },
+        { CALLBACK_DATABASESCANSTARTED, "onDatabaseScanStarted" },
+        { CALLBACK_DATABASEUPDATED, "onDatabaseUpdated" },
+        { CALLBACK_CLEANSTARTED, "onCleanStarted" },
+        { CALLBACK_CLEANFINISHED, "onCleanFinished" },
+        { CALLBACK_ABORTREQUESTED, "onAbortRequested" },
+        { CALLBACK_NOTIFICATION, "onNotification" },
+      };
+
+      unsigned int used = 0;
+      for (const auto& callback : callbacks)
+      {
+        if (overrides(callback.second))
+          used |= callback.first;
+      }
+      subscribed = used;
     }
 
     bool Monitor::waitForAbort(double timeout)
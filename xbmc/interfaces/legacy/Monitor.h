@@ -23,6 +23,9 @@
 #include "AddonCallback.h"
 #include "AddonString.h"
 
+#include <atomic>
+#include <functional>
+
 namespace XBMCAddon
 {
   namespace xbmc
@@ -43,35 +46,76 @@ namespace XBMCAddon
       String Id;
       long invokerId;
       CEvent abortEvent;
+
+#ifndef SWIG
+      enum Callbacks
+      {
+        CALLBACK_SETTINGSCHANGED = 1 << 0,
+        CALLBACK_SCREENSAVERACTIVATED = 1 << 1,
+        CALLBACK_SCREENSAVERDEACTIVATED = 1 << 2,
+        CALLBACK_DPMSACTIVATED = 1 << 3,
+        CALLBACK_DPMSDEACTIVATED = 1 << 4,
+        CALLBACK_SCANSTARTED = 1 << 5,
+        CALLBACK_SCANFINISHED = 1 << 6,
+        CALLBACK_DATABASESCANSTARTED = 1 << 7,
+        CALLBACK_DATABASEUPDATED = 1 << 8,
+        CALLBACK_CLEANSTARTED = 1 << 9,
+        CALLBACK_CLEANFINISHED = 1 << 10,
+        CALLBACK_ABORTREQUESTED = 1 << 11,
+        CALLBACK_NOTIFICATION = 1 << 12,
+        CALLBACK_ALL = ~0u
+      };
+      std::atomic<unsigned int> subscribed{CALLBACK_ALL};
+      std::atomic<bool> settingsChangedPending{false};
+
+      inline bool IsSubscribed(Callbacks callback) const { return (subscribed & callback) != 0; }
+      void SettingsChanged();
+#endif
     public:
       Monitor();
 
 #ifndef SWIG
-      inline void    OnSettingsChanged() { XBMC_TRACE; invokeCallback(new CallbackFunction<Monitor>(this,&Monitor::onSettingsChanged)); }
-      inline void    OnScreensaverActivated() { XBMC_TRACE; invokeCallback(new CallbackFunction<Monitor>(this,&Monitor::onScreensaverActivated)); }
-      inline void    OnScreensaverDeactivated() { XBMC_TRACE; invokeCallback(new CallbackFunction<Monitor>(this,&Monitor::onScreensaverDeactivated)); }
-      inline void    OnDPMSActivated() { XBMC_TRACE; invokeCallback(new CallbackFunction<Monitor>(this,&Monitor::onDPMSActivated)); }
-      inline void    OnDPMSDeactivated() { XBMC_TRACE; invokeCallback(new CallbackFunction<Monitor>(this,&Monitor::onDPMSDeactivated)); }
+      inline void    OnSettingsChanged()
+      {
+        XBMC_TRACE;
+        // one pending call covers any number of changes
+        if (IsSubscribed(CALLBACK_SETTINGSCHANGED) && !settingsChangedPending.exchange(true))
+          invokeCallback(new CallbackFunction<Monitor>(this,&Monitor::SettingsChanged));
+      }
+      inline void    OnScreensaverActivated() { XBMC_TRACE; if (IsSubscribed(CALLBACK_SCREENSAVERACTIVATED)) invokeCallback(new CallbackFunction<Monitor>(this,&Monitor::onScreensaverActivated)); }
+      inline void    OnScreensaverDeactivated() { XBMC_TRACE; if (IsSubscribed(CALLBACK_SCREENSAVERDEACTIVATED)) invokeCallback(new CallbackFunction<Monitor>(this,&Monitor::onScreensaverDeactivated)); }
+      inline void    OnDPMSActivated() { XBMC_TRACE; if (IsSubscribed(CALLBACK_DPMSACTIVATED)) invokeCallback(new CallbackFunction<Monitor>(this,&Monitor::onDPMSActivated)); }
+      inline void    OnDPMSDeactivated() { XBMC_TRACE; if (IsSubscribed(CALLBACK_DPMSDEACTIVATED)) invokeCallback(new CallbackFunction<Monitor>(this,&Monitor::onDPMSDeactivated)); }
       inline void    OnScanStarted(const String &library)
       {
 	XBMC_TRACE;
-	invokeCallback(new CallbackFunction<Monitor,const String>(this,&Monitor::onScanStarted,library));
-	invokeCallback(new CallbackFunction<Monitor,const String>(this,&Monitor::onDatabaseScanStarted,library));
+	if (IsSubscribed(CALLBACK_SCANSTARTED))
+	  invokeCallback(new CallbackFunction<Monitor,const String>(this,&Monitor::onScanStarted,library));
+	if (IsSubscribed(CALLBACK_DATABASESCANSTARTED))
+	  invokeCallback(new CallbackFunction<Monitor,const String>(this,&Monitor::onDatabaseScanStarted,library));
       }
       inline void    OnScanFinished(const String &library)
       {
 	XBMC_TRACE;
-	invokeCallback(new CallbackFunction<Monitor,const String>(this,&Monitor::onScanFinished,library));
-	invokeCallback(new CallbackFunction<Monitor,const String>(this,&Monitor::onDatabaseUpdated,library));
+	if (IsSubscribed(CALLBACK_SCANFINISHED))
+	  invokeCallback(new CallbackFunction<Monitor,const String>(this,&Monitor::onScanFinished,library));
+	if (IsSubscribed(CALLBACK_DATABASEUPDATED))
+	  invokeCallback(new CallbackFunction<Monitor,const String>(this,&Monitor::onDatabaseUpdated,library));
       }
-      inline void    OnCleanStarted(const String &library) { XBMC_TRACE; invokeCallback(new CallbackFunction<Monitor,const String>(this,&Monitor::onCleanStarted,library)); }
-      inline void    OnCleanFinished(const String &library) { XBMC_TRACE; invokeCallback(new CallbackFunction<Monitor,const String>(this,&Monitor::onCleanFinished,library)); }
-      inline void    OnNotification(const String &sender, const String &method, const String &data) { XBMC_TRACE; invokeCallback(new CallbackFunction<Monitor,const String,const String,const String>(this,&Monitor::onNotification,sender,method,data)); }
+      inline void    OnCleanStarted(const String &library) { XBMC_TRACE; if (IsSubscribed(CALLBACK_CLEANSTARTED)) invokeCallback(new CallbackFunction<Monitor,const String>(this,&Monitor::onCleanStarted,library)); }
+      inline void    OnCleanFinished(const String &library) { XBMC_TRACE; if (IsSubscribed(CALLBACK_CLEANFINISHED)) invokeCallback(new CallbackFunction<Monitor,const String>(this,&Monitor::onCleanFinished,library)); }
+      inline void    OnNotification(const String &sender, const String &method, const String &data) { XBMC_TRACE; if (IsSubscribed(CALLBACK_NOTIFICATION)) invokeCallback(new CallbackFunction<Monitor,const String,const String,const String>(this,&Monitor::onNotification,sender,method,data)); }
 
       inline const String& GetId() { return Id; }
       inline long GetInvokerId() { return invokerId; }
 
       void OnAbortRequested();
+
+      /**
+       * Callbacks the script's Monitor class does not implement are not
+       * queued at all.
+       */
+      void checkOverrides(const std::function<bool(const char* method)>& overrides) override;
 #endif
 
 #ifdef DOXYGEN_SHOULD_USE_THIS
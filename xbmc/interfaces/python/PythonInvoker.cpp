@@ -120,7 +120,7 @@ static std::vector<char *> getCPointersToArguments(std::vector<std::vector<char>
 
 CPythonInvoker::CPythonInvoker(ILanguageInvocationHandler *invocationHandler)
   : ILanguageInvoker(invocationHandler),
-    m_threadState(NULL), m_stop(false)
+    m_threadState(NULL), m_interpreterState(NULL), m_stop(false)
 { }
 
 CPythonInvoker::~CPythonInvoker()
@@ -150,7 +150,8 @@ bool CPythonInvoker::Execute(const std::string &script, const std::vector<std::s
     return false;
   }
 
-  if (!onExecutionInitialized())
+  // a reused interpreter is still counted by the invocation handler
+  if (m_interpreterState == NULL && !onExecutionInitialized())
     return false;
 
   return ILanguageInvoker::Execute(script, arguments);
@@ -170,7 +171,12 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
 
   // get the global lock
   PyEval_AcquireLock();
-  PyThreadState* state = Py_NewInterpreter();
+  // take over the interpreter of the previous script, it's only kept again if this one ends cleanly
+  PyThreadState* state = static_cast<PyThreadState*>(m_interpreterState);
+  bool reused = state != NULL;
+  m_interpreterState = NULL;
+  if (!reused)
+    state = Py_NewInterpreter();
   if (state == NULL)
   {
     PyEval_ReleaseLock();
@@ -180,10 +186,20 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   // swap in my thread state
   PyThreadState_Swap(state);
 
-  XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> languageHook(new XBMCAddon::Python::PythonLanguageHook(state->interp));
-  languageHook->RegisterMe();
+  XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> languageHook;
+  if (reused)
+    languageHook = XBMCAddon::Python::PythonLanguageHook::GetIfExists(state->interp);
+  if (!languageHook)
+  {
+    languageHook = new XBMCAddon::Python::PythonLanguageHook(state->interp);
+    languageHook->RegisterMe();
+  }
 
-  onInitialization();
+  // the modules and the initialization script stay set up in a reused interpreter
+  if (reused)
+    CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): reusing the interpreter of the previous script", GetId(), m_sourceFile.c_str());
+  else
+    onInitialization();
   setState(InvokerStateInitialized);
 
   std::string realFilename(CSpecialProtocol::TranslatePath(m_sourceFile));
@@ -196,56 +212,9 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   // this is used for python so it will search modules from script path first
   std::string scriptDir = URIUtils::GetDirectory(realFilename);
   URIUtils::RemoveSlashAtEnd(scriptDir);
-  addPath(scriptDir);
-
-  // add all addon module dependencies to path
-  if (m_addon)
-  {
-    std::set<std::string> paths;
-    getAddonModuleDeps(m_addon, paths);
-    for (std::set<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it)
-      addPath(*it);
-  }
-  else
-  { // for backwards compatibility.
-    // we don't have any addon so just add all addon modules installed
-    CLog::Log(LOGWARNING, "CPythonInvoker(%d): Script invoked without an addon. Adding all addon "
-        "modules installed to python path as fallback. This behaviour will be removed in future "
-        "version.", GetId());
-    ADDON::VECADDONS addons;
-    CServiceBroker::GetAddonMgr().GetAddons(addons, ADDON::ADDON_SCRIPT_MODULE);
-    for (unsigned int i = 0; i < addons.size(); ++i)
-      addPath(CSpecialProtocol::TranslatePath(addons[i]->LibPath()));
-  }
-
-  // we want to use sys.path so it includes site-packages
-  // if this fails, default to using Py_GetPath
-  PyObject *sysMod(PyImport_ImportModule((char*)"sys")); // must call Py_DECREF when finished
-  PyObject *sysModDict(PyModule_GetDict(sysMod)); // borrowed ref, no need to delete
-  PyObject *pathObj(PyDict_GetItemString(sysModDict, "path")); // borrowed ref, no need to delete
-
-  if (pathObj != NULL && PyList_Check(pathObj))
-  {
-    for (int i = 0; i < PyList_Size(pathObj); i++)
-    {
-      PyObject *e = PyList_GetItem(pathObj, i); // borrowed ref, no need to delete
-      if (e != NULL && PyString_Check(e))
-        addNativePath(PyString_AsString(e)); // returns internal data, don't delete or modify
-#ifdef TARGET_WINDOWS_STORE
-      // uwp python operates unicodes
-      else if (e != NULL && PyUnicode_Check(e))
-      {
-        PyObject *utf8 = PyUnicode_AsUTF8String(e);
-        addNativePath(PyString_AsString(utf8));
-        Py_DECREF(utf8);
-      }
-#endif
-    }
-  }
-  else
-    addNativePath(Py_GetPath());
-
-  Py_DECREF(sysMod); // release ref to sysMod
+  // a reused interpreter runs the same script, so the path is the same
+  if (!reused)
+    initializePath(scriptDir);
 
   // set current directory and python's path.
   PySys_SetArgv(argc, &argv[0]);
@@ -262,6 +231,19 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): entering source directory %s", GetId(), m_sourceFile.c_str(), scriptDir.c_str());
   PyObject* module = PyImport_AddModule((char*)"__main__");
   PyObject* moduleDict = PyModule_GetDict(module);
+  if (reused)
+  {
+    // start from a clean __main__, the modules imported before stay loaded
+    PyDict_Clear(moduleDict);
+    PyObject *name = PyString_FromString("__main__");
+    PyDict_SetItemString(moduleDict, "__name__", name);
+    Py_DECREF(name);
+    PyDict_SetItemString(moduleDict, "__builtins__", PyEval_GetBuiltins());
+
+    PyObject *m = PyImport_AddModule((char*)"xbmc");
+    if (m == NULL || PyObject_SetAttrString(m, (char*)"abortRequested", PyBool_FromLong(0)))
+      CLog::Log(LOGERROR, "CPythonInvoker(%d, %s): failed to reset abortRequested", GetId(), m_sourceFile.c_str());
+  }
 
   // when we are done initing we store thread state so we can be aborted
   PyThreadState_Swap(NULL);
@@ -426,6 +408,18 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
       PyRun_SimpleString(GC_SCRIPT) == -1)
     CLog::Log(LOGERROR, "CPythonInvoker(%d, %s): failed to run the gc to clean up after running prior to shutting down the Interpreter", GetId(), m_sourceFile.c_str());
 
+  // keep the interpreter for the next script unless the script was stopped or
+  // exited by SystemExit (see above), onExecutionReleased() ends it eventually
+  if (IsReusable() && !m_stop && !systemExitThrown)
+  {
+    m_interpreterState = state;
+    PyThreadState_Swap(NULL);
+    PyEval_ReleaseLock();
+
+    setState(stateToSet);
+    return true;
+  }
+
   Py_EndInterpreter(state);
 
   // If we still have objects left around, produce an error message detailing what's been left behind
@@ -537,6 +531,45 @@ bool CPythonInvoker::stop(bool abort)
   return true;
 }
 
+bool CPythonInvoker::Reset()
+{
+  if (m_interpreterState == NULL)
+    return false;
+
+  {
+    CSingleLock lock(m_critical);
+    m_stop = false;
+  }
+  m_stoppedEvent.Reset();
+
+  return ILanguageInvoker::Reset();
+}
+
+void CPythonInvoker::onExecutionReleased()
+{
+  if (m_interpreterState == NULL)
+    return;
+
+  PyEval_AcquireLock();
+  PyThreadState* state = static_cast<PyThreadState*>(m_interpreterState);
+  m_interpreterState = NULL;
+  PyThreadState_Swap(state);
+
+  XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> languageHook(XBMCAddon::Python::PythonLanguageHook::GetIfExists(state->interp));
+  Py_EndInterpreter(state);
+
+  if (languageHook)
+  {
+    if (languageHook->HasRegisteredAddonClasses())
+      CLog::Log(LOGWARNING, "CPythonInvoker(%d, %s): the reused interpreter has left several "
+        "classes in memory that we couldn't clean up. The classes include: %s",
+        GetId(), m_sourceFile.c_str(), getListOfAddonClassesAsString(languageHook).c_str());
+    languageHook->UnregisterMe();
+  }
+
+  PyEval_ReleaseLock();
+}
+
 void CPythonInvoker::onExecutionFailed()
 {
   PyThreadState_Swap(NULL);
@@ -551,6 +584,61 @@ void CPythonInvoker::onExecutionFailed()
   ILanguageInvoker::onExecutionFailed();
 }
 
+void CPythonInvoker::initializePath(const std::string &scriptDir)
+{
+  m_pythonPath.clear();
+  addPath(scriptDir);
+
+  // add all addon module dependencies to path
+  if (m_addon)
+  {
+    std::set<std::string> paths;
+    getAddonModuleDeps(m_addon, paths);
+    for (std::set<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+      addPath(*it);
+  }
+  else
+  { // for backwards compatibility.
+    // we don't have any addon so just add all addon modules installed
+    CLog::Log(LOGWARNING, "CPythonInvoker(%d): Script invoked without an addon. Adding all addon "
+        "modules installed to python path as fallback. This behaviour will be removed in future "
+        "version.", GetId());
+    ADDON::VECADDONS addons;
+    CServiceBroker::GetAddonMgr().GetAddons(addons, ADDON::ADDON_SCRIPT_MODULE);
+    for (unsigned int i = 0; i < addons.size(); ++i)
+      addPath(CSpecialProtocol::TranslatePath(addons[i]->LibPath()));
+  }
+
+  // we want to use sys.path so it includes site-packages
+  // if this fails, default to using Py_GetPath
+  PyObject *sysMod(PyImport_ImportModule((char*)"sys")); // must call Py_DECREF when finished
+  PyObject *sysModDict(PyModule_GetDict(sysMod)); // borrowed ref, no need to delete
+  PyObject *pathObj(PyDict_GetItemString(sysModDict, "path")); // borrowed ref, no need to delete
+
+  if (pathObj != NULL && PyList_Check(pathObj))
+  {
+    for (int i = 0; i < PyList_Size(pathObj); i++)
+    {
+      PyObject *e = PyList_GetItem(pathObj, i); // borrowed ref, no need to delete
+      if (e != NULL && PyString_Check(e))
+        addNativePath(PyString_AsString(e)); // returns internal data, don't delete or modify
+#ifdef TARGET_WINDOWS_STORE
+      // uwp python operates unicodes
+      else if (e != NULL && PyUnicode_Check(e))
+      {
+        PyObject *utf8 = PyUnicode_AsUTF8String(e);
+        addNativePath(PyString_AsString(utf8));
+        Py_DECREF(utf8);
+      }
+#endif
+    }
+  }
+  else
+    addNativePath(Py_GetPath());
+
+  Py_DECREF(sysMod); // release ref to sysMod
+}
+
 std::map<std::string, CPythonInvoker::PythonModuleInitialization> CPythonInvoker::getModules() const
 {
   static std::map<std::string, PythonModuleInitialization> modules;
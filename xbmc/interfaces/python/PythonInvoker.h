@@ -36,6 +36,7 @@ public:
   bool Execute(const std::string &script, const std::vector<std::string> &arguments = std::vector<std::string>()) override;
 
   bool IsStopping() const override { return m_stop || ILanguageInvoker::IsStopping(); }
+  bool Reset() override;
 
   typedef void (*PythonModuleInitialization)();
   
@@ -45,6 +46,7 @@ protected:
   virtual void executeScript(void *fp, const std::string &script, void *module, void *moduleDict);
   bool stop(bool abort) override;
   void onExecutionFailed() override;
+  void onExecutionReleased() override;
 
   // custom virtual methods
   virtual std::map<std::string, PythonModuleInitialization> getModules() const;
@@ -62,6 +64,7 @@ protected:
   CCriticalSection m_critical;
 
 private:
+  void initializePath(const std::string &scriptDir);
   void initializeModules(const std::map<std::string, PythonModuleInitialization> &modules);
   bool initializeModule(PythonModuleInitialization module);
   void addPath(const std::string& path); // add path in UTF-8 encoding
@@ -70,6 +73,7 @@ private:
 
   std::string m_pythonPath;
   void *m_threadState;
+  void *m_interpreterState; // the interpreter kept for the next script if reusable
   bool m_stop;
   CEvent m_stoppedEvent;
 
@@ -21,6 +21,7 @@
 #include "LanguageHook.h"
 #include "swig.h"
 #include "utils/StringUtils.h"
+#include "interfaces/legacy/AddonCallback.h"
 #include "interfaces/legacy/AddonString.h"
 
 #include <string>
@@ -381,6 +382,27 @@ namespace PythonBindings
     return (PyObject*)self;
   }
 
+  void checkCallbackOverrides(XBMCAddon::AddonClass* api, PyObject* pyobj)
+  {
+    XBMCAddon::AddonCallback* callback = dynamic_cast<XBMCAddon::AddonCallback*>(api);
+    if (!callback || !pyobj || pyobj == Py_None)
+      return;
+
+    PyObject* mro = Py_TYPE(pyobj)->tp_mro;
+    callback->checkOverrides([mro](const char* method)
+    {
+      // the api types are static, classes defined in python are heap types
+      for (Py_ssize_t i = 0; mro && i < PyTuple_GET_SIZE(mro); i++)
+      {
+        PyTypeObject* type = reinterpret_cast<PyTypeObject*>(PyTuple_GET_ITEM(mro, i));
+        if ((type->tp_flags & Py_TPFLAGS_HEAPTYPE) && type->tp_dict &&
+            PyDict_GetItemString(type->tp_dict, method))
+          return true;
+      }
+      return false;
+    });
+  }
+
   std::map<std::type_index, const TypeInfo*> typeInfoLookup;
 
   void registerAddonClassTypeInformation(const TypeInfo* classInfo)
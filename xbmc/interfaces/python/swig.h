@@ -154,6 +154,13 @@ namespace PythonBindings
     return makePythonInstance(api,NULL,incrementRefCount);
   }
 
+  /**
+   * This method is a helper for the generated API. It's called after python
+   *  created a new api instance, to let callback classes know which of their
+   *  callbacks the python class implements.
+   */
+  void checkCallbackOverrides(XBMCAddon::AddonClass* api, PyObject* pyobj);
+
   void registerAddonClassTypeInformation(const TypeInfo* classInfo);
   const TypeInfo* getTypeInfoForInstance(XBMCAddon::AddonClass* obj);
 
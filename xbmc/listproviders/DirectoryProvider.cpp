@@ -20,6 +20,7 @@
 
 #include "DirectoryProvider.h"
 
+#include <map>
 #include <memory>
 #include <utility>
 #include "ServiceBroker.h"
@@ -39,6 +40,7 @@
 #include "pvr/dialogs/GUIDialogPVRGuideInfo.h"
 #include "pvr/dialogs/GUIDialogPVRRecordingInfo.h"
 #include "settings/Settings.h"
+#include "threads/Event.h"
 #include "threads/SingleLock.h"
 #include "utils/JobManager.h"
 #include "utils/log.h"
@@ -55,11 +57,100 @@ using namespace ANNOUNCEMENT;
 using namespace KODI::MESSAGING;
 using namespace PVR;
 
+class CDirectoryProvider::CSharedResult
+{
+public:
+  /*!
+   \brief Get the items, listing the directory if they aren't known yet
+   Providers asking while the directory is listed wait for it instead of
+   listing it again.
+   */
+  bool GetItems(const std::string &url, CFileItemList &items)
+  {
+    unsigned int generation = 0;
+    while (true)
+    {
+      CSingleLock lock(m_section);
+      if (m_valid)
+      {
+        items.Copy(m_items);
+        return true;
+      }
+      if (!m_listing)
+      {
+        m_listing = true;
+        m_listed.Reset();
+        generation = m_generation;
+        break;
+      }
+      lock.Leave();
+      m_listed.Wait();
+    }
+
+    const bool success = CDirectory::GetDirectory(url, items, "", DIR_FLAG_DEFAULTS);
+
+    CSingleLock lock(m_section);
+    m_listing = false;
+    // the directory may have changed while being listed
+    if (success && generation == m_generation)
+    {
+      m_items.Copy(items);
+      m_valid = true;
+    }
+    m_listed.Set();
+
+    return success;
+  }
+
+  void Invalidate()
+  {
+    CSingleLock lock(m_section);
+    m_valid = false;
+    m_items.Clear();
+    m_generation++;
+  }
+
+  static std::shared_ptr<CSharedResult> Get(const std::string &url)
+  {
+    static CCriticalSection resultsSection;
+    static std::map<std::string, std::weak_ptr<CSharedResult>> results;
+
+    CSingleLock lock(resultsSection);
+
+    // forget the directories no provider lists anymore
+    for (auto it = results.begin(); it != results.end();)
+    {
+      if (it->second.expired() && it->first != url)
+        it = results.erase(it);
+      else
+        ++it;
+    }
+
+    std::shared_ptr<CSharedResult> result = results[url].lock();
+    if (!result)
+    {
+      result = std::make_shared<CSharedResult>();
+      results[url] = result;
+    }
+    return result;
+  }
+
+private:
+  CCriticalSection m_section;
+  CEvent m_listed{true, true};
+  bool m_listing = false;
+  bool m_valid = false;
+  unsigned int m_generation = 0;
+  CFileItemList m_items;
+};
+
 class CDirectoryJob : public CJob
 {
 public:
-  CDirectoryJob(const std::string &url, SortDescription sort, int limit, int parentID)
+  CDirectoryJob(const std::string &url, std::shared_ptr<CDirectoryProvider::CSharedResult> result,
+                SortDescription sort, int limit, int parentID)
     : m_url(url),
+      m_result(std::move(result)),
       m_sort(sort),
       m_limit(limit),
       m_parentID(parentID)
@@ -67,6 +158,7 @@ public:
   ~CDirectoryJob() override = default;
 
   const char* GetType() const override { return "directory"; }
+  bool IsIOBound() const override { return true; }
   bool operator==(const CJob *job) const override
   {
     if (strcmp(job->GetType(),GetType()) == 0)
@@ -81,7 +173,7 @@ public:
   bool DoWork() override
   {
     CFileItemList items;
-    if (CDirectory::GetDirectory(m_url, items, "", DIR_FLAG_DEFAULTS))
+    if (m_result->GetItems(m_url, items))
     {
       // sort the items if necessary
       if (m_sort.sortBy != SortByNone)
@@ -150,6 +242,7 @@ public:
   }
 private:
   std::string m_url;
+  std::shared_ptr<CDirectoryProvider::CSharedResult> m_result;
   std::string m_target;
   SortDescription m_sort;
   unsigned int m_limit;
@@ -217,7 +310,8 @@ bool CDirectoryProvider::Update(bool forceRefresh)
     CLog::Log(LOGDEBUG, "CDirectoryProvider[%s]: refreshing..", m_currentUrl.c_str());
     if (m_jobID)
       CJobManager::GetInstance().CancelJob(m_jobID);
-    m_jobID = CJobManager::GetInstance().AddJob(new CDirectoryJob(m_currentUrl, m_currentSort, m_currentLimit, m_parentID), this);
+    m_result = CSharedResult::Get(m_currentUrl);
+    m_jobID = CJobManager::GetInstance().AddJob(new CDirectoryJob(m_currentUrl, m_result, m_currentSort, m_currentLimit, m_parentID), this);
   }
 
   if (!changed)
@@ -254,7 +348,7 @@ void CDirectoryProvider::Announce(AnnouncementFlag flag, const char *sender, con
             m_currentSort.sortBy == SortByLastPlayed ||
             m_currentSort.sortBy == SortByPlaycount ||
             m_currentSort.sortBy == SortByLastUsed)
-          m_updateState = INVALIDATED;
+          Invalidate();
       }
     }
     else
@@ -269,7 +363,7 @@ void CDirectoryProvider::Announce(AnnouncementFlag flag, const char *sender, con
           strcmp(message, "OnCleanFinished") == 0 ||
           strcmp(message, "OnUpdate") == 0 ||
           strcmp(message, "OnRemove") == 0)
-        m_updateState = INVALIDATED;
+        Invalidate();
     }
   }
 }
@@ -295,7 +389,7 @@ void CDirectoryProvider::OnAddonEvent(const ADDON::AddonEvent& event)
         typeid(event) == typeid(ADDON::AddonEvents::ReInstalled) ||
         typeid(event) == typeid(ADDON::AddonEvents::UnInstalled) ||
         typeid(event) == typeid(ADDON::AddonEvents::MetadataChanged))
-      m_updateState = INVALIDATED;
+      Invalidate();
   }
 }
 
@@ -309,7 +403,7 @@ void CDirectoryProvider::OnPVRManagerEvent(const PVR::PVREvent& event)
         event == ManagerError ||
         event == ManagerInterrupted ||
         event == RecordingsInvalidated)
-      m_updateState = INVALIDATED;
+      Invalidate();
   }
 }
 
@@ -317,7 +411,15 @@ void CDirectoryProvider::OnFavouritesEvent(const CFavouritesService::FavouritesU
 {
   CSingleLock lock(m_section);
   if (URIUtils::IsProtocol(m_currentUrl, "favourites"))
-    m_updateState = INVALIDATED;
+    Invalidate();
+}
+
+void CDirectoryProvider::Invalidate()
+{
+  // the other providers listing the directory get the new items too
+  if (m_result)
+    m_result->Invalidate();
+  m_updateState = INVALIDATED;
 }
 
 void CDirectoryProvider::Reset()
@@ -333,6 +435,7 @@ void CDirectoryProvider::Reset()
   m_currentSort.sortBy = SortByNone;
   m_currentSort.sortOrder = SortOrderAscending;
   m_currentLimit = 0;
+  m_result.reset();
   m_updateState = OK;
 
   if (m_isAnnounced)
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 #include "addons/AddonEvents.h"
@@ -69,6 +70,12 @@ public:
 
   // callback from directory job
   void OnJobComplete(unsigned int jobID, bool success, CJob *job) override;
+
+  /*!
+   \brief Items of a directory, shared by the providers listing it
+   */
+  class CSharedResult;
+
 private:
   UpdateState      m_updateState;
   bool             m_isAnnounced;
@@ -84,8 +91,10 @@ private:
   unsigned int     m_currentLimit;
   std::vector<CGUIStaticItemPtr> m_items;
   std::vector<InfoTagType> m_itemTypes;
+  std::shared_ptr<CSharedResult> m_result; ///< \brief kept while we list its directory
   CCriticalSection m_section;
 
+  void Invalidate();
   bool UpdateURL();
   bool UpdateLimit();
   bool UpdateSort();
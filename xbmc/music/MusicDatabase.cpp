@@ -34,6 +34,7 @@
 #include "dialogs/GUIDialogSelect.h"
 #include "FileItem.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/ExistsChecker.h"
 #include "filesystem/File.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
 #include "filesystem/MusicDatabaseDirectory/QueryParams.h"
@@ -51,6 +52,7 @@
 #include "playlists/SmartPlayList.h"
 #include "profiles/ProfilesManager.h"
 #include "settings/AdvancedSettings.h"
+#include "settings/MediaSourceSettings.h"
 #include "settings/Settings.h"
 #include "Song.h"
 #include "storage/MediaManager.h"
@@ -64,6 +66,7 @@
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/XMLUtils.h"
+#include <algorithm>
 #include <inttypes.h>
 
 using namespace XFILE;
@@ -203,6 +206,9 @@ void CMusicDatabase::CreateTables()
   CLog::Log(LOGINFO, "create versiontagscan table");
   m_pDS->exec("CREATE TABLE versiontagscan (idVersion integer, iNeedsScan integer)");
   m_pDS->exec(PrepareSQL("INSERT INTO versiontagscan (idVersion, iNeedsScan) values(%i, 0)", GetSchemaVersion()));
+
+  CLog::Log(LOGINFO, "create revision table");
+  CreateRevisionTable();
 }
 
 void CMusicDatabase::CreateAnalytics()
@@ -246,23 +252,38 @@ void CMusicDatabase::CreateAnalytics()
 
   m_pDS->exec("CREATE INDEX ix_art ON art(media_id, media_type(20), type(20))");
 
+  CreateRevisionIndex();
+
   CLog::Log(LOGINFO, "create triggers");
   m_pDS->exec("CREATE TRIGGER tgrDeleteAlbum AFTER delete ON album FOR EACH ROW BEGIN"
               "  DELETE FROM song WHERE song.idAlbum = old.idAlbum;"
               "  DELETE FROM album_artist WHERE album_artist.idAlbum = old.idAlbum;"
-              "  DELETE FROM art WHERE media_id=old.idAlbum AND media_type='album';"
-              " END");
+              "  DELETE FROM art WHERE media_id=old.idAlbum AND media_type='album'; " +
+              GetRevisionSQL(MediaTypeAlbum, "old.idAlbum", true) +
+              "END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteArtist AFTER delete ON artist FOR EACH ROW BEGIN"
               "  DELETE FROM album_artist WHERE album_artist.idArtist = old.idArtist;"
               "  DELETE FROM song_artist WHERE song_artist.idArtist = old.idArtist;"
               "  DELETE FROM discography WHERE discography.idArtist = old.idArtist;"
-              "  DELETE FROM art WHERE media_id=old.idArtist AND media_type='artist';"
-              " END");
+              "  DELETE FROM art WHERE media_id=old.idArtist AND media_type='artist'; " +
+              GetRevisionSQL(MediaTypeArtist, "old.idArtist", true) +
+              "END");
   m_pDS->exec("CREATE TRIGGER tgrDeleteSong AFTER delete ON song FOR EACH ROW BEGIN"
               "  DELETE FROM song_artist WHERE song_artist.idSong = old.idSong;"
               "  DELETE FROM song_genre WHERE song_genre.idSong = old.idSong;"
-              "  DELETE FROM art WHERE media_id=old.idSong AND media_type='song';"
-              " END");
+              "  DELETE FROM art WHERE media_id=old.idSong AND media_type='song'; " +
+              GetRevisionSQL(MediaTypeSong, "old.idSong", true) +
+              "END");
+
+  // library revisions for clients listing only what changed, see GetRevision()
+  CreateRevisionTriggers(MediaTypeSong, "song", "idSong");
+  CreateRevisionTriggers(MediaTypeAlbum, "album", "idAlbum");
+  CreateRevisionTriggers(MediaTypeArtist, "artist", "idArtist");
+
+  // full-text indexes for the search window
+  CreateFullTextIndex("songsearch", "song", "idSong", { "strTitle" });
+  CreateFullTextIndex("albumsearch", "album", "idAlbum", { "strAlbum" });
+  CreateFullTextIndex("artistsearch", "artist", "idArtist", { "strArtist" });
   
   // we create views last to ensure all indexes are rolled in
   CreateViews();
@@ -616,12 +637,12 @@ bool CMusicDatabase::GetSong(int idSong, CSong& song)
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    std::string strSQL=PrepareSQL("SELECT songview.*,songartistview.* FROM songview "
-                                 " JOIN songartistview ON songview.idSong = songartistview.idSong "
-                                 " WHERE songview.idSong = %i "
-                                 " ORDER BY songartistview.idRole, songartistview.iOrder", idSong);
+    std::string strSQL="SELECT songview.*,songartistview.* FROM songview "
+                       " JOIN songartistview ON songview.idSong = songartistview.idSong "
+                       " WHERE songview.idSong = ? "
+                       " ORDER BY songartistview.idRole, songartistview.iOrder";
 
-    if (!m_pDS->query(strSQL)) return false;
+    if (!m_pDS->query(strSQL, { dbiplus::field_value(idSong) })) return false;
     int iRowsFound = m_pDS->num_rows();
     if (iRowsFound == 0)
     {
@@ -2377,7 +2398,13 @@ bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList &art
 
     std::string strVariousArtists = g_localizeStrings.Get(340).c_str();
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    Filter filter;
+    if (AppendFullTextSearch("artistsearch", "artist.idArtist", {}, search, filter))
+    {
+      filter.AppendWhere(PrepareSQL("strArtist <> '%s'", strVariousArtists.c_str()));
+      BuildSQL("select artist.* from artist", filter, strSQL);
+    }
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL=PrepareSQL("select * from artist "
                                 "where (strArtist like '%s%%' or strArtist like '%% %s%%') and strArtist <> '%s' "
                                 , search.c_str(), search.c_str(), strVariousArtists.c_str() );
@@ -2922,7 +2949,13 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList &items
       return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    Filter filter;
+    if (AppendFullTextSearch("songsearch", "songview.idSong", {}, search, filter))
+    {
+      filter.limit = "1000";
+      BuildSQL("select songview.* from songview", filter, strSQL);
+    }
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' or strTitle like '%% %s%%' limit 1000", search.c_str(), search.c_str());
     else
       strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' limit 1000", search.c_str());
@@ -2958,7 +2991,10 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList &albu
     if (NULL == m_pDS.get()) return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    Filter filter;
+    if (AppendFullTextSearch("albumsearch", "albumview.idAlbum", {}, search, filter))
+      BuildSQL("select albumview.* from albumview", filter, strSQL);
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%' or strAlbum like '%% %s%%'", search.c_str(), search.c_str());
     else
       strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%'", search.c_str());
@@ -2988,7 +3024,8 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList &albu
   return false;
 }
 
-bool CMusicDatabase::CleanupSongsByIds(const std::string &strSongIds)
+bool CMusicDatabase::CleanupSongsByIds(const std::string &strSongIds, const std::vector<std::string> &offlinePaths,
+                                       CGUIDialogProgress* progressDialog /*= nullptr*/)
 {
   try
   {
@@ -3003,7 +3040,8 @@ bool CMusicDatabase::CleanupSongsByIds(const std::string &strSongIds)
       m_pDS->close();
       return true;
     }
-    std::vector<std::string> songsToDelete;
+    std::vector<std::string> songIds;
+    std::vector<std::string> songPaths;
     while (!m_pDS->eof())
     { // get the full song path
       std::string strFileName = URIUtils::AddFileToFolder(m_pDS->fv("path.strPath").get_asString(), m_pDS->fv("song.strFileName").get_asString());
@@ -3018,14 +3056,44 @@ bool CMusicDatabase::CleanupSongsByIds(const std::string &strSongIds)
         URIUtils::RemoveSlashAtEnd(strFileName);
       }
 
-      if (!CFile::Exists(strFileName, false))
-      { // file no longer exists, so add to deletion list
-        songsToDelete.push_back(m_pDS->fv("song.idSong").get_asString());
+      // songs of a source that is offline are kept until it is back
+      bool offline = false;
+      for (const auto &path : offlinePaths)
+      {
+        if (URIUtils::PathHasParent(strFileName, path))
+        {
+          offline = true;
+          break;
+        }
+      }
+
+      if (!offline)
+      {
+        songIds.push_back(m_pDS->fv("song.idSong").get_asString());
+        songPaths.push_back(strFileName);
       }
       m_pDS->next();
     }
     m_pDS->close();
 
+    CExistsChecker checker;
+    std::vector<CExistsChecker::Result> songsExist = checker.Check(songPaths, false,
+      [progressDialog](size_t done, size_t total)
+      {
+        return progressDialog == nullptr || !progressDialog->IsCanceled();
+      });
+    if (progressDialog && progressDialog->IsCanceled())
+      return false;
+
+    std::vector<std::string> songsToDelete;
+    for (size_t i = 0; i < songsExist.size(); i++)
+    {
+      if (songsExist[i] == CExistsChecker::MISSING)
+      { // file no longer exists, so add to deletion list
+        songsToDelete.push_back(songIds[i]);
+      }
+    }
+
     if (!songsToDelete.empty())
     {
       std::string strSongsToDelete = "(" + StringUtils::Join(songsToDelete, ",") + ")";
@@ -3052,6 +3120,29 @@ bool CMusicDatabase::CleanupSongs(CGUIDialogProgress* progressDialog /*= nullptr
     // Count total number of songs
     total = (int)strtol(GetSingleValue("SELECT COUNT(1) FROM song", m_pDS).c_str(), nullptr, 10);
 
+    // look if the sources are online first, otherwise every song of one that is
+    // offline would have to time out and would then be deleted
+    std::vector<std::string> sourcePaths;
+    for (const auto &source : *CMediaSourceSettings::GetInstance().GetSources("music"))
+    {
+      if (source.vecPaths.empty())
+        sourcePaths.push_back(source.strPath);
+      else
+        sourcePaths.insert(sourcePaths.end(), source.vecPaths.begin(), source.vecPaths.end());
+    }
+
+    std::vector<std::string> offlinePaths;
+    std::vector<CExistsChecker::Result> sourcesOnline = CExistsChecker().Check(sourcePaths, true);
+    for (size_t i = 0; i < sourcesOnline.size(); i++)
+    {
+      if (sourcesOnline[i] != CExistsChecker::EXISTS)
+      {
+        CLog::Log(LOGWARNING, "%s: Source %s is not available, keeping its songs", __FUNCTION__,
+                  CURL::GetRedacted(sourcePaths[i]).c_str());
+        offlinePaths.push_back(sourcePaths[i]);
+      }
+    }
+
     // run through all songs and get all unique path ids
     int iLIMIT = 1000;
     for (int i=0;;i+=iLIMIT)
@@ -3089,7 +3180,7 @@ bool CMusicDatabase::CleanupSongs(CGUIDialogProgress* progressDialog /*= nullptr
           return false;
         }
       }
-      if (!CleanupSongsByIds(strSongIds)) return false;
+      if (!CleanupSongsByIds(strSongIds, offlinePaths, progressDialog)) return false;
     }
     return true;
   }
@@ -3144,9 +3235,16 @@ bool CMusicDatabase::CleanupPaths()
     // we can happily delete any path that has no reference to a song
     // but we must keep all paths that have been scanned that may contain songs in subpaths
 
-    // first create a temporary table of song paths
-    m_pDS->exec("CREATE TEMPORARY TABLE songpaths (idPath integer, strPath varchar(512))\n");
-    m_pDS->exec("INSERT INTO songpaths select idPath,strPath from path where idPath in (select idPath from song)\n");
+    // first load the paths of the songs, sorted so the paths below a path follow it
+    std::vector<std::string> songPaths;
+    if (!m_pDS->query("select strPath from path where idPath in (select idPath from song)")) return false;
+    while (!m_pDS->eof())
+    {
+      songPaths.push_back(m_pDS->fv("strPath").get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    std::sort(songPaths.begin(), songPaths.end());
 
     // grab all paths that aren't immediately connected with a song
     std::string sql = "select * from path where idPath not in (select idPath from song)";
@@ -3163,21 +3261,19 @@ bool CMusicDatabase::CleanupPaths()
     {
       // anything that isn't a parent path of a song path is to be deleted
       std::string path = m_pDS->fv("strPath").get_asString();
-      std::string sql = PrepareSQL("select count(idPath) from songpaths where SUBSTR(strPath,1,%i)='%s'", StringUtils::utf8_strlen(path.c_str()), path.c_str());
-      if (m_pDS2->query(sql) && m_pDS2->num_rows() == 1 && m_pDS2->fv(0).get_asInt() == 0)
+      auto songPath = std::lower_bound(songPaths.begin(), songPaths.end(), path);
+      if (songPath == songPaths.end() || !StringUtils::StartsWith(*songPath, path))
         pathIds.push_back(m_pDS->fv("idPath").get_asString()); // nothing found, so delete
-      m_pDS2->close();
       m_pDS->next();
     }
     m_pDS->close();
 
     if (!pathIds.empty())
     {
-      // do the deletion, and drop our temp table
+      // do the deletion
       std::string deleteSQL = "DELETE FROM path WHERE idPath IN (" + StringUtils::Join(pathIds, ",") + ")";
       m_pDS->exec(deleteSQL);
     }
-    m_pDS->exec("drop table songpaths");
     return true;
   }
   catch (...)
@@ -4619,6 +4715,31 @@ bool CMusicDatabase::GetSongsByWhere(const std::string &baseDir, const Filter &f
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "songview.*") + strSQLExtra;
 
     CLog::Log(LOGDEBUG, "%s query = %s", __FUNCTION__, strSQL.c_str());
+
+    // without sorting the rows are used in the order they're returned, so
+    // read them one at a time instead of holding the whole result in memory
+    if (sortDescription.sortBy == SortByNone)
+    {
+      if (!m_pDS->query_forward_only(strSQL))
+        return false;
+
+      int count = 0;
+      while (!m_pDS->eof())
+      {
+        CFileItemPtr item(new CFileItem);
+        GetFileItemFromDataset(m_pDS->get_sql_record(), item.get(), musicUrl);
+        // HACK for sorting by database returned order
+        item->m_iprogramCount = ++count;
+        items.Add(item);
+        m_pDS->next();
+      }
+      m_pDS->close();
+
+      if (count > 0)
+        items.SetProperty("total", total < count ? count : total);
+      return true;
+    }
+
     // run query
     if (!m_pDS->query(strSQL))
       return false;
@@ -5330,6 +5451,8 @@ void CMusicDatabase::UpdateTables(int version)
     // Update all songs iStartOffset and iEndOffset to milliseconds instead of frames (* 1000 / 75)
     m_pDS->exec("UPDATE song SET iStartOffset = iStartOffset * 40 / 3, iEndOffset = iEndOffset * 40 / 3 \n");
   }
+  if (version < 72)
+    CreateRevisionTable();
 
   // Set the verion of tag scanning required. 
   // Not every schema change requires the tags to be rescanned, set to the highest schema version 
@@ -5350,7 +5473,7 @@ void CMusicDatabase::UpdateTables(int version)
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 70;
+  return 72;
 }
 
 int CMusicDatabase::GetMusicNeedsTagScan()
@@ -6350,6 +6473,77 @@ bool CMusicDatabase::SetSongUserrating(int idSong, int userrating)
   return false;
 }
 
+bool CMusicDatabase::SetSongReplayGain(int idSong, const ReplayGain& replayGain)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string sql = PrepareSQL("UPDATE song SET strReplayGain='%s' WHERE idSong = %i", replayGain.Get().c_str(), idSong);
+    m_pDS->exec(sql);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%i) failed", __FUNCTION__, idSong);
+  }
+  return false;
+}
+
+bool CMusicDatabase::GetSongsWithoutReplayGain(std::vector<CSong>& songs, std::set<int>& completeAlbums)
+{
+  songs.clear();
+  completeAlbums.clear();
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    // songs of a cue sheet share a file, they can't be decoded on their own
+    std::string strSQL = "SELECT song.idSong, song.idAlbum, path.strPath, song.strFileName, "
+                         "(SELECT COUNT(1) FROM song AS albumsong WHERE albumsong.idAlbum = song.idAlbum) AS iAlbumSongs "
+                         "FROM song JOIN path ON song.idPath = path.idPath "
+                         "WHERE (song.strReplayGain IS NULL OR song.strReplayGain = '') "
+                         "AND song.iStartOffset = 0 AND song.iEndOffset = 0 "
+                         "ORDER BY song.idAlbum";
+    if (!m_pDS->query(strSQL)) return false;
+    if (m_pDS->num_rows() == 0)
+    {
+      m_pDS->close();
+      return false;
+    }
+
+    std::map<int, int> albumSongs;
+    std::map<int, int> foundSongs;
+    while (!m_pDS->eof())
+    {
+      CSong song;
+      song.idSong = m_pDS->fv("song.idSong").get_asInt();
+      song.idAlbum = m_pDS->fv("song.idAlbum").get_asInt();
+      song.strFileName = URIUtils::AddFileToFolder(m_pDS->fv("path.strPath").get_asString(),
+                                                   m_pDS->fv("song.strFileName").get_asString());
+      albumSongs[song.idAlbum] = m_pDS->fv("iAlbumSongs").get_asInt();
+      foundSongs[song.idAlbum]++;
+      songs.push_back(song);
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    for (const auto& album : foundSongs)
+    {
+      if (album.second == albumSongs[album.first])
+        completeAlbums.insert(album.first);
+    }
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
 bool CMusicDatabase::SetAlbumUserrating(const int idAlbum, int userrating)
 {
   try
@@ -6412,8 +6606,8 @@ int CMusicDatabase::GetSongIDFromPath(const std::string &filePath)
     URIUtils::Split(filePath, strPath, strFileName);
     URIUtils::AddSlashAtEnd(strPath);
 
-    std::string sql = PrepareSQL("select idSong from song join path on song.idPath = path.idPath where song.strFileName='%s' and path.strPath='%s'", strFileName.c_str(), strPath.c_str());
-    if (!m_pDS->query(sql)) return -1;
+    std::string sql = "select idSong from song join path on song.idPath = path.idPath where song.strFileName=? and path.strPath=?";
+    if (!m_pDS->query(sql, { dbiplus::field_value(strFileName), dbiplus::field_value(strPath) })) return -1;
 
     if (m_pDS->num_rows() == 0)
     {
@@ -6435,7 +6629,12 @@ int CMusicDatabase::GetSongIDFromPath(const std::string &filePath)
 bool CMusicDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
-  { // number of items in the db has likely changed, so reset the infomanager cache
+  {
+    // the scanners batching their writes refresh this once they are done
+    if (InBatch())
+      return true;
+
+    // number of items in the db has likely changed, so reset the infomanager cache
     CGUIComponent* gui = CServiceBroker::GetGUI();
     if (gui)
     {
@@ -7420,6 +7619,30 @@ bool CMusicDatabase::GetArtTypes(const MediaType &mediaType, std::vector<std::st
   return false;
 }
 
+bool CMusicDatabase::GetArtURLs(std::vector<std::string> &urls)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    if (!m_pDS->query("SELECT DISTINCT url FROM art")) return false;
+    urls.reserve(urls.size() + m_pDS->num_rows());
+    while (!m_pDS->eof())
+    {
+      urls.emplace_back(m_pDS->fv(0).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
 bool CMusicDatabase::GetFilter(CDbUrl &musicUrl, Filter &filter, SortDescription &sorting)
 {
   if (!musicUrl.IsValid())
@@ -7778,6 +8001,18 @@ bool CMusicDatabase::GetFilter(CDbUrl &musicUrl, Filter &filter, SortDescription
     }
   }
 
+  option = options.find("revision");
+  if (option != options.end())
+  {
+    int revision = (int)option->second.asInteger();
+    if (type == "artists")
+      filter.AppendWhere(GetChangedSinceCondition("artistview.idArtist", MediaTypeArtist, revision));
+    else if (type == "albums")
+      filter.AppendWhere(GetChangedSinceCondition("albumview.idAlbum", MediaTypeAlbum, revision));
+    else
+      filter.AppendWhere(GetChangedSinceCondition("songview.idSong", MediaTypeSong, revision));
+  }
+
   option = options.find("filter");
   if (option != options.end())
   {
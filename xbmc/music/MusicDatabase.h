@@ -22,6 +22,7 @@
 \brief
 */
 #pragma once
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -38,7 +39,7 @@ class CFileItem;
 namespace dbiplus
 {
   class field_value;
-  typedef std::vector<field_value> sql_record;
+  class sql_record;
 }
 
 #include <set>
@@ -209,6 +210,16 @@ public:
   bool RemoveSongsFromPath(const std::string &path, MAPSONGS& songs, bool exact=true);
   bool SetSongUserrating(const std::string &filePath, int userrating);
   bool SetSongUserrating(int idSong, int userrating);
+  bool SetSongReplayGain(int idSong, const ReplayGain& replayGain);
+
+  /*!
+   \brief Gets the songs without replay gain values that can be analyzed, ordered by album.
+   Songs from cue sheets are left out.
+   \param songs [out] the idSong, idAlbum and full path of each song
+   \param completeAlbums [out] the albums with all of their songs in the list
+   \return true if any songs were found
+   */
+  bool GetSongsWithoutReplayGain(std::vector<CSong>& songs, std::set<int>& completeAlbums);
   bool SetSongVotes(const std::string &filePath, int votes);
   int  GetSongByArtistAndAlbumAndTitle(const std::string& strArtist, const std::string& strAlbum, const std::string& strTitle);
 
@@ -565,6 +576,12 @@ public:
   */
   bool GetArtTypes(const MediaType &mediaType, std::vector<std::string> &artTypes);
 
+  /*! \brief Fetch the urls of all art held in the database.
+  \param urls [out] the distinct urls of all art, appended to any already in the vector.
+  \return true if successful, false otherwise.
+  */
+  bool GetArtURLs(std::vector<std::string> &urls);
+
   /////////////////////////////////////////////////
   // Tag Scan Version
   /////////////////////////////////////////////////
@@ -619,7 +636,12 @@ private:
   void GetFileItemFromDataset(const dbiplus::sql_record* const record, CFileItem* item, const CMusicDbUrl &baseUrl);
   void GetFileItemFromArtistCredits(VECARTISTCREDITS& artistCredits, CFileItem* item);
   bool CleanupSongs(CGUIDialogProgress* progressDialog = nullptr);
-  bool CleanupSongsByIds(const std::string &strSongIds);
+  /*! \brief Delete the songs whose files no longer exist
+   \param strSongIds ids of the songs to look for, e.g. "(1,2,3)"
+   \param offlinePaths sources that are offline, their songs are kept
+   */
+  bool CleanupSongsByIds(const std::string &strSongIds, const std::vector<std::string> &offlinePaths,
+                         CGUIDialogProgress* progressDialog = nullptr);
   bool CleanupPaths();
   bool CleanupAlbums();
   bool CleanupArtists();
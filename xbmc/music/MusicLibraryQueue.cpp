@@ -20,24 +20,32 @@
 
 #include "MusicLibraryQueue.h"
 
+#include <set>
+#include <string.h>
 #include <utility>
+#include <vector>
 
 #include "ServiceBroker.h"
 #include "dialogs/GUIDialogProgress.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
 #include "GUIUserMessages.h"
+#include "music/MusicDatabase.h"
 #include "music/jobs/MusicLibraryCleaningJob.h"
 #include "music/jobs/MusicLibraryExportJob.h"
+#include "music/jobs/MusicLibraryReplayGainJob.h"
 #include "music/jobs/MusicLibraryScanningJob.h"
 #include "music/jobs/MusicLibraryJob.h"
+#include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
 #include "Util.h"
+#include "utils/log.h"
 #include "utils/Variant.h"
 
 CMusicLibraryQueue::CMusicLibraryQueue()
   : CJobQueue(false, 1, CJob::PRIORITY_LOW),
     m_jobs(),
+    m_replayGainQueue(false, 2, CJob::PRIORITY_LOW_PAUSABLE),
     m_modal(false),
     m_exporting(false),
     m_cleaning(false)
@@ -197,6 +205,36 @@ void CMusicLibraryQueue::CleanLibraryModal()
   Refresh();
 }
 
+void CMusicLibraryQueue::AnalyzeReplayGain()
+{
+  // songs still queued would be picked up twice
+  if (m_replayGainQueue.IsProcessing())
+    return;
+
+  CMusicDatabase db;
+  if (!db.Open())
+    return;
+
+  std::vector<CSong> songs;
+  std::set<int> completeAlbums;
+  if (!db.GetSongsWithoutReplayGain(songs, completeAlbums))
+    return;
+
+  CLog::Log(LOGNOTICE, "%s - analyzing %u songs without replay gain", __FUNCTION__,
+            static_cast<unsigned int>(songs.size()));
+
+  std::vector<CSong> album;
+  for (std::vector<CSong>::const_iterator song = songs.begin(); song != songs.end(); ++song)
+  {
+    album.push_back(*song);
+    if (song + 1 == songs.end() || (song + 1)->idAlbum != song->idAlbum)
+    {
+      m_replayGainQueue.AddJob(new CMusicLibraryReplayGainJob(album, completeAlbums.find(song->idAlbum) != completeAlbums.end()));
+      album.clear();
+    }
+  }
+}
+
 void CMusicLibraryQueue::AddJob(CMusicLibraryJob *job)
 {
   if (job == NULL)
@@ -248,6 +286,7 @@ void CMusicLibraryQueue::CancelAllJobs()
 {
   CSingleLock lock(m_critical);
   CJobQueue::CancelJobs();
+  m_replayGainQueue.CancelJobs();
 
   // remove all scanning jobs
   m_jobs.clear();
@@ -271,6 +310,11 @@ void CMusicLibraryQueue::OnJobComplete(unsigned int jobID, bool success, CJob *j
   {
     if (QueueEmpty())
       Refresh();
+
+    // newly added songs mostly come without replay gain tags
+    if (g_advancedSettings.m_bMusicLibraryAnalyzeReplayGain &&
+        strcmp(job->GetType(), "MusicLibraryScanningJob") == 0)
+      AnalyzeReplayGain();
   }
 
   {
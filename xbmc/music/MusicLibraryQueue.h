@@ -100,6 +100,13 @@ public:
    */
   void CleanLibraryModal();
   
+  /*!
+   \brief Enqueue replay gain analysis jobs for all songs without replay gain values.
+   The songs of each album are analyzed by one job, a few jobs are processed at once
+   at pausable low priority separately from the other library jobs.
+   */
+  void AnalyzeReplayGain();
+
   /*!
    \brief Adds the given job to the queue.
    \param[in] job Music library job to be queued.
@@ -141,6 +148,8 @@ private:
   MusicLibraryJobMap m_jobs;
   CCriticalSection m_critical;
 
+  CJobQueue m_replayGainQueue;
+
   bool m_modal;
   bool m_exporting;
   bool m_cleaning;
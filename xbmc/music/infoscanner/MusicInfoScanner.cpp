@@ -21,6 +21,8 @@
 #include "MusicInfoScanner.h"
 
 #include <algorithm>
+#include <map>
+#include <memory>
 #include <utility>
 
 #include "ServiceBroker.h"
@@ -55,10 +57,14 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "TextureCache.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "Util.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
+#include "utils/JobManager.h"
+#include "utils/LibraryChangeJournal.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -133,6 +139,9 @@ void CMusicInfoScanner::Process()
       m_bCanInterrupt = false;
       m_needsCleanup = false;
 
+      // commit the albums added in groups rather than one transaction each
+      m_musicDatabase.BeginBatch();
+
       bool commit = true;
       for (std::set<std::string>::const_iterator it = m_pathsToScan.begin(); it != m_pathsToScan.end(); ++it)
       {
@@ -159,6 +168,9 @@ void CMusicInfoScanner::Process()
             // Set local art for added album disc sets and primary album artists
             RetrieveLocalArt();
 
+            // don't hold the write lock while waiting on the scrapers
+            m_musicDatabase.FlushBatch();
+
             if (m_flags & SCAN_ONLINE)
               // Download additional album and artist information for the recently added albums.
               // This also identifies any local artist thumb and fanart if it exists, and gives it priority, 
@@ -173,8 +185,12 @@ void CMusicInfoScanner::Process()
         }
       }
 
+      m_musicDatabase.EndBatch();
+
       if (commit)
       {
+        CLibraryChangeJournal::GetInstance().MarkScanned(m_strStartDir, m_journalPosition);
+
         CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider().ResetLibraryBools();
 
         if (m_needsCleanup)
@@ -297,6 +313,13 @@ void CMusicInfoScanner::Start(const std::string& strDirectory, int flags)
   m_seenPaths.clear();
   m_albumsAdded.clear();
   m_flags = flags;
+  m_strStartDir = strDirectory;
+
+  // anything changing from here on is picked up by the next scan
+  CLibraryChangeJournal &journal = CLibraryChangeJournal::GetInstance();
+  journal.UpdateSources();
+  m_journalPosition = journal.GetPosition();
+  m_useJournal = strDirectory.empty() && !(flags & SCAN_RESCAN);
 
   if (strDirectory.empty())
   { // scan all paths in the database.  We do this by scanning all paths in the db, and crossing them off the list as
@@ -473,6 +496,12 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
 
   m_seenPaths.insert(strDirectory);
 
+  if (m_useJournal && CLibraryChangeJournal::GetInstance().IsUnchanged(strDirectory))
+  {
+    CLog::Log(LOGDEBUG, "%s - skipping '%s' as nothing changed below it", __FUNCTION__, strDirectory.c_str());
+    return true;
+  }
+
   // Discard all excluded files defined by m_musicExcludeRegExps
   const std::vector<std::string> &regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
 
@@ -555,11 +584,9 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
 {
   std::vector<std::string> regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
 
+  std::vector<CFileItemPtr> files;
   for (int i = 0; i < items.Size(); ++i)
   {
-    if (m_bStop)
-      return INFO_CANCELLED;
-
     CFileItemPtr pItem = items[i];
 
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
@@ -568,15 +595,20 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
     if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
       continue;
 
+    files.push_back(pItem);
+  }
+
+  if (!ReadTags(files))
+    return INFO_CANCELLED;
+
+  for (const auto &pItem : files)
+  {
+    if (m_bStop)
+      return INFO_CANCELLED;
+
     m_currentItem++;
 
     CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
-    {
-      std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
-      if (NULL != pLoader.get())
-        pLoader->Load(pItem->GetPath(), tag);
-    }
 
     if (m_handle && m_itemCount>0)
       m_handle->SetPercentage(static_cast<float>(m_currentItem * 100) / static_cast<float>(m_itemCount));
@@ -600,6 +632,82 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
   return INFO_ADDED;
 }
 
+/*!
+ \brief Tags read by the jobs of ReadTags, by index of the file.
+ Shared with the jobs so that a job finishing after the scan was cancelled has somewhere to put its result.
+ */
+struct CTagReadResults
+{
+  CCriticalSection section;
+  CEvent done;
+  unsigned int pending = 0;
+  std::map<size_t, CMusicInfoTag> tags;
+};
+
+static void ReadTag(const CFileItem &item, CMusicInfoTag &tag)
+{
+  std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(item));
+  if (NULL != pLoader.get())
+    pLoader->Load(item.GetPath(), tag);
+}
+
+bool CMusicInfoScanner::ReadTags(const std::vector<std::shared_ptr<CFileItem>> &files)
+{
+  unsigned int readers = g_advancedSettings.m_musicLibraryTagReaders;
+  if (readers < 2 || files.size() < 2)
+  {
+    for (const auto &pItem : files)
+    {
+      if (m_bStop)
+        return false;
+      if (!pItem->GetMusicInfoTag()->Loaded())
+        ReadTag(*pItem, *pItem->GetMusicInfoTag());
+    }
+    return true;
+  }
+
+  // each read waits on the network for most of its time, so keep several going
+  std::shared_ptr<CTagReadResults> results = std::make_shared<CTagReadResults>();
+  CJobQueue queue(false, readers, CJob::PRIORITY_LOW);
+  for (size_t i = 0; i < files.size(); ++i)
+  {
+    if (files[i]->GetMusicInfoTag()->Loaded())
+      continue;
+
+    {
+      CSingleLock lock(results->section);
+      results->pending++;
+    }
+
+    std::shared_ptr<CFileItem> item = std::make_shared<CFileItem>(*files[i]);
+    queue.Submit([results, item, i]()
+    {
+      CMusicInfoTag tag;
+      ReadTag(*item, tag);
+
+      CSingleLock lock(results->section);
+      results->tags.insert(std::make_pair(i, tag));
+      results->pending--;
+      results->done.Set();
+    });
+  }
+
+  CSingleLock lock(results->section);
+  while (results->pending > 0)
+  {
+    if (m_bStop)
+      return false;
+
+    results->done.Reset();
+    CSingleExit exit(results->section);
+    results->done.WaitMSec(100);
+  }
+
+  for (auto &it : results->tags)
+    *files[it.first]->GetMusicInfoTag() = it.second;
+  return true;
+}
+
 static bool SortSongsByTrack(const CSong& song, const CSong& song2)
 {
   return song.iTrack < song2.iTrack;
@@ -906,6 +1014,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
 
     album->strPath = strDirectory;
     m_musicDatabase.AddAlbum(*album);
+    m_musicDatabase.BatchItemDone();
     m_albumsAdded.insert(album->idAlbum);
     
     numAdded += album->songs.size();
@@ -18,6 +18,10 @@
  *  <http://www.gnu.org/licenses/>.
  *
  */
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
 #include "InfoScanner.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
@@ -26,6 +30,7 @@
 #include "threads/IRunnable.h"
 
 class CAlbum;
+class CFileItem;
 class CArtist;
 class CGUIDialogProgressBarHandle;
 
@@ -225,6 +230,13 @@ protected:
    \param scannedItems [in] list to populate with the scannedItems
    */
   INFO_RET ScanTags(const CFileItemList& items, CFileItemList& scannedItems);
+
+  /*! \brief Read the tags of the files that don't have them yet, several at once.
+   The number of reads at once is set by <musiclibrary><tagreaders> in advancedsettings.xml.
+   \param files [in/out] the files, their tags are filled in.
+   \return false if the scan was cancelled.
+   */
+  bool ReadTags(const std::vector<std::shared_ptr<CFileItem>> &files);
   int GetPathHash(const CFileItemList &items, std::string &hash);
   void GetAlbumArtwork(long id, const CAlbum &artist);
 
@@ -254,6 +266,9 @@ protected:
  
   std::set<std::string> m_seenPaths;
   int m_flags;
+  std::string m_strStartDir;
+  bool m_useJournal = false;        ///< whether folders the change journal has nothing for are skipped
+  uint64_t m_journalPosition = 0;   ///< position in the change journal when the scan started
   CThread m_fileCountReader;
 };
 }
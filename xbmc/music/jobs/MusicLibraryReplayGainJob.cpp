@@ -0,0 +1,260 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MusicLibraryReplayGainJob.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+#include "FileItem.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/paplayer/CodecFactory.h"
+#include "cores/paplayer/ICodec.h"
+#include "music/MusicDatabase.h"
+#include "music/tags/LoudnessMeter.h"
+#include "threads/Thread.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+namespace
+{
+const double REFERENCE_LOUDNESS = -18.0; // LUFS, replay gain 2.0
+const int CPU_LOAD_LIMIT = 75; // percent, the analysis itself counts as well
+const unsigned int IDLE_WAIT = 1000; // ms
+const unsigned int READ_FRAMES = 4096;
+const unsigned int LOAD_CHECK_INTERVAL = 10; // seconds of audio
+
+double GetChannelWeight(AEChannel channel)
+{
+  switch (channel)
+  {
+    case AE_CH_LFE:
+      return 0.0;
+    case AE_CH_SL:
+    case AE_CH_SR:
+    case AE_CH_BL:
+    case AE_CH_BR:
+      return 1.41;
+    default:
+      return 1.0;
+  }
+}
+
+// the formats codecs hand out, see VideoPlayerCodec::NeedConvert
+bool IsSupported(AEDataFormat format)
+{
+  switch (format)
+  {
+    case AE_FMT_U8:
+    case AE_FMT_S16NE:
+    case AE_FMT_S32NE:
+    case AE_FMT_FLOAT:
+    case AE_FMT_DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void ToFloat(AEDataFormat format, const uint8_t* data, unsigned int count, std::vector<float>& samples)
+{
+  samples.resize(count);
+  switch (format)
+  {
+    case AE_FMT_U8:
+      for (unsigned int i = 0; i < count; i++)
+        samples[i] = (data[i] - 128) / 128.0f;
+      break;
+    case AE_FMT_S16NE:
+    {
+      const int16_t* src = reinterpret_cast<const int16_t*>(data);
+      for (unsigned int i = 0; i < count; i++)
+        samples[i] = src[i] / 32768.0f;
+      break;
+    }
+    case AE_FMT_S32NE:
+    {
+      const int32_t* src = reinterpret_cast<const int32_t*>(data);
+      for (unsigned int i = 0; i < count; i++)
+        samples[i] = static_cast<float>(src[i] / 2147483648.0);
+      break;
+    }
+    case AE_FMT_FLOAT:
+      memcpy(samples.data(), data, count * sizeof(float));
+      break;
+    case AE_FMT_DOUBLE:
+    {
+      const double* src = reinterpret_cast<const double*>(data);
+      for (unsigned int i = 0; i < count; i++)
+        samples[i] = static_cast<float>(src[i]);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+float GetGain(double loudness)
+{
+  // nothing to normalize on silence
+  if (!std::isfinite(loudness))
+    return 0.0f;
+  return static_cast<float>(REFERENCE_LOUDNESS - loudness);
+}
+}
+
+CMusicLibraryReplayGainJob::CMusicLibraryReplayGainJob(const std::vector<CSong>& songs, bool completeAlbum)
+  : m_songs(songs),
+    m_completeAlbum(completeAlbum)
+{ }
+
+CMusicLibraryReplayGainJob::~CMusicLibraryReplayGainJob() = default;
+
+bool CMusicLibraryReplayGainJob::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(), GetType()) != 0)
+    return false;
+
+  const CMusicLibraryReplayGainJob* replayGainJob = dynamic_cast<const CMusicLibraryReplayGainJob*>(job);
+  if (replayGainJob == nullptr || replayGainJob->m_songs.size() != m_songs.size())
+    return false;
+
+  return m_songs.empty() || replayGainJob->m_songs.front().idSong == m_songs.front().idSong;
+}
+
+bool CMusicLibraryReplayGainJob::Work(CMusicDatabase &db)
+{
+  std::vector<std::unique_ptr<CLoudnessMeter>> meters;
+  bool completeAlbum = m_completeAlbum;
+  for (size_t i = 0; i < m_songs.size(); i++)
+  {
+    if (ShouldCancel(i, m_songs.size()) || !WaitForIdle())
+      return false;
+
+    meters.push_back(Analyze(m_songs[i].strFileName));
+    if (!meters.back())
+      completeAlbum = false;
+  }
+
+  // the album is gated as a whole, not averaged over its songs
+  ReplayGain::Info albumGain;
+  if (completeAlbum && !meters.empty())
+  {
+    std::vector<double> blocks;
+    float peak = 0.0f;
+    for (const auto& meter : meters)
+    {
+      blocks.insert(blocks.end(), meter->GetBlocks().begin(), meter->GetBlocks().end());
+      peak = std::max(peak, meter->GetPeak());
+    }
+    albumGain.SetGain(GetGain(CLoudnessMeter::GetIntegratedLoudness(blocks)));
+    albumGain.SetPeak(peak);
+  }
+
+  db.BeginTransaction();
+  for (size_t i = 0; i < m_songs.size(); i++)
+  {
+    if (!meters[i])
+      continue;
+
+    ReplayGain replayGain;
+    replayGain.SetGain(ReplayGain::TRACK, GetGain(meters[i]->GetIntegratedLoudness()));
+    replayGain.SetPeak(ReplayGain::TRACK, meters[i]->GetPeak());
+    if (albumGain.Valid())
+      replayGain.Set(ReplayGain::ALBUM, albumGain);
+
+    if (!db.SetSongReplayGain(m_songs[i].idSong, replayGain))
+    {
+      db.RollbackTransaction();
+      return false;
+    }
+  }
+  return db.CommitTransaction();
+}
+
+std::unique_ptr<CLoudnessMeter> CMusicLibraryReplayGainJob::Analyze(const std::string& strFileName) const
+{
+  CFileItem item(strFileName, false);
+  std::unique_ptr<ICodec> codec(CodecFactory::CreateCodecDemux(item, 0));
+  if (!codec || !codec->Init(item, 0))
+  {
+    CLog::Log(LOGDEBUG, "CMusicLibraryReplayGainJob: unable to decode %s", strFileName.c_str());
+    return nullptr;
+  }
+
+  const AEAudioFormat& format = codec->m_format;
+  const unsigned int channels = format.m_channelLayout.Count();
+  const unsigned int sampleSize = CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3;
+  if (channels == 0 || format.m_sampleRate == 0 || sampleSize == 0 || !IsSupported(format.m_dataFormat))
+  {
+    CLog::Log(LOGDEBUG, "CMusicLibraryReplayGainJob: unsupported format %s in %s",
+              CAEUtil::DataFormatToStr(format.m_dataFormat), strFileName.c_str());
+    return nullptr;
+  }
+
+  std::vector<double> weights;
+  for (unsigned int i = 0; i < channels; i++)
+    weights.push_back(GetChannelWeight(format.m_channelLayout[i]));
+  std::unique_ptr<CLoudnessMeter> meter(new CLoudnessMeter(format.m_sampleRate, weights));
+
+  std::vector<uint8_t> buffer(READ_FRAMES * channels * sampleSize);
+  std::vector<float> samples;
+  unsigned int framesToCheck = format.m_sampleRate * LOAD_CHECK_INTERVAL;
+  int result = READ_SUCCESS;
+  while (result == READ_SUCCESS)
+  {
+    int readSize = 0;
+    result = codec->ReadPCM(buffer.data(), static_cast<int>(buffer.size()), &readSize);
+    if (result == READ_ERROR)
+    {
+      CLog::Log(LOGDEBUG, "CMusicLibraryReplayGainJob: error decoding %s", strFileName.c_str());
+      return nullptr;
+    }
+
+    unsigned int frames = readSize / (sampleSize * channels);
+    ToFloat(format.m_dataFormat, buffer.data(), frames * channels, samples);
+    meter->AddFrames(samples.data(), frames);
+
+    if (frames >= framesToCheck)
+    {
+      if (!WaitForIdle())
+        return nullptr;
+      framesToCheck = format.m_sampleRate * LOAD_CHECK_INTERVAL;
+    }
+    else
+      framesToCheck -= frames;
+  }
+
+  CLog::Log(LOGDEBUG, "CMusicLibraryReplayGainJob: %s %.2f LUFS, peak %.4f", strFileName.c_str(),
+            meter->GetIntegratedLoudness(), meter->GetPeak());
+  return meter;
+}
+
+bool CMusicLibraryReplayGainJob::WaitForIdle() const
+{
+  while (g_cpuInfo.getUsedPercentage() > CPU_LOAD_LIMIT)
+  {
+    if (ShouldCancel(0, 0))
+      return false;
+    XbmcThreads::ThreadSleep(IDLE_WAIT);
+  }
+  return !ShouldCancel(0, 0);
+}
@@ -0,0 +1,71 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <vector>
+
+#include "music/Song.h"
+#include "music/jobs/MusicLibraryJob.h"
+
+class CLoudnessMeter;
+
+/*!
+ \brief Music library job measuring the loudness of songs without replay
+ gain values and storing the results in the music database.
+
+ A job handles the songs of one album, the album gain is only set if all songs
+ of the album are part of the job.
+ */
+class CMusicLibraryReplayGainJob : public CMusicLibraryJob
+{
+public:
+  /*!
+   \brief Creates a new replay gain analysis job.
+   \param[in] songs Songs of an album with their idSong and full path set
+   \param[in] completeAlbum Whether the songs are all songs of the album
+  */
+  CMusicLibraryReplayGainJob(const std::vector<CSong>& songs, bool completeAlbum);
+  ~CMusicLibraryReplayGainJob() override;
+
+  // specialization of CJob
+  const char *GetType() const override { return "MusicLibraryReplayGainJob"; }
+  bool operator==(const CJob* job) const override;
+
+protected:
+  // implementation of CMusicLibraryJob
+  bool Work(CMusicDatabase &db) override;
+
+private:
+  /*!
+   \brief Decodes a file and measures it.
+   \return the meter holding the results or nullptr if the file can't be decoded
+  */
+  std::unique_ptr<CLoudnessMeter> Analyze(const std::string& strFileName) const;
+
+  /*!
+   \brief Waits while the system is busy.
+   \return false if the job got cancelled meanwhile
+  */
+  bool WaitForIdle() const;
+
+  std::vector<CSong> m_songs;
+  bool m_completeAlbum;
+};
@@ -0,0 +1,155 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LoudnessMeter.h"
+
+#include <cmath>
+
+namespace
+{
+const double ABSOLUTE_GATE = -70.0; // LUFS
+const double RELATIVE_GATE = -10.0; // LU below the absolutely gated loudness
+
+double ToLoudness(double energy)
+{
+  return -0.691 + 10.0 * log10(energy);
+}
+
+double ToEnergy(double loudness)
+{
+  return pow(10.0, (loudness + 0.691) / 10.0);
+}
+}
+
+CLoudnessMeter::CLoudnessMeter(unsigned int sampleRate, const std::vector<double>& channelWeights)
+  : m_weights(channelWeights),
+    m_state(channelWeights.size())
+{
+  // K-weighting, the BS.1770 filters derived for the actual sample rate
+  double f0 = 1681.974450955533;
+  double gain = 3.999843853973347;
+  double q = 0.7071752369554196;
+  double k = tan(M_PI * f0 / sampleRate);
+  double vh = pow(10.0, gain / 20.0);
+  double vb = pow(vh, 0.4996667741545416);
+  double a0 = 1.0 + k / q + k * k;
+  m_shelf.b0 = (vh + vb * k / q + k * k) / a0;
+  m_shelf.b1 = 2.0 * (k * k - vh) / a0;
+  m_shelf.b2 = (vh - vb * k / q + k * k) / a0;
+  m_shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+  m_shelf.a2 = (1.0 - k / q + k * k) / a0;
+
+  f0 = 38.13547087602444;
+  q = 0.5003270373238773;
+  k = tan(M_PI * f0 / sampleRate);
+  a0 = 1.0 + k / q + k * k;
+  m_highpass.b0 = 1.0;
+  m_highpass.b1 = -2.0;
+  m_highpass.b2 = 1.0;
+  m_highpass.a1 = 2.0 * (k * k - 1.0) / a0;
+  m_highpass.a2 = (1.0 - k / q + k * k) / a0;
+
+  for (FilterState& state : m_state)
+    state.z[0] = state.z[1] = state.z[2] = state.z[3] = 0.0;
+
+  // gating blocks are 400ms with 75% overlap, built from 100ms sub blocks
+  m_subBlockFrames = sampleRate / 10 > 0 ? sampleRate / 10 : 1;
+  for (double& subBlock : m_subBlocks)
+    subBlock = 0.0;
+}
+
+void CLoudnessMeter::AddFrames(const float* data, unsigned int frames)
+{
+  const size_t channels = m_weights.size();
+  const Biquad& s = m_shelf;
+  const Biquad& h = m_highpass;
+
+  for (unsigned int i = 0; i < frames; i++, data += channels)
+  {
+    for (size_t c = 0; c < channels; c++)
+    {
+      double x = data[c];
+      float sample = std::fabs(data[c]);
+      if (sample > m_peak)
+        m_peak = sample;
+
+      if (m_weights[c] == 0.0)
+        continue;
+
+      // both stages in transposed direct form II, the filters are recursive
+      // so samples of a channel can't be processed side by side
+      double* z = m_state[c].z;
+      double y = s.b0 * x + z[0];
+      z[0] = s.b1 * x - s.a1 * y + z[1];
+      z[1] = s.b2 * x - s.a2 * y;
+      x = y;
+      y = h.b0 * x + z[2];
+      z[2] = h.b1 * x - h.a1 * y + z[3];
+      z[3] = h.b2 * x - h.a2 * y;
+
+      m_subEnergy += m_weights[c] * y * y;
+    }
+
+    if (++m_subFrames < m_subBlockFrames)
+      continue;
+
+    m_subBlocks[m_subCount++ % 4] = m_subEnergy / m_subBlockFrames;
+    m_subEnergy = 0.0;
+    m_subFrames = 0;
+
+    if (m_subCount >= 4)
+      m_blocks.push_back((m_subBlocks[0] + m_subBlocks[1] + m_subBlocks[2] + m_subBlocks[3]) / 4);
+  }
+}
+
+double CLoudnessMeter::GetIntegratedLoudness(const std::vector<double>& blocks)
+{
+  const double absoluteGate = ToEnergy(ABSOLUTE_GATE);
+
+  double sum = 0.0;
+  size_t count = 0;
+  for (double block : blocks)
+  {
+    if (block > absoluteGate)
+    {
+      sum += block;
+      count++;
+    }
+  }
+  if (count == 0)
+    return -HUGE_VAL;
+
+  const double relativeGate = ToEnergy(ToLoudness(sum / count) + RELATIVE_GATE);
+
+  sum = 0.0;
+  count = 0;
+  for (double block : blocks)
+  {
+    if (block > absoluteGate && block > relativeGate)
+    {
+      sum += block;
+      count++;
+    }
+  }
+  if (count == 0)
+    return -HUGE_VAL;
+
+  return ToLoudness(sum / count);
+}
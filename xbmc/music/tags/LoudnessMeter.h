@@ -0,0 +1,87 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+/*!
+ \brief Measures integrated loudness as specified by ITU-R BS.1770 / EBU R128
+ and the sample peak of a stream of interleaved float samples.
+
+ The gated blocks of several meters can be combined to get the loudness of
+ an album.
+ */
+class CLoudnessMeter
+{
+public:
+  /*!
+   \brief Creates a meter for a stream.
+   \param sampleRate sample rate of the stream
+   \param channelWeights weight of each channel, 0 for channels not measured (LFE)
+   */
+  CLoudnessMeter(unsigned int sampleRate, const std::vector<double>& channelWeights);
+
+  /*!
+   \brief Adds interleaved frames with one sample per channel weight each.
+   */
+  void AddFrames(const float* data, unsigned int frames);
+
+  /*!
+   \brief Integrated loudness in LUFS, -HUGE_VAL if everything was gated.
+   */
+  double GetIntegratedLoudness() const { return GetIntegratedLoudness(m_blocks); }
+
+  /*!
+   \brief Largest absolute sample value, 1.0 is full scale.
+   */
+  float GetPeak() const { return m_peak; }
+
+  /*!
+   \brief Mean square of each 400ms gating block, used to gate several streams together.
+   */
+  const std::vector<double>& GetBlocks() const { return m_blocks; }
+
+  static double GetIntegratedLoudness(const std::vector<double>& blocks);
+
+private:
+  struct Biquad
+  {
+    double b0, b1, b2, a1, a2;
+  };
+
+  struct FilterState
+  {
+    double z[4];
+  };
+
+  Biquad m_shelf;
+  Biquad m_highpass;
+  std::vector<double> m_weights;
+  std::vector<FilterState> m_state;
+
+  unsigned int m_subBlockFrames;
+  unsigned int m_subFrames = 0;
+  double m_subEnergy = 0.0;
+  double m_subBlocks[4];
+  unsigned int m_subCount = 0;
+
+  std::vector<double> m_blocks;
+  float m_peak = 0.0f;
+};
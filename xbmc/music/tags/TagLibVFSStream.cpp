@@ -22,10 +22,15 @@
 #include "filesystem/File.h"
 #include <taglib/tiostream.h>
 
+#include <algorithm>
+
 using namespace XFILE;
 using namespace TagLib;
 using namespace MUSIC_INFO;
 
+#define READAHEAD_HEAD 65536 // headers, most ID3v2 tags and FLAC/MP4 metadata
+#define READAHEAD_TAIL 16384 // ID3v1, APEv2 and Lyrics3 tags
+
 /*!
  * Construct a File object and opens the \a file.  \a file should be a
  * be an XBMC Vfile.
@@ -45,6 +50,13 @@ TagLibVFSStream::TagLibVFSStream(const std::string& strFileName, bool readOnly)
   }
   m_strFileName = strFileName;
   m_bIsReadOnly = readOnly || !m_bIsOpen;
+
+  m_length = m_bIsOpen ? m_file.GetLength() : 0;
+  m_position = 0;
+  m_tailOffset = 0;
+  m_readAhead = m_bIsReadOnly && m_bIsOpen && m_length > 0;
+  if (m_readAhead)
+    ReadAhead();
 }
 
 /*!
@@ -68,6 +80,17 @@ FileName TagLibVFSStream::name() const
  */
 ByteVector TagLibVFSStream::readBlock(TagLib::ulong length)
 {
+  if (m_readAhead)
+  {
+    ByteVector block;
+    if (!ReadCached(m_head, 0, length, block) && !ReadCached(m_tail, m_tailOffset, length, block))
+    {
+      block = ReadAt(m_position, length);
+      m_position += block.size();
+    }
+    return block;
+  }
+
   ByteVector byteVector(static_cast<TagLib::uint>(length));
   ssize_t read = m_file.Read(byteVector.data(), length);
   if (read > 0)
@@ -248,6 +271,23 @@ bool TagLibVFSStream::isOpen() const
  */
 void TagLibVFSStream::seek(long offset, Position p)
 {
+  if (m_readAhead)
+  {
+    int64_t position;
+    if (p == Beginning)
+      position = offset;
+    else if (p == Current)
+      position = m_position + offset;
+    else if (p == End)
+      position = m_length + offset;
+    else
+      return; // wrong Position value
+
+    // same as below, stay within the file
+    m_position = std::max<int64_t>(0, std::min<int64_t>(position, m_length));
+    return;
+  }
+
   const long fileLen = length();
   if (m_bIsReadOnly && fileLen > 0)
   {
@@ -306,7 +346,7 @@ void TagLibVFSStream::clear()
  */
 long TagLibVFSStream::tell() const
 {
-  int64_t pos = m_file.GetPosition();
+  int64_t pos = m_readAhead ? m_position : m_file.GetPosition();
   if(pos > LONG_MAX)
     return -1;
   else
@@ -318,6 +358,8 @@ long TagLibVFSStream::tell() const
  */
 long TagLibVFSStream::length()
 {
+  if (m_readAhead)
+    return (long)m_length;
   return (long)m_file.GetLength();
 }
 
@@ -328,3 +370,61 @@ void TagLibVFSStream::truncate(long length)
 {
   m_file.Truncate(length);
 }
+
+/*!
+ * Tag readers jump between the start and the end of the file in small reads,
+ * each a round trip on network filesystems, so fetch both ends in one go.
+ */
+void TagLibVFSStream::ReadAhead()
+{
+  int64_t headLength = std::min<int64_t>(m_length, READAHEAD_HEAD);
+  m_head = ReadAt(0, static_cast<TagLib::ulong>(headLength));
+
+  if (m_length > headLength)
+  {
+    m_tailOffset = std::max<int64_t>(headLength, m_length - READAHEAD_TAIL);
+    m_tail = ReadAt(m_tailOffset, static_cast<TagLib::ulong>(m_length - m_tailOffset));
+  }
+}
+
+/*!
+ * Reads \a length bytes at \a offset from the file.
+ */
+ByteVector TagLibVFSStream::ReadAt(int64_t offset, TagLib::ulong length)
+{
+  ByteVector byteVector(static_cast<TagLib::uint>(length));
+  if (m_file.GetPosition() != offset && m_file.Seek(offset, SEEK_SET) != offset)
+  {
+    byteVector.clear();
+    return byteVector;
+  }
+
+  TagLib::ulong total = 0;
+  while (total < length)
+  {
+    ssize_t read = m_file.Read(byteVector.data() + total, length - total);
+    if (read <= 0)
+      break;
+    total += read;
+  }
+  byteVector.resize(static_cast<TagLib::uint>(total));
+  return byteVector;
+}
+
+/*!
+ * Serves a read at the current position from \a cache, read ahead at \a offset.
+ * Reads running past the end of the block are only served if it ends with the file.
+ */
+bool TagLibVFSStream::ReadCached(const ByteVector &cache, int64_t offset, TagLib::ulong length, ByteVector &block)
+{
+  int64_t end = offset + cache.size();
+  if (cache.isEmpty() || m_position < offset || m_position > end)
+    return false;
+  if (m_position + static_cast<int64_t>(length) > end && end < m_length)
+    return false;
+
+  TagLib::uint count = static_cast<TagLib::uint>(std::min<int64_t>(length, end - m_position));
+  block = cache.mid(static_cast<TagLib::uint>(m_position - offset), count);
+  m_position += count;
+  return true;
+}
@@ -122,10 +122,33 @@ namespace MUSIC_INFO
     static TagLib::uint bufferSize() { return 1024; };
 
   private:
+    /*!
+     * Reads the start and the end of a read only file, where the tags are.
+     */
+    void ReadAhead();
+
+    /*!
+     * Reads \a length bytes at \a offset from the file.
+     */
+    TagLib::ByteVector ReadAt(int64_t offset, TagLib::ulong length);
+
+    /*!
+     * Serves a read at the current position from a block read ahead.
+     */
+    bool ReadCached(const TagLib::ByteVector &cache, int64_t offset, TagLib::ulong length, TagLib::ByteVector &block);
+
     std::string   m_strFileName;
     XFILE::CFile  m_file;
     bool          m_bIsReadOnly;
     bool          m_bIsOpen;
+
+    // read only files are read through the blocks read ahead, at a position of our own
+    bool                m_readAhead;
+    int64_t             m_length;
+    int64_t             m_position;
+    TagLib::ByteVector  m_head;
+    TagLib::ByteVector  m_tail;
+    int64_t             m_tailOffset;
   };
 }
 
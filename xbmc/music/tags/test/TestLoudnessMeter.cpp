@@ -0,0 +1,84 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "music/tags/LoudnessMeter.h"
+
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+const unsigned int SAMPLE_RATE = 48000;
+
+// stereo 1kHz sine with the given peak level in dBFS
+void AddSine(CLoudnessMeter& meter, double level, double seconds)
+{
+  const double amplitude = pow(10.0, level / 20.0);
+  const unsigned int frames = static_cast<unsigned int>(seconds * SAMPLE_RATE);
+  std::vector<float> data(frames * 2);
+  for (unsigned int i = 0; i < frames; i++)
+    data[i * 2] = data[i * 2 + 1] = static_cast<float>(amplitude * sin(2.0 * M_PI * 1000.0 * i / SAMPLE_RATE));
+  meter.AddFrames(data.data(), frames);
+}
+}
+
+TEST(TestLoudnessMeter, Sine)
+{
+  // EBU Tech 3341 case 1
+  CLoudnessMeter meter(SAMPLE_RATE, std::vector<double>(2, 1.0));
+  AddSine(meter, -23.0, 20.0);
+  EXPECT_NEAR(-23.0, meter.GetIntegratedLoudness(), 0.1);
+  EXPECT_NEAR(pow(10.0, -23.0 / 20.0), meter.GetPeak(), 0.001);
+}
+
+TEST(TestLoudnessMeter, RelativeGate)
+{
+  // EBU Tech 3341 case 3, the quiet parts are gated
+  CLoudnessMeter meter(SAMPLE_RATE, std::vector<double>(2, 1.0));
+  AddSine(meter, -36.0, 10.0);
+  AddSine(meter, -23.0, 60.0);
+  AddSine(meter, -36.0, 10.0);
+  EXPECT_NEAR(-23.0, meter.GetIntegratedLoudness(), 0.1);
+}
+
+TEST(TestLoudnessMeter, Silence)
+{
+  CLoudnessMeter meter(SAMPLE_RATE, std::vector<double>(2, 1.0));
+  std::vector<float> data(SAMPLE_RATE * 2, 0.0f);
+  meter.AddFrames(data.data(), SAMPLE_RATE);
+  EXPECT_FALSE(std::isfinite(meter.GetIntegratedLoudness()));
+  EXPECT_EQ(0.0f, meter.GetPeak());
+}
+
+TEST(TestLoudnessMeter, Album)
+{
+  CLoudnessMeter first(SAMPLE_RATE, std::vector<double>(2, 1.0));
+  CLoudnessMeter second(SAMPLE_RATE, std::vector<double>(2, 1.0));
+  AddSine(first, -20.0, 10.0);
+  AddSine(second, -26.0, 10.0);
+
+  std::vector<double> blocks(first.GetBlocks());
+  blocks.insert(blocks.end(), second.GetBlocks().begin(), second.GetBlocks().end());
+  double album = CLoudnessMeter::GetIntegratedLoudness(blocks);
+  EXPECT_LT(second.GetIntegratedLoudness(), album);
+  EXPECT_GT(first.GetIntegratedLoudness(), album);
+}
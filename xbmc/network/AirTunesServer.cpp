@@ -83,6 +83,8 @@ CCriticalSection CAirTunesServer::m_actionQueueLock;
 std::list<CAction> CAirTunesServer::m_actionQueue;
 CEvent CAirTunesServer::m_processActions;
 int CAirTunesServer::m_sampleRate = 44100;
+int64_t CAirTunesServer::m_maxBacklog = 0;
+bool CAirTunesServer::m_droppingBacklog = false;
 
 
 //parse daap metadata - thx to project MythTV
@@ -385,6 +387,8 @@ void* CAirTunesServer::AudioOutputFunctions::audio_init(void *cls, int bits, int
   item->SetMimeType("audio/x-xbmc-pcm");
   m_streamStarted = true;
   m_sampleRate = samplerate;
+  m_maxBacklog = (int64_t)samplerate * channels * (bits / 8) * g_advancedSettings.m_airTunesMaxLatency / 1000;
+  m_droppingBacklog = false;
 
   CApplicationMessenger::GetInstance().PostMsg(TMSG_MEDIA_PLAY, 0, 0, static_cast<void*>(item));
 
@@ -473,6 +477,18 @@ void  CAirTunesServer::AudioOutputFunctions::audio_set_volume(void *cls, void *s
 void  CAirTunesServer::AudioOutputFunctions::audio_process(void *cls, void *session, const void *buffer, int buflen)
 {
   XFILE::CPipeFile *pipe=(XFILE::CPipeFile *)cls;
+
+  // what queues up in the pipe, e.g. while the player is starting, would delay
+  // everything after it for the rest of the stream. RAOP buffers on its own already.
+  if (m_maxBacklog > 0 && pipe->GetAvailableRead() > m_maxBacklog)
+  {
+    if (!m_droppingBacklog)
+      CLog::Log(LOGDEBUG, "AIRTUNES: player is behind, dropping audio to keep the latency");
+    m_droppingBacklog = true;
+    return;
+  }
+  m_droppingBacklog = false;
+
   pipe->Write(buffer, buflen);
 }
 
@@ -89,6 +89,8 @@ private:
   static std::list<CAction> m_actionQueue;
   static CEvent m_processActions;
   static int m_sampleRate;
+  static int64_t m_maxBacklog;
+  static bool m_droppingBacklog;
 
   class AudioOutputFunctions
   {
@@ -20,6 +20,8 @@
 
 #include "DNSNameCache.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 
@@ -51,11 +53,64 @@ bool CDNSNameCache::Lookup(const std::string& strHostName, std::string& strIpAdd
   }
 
   // check if there's a custom entry or if it's already cached
-  if(g_DNSCache.GetCached(strHostName, strIpAddress))
+  switch (GetCached(strHostName, strIpAddress))
+  {
+  case CACHED:
+    return true;
+  case CACHED_STALE:
+    Refresh(strHostName);
+    return true;
+  case CACHED_FAILED:
+    return false;
+  case NOT_CACHED:
+    break;
+  }
+
+  if (Resolve(strHostName, strIpAddress))
+  {
+    Store(strHostName, strIpAddress, false);
     return true;
+  }
+
+  Store(strHostName, "", false);
+  CLog::Log(LOGERROR, "Unable to lookup host: '%s'", strHostName.c_str());
+  return false;
+}
+
+void CDNSNameCache::Prefetch(const std::string& strHostName)
+{
+  if (strHostName.empty() || inet_addr(strHostName.c_str()) != INADDR_NONE)
+    return;
+
+  std::string strIpAddress;
+  CacheState state = GetCached(strHostName, strIpAddress);
+  if (state == NOT_CACHED || state == CACHED_STALE)
+    Refresh(strHostName);
+}
+
+void CDNSNameCache::Refresh(const std::string& strHostName)
+{
+  {
+    CSingleLock lock(m_critical);
+    if (!g_DNSCache.m_pending.insert(strHostName).second)
+      return;
+  }
+
+  CJobManager::GetInstance().Submit([strHostName]() {
+    std::string strIpAddress;
+    if (!Resolve(strHostName, strIpAddress))
+      CLog::Log(LOGDEBUG, "CDNSNameCache: unable to resolve '%s' in the background", strHostName.c_str());
+    Store(strHostName, strIpAddress, false);
+
+    CSingleLock lock(m_critical);
+    g_DNSCache.m_pending.erase(strHostName);
+  });
+}
 
+bool CDNSNameCache::Resolve(const std::string& strHostName, std::string& strIpAddress)
+{
 #ifndef TARGET_WINDOWS
-  // perform netbios lookup (win32 is handling this via gethostbyname)
+  // perform netbios lookup (win32 is handling this via getaddrinfo)
   char nmb_ip[100];
   char line[200];
 
@@ -75,56 +130,78 @@ bool CDNSNameCache::Lookup(const std::string& strHostName, std::string& strIpAdd
   }
 
   if (!strIpAddress.empty())
-  {
-    g_DNSCache.Add(strHostName, strIpAddress);
     return true;
-  }
 #endif
 
-  // perform dns lookup
-  struct hostent *host = gethostbyname(strHostName.c_str());
-  if (host && host->h_addr_list[0])
+  // perform dns lookup, unlike gethostbyname this is safe to do from several
+  // threads at once
+  struct addrinfo hints = {};
+  struct addrinfo* results = nullptr;
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+
+  if (getaddrinfo(strHostName.c_str(), nullptr, &hints, &results) != 0)
+    return false;
+
+  if (results && results->ai_addr)
   {
-    strIpAddress = StringUtils::Format("%d.%d.%d.%d",
-                                       (unsigned char)host->h_addr_list[0][0],
-                                       (unsigned char)host->h_addr_list[0][1],
-                                       (unsigned char)host->h_addr_list[0][2],
-                                       (unsigned char)host->h_addr_list[0][3]);
-    g_DNSCache.Add(strHostName, strIpAddress);
-    return true;
+    const unsigned char* addr = reinterpret_cast<const unsigned char*>(
+      &reinterpret_cast<const struct sockaddr_in*>(results->ai_addr)->sin_addr);
+    strIpAddress = StringUtils::Format("%d.%d.%d.%d", addr[0], addr[1], addr[2], addr[3]);
   }
+  freeaddrinfo(results);
 
-  CLog::Log(LOGERROR, "Unable to lookup host: '%s'", strHostName.c_str());
-  return false;
+  return !strIpAddress.empty();
 }
 
-bool CDNSNameCache::GetCached(const std::string& strHostName, std::string& strIpAddress)
+CDNSNameCache::CacheState CDNSNameCache::GetCached(const std::string& strHostName, std::string& strIpAddress)
 {
   CSingleLock lock(m_critical);
 
-  // loop through all DNSname entries and see if strHostName is cached
-  for (int i = 0; i < (int)g_DNSCache.m_vecDNSNames.size(); ++i)
+  auto it = g_DNSCache.m_dnsNames.find(strHostName);
+  if (it == g_DNSCache.m_dnsNames.end())
+    return NOT_CACHED;
+
+  const CDNSName& DNSname = it->second;
+  if (DNSname.m_permanent)
   {
-    CDNSName& DNSname = g_DNSCache.m_vecDNSNames[i];
-    if ( DNSname.m_strHostName == strHostName )
-    {
-      strIpAddress = DNSname.m_strIpAddress;
-      return true;
-    }
+    strIpAddress = DNSname.m_strIpAddress;
+    return CACHED;
   }
 
-  // not cached
-  return false;
+  unsigned int age = XbmcThreads::SystemClockMillis() - DNSname.m_time;
+  if (DNSname.m_strIpAddress.empty())
+    return age < NEGATIVE_TTL ? CACHED_FAILED : NOT_CACHED;
+
+  if (age >= STALE_TTL)
+    return NOT_CACHED;
+
+  strIpAddress = DNSname.m_strIpAddress;
+  return age < TTL ? CACHED : CACHED_STALE;
 }
 
 void CDNSNameCache::Add(const std::string &strHostName, const std::string &strIpAddress)
 {
-  CDNSName dnsName;
+  Store(strHostName, strIpAddress, true);
+}
 
-  dnsName.m_strHostName = strHostName;
-  dnsName.m_strIpAddress  = strIpAddress;
+void CDNSNameCache::Store(const std::string& strHostName, const std::string& strIpAddress, bool permanent)
+{
+  unsigned int now = XbmcThreads::SystemClockMillis();
 
   CSingleLock lock(m_critical);
-  g_DNSCache.m_vecDNSNames.push_back(dnsName);
-}
+  CDNSName& dnsName = g_DNSCache.m_dnsNames[strHostName];
+
+  // custom entries always win, and a failed refresh keeps the address that
+  // is still usable
+  if (!permanent && dnsName.m_permanent)
+    return;
+  if (!permanent && strIpAddress.empty() && !dnsName.m_strIpAddress.empty() &&
+      now - dnsName.m_time < STALE_TTL)
+    return;
 
+  dnsName.m_strHostName = strHostName;
+  dnsName.m_strIpAddress = strIpAddress;
+  dnsName.m_time = now;
+  dnsName.m_permanent = permanent;
+}
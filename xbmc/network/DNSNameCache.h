@@ -20,11 +20,20 @@
  *
  */
 
-#include <vector>
+#include <map>
+#include <set>
 #include <string>
 
 class CCriticalSection;
 
+/*!
+ \brief Cache of resolved host names.
+
+ Resolved names are valid for TTL milliseconds. After that the cached address
+ is still returned for up to STALE_TTL and a refresh is done in the background,
+ so only the first lookup of a host blocks. Failed lookups are remembered for
+ NEGATIVE_TTL. Custom entries from advancedsettings.xml never expire.
+ */
 class CDNSNameCache
 {
 public:
@@ -32,15 +41,41 @@ public:
   {
   public:
     std::string m_strHostName;
-    std::string m_strIpAddress;
+    std::string m_strIpAddress; //!< empty if the lookup failed
+    unsigned int m_time = 0; //!< when the name was resolved
+    bool m_permanent = false;
   };
   CDNSNameCache(void);
   virtual ~CDNSNameCache(void);
   static bool Lookup(const std::string& strHostName, std::string& strIpAddress);
+  /*!
+   \brief Add a custom entry that never expires.
+   */
   static void Add(const std::string& strHostName, const std::string& strIpAddress);
+  /*!
+   \brief Resolve the host name in the background unless it is cached already,
+   a later Lookup() doesn't block on it.
+   */
+  static void Prefetch(const std::string& strHostName);
+
+  static const unsigned int TTL = 5 * 60 * 1000;
+  static const unsigned int STALE_TTL = 60 * 60 * 1000;
+  static const unsigned int NEGATIVE_TTL = 10 * 1000;
 
 protected:
-  static bool GetCached(const std::string& strHostName, std::string& strIpAddress);
+  enum CacheState
+  {
+    NOT_CACHED,
+    CACHED,
+    CACHED_STALE, //!< address is usable but should be refreshed
+    CACHED_FAILED
+  };
+
+  static CacheState GetCached(const std::string& strHostName, std::string& strIpAddress);
+  static bool Resolve(const std::string& strHostName, std::string& strIpAddress);
+  static void Store(const std::string& strHostName, const std::string& strIpAddress, bool permanent);
+  static void Refresh(const std::string& strHostName);
   static CCriticalSection m_critical;
-  std::vector<CDNSName> m_vecDNSNames;
+  std::map<std::string, CDNSName> m_dnsNames;
+  std::set<std::string> m_pending; //!< host names being resolved in the background
 };
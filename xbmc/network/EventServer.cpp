@@ -43,6 +43,9 @@ using namespace EVENTPACKET;
 using namespace EVENTCLIENT;
 using namespace SOCKETS;
 
+// packets read and handed to the clients at once, a gamepad sends many of them
+#define ES_MAX_BATCH_PACKETS 32
+
 /************************************************************************/
 /* CEventServer                                                         */
 /************************************************************************/
@@ -151,7 +154,8 @@ void CEventServer::Process()
 void CEventServer::Run()
 {
   CSocketListener listener;
-  int packetSize = 0;
+  CAddress addrs[ES_MAX_BATCH_PACKETS];
+  int packetSizes[ES_MAX_BATCH_PACKETS];
 
   CLog::Log(LOGNOTICE, "ES: Starting UDP Event server on port %d", m_iPort);
 
@@ -164,7 +168,7 @@ void CEventServer::Run()
     CLog::Log(LOGERROR, "ES: Could not create socket, aborting!");
     return;
   }
-  m_pPacketBuffer = (unsigned char *)malloc(PACKET_SIZE);
+  m_pPacketBuffer = (unsigned char *)malloc(PACKET_SIZE * ES_MAX_BATCH_PACKETS);
 
   if (!m_pPacketBuffer)
   {
@@ -205,11 +209,10 @@ void CEventServer::Run()
       // start listening until we timeout
       if (listener.Listen(m_iListenTimeout))
       {
-        CAddress addr;
-        if ((packetSize = m_pSocket->Read(addr, PACKET_SIZE, (void *)m_pPacketBuffer)) > -1)
-        {
-          ProcessPacket(addr, packetSize);
-        }
+        // everything that queued up since the last time, not just the first packet
+        int count = m_pSocket->ReadPending(addrs, packetSizes, PACKET_SIZE, m_pPacketBuffer, ES_MAX_BATCH_PACKETS);
+        if (count > 0)
+          ProcessPackets(addrs, packetSizes, count);
       }
     }
     catch (...)
@@ -233,55 +236,70 @@ void CEventServer::Run()
   Cleanup();
 }
 
-void CEventServer::ProcessPacket(CAddress& addr, int pSize)
+CEventPacket* CEventServer::ParsePacket(const unsigned char* buffer, int pSize)
 {
   // check packet validity
-  CEventPacket* packet = new CEventPacket(pSize, m_pPacketBuffer);
+  CEventPacket* packet = new CEventPacket(pSize, buffer);
   if(packet == NULL)
   {
     CLog::Log(LOGERROR, "ES: Out of memory, cannot accept packet");
-    return;
+    return NULL;
   }
 
-  unsigned int clientToken;
-
   if (!packet->IsValid())
   {
     CLog::Log(LOGDEBUG, "ES: Received invalid packet");
     delete packet;
-    return;
+    return NULL;
   }
 
-  clientToken = packet->ClientToken();
-  if (!clientToken)
-    clientToken = addr.ULong(); // use IP if packet doesn't have a token
+  return packet;
+}
 
-  CSingleLock lock(m_critSection);
+void CEventServer::ProcessPackets(CAddress* addrs, const int* packetSizes, int count)
+{
+  // parse them before taking the lock the GUI thread waits for in GetButtonCode()
+  CEventPacket* packets[ES_MAX_BATCH_PACKETS];
+  for (int i = 0; i < count; i++)
+    packets[i] = ParsePacket(m_pPacketBuffer + i * PACKET_SIZE, packetSizes[i]);
 
-  // first check if we have a client for this address
-  std::map<unsigned long, CEventClient*>::iterator iter = m_clients.find(clientToken);
+  CSingleLock lock(m_critSection);
 
-  if ( iter == m_clients.end() )
+  for (int i = 0; i < count; i++)
   {
-    if ( m_clients.size() >= (unsigned int)m_iMaxClients)
-    {
-      CLog::Log(LOGWARNING, "ES: Cannot accept any more clients, maximum client count reached");
-      delete packet;
-      return;
-    }
+    CEventPacket* packet = packets[i];
+    if (!packet)
+      continue;
+
+    unsigned int clientToken = packet->ClientToken();
+    if (!clientToken)
+      clientToken = addrs[i].ULong(); // use IP if packet doesn't have a token
+
+    // first check if we have a client for this address
+    std::map<unsigned long, CEventClient*>::iterator iter = m_clients.find(clientToken);
 
-    // new client
-    CEventClient* client = new CEventClient ( addr );
-    if (client==NULL)
+    if ( iter == m_clients.end() )
     {
-      CLog::Log(LOGERROR, "ES: Out of memory, cannot accept new client connection");
-      delete packet;
-      return;
-    }
+      if ( m_clients.size() >= (unsigned int)m_iMaxClients)
+      {
+        CLog::Log(LOGWARNING, "ES: Cannot accept any more clients, maximum client count reached");
+        delete packet;
+        continue;
+      }
 
-    m_clients[clientToken] = client;
+      // new client
+      CEventClient* client = new CEventClient ( addrs[i] );
+      if (client==NULL)
+      {
+        CLog::Log(LOGERROR, "ES: Out of memory, cannot accept new client connection");
+        delete packet;
+        continue;
+      }
+
+      iter = m_clients.insert(std::make_pair(clientToken, client)).first;
+    }
+    iter->second->AddPacket(packet);
   }
-  m_clients[clientToken]->AddPacket(packet);
 }
 
 void CEventServer::RefreshClients()
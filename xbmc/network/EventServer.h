@@ -72,7 +72,8 @@ namespace EVENTSERVER
     CEventServer();
     void Cleanup();
     void Run();
-    void ProcessPacket(SOCKETS::CAddress& addr, int packetSize);
+    void ProcessPackets(SOCKETS::CAddress* addrs, const int* packetSizes, int count);
+    EVENTPACKET::CEventPacket* ParsePacket(const unsigned char* buffer, int packetSize);
     void ProcessEvents();
     void RefreshClients();
 
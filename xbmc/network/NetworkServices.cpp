@@ -65,7 +65,9 @@
 #include "network/httprequesthandler/HTTPImageHandler.h"
 #include "network/httprequesthandler/HTTPImageTransformationHandler.h"
 #include "network/httprequesthandler/HTTPVfsHandler.h"
+#include "network/httprequesthandler/HTTPHlsHandler.h"
 #include "network/httprequesthandler/HTTPJsonRpcHandler.h"
+#include "network/httprequesthandler/HTTPMetricsHandler.h"
 #ifdef HAS_WEB_INTERFACE
 #ifdef HAS_PYTHON
 #include "network/httprequesthandler/HTTPPythonHandler.h"
@@ -95,7 +97,9 @@ CNetworkServices::CNetworkServices(CSettings &settings)
   m_httpImageHandler(*new CHTTPImageHandler),
   m_httpImageTransformationHandler(*new CHTTPImageTransformationHandler),
   m_httpVfsHandler(*new CHTTPVfsHandler),
-  m_httpJsonRpcHandler(*new CHTTPJsonRpcHandler)
+  m_httpHlsHandler(*new CHTTPHlsHandler),
+  m_httpJsonRpcHandler(*new CHTTPJsonRpcHandler),
+  m_httpMetricsHandler(*new CHTTPMetricsHandler)
 #ifdef HAS_WEB_INTERFACE
 #ifdef HAS_PYTHON
   , m_httpPythonHandler(*new CHTTPPythonHandler)
@@ -109,7 +113,9 @@ CNetworkServices::CNetworkServices(CSettings &settings)
   m_webserver.RegisterRequestHandler(&m_httpImageHandler);
   m_webserver.RegisterRequestHandler(&m_httpImageTransformationHandler);
   m_webserver.RegisterRequestHandler(&m_httpVfsHandler);
+  m_webserver.RegisterRequestHandler(&m_httpHlsHandler);
   m_webserver.RegisterRequestHandler(&m_httpJsonRpcHandler);
+  m_webserver.RegisterRequestHandler(&m_httpMetricsHandler);
 #ifdef HAS_WEB_INTERFACE
 #ifdef HAS_PYTHON
   m_webserver.RegisterRequestHandler(&m_httpPythonHandler);
@@ -158,8 +164,12 @@ CNetworkServices::~CNetworkServices()
   delete &m_httpImageTransformationHandler;
   m_webserver.UnregisterRequestHandler(&m_httpVfsHandler);
   delete &m_httpVfsHandler;
+  m_webserver.UnregisterRequestHandler(&m_httpHlsHandler);
+  delete &m_httpHlsHandler;
   m_webserver.UnregisterRequestHandler(&m_httpJsonRpcHandler);
   delete &m_httpJsonRpcHandler;
+  m_webserver.UnregisterRequestHandler(&m_httpMetricsHandler);
+  delete &m_httpMetricsHandler;
   CJSONRPC::Cleanup();
 #ifdef HAS_WEB_INTERFACE
 #ifdef HAS_PYTHON
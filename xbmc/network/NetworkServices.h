@@ -27,7 +27,9 @@ class CWebServer;
 class CHTTPImageHandler;
 class CHTTPImageTransformationHandler;
 class CHTTPVfsHandler;
+class CHTTPHlsHandler;
 class CHTTPJsonRpcHandler;
+class CHTTPMetricsHandler;
 #ifdef HAS_WEB_INTERFACE
 #ifdef HAS_PYTHON
 class CHTTPPythonHandler;
@@ -109,7 +111,9 @@ private:
   CHTTPImageHandler& m_httpImageHandler;
   CHTTPImageTransformationHandler& m_httpImageTransformationHandler;
   CHTTPVfsHandler& m_httpVfsHandler;
+  CHTTPHlsHandler& m_httpHlsHandler;
   CHTTPJsonRpcHandler& m_httpJsonRpcHandler;
+  CHTTPMetricsHandler& m_httpMetricsHandler;
 #ifdef HAS_WEB_INTERFACE
 #ifdef HAS_PYTHON
   CHTTPPythonHandler& m_httpPythonHandler;
@@ -187,6 +187,54 @@ int CPosixUDPSocket::Read(CAddress& addr, const int buffersize, void *buffer)
                        (struct sockaddr*)&addr.saddr, &addr.size);
 }
 
+int CPosixUDPSocket::ReadPending(CAddress* addrs, int* sizes, const int buffersize,
+                                 unsigned char* buffers, const int count)
+{
+#if defined(TARGET_LINUX) && !defined(TARGET_ANDROID)
+  // all of them with one call
+  std::vector<struct mmsghdr> messages(count);
+  std::vector<struct iovec> vectors(count);
+  for (int i = 0; i < count; i++)
+  {
+    vectors[i].iov_base = buffers + i * buffersize;
+    vectors[i].iov_len = buffersize;
+    memset(&messages[i], 0, sizeof(messages[i]));
+    messages[i].msg_hdr.msg_name = &addrs[i].saddr;
+    messages[i].msg_hdr.msg_namelen = sizeof(addrs[i].saddr);
+    messages[i].msg_hdr.msg_iov = &vectors[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  int received = recvmmsg(m_iSock, messages.data(), count, MSG_DONTWAIT, NULL);
+  if (received < 0)
+    return 0;
+
+  for (int i = 0; i < received; i++)
+  {
+    addrs[i].size = messages[i].msg_hdr.msg_namelen;
+    sizes[i] = (int)messages[i].msg_len;
+  }
+  return received;
+#else
+  int received = 0;
+  while (received < count)
+  {
+    fd_set set;
+    FD_ZERO(&set);
+    FD_SET(m_iSock, &set);
+    struct timeval tv = { 0, 0 };
+    if (select(m_iSock + 1, &set, NULL, NULL, &tv) <= 0)
+      break;
+
+    sizes[received] = Read(addrs[received], buffersize, buffers + received * buffersize);
+    if (sizes[received] < 0)
+      break;
+    received++;
+  }
+  return received;
+#endif
+}
+
 int CPosixUDPSocket::SendTo(const CAddress& addr, const int buffersize,
                           const void *buffer)
 {
@@ -184,6 +184,12 @@ namespace SOCKETS
 
     // read datagrams, return no. of bytes read or -1 or error
     virtual int Read(CAddress& addr, const int buffersize, void *buffer) = 0;
+
+    // read the datagrams that are waiting already, up to count of them, without
+    // blocking. datagram i goes to buffers + i * buffersize, its size to sizes[i].
+    // returns no. of datagrams read
+    virtual int ReadPending(CAddress* addrs, int* sizes, const int buffersize,
+                            unsigned char* buffers, const int count) = 0;
     virtual bool Broadcast(const CAddress& addr, const int datasize,
                            const void* data) = 0;
   };
@@ -207,6 +213,8 @@ namespace SOCKETS
     bool Listen(int timeout);
     int SendTo(const CAddress& addr, const int datasize, const void* data) override;
     int Read(CAddress& addr, const int buffersize, void *buffer) override;
+    int ReadPending(CAddress* addrs, int* sizes, const int buffersize,
+                    unsigned char* buffers, const int count) override;
     bool Broadcast(const CAddress& addr, const int datasize, const void* data) override
     {
       //! @todo implement
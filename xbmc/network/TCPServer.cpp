@@ -25,11 +25,22 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+#define TCPSERVER_USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
+#if defined(TARGET_POSIX)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include "settings/AdvancedSettings.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/AnnouncementManager.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
+#include "threads/Event.h"
 #include "threads/SingleLock.h"
 #include "websocket/WebSocketManager.h"
 #include "Network.h"
@@ -62,8 +73,48 @@ using namespace ANNOUNCEMENT;
 
 #define RECEIVEBUFFER 1024
 
+// number of requests of different clients that are executed at the same time
+#define METHOD_WORKERS 4
+
+// a client that doesn't read its responses and announcements is disconnected
+#define MAX_SEND_BUFFER (16 * 1024 * 1024)
+#define MAX_ANNOUNCEMENT_BACKLOG (1024 * 1024)  // announcements are dropped while more is waiting to be sent
+
+#define MIN_DEFLATE_SIZE 64                    // smaller websocket messages aren't worth compressing
+#define MAX_FRAME_BUFFER (256 * 1024)
+
+#define POLL_TIMEOUT_MS 1000
+
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
+/* Shared with the jobs of the method workers, which may still be queued when the server is gone */
+struct CTCPServer::CResponders
+{
+  CCriticalSection section;
+  CEvent finished;
+  unsigned int running = 0;
+  bool stopped = false;
+};
+
+static bool WouldBlock()
+{
+#if defined(TARGET_WINDOWS)
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+static void SetNonBlocking(SOCKET socket)
+{
+#if defined(TARGET_WINDOWS)
+  u_long nonBlocking = 1;
+  ioctlsocket(socket, FIONBIO, &nonBlocking);
+#else
+  fcntl(socket, F_SETFL, fcntl(socket, F_GETFL) | O_NONBLOCK);
+#endif
+}
+
 bool CTCPServer::StartServer(int port, bool nonlocal)
 {
   StopServer(true);
@@ -112,123 +163,288 @@ bool CTCPServer::IsRunning()
   return ((CThread*)ServerInstance)->IsRunning();
 }
 
-CTCPServer::CTCPServer(int port, bool nonlocal) : CThread("TCPServer")
+CTCPServer::CTCPServer(int port, bool nonlocal) : CThread("TCPServer"),
+  m_methodQueue(false, METHOD_WORKERS, CJob::PRIORITY_NORMAL),
+  m_responders(std::make_shared<CResponders>())
 {
   m_port = port;
   m_nonlocal = nonlocal;
   m_sdpd = NULL;
+  m_pollfd = -1;
+  m_wakeup[0] = m_wakeup[1] = -1;
 }
 
 void CTCPServer::Process()
 {
   m_bStop = false;
 
+  std::vector<SocketEvent> events;
   while (!m_bStop)
   {
-    SOCKET          max_fd = 0;
-    fd_set          rfds;
-    struct timeval  to     = {1, 0};
-    FD_ZERO(&rfds);
+    if (!WaitForEvents(events, POLL_TIMEOUT_MS))
+    {
+      CLog::Log(LOGERROR, "JSONRPC Server: Waiting for sockets failed");
+      Sleep(1000);
+      Initialize();
+      continue;
+    }
 
-    for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
+    for (const SocketEvent &event : events)
     {
-      FD_SET(*it, &rfds);
-      if ((intptr_t)*it > (intptr_t)max_fd)
-        max_fd = *it;
+      if (std::find(m_servers.begin(), m_servers.end(), event.socket) != m_servers.end())
+      {
+        AcceptConnection(event.socket);
+        continue;
+      }
+
+      CTCPClientPtr client = GetConnection(event.socket);
+      if (client == nullptr)
+        continue;
+
+      if (event.writable)
+        client->Flush();
+
+      bool close = client->Closing();
+      if (!close && event.readable)
+        close = !Receive(client);
+
+      if (close)
+        CloseConnection(client);
     }
+  }
+
+  Deinitialize();
+}
+
+bool CTCPServer::WaitForEvents(std::vector<SocketEvent> &events, int timeoutMs)
+{
+  events.clear();
+
+#ifdef TCPSERVER_USE_EPOLL
+  // only wait for writability while there is something to write
+  for (const CTCPClientPtr &client : m_connections)
+  {
+    bool pending = client->HasPendingData();
+    if (pending == client->m_pollingWrite)
+      continue;
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN | (pending ? EPOLLOUT : 0);
+    ev.data.fd = client->m_socket;
+    epoll_ctl(m_pollfd, EPOLL_CTL_MOD, client->m_socket, &ev);
+    client->m_pollingWrite = pending;
+  }
 
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+  struct epoll_event ready[64];
+  int res = epoll_wait(m_pollfd, ready, sizeof(ready) / sizeof(ready[0]), timeoutMs);
+  if (res < 0)
+    return errno == EINTR;
+
+  for (int i = 0; i < res; i++)
+  {
+    if (ready[i].data.fd == m_wakeup[0])
     {
-      FD_SET(m_connections[i]->m_socket, &rfds);
-      if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
-        max_fd = m_connections[i]->m_socket;
+      char buffer[64];
+      while (read(m_wakeup[0], buffer, sizeof(buffer)) > 0);
+      continue;
     }
 
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
-    if (res < 0)
+    // errors and hangups are noticed by the following recv()
+    SocketEvent event;
+    event.socket = ready[i].data.fd;
+    event.readable = (ready[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0;
+    event.writable = (ready[i].events & EPOLLOUT) != 0;
+    events.push_back(event);
+  }
+  return true;
+#else
+  SOCKET max_fd = 0;
+  fd_set rfds, wfds;
+  struct timeval to = {timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+
+  for (SOCKET server : m_servers)
+  {
+    FD_SET(server, &rfds);
+    if ((intptr_t)server > (intptr_t)max_fd)
+      max_fd = server;
+  }
+
+  for (const CTCPClientPtr &client : m_connections)
+  {
+    FD_SET(client->m_socket, &rfds);
+    if (client->HasPendingData())
+      FD_SET(client->m_socket, &wfds);
+    if ((intptr_t)client->m_socket > (intptr_t)max_fd)
+      max_fd = client->m_socket;
+  }
+
+#if defined(TARGET_POSIX)
+  if (m_wakeup[0] >= 0)
+  {
+    FD_SET(m_wakeup[0], &rfds);
+    if ((intptr_t)m_wakeup[0] > (intptr_t)max_fd)
+      max_fd = m_wakeup[0];
+  }
+#endif
+
+  int res = select((intptr_t)max_fd+1, &rfds, &wfds, NULL, &to);
+  if (res < 0)
+    return false;
+  if (res == 0)
+    return true;
+
+#if defined(TARGET_POSIX)
+  if (m_wakeup[0] >= 0 && FD_ISSET(m_wakeup[0], &rfds))
+  {
+    char buffer[64];
+    while (read(m_wakeup[0], buffer, sizeof(buffer)) > 0);
+  }
+#endif
+
+  for (SOCKET server : m_servers)
+  {
+    if (FD_ISSET(server, &rfds))
+      events.push_back(SocketEvent{server, true, false});
+  }
+
+  for (const CTCPClientPtr &client : m_connections)
+  {
+    bool readable = FD_ISSET(client->m_socket, &rfds) != 0;
+    bool writable = FD_ISSET(client->m_socket, &wfds) != 0;
+    if (readable || writable)
+      events.push_back(SocketEvent{client->m_socket, readable, writable});
+  }
+  return true;
+#endif
+}
+
+void CTCPServer::WakeUp()
+{
+#if defined(TARGET_POSIX)
+  if (m_wakeup[1] >= 0)
+  {
+    char c = 0;
+    if (write(m_wakeup[1], &c, 1) < 0)
+      CLog::Log(LOGDEBUG, "JSONRPC Server: Failed to wake up the server thread");
+  }
+#endif
+}
+
+void CTCPServer::AcceptConnection(SOCKET server)
+{
+  CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
+  CTCPClientPtr newconnection = std::make_shared<CTCPClient>();
+  newconnection->m_socket = accept(server, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
+
+  if (newconnection->m_socket == INVALID_SOCKET)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
+    if (EBADF == errno)
     {
-      CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
       Sleep(1000);
       Initialize();
     }
-    else if (res > 0)
-    {
-      for (int i = m_connections.size() - 1; i >= 0; i--)
-      {
-        int socket = m_connections[i]->m_socket;
-        if (FD_ISSET(socket, &rfds))
-        {
-          char buffer[RECEIVEBUFFER] = {};
-          int  nread = 0;
-          nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
-          bool close = false;
-          if (nread > 0)
-          {
-            std::string response;
-            if (m_connections[i]->IsNew())
-            {
-              CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
-
-              if (!response.empty())
-                m_connections[i]->Send(response.c_str(), response.size());
-
-              if (websocket != NULL)
-              {
-                // Replace the CTCPClient with a CWebSocketClient
-                CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[i]));
-                delete m_connections[i];
-                m_connections.erase(m_connections.begin() + i);
-                m_connections.insert(m_connections.begin() + i, websocketClient);
-              }
-            }
-
-            if (response.size() <= 0)
-              m_connections[i]->PushBuffer(this, buffer, nread);
-
-            close = m_connections[i]->Closing();
-          }
-          else
-            close = true;
-
-          if (close)
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i]->Disconnect();
-            delete m_connections[i];
-            m_connections.erase(m_connections.begin() + i);
-          }
-        }
-      }
+    return;
+  }
 
-      for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
-      {
-        if (FD_ISSET(*it, &rfds))
-        {
-          CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
-          CTCPClient *newconnection = new CTCPClient();
-          newconnection->m_socket = accept(*it, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
-
-          if (newconnection->m_socket == INVALID_SOCKET)
-          {
-            CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
-            if (EBADF == errno)
-            {
-              Sleep(1000);
-              Initialize();
-              break;
-            }
-          }
-          else
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
-            m_connections.push_back(newconnection);
-          }
-        }
-      }
+  SetNonBlocking(newconnection->m_socket);
+  newconnection->m_host = this;
+
+#ifdef TCPSERVER_USE_EPOLL
+  struct epoll_event ev = {};
+  ev.events = EPOLLIN;
+  ev.data.fd = newconnection->m_socket;
+  if (epoll_ctl(m_pollfd, EPOLL_CTL_ADD, newconnection->m_socket, &ev) < 0)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to watch new connection: %d", errno);
+    newconnection->Disconnect();
+    return;
+  }
+#endif
+
+  CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
+  CSingleLock lock(m_connectionsSection);
+  m_connections.push_back(newconnection);
+}
+
+bool CTCPServer::Receive(CTCPClientPtr &client)
+{
+  char buffer[RECEIVEBUFFER] = {};
+  int nread = recv(client->m_socket, (char*)&buffer, RECEIVEBUFFER, 0);
+  if (nread < 0 && WouldBlock())
+    return true;
+  if (nread <= 0)
+    return false;
+
+  std::string response;
+  if (client->IsNew())
+  {
+    CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
+
+    if (!response.empty())
+      client->Send(response.c_str(), response.size());
+
+    if (websocket != NULL)
+    {
+      // Replace the CTCPClient with a CWebSocketClient
+      CTCPClientPtr websocketClient = std::make_shared<CWebSocketClient>(websocket, *client);
+      CSingleLock lock(m_connectionsSection);
+      std::replace(m_connections.begin(), m_connections.end(), client, websocketClient);
+      client = websocketClient;
     }
   }
 
-  Deinitialize();
+  if (response.size() <= 0)
+    client->PushBuffer(this, buffer, nread);
+
+  return !client->Closing();
+}
+
+void CTCPServer::CloseConnection(const CTCPClientPtr &client)
+{
+  CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
+
+#ifdef TCPSERVER_USE_EPOLL
+  epoll_ctl(m_pollfd, EPOLL_CTL_DEL, client->m_socket, NULL);
+#endif
+
+  client->Disconnect();
+
+  // a method worker that is still responding to the client keeps it until it is done
+  CSingleLock lock(m_connectionsSection);
+  m_connections.erase(std::remove(m_connections.begin(), m_connections.end(), client), m_connections.end());
+}
+
+CTCPServer::CTCPClientPtr CTCPServer::GetConnection(SOCKET socket) const
+{
+  for (const CTCPClientPtr &client : m_connections)
+  {
+    if (client->m_socket == socket)
+      return client;
+  }
+  return nullptr;
+}
+
+void CTCPServer::QueueRequest(const CTCPClientPtr &client)
+{
+  std::shared_ptr<CResponders> responders = m_responders;
+  m_methodQueue.Submit([this, client, responders]()
+  {
+    {
+      CSingleLock lock(responders->section);
+      if (responders->stopped)
+        return;
+      responders->running++;
+    }
+
+    client->ProcessRequests(this);
+
+    CSingleLock lock(responders->section);
+    responders->running--;
+    responders->finished.Set();
+  });
 }
 
 bool CTCPServer::PrepareDownload(const char *path, CVariant &details, std::string &protocol)
@@ -250,15 +466,14 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
 {
   std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
 
-  for (unsigned int i = 0; i < m_connections.size(); i++)
+  // sending doesn't block, a slow client or method doesn't hold up the others
+  CSingleLock lock(m_connectionsSection);
+  for (const CTCPClientPtr &client : m_connections)
   {
-    {
-      CSingleLock lock (m_connections[i]->m_critSection);
-      if ((m_connections[i]->GetAnnouncementFlags() & flag) == 0)
-        continue;
-    }
+    if ((client->GetAnnouncementFlags() & flag) == 0)
+      continue;
 
-    m_connections[i]->Send(str.c_str(), str.size());
+    client->Announce(str);
   }
 }
 
@@ -271,8 +486,15 @@ bool CTCPServer::Initialize()
   started |= InitializeBlue();
   started |= InitializeTCP();
 
+  if (started && !InitializePoll())
+  {
+    Deinitialize();
+    started = false;
+  }
+
   if (started)
   {
+    m_responders = std::make_shared<CResponders>();
     CAnnouncementManager::GetInstance().AddAnnouncer(this);
     CLog::Log(LOGINFO, "JSONRPC Server: Successfully initialized");
     return true;
@@ -484,21 +706,90 @@ bool CTCPServer::InitializeTCP()
   return true;
 }
 
+bool CTCPServer::InitializePoll()
+{
+#if defined(TARGET_POSIX)
+  if (pipe(m_wakeup) < 0)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to create wake up pipe");
+    m_wakeup[0] = m_wakeup[1] = -1;
+    return false;
+  }
+  fcntl(m_wakeup[0], F_SETFL, fcntl(m_wakeup[0], F_GETFL) | O_NONBLOCK);
+  fcntl(m_wakeup[1], F_SETFL, fcntl(m_wakeup[1], F_GETFL) | O_NONBLOCK);
+#endif
+
+#ifdef TCPSERVER_USE_EPOLL
+  m_pollfd = epoll_create1(EPOLL_CLOEXEC);
+  if (m_pollfd < 0)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to create epoll instance: %d", errno);
+    return false;
+  }
+
+  std::vector<int> fds(m_servers.begin(), m_servers.end());
+  fds.push_back(m_wakeup[0]);
+  for (int fd : fds)
+  {
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(m_pollfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+    {
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to watch socket: %d", errno);
+      return false;
+    }
+  }
+#endif
+
+  return true;
+}
+
 void CTCPServer::Deinitialize()
 {
-  for (unsigned int i = 0; i < m_connections.size(); i++)
+  // let the method workers finish, they use the connections and the server
+  {
+    CSingleLock lock(m_responders->section);
+    m_responders->stopped = true;
+  }
+  m_methodQueue.CancelJobs();
   {
-    m_connections[i]->Disconnect();
-    delete m_connections[i];
+    CSingleLock lock(m_responders->section);
+    while (m_responders->running > 0)
+    {
+      CSingleExit exit(m_responders->section);
+      m_responders->finished.WaitMSec(100);
+    }
   }
 
-  m_connections.clear();
+  {
+    CSingleLock lock(m_connectionsSection);
+    for (const CTCPClientPtr &client : m_connections)
+      client->Disconnect();
+
+    m_connections.clear();
+  }
 
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
 
   m_servers.clear();
 
+#ifdef TCPSERVER_USE_EPOLL
+  if (m_pollfd >= 0)
+    close(m_pollfd);
+  m_pollfd = -1;
+#endif
+
+#if defined(TARGET_POSIX)
+  for (int &fd : m_wakeup)
+  {
+    if (fd >= 0)
+      close(fd);
+    fd = -1;
+  }
+#endif
+
 #ifdef HAVE_LIBBLUETOOTH
   if (m_sdpd)
     sdp_close((sdp_session_t*)m_sdpd);
@@ -517,6 +808,12 @@ CTCPServer::CTCPClient::CTCPClient()
   m_endBrackets = 0;
   m_beginChar = 0;
   m_endChar = 0;
+  m_host = NULL;
+  m_pollingWrite = false;
+  m_sendFailed = false;
+  m_inResponse = false;
+  m_droppingAnnouncements = false;
+  m_responding = false;
 
   m_addrlen = sizeof(m_cliaddr);
 }
@@ -548,14 +845,144 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
   return true;
 }
 
+bool CTCPServer::CTCPClient::Closing() const
+{
+  return m_sendFailed;
+}
+
+int CTCPServer::CTCPClient::SendSome(const char *data, size_t size)
+{
+  int sent = send(m_socket, data, size, 0);
+  if (sent < 0 && WouldBlock())
+    return 0;
+
+  return sent;
+}
+
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
+  CSingleLock lock (m_critSection);
+  if (m_socket == INVALID_SOCKET || m_sendFailed)
+    return;
+
+  // keep the order, nothing goes out before what is still waiting
   unsigned int sent = 0;
-  do
+  if (m_sendBuffer.empty())
   {
+    int res = SendSome(data, size);
+    if (res < 0)
+    {
+      m_sendFailed = true;
+      return;
+    }
+    sent = res;
+  }
+
+  if (sent == size)
+    return;
+
+  if (m_sendBuffer.size() + size - sent > MAX_SEND_BUFFER)
+  {
+    CLog::Log(LOGWARNING, "JSONRPC Server: Client doesn't read what is sent, disconnecting");
+    m_sendBuffer.clear();
+    m_sendFailed = true;
+  }
+  else
+    m_sendBuffer.append(data + sent, size - sent);
+
+  // have the server thread wait until the socket takes more
+  if (m_host != NULL)
+    m_host->WakeUp();
+}
+
+void CTCPServer::CTCPClient::Flush()
+{
+  CSingleLock lock (m_critSection);
+  if (m_socket == INVALID_SOCKET || m_sendBuffer.empty())
+    return;
+
+  int res = SendSome(m_sendBuffer.c_str(), m_sendBuffer.size());
+  if (res < 0)
+  {
+    m_sendBuffer.clear();
+    m_sendFailed = true;
+  }
+  else
+    m_sendBuffer.erase(0, res);
+}
+
+bool CTCPServer::CTCPClient::HasPendingData()
+{
+  CSingleLock lock (m_critSection);
+  return !m_sendBuffer.empty();
+}
+
+void CTCPServer::CTCPClient::Announce(const std::string &announcement)
+{
+  CSingleLock lock (m_critSection);
+
+  // announcements are dropped rather than kept for a client that doesn't read them,
+  // responses aren't, the client would wait for them forever
+  size_t backlog = m_sendBuffer.size();
+  for (const std::string &waiting : m_announcements)
+    backlog += waiting.size();
+  if (backlog > MAX_ANNOUNCEMENT_BACKLOG)
+  {
+    if (!m_droppingAnnouncements)
+      CLog::Log(LOGDEBUG, "JSONRPC Server: Client doesn't keep up, dropping announcements");
+    m_droppingAnnouncements = true;
+    return;
+  }
+  m_droppingAnnouncements = false;
+
+  if (m_inResponse)
+    m_announcements.push_back(announcement);
+  else
+    Send(announcement.c_str(), announcement.size());
+}
+
+bool CTCPServer::CTCPClient::AddRequest(const std::string &request)
+{
+  CSingleLock lock (m_requestSection);
+  m_requests.push_back(request);
+  if (m_responding)
+    return false;
+
+  m_responding = true;
+  return true;
+}
+
+void CTCPServer::CTCPClient::ProcessRequests(CTCPServer *host)
+{
+  while (true)
+  {
+    std::string request;
+    {
+      CSingleLock lock (m_requestSection);
+      if (m_requests.empty())
+      {
+        m_responding = false;
+        return;
+      }
+      request.swap(m_requests.front());
+      m_requests.pop_front();
+    }
+
+    // no announcement gets in between the pieces of the response, they follow it
+    {
+      CSingleLock lock (m_critSection);
+      m_inResponse = true;
+    }
+
+    Respond(host, request);
+
     CSingleLock lock (m_critSection);
-    sent += send(m_socket, data + sent, size - sent, 0);
-  } while (sent < size);
+    m_inResponse = false;
+    std::vector<std::string> announcements;
+    announcements.swap(m_announcements);
+    for (const std::string &announcement : announcements)
+      Send(announcement.c_str(), announcement.size());
+  }
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -586,8 +1013,8 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        if (AddRequest(m_buffer))
+          host->QueueRequest(shared_from_this());
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -595,6 +1022,15 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
   }
 }
 
+void CTCPServer::CTCPClient::Respond(CTCPServer *host, const std::string &request)
+{
+  CJSONRPC::MethodCall(request, host, this, [this](const char *data, size_t size)
+  {
+    Send(data, size);
+    return true;
+  });
+}
+
 void CTCPServer::CTCPClient::Disconnect()
 {
   if (m_socket > 0)
@@ -618,6 +1054,15 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_host              = client.m_host;
+  m_pollingWrite      = client.m_pollingWrite;
+  m_sendBuffer        = client.m_sendBuffer;
+  m_sendFailed        = client.m_sendFailed;
+  m_inResponse        = client.m_inResponse;
+  m_announcements     = client.m_announcements;
+  m_droppingAnnouncements = client.m_droppingAnnouncements;
+  m_requests          = client.m_requests;
+  m_responding        = client.m_responding;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
@@ -653,13 +1098,36 @@ CTCPServer::CWebSocketClient& CTCPServer::CWebSocketClient::operator=(const CWeb
 
 void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
 {
-  const CWebSocketMessage *msg = m_websocket->Send(WebSocketTextFrame, data, size);
-  if (msg == NULL || !msg->IsComplete())
-    return;
+  // compressing and sending have to happen in the same order
+  CSingleLock lock (m_critSection);
+
+  // the payload goes behind room for the longest header, the header is
+  // written right in front of it once its length is known
+  m_frame.resize(CWebSocketFrame::MaxHeaderLength);
+  int8_t extension = WebSocketExtensionNone;
+  if (m_websocket->IsCompressing() && size >= MIN_DEFLATE_SIZE && m_websocket->Deflate(data, size, m_frame))
+    extension = WebSocketExtensionCompressed;
+  else
+    m_frame.append(data, size);
 
-  std::vector<const CWebSocketFrame *> frames = msg->GetFrames();
-  for (unsigned int index = 0; index < frames.size(); index++)
-    CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
+  char header[CWebSocketFrame::MaxHeaderLength];
+  size_t payloadLength = m_frame.size() - CWebSocketFrame::MaxHeaderLength;
+  size_t headerLength = CWebSocketFrame::WriteHeader(header, WebSocketTextFrame, payloadLength, true, false, 0, extension);
+  size_t offset = CWebSocketFrame::MaxHeaderLength - headerLength;
+  memcpy(&m_frame[offset], header, headerLength);
+
+  CTCPClient::Send(m_frame.c_str() + offset, (unsigned int)(m_frame.size() - offset));
+
+  // don't hold on to the memory of a large response
+  if (m_frame.capacity() > MAX_FRAME_BUFFER)
+    std::string().swap(m_frame);
+}
+
+void CTCPServer::CWebSocketClient::Respond(CTCPServer *host, const std::string &request)
+{
+  // a response has to go out as one message
+  std::string response = CJSONRPC::MethodCall(request, host, this);
+  Send(response.c_str(), response.size());
 }
 
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -674,8 +1142,20 @@ void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buff
       std::vector<const CWebSocketFrame *> frames = msg->GetFrames();
       if (send)
       {
+        // complete frames already, not payload for a text frame
         for (unsigned int index = 0; index < frames.size(); index++)
-          Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
+          CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
+      }
+      else if (!frames.empty() && (frames.front()->GetExtension() & WebSocketExtensionCompressed) != 0)
+      {
+        std::string compressed, request;
+        for (unsigned int index = 0; index < frames.size(); index++)
+          compressed.append(frames.at(index)->GetApplicationData(), (size_t)frames.at(index)->GetLength());
+
+        if (m_websocket->Inflate(compressed.c_str(), compressed.size(), request))
+          CTCPClient::PushBuffer(host, request.c_str(), (int)request.size());
+        else
+          m_websocket->Fail();
       }
       else
       {
@@ -700,7 +1180,10 @@ void CTCPServer::CWebSocketClient::Disconnect()
     {
       const CWebSocketFrame *closeFrame = m_websocket->Close();
       if (closeFrame)
-        Send(closeFrame->GetFrameData(), (unsigned int)closeFrame->GetFrameLength());
+      {
+        CTCPClient::Send(closeFrame->GetFrameData(), (unsigned int)closeFrame->GetFrameLength());
+        delete closeFrame;
+      }
     }
 
     if (m_websocket->GetState() == WebSocketStateClosed)
@@ -19,6 +19,9 @@
  *
  */
 
+#include <deque>
+#include <memory>
+#include <string>
 #include <vector>
 #include <sys/socket.h>
 
@@ -28,6 +31,7 @@
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
+#include "utils/JobManager.h"
 #include "websocket/WebSocket.h"
 
 class CVariant;
@@ -53,9 +57,35 @@ namespace JSONRPC
     bool Initialize();
     bool InitializeBlue();
     bool InitializeTCP();
+    bool InitializePoll();
     void Deinitialize();
 
-    class CTCPClient : public IClient
+    class CTCPClient;
+    typedef std::shared_ptr<CTCPClient> CTCPClientPtr;
+
+    struct SocketEvent
+    {
+      SOCKET socket;
+      bool readable;
+      bool writable;
+    };
+
+    /*! \brief Wait until a socket can be read from or written to, or the server is woken up.
+     \return false if waiting failed and the sockets have to be set up again.
+     */
+    bool WaitForEvents(std::vector<SocketEvent> &events, int timeoutMs);
+    void WakeUp();
+
+    void AcceptConnection(SOCKET server);
+    bool Receive(CTCPClientPtr &client);
+    void CloseConnection(const CTCPClientPtr &client);
+    CTCPClientPtr GetConnection(SOCKET socket) const;
+
+    /*! \brief Have a complete request executed by the method workers.
+     */
+    void QueueRequest(const CTCPClientPtr &client);
+
+    class CTCPClient : public IClient, public std::enable_shared_from_this<CTCPClient>
     {
     public:
       CTCPClient();
@@ -69,26 +99,65 @@ namespace JSONRPC
       int GetAnnouncementFlags() override;
       bool SetAnnouncementFlags(int flags) override;
 
+      /*! \brief Send without blocking, what the socket doesn't take is kept until it is writable.
+       */
       virtual void Send(const char *data, unsigned int size);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
       virtual bool IsNew() const { return m_new; }
-      virtual bool Closing() const { return false; }
+      virtual bool Closing() const;
+
+      /*! \brief Send an announcement, it waits for the end of a response that is being sent.
+       Announcements are dropped while the client doesn't read what was sent to it.
+       */
+      void Announce(const std::string &announcement);
+
+      /*! \brief Send what was kept by Send() as far as the socket takes it.
+       */
+      void Flush();
+      bool HasPendingData();
+
+      /*! \brief Respond to the taken requests one after the other, on a method worker.
+       */
+      void ProcessRequests(CTCPServer *host);
 
       SOCKET m_socket;
       sockaddr_storage m_cliaddr;
       socklen_t m_addrlen;
       CCriticalSection m_critSection;
+      CTCPServer *m_host;
+      bool m_pollingWrite;   ///< writability is being waited for
 
     protected:
+      /*! \brief Handle a complete JSON-RPC request, the response is sent as it is serialised.
+       */
+      virtual void Respond(CTCPServer *host, const std::string &request);
+
       void Copy(const CTCPClient& client);
     private:
+      int SendSome(const char *data, size_t size);
+
+      /*! \brief Keep a complete request for the method worker.
+       \return true if no method worker is responding to the client yet and one has to be started.
+       */
+      bool AddRequest(const std::string &request);
+
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+
+      std::string m_sendBuffer;             ///< what the socket didn't take yet
+      bool m_sendFailed;
+      bool m_inResponse;
+      std::vector<std::string> m_announcements;  ///< announcements made while a response was sent
+      bool m_droppingAnnouncements;
+
+      CCriticalSection m_requestSection;
+      std::deque<std::string> m_requests;   ///< complete requests waiting for a method worker
+      bool m_responding;
     };
 
     class CWebSocketClient : public CTCPClient
@@ -105,17 +174,28 @@ namespace JSONRPC
       void Disconnect() override;
 
       bool IsNew() const override { return m_websocket == NULL; }
-      bool Closing() const override { return m_websocket != NULL && m_websocket->GetState() == WebSocketStateClosed; }
+      bool Closing() const override { return CTCPClient::Closing() || (m_websocket != NULL && m_websocket->GetState() == WebSocketStateClosed); }
+
+    protected:
+      void Respond(CTCPServer *host, const std::string &request) override;
 
     private:
       CWebSocket *m_websocket;
+      std::string m_frame;   ///< the frame being sent, kept to reuse its memory
     };
 
-    std::vector<CTCPClient*> m_connections;
+    struct CResponders;
+
+    std::vector<CTCPClientPtr> m_connections;
+    CCriticalSection m_connectionsSection;
     std::vector<SOCKET> m_servers;
     int m_port;
     bool m_nonlocal;
     void* m_sdpd;
+    int m_pollfd;
+    int m_wakeup[2];
+    CJobQueue m_methodQueue;
+    std::shared_ptr<CResponders> m_responders;
 
     static CTCPServer *ServerInstance;
   };
@@ -26,10 +26,13 @@
 #include <utility>
 
 #if defined(TARGET_POSIX)
+#include <fcntl.h>
 #include <pthread.h>
+#include <unistd.h>
 #endif
 
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
 #include "settings/AdvancedSettings.h"
@@ -56,6 +59,9 @@
 
 #define MAX_POST_BUFFER_SIZE 2048
 
+// bytes read from a file per callback when serving it through the VFS
+#define FILE_DOWNLOAD_BLOCK_SIZE 65536
+
 #define PAGE_FILE_NOT_FOUND "<html><head><title>File not found</title></head><body>File not found</body></html>"
 #define NOT_SUPPORTED       "<html><head><title>Not Supported</title></head><body>The method you are trying to use is not supported by this server</body></html>"
 
@@ -111,6 +117,33 @@ static MHD_Response* create_response(size_t size, void* data, int free, int copy
   return MHD_create_response_from_buffer(size, data, mode);
 }
 
+static MHD_Response* create_local_file_response(const std::string &filePath, uint64_t offset, uint64_t length)
+{
+#if defined(TARGET_POSIX) && (MHD_VERSION >= 0x00094400)
+  // local files are handed to mhd as a file descriptor so that it can use sendfile()
+  // instead of copying every byte through the VFS
+  if (URIUtils::IsStack(filePath))
+    return nullptr;
+
+  std::string localPath = CSpecialProtocol::TranslatePath(filePath);
+  if (!CURL(localPath).GetProtocol().empty())
+    return nullptr;
+
+  int fd = open(localPath.c_str(), O_RDONLY);
+  if (fd < 0)
+    return nullptr;
+
+  // mhd closes the file descriptor when the response is destroyed
+  MHD_Response *response = MHD_create_response_from_fd_at_offset64(length, fd, offset);
+  if (response == nullptr)
+    close(fd);
+
+  return response;
+#else
+  return nullptr;
+#endif
+}
+
 int CWebServer::AskForAuthentication(const HTTPRequest& request) const
 {
   struct MHD_Response *response = create_response(0, nullptr, MHD_NO, MHD_NO);
@@ -835,18 +868,30 @@ int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHan
     // set the initial write position
     context->ranges.GetFirstPosition(context->writePosition);
 
+    // a single range of a local file doesn't need to go through the VFS
+    response = nullptr;
+    if (context->rangeCountTotal == 1)
+    {
+      response = create_local_file_response(filePath, context->writePosition, totalLength);
+      if (response != nullptr)
+        file->Close();
+    }
+
     // create the response object
-    response = MHD_create_response_from_callback(totalLength, 2048,
-                                                  &CWebServer::ContentReaderCallback,
-                                                  context.get(),
-                                                  &CWebServer::ContentReaderFreeCallback);
     if (response == nullptr)
     {
-      CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be filled from %s", m_port, request.pathUrl.c_str(), filePath.c_str());
-      return MHD_NO;
-    }
+      response = MHD_create_response_from_callback(totalLength, FILE_DOWNLOAD_BLOCK_SIZE,
+                                                    &CWebServer::ContentReaderCallback,
+                                                    context.get(),
+                                                    &CWebServer::ContentReaderFreeCallback);
+      if (response == nullptr)
+      {
+        CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be filled from %s", m_port, request.pathUrl.c_str(), filePath.c_str());
+        return MHD_NO;
+      }
 
-    context.release(); // ownership was passed to mhd
+      context.release(); // ownership was passed to mhd
+    }
 
     // add Content-Range header
     if (ranged)
@@ -0,0 +1,449 @@
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdlib>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "HTTPHlsHandler.h"
+#include "cores/FFmpeg.h"
+#include "filesystem/File.h"
+#include "network/WebServer.h"
+#include "network/httprequesthandler/HTTPVfsHandler.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#define HLS_SEGMENT_DURATION  6.0     // seconds a segment is long at least, if there are key frames for it
+#define HLS_TIME_TOLERANCE    0.001   // seconds
+#define HLS_TIMESTAMP_OFFSET  1       // seconds added to all timestamps, b-frames may start before 0
+#define HLS_MAX_PLANS         8       // segmentations of files kept in memory
+
+static const std::string HlsBasePath = "/hls/";
+static const std::string HlsPlaylist = "index.m3u8";
+static const std::string HlsSegmentExtension = ".ts";
+
+using namespace XFILE;
+
+namespace
+{
+int vfs_file_read(void *h, uint8_t* buf, int size)
+{
+  CFile* pFile = static_cast<CFile*>(h);
+  return pFile->Read(buf, size);
+}
+
+int64_t vfs_file_seek(void *h, int64_t pos, int whence)
+{
+  CFile* pFile = static_cast<CFile*>(h);
+  if (whence == AVSEEK_SIZE)
+    return pFile->GetLength();
+  else
+    return pFile->Seek(pos, whence & ~AVSEEK_FORCE);
+}
+
+/*!
+ \brief A file opened for demuxing through the VFS.
+ */
+class CHlsInput
+{
+public:
+  CHlsInput() = default;
+  ~CHlsInput()
+  {
+    if (m_format)
+      avformat_close_input(&m_format);
+    if (m_ioContext)
+    {
+      av_free(m_ioContext->buffer);
+      av_free(m_ioContext);
+    }
+  }
+
+  bool Open(const std::string &path)
+  {
+    if (!m_file.Open(path))
+      return false;
+
+    int bufferSize = 32768;
+    uint8_t* buffer = (uint8_t*)av_malloc(bufferSize);
+    m_ioContext = avio_alloc_context(buffer, bufferSize, 0, &m_file, vfs_file_read, NULL, vfs_file_seek);
+    if (m_file.IoControl(IOCTRL_SEEK_POSSIBLE, NULL) != 1)
+      m_ioContext->seekable = 0;
+
+    m_format = avformat_alloc_context();
+    m_format->pb = m_ioContext;
+
+    AVInputFormat* iformat = NULL;
+    av_probe_input_buffer(m_ioContext, &iformat, path.c_str(), NULL, 0, 0);
+    if (avformat_open_input(&m_format, path.c_str(), iformat, NULL) < 0)
+    {
+      // avformat_open_input() frees the context on failure
+      m_format = NULL;
+      return false;
+    }
+
+    if (avformat_find_stream_info(m_format, NULL) < 0)
+      return false;
+
+    m_startTime = m_format->start_time != AV_NOPTS_VALUE ? m_format->start_time : 0;
+    m_video = av_find_best_stream(m_format, AVMEDIA_TYPE_VIDEO, -1, -1, NULL, 0);
+    if (m_video >= 0 && (m_format->streams[m_video]->disposition & AV_DISPOSITION_ATTACHED_PIC))
+      m_video = -1;
+    return true;
+  }
+
+  //! seconds from the start of the file
+  double GetTime(const AVStream *stream, int64_t timestamp) const
+  {
+    return timestamp * av_q2d(stream->time_base) - (double)m_startTime / AV_TIME_BASE;
+  }
+
+  CFile m_file;
+  AVIOContext *m_ioContext = NULL;
+  AVFormatContext *m_format = NULL;
+  int64_t m_startTime = 0;
+  int m_video = -1;
+};
+
+/*!
+ \brief Where the segments of a file start, in seconds. The last entry is the end of the file.
+ */
+typedef std::vector<double> HlsPlan;
+typedef std::shared_ptr<const HlsPlan> HlsPlanPtr;
+
+HlsPlanPtr CreatePlan(const std::string &path)
+{
+  CHlsInput input;
+  if (!input.Open(path) || input.m_format->duration == AV_NOPTS_VALUE)
+    return HlsPlanPtr();
+
+  std::shared_ptr<HlsPlan> plan = std::make_shared<HlsPlan>();
+  double duration = (double)input.m_format->duration / AV_TIME_BASE;
+  plan->push_back(0);
+
+  // segments start at key frames of the video, as long as the index knows of them
+  if (input.m_video >= 0)
+  {
+    const AVStream *stream = input.m_format->streams[input.m_video];
+    for (int i = 0; i < stream->nb_index_entries; i++)
+    {
+      const AVIndexEntry &entry = stream->index_entries[i];
+      if (!(entry.flags & AVINDEX_KEYFRAME))
+        continue;
+
+      double time = input.GetTime(stream, entry.timestamp);
+      if (time - plan->back() >= HLS_SEGMENT_DURATION && time < duration - HLS_TIME_TOLERANCE)
+        plan->push_back(time);
+    }
+  }
+
+  // without an index the segments are cut at the first key frame after each nominal start
+  if (plan->size() == 1)
+  {
+    for (double time = HLS_SEGMENT_DURATION; time < duration - HLS_TIME_TOLERANCE; time += HLS_SEGMENT_DURATION)
+      plan->push_back(time);
+  }
+
+  plan->push_back(duration);
+  return plan;
+}
+
+/*!
+ \brief The segmentation of the most recently requested files, so that the file isn't
+ opened twice for every segment.
+ */
+class CHlsPlans
+{
+public:
+  HlsPlanPtr Get(const std::string &path)
+  {
+    struct __stat64 statBuffer;
+    if (CFile::Stat(path, &statBuffer) != 0)
+      return HlsPlanPtr();
+    std::string key = StringUtils::Format("%s|%" PRId64, path.c_str(), (int64_t)statBuffer.st_mtime);
+
+    {
+      CSingleLock lock(m_section);
+      for (PlanList::iterator it = m_plans.begin(); it != m_plans.end(); ++it)
+      {
+        if (it->first == key)
+        {
+          m_plans.splice(m_plans.begin(), m_plans, it);
+          return m_plans.front().second;
+        }
+      }
+    }
+
+    HlsPlanPtr plan = CreatePlan(path);
+    if (!plan)
+      return plan;
+
+    CSingleLock lock(m_section);
+    m_plans.push_front(std::make_pair(key, plan));
+    if (m_plans.size() > HLS_MAX_PLANS)
+      m_plans.pop_back();
+    return plan;
+  }
+
+private:
+  typedef std::list<std::pair<std::string, HlsPlanPtr>> PlanList;
+
+  CCriticalSection m_section;
+  PlanList m_plans;
+};
+
+CHlsPlans hlsPlans;
+
+std::string GetPlaylist(const HlsPlan &plan)
+{
+  double targetDuration = 0;
+  for (size_t i = 1; i < plan.size(); i++)
+    targetDuration = std::max(targetDuration, plan[i] - plan[i - 1]);
+
+  std::string playlist = StringUtils::Format("#EXTM3U\n"
+                                             "#EXT-X-VERSION:3\n"
+                                             "#EXT-X-PLAYLIST-TYPE:VOD\n"
+                                             "#EXT-X-TARGETDURATION:%d\n"
+                                             "#EXT-X-MEDIA-SEQUENCE:0\n", (int)ceil(targetDuration));
+  for (size_t i = 1; i < plan.size(); i++)
+    playlist += StringUtils::Format("#EXTINF:%.3f,\n%u%s\n", plan[i] - plan[i - 1], (unsigned int)(i - 1), HlsSegmentExtension.c_str());
+  playlist += "#EXT-X-ENDLIST\n";
+  return playlist;
+}
+
+/*!
+ \brief Remux a segment into MPEG-TS.
+
+ A segment starts with the key frame at its start and takes every packet up to the
+ key frame that starts the next one, in the order of the file. So every packet ends
+ up in exactly one segment, even where audio and video are interleaved loosely.
+ Timestamps are kept, so that the segments play back to back.
+ */
+bool GetSegment(const std::string &path, const HlsPlan &plan, unsigned int segment, std::string &data)
+{
+  CHlsInput input;
+  if (!input.Open(path))
+    return false;
+
+  double start = plan[segment];
+  double end = plan[segment + 1];
+  bool last = segment + 2 == plan.size();
+
+  AVFormatContext *output = NULL;
+  if (avformat_alloc_output_context2(&output, NULL, "mpegts", NULL) < 0 || output == NULL)
+    return false;
+
+  // streams the muxer can't carry are left out, e.g. subtitles in text formats
+  std::vector<int> streamMap(input.m_format->nb_streams, -1);
+  for (unsigned int i = 0; i < input.m_format->nb_streams; i++)
+  {
+    const AVStream *stream = input.m_format->streams[i];
+    if ((stream->codecpar->codec_type != AVMEDIA_TYPE_VIDEO && stream->codecpar->codec_type != AVMEDIA_TYPE_AUDIO) ||
+        (stream->disposition & AV_DISPOSITION_ATTACHED_PIC) ||
+        avformat_query_codec(output->oformat, stream->codecpar->codec_id, FF_COMPLIANCE_NORMAL) != 1)
+      continue;
+
+    AVStream *outputStream = avformat_new_stream(output, NULL);
+    if (outputStream == NULL || avcodec_parameters_copy(outputStream->codecpar, stream->codecpar) < 0)
+    {
+      avformat_free_context(output);
+      return false;
+    }
+    outputStream->codecpar->codec_tag = 0;
+    outputStream->time_base = stream->time_base;
+    streamMap[i] = outputStream->index;
+  }
+
+  if (output->nb_streams == 0 || avio_open_dyn_buf(&output->pb) < 0)
+  {
+    avformat_free_context(output);
+    return false;
+  }
+
+  // every segment is muxed on its own, the timestamps mustn't be moved to start at 0
+  output->avoid_negative_ts = AVFMT_AVOID_NEG_TS_DISABLED;
+  AVDictionary *options = NULL;
+  av_dict_set(&options, "mpegts_copyts", "1", 0);
+  bool success = avformat_write_header(output, &options) >= 0;
+  av_dict_free(&options);
+
+  if (success)
+  {
+    if (segment > 0)
+      av_seek_frame(input.m_format, -1, input.m_startTime + (int64_t)(start * AV_TIME_BASE), AVSEEK_FLAG_BACKWARD);
+
+    bool started = false;
+    AVPacket packet;
+    av_init_packet(&packet);
+    while (av_read_frame(input.m_format, &packet) >= 0)
+    {
+      if (packet.stream_index < 0 || packet.stream_index >= (int)streamMap.size() || streamMap[packet.stream_index] < 0)
+      {
+        av_packet_unref(&packet);
+        continue;
+      }
+
+      const AVStream *stream = input.m_format->streams[packet.stream_index];
+      int64_t timestamp = packet.pts != AV_NOPTS_VALUE ? packet.pts : packet.dts;
+      if (timestamp != AV_NOPTS_VALUE)
+      {
+        double time = input.GetTime(stream, timestamp);
+        bool boundary = input.m_video < 0 || (packet.stream_index == input.m_video && (packet.flags & AV_PKT_FLAG_KEY));
+        if (boundary && !last && time >= end - HLS_TIME_TOLERANCE)
+        {
+          av_packet_unref(&packet);
+          break;
+        }
+        if (boundary && !started && time >= start - HLS_TIME_TOLERANCE)
+          started = true;
+      }
+      if (!started)
+      {
+        av_packet_unref(&packet);
+        continue;
+      }
+
+      AVRational timeBase = { 1, AV_TIME_BASE };
+      int64_t offset = av_rescale_q(HLS_TIMESTAMP_OFFSET * AV_TIME_BASE - input.m_startTime, timeBase, stream->time_base);
+      if (packet.pts != AV_NOPTS_VALUE)
+        packet.pts += offset;
+      if (packet.dts != AV_NOPTS_VALUE)
+        packet.dts += offset;
+
+      AVStream *outputStream = output->streams[streamMap[packet.stream_index]];
+      av_packet_rescale_ts(&packet, stream->time_base, outputStream->time_base);
+      packet.stream_index = outputStream->index;
+      packet.pos = -1;
+
+      // takes the packet
+      if (av_interleaved_write_frame(output, &packet) < 0)
+      {
+        success = false;
+        break;
+      }
+    }
+
+    if (success)
+      success = av_write_trailer(output) >= 0;
+  }
+
+  uint8_t *buffer = NULL;
+  int size = avio_close_dyn_buf(output->pb, &buffer);
+  if (success && size > 0)
+    data.assign(reinterpret_cast<const char*>(buffer), size);
+  av_free(buffer);
+  avformat_free_context(output);
+
+  return success && !data.empty();
+}
+}
+
+CHTTPHlsHandler::CHTTPHlsHandler(const HTTPRequest &request)
+  : IHTTPRequestHandler(request)
+{
+  size_t pos = m_request.pathUrl.rfind('/');
+  if (pos <= HlsBasePath.size())
+  {
+    m_response.status = MHD_HTTP_BAD_REQUEST;
+    m_response.type = HTTPError;
+    return;
+  }
+
+  m_file = m_request.pathUrl.substr(HlsBasePath.size(), pos - HlsBasePath.size());
+  m_resource = m_request.pathUrl.substr(pos + 1);
+
+  int status = CHTTPVfsHandler::GetAccessStatus(m_file);
+  if (status != MHD_HTTP_OK)
+  {
+    m_response.status = status;
+    m_response.type = HTTPError;
+    return;
+  }
+
+  m_response.status = MHD_HTTP_OK;
+  m_response.type = HTTPMemoryDownloadNoFreeNoCopy;
+  if (m_resource == HlsPlaylist)
+    m_response.contentType = "application/vnd.apple.mpegurl";
+  else
+    m_response.contentType = "video/mp2t";
+}
+
+bool CHTTPHlsHandler::CanHandleRequest(const HTTPRequest &request) const
+{
+  if ((request.method != GET && request.method != HEAD) ||
+      request.pathUrl.find(HlsBasePath) != 0)
+    return false;
+
+  return StringUtils::EndsWith(request.pathUrl, "/" + HlsPlaylist) ||
+         StringUtils::EndsWith(request.pathUrl, HlsSegmentExtension);
+}
+
+int CHTTPHlsHandler::HandleRequest()
+{
+  if (m_response.type == HTTPError)
+    return MHD_YES;
+
+  HlsPlanPtr plan = hlsPlans.Get(m_file);
+  if (!plan)
+  {
+    CLog::Log(LOGERROR, "CHTTPHlsHandler: unable to segment %s", m_file.c_str());
+    m_response.status = MHD_HTTP_UNSUPPORTED_MEDIA_TYPE;
+    m_response.type = HTTPError;
+    return MHD_YES;
+  }
+
+  if (m_resource == HlsPlaylist)
+    m_data = GetPlaylist(*plan);
+  else
+  {
+    char *end = NULL;
+    unsigned long segment = strtoul(m_resource.c_str(), &end, 10);
+    if (end == m_resource.c_str() || HlsSegmentExtension != end || segment + 1 >= plan->size())
+    {
+      m_response.status = MHD_HTTP_NOT_FOUND;
+      m_response.type = HTTPError;
+      return MHD_YES;
+    }
+
+    // nothing else to do if this is a HEAD request
+    if (m_request.method == HEAD)
+      return MHD_YES;
+
+    if (!GetSegment(m_file, *plan, segment, m_data))
+    {
+      CLog::Log(LOGERROR, "CHTTPHlsHandler: unable to remux segment %lu of %s", segment, m_file.c_str());
+      m_response.status = MHD_HTTP_INTERNAL_SERVER_ERROR;
+      m_response.type = HTTPError;
+      return MHD_YES;
+    }
+  }
+
+  m_response.totalLength = m_data.size();
+  if (m_request.method == GET && !m_data.empty())
+    m_responseData.push_back(CHttpResponseRange(m_data.c_str(), 0, m_response.totalLength - 1));
+
+  return MHD_YES;
+}
@@ -0,0 +1,57 @@
+#pragma once
+/*
+ *      Copyright (C) 2015 Team XBMC
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+#include "network/httprequesthandler/IHTTPRequestHandler.h"
+
+/*!
+ \brief Serves a file of a shared source as HTTP Live Streaming, remuxed into
+ MPEG-TS segments while they are requested, without transcoding.
+
+ /hls/<path>/index.m3u8 is the playlist of the file at <path> (url-encoded, as
+ for /vfs/), /hls/<path>/<n>.ts its segments. Segments start at key frames of
+ the video stream, taken from the index of the container where there is one.
+ */
+class CHTTPHlsHandler : public IHTTPRequestHandler
+{
+public:
+  CHTTPHlsHandler() = default;
+  ~CHTTPHlsHandler() override = default;
+
+  IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPHlsHandler(request); }
+  bool CanHandleRequest(const HTTPRequest &request) const override;
+
+  int HandleRequest() override;
+
+  HttpResponseRanges GetResponseData() const override { return m_responseData; }
+
+  int GetPriority() const override { return 5; }
+
+protected:
+  explicit CHTTPHlsHandler(const HTTPRequest &request);
+
+private:
+  std::string m_file;
+  std::string m_resource;   ///< index.m3u8 or <n>.ts
+  std::string m_data;
+  HttpResponseRanges m_responseData;
+};
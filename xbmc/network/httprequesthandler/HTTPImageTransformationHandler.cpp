@@ -18,7 +18,10 @@
  *
  */
 
+#include <cinttypes>
+#include <list>
 #include <map>
+#include <set>
 
 #include "HTTPImageTransformationHandler.h"
 #include "TextureCacheJob.h"
@@ -26,6 +29,10 @@
 #include "filesystem/ImageFile.h"
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/Crc32.h"
 #include "utils/Mime.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -34,12 +41,89 @@
 #define TRANSFORMATION_OPTION_HEIGHT            "height"
 #define TRANSFORMATION_OPTION_SCALING_ALGORITHM "scaling_algorithm"
 
+#define TRANSFORMATION_CACHE_SIZE       (32 * 1024 * 1024) // bytes of transformed images kept in memory
+#define TRANSFORMATION_MAX_CONCURRENT   2                  // images resized at the same time
+
 static const std::string ImageBasePath = "/image/";
 
+namespace
+{
+/*!
+ \brief Least recently used cache of transformed images, shared by all requests.
+
+ Resizing is limited to a few images at a time, so that a web interface asking for
+ a page of thumbnails at once doesn't occupy every core. Concurrent requests for the
+ same variant wait for the first one instead of resizing it again.
+ */
+class CTransformedImageCache
+{
+public:
+  typedef std::shared_ptr<const std::vector<uint8_t>> ImagePtr;
+
+  ImagePtr Get(const std::string &key, const std::string &imagePath)
+  {
+    CSingleLock lock(m_section);
+    for (;;)
+    {
+      auto it = m_index.find(key);
+      if (it != m_index.end())
+      {
+        // move to the front of the list
+        m_images.splice(m_images.begin(), m_images, it->second);
+        return it->second->second;
+      }
+      if (m_resizing.find(key) == m_resizing.end() && m_resizing.size() < TRANSFORMATION_MAX_CONCURRENT)
+        break;
+      m_changed.wait(lock);
+    }
+
+    m_resizing.insert(key);
+    ImagePtr image;
+    {
+      CSingleExit exit(m_section);
+      uint8_t *buffer = nullptr;
+      size_t bufferSize = 0;
+      if (CTextureCacheJob::ResizeTexture(imagePath, buffer, bufferSize))
+        image = std::make_shared<const std::vector<uint8_t>>(buffer, buffer + bufferSize);
+      delete[] buffer;
+    }
+    m_resizing.erase(key);
+
+    if (image)
+    {
+      m_images.push_front(std::make_pair(key, image));
+      m_index[key] = m_images.begin();
+      m_size += image->size();
+      while (m_size > TRANSFORMATION_CACHE_SIZE && m_images.size() > 1)
+      {
+        m_size -= m_images.back().second->size();
+        m_index.erase(m_images.back().first);
+        m_images.pop_back();
+      }
+    }
+    m_changed.notifyAll();
+    return image;
+  }
+
+private:
+  typedef std::list<std::pair<std::string, ImagePtr>> ImageList;
+
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_changed;
+  ImageList m_images;
+  std::map<std::string, ImageList::iterator> m_index;
+  std::set<std::string> m_resizing;
+  size_t m_size = 0;
+};
+
+CTransformedImageCache transformedImages;
+}
+
 CHTTPImageTransformationHandler::CHTTPImageTransformationHandler()
   : m_url(),
     m_lastModified(),
-    m_buffer(NULL),
+    m_modificationTime(0),
+    m_image(),
     m_responseData()
 { }
 
@@ -47,7 +131,8 @@ CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPReque
   : IHTTPRequestHandler(request),
     m_url(),
     m_lastModified(),
-    m_buffer(NULL),
+    m_modificationTime(0),
+    m_image(),
     m_responseData()
 {
   m_url = m_request.pathUrl.substr(ImageBasePath.size());
@@ -81,6 +166,7 @@ CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPReque
   struct __stat64 statBuffer;
   if (imageFile.Stat(pathToUrl, &statBuffer) != 0)
     return;
+  m_modificationTime = statBuffer.st_mtime;
 
   struct tm *time;
 #ifdef HAVE_LOCALTIME_R
@@ -98,8 +184,6 @@ CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPReque
 CHTTPImageTransformationHandler::~CHTTPImageTransformationHandler()
 {
   m_responseData.clear();
-  delete m_buffer;
-  m_buffer = NULL;
 }
 
 bool CHTTPImageTransformationHandler::CanHandleRequest(const HTTPRequest &request) const
@@ -121,15 +205,6 @@ int CHTTPImageTransformationHandler::HandleRequest()
   if (m_response.type == HTTPError)
     return MHD_YES;
 
-  // nothing else to do if this is a HEAD request
-  if (m_request.method == HEAD)
-  {
-    m_response.status = MHD_HTTP_OK;
-    m_response.type = HTTPMemoryDownloadNoFreeNoCopy;
-
-    return MHD_YES;
-  }
-
   // get the transformation options
   std::map<std::string, std::string> options;
   HTTPRequestHandlerUtils::GetRequestHeaderValues(m_request.connection, MHD_GET_ARGUMENT_KIND, options);
@@ -154,9 +229,33 @@ int CHTTPImageTransformationHandler::HandleRequest()
     imagePath += StringUtils::Join(urlOptions, "&");
   }
 
-  // resize the image into the local buffer
-  size_t bufferSize;
-  if (!CTextureCacheJob::ResizeTexture(imagePath, m_buffer, bufferSize))
+  // the variant is identified by the transformation and the modification time of the source
+  std::string cacheKey = StringUtils::Format("%s|%" PRId64, imagePath.c_str(), m_modificationTime);
+  std::string etag = StringUtils::Format("\"%08x\"", Crc32::Compute(cacheKey));
+  AddResponseHeader(MHD_HTTP_HEADER_ETAG, etag);
+
+  // nothing else to do if this is a HEAD request
+  if (m_request.method == HEAD)
+  {
+    m_response.status = MHD_HTTP_OK;
+    m_response.type = HTTPMemoryDownloadNoFreeNoCopy;
+
+    return MHD_YES;
+  }
+
+  // the client already has this variant
+  std::string ifNoneMatch = HTTPRequestHandlerUtils::GetRequestHeaderValue(m_request.connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_NONE_MATCH);
+  if (!ifNoneMatch.empty() && (ifNoneMatch == "*" || ifNoneMatch.find(etag) != std::string::npos))
+  {
+    m_response.status = MHD_HTTP_NOT_MODIFIED;
+    m_response.type = HTTPMemoryDownloadNoFreeNoCopy;
+
+    return MHD_YES;
+  }
+
+  // get the resized image from the cache or resize it now
+  m_image = transformedImages.Get(cacheKey, imagePath);
+  if (!m_image || m_image->empty())
   {
     m_response.status = MHD_HTTP_INTERNAL_SERVER_ERROR;
     m_response.type = HTTPError;
@@ -165,17 +264,17 @@ int CHTTPImageTransformationHandler::HandleRequest()
   }
 
   // store the size of the image
-  m_response.totalLength = bufferSize;
+  m_response.totalLength = m_image->size();
 
   // nothing else to do if the request is not ranged
   if (!GetRequestedRanges(m_response.totalLength))
   {
-    m_responseData.push_back(CHttpResponseRange(m_buffer, 0, m_response.totalLength - 1));
+    m_responseData.push_back(CHttpResponseRange(m_image->data(), 0, m_response.totalLength - 1));
     return MHD_YES;
   }
 
   for (HttpRanges::const_iterator range = m_request.ranges.Begin(); range != m_request.ranges.End(); ++range)
-    m_responseData.push_back(CHttpResponseRange(m_buffer + range->GetFirstPosition(), range->GetFirstPosition(), range->GetLastPosition()));
+    m_responseData.push_back(CHttpResponseRange(m_image->data() + range->GetFirstPosition(), range->GetFirstPosition(), range->GetLastPosition()));
 
   return MHD_YES;
 }
@@ -19,8 +19,10 @@
  *
  */
 
+#include <memory>
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 #include "XBDateTime.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
@@ -51,7 +53,8 @@ protected:
 private:
   std::string m_url;
   CDateTime m_lastModified;
+  int64_t m_modificationTime;
 
-  uint8_t* m_buffer;
+  std::shared_ptr<const std::vector<uint8_t>> m_image;
   HttpResponseRanges m_responseData;
 };
@@ -0,0 +1,50 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "HTTPMetricsHandler.h"
+#include "network/WebServer.h"
+#include "utils/Metrics.h"
+
+bool CHTTPMetricsHandler::CanHandleRequest(const HTTPRequest &request) const
+{
+  return (request.method == GET || request.method == HEAD) &&
+         request.pathUrl.compare("/metrics") == 0;
+}
+
+int CHTTPMetricsHandler::HandleRequest()
+{
+  m_responseData = CMetrics::GetInstance().GetPrometheusText();
+  m_responseRange.SetData(m_responseData.c_str(), m_responseData.size());
+
+  m_response.type = HTTPMemoryDownloadNoFreeCopy;
+  m_response.status = MHD_HTTP_OK;
+  m_response.contentType = "text/plain; version=0.0.4";
+  m_response.totalLength = m_responseData.size();
+
+  return MHD_YES;
+}
+
+HttpResponseRanges CHTTPMetricsHandler::GetResponseData() const
+{
+  HttpResponseRanges ranges;
+  ranges.push_back(m_responseRange);
+
+  return ranges;
+}
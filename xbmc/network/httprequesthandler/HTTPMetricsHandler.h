@@ -0,0 +1,53 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+#include "network/httprequesthandler/IHTTPRequestHandler.h"
+
+/*!
+ \brief Serves the metrics of CMetrics at /metrics in the text format of
+ Prometheus, so a monitoring server can scrape them.
+ */
+class CHTTPMetricsHandler : public IHTTPRequestHandler
+{
+public:
+  CHTTPMetricsHandler() = default;
+  ~CHTTPMetricsHandler() override = default;
+
+  IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPMetricsHandler(request); }
+  bool CanHandleRequest(const HTTPRequest &request) const override;
+
+  int HandleRequest() override;
+
+  HttpResponseRanges GetResponseData() const override;
+
+  int GetPriority() const override { return 5; }
+
+protected:
+  explicit CHTTPMetricsHandler(const HTTPRequest &request)
+    : IHTTPRequestHandler(request)
+  { }
+
+private:
+  std::string m_responseData;
+  CHttpResponseRange m_responseRange;
+};
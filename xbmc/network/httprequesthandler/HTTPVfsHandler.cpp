@@ -35,60 +35,53 @@ CHTTPVfsHandler::CHTTPVfsHandler(const HTTPRequest &request)
   if (m_request.pathUrl.size() > 5)
   {
     file = m_request.pathUrl.substr(5);
+    responseStatus = GetAccessStatus(file);
+  }
 
-    if (XFILE::CFile::Exists(file))
-    {
-      bool accessible = false;
-      if (file.substr(0, 8) == "image://")
-        accessible = true;
-      else
-      {
-        std::string sourceTypes[] = { "video", "music", "pictures" };
-        unsigned int size = sizeof(sourceTypes) / sizeof(std::string);
+  // set the file and the HTTP response status
+  SetFile(file, responseStatus);
+}
 
-        std::string realPath = URIUtils::GetRealPath(file);
-        // for rar:// and zip:// paths we need to extract the path to the archive instead of using the VFS path
-        while (URIUtils::IsInArchive(realPath))
-          realPath = CURL(realPath).GetHostName();
+int CHTTPVfsHandler::GetAccessStatus(const std::string &file)
+{
+  if (!XFILE::CFile::Exists(file))
+    return MHD_HTTP_NOT_FOUND;
 
-        VECSOURCES *sources = NULL;
-        for (unsigned int index = 0; index < size && !accessible; index++)
-        {
-          sources = CMediaSourceSettings::GetInstance().GetSources(sourceTypes[index]);
-          if (sources == NULL)
-            continue;
+  if (file.substr(0, 8) == "image://")
+    return MHD_HTTP_OK;
 
-          for (VECSOURCES::const_iterator source = sources->begin(); source != sources->end() && !accessible; ++source)
-          {
-            // don't allow access to locked / disabled sharing sources
-            if (source->m_iHasLock == 2 || !source->m_allowSharing)
-              continue;
+  std::string sourceTypes[] = { "video", "music", "pictures" };
+  unsigned int size = sizeof(sourceTypes) / sizeof(std::string);
 
-            for (std::vector<std::string>::const_iterator path = source->vecPaths.begin(); path != source->vecPaths.end(); ++path)
-            {
-              std::string realSourcePath = URIUtils::GetRealPath(*path);
-              if (URIUtils::PathHasParent(realPath, realSourcePath, true))
-              {
-                accessible = true;
-                break;
-              }
-            }
-          }
-        }
-      }
+  std::string realPath = URIUtils::GetRealPath(file);
+  // for rar:// and zip:// paths we need to extract the path to the archive instead of using the VFS path
+  while (URIUtils::IsInArchive(realPath))
+    realPath = CURL(realPath).GetHostName();
 
-      if (accessible)
-        responseStatus = MHD_HTTP_OK;
-      // the file exists but not in one of the defined sources so we deny access to it
-      else
-        responseStatus = MHD_HTTP_UNAUTHORIZED;
+  VECSOURCES *sources = NULL;
+  for (unsigned int index = 0; index < size; index++)
+  {
+    sources = CMediaSourceSettings::GetInstance().GetSources(sourceTypes[index]);
+    if (sources == NULL)
+      continue;
+
+    for (VECSOURCES::const_iterator source = sources->begin(); source != sources->end(); ++source)
+    {
+      // don't allow access to locked / disabled sharing sources
+      if (source->m_iHasLock == 2 || !source->m_allowSharing)
+        continue;
+
+      for (std::vector<std::string>::const_iterator path = source->vecPaths.begin(); path != source->vecPaths.end(); ++path)
+      {
+        std::string realSourcePath = URIUtils::GetRealPath(*path);
+        if (URIUtils::PathHasParent(realPath, realSourcePath, true))
+          return MHD_HTTP_OK;
+      }
     }
-    else
-      responseStatus = MHD_HTTP_NOT_FOUND;
   }
 
-  // set the file and the HTTP response status
-  SetFile(file, responseStatus);
+  // the file exists but not in one of the defined sources so we deny access to it
+  return MHD_HTTP_UNAUTHORIZED;
 }
 
 bool CHTTPVfsHandler::CanHandleRequest(const HTTPRequest &request) const
@@ -34,6 +34,12 @@ public:
 
   int GetPriority() const override { return 5; }
 
+  /*!
+   \brief Whether a file may be served, it has to be in a shared source.
+   \return MHD_HTTP_OK, MHD_HTTP_UNAUTHORIZED or MHD_HTTP_NOT_FOUND.
+   */
+  static int GetAccessStatus(const std::string &file);
+
 protected:
   explicit CHTTPVfsHandler(const HTTPRequest &request);
 };
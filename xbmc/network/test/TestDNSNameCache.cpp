@@ -0,0 +1,45 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "network/DNSNameCache.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestDNSNameCache, IpAddress)
+{
+  std::string ip;
+  EXPECT_TRUE(CDNSNameCache::Lookup("192.168.1.20", ip));
+  EXPECT_EQ("192.168.1.20", ip);
+}
+
+TEST(TestDNSNameCache, CustomEntry)
+{
+  CDNSNameCache::Add("kodi-test-custom-host", "10.1.2.3");
+
+  std::string ip;
+  EXPECT_TRUE(CDNSNameCache::Lookup("kodi-test-custom-host", ip));
+  EXPECT_EQ("10.1.2.3", ip);
+
+  // prefetching a cached host doesn't replace the entry
+  CDNSNameCache::Prefetch("kodi-test-custom-host");
+  ip.clear();
+  EXPECT_TRUE(CDNSNameCache::Lookup("kodi-test-custom-host", ip));
+  EXPECT_EQ("10.1.2.3", ip);
+}
@@ -55,6 +55,9 @@
 
 NPT_SET_LOCAL_LOGGER("xbmc.upnp.server")
 
+#define UPNP_MAX_INDEXED_LISTINGS 16      // listings kept for paging through them
+#define UPNP_MAX_INDEXED_OBJECTS  50000   // didl of items kept, for all clients
+
 using namespace ANNOUNCEMENT;
 using namespace XFILE;
 using KODI::UTILITY::CDigest;
@@ -433,6 +436,10 @@ CUPnPServer::Announce(AnnouncementFlag flag, const char *sender, const char *mes
         && strcmp(message, "OnScanStarted") && strcmp(message, "OnScanFinished"))
         return;
 
+    // an update may show in any listing, e.g. through the playcount or recently added
+    if (flag == VideoLibrary || flag == AudioLibrary)
+        InvalidateIndex();
+
     if (data.isNull()) {
         if (!strcmp(message, "OnScanStarted") || !strcmp(message, "OnCleanStarted")) {
             m_scanning = true;
@@ -492,6 +499,94 @@ CUPnPServer::Announce(AnnouncementFlag flag, const char *sender, const char *mes
     }
 }
 
+/*----------------------------------------------------------------------
+|   CUPnPServer::IsIndexable
++---------------------------------------------------------------------*/
+bool
+CUPnPServer::IsIndexable(const std::string& id)
+{
+    // only listings we are told about changes of
+    return StringUtils::StartsWith(id, "musicdb://") ||
+           StringUtils::StartsWith(id, "videodb://") ||
+           StringUtils::StartsWith(id, "library://video/") ||
+           StringUtils::StartsWith(id, "virtualpath://upnproot");
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::GetIndexedListing
++---------------------------------------------------------------------*/
+std::shared_ptr<CFileItemList>
+CUPnPServer::GetIndexedListing(const std::string& id)
+{
+    NPT_AutoLock lock(m_IndexMutex);
+    std::map<std::string, CIndexedListing>::iterator itr = m_IndexedListings.find(id);
+    if (itr == m_IndexedListings.end())
+        return std::shared_ptr<CFileItemList>();
+
+    itr->second.last_used = XbmcThreads::SystemClockMillis();
+    return itr->second.items;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::IndexListing
++---------------------------------------------------------------------*/
+void
+CUPnPServer::IndexListing(const std::string& id, const std::shared_ptr<CFileItemList>& items)
+{
+    NPT_AutoLock lock(m_IndexMutex);
+    if (m_IndexedListings.size() >= UPNP_MAX_INDEXED_LISTINGS) {
+        std::map<std::string, CIndexedListing>::iterator oldest = m_IndexedListings.begin();
+        for (std::map<std::string, CIndexedListing>::iterator itr = m_IndexedListings.begin(); itr != m_IndexedListings.end(); ++itr) {
+            if (itr->second.last_used < oldest->second.last_used)
+                oldest = itr;
+        }
+        m_IndexedListings.erase(oldest);
+    }
+
+    CIndexedListing& listing = m_IndexedListings[id];
+    listing.items = items;
+    listing.last_used = XbmcThreads::SystemClockMillis();
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::GetIndexedDidl
++---------------------------------------------------------------------*/
+bool
+CUPnPServer::GetIndexedDidl(const std::string& key, NPT_String& didl)
+{
+    NPT_AutoLock lock(m_IndexMutex);
+    std::map<std::string, NPT_String>::const_iterator itr = m_IndexedDidl.find(key);
+    if (itr == m_IndexedDidl.end())
+        return false;
+
+    didl = itr->second;
+    return true;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::IndexDidl
++---------------------------------------------------------------------*/
+void
+CUPnPServer::IndexDidl(const std::string& key, const NPT_String& didl)
+{
+    NPT_AutoLock lock(m_IndexMutex);
+    // start over rather than keeping track of what was used when
+    if (m_IndexedDidl.size() >= UPNP_MAX_INDEXED_OBJECTS)
+        m_IndexedDidl.clear();
+    m_IndexedDidl[key] = didl;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::InvalidateIndex
++---------------------------------------------------------------------*/
+void
+CUPnPServer::InvalidateIndex()
+{
+    NPT_AutoLock lock(m_IndexMutex);
+    m_IndexedListings.clear();
+    m_IndexedDidl.clear();
+}
+
 /*----------------------------------------------------------------------
 |   TranslateWMPObjectId
 +---------------------------------------------------------------------*/
@@ -644,7 +739,6 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
                                     const char*                   sort_criteria,
                                     const PLT_HttpRequestContext& context)
 {
-    CFileItemList items;
     NPT_String    parent_id = TranslateWMPObjectId(object_id);
 
     CLog::Log(LOGINFO, "UPnP: Received Browse DirectChildren request for object '%s', with sort criteria %s", object_id, sort_criteria);
@@ -654,6 +748,22 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
         return NPT_FAILURE;
     }
 
+    // Don't pass parent_id if action is Search not BrowseDirectChildren, as
+    // we want the engine to determine the best parent id, not necessarily the one
+    // passed
+    NPT_String action_name = action->GetActionDesc().GetName();
+    const char* response_parent_id = (action_name.Compare("Search", true)==0)?NULL:parent_id.GetChars();
+
+    // pages after the first one of a library listing come from the index
+    bool indexed = IsIndexable((const char*)parent_id);
+    std::shared_ptr<CFileItemList> listing;
+    if (indexed)
+        listing = GetIndexedListing((const char*)parent_id);
+    if (listing)
+        return BuildResponse(action, *listing, filter, starting_index, requested_count, sort_criteria, context, response_parent_id, true);
+
+    listing.reset(new CFileItemList);
+    CFileItemList& items = *listing;
     items.SetPath(std::string(parent_id));
 
     // guard against loading while saving to the same cache file
@@ -717,10 +827,18 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
       }
     }
 
-    // Don't pass parent_id if action is Search not BrowseDirectChildren, as
-    // we want the engine to determine the best parent id, not necessarily the one
-    // passed
-    NPT_String action_name = action->GetActionDesc().GetName();
+    // this isn't pretty but needed to properly hide the addons node from clients
+    if (StringUtils::StartsWith(items.GetPath(), "library")) {
+        for (int i=items.Size()-1; i>=0; i--) {
+            if (StringUtils::StartsWith(items[i]->GetPath(), "addons") ||
+                StringUtils::EndsWith(items[i]->GetPath(), "/addons.xml/"))
+                items.Remove(i);
+        }
+    }
+
+    if (indexed)
+        IndexListing((const char*)parent_id, listing);
+
     return BuildResponse(
         action,
         items,
@@ -729,7 +847,8 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
         requested_count,
         sort_criteria,
         context,
-        (action_name.Compare("Search", true)==0)?NULL:parent_id.GetChars());
+        response_parent_id,
+        indexed);
 }
 
 /*----------------------------------------------------------------------
@@ -737,13 +856,14 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
 +---------------------------------------------------------------------*/
 NPT_Result
 CUPnPServer::BuildResponse(PLT_ActionReference&          action,
-                           CFileItemList&                items,
+                           const CFileItemList&          items,
                            const char*                   filter,
                            NPT_UInt32                    starting_index,
                            NPT_UInt32                    requested_count,
                            const char*                   sort_criteria,
                            const PLT_HttpRequestContext& context,
-                           const char*                   parent_id /* = NULL */)
+                           const char*                   parent_id,
+                           bool                          indexed)
 {
     NPT_COMPILER_UNUSED(sort_criteria);
 
@@ -752,31 +872,23 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
         starting_index,
         requested_count);
 
-    // we will reuse this ThumbLoader for all items
+    // we will reuse this ThumbLoader for all items, it's only created once an item
+    // isn't in the index
     NPT_Reference<CThumbLoader> thumb_loader;
-
-    if (URIUtils::IsVideoDb(items.GetPath()) ||
-        StringUtils::StartsWithNoCase(items.GetPath(), "library://video/") ||
-        StringUtils::StartsWithNoCase(items.GetPath(), "special://profile/playlists/video/")) {
-
-        thumb_loader = NPT_Reference<CThumbLoader>(new CVideoThumbLoader());
-    }
-    else if (URIUtils::IsMusicDb(items.GetPath()) ||
-        StringUtils::StartsWithNoCase(items.GetPath(), "special://profile/playlists/music/")) {
-
-        thumb_loader = NPT_Reference<CThumbLoader>(new CMusicThumbLoader());
-    }
-    if (!thumb_loader.IsNull()) {
-        thumb_loader->OnLoaderStart();
-    }
-
-    // this isn't pretty but needed to properly hide the addons node from clients
-    if (StringUtils::StartsWith(items.GetPath(), "library")) {
-        for (int i=0; i<items.Size(); i++) {
-            if (StringUtils::StartsWith(items[i]->GetPath(), "addons") ||
-                StringUtils::EndsWith(items[i]->GetPath(), "/addons.xml/"))
-                items.Remove(i);
-        }
+    bool thumb_loader_created = false;
+
+    // the didl of an item differs by the address it was asked on, the quirks of the
+    // client, the filter and the parent
+    std::string index_prefix;
+    if (indexed) {
+        const NPT_String* user_agent = context.GetRequest().GetHeaders().GetHeaderValue(NPT_HTTP_HEADER_USER_AGENT);
+        const NPT_String* server     = context.GetRequest().GetHeaders().GetHeaderValue(NPT_HTTP_HEADER_SERVER);
+        index_prefix = StringUtils::Format("%s\n%s\n%s\n%s\n%s\n",
+                                           (const char*)context.GetLocalAddress().ToString(),
+                                           user_agent ? (const char*)*user_agent : "",
+                                           server ? (const char*)*server : "",
+                                           filter ? filter : "",
+                                           parent_id ? parent_id : "");
     }
 
     // won't return more than UPNP_MAX_RETURNED_ITEMS items at a time to keep things smooth
@@ -789,16 +901,44 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
     NPT_String didl = didl_header;
     PLT_MediaObjectReference object;
     for (unsigned long i=starting_index; i<stop_index; ++i) {
-        object = Build(items[i], true, context, thumb_loader, parent_id);
-        if (object.IsNull()) {
+        NPT_String tmp;
+        std::string index_key = index_prefix + items[i]->GetPath();
+        if (!indexed || !GetIndexedDidl(index_key, tmp)) {
+            if (!thumb_loader_created) {
+                thumb_loader_created = true;
+                if (URIUtils::IsVideoDb(items.GetPath()) ||
+                    StringUtils::StartsWithNoCase(items.GetPath(), "library://video/") ||
+                    StringUtils::StartsWithNoCase(items.GetPath(), "special://profile/playlists/video/")) {
+
+                    thumb_loader = NPT_Reference<CThumbLoader>(new CVideoThumbLoader());
+                }
+                else if (URIUtils::IsMusicDb(items.GetPath()) ||
+                    StringUtils::StartsWithNoCase(items.GetPath(), "special://profile/playlists/music/")) {
+
+                    thumb_loader = NPT_Reference<CThumbLoader>(new CMusicThumbLoader());
+                }
+                if (!thumb_loader.IsNull()) {
+                    thumb_loader->OnLoaderStart();
+                }
+            }
+
+            // Build() fills in the item, an indexed listing is shared between requests
+            CFileItemPtr item = indexed ? CFileItemPtr(new CFileItem(*items[i])) : items[i];
+            object = Build(item, true, context, thumb_loader, parent_id);
+            if (!object.IsNull()) {
+                NPT_CHECK(PLT_Didl::ToDidl(*object.AsPointer(), filter, tmp));
+            }
+            // an empty didl keeps an item that can't be built out of later pages as well
+            if (indexed)
+                IndexDidl(index_key, tmp);
+        }
+
+        if (tmp.IsEmpty()) {
             // don't tell the client this item ever existed
             --total;
             continue;
         }
 
-        NPT_String tmp;
-        NPT_CHECK(PLT_Didl::ToDidl(*object.AsPointer(), filter, tmp));
-
         // Neptunes string growing is dead slow for small additions
         if (didl.GetCapacity() < tmp.GetLength() + didl.GetLength()) {
             didl.Reserve((tmp.GetLength() + didl.GetLength())*2);
@@ -973,7 +1113,12 @@ CUPnPServer::OnSearchContainer(PLT_ActionReference&          action,
     } else if (NPT_String(search_criteria).Find("object.container.playlistContainer") >= 0) {
         return OnBrowseDirectChildren(action, "special://musicplaylists/", filter, starting_index, requested_count, sort_criteria, context);
     } else if (NPT_String(search_criteria).Find("object.item.videoItem") >= 0) {
-      CFileItemList items, itemsall;
+      std::shared_ptr<CFileItemList> listing = GetIndexedListing("upnp://search/videoItem");
+      if (listing)
+        return BuildResponse(action, *listing, filter, starting_index, requested_count, sort_criteria, context, NULL, true);
+
+      listing.reset(new CFileItemList);
+      CFileItemList items, &itemsall = *listing;
 
       CVideoDatabase database;
       if (!database.Open()) {
@@ -1002,10 +1147,11 @@ CUPnPServer::OnSearchContainer(PLT_ActionReference&          action,
       itemsall.Append(items);
       items.Clear();
 
-      return BuildResponse(action, itemsall, filter, starting_index, requested_count, sort_criteria, context, NULL);
+      IndexListing("upnp://search/videoItem", listing);
+      return BuildResponse(action, itemsall, filter, starting_index, requested_count, sort_criteria, context, NULL, true);
   } else if (NPT_String(search_criteria).Find("object.item.imageItem") >= 0) {
       CFileItemList items;
-      return BuildResponse(action, items, filter, starting_index, requested_count, sort_criteria, context, NULL);
+      return BuildResponse(action, items, filter, starting_index, requested_count, sort_criteria, context, NULL, false);
   }
 
   return NPT_FAILURE;
@@ -18,6 +18,9 @@
  *
  */
 #pragma once
+#include <map>
+#include <memory>
+#include <string>
 #include <utility>
 #include <Platinum/Source/Devices/MediaConnect/PltMediaConnect.h>
 
@@ -115,13 +118,24 @@ private:
                            NPT_Reference<CThumbLoader>&  thumbLoader,
                            const char*                   parent_id = NULL);
     NPT_Result BuildResponse(PLT_ActionReference&          action,
-                             CFileItemList&                items,
+                             const CFileItemList&          items,
                              const char*                   filter,
                              NPT_UInt32                    starting_index,
                              NPT_UInt32                    requested_count,
                              const char*                   sort_criteria,
                              const PLT_HttpRequestContext& context,
-                             const char*                   parent_id /* = NULL */);
+                             const char*                   parent_id,
+                             bool                          indexed);
+
+    /* Library listings are kept with the didl of their items, so that clients paging
+       through them don't query the database and build each item again for every page.
+       Both are dropped on any library update. */
+    std::shared_ptr<CFileItemList> GetIndexedListing(const std::string& id);
+    void IndexListing(const std::string& id, const std::shared_ptr<CFileItemList>& items);
+    bool GetIndexedDidl(const std::string& key, NPT_String& didl);
+    void IndexDidl(const std::string& key, const NPT_String& didl);
+    void InvalidateIndex();
+    static bool IsIndexable(const std::string& id);
 
     // class methods
     static bool SortItems(CFileItemList& items, const char* sort_criteria);
@@ -135,6 +149,15 @@ private:
 
     NPT_Mutex m_CacheMutex;
 
+    struct CIndexedListing
+    {
+        std::shared_ptr<CFileItemList> items;
+        unsigned int                   last_used;
+    };
+    NPT_Mutex m_IndexMutex;
+    std::map<std::string, CIndexedListing> m_IndexedListings;  // by container id
+    std::map<std::string, NPT_String>      m_IndexedDidl;      // by client, filter, parent and item path
+
     NPT_Mutex m_FileMutex;
     NPT_Map<NPT_String, NPT_String> m_FileMap;
 
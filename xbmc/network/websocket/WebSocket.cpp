@@ -18,9 +18,12 @@
  *
  */
 
+#include <cstring>
 #include <string>
 #include <sstream>
 
+#include <zlib.h>
+
 #include "WebSocket.h"
 #include "utils/EndianSwap.h"
 #include "utils/log.h"
@@ -42,6 +45,11 @@
 
 #define LENGTH_MIN    0x2
 
+#define DEFLATE_TAIL          "\x00\x00\xff\xff"
+#define DEFLATE_TAIL_LENGTH   4
+#define DEFLATE_CHUNK         16384
+#define INFLATE_MAX_LENGTH    (16 * 1024 * 1024)  // the largest decompressed message accepted
+
 CWebSocketFrame::CWebSocketFrame(const char* data, uint64_t length)
 {
   reset();
@@ -55,10 +63,8 @@ CWebSocketFrame::CWebSocketFrame(const char* data, uint64_t length)
 
   // Get the FIN flag
   m_final = ((m_data[0] & MASK_FIN) == MASK_FIN);
-  // Get the RSV1 - RSV3 flags
-  m_extension |= m_data[0] & MASK_RSV1;
-  m_extension |= (m_data[0] & MASK_RSV2) << 1;
-  m_extension |= (m_data[0] & MASK_RSV3) << 2;
+  // Get the RSV1 - RSV3 flags, the same way they are set
+  m_extension = (m_data[0] & MASK_RSV) >> 4;
   // Get the opcode
   m_opcode = (WebSocketFrameOpcode)(m_data[0] & MASK_OPCODE);
   if (m_opcode >= WebSocketUnknownFrame)
@@ -158,81 +164,87 @@ CWebSocketFrame::CWebSocketFrame(WebSocketFrameOpcode opcode, const char* data /
   m_final = final;
   m_extension = extension;
 
-  std::string buffer;
+  char header[MaxHeaderLength];
+  size_t headerLength = WriteHeader(header, m_opcode, m_length, m_final, m_masked, m_mask, m_extension);
+
+  // header and payload go into one buffer, the payload is copied (or masked) once
+  m_lengthFrame = headerLength + (data ? m_length : 0);
+  char *frame = new char[(size_t)m_lengthFrame];
+  memcpy(frame, header, headerLength);
+  m_data = frame;
+
+  if (data)
+  {
+    m_applicationData = frame + headerLength;
+    if (m_masked)
+    {
+      for (uint64_t index = 0; index < m_length; index++)
+        m_applicationData[index] = data[index] ^ ((char *)(&m_mask))[index % 4];
+    }
+    else
+      memcpy(m_applicationData, data, (size_t)m_length);
+  }
+
+  m_valid = true;
+}
+
+size_t CWebSocketFrame::WriteHeader(char *header, WebSocketFrameOpcode opcode, uint64_t length, bool final /* = true */,
+                                    bool masked /* = false */, int32_t mask /* = 0 */, int8_t extension /* = 0 */)
+{
+  size_t headerLength = 0;
   char dataByte = 0;
 
   // Set the FIN flag
-  if (m_final)
+  if (final)
     dataByte |= MASK_FIN;
 
   // Set RSV1 - RSV3 flags
-  if (m_extension != 0)
-    dataByte |= (m_extension << 4) & MASK_RSV;
+  if (extension != 0)
+    dataByte |= (extension << 4) & MASK_RSV;
 
   // Set opcode flag
   dataByte |= opcode & MASK_OPCODE;
 
-  buffer.push_back(dataByte);
+  header[headerLength++] = dataByte;
   dataByte = 0;
 
   // Set MASK flag
-  if (m_masked)
+  if (masked)
     dataByte |= MASK_MASK;
 
   // Set payload length
-  if (m_length < 126)
+  if (length < 126)
   {
-    dataByte |= m_length & MASK_LENGTH;
-    buffer.push_back(dataByte);
+    dataByte |= length & MASK_LENGTH;
+    header[headerLength++] = dataByte;
   }
-  else if (m_length <= 65535)
+  else if (length <= 65535)
   {
     dataByte |= 126 & MASK_LENGTH;
-    buffer.push_back(dataByte);
+    header[headerLength++] = dataByte;
 
-    uint16_t dataLength = Endian_SwapBE16((uint16_t)m_length);
-    buffer.append((const char*)&dataLength, 2);
+    uint16_t dataLength = Endian_SwapBE16((uint16_t)length);
+    memcpy(header + headerLength, &dataLength, 2);
+    headerLength += 2;
   }
   else
   {
     dataByte |= 127 & MASK_LENGTH;
-    buffer.push_back(dataByte);
-    
-    uint64_t dataLength = Endian_SwapBE64(m_length);
-    buffer.append((const char*)&dataLength, 8);
-  }
+    header[headerLength++] = dataByte;
 
-  uint64_t applicationDataOffset = 0;
-  if (data)
-  {
-    // Set masking key
-    if (m_masked)
-    {
-      buffer.append((char *)&m_mask, sizeof(m_mask));
-      applicationDataOffset = buffer.size();
-
-      for (uint64_t index = 0; index < m_length; index++)
-        buffer.push_back(data[index] ^ ((char *)(&m_mask))[index % 4]);
-    }
-    else
-    {
-      applicationDataOffset = buffer.size();
-      buffer.append(data, (unsigned int)length);
-    }
+    uint64_t dataLength = Endian_SwapBE64(length);
+    memcpy(header + headerLength, &dataLength, 8);
+    headerLength += 8;
   }
 
-  // Get the whole data
-  m_lengthFrame = buffer.size();
-  m_data = new char[(uint32_t)m_lengthFrame];
-  memcpy((char *)m_data, buffer.c_str(), (uint32_t)m_lengthFrame);
-
-  if (data)
+  // Set masking key
+  if (masked)
   {
-    m_applicationData = (char *)m_data;
-    m_applicationData += applicationDataOffset;
+    memcpy(header + headerLength, &mask, sizeof(mask));
+    headerLength += sizeof(mask);
   }
 
-  m_valid = true;
+  return headerLength;
 }
 
 CWebSocketFrame::~CWebSocketFrame()
@@ -298,6 +310,194 @@ void CWebSocketMessage::Clear()
   m_frames.clear();
 }
 
+class CWebSocketDeflate
+{
+public:
+  CWebSocketDeflate(int windowBits, bool noContextTakeover)
+    : m_noContextTakeover(noContextTakeover)
+  {
+    memset(&m_deflate, 0, sizeof(m_deflate));
+    memset(&m_inflate, 0, sizeof(m_inflate));
+    m_deflateValid = deflateInit2(&m_deflate, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -windowBits, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+    // the client may use up to 15 bits, whatever it announced
+    m_inflateValid = inflateInit2(&m_inflate, -MAX_WBITS) == Z_OK;
+  }
+
+  ~CWebSocketDeflate()
+  {
+    if (m_deflateValid)
+      deflateEnd(&m_deflate);
+    if (m_inflateValid)
+      inflateEnd(&m_inflate);
+  }
+
+  bool IsValid() const { return m_deflateValid && m_inflateValid; }
+
+  z_stream m_deflate;
+  z_stream m_inflate;
+  bool m_deflateValid;
+  bool m_inflateValid;
+  bool m_noContextTakeover;  ///< the compression starts over with every message
+};
+
+CWebSocket::CWebSocket()
+{
+  m_version = 0;
+  m_state = WebSocketStateNotConnected;
+  m_message = NULL;
+}
+
+CWebSocket::~CWebSocket()
+{
+  delete m_message;
+}
+
+bool CWebSocket::Deflate(const char *data, size_t length, std::string &out)
+{
+  if (m_deflate == nullptr)
+    return false;
+
+  z_stream &stream = m_deflate->m_deflate;
+  stream.next_in = (Bytef *)data;
+  stream.avail_in = (uInt)length;
+
+  // a sync flush ends the message on a byte boundary with an empty stored
+  // block, whose marker (00 00 ff ff) is left out of the frame
+  size_t start = out.size();
+  int ret;
+  do
+  {
+    size_t offset = out.size();
+    out.resize(offset + DEFLATE_CHUNK);
+    stream.next_out = (Bytef *)&out[offset];
+    stream.avail_out = DEFLATE_CHUNK;
+    ret = deflate(&stream, Z_SYNC_FLUSH);
+    out.resize(offset + DEFLATE_CHUNK - stream.avail_out);
+  } while (ret == Z_OK && stream.avail_out == 0);
+
+  if (ret != Z_OK && ret != Z_BUF_ERROR)
+  {
+    CLog::Log(LOGERROR, "WebSocket: compressing a message failed (%d)", ret);
+    out.resize(start);
+    return false;
+  }
+
+  if (out.size() - start >= DEFLATE_TAIL_LENGTH &&
+      memcmp(out.c_str() + out.size() - DEFLATE_TAIL_LENGTH, DEFLATE_TAIL, DEFLATE_TAIL_LENGTH) == 0)
+    out.resize(out.size() - DEFLATE_TAIL_LENGTH);
+
+  if (m_deflate->m_noContextTakeover)
+    deflateReset(&stream);
+
+  return true;
+}
+
+bool CWebSocket::Inflate(const char *data, size_t length, std::string &out)
+{
+  if (m_deflate == nullptr)
+    return false;
+
+  z_stream &stream = m_deflate->m_inflate;
+  size_t start = out.size();
+  int ret = Z_OK;
+
+  // the client leaves out the marker of the empty stored block ending the message
+  for (int part = 0; part < 2 && ret == Z_OK; part++)
+  {
+    stream.next_in = part == 0 ? (Bytef *)data : (Bytef *)DEFLATE_TAIL;
+    stream.avail_in = part == 0 ? (uInt)length : DEFLATE_TAIL_LENGTH;
+
+    do
+    {
+      if (out.size() - start > INFLATE_MAX_LENGTH)
+      {
+        CLog::Log(LOGINFO, "WebSocket: compressed message too large");
+        out.resize(start);
+        return false;
+      }
+
+      size_t offset = out.size();
+      out.resize(offset + DEFLATE_CHUNK);
+      stream.next_out = (Bytef *)&out[offset];
+      stream.avail_out = DEFLATE_CHUNK;
+      ret = inflate(&stream, Z_SYNC_FLUSH);
+      out.resize(offset + DEFLATE_CHUNK - stream.avail_out);
+    } while (ret == Z_OK && (stream.avail_in > 0 || stream.avail_out == 0));
+
+    // nothing left to do with the input so far
+    if (ret == Z_BUF_ERROR)
+      ret = Z_OK;
+  }
+
+  // the client may end the stream with a final block, the next message starts a new one
+  if (ret == Z_STREAM_END)
+  {
+    inflateReset(&stream);
+    ret = Z_OK;
+  }
+
+  if (ret != Z_OK)
+  {
+    CLog::Log(LOGINFO, "WebSocket: invalid compressed message received (%d)", ret);
+    out.resize(start);
+    return false;
+  }
+
+  return true;
+}
+
+void CWebSocket::NegotiateDeflate(const std::string &offers, std::string &response)
+{
+  response.clear();
+
+  // offers are separated by commas, parameters by semicolons, the first acceptable offer is taken
+  std::vector<std::string> extensions = StringUtils::Split(offers, ",");
+  for (std::string &extension : extensions)
+  {
+    std::vector<std::string> parameters = StringUtils::Split(extension, ";");
+    if (parameters.empty() || !StringUtils::EqualsNoCase(StringUtils::Trim(parameters[0]), "permessage-deflate"))
+      continue;
+
+    bool acceptable = true;
+    bool noContextTakeover = false;
+    int windowBits = MAX_WBITS;
+    for (size_t index = 1; index < parameters.size() && acceptable; index++)
+    {
+      std::vector<std::string> parameter = StringUtils::Split(parameters[index], "=");
+      std::string name = StringUtils::Trim(parameter[0]);
+      std::string value = parameter.size() > 1 ? StringUtils::Trim(parameter[1]) : "";
+      StringUtils::Replace(value, "\"", "");
+
+      if (StringUtils::EqualsNoCase(name, "server_no_context_takeover"))
+        noContextTakeover = true;
+      else if (StringUtils::EqualsNoCase(name, "server_max_window_bits"))
+      {
+        // zlib can't produce a raw deflate stream with an 8 bit window
+        windowBits = atoi(value.c_str());
+        acceptable = windowBits >= 9 && windowBits <= MAX_WBITS;
+      }
+      else if (!StringUtils::EqualsNoCase(name, "client_no_context_takeover") &&
+               !StringUtils::EqualsNoCase(name, "client_max_window_bits"))
+        acceptable = false;
+    }
+
+    if (!acceptable)
+      continue;
+
+    std::unique_ptr<CWebSocketDeflate> deflate(new CWebSocketDeflate(windowBits, noContextTakeover));
+    if (!deflate->IsValid())
+      return;
+
+    m_deflate = std::move(deflate);
+    response = "permessage-deflate";
+    if (noContextTakeover)
+      response += "; server_no_context_takeover";
+    if (windowBits != MAX_WBITS)
+      response += StringUtils::Format("; server_max_window_bits=%d", windowBits);
+    return;
+  }
+}
+
 const CWebSocketMessage* CWebSocket::Handle(const char* &buffer, size_t &length, bool &send)
 {
   send = false;
@@ -20,6 +20,8 @@
 #pragma once
  
 #include <stdint.h>
+#include <memory>
+#include <string>
 #include <vector>
 
 enum WebSocketFrameOpcode
@@ -35,6 +37,12 @@ enum WebSocketFrameOpcode
   WebSocketUnknownFrame       = 0x10
 };
 
+enum WebSocketFrameExtension
+{
+  WebSocketExtensionNone        = 0x00,
+  WebSocketExtensionCompressed  = 0x04  // RSV1, set on the first frame of a permessage-deflate message
+};
+
 enum WebSocketState
 {
   WebSocketStateNotConnected    = 0,
@@ -75,6 +83,15 @@ public:
   virtual const char* GetFrameData() const { return m_data; }
   virtual const char* GetApplicationData() const { return m_applicationData; }
 
+  static const size_t MaxHeaderLength = 14;
+
+  /*!
+   \brief Write the header of a frame, the payload follows it unchanged (or masked).
+   \param header at least MaxHeaderLength bytes.
+   \return the length of the header.
+   */
+  static size_t WriteHeader(char *header, WebSocketFrameOpcode opcode, uint64_t length, bool final = true, bool masked = false, int32_t mask = 0, int8_t extension = 0);
+
 protected:
   bool m_free;
   const char *m_data;
@@ -114,11 +131,13 @@ protected:
   bool m_complete;
 };
 
+class CWebSocketDeflate;
+
 class CWebSocket
 {
 public:
-  CWebSocket() { m_state = WebSocketStateNotConnected; m_message = NULL; }
-  virtual ~CWebSocket() { if (m_message) delete m_message; };
+  CWebSocket();
+  virtual ~CWebSocket();
 
   int GetVersion() { return m_version; }
   WebSocketState GetState() { return m_state; }
@@ -131,10 +150,36 @@ public:
   virtual const CWebSocketFrame* Close(WebSocketCloseReason reason = WebSocketCloseNormal, const std::string &message = "") = 0;
   virtual void Fail() = 0;
 
+  /*!
+   \brief Whether messages are compressed with permessage-deflate (RFC 7692), as negotiated in the handshake.
+   */
+  bool IsCompressing() const { return m_deflate != nullptr; }
+
+  /*!
+   \brief Compress the payload of a message, the frame carrying it needs WebSocketExtensionCompressed.
+   \param out the compressed payload is appended to it.
+   */
+  bool Deflate(const char *data, size_t length, std::string &out);
+
+  /*!
+   \brief Decompress the payload of a message received with WebSocketExtensionCompressed.
+   \param out the payload is appended to it.
+   \return false if the payload is invalid or too large.
+   */
+  bool Inflate(const char *data, size_t length, std::string &out);
+
 protected:
   int m_version;
   WebSocketState m_state;
   CWebSocketMessage *m_message;
+  std::unique_ptr<CWebSocketDeflate> m_deflate;
+
+  /*!
+   \brief Accept a permessage-deflate offer of a "Sec-WebSocket-Extensions" header.
+   \param offers the value of the header.
+   \param response the value of the response header, empty if no offer was accepted.
+   */
+  void NegotiateDeflate(const std::string &offers, std::string &response);
 
   virtual CWebSocketFrame* GetFrame(const char* data, uint64_t length) = 0;
   virtual CWebSocketFrame* GetFrame(WebSocketFrameOpcode opcode, const char* data = NULL, uint32_t length = 0, bool final = true, bool masked = false, int32_t mask = 0, int8_t extension = 0) = 0;
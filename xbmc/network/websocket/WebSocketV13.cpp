@@ -42,6 +42,8 @@
 #define WS_HEADER_ACCEPT        "Sec-WebSocket-Accept"
 #define WS_HEADER_PROTOCOL      "Sec-WebSocket-Protocol"
 #define WS_HEADER_PROTOCOL_LC   "sec-websocket-protocol"    // "Sec-WebSocket-Protocol"
+#define WS_HEADER_EXTENSIONS    "Sec-WebSocket-Extensions"
+#define WS_HEADER_EXTENSIONS_LC "sec-websocket-extensions"  // "Sec-WebSocket-Extensions"
 
 #define WS_PROTOCOL_JSONRPC     "jsonrpc.xbmc.org"
 #define WS_HEADER_UPGRADE_VALUE "websocket"
@@ -136,6 +138,12 @@ bool CWebSocketV13::Handshake(const char* data, size_t length, std::string &resp
     }
   }
 
+  // There might be a "Sec-WebSocket-Extensions" header offering permessage-deflate
+  std::string websocketExtensions;
+  value = header.getValue(WS_HEADER_EXTENSIONS_LC);
+  if (value && strlen(value) > 0)
+    NegotiateDeflate(value, websocketExtensions);
+
   CHttpResponse httpResponse(HTTP::Get, HTTP::SwitchingProtocols, HTTP::Version1_1);
   httpResponse.AddHeader(WS_HEADER_UPGRADE, WS_HEADER_UPGRADE_VALUE);
   httpResponse.AddHeader(WS_HEADER_CONNECTION, WS_HEADER_UPGRADE);
@@ -143,6 +151,8 @@ bool CWebSocketV13::Handshake(const char* data, size_t length, std::string &resp
   httpResponse.AddHeader(WS_HEADER_ACCEPT, responseKey);
   if (!websocketProtocol.empty())
     httpResponse.AddHeader(WS_HEADER_PROTOCOL, websocketProtocol);
+  if (!websocketExtensions.empty())
+    httpResponse.AddHeader(WS_HEADER_EXTENSIONS, websocketExtensions);
 
   char *responseBuffer;
   int responseLength = httpResponse.Create(responseBuffer);
@@ -71,7 +71,8 @@ namespace PERIPHERALS
     /*!
      * \brief Trigger a scan for events
      *
-     * \param bWait If true, this blocks until all events are handled
+     * \param bWait If true, the scan runs on the calling thread and all events
+     *              are handled when this returns
      */
     void HandleEvents(bool bWait);
 
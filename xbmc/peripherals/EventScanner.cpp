@@ -36,6 +36,15 @@ using namespace XbmcThreads;
 // input latency when the game is running at < 1/4 speed.
 #define WATCHDOG_TIMEOUT_MS   80
 
+// Scan rate when joysticks wake the scanner and nothing has been held for
+// IDLE_DELAY_MS. Devices outside of /dev/input still get scanned at this rate.
+#define IDLE_SCAN_RATE_HZ     4
+#define IDLE_DELAY_MS         2000
+
+// Joysticks can report at 1 kHz, scans triggered by them are spaced at least
+// this far apart
+#define MIN_INPUT_SCAN_INTERVAL_MS  4
+
 CEventScanner::CEventScanner(IEventScannerCallback* callback) :
   CThread("PeripEventScanner"),
   m_callback(callback)
@@ -52,6 +61,9 @@ void CEventScanner::Stop(void)
 {
   StopThread(false);
   m_scanEvent.Set();
+#if defined(HAS_INPUT_EVENT_MONITOR)
+  m_inputMonitor.Interrupt();
+#endif
   StopThread(true);
 }
 
@@ -93,15 +105,19 @@ void CEventScanner::HandleEvents(bool bWait)
 {
   if (bWait)
   {
-    CSingleLock lock(m_pollMutex);
+    // Scan right here instead of waking the scanner thread and waiting for
+    // it. This saves two context switches, and a scan that was already
+    // running when we were called can't be taken for ours.
+    CSingleLock lock(m_scanMutex);
 
-    m_scanFinishedEvent.Reset();
-    m_scanEvent.Set();
-    m_scanFinishedEvent.Wait();
+    m_callback->ProcessEvents();
   }
   else
   {
     m_scanEvent.Set();
+#if defined(HAS_INPUT_EVENT_MONITOR)
+    m_inputMonitor.Interrupt();
+#endif
   }
 }
 
@@ -119,11 +135,18 @@ void CEventScanner::Process(void)
 {
   double nextScanMs = static_cast<double>(SystemClockMillis());
 
+#if defined(HAS_INPUT_EVENT_MONITOR)
+  if (!m_inputMonitor.Open())
+    CLog::Log(LOGDEBUG, "PERIPHERALS: Input event monitor unavailable, polling at %d Hz", DEFAULT_SCAN_RATE_HZ);
+#endif
+
   while (!m_bStop)
   {
-    m_callback->ProcessEvents();
-
-    m_scanFinishedEvent.Set();
+    {
+      CSingleLock lock(m_scanMutex);
+      m_callback->ProcessEvents();
+    }
+    m_lastScanMs = SystemClockMillis();
 
     const double nowMs = static_cast<double>(SystemClockMillis());
     const double scanIntervalMs = GetScanIntervalMs();
@@ -138,8 +161,35 @@ void CEventScanner::Process(void)
     unsigned int waitTimeMs = static_cast<unsigned int>(nextScanMs - nowMs);
 
     if (!m_bStop && waitTimeMs > 0)
-      m_scanEvent.WaitMSec(waitTimeMs);
+      WaitForEvents(waitTimeMs);
   }
+
+#if defined(HAS_INPUT_EVENT_MONITOR)
+  m_inputMonitor.Close();
+#endif
+}
+
+void CEventScanner::WaitForEvents(unsigned int timeoutMs)
+{
+#if defined(HAS_INPUT_EVENT_MONITOR)
+  if (m_inputMonitor.IsOpen())
+  {
+    // m_scanEvent is only for the fallback, don't let it fire later
+    m_scanEvent.Reset();
+
+    if (m_inputMonitor.Wait(timeoutMs))
+    {
+      m_lastInputMs = SystemClockMillis();
+
+      const unsigned int elapsedMs = m_lastInputMs - m_lastScanMs;
+      if (elapsedMs < MIN_INPUT_SCAN_INTERVAL_MS)
+        Sleep(MIN_INPUT_SCAN_INTERVAL_MS - elapsedMs);
+    }
+    return;
+  }
+#endif
+
+  m_scanEvent.WaitMSec(timeoutMs);
 }
 
 double CEventScanner::GetScanIntervalMs() const
@@ -151,8 +201,15 @@ double CEventScanner::GetScanIntervalMs() const
     bHasActiveHandle = !m_activeHandles.empty();
   }
 
-  if (!bHasActiveHandle)
-    return 1000.0 / DEFAULT_SCAN_RATE_HZ;
-  else
+  if (bHasActiveHandle)
     return WATCHDOG_TIMEOUT_MS;
+
+#if defined(HAS_INPUT_EVENT_MONITOR)
+  // Held buttons and sticks repeat without events, so keep scanning them
+  if (m_inputMonitor.IsOpen() && !m_inputMonitor.IsHeld() &&
+      SystemClockMillis() - m_lastInputMs >= IDLE_DELAY_MS)
+    return 1000.0 / IDLE_SCAN_RATE_HZ;
+#endif
+
+  return 1000.0 / DEFAULT_SCAN_RATE_HZ;
 }
@@ -27,6 +27,11 @@
 #include "threads/Event.h"
 #include "threads/Thread.h"
 
+#if defined(TARGET_LINUX) && !defined(TARGET_ANDROID)
+#include "platform/linux/peripherals/InputEventMonitor.h"
+#define HAS_INPUT_EVENT_MONITOR
+#endif
+
 namespace PERIPHERALS
 {
   class IEventScannerCallback
@@ -42,6 +47,9 @@ namespace PERIPHERALS
    *
    * By default, a rate of 60 Hz is used. A client can obtain control over when
    * input is handled by registering for a polling handle.
+   *
+   * On Linux, input of joysticks on /dev/input triggers a scan right away.
+   * Once they have been idle for a while, the rate drops to save power.
    */
   class CEventScanner : public IEventPollCallback,
                         protected CThread
@@ -68,12 +76,17 @@ namespace PERIPHERALS
 
   private:
     double GetScanIntervalMs(void) const;
+    void WaitForEvents(unsigned int timeoutMs);
 
     IEventScannerCallback* const m_callback;
     std::set<void*>              m_activeHandles;
     CEvent                       m_scanEvent;
-    CEvent                       m_scanFinishedEvent;
     CCriticalSection             m_mutex;
-    CCriticalSection             m_pollMutex; // Prevent two poll handles from polling at once
+    CCriticalSection             m_scanMutex; // Scans run on the scanner thread or a polling thread, one at a time
+    unsigned int                 m_lastScanMs = 0;
+    unsigned int                 m_lastInputMs = 0;
+#if defined(HAS_INPUT_EVENT_MONITOR)
+    CInputEventMonitor           m_inputMonitor; // Only used by the scanner thread
+#endif
   };
 }
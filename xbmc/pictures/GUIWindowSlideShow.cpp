@@ -26,6 +26,7 @@
 #include "utils/URIUtils.h"
 #include "URL.h"
 #include "guilib/GUIComponent.h"
+#include "guilib/GUIFrameScheduler.h"
 #include "guilib/TextureManager.h"
 #include "guilib/GUILabelControl.h"
 #include "input/Key.h"
@@ -34,6 +35,7 @@
 #include "GUIDialogPictureInfo.h"
 #include "GUIUserMessages.h"
 #include "guilib/GUIWindowManager.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/DisplaySettings.h"
 #include "settings/Settings.h"
 #include "FileItem.h"
@@ -42,6 +44,8 @@
 #include "guilib/LocalizeStrings.h"
 #include "TextureDatabase.h"
 #include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/log.h"
 #include "utils/Random.h"
 #include "utils/Variant.h"
@@ -52,6 +56,8 @@
 #ifdef TARGET_POSIX
 #include "platform/linux/XTimeUtils.h"
 #endif
+#include <algorithm>
+#include <cstring>
 #include <random>
 
 using namespace XFILE;
@@ -70,11 +76,152 @@ using namespace KODI::MESSAGING;
 
 #define ROTATION_SNAP_RANGE              10.0f
 
+#define SLIDESHOW_PREFETCH_JOBS              2 // pictures decoded ahead in parallel
+
 #define LABEL_ROW1                          10
 #define CONTROL_PAUSE                       13
 
 static float zoomamount[10] = { 1.0f, 1.2f, 1.5f, 2.0f, 2.8f, 4.0f, 6.0f, 9.0f, 13.5f, 20.0f };
 
+namespace
+{
+class CPicturePrefetchJob : public CJob
+{
+public:
+  CPicturePrefetchJob(const std::string &key, const std::string &path, int maxWidth, int maxHeight)
+    : m_key(key), m_path(path), m_maxWidth(maxWidth), m_maxHeight(maxHeight), m_texture(nullptr)
+  {
+  }
+
+  ~CPicturePrefetchJob() override
+  {
+    delete m_texture;
+  }
+
+  const char *GetType() const override { return "prefetchpicture"; }
+
+  bool operator==(const CJob *job) const override
+  {
+    if (strcmp(job->GetType(), GetType()) == 0)
+    {
+      const CPicturePrefetchJob *prefetchJob = dynamic_cast<const CPicturePrefetchJob*>(job);
+      if (prefetchJob && prefetchJob->m_key == m_key)
+        return true;
+    }
+    return false;
+  }
+
+  bool DoWork() override
+  {
+    m_texture = CTexture::LoadFromFile(m_path, m_maxWidth, m_maxHeight);
+    return m_texture != nullptr;
+  }
+
+  std::string m_key;
+  std::string m_path;
+  int m_maxWidth;
+  int m_maxHeight;
+  CBaseTexture *m_texture;
+};
+}
+
+CSlideShowPrefetcher::CSlideShowPrefetcher(unsigned int jobsAtOnce)
+  : CJobQueue(false, jobsAtOnce, CJob::PRIORITY_NORMAL)
+{
+}
+
+CSlideShowPrefetcher::~CSlideShowPrefetcher()
+{
+  CancelJobs();
+  for (auto &it : m_decoded)
+    delete it.second;
+}
+
+std::string CSlideShowPrefetcher::GetKey(const std::string &path, int maxWidth, int maxHeight)
+{
+  return StringUtils::Format("%dx%d|%s", maxWidth, maxHeight, path.c_str());
+}
+
+void CSlideShowPrefetcher::Prefetch(const std::vector<std::string> &paths, int maxWidth, int maxHeight)
+{
+  std::vector<CPicturePrefetchJob*> jobs;
+  {
+    CSingleLock lock(m_prefetchSection);
+    std::set<std::string> wanted;
+    for (const auto &path : paths)
+    {
+      std::string key = GetKey(path, maxWidth, maxHeight);
+      wanted.insert(key);
+      if (m_decoded.find(key) == m_decoded.end() && m_decoding.insert(key).second)
+        jobs.push_back(new CPicturePrefetchJob(key, path, maxWidth, maxHeight));
+    }
+
+    // drop whatever has fallen out of the prefetch window
+    for (auto it = m_decoded.begin(); it != m_decoded.end();)
+    {
+      if (wanted.find(it->first) == wanted.end())
+      {
+        delete it->second;
+        it = m_decoded.erase(it);
+      }
+      else
+        ++it;
+    }
+    for (auto it = m_decoding.begin(); it != m_decoding.end();)
+    {
+      if (wanted.find(*it) == wanted.end())
+      {
+        CPicturePrefetchJob job(*it, "", 0, 0);
+        CancelJob(&job);
+        it = m_decoding.erase(it);
+      }
+      else
+        ++it;
+    }
+    m_wanted.swap(wanted);
+  }
+  m_decodedEvent.Set();
+
+  // the queue may complete a job synchronously, so add them without holding our lock
+  for (auto job : jobs)
+    AddJob(job);
+}
+
+CBaseTexture* CSlideShowPrefetcher::Take(const std::string &path, int maxWidth, int maxHeight)
+{
+  std::string key = GetKey(path, maxWidth, maxHeight);
+  CSingleLock lock(m_prefetchSection);
+  while (m_decoding.find(key) != m_decoding.end())
+  {
+    m_decodedEvent.Reset();
+    CSingleExit exit(m_prefetchSection);
+    m_decodedEvent.WaitMSec(100);
+  }
+
+  auto it = m_decoded.find(key);
+  if (it == m_decoded.end())
+    return nullptr;
+  CBaseTexture *texture = it->second;
+  m_decoded.erase(it);
+  return texture;
+}
+
+void CSlideShowPrefetcher::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CPicturePrefetchJob *prefetchJob = static_cast<CPicturePrefetchJob*>(job);
+  {
+    CSingleLock lock(m_prefetchSection);
+    m_decoding.erase(prefetchJob->m_key);
+    if (success && m_wanted.find(prefetchJob->m_key) != m_wanted.end())
+    {
+      m_decoded[prefetchJob->m_key] = prefetchJob->m_texture;
+      prefetchJob->m_texture = nullptr;
+    }
+  }
+  m_decodedEvent.Set();
+  CJobQueue::OnJobComplete(jobID, success, job);
+}
+
 CBackgroundPicLoader::CBackgroundPicLoader()
   : CThread("BgPicLoader")
   , m_iPic{0}
@@ -95,6 +242,8 @@ void CBackgroundPicLoader::Create(CGUIWindowSlideShow *pCallback)
 {
   m_pCallback = pCallback;
   m_isLoading = false;
+  if (g_advancedSettings.m_slideshowPrefetch > 0)
+    m_prefetcher.reset(new CSlideShowPrefetcher(std::min(g_advancedSettings.m_slideshowPrefetch, SLIDESHOW_PREFETCH_JOBS)));
   CThread::Create(false);
 }
 
@@ -109,7 +258,11 @@ void CBackgroundPicLoader::Process()
       if (m_pCallback)
       {
         unsigned int start = XbmcThreads::SystemClockMillis();
-        CBaseTexture* texture = CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight);
+        CBaseTexture* texture = nullptr;
+        if (m_prefetcher)
+          texture = m_prefetcher->Take(m_strFileName, m_maxWidth, m_maxHeight);
+        if (!texture)
+          texture = CTexture::LoadFromFile(m_strFileName, m_maxWidth, m_maxHeight);
         totalTime += XbmcThreads::SystemClockMillis() - start;
         count++;
         // tell our parent
@@ -149,6 +302,12 @@ void CBackgroundPicLoader::LoadPic(int iPic, int iSlideNumber, const std::string
   m_loadPic.Set();
 }
 
+void CBackgroundPicLoader::Prefetch(const std::vector<std::string> &paths, int maxWidth, int maxHeight)
+{
+  if (m_prefetcher)
+    m_prefetcher->Prefetch(paths, maxWidth, maxHeight);
+}
+
 CGUIWindowSlideShow::CGUIWindowSlideShow(void)
     : CGUIDialog(WINDOW_SLIDESHOW, "SlideShow.xml")
 {
@@ -235,6 +394,7 @@ void CGUIWindowSlideShow::Reset()
   m_iCurrentPic = 0;
   m_iDirection = 1;
   m_iLastFailedNextSlide = -1;
+  m_iPrefetchedSlide = -1;
   m_slides.clear();
   AnnouncePlaylistClear();
   m_Resolution = CServiceBroker::GetWinSystem()->GetGfxContext().GetVideoResolution();
@@ -521,6 +681,17 @@ void CGUIWindowSlideShow::Process(unsigned int currentTime, CDirtyRegionList &re
     }
   }
 
+  // once the next picture is in place, start on the ones after it
+  if (m_iPrefetchedSlide != m_iNextSlide &&
+      m_Image[1 - m_iCurrentPic].IsLoaded() && m_Image[1 - m_iCurrentPic].SlideNumber() == m_iNextSlide)
+  {
+    int maxWidth, maxHeight;
+    GetCheckedSize((float)res.iWidth * m_fZoom,
+                   (float)res.iHeight * m_fZoom,
+                   maxWidth, maxHeight);
+    PrefetchSlides(maxWidth, maxHeight);
+  }
+
   if (m_slides.at(m_iCurrentSlide)->IsVideo() &&
       m_iVideoSlide != m_iCurrentSlide)
   {
@@ -657,6 +828,18 @@ void CGUIWindowSlideShow::Render()
 
     if (m_Image[m_iCurrentPic].DrawNextImage() && m_Image[1 - m_iCurrentPic].IsLoaded())
       m_Image[1 - m_iCurrentPic].Render();
+    else if (m_Image[1 - m_iCurrentPic].IsLoaded())
+    {
+      // upload the next picture while the current one is static, so the
+      // transition doesn't have to wait for it
+      CGUIFrameScheduler &scheduler = CServiceBroker::GetGUI()->GetFrameScheduler();
+      if (scheduler.CanRunDeferred())
+      {
+        int64_t start = CurrentHostCounter();
+        if (m_Image[1 - m_iCurrentPic].UploadTexture())
+          scheduler.EndDeferred(start);
+      }
+    }
   }
 
   RenderErrorMessage();
@@ -678,6 +861,29 @@ int CGUIWindowSlideShow::GetNextSlide()
   return m_iCurrentSlide;
 }
 
+void CGUIWindowSlideShow::PrefetchSlides(int maxWidth, int maxHeight)
+{
+  m_iPrefetchedSlide = m_iNextSlide;
+
+  // decode the pictures following the next slide, in the direction we are going
+  std::vector<std::string> paths;
+  int step = m_iDirection >= 0 ? 1 : -1;
+  int slide = m_iNextSlide;
+  for (int i = 0; i < static_cast<int>(m_slides.size()) && static_cast<int>(paths.size()) < g_advancedSettings.m_slideshowPrefetch; i++)
+  {
+    slide = (slide + step + m_slides.size()) % m_slides.size();
+    if (slide == m_iCurrentSlide || slide == m_iNextSlide)
+      break;
+    CFileItemPtr item = m_slides.at(slide);
+    if (item->IsVideo() || item->HasProperty("unplayable"))
+      continue;
+    std::string picturePath = GetPicturePath(item.get());
+    if (!picturePath.empty())
+      paths.push_back(picturePath);
+  }
+  m_pBackgroundLoader->Prefetch(paths, maxWidth, maxHeight);
+}
+
 EVENT_RESULT CGUIWindowSlideShow::OnMouseEvent(const CPoint &point, const CMouseEvent &event)
 {
   if (event.m_id == ACTION_GESTURE_NOTIFY)
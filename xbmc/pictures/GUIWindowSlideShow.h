@@ -20,13 +20,16 @@
  *
  */
 
+#include <map>
 #include <memory>
 #include <set>
+#include <vector>
 #include "guilib/GUIDialog.h"
 #include "threads/Thread.h"
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 #include "SlideShowPicture.h"
+#include "utils/JobManager.h"
 #include "utils/SortUtils.h"
 
 class CFileItemList;
@@ -34,6 +37,41 @@ class CVariant;
 
 class CGUIWindowSlideShow;
 
+/*!
+ \brief Decodes the pictures following the next slide ahead of time.
+
+ The wanted pictures are decoded at display size on the job manager's workers,
+ several at once, and kept until the background loader asks for them or they
+ drop out of the wanted set.
+ */
+class CSlideShowPrefetcher : public CJobQueue
+{
+public:
+  explicit CSlideShowPrefetcher(unsigned int jobsAtOnce);
+  ~CSlideShowPrefetcher() override;
+
+  /*! \brief Replace the set of pictures to decode ahead.
+   Pictures no longer wanted are cancelled or freed.
+   */
+  void Prefetch(const std::vector<std::string> &paths, int maxWidth, int maxHeight);
+
+  /*! \brief Take ownership of a prefetched picture, waiting for it if it is being decoded.
+   \return the texture, or nullptr if the picture wasn't prefetched or failed to decode.
+   */
+  CBaseTexture* Take(const std::string &path, int maxWidth, int maxHeight);
+
+  void OnJobComplete(unsigned int jobID, bool success, CJob *job) override;
+
+private:
+  static std::string GetKey(const std::string &path, int maxWidth, int maxHeight);
+
+  std::set<std::string> m_wanted;
+  std::set<std::string> m_decoding;
+  std::map<std::string, CBaseTexture*> m_decoded;
+  CCriticalSection m_prefetchSection;
+  CEvent m_decodedEvent;
+};
+
 class CBackgroundPicLoader : public CThread
 {
 public:
@@ -45,6 +83,7 @@ public:
   bool IsLoading() { return m_isLoading;};
   int SlideNumber() const { return m_iSlideNumber; }
   int Pic() const { return m_iPic; }
+  void Prefetch(const std::vector<std::string> &paths, int maxWidth, int maxHeight);
 
 private:
   void Process() override;
@@ -58,6 +97,7 @@ private:
   bool m_isLoading;
 
   CGUIWindowSlideShow *m_pCallback;
+  std::unique_ptr<CSlideShowPrefetcher> m_prefetcher;
 };
 
 class CGUIWindowSlideShow : public CGUIDialog
@@ -124,6 +164,7 @@ private:
   void GetCheckedSize(float width, float height, int &maxWidth, int &maxHeight);
   std::string GetPicturePath(CFileItem *item);
   int  GetNextSlide();
+  void PrefetchSlides(int maxWidth, int maxHeight);
 
   void AnnouncePlayerPlay(const CFileItemPtr& item);
   void AnnouncePlayerPause(const CFileItemPtr& item);
@@ -156,6 +197,7 @@ private:
   // background loader
   std::unique_ptr<CBackgroundPicLoader> m_pBackgroundLoader;
   int m_iLastFailedNextSlide;
+  int m_iPrefetchedSlide;
   bool m_bLoadNextPic;
   RESOLUTION m_Resolution;
   CPoint m_firstGesturePoint;
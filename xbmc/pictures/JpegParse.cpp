@@ -47,6 +47,10 @@ typedef unsigned char BYTE;
 using namespace XFILE;
 
 //--------------------------------------------------------------------------
+// the header is fetched in blocks of this size, which normally holds all of
+// the EXIF and IPTC data, instead of byte by byte
+#define JPEG_READ_BLOCK                 65536
+
 #define JPEG_PARSE_STRING_ID_BASE       21500
 enum {
   ProcessUnknown = JPEG_PARSE_STRING_ID_BASE,
@@ -72,7 +76,8 @@ enum {
 // Constructor
 //--------------------------------------------------------------------------
 CJpegParse::CJpegParse():
-  m_SectionBuffer(NULL)
+  m_SectionBuffer(NULL),
+  m_readPos(0)
 {
   memset(&m_ExifInfo, 0, sizeof(m_ExifInfo));
   memset(&m_IPTCInfo, 0, sizeof(m_IPTCInfo));
@@ -98,6 +103,54 @@ void CJpegParse::ProcessSOFn (void)
 }
 
 
+//--------------------------------------------------------------------------
+// Read from the file through the block buffer
+//--------------------------------------------------------------------------
+size_t CJpegParse::Read(CFile& infile, void* buffer, size_t size)
+{
+  unsigned char* dest = static_cast<unsigned char*>(buffer);
+  size_t done = 0;
+  while (done < size)
+  {
+    if (m_readPos >= m_readBuffer.size())
+    {
+      m_readBuffer.resize(JPEG_READ_BLOCK);
+      m_readPos = 0;
+      ssize_t bytesRead = infile.Read(m_readBuffer.data(), JPEG_READ_BLOCK);
+      if (bytesRead <= 0)
+      {
+        m_readBuffer.clear();
+        break;
+      }
+      m_readBuffer.resize(bytesRead);
+    }
+    size_t count = m_readBuffer.size() - m_readPos;
+    if (count > size - done)
+      count = size - done;
+    memcpy(dest + done, m_readBuffer.data() + m_readPos, count);
+    m_readPos += count;
+    done += count;
+  }
+  return done;
+}
+
+//--------------------------------------------------------------------------
+// Skip over a section we aren't interested in, seeking past it if it isn't
+// in the buffer
+//--------------------------------------------------------------------------
+bool CJpegParse::Skip(CFile& infile, size_t size)
+{
+  size_t buffered = m_readBuffer.size() - m_readPos;
+  if (size <= buffered)
+  {
+    m_readPos += size;
+    return true;
+  }
+  m_readBuffer.clear();
+  m_readPos = 0;
+  return infile.Seek(size - buffered, SEEK_CUR) >= 0;
+}
+
 //--------------------------------------------------------------------------
 // Read a section from a JPEG file. Note that this function allocates memory.
 // It must be called in pair with ReleaseSection
@@ -122,7 +175,7 @@ bool CJpegParse::GetSection (CFile& infile, const unsigned short sectionLength)
 
   unsigned int len = (unsigned int)sectionLength;
 
-  size_t bytesRead = infile.Read(m_SectionBuffer+sizeof(sectionLength), len-sizeof(sectionLength));
+  size_t bytesRead = Read(infile, m_SectionBuffer+sizeof(sectionLength), len-sizeof(sectionLength));
   if (bytesRead != sectionLength-sizeof(sectionLength))
   {
     printf("JpgParse: premature end of file?");
@@ -150,12 +203,12 @@ bool CJpegParse::ExtractInfo (CFile& infile)
 {
   // Get file marker (two bytes - must be 0xFFD8 for JPEG files
   BYTE a;
-  size_t bytesRead = infile.Read(&a, sizeof(BYTE));
+  size_t bytesRead = Read(infile, &a, sizeof(BYTE));
   if ((bytesRead != sizeof(BYTE)) || (a != 0xFF))
   {
     return false;
   }
-  bytesRead = infile.Read(&a, sizeof(BYTE));
+  bytesRead = Read(infile, &a, sizeof(BYTE));
   if ((bytesRead != sizeof(BYTE)) || (a != M_SOI))
   {
     return false;
@@ -165,7 +218,7 @@ bool CJpegParse::ExtractInfo (CFile& infile)
   {
     BYTE marker = 0;
     for (a=0; a<7; a++) {
-      bytesRead = infile.Read(&marker, sizeof(BYTE));
+      bytesRead = Read(infile, &marker, sizeof(BYTE));
       if (marker != 0xFF)
         break;
 
@@ -179,7 +232,7 @@ bool CJpegParse::ExtractInfo (CFile& infile)
 
     // Read the length of the section.
     unsigned short itemlen = 0;
-    bytesRead = infile.Read(&itemlen, sizeof(itemlen));
+    bytesRead = Read(infile, &itemlen, sizeof(itemlen));
     itemlen = CExifParse::Get16(&itemlen);
 
     if ((bytesRead != sizeof(itemlen)) || (itemlen < sizeof(itemlen)))
@@ -262,8 +315,11 @@ bool CJpegParse::ExtractInfo (CFile& infile)
       // fall through to default case
       default:
         // Skip any other sections.
-        GetSection(infile, itemlen);
-        ReleaseSection();
+        if (!Skip(infile, itemlen - sizeof(itemlen)))
+        {
+          printf("JpgParse: premature end of file?");
+          return false;
+        }
       break;
     }
   }
@@ -320,8 +376,11 @@ bool CJpegParse::Process (const char *picFileName)
   tmp.Format("%s %s", date.GetAsLocalizedDate(), date.GetAsLocalizedTime());
   m_JpegInfo[SLIDESHOW_FILE_DATE] = tmp;*/
 
+  m_readBuffer.clear();
+  m_readPos = 0;
   bool result = ExtractInfo(file);
   file.Close();
+  m_readBuffer.clear();
   return result;
 }
 
@@ -34,6 +34,8 @@
 #define M_DRI   0xDD
 #define M_IPTC  0xED            // IPTC marker
 
+#include <vector>
+
 namespace XFILE
 {
   class CFile;
@@ -54,8 +56,12 @@ class CJpegParse
     bool GetSection(XFILE::CFile& infile, const unsigned short sectionLength);
     void ReleaseSection(void);
     void ProcessSOFn(void);
+    size_t Read(XFILE::CFile& infile, void* buffer, size_t size);
+    bool Skip(XFILE::CFile& infile, size_t size);
 
     unsigned char* m_SectionBuffer;
+    std::vector<unsigned char> m_readBuffer; // block of the file header currently being parsed
+    size_t m_readPos;
     ExifInfo_t m_ExifInfo;
     IPTCInfo_t m_IPTCInfo;
 };
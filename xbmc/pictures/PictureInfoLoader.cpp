@@ -22,17 +22,44 @@
 #include "PictureInfoTag.h"
 #include "ServiceBroker.h"
 #include "settings/Settings.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
 #include "FileItem.h"
 
+#include <map>
+#include <set>
+
+#define PICTURE_TAG_JOBS 4 // number of files read in parallel
+
+/*!
+ \brief Tags read by the jobs, waiting to be picked up by the loader thread.
+ Shared with the jobs so that a job finishing after the loader is gone has somewhere to put its result.
+ */
+struct CPictureInfoLoader::CTagResults
+{
+  CCriticalSection section;
+  CEvent loaded;
+  std::set<std::string> pending;
+  std::map<std::string, CPictureInfoTag> tags;
+};
+
+static bool CanHaveTag(const CFileItem* pItem)
+{
+  return pItem->IsPicture() && !pItem->IsZIP() && !pItem->IsRAR() && !pItem->IsCBR() && !pItem->IsCBZ() && !pItem->IsInternetStream() && !pItem->IsVideo();
+}
+
 CPictureInfoLoader::CPictureInfoLoader()
+  : m_tagQueue(false, PICTURE_TAG_JOBS, CJob::PRIORITY_LOW)
 {
   m_mapFileItems = new CFileItemList;
   m_tagReads = 0;
+  m_loadTags = false;
 }
 
 CPictureInfoLoader::~CPictureInfoLoader()
 {
   StopThread();
+  m_tagQueue.CancelJobs();
   delete m_mapFileItems;
 }
 
@@ -60,7 +87,7 @@ bool CPictureInfoLoader::LoadItem(CFileItem* pItem)
 
 bool CPictureInfoLoader::LoadItemCached(CFileItem* pItem)
 {
-  if (!pItem->IsPicture() || pItem->IsZIP() || pItem->IsRAR() || pItem->IsCBR() || pItem->IsCBZ() || pItem->IsInternetStream() || pItem->IsVideo())
+  if (!CanHaveTag(pItem))
     return false;
 
   if (pItem->HasPictureInfoTag())
@@ -83,7 +110,7 @@ bool CPictureInfoLoader::LoadItemLookup(CFileItem* pItem)
   if (m_pProgressCallback && !pItem->m_bIsFolder)
     m_pProgressCallback->SetProgressAdvance();
 
-  if (!pItem->IsPicture() || pItem->IsZIP() || pItem->IsRAR() || pItem->IsCBR() || pItem->IsCBZ() || pItem->IsInternetStream() || pItem->IsVideo())
+  if (!CanHaveTag(pItem))
     return false;
 
   if (pItem->HasPictureInfoTag())
@@ -91,15 +118,75 @@ bool CPictureInfoLoader::LoadItemLookup(CFileItem* pItem)
 
   if (m_loadTags)
   { // Nothing found, load tag from file
-    pItem->GetPictureInfoTag()->Load(pItem->GetPath());
+    if (!m_tagResults)
+      QueueTagReads();
+
+    bool found = false;
+    {
+      CSingleLock lock(m_tagResults->section);
+      while (m_tagResults->pending.find(pItem->GetPath()) != m_tagResults->pending.end() && !m_bStop)
+      {
+        m_tagResults->loaded.Reset();
+        CSingleExit exit(m_tagResults->section);
+        m_tagResults->loaded.WaitMSec(100);
+      }
+      auto it = m_tagResults->tags.find(pItem->GetPath());
+      if (it != m_tagResults->tags.end())
+      {
+        *pItem->GetPictureInfoTag() = it->second;
+        m_tagResults->tags.erase(it);
+        found = true;
+      }
+    }
+    if (!found)
+    {
+      if (m_bStop)
+        return false;
+      pItem->GetPictureInfoTag()->Load(pItem->GetPath());
+    }
     m_tagReads++;
   }
 
   return true;
 }
 
+void CPictureInfoLoader::QueueTagReads()
+{
+  m_tagResults = std::make_shared<CTagResults>();
+
+  // items are handed to LoadItemLookup in list order, so queue them in the same order
+  for (const auto &item : m_vecItems)
+  {
+    if (!CanHaveTag(item.get()) || item->HasPictureInfoTag())
+      continue;
+
+    std::string path = item->GetPath();
+    {
+      CSingleLock lock(m_tagResults->section);
+      if (!m_tagResults->pending.insert(path).second)
+        continue;
+    }
+
+    std::shared_ptr<CTagResults> results = m_tagResults;
+    m_tagQueue.Submit([results, path]()
+    {
+      CPictureInfoTag tag;
+      tag.Load(path);
+
+      CSingleLock lock(results->section);
+      results->pending.erase(path);
+      results->tags.insert(std::make_pair(path, tag));
+      results->loaded.Set();
+    });
+  }
+}
+
 void CPictureInfoLoader::OnLoaderFinish()
 {
+  // drop any reads still outstanding
+  m_tagQueue.CancelJobs();
+  m_tagResults.reset();
+
   // cleanup cache loaded from HD
   m_mapFileItems->Clear();
 
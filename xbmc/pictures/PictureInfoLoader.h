@@ -20,6 +20,8 @@
  */
 
 #include "BackgroundInfoLoader.h"
+#include "utils/JobManager.h"
+#include <memory>
 #include <string>
 
 class CPictureInfoLoader : public CBackgroundInfoLoader
@@ -37,8 +39,16 @@ protected:
   void OnLoaderStart() override;
   void OnLoaderFinish() override;
 
+  /*! \brief Start reading the tags of all items that need them on the job manager's workers.
+   */
+  void QueueTagReads();
+
+  struct CTagResults;
+
   CFileItemList* m_mapFileItems;
   unsigned int m_tagReads;
   bool m_loadTags;
+  CJobQueue m_tagQueue;
+  std::shared_ptr<CTagResults> m_tagResults;
 };
 
@@ -86,6 +86,7 @@ void CSlideShowPic::Close()
   m_bDrawNextImage = false;
   m_bTransitionImmediately = false;
   m_bIsDirty = true;
+  m_bIsUploaded = false;
   m_alpha = 0;
 #ifdef HAS_DX
   m_vb = nullptr;
@@ -126,6 +127,7 @@ void CSlideShowPic::SetTexture_Internal(int iSlideNumber, CBaseTexture* pTexture
   m_iSlideNumber = iSlideNumber;
 
   m_bIsDirty = true;
+  m_bIsUploaded = false;
   m_pImage = pTexture;
   m_fWidth = (float)pTexture->GetWidth();
   m_fHeight = (float)pTexture->GetHeight();
@@ -273,6 +275,17 @@ void CSlideShowPic::UpdateTexture(CBaseTexture* pTexture)
   m_fWidth = (float)pTexture->GetWidth();
   m_fHeight = (float)pTexture->GetHeight();
   m_bIsDirty = true;
+  m_bIsUploaded = false;
+}
+
+bool CSlideShowPic::UploadTexture()
+{
+  CSingleLock lock(m_textureAccess);
+  if (!m_pImage || !m_bIsLoaded || m_bIsUploaded)
+    return false;
+  m_pImage->LoadToGPU();
+  m_bIsUploaded = true;
+  return true;
 }
 
 static CRect GetRectangle(const float x[4], const float y[4])
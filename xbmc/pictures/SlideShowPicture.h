@@ -48,6 +48,10 @@ public:
 
   void SetTexture(int iSlideNumber, CBaseTexture* pTexture, DISPLAY_EFFECT dispEffect = EFFECT_RANDOM, TRANSITION_EFFECT transEffect = FADEIN_FADEOUT);
   void UpdateTexture(CBaseTexture* pTexture);
+  /*! \brief Upload the texture to the GPU ahead of its first render.
+   \return true if there was anything to upload.
+   */
+  bool UploadTexture();
 
   bool IsLoaded() const { return m_bIsLoaded;};
   void UnLoad() {m_bIsLoaded = false;};
@@ -99,6 +103,7 @@ private:
   bool m_bIsFinished;
   bool m_bDrawNextImage;
   bool m_bIsDirty;
+  bool m_bIsUploaded = false;
   std::string m_strFileName;
   float m_fWidth;
   float m_fHeight;
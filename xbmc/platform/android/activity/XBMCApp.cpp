@@ -86,6 +86,7 @@
 #include "input/mouse/MouseStat.h"
 #include "input/Key.h"
 #include "utils/log.h"
+#include "utils/MemoryBudget.h"
 #include "platform/android/network/NetworkAndroid.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
 #include "filesystem/SpecialProtocol.h"
@@ -312,7 +313,8 @@ void CXBMCApp::onConfigurationChanged()
 void CXBMCApp::onLowMemory()
 {
   android_printf("%s: ", __PRETTY_FUNCTION__);
-  // can't do much as we don't want to close completely
+  // we don't want to close completely, so let the caches give memory back
+  CMemoryBudget::GetInstance().OnMemoryPressure(MemoryPressure::CRITICAL);
 }
 
 void CXBMCApp::onCreateWindow(ANativeWindow* window)
@@ -0,0 +1,310 @@
+/*
+ *      Copyright (C) 2005-2015 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include "InotifyWatcher.h"
+
+#define WATCH_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+
+CInotifyWatcher::CInotifyWatcher(IDirectoryWatcherCallback &callback) :
+  CThread("InotifyWatcher"),
+  m_callback(callback),
+  m_fd(-1),
+  m_rootsChanged(false)
+{
+  m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_fd < 0)
+  {
+    CLog::Log(LOGERROR, "CInotifyWatcher: inotify_init1 failed: %s", strerror(errno));
+    return;
+  }
+  Create();
+}
+
+CInotifyWatcher::~CInotifyWatcher()
+{
+  if (m_fd >= 0)
+  {
+    StopThread(true);
+    close(m_fd);
+  }
+}
+
+void CInotifyWatcher::SetRoots(const std::vector<std::string> &roots)
+{
+  CSingleLock lock(m_rootsSection);
+  m_roots = roots;
+  m_rootsChanged = true;
+}
+
+void CInotifyWatcher::Process()
+{
+  // the events are read into it directly, so align it like them
+  char buffer[16 * 1024] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+  while (!m_bStop)
+  {
+    UpdateRoots();
+
+    struct pollfd pfd = { m_fd, POLLIN, 0 };
+    if (poll(&pfd, 1, 500) <= 0)
+      continue;
+
+    ssize_t len = read(m_fd, buffer, sizeof(buffer));
+    if (len <= 0)
+      continue;
+
+    for (char *ptr = buffer; ptr < buffer + len && !m_bStop;)
+    {
+      const struct inotify_event *event = reinterpret_cast<const struct inotify_event*>(ptr);
+      OnEvent(event);
+      ptr += sizeof(struct inotify_event) + event->len;
+    }
+  }
+}
+
+void CInotifyWatcher::UpdateRoots()
+{
+  std::vector<std::string> roots;
+  {
+    CSingleLock lock(m_rootsSection);
+    if (!m_rootsChanged)
+      return;
+    roots = m_roots;
+    m_rootsChanged = false;
+  }
+
+  for (auto it = m_watchedRoots.begin(); it != m_watchedRoots.end();)
+  {
+    if (std::find(roots.begin(), roots.end(), *it) == roots.end())
+    {
+      RemoveWatches(*it);
+      it = m_watchedRoots.erase(it);
+    }
+    else
+      ++it;
+  }
+  for (auto it = m_failedRoots.begin(); it != m_failedRoots.end();)
+  {
+    if (std::find(roots.begin(), roots.end(), *it) == roots.end())
+      it = m_failedRoots.erase(it);
+    else
+      ++it;
+  }
+
+  for (const auto &root : roots)
+  {
+    if (m_bStop)
+      return;
+    if (m_watchedRoots.find(root) != m_watchedRoots.end() || m_failedRoots.find(root) != m_failedRoots.end())
+      continue;
+
+    if (!AddWatches(root))
+    {
+      RemoveWatches(root);
+      if (!m_bStop)
+        m_failedRoots.insert(root);
+    }
+    else if (m_watches.find(root) != m_watches.end())
+    {
+      CLog::Log(LOGDEBUG, "CInotifyWatcher: watching %s", root.c_str());
+      m_watchedRoots.insert(root);
+      m_callback.OnWatchStarted(root);
+    }
+    // else it doesn't exist right now, it is tried again with the next roots
+  }
+}
+
+void CInotifyWatcher::OnEvent(const struct inotify_event *event)
+{
+  if (event->mask & IN_Q_OVERFLOW)
+  {
+    CLog::Log(LOGWARNING, "CInotifyWatcher: event queue overflowed, the watched folders will be walked again");
+    // the watches are still in place, only the changes until now are lost
+    for (const auto &root : m_watchedRoots)
+    {
+      m_callback.OnWatchLost(root);
+      m_callback.OnWatchStarted(root);
+    }
+    return;
+  }
+
+  auto it = m_paths.find(event->wd);
+  if (it == m_paths.end())
+    return;
+  std::string path = it->second;
+
+  if (event->mask & IN_IGNORED)
+  {
+    // the folder is gone, its parent has been told about it
+    m_watches.erase(path);
+    m_paths.erase(it);
+    if (m_watchedRoots.find(path) != m_watchedRoots.end())
+      DropRoot(path);
+    return;
+  }
+
+  if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT))
+  {
+    if (m_watchedRoots.find(path) != m_watchedRoots.end())
+      DropRoot(path);
+    else if (event->mask & IN_UNMOUNT)
+    {
+      std::string root = GetRoot(path);
+      if (!root.empty())
+        DropRoot(root);
+    }
+    return;
+  }
+
+  m_callback.OnDirectoryChanged(path);
+
+  if (!(event->mask & IN_ISDIR) || event->len == 0)
+    return;
+
+  std::string child = path + event->name + "/";
+  if (event->mask & (IN_CREATE | IN_MOVED_TO))
+  {
+    // anything put into the folder before its watch was added has to be scanned as well
+    std::vector<std::string> added;
+    bool watched = AddWatches(child, &added);
+    for (const auto &folder : added)
+      m_callback.OnDirectoryChanged(folder);
+
+    if (!watched && !m_bStop)
+    {
+      std::string root = GetRoot(path);
+      if (!root.empty())
+      {
+        DropRoot(root);
+        m_failedRoots.insert(root);
+      }
+    }
+  }
+  else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+    RemoveWatches(child);
+}
+
+bool CInotifyWatcher::AddWatches(const std::string &path, std::vector<std::string> *added)
+{
+  std::vector<std::string> pending(1, path);
+  while (!pending.empty())
+  {
+    if (m_bStop)
+      return false;
+
+    std::string dir = pending.back();
+    pending.pop_back();
+
+    int wd = inotify_add_watch(m_fd, dir.c_str(), WATCH_MASK);
+    if (wd < 0)
+    {
+      if (errno == ENOSPC)
+      {
+        CLog::Log(LOGWARNING, "CInotifyWatcher: out of watches at %s, raise fs.inotify.max_user_watches to watch the whole library", dir.c_str());
+        return false;
+      }
+      // gone or not readable, left to the scanner
+      continue;
+    }
+
+    auto it = m_paths.find(wd);
+    if (it != m_paths.end() && it->second != dir)
+    {
+      // symlinks lead here from two places, the changes would only be reported for one of them
+      CLog::Log(LOGDEBUG, "CInotifyWatcher: %s is the same folder as %s, not watching it", dir.c_str(), it->second.c_str());
+      return false;
+    }
+    m_paths[wd] = dir;
+    m_watches[dir] = wd;
+    if (added)
+      added->push_back(dir);
+
+    DIR *handle = opendir(dir.c_str());
+    if (!handle)
+      continue;
+    while (struct dirent *entry = readdir(handle))
+    {
+      if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+        continue;
+
+      std::string child = dir + entry->d_name;
+      bool isDir = entry->d_type == DT_DIR;
+      if (entry->d_type == DT_LNK || entry->d_type == DT_UNKNOWN)
+      {
+        // the scanner follows symlinks, so do we
+        struct stat st;
+        isDir = stat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+      }
+      if (isDir)
+        pending.push_back(child + "/");
+    }
+    closedir(handle);
+  }
+  return true;
+}
+
+void CInotifyWatcher::RemoveWatches(const std::string &path)
+{
+  // the watches are sorted by path, so those below the folder follow it
+  auto it = m_watches.lower_bound(path);
+  while (it != m_watches.end() && StringUtils::StartsWith(it->first, path))
+  {
+    inotify_rm_watch(m_fd, it->second);
+    m_paths.erase(it->second);
+    it = m_watches.erase(it);
+  }
+}
+
+std::string CInotifyWatcher::GetRoot(const std::string &path) const
+{
+  for (const auto &root : m_watchedRoots)
+  {
+    if (URIUtils::PathHasParent(path, root))
+      return root;
+  }
+  return "";
+}
+
+void CInotifyWatcher::DropRoot(const std::string &root)
+{
+  CLog::Log(LOGDEBUG, "CInotifyWatcher: no longer watching %s", root.c_str());
+  RemoveWatches(root);
+  m_watchedRoots.erase(root);
+  m_callback.OnWatchLost(root);
+
+  // try again with the next roots, e.g. once it is mounted again
+  CSingleLock lock(m_rootsSection);
+  m_rootsChanged = true;
+}
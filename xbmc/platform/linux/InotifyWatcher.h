@@ -0,0 +1,78 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2015 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+#include "utils/IDirectoryWatcher.h"
+
+struct inotify_event;
+
+/*!
+ \brief Watches folders with inotify.
+
+ inotify isn't recursive, so every folder below a root gets its own watch. The number of
+ watches is limited by fs.inotify.max_user_watches; roots that don't fit are reported as lost
+ and left to the scanner. Only changes made through this machine are seen, so changes to a
+ network share mounted here made by another machine are missed.
+ */
+class CInotifyWatcher : public IDirectoryWatcher, private CThread
+{
+public:
+  explicit CInotifyWatcher(IDirectoryWatcherCallback &callback);
+  ~CInotifyWatcher() override;
+
+  void SetRoots(const std::vector<std::string> &roots) override;
+
+protected:
+  void Process() override;
+
+private:
+  void UpdateRoots();
+  void OnEvent(const struct inotify_event *event);
+
+  /*! \brief Watch a folder and everything below it.
+   \param path the folder, with a trailing slash.
+   \param added if given, gets the folders that were watched.
+   \return false if we ran out of watches.
+   */
+  bool AddWatches(const std::string &path, std::vector<std::string> *added = nullptr);
+  void RemoveWatches(const std::string &path);
+  std::string GetRoot(const std::string &path) const;
+  void DropRoot(const std::string &root);
+
+  IDirectoryWatcherCallback &m_callback;
+  int m_fd;
+
+  CCriticalSection m_rootsSection;
+  std::vector<std::string> m_roots;       ///< roots wanted
+  bool m_rootsChanged;
+
+  // used on our thread only
+  std::set<std::string> m_watchedRoots;   ///< roots watched completely
+  std::set<std::string> m_failedRoots;    ///< roots that didn't fit, not retried until they are set again
+  std::map<int, std::string> m_paths;     ///< by watch descriptor
+  std::map<std::string, int> m_watches;   ///< by path
+};
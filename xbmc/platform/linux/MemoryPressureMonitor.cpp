@@ -0,0 +1,114 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MemoryPressureMonitor.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#include "utils/MemoryBudget.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PSI_MEMORY  "/proc/pressure/memory"
+
+// Stall time in a window, in microseconds. Unprivileged processes may only
+// use windows of whole multiples of 2 seconds.
+#define PSI_MODERATE_TRIGGER  "some 200000 2000000"
+#define PSI_CRITICAL_TRIGGER  "full 200000 2000000"
+
+// The caches need some time to fill again, so don't empty them over and over
+#define MODERATE_INTERVAL_MS  30000
+#define CRITICAL_INTERVAL_MS  5000
+
+namespace
+{
+  int OpenTrigger(const char *trigger)
+  {
+    int fd = open(PSI_MEMORY, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+      return -1;
+
+    if (write(fd, trigger, strlen(trigger) + 1) < 0)
+    {
+      close(fd);
+      return -1;
+    }
+
+    return fd;
+  }
+}
+
+CMemoryPressureMonitor::CMemoryPressureMonitor() :
+  CThread("MemoryPressure")
+{
+}
+
+void CMemoryPressureMonitor::Process()
+{
+  struct pollfd fds[2] = { };
+  fds[0].fd = OpenTrigger(PSI_MODERATE_TRIGGER);
+  fds[1].fd = OpenTrigger(PSI_CRITICAL_TRIGGER);
+  fds[0].events = fds[1].events = POLLPRI;
+
+  if (fds[0].fd < 0 || fds[1].fd < 0)
+  {
+    CLog::Log(LOGNOTICE, "CMemoryPressureMonitor: memory pressure can't be watched: %s", strerror(errno));
+  }
+  else
+  {
+    CLog::Log(LOGDEBUG, "CMemoryPressureMonitor: watching %s", PSI_MEMORY);
+
+    XbmcThreads::EndTime moderateTimeout;
+    XbmcThreads::EndTime criticalTimeout;
+
+    while (!m_bStop)
+    {
+      if (poll(fds, 2, 1000) <= 0)
+        continue;
+
+      if ((fds[0].revents | fds[1].revents) & (POLLERR | POLLNVAL))
+      {
+        CLog::Log(LOGERROR, "CMemoryPressureMonitor: watching %s failed", PSI_MEMORY);
+        break;
+      }
+
+      if ((fds[1].revents & POLLPRI) && criticalTimeout.IsTimePast())
+      {
+        CMemoryBudget::GetInstance().OnMemoryPressure(MemoryPressure::CRITICAL);
+        criticalTimeout.Set(CRITICAL_INTERVAL_MS);
+        moderateTimeout.Set(MODERATE_INTERVAL_MS);
+      }
+      else if ((fds[0].revents & POLLPRI) && moderateTimeout.IsTimePast())
+      {
+        CMemoryBudget::GetInstance().OnMemoryPressure(MemoryPressure::MODERATE);
+        moderateTimeout.Set(MODERATE_INTERVAL_MS);
+      }
+    }
+  }
+
+  for (const struct pollfd &fd : fds)
+  {
+    if (fd.fd >= 0)
+      close(fd.fd);
+  }
+}
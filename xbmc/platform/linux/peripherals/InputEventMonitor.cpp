@@ -0,0 +1,370 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "InputEventMonitor.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace PERIPHERALS;
+
+#define INPUT_DIR  "/dev/input/"
+
+// Events read per call, the rest is read on the next one
+#define MAX_EVENTS  64
+
+#define BITS_PER_LONG     (sizeof(unsigned long) * 8)
+#define BITS_SIZE(count)  (((count) + BITS_PER_LONG - 1) / BITS_PER_LONG * sizeof(unsigned long))
+
+namespace
+{
+  std::vector<unsigned long> GetBits(int fd, unsigned int request, unsigned int count)
+  {
+    std::vector<unsigned long> bits(BITS_SIZE(count) / sizeof(unsigned long));
+    if (ioctl(fd, request, bits.data()) < 0)
+      std::fill(bits.begin(), bits.end(), 0);
+    return bits;
+  }
+
+  bool TestBit(const std::vector<unsigned long> &bits, unsigned int bit)
+  {
+    return (bits[bit / BITS_PER_LONG] >> (bit % BITS_PER_LONG)) & 1;
+  }
+
+  // Keyboards and mice wake the input manager, not the peripheral scanner
+  bool IsJoystickButton(unsigned int code)
+  {
+    return (BTN_JOYSTICK <= code && code < BTN_DIGI) ||
+           (BTN_TRIGGER_HAPPY <= code && code <= BTN_TRIGGER_HAPPY40);
+  }
+}
+
+CInputEventMonitor::CInputEventMonitor() :
+  m_wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+}
+
+CInputEventMonitor::~CInputEventMonitor()
+{
+  Close();
+
+  if (m_wakeFd >= 0)
+    close(m_wakeFd);
+}
+
+bool CInputEventMonitor::Open()
+{
+  Close();
+
+  m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+  if (m_epollFd < 0 || m_wakeFd < 0)
+  {
+    CLog::Log(LOGERROR, "PERIPHERALS: Failed to create input event monitor: %s", strerror(errno));
+    Close();
+    return false;
+  }
+
+  struct epoll_event event = { };
+  event.events = EPOLLIN;
+  event.data.fd = m_wakeFd;
+  epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event);
+
+  // udev fixes the permissions after creating the node, so wait for that too
+  m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_inotifyFd >= 0 && inotify_add_watch(m_inotifyFd, INPUT_DIR, IN_CREATE | IN_ATTRIB) >= 0)
+  {
+    event.data.fd = m_inotifyFd;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_inotifyFd, &event);
+  }
+  else
+  {
+    // Without hotplug, devices connected later would only be polled
+    CLog::Log(LOGERROR, "PERIPHERALS: Failed to watch %s: %s", INPUT_DIR, strerror(errno));
+    Close();
+    return false;
+  }
+
+  AddDevices();
+
+  return true;
+}
+
+void CInputEventMonitor::Close()
+{
+  for (const auto &device : m_devices)
+    close(device.first);
+  m_devices.clear();
+
+  if (m_inotifyFd >= 0)
+    close(m_inotifyFd);
+  if (m_epollFd >= 0)
+    close(m_epollFd);
+
+  m_inotifyFd = -1;
+  m_epollFd = -1;
+}
+
+bool CInputEventMonitor::Wait(unsigned int timeoutMs)
+{
+  if (m_epollFd < 0)
+    return false;
+
+  struct epoll_event events[16];
+  int count = epoll_wait(m_epollFd, events, 16, static_cast<int>(timeoutMs));
+
+  bool bInput = false;
+
+  for (int i = 0; i < count; i++)
+  {
+    const int fd = events[i].data.fd;
+
+    if (fd == m_wakeFd)
+    {
+      uint64_t value;
+      if (read(m_wakeFd, &value, sizeof(value)) < 0)
+      {
+        // Nothing to do, another wakeup raced us
+      }
+    }
+    else if (fd == m_inotifyFd)
+    {
+      ReadHotplug();
+    }
+    else
+    {
+      auto it = m_devices.find(fd);
+      if (it == m_devices.end())
+        continue;
+
+      if ((events[i].events & (EPOLLERR | EPOLLHUP)) || !ReadDevice(fd, it->second))
+        RemoveDevice(fd);
+      else
+        bInput = true;
+    }
+  }
+
+  return bInput;
+}
+
+void CInputEventMonitor::Interrupt()
+{
+  if (m_wakeFd >= 0)
+  {
+    const uint64_t value = 1;
+    if (write(m_wakeFd, &value, sizeof(value)) < 0)
+    {
+      // The counter is full, Wait() returns anyway
+    }
+  }
+}
+
+bool CInputEventMonitor::IsHeld() const
+{
+  for (const auto &device : m_devices)
+  {
+    if (!device.second.pressedButtons.empty())
+      return true;
+
+    for (const auto &axis : device.second.axes)
+    {
+      if (axis.second.deflected)
+        return true;
+    }
+  }
+
+  return false;
+}
+
+void CInputEventMonitor::AddDevices()
+{
+  DIR *dir = opendir(INPUT_DIR);
+  if (dir == nullptr)
+    return;
+
+  while (struct dirent *entry = readdir(dir))
+  {
+    if (StringUtils::StartsWith(entry->d_name, "event"))
+      AddDevice(std::string(INPUT_DIR) + entry->d_name);
+  }
+
+  closedir(dir);
+}
+
+void CInputEventMonitor::AddDevice(const std::string &path)
+{
+  for (const auto &device : m_devices)
+  {
+    if (device.second.path == path)
+      return;
+  }
+
+  int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0)
+    return;
+
+  const std::vector<unsigned long> keyBits = GetBits(fd, EVIOCGBIT(EV_KEY, BITS_SIZE(KEY_CNT)), KEY_CNT);
+
+  bool bJoystick = false;
+  for (unsigned int code = BTN_JOYSTICK; code < KEY_CNT && !bJoystick; code++)
+    bJoystick = IsJoystickButton(code) && TestBit(keyBits, code);
+
+  if (!bJoystick)
+  {
+    close(fd);
+    return;
+  }
+
+  Device device;
+  device.path = path;
+
+  const std::vector<unsigned long> absBits = GetBits(fd, EVIOCGBIT(EV_ABS, BITS_SIZE(ABS_CNT)), ABS_CNT);
+  for (unsigned int code = 0; code < ABS_CNT; code++)
+  {
+    struct input_absinfo info;
+    if (!TestBit(absBits, code) || ioctl(fd, EVIOCGABS(code), &info) < 0 || info.maximum <= info.minimum)
+      continue;
+
+    Axis axis;
+    axis.deadzone = std::max(info.flat, (info.maximum - info.minimum) / 8);
+
+    // Triggers rest at their minimum, sticks and hats in the center
+    if (info.value - info.minimum <= axis.deadzone)
+      axis.rest = info.minimum;
+    else
+      axis.rest = info.minimum + (info.maximum - info.minimum + 1) / 2;
+
+    axis.deflected = false;
+    device.axes[code] = axis;
+  }
+
+  SyncState(fd, device);
+
+  struct epoll_event event = { };
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+  {
+    close(fd);
+    return;
+  }
+
+  CLog::Log(LOGDEBUG, "PERIPHERALS: Monitoring input events of %s", path.c_str());
+
+  m_devices[fd] = std::move(device);
+}
+
+void CInputEventMonitor::RemoveDevice(int fd)
+{
+  auto it = m_devices.find(fd);
+  if (it == m_devices.end())
+    return;
+
+  CLog::Log(LOGDEBUG, "PERIPHERALS: Stopped monitoring input events of %s", it->second.path.c_str());
+
+  epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+  close(fd);
+  m_devices.erase(it);
+}
+
+bool CInputEventMonitor::ReadDevice(int fd, Device &device)
+{
+  struct input_event events[MAX_EVENTS];
+
+  ssize_t bytes = read(fd, events, sizeof(events));
+  if (bytes < 0)
+    return errno == EAGAIN || errno == EINTR;
+
+  const size_t count = static_cast<size_t>(bytes) / sizeof(struct input_event);
+  for (size_t i = 0; i < count; i++)
+  {
+    const struct input_event &event = events[i];
+
+    if (event.type == EV_KEY && IsJoystickButton(event.code))
+    {
+      if (event.value == 0)
+        device.pressedButtons.erase(event.code);
+      else
+        device.pressedButtons.insert(event.code);
+    }
+    else if (event.type == EV_ABS)
+    {
+      auto it = device.axes.find(event.code);
+      if (it != device.axes.end())
+        it->second.deflected = std::abs(event.value - it->second.rest) > it->second.deadzone;
+    }
+    else if (event.type == EV_SYN && event.code == SYN_DROPPED)
+    {
+      SyncState(fd, device);
+    }
+  }
+
+  return true;
+}
+
+void CInputEventMonitor::ReadHotplug()
+{
+  // Events are read into it directly, so align it like them
+  char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+  ssize_t len;
+  while ((len = read(m_inotifyFd, buffer, sizeof(buffer))) > 0)
+  {
+    for (char *ptr = buffer; ptr < buffer + len;)
+    {
+      const struct inotify_event *event = reinterpret_cast<const struct inotify_event*>(ptr);
+      if (event->len > 0 && StringUtils::StartsWith(event->name, "event"))
+        AddDevice(std::string(INPUT_DIR) + event->name);
+      ptr += sizeof(struct inotify_event) + event->len;
+    }
+  }
+}
+
+void CInputEventMonitor::SyncState(int fd, Device &device)
+{
+  const std::vector<unsigned long> keyState = GetBits(fd, EVIOCGKEY(BITS_SIZE(KEY_CNT)), KEY_CNT);
+
+  device.pressedButtons.clear();
+  for (unsigned int code = BTN_JOYSTICK; code < KEY_CNT; code++)
+  {
+    if (IsJoystickButton(code) && TestBit(keyState, code))
+      device.pressedButtons.insert(code);
+  }
+
+  for (auto &axis : device.axes)
+  {
+    struct input_absinfo info;
+    if (ioctl(fd, EVIOCGABS(axis.first), &info) == 0)
+      axis.second.deflected = std::abs(info.value - axis.second.rest) > axis.second.deadzone;
+  }
+}
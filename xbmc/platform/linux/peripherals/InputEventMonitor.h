@@ -0,0 +1,100 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <set>
+#include <string>
+
+namespace PERIPHERALS
+{
+  /*!
+   * \brief Wakes the event scanner when a joystick on /dev/input reports input
+   *
+   * The peripheral add-ons read the devices themselves, so the events read
+   * here are only used to tell if input arrived and if a button or stick is
+   * still held. Every open evdev descriptor gets its own copy of the events,
+   * so reading them doesn't take them from the add-ons.
+   *
+   * Only Interrupt() may be called from another thread.
+   */
+  class CInputEventMonitor
+  {
+  public:
+    CInputEventMonitor();
+    ~CInputEventMonitor();
+
+    /*!
+     * \brief Open the joysticks on /dev/input and watch for new ones
+     *
+     * \return false if the monitor can't be used, e.g. if /dev/input can't
+     *         be watched for hotplugged devices
+     */
+    bool Open();
+    void Close();
+
+    /*!
+     * \brief Wait for input, Interrupt() or the timeout
+     *
+     * \return true if a joystick reported input
+     */
+    bool Wait(unsigned int timeoutMs);
+
+    /*!
+     * \brief Let Wait() return now
+     */
+    void Interrupt();
+
+    /*!
+     * \brief A button or a stick is held, its state has to be scanned
+     *        although no events arrive
+     */
+    bool IsHeld() const;
+
+    bool IsOpen() const { return m_epollFd >= 0; }
+
+  private:
+    struct Axis
+    {
+      int rest;
+      int deadzone;
+      bool deflected;
+    };
+
+    struct Device
+    {
+      std::string path;
+      std::set<unsigned int> pressedButtons;
+      std::map<unsigned int, Axis> axes;
+    };
+
+    void AddDevices();
+    void AddDevice(const std::string &path);
+    void RemoveDevice(int fd);
+    bool ReadDevice(int fd, Device &device);
+    void ReadHotplug();
+    void SyncState(int fd, Device &device);
+
+    int m_epollFd = -1;
+    const int m_wakeFd; // Lives as long as we do, for Interrupt()
+    int m_inotifyFd = -1;
+    std::map<int, Device> m_devices; // by descriptor
+  };
+}
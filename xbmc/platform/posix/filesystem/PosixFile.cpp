@@ -37,8 +37,16 @@
 
 using namespace XFILE;
 
+// window the kernel is asked to read ahead of the reader, in addition to
+// its own read-ahead which is tuned for small files
+static const int64_t PREFETCH_SIZE = 8 * 1024 * 1024;
+// amount of data written before it's handed to writeback when bypassing
+// the page cache
+static const int64_t WRITEBACK_SIZE = 4 * 1024 * 1024;
+
 CPosixFile::CPosixFile() :
-  m_fd(-1), m_filePos(-1), m_lastDropPos(-1), m_allowWrite(false)
+  m_fd(-1), m_filePos(-1), m_lastDropPos(-1), m_allowWrite(false),
+  m_prefetchPos(0), m_bypassPageCache(false), m_writeBackPos(0), m_droppedPos(0)
 { }
 
 CPosixFile::~CPosixFile()
@@ -69,7 +77,12 @@ bool CPosixFile::Open(const CURL& url)
   
   m_fd = open(filename.c_str(), O_RDONLY, S_IRUSR | S_IRGRP | S_IROTH);
   m_filePos = 0;
-  
+
+#if defined(HAVE_POSIX_FADVISE)
+  if (m_fd != -1)
+    posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
   return m_fd != -1;
 }
 
@@ -101,6 +114,10 @@ void CPosixFile::Close()
     m_filePos = -1;
     m_lastDropPos = -1;
     m_allowWrite = false;
+    m_prefetchPos = 0;
+    m_bypassPageCache = false;
+    m_writeBackPos = 0;
+    m_droppedPos = 0;
   }
 }
 
@@ -132,15 +149,26 @@ ssize_t CPosixFile::Read(void* lpBuf, size_t uiBufSize)
     // are now, to make sure the file doesn't displace everything else.
     // However, never throw out the first 16 MB of the file, as it might
     // be the header etc., and never ask the OS to drop in chunks of
-    // less than 1 MB.
-    const int64_t end_drop = m_filePos - 16 * 1024 * 1024;
-    if (end_drop >= 17 * 1024 * 1024)
+    // less than 1 MB. Data read while bypassing the page cache is
+    // dropped right away.
+    const int64_t keep = m_bypassPageCache ? 0 : 16 * 1024 * 1024;
+    const int64_t end_drop = m_filePos - keep;
+    if (end_drop >= keep + 1 * 1024 * 1024)
     {
-      const int64_t start_drop = std::max<int64_t>(m_lastDropPos, 16 * 1024 * 1024);
+      const int64_t start_drop = std::max<int64_t>(m_lastDropPos, keep);
       if (end_drop - start_drop >= 1 * 1024 * 1024 &&
           posix_fadvise(m_fd, start_drop, end_drop - start_drop, POSIX_FADV_DONTNEED) == 0)
         m_lastDropPos = end_drop;
     }
+
+    // Have the next window read from disk while the current one is
+    // consumed, so slow disks keep up with large files.
+    if (m_filePos >= m_prefetchPos - PREFETCH_SIZE / 2)
+    {
+      const int64_t start_prefetch = std::max(m_prefetchPos, m_filePos);
+      if (posix_fadvise(m_fd, start_prefetch, m_filePos + PREFETCH_SIZE - start_prefetch, POSIX_FADV_WILLNEED) == 0)
+        m_prefetchPos = m_filePos + PREFETCH_SIZE;
+    }
 #endif
   }
 
@@ -167,8 +195,25 @@ ssize_t CPosixFile::Write(const void* lpBuf, size_t uiBufSize)
   }
   
   if (m_filePos >= 0)
+  {
     m_filePos += res; // if m_filePos was known - update it
-  
+#if defined(HAVE_SYNC_FILE_RANGE) && defined(HAVE_POSIX_FADVISE)
+    if (m_bypassPageCache && m_filePos - m_writeBackPos >= WRITEBACK_SIZE)
+    {
+      // Like O_DIRECT but without its alignment requirements: start writing
+      // back the new window, then wait for the window before, which should
+      // be on disk by now, and drop it from the page cache.
+      sync_file_range(m_fd, m_writeBackPos, m_filePos - m_writeBackPos, SYNC_FILE_RANGE_WRITE);
+      if (m_writeBackPos > m_droppedPos &&
+          sync_file_range(m_fd, m_droppedPos, m_writeBackPos - m_droppedPos,
+                          SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER) == 0)
+        posix_fadvise(m_fd, m_droppedPos, m_writeBackPos - m_droppedPos, POSIX_FADV_DONTNEED);
+      m_droppedPos = m_writeBackPos;
+      m_writeBackPos = m_filePos;
+    }
+#endif
+  }
+
   return res;
 }
 
@@ -189,7 +234,12 @@ int64_t CPosixFile::Seek(int64_t iFilePosition, int iWhence /* = SEEK_SET*/)
   
   m_filePos = lseek(m_fd, filePosOffT, iWhence);
 #endif // !TARGET_ANDROID
-  
+
+  // read-ahead and writeback start over at the new position
+  m_prefetchPos = 0;
+  if (m_filePos >= 0)
+    m_writeBackPos = m_droppedPos = m_filePos;
+
   return m_filePos;
 }
 
@@ -278,6 +328,19 @@ int CPosixFile::IoControl(EIoControl request, void* param)
         return 0; // size of file is 1 byte or more and seeking not possible
     }
   }
+  else if (request == IOCTRL_BYPASS_PAGECACHE)
+  {
+#if defined(HAVE_POSIX_FADVISE)
+    if (!param)
+      return -1;
+    m_bypassPageCache = *static_cast<bool*>(param);
+    if (m_filePos >= 0)
+      m_writeBackPos = m_droppedPos = m_filePos;
+    return 0;
+#else
+    return -1;
+#endif
+  }
   
   return -1;
 }
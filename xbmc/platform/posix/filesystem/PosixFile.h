@@ -54,6 +54,10 @@ namespace XFILE
     int64_t m_filePos;
     int64_t m_lastDropPos;
     bool    m_allowWrite;
+    int64_t m_prefetchPos; // end of the window the kernel was asked to read ahead
+    bool    m_bypassPageCache;
+    int64_t m_writeBackPos; // start of the data written but not handed to writeback
+    int64_t m_droppedPos; // start of the data handed to writeback but not dropped
   };
   
 }
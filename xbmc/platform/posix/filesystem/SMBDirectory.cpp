@@ -195,6 +195,7 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
         if (hidden)
           pItem->SetProperty("file:hidden", true);
         items.Add(pItem);
+        PublishItems(items);
       }
       else
       {
@@ -206,6 +207,7 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
         if (hidden)
           pItem->SetProperty("file:hidden", true);
         items.Add(pItem);
+        PublishItems(items);
       }
     }
   }
@@ -62,6 +62,12 @@ SMBCSRV* xb_smbc_cache(SMBCCTX* c, const char* server, const char* share, const
 
 bool CSMB::IsFirstInit = true;
 
+// CheckIfIdle() is called twice a second
+static unsigned int GetIdleTicks()
+{
+  return g_advancedSettings.m_sambaidletimeout * 2;
+}
+
 CSMB::CSMB()
 {
   m_context = NULL;
@@ -230,7 +236,7 @@ void CSMB::Init()
       m_context = NULL;
     }
   }
-  m_IdleTimeout = 180;
+  m_IdleTimeout = GetIdleTicks();
 }
 
 std::string CSMB::URLEncode(const CURL &url)
@@ -289,7 +295,7 @@ void CSMB::CheckIfIdle()
 /* We check if there are open connections. This is done without a lock to not halt the mainthread. It should be thread safe as
    worst case scenario is that m_OpenConnections could read 0 and then changed to 1 if this happens it will enter the if wich will lead to another check, wich is locked.  */
   if (m_OpenConnections == 0)
-  { /* I've set the the maximum IDLE time to be 1 min and 30 sec. */
+  { /* the connections stay around for <samba><idletimeout>, so files opened from a listing reuse them */
     CSingleLock lock(*this);
     if (m_OpenConnections == 0 /* check again - when locked */ && m_context != NULL)
     {
@@ -308,9 +314,8 @@ void CSMB::CheckIfIdle()
 
 void CSMB::SetActivityTime()
 {
-  /* Since we get called every 500ms from ProcessSlow we limit the tick count to 180 */
-  /* That means we have 2 ticks per second which equals 180/2 == 90 seconds */
-  m_IdleTimeout = 180;
+  /* Since we get called every 500ms from ProcessSlow we count 2 ticks per second */
+  m_IdleTimeout = GetIdleTicks();
 }
 
 /* The following two function is used to keep track on how many Opened files/directories there are.
@@ -326,7 +331,7 @@ void CSMB::AddIdleConnection()
   m_OpenConnections--;
   /* If we close a file we reset the idle timer so that we don't have any wierd behaviours if a user
      leaves the movie paused for a long while and then press stop */
-  m_IdleTimeout = 180;
+  m_IdleTimeout = GetIdleTicks();
 }
 
 CSMB smb;
@@ -667,6 +672,13 @@ std::string CSMBFile::GetAuthenticatedPath(const CURL &url)
   return smb.URLEncode(authURL);
 }
 
+int CSMBFile::GetChunkSize()
+{
+  // libsmbclient keeps several requests of the negotiated maximum size in
+  // flight for a large read, so the read size sets the pipeline depth
+  return g_advancedSettings.m_sambareadsize * 1024;
+}
+
 int CSMBFile::IoControl(EIoControl request, void* param)
 {
   if (request == IOCTRL_SEEK_POSSIBLE)
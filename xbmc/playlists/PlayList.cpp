@@ -32,6 +32,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -84,16 +85,8 @@ void CPlayList::AnnounceAdd(const CFileItemPtr& item, int pos)
   ANNOUNCEMENT::CAnnouncementManager::GetInstance().Announce(ANNOUNCEMENT::Playlist, "xbmc", "OnAdd", item, data);
 }
 
-void CPlayList::Add(const CFileItemPtr &item, int iPosition, int iOrder)
+void CPlayList::PrepareItem(const CFileItemPtr &item)
 {
-  int iOldSize = size();
-  if (iPosition < 0 || iPosition >= iOldSize)
-    iPosition = iOldSize;
-  if (iOrder < 0 || iOrder >= iOldSize)
-    item->m_iprogramCount = iOldSize;
-  else
-    item->m_iprogramCount = iOrder;
-
   // increment the playable counter
   item->ClearProperty("unplayable");
   if (m_iPlayableItems < 0)
@@ -103,6 +96,19 @@ void CPlayList::Add(const CFileItemPtr &item, int iPosition, int iOrder)
 
   // set 'IsPlayable' property - needed for properly handling plugin:// URLs
   item->SetProperty("IsPlayable", true);
+}
+
+void CPlayList::Add(const CFileItemPtr &item, int iPosition, int iOrder)
+{
+  int iOldSize = size();
+  if (iPosition < 0 || iPosition >= iOldSize)
+    iPosition = iOldSize;
+  if (iOrder < 0 || iOrder >= iOldSize)
+    item->m_iprogramCount = iOldSize;
+  else
+    item->m_iprogramCount = iOrder;
+
+  PrepareItem(item);
 
   //CLog::Log(LOGDEBUG,"%s item:(%02i/%02i)[%s]", __FUNCTION__, iPosition, item->m_iprogramCount, item->GetPath().c_str());
   if (iPosition == iOldSize)
@@ -118,6 +124,37 @@ void CPlayList::Add(const CFileItemPtr &item, int iPosition, int iOrder)
   AnnounceAdd(item, iPosition);
 }
 
+void CPlayList::InsertItems(std::vector<CFileItemPtr> items, int iPosition)
+{
+  // out of bounds so just add to the end
+  if (iPosition < 0 || iPosition >= size())
+  {
+    for (const auto &item : items)
+      Add(item, -1, -1);
+    return;
+  }
+
+  // the items get the orders of their positions, so move the orders of the
+  // items behind them out of the way. Same as inserting one by one, but the
+  // list is only shifted and renumbered once.
+  const int count = static_cast<int>(items.size());
+  for (ivecItems it = m_vecItems.begin() + iPosition; it != m_vecItems.end(); ++it)
+  {
+    if ((*it)->m_iprogramCount >= iPosition)
+      (*it)->m_iprogramCount += count;
+  }
+
+  for (int i = 0; i < count; i++)
+  {
+    items[i]->m_iprogramCount = iPosition + i;
+    PrepareItem(items[i]);
+  }
+  m_vecItems.insert(m_vecItems.begin() + iPosition, items.begin(), items.end());
+
+  for (int i = 0; i < count; i++)
+    AnnounceAdd(items[i], iPosition + i);
+}
+
 void CPlayList::Add(const CFileItemPtr &item)
 {
   Add(item, -1, -1);
@@ -137,33 +174,16 @@ void CPlayList::Add(const CFileItemList& items)
 
 void CPlayList::Insert(const CPlayList& playlist, int iPosition /* = -1 */)
 {
-  // out of bounds so just add to the end
-  int iSize = size();
-  if (iPosition < 0 || iPosition >= iSize)
-  {
-    Add(playlist);
-    return;
-  }
-  for (int i = 0; i < (int)playlist.size(); i++)
-  {
-    int iPos = iPosition + i;
-    Add(playlist[i], iPos, iPos);
-  }
+  InsertItems(playlist.m_vecItems, iPosition);
 }
 
 void CPlayList::Insert(const CFileItemList& items, int iPosition /* = -1 */)
 {
-  // out of bounds so just add to the end
-  int iSize = size();
-  if (iPosition < 0 || iPosition >= iSize)
-  {
-    Add(items);
-    return;
-  }
-  for (int i = 0; i < (int)items.Size(); i++)
-  {
-    Add(items[i], iPosition + i, iPosition + i);
-  }
+  std::vector<CFileItemPtr> vecItems;
+  vecItems.reserve(items.Size());
+  for (int i = 0; i < items.Size(); i++)
+    vecItems.push_back(items[i]);
+  InsertItems(std::move(vecItems), iPosition);
 }
 
 void CPlayList::Insert(const CFileItemPtr &item, int iPosition /* = -1 */)
@@ -305,27 +325,38 @@ const std::string& CPlayList::GetName() const
 
 void CPlayList::Remove(const std::string& strFileName)
 {
-  int iOrder = -1;
-  int position = 0;
-  ivecItems it;
-  it = m_vecItems.begin();
-  while (it != m_vecItems.end() )
+  RemoveIf([&strFileName](const CFileItemPtr &item) { return item->GetPath() == strFileName; });
+}
+
+int CPlayList::RemoveIf(const std::function<bool(const CFileItemPtr&)> &predicate)
+{
+  std::vector<int> removedOrders;
+  ivecItems kept = m_vecItems.begin();
+  for (ivecItems it = m_vecItems.begin(); it != m_vecItems.end(); ++it)
   {
-    CFileItemPtr item = *it;
-    if (item->GetPath() == strFileName)
+    if (predicate(*it))
     {
-      iOrder = item->m_iprogramCount;
-      it = m_vecItems.erase(it);
-      AnnounceRemove(position);
-      //CLog::Log(LOGDEBUG,"PLAYLIST, removing item at order %i", iPos);
+      removedOrders.push_back((*it)->m_iprogramCount);
+      // the position it had when removed, as if they were removed one by one
+      AnnounceRemove(static_cast<int>(kept - m_vecItems.begin()));
     }
     else
+      *kept++ = std::move(*it);
+  }
+  m_vecItems.erase(kept, m_vecItems.end());
+
+  // close the gaps in the orders in one go
+  if (!removedOrders.empty())
+  {
+    std::sort(removedOrders.begin(), removedOrders.end());
+    for (const auto &item : m_vecItems)
     {
-      ++position;
-      ++it;
+      auto gaps = std::lower_bound(removedOrders.begin(), removedOrders.end(), item->m_iprogramCount);
+      item->m_iprogramCount -= static_cast<int>(gaps - removedOrders.begin());
     }
   }
-  DecrementOrder(iOrder);
+
+  return static_cast<int>(removedOrders.size());
 }
 
 int CPlayList::FindOrder(int iOrder) const
@@ -354,36 +385,7 @@ void CPlayList::Remove(int position)
 
 int CPlayList::RemoveDVDItems()
 {
-  std::vector <std::string> vecFilenames;
-
-  // Collect playlist items from DVD share
-  ivecItems it;
-  it = m_vecItems.begin();
-  while (it != m_vecItems.end() )
-  {
-    CFileItemPtr item = *it;
-    if ( item->IsCDDA() || item->IsOnDVD() )
-    {
-      vecFilenames.push_back( item->GetPath() );
-    }
-    ++it;
-  }
-
-  // Delete them from playlist
-  int nFileCount = vecFilenames.size();
-  if ( nFileCount )
-  {
-    std::vector <std::string>::iterator it;
-    it = vecFilenames.begin();
-    while (it != vecFilenames.end() )
-    {
-      std::string& strFilename = *it;
-      Remove( strFilename );
-      ++it;
-    }
-    vecFilenames.erase( vecFilenames.begin(), vecFilenames.end() );
-  }
-  return nFileCount;
+  return RemoveIf([](const CFileItemPtr &item) { return item->IsCDDA() || item->IsOnDVD(); });
 }
 
 bool CPlayList::Swap(int position1, int position2)
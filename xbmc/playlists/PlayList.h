@@ -20,6 +20,7 @@
  */
 
 #include "FileItem.h"
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -86,6 +87,13 @@ protected:
 
 private:
   void Add(const CFileItemPtr& item, int iPosition, int iOrderOffset);
+  void InsertItems(std::vector<CFileItemPtr> items, int iPosition); // a copy, the items may come from this playlist
+  void PrepareItem(const CFileItemPtr &item);
+
+  /*! \brief Remove the items a predicate is true for in a single pass
+   \return the number of items removed
+   */
+  int RemoveIf(const std::function<bool(const CFileItemPtr&)> &predicate);
   void DecrementOrder(int iOrder);
   void IncrementOrder(int iPosition, int iOrder);
 
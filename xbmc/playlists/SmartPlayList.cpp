@@ -19,9 +19,11 @@
  */
 
 #include <cstdlib>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <typeinfo>
 #include <vector>
 
 #include "SmartPlayList.h"
@@ -30,6 +32,8 @@
 #include "filesystem/File.h"
 #include "filesystem/SmartPlaylistDirectory.h"
 #include "guilib/LocalizeStrings.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/DatabaseUtils.h"
 #include "utils/JSONVariantParser.h"
 #include "utils/JSONVariantWriter.h"
@@ -43,6 +47,16 @@
 
 using namespace XFILE;
 
+// The cache is cleared when it holds more clauses
+#define MAX_CACHED_WHERE_CLAUSES 100
+
+namespace
+{
+  // WHERE clauses by database, playlist type and rules
+  CCriticalSection g_whereClauseSection;
+  std::map<std::string, std::string> g_whereClauses;
+}
+
 typedef struct
 {
   char string[17];
@@ -1027,6 +1041,26 @@ std::string CSmartPlaylistRuleCombination::GetWhereClause(const CDatabase &db, c
   return rule;
 }
 
+bool CSmartPlaylistRuleCombination::IsCacheable() const
+{
+  for (const auto &combination : m_combinations)
+  {
+    std::shared_ptr<CSmartPlaylistRuleCombination> combo = std::static_pointer_cast<CSmartPlaylistRuleCombination>(combination);
+    if (combo && !combo->IsCacheable())
+      return false;
+  }
+
+  for (const auto &rule : m_rules)
+  {
+    if (rule->m_field == FieldPlaylist ||
+        rule->m_operator == CDatabaseQueryRule::OPERATOR_IN_THE_LAST ||
+        rule->m_operator == CDatabaseQueryRule::OPERATOR_NOT_IN_THE_LAST)
+      return false;
+  }
+
+  return true;
+}
+
 void CSmartPlaylistRuleCombination::GetVirtualFolders(const std::string& strType, std::vector<std::string> &virtualFolders) const
 {
   for (CDatabaseQueryRuleCombinations::const_iterator it = m_combinations.begin(); it != m_combinations.end(); ++it)
@@ -1430,7 +1464,31 @@ bool CSmartPlaylist::IsMusicType(const std::string &type)
 
 std::string CSmartPlaylist::GetWhereClause(const CDatabase &db, std::set<std::string> &referencedPlaylists) const
 {
-  return m_ruleCombination.GetWhereClause(db, GetType(), referencedPlaylists);
+  if (!IsCacheable())
+    return m_ruleCombination.GetWhereClause(db, GetType(), referencedPlaylists);
+
+  // the fields differ between the databases, the escaping between their backends
+  CVariant rules(CVariant::VariantTypeObject);
+  std::string key;
+  if (!m_ruleCombination.Save(rules) || !CJSONVariantWriter::Write(rules, key, true))
+    return m_ruleCombination.GetWhereClause(db, GetType(), referencedPlaylists);
+  key = std::string(typeid(db).name()) + db.PrepareSQL("%s", "'\\") + "|" + GetType() + "|" + key;
+
+  {
+    CSingleLock lock(g_whereClauseSection);
+    auto it = g_whereClauses.find(key);
+    if (it != g_whereClauses.end())
+      return it->second;
+  }
+
+  std::string whereClause = m_ruleCombination.GetWhereClause(db, GetType(), referencedPlaylists);
+
+  CSingleLock lock(g_whereClauseSection);
+  if (g_whereClauses.size() >= MAX_CACHED_WHERE_CLAUSES)
+    g_whereClauses.clear();
+  g_whereClauses[key] = whereClause;
+
+  return whereClause;
 }
 
 void CSmartPlaylist::GetVirtualFolders(std::vector<std::string> &virtualFolders) const
@@ -1486,6 +1544,11 @@ bool CSmartPlaylist::CheckTypeCompatibility(const std::string &typeLeft, const s
   return false;
 }
 
+bool CSmartPlaylist::IsCacheable() const
+{
+  return m_ruleCombination.IsCacheable();
+}
+
 CDatabaseQueryRule *CSmartPlaylist::CreateRule() const
 {
   return new CSmartPlaylistRule();
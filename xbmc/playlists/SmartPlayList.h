@@ -92,6 +92,12 @@ public:
   void GetVirtualFolders(const std::string& strType,
                          std::vector<std::string> &virtualFolders) const;
 
+  /*!
+   \brief Whether the WHERE clause only depends on the rules, i.e. not on the
+   current time or on other playlists
+   */
+  bool IsCacheable() const;
+
   void AddRule(const CSmartPlaylistRule &rule);
 };
 
@@ -162,6 +168,12 @@ public:
 
   bool IsEmpty(bool ignoreSortAndLimit = true) const;
 
+  /*!
+   \brief Whether the WHERE clause and the items of the playlist only depend
+   on its rules and the library, see CSmartPlaylistRuleCombination::IsCacheable()
+   */
+  bool IsCacheable() const;
+
   // rule creation
   CDatabaseQueryRule *CreateRule() const override;
   CDatabaseQueryRuleCombination *CreateCombination() const override;
@@ -287,7 +287,7 @@ int CPVRDatabase::Get(CPVRChannelGroup &results, bool bCompressDB)
                                         CPVRChannelNumber(static_cast<unsigned int>(m_pDS->fv("iChannelNumber").get_asInt()),
                                                           static_cast<unsigned int>(m_pDS->fv("iSubChannelNumber").get_asInt())),
                                         0);
-        results.m_sortedMembers.emplace_back(newMember);
+        results.GetSortedMembersForUpdate().emplace_back(newMember);
         results.m_members.insert(std::make_pair(channel->StorageId(), newMember));
 
         m_pDS->next();
@@ -575,7 +575,7 @@ int CPVRDatabase::Get(CPVRChannelGroup &group, const CPVRChannelGroup &allGroup)
 
     // create a map to speedup data lookup
     std::map<int, CPVRChannelPtr> allChannels;
-    for (const auto& groupMember : allGroup.GetMembers())
+    for (const auto& groupMember : *allGroup.GetMembers())
     {
       allChannels.insert(std::make_pair(groupMember.channel->ChannelID(), groupMember.channel));
     }
@@ -593,7 +593,7 @@ int CPVRDatabase::Get(CPVRChannelGroup &group, const CPVRChannelGroup &allGroup)
                                           CPVRChannelNumber(static_cast<unsigned int>(m_pDS->fv("iChannelNumber").get_asInt()),
                                                             static_cast<unsigned int>(m_pDS->fv("iSubChannelNumber").get_asInt())),
                                           0);
-          group.m_sortedMembers.emplace_back(newMember);
+          group.GetSortedMembersForUpdate().emplace_back(newMember);
           group.m_members.insert(std::make_pair(channel->second->StorageId(), newMember));
           ++iReturn;
         }
@@ -672,7 +672,7 @@ bool CPVRDatabase::PersistGroupMembers(const CPVRChannelGroup &group)
 
   if (group.HasChannels())
   {
-    for (const auto& groupMember : group.m_sortedMembers)
+    for (const auto& groupMember : *group.m_sortedMembers)
     {
       const std::string strWhereClause = PrepareSQL("idChannel = %u AND idGroup = %u AND iChannelNumber = %u AND iSubChannelNumber = %u",
           groupMember.channel->ChannelID(), group.GroupID(), groupMember.channelNumber.GetChannelNumber(), groupMember.channelNumber.GetSubChannelNumber());
@@ -1220,10 +1220,10 @@ namespace PVR
       if (channelGroup)
       {
         // try to start playback of first channel in this group
-        std::vector<PVRChannelGroupMember> groupMembers(channelGroup->GetMembers());
-        if (!groupMembers.empty())
+        const PVR_CHANNEL_GROUP_SORTED_MEMBERS_PTR groupMembers(channelGroup->GetMembers());
+        if (!groupMembers->empty())
         {
-          return SwitchToChannel(CFileItemPtr(new CFileItem((*groupMembers.begin()).channel)), true);
+          return SwitchToChannel(CFileItemPtr(new CFileItem((*groupMembers->begin()).channel)), true);
         }
       }
     }
@@ -1258,10 +1258,10 @@ namespace PVR
     {
       // fallback to first channel
       auto channels(group->GetMembers());
-      if (channels.empty())
+      if (channels->empty())
         return false;
 
-      item = std::make_shared<CFileItem>(channels.front().channel);
+      item = std::make_shared<CFileItem>(channels->front().channel);
     }
 
     CLog::Log(LOGNOTICE, "PVRGUIActions - %s - start playback of channel '%s'", __FUNCTION__, item->GetPVRChannelInfoTag()->ChannelName().c_str());
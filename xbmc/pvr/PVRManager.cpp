@@ -26,6 +26,7 @@
 #include "guilib/LocalizeStrings.h"
 #include "interfaces/AnnouncementManager.h"
 #include "messaging/ApplicationMessenger.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "threads/SystemClock.h"
 #include "utils/JobManager.h"
@@ -139,6 +140,7 @@ CPVRManager::CPVRManager(void) :
     m_guiActions(new CPVRGUIActions),
     m_database(new CPVRDatabase),
     m_bFirstStart(true),
+    m_bWarmStart(false),
     m_bEpgsCreated(false),
     m_managerState(ManagerStateStopped),
     m_parentalTimer(new CStopWatch),
@@ -396,6 +398,7 @@ void CPVRManager::Process(void)
 {
   m_addons->Continue();
   m_database->Open();
+  m_bWarmStart = false;
 
   /* load the pvr data from the db and clients if it's not already loaded */
   XbmcThreads::EndTime progressTimeout(30000); // 30 secs
@@ -450,6 +453,10 @@ void CPVRManager::Process(void)
 
       /* try to play channel on startup */
       TriggerPlayChannelOnStartup();
+
+      /* started with what the database had, catch up with the clients */
+      if (m_bWarmStart)
+        UpdateComponentsFromClients();
     }
     /* execute the next pending jobs if there are any */
     try
@@ -521,6 +528,9 @@ void CPVRManager::OnWake()
 
 bool CPVRManager::LoadComponents(CPVRGUIProgressHandler* progressHandler)
 {
+  if (g_advancedSettings.m_bPVRWarmStart && LoadComponentsFromDatabase())
+    return true;
+
   /* load at least one client */
   while (IsInitialising() && m_addons && !m_addons->HasCreatedClients())
     Sleep(50);
@@ -562,6 +572,45 @@ bool CPVRManager::LoadComponents(CPVRGUIProgressHandler* progressHandler)
   return true;
 }
 
+bool CPVRManager::LoadComponentsFromDatabase(void)
+{
+  if (!m_channelGroups->Load(false) || !IsInitialising())
+    return false;
+
+  if (m_channelGroups->GetGroupAllTV()->Size() == 0 && m_channelGroups->GetGroupAllRadio()->Size() == 0)
+  {
+    CLog::Log(LOGDEBUG, "PVRManager - %s - no channels in the database, loading from the clients", __FUNCTION__);
+    m_channelGroups->Unload();
+    return false;
+  }
+
+  CLog::Log(LOGDEBUG, "PVRManager - %s - loaded channel groups from the database, clients are updated once started", __FUNCTION__);
+  m_bWarmStart = true;
+
+  SetChanged();
+  NotifyObservers(ObservableMessageChannelGroupsLoaded);
+  return true;
+}
+
+void CPVRManager::UpdateComponentsFromClients(void)
+{
+  while (IsStarted() && !m_addons->HasCreatedClients())
+    Sleep(50);
+
+  if (!IsStarted())
+    return;
+
+  CLog::Log(LOGDEBUG, "PVRManager - %s - updating channel groups, timers and recordings from the clients", __FUNCTION__);
+
+  m_channelGroups->Update();
+  if (IsStarted())
+    m_timers->Load();
+  if (IsStarted())
+    m_recordings->Load();
+
+  m_bWarmStart = false;
+}
+
 void CPVRManager::UnloadComponents()
 {
   m_recordings->Unload();
@@ -462,6 +462,17 @@ namespace PVR
      */
     bool LoadComponents(CPVRGUIProgressHandler* progressHandler);
 
+    /*!
+     * @brief Load the channel groups stored in the database, without waiting for the clients.
+     * @return True if the database had channels, false if the clients have to be asked first.
+     */
+    bool LoadComponentsFromDatabase(void);
+
+    /*!
+     * @brief Update the channel groups loaded by LoadComponentsFromDatabase() from the clients and load timers and recordings.
+     */
+    void UpdateComponentsFromClients(void);
+
     /*!
      * @brief Unload all PVR data (recordings, timers, channelgroups).
      */
@@ -520,6 +531,7 @@ namespace PVR
     CPVRDatabasePtr                 m_database;                    /*!< the database for all PVR related data */
     CCriticalSection                m_critSection;                 /*!< critical section for all changes to this class, except for changes to triggers */
     bool                            m_bFirstStart;                 /*!< true when the PVR manager was started first, false otherwise */
+    bool                            m_bWarmStart;                  /*!< true if started with the data from the database, the clients are asked once started */
     bool                            m_bEpgsCreated;                /*!< true if epg data for channels has been created */
 
     CCriticalSection                m_managerStateMutex;
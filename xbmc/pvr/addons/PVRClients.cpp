@@ -795,11 +795,11 @@ PVR_ERROR CPVRClients::GetTimerTypes(CPVRTimerTypes& results, int iClientId) con
   });
 }
 
-PVR_ERROR CPVRClients::GetRecordings(CPVRRecordings *recordings, bool deleted)
+PVR_ERROR CPVRClients::GetRecordings(CPVRRecordings *recordings, bool deleted, std::vector<int> &failedClients)
 {
   return ForCreatedClients(__FUNCTION__, [recordings, deleted](const CPVRClientPtr &client) {
     return client->GetRecordings(recordings, deleted);
-  });
+  }, failedClients);
 }
 
 PVR_ERROR CPVRClients::RenameRecording(const CPVRRecording &recording)
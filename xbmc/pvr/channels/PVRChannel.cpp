@@ -540,6 +540,7 @@ int CPVRChannel::GetEPG(CFileItemList &results) const
     return -1;
   }
 
+  epg->LoadUntil(CDateTime());
   return epg->Get(results);
 }
 
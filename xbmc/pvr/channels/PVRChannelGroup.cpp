@@ -57,7 +57,8 @@ CPVRChannelGroup::CPVRChannelGroup(void) :
     m_bPreventSortAndRenumber(false),
     m_iLastWatched(0),
     m_bHidden(false),
-    m_iPosition(0)
+    m_iPosition(0),
+    m_sortedMembers(std::make_shared<PVR_CHANNEL_GROUP_SORTED_MEMBERS>())
 {
   OnInit();
 }
@@ -75,7 +76,8 @@ CPVRChannelGroup::CPVRChannelGroup(bool bRadio, unsigned int iGroupId, const std
     m_bPreventSortAndRenumber(false),
     m_iLastWatched(0),
     m_bHidden(false),
-    m_iPosition(0)
+    m_iPosition(0),
+    m_sortedMembers(std::make_shared<PVR_CHANNEL_GROUP_SORTED_MEMBERS>())
 {
   OnInit();
 }
@@ -93,7 +95,8 @@ CPVRChannelGroup::CPVRChannelGroup(const PVR_CHANNEL_GROUP &group) :
     m_bPreventSortAndRenumber(false),
     m_iLastWatched(0),
     m_bHidden(false),
-    m_iPosition(group.iPosition)
+    m_iPosition(group.iPosition),
+    m_sortedMembers(std::make_shared<PVR_CHANNEL_GROUP_SORTED_MEMBERS>())
 {
   OnInit();
 }
@@ -150,7 +153,7 @@ void CPVRChannelGroup::OnInit(void)
   });
 }
 
-bool CPVRChannelGroup::Load(void)
+bool CPVRChannelGroup::Load(bool bUpdateFromClients /* = true */)
 {
   /* make sure this container is empty before loading */
   Unload();
@@ -162,7 +165,7 @@ bool CPVRChannelGroup::Load(void)
   CLog::Log(LOGDEBUG, "PVRChannelGroup - %s - %d channels loaded from the database for group '%s'",
         __FUNCTION__, iChannelCount, m_strGroupName.c_str());
 
-  if (!Update())
+  if (bUpdateFromClients && !Update())
   {
     CLog::Log(LOGERROR, "PVRChannelGroup - %s - failed to update channels", __FUNCTION__);
     return false;
@@ -184,7 +187,8 @@ bool CPVRChannelGroup::Load(void)
 void CPVRChannelGroup::Unload(void)
 {
   CSingleLock lock(m_critSection);
-  m_sortedMembers.clear();
+  m_sortedMembers = std::make_shared<PVR_CHANNEL_GROUP_SORTED_MEMBERS>();
+  m_channelNumberIndex.clear();
   m_members.clear();
   m_failedClientsForChannels.clear();
   m_failedClientsForChannelGroupMembers.clear();
@@ -214,7 +218,8 @@ bool CPVRChannelGroup::SetChannelNumber(const CPVRChannelPtr &channel, const CPV
   bool bReturn(false);
   CSingleLock lock(m_critSection);
 
-  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::iterator it = m_sortedMembers.begin(); it != m_sortedMembers.end(); ++it)
+  PVR_CHANNEL_GROUP_SORTED_MEMBERS &sortedMembers = GetSortedMembersForUpdate();
+  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::iterator it = sortedMembers.begin(); it != sortedMembers.end(); ++it)
   {
     PVRChannelGroupMember& member(*it);
     if (*member.channel == *channel)
@@ -344,14 +349,30 @@ void CPVRChannelGroup::SortByClientChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
   if (!PreventSortAndRenumber())
-    sort(m_sortedMembers.begin(), m_sortedMembers.end(), sortByClientChannelNumber());
+  {
+    PVR_CHANNEL_GROUP_SORTED_MEMBERS &sortedMembers = GetSortedMembersForUpdate();
+    sort(sortedMembers.begin(), sortedMembers.end(), sortByClientChannelNumber());
+  }
 }
 
 void CPVRChannelGroup::SortByChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
   if (!PreventSortAndRenumber())
-    sort(m_sortedMembers.begin(), m_sortedMembers.end(), sortByChannelNumber());
+  {
+    PVR_CHANNEL_GROUP_SORTED_MEMBERS &sortedMembers = GetSortedMembersForUpdate();
+    sort(sortedMembers.begin(), sortedMembers.end(), sortByChannelNumber());
+  }
+}
+
+PVR_CHANNEL_GROUP_SORTED_MEMBERS &CPVRChannelGroup::GetSortedMembersForUpdate(void)
+{
+  /* the list may still be used by whoever got it from GetMembers() */
+  if (m_sortedMembers.use_count() > 1)
+    m_sortedMembers = std::make_shared<PVR_CHANNEL_GROUP_SORTED_MEMBERS>(*m_sortedMembers);
+
+  m_channelNumberIndex.clear();
+  return const_cast<PVR_CHANNEL_GROUP_SORTED_MEMBERS&>(*m_sortedMembers);
 }
 
 bool CPVRChannelGroup::UpdateClientPriorities()
@@ -361,7 +382,7 @@ bool CPVRChannelGroup::UpdateClientPriorities()
 
   CSingleLock lock(m_critSection);
 
-  for (auto& member : m_sortedMembers)
+  for (auto& member : GetSortedMembersForUpdate())
   {
     int iNewPriority = 0;
 
@@ -460,18 +481,27 @@ CPVRChannelNumber CPVRChannelGroup::GetChannelNumber(const CPVRChannelPtr &chann
   return member.channelNumber;
 }
 
+static uint64_t GetChannelNumberKey(const CPVRChannelNumber &channelNumber)
+{
+  return (static_cast<uint64_t>(channelNumber.GetChannelNumber()) << 32) | channelNumber.GetSubChannelNumber();
+}
+
 CFileItemPtr CPVRChannelGroup::GetByChannelNumber(const CPVRChannelNumber &channelNumber) const
 {
-  CFileItemPtr retval;
   CSingleLock lock(m_critSection);
 
-  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers.begin(); !retval && it != m_sortedMembers.end(); ++it)
+  if (m_channelNumberIndex.empty())
   {
-    if ((*it).channelNumber == channelNumber)
-      retval = CFileItemPtr(new CFileItem((*it).channel));
+    /* the first member with a number wins, as with the search through the sorted members this replaces */
+    for (const auto& member : *m_sortedMembers)
+      m_channelNumberIndex.insert(std::make_pair(GetChannelNumberKey(member.channelNumber), member.channel));
   }
 
-  return retval;
+  const auto it = m_channelNumberIndex.find(GetChannelNumberKey(channelNumber));
+  if (it == m_channelNumberIndex.end())
+    return CFileItemPtr();
+
+  return CFileItemPtr(new CFileItem(it->second));
 }
 
 CFileItemPtr CPVRChannelGroup::GetNextChannel(const CPVRChannelPtr &channel) const
@@ -481,14 +511,15 @@ CFileItemPtr CPVRChannelGroup::GetNextChannel(const CPVRChannelPtr &channel) con
   if (channel)
   {
     CSingleLock lock(m_critSection);
-    for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers.begin(); !retval && it != m_sortedMembers.end(); ++it)
+    const PVR_CHANNEL_GROUP_SORTED_MEMBERS &sortedMembers = *m_sortedMembers;
+    for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = sortedMembers.begin(); !retval && it != sortedMembers.end(); ++it)
     {
       if ((*it).channel == channel)
       {
         do
         {
-          if ((++it) == m_sortedMembers.end())
-            it = m_sortedMembers.begin();
+          if ((++it) == sortedMembers.end())
+            it = sortedMembers.begin();
           if ((*it).channel && !(*it).channel->IsHidden())
             retval = std::make_shared<CFileItem>((*it).channel);
         } while (!retval && (*it).channel != channel);
@@ -509,14 +540,15 @@ CFileItemPtr CPVRChannelGroup::GetPreviousChannel(const CPVRChannelPtr &channel)
   if (channel)
   {
     CSingleLock lock(m_critSection);
-    for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_reverse_iterator it = m_sortedMembers.rbegin(); !retval && it != m_sortedMembers.rend(); ++it)
+    const PVR_CHANNEL_GROUP_SORTED_MEMBERS &sortedMembers = *m_sortedMembers;
+    for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_reverse_iterator it = sortedMembers.rbegin(); !retval && it != sortedMembers.rend(); ++it)
     {
       if ((*it).channel == channel)
       {
         do
         {
-          if ((++it) == m_sortedMembers.rend())
-            it = m_sortedMembers.rbegin();
+          if ((++it) == sortedMembers.rend())
+            it = sortedMembers.rbegin();
           if ((*it).channel && !(*it).channel->IsHidden())
             retval = std::make_shared<CFileItem>((*it).channel);
         } while (!retval && (*it).channel != channel);
@@ -529,7 +561,7 @@ CFileItemPtr CPVRChannelGroup::GetPreviousChannel(const CPVRChannelPtr &channel)
   return retval;
 }
 
-PVR_CHANNEL_GROUP_SORTED_MEMBERS CPVRChannelGroup::GetMembers(void) const
+PVR_CHANNEL_GROUP_SORTED_MEMBERS_PTR CPVRChannelGroup::GetMembers(void) const
 {
   CSingleLock lock(m_critSection);
   return m_sortedMembers;
@@ -542,7 +574,7 @@ int CPVRChannelGroup::GetMembers(CFileItemList &results, bool bGroupMembers /* =
 
   CSingleLock lock(channels->m_critSection);
 
-  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = channels->m_sortedMembers.begin(); it != channels->m_sortedMembers.end(); ++it)
+  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = channels->m_sortedMembers->begin(); it != channels->m_sortedMembers->end(); ++it)
   {
     if (bGroupMembers || !IsGroupMember((*it).channel))
     {
@@ -557,7 +589,7 @@ int CPVRChannelGroup::GetMembers(CFileItemList &results, bool bGroupMembers /* =
 void CPVRChannelGroup::GetChannelNumbers(std::vector<std::string>& channelNumbers) const
 {
   CSingleLock lock(m_critSection);
-  for (const auto& member : m_sortedMembers)
+  for (const auto& member : *m_sortedMembers)
     channelNumbers.emplace_back(member.channelNumber.FormattedChannelNumber());
 }
 
@@ -655,7 +687,7 @@ bool CPVRChannelGroup::RemoveDeletedChannels(const CPVRChannelGroup &channels)
   CSingleLock lock(m_critSection);
 
   /* check for deleted channels */
-  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::iterator it = m_sortedMembers.begin(); it != m_sortedMembers.end();)
+  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers->begin(); it != m_sortedMembers->end();)
   {
     CSingleLock lock(channels.m_critSection);
     if (channels.m_members.find((*it).channel->StorageId()) == channels.m_members.end())
@@ -683,19 +715,20 @@ bool CPVRChannelGroup::RemoveDeletedChannels(const CPVRChannelGroup &channels)
 
       //our vector can have been modified during the call to RemoveFromAllGroups
       //make no assumption and search for the value to be removed
-      auto possiblyRemovedGroup = std::find_if(m_sortedMembers.begin(), m_sortedMembers.end(), [&group](const PVRChannelGroupMember& it)
+      PVR_CHANNEL_GROUP_SORTED_MEMBERS &sortedMembers = GetSortedMembersForUpdate();
+      auto possiblyRemovedGroup = std::find_if(sortedMembers.begin(), sortedMembers.end(), [&group](const PVRChannelGroupMember& it)
       {
         return  group.channel == it.channel &&
                 group.channelNumber == it.channelNumber &&
                 group.iClientPriority == it.iClientPriority;
       });
 
-      if (possiblyRemovedGroup != m_sortedMembers.end())
-        m_sortedMembers.erase(possiblyRemovedGroup);
+      if (possiblyRemovedGroup != sortedMembers.end())
+        sortedMembers.erase(possiblyRemovedGroup);
       
       //We have to start over from the beginning, list can have been modified and
       //resorted, there's no safe way to continue where we left of
-      it = m_sortedMembers.begin();
+      it = m_sortedMembers->begin();
       m_bChanged = true;
       bReturn = true;
     }
@@ -749,13 +782,14 @@ bool CPVRChannelGroup::RemoveFromGroup(const CPVRChannelPtr &channel)
   bool bReturn(false);
   CSingleLock lock(m_critSection);
 
-  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::iterator it = m_sortedMembers.begin(); it != m_sortedMembers.end();)
+  PVR_CHANNEL_GROUP_SORTED_MEMBERS &sortedMembers = GetSortedMembersForUpdate();
+  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::iterator it = sortedMembers.begin(); it != sortedMembers.end();)
   {
     if (*channel == *((*it).channel))
     {
       //! @todo notify observers
       m_members.erase((*it).channel->StorageId());
-      it = m_sortedMembers.erase(it);
+      it = sortedMembers.erase(it);
       bReturn = true;
       m_bChanged = true;
       break;
@@ -796,7 +830,7 @@ bool CPVRChannelGroup::AddToGroup(const CPVRChannelPtr &channel, const CPVRChann
 
       PVRChannelGroupMember newMember(realChannel);
       newMember.channelNumber = CPVRChannelNumber(iChannelNumber, channelNumber.GetSubChannelNumber());
-      m_sortedMembers.push_back(newMember);
+      GetSortedMembersForUpdate().push_back(newMember);
       m_members.insert(std::make_pair(realChannel.channel->StorageId(), newMember));
       m_bChanged = true;
 
@@ -896,7 +930,8 @@ bool CPVRChannelGroup::Renumber(void)
   CSingleLock lock(m_critSection);
 
   CPVRChannelNumber currentChannelNumber;
-  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::iterator it = m_sortedMembers.begin(); it != m_sortedMembers.end(); ++it)
+  PVR_CHANNEL_GROUP_SORTED_MEMBERS &sortedMembers = GetSortedMembersForUpdate();
+  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::iterator it = sortedMembers.begin(); it != sortedMembers.end(); ++it)
   {
     if ((*it).channel->IsHidden())
     {
@@ -935,7 +970,7 @@ void CPVRChannelGroup::ResetChannelNumberCache(void)
     return;
 
   /* set all channel numbers on members of this group */
-  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::iterator it = m_sortedMembers.begin(); it != m_sortedMembers.end(); ++it)
+  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers->begin(); it != m_sortedMembers->end(); ++it)
   {
     (*it).channel->SetChannelNumber((*it).channelNumber);
   }
@@ -1017,7 +1052,7 @@ int CPVRChannelGroup::GetEPGNowOrNext(CFileItemList &results, bool bGetNext) con
   CPVRChannelPtr channel;
   CSingleLock lock(m_critSection);
 
-  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers.begin(); it != m_sortedMembers.end(); ++it)
+  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers->begin(); it != m_sortedMembers->end(); ++it)
   {
     channel = (*it).channel;
     CPVREpgPtr epg = channel->GetEPG();
@@ -1045,7 +1080,7 @@ int CPVRChannelGroup::GetEPGAll(CFileItemList &results, bool bIncludeChannelsWit
   CPVRChannelPtr channel;
   CSingleLock lock(m_critSection);
 
-  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers.begin(); it != m_sortedMembers.end(); ++it)
+  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers->begin(); it != m_sortedMembers->end(); ++it)
   {
     channel = (*it).channel;
     if (!channel->IsHidden())
@@ -1057,6 +1092,7 @@ int CPVRChannelGroup::GetEPGAll(CFileItemList &results, bool bIncludeChannelsWit
       {
         // XXX channel pointers aren't set in some occasions. this works around the issue, but is not very nice
         epg->SetChannel(channel);
+        epg->LoadUntil(CDateTime());
         iAdded = epg->Get(results);
       }
 
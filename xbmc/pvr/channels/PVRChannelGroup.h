@@ -21,6 +21,7 @@
 
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -53,6 +54,7 @@ namespace PVR
   };
 
   typedef std::vector<PVRChannelGroupMember> PVR_CHANNEL_GROUP_SORTED_MEMBERS;
+  typedef std::shared_ptr<const PVR_CHANNEL_GROUP_SORTED_MEMBERS> PVR_CHANNEL_GROUP_SORTED_MEMBERS_PTR;
   typedef std::map<std::pair<int, int>, PVRChannelGroupMember> PVR_CHANNEL_GROUP_MEMBERS;
 
   enum EpgDateType
@@ -103,9 +105,10 @@ namespace PVR
 
     /*!
      * @brief Load the channels from the database.
+     * @param bUpdateFromClients True to update the channels from the clients after loading them, false to only load the database.
      * @return True when loaded successfully, false otherwise.
      */
-    virtual bool Load(void);
+    virtual bool Load(bool bUpdateFromClients = true);
 
     /*!
      * @return The amount of group members
@@ -322,9 +325,10 @@ namespace PVR
 
     /*!
      * Get the current members of this group
-     * @return The group members
+     * @return The group members. The list is shared, not copied. It doesn't change once returned,
+     *         changes to the group are made to a new list.
      */
-    PVR_CHANNEL_GROUP_SORTED_MEMBERS GetMembers(void) const;
+    PVR_CHANNEL_GROUP_SORTED_MEMBERS_PTR GetMembers(void) const;
 
     /*!
      * @brief Get the list of channels in a group.
@@ -522,6 +526,13 @@ namespace PVR
      */
     bool UpdateClientPriorities();
 
+    /*!
+     * @brief Get the sorted members to change them.
+     * The list is copied first if it was handed out by GetMembers(). Must be called with m_critSection held.
+     * @return The sorted members.
+     */
+    PVR_CHANNEL_GROUP_SORTED_MEMBERS &GetSortedMembersForUpdate(void);
+
     bool             m_bRadio;                      /*!< true if this container holds radio channels, false if it holds TV channels */
     int              m_iGroupType;                  /*!< The type of this group */
     int              m_iGroupId;                    /*!< The ID of this group in the database */
@@ -535,7 +546,7 @@ namespace PVR
     time_t           m_iLastWatched;                /*!< last time group has been watched */
     bool             m_bHidden;                     /*!< true if this group is hidden, false otherwise */
     int              m_iPosition;                   /*!< the position of this group within the group list */
-    PVR_CHANNEL_GROUP_SORTED_MEMBERS m_sortedMembers; /*!< members sorted by channel number */
+    PVR_CHANNEL_GROUP_SORTED_MEMBERS_PTR m_sortedMembers; /*!< members sorted by channel number, copied on write */
     PVR_CHANNEL_GROUP_MEMBERS        m_members;       /*!< members with key clientid+uniqueid */
     CCriticalSection m_critSection;
     std::vector<int> m_failedClientsForChannels;
@@ -543,6 +554,8 @@ namespace PVR
 
   private:
     CDateTime GetEPGDate(EpgDateType epgDateType) const;
+
+    mutable std::unordered_map<uint64_t, CPVRChannelPtr> m_channelNumberIndex; /*!< channels by channel and sub channel number, built on first use */
     /*!
      * @brief Get all entries that will be active next.
      * @param results The fileitem list to store the results in.
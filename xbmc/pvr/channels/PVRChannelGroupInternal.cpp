@@ -60,9 +60,9 @@ CPVRChannelGroupInternal::~CPVRChannelGroupInternal(void)
   CServiceBroker::GetPVRManager().Events().Unsubscribe(this);
 }
 
-bool CPVRChannelGroupInternal::Load(void)
+bool CPVRChannelGroupInternal::Load(bool bUpdateFromClients /* = true */)
 {
-  if (CPVRChannelGroup::Load())
+  if (CPVRChannelGroup::Load(bUpdateFromClients))
   {
     UpdateChannelPaths();
     CServiceBroker::GetPVRManager().Events().Subscribe(this, &CPVRChannelGroupInternal::OnPVRManagerEvent);
@@ -112,11 +112,11 @@ CPVRChannelPtr CPVRChannelGroupInternal::UpdateFromClient(const CPVRChannelPtr &
   {
     unsigned int iChannelNumber = channelNumber.GetChannelNumber();
     if (iChannelNumber == 0)
-      iChannelNumber = static_cast<int>(m_sortedMembers.size()) + 1;
+      iChannelNumber = static_cast<int>(m_sortedMembers->size()) + 1;
 
     PVRChannelGroupMember newMember(channel, CPVRChannelNumber(iChannelNumber, channelNumber.GetSubChannelNumber()), 0);
     channel->UpdatePath(this);
-    m_sortedMembers.push_back(newMember);
+    GetSortedMembersForUpdate().push_back(newMember);
     m_members.insert(std::make_pair(channel->StorageId(), newMember));
     m_bChanged = true;
 
@@ -220,7 +220,7 @@ int CPVRChannelGroupInternal::GetMembers(CFileItemList &results, bool bGroupMemb
   int iOrigSize = results.Size();
   CSingleLock lock(m_critSection);
 
-  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers.begin(); it != m_sortedMembers.end(); ++it)
+  for (PVR_CHANNEL_GROUP_SORTED_MEMBERS::const_iterator it = m_sortedMembers->begin(); it != m_sortedMembers->end(); ++it)
     if (bGroupMembers != (*it).channel->IsHidden())
       results.Add(CFileItemPtr(new CFileItem((*it).channel)));
 
@@ -129,9 +129,10 @@ namespace PVR
      * Load the channels from the database.
      * If no channels are stored in the database, then the channels will be loaded from the clients.
      *
+     * @param bUpdateFromClients True to update the channels from the clients after loading them, false to only load the database.
      * @return True when loaded successfully, false otherwise.
      */
-    bool Load(void) override;
+    bool Load(bool bUpdateFromClients = true) override;
 
     /*!
      * @brief Update the vfs paths of all channels.
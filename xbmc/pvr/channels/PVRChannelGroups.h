@@ -51,9 +51,10 @@ namespace PVR
 
     /*!
      * @brief Load this container's contents from the database or PVR clients.
+     * @param bUpdateFromClients True to update the groups from the clients after loading them, false to only load the database.
      * @return True if it was loaded successfully, false if not.
      */
-    bool Load(void);
+    bool Load(bool bUpdateFromClients = true);
 
     /*!
      * @return Amount of groups in this container
@@ -214,7 +215,7 @@ namespace PVR
     bool Update(bool bChannelsOnly = false);
 
   private:
-    bool LoadUserDefinedChannelGroups(void);
+    bool LoadUserDefinedChannelGroups(bool bUpdateFromClients);
     bool GetGroupsFromClients(void);
     void SortGroups(void);
 
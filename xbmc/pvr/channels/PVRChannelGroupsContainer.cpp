@@ -64,10 +64,10 @@ bool CPVRChannelGroupsContainer::Update(bool bChannelsOnly /* = false */)
   return bReturn;
 }
 
-bool CPVRChannelGroupsContainer::Load(void)
+bool CPVRChannelGroupsContainer::Load(bool bUpdateFromClients /* = true */)
 {
   Unload();
-  m_bLoaded = m_groupsTV->Load() && m_groupsRadio->Load();
+  m_bLoaded = m_groupsTV->Load(bUpdateFromClients) && m_groupsRadio->Load(bUpdateFromClients);
   return m_bLoaded;
 }
 
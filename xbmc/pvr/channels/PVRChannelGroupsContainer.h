@@ -42,9 +42,10 @@ namespace PVR
 
     /*!
      * @brief Load all channel groups and all channels in those channel groups.
+     * @param bUpdateFromClients True to update the groups from the clients after loading them, false to only load the database.
      * @return True if all groups were loaded, false otherwise.
      */
-    bool Load(void);
+    bool Load(bool bUpdateFromClients = true);
 
     /*!
      * @brief Checks whether groups were already loaded.
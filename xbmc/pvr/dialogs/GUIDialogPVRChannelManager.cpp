@@ -675,9 +675,9 @@ void CGUIDialogPVRChannelManager::Update()
   if(!channels)
     return;
 
-  std::vector<PVRChannelGroupMember> groupMembers(channels->GetMembers());
+  const PVR_CHANNEL_GROUP_SORTED_MEMBERS_PTR groupMembers(channels->GetMembers());
   CFileItemPtr channelFile;
-  for (const auto &member : groupMembers)
+  for (const auto &member : *groupMembers)
   {
     channelFile = CFileItemPtr(new CFileItem(member.channel));
     if (!channelFile || !channelFile->HasPVRChannelInfoTag())
@@ -81,10 +81,10 @@ void CGUIDialogPVRGuideSearch::UpdateChannelSpin(void)
     group = CServiceBroker::GetPVRManager().ChannelGroups()->GetGroupAll(m_searchFilter->IsRadio());
 
   m_channelNumbersMap.clear();
-  const std::vector<PVRChannelGroupMember> groupMembers(group->GetMembers());
+  const PVR_CHANNEL_GROUP_SORTED_MEMBERS_PTR groupMembers(group->GetMembers());
   int iIndex = 0;
   int iSelectedChannel = EPG_SEARCH_UNSET;
-  for (const auto& groupMember : groupMembers)
+  for (const auto& groupMember : *groupMembers)
   {
     if (groupMember.channel)
     {
@@ -20,7 +20,10 @@
 
 #include "Epg.h"
 
+#include <algorithm>
+#include <iterator>
 #include <utility>
+#include <vector>
 
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_epg_types.h"
 #include "EpgContainer.h"
@@ -37,6 +40,8 @@
 #include "pvr/recordings/PVRRecordings.h"
 #include "pvr/timers/PVRTimers.h"
 
+#define EPG_PAGED_IN_LINGER 600 /* keep entries paged in beyond the window for 10 minutes after they were last needed */
+
 using namespace PVR;
 
 CPVREpg::CPVREpg(int iEpgID, const std::string &strName /* = "" */, const std::string &strScraperName /* = "" */, bool bLoadedFromDb /* = false */) :
@@ -47,7 +52,9 @@ CPVREpg::CPVREpg(int iEpgID, const std::string &strName /* = "" */, const std::s
     m_iEpgID(iEpgID),
     m_strName(strName),
     m_strScraperName(strScraperName),
-    m_bUpdateLastScanTime(false)
+    m_bUpdateLastScanTime(false),
+    m_bWindowed(false),
+    m_iLastPageIn(0)
 {
 }
 
@@ -60,7 +67,9 @@ CPVREpg::CPVREpg(const CPVRChannelPtr &channel, bool bLoadedFromDb /* = false */
     m_strName(channel->ChannelName()),
     m_strScraperName(channel->EPGScraper()),
     m_pvrChannel(channel),
-    m_bUpdateLastScanTime(false)
+    m_bUpdateLastScanTime(false),
+    m_bWindowed(false),
+    m_iLastPageIn(0)
 {
 }
 
@@ -70,7 +79,9 @@ CPVREpg::CPVREpg(void) :
     m_bLoaded(false),
     m_bUpdatePending(false),
     m_iEpgID(0),
-    m_bUpdateLastScanTime(false)
+    m_bUpdateLastScanTime(false),
+    m_bWindowed(false),
+    m_iLastPageIn(0)
 {
 }
 
@@ -91,6 +102,10 @@ CPVREpg &CPVREpg::operator =(const CPVREpg &right)
   m_nowActiveStart    = right.m_nowActiveStart;
   m_lastScanTime      = right.m_lastScanTime;
   m_pvrChannel        = right.m_pvrChannel;
+  m_bWindowed         = right.m_bWindowed;
+  m_loadedUntil       = right.m_loadedUntil;
+  m_lastStoredStart   = right.m_lastStoredStart;
+  m_iLastPageIn       = right.m_iLastPageIn;
 
   for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = right.m_tags.begin(); it != right.m_tags.end(); ++it)
     m_tags.insert(make_pair(it->first, it->second));
@@ -183,18 +198,22 @@ CPVREpgInfoTagPtr CPVREpg::GetTagNow(bool bUpdateIfNeeded /* = true */) const
 
   if (bUpdateIfNeeded)
   {
+    /* the entries of a table don't overlap, so the one playing now is the last that started before now.
+       timeshifting moves the playing time back, in that case it can be one of the entries before it */
     CPVREpgInfoTagPtr lastActiveTag;
-
-    /* one of the first items will always match if the list is sorted */
-    for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+    for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.upper_bound(CDateTime::GetUTCDateTime()); it != m_tags.begin();)
     {
+      --it;
       if (it->second->IsActive())
       {
         m_nowActiveStart = it->first;
         return it->second;
       }
       else if (it->second->WasActive())
+      {
         lastActiveTag = it->second;
+        break;
+      }
     }
 
     /* there might be a gap between the last and next event. return the last if found and it ended not more than 5 minutes ago */
@@ -219,11 +238,13 @@ CPVREpgInfoTagPtr CPVREpg::GetTagNext() const
   else if (Size() > 0)
   {
     /* return the first event that is in the future */
-    for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
-    {
-      if (it->second->IsUpcoming())
-        return it->second;
-    }
+    CSingleLock lock(m_critSection);
+    std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.upper_bound(CDateTime::GetUTCDateTime());
+    while (it != m_tags.begin() && std::prev(it)->second->IsUpcoming())
+      --it;
+
+    if (it != m_tags.end())
+      return it->second;
   }
 
   return CPVREpgInfoTagPtr();
@@ -244,6 +265,29 @@ bool CPVREpg::CheckPlayingEvent(void)
   return false;
 }
 
+CDateTime CPVREpg::GetNextPlayingEventChange(void) const
+{
+  const CDateTime now(CDateTime::GetUTCDateTime());
+  CDateTime next;
+
+  CSingleLock lock(m_critSection);
+  std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.upper_bound(now);
+  if (it != m_tags.end())
+    next = it->first;
+
+  if (it != m_tags.begin())
+  {
+    /* the entry playing now ends, or the one that ended stops being reported as playing */
+    CDateTime end((--it)->second->EndAsUTC());
+    if (end <= now)
+      end += CDateTimeSpan(0, 0, 5, 0);
+    if (end > now && (!next.IsValid() || end < next))
+      next = end;
+  }
+
+  return next;
+}
+
 CPVREpgInfoTagPtr CPVREpg::GetTagByBroadcastId(unsigned int iUniqueBroadcastId) const
 {
   if (iUniqueBroadcastId != EPG_TAG_INVALID_UID)
@@ -261,9 +305,9 @@ CPVREpgInfoTagPtr CPVREpg::GetTagByBroadcastId(unsigned int iUniqueBroadcastId)
 CPVREpgInfoTagPtr CPVREpg::GetTagBetween(const CDateTime &beginTime, const CDateTime &endTime) const
 {
   CSingleLock lock(m_critSection);
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.lower_bound(beginTime); it != m_tags.end() && it->first <= endTime; ++it)
   {
-    if (it->second->StartAsUTC() >= beginTime && it->second->EndAsUTC() <= endTime)
+    if (it->second->EndAsUTC() <= endTime)
       return it->second;
   }
 
@@ -275,15 +319,12 @@ std::vector<CPVREpgInfoTagPtr> CPVREpg::GetTagsBetween(const CDateTime &beginTim
   std::vector<CPVREpgInfoTagPtr> epgTags;
 
   CSingleLock lock(m_critSection);
-  for (const auto &infoTag : m_tags)
+  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.lower_bound(beginTime); it != m_tags.end(); ++it)
   {
-    if (infoTag.second->StartAsUTC() >= beginTime)
-    {
-      if (infoTag.second->EndAsUTC() <= endTime)
-        epgTags.emplace_back(infoTag.second);
-      else
-        break; // done.
-    }
+    if (it->second->EndAsUTC() <= endTime)
+      epgTags.emplace_back(it->second);
+    else
+      break; // done.
   }
 
   return epgTags;
@@ -295,26 +336,21 @@ void CPVREpg::AddEntry(const CPVREpgInfoTag &tag)
   CPVRChannelPtr channel;
   {
     CSingleLock lock(m_critSection);
-    std::map<CDateTime, CPVREpgInfoTagPtr>::iterator itr = m_tags.find(tag.StartAsUTC());
-    if (itr != m_tags.end())
-      newTag = itr->second;
-    else
-    {
-      newTag.reset(new CPVREpgInfoTag(this, m_pvrChannel, m_strName, m_pvrChannel ? m_pvrChannel->IconPath() : ""));
-      m_tags.insert(make_pair(tag.StartAsUTC(), newTag));
-    }
+    /* an entry that is in memory already is at least as recent as the stored one */
+    if (m_tags.find(tag.StartAsUTC()) != m_tags.end())
+      return;
+
+    newTag.reset(new CPVREpgInfoTag(this, m_pvrChannel, m_strName, m_pvrChannel ? m_pvrChannel->IconPath() : ""));
+    m_tags.insert(make_pair(tag.StartAsUTC(), newTag));
 
     channel = m_pvrChannel;
   }
 
-  if (newTag)
-  {
-    newTag->Update(tag);
-    newTag->SetChannel(channel);
-    newTag->SetEpg(this);
-    newTag->SetTimer(CServiceBroker::GetPVRManager().Timers()->GetTimerForEpgTag(newTag));
-    newTag->SetRecording(CServiceBroker::GetPVRManager().Recordings()->GetRecordingForEpgTag(newTag));
-  }
+  newTag->Update(tag);
+  newTag->SetChannel(channel);
+  newTag->SetEpg(this);
+  newTag->SetTimer(CServiceBroker::GetPVRManager().Timers()->GetTimerForEpgTag(newTag));
+  newTag->SetRecording(CServiceBroker::GetPVRManager().Recordings()->GetRecordingForEpgTag(newTag));
 }
 
 bool CPVREpg::Load(void)
@@ -328,7 +364,17 @@ bool CPVREpg::Load(void)
     return bReturn;
   }
 
-  int iEntriesLoaded = database->Get(*this);
+  /* the entries further ahead are paged in when they are needed */
+  CDateTime windowEnd;
+  CDateTime lastStoredStart;
+  bool bWindowed = g_advancedSettings.m_iEpgMemoryWindow > 0;
+  if (bWindowed)
+  {
+    windowEnd = CDateTime::GetUTCDateTime() + CDateTimeSpan(0, g_advancedSettings.m_iEpgMemoryWindow, 0, 0);
+    lastStoredStart = database->GetLastStartTime(m_iEpgID);
+  }
+
+  int iEntriesLoaded = database->Get(*this, CDateTime(), windowEnd);
 
   CSingleLock lock(m_critSection);
   if (iEntriesLoaded <= 0)
@@ -344,11 +390,116 @@ bool CPVREpg::Load(void)
     bReturn = true;
   }
 
+  m_bWindowed = bWindowed;
+  m_loadedUntil = windowEnd;
+  m_lastStoredStart = lastStoredStart;
   m_bLoaded = true;
 
   return bReturn;
 }
 
+bool CPVREpg::LoadUntil(const CDateTime &end)
+{
+  CDateTime start;
+  {
+    CSingleLock lock(m_critSection);
+    if (!m_bWindowed)
+      return true;
+
+    const CDateTime now(CDateTime::GetUTCDateTime());
+    if (!end.IsValid() || end > now + CDateTimeSpan(0, g_advancedSettings.m_iEpgMemoryWindow, 0, 0))
+      now.GetAsTime(m_iLastPageIn);
+
+    if (!m_loadedUntil.IsValid() || (end.IsValid() && end <= m_loadedUntil))
+      return true;
+
+    start = m_loadedUntil;
+  }
+
+  /* not holding the lock while reading, the database takes its own lock before ours when persisting */
+  CPVREpgDatabasePtr database = CServiceBroker::GetPVRManager().EpgContainer().GetEpgDatabase();
+  if (!database)
+  {
+    CLog::Log(LOGERROR, "EPG - %s - could not open the database", __FUNCTION__);
+    return false;
+  }
+
+  if (database->Get(*this, start, end) < 0)
+    return false;
+
+  CSingleLock lock(m_critSection);
+  if (!end.IsValid())
+    m_loadedUntil.SetValid(false);
+  else if (m_loadedUntil.IsValid() && end > m_loadedUntil)
+    m_loadedUntil = end;
+
+  return true;
+}
+
+bool CPVREpg::LoadBroadcast(unsigned int iUniqueBroadcastId)
+{
+  {
+    CSingleLock lock(m_critSection);
+    if (!m_bWindowed || !m_loadedUntil.IsValid() || iUniqueBroadcastId == EPG_TAG_INVALID_UID)
+      return false;
+  }
+
+  CPVREpgDatabasePtr database = CServiceBroker::GetPVRManager().EpgContainer().GetEpgDatabase();
+  if (!database)
+    return false;
+
+  const CDateTime startTime(database->GetStartTime(m_iEpgID, iUniqueBroadcastId));
+  return startTime.IsValid() && LoadUntil(startTime) && GetTagByBroadcastId(iUniqueBroadcastId) != nullptr;
+}
+
+void CPVREpg::UpdateWindow(void)
+{
+  CDateTime windowEnd;
+  {
+    CSingleLock lock(m_critSection);
+    if (!m_bWindowed)
+      return;
+
+    const CDateTime now(CDateTime::GetUTCDateTime());
+    windowEnd = now + CDateTimeSpan(0, g_advancedSettings.m_iEpgMemoryWindow, 0, 0);
+
+    time_t iNow;
+    now.GetAsTime(iNow);
+    if (iNow - m_iLastPageIn >= EPG_PAGED_IN_LINGER &&
+        (!m_loadedUntil.IsValid() || m_loadedUntil > windowEnd))
+    {
+      /* changed entries that weren't persisted yet and the ones with a timer stay */
+      unsigned int iDropped = 0;
+      for (std::map<CDateTime, CPVREpgInfoTagPtr>::iterator it = m_tags.upper_bound(windowEnd); it != m_tags.end();)
+      {
+        if (it->second->HasTimer() || m_changedTags.find(it->second->UniqueBroadcastID()) != m_changedTags.end())
+        {
+          ++it;
+          continue;
+        }
+
+        if (!m_lastStoredStart.IsValid() || it->first > m_lastStoredStart)
+          m_lastStoredStart = it->first;
+
+        it->second->ClearRecording();
+        it = m_tags.erase(it);
+        ++iDropped;
+      }
+      m_loadedUntil = windowEnd;
+
+#if EPG_DEBUGGING
+      CLog::Log(LOGDEBUG, "EPG - %s - dropped %u entries beyond the window for table '%s'.", __FUNCTION__, iDropped, m_strName.c_str());
+#endif
+      return;
+    }
+
+    if (!m_loadedUntil.IsValid() || m_loadedUntil >= windowEnd)
+      return;
+  }
+
+  LoadUntil(windowEnd);
+}
+
 bool CPVREpg::UpdateEntries(const CPVREpg &epg, bool bStoreInDb /* = true */)
 {
   CSingleLock lock(m_critSection);
@@ -431,11 +582,12 @@ bool CPVREpg::UpdateEntry(const CPVREpgInfoTagPtr &tag, bool bUpdateDatabase)
       bNewTag = true;
     }
 
-    infoTag->Update(*tag, bNewTag);
+    /* only write what the client actually changed, a refresh mostly sends the same entries again */
+    const bool bChanged = infoTag->Update(*tag, bNewTag);
     infoTag->SetEpg(this);
     infoTag->SetChannel(m_pvrChannel);
 
-    if (bUpdateDatabase)
+    if (bUpdateDatabase && (bNewTag || bChanged))
       m_changedTags.insert(std::make_pair(infoTag->UniqueBroadcastID(), infoTag));
   }
 
@@ -586,6 +738,31 @@ int CPVREpg::Get(CFileItemList &results, const CPVREpgSearchFilter &filter) cons
   return results.Size() - iInitialSize;
 }
 
+int CPVREpg::Get(CFileItemList &results, const CPVREpgSearchFilter &filter, const std::set<unsigned int> &matches) const
+{
+  int iInitialSize = results.Size();
+
+  if (!HasValidEntries())
+    return -1;
+
+  CSingleLock lock(m_critSection);
+
+  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+  {
+    /* entries changed since they were last stored aren't in the index yet */
+    unsigned int iUniqueBroadcastId = it->second->UniqueBroadcastID();
+    if (iUniqueBroadcastId != EPG_TAG_INVALID_UID &&
+        matches.find(iUniqueBroadcastId) == matches.end() &&
+        m_changedTags.find(iUniqueBroadcastId) == m_changedTags.end())
+      continue;
+
+    if (filter.FilterEntry(it->second))
+      results.Add(CFileItemPtr(new CFileItem(it->second)));
+  }
+
+  return results.Size() - iInitialSize;
+}
+
 bool CPVREpg::Persist(void)
 {
   if (CServiceBroker::GetSettings().GetBool(CSettings::SETTING_EPG_IGNOREDBFORCLIENT) || !NeedsSave())
@@ -613,11 +790,20 @@ bool CPVREpg::Persist(void)
         m_iEpgID = iId;
     }
 
+    /* the removed and changed entries are written in bulk, in the same transaction as the table */
+    std::vector<CPVREpgInfoTagPtr> tags;
+    tags.reserve(std::max(m_deletedTags.size(), m_changedTags.size()));
+
     for (std::map<int, CPVREpgInfoTagPtr>::iterator it = m_deletedTags.begin(); it != m_deletedTags.end(); ++it)
-      database->Delete(*it->second);
+      tags.push_back(it->second);
+    if (!tags.empty())
+      database->QueueDeleteTags(m_iEpgID, tags);
 
+    tags.clear();
     for (std::map<int, CPVREpgInfoTagPtr>::iterator it = m_changedTags.begin(); it != m_changedTags.end(); ++it)
-      it->second->Persist(false);
+      tags.push_back(it->second);
+    if (!tags.empty())
+      database->QueuePersistTags(tags);
 
     if (m_bUpdateLastScanTime)
       database->PersistLastEpgScanTime(m_iEpgID, true);
@@ -654,6 +840,10 @@ CDateTime CPVREpg::GetLastDate(void) const
   if (!m_tags.empty())
     last = m_tags.rbegin()->second->StartAsUTC();
 
+  /* entries beyond the window count as well, they are paged in when needed */
+  if (m_bWindowed && m_lastStoredStart.IsValid() && (!last.IsValid() || m_lastStoredStart > last))
+    last = m_lastStoredStart;
+
   return last;
 }
 
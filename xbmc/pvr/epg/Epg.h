@@ -20,6 +20,7 @@
  */
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -66,11 +67,36 @@ namespace PVR
     CPVREpg &operator =(const CPVREpg &right);
 
     /*!
-     * @brief Load all entries for this table from the database.
+     * @brief Load the entries for this table from the database.
+     *
+     * Unless disabled in advancedsettings.xml, only the entries up to a window after now are kept
+     * in memory. Use LoadUntil() and LoadBroadcast() before looking at entries further ahead.
      * @return True if any entries were loaded, false otherwise.
      */
     bool Load(void);
 
+    /*!
+     * @brief Page in the entries stored in the database up to a start time, if they aren't in memory.
+     * @param end The start time up to which entries are needed, invalid for all of them.
+     * @return False if the database couldn't be read, true otherwise.
+     */
+    bool LoadUntil(const CDateTime &end);
+
+    /*!
+     * @brief Page in the entries stored in the database up to an entry, if it isn't in memory.
+     * @param iUniqueBroadcastId The unique broadcast id of the entry.
+     * @return True if the entry was paged in, false otherwise.
+     */
+    bool LoadBroadcast(unsigned int iUniqueBroadcastId);
+
+    /*!
+     * @brief Move the window of entries kept in memory along with the time.
+     *
+     * Pages in the entries that moved into the window and drops the ones beyond it that were
+     * paged in on demand but weren't needed for a while.
+     */
+    void UpdateWindow(void);
+
     /*!
      * @brief The channel this EPG belongs to.
      * @return The channel this EPG belongs to
@@ -162,6 +188,12 @@ namespace PVR
      */
     CPVREpgInfoTagPtr GetTagNext() const;
 
+    /*!
+     * @brief Get the time the event that is occurring now changes next, when it ends or the next one starts.
+     * @return The time or an invalid time if no change is known of.
+     */
+    CDateTime GetNextPlayingEventChange(void) const;
+
     /*!
      * Get the event that occurs between the given begin and end time.
      * @param beginTime Minimum start time in UTC of the event.
@@ -236,6 +268,15 @@ namespace PVR
      */
     int Get(CFileItemList &results, const CPVREpgSearchFilter &filter) const;
 
+    /*!
+     * @brief Get all EPG entries that and apply a filter, considering only stored entries found by a full-text search.
+     * @param results The file list to store the results in.
+     * @param filter The filter to apply.
+     * @param matches The unique broadcast ids of this table's stored entries that matched the full-text search.
+     * @return The amount of entries that were added.
+     */
+    int Get(CFileItemList &results, const CPVREpgSearchFilter &filter, const std::set<unsigned int> &matches) const;
+
     /*!
      * @brief Persist this table in the database.
      * @return True if the table was persisted, false otherwise.
@@ -342,5 +383,10 @@ namespace PVR
 
     CCriticalSection                    m_critSection;     /*!< critical section for changes in this table */
     bool                                m_bUpdateLastScanTime;
+
+    bool                                m_bWindowed;       /*!< true if only a window of the entries in the database is kept in memory */
+    CDateTime                           m_loadedUntil;     /*!< the entries starting up to this time are in memory, invalid if all of them are */
+    CDateTime                           m_lastStoredStart; /*!< the start time of the last entry in the database that may not be in memory */
+    time_t                              m_iLastPageIn;     /*!< the last time entries beyond the window were needed */
   };
 }
@@ -20,6 +20,8 @@
 
 #include "EpgContainer.h"
 
+#include <map>
+#include <memory>
 #include <utility>
 
 #include "Application.h"
@@ -28,8 +30,10 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/lib/Setting.h"
+#include "threads/Event.h"
 #include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 
 #include "pvr/PVRManager.h"
@@ -111,6 +115,20 @@ void CEpgTagStateChange::Deliver()
     CLog::Log(LOGERROR, "PVR - %s - update failed for epgtag change for channel '%s'", __FUNCTION__, channel->ChannelName().c_str());
 }
 
+/*!
+ * @brief Results of the table updates running on the job manager, shared with the jobs.
+ */
+struct CEpgUpdateState
+{
+  CCriticalSection section;
+  CEvent done;
+  bool bCancelled = false;
+  unsigned int iFinished = 0;
+  unsigned int iUpdated = 0;
+  std::string strLastFinished;
+  std::vector<CPVREpgPtr> invalidTables;
+};
+
 CPVREpgContainer::CPVREpgContainer(void) :
   CThread("EPGUpdater"),
   m_database(new CPVREpgDatabase),
@@ -133,7 +151,7 @@ CPVREpgContainer::CPVREpgContainer(void) :
   m_bLoaded = false;
   m_pendingUpdates = 0;
   m_iLastEpgCleanup = 0;
-  m_iNextEpgActiveTagCheck = 0;
+  m_bCheckAllPlayingEvents = true;
   m_iNextEpgUpdate = 0;
 }
 
@@ -243,7 +261,7 @@ void CPVREpgContainer::Start(bool bAsync)
     m_bStop = false;
 
     m_iNextEpgUpdate  = 0;
-    m_iNextEpgActiveTagCheck = 0;
+    m_bCheckAllPlayingEvents = true;
     m_bUpdateNotificationPending = false;
   }
 
@@ -285,6 +303,17 @@ bool CPVREpgContainer::Stop(void)
 
 void CPVREpgContainer::Notify(const Observable &obs, const ObservableMessage msg)
 {
+  if (msg != ObservableMessageEpgActiveItem)
+  {
+    /* the table's active tag may have changed with its entries */
+    const CPVREpg *epg = dynamic_cast<const CPVREpg *>(&obs);
+    if (epg)
+    {
+      CSingleLock lock(m_critSection);
+      SchedulePlayingEventCheck(epg->EpgID(), 0);
+    }
+  }
+
   if (msg == ObservableMessageEpgItemUpdate)
   {
     // there can be many of these notifications during short time period. Thus, announce async and not every event.
@@ -332,6 +361,7 @@ void CPVREpgContainer::LoadFromDB(void)
   progressHandler->DestroyProgress();
 
   m_bLoaded = bLoaded;
+  m_bCheckAllPlayingEvents = true;
 }
 
 bool CPVREpgContainer::PersistAll(void)
@@ -496,6 +526,20 @@ CPVREpgInfoTagPtr CPVREpgContainer::GetTagById(const CPVRChannelPtr &channel, un
       if (retval)
         break;
     }
+
+    /* it may be further ahead than the tables keep in memory. lookups for a channel are
+       for recordings, which never are */
+    if (!retval)
+    {
+      for (const auto &epgEntry : m_epgs)
+      {
+        if (epgEntry.second->LoadBroadcast(iBroadcastId))
+        {
+          retval = epgEntry.second->GetTagByBroadcastId(iBroadcastId);
+          break;
+        }
+      }
+    }
   }
 
   return retval;
@@ -512,7 +556,10 @@ std::vector<CPVREpgInfoTagPtr> CPVREpgContainer::GetEpgTagsForTimer(const CPVRTi
   {
     const CPVREpgPtr epg(channel->GetEPG());
     if (epg)
+    {
+      epg->LoadUntil(timer->EndAsUTC());
       return epg->GetTagsBetween(timer->StartAsUTC(), timer->EndAsUTC());
+    }
   }
   return std::vector<CPVREpgInfoTagPtr>();
 }
@@ -586,9 +633,12 @@ bool CPVREpgContainer::RemoveOldEntries(void)
 {
   const CDateTime cleanupTime(CDateTime::GetUTCDateTime() - CDateTimeSpan(GetPastDaysToDisplay(), 0, 0, 0));
 
-  /* call Cleanup() on all known EPG tables */
+  /* call Cleanup() on all known EPG tables and move their windows along */
   for (const auto &epgEntry : m_epgs)
+  {
     epgEntry.second->Cleanup(cleanupTime);
+    epgEntry.second->UpdateWindow();
+  }
 
   /* remove the old entries from the database */
   if (!IgnoreDB())
@@ -682,8 +732,13 @@ bool CPVREpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
   if (bShowProgress && !bOnlyPending)
     progressHandler = new CPVRGUIProgressHandler(g_localizeStrings.Get(19004)); // Importing guide from clients
 
-  /* load or update all EPG tables */
+  /* load or update all EPG tables. the tables of different clients are updated at the same time,
+     and several of each client, as the backends can serve more than one channel at once */
+  std::shared_ptr<CEpgUpdateState> state(std::make_shared<CEpgUpdateState>());
+  std::map<int, std::unique_ptr<CJobQueue>> clientQueues;
+  const int iUpdateTime = m_settings.GetIntValue(CSettings::SETTING_EPG_EPGUPDATE) * 60;
   unsigned int iCounter(0);
+  unsigned int iSubmitted(0);
   for (const auto &epgEntry : m_epgs)
   {
     if (InterruptUpdate())
@@ -696,12 +751,12 @@ bool CPVREpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
     if (!epg)
       continue;
 
-    if (bShowProgress && !bOnlyPending)
-      progressHandler->UpdateProgress(epg->Name(), ++iCounter, m_epgs.size());
-
     // we currently only support update via pvr add-ons. skip update when the pvr manager isn't started
     if (!CServiceBroker::GetPVRManager().IsStarted())
+    {
+      ++iCounter;
       continue;
+    }
 
     // check the pvr manager when the channel pointer isn't set
     if (!epg->Channel())
@@ -711,12 +766,62 @@ bool CPVREpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
         epg->SetChannel(channel);
     }
 
-    if ((!bOnlyPending || epg->UpdatePending()) &&
-        epg->Update(start, end, m_settings.GetIntValue(CSettings::SETTING_EPG_EPGUPDATE) * 60, bOnlyPending))
-      iUpdatedTables++;
-    else if (!epg->IsValid())
-      invalidTables.push_back(epg);
+    if (bOnlyPending && !epg->UpdatePending())
+    {
+      ++iCounter;
+      if (!epg->IsValid())
+        invalidTables.push_back(epg);
+      continue;
+    }
+
+    const CPVRChannelPtr channel(epg->Channel());
+    const int iClientId = channel ? channel->ClientID() : -1;
+    auto queue = clientQueues.find(iClientId);
+    if (queue == clientQueues.end())
+      queue = clientQueues.insert(std::make_pair(iClientId, std::unique_ptr<CJobQueue>(new CJobQueue(false, g_advancedSettings.m_iEpgUpdatesPerClient, CJob::PRIORITY_NORMAL)))).first;
+
+    queue->second->Submit([state, epg, start, end, iUpdateTime, bOnlyPending]()
+    {
+      bool bCancelled;
+      {
+        CSingleLock lock(state->section);
+        bCancelled = state->bCancelled;
+      }
+
+      const bool bUpdated = !bCancelled && epg->Update(start, end, iUpdateTime, bOnlyPending);
+
+      CSingleLock lock(state->section);
+      if (bUpdated)
+        state->iUpdated++;
+      else if (!bCancelled && !epg->IsValid())
+        state->invalidTables.push_back(epg);
+      state->strLastFinished = epg->Name();
+      state->iFinished++;
+      state->done.Set();
+    });
+    iSubmitted++;
+  }
+
+  /* wait for the updates, tables that weren't started yet are skipped when the update is interrupted */
+  CSingleLock stateLock(state->section);
+  while (state->iFinished < iSubmitted)
+  {
+    if (!bInterrupted && InterruptUpdate())
+    {
+      bInterrupted = true;
+      state->bCancelled = true;
+    }
+
+    if (bShowProgress && !bOnlyPending && !state->strLastFinished.empty())
+      progressHandler->UpdateProgress(state->strLastFinished, iCounter + state->iFinished, m_epgs.size());
+
+    state->done.Reset();
+    CSingleExit exit(state->section);
+    state->done.WaitMSec(100);
   }
+  iUpdatedTables = state->iUpdated;
+  invalidTables.insert(invalidTables.end(), state->invalidTables.begin(), state->invalidTables.end());
+  stateLock.Leave();
 
   if (bShowProgress && !bOnlyPending)
     progressHandler->DestroyProgress();
@@ -793,11 +898,36 @@ int CPVREpgContainer::GetEPGSearch(CFileItemList &results, const CPVREpgSearchFi
 {
   int iInitialSize = results.Size();
 
+  /* narrow the search term down with the full-text index, unless the database isn't kept up to date */
+  std::map<int, std::set<unsigned int>> matches;
+  bool bIndexed = false;
+  if (!CServiceBroker::GetSettings().GetBool(CSettings::SETTING_EPG_IGNOREDBFORCLIENT))
+  {
+    const CPVREpgDatabasePtr database = GetEpgDatabase();
+    if (database)
+      bIndexed = database->GetSearchMatches(filter, matches);
+  }
+
   /* get filtered results from all tables */
   {
+    static const std::set<unsigned int> noMatches;
     CSingleLock lock(m_critSection);
     for (const auto &epgEntry : m_epgs)
-      epgEntry.second->Get(results, filter);
+    {
+      if (!bIndexed)
+      {
+        epgEntry.second->LoadUntil(CDateTime());
+        epgEntry.second->Get(results, filter);
+      }
+      else
+      {
+        /* only the tables with matches need all of their entries */
+        const auto it = matches.find(epgEntry.second->EpgID());
+        if (it != matches.end())
+          epgEntry.second->LoadUntil(CDateTime());
+        epgEntry.second->Get(results, filter, it != matches.end() ? it->second : noMatches);
+      }
+    }
   }
 
   /* remove duplicate entries */
@@ -807,40 +937,67 @@ int CPVREpgContainer::GetEPGSearch(CFileItemList &results, const CPVREpgSearchFi
   return results.Size() - iInitialSize;
 }
 
+void CPVREpgContainer::SchedulePlayingEventCheck(int iEpgId, time_t iTime)
+{
+  const auto it = m_nextPlayingEventChecks.find(iEpgId);
+  if (it != m_nextPlayingEventChecks.end() && it->second <= iTime)
+    return;
+
+  m_nextPlayingEventChecks[iEpgId] = iTime;
+  m_playingEventChecks.push(std::make_pair(iTime, iEpgId));
+}
+
 bool CPVREpgContainer::CheckPlayingEvents(void)
 {
-  bool bReturn(false);
   bool bFoundChanges(false);
 
+  time_t iNow;
+  CDateTime::GetCurrentDateTime().GetAsUTCDateTime().GetAsTime(iNow);
+
+  /* take the tables that are due */
+  std::vector<CPVREpgPtr> epgs;
   {
-    time_t iNextEpgActiveTagCheck;
+    CSingleLock lock(m_critSection);
+    if (m_bCheckAllPlayingEvents)
     {
-      CSingleLock lock(m_critSection);
-      iNextEpgActiveTagCheck = m_iNextEpgActiveTagCheck;
+      for (const auto &epgEntry : m_epgs)
+        SchedulePlayingEventCheck(epgEntry.first, iNow);
+      m_bCheckAllPlayingEvents = false;
     }
 
-    time_t iNow;
-    CDateTime::GetCurrentDateTime().GetAsUTCDateTime().GetAsTime(iNow);
-    if (iNow >= iNextEpgActiveTagCheck)
+    while (!m_playingEventChecks.empty() && m_playingEventChecks.top().first <= iNow)
     {
-      for (const auto &epgEntry : m_epgs)
-        bFoundChanges = epgEntry.second->CheckPlayingEvent() || bFoundChanges;
+      const PlayingEventCheck check(m_playingEventChecks.top());
+      m_playingEventChecks.pop();
 
-      CDateTime::GetCurrentDateTime().GetAsUTCDateTime().GetAsTime(iNextEpgActiveTagCheck);
-      iNextEpgActiveTagCheck += g_advancedSettings.m_iEpgActiveTagCheckInterval;
+      const auto it = m_nextPlayingEventChecks.find(check.second);
+      if (it == m_nextPlayingEventChecks.end() || it->second != check.first)
+        continue;
+      m_nextPlayingEventChecks.erase(it);
 
-      /* pvr tags always start on the full minute */
-      if (CServiceBroker::GetPVRManager().IsStarted())
-        iNextEpgActiveTagCheck -= iNextEpgActiveTagCheck % 60;
-
-      bReturn = true;
+      const auto epgEntry = m_epgs.find(check.second);
+      if (epgEntry != m_epgs.end())
+        epgs.push_back(epgEntry->second);
     }
+  }
 
-    if (bReturn)
-    {
-      CSingleLock lock(m_critSection);
-      m_iNextEpgActiveTagCheck = iNextEpgActiveTagCheck;
-    }
+  const CPVRChannelPtr playingChannel(CServiceBroker::GetPVRManager().GetPlayingChannel());
+  for (const auto &epg : epgs)
+  {
+    bFoundChanges = epg->CheckPlayingEvent() || bFoundChanges;
+
+    /* the playing time of a timeshifted channel lags behind, its changes can't be told in advance */
+    time_t iNext = 0;
+    const CDateTime next(epg->GetNextPlayingEventChange());
+    if (next.IsValid())
+      next.GetAsTime(iNext);
+    if ((next.IsValid() && iNext <= iNow) || (playingChannel && playingChannel->EpgID() == epg->EpgID()))
+      iNext = iNow + g_advancedSettings.m_iEpgActiveTagCheckInterval;
+    else if (!next.IsValid())
+      continue; // checked again when the table changes
+
+    CSingleLock lock(m_critSection);
+    SchedulePlayingEventCheck(epg->EpgID(), iNext);
   }
 
   if (bFoundChanges)
@@ -849,7 +1006,7 @@ bool CPVREpgContainer::CheckPlayingEvents(void)
     CSingleExit ex(m_critSection);
     NotifyObservers(ObservableMessageEpgActiveItem);
   }
-  return bReturn;
+  return !epgs.empty();
 }
 
 void CPVREpgContainer::SetHasPendingUpdates(bool bHasPendingUpdates /* = true */)
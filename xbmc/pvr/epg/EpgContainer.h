@@ -19,6 +19,12 @@
  *
  */
 
+#include <functional>
+#include <map>
+#include <queue>
+#include <utility>
+#include <vector>
+
 #include "XBDateTime.h"
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
@@ -151,8 +157,9 @@ namespace PVR
     std::vector<CPVREpgInfoTagPtr> GetEpgTagsForTimer(const PVR::CPVRTimerInfoTagPtr &timer) const;
 
     /*!
-     * @brief Notify EPG table observers when the currently active tag changed.
-     * @return True if the check was done, false if it was not the right time to check
+     * @brief Notify EPG table observers when the currently active tag changed. Only the tables
+     * whose active tag is due to change, or that changed themselves, are checked.
+     * @return True if a table was checked, false if none was due
      */
     bool CheckPlayingEvents(void);
 
@@ -266,7 +273,7 @@ namespace PVR
     int          m_pendingUpdates;         /*!< count of pending manual updates */
     time_t       m_iLastEpgCleanup;        /*!< the time the EPG was cleaned up */
     time_t       m_iNextEpgUpdate;         /*!< the time the EPG will be updated */
-    time_t       m_iNextEpgActiveTagCheck; /*!< the time the EPG will be checked for active tag updates */
+    bool         m_bCheckAllPlayingEvents; /*!< true to check all tables for active tag updates */
     unsigned int m_iNextEpgId;             /*!< the next epg ID that will be given to a new table when the db isn't being used */
     EPGMAP       m_epgs;                   /*!< the EPGs in this container */
     //@}
@@ -280,6 +287,17 @@ namespace PVR
     std::list<CEpgTagStateChange> m_epgTagChanges; /*!< list of updated epg tags announced by addon */
     CCriticalSection m_epgTagChangesLock;          /*!< protect changed epg tags list */
 
+    /*!
+     * @brief Schedule a check of a table for an active tag update. m_critSection must be held.
+     * @param iEpgId The table.
+     * @param iTime The time to check it at. A check scheduled earlier is kept.
+     */
+    void SchedulePlayingEventCheck(int iEpgId, time_t iTime);
+
+    typedef std::pair<time_t, int> PlayingEventCheck;
+    std::priority_queue<PlayingEventCheck, std::vector<PlayingEventCheck>, std::greater<PlayingEventCheck>> m_playingEventChecks; /*!< the times the tables' active tags change, earliest first */
+    std::map<int, time_t> m_nextPlayingEventChecks; /*!< the time each table is due, entries of the queue that don't match were rescheduled */
+
     bool m_bUpdateNotificationPending; /*!< true while an epg updated notification to observers is pending. */
     CPVRSettings m_settings;
   };
@@ -27,9 +27,15 @@
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TextSearch.h"
 
 #include "pvr/epg/EpgContainer.h"
 
+#define EPG_TAGS_PER_QUERY 100 /* rows written or removed by a single statement */
+#define EPG_TAG_COLUMNS "idEpg, iStartTime, iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, " \
+                        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, " \
+                        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid"
+
 using namespace dbiplus;
 using namespace PVR;
 
@@ -118,6 +124,8 @@ void CPVREpgDatabase::CreateAnalytics()
   CSingleLock lock(m_critSection);
   m_pDS->exec("CREATE UNIQUE INDEX idx_epg_idEpg_iStartTime on epgtags(idEpg, iStartTime desc);");
   m_pDS->exec("CREATE INDEX idx_epg_iEndTime on epgtags(iEndTime);");
+
+  CreateFullTextIndex("epgsearch", "epgtags", "idBroadcast", { "sTitle", "sPlotOutline", "sPlot" });
 }
 
 void CPVREpgDatabase::UpdateTables(int iVersion)
@@ -200,6 +208,38 @@ bool CPVREpgDatabase::Delete(const CPVREpgInfoTag &tag)
   return DeleteValues("epgtags", filter);
 }
 
+bool CPVREpgDatabase::QueueDeleteTags(int iEpgId, const std::vector<CPVREpgInfoTagPtr> &tags)
+{
+  bool bReturn(true);
+
+  CSingleLock lock(m_critSection);
+
+  /* tags that were queued for writing don't know their ID, but a table has only one entry per start time */
+  std::string strStartTimes;
+  unsigned int iRows(0);
+  for (const auto &tag : tags)
+  {
+    time_t iStartTime;
+    tag->StartAsUTC().GetAsTime(iStartTime);
+
+    if (iRows > 0)
+      strStartTimes += ", ";
+    strStartTimes += StringUtils::Format("%u", static_cast<unsigned int>(iStartTime));
+
+    if (++iRows == EPG_TAGS_PER_QUERY)
+    {
+      bReturn &= QueueInsertQuery(PrepareSQL("DELETE FROM epgtags WHERE idEpg = %u AND iStartTime IN (%s);", iEpgId, strStartTimes.c_str()));
+      strStartTimes.clear();
+      iRows = 0;
+    }
+  }
+
+  if (iRows > 0)
+    bReturn &= QueueInsertQuery(PrepareSQL("DELETE FROM epgtags WHERE idEpg = %u AND iStartTime IN (%s);", iEpgId, strStartTimes.c_str()));
+
+  return bReturn;
+}
+
 int CPVREpgDatabase::Get(CPVREpgContainer &container)
 {
   int iReturn(-1);
@@ -234,11 +274,29 @@ int CPVREpgDatabase::Get(CPVREpgContainer &container)
 }
 
 int CPVREpgDatabase::Get(CPVREpg &epg)
+{
+  return Get(epg, CDateTime(), CDateTime());
+}
+
+int CPVREpgDatabase::Get(CPVREpg &epg, const CDateTime &start, const CDateTime &end)
 {
   int iReturn(-1);
 
+  std::string strQuery = PrepareSQL("SELECT * FROM epgtags WHERE idEpg = %u", epg.EpgID());
+  time_t iTime;
+  if (start.IsValid())
+  {
+    start.GetAsTime(iTime);
+    strQuery += PrepareSQL(" AND iStartTime > %u", static_cast<unsigned int>(iTime));
+  }
+  if (end.IsValid())
+  {
+    end.GetAsTime(iTime);
+    strQuery += PrepareSQL(" AND iStartTime <= %u", static_cast<unsigned int>(iTime));
+  }
+  strQuery += ";";
+
   CSingleLock lock(m_critSection);
-  std::string strQuery = PrepareSQL("SELECT * FROM epgtags WHERE idEpg = %u;", epg.EpgID());
   if (ResultQuery(strQuery))
   {
     iReturn = 0;
@@ -303,6 +361,33 @@ int CPVREpgDatabase::Get(CPVREpg &epg)
   return iReturn;
 }
 
+CDateTime CPVREpgDatabase::GetLastStartTime(int iEpgId)
+{
+  CDateTime lastStart;
+
+  CSingleLock lock(m_critSection);
+  std::string strValue = GetSingleValue(PrepareSQL("SELECT MAX(iStartTime) FROM epgtags WHERE idEpg = %u", iEpgId));
+  time_t iStartTime = static_cast<time_t>(strtoll(strValue.c_str(), nullptr, 10));
+  if (iStartTime > 0)
+    lastStart = CDateTime(iStartTime);
+
+  return lastStart;
+}
+
+CDateTime CPVREpgDatabase::GetStartTime(int iEpgId, unsigned int iUniqueBroadcastId)
+{
+  CDateTime startTime;
+
+  CSingleLock lock(m_critSection);
+  std::string strWhereClause = PrepareSQL("idEpg = %u AND iBroadcastUid = %u", iEpgId, iUniqueBroadcastId);
+  std::string strValue = GetSingleValue("epgtags", "iStartTime", strWhereClause);
+  time_t iStartTime = static_cast<time_t>(strtoll(strValue.c_str(), nullptr, 10));
+  if (iStartTime > 0)
+    startTime = CDateTime(iStartTime);
+
+  return startTime;
+}
+
 bool CPVREpgDatabase::GetLastEpgScanTime(int iEpgId, CDateTime *lastScan)
 {
   bool bReturn = false;
@@ -360,61 +445,49 @@ int CPVREpgDatabase::Persist(const CPVREpg &epg, bool bQueueWrite /* = false */)
   return iReturn;
 }
 
-int CPVREpgDatabase::Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate /* = true */)
+std::string CPVREpgDatabase::GetTagValues(const CPVREpgInfoTag &tag, bool bWithId)
 {
-  int iReturn(-1);
-
-  if (tag.EpgID() <= 0)
-  {
-    CLog::Log(LOGERROR, "%s - tag '%s' does not have a valid table", __FUNCTION__, tag.Title(true).c_str());
-    return iReturn;
-  }
-
   time_t iStartTime, iEndTime, iFirstAired;
   tag.StartAsUTC().GetAsTime(iStartTime);
   tag.EndAsUTC().GetAsTime(iEndTime);
   tag.FirstAiredAsUTC().GetAsTime(iFirstAired);
 
-  int iBroadcastId = tag.BroadcastId();
-  std::string strQuery;
-
   /* Only store the genre string when needed */
   std::string strGenre = (tag.GenreType() == EPG_GENRE_USE_STRING) ? tag.DeTokenize(tag.Genre()) : "";
 
-  CSingleLock lock(m_critSection);
+  std::string strValues = PrepareSQL("(%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i",
+      tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
+      tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
+      tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
+      tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
+      tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
+      static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), tag.Notify(),
+      tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName(true).c_str(), tag.Flags(),
+      tag.UniqueBroadcastID());
+
+  if (bWithId)
+    strValues += PrepareSQL(", %i", tag.BroadcastId());
+
+  return strValues + ")";
+}
+
+int CPVREpgDatabase::Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate /* = true */)
+{
+  int iReturn(-1);
 
-  if (iBroadcastId < 0)
+  if (tag.EpgID() <= 0)
   {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
-        tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName(true).c_str(), tag.Flags(),
-        tag.UniqueBroadcastID());
+    CLog::Log(LOGERROR, "%s - tag '%s' does not have a valid table", __FUNCTION__, tag.Title(true).c_str());
+    return iReturn;
   }
+
+  CSingleLock lock(m_critSection);
+
+  std::string strQuery;
+  if (tag.BroadcastId() < 0)
+    strQuery = "REPLACE INTO epgtags (" EPG_TAG_COLUMNS ") VALUES " + GetTagValues(tag, false) + ";";
   else
-  {
-    strQuery = PrepareSQL("REPLACE INTO epgtags (idEpg, iStartTime, "
-        "iEndTime, sTitle, sPlotOutline, sPlot, sOriginalTitle, sCast, sDirector, sWriter, iYear, sIMDBNumber, "
-        "sIconPath, iGenreType, iGenreSubType, sGenre, iFirstAired, iParentalRating, iStarRating, bNotify, iSeriesId, "
-        "iEpisodeId, iEpisodePart, sEpisodeName, iFlags, iBroadcastUid, idBroadcast) "
-        "VALUES (%u, %u, %u, '%s', '%s', '%s', '%s', '%s', '%s', '%s', %i, '%s', '%s', %i, %i, '%s', %u, %i, %i, %i, %i, %i, %i, '%s', %i, %i, %i);",
-        tag.EpgID(), static_cast<unsigned int>(iStartTime), static_cast<unsigned int>(iEndTime),
-        tag.Title(true).c_str(), tag.PlotOutline(true).c_str(), tag.Plot(true).c_str(),
-        tag.OriginalTitle(true).c_str(), tag.DeTokenize(tag.Cast()).c_str(), tag.DeTokenize(tag.Directors()).c_str(),
-        tag.DeTokenize(tag.Writers()).c_str(), tag.Year(), tag.IMDBNumber().c_str(),
-        tag.Icon().c_str(), tag.GenreType(), tag.GenreSubType(), strGenre.c_str(),
-        static_cast<unsigned int>(iFirstAired), tag.ParentalRating(), tag.StarRating(), tag.Notify(),
-        tag.SeriesNumber(), tag.EpisodeNumber(), tag.EpisodePart(), tag.EpisodeName(true).c_str(), tag.Flags(),
-        tag.UniqueBroadcastID(), iBroadcastId);
-  }
+    strQuery = "REPLACE INTO epgtags (" EPG_TAG_COLUMNS ", idBroadcast) VALUES " + GetTagValues(tag, true) + ";";
 
   if (bSingleUpdate)
   {
@@ -430,6 +503,105 @@ int CPVREpgDatabase::Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate /* =
   return iReturn;
 }
 
+bool CPVREpgDatabase::QueuePersistTags(const std::vector<CPVREpgInfoTagPtr> &tags)
+{
+  bool bReturn(true);
+
+  CSingleLock lock(m_critSection);
+
+  /* tags that were stored before keep their ID, the others get a new one */
+  for (bool bWithId : { false, true })
+  {
+    const std::string strQuery = std::string("REPLACE INTO epgtags (" EPG_TAG_COLUMNS) + (bWithId ? ", idBroadcast" : "") + ") VALUES ";
+    std::string strValues;
+    unsigned int iRows(0);
+    for (const auto &tag : tags)
+    {
+      if ((tag->BroadcastId() >= 0) != bWithId)
+        continue;
+
+      if (tag->EpgID() <= 0)
+      {
+        CLog::Log(LOGERROR, "%s - tag '%s' does not have a valid table", __FUNCTION__, tag->Title(true).c_str());
+        continue;
+      }
+
+      if (iRows > 0)
+        strValues += ", ";
+      strValues += GetTagValues(*tag, bWithId);
+
+      if (++iRows == EPG_TAGS_PER_QUERY)
+      {
+        bReturn &= QueueInsertQuery(strQuery + strValues + ";");
+        strValues.clear();
+        iRows = 0;
+      }
+    }
+
+    if (iRows > 0)
+      bReturn &= QueueInsertQuery(strQuery + strValues + ";");
+  }
+
+  return bReturn;
+}
+
+bool CPVREpgDatabase::GetSearchMatches(const CPVREpgSearchFilter &filter, std::map<int, std::set<unsigned int>> &matches)
+{
+  if (filter.GetSearchTerm().empty())
+    return false;
+
+  CTextSearch search(filter.GetSearchTerm(), filter.IsCaseSensitive(), SEARCH_DEFAULT_OR);
+
+  /* an OR term the index can't match would make it miss entries the filter accepts */
+  for (const auto &term : search.GetOrTerms())
+  {
+    if (GetFullTextQuery({ term }).empty())
+      return false;
+  }
+
+  std::string strAnd = GetFullTextQuery(search.GetAndTerms(), true);
+  std::string strOr = GetFullTextQuery(search.GetOrTerms(), false);
+  if (strAnd.empty() && strOr.empty())
+    return false;
+
+  std::string strQuery;
+  if (strAnd.empty())
+    strQuery = "(" + strOr + ")";
+  else if (strOr.empty())
+    strQuery = "(" + strAnd + ")";
+  else
+    strQuery = "(" + strAnd + ") AND (" + strOr + ")";
+
+  if (!filter.ShouldSearchInDescription())
+    strQuery = "{sTitle sPlotOutline} : " + strQuery;
+
+  CSingleLock lock(m_critSection);
+  if (!HasFullTextIndex("epgsearch"))
+    return false;
+
+  try
+  {
+    std::string strSQL = PrepareSQL("SELECT epgtags.idEpg, epgtags.iBroadcastUid FROM epgsearch "
+                                    "JOIN epgtags ON epgtags.idBroadcast = epgsearch.rowid "
+                                    "WHERE epgsearch MATCH '%s'", strQuery.c_str());
+    if (!m_pDS->query(strSQL))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      matches[m_pDS->fv(0).get_asInt()].insert(static_cast<unsigned int>(m_pDS->fv(1).get_asInt()));
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "EpgDB - %s - couldn't search for '%s'", __FUNCTION__, filter.GetSearchTerm().c_str());
+  }
+  return false;
+}
+
 int CPVREpgDatabase::GetLastEPGId(void)
 {
   CSingleLock lock(m_critSection);
@@ -19,6 +19,11 @@
  *
  */
 
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
 #include "XBDateTime.h"
 #include "dbwrappers/Database.h"
 #include "threads/CriticalSection.h"
@@ -70,7 +75,7 @@ namespace PVR
      * @brief Get the minimal database version that is required to operate correctly.
      * @return The minimal database version.
      */
-    int GetSchemaVersion(void) const override { return 11; }
+    int GetSchemaVersion(void) const override { return 12; }
 
     /*!
      * @brief Get the default sqlite database filename.
@@ -108,6 +113,14 @@ namespace PVR
      */
     bool Delete(const CPVREpgInfoTag &tag);
 
+    /*!
+     * @brief Queue the removal of EPG entries of a table, with as few statements as possible.
+     * @param iEpgId The table the entries belong to.
+     * @param tags The entries to remove.
+     * @return True if the queries were queued successfully, false otherwise.
+     */
+    bool QueueDeleteTags(int iEpgId, const std::vector<CPVREpgInfoTagPtr> &tags);
+
     /*!
      * @brief Get all EPG tables from the database. Does not get the EPG tables' entries.
      * @param container The container to fill.
@@ -122,6 +135,30 @@ namespace PVR
      */
     int Get(CPVREpg &epg);
 
+    /*!
+     * @brief Get the EPG entries of a table that start within a time range.
+     * @param epg The EPG table to get the entries for.
+     * @param start Get the entries starting after this time. Invalid for no lower limit.
+     * @param end Get the entries starting at or before this time. Invalid for no upper limit.
+     * @return The amount of entries that was added.
+     */
+    int Get(CPVREpg &epg, const CDateTime &start, const CDateTime &end);
+
+    /*!
+     * @brief Get the start time of the last entry of a table.
+     * @param iEpgId The table.
+     * @return The start time, invalid if the table has no entries.
+     */
+    CDateTime GetLastStartTime(int iEpgId);
+
+    /*!
+     * @brief Get the start time of an entry of a table.
+     * @param iEpgId The table.
+     * @param iUniqueBroadcastId The unique broadcast id of the entry.
+     * @return The start time, invalid if the entry wasn't found.
+     */
+    CDateTime GetStartTime(int iEpgId, unsigned int iUniqueBroadcastId);
+
     /*!
      * @brief Get the last stored EPG scan time.
      * @param iEpgId The table to update the time for. Use 0 for a global value.
@@ -130,6 +167,15 @@ namespace PVR
      */
     bool GetLastEpgScanTime(int iEpgId, CDateTime *lastScan);
 
+    /*!
+     * @brief Look up the stored entries matching the search term of a filter in the full-text index.
+     * Terms only match the start of words here, so the entries found still have to pass the filter.
+     * @param filter The filter to get the search term from.
+     * @param matches The unique broadcast ids of the matching entries, per EPG table id.
+     * @return False if the index isn't available or can't be used for this search term, true otherwise.
+     */
+    bool GetSearchMatches(const CPVREpgSearchFilter &filter, std::map<int, std::set<unsigned int>> &matches);
+
     /*!
      * @brief Update the last scan time.
      * @param iEpgId The table to update the time for. Use 0 for a global value.
@@ -154,6 +200,13 @@ namespace PVR
      */
     int Persist(const CPVREpgInfoTag &tag, bool bSingleUpdate = true);
 
+    /*!
+     * @brief Queue the persisting of infotags, several of them per statement.
+     * @param tags The tags to persist.
+     * @return True if the queries were queued successfully, false otherwise.
+     */
+    bool QueuePersistTags(const std::vector<CPVREpgInfoTagPtr> &tags);
+
     /*!
      * @return Last EPG id in the database
      */
@@ -180,6 +233,14 @@ namespace PVR
 
     int GetMinSchemaVersion() const override { return 4; }
 
+    /*!
+     * @brief Get the column values of an infotag as they are written to the epgtags table.
+     * @param tag The tag.
+     * @param bWithId Include the database ID of the tag.
+     * @return The values, formatted for a VALUES clause.
+     */
+    std::string GetTagValues(const CPVREpgInfoTag &tag, bool bWithId);
+
     CCriticalSection m_critSection;
   };
 }
@@ -20,6 +20,7 @@
 
 #include "PVRRecordings.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "FileItem.h"
@@ -48,7 +49,8 @@ CPVRRecordings::CPVRRecordings(void) :
     m_bDeletedTVRecordings(false),
     m_bDeletedRadioRecordings(false),
     m_iTVRecordings(0),
-    m_iRadioRecordings(0)
+    m_iRadioRecordings(0),
+    m_bChanged(false)
 {
 }
 
@@ -58,12 +60,58 @@ CPVRRecordings::~CPVRRecordings()
     m_database->Close();
 }
 
-void CPVRRecordings::UpdateFromClients(void)
+bool CPVRRecordings::UpdateFromClients(void)
 {
   CSingleLock lock(m_critSection);
-  Unload();
-  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, false);
-  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, true);
+  m_bChanged = false;
+  m_updatedRecordings.clear();
+
+  std::vector<int> failedClients;
+  std::vector<int> failedClientsDeleted;
+  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, false, failedClients);
+  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, true, failedClientsDeleted);
+  failedClients.insert(failedClients.end(), failedClientsDeleted.begin(), failedClientsDeleted.end());
+
+  size_t iSize = m_recordings.size();
+  RemoveStaleRecordings(failedClients);
+  m_updatedRecordings.clear();
+
+  return m_bChanged || m_recordings.size() != iSize;
+}
+
+void CPVRRecordings::RemoveStaleRecordings(const std::vector<int> &failedClients)
+{
+  m_bDeletedTVRecordings = false;
+  m_bDeletedRadioRecordings = false;
+  m_iTVRecordings = 0;
+  m_iRadioRecordings = 0;
+
+  for (PVR_RECORDINGMAP_ITR it = m_recordings.begin(); it != m_recordings.end();)
+  {
+    if (m_updatedRecordings.find(it->first) == m_updatedRecordings.end() &&
+        std::find(failedClients.begin(), failedClients.end(), it->first.m_iClientId) == failedClients.end())
+    {
+      CLog::Log(LOGDEBUG, "CPVRRecordings - %s - removed recording '%s'", __FUNCTION__, it->second->m_strTitle.c_str());
+      it = m_recordings.erase(it);
+      continue;
+    }
+
+    const CPVRRecordingPtr &recording = it->second;
+    if (recording->IsDeleted())
+    {
+      if (recording->IsRadio())
+        m_bDeletedRadioRecordings = true;
+      else
+        m_bDeletedTVRecordings = true;
+    }
+
+    if (recording->IsRadio())
+      ++m_iRadioRecordings;
+    else
+      ++m_iTVRecordings;
+
+    ++it;
+  }
 }
 
 std::string CPVRRecordings::TrimSlashes(const std::string &strOrig) const
@@ -170,12 +218,18 @@ void CPVRRecordings::Update(void)
   lock.Leave();
 
   CLog::Log(LOGDEBUG, "CPVRRecordings - %s - updating recordings", __FUNCTION__);
-  UpdateFromClients();
+  bool bChanged = UpdateFromClients();
 
   lock.Enter();
   m_bIsUpdating = false;
   lock.Leave();
 
+  if (!bChanged)
+  {
+    CLog::Log(LOGDEBUG, "CPVRRecordings - %s - recordings unchanged", __FUNCTION__);
+    return;
+  }
+
   CServiceBroker::GetPVRManager().SetChanged();
   CServiceBroker::GetPVRManager().NotifyObservers(ObservableMessageRecordings);
   CServiceBroker::GetPVRManager().PublishEvent(RecordingsInvalidated);
@@ -433,9 +487,18 @@ void CPVRRecordings::UpdateFromClient(const CPVRRecordingPtr &tag)
       m_bDeletedTVRecordings = true;
   }
 
+  m_updatedRecordings.insert(CPVRRecordingUid(tag->m_iClientId, tag->m_strRecordingId));
+
   CPVRRecordingPtr newTag = GetById(tag->m_iClientId, tag->m_strRecordingId);
   if (newTag)
   {
+    /* the client doesn't know our id, it mustn't count as a change */
+    tag->m_iRecordingId = newTag->m_iRecordingId;
+    if (*newTag != *tag ||
+        newTag->GetLocalPlayCount() != tag->GetLocalPlayCount() ||
+        newTag->GetLocalResumePoint().timeInSeconds != tag->GetLocalResumePoint().timeInSeconds)
+      m_bChanged = true;
+
     newTag->Update(*tag);
   }
   else
@@ -454,6 +517,7 @@ void CPVRRecordings::UpdateFromClient(const CPVRRecordingPtr &tag)
     }
     newTag->m_iRecordingId = ++m_iLastId;
     m_recordings.insert(std::make_pair(CPVRRecordingUid(newTag->m_iClientId, newTag->m_strRecordingId), newTag));
+    m_bChanged = true;
     if (newTag->IsRadio())
       ++m_iRadioRecordings;
     else
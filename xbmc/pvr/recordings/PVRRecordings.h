@@ -21,6 +21,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 
 #include "FileItem.h"
 #include "video/VideoDatabase.h"
@@ -53,6 +54,8 @@ namespace PVR
 
     /**
      * @brief refresh the recordings list from the clients.
+     * Recordings that are already known are updated in place and keep their id, recordings the
+     * clients no longer return are removed. Observers are only notified if anything changed.
      */
     void Update(void);
 
@@ -109,8 +112,20 @@ namespace PVR
     bool m_bDeletedRadioRecordings;
     unsigned int m_iTVRecordings;
     unsigned int m_iRadioRecordings;
+    bool m_bChanged;                                  /*!< true if a recording was added or changed since the last update */
+    std::set<CPVRRecordingUid> m_updatedRecordings;   /*!< the recordings the clients returned during the running update */
 
-    void UpdateFromClients(void);
+    /**
+     * @brief get the recordings from the clients and merge them into the list.
+     * @return true if anything changed.
+     */
+    bool UpdateFromClients(void);
+
+    /**
+     * @brief remove the recordings that weren't returned during an update and count the rest.
+     * @param failedClients the clients that couldn't be asked, their recordings are kept.
+     */
+    void RemoveStaleRecordings(const std::vector<int> &failedClients);
     std::string TrimSlashes(const std::string &strOrig) const;
     bool IsDirectoryMember(const std::string &strDirectory, const std::string &strEntryDirectory, bool bGrouped) const;
     void GetSubDirectories(const CPVRRecordingsPath &recParentPath, CFileItemList *results);
@@ -933,6 +933,9 @@ CPVREpgInfoTagPtr CPVRTimerInfoTag::GetEpgInfoTag(bool bCreate /* = true */) con
       const CPVREpgPtr epg(channel->GetEPG());
       if (epg)
       {
+        // the tag may be further ahead than the epg keeps in memory
+        epg->LoadUntil(EndAsUTC() + CDateTimeSpan(0, 0, 2, 0));
+
         CSingleLock lock(m_critSection);
         if (!m_epgTag)
         {
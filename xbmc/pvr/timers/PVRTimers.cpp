@@ -48,7 +48,11 @@ bool CPVRTimersContainer::UpdateFromClient(const CPVRTimerInfoTagPtr &timer)
   {
     tag.reset(new CPVRTimerInfoTag());
     tag->m_iTimerId = ++m_iLastId;
+
+    // insert once the ids and the start time are set, they are the keys
+    bool bReturn = tag->UpdateEntry(timer);
     InsertTimer(tag);
+    return bReturn;
   }
 
   return tag->UpdateEntry(timer);
@@ -57,16 +61,9 @@ bool CPVRTimersContainer::UpdateFromClient(const CPVRTimerInfoTagPtr &timer)
 CPVRTimerInfoTagPtr CPVRTimersContainer::GetByClient(int iClientId, unsigned int iClientTimerId) const
 {
   CSingleLock lock(m_critSection);
-  for (const auto startDates : m_tags)
-  {
-    for (const auto timer : startDates.second)
-    {
-      if (timer->m_iClientId == iClientId && timer->m_iClientIndex == iClientTimerId)
-      {
-        return timer;
-      }
-    }
-  }
+  const auto it = m_timersByClient.find(std::make_pair(iClientId, iClientTimerId));
+  if (it != m_timersByClient.end())
+    return it->second;
 
   return CPVRTimerInfoTagPtr();
 }
@@ -83,6 +80,8 @@ void CPVRTimersContainer::InsertTimer(const CPVRTimerInfoTagPtr &newTimer)
   {
     it->second.emplace_back(newTimer);
   }
+
+  m_timersByClient[std::make_pair(newTimer->m_iClientId, newTimer->m_iClientIndex)] = newTimer;
 }
 
 CPVRTimers::CPVRTimers(void)
@@ -94,7 +93,8 @@ CPVRTimers::CPVRTimers(void)
     CSettings::SETTING_PVRPOWERMANAGEMENT_DAILYWAKEUPTIME,
     CSettings::SETTING_PVRRECORD_TIMERNOTIFICATIONS,
     CSettings::SETTING_PVRTIMERS_HIDEDISABLEDTIMERS
-  })
+  }),
+  m_bTimersByChannelValid(false)
 {
 }
 
@@ -122,6 +122,9 @@ void CPVRTimers::Unload()
   // remove all tags
   CSingleLock lock(m_critSection);
   m_tags.clear();
+  m_timersByClient.clear();
+  m_timersByChannel.clear();
+  m_bTimersByChannelValid = false;
 }
 
 bool CPVRTimers::Update(void)
@@ -283,6 +286,7 @@ bool CPVRTimers::UpdateEntries(const CPVRTimersContainer &timers, const std::vec
 
         ClearEpgTagTimer(timer);
 
+        m_timersByClient.erase(std::make_pair(timer->m_iClientId, timer->m_iClientIndex));
         it2 = it->second.erase(it2);
 
         bChanged = true;
@@ -341,6 +345,7 @@ bool CPVRTimers::UpdateEntries(const CPVRTimersContainer &timers, const std::vec
   m_bIsUpdating = false;
   if (bChanged)
   {
+    m_bTimersByChannelValid = false;
     UpdateChannels();
     lock.Leave();
 
@@ -760,29 +765,39 @@ CPVRTimerInfoTagPtr CPVRTimers::GetTimerForEpgTag(const CPVREpgInfoTagPtr &epgTa
     if (channel)
     {
       CSingleLock lock(m_critSection);
+      const std::map<int, VecTimerInfoTag> &timersByChannel = GetTimersByChannel();
 
-      for (const auto &tagsEntry : m_tags)
+      // timers without a channel can only match by their epg tag
+      const auto noChannelTimers = timersByChannel.find(PVR_CHANNEL_INVALID_UID);
+      if (noChannelTimers != timersByChannel.end())
       {
-        for (const auto &timersEntry : tagsEntry.second)
+        for (const auto &timersEntry : noChannelTimers->second)
         {
-          if (timersEntry->IsTimerRule())
-            continue;
+          if (timersEntry->GetEpgInfoTag(false) == epgTag)
+            return timersEntry;
+        }
+      }
+
+      const auto channelTimers = timersByChannel.find(channel->UniqueID());
+      if (channelTimers != timersByChannel.end() && channel->UniqueID() != PVR_CHANNEL_INVALID_UID)
+      {
+        for (const auto &timersEntry : channelTimers->second)
+        {
+          // sorted by start, no later timer can cover the tag or belong to it
+          if (!timersEntry->m_bStartAnyTime && timersEntry->StartAsUTC() > epgTag->EndAsUTC())
+            break;
 
           if (timersEntry->GetEpgInfoTag(false) == epgTag)
             return timersEntry;
 
-          if (timersEntry->m_iClientChannelUid != PVR_CHANNEL_INVALID_UID &&
-              timersEntry->m_iClientChannelUid == channel->UniqueID())
-          {
-            if (timersEntry->UniqueBroadcastID() != EPG_TAG_INVALID_UID &&
-                timersEntry->UniqueBroadcastID() == epgTag->UniqueBroadcastID())
-              return timersEntry;
-
-            if (timersEntry->m_bIsRadio == channel->IsRadio() &&
-                timersEntry->StartAsUTC() <= epgTag->StartAsUTC() &&
-                timersEntry->EndAsUTC() >= epgTag->EndAsUTC())
-              return timersEntry;
-          }
+          if (timersEntry->UniqueBroadcastID() != EPG_TAG_INVALID_UID &&
+              timersEntry->UniqueBroadcastID() == epgTag->UniqueBroadcastID())
+            return timersEntry;
+
+          if (timersEntry->m_bIsRadio == channel->IsRadio() &&
+              timersEntry->StartAsUTC() <= epgTag->StartAsUTC() &&
+              timersEntry->EndAsUTC() >= epgTag->EndAsUTC())
+            return timersEntry;
         }
       }
     }
@@ -825,21 +840,27 @@ CPVRTimerInfoTagPtr CPVRTimers::GetTimerRule(const CPVRTimerInfoTagPtr &timer) c
   {
     unsigned int iRuleId = timer->GetTimerRuleId();
     if (iRuleId != PVR_TIMER_NO_PARENT)
-    {
-      int iClientId = timer->m_iClientId;
+      return GetByClient(timer->m_iClientId, iRuleId);
+  }
+  return CPVRTimerInfoTagPtr();
+}
 
-      CSingleLock lock(m_critSection);
-      for (const auto &tagsEntry : m_tags)
+const std::map<int, CPVRTimers::VecTimerInfoTag>& CPVRTimers::GetTimersByChannel(void) const
+{
+  if (!m_bTimersByChannelValid)
+  {
+    m_timersByChannel.clear();
+    for (const auto &tagsEntry : m_tags)
+    {
+      for (const auto &timersEntry : tagsEntry.second)
       {
-        for (const auto &timersEntry : tagsEntry.second)
-        {
-          if (timersEntry->m_iClientId == iClientId && timersEntry->m_iClientIndex == iRuleId)
-            return timersEntry;
-        }
+        if (!timersEntry->IsTimerRule())
+          m_timersByChannel[timersEntry->m_iClientChannelUid].emplace_back(timersEntry);
       }
     }
+    m_bTimersByChannelValid = true;
   }
-  return CPVRTimerInfoTagPtr();
+  return m_timersByChannel;
 }
 
 CFileItemPtr CPVRTimers::GetTimerRule(const CFileItemPtr &item) const
@@ -70,11 +70,14 @@ namespace PVR
     const MapTags& GetTags() const { return m_tags; }
 
   protected:
+    typedef std::map<std::pair<int, unsigned int>, CPVRTimerInfoTagPtr> MapTimersByClient;
+
     void InsertTimer(const CPVRTimerInfoTagPtr &newTimer);
 
     CCriticalSection m_critSection;
     unsigned int m_iLastId;
     MapTags m_tags;
+    MapTimersByClient m_timersByClient; /*!< the timers in m_tags, by client id and client index */
   };
 
   class CPVRTimers : public CPVRTimersContainer, public Observer
@@ -303,6 +306,13 @@ namespace PVR
     bool SetEpgTagTimer(const CPVRTimerInfoTagPtr &timer);
     bool ClearEpgTagTimer(const CPVRTimerInfoTagPtr &timer);
 
+    /*!
+     * @brief Get the timers that aren't timer rules by client channel uid, rebuilt after timers changed.
+     * Must be called with m_critSection held.
+     * @return The timers of each channel, sorted by start time.
+     */
+    const std::map<int, VecTimerInfoTag>& GetTimersByChannel(void) const;
+
     enum TimerKind
     {
       TimerKindAny = 0,
@@ -319,6 +329,8 @@ namespace PVR
 
     bool m_bIsUpdating;
     CPVRSettings m_settings;
+    mutable std::map<int, VecTimerInfoTag> m_timersByChannel; /*!< see GetTimersByChannel */
+    mutable bool m_bTimersByChannelValid;                      /*!< false if m_timersByChannel has to be rebuilt */
   };
 
   class CPVRTimersPath
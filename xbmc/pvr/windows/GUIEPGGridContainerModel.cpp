@@ -157,7 +157,6 @@ void CGUIEPGGridContainerModel::Refresh(const std::unique_ptr<CFileItemList> &it
 
   ////////////////////////////////////////////////////////////////////////
   // Create epg grid
-  const CDateTimeSpan blockDuration(0, 0, MINSPERBLOCK, 0);
   const CDateTimeSpan gridDuration(m_gridEnd - m_gridStart);
   m_blocks = (gridDuration.GetDays() * 24 * 60 + gridDuration.GetHours() * 60 + gridDuration.GetMinutes()) / MINSPERBLOCK;
   if (m_blocks >= MAXBLOCKS)
@@ -165,111 +164,123 @@ void CGUIEPGGridContainerModel::Refresh(const std::unique_ptr<CFileItemList> &it
   else if (m_blocks < iBlocksPerPage)
     m_blocks = iBlocksPerPage;
 
-  m_gridIndex.reserve(m_channelItems.size());
-  const std::vector<GridItem> blocks(m_blocks);
-
-  for (size_t channel = 0; channel < m_channelItems.size(); ++channel)
-  {
-    m_gridIndex.emplace_back(blocks);
+  /* the rows of the grid are computed when they are first needed, opening the guide
+     would otherwise have to lay out every channel for the whole epg range up front */
+  m_fBlockSize = fBlockSize;
+  m_gridIndex.resize(m_channelItems.size());
+}
 
-    CDateTime gridCursor(m_gridStart); //reset cursor for new channel
-    unsigned long progIdx = m_epgItemsPtr[channel].start;
-    unsigned long lastIdx = m_epgItemsPtr[channel].stop;
-    int iEpgId            = m_programmeItems[progIdx]->GetEPGInfoTag()->EpgID();
-    int itemSize          = 1; // size of the programme in blocks
-    int savedBlock        = 0;
-    CFileItemPtr item;
-    CPVREpgInfoTagPtr tag;
+std::vector<GridItem> &CGUIEPGGridContainerModel::GetGridRow(int iChannel) const
+{
+  std::vector<GridItem> &row = m_gridIndex[iChannel];
+  if (row.empty())
+    CreateGridRow(iChannel, row);
+  return row;
+}
 
-    for (int block = 0; block < m_blocks; ++block)
+void CGUIEPGGridContainerModel::CreateGridRow(size_t channel, std::vector<GridItem> &row) const
+{
+  const CDateTimeSpan blockDuration(0, 0, MINSPERBLOCK, 0);
+  const float fBlockSize = m_fBlockSize;
+  row.resize(m_blocks);
+
+  CDateTime gridCursor(m_gridStart); //reset cursor for new channel
+  unsigned long progIdx = m_epgItemsPtr[channel].start;
+  unsigned long lastIdx = m_epgItemsPtr[channel].stop;
+  int iEpgId            = m_programmeItems[progIdx]->GetEPGInfoTag()->EpgID();
+  int itemSize          = 1; // size of the programme in blocks
+  int savedBlock        = 0;
+  CFileItemPtr item;
+  CPVREpgInfoTagPtr tag;
+
+  for (int block = 0; block < m_blocks; ++block)
+  {
+    while (progIdx <= lastIdx)
     {
-      while (progIdx <= lastIdx)
-      {
-        item = m_programmeItems[progIdx];
-        tag = item->GetEPGInfoTag();
+      item = m_programmeItems[progIdx];
+      tag = item->GetEPGInfoTag();
 
-        // Note: Start block of an event is start-time-based calculated block + 1,
-        //       unless start times matches exactly the begin of a block.
+      // Note: Start block of an event is start-time-based calculated block + 1,
+      //       unless start times matches exactly the begin of a block.
 
-        if (tag->EpgID() != iEpgId || gridCursor < tag->StartAsUTC() || m_gridEnd <= tag->StartAsUTC())
-          break;
+      if (tag->EpgID() != iEpgId || gridCursor < tag->StartAsUTC() || m_gridEnd <= tag->StartAsUTC())
+        break;
 
-        if (gridCursor < tag->EndAsUTC())
-        {
-          m_gridIndex[channel][block].item = item;
-          m_gridIndex[channel][block].progIndex = progIdx;
-          break;
-        }
-
-        progIdx++;
+      if (gridCursor < tag->EndAsUTC())
+      {
+        row[block].item = item;
+        row[block].progIndex = progIdx;
+        break;
       }
 
-      gridCursor += blockDuration;
+      progIdx++;
+    }
 
-      if (block == 0)
-        continue;
+    gridCursor += blockDuration;
 
-      const CFileItemPtr prevItem(m_gridIndex[channel][block - 1].item);
-      const CFileItemPtr currItem(m_gridIndex[channel][block].item);
+    if (block == 0)
+      continue;
 
-      if (block == m_blocks - 1 || prevItem != currItem)
+    const CFileItemPtr prevItem(row[block - 1].item);
+    const CFileItemPtr currItem(row[block].item);
+
+    if (block == m_blocks - 1 || prevItem != currItem)
+    {
+      // special handling for last block.
+      int blockDelta = -1;
+      int sizeDelta = 0;
+      if (block == m_blocks - 1 && prevItem == currItem)
       {
-        // special handling for last block.
-        int blockDelta = -1;
-        int sizeDelta = 0;
-        if (block == m_blocks - 1 && prevItem == currItem)
+        itemSize++;
+        blockDelta = 0;
+        sizeDelta = 1;
+      }
+
+      if (prevItem)
+      {
+        row[savedBlock].item->SetProperty("GenreType", prevItem->GetEPGInfoTag()->GenreType());
+      }
+      else
+      {
+        CPVREpgInfoTagPtr gapTag(CPVREpgInfoTag::CreateDefaultTag());
+        gapTag->SetChannel(m_channelItems[channel]->GetPVRChannelInfoTag());
+        CFileItemPtr gapItem(new CFileItem(gapTag));
+        for (int i = block + blockDelta; i >= block - itemSize + sizeDelta; --i)
         {
-          itemSize++;
-          blockDelta = 0;
-          sizeDelta = 1;
+          row[i].item = gapItem;
         }
+      }
 
-        if (prevItem)
+      float fItemWidth = itemSize * fBlockSize;
+      row[savedBlock].originWidth = fItemWidth;
+      row[savedBlock].width = fItemWidth;
+
+      itemSize = 1;
+      savedBlock = block;
+
+      // special handling for last block.
+      if (block == m_blocks - 1 && prevItem != currItem)
+      {
+        if (currItem)
         {
-          m_gridIndex[channel][savedBlock].item->SetProperty("GenreType", prevItem->GetEPGInfoTag()->GenreType());
+          row[savedBlock].item->SetProperty("GenreType", currItem->GetEPGInfoTag()->GenreType());
         }
         else
         {
           CPVREpgInfoTagPtr gapTag(CPVREpgInfoTag::CreateDefaultTag());
           gapTag->SetChannel(m_channelItems[channel]->GetPVRChannelInfoTag());
           CFileItemPtr gapItem(new CFileItem(gapTag));
-          for (int i = block + blockDelta; i >= block - itemSize + sizeDelta; --i)
-          {
-            m_gridIndex[channel][i].item = gapItem;
-          }
+          row[block].item = gapItem;
         }
 
-        float fItemWidth = itemSize * fBlockSize;
-        m_gridIndex[channel][savedBlock].originWidth = fItemWidth;
-        m_gridIndex[channel][savedBlock].width = fItemWidth;
-
-        itemSize = 1;
-        savedBlock = block;
-
-        // special handling for last block.
-        if (block == m_blocks - 1 && prevItem != currItem)
-        {
-          if (currItem)
-          {
-            m_gridIndex[channel][savedBlock].item->SetProperty("GenreType", currItem->GetEPGInfoTag()->GenreType());
-          }
-          else
-          {
-            CPVREpgInfoTagPtr gapTag(CPVREpgInfoTag::CreateDefaultTag());
-            gapTag->SetChannel(m_channelItems[channel]->GetPVRChannelInfoTag());
-            CFileItemPtr gapItem(new CFileItem(gapTag));
-            m_gridIndex[channel][block].item = gapItem;
-          }
-
-          m_gridIndex[channel][savedBlock].originWidth = fBlockSize; // size always 1 block here
-          m_gridIndex[channel][savedBlock].width = fBlockSize;
-        }
-      }
-      else
-      {
-        itemSize++;
+        row[savedBlock].originWidth = fBlockSize; // size always 1 block here
+        row[savedBlock].width = fBlockSize;
       }
     }
+    else
+    {
+      itemSize++;
+    }
   }
 }
 
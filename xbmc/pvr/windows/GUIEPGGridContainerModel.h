@@ -49,7 +49,7 @@ namespace PVR
     static const int MINSPERBLOCK = 5; // minutes
     static const int MAXBLOCKS = 33 * 24 * 60 / MINSPERBLOCK; //! 33 days of 5 minute blocks (31 days for upcoming data + 1 day for past data + 1 day for fillers)
 
-    CGUIEPGGridContainerModel() : m_blocks(0) {}
+    CGUIEPGGridContainerModel() : m_blocks(0), m_fBlockSize(0.0f) {}
     virtual ~CGUIEPGGridContainerModel() { Reset(); }
 
     void Refresh(const std::unique_ptr<CFileItemList> &items, const CDateTime &gridStart, const CDateTime &gridEnd, int iRulerUnit, int iBlocksPerPage, float fBlockSize);
@@ -75,12 +75,12 @@ namespace PVR
 
     int GetBlockCount() const { return m_blocks; }
     bool HasGridItems() const { return !m_gridIndex.empty(); }
-    GridItem *GetGridItemPtr(int iChannel, int iBlock) { return &m_gridIndex[iChannel][iBlock]; }
-    CFileItemPtr GetGridItem(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].item; }
-    float GetGridItemWidth(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].width; }
-    float GetGridItemOriginWidth(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].originWidth; }
-    int GetGridItemIndex(int iChannel, int iBlock) const { return m_gridIndex[iChannel][iBlock].progIndex; }
-    void SetGridItemWidth(int iChannel, int iBlock, float fWidth) { m_gridIndex[iChannel][iBlock].width = fWidth; }
+    GridItem *GetGridItemPtr(int iChannel, int iBlock) { return &GetGridRow(iChannel)[iBlock]; }
+    CFileItemPtr GetGridItem(int iChannel, int iBlock) const { return GetGridRow(iChannel)[iBlock].item; }
+    float GetGridItemWidth(int iChannel, int iBlock) const { return GetGridRow(iChannel)[iBlock].width; }
+    float GetGridItemOriginWidth(int iChannel, int iBlock) const { return GetGridRow(iChannel)[iBlock].originWidth; }
+    int GetGridItemIndex(int iChannel, int iBlock) const { return GetGridRow(iChannel)[iBlock].progIndex; }
+    void SetGridItemWidth(int iChannel, int iBlock, float fWidth) { GetGridRow(iChannel)[iBlock].width = fWidth; }
 
     bool IsZeroGridDuration() const { return (m_gridEnd - m_gridStart) == CDateTimeSpan(0, 0, 0, 0); }
     const CDateTime &GetGridStart() const { return m_gridStart; }
@@ -99,6 +99,14 @@ namespace PVR
     void FreeItemsMemory();
     void Reset();
 
+    /*!
+     * @brief Get the blocks of a channel, laying them out on first use.
+     * @param iChannel The index of the channel.
+     * @return The blocks. Rows stay in place once created, pointers to their items stay valid until the next Refresh.
+     */
+    std::vector<GridItem> &GetGridRow(int iChannel) const;
+    void CreateGridRow(size_t channel, std::vector<GridItem> &row) const;
+
     struct ItemsPtr
     {
       long start;
@@ -112,8 +120,9 @@ namespace PVR
     std::vector<CFileItemPtr> m_channelItems;
     std::vector<CFileItemPtr> m_rulerItems;
     std::vector<ItemsPtr> m_epgItemsPtr;
-    std::vector<std::vector<GridItem> > m_gridIndex;
+    mutable std::vector<std::vector<GridItem> > m_gridIndex; //! one row per channel, empty until it is needed
 
     int m_blocks;
+    float m_fBlockSize;
   };
 }
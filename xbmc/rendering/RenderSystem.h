@@ -76,6 +76,12 @@ public:
 
   virtual bool TestRender() = 0;
 
+  /**
+   * Draw the GUI textures queued for batching. Needed before rendering
+   * that doesn't go through the render system, e.g. video renderers
+   */
+  virtual void FlushBatch() {}
+
   /**
    * Project (x,y,z) 3d scene coordinates to (x,y) 2d screen coordinates
    */
@@ -22,6 +22,7 @@
 #include "filesystem/File.h"
 #include "windowing/GraphicContext.h"
 #include "settings/AdvancedSettings.h"
+#include "guilib/GUITextureGL.h"
 #include "guilib/MatrixGLES.h"
 #include "settings/DisplaySettings.h"
 #include "utils/log.h"
@@ -230,6 +231,8 @@ bool CRenderSystemGL::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  FlushBatch();
+
   return true;
 }
 
@@ -238,6 +241,8 @@ bool CRenderSystemGL::ClearBuffers(UTILS::Color color)
   if (!m_bRenderCreated)
     return false;
 
+  FlushBatch();
+
   /* clear is not affected by stipple pattern, so we can only clear on first frame */
   if(m_stereoMode == RENDER_STEREO_MODE_INTERLACED && m_stereoView == RENDER_STEREO_VIEW_RIGHT)
     return true;
@@ -320,6 +325,8 @@ void CRenderSystemGL::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   glMatrixProject.Push();
   glMatrixModview.Push();
   glMatrixTexture.Push();
@@ -487,6 +494,8 @@ void CRenderSystemGL::SetViewPort(const CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   m_viewPort[0] = viewPort.x1;
@@ -521,6 +530,9 @@ void CRenderSystemGL::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  FlushBatch();
+
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -590,6 +602,7 @@ static const GLubyte stipple_3d[] = {
 
 void CRenderSystemGL::SetStereoMode(RENDER_STEREO_MODE mode, RENDER_STEREO_VIEW view)
 {
+  FlushBatch();
   CRenderSystemBase::SetStereoMode(mode, view);
 
   glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
@@ -761,6 +774,7 @@ void CRenderSystemGL::ReleaseShaders()
 
 void CRenderSystemGL::EnableShader(ESHADERMETHOD method)
 {
+  FlushBatch();
   m_method = method;
   if (m_pShader[m_method])
   {
@@ -772,6 +786,11 @@ void CRenderSystemGL::EnableShader(ESHADERMETHOD method)
   }
 }
 
+void CRenderSystemGL::FlushBatch()
+{
+  CGUITextureGL::Flush();
+}
+
 void CRenderSystemGL::DisableShader()
 {
   if (m_pShader[m_method])
@@ -74,6 +74,7 @@ public:
   bool SupportsNPOT(bool dxt) const override;
 
   bool TestRender() override;
+  void FlushBatch() override;
 
   void Project(float &x, float &y, float &z) override;
 
@@ -21,6 +21,7 @@
 #include "windowing/GraphicContext.h"
 #include "settings/AdvancedSettings.h"
 #include "RenderSystemGLES.h"
+#include "guilib/GUITextureGLES.h"
 #include "guilib/MatrixGLES.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -167,6 +168,8 @@ bool CRenderSystemGLES::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  FlushBatch();
+
   return true;
 }
 
@@ -175,6 +178,8 @@ bool CRenderSystemGLES::ClearBuffers(UTILS::Color color)
   if (!m_bRenderCreated)
     return false;
 
+  FlushBatch();
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -266,6 +271,8 @@ void CRenderSystemGLES::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   glMatrixProject.Push();
   glMatrixModview.Push();
   glMatrixTexture.Push();
@@ -417,6 +424,8 @@ void CRenderSystemGLES::SetViewPort(const CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   m_viewPort[0] = viewPort.x1;
@@ -451,6 +460,9 @@ void CRenderSystemGLES::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  FlushBatch();
+
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -641,6 +653,7 @@ void CRenderSystemGLES::ReleaseShaders()
 
 void CRenderSystemGLES::EnableGUIShader(ESHADERMETHOD method)
 {
+  FlushBatch();
   m_method = method;
   if (m_pShader[m_method])
   {
@@ -652,6 +665,11 @@ void CRenderSystemGLES::EnableGUIShader(ESHADERMETHOD method)
   }
 }
 
+void CRenderSystemGLES::FlushBatch()
+{
+  CGUITextureGLES::Flush();
+}
+
 void CRenderSystemGLES::DisableGUIShader()
 {
   if (m_pShader[m_method])
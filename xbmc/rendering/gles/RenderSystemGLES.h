@@ -78,6 +78,7 @@ public:
   bool SupportsStereo(RENDER_STEREO_MODE mode) const override;
 
   bool TestRender() override;
+  void FlushBatch() override;
 
   void Project(float &x, float &y, float &z) override;
 
@@ -145,6 +145,9 @@ void CAdvancedSettings::Initialize()
   m_videoPlayCountMinimumPercent = 90.0f;
   m_videoVDPAUScaling = -1;
   m_videoVAAPIforced = false;
+  m_videoDecodeThreads = 0;
+  m_videoDecodeThreadType = 0;
+  m_videoPredictiveDrop = false;
   m_videoNonLinStretchRatio = 0.5f;
   m_videoEnableHighQualityHwScalers = false;
   m_videoAutoScaleMaxFps = 30.0f;
@@ -172,10 +175,13 @@ void CAdvancedSettings::Initialize()
   m_musicPercentSeekBackward = -1;
   m_musicPercentSeekForwardBig = 10;
   m_musicPercentSeekBackwardBig = -10;
+  m_musicPrefetchTime = 5;
+  m_musicPrefetchTimeRemote = 20;
 
   m_slideshowPanAmount = 2.5f;
   m_slideshowZoomAmount = 5.0f;
   m_slideshowBlackBarCompensation = 20.0f;
+  m_slideshowPrefetch = 2;
 
   m_songInfoDuration = 10;
 
@@ -263,10 +269,18 @@ void CAdvancedSettings::Initialize()
   m_fanartRes = 1080;
   m_imageRes = 720;
   m_imageScalingAlgorithm = CPictureScalingAlgorithm::Default;
+  m_useDDSFanart = false;
+  m_artPrecacheJobs = 2;
+  m_artPrecacheDelay = 0;
 
   m_sambaclienttimeout = 30;
   m_sambadoscodepage = "";
   m_sambastatfiles = true;
+  m_sambareadsize = 2048;
+  m_sambaidletimeout = 90;
+
+  m_nfsreaddepth = 4;
+  m_nfsreadsize = 0;
 
   m_bHTTPDirectoryStatFilesize = false;
 
@@ -279,11 +293,13 @@ void CAdvancedSettings::Initialize()
 
   m_bMusicLibraryAllItemsOnBottom = false;
   m_bMusicLibraryCleanOnUpdate = false;
+  m_bMusicLibraryAnalyzeReplayGain = false;
   m_bMusicLibraryArtistSortOnUpdate = false;
   m_iMusicLibraryRecentlyAddedItems = 25;
   m_strMusicLibraryAlbumFormat = "";
   m_prioritiseAPEv2tags = false;
   m_musicUseArtistSortName = false;
+  m_musicLibraryTagReaders = 4;
   m_musicItemSeparator = " / ";
   m_musicArtistSeparators = { ";", " feat. ", " ft. " };
   m_videoItemSeparator = " / ";
@@ -297,6 +313,8 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryImportWatchedState = false;
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
+  m_videoScannerListingsPerHost = 2;
+  m_videoScannerLookupsPerScraper = 2;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
 
   m_iEpgUpdateCheckInterval = 300; /* check if tables need to be updated every 5 minutes */
@@ -306,6 +324,8 @@ void CAdvancedSettings::Initialize()
   m_iEpgUpdateEmptyTagsInterval = 60; /* override user selectable EPG update interval for empty EPG tags */
   m_bEpgDisplayUpdatePopup = true; /* display a progress popup while updating EPG data from clients */
   m_bEpgDisplayIncrementalUpdatePopup = false; /* also display a progress popup while doing incremental EPG updates */
+  m_iEpgMemoryWindow = 24; /* keep the guide data of the next 24 hours in memory, page in the rest on demand */
+  m_iEpgUpdatesPerClient = 4; /* update the tables of up to 4 channels of a client at once */
 
   m_bEdlMergeShortCommBreaks = false;      // Off by default
   m_iEdlMaxCommBreakLength = 8 * 30 + 10;  // Just over 8 * 30 second commercial break.
@@ -324,8 +344,11 @@ void CAdvancedSettings::Initialize()
   m_curlconnecttimeout = 30;
   m_curllowspeedtime = 20;
   m_curlretries = 2;
+  m_curlParallelRanges = 0;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
+  m_curlDisableHTTP2 = false;
+  m_httpCacheSize = 50;
 
 #if defined(TARGET_DARWIN_IOS)
   m_startFullScreen = true;
@@ -359,12 +382,20 @@ void CAdvancedSettings::Initialize()
   m_bPVRChannelIconsAutoScan       = true;
   m_bPVRAutoScanIconsUserSet       = false;
   m_iPVRNumericChannelSwitchTimeout = 2000;
+  m_bPVRFastZap                    = false;
+  m_bPVRWarmStart                  = false;
+  m_iPVRTimeshiftBufferSize        = 0;
 
   m_cacheMemSize = 1024 * 1024 * 20;
+  m_cachePersistentSize = 0;
   m_cacheBufferMode = CACHE_BUFFER_MODE_INTERNET; // Default (buffer all internet streams/filesystems)
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  m_cacheReadAheadTime = 0.0f;
+  m_cacheBypassPageCache = false;
+  // seconds of demuxed data read ahead on a separate thread, 0 disables it
+  m_cacheDemuxReadAhead = 0.0f;
 
   m_addonPackageFolderSize = 200;
 
@@ -379,9 +410,20 @@ void CAdvancedSettings::Initialize()
   m_guiSmartRedraw = false;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
+  m_airTunesMaxLatency = 250;
 
   m_databaseMusic.Reset();
   m_databaseVideo.Reset();
+  m_databaseTV.Reset();
+  m_databaseEpg.Reset();
+  m_databaseSavestates.Reset();
+  m_databaseTextures.Reset();
+  m_databaseAddons.Reset();
+  m_databaseProfiling = false;
+  m_databaseSlowQueryTime = 0;
+  // the libraries are the large, read heavy databases
+  m_databaseMusic.mmapSize = 64;
+  m_databaseVideo.mmapSize = 64;
 
   m_pictureExtensions = ".png|.jpg|.jpeg|.bmp|.gif|.ico|.tif|.tiff|.tga|.pcx|.cbz|.zip|.rss|.webp|.jp2|.apng";
   m_musicExtensions = ".nsv|.m4a|.flac|.aac|.strm|.pls|.rm|.rma|.mpa|.wav|.wma|.ogg|.mp3|.mp2|.m3u|.gdm|.imf|.m15|.sfx|.uni|.ac3|.dts|.cue|.aif|.aiff|.wpl|.ape|.mac|.mpc|.mp+|.mpp|.shn|.zip|.wv|.dsp|.xsp|.xwav|.waa|.wvs|.wam|.gcm|.idsp|.mpdsp|.mss|.spt|.rsd|.sap|.cmc|.cmr|.dmc|.mpt|.mpd|.rmt|.tmc|.tm8|.tm2|.oga|.url|.pxml|.tta|.rss|.wtv|.mka|.tak|.opus|.dff|.dsf|.m4b";
@@ -401,6 +443,11 @@ void CAdvancedSettings::Initialize()
   m_allowUseSeparateDeviceForDecoding = false;
 
   m_videoAssFixedWorks = false;
+  m_videoAssLookAhead = 0;
+  m_videoAccurateSeek = false;
+  m_videoSeekPreview = false;
+  m_videoRenderTimings = false;
+  m_videoPreOpenNext = false;
 
   m_logLevelHint = m_logLevel = LOG_LEVEL_NORMAL;
   m_extraLogEnabled = false;
@@ -517,6 +564,10 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "percentseekforwardbig", m_musicPercentSeekForwardBig, 0, 100);
     XMLUtils::GetInt(pElement, "percentseekbackwardbig", m_musicPercentSeekBackwardBig, -100, 0);
 
+    // seconds before the end of a song the next one is opened, network shares may need to spin up
+    XMLUtils::GetInt(pElement, "prefetchtime", m_musicPrefetchTime, 1, 300);
+    XMLUtils::GetInt(pElement, "prefetchtimeremote", m_musicPrefetchTimeRemote, 1, 300);
+
     TiXmlElement* pAudioExcludes = pElement->FirstChildElement("excludefromlisting");
     if (pAudioExcludes)
       GetCustomRegexps(pAudioExcludes, m_audioExcludeFromListingRegExps);
@@ -542,6 +593,12 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "assfixedworks", m_videoAssFixedWorks);
+    // number of ass subtitle frames rendered ahead on a worker thread, 0 = off
+    XMLUtils::GetUInt(pElement, "asslookahead", m_videoAssLookAhead, 0, 30);
+    XMLUtils::GetBoolean(pElement, "accurateseek", m_videoAccurateSeek);
+    XMLUtils::GetBoolean(pElement, "seekpreview", m_videoSeekPreview);
+    XMLUtils::GetBoolean(pElement, "rendertimings", m_videoRenderTimings);
+    XMLUtils::GetBoolean(pElement, "preopennext", m_videoPreOpenNext);
     XMLUtils::GetString(pElement, "stereoscopicregex3d", m_stereoscopicregex_3d);
     XMLUtils::GetString(pElement, "stereoscopicregexsbs", m_stereoscopicregex_sbs);
     XMLUtils::GetString(pElement, "stereoscopicregextab", m_stereoscopicregex_tab);
@@ -588,6 +645,12 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     // There is a large amount of drivers implementing VAAPI in a non stable way
     // the forcevaapienabled setting let's the user decide to use it nevertheless
     XMLUtils::GetBoolean(pElement, "forcevaapienabled", m_videoVAAPIforced);
+    // software decoding threads, 0 = auto
+    XMLUtils::GetInt(pElement, "decodethreads", m_videoDecodeThreads, 0, 16);
+    // 0 = auto, 1 = frame threading, 2 = slice threading
+    XMLUtils::GetInt(pElement, "decodethreadtype", m_videoDecodeThreadType, 0, 2);
+    // drop non-reference frames when decoding is predicted to fall behind
+    XMLUtils::GetBoolean(pElement, "predictivedrop", m_videoPredictiveDrop);
     XMLUtils::GetFloat(pElement, "nonlinearstretchratio", m_videoNonLinStretchRatio, 0.01f, 1.0f);
     XMLUtils::GetBoolean(pElement,"enablehighqualityhwscalers", m_videoEnableHighQualityHwScalers);
     XMLUtils::GetFloat(pElement,"autoscalemaxfps",m_videoAutoScaleMaxFps, 0.0f, 1000.0f);
@@ -734,11 +797,13 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "prioritiseapetags", m_prioritiseAPEv2tags);
     XMLUtils::GetBoolean(pElement, "allitemsonbottom", m_bMusicLibraryAllItemsOnBottom);
     XMLUtils::GetBoolean(pElement, "cleanonupdate", m_bMusicLibraryCleanOnUpdate);
+    XMLUtils::GetBoolean(pElement, "analyzereplaygain", m_bMusicLibraryAnalyzeReplayGain);
     XMLUtils::GetBoolean(pElement, "artistsortonupdate", m_bMusicLibraryArtistSortOnUpdate);
     XMLUtils::GetBoolean(pElement, "useartistsortname", m_musicUseArtistSortName);
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
     XMLUtils::GetInt(pElement, "dateadded", m_iMusicLibraryDateAdded);
+    XMLUtils::GetUInt(pElement, "tagreaders", m_musicLibraryTagReaders, 0, 16);
     //Music artist name separators
     TiXmlElement* separators = pElement->FirstChildElement("artistseparators");
     if (separators)
@@ -798,6 +863,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "ignoreerrors", m_bVideoScannerIgnoreErrors);
+    XMLUtils::GetUInt(pElement, "listingsperhost", m_videoScannerListingsPerHost, 0, 16);
+    XMLUtils::GetUInt(pElement, "lookupsperscraper", m_videoScannerLookupsPerScraper, 0, 16);
   }
 
   // Backward-compatibility of ExternalPlayer config
@@ -812,6 +879,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetFloat(pElement, "panamount", m_slideshowPanAmount, 0.0f, 20.0f);
     XMLUtils::GetFloat(pElement, "zoomamount", m_slideshowZoomAmount, 0.0f, 20.0f);
     XMLUtils::GetFloat(pElement, "blackbarcompensation", m_slideshowBlackBarCompensation, 0.0f, 50.0f);
+    XMLUtils::GetInt(pElement, "prefetch", m_slideshowPrefetch, 0, 8);
   }
 
   pElement = pRootElement->FirstChildElement("network");
@@ -820,15 +888,22 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curlclienttimeout", m_curlconnecttimeout, 1, 1000);
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
+    XMLUtils::GetInt(pElement, "curlparallelranges", m_curlParallelRanges, 0, 8);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
+    XMLUtils::GetBoolean(pElement, "disablehttp2", m_curlDisableHTTP2);
+    XMLUtils::GetUInt(pElement, "httpcachesize", m_httpCacheSize, 0, 4096);
   }
 
   pElement = pRootElement->FirstChildElement("cache");
   if (pElement)
   {
     XMLUtils::GetUInt(pElement, "memorysize", m_cacheMemSize);
+    XMLUtils::GetUInt(pElement, "persistentsize", m_cachePersistentSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetFloat(pElement, "readaheadtime", m_cacheReadAheadTime, 0.0f, 600.0f);
+    XMLUtils::GetBoolean(pElement, "bypasspagecache", m_cacheBypassPageCache);
+    XMLUtils::GetFloat(pElement, "demuxreadahead", m_cacheDemuxReadAhead, 0.0f, 60.0f);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -844,6 +919,15 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pElement,  "doscodepage",   m_sambadoscodepage);
     XMLUtils::GetInt(pElement, "clienttimeout", m_sambaclienttimeout, 5, 100);
     XMLUtils::GetBoolean(pElement, "statfiles", m_sambastatfiles);
+    XMLUtils::GetInt(pElement, "readsize", m_sambareadsize, 64, 16384);
+    XMLUtils::GetInt(pElement, "idletimeout", m_sambaidletimeout, 10, 3600);
+  }
+
+  pElement = pRootElement->FirstChildElement("nfs");
+  if (pElement)
+  {
+    XMLUtils::GetInt(pElement, "readdepth", m_nfsreaddepth, 1, 32);
+    XMLUtils::GetInt(pElement, "readsize", m_nfsreadsize, 0, 1024);
   }
 
   pElement = pRootElement->FirstChildElement("httpdirectory");
@@ -878,6 +962,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   //airtunes + airplay
   XMLUtils::GetInt(pRootElement,     "airtunesport", m_airTunesPort);
   XMLUtils::GetInt(pRootElement,     "airplayport", m_airPlayPort);  
+  XMLUtils::GetInt(pRootElement,     "airtunesmaxlatency", m_airTunesMaxLatency, 0, 10000);
 
   XMLUtils::GetBoolean(pRootElement, "handlemounting", m_handleMounting);
 
@@ -912,6 +997,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "updateemptytagsinterval", m_iEpgUpdateEmptyTagsInterval);
     XMLUtils::GetBoolean(pElement, "displayupdatepopup", m_bEpgDisplayUpdatePopup);
     XMLUtils::GetBoolean(pElement, "displayincrementalupdatepopup", m_bEpgDisplayIncrementalUpdatePopup);
+    XMLUtils::GetInt(pElement, "memorywindow", m_iEpgMemoryWindow, 0, 24 * 365);
+    XMLUtils::GetInt(pElement, "updatesperclient", m_iEpgUpdatesPerClient, 1, 16);
   }
 
   // EDL commercial break handling
@@ -1048,6 +1135,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   XMLUtils::GetUInt(pRootElement, "imageres", m_imageRes, 0, 9999);
   if (XMLUtils::GetString(pRootElement, "imagescalingalgorithm", tmp))
     m_imageScalingAlgorithm = CPictureScalingAlgorithm::FromString(tmp);
+  XMLUtils::GetBoolean(pRootElement, "useddsfanart", m_useDDSFanart);
+  XMLUtils::GetUInt(pRootElement, "artprecachejobs", m_artPrecacheJobs, 1, 8);
+  XMLUtils::GetUInt(pRootElement, "artprecachedelay", m_artPrecacheDelay, 0, 10000);
   XMLUtils::GetBoolean(pRootElement, "playlistasfolders", m_playlistAsFolders);
   XMLUtils::GetBoolean(pRootElement, "detectasudf", m_detectAsUdf);
 
@@ -1104,6 +1194,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pPVR, "channeliconsautoscan", m_bPVRChannelIconsAutoScan);
     XMLUtils::GetBoolean(pPVR, "autoscaniconsuserset", m_bPVRAutoScanIconsUserSet);
     XMLUtils::GetInt(pPVR, "numericchannelswitchtimeout", m_iPVRNumericChannelSwitchTimeout, 50, 60000);
+    XMLUtils::GetBoolean(pPVR, "fastzap", m_bPVRFastZap);
+    XMLUtils::GetBoolean(pPVR, "warmstart", m_bPVRWarmStart);
+    XMLUtils::GetInt(pPVR, "timeshiftbuffersize", m_iPVRTimeshiftBufferSize, 0, 65536);
   }
 
   TiXmlElement* pDatabase = pRootElement->FirstChildElement("videodatabase");
@@ -1122,6 +1215,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pDatabase, "capath", m_databaseVideo.capath);
     XMLUtils::GetString(pDatabase, "ciphers", m_databaseVideo.ciphers);
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseVideo.compression);
+    GetSqliteTuning(pDatabase, m_databaseVideo);
   }
 
   pDatabase = pRootElement->FirstChildElement("musicdatabase");
@@ -1139,6 +1233,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pDatabase, "capath", m_databaseMusic.capath);
     XMLUtils::GetString(pDatabase, "ciphers", m_databaseMusic.ciphers);
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseMusic.compression);
+    GetSqliteTuning(pDatabase, m_databaseMusic);
   }
 
   pDatabase = pRootElement->FirstChildElement("tvdatabase");
@@ -1156,6 +1251,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pDatabase, "capath", m_databaseTV.capath);
     XMLUtils::GetString(pDatabase, "ciphers", m_databaseTV.ciphers);
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseTV.compression);
+    GetSqliteTuning(pDatabase, m_databaseTV);
   }
 
   pDatabase = pRootElement->FirstChildElement("epgdatabase");
@@ -1173,6 +1269,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pDatabase, "capath", m_databaseEpg.capath);
     XMLUtils::GetString(pDatabase, "ciphers", m_databaseEpg.ciphers);
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseEpg.compression);
+    GetSqliteTuning(pDatabase, m_databaseEpg);
   }
 
   pDatabase = pRootElement->FirstChildElement("savestatedatabase");
@@ -1190,6 +1287,22 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pDatabase, "capath", m_databaseSavestates.capath);
     XMLUtils::GetString(pDatabase, "ciphers", m_databaseSavestates.ciphers);
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseSavestates.compression);
+    GetSqliteTuning(pDatabase, m_databaseSavestates);
+  }
+
+  pDatabase = pRootElement->FirstChildElement("texturedatabase");
+  if (pDatabase)
+    GetSqliteTuning(pDatabase, m_databaseTextures);
+
+  pDatabase = pRootElement->FirstChildElement("addondatabase");
+  if (pDatabase)
+    GetSqliteTuning(pDatabase, m_databaseAddons);
+
+  pElement = pRootElement->FirstChildElement("databaseprofiler");
+  if (pElement)
+  {
+    XMLUtils::GetBoolean(pElement, "enabled", m_databaseProfiling);
+    XMLUtils::GetUInt(pElement, "slowquerytime", m_databaseSlowQueryTime, 0, 60000);
   }
 
   pElement = pRootElement->FirstChildElement("enablemultimediakeys");
@@ -1338,6 +1451,20 @@ void CAdvancedSettings::GetCustomRegexps(TiXmlElement *pRootElement, std::vector
   }
 }
 
+void CAdvancedSettings::GetSqliteTuning(TiXmlElement *pDatabase, DatabaseSettings &settings)
+{
+  TiXmlElement *pSqlite = pDatabase->FirstChildElement("sqlite");
+  if (!pSqlite)
+    return;
+
+  XMLUtils::GetBoolean(pSqlite, "wal", settings.walMode);
+  XMLUtils::GetUInt(pSqlite, "mmapsize", settings.mmapSize, 0, 1024);
+  XMLUtils::GetUInt(pSqlite, "cachesize", settings.cacheSize, 256, 262144);
+  XMLUtils::GetUInt(pSqlite, "walautocheckpoint", settings.walAutoCheckpoint, 0, 100000);
+  XMLUtils::GetUInt(pSqlite, "pagesize", settings.pageSize, 512, 65536);
+  XMLUtils::GetBoolean(pSqlite, "optimize", settings.optimize);
+}
+
 void CAdvancedSettings::GetCustomExtensions(TiXmlElement *pRootElement, std::string& extensions)
 {
   std::string extraExtensions;
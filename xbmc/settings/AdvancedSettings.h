@@ -62,6 +62,12 @@ public:
     capath.clear();
     ciphers.clear();
     compression = false;
+    walMode = true;
+    mmapSize = 16;
+    cacheSize = 16384;
+    walAutoCheckpoint = 1000;
+    pageSize = 4096;
+    optimize = true;
   };
   std::string type;
   std::string host;
@@ -75,6 +81,14 @@ public:
   std::string capath;
   std::string ciphers;
   bool compression;
+
+  // sqlite tuning
+  bool walMode;                   //!< write ahead logging, so library writes don't block readers
+  unsigned int mmapSize;          //!< MB of the database file to access through memory mapped I/O, 0 to disable
+  unsigned int cacheSize;         //!< KB of page cache per connection
+  unsigned int walAutoCheckpoint; //!< pages in the write ahead log before it's checkpointed, 0 to disable
+  unsigned int pageSize;          //!< page size of newly created databases
+  bool optimize;                  //!< check and analyze the database at startup
 };
 
 struct TVShowRegexp
@@ -131,6 +145,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     static void GetCustomTVRegexps(TiXmlElement *pRootElement, SETTINGS_TVSHOWLIST& settings);
     static void GetCustomRegexps(TiXmlElement *pRootElement, std::vector<std::string> &settings);
     static void GetCustomExtensions(TiXmlElement *pRootElement, std::string& extensions);
+    static void GetSqliteTuning(TiXmlElement *pDatabase, DatabaseSettings &settings);
 
     bool CanLogComponent(int component) const;
     static void SettingOptionsLoggingComponentsFiller(std::shared_ptr<const CSetting> setting, std::vector< std::pair<std::string, int> > &list, int &current, void *data);
@@ -170,6 +185,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_musicPercentSeekBackward;
     int m_musicPercentSeekForwardBig;
     int m_musicPercentSeekBackwardBig;
+    int m_musicPrefetchTime;
+    int m_musicPrefetchTimeRemote;
     int m_videoIgnoreSecondsAtStart;
     float m_videoIgnorePercentAtEnd;
     float m_audioApplyDrc;
@@ -177,6 +194,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     int   m_videoVDPAUScaling;
     bool  m_videoVAAPIforced;
+    int   m_videoDecodeThreads;
+    int   m_videoDecodeThreadType;
+    bool  m_videoPredictiveDrop;
     float m_videoNonLinStretchRatio;
     bool  m_videoEnableHighQualityHwScalers;
     float m_videoAutoScaleMaxFps;
@@ -198,6 +218,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     float m_slideshowBlackBarCompensation;
     float m_slideshowZoomAmount;
     float m_slideshowPanAmount;
+    int m_slideshowPrefetch;
 
     int m_songInfoDuration;
     int m_logLevel;
@@ -210,6 +231,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     //airtunes + airplay
     int m_airTunesPort;
     int m_airPlayPort;
+    int m_airTunesMaxLatency; //!< ms of audio allowed to queue up in front of the player, 0 for no limit
 
     bool m_handleMounting;
 
@@ -241,10 +263,18 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_fanartRes; ///< \brief the maximal resolution to cache fanart at (assumes 16x9)
     unsigned int m_imageRes;  ///< \brief the maximal resolution to cache images at (assumes 16x9)
     CPictureScalingAlgorithm::Algorithm m_imageScalingAlgorithm;
+    bool m_useDDSFanart; ///< \brief keep a DXT compressed copy of cached images for faster loading
+    unsigned int m_artPrecacheJobs;  ///< \brief number of images cached at once when pre-caching library art
+    unsigned int m_artPrecacheDelay; ///< \brief pause (ms) after each image cached when pre-caching library art
 
     int m_sambaclienttimeout;
     std::string m_sambadoscodepage;
     bool m_sambastatfiles;
+    int m_sambareadsize; //!< KB requested per read, libsmbclient splits it into pipelined requests
+    int m_sambaidletimeout; //!< seconds without open files before the connections are closed
+
+    int m_nfsreaddepth; //!< reads kept outstanding per file, 1 reads synchronously
+    int m_nfsreadsize; //!< KB per read request, 0 uses the size offered by the server
 
     bool m_bHTTPDirectoryStatFilesize;
 
@@ -259,6 +289,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_iMusicLibraryDateAdded;
     bool m_bMusicLibraryAllItemsOnBottom;
     bool m_bMusicLibraryCleanOnUpdate;
+    bool m_bMusicLibraryAnalyzeReplayGain;
     bool m_bMusicLibraryArtistSortOnUpdate;
     std::string m_strMusicLibraryAlbumFormat;
     bool m_prioritiseAPEv2tags;
@@ -267,6 +298,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     std::string m_videoItemSeparator;
     std::vector<std::string> m_musicTagsFromFileFilters;
     bool m_musicUseArtistSortName;
+    unsigned int m_musicLibraryTagReaders;        ///< files the music scanner reads the tags of at once, 0 or 1 to read them one by one
 
     bool m_bVideoLibraryAllItemsOnBottom;
     int m_iVideoLibraryRecentlyAddedItems;
@@ -277,6 +309,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bVideoLibraryImportResumePoint;
 
     bool m_bVideoScannerIgnoreErrors;
+    unsigned int m_videoScannerListingsPerHost;   ///< folders the video scanner lists at once per host, 0 to list them one by one
+    unsigned int m_videoScannerLookupsPerScraper; ///< items the video scanner looks up at once per scraper, 0 to look them up one by one
     int m_iVideoLibraryDateAdded;
 
     std::set<std::string> m_vecTokens;
@@ -288,6 +322,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_iEpgUpdateEmptyTagsInterval; // seconds
     bool m_bEpgDisplayUpdatePopup;
     bool m_bEpgDisplayIncrementalUpdatePopup;
+    int m_iEpgMemoryWindow;         // hours of guide data ahead of now kept in memory, 0 to keep all of it
+    int m_iEpgUpdatesPerClient;     // channels of a pvr client updated at once
 
     // EDL Commercial Break
     bool m_bEdlMergeShortCommBreaks;
@@ -301,7 +337,10 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curlconnecttimeout;
     int m_curllowspeedtime;
     int m_curlretries;
+    int m_curlParallelRanges; //!< ranges fetched ahead of the reader, 0 for a single connection
     bool m_curlDisableIPV6;
+    bool m_curlDisableHTTP2;
+    unsigned int m_httpCacheSize; //!< MB of http responses kept for the scrapers, 0 to disable
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -334,12 +373,19 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bPVRChannelIconsAutoScan; /*!< @brief automatically scan user defined folder for channel icons when loading internal channel groups */
     bool m_bPVRAutoScanIconsUserSet; /*!< @brief mark channel icons populated by auto scan as "user set" */
     int m_iPVRNumericChannelSwitchTimeout; /*!< @brief time in ms before the numeric dialog auto closes when confirmchannelswitch is disabled */
+    bool m_bPVRFastZap; /*!< @brief keep the video decoder across channel switches if the new channel has the same video format */
+    bool m_bPVRWarmStart; /*!< @brief show the channels stored in the database at startup, update them from the clients once started */
+    int m_iPVRTimeshiftBufferSize; /*!< @brief MB of live tv buffered on disk for clients that can't timeshift themselves, 0 to disable. defaults to 0. */
 
     DatabaseSettings m_databaseMusic; // advanced music database setup
     DatabaseSettings m_databaseVideo; // advanced video database setup
     DatabaseSettings m_databaseTV;    // advanced tv database setup
     DatabaseSettings m_databaseEpg;   /*!< advanced EPG database setup */
     DatabaseSettings m_databaseSavestates; /*!< advanced savestate database setup */
+    DatabaseSettings m_databaseTextures; /*!< sqlite tuning of the texture database */
+    DatabaseSettings m_databaseAddons;   /*!< sqlite tuning of the addon database */
+    bool m_databaseProfiling;             /*!< collect per statement statistics, see CDatabaseProfiler */
+    unsigned int m_databaseSlowQueryTime; /*!< log statements taking longer than this many ms, 0 to disable */
 
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
@@ -347,8 +393,12 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemSize;
+    unsigned int m_cachePersistentSize; //!< MB on disk for copies of remote media, 0 disables them
     unsigned int m_cacheBufferMode;
     float m_cacheReadFactor;
+    float m_cacheReadAheadTime; //!< seconds of media to keep cached, 0 to use m_cacheReadFactor
+    bool m_cacheBypassPageCache; //!< keep the disk cache out of the OS page cache
+    float m_cacheDemuxReadAhead;
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
@@ -384,6 +434,21 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     False to show at the bottom of video (default) */
     bool m_videoAssFixedWorks;
 
+    /*!< @brief number of frames libass renders ahead of the clock on a worker thread, 0 renders on demand */
+    unsigned int m_videoAssLookAhead;
+
+    /*!< @brief true to make step seeks frame accurate by decoding from the prior keyframe */
+    bool m_videoAccurateSeek;
+
+    /*!< @brief true to show keyframe previews while a delayed seek is being adjusted */
+    bool m_videoSeekPreview;
+
+    /*!< @brief true to measure GPU time per render stage while playing, always on with the debug OSD */
+    bool m_videoRenderTimings;
+
+    /*!< @brief true to open the next playlist item before the current one ends, so it starts without a stop */
+    bool m_videoPreOpenNext;
+
     std::string m_userAgent;
 
   private:
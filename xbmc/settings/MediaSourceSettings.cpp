@@ -31,6 +31,7 @@
 #include "utils/URIUtils.h"
 #include "utils/XBMCTinyXML.h"
 #include "utils/XMLUtils.h"
+#include "network/DNSNameCache.h"
 #include "network/WakeOnAccess.h"
 #include "ServiceBroker.h"
 
@@ -111,9 +112,41 @@ bool CMediaSourceSettings::Load(const std::string &file)
   GetSources(pRootElement, "music", m_musicSources, m_defaultMusicSource);
   GetSources(pRootElement, "games", m_gameSources, dummy);
 
+  // resolve the hosts of network sources now, not on the first browse
+  PrefetchHosts(m_videoSources);
+  PrefetchHosts(m_programSources);
+  PrefetchHosts(m_pictureSources);
+  PrefetchHosts(m_fileSources);
+  PrefetchHosts(m_musicSources);
+  PrefetchHosts(m_gameSources);
+
   return true;
 }
 
+void CMediaSourceSettings::PrefetchHosts(const VECSOURCES& items) const
+{
+  static const char* protocols[] = { "smb", "nfs", "ftp", "ftps", "sftp", "http", "https", "dav", "davs" };
+
+  for (const auto& source : items)
+  {
+    for (const auto& path : source.vecPaths)
+    {
+      CURL url(path);
+      if (url.GetHostName().empty())
+        continue;
+
+      for (const char* protocol : protocols)
+      {
+        if (url.IsProtocol(protocol))
+        {
+          CDNSNameCache::Prefetch(url.GetHostName());
+          break;
+        }
+      }
+    }
+  }
+}
+
 bool CMediaSourceSettings::Save()
 {
   return Save(GetSourcesFile());
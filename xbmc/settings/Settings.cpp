@@ -428,6 +428,9 @@ const std::string CSettings::SETTING_SOURCE_PICTURES = "source.pictures";
 const std::string CSettings::SETTING_GAMES_ENABLE = "gamesgeneral.enable";
 const std::string CSettings::SETTING_GAMES_ENABLEREWIND = "gamesgeneral.enablerewind";
 const std::string CSettings::SETTING_GAMES_REWINDTIME = "gamesgeneral.rewindtime";
+const std::string CSettings::SETTING_GAMES_REWINDMEMORY = "gamesgeneral.rewindmemory";
+const std::string CSettings::SETTING_GAMES_RUNAHEAD = "gamesgeneral.runahead";
+const std::string CSettings::SETTING_GAMES_SYNCTODISPLAY = "gamesgeneral.synctodisplay";
 
 bool CSettings::Initialize()
 {
@@ -382,6 +382,9 @@ public:
   static const std::string SETTING_GAMES_ENABLE;
   static const std::string SETTING_GAMES_ENABLEREWIND;
   static const std::string SETTING_GAMES_REWINDTIME;
+  static const std::string SETTING_GAMES_REWINDMEMORY;
+  static const std::string SETTING_GAMES_RUNAHEAD;
+  static const std::string SETTING_GAMES_SYNCTODISPLAY;
 
   /*!
    \brief Creates a new settings wrapper around a new settings manager.
@@ -60,6 +60,7 @@ const std::string& CSkinSettings::GetString(int setting) const
 void CSkinSettings::SetString(int setting, const std::string &label)
 {
   g_SkinInfo->SetString(setting, label);
+  CServiceBroker::GetGUI()->GetInfoManager().ResetSkinCache();
 }
 
 int CSkinSettings::TranslateBool(const std::string &setting)
@@ -75,11 +76,13 @@ bool CSkinSettings::GetBool(int setting) const
 void CSkinSettings::SetBool(int setting, bool set)
 {
   g_SkinInfo->SetBool(setting, set);
+  CServiceBroker::GetGUI()->GetInfoManager().ResetSkinCache();
 }
 
 void CSkinSettings::Reset(const std::string &setting)
 {
   g_SkinInfo->Reset(setting);
+  CServiceBroker::GetGUI()->GetInfoManager().ResetSkinCache();
 }
 
 void CSkinSettings::Reset()
@@ -87,7 +90,7 @@ void CSkinSettings::Reset()
   g_SkinInfo->Reset();
 
   CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
-  infoMgr.ResetCache();
+  infoMgr.ResetSkinCache();
   infoMgr.GetInfoProviders().GetGUIControlsInfoProvider().ResetContainerMovingCache();
 }
 
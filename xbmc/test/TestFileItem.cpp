@@ -21,6 +21,7 @@
 #include "FileItem.h"
 #include "URL.h"
 #include "settings/AdvancedSettings.h"
+#include "utils/Variant.h"
 
 #include "gtest/gtest.h"
 
@@ -136,3 +137,57 @@ const TestFileData BaseMovies[] = {{ "c:\\dir\\filename.avi", false, "c:\\dir\\f
                                    { "/home/user/movies/movie_name/BDMV/index.bdmv", true, "/home/user/movies/movie_name/" }};
 
 INSTANTIATE_TEST_CASE_P(BaseNameMovies, TestFileItemBasePath, ValuesIn(BaseMovies));
+
+TEST(TestFileItem, Properties)
+{
+  CFileItem item;
+  item.SetProperty("Zeta", 1);
+  item.SetProperty("alpha", "a");
+  item.SetProperty("Mid", true);
+  item.SetProperty("ALPHA", "b");
+
+  EXPECT_TRUE(item.HasProperty("zeta"));
+  EXPECT_EQ("b", item.GetProperty("Alpha").asString());
+  EXPECT_TRUE(item.GetProperty("missing").isNull());
+
+  CFileItem copy(item);
+  item.ClearProperty("mid");
+  EXPECT_FALSE(item.HasProperty("Mid"));
+  EXPECT_TRUE(copy.GetProperty("MID").asBoolean());
+  EXPECT_EQ(1, copy.GetProperty("zeta").asInteger());
+
+  CVariant serialized;
+  copy.CGUIListItem::Serialize(serialized);
+  EXPECT_EQ("b", serialized["properties"]["alpha"].asString());
+}
+
+TEST(TestFileItem, AssignMove)
+{
+  CFileItemList source("/movies/");
+  source.SetContent("movies");
+  source.SetProperty("total", 2);
+  CFileItemPtr first(new CFileItem("/movies/a.mkv", false));
+  CFileItemPtr second(new CFileItem("/movies/b.mkv", false));
+  source.Add(first);
+  source.Add(second);
+
+  CFileItemList items;
+  items.Assign(std::move(source));
+  ASSERT_EQ(2, items.Size());
+  EXPECT_EQ(first, items[0]);
+  EXPECT_EQ(second, items[1]);
+  EXPECT_EQ("/movies/", items.GetPath());
+  EXPECT_EQ("movies", items.GetContent());
+  EXPECT_EQ(2, items.GetProperty("total").asInteger());
+  EXPECT_EQ(0, source.Size());
+
+  CFileItemList more;
+  CFileItemPtr third(new CFileItem("/movies/c.mkv", false));
+  more.Add(third);
+  items.SetFastLookup(true);
+  items.Assign(std::move(more), true);
+  ASSERT_EQ(3, items.Size());
+  EXPECT_EQ(third, items[2]);
+  EXPECT_EQ(third, items.Get("/movies/c.mkv"));
+  EXPECT_EQ(0, more.Size());
+}
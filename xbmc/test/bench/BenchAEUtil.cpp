@@ -0,0 +1,57 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include <vector>
+
+// One period of 7.1 audio at 48 kHz
+#define SAMPLES  (512 * 8)
+
+KODI_BENCHMARK(AEUtil_MulAddArray)
+{
+  std::vector<float> dst(SAMPLES, 0.25f);
+  std::vector<float> src(SAMPLES, 0.5f);
+
+  state.SetItemsPerIteration(SAMPLES);
+  while (state.Run())
+    CAEUtil::MulAddArray(dst.data(), src.data(), 0.5f, SAMPLES);
+}
+
+KODI_BENCHMARK(AEUtil_MulArray)
+{
+  std::vector<float> data(SAMPLES, 0.5f);
+
+  state.SetItemsPerIteration(SAMPLES);
+  while (state.Run())
+    CAEUtil::MulArray(data.data(), 1.0f, SAMPLES);
+}
+
+KODI_BENCHMARK(AEUtil_ClampArray)
+{
+  std::vector<float> data(SAMPLES);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = (static_cast<float>(i % 64) - 32.0f) / 16.0f;
+
+  state.SetItemsPerIteration(SAMPLES);
+  while (state.Run())
+    CAEUtil::ClampArray(data.data(), SAMPLES);
+}
@@ -0,0 +1,94 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.h"
+#include "FileItem.h"
+#include "filesystem/DirectoryCache.h"
+#include "utils/StringUtils.h"
+
+#define DIR_COUNT   200
+#define ITEM_COUNT  100
+
+using namespace XFILE;
+
+namespace
+{
+  std::string GetDirPath(int dir)
+  {
+    return StringUtils::Format("smb://server/share/Movies/Movie %d/", dir);
+  }
+
+  void FillCache(CDirectoryCache &cache)
+  {
+    for (int dir = 0; dir < DIR_COUNT; dir++)
+    {
+      CFileItemList items;
+      for (int item = 0; item < ITEM_COUNT; item++)
+        items.Add(CFileItemPtr(new CFileItem(GetDirPath(dir) + StringUtils::Format("file%d.mkv", item), false)));
+      cache.SetDirectory(GetDirPath(dir), items, DIR_CACHE_ALWAYS);
+    }
+  }
+}
+
+KODI_BENCHMARK(DirectoryCache_GetDirectory)
+{
+  CDirectoryCache cache;
+  FillCache(cache);
+
+  int dir = 0;
+  state.SetItemsPerIteration(ITEM_COUNT);
+  while (state.Run())
+  {
+    CFileItemList items;
+    cache.GetDirectory(GetDirPath(dir), items);
+    dir = (dir + 1) % DIR_COUNT;
+  }
+}
+
+KODI_BENCHMARK(DirectoryCache_FileExists)
+{
+  CDirectoryCache cache;
+  FillCache(cache);
+
+  int file = 0;
+  while (state.Run())
+  {
+    bool bInCache;
+    cache.FileExists(GetDirPath(file % DIR_COUNT) + StringUtils::Format("file%d.mkv", file % ITEM_COUNT), bInCache);
+    file = (file + 7) % (DIR_COUNT * ITEM_COUNT);
+  }
+}
+
+KODI_BENCHMARK(DirectoryCache_SetDirectory)
+{
+  CDirectoryCache cache;
+
+  CFileItemList items;
+  for (int item = 0; item < ITEM_COUNT; item++)
+    items.Add(CFileItemPtr(new CFileItem(GetDirPath(0) + StringUtils::Format("file%d.mkv", item), false)));
+
+  int dir = 0;
+  state.SetItemsPerIteration(ITEM_COUNT);
+  while (state.Run())
+  {
+    cache.SetDirectory(GetDirPath(dir), items, DIR_CACHE_ALWAYS);
+    dir = (dir + 1) % DIR_COUNT;
+  }
+}
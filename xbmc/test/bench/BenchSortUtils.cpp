@@ -0,0 +1,76 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.h"
+#include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include <random>
+
+#define ITEM_COUNT  10000
+
+namespace
+{
+  SortItems CreateItems()
+  {
+    // the same items on every run
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> year(1950, 2018);
+    std::uniform_int_distribution<int> letter('A', 'Z');
+
+    SortItems items;
+    for (int i = 0; i < ITEM_COUNT; i++)
+    {
+      SortItemPtr item(new SortItem());
+      const std::string title = StringUtils::Format("The %c%c%c Movie %d", letter(random), letter(random), letter(random), i);
+      (*item)[FieldLabel] = title;
+      (*item)[FieldTitle] = title;
+      (*item)[FieldSortTitle] = title;
+      (*item)[FieldYear] = year(random);
+      items.push_back(item);
+    }
+    return items;
+  }
+}
+
+KODI_BENCHMARK(SortUtils_SortByTitle)
+{
+  const SortItems items = CreateItems();
+
+  state.SetItemsPerIteration(items.size());
+  while (state.Run())
+  {
+    SortItems sorted(items);
+    SortUtils::Sort(SortByTitle, SortOrderAscending, SortAttributeIgnoreArticle, sorted);
+  }
+}
+
+KODI_BENCHMARK(SortUtils_SortByYear)
+{
+  const SortItems items = CreateItems();
+
+  state.SetItemsPerIteration(items.size());
+  while (state.Run())
+  {
+    SortItems sorted(items);
+    SortUtils::Sort(SortByYear, SortOrderDescending, SortAttributeNone, sorted);
+  }
+}
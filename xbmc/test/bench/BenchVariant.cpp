@@ -0,0 +1,84 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+
+#define MOVIE_COUNT  1000
+
+namespace
+{
+  // Looks like a JSON-RPC VideoLibrary.GetMovies response
+  CVariant CreateMovies()
+  {
+    CVariant movies(CVariant::VariantTypeArray);
+    for (int i = 0; i < MOVIE_COUNT; i++)
+    {
+      CVariant movie(CVariant::VariantTypeObject);
+      movie["movieid"] = i;
+      movie["label"] = "Movie " + std::to_string(i);
+      movie["year"] = 1950 + i % 70;
+      movie["rating"] = (i % 100) / 10.0;
+      movie["playcount"] = i % 3;
+      movie["file"] = "smb://server/movies/Movie " + std::to_string(i) + "/movie.mkv";
+      movie["plot"] = "A long plot with \"quotes\", unicode \xc3\xa9 and\nnew lines of movie " + std::to_string(i);
+      movie["genre"].push_back("Drama");
+      movie["genre"].push_back("Comedy");
+      movies.push_back(movie);
+    }
+
+    CVariant result(CVariant::VariantTypeObject);
+    result["movies"] = movies;
+    result["limits"]["start"] = 0;
+    result["limits"]["end"] = MOVIE_COUNT;
+    result["limits"]["total"] = MOVIE_COUNT;
+    return result;
+  }
+}
+
+KODI_BENCHMARK(Variant_ParseJSON)
+{
+  std::string json;
+  CJSONVariantWriter::Write(CreateMovies(), json, true);
+
+  state.SetItemsPerIteration(json.size());
+  while (state.Run())
+  {
+    CVariant parsed;
+    CJSONVariantParser::Parse(json, parsed);
+  }
+}
+
+KODI_BENCHMARK(Variant_WriteJSON)
+{
+  const CVariant movies = CreateMovies();
+
+  std::string json;
+  CJSONVariantWriter::Write(movies, json, true);
+
+  state.SetItemsPerIteration(json.size());
+  while (state.Run())
+  {
+    json.clear();
+    CJSONVariantWriter::Write(movies, json, true);
+  }
+}
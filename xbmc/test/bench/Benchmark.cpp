@@ -0,0 +1,141 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.h"
+#include "filesystem/File.h"
+#include "threads/SystemClock.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+using namespace KODI::BENCHMARK;
+
+namespace
+{
+  // Sorted by name, so the output is stable
+  std::map<std::string, BenchmarkFunc>& GetBenchmarks()
+  {
+    static std::map<std::string, BenchmarkFunc> benchmarks;
+    return benchmarks;
+  }
+
+  uint64_t RunOnce(BenchmarkFunc func, uint64_t iterations, uint64_t &items)
+  {
+    CBenchmarkState state(iterations);
+    func(state);
+    items = state.GetItemsPerIteration();
+    return state.GetElapsedNs();
+  }
+
+  // Iterations needed for a repetition to run at least minTimeMs
+  uint64_t Calibrate(BenchmarkFunc func, unsigned int minTimeMs)
+  {
+    const uint64_t minTimeNs = static_cast<uint64_t>(minTimeMs) * 1000000;
+
+    uint64_t iterations = 1;
+    while (true)
+    {
+      uint64_t items;
+      const uint64_t elapsed = RunOnce(func, iterations, items);
+      if (elapsed >= minTimeNs || iterations >= (1ULL << 40))
+        return iterations;
+
+      // aim a bit over, but don't grow by more than 10x on noisy short runs
+      uint64_t next = elapsed > 0 ? iterations * minTimeNs * 12 / 10 / elapsed : iterations * 10;
+      iterations = std::max(iterations + 1, std::min(next, iterations * 10));
+    }
+  }
+}
+
+uint64_t CBenchmarkState::Now()
+{
+  return XbmcThreads::SystemClockNanos();
+}
+
+CBenchmarkRegistration::CBenchmarkRegistration(const char *name, BenchmarkFunc func)
+{
+  GetBenchmarks()[name] = func;
+}
+
+bool KODI::BENCHMARK::RunBenchmarks(const BenchmarkOptions &options)
+{
+  CVariant results(CVariant::VariantTypeArray);
+
+  printf("%-40s %14s %14s %14s %16s\n", "benchmark", "iterations", "median ns", "min ns", "items/s");
+
+  for (const auto &benchmark : GetBenchmarks())
+  {
+    if (!options.filter.empty() && benchmark.first.find(options.filter) == std::string::npos)
+      continue;
+
+    const uint64_t iterations = Calibrate(benchmark.second, options.minTimeMs);
+
+    std::vector<double> times;
+    uint64_t items = 0;
+    for (unsigned int i = 0; i < std::max(options.repetitions, 1U); i++)
+      times.push_back(static_cast<double>(RunOnce(benchmark.second, iterations, items)) / iterations);
+
+    std::sort(times.begin(), times.end());
+    const double median = times[times.size() / 2];
+    const double itemsPerSecond = items > 0 && median > 0.0 ? items * 1e9 / median : 0.0;
+
+    printf("%-40s %14llu %14.1f %14.1f %16.0f\n", benchmark.first.c_str(),
+           static_cast<unsigned long long>(iterations), median, times.front(), itemsPerSecond);
+
+    CVariant result(CVariant::VariantTypeObject);
+    result["name"] = benchmark.first;
+    result["iterations"] = static_cast<uint64_t>(iterations);
+    result["median_ns"] = median;
+    result["min_ns"] = times.front();
+    result["max_ns"] = times.back();
+    result["items_per_second"] = itemsPerSecond;
+    results.push_back(result);
+  }
+
+  if (results.empty())
+  {
+    fprintf(stderr, "No benchmark matches \"%s\"\n", options.filter.c_str());
+    return false;
+  }
+
+  if (options.outputFile.empty())
+    return true;
+
+  CVariant output(CVariant::VariantTypeObject);
+  output["version"] = 1;
+  output["repetitions"] = options.repetitions;
+  output["benchmarks"] = results;
+
+  std::string json;
+  XFILE::CFile file;
+  if (!CJSONVariantWriter::Write(output, json, false) ||
+      !file.OpenForWrite(options.outputFile, true) ||
+      file.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    fprintf(stderr, "Unable to write %s\n", options.outputFile.c_str());
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,107 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+
+namespace KODI
+{
+namespace BENCHMARK
+{
+  /*!
+   * \brief Handed to a benchmark, which runs the measured code once per
+   *        iteration of Run()
+   *
+   *   KODI_BENCHMARK(Name)
+   *   {
+   *     // set up, not measured
+   *     while (state.Run())
+   *     {
+   *       // measured
+   *     }
+   *   }
+   */
+  class CBenchmarkState
+  {
+  public:
+    explicit CBenchmarkState(uint64_t iterations) : m_iterations(iterations) { }
+
+    bool Run()
+    {
+      if (m_done == 0)
+        m_start = Now();
+      if (m_done < m_iterations)
+      {
+        m_done++;
+        return true;
+      }
+      m_end = Now();
+      return false;
+    }
+
+    /*!
+     * \brief Items processed per iteration, reported as throughput
+     */
+    void SetItemsPerIteration(uint64_t items) { m_items = items; }
+
+    uint64_t GetIterations() const { return m_iterations; }
+    uint64_t GetItemsPerIteration() const { return m_items; }
+    uint64_t GetElapsedNs() const { return m_end - m_start; }
+
+  private:
+    static uint64_t Now();
+
+    const uint64_t m_iterations;
+    uint64_t m_done = 0;
+    uint64_t m_items = 0;
+    uint64_t m_start = 0;
+    uint64_t m_end = 0;
+  };
+
+  typedef void (*BenchmarkFunc)(CBenchmarkState &state);
+
+  class CBenchmarkRegistration
+  {
+  public:
+    CBenchmarkRegistration(const char *name, BenchmarkFunc func);
+  };
+
+  struct BenchmarkOptions
+  {
+    std::string filter;           //!< run the benchmarks whose name contains it
+    std::string outputFile;       //!< JSON results, for tracking them across builds
+    unsigned int minTimeMs = 500; //!< time a repetition runs at least
+    unsigned int repetitions = 5;
+  };
+
+  /*!
+   * \brief Run the registered benchmarks, printing a table to stdout
+   *
+   * \return false if no benchmark matched or the results couldn't be written
+   */
+  bool RunBenchmarks(const BenchmarkOptions &options);
+}
+}
+
+#define KODI_BENCHMARK(name) \
+  static void Benchmark_##name(KODI::BENCHMARK::CBenchmarkState &state); \
+  static const KODI::BENCHMARK::CBenchmarkRegistration registration_##name(#name, Benchmark_##name); \
+  static void Benchmark_##name(KODI::BENCHMARK::CBenchmarkState &state)
@@ -0,0 +1,64 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.h"
+#include "test/TestBasicEnvironment.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+/*!
+ * Runs the benchmarks in the test environment of the unit tests.
+ *
+ *   --filter=<text>      only run the benchmarks whose name contains text
+ *   --out=<file>         write the results as JSON
+ *   --min-time=<ms>      time each repetition runs at least (default 500)
+ *   --repetitions=<n>    repetitions, the median is reported (default 5)
+ */
+int main(int argc, char **argv)
+{
+  KODI::BENCHMARK::BenchmarkOptions options;
+
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string arg = argv[i];
+    if (StringUtils::StartsWith(arg, "--filter="))
+      options.filter = arg.substr(9);
+    else if (StringUtils::StartsWith(arg, "--out="))
+      options.outputFile = arg.substr(6);
+    else if (StringUtils::StartsWith(arg, "--min-time="))
+      options.minTimeMs = std::strtoul(arg.c_str() + 11, nullptr, 10);
+    else if (StringUtils::StartsWith(arg, "--repetitions="))
+      options.repetitions = std::strtoul(arg.c_str() + 14, nullptr, 10);
+  }
+
+  CXBMCTestUtils::Instance().ParseArgs(argc, argv);
+
+  TestBasicEnvironment environment;
+  environment.SetUp();
+
+  const bool success = KODI::BENCHMARK::RunBenchmarks(options);
+
+  environment.TearDown();
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,113 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Condition.h"
+#include "threads/platform/Futex.cpp"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// bounds of the busy wait before sleeping, adapted to how often it pays off
+#define CONDITION_SPINS_MIN   16
+#define CONDITION_SPINS_START 128
+#define CONDITION_SPINS_MAX   2048
+
+namespace
+{
+inline void CpuRelax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+  __builtin_ia32_pause();
+#elif defined(_M_IX86) || defined(_M_X64)
+  _mm_pause();
+#elif defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+bool CanSpin()
+{
+  // on a single core the notifying thread can't run while we spin
+  static const bool canSpin = std::thread::hardware_concurrency() > 1;
+  return canSpin;
+}
+}
+
+namespace XbmcThreads
+{
+  ConditionVariable::ConditionVariable() : m_spins(CONDITION_SPINS_START)
+  {
+  }
+
+  bool ConditionVariable::Spin(int sequence)
+  {
+    int spins = m_spins.load(std::memory_order_relaxed);
+    for (int i = 0; i < spins; i++)
+    {
+      if (m_sequence.load(std::memory_order_acquire) != sequence)
+      {
+        m_spins.store(std::min(spins * 2, CONDITION_SPINS_MAX), std::memory_order_relaxed);
+        return true;
+      }
+      CpuRelax();
+    }
+    m_spins.store(std::max(spins / 2, CONDITION_SPINS_MIN), std::memory_order_relaxed);
+    return false;
+  }
+
+  bool ConditionVariable::Wait(CCriticalSection& lock, unsigned int milliseconds)
+  {
+    // read while still holding the lock, so a notify after we unlock is seen
+    int sequence = m_sequence.load();
+
+    unsigned int count = lock.count;
+    lock.count = 0;
+    lock.get_underlying().unlock();
+
+    bool notified = milliseconds > 0 && CanSpin() && Spin(sequence);
+    if (!notified && milliseconds > 0)
+    {
+      // notify() skips the wake up while nobody is counted here, in which
+      // case AddressWait() returns right away as the sequence changed
+      m_waiters++;
+      if (milliseconds == EndTime::InfiniteValue)
+      {
+        while (m_sequence.load() == sequence)
+          AddressWait(m_sequence, sequence, milliseconds);
+      }
+      else
+      {
+        EndTime endTime(milliseconds);
+        while (m_sequence.load() == sequence && !endTime.IsTimePast())
+          AddressWait(m_sequence, sequence, endTime.MillisLeft());
+      }
+      m_waiters--;
+    }
+    notified = m_sequence.load() != sequence;
+
+    lock.get_underlying().lock();
+    lock.count = count;
+    return notified;
+  }
+}
@@ -23,43 +23,46 @@
 #include "threads/SingleLock.h"
 #include "threads/Helpers.h"
 #include "threads/SystemClock.h"
+#include "threads/platform/Futex.h"
 
-#include <condition_variable>
-#include <chrono>
+#include <atomic>
 
 namespace XbmcThreads
 {
 
   /**
-   * This is a thin wrapper around std::condition_variable_any. It is subject
-   *  to "spurious returns" as it is built on boost which is built on posix
-   *  on many of our platforms.
+   * A condition variable that waits on a sequence number with
+   *  AddressWait(): a futex on Linux, WaitOnAddress on Windows. Waiters spin
+   *  for a moment before they sleep, as notifications often follow within
+   *  microseconds, and notify() only enters the kernel when someone sleeps.
+   *
+   * It is subject to "spurious returns" like any condition variable.
    */
   class ConditionVariable
   {
   private:
-    std::condition_variable_any cond;
+    std::atomic<int> m_sequence{0};
+    std::atomic<int> m_waiters{0};
+    std::atomic<int> m_spins;
+
     ConditionVariable(const ConditionVariable&) = delete;
     ConditionVariable& operator=(const ConditionVariable&) = delete;
 
+    // implementation is in threads/Condition.cpp
+    bool Wait(CCriticalSection& lock, unsigned int milliseconds);
+    bool Spin(int sequence);
+
   public:
-    ConditionVariable() = default;
+    ConditionVariable();
 
     inline void wait(CCriticalSection& lock) 
     {
-      int count  = lock.count;
-      lock.count = 0;
-      cond.wait(lock.get_underlying());
-      lock.count = count;
+      Wait(lock, EndTime::InfiniteValue);
     }
 
     inline bool wait(CCriticalSection& lock, unsigned long milliseconds) 
     { 
-      int count  = lock.count;
-      lock.count = 0;
-      std::cv_status res = cond.wait_for(lock.get_underlying(), std::chrono::milliseconds(milliseconds));
-      lock.count = count;
-      return res == std::cv_status::no_timeout;
+      return Wait(lock, milliseconds < EndTime::InfiniteValue ? static_cast<unsigned int>(milliseconds) : EndTime::InfiniteValue - 1);
     }
 
     inline void wait(CSingleLock& lock) { wait(lock.get_underlying()); }
@@ -67,12 +70,16 @@ namespace XbmcThreads
 
     inline void notifyAll() 
     { 
-      cond.notify_all();
+      m_sequence++;
+      if (m_waiters.load() > 0)
+        AddressWake(m_sequence, true);
     }
 
     inline void notify() 
     { 
-      cond.notify_one();
+      m_sequence++;
+      if (m_waiters.load() > 0)
+        AddressWake(m_sequence, false);
     }
   };
 
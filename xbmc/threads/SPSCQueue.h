@@ -0,0 +1,143 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace XbmcThreads
+{
+  /**
+   * Bounded single-producer/single-consumer FIFO.
+   *
+   * Push() may only be called from one thread at a time and Pop()/Front()
+   * may only be called from one (other) thread at a time. Neither side
+   * ever blocks or allocates once the queue has been sized. Callers that
+   * need more than one producer or consumer have to serialize each side
+   * themselves.
+   *
+   * The capacity is rounded up to the next power of two.
+   */
+  template<typename T>
+  class CSPSCQueue
+  {
+  public:
+    explicit CSPSCQueue(size_t capacity = 0)
+    {
+      Reset(capacity);
+    }
+
+    CSPSCQueue(const CSPSCQueue&) = delete;
+    CSPSCQueue& operator=(const CSPSCQueue&) = delete;
+
+    /**
+     * Resize the queue and drop all elements. Not thread safe, neither side
+     * may access the queue while this is called.
+     */
+    void Reset(size_t capacity)
+    {
+      size_t size = 1;
+      while (size < capacity)
+        size <<= 1;
+
+      m_buffer.assign(capacity ? size : 0, T());
+      m_mask = size - 1;
+      m_head.store(0, std::memory_order_relaxed);
+      m_tail.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * Producer side. Returns false if the queue is full.
+     */
+    bool Push(const T& value)
+    {
+      const size_t head = m_head.load(std::memory_order_relaxed);
+      if (head - m_tail.load(std::memory_order_acquire) >= m_buffer.size())
+        return false;
+
+      m_buffer[head & m_mask] = value;
+      m_head.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    bool Push(T&& value)
+    {
+      const size_t head = m_head.load(std::memory_order_relaxed);
+      if (head - m_tail.load(std::memory_order_acquire) >= m_buffer.size())
+        return false;
+
+      m_buffer[head & m_mask] = std::move(value);
+      m_head.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * Consumer side. Returns false if the queue is empty.
+     */
+    bool Pop(T& value)
+    {
+      const size_t tail = m_tail.load(std::memory_order_relaxed);
+      if (tail == m_head.load(std::memory_order_acquire))
+        return false;
+
+      value = std::move(m_buffer[tail & m_mask]);
+      m_buffer[tail & m_mask] = T();
+      m_tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * Consumer side. Returns a pointer to the element at position idx counted
+     * from the oldest element or nullptr if there are not enough elements.
+     * The pointer is valid until the element is popped.
+     */
+    const T* Peek(size_t idx = 0) const
+    {
+      const size_t tail = m_tail.load(std::memory_order_relaxed);
+      if (m_head.load(std::memory_order_acquire) - tail <= idx)
+        return nullptr;
+
+      return &m_buffer[(tail + idx) & m_mask];
+    }
+
+    /**
+     * Number of queued elements. Exact on either side, a snapshot otherwise.
+     */
+    size_t Size() const
+    {
+      const size_t tail = m_tail.load(std::memory_order_acquire);
+      return m_head.load(std::memory_order_acquire) - tail;
+    }
+
+    bool Empty() const { return Size() == 0; }
+    size_t Capacity() const { return m_buffer.size(); }
+
+  private:
+    std::vector<T> m_buffer;
+    size_t m_mask = 0;
+
+    // keep producer and consumer indices on separate cache lines
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+  };
+}
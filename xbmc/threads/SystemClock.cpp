@@ -22,7 +22,6 @@
 
 #if   defined(TARGET_DARWIN)
 #include <mach/mach_time.h>
-#include <CoreVideo/CVHostTime.h>
 #elif defined(TARGET_WINDOWS)
 #include <windows.h>
 #else
@@ -30,32 +29,46 @@
 #endif
 #include "SystemClock.h"
 
-namespace XbmcThreads
+namespace
 {
-  unsigned int SystemClockMillis()
+  uint64_t HostClockNanos()
   {
-    uint64_t now_time;
-    static uint64_t start_time = 0;
-    static bool start_time_set = false;
 #if defined(TARGET_DARWIN)
-    now_time = CVGetCurrentHostTime() *  1000 / CVGetHostClockFrequency();
+    static mach_timebase_info_data_t timebase = {};
+    if (timebase.denom == 0)
+      mach_timebase_info(&timebase);
+    return mach_absolute_time() * timebase.numer / timebase.denom;
 #elif defined(TARGET_WINDOWS)
-    now_time = GetTickCount64();
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0)
+      QueryPerformanceFrequency(&frequency);
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    // split to not overflow the multiplication
+    const uint64_t seconds = counter.QuadPart / frequency.QuadPart;
+    const uint64_t rest = counter.QuadPart % frequency.QuadPart;
+    return seconds * 1000000000 + rest * 1000000000 / frequency.QuadPart;
 #else
+    // CLOCK_MONOTONIC rather than CLOCK_MONOTONIC_RAW, as only the former is
+    // read without a syscall on all kernels
     struct timespec ts = {};
-#ifdef CLOCK_MONOTONIC_RAW
-    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
-#else
     clock_gettime(CLOCK_MONOTONIC, &ts);
-#endif // CLOCK_MONOTONIC_RAW
-    now_time = (ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
 #endif
-    if (!start_time_set)
-    {
-      start_time = now_time;
-      start_time_set = true;
-    }
-    return (unsigned int)(now_time - start_time);
+  }
+}
+
+namespace XbmcThreads
+{
+  uint64_t SystemClockNanos()
+  {
+    static const uint64_t start_time = HostClockNanos();
+    return HostClockNanos() - start_time;
+  }
+
+  unsigned int SystemClockMillis()
+  {
+    return (unsigned int)(SystemClockNanos() / 1000000);
   }
   const unsigned int EndTime::InfiniteValue = std::numeric_limits<unsigned int>::max();
 }
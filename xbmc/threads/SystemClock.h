@@ -21,9 +21,19 @@
 #pragma once
 
 #include <limits>
+#include <stdint.h>
 
 namespace XbmcThreads
 {
+  /**
+   * The number of nanoseconds since the same reference point as
+   *  SystemClockMillis(), from the monotonic clock with the cheapest reads the
+   *  platform has (the vDSO on Linux, which reads the TSC when the kernel
+   *  trusts it). Use it for frame timing and profiling, where milliseconds
+   *  are too coarse. It doesn't wrap.
+   */
+  uint64_t SystemClockNanos();
+
   /**
    * This function returns the system clock's number of milliseconds but with
    *  an arbitrary reference point. It handles the wrapping of any underlying
@@ -74,6 +74,7 @@ public:
   static bool IsCurrentThread(const ThreadIdentifier tid);
   static ThreadIdentifier GetCurrentThreadId();
   static CThread* GetCurrentThread();
+  const std::string& GetThreadName() const { return m_ThreadName; }
 
   virtual void OnException(){} // signal termination handler
 protected:
@@ -0,0 +1,40 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+
+namespace XbmcThreads
+{
+  /**
+   * Blocks while address holds expected, until AddressWake() is called for
+   *  address or milliseconds passed. Like a condition variable it may return
+   *  spuriously, so callers check the value again.
+   *
+   * Returns false if the wait timed out.
+   */
+  bool AddressWait(std::atomic<int>& address, int expected, unsigned int milliseconds);
+
+  /**
+   * Wakes one or all threads in AddressWait() on address. Change the value
+   *  before calling this.
+   */
+  void AddressWake(std::atomic<int>& address, bool all);
+}
@@ -0,0 +1,76 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <stdint.h>
+
+namespace XbmcThreads
+{
+  /**
+   * AddressWait()/AddressWake() for systems without a wait on address. Waiters
+   *  park on one of a fixed set of condition variables chosen by the address.
+   */
+  class CParkingLot
+  {
+  public:
+    bool Wait(std::atomic<int>& address, int expected, unsigned int milliseconds)
+    {
+      Bucket& bucket = GetBucket(&address);
+      std::unique_lock<std::mutex> lock(bucket.mutex);
+      if (address.load() != expected)
+        return true;
+      if (milliseconds == std::numeric_limits<unsigned int>::max())
+      {
+        bucket.cond.wait(lock);
+        return true;
+      }
+      return bucket.cond.wait_for(lock, std::chrono::milliseconds(milliseconds)) == std::cv_status::no_timeout;
+    }
+
+    void Wake(std::atomic<int>& address, bool all)
+    {
+      Bucket& bucket = GetBucket(&address);
+      // a waiter that saw the old value is waiting once we get the mutex
+      { std::lock_guard<std::mutex> lock(bucket.mutex); }
+      // other addresses share the bucket, so waking one could wake the wrong waiter
+      bucket.cond.notify_all();
+    }
+
+  private:
+    struct Bucket
+    {
+      std::mutex mutex;
+      std::condition_variable cond;
+    };
+
+    Bucket& GetBucket(const void* address)
+    {
+      return m_buckets[(reinterpret_cast<uintptr_t>(address) >> 4) % BUCKETS];
+    }
+
+    static const unsigned int BUCKETS = 61;
+    Bucket m_buckets[BUCKETS];
+  };
+}
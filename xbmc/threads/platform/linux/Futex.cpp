@@ -0,0 +1,54 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <limits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace XbmcThreads
+{
+  static_assert(sizeof(std::atomic<int>) == sizeof(int), "futex needs a plain int");
+
+  bool AddressWait(std::atomic<int>& address, int expected, unsigned int milliseconds)
+  {
+    struct timespec timeout;
+    struct timespec* ptimeout = nullptr;
+    if (milliseconds != std::numeric_limits<unsigned int>::max())
+    {
+      timeout.tv_sec = milliseconds / 1000;
+      timeout.tv_nsec = (milliseconds % 1000) * 1000000L;
+      ptimeout = &timeout;
+    }
+
+    // returns EAGAIN right away if the value changed already
+    if (syscall(SYS_futex, reinterpret_cast<int*>(&address), FUTEX_WAIT_PRIVATE, expected, ptimeout, nullptr, 0) == -1)
+      return errno != ETIMEDOUT;
+    return true;
+  }
+
+  void AddressWake(std::atomic<int>& address, bool all)
+  {
+    syscall(SYS_futex, reinterpret_cast<int*>(&address), FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, nullptr, nullptr, 0);
+  }
+}
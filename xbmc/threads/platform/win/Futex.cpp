@@ -0,0 +1,100 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/platform/ParkingLot.h"
+
+#include <windows.h>
+
+namespace XbmcThreads
+{
+#if defined(TARGET_WINDOWS_STORE)
+  // always there on Windows 10
+  bool AddressWait(std::atomic<int>& address, int expected, unsigned int milliseconds)
+  {
+    if (!WaitOnAddress(&address, &expected, sizeof(expected), milliseconds == std::numeric_limits<unsigned int>::max() ? INFINITE : milliseconds))
+      return GetLastError() != ERROR_TIMEOUT;
+    return true;
+  }
+
+  void AddressWake(std::atomic<int>& address, bool all)
+  {
+    if (all)
+      WakeByAddressAll(&address);
+    else
+      WakeByAddressSingle(&address);
+  }
+#else
+  // WaitOnAddress() came with Windows 8, park in user space before that
+  namespace
+  {
+    typedef BOOL (WINAPI *WaitOnAddressFunc)(volatile VOID*, PVOID, SIZE_T, DWORD);
+    typedef VOID (WINAPI *WakeByAddressFunc)(PVOID);
+
+    struct CAddressFunctions
+    {
+      CAddressFunctions()
+      {
+        HMODULE module = LoadLibraryW(L"api-ms-win-core-synch-l1-2-0.dll");
+        if (module)
+        {
+          wait = reinterpret_cast<WaitOnAddressFunc>(GetProcAddress(module, "WaitOnAddress"));
+          wakeSingle = reinterpret_cast<WakeByAddressFunc>(GetProcAddress(module, "WakeByAddressSingle"));
+          wakeAll = reinterpret_cast<WakeByAddressFunc>(GetProcAddress(module, "WakeByAddressAll"));
+        }
+        if (!wait || !wakeSingle || !wakeAll)
+          wait = nullptr;
+      }
+
+      WaitOnAddressFunc wait = nullptr;
+      WakeByAddressFunc wakeSingle = nullptr;
+      WakeByAddressFunc wakeAll = nullptr;
+      CParkingLot parkingLot;
+    };
+
+    CAddressFunctions& GetAddressFunctions()
+    {
+      static CAddressFunctions functions;
+      return functions;
+    }
+  }
+
+  bool AddressWait(std::atomic<int>& address, int expected, unsigned int milliseconds)
+  {
+    CAddressFunctions& functions = GetAddressFunctions();
+    if (!functions.wait)
+      return functions.parkingLot.Wait(address, expected, milliseconds);
+
+    if (!functions.wait(&address, &expected, sizeof(expected), milliseconds == std::numeric_limits<unsigned int>::max() ? INFINITE : milliseconds))
+      return GetLastError() != ERROR_TIMEOUT;
+    return true;
+  }
+
+  void AddressWake(std::atomic<int>& address, bool all)
+  {
+    CAddressFunctions& functions = GetAddressFunctions();
+    if (!functions.wait)
+      functions.parkingLot.Wake(address, all);
+    else if (all)
+      functions.wakeAll(&address);
+    else
+      functions.wakeSingle(&address);
+  }
+#endif
+}
@@ -0,0 +1,117 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Condition.h"
+#include "threads/Event.h"
+#include "threads/SystemClock.h"
+
+#include "gtest/gtest.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdio.h>
+#include <thread>
+
+#define PING_PONGS 2000
+
+using namespace XbmcThreads;
+
+namespace
+{
+// average nanoseconds from waking the other thread until it wakes us again
+uint64_t PingPong(const std::function<void()>& ping, const std::function<void()>& waitPong,
+                  const std::function<void()>& waitPing, const std::function<void()>& pong)
+{
+  std::thread other([&]()
+  {
+    for (int i = 0; i < PING_PONGS; i++)
+    {
+      waitPing();
+      pong();
+    }
+  });
+
+  uint64_t start = SystemClockNanos();
+  for (int i = 0; i < PING_PONGS; i++)
+  {
+    ping();
+    waitPong();
+  }
+  uint64_t elapsed = SystemClockNanos() - start;
+  other.join();
+  return elapsed / (PING_PONGS * 2);
+}
+}
+
+TEST(TestCondition, TimedWaitTimeout)
+{
+  CCriticalSection section;
+  ConditionVariable cond;
+  CSingleLock lock(section);
+
+  unsigned int start = SystemClockMillis();
+  EXPECT_FALSE(cond.wait(lock, 50));
+  EXPECT_GE(SystemClockMillis() - start, 50u);
+  EXPECT_FALSE(cond.wait(lock, 0));
+}
+
+TEST(TestCondition, Notify)
+{
+  CCriticalSection section;
+  ConditionVariable cond;
+  bool ready = false;
+
+  std::thread notifier([&]()
+  {
+    CSingleLock lock(section);
+    ready = true;
+    cond.notifyAll();
+  });
+
+  {
+    CSingleLock lock(section);
+    while (!ready)
+      EXPECT_TRUE(cond.wait(lock, 10000));
+  }
+  notifier.join();
+}
+
+// not a pass/fail test, prints the wake latency of CEvent next to a plain
+// std::condition_variable for comparing platforms and changes
+TEST(TestCondition, WakeLatency)
+{
+  CEvent ping, pong;
+  uint64_t event = PingPong([&]() { ping.Set(); }, [&]() { pong.Wait(); },
+                            [&]() { ping.Wait(); }, [&]() { pong.Set(); });
+
+  std::mutex mutex;
+  std::condition_variable pingCond, pongCond;
+  bool pinged = false, ponged = false;
+  uint64_t plain = PingPong([&]() { std::lock_guard<std::mutex> lock(mutex); pinged = true; pingCond.notify_one(); },
+                          [&]() { std::unique_lock<std::mutex> lock(mutex); pongCond.wait(lock, [&]() { return ponged; }); ponged = false; },
+                          [&]() { std::unique_lock<std::mutex> lock(mutex); pingCond.wait(lock, [&]() { return pinged; }); pinged = false; },
+                          [&]() { std::lock_guard<std::mutex> lock(mutex); ponged = true; pongCond.notify_one(); });
+
+  printf("wake latency: CEvent %llu ns, std::condition_variable %llu ns\n",
+         static_cast<unsigned long long>(event), static_cast<unsigned long long>(plain));
+  RecordProperty("CEvent", static_cast<int>(event));
+  RecordProperty("std_condition_variable", static_cast<int>(plain));
+}
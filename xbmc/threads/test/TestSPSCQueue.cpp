@@ -0,0 +1,91 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/SPSCQueue.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace XbmcThreads;
+
+TEST(TestSPSCQueue, General)
+{
+  CSPSCQueue<int> queue(3);
+  int value = 0;
+
+  EXPECT_EQ(4U, queue.Capacity());
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_FALSE(queue.Pop(value));
+  EXPECT_EQ(nullptr, queue.Peek());
+
+  for (int i = 0; i < 4; i++)
+    EXPECT_TRUE(queue.Push(i));
+  EXPECT_FALSE(queue.Push(4));
+  EXPECT_EQ(4U, queue.Size());
+  EXPECT_EQ(0, *queue.Peek());
+  EXPECT_EQ(3, *queue.Peek(3));
+  EXPECT_EQ(nullptr, queue.Peek(4));
+
+  for (int i = 0; i < 4; i++)
+  {
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(TestSPSCQueue, Disabled)
+{
+  CSPSCQueue<int> queue;
+
+  EXPECT_EQ(0U, queue.Capacity());
+  EXPECT_FALSE(queue.Push(1));
+}
+
+TEST(TestSPSCQueue, Threaded)
+{
+  const int count = 100000;
+  CSPSCQueue<int> queue(64);
+
+  std::thread producer([&queue, count]() {
+    for (int i = 0; i < count; i++)
+    {
+      while (!queue.Push(i))
+        std::this_thread::yield();
+    }
+  });
+
+  int expected = 0;
+  while (expected < count)
+  {
+    int value;
+    if (queue.Pop(value))
+    {
+      ASSERT_EQ(expected, value);
+      expected++;
+    }
+    else
+      std::this_thread::yield();
+  }
+
+  producer.join();
+  EXPECT_TRUE(queue.Empty());
+}
@@ -322,6 +322,8 @@ CBitstreamConverter::CBitstreamConverter()
   m_convert_bitstream = false;
   m_convertBuffer     = NULL;
   m_convertSize       = 0;
+  m_convertArena      = NULL;
+  m_convertArenaSize  = 0;
   m_inputBuffer       = NULL;
   m_inputSize         = 0;
   m_to_annexb         = false;
@@ -502,10 +504,13 @@ void CBitstreamConverter::Close(void)
   if (m_sps_pps_context.sps_pps_data)
     av_free(m_sps_pps_context.sps_pps_data), m_sps_pps_context.sps_pps_data = NULL;
 
-  if (m_convertBuffer)
-    av_free(m_convertBuffer), m_convertBuffer = NULL;
+  FreeConvertBuffer();
   m_convertSize = 0;
 
+  if (m_convertArena)
+    av_free(m_convertArena), m_convertArena = NULL;
+  m_convertArenaSize = 0;
+
   if (m_extradata)
     av_free(m_extradata), m_extradata = NULL;
   m_extrasize = 0;
@@ -520,11 +525,7 @@ void CBitstreamConverter::Close(void)
 
 bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
 {
-  if (m_convertBuffer)
-  {
-    av_free(m_convertBuffer);
-    m_convertBuffer = NULL;
-  }
+  FreeConvertBuffer();
   m_inputSize = 0;
   m_convertSize = 0;
   m_inputBuffer = NULL;
@@ -541,16 +542,20 @@ bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
 
         if (m_convert_bitstream)
         {
-          // convert demuxer packet from bitstream to bytestream (AnnexB)
+          // convert demuxer packet from bitstream to bytestream (AnnexB),
+          // the output goes to a buffer kept across packets
           int bytestream_size = 0;
-          uint8_t *bytestream_buff = NULL;
-
-          BitstreamConvert(demuxer_content, demuxer_bytes, &bytestream_buff, &bytestream_size);
-          if (bytestream_buff && (bytestream_size > 0))
+          if (BitstreamConvert(demuxer_content, demuxer_bytes, NULL, &bytestream_size) &&
+              bytestream_size > 0)
           {
-            m_convertSize   = bytestream_size;
-            m_convertBuffer = bytestream_buff;
-            return true;
+            av_fast_padded_malloc(&m_convertArena, &m_convertArenaSize, bytestream_size);
+            if (m_convertArena)
+            {
+              BitstreamConvert(demuxer_content, demuxer_bytes, m_convertArena, &bytestream_size);
+              m_convertSize   = bytestream_size;
+              m_convertBuffer = m_convertArena;
+              return true;
+            }
           }
           else
           {
@@ -574,13 +579,6 @@ bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
 
         if (m_convert_bytestream)
         {
-          if(m_convertBuffer)
-          {
-            av_free(m_convertBuffer);
-            m_convertBuffer = NULL;
-          }
-          m_convertSize = 0;
-
           // convert demuxer packet from bytestream (AnnexB) to bitstream
           AVIOContext *pb;
 
@@ -593,13 +591,6 @@ bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
         }
         else if (m_convert_3byteTo4byteNALSize)
         {
-          if(m_convertBuffer)
-          {
-            av_free(m_convertBuffer);
-            m_convertBuffer = NULL;
-          }
-          m_convertSize = 0;
-
           // convert demuxer packet from 3 byte NAL sizes to 4 byte
           AVIOContext *pb;
           if (avio_open_dyn_buf(&pb) < 0)
@@ -628,6 +619,29 @@ bool CBitstreamConverter::Convert(uint8_t *pData, int iSize)
 }
 
 
+int CBitstreamConverter::ConvertTo(const uint8_t *pData, int iSize, uint8_t *pDest, int iDestSize)
+{
+  if (!pData || !pDest || !m_to_annexb || !m_convert_bitstream ||
+      (m_codec != AV_CODEC_ID_H264 && m_codec != AV_CODEC_ID_HEVC))
+    return -1;
+
+  int bytestream_size = 0;
+  if (!BitstreamConvert(pData, iSize, NULL, &bytestream_size) ||
+      bytestream_size <= 0 || bytestream_size > iDestSize)
+    return -1;
+
+  BitstreamConvert(pData, iSize, pDest, &bytestream_size);
+  return bytestream_size;
+}
+
+void CBitstreamConverter::FreeConvertBuffer()
+{
+  // the arena is kept, buffers of the avio conversions are per packet
+  if (m_convertBuffer && m_convertBuffer != m_convertArena)
+    av_free(m_convertBuffer);
+  m_convertBuffer = NULL;
+}
+
 uint8_t *CBitstreamConverter::GetConvertBuffer() const
 {
   if((m_convert_bitstream || m_convert_bytestream || m_convert_3byteTo4byteNALSize) && m_convertBuffer != NULL)
@@ -874,20 +888,27 @@ bool CBitstreamConverter::IsSlice(uint8_t unit_type)
   }
 }
 
-bool CBitstreamConverter::BitstreamConvert(uint8_t* pData, int iSize, uint8_t **poutbuf, int *poutbuf_size)
+bool CBitstreamConverter::BitstreamConvert(const uint8_t* pData, int iSize, uint8_t *poutbuf, int *poutbuf_size)
 {
   // based on h264_mp4toannexb_bsf.c (ffmpeg)
   // which is Copyright (c) 2007 Benoit Fouet <benoit.fouet@free.fr>
   // and Licensed GPL 2.1 or greater
 
   int i;
-  uint8_t *buf = pData;
+  const uint8_t *buf = pData;
   uint32_t buf_size = iSize;
   uint8_t  unit_type, nal_sps, nal_pps, nal_sei;
   int32_t  nal_size;
   uint32_t cumul_size = 0;
   const uint8_t *buf_end = buf + buf_size;
 
+  // without an output buffer only the size is computed, the state is
+  // committed once the packet is written
+  uint8_t first_idr = m_sps_pps_context.first_idr;
+  uint8_t idr_sps_pps_seen = m_sps_pps_context.idr_sps_pps_seen;
+  bool start_decode = m_start_decode;
+  int out_size = 0;
+
   switch (m_codec)
   {
     case AV_CODEC_ID_H264:
@@ -926,26 +947,26 @@ bool CBitstreamConverter::BitstreamConvert(uint8_t* pData, int iSize, uint8_t **
       goto fail;
 
     // Don't add sps/pps if the unit already contain them
-    if (m_sps_pps_context.first_idr && (unit_type == nal_sps || unit_type == nal_pps))
-      m_sps_pps_context.idr_sps_pps_seen = 1;
+    if (first_idr && (unit_type == nal_sps || unit_type == nal_pps))
+      idr_sps_pps_seen = 1;
 
-    if (!m_start_decode && (unit_type == nal_sps || IsIDR(unit_type) || (unit_type == nal_sei && has_sei_recovery_point(buf, buf + nal_size))))
-      m_start_decode = true;
+    if (!start_decode && (unit_type == nal_sps || IsIDR(unit_type) || (unit_type == nal_sei && has_sei_recovery_point(buf, buf + nal_size))))
+      start_decode = true;
 
     // prepend only to the first access unit of an IDR picture, if no sps/pps already present
-    if (m_sps_pps_context.first_idr && IsIDR(unit_type) && !m_sps_pps_context.idr_sps_pps_seen)
+    if (first_idr && IsIDR(unit_type) && !idr_sps_pps_seen)
     {
-      BitstreamAllocAndCopy(poutbuf, poutbuf_size,
+      BitstreamCopy(poutbuf, &out_size,
         m_sps_pps_context.sps_pps_data, m_sps_pps_context.size, buf, nal_size);
-      m_sps_pps_context.first_idr = 0;
+      first_idr = 0;
     }
     else
     {
-      BitstreamAllocAndCopy(poutbuf, poutbuf_size, NULL, 0, buf, nal_size);
-      if (!m_sps_pps_context.first_idr && IsSlice(unit_type))
+      BitstreamCopy(poutbuf, &out_size, NULL, 0, buf, nal_size);
+      if (!first_idr && IsSlice(unit_type))
       {
-          m_sps_pps_context.first_idr = 1;
-          m_sps_pps_context.idr_sps_pps_seen = 0;
+          first_idr = 1;
+          idr_sps_pps_seen = 0;
       }
     }
 
@@ -953,15 +974,21 @@ bool CBitstreamConverter::BitstreamConvert(uint8_t* pData, int iSize, uint8_t **
     cumul_size += nal_size + m_sps_pps_context.length_size;
   } while (cumul_size < buf_size);
 
+  *poutbuf_size = out_size;
+  if (poutbuf)
+  {
+    m_sps_pps_context.first_idr = first_idr;
+    m_sps_pps_context.idr_sps_pps_seen = idr_sps_pps_seen;
+    m_start_decode = start_decode;
+  }
   return true;
 
 fail:
-  av_free(*poutbuf), *poutbuf = NULL;
   *poutbuf_size = 0;
   return false;
 }
 
-void CBitstreamConverter::BitstreamAllocAndCopy( uint8_t **poutbuf, int *poutbuf_size,
+void CBitstreamConverter::BitstreamCopy(uint8_t *poutbuf, int *poutbuf_size,
     const uint8_t *sps_pps, uint32_t sps_pps_size, const uint8_t *in, uint32_t in_size)
 {
   // based on h264_mp4toannexb_bsf.c (ffmpeg)
@@ -970,26 +997,24 @@ void CBitstreamConverter::BitstreamAllocAndCopy( uint8_t **poutbuf, int *poutbuf
 
   uint32_t offset = *poutbuf_size;
   uint8_t nal_header_size = offset ? 3 : 4;
-  void *tmp;
 
   *poutbuf_size += sps_pps_size + in_size + nal_header_size;
-  tmp = av_realloc(*poutbuf, *poutbuf_size);
-  if (!tmp)
+  if (!poutbuf)
     return;
-  *poutbuf = (uint8_t*)tmp;
+
   if (sps_pps)
-    memcpy(*poutbuf + offset, sps_pps, sps_pps_size);
+    memcpy(poutbuf + offset, sps_pps, sps_pps_size);
 
-  memcpy(*poutbuf + sps_pps_size + nal_header_size + offset, in, in_size);
+  memcpy(poutbuf + sps_pps_size + nal_header_size + offset, in, in_size);
   if (!offset)
   {
-    BS_WB32(*poutbuf + sps_pps_size, 1);
+    BS_WB32(poutbuf + sps_pps_size, 1);
   }
   else
   {
-    (*poutbuf + offset + sps_pps_size)[0] = 0;
-    (*poutbuf + offset + sps_pps_size)[1] = 0;
-    (*poutbuf + offset + sps_pps_size)[2] = 1;
+    (poutbuf + offset + sps_pps_size)[0] = 0;
+    (poutbuf + offset + sps_pps_size)[1] = 0;
+    (poutbuf + offset + sps_pps_size)[2] = 1;
   }
 }
 
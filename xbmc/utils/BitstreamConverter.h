@@ -102,6 +102,9 @@ public:
   void              Close(void);
   bool              NeedConvert(void) const { return m_convert_bitstream; };
   bool              Convert(uint8_t *pData, int iSize);
+  // bitstream to Annex B straight into pDest, returns the bytes written or -1 if
+  // the packet isn't converted this way or doesn't fit, Convert() has to be used then
+  int               ConvertTo(const uint8_t *pData, int iSize, uint8_t *pDest, int iDestSize);
   uint8_t*          GetConvertBuffer(void) const;
   int               GetConvertSize() const;
   uint8_t*          GetExtraData(void) const;
@@ -120,9 +123,10 @@ protected:
   bool              IsSlice(uint8_t unit_type);
   bool              BitstreamConvertInitAVC(void *in_extradata, int in_extrasize);
   bool              BitstreamConvertInitHEVC(void *in_extradata, int in_extrasize);
-  bool              BitstreamConvert(uint8_t* pData, int iSize, uint8_t **poutbuf, int *poutbuf_size);
-  static void       BitstreamAllocAndCopy(uint8_t **poutbuf, int *poutbuf_size,
+  bool              BitstreamConvert(const uint8_t* pData, int iSize, uint8_t *poutbuf, int *poutbuf_size);
+  static void       BitstreamCopy(uint8_t *poutbuf, int *poutbuf_size,
                       const uint8_t *sps_pps, uint32_t sps_pps_size, const uint8_t *in, uint32_t in_size);
+  void              FreeConvertBuffer();
 
   typedef struct omx_bitstream_ctx {
       uint8_t  length_size;
@@ -134,6 +138,8 @@ protected:
 
   uint8_t          *m_convertBuffer;
   int               m_convertSize;
+  uint8_t          *m_convertArena;
+  unsigned int      m_convertArenaSize;
   uint8_t          *m_inputBuffer;
   int               m_inputSize;
 
@@ -21,6 +21,8 @@
 #include "CharsetConverter.h"
 
 #include <algorithm>
+#include <stdint.h>
+#include <string.h>
 
 #ifndef TARGET_FREEBSD
 #include <iconv.h>
@@ -286,6 +288,245 @@ enum StdConversionType /* Keep it in sync with CCharsetConverter::CInnerConverte
   NumberOfStdConversionTypes /* Dummy sentinel entry */
 };
 
+/* Conversions between UTF-8, UTF-16 and UTF-32 (and wchar_t, which is one of the latter)
+   don't need iconv. They are done by unicodeConvert() without taking the converter lock. */
+enum UnicodeFastPath
+{
+  UnicodeNone = 0,
+  UnicodeNative,  /* source in host byte order */
+  UnicodeSwapped  /* UTF-16 source in the other byte order */
+};
+
+#ifdef WORDS_BIGENDIAN
+  #define UTF16LE_FAST_PATH UnicodeSwapped
+  #define UTF16BE_FAST_PATH UnicodeNative
+#else
+  #define UTF16LE_FAST_PATH UnicodeNative
+  #define UTF16BE_FAST_PATH UnicodeSwapped
+#endif
+
+#if defined(TARGET_DARWIN)
+  /* UTF-8-MAC composes decomposed characters, leave that to iconv */
+  #define UTF8_SOURCE_FAST_PATH UnicodeNone
+#else
+  #define UTF8_SOURCE_FAST_PATH UnicodeNative
+#endif
+
+static UnicodeFastPath GetUnicodeFastPath(StdConversionType convertType)
+{
+  switch (convertType)
+  {
+  case Utf8ToUtf32:
+  case Utf8toW:
+    return UTF8_SOURCE_FAST_PATH;
+  case Utf32ToUtf8:
+  case Utf32ToW:
+  case WToUtf32:
+  case WtoUtf8:
+    return UnicodeNative;
+  case Utf16LEtoW:
+  case Utf16LEtoUtf8:
+    return UTF16LE_FAST_PATH;
+  case Utf16BEtoUtf8:
+    return UTF16BE_FAST_PATH;
+  default:
+    return UnicodeNone;
+  }
+}
+
+namespace
+{
+enum DecodeResult
+{
+  Decoded,
+  InvalidChar,    /* skip one code unit, as iconv() does on EILSEQ */
+  TruncatedChar   /* incomplete character at the end, as iconv() does on EINVAL */
+};
+
+inline bool IsValidCodePoint(uint32_t cp)
+{
+  return cp <= 0x10FFFF && (cp < 0xD800 || cp > 0xDFFF);
+}
+
+/* decoding and encoding by the size of the code unit of the string */
+template<size_t UNIT_SIZE>
+struct CUnicodeCodec;
+
+template<>
+struct CUnicodeCodec<1> /* UTF-8 */
+{
+  template<class STR>
+  static DecodeResult Decode(const STR& str, size_t& pos, bool swap, uint32_t& cp)
+  {
+    const size_t len = str.length();
+    const uint8_t lead = static_cast<uint8_t>(str[pos]);
+    size_t count;
+    uint32_t minCp;
+    if (lead < 0x80)
+    {
+      cp = lead;
+      pos++;
+      return Decoded;
+    }
+    else if (lead >= 0xC2 && lead <= 0xDF)
+    {
+      count = 1;
+      minCp = 0x80;
+      cp = lead & 0x1F;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+      count = 2;
+      minCp = 0x800;
+      cp = lead & 0x0F;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+      count = 3;
+      minCp = 0x10000;
+      cp = lead & 0x07;
+    }
+    else
+      return InvalidChar;
+
+    for (size_t i = 1; i <= count; i++)
+    {
+      if (pos + i >= len)
+        return TruncatedChar;
+      const uint8_t next = static_cast<uint8_t>(str[pos + i]);
+      if ((next & 0xC0) != 0x80)
+        return InvalidChar;
+      cp = (cp << 6) | (next & 0x3F);
+      // reject overlong forms and surrogates as soon as the second byte tells
+      if (i == 1 && count > 1 && (cp << (6 * (count - 1))) < minCp)
+        return InvalidChar;
+    }
+    if (cp < minCp || !IsValidCodePoint(cp))
+      return InvalidChar;
+
+    pos += count + 1;
+    return Decoded;
+  }
+
+  template<class STR>
+  static void Encode(uint32_t cp, STR& str)
+  {
+    typedef typename STR::value_type unit;
+    if (cp < 0x80)
+      str.push_back(static_cast<unit>(cp));
+    else if (cp < 0x800)
+    {
+      str.push_back(static_cast<unit>(0xC0 | (cp >> 6)));
+      str.push_back(static_cast<unit>(0x80 | (cp & 0x3F)));
+    }
+    else if (cp < 0x10000)
+    {
+      str.push_back(static_cast<unit>(0xE0 | (cp >> 12)));
+      str.push_back(static_cast<unit>(0x80 | ((cp >> 6) & 0x3F)));
+      str.push_back(static_cast<unit>(0x80 | (cp & 0x3F)));
+    }
+    else
+    {
+      str.push_back(static_cast<unit>(0xF0 | (cp >> 18)));
+      str.push_back(static_cast<unit>(0x80 | ((cp >> 12) & 0x3F)));
+      str.push_back(static_cast<unit>(0x80 | ((cp >> 6) & 0x3F)));
+      str.push_back(static_cast<unit>(0x80 | (cp & 0x3F)));
+    }
+  }
+};
+
+template<>
+struct CUnicodeCodec<2> /* UTF-16 */
+{
+  static uint32_t Unit(uint32_t unit, bool swap)
+  {
+    return swap ? (((unit & 0xFF) << 8) | ((unit >> 8) & 0xFF)) : (unit & 0xFFFF);
+  }
+
+  template<class STR>
+  static DecodeResult Decode(const STR& str, size_t& pos, bool swap, uint32_t& cp)
+  {
+    cp = Unit(static_cast<uint32_t>(str[pos]), swap);
+    if (cp < 0xD800 || cp > 0xDFFF)
+    {
+      pos++;
+      return Decoded;
+    }
+    if (cp > 0xDBFF)
+      return InvalidChar;
+    if (pos + 1 >= str.length())
+      return TruncatedChar;
+
+    const uint32_t low = Unit(static_cast<uint32_t>(str[pos + 1]), swap);
+    if (low < 0xDC00 || low > 0xDFFF)
+      return InvalidChar;
+
+    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+    pos += 2;
+    return Decoded;
+  }
+
+  template<class STR>
+  static void Encode(uint32_t cp, STR& str)
+  {
+    typedef typename STR::value_type unit;
+    if (cp < 0x10000)
+      str.push_back(static_cast<unit>(cp));
+    else
+    {
+      cp -= 0x10000;
+      str.push_back(static_cast<unit>(0xD800 + (cp >> 10)));
+      str.push_back(static_cast<unit>(0xDC00 + (cp & 0x3FF)));
+    }
+  }
+};
+
+template<>
+struct CUnicodeCodec<4> /* UTF-32 */
+{
+  template<class STR>
+  static DecodeResult Decode(const STR& str, size_t& pos, bool swap, uint32_t& cp)
+  {
+    cp = static_cast<uint32_t>(str[pos]);
+    if (!IsValidCodePoint(cp))
+      return InvalidChar;
+    pos++;
+    return Decoded;
+  }
+
+  template<class STR>
+  static void Encode(uint32_t cp, STR& str)
+  {
+    str.push_back(static_cast<typename STR::value_type>(cp));
+  }
+};
+
+/* length of the run of 7-bit characters starting at pos, checked eight bytes at a time */
+inline size_t AsciiRun(const std::string& str, size_t pos)
+{
+  const size_t start = pos;
+  const size_t len = str.length();
+  const char* data = str.data();
+  while (pos + 8 <= len)
+  {
+    uint64_t block;
+    memcpy(&block, data + pos, sizeof(block));
+    if (block & UINT64_C(0x8080808080808080))
+      break;
+    pos += 8;
+  }
+  while (pos < len && static_cast<uint8_t>(data[pos]) < 0x80)
+    pos++;
+  return pos - start;
+}
+
+template<class INPUT>
+inline size_t AsciiRun(const INPUT& str, size_t pos)
+{
+  return 0;
+}
+}
+
 /* We don't want to pollute header file with many additional includes and definitions, so put 
    here all staff that require usage of types defined in this file or in additional headers */
 class CCharsetConverter::CInnerConverter
@@ -301,6 +542,9 @@ public:
   template<class INPUT,class OUTPUT>
   static bool convert(iconv_t type, int multiplier, const INPUT& strSource, OUTPUT& strDest, bool failOnInvalidChar = false);
 
+  template<class INPUT,class OUTPUT>
+  static bool unicodeConvert(const INPUT& strSource, OUTPUT& strDest, bool swapSource, bool failOnInvalidChar = false);
+
   static CConverterType m_stdConversion[NumberOfStdConversionTypes];
   static CCriticalSection m_critSectionFriBiDi;
 };
@@ -343,6 +587,16 @@ bool CCharsetConverter::CInnerConverter::stdConvert(StdConversionType convertTyp
   if (convertType < 0 || convertType >= NumberOfStdConversionTypes)
     return false;
 
+  switch (GetUnicodeFastPath(convertType))
+  {
+  case UnicodeNative:
+    return unicodeConvert(strSource, strDest, false, failOnInvalidChar);
+  case UnicodeSwapped:
+    return unicodeConvert(strSource, strDest, true, failOnInvalidChar);
+  default:
+    break;
+  }
+
   CConverterType& convType = m_stdConversion[convertType];
   CSingleLock converterLock(convType);
 
@@ -489,6 +743,53 @@ bool CCharsetConverter::CInnerConverter::convert(iconv_t type, int multiplier, c
   return true;
 }
 
+template<class INPUT,class OUTPUT>
+bool CCharsetConverter::CInnerConverter::unicodeConvert(const INPUT& strSource, OUTPUT& strDest, bool swapSource, bool failOnInvalidChar /*= false*/)
+{
+  typedef CUnicodeCodec<sizeof(typename INPUT::value_type)> Decoder;
+  typedef CUnicodeCodec<sizeof(typename OUTPUT::value_type)> Encoder;
+
+  const size_t len = strSource.length();
+  strDest.reserve(len);
+
+  size_t pos = 0;
+  while (pos < len)
+  {
+    const size_t ascii = AsciiRun(strSource, pos);
+    if (ascii > 0)
+    {
+      strDest.append(strSource.begin() + pos, strSource.begin() + pos + ascii);
+      pos += ascii;
+      continue;
+    }
+
+    uint32_t cp;
+    const DecodeResult result = Decoder::Decode(strSource, pos, swapSource, cp);
+    if (result == Decoded)
+      Encoder::Encode(cp, strDest);
+    else if (result == InvalidChar)
+    {
+      if (failOnInvalidChar)
+      {
+        strDest.clear();
+        return false;
+      }
+      pos++;
+    }
+    else /* TruncatedChar */
+    {
+      if (failOnInvalidChar)
+      {
+        strDest.clear();
+        return false;
+      }
+      break;
+    }
+  }
+
+  return true;
+}
+
 bool CCharsetConverter::CInnerConverter::logicalToVisualBiDi(const std::u32string& stringSrc, std::u32string& stringDst, FriBidiCharType base /*= FRIBIDI_TYPE_LTR*/, const bool failOnBadString /*= false*/)
 {
   stringDst.clear();
@@ -89,6 +89,38 @@ uint32_t  crc_tab[256] =
  0xBCB4666DL, 0xB8757BDAL, 0xB5365D03L, 0xB1F740B4L
 };
 
+namespace
+{
+/* Tables for slicing-by-8: crc_tab advances the crc by one byte, table n by n + 1
+   bytes, so eight bytes take eight lookups that don't depend on each other. */
+struct CrcSliceTables
+{
+  uint32_t table[8][256];
+
+  CrcSliceTables()
+  {
+    for (unsigned int i = 0; i < 256; i++)
+    {
+      table[0][i] = crc_tab[i];
+      for (unsigned int n = 1; n < 8; n++)
+        table[n][i] = (table[n - 1][i] << 8) ^ crc_tab[table[n - 1][i] >> 24];
+    }
+  }
+};
+
+const CrcSliceTables& GetSliceTables()
+{
+  static const CrcSliceTables tables;
+  return tables;
+}
+
+inline uint32_t ReadBigEndian(const unsigned char* data)
+{
+  return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) | data[3];
+}
+}
+
 Crc32::Crc32()
 {
   Reset();
@@ -101,8 +133,25 @@ void Crc32::Reset()
 
 void Crc32::Compute(const char* buffer, size_t count)
 {
-   while (count--)
-      m_crc = (m_crc << 8) ^ crc_tab[((m_crc >> 24) ^ *buffer++) & 0xFF];
+  const unsigned char* data = reinterpret_cast<const unsigned char*>(buffer);
+  if (count >= 16)
+  {
+    const uint32_t (&table)[8][256] = GetSliceTables().table;
+    uint32_t crc = m_crc;
+    for (; count >= 8; count -= 8, data += 8)
+    {
+      const uint32_t one = crc ^ ReadBigEndian(data);
+      const uint32_t two = ReadBigEndian(data + 4);
+      crc = table[7][one >> 24] ^ table[6][(one >> 16) & 0xFF] ^
+            table[5][(one >> 8) & 0xFF] ^ table[4][one & 0xFF] ^
+            table[3][two >> 24] ^ table[2][(two >> 16) & 0xFF] ^
+            table[1][(two >> 8) & 0xFF] ^ table[0][two & 0xFF];
+    }
+    m_crc = crc;
+  }
+
+  while (count--)
+    m_crc = (m_crc << 8) ^ crc_tab[((m_crc >> 24) ^ *data++) & 0xFF];
 }
 
 uint32_t Crc32::Compute(const std::string& strValue)
@@ -116,6 +165,6 @@ uint32_t Crc32::ComputeFromLowerCase(const std::string& strValue)
 {
   std::string strLower = strValue;
   StringUtils::ToLower(strLower);
-  return Compute(strLower.c_str());
+  return Compute(strLower);
 }
 
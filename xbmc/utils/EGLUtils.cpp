@@ -25,8 +25,19 @@
 #include "settings/AdvancedSettings.h"
 
 #include <EGL/eglext.h>
+#include <math.h>
 #include <string.h>
 
+#define MAX_DAMAGE_HISTORY 4  // frames of damage kept for buffer age repairs
+
+#ifndef EGL_BUFFER_AGE_EXT
+#define EGL_BUFFER_AGE_EXT 0x313D
+#endif
+
+// declared here as older eglext.h headers don't carry the extension prototypes
+typedef EGLBoolean (EGLAPIENTRYP SetDamageRegionProc)(EGLDisplay dpy, EGLSurface surface, EGLint* rects, EGLint n_rects);
+typedef EGLBoolean (EGLAPIENTRYP SwapBuffersWithDamageProc)(EGLDisplay dpy, EGLSurface surface, EGLint* rects, EGLint n_rects);
+
 std::set<std::string> CEGLUtils::GetClientExtensions()
 {
   const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
@@ -82,27 +93,6 @@ bool CEGLContextUtils::CreateDisplay(EGLDisplay display,
   EGLint neglconfigs = 0;
   int major, minor;
 
-  EGLint surface_type = EGL_WINDOW_BIT;
-  // for the non-trivial dirty region modes, we need the EGL buffer to be preserved across updates
-  if (g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_COST_REDUCTION ||
-      g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_UNION)
-    surface_type |= EGL_SWAP_BEHAVIOR_PRESERVED_BIT;
-
-  EGLint attribs[] =
-  {
-    EGL_RED_SIZE,        8,
-    EGL_GREEN_SIZE,      8,
-    EGL_BLUE_SIZE,       8,
-    EGL_ALPHA_SIZE,      8,
-    EGL_DEPTH_SIZE,     16,
-    EGL_STENCIL_SIZE,    0,
-    EGL_SAMPLE_BUFFERS,  0,
-    EGL_SAMPLES,         0,
-    EGL_SURFACE_TYPE,    surface_type,
-    EGL_RENDERABLE_TYPE, renderable_type,
-    EGL_NONE
-  };
-
 #if defined(EGL_EXT_platform_base) && defined(EGL_KHR_platform_gbm) && defined(HAVE_GBM)
   if (m_eglDisplay == EGL_NO_DISPLAY &&
       CEGLUtils::HasExtension(EGL_NO_DISPLAY, "EGL_EXT_platform_base") &&
@@ -135,6 +125,29 @@ bool CEGLContextUtils::CreateDisplay(EGLDisplay display,
 
   eglBindAPI(rendering_api);
 
+  QueryPartialUpdate();
+
+  EGLint surface_type = EGL_WINDOW_BIT;
+  // for the non-trivial dirty region modes, we need the EGL buffer to be preserved across
+  // updates, unless the driver tells us how old the back buffer is
+  if (m_partialRendering && !m_bufferAge)
+    surface_type |= EGL_SWAP_BEHAVIOR_PRESERVED_BIT;
+
+  EGLint attribs[] =
+  {
+    EGL_RED_SIZE,        8,
+    EGL_GREEN_SIZE,      8,
+    EGL_BLUE_SIZE,       8,
+    EGL_ALPHA_SIZE,      8,
+    EGL_DEPTH_SIZE,     16,
+    EGL_STENCIL_SIZE,    0,
+    EGL_SAMPLE_BUFFERS,  0,
+    EGL_SAMPLES,         0,
+    EGL_SURFACE_TYPE,    surface_type,
+    EGL_RENDERABLE_TYPE, renderable_type,
+    EGL_NONE
+  };
+
   if (!eglChooseConfig(m_eglDisplay, attribs,
                        &m_eglConfig, 1, &neglconfigs))
   {
@@ -184,8 +197,7 @@ bool CEGLContextUtils::BindContext()
 bool CEGLContextUtils::SurfaceAttrib()
 {
   // for the non-trivial dirty region modes, we need the EGL buffer to be preserved across updates
-  if (g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_COST_REDUCTION ||
-      g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_UNION)
+  if (m_partialRendering && !m_bufferAge)
   {
     if ((m_eglDisplay == EGL_NO_DISPLAY) || (m_eglSurface == EGL_NO_SURFACE))
     {
@@ -270,5 +282,118 @@ void CEGLContextUtils::SwapBuffers()
     return;
   }
 
-  eglSwapBuffers(m_eglDisplay, m_eglSurface);
+  if (m_frameDamaged && m_swapWithDamage && !m_damageRects.empty())
+  {
+    reinterpret_cast<SwapBuffersWithDamageProc>(m_swapWithDamage)(m_eglDisplay, m_eglSurface,
+                                                                 m_damageRects.data(), static_cast<EGLint>(m_damageRects.size() / 4));
+  }
+  else
+    eglSwapBuffers(m_eglDisplay, m_eglSurface);
+
+  if (m_bufferAge)
+  {
+    // a frame that wasn't prepared by SetDamagedRegions() redrew everything,
+    // so nothing older than it can be used to repair the back buffer
+    if (m_frameDamaged)
+      m_damageHistory.push_front(m_frameDamage);
+    else
+      m_damageHistory.clear();
+    while (m_damageHistory.size() > MAX_DAMAGE_HISTORY)
+      m_damageHistory.pop_back();
+  }
+  m_frameDamaged = false;
+  m_frameDamage.clear();
+  m_damageRects.clear();
+}
+
+void CEGLContextUtils::QueryPartialUpdate()
+{
+  m_partialRendering = g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_COST_REDUCTION ||
+                       g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_UNION;
+  m_bufferAge = false;
+  m_setDamageRegion = nullptr;
+  m_swapWithDamage = nullptr;
+  m_damageHistory.clear();
+
+  if (!m_partialRendering)
+    return;
+
+  std::set<std::string> extensions;
+  try
+  {
+    extensions = CEGLUtils::GetExtensions(m_eglDisplay);
+  }
+  catch (std::runtime_error&)
+  {
+    return;
+  }
+
+  m_bufferAge = extensions.find("EGL_EXT_buffer_age") != extensions.end();
+  // partial update is only defined in combination with the buffer age
+  if (m_bufferAge && extensions.find("EGL_KHR_partial_update") != extensions.end())
+    m_setDamageRegion = eglGetProcAddress("eglSetDamageRegionKHR");
+  if (extensions.find("EGL_KHR_swap_buffers_with_damage") != extensions.end())
+    m_swapWithDamage = eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+  else if (extensions.find("EGL_EXT_swap_buffers_with_damage") != extensions.end())
+    m_swapWithDamage = eglGetProcAddress("eglSwapBuffersWithDamageEXT");
+
+  CLog::Log(LOGNOTICE, "EGL partial updates: buffer age %s, partial update %s, swap with damage %s",
+            m_bufferAge ? "yes" : "no", m_setDamageRegion ? "yes" : "no", m_swapWithDamage ? "yes" : "no");
+}
+
+void CEGLContextUtils::SetDamagedRegions(CDirtyRegionList& dirtyRegions)
+{
+  if (!m_partialRendering || m_eglDisplay == EGL_NO_DISPLAY || m_eglSurface == EGL_NO_SURFACE)
+    return;
+
+  EGLint width = 0, height = 0;
+  eglQuerySurface(m_eglDisplay, m_eglSurface, EGL_WIDTH, &width);
+  eglQuerySurface(m_eglDisplay, m_eglSurface, EGL_HEIGHT, &height);
+
+  m_frameDamaged = true;
+  m_frameDamage = dirtyRegions;
+
+  if (m_bufferAge)
+  {
+    // the back buffer is missing everything that changed since it was last presented
+    EGLint age = 0;
+    if (!eglQuerySurface(m_eglDisplay, m_eglSurface, EGL_BUFFER_AGE_EXT, &age))
+      age = 0;
+
+    if (age <= 0 || static_cast<size_t>(age - 1) > m_damageHistory.size())
+    {
+      // contents are undefined - redraw the lot
+      dirtyRegions.clear();
+      dirtyRegions.push_back(CDirtyRegion(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)));
+    }
+    else
+    {
+      for (int i = 0; i < age - 1; i++)
+        dirtyRegions.insert(dirtyRegions.end(), m_damageHistory[i].begin(), m_damageHistory[i].end());
+    }
+  }
+
+  // EGL wants integer rectangles with a bottom left origin
+  m_damageRects.clear();
+  for (const auto& region : dirtyRegions)
+  {
+    CRect rect = region;
+    rect.Intersect(CRect(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)));
+    if (rect.IsEmpty())
+      continue;
+    EGLint x1 = static_cast<EGLint>(floorf(rect.x1));
+    EGLint y1 = static_cast<EGLint>(floorf(rect.y1));
+    EGLint x2 = static_cast<EGLint>(ceilf(rect.x2));
+    EGLint y2 = static_cast<EGLint>(ceilf(rect.y2));
+    m_damageRects.push_back(x1);
+    m_damageRects.push_back(height - y2);
+    m_damageRects.push_back(x2 - x1);
+    m_damageRects.push_back(y2 - y1);
+  }
+
+  if (m_setDamageRegion && !m_damageRects.empty())
+  {
+    reinterpret_cast<SetDamageRegionProc>(m_setDamageRegion)(m_eglDisplay, m_eglSurface,
+                                                           m_damageRects.data(), static_cast<EGLint>(m_damageRects.size() / 4));
+  }
 }
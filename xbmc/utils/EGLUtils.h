@@ -19,13 +19,16 @@
  */
 #pragma once
 
+#include <deque>
 #include <set>
 #include <string>
 #include <stdexcept>
+#include <vector>
 
 #include <EGL/egl.h>
 
 #include "StringUtils.h"
+#include "guilib/DirtyRegion.h"
 
 class CEGLUtils
 {
@@ -139,8 +142,27 @@ public:
   bool SetVSync(bool enable);
   void SwapBuffers();
 
+  /*! \brief Prepare a frame that only redraws dirtyRegions.
+   If the driver reports the buffer age, the list is grown to also cover the
+   regions that changed since the back buffer was last presented, and the
+   damage is passed on via EGL_KHR_partial_update / swap_buffers_with_damage.
+   */
+  void SetDamagedRegions(CDirtyRegionList& dirtyRegions);
+
   EGLDisplay m_eglDisplay;
   EGLSurface m_eglSurface;
   EGLContext m_eglContext;
   EGLConfig m_eglConfig;
+
+private:
+  void QueryPartialUpdate();
+
+  bool m_partialRendering = false;                        // the gui only redraws dirty regions
+  bool m_bufferAge = false;                               // EGL_EXT_buffer_age
+  __eglMustCastToProperFunctionPointerType m_setDamageRegion = nullptr;  // eglSetDamageRegionKHR
+  __eglMustCastToProperFunctionPointerType m_swapWithDamage = nullptr;   // eglSwapBuffersWithDamage{KHR,EXT}
+  bool m_frameDamaged = false;                            // SetDamagedRegions() was called for this frame
+  CDirtyRegionList m_frameDamage;                         // regions redrawn in this frame
+  std::deque<CDirtyRegionList> m_damageHistory;           // regions redrawn in previous frames, newest first
+  std::vector<EGLint> m_damageRects;                      // m_frameDamage in EGL surface coordinates
 };
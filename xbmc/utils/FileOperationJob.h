@@ -50,6 +50,7 @@ public:
   // implementations of CJob
   bool DoWork() override;
   const char* GetType() const override { return m_displayProgress ? "filemanager" : ""; }
+  bool IsIOBound() const override { return true; }
   bool operator==(const CJob *job) const override;
 
   void SetFileOperation(FileAction action, CFileItemList &items, const std::string &strDestFile);
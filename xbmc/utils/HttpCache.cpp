@@ -0,0 +1,324 @@
+/*
+ *      Copyright (C) 2005-2015 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "HttpCache.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <inttypes.h>
+#include <vector>
+
+#include "FileItem.h"
+#include "XBDateTime.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/Digest.h"
+#include "utils/HttpHeader.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/XMLUtils.h"
+#include "utils/log.h"
+
+#define HTTPCACHE_FOLDER "httpcache"
+#define HTTPCACHE_BODY   ".body"
+#define HTTPCACHE_META   ".xml"
+
+using namespace XFILE;
+
+CHttpCache& CHttpCache::GetInstance()
+{
+  static CHttpCache sHttpCache;
+  return sHttpCache;
+}
+
+bool CHttpCache::IsEnabled()
+{
+  return g_advancedSettings.m_httpCacheSize > 0;
+}
+
+std::string CHttpCache::GetKey(const std::string &url, const std::string &referer, const std::string &acceptEncoding)
+{
+  return CDigest::Calculate(CDigest::Type::MD5, url + "\n" + referer + "\n" + acceptEncoding);
+}
+
+std::string CHttpCache::GetPath(const std::string &key, const char *extension) const
+{
+  return URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath, HTTPCACHE_FOLDER, key + extension);
+}
+
+bool CHttpCache::Lookup(const std::string &key, CEntry &entry)
+{
+  CSingleLock lock(m_section);
+  LoadIndex();
+
+  auto it = m_index.find(key);
+  if (it == m_index.end())
+    return false;
+
+  CXBMCTinyXML doc;
+  if (!doc.LoadFile(GetPath(key, HTTPCACHE_META)) || !doc.RootElement())
+  {
+    RemoveFiles(key);
+    return false;
+  }
+
+  const TiXmlElement *root = doc.RootElement();
+  long expires = 0;
+  XMLUtils::GetString(root, "mimetype", entry.mimeType);
+  XMLUtils::GetString(root, "charset", entry.charset);
+  XMLUtils::GetString(root, "etag", entry.etag);
+  XMLUtils::GetString(root, "lastmodified", entry.lastModified);
+  XMLUtils::GetLong(root, "expires", expires);
+  entry.expires = expires;
+
+  CFile file;
+  auto_buffer buffer;
+  if (file.LoadFile(GetPath(key, HTTPCACHE_BODY), buffer) < 0)
+  {
+    RemoveFiles(key);
+    return false;
+  }
+  entry.body.assign(buffer.get(), buffer.length());
+
+  it->second.lastUsed = time(nullptr);
+  return true;
+}
+
+void CHttpCache::Store(const std::string &key, const CHttpHeader &headers, const std::string &body)
+{
+  CEntry entry;
+  entry.body = body;
+  entry.mimeType = headers.GetMimeType();
+  entry.charset = headers.GetCharset();
+
+  CSingleLock lock(m_section);
+  LoadIndex();
+
+  if (!SetValidity(headers, entry))
+  {
+    RemoveFiles(key);
+    return;
+  }
+  if (!Write(key, entry, true))
+    RemoveFiles(key);
+  Trim();
+}
+
+void CHttpCache::Revalidated(const std::string &key, const CHttpHeader &headers, CEntry &entry)
+{
+  CSingleLock lock(m_section);
+  LoadIndex();
+
+  // the 304 replaces the lifetime and validators, the body stays
+  if (!SetValidity(headers, entry) || !Write(key, entry, false))
+    RemoveFiles(key);
+}
+
+void CHttpCache::Remove(const std::string &key)
+{
+  CSingleLock lock(m_section);
+  LoadIndex();
+  RemoveFiles(key);
+}
+
+int64_t CHttpCache::GetFreshness(const CHttpHeader &headers, bool &noStore)
+{
+  noStore = false;
+
+  bool noCache = false;
+  int64_t maxAge = -1;
+  std::vector<std::string> directives = StringUtils::Split(StringUtils::Join(headers.GetValues("cache-control"), ","), ",");
+  for (std::string &directive : directives)
+  {
+    StringUtils::Trim(directive);
+    StringUtils::ToLower(directive);
+    if (directive == "no-store")
+      noStore = true;
+    else if (StringUtils::StartsWith(directive, "no-cache"))
+      noCache = true;
+    else if (StringUtils::StartsWith(directive, "max-age="))
+      maxAge = strtoll(directive.c_str() + 8, nullptr, 10);
+  }
+
+  // the response differs by request headers we don't know of
+  std::string vary = headers.GetValue("vary");
+  StringUtils::Trim(vary);
+  if (vary == "*")
+    noStore = true;
+
+  if (noStore || noCache)
+    return 0;
+
+  if (maxAge >= 0)
+  {
+    // the time it spent in caches on the way counts against it
+    int64_t age = strtoll(headers.GetValue("age").c_str(), nullptr, 10);
+    return std::max<int64_t>(maxAge - std::max<int64_t>(age, 0), 0);
+  }
+
+  std::string expiresValue = headers.GetValue("expires");
+  if (!expiresValue.empty())
+  {
+    // compare with the server's clock rather than ours, an invalid date means already expired
+    CDateTime expires = CDateTime::FromRFC1123DateTime(expiresValue);
+    CDateTime date = CDateTime::FromRFC1123DateTime(headers.GetValue("date"));
+    if (!date.IsValid())
+      date = CDateTime::GetUTCDateTime();
+    if (expires.IsValid() && expires > date)
+      return (expires - date).GetSecondsTotal();
+  }
+  return 0;
+}
+
+bool CHttpCache::SetValidity(const CHttpHeader &headers, CEntry &entry)
+{
+  bool noStore;
+  int64_t freshness = GetFreshness(headers, noStore);
+  if (noStore)
+    return false;
+
+  std::string etag = headers.GetValue("etag");
+  if (!etag.empty())
+    entry.etag = etag;
+  std::string lastModified = headers.GetValue("last-modified");
+  if (!lastModified.empty())
+    entry.lastModified = lastModified;
+
+  entry.expires = freshness > 0 ? time(nullptr) + freshness : 0;
+
+  // a response that is never fresh and can't be revalidated is of no use
+  return freshness > 0 || !entry.etag.empty() || !entry.lastModified.empty();
+}
+
+bool CHttpCache::Write(const std::string &key, const CEntry &entry, bool withBody)
+{
+  uint64_t size = 0;
+  if (withBody)
+  {
+    CFile file;
+    if (!file.OpenForWrite(GetPath(key, HTTPCACHE_BODY), true) ||
+        file.Write(entry.body.data(), entry.body.size()) != static_cast<ssize_t>(entry.body.size()))
+      return false;
+  }
+  size += entry.body.size();
+
+  CXBMCTinyXML doc;
+  TiXmlElement root("httpcache");
+  XMLUtils::SetString(&root, "mimetype", entry.mimeType);
+  XMLUtils::SetString(&root, "charset", entry.charset);
+  XMLUtils::SetString(&root, "etag", entry.etag);
+  XMLUtils::SetString(&root, "lastmodified", entry.lastModified);
+  XMLUtils::SetLong(&root, "expires", static_cast<long>(entry.expires));
+  doc.InsertEndChild(root);
+
+  std::string metaPath = GetPath(key, HTTPCACHE_META);
+  if (!doc.SaveFile(metaPath))
+    return false;
+
+  struct __stat64 st;
+  if (CFile::Stat(metaPath, &st) == 0)
+    size += st.st_size;
+
+  CIndexEntry &indexEntry = m_index[key];
+  m_size -= indexEntry.size;
+  indexEntry.size = size;
+  indexEntry.lastUsed = time(nullptr);
+  m_size += size;
+  return true;
+}
+
+void CHttpCache::RemoveFiles(const std::string &key)
+{
+  CFile::Delete(GetPath(key, HTTPCACHE_META));
+  CFile::Delete(GetPath(key, HTTPCACHE_BODY));
+
+  auto it = m_index.find(key);
+  if (it != m_index.end())
+  {
+    m_size -= it->second.size;
+    m_index.erase(it);
+  }
+}
+
+void CHttpCache::LoadIndex()
+{
+  if (m_indexLoaded)
+    return;
+  m_indexLoaded = true;
+
+  std::string folder = URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath, HTTPCACHE_FOLDER);
+  if (!CDirectory::Exists(folder))
+  {
+    CDirectory::Create(folder);
+    return;
+  }
+
+  CFileItemList items;
+  CDirectory::GetDirectory(folder, items, "", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+  for (int i = 0; i < items.Size(); i++)
+  {
+    const CFileItemPtr item = items[i];
+    if (item->m_bIsFolder)
+      continue;
+
+    std::string key = URIUtils::GetFileName(item->GetPath());
+    URIUtils::RemoveExtension(key);
+
+    struct __stat64 st;
+    if (CFile::Stat(item->GetPath(), &st) != 0)
+      continue;
+
+    CIndexEntry &entry = m_index[key];
+    entry.size += st.st_size;
+    entry.lastUsed = std::max<time_t>(entry.lastUsed, st.st_mtime);
+    m_size += st.st_size;
+  }
+
+  CLog::Log(LOGDEBUG, "CHttpCache: %u responses, %" PRIu64 " bytes in %s", static_cast<unsigned int>(m_index.size()), m_size, folder.c_str());
+  Trim();
+}
+
+void CHttpCache::Trim()
+{
+  uint64_t maxSize = static_cast<uint64_t>(g_advancedSettings.m_httpCacheSize) * 1024 * 1024;
+  if (m_size <= maxSize)
+    return;
+
+  std::vector<std::pair<time_t, std::string>> byAge;
+  byAge.reserve(m_index.size());
+  for (const auto &it : m_index)
+    byAge.push_back(std::make_pair(it.second.lastUsed, it.first));
+  std::sort(byAge.begin(), byAge.end());
+
+  // drop down to 90% so that every new response doesn't evict another one
+  uint64_t targetSize = maxSize / 10 * 9;
+  unsigned int dropped = 0;
+  for (const auto &it : byAge)
+  {
+    if (m_size <= targetSize)
+      break;
+    RemoveFiles(it.second);
+    dropped++;
+  }
+  CLog::Log(LOGDEBUG, "CHttpCache: dropped %u least recently used responses", dropped);
+}
@@ -0,0 +1,120 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2015 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <time.h>
+#include <map>
+#include <string>
+
+#include "threads/CriticalSection.h"
+
+class CHttpHeader;
+
+/*!
+ \brief Disk cache of http responses, shared by the scrapers.
+
+ Responses are kept as they came from the server, keyed by the url and the request headers
+ that change the response. Cache-Control and Expires tell how long a response may be used
+ without asking the server again; once that is over the response is revalidated with
+ If-None-Match / If-Modified-Since, so that an unchanged one only costs a 304.
+ Responses with no-store, Vary: * or neither a lifetime nor a validator aren't kept.
+
+ The cache is limited in size, least recently used responses are dropped first.
+ Configured in advancedsettings.xml:
+ \code
+ <network>
+   <httpcachesize>50</httpcachesize>  <!-- MB, 0 to disable -->
+ </network>
+ \endcode
+ */
+class CHttpCache
+{
+public:
+  struct CEntry
+  {
+    std::string body;           ///< body as received, before unpacking or charset conversion
+    std::string mimeType;
+    std::string charset;
+    std::string etag;
+    std::string lastModified;
+    time_t expires = 0;         ///< until when the response is fresh, 0 to always revalidate
+
+    bool IsFresh() const { return expires > time(nullptr); }
+  };
+
+  static CHttpCache& GetInstance();
+
+  static bool IsEnabled();
+
+  /*! \brief Key of a request.
+   \param url the url, including protocol options as they may carry request headers.
+   \param referer the Referer header sent.
+   \param acceptEncoding the Accept-Encoding header sent.
+   */
+  static std::string GetKey(const std::string &url, const std::string &referer, const std::string &acceptEncoding);
+
+  /*! \brief Get a cached response.
+   \return true if there is one, check CEntry::IsFresh() before using it without revalidation.
+   */
+  bool Lookup(const std::string &key, CEntry &entry);
+
+  /*! \brief Keep a 200 response, or drop the cached one if the response mustn't be kept.
+   */
+  void Store(const std::string &key, const CHttpHeader &headers, const std::string &body);
+
+  /*! \brief Update a cached response the server answered a revalidation of with a 304.
+   \param entry the cached response, its validators and lifetime are updated from the headers.
+   */
+  void Revalidated(const std::string &key, const CHttpHeader &headers, CEntry &entry);
+
+  /*! \brief Drop a cached response.
+   */
+  void Remove(const std::string &key);
+
+  /*! \brief Lifetime of a response from its Cache-Control, Age, Expires and Date headers.
+   \param noStore set to true if the response mustn't be cached at all.
+   \return seconds the response is fresh for, 0 if it has to be revalidated on every use.
+   */
+  static int64_t GetFreshness(const CHttpHeader &headers, bool &noStore);
+
+private:
+  CHttpCache() = default;
+  CHttpCache(const CHttpCache&) = delete;
+  CHttpCache& operator=(const CHttpCache&) = delete;
+
+  bool SetValidity(const CHttpHeader &headers, CEntry &entry);
+  bool Write(const std::string &key, const CEntry &entry, bool withBody);
+  void RemoveFiles(const std::string &key);
+  void LoadIndex();
+  void Trim();
+  std::string GetPath(const std::string &key, const char *extension) const;
+
+  struct CIndexEntry
+  {
+    uint64_t size = 0;
+    time_t lastUsed = 0;
+  };
+
+  CCriticalSection m_section;
+  bool m_indexLoaded = false;
+  std::map<std::string, CIndexEntry> m_index;   ///< by key
+  uint64_t m_size = 0;                          ///< bytes used on disk
+};
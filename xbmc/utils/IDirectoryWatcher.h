@@ -0,0 +1,60 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2015 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+/*!
+ \brief Receives the changes seen by an IDirectoryWatcher.
+ Called on the watcher's own thread.
+ */
+class IDirectoryWatcherCallback
+{
+public:
+  virtual ~IDirectoryWatcherCallback() = default;
+
+  /*! \brief Something was added to, removed from or written in a folder below a watched root.
+   \param path the folder, with a trailing slash.
+   */
+  virtual void OnDirectoryChanged(const std::string &path) = 0;
+
+  /*! \brief Every folder below a root is watched from now on.
+   */
+  virtual void OnWatchStarted(const std::string &root) = 0;
+
+  /*! \brief Changes below a root may have been missed, or it is no longer watched.
+   */
+  virtual void OnWatchLost(const std::string &root) = 0;
+};
+
+/*!
+ \brief Watches local folders for changes, using whatever the platform offers.
+ */
+class IDirectoryWatcher
+{
+public:
+  virtual ~IDirectoryWatcher() = default;
+
+  /*! \brief Watch exactly these folders and everything below them.
+   \param roots local folders, with a trailing slash. None of them is below another.
+   */
+  virtual void SetRoots(const std::vector<std::string> &roots) = 0;
+};
@@ -20,6 +20,8 @@
 
 #include "JSONVariantParser.h"
 
+#include <utility>
+
 #include <rapidjson/reader.h>
 
 class CJSONVariantParserHandler
@@ -52,7 +54,7 @@ private:
     return true;
   }
 
-  void PushObject(CVariant variant);
+  void PushObject(CVariant &&variant);
   void PopObject();
 
   CVariant& m_parsedObject;
@@ -77,7 +79,7 @@ CJSONVariantParserHandler::CJSONVariantParserHandler(CVariant& parsedObject)
 
 bool CJSONVariantParserHandler::Null()
 {
-  PushObject(CVariant::ConstNullVariant);
+  PushObject(CVariant(CVariant::ConstNullVariant));
   PopObject();
 
   return true;
@@ -158,25 +160,32 @@ bool CJSONVariantParserHandler::EndArray(rapidjson::SizeType elementCount)
   return true;
 }
 
-void CJSONVariantParserHandler::PushObject(CVariant variant)
+void CJSONVariantParserHandler::PushObject(CVariant &&variant)
 {
+  // values are moved into their place in the tree rather than copied, a string or
+  // a container is never duplicated on the way
+  CVariant *value;
   if (m_status == PARSE_STATUS::Object)
   {
-    (*m_parse[m_parse.size() - 1])[m_key] = variant;
-    m_parse.push_back(&(*m_parse[m_parse.size() - 1])[m_key]);
+    value = &(*m_parse[m_parse.size() - 1])[m_key];
+    *value = std::move(variant);
   }
   else if (m_status == PARSE_STATUS::Array)
   {
     CVariant *temp = m_parse[m_parse.size() - 1];
-    temp->push_back(variant);
-    m_parse.push_back(&(*temp)[temp->size() - 1]);
+    temp->push_back(std::move(variant));
+    value = &(*temp)[temp->size() - 1];
   }
-  else if (m_parse.empty())
-    m_parse.push_back(new CVariant(variant));
+  else
+  {
+    m_parsedObject = std::move(variant);
+    value = &m_parsedObject;
+  }
+  m_parse.push_back(value);
 
-  if (variant.isObject())
+  if (value->isObject())
     m_status = PARSE_STATUS::Object;
-  else if (variant.isArray())
+  else if (value->isArray())
     m_status = PARSE_STATUS::Array;
   else
     m_status = PARSE_STATUS::Variable;
@@ -184,12 +193,11 @@ void CJSONVariantParserHandler::PushObject(CVariant variant)
 
 void CJSONVariantParserHandler::PopObject()
 {
-  CVariant *variant = m_parse[m_parse.size() - 1];
   m_parse.pop_back();
 
   if (!m_parse.empty())
   {
-    variant = m_parse[m_parse.size() - 1];
+    CVariant *variant = m_parse[m_parse.size() - 1];
     if (variant->isObject())
       m_status = PARSE_STATUS::Object;
     else if (variant->isArray())
@@ -198,12 +206,7 @@ void CJSONVariantParserHandler::PopObject()
       m_status = PARSE_STATUS::Variable;
   }
   else
-  {
-    m_parsedObject = *variant;
-    delete variant;
-
     m_status = PARSE_STATUS::Variable;
-  }
 }
 
 bool CJSONVariantParser::Parse(const char* json, CVariant& data)
@@ -214,11 +217,13 @@ bool CJSONVariantParser::Parse(const char* json, CVariant& data)
   rapidjson::Reader reader;
   rapidjson::StringStream stringStream(json);
 
-  CJSONVariantParserHandler handler(data);
-  if (reader.Parse(stringStream, handler))
-    return true;
+  CVariant parsed;
+  CJSONVariantParserHandler handler(parsed);
+  if (!reader.Parse(stringStream, handler))
+    return false;
 
-  return false;
+  data = std::move(parsed);
+  return true;
 }
 
 bool CJSONVariantParser::Parse(const std::string& json, CVariant& data)
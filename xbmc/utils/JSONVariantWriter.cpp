@@ -20,12 +20,66 @@
 
 #include "JSONVariantWriter.h"
 
+#include <utility>
+
 #include <rapidjson/prettywriter.h>
-#include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
 #include "utils/Variant.h"
 
+#define JSON_OUTPUT_CHUNK_SIZE 16384
+
+// rapidjson output stream appending straight to the result, there is no buffer to copy from at the end
+class CStringOutputStream
+{
+public:
+  typedef char Ch;
+
+  explicit CStringOutputStream(std::string &output) : m_output(output) { }
+
+  void Put(Ch c) { m_output.push_back(c); }
+  void Flush() { }
+
+private:
+  std::string &m_output;
+};
+
+// rapidjson output stream handing the output on whenever a chunk is full
+class CChunkedOutputStream
+{
+public:
+  typedef char Ch;
+
+  explicit CChunkedOutputStream(const CJSONVariantWriter::OutputFunction &output)
+    : m_output(output)
+  {
+    m_buffer.reserve(JSON_OUTPUT_CHUNK_SIZE);
+  }
+
+  void Put(Ch c)
+  {
+    if (!m_ok)
+      return;
+    m_buffer.push_back(c);
+    if (m_buffer.size() >= JSON_OUTPUT_CHUNK_SIZE)
+      Flush();
+  }
+
+  void Flush()
+  {
+    if (!m_buffer.empty() && m_ok)
+      m_ok = m_output(m_buffer.c_str(), m_buffer.size());
+    m_buffer.clear();
+  }
+
+  bool IsOk() const { return m_ok; }
+
+private:
+  const CJSONVariantWriter::OutputFunction &m_output;
+  std::string m_buffer;
+  bool m_ok = true;
+};
+
 template<class TWriter>
 bool InternalWrite(TWriter& writer, const CVariant &value)
 {
@@ -80,25 +134,37 @@ bool InternalWrite(TWriter& writer, const CVariant &value)
   return false;
 }
 
-bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool compact)
+template<class TStream>
+bool WriteToStream(TStream& stream, const CVariant &value, bool compact)
 {
-  rapidjson::StringBuffer stringBuffer;
   if (compact)
   {
-    rapidjson::Writer<rapidjson::StringBuffer> writer(stringBuffer);
-
-    if (!InternalWrite(writer, value) || !writer.IsComplete())
-      return false;
+    rapidjson::Writer<TStream> writer(stream);
+    return InternalWrite(writer, value) && writer.IsComplete();
   }
-  else
-  {
-    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(stringBuffer);
-    writer.SetIndent('\t', 1);
 
-    if (!InternalWrite(writer, value) || !writer.IsComplete())
-      return false;
-  }
+  rapidjson::PrettyWriter<TStream> writer(stream);
+  writer.SetIndent('\t', 1);
+  return InternalWrite(writer, value) && writer.IsComplete();
+}
+
+bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool compact)
+{
+  std::string json;
+  CStringOutputStream stream(json);
+  if (!WriteToStream(stream, value, compact))
+    return false;
 
-  output = stringBuffer.GetString();
+  output = std::move(json);
   return true;
 }
+
+bool CJSONVariantWriter::Write(const CVariant &value, const OutputFunction &output, bool compact)
+{
+  CChunkedOutputStream stream(output);
+  if (!WriteToStream(stream, value, compact))
+    return false;
+
+  stream.Flush();
+  return stream.IsOk();
+}
@@ -19,6 +19,7 @@
  *
  */
 
+#include <functional>
 #include <string>
 
 class CVariant;
@@ -28,5 +29,15 @@ class CJSONVariantWriter
 public:
   CJSONVariantWriter() = delete;
 
+  /*! \brief Function the JSON is handed to piece by piece, returns false to abort the writing.
+   */
+  typedef std::function<bool(const char *data, size_t size)> OutputFunction;
+
   static bool Write(const CVariant &value, std::string& output, bool compact);
+
+  /*! \brief Serialise a value without building the JSON in memory first.
+   The output gets the JSON in pieces of a few kB while the value is serialised, so that a transport
+   can send a large response as it is produced.
+   */
+  static bool Write(const CVariant &value, const OutputFunction &output, bool compact);
 };
@@ -26,6 +26,7 @@ class CJob;
 #define kJobTypeMediaFlags  "mediaflags"
 #define kJobTypeCacheImage  "cacheimage"
 #define kJobTypeDDSCompress "ddscompress"
+#define kJobTypePrecacheArt "precacheart"
 
 /*!
  \ingroup jobs
@@ -147,6 +148,18 @@ public:
    */
   virtual const char *GetType() const { return ""; };
 
+  /*!
+   \brief Function that returns whether the job spends most of its time waiting for I/O.
+
+   CJob subclasses that mostly wait on the network or on file transfers may implement this function.
+   The CJobManager counts them apart from CPU-bound jobs when deciding whether a job of a priority
+   may start, so slow transfers don't hold back decoding jobs of the same priority and vice versa.
+
+   \return true if the job is I/O-bound, false if it is CPU-bound (the default).
+   \sa CJobManager
+   */
+  virtual bool IsIOBound() const { return false; };
+
   virtual bool operator==(const CJob* job) const
   {
     return false;
@@ -22,12 +22,18 @@
 #include <algorithm>
 #include <functional>
 #include <stdexcept>
+#include <thread>
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "utils/Metrics.h"
+#include "utils/Trace.h"
 #ifdef TARGET_POSIX
 #include "platform/linux/XTimeUtils.h"
 #endif
 
+#define JOB_WORKER_IDLE_TIMEOUT 30000  // ms an idle worker above the kept ones waits before it exits
+#define JOB_SLOW_START_TIME     2000   // ms a job may wait for a worker before this is logged
+
 bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
 {
   if (m_callback)
@@ -64,6 +70,7 @@ void CJobWorker::Process()
     bool success = false;
     try
     {
+      CTraceScope trace("job", "CJob::DoWork", job->GetType());
       success = job->DoWork();
     }
     catch (...)
@@ -182,6 +189,22 @@ CJobManager::CJobManager()
   m_jobCounter = 0;
   m_running = true;
   m_pauseJobs = false;
+  m_idleWorkers = std::max(std::min(std::thread::hardware_concurrency(), GetMaxWorkers(CJob::PRIORITY_HIGH)), 1u);
+
+  CMetrics::GetInstance().RegisterGauge("kodi_jobs_queued", "Jobs waiting for a worker", [this]()
+  {
+    unsigned int queued = 0;
+    for (const auto &lane : GetStatistics())
+      queued += lane.queued;
+    return static_cast<double>(queued);
+  });
+  CMetrics::GetInstance().RegisterGauge("kodi_jobs_processing", "Jobs being processed", [this]()
+  {
+    unsigned int processing = 0;
+    for (const auto &lane : GetStatistics())
+      processing += lane.processing;
+    return static_cast<double>(processing);
+  });
 }
 
 void CJobManager::Restart()
@@ -191,6 +214,8 @@ void CJobManager::Restart()
   if (m_running)
     throw std::logic_error("CJobManager already running");
   m_running = true;
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+    m_waitTimes[priority] = WaitTimes();
 }
 
 void CJobManager::CancelJobs()
@@ -205,6 +230,11 @@ void CJobManager::CancelJobs()
     m_jobQueue[priority].clear();
   }
 
+  // and jobs waiting for others
+  for_each(m_waiting.begin(), m_waiting.end(), [](CWorkItem& wi) { wi.FreeJob(); });
+  m_waiting.clear();
+  m_dependents.clear();
+
   // cancel any callbacks on jobs still processing
   for_each(m_processing.begin(), m_processing.end(), [](CWorkItem& wi) { wi.Cancel(); });
 
@@ -218,9 +248,18 @@ void CJobManager::CancelJobs()
   }
 }
 
-CJobManager::~CJobManager() = default;
+CJobManager::~CJobManager()
+{
+  CMetrics::GetInstance().UnregisterGauge("kodi_jobs_queued");
+  CMetrics::GetInstance().UnregisterGauge("kodi_jobs_processing");
+}
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
+{
+  return AddJob(job, callback, priority, std::vector<unsigned int>());
+}
+
+unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority, const std::vector<unsigned int> &dependencies)
 {
   CSingleLock lock(m_section);
 
@@ -234,39 +273,137 @@ unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORI
 
   // create a work item for this job
   CWorkItem work(job, m_jobCounter, priority, callback);
-  m_jobQueue[priority].push_back(work);
+  CTrace::FlowBegin("job", work.m_id);
 
-  StartWorkers(priority);
+  // wait for the dependencies that haven't completed yet
+  for (std::vector<unsigned int>::const_iterator it = dependencies.begin(); it != dependencies.end(); ++it)
+  {
+    if (IsPending(*it))
+    {
+      m_dependents.insert(std::make_pair(*it, work.m_id));
+      work.m_dependencies++;
+    }
+  }
+
+  if (work.m_dependencies)
+    m_waiting.push_back(work);
+  else
+    QueueJob(work);
   return work.m_id;
 }
 
+void CJobManager::QueueJob(const CWorkItem &work)
+{
+  m_jobQueue[work.m_priority].push_back(work);
+  StartWorkers(work.m_priority, work.m_ioBound);
+}
+
+bool CJobManager::IsPending(unsigned int jobID) const
+{
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  {
+    if (find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID) != m_jobQueue[priority].end())
+      return true;
+  }
+  return find(m_processing.begin(), m_processing.end(), jobID) != m_processing.end() ||
+         find(m_waiting.begin(), m_waiting.end(), jobID) != m_waiting.end();
+}
+
+void CJobManager::ResolveDependents(unsigned int jobID, bool success, WorkItems &failed)
+{
+  std::vector<unsigned int> failedIDs;
+  std::pair<std::multimap<unsigned int, unsigned int>::iterator, std::multimap<unsigned int, unsigned int>::iterator> range = m_dependents.equal_range(jobID);
+  for (std::multimap<unsigned int, unsigned int>::iterator it = range.first; it != range.second; ++it)
+  {
+    WorkItems::iterator i = find(m_waiting.begin(), m_waiting.end(), it->second);
+    if (i == m_waiting.end())
+      continue; // failed already through another dependency
+
+    if (!success)
+    {
+      failed.push_back(*i);
+      failedIDs.push_back(i->m_id);
+      m_waiting.erase(i);
+    }
+    else if (--i->m_dependencies == 0)
+    {
+      CWorkItem work(*i);
+      m_waiting.erase(i);
+      work.m_queued = XbmcThreads::SystemClockMillis();
+      QueueJob(work);
+    }
+  }
+  m_dependents.erase(range.first, range.second);
+
+  for (std::vector<unsigned int>::const_iterator it = failedIDs.begin(); it != failedIDs.end(); ++it)
+    ResolveDependents(*it, false, failed);
+}
+
+void CJobManager::FailJobs(WorkItems &failed)
+{
+  for (WorkItems::iterator it = failed.begin(); it != failed.end(); ++it)
+  {
+    try
+    {
+      if (it->m_callback)
+        it->m_callback->OnJobComplete(it->m_id, false, it->m_job);
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, it->m_job->GetType());
+    }
+    it->FreeJob();
+  }
+}
+
 void CJobManager::CancelJob(unsigned int jobID)
 {
   CSingleLock lock(m_section);
+  WorkItems failed;
 
   // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  bool found = false;
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED && !found; ++priority)
   {
     JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
     if (i != m_jobQueue[priority].end())
     {
       delete i->m_job;
       m_jobQueue[priority].erase(i);
-      return;
+      found = true;
+    }
+  }
+  // or waiting for other jobs
+  if (!found)
+  {
+    WorkItems::iterator i = find(m_waiting.begin(), m_waiting.end(), jobID);
+    if (i != m_waiting.end())
+    {
+      delete i->m_job;
+      m_waiting.erase(i);
+      found = true;
     }
   }
+  if (found)
+  {
+    // the jobs waiting for this one won't run either
+    ResolveDependents(jobID, false, failed);
+    lock.Leave();
+    FailJobs(failed);
+    return;
+  }
   // or if we're processing it
   Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
   if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+    it->Cancel(); // job is in progress, so only thing to do is to remove callback
 }
 
-void CJobManager::StartWorkers(CJob::PRIORITY priority)
+void CJobManager::StartWorkers(CJob::PRIORITY priority, bool ioBound)
 {
   CSingleLock lock(m_section);
 
   // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
+  if (GetProcessing(ioBound) >= GetMaxWorkers(priority))
     return;
 
   // do we have any sleeping threads?
@@ -289,17 +426,40 @@ CJob *CJobManager::PopJob()
     if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
       continue;
 
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
-    {
-      // pop the job off the queue
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
-
-      // add to the processing vector
-      m_processing.push_back(job);
-      job.m_job->m_callback = this;
-      return job.m_job;
-    }
+    // take the oldest job of the lane that may start. I/O-bound and CPU-bound
+    // jobs are limited separately, so only look for the other kind if one is full
+    unsigned int maxWorkers = GetMaxWorkers(CJob::PRIORITY(priority));
+    bool cpuFull = GetProcessing(false) >= maxWorkers;
+    bool ioFull = GetProcessing(true) >= maxWorkers;
+    if (cpuFull && ioFull)
+      continue;
+
+    JobQueue::iterator i = m_jobQueue[priority].begin();
+    while (i != m_jobQueue[priority].end() && (i->m_ioBound ? ioFull : cpuFull))
+      ++i;
+    if (i == m_jobQueue[priority].end())
+      continue;
+
+    // pop the job off the queue
+    CWorkItem job = *i;
+    m_jobQueue[priority].erase(i);
+
+    unsigned int wait = XbmcThreads::SystemClockMillis() - job.m_queued;
+    WaitTimes &waitTimes = m_waitTimes[priority];
+    waitTimes.started++;
+    waitTimes.total += wait;
+    waitTimes.max = std::max(waitTimes.max, wait);
+    if (wait >= JOB_SLOW_START_TIME)
+      CLog::Log(LOGDEBUG, "CJobManager: job %s of priority %d waited %u ms for a worker, %u more queued",
+                job.m_job->GetType(), priority, wait, static_cast<unsigned int>(m_jobQueue[priority].size()));
+
+    // the arrow from AddJob() ends at the next span of this worker, the job
+    CTrace::FlowEnd("job", job.m_id);
+
+    // add to the processing vector
+    m_processing.push_back(job);
+    job.m_job->m_callback = this;
+    return job.m_job;
   }
   return NULL;
 }
@@ -331,6 +491,32 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
   return false;
 }
 
+std::vector<CJobManager::LaneStatistics> CJobManager::GetStatistics() const
+{
+  CSingleLock lock(m_section);
+
+  std::vector<LaneStatistics> statistics(CJob::PRIORITY_DEDICATED + 1);
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  {
+    LaneStatistics &lane = statistics[priority];
+    lane.queued = m_jobQueue[priority].size();
+    lane.waiting = count_if(m_waiting.begin(), m_waiting.end(), [priority](const CWorkItem& wi) { return wi.m_priority == priority; });
+    lane.started = m_waitTimes[priority].started;
+    if (lane.started)
+      lane.averageWait = static_cast<unsigned int>(m_waitTimes[priority].total / lane.started);
+    lane.maxWait = m_waitTimes[priority].max;
+  }
+  for (Processing::const_iterator it = m_processing.begin(); it != m_processing.end(); ++it)
+    statistics[it->m_priority].processing++;
+  return statistics;
+}
+
+size_t CJobManager::GetWorkerCount() const
+{
+  CSingleLock lock(m_section);
+  return m_workers.size();
+}
+
 int CJobManager::IsProcessing(const std::string &type) const
 {
   int jobsMatched = 0;
@@ -356,11 +542,12 @@ CJob *CJobManager::GetNextJob(const CJobWorker *worker)
     CJob *job = PopJob();
     if (job)
       return job;
-    // no jobs are left - sleep for 30 seconds to allow new jobs to come in
+    // no jobs are left - sleep for a while to allow new jobs to come in.
+    // Workers up to m_idleWorkers stay around, the others exit when nothing came
     lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
+    bool newJob = m_jobEvent.WaitMSec(JOB_WORKER_IDLE_TIMEOUT);
     lock.Enter();
-    if (!newJob)
+    if (!newJob && m_workers.size() > m_idleWorkers)
       break;
   }
   // ensure no jobs have come in during the period after
@@ -413,9 +600,17 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
     lock.Enter();
     Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
     if (j != m_processing.end())
+    {
+      // the job may have been cancelled while its callback was running
+      success = success && !j->m_cancelled;
       m_processing.erase(j);
+    }
+    // queue the jobs that were waiting for this one
+    WorkItems failed;
+    ResolveDependents(item.m_id, success && !item.m_cancelled, failed);
     lock.Leave();
     item.FreeJob();
+    FailJobs(failed);
   }
 }
 
@@ -428,6 +623,17 @@ void CJobManager::RemoveWorker(const CJobWorker *worker)
     m_workers.erase(i); // workers auto-delete
 }
 
+unsigned int CJobManager::GetProcessing(bool ioBound) const
+{
+  unsigned int processing = 0;
+  for (Processing::const_iterator it = m_processing.begin(); it != m_processing.end(); ++it)
+  {
+    if (it->m_ioBound == ioBound)
+      processing++;
+  }
+  return processing;
+}
+
 unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
 {
   static const unsigned int max_workers = 5;
@@ -19,10 +19,12 @@
  *
  */
 
+#include <map>
 #include <queue>
 #include <vector>
 #include <string>
 #include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
 #include "threads/Thread.h"
 #include "Job.h"
 
@@ -197,6 +199,15 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Each priority has its own queue (lane).  I/O-bound jobs (see CJob::IsIOBound()) are
+ limited separately from CPU-bound ones.  As many workers as there are cores (up to
+ the limit of PRIORITY_HIGH) are kept alive when idle, so bursts of jobs don't create
+ and destroy threads; workers beyond that exit after being idle for a while.
+
+ A job may depend on other jobs (see AddJob() with dependencies and AddContinuation()).
+ It is queued once all of them completed successfully, directly from the worker that
+ finished the last one, so stages of a pipeline run on workers one after the other.
+
  \sa CJob and IJobCallback
  */
 class CJobManager
@@ -210,6 +221,10 @@ class CJobManager
       m_id = id;
       m_callback = callback;
       m_priority = priority;
+      m_ioBound = job->IsIOBound();
+      m_queued = XbmcThreads::SystemClockMillis();
+      m_dependencies = 0;
+      m_cancelled = false;
     }
     bool operator==(unsigned int jobID) const
     {
@@ -227,14 +242,33 @@ class CJobManager
     void Cancel()
     {
       m_callback = NULL;
+      m_cancelled = true;
     };
     CJob         *m_job;
     unsigned int  m_id;
     IJobCallback *m_callback;
     CJob::PRIORITY m_priority;
+    bool          m_ioBound;
+    unsigned int  m_queued;   ///< time the job was added, in ms
+    unsigned int  m_dependencies; ///< jobs that have to complete before this one is queued
+    bool          m_cancelled;
   };
 
 public:
+  /*!
+   \brief Queue depth and latency of the jobs of one priority, for debugging.
+   \sa GetStatistics()
+   */
+  struct LaneStatistics
+  {
+    unsigned int queued = 0;       ///< jobs waiting for a worker
+    unsigned int waiting = 0;      ///< jobs waiting for other jobs to complete
+    unsigned int processing = 0;   ///< jobs being processed
+    unsigned int started = 0;      ///< jobs started since the last Restart()
+    unsigned int averageWait = 0;  ///< average time (ms) the started jobs waited for a worker
+    unsigned int maxWait = 0;      ///< longest time (ms) a started job waited for a worker
+  };
+
   /*!
    \brief The only way through which the global instance of the CJobManager should be accessed.
    \return the global instance.
@@ -251,6 +285,32 @@ public:
    */
   unsigned int AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority = CJob::PRIORITY_LOW);
 
+  /*!
+   \brief Add a job that is only queued once the given jobs have completed.
+
+   The job is queued after every job in dependencies has completed successfully and their
+   OnJobComplete() callbacks returned. If one of them fails or is cancelled the job is not
+   run; its callback receives OnJobComplete() with success false and the job is destroyed,
+   as are the jobs depending on it. Ids of jobs that are no longer queued or processing are
+   taken as completed.
+   \param job a pointer to the job to add. The job should be subclassed from CJob
+   \param callback a pointer to an IJobCallback instance to receive job progress and completion notices.
+   \param priority the priority that this job should run at.
+   \param dependencies ids of the jobs to wait for, as retrieved from AddJob()
+   \return a unique identifier for this job, to be used with other interaction
+   \sa AddContinuation(), CancelJob()
+   */
+  unsigned int AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority, const std::vector<unsigned int> &dependencies);
+
+  /*!
+   \brief Add a job that is queued once the job with the given id has completed successfully.
+   \sa AddJob()
+   */
+  unsigned int AddContinuation(unsigned int jobID, CJob *job, IJobCallback *callback, CJob::PRIORITY priority = CJob::PRIORITY_LOW)
+  {
+    return AddJob(job, callback, priority, std::vector<unsigned int>(1, jobID));
+  }
+
   /*!
    \brief Add a function f to this job manager for asynchronously execution.
    */
@@ -269,6 +329,17 @@ public:
     AddJob(new CLambdaJob<F>(std::forward<F>(f)), callback, priority);
   }
 
+  /*!
+   \brief Add a function f to this job manager for execution once the given jobs have completed.
+   \return a unique identifier for the job running f
+   \sa AddJob()
+   */
+  template<typename F>
+  unsigned int SubmitAfter(const std::vector<unsigned int> &dependencies, F&& f, CJob::PRIORITY priority = CJob::PRIORITY_LOW)
+  {
+    return AddJob(new CLambdaJob<F>(std::forward<F>(f)), nullptr, priority, dependencies);
+  }
+
   /*!
    \brief Cancel a job with the given id.
    \param jobID the id of the job to cancel, retrieved previously from AddJob()
@@ -319,6 +390,18 @@ public:
    */
   bool IsProcessing(const CJob::PRIORITY &priority) const;
 
+  /*!
+   \brief Retrieve the queue depth and latency of each priority.
+   \return the statistics, indexed by CJob::PRIORITY
+   \sa LaneStatistics
+   */
+  std::vector<LaneStatistics> GetStatistics() const;
+
+  /*!
+   \brief Number of worker threads, busy or idle.
+   */
+  size_t GetWorkerCount() const;
+
 protected:
   friend class CJobWorker;
   friend class CJob;
@@ -363,9 +446,27 @@ private:
    */
   CJob *PopJob();
 
-  void StartWorkers(CJob::PRIORITY priority);
+  void StartWorkers(CJob::PRIORITY priority, bool ioBound);
   void RemoveWorker(const CJobWorker *worker);
   static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
+  unsigned int GetProcessing(bool ioBound) const;
+  bool IsPending(unsigned int jobID) const;
+  void QueueJob(const CWorkItem &work);
+
+  typedef std::vector<CWorkItem> WorkItems;
+
+  /*! \brief Called with the lock held after a job completed or was cancelled. Queues the jobs
+   that were waiting for it only, or moves them to failed (along with their dependents).
+   */
+  void ResolveDependents(unsigned int jobID, bool success, WorkItems &failed);
+  static void FailJobs(WorkItems &failed);
+
+  struct WaitTimes
+  {
+    unsigned int started = 0;
+    uint64_t total = 0;
+    unsigned int max = 0;
+  };
 
   unsigned int m_jobCounter;
 
@@ -377,6 +478,10 @@ private:
   bool       m_pauseJobs;
   Processing m_processing;
   Workers    m_workers;
+  WorkItems  m_waiting;        ///< jobs with dependencies that have not completed yet
+  std::multimap<unsigned int, unsigned int> m_dependents;  ///< job id -> ids of the jobs waiting for it
+  size_t     m_idleWorkers;    ///< workers that are kept alive when there is nothing to do
+  WaitTimes  m_waitTimes[CJob::PRIORITY_DEDICATED + 1];
 
   CCriticalSection m_section;
   CEvent           m_jobEvent;
@@ -0,0 +1,292 @@
+/*
+ *      Copyright (C) 2005-2015 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LibraryChangeJournal.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "MediaSource.h"
+#include "profiles/ProfilesManager.h"
+#include "settings/MediaSourceSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/XMLUtils.h"
+
+#if defined(TARGET_LINUX)
+#include "platform/linux/InotifyWatcher.h"
+#endif
+
+#define MAX_JOURNAL_ENTRIES 10000 // beyond this the sources are simply walked again
+
+static IDirectoryWatcher* CreateWatcher(IDirectoryWatcherCallback &callback)
+{
+#if defined(TARGET_LINUX)
+  return new CInotifyWatcher(callback);
+#else
+  return nullptr;
+#endif
+}
+
+CLibraryChangeJournal& CLibraryChangeJournal::GetInstance()
+{
+  static CLibraryChangeJournal sJournal;
+  return sJournal;
+}
+
+void CLibraryChangeJournal::Start()
+{
+  Stop();
+
+  IDirectoryWatcher *watcher = CreateWatcher(*this);
+  {
+    CSingleLock lock(m_section);
+    m_file = CProfilesManager::GetInstance().GetUserDataItem("librarychanges.xml");
+    Load();
+    m_watcher.reset(watcher);
+    m_started = true;
+  }
+
+  if (watcher)
+    UpdateSources();
+  else
+    CLog::Log(LOGDEBUG, "%s - folders can't be watched on this platform, library updates walk all sources", __FUNCTION__);
+}
+
+void CLibraryChangeJournal::Stop()
+{
+  std::unique_ptr<IDirectoryWatcher> watcher;
+  {
+    CSingleLock lock(m_section);
+    if (!m_started)
+      return;
+    watcher = std::move(m_watcher);
+  }
+
+  // the watcher calls us from its thread, so it has to be stopped without holding the lock
+  watcher.reset();
+
+  CSingleLock lock(m_section);
+  Save();
+  m_roots.clear();
+  m_changes.clear();
+  m_started = false;
+}
+
+void CLibraryChangeJournal::UpdateSources()
+{
+  std::vector<std::string> paths;
+  for (const char *type : { "video", "music" })
+  {
+    VECSOURCES *sources = CMediaSourceSettings::GetInstance().GetSources(type);
+    if (!sources)
+      continue;
+    for (const auto &source : *sources)
+    {
+      for (std::string path : source.vecPaths)
+      {
+        // only plain local paths, as in the library, can be watched
+        if (!URIUtils::IsHD(path) || URIUtils::IsSpecial(path) || URIUtils::IsStack(path) ||
+            URIUtils::IsProtocol(path, "file"))
+          continue;
+        URIUtils::AddSlashAtEnd(path);
+        paths.push_back(path);
+      }
+    }
+  }
+
+  // a source below another one is covered by the watch of the outer one
+  std::vector<std::string> roots;
+  for (const auto &path : paths)
+  {
+    bool nested = false;
+    for (const auto &other : paths)
+    {
+      if (other != path && URIUtils::PathHasParent(path, other))
+      {
+        nested = true;
+        break;
+      }
+    }
+    if (!nested && std::find(roots.begin(), roots.end(), path) == roots.end())
+      roots.push_back(path);
+  }
+
+  CSingleLock lock(m_section);
+  if (!m_watcher)
+    return;
+
+  for (auto it = m_roots.begin(); it != m_roots.end();)
+  {
+    if (std::find(roots.begin(), roots.end(), it->first) == roots.end())
+      it = m_roots.erase(it);
+    else
+      ++it;
+  }
+  for (const auto &root : roots)
+    m_roots.insert(std::make_pair(root, Root()));
+
+  m_watcher->SetRoots(roots);
+}
+
+uint64_t CLibraryChangeJournal::GetPosition() const
+{
+  CSingleLock lock(m_section);
+  return m_position;
+}
+
+bool CLibraryChangeJournal::IsComplete(const std::string &path) const
+{
+  CSingleLock lock(m_section);
+  for (const auto &root : m_roots)
+  {
+    if (root.second.complete && URIUtils::PathHasParent(path, root.first))
+      return true;
+  }
+  return false;
+}
+
+bool CLibraryChangeJournal::HasChanges(const std::string &path) const
+{
+  CSingleLock lock(m_section);
+  // the changes are sorted by path, so those below the folder follow it
+  auto it = m_changes.lower_bound(path);
+  return it != m_changes.end() && URIUtils::PathHasParent(it->first, path);
+}
+
+bool CLibraryChangeJournal::IsUnchanged(const std::string &path) const
+{
+  return IsComplete(path) && !HasChanges(path);
+}
+
+void CLibraryChangeJournal::MarkScanned(const std::string &path, uint64_t position)
+{
+  CSingleLock lock(m_section);
+  if (!m_started)
+    return;
+
+  for (auto &root : m_roots)
+  {
+    if ((path.empty() || URIUtils::PathHasParent(root.first, path)) &&
+        root.second.watched && root.second.watchedSince <= position && !root.second.complete)
+    {
+      CLog::Log(LOGDEBUG, "%s - %s was walked while watched, further updates only scan its changes", __FUNCTION__, root.first.c_str());
+      root.second.complete = true;
+    }
+  }
+
+  auto it = path.empty() ? m_changes.begin() : m_changes.lower_bound(path);
+  while (it != m_changes.end() && (path.empty() || URIUtils::PathHasParent(it->first, path)))
+  {
+    if (it->second <= position)
+    {
+      it = m_changes.erase(it);
+      m_dirty = true;
+    }
+    else
+      ++it;
+  }
+
+  Save();
+}
+
+void CLibraryChangeJournal::OnDirectoryChanged(const std::string &path)
+{
+  CSingleLock lock(m_section);
+  if (m_changes.size() >= MAX_JOURNAL_ENTRIES && m_changes.find(path) == m_changes.end())
+  {
+    // too much going on, fall back to walking everything
+    for (auto &root : m_roots)
+      root.second.complete = false;
+    return;
+  }
+  m_changes[path] = ++m_position;
+  m_dirty = true;
+}
+
+void CLibraryChangeJournal::OnWatchStarted(const std::string &root)
+{
+  CSingleLock lock(m_section);
+  auto it = m_roots.find(root);
+  if (it == m_roots.end())
+    return;
+
+  // a scan running already may have walked parts of it before the watch was there
+  it->second.watched = true;
+  it->second.watchedSince = ++m_position;
+}
+
+void CLibraryChangeJournal::OnWatchLost(const std::string &root)
+{
+  CSingleLock lock(m_section);
+  auto it = m_roots.find(root);
+  if (it == m_roots.end())
+    return;
+
+  CLog::Log(LOGDEBUG, "%s - changes below %s may have been missed, it will be walked again", __FUNCTION__, root.c_str());
+  it->second.watched = false;
+  it->second.complete = false;
+  ++m_position;
+}
+
+void CLibraryChangeJournal::Load()
+{
+  m_changes.clear();
+  m_position = 0;
+  m_dirty = false;
+
+  CXBMCTinyXML doc;
+  if (!doc.LoadFile(m_file))
+    return;
+
+  TiXmlElement *root = doc.RootElement();
+  if (!root || root->ValueStr() != "librarychanges")
+    return;
+
+  for (const TiXmlElement *path = root->FirstChildElement("path"); path; path = path->NextSiblingElement("path"))
+  {
+    if (path->FirstChild())
+      m_changes[path->FirstChild()->ValueStr()] = m_position;
+  }
+  CLog::Log(LOGDEBUG, "%s - %u changed folders left from the last session", __FUNCTION__, static_cast<unsigned int>(m_changes.size()));
+}
+
+void CLibraryChangeJournal::Save()
+{
+  if (!m_dirty || m_file.empty())
+    return;
+
+  CXBMCTinyXML doc;
+  TiXmlElement root("librarychanges");
+  TiXmlNode *rootNode = doc.InsertEndChild(root);
+  if (!rootNode)
+    return;
+
+  for (const auto &change : m_changes)
+    XMLUtils::SetString(rootNode, "path", change.first);
+
+  if (doc.SaveFile(m_file))
+    m_dirty = false;
+  else
+    CLog::Log(LOGERROR, "%s - unable to save %s", __FUNCTION__, m_file.c_str());
+}
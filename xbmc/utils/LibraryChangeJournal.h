@@ -0,0 +1,108 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2015 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "IDirectoryWatcher.h"
+#include "threads/CriticalSection.h"
+
+/*!
+ \brief Journal of the folders of local media sources that changed since the last library scan.
+
+ The local video and music sources are watched for changes. Once a source has been walked
+ completely by a scan while being watched, the journal knows every folder below it that
+ changed since, and library updates only need to look at those. Sources that can't be
+ watched, network sources and sources that lost their watch are walked as before.
+
+ Changes made while Kodi isn't running can't be seen, so each source is walked once after
+ every start before the journal is relied on.
+ */
+class CLibraryChangeJournal : public IDirectoryWatcherCallback
+{
+public:
+  static CLibraryChangeJournal& GetInstance();
+
+  /*! \brief Load the journal of the current profile and start watching the local sources.
+   */
+  void Start();
+
+  /*! \brief Stop watching and save the journal.
+   */
+  void Stop();
+
+  /*! \brief Pick up sources that were added or removed.
+   */
+  void UpdateSources();
+
+  /*! \brief Current position in the journal, to pass to MarkScanned() once the scan started now is done.
+   */
+  uint64_t GetPosition() const;
+
+  /*! \brief Whether the journal lists every change below a folder, i.e. its source has been
+   watched without interruption since it was last walked.
+   */
+  bool IsComplete(const std::string &path) const;
+
+  /*! \brief Whether a folder or anything below it changed since it was last scanned.
+   */
+  bool HasChanges(const std::string &path) const;
+
+  /*! \brief Whether a scan of a folder can be skipped: the journal is complete and has no changes for it.
+   */
+  bool IsUnchanged(const std::string &path) const;
+
+  /*! \brief A scan that walked a folder finished.
+   \param path the folder that was scanned, empty if all sources were.
+   \param position position in the journal when the scan started.
+   */
+  void MarkScanned(const std::string &path, uint64_t position);
+
+  void OnDirectoryChanged(const std::string &path) override;
+  void OnWatchStarted(const std::string &root) override;
+  void OnWatchLost(const std::string &root) override;
+
+private:
+  CLibraryChangeJournal() = default;
+  CLibraryChangeJournal(const CLibraryChangeJournal&) = delete;
+  CLibraryChangeJournal& operator=(const CLibraryChangeJournal&) = delete;
+
+  struct Root
+  {
+    bool watched = false;         ///< whether every folder below it is watched
+    uint64_t watchedSince = 0;    ///< position at which the watch started
+    bool complete = false;        ///< whether it was walked by a scan since the watch started
+  };
+
+  void Load();
+  void Save();
+
+  mutable CCriticalSection m_section;
+  std::unique_ptr<IDirectoryWatcher> m_watcher;
+  std::map<std::string, Root> m_roots;
+  std::map<std::string, uint64_t> m_changes;   ///< changed folders and the position they changed at
+  uint64_t m_position = 0;
+  bool m_started = false;
+  bool m_dirty = false;
+  std::string m_file;
+};
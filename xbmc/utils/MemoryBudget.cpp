@@ -0,0 +1,133 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MemoryBudget.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+
+#if defined(TARGET_LINUX) && !defined(TARGET_ANDROID)
+#include "platform/linux/MemoryPressureMonitor.h"
+#endif
+
+#include <algorithm>
+
+CMemoryBudget& CMemoryBudget::GetInstance()
+{
+  static CMemoryBudget sMemoryBudget;
+  return sMemoryBudget;
+}
+
+CMemoryBudget::~CMemoryBudget()
+{
+  Stop();
+}
+
+void CMemoryBudget::Start()
+{
+  CSingleLock lock(m_section);
+  if (m_monitor)
+    return;
+
+#if defined(TARGET_LINUX) && !defined(TARGET_ANDROID)
+  m_monitor.reset(new CMemoryPressureMonitor);
+  m_monitor->Create();
+#endif
+}
+
+void CMemoryBudget::Stop()
+{
+  std::unique_ptr<CThread> monitor;
+  {
+    CSingleLock lock(m_section);
+    monitor = std::move(m_monitor);
+  }
+
+  // the monitor may be telling us about pressure right now, so don't hold the lock
+  if (monitor)
+    monitor->StopThread();
+}
+
+void CMemoryBudget::Register(IMemoryConsumer *consumer, const std::string &name, int priority)
+{
+  CSingleLock lock(m_section);
+
+  auto it = std::upper_bound(m_consumers.begin(), m_consumers.end(), priority,
+    [](int priority, const CConsumer &consumer) { return priority < consumer.priority; });
+  m_consumers.insert(it, CConsumer{ consumer, name, priority });
+}
+
+void CMemoryBudget::Unregister(IMemoryConsumer *consumer)
+{
+  CSingleLock lock(m_section);
+
+  m_consumers.erase(std::remove_if(m_consumers.begin(), m_consumers.end(),
+    [consumer](const CConsumer &c) { return c.consumer == consumer; }), m_consumers.end());
+}
+
+size_t CMemoryBudget::OnMemoryPressure(MemoryPressure level)
+{
+  // held while the caches shrink, so none of them is destroyed meanwhile
+  CSingleLock lock(m_section);
+
+  size_t total = 0;
+  for (const CConsumer &consumer : m_consumers)
+    total += consumer.consumer->GetMemoryBudgetUsage();
+
+  CLog::Log(LOGNOTICE, "CMemoryBudget: %s memory pressure, caches use %zu kB",
+            level == MemoryPressure::CRITICAL ? "critical" : "moderate", total / 1024);
+
+  size_t released = 0;
+  for (const CConsumer &consumer : m_consumers)
+  {
+    if (level == MemoryPressure::MODERATE && released >= total / 2)
+      break;
+
+    const size_t before = consumer.consumer->GetMemoryBudgetUsage();
+    consumer.consumer->OnMemoryPressure(level);
+    const size_t after = consumer.consumer->GetMemoryBudgetUsage();
+
+    if (after < before)
+    {
+      released += before - after;
+      CLog::Log(LOGDEBUG, "CMemoryBudget: %s gave back %zu kB", consumer.name.c_str(), (before - after) / 1024);
+    }
+  }
+
+  return released;
+}
+
+std::vector<CMemoryBudget::CConsumerStatus> CMemoryBudget::GetStatus() const
+{
+  CSingleLock lock(m_section);
+
+  std::vector<CConsumerStatus> status;
+  status.reserve(m_consumers.size());
+  for (const CConsumer &consumer : m_consumers)
+  {
+    CConsumerStatus entry;
+    entry.name = consumer.name;
+    entry.priority = consumer.priority;
+    entry.usage = consumer.consumer->GetMemoryBudgetUsage();
+    status.push_back(entry);
+  }
+
+  return status;
+}
@@ -0,0 +1,115 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stddef.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+
+class CThread;
+
+enum class MemoryPressure
+{
+  MODERATE, ///< the system starts to run short, give back what is cheap to get again
+  CRITICAL  ///< the system is about to kill processes, give back everything possible
+};
+
+/*!
+ \brief A cache that can give memory back when the system runs short of it.
+ */
+class IMemoryConsumer
+{
+public:
+  virtual ~IMemoryConsumer() = default;
+
+  /*! \brief Estimated memory the cache uses, in bytes.
+   */
+  virtual size_t GetMemoryBudgetUsage() const = 0;
+
+  /*! \brief Give memory back. Called from the thread that noticed the pressure, a cache
+   that can only be shrunk on a certain thread may do it there a bit later.
+   */
+  virtual void OnMemoryPressure(MemoryPressure level) = 0;
+};
+
+/*!
+ \brief Asks the registered caches to shrink when the system runs short of memory.
+
+ Each cache sets its own limit for normal operation, this only steps in under
+ pressure reported by the OS: the pressure stall information of Linux, or the
+ low memory callback of Android. The caches are asked in order of their
+ priority, lowest first. On moderate pressure this stops once half of the
+ memory all caches use is given back, on critical pressure every cache is
+ asked.
+ */
+class CMemoryBudget
+{
+public:
+  struct CConsumerStatus
+  {
+    std::string name;
+    int priority = 0;
+    size_t usage = 0; ///< bytes
+  };
+
+  static CMemoryBudget& GetInstance();
+
+  /*! \brief Start watching the memory pressure reported by the OS, if the platform can.
+   */
+  void Start();
+  void Stop();
+
+  /*! \brief Register a cache, it has to be unregistered before it is destroyed.
+   \param name shown in the status, e.g. "Textures".
+   \param priority caches with lower ones are asked to shrink first, so they should be
+                   the ones that are cheap to fill again.
+   */
+  void Register(IMemoryConsumer *consumer, const std::string &name, int priority);
+  void Unregister(IMemoryConsumer *consumer);
+
+  /*! \brief Let the caches give memory back, called by the platform code.
+   \return bytes given back, as far as the caches could tell right away.
+   */
+  size_t OnMemoryPressure(MemoryPressure level);
+
+  /*! \brief Usage of the registered caches, in the order they are asked to shrink.
+   */
+  std::vector<CConsumerStatus> GetStatus() const;
+
+private:
+  CMemoryBudget() = default;
+  ~CMemoryBudget();
+  CMemoryBudget(const CMemoryBudget&) = delete;
+  CMemoryBudget& operator=(const CMemoryBudget&) = delete;
+
+  struct CConsumer
+  {
+    IMemoryConsumer *consumer;
+    std::string name;
+    int priority;
+  };
+
+  mutable CCriticalSection m_section;
+  std::vector<CConsumer> m_consumers; ///< by priority
+  std::unique_ptr<CThread> m_monitor;
+};
@@ -0,0 +1,363 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Metrics.h"
+
+#include <inttypes.h>
+#include <algorithm>
+
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+// milliseconds of values the quantiles are estimated from, at least one and at most two of them
+#define RECENT_WINDOW 5000
+
+namespace
+{
+std::string FormatValue(double value)
+{
+  return StringUtils::Format("%.9g", value);
+}
+}
+
+CMetricHistogram::CMetricHistogram(const std::vector<double> &bounds)
+  : m_bounds(bounds),
+    m_windowStart(XbmcThreads::SystemClockMillis())
+{
+  m_total.counts.resize(m_bounds.size() + 1);
+  m_current.counts.resize(m_bounds.size() + 1);
+  m_previous.counts.resize(m_bounds.size() + 1);
+}
+
+void CMetricHistogram::Observe(double value)
+{
+  const size_t bucket = std::lower_bound(m_bounds.begin(), m_bounds.end(), value) - m_bounds.begin();
+
+  CSingleLock lock(m_section);
+  Rotate(XbmcThreads::SystemClockMillis());
+
+  for (CWindow *window : { &m_total, &m_current })
+  {
+    window->counts[bucket]++;
+    window->count++;
+    window->sum += value;
+  }
+}
+
+CMetricHistogram::CSnapshot CMetricHistogram::GetSnapshot() const
+{
+  CSnapshot snapshot;
+  snapshot.bounds = m_bounds;
+
+  CSingleLock lock(m_section);
+  snapshot.counts = m_total.counts;
+  snapshot.count = m_total.count;
+  snapshot.sum = m_total.sum;
+  return snapshot;
+}
+
+double CMetricHistogram::GetQuantile(double quantile) const
+{
+  CSingleLock lock(m_section);
+  Rotate(XbmcThreads::SystemClockMillis());
+
+  const uint64_t count = m_current.count + m_previous.count;
+  if (count == 0)
+    return 0.0;
+
+  const double rank = std::min(std::max(quantile, 0.0), 1.0) * count;
+  uint64_t below = 0;
+  for (size_t i = 0; i < m_bounds.size(); i++)
+  {
+    const uint64_t inBucket = m_current.counts[i] + m_previous.counts[i];
+    if (below + inBucket >= rank && inBucket > 0)
+    {
+      // assume the values are spread evenly over the bucket
+      const double lower = i > 0 ? m_bounds[i - 1] : 0.0;
+      return lower + (m_bounds[i] - lower) * (rank - below) / inBucket;
+    }
+    below += inBucket;
+  }
+
+  // above all bounds, nothing better to tell than the largest one
+  return m_bounds.empty() ? 0.0 : m_bounds.back();
+}
+
+double CMetricHistogram::GetAverage() const
+{
+  CSingleLock lock(m_section);
+  Rotate(XbmcThreads::SystemClockMillis());
+
+  const uint64_t count = m_current.count + m_previous.count;
+  if (count == 0)
+    return 0.0;
+  return (m_current.sum + m_previous.sum) / count;
+}
+
+void CMetricHistogram::Rotate(unsigned int now) const
+{
+  const unsigned int elapsed = now - m_windowStart;
+  if (elapsed < RECENT_WINDOW)
+    return;
+
+  if (elapsed < 2 * RECENT_WINDOW)
+    std::swap(m_previous, m_current);
+
+  m_current.counts.assign(m_bounds.size() + 1, 0);
+  m_current.count = 0;
+  m_current.sum = 0.0;
+  if (elapsed >= 2 * RECENT_WINDOW)
+    m_previous = m_current;
+
+  m_windowStart = now;
+}
+
+CMetrics& CMetrics::GetInstance()
+{
+  static CMetrics metrics;
+  return metrics;
+}
+
+CMetricCounter& CMetrics::GetCounter(const std::string &name, const std::string &help)
+{
+  CSingleLock lock(m_section);
+  CMetric *metric = Get(name, Type::COUNTER, help);
+  if (!metric)
+    return m_invalidCounter;
+
+  if (!metric->counter)
+    metric->counter.reset(new CMetricCounter);
+  return *metric->counter;
+}
+
+CMetricGauge& CMetrics::GetGauge(const std::string &name, const std::string &help)
+{
+  CSingleLock lock(m_section);
+  CMetric *metric = Get(name, Type::GAUGE, help);
+  if (!metric || metric->callback)
+  {
+    if (metric)
+      CLog::Log(LOGERROR, "CMetrics::%s - gauge %s is read through a callback", __FUNCTION__, name.c_str());
+    return m_invalidGauge;
+  }
+
+  if (!metric->gauge)
+    metric->gauge.reset(new CMetricGauge);
+  return *metric->gauge;
+}
+
+CMetricHistogram& CMetrics::GetHistogram(const std::string &name, const std::string &help,
+                                         const std::vector<double> &bounds)
+{
+  CSingleLock lock(m_section);
+  CMetric *metric = Get(name, Type::HISTOGRAM, help);
+  if (!metric)
+  {
+    if (!m_invalidHistogram)
+      m_invalidHistogram.reset(new CMetricHistogram(std::vector<double>()));
+    return *m_invalidHistogram;
+  }
+
+  if (!metric->histogram)
+    metric->histogram.reset(new CMetricHistogram(bounds));
+  return *metric->histogram;
+}
+
+void CMetrics::RegisterGauge(const std::string &name, const std::string &help, const std::function<double()> &callback)
+{
+  CSingleLock lock(m_section);
+  CMetric *metric = Get(name, Type::GAUGE, help);
+  if (!metric)
+    return;
+
+  if (metric->gauge)
+  {
+    CLog::Log(LOGERROR, "CMetrics::%s - gauge %s is set directly", __FUNCTION__, name.c_str());
+    return;
+  }
+  metric->callback = callback;
+}
+
+void CMetrics::UnregisterGauge(const std::string &name)
+{
+  CSingleLock lock(m_section);
+  auto it = m_metrics.find(name);
+  if (it != m_metrics.end() && it->second.callback)
+    m_metrics.erase(it);
+}
+
+CMetrics::CMetric* CMetrics::Get(const std::string &name, Type type, const std::string &help)
+{
+  auto it = m_metrics.find(name);
+  if (it == m_metrics.end())
+  {
+    CMetric &metric = m_metrics[name];
+    metric.type = type;
+    metric.help = help;
+    return &metric;
+  }
+
+  if (it->second.type != type)
+  {
+    CLog::Log(LOGERROR, "CMetrics::%s - %s is already registered with another type", __FUNCTION__, name.c_str());
+    return nullptr;
+  }
+  return &it->second;
+}
+
+const char* CMetrics::GetTypeName(Type type)
+{
+  switch (type)
+  {
+    case Type::COUNTER:
+      return "counter";
+    case Type::HISTOGRAM:
+      return "histogram";
+    default:
+      return "gauge";
+  }
+}
+
+double CMetrics::GetGaugeValue(const CMetric &metric)
+{
+  if (metric.callback)
+    return metric.callback();
+  return metric.gauge ? metric.gauge->GetValue() : 0.0;
+}
+
+bool CMetrics::GetValue(const std::string &name, double &value) const
+{
+  CSingleLock lock(m_section);
+
+  auto it = m_metrics.find(name);
+  if (it != m_metrics.end())
+  {
+    if (it->second.type == Type::COUNTER)
+      value = it->second.counter ? static_cast<double>(it->second.counter->GetValue()) : 0.0;
+    else if (it->second.type == Type::GAUGE)
+      value = GetGaugeValue(it->second);
+    else
+      return false;
+    return true;
+  }
+
+  const size_t dot = name.rfind('.');
+  if (dot == std::string::npos)
+    return false;
+
+  it = m_metrics.find(name.substr(0, dot));
+  if (it == m_metrics.end() || it->second.type != Type::HISTOGRAM || !it->second.histogram)
+    return false;
+
+  const std::string statistic = name.substr(dot + 1);
+  const CMetricHistogram &histogram = *it->second.histogram;
+  if (statistic == "avg")
+    value = histogram.GetAverage();
+  else if (statistic == "p50")
+    value = histogram.GetQuantile(0.5);
+  else if (statistic == "p95")
+    value = histogram.GetQuantile(0.95);
+  else if (statistic == "p99")
+    value = histogram.GetQuantile(0.99);
+  else
+    return false;
+  return true;
+}
+
+void CMetrics::GetMetrics(CVariant &result) const
+{
+  result = CVariant(CVariant::VariantTypeArray);
+
+  CSingleLock lock(m_section);
+  for (const auto &it : m_metrics)
+  {
+    const CMetric &metric = it.second;
+
+    CVariant entry(CVariant::VariantTypeObject);
+    entry["name"] = it.first;
+    entry["type"] = GetTypeName(metric.type);
+    entry["help"] = metric.help;
+
+    if (metric.type == Type::COUNTER)
+      entry["value"] = metric.counter ? metric.counter->GetValue() : 0;
+    else if (metric.type == Type::GAUGE)
+      entry["value"] = GetGaugeValue(metric);
+    else if (metric.histogram)
+    {
+      const CMetricHistogram::CSnapshot snapshot = metric.histogram->GetSnapshot();
+      entry["count"] = snapshot.count;
+      entry["sum"] = snapshot.sum;
+      entry["buckets"] = CVariant(CVariant::VariantTypeArray);
+      uint64_t cumulative = 0;
+      for (size_t i = 0; i < snapshot.bounds.size(); i++)
+      {
+        cumulative += snapshot.counts[i];
+        CVariant bucket(CVariant::VariantTypeObject);
+        bucket["le"] = snapshot.bounds[i];
+        bucket["count"] = cumulative;
+        entry["buckets"].push_back(bucket);
+      }
+      entry["recent"]["avg"] = metric.histogram->GetAverage();
+      entry["recent"]["p50"] = metric.histogram->GetQuantile(0.5);
+      entry["recent"]["p95"] = metric.histogram->GetQuantile(0.95);
+      entry["recent"]["p99"] = metric.histogram->GetQuantile(0.99);
+    }
+
+    result.push_back(entry);
+  }
+}
+
+std::string CMetrics::GetPrometheusText() const
+{
+  std::string text;
+
+  CSingleLock lock(m_section);
+  for (const auto &it : m_metrics)
+  {
+    const std::string &name = it.first;
+    const CMetric &metric = it.second;
+
+    text += "# HELP " + name + " " + metric.help + "\n";
+    text += "# TYPE " + name + " " + GetTypeName(metric.type) + "\n";
+
+    if (metric.type == Type::COUNTER)
+      text += StringUtils::Format("%s %" PRIu64 "\n", name.c_str(), metric.counter ? metric.counter->GetValue() : 0);
+    else if (metric.type == Type::GAUGE)
+      text += name + " " + FormatValue(GetGaugeValue(metric)) + "\n";
+    else if (metric.histogram)
+    {
+      const CMetricHistogram::CSnapshot snapshot = metric.histogram->GetSnapshot();
+      uint64_t cumulative = 0;
+      for (size_t i = 0; i < snapshot.bounds.size(); i++)
+      {
+        cumulative += snapshot.counts[i];
+        // the braces of the labels would be taken for fmt placeholders by StringUtils::Format
+        text += name + "_bucket{le=\"" + FormatValue(snapshot.bounds[i]) + "\"} " + std::to_string(cumulative) + "\n";
+      }
+      text += name + "_bucket{le=\"+Inf\"} " + std::to_string(snapshot.count) + "\n";
+      text += name + "_sum " + FormatValue(snapshot.sum) + "\n";
+      text += StringUtils::Format("%s_count %" PRIu64 "\n", name.c_str(), snapshot.count);
+    }
+  }
+  return text;
+}
@@ -0,0 +1,203 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+
+class CVariant;
+
+/*!
+ \brief A value that only goes up, e.g. the number of dropped frames.
+ */
+class CMetricCounter
+{
+public:
+  void Increment(uint64_t value = 1) { m_value += value; }
+  uint64_t GetValue() const { return m_value; }
+
+private:
+  std::atomic<uint64_t> m_value{0};
+};
+
+/*!
+ \brief A value that goes up and down, e.g. the fill level of a cache.
+ */
+class CMetricGauge
+{
+public:
+  void Set(double value) { m_value = value; }
+  double GetValue() const { return m_value; }
+
+private:
+  std::atomic<double> m_value{0.0};
+};
+
+/*!
+ \brief Counts values into buckets, e.g. frame times.
+
+ The buckets count every value since the start, like a Prometheus histogram,
+ which is what a monitoring server wants. For a display on the device the
+ quantiles are estimated from the values of the last few seconds only.
+ */
+class CMetricHistogram
+{
+public:
+  /*!
+   \param bounds upper bounds of the buckets, ascending. Larger values land in
+                 an extra bucket.
+   */
+  explicit CMetricHistogram(const std::vector<double> &bounds);
+
+  void Observe(double value);
+
+  struct CSnapshot
+  {
+    std::vector<double> bounds;
+    std::vector<uint64_t> counts; ///< per bucket, the last one for values above all bounds
+    uint64_t count = 0;
+    double sum = 0.0;
+  };
+
+  CSnapshot GetSnapshot() const;
+
+  /*!
+   \brief Estimate the value below which the given share of the recent values are.
+   \param quantile between 0 and 1, e.g. 0.95
+   \return 0 if there were no recent values.
+   */
+  double GetQuantile(double quantile) const;
+
+  /*!
+   \brief The average of the recent values, 0 if there were none.
+   */
+  double GetAverage() const;
+
+private:
+  struct CWindow
+  {
+    std::vector<uint64_t> counts;
+    uint64_t count = 0;
+    double sum = 0.0;
+  };
+
+  void Rotate(unsigned int now) const;
+
+  const std::vector<double> m_bounds;
+
+  mutable CCriticalSection m_section;
+  CWindow m_total;
+  mutable CWindow m_current; ///< recent values, they move to m_previous when the window ends
+  mutable CWindow m_previous;
+  mutable unsigned int m_windowStart;
+};
+
+/*!
+ \brief Registry of the counters, gauges and histograms published by the subsystems.
+
+ A subsystem asks for its metric once and keeps the reference, the metrics are
+ never removed. Values a subsystem keeps anyway can be published as gauges that
+ are read through a callback instead, those have to be unregistered before the
+ subsystem goes away.
+
+ Names follow the Prometheus conventions, e.g. kodi_video_dropped_frames_total.
+ They are read by the debug overlay, the System.Metric(name) info label, the
+ JSON-RPC method XBMC.GetMetrics and the /metrics page of the web server.
+ */
+class CMetrics
+{
+public:
+  static CMetrics& GetInstance();
+
+  CMetricCounter& GetCounter(const std::string &name, const std::string &help);
+  CMetricGauge& GetGauge(const std::string &name, const std::string &help);
+  CMetricHistogram& GetHistogram(const std::string &name, const std::string &help,
+                                 const std::vector<double> &bounds);
+
+  /*!
+   \brief Publish a gauge that is read by calling the callback.
+   \param callback called on the thread reading the metrics, with the registry locked,
+                   so it must not publish metrics itself.
+   */
+  void RegisterGauge(const std::string &name, const std::string &help, const std::function<double()> &callback);
+  void UnregisterGauge(const std::string &name);
+
+  /*!
+   \brief Get the value of a metric for display.
+   \param name the name of a counter or gauge, or of a histogram followed by
+               .avg, .p50, .p95 or .p99 for the recent values.
+   \return false if there is no such metric.
+   */
+  bool GetValue(const std::string &name, double &value) const;
+
+  /*!
+   \brief Get all metrics as an array of objects with name, type, help and the values.
+   */
+  void GetMetrics(CVariant &result) const;
+
+  /*!
+   \brief Get all metrics in the text format of Prometheus.
+   */
+  std::string GetPrometheusText() const;
+
+private:
+  CMetrics() = default;
+  CMetrics(const CMetrics&) = delete;
+  CMetrics& operator=(const CMetrics&) = delete;
+
+  enum class Type
+  {
+    COUNTER,
+    GAUGE,
+    HISTOGRAM
+  };
+
+  struct CMetric
+  {
+    Type type;
+    std::string help;
+    std::unique_ptr<CMetricCounter> counter;
+    std::unique_ptr<CMetricGauge> gauge;
+    std::unique_ptr<CMetricHistogram> histogram;
+    std::function<double()> callback;
+  };
+
+  /*!
+   \brief Find or add the metric, nullptr if it exists with another type.
+   */
+  CMetric* Get(const std::string &name, Type type, const std::string &help);
+  static const char* GetTypeName(Type type);
+  static double GetGaugeValue(const CMetric &metric);
+
+  mutable CCriticalSection m_section;
+  std::map<std::string, CMetric> m_metrics; ///< by name, sorted for the output
+
+  // handed out for names that are taken by a metric of another type
+  CMetricCounter m_invalidCounter;
+  CMetricGauge m_invalidGauge;
+  std::unique_ptr<CMetricHistogram> m_invalidHistogram;
+};
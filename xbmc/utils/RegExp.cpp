@@ -21,8 +21,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <algorithm> 
+#include <list>
+#include <map>
 #include "RegExp.h"
 #include "log.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/StringUtils.h"
 #include "utils/Utf8Utils.h"
 
@@ -47,6 +51,99 @@ using namespace PCRE;
 #define pcre_free_study(x) pcre_free((x))
 #endif
 
+// pcre_jit_exec() takes the JIT stack per call, so compiled patterns can be shared
+#if defined(PCRE_HAS_JIT_CODE) && (PCRE_MAJOR > 8 || (PCRE_MAJOR == 8 && PCRE_MINOR >= 32))
+#define PCRE_HAS_JIT_EXEC 1
+#endif
+
+#define REGEXP_CACHE_SIZE 256 // compiled patterns kept for reuse
+
+struct CRegExp::CCompiledPattern
+{
+  pcre* re = NULL;
+  pcre_extra* sd = NULL;
+  bool jitCompiled = false;
+
+  CCompiledPattern() = default;
+  CCompiledPattern(const CCompiledPattern&) = delete;
+  CCompiledPattern& operator=(const CCompiledPattern&) = delete;
+
+  ~CCompiledPattern()
+  {
+    if (sd)
+      pcre_free_study(sd);
+    if (re)
+      pcre_free(re);
+  }
+};
+
+namespace
+{
+struct CPatternKey
+{
+  std::string pattern;
+  int options;
+  int study;
+
+  bool operator<(const CPatternKey& right) const
+  {
+    if (options != right.options)
+      return options < right.options;
+    if (study != right.study)
+      return study < right.study;
+    return pattern < right.pattern;
+  }
+};
+
+/* Compiled patterns are only read while matching, so any number of CRegExp objects
+   on any thread can use the same one. Least recently used first. Templated, as
+   CRegExp::CCompiledPattern is private. */
+template<class PATTERN>
+class CPatternCache
+{
+public:
+  std::shared_ptr<const PATTERN> Get(const CPatternKey& key)
+  {
+    CSingleLock lock(m_section);
+    typename Index::iterator it = m_index.find(key);
+    if (it == m_index.end())
+      return std::shared_ptr<const PATTERN>();
+    m_patterns.splice(m_patterns.end(), m_patterns, it->second);
+    return it->second->second;
+  }
+
+  void Add(const CPatternKey& key, const std::shared_ptr<const PATTERN>& pattern)
+  {
+    CSingleLock lock(m_section);
+    if (m_index.find(key) != m_index.end())
+      return;
+    if (m_patterns.size() >= REGEXP_CACHE_SIZE)
+    {
+      m_index.erase(m_patterns.front().first);
+      m_patterns.pop_front();
+    }
+    m_patterns.push_back(std::make_pair(key, pattern));
+    m_index.insert(std::make_pair(key, std::prev(m_patterns.end())));
+  }
+
+private:
+  typedef std::list<std::pair<CPatternKey, std::shared_ptr<const PATTERN>>> Patterns;
+  typedef std::map<CPatternKey, typename Patterns::iterator> Index;
+
+  CCriticalSection m_section;
+  Patterns m_patterns;
+  Index m_index;
+};
+}
+
+// constructed on first use, as CRegExp may be used during static initialisation
+template<class PATTERN>
+static CPatternCache<PATTERN>& GetPatternCache()
+{
+  static CPatternCache<PATTERN> cache;
+  return cache;
+}
+
 int CRegExp::m_Utf8Supported = -1;
 int CRegExp::m_UcpSupported  = -1;
 int CRegExp::m_JitSupported  = -1;
@@ -82,7 +179,7 @@ void CRegExp::InitValues(bool caseless /*= false*/, CRegExp::utf8Mode utf8 /*= a
   memset(m_iOvector, 0, sizeof(m_iOvector));
 }
 
-CRegExp::CRegExp(bool caseless, CRegExp::utf8Mode utf8, const char *re, studyMode study /*= NoStudy*/)
+CRegExp::CRegExp(bool caseless, CRegExp::utf8Mode utf8, const char *re, studyMode study /*= StudyWithJitComp*/)
 {
   if (utf8 == autoUtf8)
     utf8 = requireUtf8(re) ? forceUtf8 : asciiOnly;
@@ -244,27 +341,25 @@ CRegExp::CRegExp(const CRegExp& re)
 
 CRegExp& CRegExp::operator=(const CRegExp& re)
 {
-  size_t size;
+  if (this == &re)
+    return *this;
+
   Cleanup();
   m_jitCompiled = false;
   m_pattern = re.m_pattern;
-  if (re.m_re)
+  if (re.m_compiled)
   {
-    if (pcre_fullinfo(re.m_re, NULL, PCRE_INFO_SIZE, &size) >= 0)
-    {
-      if ((m_re = (pcre*)malloc(size)))
-      {
-        memcpy(m_re, re.m_re, size);
-        memcpy(m_iOvector, re.m_iOvector, OVECCOUNT*sizeof(int));
-        m_offset = re.m_offset;
-        m_iMatchCount = re.m_iMatchCount;
-        m_bMatched = re.m_bMatched;
-        m_subject = re.m_subject;
-        m_iOptions = re.m_iOptions;
-      }
-      else
-        CLog::Log(LOGSEVERE, "%s: Failed to allocate memory", __FUNCTION__);
-    }
+    // the compiled pattern is never modified, share it
+    m_compiled = re.m_compiled;
+    m_re = m_compiled->re;
+    m_sd = m_compiled->sd;
+    m_jitCompiled = m_compiled->jitCompiled;
+    memcpy(m_iOvector, re.m_iOvector, OVECCOUNT*sizeof(int));
+    m_offset = re.m_offset;
+    m_iMatchCount = re.m_iMatchCount;
+    m_bMatched = re.m_bMatched;
+    m_subject = re.m_subject;
+    m_iOptions = re.m_iOptions;
   }
   return *this;
 }
@@ -274,7 +369,7 @@ CRegExp::~CRegExp()
   Cleanup();
 }
 
-bool CRegExp::RegComp(const char *re, studyMode study /*= NoStudy*/)
+bool CRegExp::RegComp(const char *re, studyMode study /*= StudyWithJitComp*/)
 {
   if (!re)
     return false;
@@ -291,39 +386,54 @@ bool CRegExp::RegComp(const char *re, studyMode study /*= NoStudy*/)
 
   Cleanup();
 
-  m_re = pcre_compile(re, options, &errMsg, &errOffset, NULL);
-  if (!m_re)
-  {
-    m_pattern.clear();
-    CLog::Log(LOGERROR, "PCRE: %s. Compilation failed at offset %d in expression '%s'",
-              errMsg, errOffset, re);
-    return false;
-  }
+  if (study == StudyWithJitComp && !IsJitSupported())
+    study = StudyRegExp;
 
-  m_pattern = re;
-
-  if (study)
+  const CPatternKey key = { re, options, study };
+  m_compiled = GetPatternCache<CCompiledPattern>().Get(key);
+  if (!m_compiled)
   {
-    const bool jitCompile = (study == StudyWithJitComp) && IsJitSupported();
-    const int studyOptions = jitCompile ? PCRE_STUDY_JIT_COMPILE : 0;
+    std::shared_ptr<CCompiledPattern> compiled = std::make_shared<CCompiledPattern>();
+    compiled->re = pcre_compile(re, options, &errMsg, &errOffset, NULL);
+    if (!compiled->re)
+    {
+      m_pattern.clear();
+      CLog::Log(LOGERROR, "PCRE: %s. Compilation failed at offset %d in expression '%s'",
+                errMsg, errOffset, re);
+      return false;
+    }
 
-    m_sd = pcre_study(m_re, studyOptions, &errMsg);
-    if (errMsg != NULL)
+    if (study)
     {
-      CLog::Log(LOGWARNING, "%s: PCRE error \"%s\" while studying expression", __FUNCTION__, errMsg);
-      if (m_sd != NULL)
+      const bool jitCompile = (study == StudyWithJitComp);
+      const int studyOptions = jitCompile ? PCRE_STUDY_JIT_COMPILE : 0;
+
+      compiled->sd = pcre_study(compiled->re, studyOptions, &errMsg);
+      if (errMsg != NULL)
       {
-        pcre_free_study(m_sd);
-        m_sd = NULL;
+        CLog::Log(LOGWARNING, "%s: PCRE error \"%s\" while studying expression", __FUNCTION__, errMsg);
+        if (compiled->sd != NULL)
+        {
+          pcre_free_study(compiled->sd);
+          compiled->sd = NULL;
+        }
+      }
+      else if (jitCompile)
+      {
+        int jitPresent = 0;
+        compiled->jitCompiled = (pcre_fullinfo(compiled->re, compiled->sd, PCRE_INFO_JIT, &jitPresent) == 0 && jitPresent == 1);
       }
     }
-    else if (jitCompile)
-    {
-      int jitPresent = 0;
-      m_jitCompiled = (pcre_fullinfo(m_re, m_sd, PCRE_INFO_JIT, &jitPresent) == 0 && jitPresent == 1);
-    }
+
+    GetPatternCache<CCompiledPattern>().Add(key, compiled);
+    m_compiled = compiled;
   }
 
+  m_re = m_compiled->re;
+  m_sd = m_compiled->sd;
+  m_jitCompiled = m_compiled->jitCompiled;
+  m_pattern = re;
+
   return true;
 }
 
@@ -356,14 +466,12 @@ int CRegExp::PrivateRegFind(size_t bufferLen, const char *str, unsigned int star
     return -1;
   }
 
-#ifdef PCRE_HAS_JIT_CODE
+#ifdef PCRE_HAS_JIT_EXEC
   if (m_jitCompiled && !m_jitStack)
   {
     m_jitStack = pcre_jit_stack_alloc(32*1024, 512*1024);
     if (m_jitStack == NULL)
       CLog::Log(LOGWARNING, "%s: can't allocate address space for JIT stack", __FUNCTION__);
-
-    pcre_assign_jit_stack(m_sd, NULL, m_jitStack);
   }
 #endif
 
@@ -371,7 +479,23 @@ int CRegExp::PrivateRegFind(size_t bufferLen, const char *str, unsigned int star
     bufferLen = std::min<size_t>(bufferLen, startoffset + maxNumberOfCharsToTest);
 
   m_subject.assign(str + startoffset, bufferLen - startoffset);
-  int rc = pcre_exec(m_re, NULL, m_subject.c_str(), m_subject.length(), 0, 0, m_iOvector, OVECCOUNT);
+  int rc;
+#ifdef PCRE_HAS_JIT_EXEC
+  if (m_jitCompiled && m_jitStack)
+    rc = pcre_jit_exec(m_re, m_sd, m_subject.c_str(), m_subject.length(), 0, 0, m_iOvector, OVECCOUNT, m_jitStack);
+  else
+#endif
+    rc = pcre_exec(m_re, m_sd, m_subject.c_str(), m_subject.length(), 0, 0, m_iOvector, OVECCOUNT);
+
+#ifdef PCRE_HAS_JIT_CODE
+  if (rc == PCRE_ERROR_JIT_STACKLIMIT && m_sd)
+  {
+    // the shared study data has no JIT stack of its own, retry with the interpreter
+    pcre_extra extra = *m_sd;
+    extra.flags &= ~PCRE_EXTRA_EXECUTABLE_JIT;
+    rc = pcre_exec(m_re, &extra, m_subject.c_str(), m_subject.length(), 0, 0, m_iOvector, OVECCOUNT);
+  }
+#endif
 
   if (rc<1)
   {
@@ -557,17 +681,10 @@ void CRegExp::DumpOvector(int iLog /* = LOGDEBUG */)
 
 void CRegExp::Cleanup()
 {
-  if (m_re)
-  {
-    pcre_free(m_re); 
-    m_re = NULL; 
-  }
-
-  if (m_sd)
-  {
-    pcre_free_study(m_sd);
-    m_sd = NULL;
-  }
+  m_compiled.reset();
+  m_re = NULL;
+  m_sd = NULL;
+  m_jitCompiled = false;
 
 #ifdef PCRE_HAS_JIT_CODE
   if (m_jitStack)
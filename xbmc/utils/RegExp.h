@@ -24,6 +24,7 @@
 
 //! @todo - move to std::regex (after switching to gcc 4.9 or higher) and get rid of CRegExp
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -72,19 +73,22 @@ public:
    * @param study (optional) Controls study of expression, useful if expression will be used
    *                         several times
    */
-  CRegExp(bool caseless, utf8Mode utf8, const char *re, studyMode study = NoStudy);
+  CRegExp(bool caseless, utf8Mode utf8, const char *re, studyMode study = StudyWithJitComp);
 
   CRegExp(const CRegExp& re);
   ~CRegExp();
 
   /**
    * Compile (prepare) regular expression
+   * Compiled expressions are shared by all CRegExp objects: compiling a pattern that
+   * was compiled before with the same options only takes a lookup, so the default is
+   * to study and JIT-compile.
    * @param re          The regular expression
    * @param study (optional) Controls study of expression, useful if expression will be used 
    *                         several times
    * @return true on success, false on any error
    */
-  bool RegComp(const char *re, studyMode study = NoStudy);
+  bool RegComp(const char *re, studyMode study = StudyWithJitComp);
 
   /**
    * Compile (prepare) regular expression
@@ -93,7 +97,7 @@ public:
    *                         several times
    * @return true on success, false on any error
    */
-  bool RegComp(const std::string& re, studyMode study = NoStudy)
+  bool RegComp(const std::string& re, studyMode study = StudyWithJitComp)
   { return RegComp(re.c_str(), study); }
 
   /**
@@ -157,8 +161,10 @@ private:
   void Cleanup();
   inline bool IsValidSubNumber(int iSub) const;
 
-  PCRE::pcre* m_re;
-  PCRE::pcre_extra* m_sd;
+  struct CCompiledPattern;
+  std::shared_ptr<const CCompiledPattern> m_compiled;
+  PCRE::pcre* m_re;       // owned by m_compiled
+  PCRE::pcre_extra* m_sd; // owned by m_compiled
   static const int OVECCOUNT=(m_MaxNumOfBackrefrences + 1) * 3;
   unsigned int m_offset;
   int         m_iOvector[OVECCOUNT];
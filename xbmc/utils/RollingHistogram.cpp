@@ -0,0 +1,68 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RollingHistogram.h"
+
+#include <algorithm>
+
+CRollingHistogram::CRollingHistogram(double bucketWidth, int buckets, int window) :
+  m_bucketWidth(bucketWidth),
+  m_buckets(buckets),
+  m_samples(window)
+{
+}
+
+void CRollingHistogram::Reset()
+{
+  std::fill(m_buckets.begin(), m_buckets.end(), 0);
+  m_pos = 0;
+  m_count = 0;
+}
+
+void CRollingHistogram::Add(double value)
+{
+  int last = static_cast<int>(m_buckets.size()) - 1;
+  int bucket = value > 0.0 ? static_cast<int>(std::min(value / m_bucketWidth, static_cast<double>(last))) : 0;
+
+  if (m_count == static_cast<int>(m_samples.size()))
+    m_buckets[m_samples[m_pos]]--;
+  else
+    m_count++;
+
+  m_samples[m_pos] = bucket;
+  m_buckets[bucket]++;
+  m_pos = (m_pos + 1) % m_samples.size();
+}
+
+double CRollingHistogram::GetPercentile(double p) const
+{
+  if (m_count == 0)
+    return 0.0;
+
+  int target = std::min(static_cast<int>(m_count * p), m_count - 1);
+  int sum = 0;
+  for (size_t i = 0; i < m_buckets.size(); i++)
+  {
+    sum += m_buckets[i];
+    if (sum > target)
+      return (i + 1) * m_bucketWidth;
+  }
+  return m_buckets.size() * m_bucketWidth;
+}
@@ -0,0 +1,50 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <vector>
+
+/*!
+ * \brief Histogram over the last values added, used for timing telemetry.
+ *
+ * Values are sorted into buckets of equal width starting at zero, values
+ * beyond the last bucket are counted in the last one. Once the window is
+ * full the oldest value is dropped for every new one.
+ */
+class CRollingHistogram
+{
+public:
+  CRollingHistogram(double bucketWidth, int buckets, int window);
+
+  void Reset();
+  void Add(double value);
+
+  //! upper bound of the bucket the given fraction of values is below of, 0 if empty
+  double GetPercentile(double p) const;
+  int GetCount() const { return m_count; }
+
+private:
+  double m_bucketWidth;
+  std::vector<int> m_buckets;
+  std::vector<int> m_samples;
+  int m_pos = 0;
+  int m_count = 0;
+};
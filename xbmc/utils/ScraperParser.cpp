@@ -35,10 +35,42 @@
 #include "utils/XMLUtils.h"
 #include <sstream>
 #include <cstring>
+#include <algorithm>
 
 using namespace ADDON;
 using namespace XFILE;
 
+/*!
+ \brief A <RegExp> element with its attributes parsed, and its expression compiled
+ if it can be, so that running a scraper function many times doesn't repeat the work.
+ */
+struct CScraperParser::CExpression
+{
+  bool insensitive = true;
+  CRegExp::utf8Mode utf8 = CRegExp::autoUtf8;
+  std::string expression;
+  std::string output;
+  bool expressionStatic = false;    ///< expression uses no buffers or settings, so it is compiled once
+  bool outputStatic = false;        ///< output uses no buffers or settings, so its tokens are inserted once
+  std::unique_ptr<CRegExp> regExp;  ///< the compiled expression if static, NULL if it failed to compile
+  std::unique_ptr<CRegExp> optionalExp;
+  bool repeat = false;
+  bool clear = false;
+  bool clean[MAX_SCRAPER_BUFFERS];
+  bool trim[MAX_SCRAPER_BUFFERS];
+  bool fixChars[MAX_SCRAPER_BUFFERS];
+  bool encode[MAX_SCRAPER_BUFFERS];
+  int optional = -1;
+  int compare = -1;
+};
+
+static bool UsesBuffers(const std::string& str)
+{
+  return str.find("$$") != std::string::npos ||
+         str.find("$INFO[") != std::string::npos ||
+         str.find("$LOCALIZE[") != std::string::npos;
+}
+
 CScraperParser::CScraperParser()
 {
   m_pRootElement = NULL;
@@ -82,6 +114,7 @@ CScraperParser::~CScraperParser()
 
 void CScraperParser::Clear()
 {
+  m_expressions.clear();
   m_pRootElement = NULL;
   delete m_document;
 
@@ -153,7 +186,7 @@ void CScraperParser::ReplaceBuffers(std::string& strDest)
 {
   // insert buffers
   size_t iIndex;
-  for (int i=MAX_SCRAPER_BUFFERS-1; i>=0; i--)
+  for (int i=MAX_SCRAPER_BUFFERS-1; i>=0 && strDest.find("$$") != std::string::npos; i--)
   {
     iIndex = 0;
     std::string temp = StringUtils::Format("$$%i",i+1);
@@ -192,108 +225,162 @@ void CScraperParser::ReplaceBuffers(std::string& strDest)
     strDest.replace(strDest.begin()+iIndex,strDest.begin()+iIndex+2,"\n");
 }
 
-void CScraperParser::ParseExpression(const std::string& input, std::string& dest, TiXmlElement* element, bool bAppend)
+CScraperParser::CExpression* CScraperParser::GetExpression(TiXmlElement* element)
 {
-  std::string strOutput = XMLUtils::GetAttribute(element, "output");
+  auto it = m_expressions.find(element);
+  if (it != m_expressions.end())
+    return it->second.get();
 
+  std::unique_ptr<CExpression> expression;
   TiXmlElement* pExpression = element->FirstChildElement("expression");
   if (pExpression)
   {
-    bool bInsensitive=true;
+    expression.reset(new CExpression);
+
     const char* sensitive = pExpression->Attribute("cs");
     if (sensitive)
       if (stricmp(sensitive,"yes") == 0)
-        bInsensitive=false; // match case sensitive
+        expression->insensitive=false; // match case sensitive
 
-    CRegExp::utf8Mode eUtf8 = CRegExp::autoUtf8;
     const char* const strUtf8 = pExpression->Attribute("utf8");
     if (strUtf8)
     {
       if (stricmp(strUtf8, "yes") == 0)
-        eUtf8 = CRegExp::forceUtf8;
+        expression->utf8 = CRegExp::forceUtf8;
       else if (stricmp(strUtf8, "no") == 0)
-        eUtf8 = CRegExp::asciiOnly;
+        expression->utf8 = CRegExp::asciiOnly;
       else if (stricmp(strUtf8, "auto") == 0)
-        eUtf8 = CRegExp::autoUtf8;
+        expression->utf8 = CRegExp::autoUtf8;
     }
 
-    CRegExp reg(bInsensitive, eUtf8);
-    std::string strExpression;
     if (pExpression->FirstChild())
-      strExpression = pExpression->FirstChild()->Value();
+      expression->expression = pExpression->FirstChild()->Value();
     else
-      strExpression = "(.*)";
-    ReplaceBuffers(strExpression);
-    ReplaceBuffers(strOutput);
-
-    if (!reg.RegComp(strExpression.c_str()))
-    {
-      return;
-    }
+      expression->expression = "(.*)";
 
-    bool bRepeat = false;
     const char* szRepeat = pExpression->Attribute("repeat");
     if (szRepeat)
       if (stricmp(szRepeat,"yes") == 0)
-        bRepeat = true;
+        expression->repeat = true;
 
     const char* szClear = pExpression->Attribute("clear");
     if (szClear)
       if (stricmp(szClear,"yes") == 0)
-        dest=""; // clear no matter if regexp fails
+        expression->clear = true;
 
-    bool bClean[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bClean,pExpression->Attribute("noclean"),true);
+    GetBufferParams(expression->clean,pExpression->Attribute("noclean"),true);
+    GetBufferParams(expression->trim,pExpression->Attribute("trim"),false);
+    GetBufferParams(expression->fixChars,pExpression->Attribute("fixchars"),false);
+    GetBufferParams(expression->encode,pExpression->Attribute("encode"),false);
 
-    bool bTrim[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bTrim,pExpression->Attribute("trim"),false);
+    pExpression->QueryIntAttribute("optional",&expression->optional);
+    pExpression->QueryIntAttribute("compare",&expression->compare);
 
-    bool bFixChars[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bFixChars,pExpression->Attribute("fixchars"),false);
+    if (expression->optional > -1)
+    {
+      expression->optionalExp.reset(new CRegExp);
+      expression->optionalExp->RegComp("(.*)(\\\\\\(.*\\\\2.*)\\\\\\)(.*)");
+    }
 
-    bool bEncode[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bEncode,pExpression->Attribute("encode"),false);
+    // most expressions are fixed and run for every item, so compile them once and have them studied
+    expression->expressionStatic = !UsesBuffers(expression->expression);
+    if (expression->expressionStatic)
+    {
+      ReplaceBuffers(expression->expression);
+      expression->regExp.reset(new CRegExp(expression->insensitive, expression->utf8));
+      if (!expression->regExp->RegComp(expression->expression, CRegExp::StudyWithJitComp))
+        expression->regExp.reset();
+    }
 
-    int iOptional = -1;
-    pExpression->QueryIntAttribute("optional",&iOptional);
+    expression->output = XMLUtils::GetAttribute(element, "output");
+    expression->outputStatic = !UsesBuffers(expression->output);
+    if (expression->outputStatic)
+    {
+      ReplaceBuffers(expression->output);
+      InsertTokens(expression->output, *expression);
+    }
+  }
 
-    int iCompare = -1;
-    pExpression->QueryIntAttribute("compare",&iCompare);
-    if (iCompare > -1)
-      StringUtils::ToLower(m_param[iCompare-1]);
-    std::string curInput = input;
-    for (int iBuf=0;iBuf<MAX_SCRAPER_BUFFERS;++iBuf)
+  return m_expressions.insert(std::make_pair(element, std::move(expression))).first->second.get();
+}
+
+void CScraperParser::InsertTokens(std::string& strOutput, const CExpression& expression)
+{
+  for (int iBuf=0;iBuf<MAX_SCRAPER_BUFFERS;++iBuf)
+  {
+    if (expression.clean[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!CLEAN!!!");
+    if (expression.trim[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!TRIM!!!");
+    if (expression.fixChars[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!FIXCHARS!!!");
+    if (expression.encode[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!ENCODE!!!");
+  }
+}
+
+void CScraperParser::ParseExpression(const std::string& input, std::string& dest, TiXmlElement* element, bool bAppend)
+{
+  CExpression* expression = GetExpression(element);
+  if (expression)
+  {
+    CRegExp* reg = expression->regExp.get();
+    std::unique_ptr<CRegExp> dynamicReg;
+    if (!expression->expressionStatic)
+    {
+      std::string strExpression = expression->expression;
+      ReplaceBuffers(strExpression);
+      dynamicReg.reset(new CRegExp(expression->insensitive, expression->utf8));
+      if (!dynamicReg->RegComp(strExpression.c_str()))
+        return;
+      reg = dynamicReg.get();
+    }
+    else if (!reg)
     {
-      if (bClean[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!CLEAN!!!");
-      if (bTrim[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!TRIM!!!");
-      if (bFixChars[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!FIXCHARS!!!");
-      if (bEncode[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!ENCODE!!!");
+      return;
     }
-    int i = reg.RegFind(curInput.c_str());
-    while (i > -1 && (i < (int)curInput.size() || curInput.empty()))
+
+    const std::string* strOutput = &expression->output;
+    std::string dynamicOutput;
+    if (!expression->outputStatic)
+    {
+      dynamicOutput = expression->output;
+      ReplaceBuffers(dynamicOutput);
+      InsertTokens(dynamicOutput, *expression);
+      strOutput = &dynamicOutput;
+    }
+
+    if (expression->clear)
+      dest=""; // clear no matter if regexp fails
+
+    int iOptional = expression->optional;
+    int iCompare = expression->compare;
+    if (iCompare > -1)
+      StringUtils::ToLower(m_param[iCompare-1]);
+
+    // repeated matches move along the input rather than erase it from a copy
+    const char* curInput = input.c_str();
+    size_t curSize = input.size();
+    int i = reg->RegFind(curInput);
+    while (i > -1 && (i < (int)curSize || curSize == 0))
     {
       if (!bAppend)
       {
         dest = "";
         bAppend = true;
       }
-      std::string strCurOutput=strOutput;
+      std::string strCurOutput=*strOutput;
 
       if (iOptional > -1) // check that required param is there
       {
         char temp[4];
         sprintf(temp,"\\%i",iOptional);
-        std::string szParam = reg.GetReplaceString(temp);
-        CRegExp reg2;
-        reg2.RegComp("(.*)(\\\\\\(.*\\\\2.*)\\\\\\)(.*)");
-        int i2=reg2.RegFind(strCurOutput.c_str());
+        std::string szParam = reg->GetReplaceString(temp);
+        CRegExp* reg2 = expression->optionalExp.get();
+        int i2=reg2->RegFind(strCurOutput.c_str());
         while (i2 > -1)
         {
-          std::string szRemove(reg2.GetMatch(2));
+          std::string szRemove(reg2->GetMatch(2));
           int iRemove = szRemove.size();
           int i3 = strCurOutput.find(szRemove);
           if (!szParam.empty())
@@ -304,14 +391,14 @@ void CScraperParser::ParseExpression(const std::string& input, std::string& dest
           else
             strCurOutput.replace(strCurOutput.begin()+i3,strCurOutput.begin()+i3+iRemove+2,"");
 
-          i2 = reg2.RegFind(strCurOutput.c_str());
+          i2 = reg2->RegFind(strCurOutput.c_str());
         }
       }
 
-      int iLen = reg.GetFindLen();
+      int iLen = reg->GetFindLen();
       // nasty hack #1 - & means \0 in a replace string
       StringUtils::Replace(strCurOutput, "&","!!!AMPAMP!!!");
-      std::string result = reg.GetReplaceString(strCurOutput.c_str());
+      std::string result = reg->GetReplaceString(strCurOutput.c_str());
       if (!result.empty())
       {
         std::string strResult(result);
@@ -328,10 +415,12 @@ void CScraperParser::ParseExpression(const std::string& input, std::string& dest
         else
           dest += strResult;
       }
-      if (bRepeat && iLen > 0)
+      if (expression->repeat && iLen > 0)
       {
-        curInput.erase(0,i+iLen>(int)curInput.size()?curInput.size():i+iLen);
-        i = reg.RegFind(curInput.c_str());
+        size_t skip = std::min(static_cast<size_t>(i + iLen), curSize);
+        curInput += skip;
+        curSize -= skip;
+        i = reg->RegFind(curInput);
       }
       else
         i = -1;
@@ -553,8 +642,12 @@ void CScraperParser::Clean(std::string& strDirty)
 
 void CScraperParser::ConvertJSON(std::string &string)
 {
-  CRegExp reg;
-  reg.RegComp("\\\\u([0-f]{4})");
+  if (!m_jsonUnicode)
+  {
+    m_jsonUnicode.reset(new CRegExp);
+    m_jsonUnicode->RegComp("\\\\u([0-f]{4})", CRegExp::StudyRegExp);
+  }
+  CRegExp& reg = *m_jsonUnicode;
   while (reg.RegFind(string.c_str()) > -1)
   {
     int pos = reg.GetSubStart(1);
@@ -564,8 +657,12 @@ void CScraperParser::ConvertJSON(std::string &string)
     string.replace(string.begin()+pos-2, string.begin()+pos+4, replace);
   }
 
-  CRegExp reg2;
-  reg2.RegComp("\\\\x([0-9]{2})([^\\\\]+;)");
+  if (!m_jsonHex)
+  {
+    m_jsonHex.reset(new CRegExp);
+    m_jsonHex->RegComp("\\\\x([0-9]{2})([^\\\\]+;)", CRegExp::StudyRegExp);
+  }
+  CRegExp& reg2 = *m_jsonHex;
   while (reg2.RegFind(string.c_str()) > -1)
   {
     int pos1 = reg2.GetSubStart(1);
@@ -21,6 +21,8 @@
  *
  */
 
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -33,6 +35,7 @@ namespace ADDON
 
 class TiXmlElement;
 class CXBMCTinyXML;
+class CRegExp;
 
 class CScraperSettings;
 
@@ -58,8 +61,16 @@ public:
   std::string m_param[MAX_SCRAPER_BUFFERS];
 
 private:
+  struct CExpression;
+
   bool LoadFromXML();
   void ReplaceBuffers(std::string& strDest);
+
+  /*! \brief Get the parsed attributes of a <RegExp> element and its expression,
+   compiled the first time it is used if it doesn't depend on buffers or settings.
+   \return the expression, or NULL if the element has none.
+   */
+  CExpression* GetExpression(TiXmlElement* element);
   void ParseExpression(const std::string& input, std::string& dest, TiXmlElement* element, bool bAppend);
 
   /*! \brief Parse an 'XSLT' declaration from the scraper
@@ -78,6 +89,7 @@ private:
   void ClearBuffers();
   void GetBufferParams(bool* result, const char* attribute, bool defvalue);
   void InsertToken(std::string& strOutput, int buf, const char* token);
+  void InsertTokens(std::string& strOutput, const CExpression& expression);
 
   CXBMCTinyXML* m_document;
   TiXmlElement* m_pRootElement;
@@ -87,6 +99,10 @@ private:
 
   std::string m_strFile;
   ADDON::CScraper* m_scraper;
+
+  std::map<const TiXmlElement*, std::unique_ptr<CExpression>> m_expressions; ///< by <RegExp> element of m_document
+  std::unique_ptr<CRegExp> m_jsonUnicode;
+  std::unique_ptr<CRegExp> m_jsonHex;
 };
 
 #endif
@@ -23,6 +23,7 @@
 #include "settings/AdvancedSettings.h"
 #include "CharsetConverter.h"
 #include "utils/CharsetDetection.h"
+#include "utils/HttpCache.h"
 #include "utils/StringUtils.h"
 #include "URL.h"
 #include "filesystem/CurlFile.h"
@@ -214,6 +215,8 @@ bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CCur
   }
 
   std::string strHTML1(strHTML);
+  std::string mimeType;
+  std::string reportedCharset;
 
   if (scrURL.m_post)
   {
@@ -223,14 +226,15 @@ bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CCur
 
     if (!http.Post(url.Get(), strOptions, strHTML1))
       return false;
+
+    mimeType = http.GetProperty(XFILE::FILE_PROPERTY_MIME_TYPE);
+    reportedCharset = http.GetProperty(XFILE::FILE_PROPERTY_CONTENT_CHARSET);
   }
-  else
-    if (!http.Get(url.Get(), strHTML1))
-      return false;
+  else if (!GetCached(url.Get(), scrURL, http, strHTML1, mimeType, reportedCharset))
+    return false;
 
   strHTML = strHTML1;
 
-  std::string mimeType(http.GetProperty(XFILE::FILE_PROPERTY_MIME_TYPE));
   CMime::EFileType ftype = CMime::GetFileTypeFromMime(mimeType);
   if (ftype == CMime::FileTypeUnknown)
     ftype = CMime::GetFileTypeFromContent(strHTML);
@@ -249,7 +253,6 @@ bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CCur
       CLog::Log(LOGWARNING, "%s: \"%s\" looks like archive, but cannot be unpacked", __FUNCTION__, scrURL.m_url.c_str());
   }
 
-  std::string reportedCharset(http.GetProperty(XFILE::FILE_PROPERTY_CONTENT_CHARSET));
   if (ftype == CMime::FileTypeHtml)
   {
     std::string realHtmlCharset, converted;
@@ -308,6 +311,64 @@ bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CCur
   return true;
 }
 
+bool CScraperUrl::GetCached(const std::string& url, const SUrlEntry& scrURL, XFILE::CCurlFile& http,
+                            std::string& body, std::string& mimeType, std::string& charset)
+{
+  if (!CHttpCache::IsEnabled())
+  {
+    if (!http.Get(url, body))
+      return false;
+    mimeType = http.GetProperty(XFILE::FILE_PROPERTY_MIME_TYPE);
+    charset = http.GetProperty(XFILE::FILE_PROPERTY_CONTENT_CHARSET);
+    return true;
+  }
+
+  CHttpCache &cache = CHttpCache::GetInstance();
+  std::string key = CHttpCache::GetKey(url, scrURL.m_spoof, scrURL.m_isgz ? "gzip" : "");
+  CHttpCache::CEntry entry;
+  bool cached = cache.Lookup(key, entry);
+  if (cached && entry.IsFresh())
+  {
+    CLog::Log(LOGDEBUG, "%s: Using cached response for \"%s\"", __FUNCTION__, CURL::GetRedacted(url).c_str());
+    body = entry.body;
+    mimeType = entry.mimeType;
+    charset = entry.charset;
+    return true;
+  }
+
+  if (cached && !entry.etag.empty())
+    http.SetRequestHeader("If-None-Match", entry.etag);
+  if (cached && !entry.lastModified.empty())
+    http.SetRequestHeader("If-Modified-Since", entry.lastModified);
+
+  bool result = http.Get(url, body);
+
+  // the curl file is reused for the next requests of the scraper
+  http.RemoveRequestHeader("If-None-Match");
+  http.RemoveRequestHeader("If-Modified-Since");
+
+  if (!result)
+    return false;
+
+  if (cached && http.GetHttpResponseCode() == 304)
+  {
+    CLog::Log(LOGDEBUG, "%s: Cached response for \"%s\" is unchanged", __FUNCTION__, CURL::GetRedacted(url).c_str());
+    cache.Revalidated(key, http.GetHttpHeader(), entry);
+    body = entry.body;
+    mimeType = entry.mimeType;
+    charset = entry.charset;
+    return true;
+  }
+
+  mimeType = http.GetProperty(XFILE::FILE_PROPERTY_MIME_TYPE);
+  charset = http.GetProperty(XFILE::FILE_PROPERTY_CONTENT_CHARSET);
+  if (http.GetHttpResponseCode() == 200)
+    cache.Store(key, http.GetHttpHeader(), body);
+  else if (cached)
+    cache.Remove(key);
+  return true;
+}
+
 // XML format is of strUrls is:
 // <TAG><url>...</url>...</TAG> (parsed by ParseElement) or <url>...</url> (ditto)
 bool CScraperUrl::ParseEpisodeGuide(std::string strUrls)
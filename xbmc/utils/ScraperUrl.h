@@ -86,6 +86,14 @@ public:
   std::string strId;
   double relevance;
   std::vector<SUrlEntry> m_url;
+
+private:
+  /*! \brief Get an url through the http cache, revalidating a stale cached response.
+   \param body the response body as received.
+   \param mimeType, charset the mime type and charset reported with it.
+   */
+  static bool GetCached(const std::string& url, const SUrlEntry& scrURL, XFILE::CCurlFile& http,
+                        std::string& body, std::string& mimeType, std::string& charset);
 };
 
 #endif
@@ -23,12 +23,19 @@
 #include "URL.h"
 #include "Util.h"
 #include "XBDateTime.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
+#include "utils/CPUInfo.h"
+#include "utils/JobManager.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
 
 #include <algorithm>
+#include <locale>
+#include <memory>
+#include <set>
 
 std::string ArrayToString(SortAttribute attributes, const CVariant &variant, const std::string &separator = " / ")
 {
@@ -433,130 +440,319 @@ std::string ByLastUsed(SortAttribute attributes, const SortItem &values)
   return values.at(FieldLastUsed).asString();
 }
 
-bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFolder, bool &result, std::wstring &labelLeft, std::wstring &labelRight)
+#define SORT_NUMBER_FLAG        (UINT64_C(1) << 63)
+#define SORT_NUMBER_DIGIT(t)    (static_cast<unsigned int>((t) >> 50) & 0xf)
+#define SORT_NUMBER_VALUE(t)    ((t) & ((UINT64_C(1) << 50) - 1))
+#define SORT_PARALLEL_MIN_ITEMS 20000 // smaller inputs are sorted on the calling thread
+#define SORT_PARALLEL_MAX_CHUNKS 8
+
+/*!
+ \brief What the comparison of two items looks at, taken from each item once.
+
+ The sort label is turned into a collation key with a token per character or number, the
+ way StringUtils::AlphaNumericCompare walks it: characters become their rank in the collation
+ of the locale, runs of up to 15 digits their value along with the first digit. Comparing two
+ keys then takes integer comparisons only, instead of a collation call per character.
+ */
+class CSortKeys
 {
-  // make sure both items have the necessary data to do the sorting
-  SortItem::const_iterator itLeftSort, itRightSort;
-  if ((itLeftSort = left.find(FieldSort)) == left.end())
+public:
+  CSortKeys(const std::vector<const SortItem*> &items, bool handleFolder, bool descending);
+
+  bool Less(size_t left, size_t right) const;
+
+private:
+  struct Key
   {
-    result = false;
-    return true;
+    const SortItem *item = nullptr;
+    bool hasLabel = false;
+    SortSpecial special = SortSpecialNone;
+    int folder = -1;    // -1 if the item has no folder flag
+    size_t offset = 0;  // of the tokens in m_tokens
+    size_t length = 0;
+  };
+
+  int CompareLabels(const Key &left, const Key &right) const;
+
+  static wchar_t Fold(wchar_t c)
+  {
+    return c >= L'A' && c <= L'Z' ? c + (L'a' - L'A') : c;
   }
-  if ((itRightSort = right.find(FieldSort)) == right.end())
+  static bool IsDigit(wchar_t c) { return c >= L'0' && c <= L'9'; }
+
+  std::vector<Key> m_keys;
+  std::vector<uint64_t> m_tokens;
+  uint64_t m_digitRanks[10];
+  bool m_handleFolder;
+  bool m_descending;
+};
+
+CSortKeys::CSortKeys(const std::vector<const SortItem*> &items, bool handleFolder, bool descending)
+  : m_handleFolder(handleFolder)
+  , m_descending(descending)
+{
+  m_keys.resize(items.size());
+  std::vector<std::wstring> labels(items.size());
+  std::vector<wchar_t> chars;
+  std::vector<bool> seen(0x100, false);
+  std::set<wchar_t> seenOther;
+  for (wchar_t c = L'0'; c <= L'9'; c++)
   {
-    result = true;
-    return true;
+    chars.push_back(c);
+    seen[c] = true;
   }
 
-  // look at special sorting behaviour
-  SortItem::const_iterator itLeft, itRight;
-  SortSpecial leftSortSpecial = SortSpecialNone;
-  SortSpecial rightSortSpecial = SortSpecialNone;
-  if ((itLeft = left.find(FieldSortSpecial)) != left.end() && itLeft->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    leftSortSpecial = (SortSpecial)itLeft->second.asInteger();
-  if ((itRight = right.find(FieldSortSpecial)) != right.end() && itRight->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    rightSortSpecial = (SortSpecial)itRight->second.asInteger();
-  
-  // one has a special sort
-  if (leftSortSpecial != rightSortSpecial)
+  for (size_t i = 0; i < items.size(); i++)
   {
-    // left should be sorted on top
-    // or right should be sorted on bottom
-    // => left is sorted above right
-    if (leftSortSpecial == SortSpecialOnTop ||
-        rightSortSpecial == SortSpecialOnBottom)
+    const SortItem &item = *items[i];
+    Key &key = m_keys[i];
+    key.item = &item;
+
+    SortItem::const_iterator it = item.find(FieldSort);
+    if (it == item.end())
+      continue;
+    key.hasLabel = true;
+    labels[i] = it->second.asWideString();
+
+    if ((it = item.find(FieldSortSpecial)) != item.end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+      key.special = (SortSpecial)it->second.asInteger();
+    if ((it = item.find(FieldFolder)) != item.end())
+      key.folder = it->second.asBoolean() ? 1 : 0;
+
+    for (wchar_t c : labels[i])
     {
-      result = true;
-      return true;
+      c = Fold(c);
+      if (c >= 0 && c < 0x100 ? !seen[c] : seenOther.find(c) == seenOther.end())
+      {
+        if (c >= 0 && c < 0x100)
+          seen[c] = true;
+        else
+          seenOther.insert(c);
+        chars.push_back(c);
+      }
     }
-    
-    // otherwise right is sorted above left
-    result = false;
-    return true;
   }
-  // both have either sort on top or sort on bottom -> leave as-is
-  else if (leftSortSpecial != SortSpecialNone && leftSortSpecial == rightSortSpecial)
+
+  // rank the characters used, ones that collate the same share a rank
+  const std::collate<wchar_t>& coll = std::use_facet<std::collate<wchar_t> >(g_langInfo.GetSystemLocale());
+  std::sort(chars.begin(), chars.end(), [&coll](const wchar_t &left, const wchar_t &right)
   {
-    result = false;
-    return true;
+    return coll.compare(&left, &left + 1, &right, &right + 1) < 0;
+  });
+  std::vector<uint32_t> lowRanks(0x100, 0);
+  std::map<wchar_t, uint32_t> otherRanks;
+  uint32_t rank = 0;
+  for (size_t i = 0; i < chars.size(); i++)
+  {
+    if (i > 0 && coll.compare(&chars[i - 1], &chars[i - 1] + 1, &chars[i], &chars[i] + 1) != 0)
+      rank++;
+    if (chars[i] >= 0 && chars[i] < 0x100)
+      lowRanks[chars[i]] = rank;
+    else
+      otherRanks[chars[i]] = rank;
   }
+  for (unsigned int digit = 0; digit < 10; digit++)
+    m_digitRanks[digit] = lowRanks[L'0' + digit];
 
-  if (handleFolder)
+  for (size_t i = 0; i < items.size(); i++)
   {
-    itLeft = left.find(FieldFolder);
-    itRight = right.find(FieldFolder);
-    if (itLeft != left.end() && itRight != right.end() &&
-        itLeft->second.asBoolean() != itRight->second.asBoolean())
+    const std::wstring &label = labels[i];
+    Key &key = m_keys[i];
+    key.offset = m_tokens.size();
+    for (size_t pos = 0; pos < label.size();)
     {
-      result = itLeft->second.asBoolean();
-      return true;
+      if (IsDigit(label[pos]))
+      {
+        // same as AlphaNumericCompare, which reads up to 15 digits at once
+        uint64_t firstDigit = label[pos] - L'0';
+        uint64_t value = 0;
+        size_t end = std::min(label.size(), pos + 15);
+        for (; pos < end && IsDigit(label[pos]); pos++)
+          value = value * 10 + (label[pos] - L'0');
+        m_tokens.push_back(SORT_NUMBER_FLAG | (firstDigit << 50) | value);
+      }
+      else
+      {
+        wchar_t c = Fold(label[pos++]);
+        m_tokens.push_back(c >= 0 && c < 0x100 ? lowRanks[c] : otherRanks[c]);
+      }
     }
+    key.length = m_tokens.size() - key.offset;
   }
-
-  labelLeft = itLeftSort->second.asWideString();
-  labelRight = itRightSort->second.asWideString();
-
-  return false;
 }
 
-bool SorterAscending(const SortItem &left, const SortItem &right)
+bool CSortKeys::Less(size_t left, size_t right) const
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+  const Key &keyLeft = m_keys[left];
+  const Key &keyRight = m_keys[right];
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+  // make sure both items have the necessary data to do the sorting
+  if (!keyLeft.hasLabel)
+    return false;
+  if (!keyRight.hasLabel)
+    return true;
 
-bool SorterDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+  // one has a special sort, items sorted on top are above and items sorted on bottom below the others
+  if (keyLeft.special != keyRight.special)
+    return keyLeft.special == SortSpecialOnTop || keyRight.special == SortSpecialOnBottom;
+  // both have either sort on top or sort on bottom -> leave as-is
+  if (keyLeft.special != SortSpecialNone)
+    return false;
+
+  if (m_handleFolder && keyLeft.folder >= 0 && keyRight.folder >= 0 && keyLeft.folder != keyRight.folder)
+    return keyLeft.folder > keyRight.folder;
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
+  int result = CompareLabels(keyLeft, keyRight);
+  return m_descending ? result > 0 : result < 0;
 }
 
-bool SorterIgnoreFoldersAscending(const SortItem &left, const SortItem &right)
+int CSortKeys::CompareLabels(const Key &left, const Key &right) const
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+  const uint64_t *l = m_tokens.data() + left.offset;
+  const uint64_t *lEnd = l + left.length;
+  const uint64_t *r = m_tokens.data() + right.offset;
+  const uint64_t *rEnd = r + right.length;
+  for (; l != lEnd && r != rEnd; ++l, ++r)
+  {
+    if (*l == *r)
+      continue;
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+    bool lNumber = (*l & SORT_NUMBER_FLAG) != 0;
+    bool rNumber = (*r & SORT_NUMBER_FLAG) != 0;
+    if (lNumber && rNumber)
+    {
+      if (SORT_NUMBER_VALUE(*l) != SORT_NUMBER_VALUE(*r))
+        return SORT_NUMBER_VALUE(*l) < SORT_NUMBER_VALUE(*r) ? -1 : 1;
+      continue;
+    }
 
-bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+    // a digit against another character is compared by collation
+    uint64_t lRank = lNumber ? m_digitRanks[SORT_NUMBER_DIGIT(*l)] : *l;
+    uint64_t rRank = rNumber ? m_digitRanks[SORT_NUMBER_DIGIT(*r)] : *r;
+    if (lRank != rRank)
+      return lRank < rRank ? -1 : 1;
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
+    // a digit collating like another character, the tokens of both don't line up anymore
+    if (lNumber != rNumber)
+    {
+      int64_t result = StringUtils::AlphaNumericCompare(left.item->at(FieldSort).asWideString().c_str(),
+                                                        right.item->at(FieldSort).asWideString().c_str());
+      return result < 0 ? -1 : (result > 0 ? 1 : 0);
+    }
+  }
 
-bool SorterIndirectAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterAscending(*left, *right);
+  if (r != rEnd)
+    return -1; // right is longer
+  if (l != lEnd)
+    return 1;  // left is longer
+  return 0;
 }
 
-bool SorterIndirectDescending(const SortItemPtr &left, const SortItemPtr &right)
+/*!
+ \brief Chunks of a parallel sort, shared with the jobs so that a job that only
+ runs after the sort is done finds its chunk already taken.
+ */
+struct CSortChunks
 {
-  return SorterDescending(*left, *right);
-}
+  CCriticalSection section;
+  CEvent done;
+  std::vector<bool> taken;
+  unsigned int running = 0;
+};
+
+/*!
+ \brief Stable order of the items, as indices into them.
 
-bool SorterIndirectIgnoreFoldersAscending(const SortItemPtr &left, const SortItemPtr &right)
+ Large inputs are cut into chunks that are sorted on the job manager and merged. The
+ calling thread sorts any chunk no job has started on, so the sort never waits on a
+ busy job manager.
+ */
+static std::vector<size_t> GetSortedOrder(const std::vector<const SortItem*> &items, SortOrder sortOrder, SortAttribute attributes)
 {
-  return SorterIgnoreFoldersAscending(*left, *right);
+  CSortKeys keys(items, !(attributes & SortAttributeIgnoreFolders), sortOrder == SortOrderDescending);
+  auto less = [&keys](size_t left, size_t right) { return keys.Less(left, right); };
+
+  std::vector<size_t> order(items.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+
+  unsigned int chunks = std::min(static_cast<unsigned int>(std::max(g_cpuInfo.getCPUCount(), 1)), static_cast<unsigned int>(SORT_PARALLEL_MAX_CHUNKS));
+  if (order.size() < SORT_PARALLEL_MIN_ITEMS || chunks < 2)
+  {
+    std::stable_sort(order.begin(), order.end(), less);
+    return order;
+  }
+
+  std::vector<size_t> bounds(chunks + 1);
+  for (unsigned int chunk = 0; chunk <= chunks; chunk++)
+    bounds[chunk] = order.size() * chunk / chunks;
+
+  std::shared_ptr<CSortChunks> state = std::make_shared<CSortChunks>();
+  state->taken.resize(chunks, false);
+  size_t *data = order.data();
+  const CSortKeys *sortKeys = &keys;
+  CJobQueue queue(false, chunks - 1, CJob::PRIORITY_HIGH);
+  for (unsigned int chunk = 1; chunk < chunks; chunk++)
+  {
+    size_t begin = bounds[chunk];
+    size_t end = bounds[chunk + 1];
+    queue.Submit([state, chunk, data, begin, end, sortKeys]()
+    {
+      {
+        CSingleLock lock(state->section);
+        if (state->taken[chunk])
+          return;
+        state->taken[chunk] = true;
+        state->running++;
+      }
+
+      std::stable_sort(data + begin, data + end, [sortKeys](size_t left, size_t right) { return sortKeys->Less(left, right); });
+
+      CSingleLock lock(state->section);
+      state->running--;
+      state->done.Set();
+    });
+  }
+
+  for (unsigned int chunk = 0; chunk < chunks; chunk++)
+  {
+    {
+      CSingleLock lock(state->section);
+      if (state->taken[chunk])
+        continue;
+      state->taken[chunk] = true;
+    }
+    std::stable_sort(order.begin() + bounds[chunk], order.begin() + bounds[chunk + 1], less);
+  }
+
+  {
+    CSingleLock lock(state->section);
+    while (state->running > 0)
+    {
+      state->done.Reset();
+      CSingleExit exit(state->section);
+      state->done.Wait();
+    }
+  }
+
+  // merging keeps items of the left chunk first, so the result is as stable as a single sort
+  for (unsigned int width = 1; width < chunks; width *= 2)
+  {
+    for (unsigned int chunk = 0; chunk + width < chunks; chunk += 2 * width)
+      std::inplace_merge(order.begin() + bounds[chunk], order.begin() + bounds[chunk + width],
+                         order.begin() + bounds[std::min(chunk + 2 * width, chunks)], less);
+  }
+  return order;
 }
 
-bool SorterIndirectIgnoreFoldersDescending(const SortItemPtr &left, const SortItemPtr &right)
+template<typename T>
+static void ApplyOrder(std::vector<T> &items, const std::vector<size_t> &order)
 {
-  return SorterIgnoreFoldersDescending(*left, *right);
+  std::vector<T> sorted;
+  sorted.reserve(items.size());
+  for (size_t index : order)
+    sorted.push_back(std::move(items[index]));
+  items.swap(sorted);
 }
 
 std::map<SortBy, SortUtils::SortPreparator> fillPreparators()
@@ -746,7 +942,11 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
       }
 
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
+      std::vector<const SortItem*> sortItems;
+      sortItems.reserve(items.size());
+      for (const SortItem &item : items)
+        sortItems.push_back(&item);
+      ApplyOrder(items, GetSortedOrder(sortItems, sortOrder, attributes));
     }
   }
 
@@ -796,7 +996,11 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
       }
 
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
+      std::vector<const SortItem*> sortItems;
+      sortItems.reserve(items.size());
+      for (const SortItemPtr &item : items)
+        sortItems.push_back(item.get());
+      ApplyOrder(items, GetSortedOrder(sortItems, sortOrder, attributes));
     }
   }
 
@@ -849,22 +1053,6 @@ const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
   return m_preparators[SortByNone];
 }
 
-SortUtils::Sorter SortUtils::getSorter(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIgnoreFoldersDescending : SorterIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterDescending : SorterAscending;
-}
-
-SortUtils::SorterIndirect SortUtils::getSorterIndirect(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIndirectIgnoreFoldersDescending : SorterIndirectIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterIndirectDescending : SorterIndirectAscending;
-}
-
 const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
 {
   std::map<SortBy, Fields>::const_iterator it = m_sortingFields.find(sortBy);
@@ -0,0 +1,55 @@
+/*
+ *      Copyright (C) 2005-2015 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "StringPool.h"
+
+#include <unordered_set>
+
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+
+namespace
+{
+  struct Pool
+  {
+    CCriticalSection section;
+    std::unordered_set<std::string> strings; // elements don't move on rehash
+  };
+
+  Pool& GetPool()
+  {
+    static Pool pool;
+    return pool;
+  }
+}
+
+const std::string& CStringPool::Get(const std::string &str)
+{
+  Pool &pool = GetPool();
+  CSingleLock lock(pool.section);
+  return *pool.strings.insert(str).first;
+}
+
+size_t CStringPool::Size()
+{
+  Pool &pool = GetPool();
+  CSingleLock lock(pool.section);
+  return pool.strings.size();
+}
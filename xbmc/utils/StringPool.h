@@ -0,0 +1,41 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2015 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+/*!
+ \brief Single shared copy of strings that are repeated across many objects.
+
+ Pooled strings are never freed, so only pool strings of a limited set, like the
+ names of list item properties, not values.
+ */
+class CStringPool
+{
+public:
+  /*! \brief Get the pooled copy of a string, adding it to the pool if needed.
+   \return a reference that stays valid until exit.
+   */
+  static const std::string& Get(const std::string &str);
+
+  /*! \brief Number of strings in the pool.
+   */
+  static size_t Size();
+};
@@ -64,22 +64,29 @@ int64_t CurrentHostFrequency(void)
 #endif
 }
 
-unsigned int CTimeUtils::frameTime = 0;
+uint64_t CTimeUtils::frameTime = 0;
 
 void CTimeUtils::UpdateFrameTime(bool flip)
 {
-  unsigned int currentTime = XbmcThreads::SystemClockMillis();
-  unsigned int last = frameTime;
-  while (frameTime < currentTime)
-  {
-    frameTime += (unsigned int)(1000 / CServiceBroker::GetWinSystem()->GetGfxContext().GetFPS());
-    // observe wrap around
-    if (frameTime < last)
-      break;
-  }
+  const uint64_t currentTime = XbmcThreads::SystemClockNanos();
+  if (frameTime >= currentTime)
+    return;
+
+  // advance by whole frames, counted in nanoseconds so that 1000 / fps doesn't
+  // get rounded down every frame
+  const uint64_t framePeriod = (uint64_t)(1000000000.0 / CServiceBroker::GetWinSystem()->GetGfxContext().GetFPS());
+  if (framePeriod == 0)
+    frameTime = currentTime;
+  else
+    frameTime += (currentTime - frameTime + framePeriod - 1) / framePeriod * framePeriod;
 }
 
 unsigned int CTimeUtils::GetFrameTime()
+{
+  return (unsigned int)(frameTime / 1000000);
+}
+
+uint64_t CTimeUtils::GetFrameTimeNanos()
 {
   return frameTime;
 }
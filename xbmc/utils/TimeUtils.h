@@ -33,9 +33,10 @@ class CTimeUtils
 public:
   static void UpdateFrameTime(bool flip); ///< update the frame time.  Not threadsafe
   static unsigned int GetFrameTime(); ///< returns the frame time in MS.  Not threadsafe
+  static uint64_t GetFrameTimeNanos(); ///< returns the frame time in nanoseconds.  Not threadsafe
   static CDateTime GetLocalTime(time_t time);
 
 private:
-  static unsigned int frameTime;
+  static uint64_t frameTime;
 };
 
@@ -0,0 +1,240 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Trace.h"
+
+#include <inttypes.h>
+#include <memory>
+#include <vector>
+
+#include "filesystem/File.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#define TRACE_MAX_EVENTS 2000000 // about 150MB, events beyond are dropped
+
+std::atomic<bool> CTrace::m_running(false);
+
+namespace
+{
+struct TraceEvent
+{
+  char phase;            // 'X' span, 'C' counter, 's'/'f' flow begin/end
+  const char *category;
+  const char *name;
+  int64_t ts;
+  int64_t value;         // duration, counter value or flow id
+  std::string args;
+};
+
+// events of one thread, the lock is only contended while Stop() collects them
+struct CTraceBuffer
+{
+  CCriticalSection section;
+  std::vector<TraceEvent> events;
+  uint64_t threadId;
+  std::string threadName;
+};
+
+CCriticalSection g_traceSection;
+std::vector<std::shared_ptr<CTraceBuffer>> g_traceBuffers;
+std::string g_traceFile;
+std::atomic<unsigned int> g_traceEvents(0);
+std::atomic<unsigned int> g_traceDropped(0);
+thread_local std::shared_ptr<CTraceBuffer> t_traceBuffer;
+
+void AddEvent(char phase, const char *category, const char *name, int64_t ts, int64_t value, const std::string &args)
+{
+  if (g_traceEvents++ >= TRACE_MAX_EVENTS)
+  {
+    g_traceDropped++;
+    return;
+  }
+
+  if (!t_traceBuffer)
+  {
+    std::shared_ptr<CTraceBuffer> buffer = std::make_shared<CTraceBuffer>();
+    buffer->threadId = CThread::GetCurrentThreadId();
+    CThread *thread = CThread::GetCurrentThread();
+    buffer->threadName = thread ? thread->GetThreadName() : StringUtils::Format("%" PRIu64, buffer->threadId);
+
+    CSingleLock lock(g_traceSection);
+    g_traceBuffers.push_back(buffer);
+    t_traceBuffer = buffer;
+  }
+
+  TraceEvent event = { phase, category, name, ts, value, args };
+  CSingleLock lock(t_traceBuffer->section);
+  t_traceBuffer->events.push_back(std::move(event));
+}
+
+std::string Escape(const std::string &str)
+{
+  std::string escaped;
+  escaped.reserve(str.size());
+  for (std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+  {
+    if (*it == '"' || *it == '\\')
+    {
+      escaped += '\\';
+      escaped += *it;
+    }
+    else if (static_cast<unsigned char>(*it) < 0x20)
+      escaped += StringUtils::Format("\\u%04x", static_cast<unsigned char>(*it));
+    else
+      escaped += *it;
+  }
+  return escaped;
+}
+
+// StringUtils::Format() would take the braces of JSON for fmt fields, so concatenate
+std::string ToJson(const TraceEvent &event, uint64_t threadId)
+{
+  std::string json = "{\"ph\":\"";
+  json += event.phase;
+  json += "\",\"name\":\"" + Escape(event.name) + "\",\"ts\":" + std::to_string(event.ts) +
+          ",\"pid\":1,\"tid\":" + std::to_string(threadId);
+  switch (event.phase)
+  {
+  case 'X':
+    json += ",\"cat\":\"" + Escape(event.category) + "\",\"dur\":" + std::to_string(event.value);
+    if (!event.args.empty())
+      json += ",\"args\":{\"detail\":\"" + Escape(event.args) + "\"}";
+    break;
+  case 'C':
+    json += ",\"args\":{\"value\":" + std::to_string(event.value) + "}";
+    break;
+  case 's':
+  case 'f':
+    json += ",\"cat\":\"flow\",\"id\":" + std::to_string(event.value);
+    break;
+  }
+  return json + "}";
+}
+}
+
+void CTrace::Start(const std::string &file)
+{
+  CSingleLock lock(g_traceSection);
+  for (std::vector<std::shared_ptr<CTraceBuffer>>::iterator it = g_traceBuffers.begin(); it != g_traceBuffers.end(); ++it)
+  {
+    CSingleLock bufferLock((*it)->section);
+    (*it)->events.clear();
+  }
+  g_traceFile = file;
+  g_traceEvents = 0;
+  g_traceDropped = 0;
+  m_running = true;
+  CLog::Log(LOGNOTICE, "CTrace: started tracing to %s", file.c_str());
+}
+
+bool CTrace::Stop()
+{
+  CSingleLock lock(g_traceSection);
+  if (!m_running)
+    return false;
+  m_running = false;
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(g_traceFile, true))
+  {
+    CLog::Log(LOGERROR, "CTrace: unable to write %s", g_traceFile.c_str());
+    return false;
+  }
+
+  std::string json = "{\"traceEvents\":[\n";
+  bool first = true;
+  unsigned int count = 0;
+  for (std::vector<std::shared_ptr<CTraceBuffer>>::iterator it = g_traceBuffers.begin(); it != g_traceBuffers.end(); ++it)
+  {
+    std::vector<TraceEvent> events;
+    {
+      CSingleLock bufferLock((*it)->section);
+      events.swap((*it)->events);
+    }
+    if (events.empty())
+      continue;
+
+    if (!first)
+      json += ",\n";
+    first = false;
+    json += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + std::to_string((*it)->threadId) +
+            ",\"args\":{\"name\":\"" + Escape((*it)->threadName) + "\"}}";
+    for (std::vector<TraceEvent>::const_iterator event = events.begin(); event != events.end(); ++event)
+    {
+      json += ",\n" + ToJson(*event, (*it)->threadId);
+      // write in pieces instead of keeping the whole trace twice
+      if (json.size() > 1024 * 1024)
+      {
+        file.Write(json.c_str(), json.size());
+        json.clear();
+      }
+    }
+    count += events.size();
+  }
+  json += "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":" + std::to_string(g_traceDropped.load()) + "}}\n";
+  bool success = file.Write(json.c_str(), json.size()) == static_cast<ssize_t>(json.size());
+  file.Close();
+
+  // forget the buffers of threads that are gone
+  for (std::vector<std::shared_ptr<CTraceBuffer>>::iterator it = g_traceBuffers.begin(); it != g_traceBuffers.end();)
+  {
+    if (it->use_count() == 1)
+      it = g_traceBuffers.erase(it);
+    else
+      ++it;
+  }
+
+  CLog::Log(LOGNOTICE, "CTrace: wrote %u events to %s, dropped %u", count, g_traceFile.c_str(), g_traceDropped.load());
+  return success;
+}
+
+int64_t CTrace::Now()
+{
+  return static_cast<int64_t>(XbmcThreads::SystemClockNanos() / 1000);
+}
+
+void CTrace::Span(const char *category, const char *name, int64_t start, const std::string &args)
+{
+  if (IsRunning())
+    AddEvent('X', category, name, start, Now() - start, args);
+}
+
+void CTrace::Counter(const char *name, int64_t value)
+{
+  if (IsRunning())
+    AddEvent('C', "counter", name, Now(), value, std::string());
+}
+
+void CTrace::FlowBegin(const char *name, uint64_t id)
+{
+  if (IsRunning())
+    AddEvent('s', "flow", name, Now(), static_cast<int64_t>(id), std::string());
+}
+
+void CTrace::FlowEnd(const char *name, uint64_t id)
+{
+  if (IsRunning())
+    AddEvent('f', "flow", name, Now(), static_cast<int64_t>(id), std::string());
+}
@@ -0,0 +1,119 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+/*!
+ \brief Records spans, counters and flows of all threads while running and
+ writes them as Chrome trace event JSON, which chrome://tracing and the
+ Perfetto UI open.
+
+ While not running, every call returns after checking one flag. Category and
+ name have to be string literals (or otherwise outlive the trace), anything
+ that changes goes into args, which is copied.
+ */
+class CTrace
+{
+public:
+  /*!
+   \brief Start recording, dropping what was recorded before.
+   \param file the file Stop() writes the trace to.
+   */
+  static void Start(const std::string &file);
+
+  /*!
+   \brief Stop recording and write the trace to the file given to Start().
+   \return true if the file was written, false if not running or on errors.
+   */
+  static bool Stop();
+
+  static bool IsRunning() { return m_running.load(std::memory_order_relaxed); }
+
+  /*!
+   \brief Time in microseconds, as used for the events.
+   */
+  static int64_t Now();
+
+  /*!
+   \brief A span of the calling thread that started at start and ends now.
+   \sa CTraceScope
+   */
+  static void Span(const char *category, const char *name, int64_t start, const std::string &args = "");
+
+  /*!
+   \brief The value of a counter, shown as a graph over time.
+   */
+  static void Counter(const char *name, int64_t value);
+
+  /*!
+   \brief An arrow from the enclosing span of this thread to the next span
+   that starts after FlowEnd() with the same name and id, on any thread.
+   */
+  static void FlowBegin(const char *name, uint64_t id);
+  static void FlowEnd(const char *name, uint64_t id);
+
+private:
+  static std::atomic<bool> m_running;
+};
+
+/*!
+ \brief Records a span from construction to destruction while tracing.
+ */
+class CTraceScope
+{
+public:
+  CTraceScope(const char *category, const char *name)
+  {
+    if (CTrace::IsRunning())
+    {
+      m_category = category;
+      m_name = name;
+      m_start = CTrace::Now();
+    }
+  }
+
+  /*!
+   \param args details of this span, only copied while tracing.
+   */
+  CTraceScope(const char *category, const char *name, const char *args)
+    : CTraceScope(category, name)
+  {
+    if (m_name && args)
+      m_args = args;
+  }
+
+  ~CTraceScope()
+  {
+    if (m_name)
+      CTrace::Span(m_category, m_name, m_start, m_args);
+  }
+
+  CTraceScope(const CTraceScope&) = delete;
+  CTraceScope& operator=(const CTraceScope&) = delete;
+
+private:
+  const char *m_category = nullptr;
+  const char *m_name = nullptr;
+  int64_t m_start = 0;
+  std::string m_args;
+};
@@ -43,6 +43,24 @@
 
 using namespace XFILE;
 
+namespace
+{
+// Same as URIUtils::HasParentInHostname() for the protocol at the start of the
+// path, so checking the protocol of a path doesn't need to parse all of it. A
+// local path into an archive is turned into one by CURL, but embeds a local
+// path only.
+bool IsParentInHostnameProtocol(const std::string& path)
+{
+  return URIUtils::IsProtocol(path, "zip")
+      || URIUtils::IsProtocol(path, "rar")
+      || URIUtils::IsProtocol(path, "archive")
+      || URIUtils::IsProtocol(path, "apk")
+      || URIUtils::IsProtocol(path, "bluray")
+      || URIUtils::IsProtocol(path, "udf")
+      || URIUtils::IsProtocol(path, "xbt");
+}
+}
+
 /* returns filename extension including period of filename */
 std::string URIUtils::GetExtension(const CURL& url)
 {
@@ -528,7 +546,9 @@ std::string URIUtils::SubstitutePath(const std::string& strPath, bool reverse /*
 
 bool URIUtils::IsProtocol(const std::string& url, const std::string &type)
 {
-  return StringUtils::StartsWithNoCase(url, type + "://");
+  // compared in place, this is called far too often to build type + "://"
+  return StringUtils::StartsWithNoCase(url, type.c_str()) &&
+         url.compare(type.size(), 3, "://") == 0;
 }
 
 bool URIUtils::PathHasParent(std::string path, std::string parent, bool translate /* = false */)
@@ -834,26 +854,22 @@ bool URIUtils::IsSpecial(const std::string& strFile)
 
 bool URIUtils::IsPlugin(const std::string& strFile)
 {
-  CURL url(strFile);
-  return url.IsProtocol("plugin");
+  return IsProtocol(strFile, "plugin");
 }
 
 bool URIUtils::IsScript(const std::string& strFile)
 {
-  CURL url(strFile);
-  return url.IsProtocol("script");
+  return IsProtocol(strFile, "script");
 }
 
 bool URIUtils::IsAddonsPath(const std::string& strFile)
 {
-  CURL url(strFile);
-  return url.IsProtocol("addons");
+  return IsProtocol(strFile, "addons");
 }
 
 bool URIUtils::IsSourcesPath(const std::string& strPath)
 {
-  CURL url(strPath);
-  return url.IsProtocol("sources");
+  return IsProtocol(strPath, "sources");
 }
 
 bool URIUtils::IsCDDA(const std::string& strFile)
@@ -874,9 +890,8 @@ bool URIUtils::IsSmb(const std::string& strFile)
   if (IsSpecial(strFile))
     return IsSmb(CSpecialProtocol::TranslatePath(strFile));
 
-  CURL url(strFile);
-  if (HasParentInHostname(url))
-    return IsSmb(url.GetHostName());
+  if (IsParentInHostnameProtocol(strFile))
+    return IsSmb(CURL(strFile).GetHostName());
 
   return IsProtocol(strFile, "smb");
 }
@@ -894,9 +909,8 @@ bool URIUtils::IsFTP(const std::string& strFile)
   if (IsSpecial(strFile))
     return IsFTP(CSpecialProtocol::TranslatePath(strFile));
 
-  CURL url(strFile);
-  if (HasParentInHostname(url))
-    return IsFTP(url.GetHostName());
+  if (IsParentInHostnameProtocol(strFile))
+    return IsFTP(CURL(strFile).GetHostName());
 
   return IsProtocol(strFile, "ftp") ||
          IsProtocol(strFile, "ftps");
@@ -910,9 +924,8 @@ bool URIUtils::IsHTTP(const std::string& strFile)
   if (IsSpecial(strFile))
     return IsHTTP(CSpecialProtocol::TranslatePath(strFile));
 
-  CURL url(strFile);
-  if (HasParentInHostname(url))
-    return IsHTTP(url.GetHostName());
+  if (IsParentInHostnameProtocol(strFile))
+    return IsHTTP(CURL(strFile).GetHostName());
 
   return IsProtocol(strFile, "http") ||
          IsProtocol(strFile, "https");
@@ -958,16 +971,19 @@ bool URIUtils::IsDAV(const std::string& strFile)
   if (IsSpecial(strFile))
     return IsDAV(CSpecialProtocol::TranslatePath(strFile));
 
-  CURL url(strFile);
-  if (HasParentInHostname(url))
-    return IsDAV(url.GetHostName());
-  
+  if (IsParentInHostnameProtocol(strFile))
+    return IsDAV(CURL(strFile).GetHostName());
+
   return IsProtocol(strFile, "dav") ||
          IsProtocol(strFile, "davs");
 }
 
 bool URIUtils::IsInternetStream(const std::string &path, bool bStrictCheck /* = false */)
 {
+  // local paths have no protocol, or one of an archive if they point into it
+  if (path.find(':') == std::string::npos)
+    return false;
+
   const CURL pathToUrl(path);
   return IsInternetStream(pathToUrl, bStrictCheck);
 }
@@ -156,7 +156,7 @@ CVariant::CVariant(VariantType type)
       m_data.dvalue = 0.0;
       break;
     case VariantTypeString:
-      m_data.string = new std::string();
+      setString("", 0);
       break;
     case VariantTypeWideString:
       m_data.wstring = new std::wstring();
@@ -220,25 +220,25 @@ CVariant::CVariant(bool boolean)
 CVariant::CVariant(const char *str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  setString(str, strlen(str));
 }
 
 CVariant::CVariant(const char *str, unsigned int length)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str, length);
+  setString(str, length);
 }
 
 CVariant::CVariant(const std::string &str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  setString(str.c_str(), str.size());
 }
 
 CVariant::CVariant(std::string &&str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(std::move(str));
+  setString(std::move(str));
 }
 
 CVariant::CVariant(const wchar_t *str)
@@ -313,8 +313,11 @@ void CVariant::cleanup()
   switch (m_type)
   {
   case VariantTypeString:
-    delete m_data.string;
-    m_data.string = nullptr;
+    if (!isShortString())
+    {
+      delete m_data.string;
+      m_data.string = nullptr;
+    }
     break;
 
   case VariantTypeWideString:
@@ -337,6 +340,42 @@ void CVariant::cleanup()
   m_type = VariantTypeNull;
 }
 
+void CVariant::setString(const char *str, size_t length)
+{
+  if (length <= SHORT_STRING_MAX)
+  {
+    memcpy(m_data.shortString.data, str, length);
+    m_data.shortString.data[length] = '\0';
+    m_data.shortString.length = static_cast<uint8_t>(length);
+  }
+  else
+  {
+    m_data.string = new std::string(str, length);
+    m_data.shortString.length = LONG_STRING;
+  }
+}
+
+void CVariant::setString(std::string &&str)
+{
+  if (str.size() <= SHORT_STRING_MAX)
+    setString(str.c_str(), str.size());
+  else
+  {
+    m_data.string = new std::string(std::move(str));
+    m_data.shortString.length = LONG_STRING;
+  }
+}
+
+const char *CVariant::stringData() const
+{
+  return isShortString() ? m_data.shortString.data : m_data.string->c_str();
+}
+
+size_t CVariant::stringLength() const
+{
+  return isShortString() ? m_data.shortString.length : m_data.string->size();
+}
+
 bool CVariant::isInteger() const
 {
   return isSignedInteger() || isUnsignedInteger();
@@ -403,7 +442,7 @@ int64_t CVariant::asInteger(int64_t fallback) const
     case VariantTypeDouble:
       return (int64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2int64(*m_data.string, fallback);
+      return str2int64(std::string(stringData(), stringLength()), fallback);
     case VariantTypeWideString:
       return str2int64(*m_data.wstring, fallback);
     default:
@@ -429,7 +468,7 @@ uint64_t CVariant::asUnsignedInteger(uint64_t fallback) const
     case VariantTypeDouble:
       return (uint64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2uint64(*m_data.string, fallback);
+      return str2uint64(std::string(stringData(), stringLength()), fallback);
     case VariantTypeWideString:
       return str2uint64(*m_data.wstring, fallback);
     default:
@@ -455,7 +494,7 @@ double CVariant::asDouble(double fallback) const
     case VariantTypeUnsignedInteger:
       return (double)m_data.unsignedinteger;
     case VariantTypeString:
-      return str2double(*m_data.string, fallback);
+      return str2double(std::string(stringData(), stringLength()), fallback);
     case VariantTypeWideString:
       return str2double(*m_data.wstring, fallback);
     default:
@@ -476,7 +515,7 @@ float CVariant::asFloat(float fallback) const
     case VariantTypeUnsignedInteger:
       return (float)m_data.unsignedinteger;
     case VariantTypeString:
-      return (float)str2double(*m_data.string, fallback);
+      return (float)str2double(std::string(stringData(), stringLength()), fallback);
     case VariantTypeWideString:
       return (float)str2double(*m_data.wstring, fallback);
     default:
@@ -499,7 +538,8 @@ bool CVariant::asBoolean(bool fallback) const
     case VariantTypeDouble:
       return (m_data.dvalue != 0);
     case VariantTypeString:
-      if (m_data.string->empty() || m_data.string->compare("0") == 0 || m_data.string->compare("false") == 0)
+      if (stringLength() == 0 || (stringLength() == 1 && stringData()[0] == '0') ||
+          (stringLength() == 5 && memcmp(stringData(), "false", 5) == 0))
         return false;
       return true;
     case VariantTypeWideString:
@@ -518,6 +558,8 @@ std::string CVariant::asString(const std::string &fallback /* = "" */) const
   switch (m_type)
   {
     case VariantTypeString:
+      if (isShortString())
+        return std::string(m_data.shortString.data, m_data.shortString.length);
       return *m_data.string;
     case VariantTypeBoolean:
       return m_data.boolean ? "true" : "false";
@@ -618,7 +660,10 @@ CVariant &CVariant::operator=(const CVariant &rhs)
     m_data.dvalue = rhs.m_data.dvalue;
     break;
   case VariantTypeString:
-    m_data.string = new std::string(*rhs.m_data.string);
+    if (rhs.isShortString())
+      m_data.shortString = rhs.m_data.shortString;
+    else
+      setString(rhs.m_data.string->c_str(), rhs.m_data.string->size());
     break;
   case VariantTypeWideString:
     m_data.wstring = new std::wstring(*rhs.m_data.wstring);
@@ -651,7 +696,10 @@ CVariant& CVariant::operator=(CVariant&& rhs)
   //Should be enough to just set m_type here
   //but better safe than sorry, could probably lead to coverity warnings
   if (rhs.m_type == VariantTypeString)
-    rhs.m_data.string = nullptr;
+  {
+    if (!rhs.isShortString())
+      rhs.m_data.string = nullptr;
+  }
   else if (rhs.m_type == VariantTypeWideString)
     rhs.m_data.wstring = nullptr;
   else if (rhs.m_type == VariantTypeArray)
@@ -679,7 +727,8 @@ bool CVariant::operator==(const CVariant &rhs) const
     case VariantTypeDouble:
       return m_data.dvalue == rhs.m_data.dvalue;
     case VariantTypeString:
-      return *m_data.string == *rhs.m_data.string;
+      return stringLength() == rhs.stringLength() &&
+             memcmp(stringData(), rhs.stringData(), stringLength()) == 0;
     case VariantTypeWideString:
       return *m_data.wstring == *rhs.m_data.wstring;
     case VariantTypeArray:
@@ -731,7 +780,7 @@ void CVariant::append(CVariant&& variant)
 const char *CVariant::c_str() const
 {
   if (m_type == VariantTypeString)
-    return m_data.string->c_str();
+    return stringData();
   else
     return NULL;
 }
@@ -819,7 +868,7 @@ unsigned int CVariant::size() const
   else if (m_type == VariantTypeArray)
     return m_data.array->size();
   else if (m_type == VariantTypeString)
-    return m_data.string->size();
+    return stringLength();
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->size();
   else
@@ -833,7 +882,7 @@ bool CVariant::empty() const
   else if (m_type == VariantTypeArray)
     return m_data.array->empty();
   else if (m_type == VariantTypeString)
-    return m_data.string->empty();
+    return stringLength() == 0;
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->empty();
   else if (m_type == VariantTypeNull)
@@ -849,7 +898,11 @@ void CVariant::clear()
   else if (m_type == VariantTypeArray)
     m_data.array->clear();
   else if (m_type == VariantTypeString)
-    m_data.string->clear();
+  {
+    cleanup();
+    m_type = VariantTypeString;
+    setString("", 0);
+  }
   else if (m_type == VariantTypeWideString)
     m_data.wstring->clear();
 }
@@ -154,6 +154,26 @@ public:
 
 private:
   void cleanup();
+  void setString(const char *str, size_t length);
+  void setString(std::string &&str);
+  bool isShortString() const { return m_data.shortString.length != LONG_STRING; }
+  const char *stringData() const;
+  size_t stringLength() const;
+
+  /*!
+   Strings up to SHORT_STRING_MAX characters are kept in the variant itself, most strings of
+   JSON-RPC responses and list item properties are that short. Longer ones are allocated, in
+   which case the length byte is set to LONG_STRING.
+   */
+  static const uint8_t SHORT_STRING_MAX = 14;
+  static const uint8_t LONG_STRING = 0xFF;
+
+  struct ShortString
+  {
+    char data[SHORT_STRING_MAX + 1];
+    uint8_t length;
+  };
+
   union VariantUnion
   {
     int64_t integer;
@@ -164,6 +184,7 @@ private:
     std::wstring *wstring;
     VariantArray *array;
     VariantMap *map;
+    ShortString shortString;
   };
 
   VariantType m_type;
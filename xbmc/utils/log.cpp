@@ -22,10 +22,16 @@
 #include "CompileInfo.h"
 #include "settings/AdvancedSettings.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "threads/SingleLock.h"
+#include "threads/SPSCQueue.h"
 #include "threads/Thread.h"
 #include "utils/StringUtils.h"
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 #if defined(TARGET_POSIX)
 #include "platform/posix/utils/PosixInterfaceForCLog.h"
 typedef class CPosixInterfaceForCLog PlatformInterfaceForCLog;
@@ -34,6 +40,8 @@ typedef class CPosixInterfaceForCLog PlatformInterfaceForCLog;
 typedef class CWin32InterfaceForCLog PlatformInterfaceForCLog;
 #endif
 
+#define LOG_RING_SIZE       512  // lines a thread may have queued for the writer
+#define LOG_WRITER_INTERVAL 100  // ms between the writes of queued lines
 
 static const char* const levelNames[] =
 {"DEBUG", "INFO", "NOTICE", "WARNING", "ERROR", "SEVERE", "FATAL", "NONE"};
@@ -44,11 +52,66 @@ static const char* const logLevelNames[] =
 
 namespace
 {
+struct LogRecord
+{
+  int         level = 0;
+  uint64_t    sequence = 0;
+  uint64_t    threadId = 0;
+  int         hour = 0;
+  int         minute = 0;
+  int         second = 0;
+  int         millisecond = 0;
+  std::string line;
+};
+
+/*!
+ \brief Lines logged by one thread, waiting to be written by the log writer thread.
+ The thread is the only producer, consumers hold CLogGlobals::critSec.
+ */
+struct CLogRing
+{
+  CLogRing() : queue(LOG_RING_SIZE), dropped(0), threadId(CThread::GetCurrentThreadId()) {}
+  XbmcThreads::CSPSCQueue<LogRecord> queue;
+  std::atomic<unsigned int> dropped;
+  uint64_t threadId;
+};
+
+class CLogWriter : public CThread
+{
+public:
+  CLogWriter() : CThread("LogWriter") {}
+  void Wake() { m_wakeEvent.Set(); }
+  void Stop()
+  {
+    m_bStop = true;
+    m_wakeEvent.Set();
+    StopThread();
+  }
+
+protected:
+  void Process() override
+  {
+    while (!m_bStop)
+    {
+      m_wakeEvent.WaitMSec(LOG_WRITER_INTERVAL);
+      CLog::Flush();
+    }
+    CLog::Flush();
+  }
+
+private:
+  CEvent m_wakeEvent;
+};
+
 class CLogGlobals
 {
 public:
-  CLogGlobals(void) : m_repeatCount(0), m_repeatLogLevel(-1), m_logLevel(LOG_LEVEL_DEBUG), m_extraLogLevels(0) {}
-  ~CLogGlobals() = default;
+  CLogGlobals(void) : m_repeatCount(0), m_repeatLogLevel(-1), m_logLevel(LOG_LEVEL_DEBUG), m_extraLogLevels(0), m_async(false), m_sequence(0) {}
+  ~CLogGlobals()
+  {
+    m_async = false;
+    m_writer.Stop();
+  }
   PlatformInterfaceForCLog m_platform;
   int         m_repeatCount;
   int         m_repeatLogLevel;
@@ -56,9 +119,87 @@ public:
   int         m_logLevel;
   int         m_extraLogLevels;
   CCriticalSection critSec;
+
+  std::atomic<bool> m_async;      ///< lines are queued for m_writer instead of written by the logging thread
+  std::atomic<uint64_t> m_sequence;
+  CCriticalSection m_ringSection; ///< guards m_rings
+  std::vector<std::shared_ptr<CLogRing>> m_rings;
+  CLogWriter  m_writer;
 };
 
 static CLogGlobals g_logState;
+static thread_local std::shared_ptr<CLogRing> t_logRing;
+
+void FillRecord(LogRecord &record, int logLevel)
+{
+  double millisecond;
+  PlatformInterfaceForCLog::GetCurrentLocalTime(record.hour, record.minute, record.second, millisecond);
+  record.millisecond = static_cast<int>(millisecond);
+  record.level = logLevel;
+  record.threadId = CThread::GetCurrentThreadId();
+}
+
+bool WriteLogString(const LogRecord &record, const std::string &logString)
+{
+  static const char* prefixFormat = "%02d:%02d:%02d.%03d T:%" PRIu64" %7s: ";
+
+  std::string strData(logString);
+  /* fixup newline alignment, number of spaces should equal prefix length */
+  StringUtils::Replace(strData, "\n", "\n                                            ");
+
+  strData = StringUtils::Format(prefixFormat,
+                                  record.hour,
+                                  record.minute,
+                                  record.second,
+                                  record.millisecond,
+                                  record.threadId,
+                                  levelNames[record.level]) + strData;
+
+  return g_logState.m_platform.WriteStringToLog(strData);
+}
+
+// called with g_logState.critSec held
+void WriteRecord(const LogRecord &record)
+{
+  std::string strData(record.line);
+  StringUtils::TrimRight(strData);
+  if (strData.empty())
+    return;
+
+  if (g_logState.m_repeatLogLevel == record.level && g_logState.m_repeatLine == strData)
+  {
+    g_logState.m_repeatCount++;
+    return;
+  }
+  else if (g_logState.m_repeatCount)
+  {
+    std::string strData2 = StringUtils::Format("Previous line repeats %d times.",
+                                              g_logState.m_repeatCount);
+    CLog::PrintDebugString(strData2);
+    LogRecord repeat(record);
+    repeat.level = g_logState.m_repeatLogLevel;
+    WriteLogString(repeat, strData2);
+    g_logState.m_repeatCount = 0;
+  }
+
+  g_logState.m_repeatLine = strData;
+  g_logState.m_repeatLogLevel = record.level;
+
+  CLog::PrintDebugString(strData);
+
+  WriteLogString(record, strData);
+}
+
+CLogRing& GetLogRing()
+{
+  if (!t_logRing)
+  {
+    t_logRing = std::make_shared<CLogRing>();
+    CSingleLock lock(g_logState.m_ringSection);
+    g_logState.m_rings.push_back(t_logRing);
+  }
+  return *t_logRing;
+}
 }
 
 CLog::CLog() = default;
@@ -67,45 +208,88 @@ CLog::~CLog() = default;
 
 void CLog::Close()
 {
+  // write what is still queued, the following lines are written directly
+  g_logState.m_async = false;
+  g_logState.m_writer.Stop();
+
   CSingleLock waitLock(g_logState.critSec);
+  Flush();
   g_logState.m_platform.CloseLogFile();
   g_logState.m_repeatLine.clear();
 }
 
 void CLog::LogString(int logLevel, std::string&& logString)
 {
+  LogRecord record;
+  FillRecord(record, logLevel);
+  record.line = std::move(logString);
+
+  if (g_logState.m_async)
+  {
+    // queue the line for the writer thread, so the calling thread doesn't wait for the file
+    record.sequence = g_logState.m_sequence++;
+    CLogRing &ring = GetLogRing();
+    if (!ring.queue.Push(std::move(record)))
+      ring.dropped++;
+
+    // make sure whatever leads to a crash ends up in the file
+    if ((logLevel & LOGMASK) >= LOGSEVERE)
+      Flush();
+    else if (ring.queue.Size() >= ring.queue.Capacity() / 2)
+      g_logState.m_writer.Wake();
+    return;
+  }
+
   CSingleLock waitLock(g_logState.critSec);
-  std::string strData(logString);
-  StringUtils::TrimRight(strData);
-  if (!strData.empty())
+  WriteRecord(record);
+}
+
+void CLog::Flush()
+{
+  std::vector<std::shared_ptr<CLogRing>> rings;
   {
-    if (g_logState.m_repeatLogLevel == logLevel && g_logState.m_repeatLine == strData)
-    {
-      g_logState.m_repeatCount++;
-      return;
-    }
-    else if (g_logState.m_repeatCount)
-    {
-      std::string strData2 = StringUtils::Format("Previous line repeats %d times.",
-                                                g_logState.m_repeatCount);
-      PrintDebugString(strData2);
-      WriteLogString(g_logState.m_repeatLogLevel, strData2);
-      g_logState.m_repeatCount = 0;
-    }
+    CSingleLock lock(g_logState.m_ringSection);
+    // forget the rings of threads that are gone once they are written
+    g_logState.m_rings.erase(std::remove_if(g_logState.m_rings.begin(), g_logState.m_rings.end(),
+                                            [](const std::shared_ptr<CLogRing>& ring)
+                                            {
+                                              return ring.use_count() == 1 && ring->queue.Empty() && !ring->dropped;
+                                            }),
+                             g_logState.m_rings.end());
+    rings = g_logState.m_rings;
+  }
+
+  CSingleLock waitLock(g_logState.critSec);
 
-    g_logState.m_repeatLine = strData;
-    g_logState.m_repeatLogLevel = logLevel;
+  // merge the lines of all threads in the order they were logged
+  std::vector<LogRecord> records;
+  std::vector<std::pair<uint64_t, unsigned int>> dropped;
+  for (std::vector<std::shared_ptr<CLogRing>>::const_iterator it = rings.begin(); it != rings.end(); ++it)
+  {
+    LogRecord record;
+    while ((*it)->queue.Pop(record))
+      records.push_back(std::move(record));
+    unsigned int count = (*it)->dropped.exchange(0);
+    if (count)
+      dropped.push_back(std::make_pair((*it)->threadId, count));
+  }
+  std::sort(records.begin(), records.end(), [](const LogRecord& a, const LogRecord& b) { return a.sequence < b.sequence; });
 
-    PrintDebugString(strData);
+  for (std::vector<LogRecord>::const_iterator it = records.begin(); it != records.end(); ++it)
+    WriteRecord(*it);
 
-    WriteLogString(logLevel, strData);
+  for (std::vector<std::pair<uint64_t, unsigned int>>::const_iterator it = dropped.begin(); it != dropped.end(); ++it)
+  {
+    LogRecord record;
+    FillRecord(record, LOGWARNING);
+    record.line = StringUtils::Format("Dropped %u lines of thread %" PRIu64" as the log writer fell behind", it->second, it->first);
+    WriteRecord(record);
   }
 }
 
-void CLog::LogString(int logLevel, int component, std::string&& logString)
+bool CLog::CanLogComponent(int component)
 {
-  if (g_advancedSettings.CanLogComponent(component) && IsLogLevelLogged(logLevel))
-    LogString(logLevel, std::move(logString));
+  return g_advancedSettings.CanLogComponent(component);
 }
 
 bool CLog::Init(const std::string& path)
@@ -117,7 +301,14 @@ bool CLog::Init(const std::string& path)
 
   std::string appName = CCompileInfo::GetAppName();
   StringUtils::ToLower(appName);
-  return g_logState.m_platform.OpenLogFile(path + appName + ".log", path + appName + ".old.log");
+  if (!g_logState.m_platform.OpenLogFile(path + appName + ".log", path + appName + ".old.log"))
+    return false;
+
+  // from now on lines are written by the log writer thread
+  if (!g_logState.m_writer.IsRunning())
+    g_logState.m_writer.Create();
+  g_logState.m_async = true;
+  return true;
 }
 
 void CLog::MemDump(char *pData, int length)
@@ -196,26 +387,3 @@ void CLog::PrintDebugString(const std::string& line)
   g_logState.m_platform.PrintDebugString(line);
 #endif // defined(_DEBUG) || defined(PROFILE)
 }
-
-bool CLog::WriteLogString(int logLevel, const std::string& logString)
-{
-  static const char* prefixFormat = "%02d:%02d:%02d.%03d T:%" PRIu64" %7s: ";
-
-  std::string strData(logString);
-  /* fixup newline alignment, number of spaces should equal prefix length */
-  StringUtils::Replace(strData, "\n", "\n                                            ");
-
-  int hour, minute, second;
-  double millisecond;
-  g_logState.m_platform.GetCurrentLocalTime(hour, minute, second, millisecond);
-
-  strData = StringUtils::Format(prefixFormat,
-                                  hour,
-                                  minute,
-                                  second,
-                                  static_cast<int>(millisecond),
-                                  (uint64_t)CThread::GetCurrentThreadId(),
-                                  levelNames[logLevel]) + strData;
-
-  return g_logState.m_platform.WriteStringToLog(strData);
-}
@@ -51,17 +51,15 @@ public:
 
   static void Log(int loglevel, int component, const char* format)
   {
-    if (IsLogLevelLogged(loglevel))
-      LogString(loglevel, component, format);
+    if (IsLogLevelLogged(loglevel) && CanLogComponent(component))
+      LogString(loglevel, format);
   }
 
   template<typename... Args>
   static void Log(int loglevel, int component, const char* format, Args&&... args)
   {
-    // We defer component checking to LogString to avoid having to drag in advancedsettings
-    // everywhere we want to log anything
-    if (IsLogLevelLogged(loglevel))
-      LogString(loglevel, component, StringUtils::Format(format, std::forward<Args>(args)...));
+    if (IsLogLevelLogged(loglevel) && CanLogComponent(component))
+      LogString(loglevel, StringUtils::Format(format, std::forward<Args>(args)...));
   }
 
   static void LogFunction(int loglevel, std::string functionName, const char* format)
@@ -85,35 +83,33 @@ public:
 
   static void LogFunction(int loglevel, std::string functionName, int component, const char* format)
   {
-    if (IsLogLevelLogged(loglevel))
-      LogString(loglevel, component, functionName + ": " + format);
+    if (IsLogLevelLogged(loglevel) && CanLogComponent(component))
+      LogString(loglevel, functionName + ": " + format);
   }
 
   template<typename... Args>
   static void LogFunction(
       int loglevel, std::string functionName, int component, const char* format, Args&&... args)
   {
-    // We defer component checking to LogString to avoid having to drag in advancedsettings
-    // everywhere we want to log anything
-    if (IsLogLevelLogged(loglevel))
+    if (IsLogLevelLogged(loglevel) && CanLogComponent(component))
     {
       functionName.append(": ");
-      LogString(loglevel, component,
-                functionName + StringUtils::Format(format, std::forward<Args>(args)...));
+      LogString(loglevel, functionName + StringUtils::Format(format, std::forward<Args>(args)...));
     }
   }
 #define LogF(loglevel, ...) LogFunction((loglevel), __FUNCTION__, ##__VA_ARGS__)
 #define LogFC(loglevel, component, ...) LogFunction((loglevel), __FUNCTION__, (component), ##__VA_ARGS__)
   static void MemDump(char *pData, int length);
   static bool Init(const std::string& path);
+  /*! \brief Write the lines that were logged but are still queued for the log writer thread */
+  static void Flush();
   static void PrintDebugString(const std::string& line); // universal interface for printing debug strings
   static void SetLogLevel(int level);
   static int  GetLogLevel();
   static void SetExtraLogLevels(int level);
   static bool IsLogLevelLogged(int loglevel);
+  static bool CanLogComponent(int component); // defined in log.cpp, to not drag in advancedsettings everywhere
 
 protected:
   static void LogString(int logLevel, std::string&& logString);
-  static void LogString(int logLevel, int component, std::string&& logString);
-  static bool WriteLogString(int logLevel, const std::string& logString);
 };
\ No newline at end of file
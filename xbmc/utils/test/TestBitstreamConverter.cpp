@@ -0,0 +1,90 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/BitstreamConverter.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+// avcC with 4 byte NAL sizes, one sps and one pps
+uint8_t avcC[] = { 0x01, 0x42, 0x00, 0x1e, 0xff,
+                   0xe1, 0x00, 0x04, 0x67, 0x42, 0x00, 0x1e,
+                   0x01, 0x00, 0x04, 0x68, 0xce, 0x38, 0x80 };
+
+uint8_t idrPacket[] = { 0x00, 0x00, 0x00, 0x03, 0x65, 0x88, 0x84 };
+
+uint8_t slicePacket[] = { 0x00, 0x00, 0x00, 0x03, 0x41, 0x9a, 0x02,
+                          0x00, 0x00, 0x00, 0x02, 0x41, 0x9b };
+
+const std::vector<uint8_t> idrAnnexB = { 0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0x00, 0x1e,
+                                         0x00, 0x00, 0x00, 0x01, 0x68, 0xce, 0x38, 0x80,
+                                         0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84 };
+
+const std::vector<uint8_t> sliceAnnexB = { 0x00, 0x00, 0x00, 0x01, 0x41, 0x9a, 0x02,
+                                           0x00, 0x00, 0x01, 0x41, 0x9b };
+
+std::vector<uint8_t> Convert(CBitstreamConverter &converter, uint8_t *data, int size)
+{
+  if (!converter.Convert(data, size))
+    return std::vector<uint8_t>();
+  uint8_t *out = converter.GetConvertBuffer();
+  return std::vector<uint8_t>(out, out + converter.GetConvertSize());
+}
+}
+
+TEST(TestBitstreamConverter, ToAnnexB)
+{
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(AV_CODEC_ID_H264, avcC, sizeof(avcC), true));
+  ASSERT_TRUE(converter.NeedConvert());
+
+  EXPECT_EQ(idrAnnexB, Convert(converter, idrPacket, sizeof(idrPacket)));
+  EXPECT_EQ(sliceAnnexB, Convert(converter, slicePacket, sizeof(slicePacket)));
+
+  // sps and pps are prepended again to the first idr after slices
+  EXPECT_EQ(idrAnnexB, Convert(converter, idrPacket, sizeof(idrPacket)));
+
+  // truncated packets fail
+  EXPECT_FALSE(converter.Convert(slicePacket, sizeof(slicePacket) - 1));
+}
+
+TEST(TestBitstreamConverter, ConvertTo)
+{
+  CBitstreamConverter converter;
+  ASSERT_TRUE(converter.Open(AV_CODEC_ID_H264, avcC, sizeof(avcC), true));
+
+  // a destination too small leaves the state alone, Convert still prepends sps and pps
+  std::vector<uint8_t> dest(idrAnnexB.size() - 1);
+  EXPECT_EQ(-1, converter.ConvertTo(idrPacket, sizeof(idrPacket), dest.data(), dest.size()));
+
+  dest.resize(64);
+  int size = converter.ConvertTo(idrPacket, sizeof(idrPacket), dest.data(), dest.size());
+  ASSERT_EQ(static_cast<int>(idrAnnexB.size()), size);
+  EXPECT_EQ(idrAnnexB, std::vector<uint8_t>(dest.begin(), dest.begin() + size));
+
+  size = converter.ConvertTo(slicePacket, sizeof(slicePacket), dest.data(), dest.size());
+  ASSERT_EQ(static_cast<int>(sliceAnnexB.size()), size);
+  EXPECT_EQ(sliceAnnexB, std::vector<uint8_t>(dest.begin(), dest.begin() + size));
+
+  EXPECT_EQ(idrAnnexB, Convert(converter, idrPacket, sizeof(idrPacket)));
+}
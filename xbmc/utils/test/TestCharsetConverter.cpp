@@ -133,6 +133,32 @@ TEST_F(TestCharsetConverter, utf8ToW)
   EXPECT_STREQ(refstrw1.c_str(), varstrw1.c_str());
 }
 
+TEST_F(TestCharsetConverter, utf8ToUtf32)
+{
+  std::u32string varstr32;
+  EXPECT_TRUE(g_charsetConverter.utf8ToUtf32(u8"test ｕｔｆ８ \U0001F42D and some ascii", varstr32));
+  EXPECT_EQ(std::u32string(U"test ｕｔｆ８ \U0001F42D and some ascii"), varstr32);
+
+  refstra1.clear();
+  EXPECT_TRUE(g_charsetConverter.utf32ToUtf8(varstr32, refstra1));
+  EXPECT_STREQ(u8"test ｕｔｆ８ \U0001F42D and some ascii", refstra1.c_str());
+}
+
+TEST_F(TestCharsetConverter, utf8ToUtf32_BadChar)
+{
+  std::u32string varstr32;
+  // stray continuation byte, overlong '/', surrogate and a truncated character at the end
+  refstra1 = "te\x80st\xC0\xAF \xED\xA0\x80ok\xE2\x82";
+  EXPECT_FALSE(g_charsetConverter.utf8ToUtf32(refstra1, varstr32, true));
+  EXPECT_TRUE(varstr32.empty());
+  EXPECT_TRUE(g_charsetConverter.utf8ToUtf32(refstra1, varstr32, false));
+  EXPECT_EQ(std::u32string(U"test ok"), varstr32);
+
+  const std::u32string badstr32 = { U'o', 0xD800, 0x110000, U'k' };
+  EXPECT_TRUE(g_charsetConverter.utf32ToUtf8(badstr32, refstra1, false));
+  EXPECT_STREQ("ok", refstra1.c_str());
+}
+
 
 //TEST_F(TestCharsetConverter, utf16LEtoW)
 //{
@@ -269,6 +295,26 @@ TEST_F(TestCharsetConverter, wToUTF8)
   EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
 }
 
+TEST_F(TestCharsetConverter, utf16toUTF8_Surrogates)
+{
+  const std::u16string refstr16LE = { 0x0074, 0xD83D, 0xDC2D };
+  const std::u16string refstr16BE = { 0x7400, 0x3DD8, 0x2DDC };
+  refstra1 = u8"t\U0001F42D";
+#ifdef WORDS_BIGENDIAN
+  g_charsetConverter.utf16LEtoUTF8(refstr16BE, varstra1);
+  EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
+  g_charsetConverter.utf16BEtoUTF8(refstr16LE, varstra1);
+  EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
+#else
+  g_charsetConverter.utf16LEtoUTF8(refstr16LE, varstra1);
+  EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
+  g_charsetConverter.utf16BEtoUTF8(refstr16BE, varstra1);
+  EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
+  g_charsetConverter.utf16LEtoW(refstr16LE, varstrw1);
+  EXPECT_STREQ(L"t\U0001F42D", varstrw1.c_str());
+#endif
+}
+
 //TEST_F(TestCharsetConverter, utf16BEtoUTF8)
 //{
 //  refstr16_1.assign(refutf16BE);
@@ -60,3 +60,31 @@ TEST(TestCrc32, Reset)
   varcrc = a;
   EXPECT_EQ(0xffffffff, varcrc);
 }
+
+TEST(TestCrc32, Compute_Long)
+{
+  // the same crc for any split of the buffer, and as computed a byte at a time
+  std::string s;
+  for (int i = 0; i < 40; i++)
+    s += refdata;
+
+  for (size_t length = 0; length < 100; length += 7)
+  {
+    for (size_t split = 0; split <= length; split += 5)
+    {
+      Crc32 a;
+      a.Compute(s.c_str(), split);
+      a.Compute(s.c_str() + split, length - split);
+
+      Crc32 b;
+      for (size_t i = 0; i < length; i++)
+        b.Compute(s.c_str() + i, 1);
+      EXPECT_EQ((uint32_t)b, (uint32_t)a);
+    }
+  }
+
+  Crc32 a;
+  for (int i = 0; i < 40; i++)
+    a.Compute(refdata, sizeof(refdata) - 1);
+  EXPECT_EQ((uint32_t)a, Crc32::Compute(s));
+}
@@ -0,0 +1,78 @@
+/*
+ *      Copyright (C) 2005-2015 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/HttpCache.h"
+#include "utils/HttpHeader.h"
+#include "gtest/gtest.h"
+
+static int64_t GetFreshness(const std::string &headerLines, bool &noStore)
+{
+  CHttpHeader headers;
+  headers.Parse("HTTP/1.1 200 OK\r\n" + headerLines + "\r\n");
+  return CHttpCache::GetFreshness(headers, noStore);
+}
+
+TEST(TestHttpCache, GetFreshnessMaxAge)
+{
+  bool noStore;
+  EXPECT_EQ(3600, GetFreshness("Cache-Control: public, max-age=3600\r\n", noStore));
+  EXPECT_FALSE(noStore);
+  EXPECT_EQ(3000, GetFreshness("Cache-Control: max-age=3600\r\nAge: 600\r\n", noStore));
+  EXPECT_EQ(0, GetFreshness("Cache-Control: max-age=60\r\nAge: 600\r\n", noStore));
+
+  // max-age takes precedence over Expires
+  EXPECT_EQ(60, GetFreshness("Date: Thu, 09 Jan 2014 17:58:30 GMT\r\n"
+                             "Expires: Thu, 09 Jan 2014 18:58:30 GMT\r\n"
+                             "Cache-Control: max-age=60\r\n", noStore));
+}
+
+TEST(TestHttpCache, GetFreshnessExpires)
+{
+  bool noStore;
+  EXPECT_EQ(3600, GetFreshness("Date: Thu, 09 Jan 2014 17:58:30 GMT\r\n"
+                               "Expires: Thu, 09 Jan 2014 18:58:30 GMT\r\n", noStore));
+  EXPECT_FALSE(noStore);
+  EXPECT_EQ(0, GetFreshness("Date: Thu, 09 Jan 2014 17:58:30 GMT\r\n"
+                            "Expires: Thu, 19 Nov 1981 08:52:00 GMT\r\n", noStore));
+  EXPECT_EQ(0, GetFreshness("Date: Thu, 09 Jan 2014 17:58:30 GMT\r\n"
+                            "Expires: 0\r\n", noStore));
+  EXPECT_EQ(0, GetFreshness("ETag: \"abc\"\r\n", noStore));
+  EXPECT_FALSE(noStore);
+}
+
+TEST(TestHttpCache, GetFreshnessNoStore)
+{
+  bool noStore;
+  EXPECT_EQ(0, GetFreshness("Cache-Control: no-store, max-age=3600\r\n", noStore));
+  EXPECT_TRUE(noStore);
+  EXPECT_EQ(0, GetFreshness("Cache-Control: max-age=3600\r\nVary: *\r\n", noStore));
+  EXPECT_TRUE(noStore);
+  EXPECT_EQ(0, GetFreshness("Cache-Control: no-cache\r\nCache-Control: max-age=3600\r\n", noStore));
+  EXPECT_FALSE(noStore);
+}
+
+TEST(TestHttpCache, GetKey)
+{
+  std::string key = CHttpCache::GetKey("https://api.example.com/3/movie/19995", "", "");
+  EXPECT_EQ(key, CHttpCache::GetKey("https://api.example.com/3/movie/19995", "", ""));
+  EXPECT_NE(key, CHttpCache::GetKey("https://api.example.com/3/movie/19995", "", "gzip"));
+  EXPECT_NE(key, CHttpCache::GetKey("https://api.example.com/3/movie/19995", "https://www.example.com", ""));
+  EXPECT_NE(key, CHttpCache::GetKey("https://api.example.com/3/movie/19995|Accept-Language=de", "", ""));
+}
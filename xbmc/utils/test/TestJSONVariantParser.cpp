@@ -199,3 +199,17 @@ TEST(TestJSONVariantParser, CanParseArray)
   ASSERT_TRUE(variant[0]["foo"].isString());
   ASSERT_STREQ("bar", variant[0]["foo"].asString().c_str());
 }
+
+TEST(TestJSONVariantParser, KeepsValueOnError)
+{
+  CVariant variant("foo");
+  ASSERT_FALSE(CJSONVariantParser::Parse("{ \"foo\": [ 1, 2", variant));
+  ASSERT_TRUE(variant.isString());
+  ASSERT_STREQ("foo", variant.asString().c_str());
+
+  ASSERT_TRUE(CJSONVariantParser::Parse("{ \"foo\": [ 1, { \"bar\": [] } ], \"baz\": null }", variant));
+  ASSERT_TRUE(variant.isObject());
+  ASSERT_EQ(2U, variant["foo"].size());
+  ASSERT_TRUE(variant["foo"][1]["bar"].isArray());
+  ASSERT_TRUE(variant["baz"].isNull());
+}
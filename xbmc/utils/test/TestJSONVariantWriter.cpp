@@ -161,3 +161,32 @@ TEST(TestJSONVariantWriter, CanWriteArray)
   ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, false));
   ASSERT_STREQ("[\n\t{\n\t\t\"foo\": \"bar\"\n\t}\n]", str.c_str());
 }
+
+TEST(TestJSONVariantWriter, CanWriteChunked)
+{
+  CVariant variant(CVariant::VariantTypeArray);
+  for (int i = 0; i < 5000; i++)
+  {
+    CVariant item(CVariant::VariantTypeObject);
+    item["id"] = i;
+    item["title"] = "Some movie title";
+    variant.push_back(item);
+  }
+
+  std::string expected;
+  ASSERT_TRUE(CJSONVariantWriter::Write(variant, expected, true));
+
+  std::string str;
+  unsigned int chunks = 0;
+  ASSERT_TRUE(CJSONVariantWriter::Write(variant, [&str, &chunks](const char *data, size_t size)
+  {
+    str.append(data, size);
+    chunks++;
+    return true;
+  }, true));
+  ASSERT_EQ(expected, str);
+  ASSERT_LT(1U, chunks);
+
+  // the output can abort the writing
+  ASSERT_FALSE(CJSONVariantWriter::Write(variant, [](const char *data, size_t size) { return false; }, true));
+}
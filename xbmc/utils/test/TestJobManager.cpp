@@ -147,10 +147,12 @@ private:
 };
 
 BroadcastingJob *
-WaitForJobToStartProcessing(CJob::PRIORITY priority, JobControlPackage &package)
+WaitForJobToStartProcessing(CJob::PRIORITY priority, JobControlPackage &package, unsigned int *id = NULL)
 {
   BroadcastingJob* job = new BroadcastingJob(package);
-  CJobManager::GetInstance().AddJob(job, NULL, priority);
+  unsigned int jobID = CJobManager::GetInstance().AddJob(job, NULL, priority);
+  if (id)
+    *id = jobID;
 
   // We're now ready to wait, wait and then unblock once ready
   while (!package.ready)
@@ -183,3 +185,57 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+TEST_F(TestJobManager, GetStatistics)
+{
+  JobControlPackage package;
+  BroadcastingJob *job (WaitForJobToStartProcessing(CJob::PRIORITY_LOW, package));
+
+  std::vector<CJobManager::LaneStatistics> statistics = CJobManager::GetInstance().GetStatistics();
+  ASSERT_EQ(CJob::PRIORITY_DEDICATED + 1, static_cast<int>(statistics.size()));
+  EXPECT_EQ(1u, statistics[CJob::PRIORITY_LOW].processing);
+  EXPECT_EQ(0u, statistics[CJob::PRIORITY_LOW].queued);
+  EXPECT_LE(1u, statistics[CJob::PRIORITY_LOW].started);
+  EXPECT_EQ(0u, statistics[CJob::PRIORITY_HIGH].processing);
+  EXPECT_LE(1u, CJobManager::GetInstance().GetWorkerCount());
+
+  job->FinishAndStopBlocking();
+}
+
+TEST_F(TestJobManager, AddContinuation)
+{
+  JobControlPackage package;
+  unsigned int blockingID = 0;
+  BroadcastingJob *job (WaitForJobToStartProcessing(CJob::PRIORITY_LOW, package, &blockingID));
+
+  std::atomic<bool> ran(false);
+  unsigned int id = CJobManager::GetInstance().SubmitAfter(std::vector<unsigned int>(1, blockingID), [&ran]() { ran = true; });
+  EXPECT_NE(0u, id);
+
+  Sleep(100);
+  EXPECT_FALSE(ran);
+  EXPECT_EQ(1u, CJobManager::GetInstance().GetStatistics()[CJob::PRIORITY_LOW].waiting);
+
+  job->FinishAndStopBlocking();
+  for (int i = 0; i < 100 && !ran; ++i)
+    Sleep(10);
+  EXPECT_TRUE(ran);
+  EXPECT_EQ(0u, CJobManager::GetInstance().GetStatistics()[CJob::PRIORITY_LOW].waiting);
+}
+
+TEST_F(TestJobManager, CancelDependency)
+{
+  CJobManager::GetInstance().PauseJobs();
+
+  std::atomic<bool> ran(false);
+  unsigned int id = CJobManager::GetInstance().AddJob(new DummyJob(), NULL, CJob::PRIORITY_LOW_PAUSABLE);
+  CJobManager::GetInstance().SubmitAfter(std::vector<unsigned int>(1, id), [&ran]() { ran = true; });
+  EXPECT_EQ(1u, CJobManager::GetInstance().GetStatistics()[CJob::PRIORITY_LOW].waiting);
+
+  CJobManager::GetInstance().CancelJob(id);
+  EXPECT_EQ(0u, CJobManager::GetInstance().GetStatistics()[CJob::PRIORITY_LOW].waiting);
+
+  CJobManager::GetInstance().UnPauseJobs();
+  Sleep(200);
+  EXPECT_FALSE(ran);
+}
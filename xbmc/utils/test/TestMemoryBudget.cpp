@@ -0,0 +1,107 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/MemoryBudget.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace
+{
+  class CTestConsumer : public IMemoryConsumer
+  {
+  public:
+    CTestConsumer(std::vector<CTestConsumer*> &calls, size_t usage) : m_calls(calls), m_usage(usage) {}
+
+    size_t GetMemoryBudgetUsage() const override { return m_usage; }
+    void OnMemoryPressure(MemoryPressure level) override
+    {
+      m_calls.push_back(this);
+      m_usage = 0;
+    }
+
+  private:
+    std::vector<CTestConsumer*> &m_calls;
+    size_t m_usage;
+  };
+}
+
+// the caches registered by the rest of kodi use far less, and are asked after these
+#define LARGE_USAGE  (1024 * 1024 * 1024)
+#define SMALL_USAGE  (1024 * 1024)
+
+TEST(TestMemoryBudget, Status)
+{
+  std::vector<CTestConsumer*> calls;
+  CTestConsumer second(calls, SMALL_USAGE);
+  CTestConsumer first(calls, LARGE_USAGE);
+  CMemoryBudget &budget = CMemoryBudget::GetInstance();
+  budget.Register(&second, "second", -1);
+  budget.Register(&first, "first", -2);
+
+  std::vector<CMemoryBudget::CConsumerStatus> status = budget.GetStatus();
+  ASSERT_GE(status.size(), 2u);
+  EXPECT_EQ("first", status[0].name);
+  EXPECT_EQ(static_cast<size_t>(LARGE_USAGE), status[0].usage);
+  EXPECT_EQ("second", status[1].name);
+  EXPECT_EQ(-1, status[1].priority);
+
+  budget.Unregister(&first);
+  budget.Unregister(&second);
+  for (const auto &entry : budget.GetStatus())
+    EXPECT_NE("first", entry.name);
+}
+
+TEST(TestMemoryBudget, ModeratePressure)
+{
+  std::vector<CTestConsumer*> calls;
+  CTestConsumer first(calls, LARGE_USAGE);
+  CTestConsumer second(calls, SMALL_USAGE);
+  CMemoryBudget &budget = CMemoryBudget::GetInstance();
+  budget.Register(&first, "first", -2);
+  budget.Register(&second, "second", -1);
+
+  // the first one gave back more than half, so the others are left alone
+  EXPECT_EQ(static_cast<size_t>(LARGE_USAGE), budget.OnMemoryPressure(MemoryPressure::MODERATE));
+  ASSERT_EQ(1u, calls.size());
+  EXPECT_EQ(&first, calls[0]);
+  EXPECT_EQ(static_cast<size_t>(SMALL_USAGE), second.GetMemoryBudgetUsage());
+
+  budget.Unregister(&first);
+  budget.Unregister(&second);
+}
+
+TEST(TestMemoryBudget, CriticalPressure)
+{
+  std::vector<CTestConsumer*> calls;
+  CTestConsumer first(calls, LARGE_USAGE);
+  CTestConsumer second(calls, SMALL_USAGE);
+  CMemoryBudget &budget = CMemoryBudget::GetInstance();
+  budget.Register(&first, "first", -2);
+  budget.Register(&second, "second", -1);
+
+  EXPECT_GE(budget.OnMemoryPressure(MemoryPressure::CRITICAL), static_cast<size_t>(LARGE_USAGE + SMALL_USAGE));
+  ASSERT_EQ(2u, calls.size());
+  EXPECT_EQ(&first, calls[0]);
+  EXPECT_EQ(&second, calls[1]);
+
+  budget.Unregister(&first);
+  budget.Unregister(&second);
+}
@@ -0,0 +1,130 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/Metrics.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+#include "gtest/gtest.h"
+
+TEST(TestMetrics, Counter)
+{
+  CMetrics &metrics = CMetrics::GetInstance();
+  CMetricCounter &counter = metrics.GetCounter("test_counter_total", "A counter");
+  counter.Increment();
+  counter.Increment(2);
+
+  // the same name gives the same counter
+  EXPECT_EQ(3u, metrics.GetCounter("test_counter_total", "A counter").GetValue());
+
+  double value = 0.0;
+  ASSERT_TRUE(metrics.GetValue("test_counter_total", value));
+  EXPECT_EQ(3.0, value);
+
+  // a name can't be used for another type
+  metrics.GetGauge("test_counter_total", "A gauge").Set(10.0);
+  ASSERT_TRUE(metrics.GetValue("test_counter_total", value));
+  EXPECT_EQ(3.0, value);
+}
+
+TEST(TestMetrics, Gauge)
+{
+  CMetrics &metrics = CMetrics::GetInstance();
+  metrics.GetGauge("test_gauge", "A gauge").Set(1.5);
+
+  double value = 0.0;
+  ASSERT_TRUE(metrics.GetValue("test_gauge", value));
+  EXPECT_EQ(1.5, value);
+
+  int calls = 0;
+  metrics.RegisterGauge("test_callback_gauge", "A gauge read through a callback", [&calls]() { return ++calls; });
+  ASSERT_TRUE(metrics.GetValue("test_callback_gauge", value));
+  EXPECT_EQ(1.0, value);
+
+  metrics.UnregisterGauge("test_callback_gauge");
+  EXPECT_FALSE(metrics.GetValue("test_callback_gauge", value));
+  EXPECT_EQ(1, calls);
+}
+
+TEST(TestMetrics, Histogram)
+{
+  CMetrics &metrics = CMetrics::GetInstance();
+  CMetricHistogram &histogram = metrics.GetHistogram("test_histogram", "A histogram", { 10.0, 20.0, 40.0 });
+
+  double value = 0.0;
+  ASSERT_TRUE(metrics.GetValue("test_histogram.p50", value));
+  EXPECT_EQ(0.0, value);
+
+  for (int i = 0; i < 90; i++)
+    histogram.Observe(15.0);
+  for (int i = 0; i < 10; i++)
+    histogram.Observe(100.0);
+
+  CMetricHistogram::CSnapshot snapshot = histogram.GetSnapshot();
+  ASSERT_EQ(4u, snapshot.counts.size());
+  EXPECT_EQ(0u, snapshot.counts[0]);
+  EXPECT_EQ(90u, snapshot.counts[1]);
+  EXPECT_EQ(10u, snapshot.counts[3]);
+  EXPECT_EQ(100u, snapshot.count);
+  EXPECT_EQ(2350.0, snapshot.sum);
+
+  EXPECT_DOUBLE_EQ(23.5, histogram.GetAverage());
+  // half of the values in the bucket from 10 to 20
+  ASSERT_TRUE(metrics.GetValue("test_histogram.p50", value));
+  EXPECT_NEAR(15.56, value, 0.01);
+  // values above all bounds report the largest one
+  ASSERT_TRUE(metrics.GetValue("test_histogram.p95", value));
+  EXPECT_EQ(40.0, value);
+
+  EXPECT_FALSE(metrics.GetValue("test_histogram", value));
+  EXPECT_FALSE(metrics.GetValue("test_histogram.p42", value));
+}
+
+TEST(TestMetrics, Output)
+{
+  CMetrics &metrics = CMetrics::GetInstance();
+  metrics.GetCounter("test_output_total", "Counted things").Increment(5);
+  metrics.GetHistogram("test_output_ms", "Timed things", { 1.0, 2.0 }).Observe(1.5);
+
+  std::string text = metrics.GetPrometheusText();
+  EXPECT_NE(std::string::npos, text.find("# HELP test_output_total Counted things\n"
+                                         "# TYPE test_output_total counter\n"
+                                         "test_output_total 5\n"));
+  EXPECT_NE(std::string::npos, text.find("# TYPE test_output_ms histogram\n"
+                                         "test_output_ms_bucket{le=\"1\"} 0\n"
+                                         "test_output_ms_bucket{le=\"2\"} 1\n"
+                                         "test_output_ms_bucket{le=\"+Inf\"} 1\n"
+                                         "test_output_ms_sum 1.5\n"
+                                         "test_output_ms_count 1\n"));
+
+  CVariant result;
+  metrics.GetMetrics(result);
+  ASSERT_TRUE(result.isArray());
+  bool found = false;
+  for (auto it = result.begin_array(); it != result.end_array(); ++it)
+  {
+    if ((*it)["name"].asString() == "test_output_total")
+    {
+      EXPECT_EQ("counter", (*it)["type"].asString());
+      EXPECT_EQ(5u, (*it)["value"].asUnsignedInteger());
+      found = true;
+    }
+  }
+  EXPECT_TRUE(found);
+}
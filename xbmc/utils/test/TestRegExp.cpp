@@ -134,6 +134,32 @@ TEST(TestRegExp, operatorEqual)
   EXPECT_STREQ("string", match.c_str());
 }
 
+TEST(TestRegExp, SharedPattern)
+{
+  CRegExp regexcopy;
+  {
+    CRegExp regex(true, CRegExp::asciiOnly);
+    EXPECT_TRUE(regex.RegComp("s([0-9]+)e([0-9]+)"));
+    regexcopy = regex;
+  }
+  // the compiled pattern outlives the object that compiled it
+  EXPECT_EQ(5, regexcopy.RegFind("Show.S01E02.mkv"));
+  EXPECT_STREQ("01", regexcopy.GetMatch(1).c_str());
+
+  // same pattern from the cache, but with other options
+  CRegExp casesensitive(false, CRegExp::asciiOnly);
+  EXPECT_TRUE(casesensitive.RegComp("s([0-9]+)e([0-9]+)"));
+  EXPECT_EQ(-1, casesensitive.RegFind("Show.S01E02.mkv"));
+
+  CRegExp nostudy(true, CRegExp::asciiOnly);
+  EXPECT_TRUE(nostudy.RegComp("s([0-9]+)e([0-9]+)", CRegExp::NoStudy));
+  EXPECT_EQ(5, nostudy.RegFind("Show.S01E02.mkv"));
+  EXPECT_STREQ("02", nostudy.GetMatch(2).c_str());
+
+  EXPECT_FALSE(nostudy.RegComp("s([0-9]+"));
+  EXPECT_FALSE(nostudy.IsCompiled());
+}
+
 class TestRegExpLog : public testing::Test
 {
 protected:
@@ -0,0 +1,66 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/RollingHistogram.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestRollingHistogram, Empty)
+{
+  CRollingHistogram histogram(1.0, 10, 4);
+  EXPECT_EQ(0, histogram.GetCount());
+  EXPECT_DOUBLE_EQ(0.0, histogram.GetPercentile(0.5));
+}
+
+TEST(TestRollingHistogram, Percentile)
+{
+  CRollingHistogram histogram(0.5, 100, 100);
+  for (int i = 0; i < 100; i++)
+    histogram.Add(i * 0.5 + 0.25);
+
+  EXPECT_EQ(100, histogram.GetCount());
+  EXPECT_DOUBLE_EQ(25.5, histogram.GetPercentile(0.5));
+  EXPECT_DOUBLE_EQ(48.0, histogram.GetPercentile(0.95));
+  EXPECT_DOUBLE_EQ(50.0, histogram.GetPercentile(1.0));
+}
+
+TEST(TestRollingHistogram, Clamp)
+{
+  CRollingHistogram histogram(1.0, 10, 4);
+  histogram.Add(-5.0);
+  EXPECT_DOUBLE_EQ(1.0, histogram.GetPercentile(1.0));
+  histogram.Add(1000.0);
+  EXPECT_DOUBLE_EQ(10.0, histogram.GetPercentile(1.0));
+}
+
+TEST(TestRollingHistogram, Window)
+{
+  CRollingHistogram histogram(1.0, 10, 4);
+  for (int i = 0; i < 4; i++)
+    histogram.Add(9.5);
+  for (int i = 0; i < 4; i++)
+    histogram.Add(0.5);
+
+  EXPECT_EQ(4, histogram.GetCount());
+  EXPECT_DOUBLE_EQ(1.0, histogram.GetPercentile(1.0));
+
+  histogram.Reset();
+  EXPECT_EQ(0, histogram.GetCount());
+}
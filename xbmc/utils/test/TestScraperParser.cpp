@@ -19,11 +19,37 @@
  */
 
 #include "utils/ScraperParser.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 
 #include "test/TestUtils.h"
 
+#include <iostream>
+
 #include "gtest/gtest.h"
 
+namespace
+{
+
+// a tmdb search result with the given number of movies
+std::string SearchResults(int movies)
+{
+  std::string results = "{\"page\":1,\"results\":[";
+  for (int i = 0; i < movies; i++)
+  {
+    if (i > 0)
+      results += ",";
+    // no StringUtils::Format(), fmt would take the braces for fields
+    results += "{\"release_date\":\"" + std::to_string(1950 + i % 60) + "-12-10\",\"id\":" + std::to_string(1000 + i) +
+               ",\"original_title\":\"Movie " + std::to_string(i) + "\",\"original_language\":\"en\",\"title\":\"Movie " +
+               std::to_string(i) + "\",\"popularity\":1.5}";
+  }
+  results += "]}";
+  return results;
+}
+
+}
+
 TEST(TestScraperParser, General)
 {
   CScraperParser a;
@@ -37,3 +63,43 @@ TEST(TestScraperParser, General)
     a.GetFilename().c_str());
   EXPECT_STREQ("UTF-8", a.GetSearchStringEncoding().c_str());
 }
+
+TEST(TestScraperParser, Parse)
+{
+  CScraperParser a;
+  ASSERT_TRUE(a.Load(XBMC_REF_FILE_PATH("/addons/metadata.themoviedb.org/tmdb.xml")));
+
+  // run twice, the second time with the expressions compiled already
+  for (int run = 0; run < 2; run++)
+  {
+    a.m_param[0] = "Avatar";
+    a.m_param[1] = "2009";
+    EXPECT_EQ("<url>https://api.tmdb.org/3/search/movie?api_key=ecbc86c92da237cb9faff6d3ddc4be6d"
+              "&amp;query=Avatar&amp;year=2009&amp;language=</url>",
+              a.Parse("CreateSearchUrl", nullptr));
+
+    a.m_param[0] = SearchResults(3);
+    std::string results = a.Parse("GetSearchResults", nullptr);
+    EXPECT_TRUE(StringUtils::StartsWith(results, "<results><entity><title>Movie 0</title><id>1000</id><year>1950</year>"));
+    EXPECT_NE(std::string::npos, results.find("<title>Movie 2</title><id>1002</id><year>1952</year>"));
+  }
+}
+
+// microbenchmark, run with --gtest_also_run_disabled_tests
+TEST(TestScraperParser, DISABLED_ParseSpeed)
+{
+  CScraperParser a;
+  ASSERT_TRUE(a.Load(XBMC_REF_FILE_PATH("/addons/metadata.themoviedb.org/tmdb.xml")));
+
+  const int runs = 200;
+  std::string input = SearchResults(20);
+
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < runs; i++)
+  {
+    a.m_param[0] = input;
+    EXPECT_FALSE(a.Parse("GetSearchResults", nullptr).empty());
+  }
+  double duration = static_cast<double>(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency() / runs;
+  std::cout << "GetSearchResults with 20 movies: " << duration << " ms" << std::endl;
+}
@@ -19,10 +19,13 @@
  */
 
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+
 TEST(TestSortUtils, Sort_SortBy)
 {
   SortItems items;
@@ -133,3 +136,108 @@ TEST(TestSortUtils, GetFieldsForSorting)
   EXPECT_EQ(FieldTrackNumber, *it);
   EXPECT_EQ((unsigned int)5, fields.size());
 }
+
+static SortItems GetLabelItems(const std::vector<std::string> &labels)
+{
+  SortItems items;
+  for (const std::string &label : labels)
+  {
+    SortItemPtr item(new SortItem());
+    (*item)[FieldLabel] = CVariant(label);
+    items.push_back(item);
+  }
+  return items;
+}
+
+static std::vector<std::string> GetSyntheticLabels(unsigned int count)
+{
+  static const char *words[] = { "The", "Movie", "Part", "alpha", "Beta", "(Extended)", "Episode", "a", "10", "007" };
+  std::vector<std::string> labels;
+  unsigned int seed = 12345;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    std::string label;
+    for (unsigned int word = 0; word < 3; word++)
+    {
+      seed = seed * 1103515245 + 12345;
+      label += words[(seed >> 16) % 10];
+      label += " ";
+    }
+    seed = seed * 1103515245 + 12345;
+    label += StringUtils::Format("%u", (seed >> 16) % 1000);
+    labels.push_back(label);
+  }
+  return labels;
+}
+
+static void CheckSortedLikeAlphaNumericCompare(const std::vector<std::string> &labels)
+{
+  std::vector<std::string> expected(labels);
+  std::stable_sort(expected.begin(), expected.end(), [](const std::string &left, const std::string &right)
+  {
+    std::wstring wideLeft(left.begin(), left.end());
+    std::wstring wideRight(right.begin(), right.end());
+    return StringUtils::AlphaNumericCompare(wideLeft.c_str(), wideRight.c_str()) < 0;
+  });
+
+  SortItems items = GetLabelItems(labels);
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items);
+
+  ASSERT_EQ(expected.size(), items.size());
+  for (size_t i = 0; i < items.size(); i++)
+    EXPECT_EQ(expected[i], (*items[i])[FieldLabel].asString());
+}
+
+TEST(TestSortUtils, Sort_AlphaNumeric)
+{
+  CheckSortedLikeAlphaNumericCompare({ "Item 10", "item 9", "Item 010", "Item 1", "b", "A", "Item 9a",
+                                       "Item 9", "Item", "Item 1234567890123456", "Item 1234567890123455",
+                                       "item 10", "Item 10" });
+}
+
+TEST(TestSortUtils, Sort_Stable)
+{
+  SortItems items = GetLabelItems({ "B", "a", "b", "A" });
+  for (size_t i = 0; i < items.size(); i++)
+    (*items[i])[FieldId] = CVariant(static_cast<int>(i));
+
+  SortUtils::Sort(SortByLabel, SortOrderDescending, SortAttributeNone, items);
+
+  EXPECT_EQ(0, (*items[0])[FieldId].asInteger());
+  EXPECT_EQ(2, (*items[1])[FieldId].asInteger());
+  EXPECT_EQ(1, (*items[2])[FieldId].asInteger());
+  EXPECT_EQ(3, (*items[3])[FieldId].asInteger());
+}
+
+TEST(TestSortUtils, Sort_SortSpecialAndFolders)
+{
+  SortItems items = GetLabelItems({ "c", "b", "a", "d" });
+  (*items[0])[FieldSortSpecial] = CVariant(SortSpecialOnBottom);
+  (*items[1])[FieldFolder] = CVariant(false);
+  (*items[2])[FieldFolder] = CVariant(false);
+  (*items[3])[FieldFolder] = CVariant(true);
+
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items);
+
+  EXPECT_EQ("d", (*items[0])[FieldLabel].asString());
+  EXPECT_EQ("a", (*items[1])[FieldLabel].asString());
+  EXPECT_EQ("b", (*items[2])[FieldLabel].asString());
+  EXPECT_EQ("c", (*items[3])[FieldLabel].asString());
+}
+
+TEST(TestSortUtils, Sort_Large)
+{
+  // large enough to be sorted in chunks
+  CheckSortedLikeAlphaNumericCompare(GetSyntheticLabels(50000));
+}
+
+// microbenchmark, run with --gtest_also_run_disabled_tests
+TEST(TestSortUtils, DISABLED_SortSpeed)
+{
+  std::vector<std::string> labels = GetSyntheticLabels(100000);
+  for (unsigned int i = 0; i < 10; i++)
+  {
+    SortItems items = GetLabelItems(labels);
+    SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeIgnoreArticle, items);
+  }
+}
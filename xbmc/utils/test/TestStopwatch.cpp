@@ -19,6 +19,7 @@
  */
 
 #include "utils/Stopwatch.h"
+#include "threads/SystemClock.h"
 #include "threads/Thread.h"
 
 #include "gtest/gtest.h"
@@ -74,3 +75,20 @@ TEST(TestStopWatch, Reset)
   a.Reset();
   EXPECT_LT(a.GetElapsedMilliseconds(), 5);
 }
+
+TEST(TestStopWatch, SubMillisecond)
+{
+  CStopWatch a;
+  a.StartZero();
+  const uint64_t start = XbmcThreads::SystemClockNanos();
+  while (XbmcThreads::SystemClockNanos() - start < 200000)
+    ;
+  a.Stop();
+  EXPECT_GE(a.GetElapsedMilliseconds(), 0.2f);
+  EXPECT_LT(a.GetElapsedMilliseconds(), 100.0f);
+
+  const unsigned int millis = XbmcThreads::SystemClockMillis();
+  const uint64_t nanos = XbmcThreads::SystemClockNanos();
+  EXPECT_LE(millis, nanos / 1000000);
+  EXPECT_LE(nanos / 1000000 - millis, 1u);
+}
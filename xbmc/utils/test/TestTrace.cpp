@@ -0,0 +1,85 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/Trace.h"
+#include "utils/Variant.h"
+#include "utils/JSONVariantParser.h"
+
+#include "gtest/gtest.h"
+
+#include <thread>
+
+TEST(TestTrace, NotRunning)
+{
+  EXPECT_FALSE(CTrace::IsRunning());
+  {
+    CTraceScope trace("test", "not running");
+  }
+  EXPECT_FALSE(CTrace::Stop());
+}
+
+TEST(TestTrace, Write)
+{
+  std::string file = CSpecialProtocol::TranslatePath("special://temp/test.trace.json");
+
+  CTrace::Start(file);
+  EXPECT_TRUE(CTrace::IsRunning());
+  {
+    CTraceScope trace("test", "outer", "with \"quotes\"");
+    CTrace::Counter("level", 42);
+    CTrace::FlowBegin("handover", 7);
+  }
+  std::thread thread([]()
+  {
+    CTrace::FlowEnd("handover", 7);
+    CTraceScope trace("test", "inner");
+  });
+  thread.join();
+  EXPECT_TRUE(CTrace::Stop());
+  EXPECT_FALSE(CTrace::IsRunning());
+
+  XFILE::CFile reader;
+  XUTILS::auto_buffer data;
+  ASSERT_GT(reader.LoadFile(file, data), 0);
+  reader.Close();
+
+  CVariant trace;
+  ASSERT_TRUE(CJSONVariantParser::Parse(std::string(data.get(), data.size()), trace));
+  ASSERT_TRUE(trace["traceEvents"].isArray());
+
+  std::map<std::string, CVariant> events;
+  for (CVariant::const_iterator_array it = trace["traceEvents"].begin_array(); it != trace["traceEvents"].end_array(); ++it)
+    events[(*it)["ph"].asString() + (*it)["name"].asString()] = *it;
+
+  ASSERT_TRUE(events.find("Xouter") != events.end());
+  EXPECT_EQ("test", events["Xouter"]["cat"].asString());
+  EXPECT_EQ("with \"quotes\"", events["Xouter"]["args"]["detail"].asString());
+  ASSERT_TRUE(events.find("Xinner") != events.end());
+  EXPECT_NE(events["Xouter"]["tid"].asUnsignedInteger(), events["Xinner"]["tid"].asUnsignedInteger());
+  EXPECT_EQ(42, events["Clevel"]["args"]["value"].asInteger());
+  EXPECT_EQ(7, events["shandover"]["id"].asInteger());
+  EXPECT_EQ(7, events["fhandover"]["id"].asInteger());
+  EXPECT_TRUE(events.find("Mthread_name") != events.end());
+  EXPECT_EQ(0, trace["otherData"]["dropped"].asInteger());
+
+  EXPECT_TRUE(XFILE::CFile::Delete(file));
+}
@@ -314,6 +314,12 @@ TEST_F(TestURIUtils, IsInternetStream)
   CURL url2("https://path/to/file");
   EXPECT_TRUE(URIUtils::IsInternetStream(url1));
   EXPECT_TRUE(URIUtils::IsInternetStream(url2));
+  EXPECT_TRUE(URIUtils::IsInternetStream("rtmp://path/to/stream"));
+  EXPECT_TRUE(URIUtils::IsInternetStream("stack://http://path/to/file"));
+  EXPECT_FALSE(URIUtils::IsInternetStream("/path/to/file"));
+  EXPECT_FALSE(URIUtils::IsInternetStream("smb://path/to/file"));
+  EXPECT_FALSE(URIUtils::IsInternetStream("dav://path/to/file"));
+  EXPECT_TRUE(URIUtils::IsInternetStream("dav://path/to/file", true));
 }
 
 TEST_F(TestURIUtils, IsInZIP)
@@ -393,7 +399,13 @@ TEST_F(TestURIUtils, IsRemote)
 TEST_F(TestURIUtils, IsSmb)
 {
   EXPECT_TRUE(URIUtils::IsSmb("smb://path/to/file"));
+  EXPECT_TRUE(URIUtils::IsSmb("SMB://path/to/file"));
   EXPECT_TRUE(URIUtils::IsSmb("stack://smb://path/to/file"));
+  EXPECT_TRUE(URIUtils::IsSmb("zip://smb%3a%2f%2fpath%2fto%2farchive.zip/file"));
+  EXPECT_FALSE(URIUtils::IsSmb("smb:/path/to/file"));
+  EXPECT_FALSE(URIUtils::IsSmb("smb"));
+  EXPECT_FALSE(URIUtils::IsSmb("/path/to/smb://file"));
+  EXPECT_FALSE(URIUtils::IsSmb("zip://%2fpath%2fto%2farchive.zip/file"));
 }
 
 TEST_F(TestURIUtils, IsSpecial)
@@ -345,3 +345,36 @@ TEST(TestVariant, isMember)
   EXPECT_TRUE(a.isMember("key1"));
   EXPECT_FALSE(a.isMember("key2"));
 }
+
+TEST(TestVariant, ShortAndLongString)
+{
+  std::string shortString("fourteen chars");
+  std::string longString("a string that doesn't fit into the variant");
+
+  CVariant a(shortString), b(longString);
+  EXPECT_EQ(shortString, a.asString());
+  EXPECT_EQ(longString, b.asString());
+  EXPECT_EQ(shortString.size(), a.size());
+  EXPECT_EQ(longString.size(), b.size());
+  EXPECT_STREQ(longString.c_str(), b.c_str());
+
+  CVariant c(a), d(b);
+  EXPECT_TRUE(c == a);
+  EXPECT_TRUE(d == b);
+  EXPECT_FALSE(a == b);
+
+  c = std::move(d);
+  EXPECT_EQ(longString, c.asString());
+  a.swap(c);
+  EXPECT_EQ(longString, a.asString());
+  EXPECT_EQ(shortString, c.asString());
+
+  b.clear();
+  EXPECT_TRUE(b.isString());
+  EXPECT_TRUE(b.empty());
+  EXPECT_STREQ("", b.c_str());
+
+  EXPECT_EQ(42, CVariant("42").asInteger());
+  EXPECT_FALSE(CVariant("false").asBoolean(true));
+  EXPECT_TRUE(CVariant(std::string("0\0", 2)).asBoolean());
+}
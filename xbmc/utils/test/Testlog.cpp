@@ -30,6 +30,9 @@
 
 #include "gtest/gtest.h"
 
+#include <thread>
+#include <vector>
+
 class Testlog : public testing::Test
 {
 protected:
@@ -151,3 +154,48 @@ TEST_F(Testlog, SetLogLevel)
   CLog::Close();
   EXPECT_TRUE(XFILE::CFile::Delete(logfile));
 }
+
+TEST_F(Testlog, Threads)
+{
+  std::string logfile, logstring;
+  char buf[100];
+  unsigned int bytesread;
+  XFILE::CFile file;
+
+  std::string appName = CCompileInfo::GetAppName();
+  StringUtils::ToLower(appName);
+  logfile = CSpecialProtocol::TranslatePath("special://temp/") + appName + ".log";
+  EXPECT_TRUE(CLog::Init(CSpecialProtocol::TranslatePath("special://temp/").c_str()));
+
+  // lines of other threads are written by the log writer, Close() writes what is left
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+    threads.emplace_back([t]()
+    {
+      for (int i = 0; i < 50; i++)
+        CLog::Log(LOGDEBUG, "thread %d line %d", t, i);
+    });
+  for (auto& thread : threads)
+    thread.join();
+  CLog::Close();
+
+  EXPECT_TRUE(file.Open(logfile));
+  while ((bytesread = file.Read(buf, sizeof(buf) - 1)) > 0)
+  {
+    buf[bytesread] = '\0';
+    logstring.append(buf);
+  }
+  file.Close();
+
+  for (int t = 0; t < 4; t++)
+  {
+    EXPECT_NE(std::string::npos, logstring.find(StringUtils::Format("DEBUG: thread %d line 0\n", t)));
+    EXPECT_NE(std::string::npos, logstring.find(StringUtils::Format("DEBUG: thread %d line 49\n", t)));
+    // the lines of a thread stay in order
+    EXPECT_LT(logstring.find(StringUtils::Format("thread %d line 10\n", t)),
+              logstring.find(StringUtils::Format("thread %d line 11\n", t)));
+  }
+  EXPECT_EQ(std::string::npos, logstring.find("Dropped"));
+
+  EXPECT_TRUE(XFILE::CFile::Delete(logfile));
+}
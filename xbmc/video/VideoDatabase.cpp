@@ -37,6 +37,7 @@
 #include "dialogs/GUIDialogYesNo.h"
 #include "FileItem.h"
 #include "filesystem/Directory.h"
+#include "filesystem/ExistsChecker.h"
 #include "filesystem/File.h"
 #include "filesystem/MultiPathDirectory.h"
 #include "filesystem/StackDirectory.h"
@@ -79,6 +80,12 @@ using namespace ADDON;
 using namespace KODI::MESSAGING;
 using namespace KODI::GUILIB;
 
+// link tables whose navigation nodes are served from the navsummary table
+static const char *NavSummaryTypes[] = { "genre", "country", "studio", "tag" };
+
+// number of items whose details GetDetailsForItems() fetches with a single query
+#define VIDEODB_DETAILS_BATCH_SIZE 250
+
 //********************************************************************************************************************************
 CVideoDatabase::CVideoDatabase(void) = default;
 
@@ -202,6 +209,64 @@ void CVideoDatabase::CreateTables()
 
   CLog::Log(LOGINFO, "create uniqueid table");
   m_pDS->exec("CREATE TABLE uniqueid (uniqueid_id INTEGER PRIMARY KEY, media_id INTEGER, media_type TEXT, value TEXT, type TEXT)");
+
+  CLog::Log(LOGINFO, "create navsummary table");
+  CreateNavSummaryTables();
+
+  CLog::Log(LOGINFO, "create revision table");
+  CreateRevisionTable();
+}
+
+void CVideoDatabase::CreateNavSummaryTables()
+{
+  // per item counts for the genre/country/studio/tag nodes. Rows are dropped by
+  // the triggers in CreateNavSummaryTriggers() whenever the underlying links or
+  // watched state change and recomputed the next time the node is listed
+  m_pDS->exec("CREATE TABLE navsummary (type TEXT, media_type TEXT, item_id INTEGER, total INTEGER, watched INTEGER)");
+  m_pDS->exec("CREATE TABLE navsummary_state (type TEXT, media_type TEXT, dirty INTEGER)");
+  for (const char *type : NavSummaryTypes)
+  {
+    for (const char *mediaType : { MediaTypeMovie, MediaTypeTvShow, MediaTypeMusicVideo })
+      m_pDS->exec(PrepareSQL("INSERT INTO navsummary_state (type, media_type, dirty) VALUES ('%s', '%s', 1)", type, mediaType));
+  }
+}
+
+void CVideoDatabase::CreateNavSummaryTriggers()
+{
+  // the summary may be out of date if the triggers were dropped while updating the tables
+  m_pDS->exec("DELETE FROM navsummary");
+  m_pDS->exec("UPDATE navsummary_state SET dirty=1");
+
+  for (const char *type : NavSummaryTypes)
+  {
+    for (const auto &event : { std::make_pair("INSERT", "new"), std::make_pair("DELETE", "old") })
+    {
+      const char *when = event.first;
+      const char *row = event.second;
+      m_pDS->exec(PrepareSQL("CREATE TRIGGER navsummary_%s_%s AFTER %s ON %s_link FOR EACH ROW BEGIN "
+                             "DELETE FROM navsummary WHERE type='%s' AND media_type=%s.media_type AND item_id=%s.%s_id; "
+                             "UPDATE navsummary_state SET dirty=1 WHERE type='%s' AND media_type=%s.media_type; "
+                             "END",
+                             type, row, when, type,
+                             type, row, row, type,
+                             type, row));
+    }
+  }
+
+  // only movies and music videos carry a watched count
+  std::string sql = "CREATE TRIGGER navsummary_playcount AFTER UPDATE ON files FOR EACH ROW BEGIN ";
+  for (const char *type : NavSummaryTypes)
+  {
+    sql += PrepareSQL("DELETE FROM navsummary WHERE type='%s' AND media_type='movie' AND (old.playCount IS NULL) <> (new.playCount IS NULL) AND "
+                      "item_id IN (SELECT %s_link.%s_id FROM %s_link JOIN movie ON movie.idMovie=%s_link.media_id WHERE %s_link.media_type='movie' AND movie.idFile=new.idFile); ",
+                      type, type, type, type, type, type);
+    sql += PrepareSQL("DELETE FROM navsummary WHERE type='%s' AND media_type='musicvideo' AND (old.playCount IS NULL) <> (new.playCount IS NULL) AND "
+                      "item_id IN (SELECT %s_link.%s_id FROM %s_link JOIN musicvideo ON musicvideo.idMVideo=%s_link.media_id WHERE %s_link.media_type='musicvideo' AND musicvideo.idFile=new.idFile); ",
+                      type, type, type, type, type, type);
+  }
+  sql += "UPDATE navsummary_state SET dirty=1 WHERE media_type IN ('movie', 'musicvideo') AND (old.playCount IS NULL) <> (new.playCount IS NULL); "
+         "END";
+  m_pDS->exec(sql);
 }
 
 void CVideoDatabase::CreateLinkIndex(const char *table)
@@ -281,6 +346,8 @@ void CVideoDatabase::CreateAnalytics()
   CreateLinkIndex("genre");
   CreateLinkIndex("country");
 
+  CreateRevisionIndex();
+
   CLog::Log(LOGINFO, "%s - creating triggers", __FUNCTION__);
   m_pDS->exec("CREATE TRIGGER delete_movie AFTER DELETE ON movie FOR EACH ROW BEGIN "
               "DELETE FROM genre_link WHERE media_id=old.idMovie AND media_type='movie'; "
@@ -293,7 +360,8 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM art WHERE media_id=old.idMovie AND media_type='movie'; "
               "DELETE FROM tag_link WHERE media_id=old.idMovie AND media_type='movie'; "
               "DELETE FROM rating WHERE media_id=old.idMovie AND media_type='movie'; "
-              "DELETE FROM uniqueid WHERE media_id=old.idMovie AND media_type='movie'; "
+              "DELETE FROM uniqueid WHERE media_id=old.idMovie AND media_type='movie'; " +
+              GetRevisionSQL(MediaTypeMovie, "old.idMovie", true) +
               "END");
   m_pDS->exec("CREATE TRIGGER delete_tvshow AFTER DELETE ON tvshow FOR EACH ROW BEGIN "
               "DELETE FROM actor_link WHERE media_id=old.idShow AND media_type='tvshow'; "
@@ -306,7 +374,8 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM art WHERE media_id=old.idShow AND media_type='tvshow'; "
               "DELETE FROM tag_link WHERE media_id=old.idShow AND media_type='tvshow'; "
               "DELETE FROM rating WHERE media_id=old.idShow AND media_type='tvshow'; "
-              "DELETE FROM uniqueid WHERE media_id=old.idShow AND media_type='tvshow'; "
+              "DELETE FROM uniqueid WHERE media_id=old.idShow AND media_type='tvshow'; " +
+              GetRevisionSQL(MediaTypeTvShow, "old.idShow", true) +
               "END");
   m_pDS->exec("CREATE TRIGGER delete_musicvideo AFTER DELETE ON musicvideo FOR EACH ROW BEGIN "
               "DELETE FROM actor_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
@@ -314,7 +383,8 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM genre_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
               "DELETE FROM studio_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
               "DELETE FROM art WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
-              "DELETE FROM tag_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
+              "DELETE FROM tag_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; " +
+              GetRevisionSQL(MediaTypeMusicVideo, "old.idMVideo", true) +
               "END");
   m_pDS->exec("CREATE TRIGGER delete_episode AFTER DELETE ON episode FOR EACH ROW BEGIN "
               "DELETE FROM actor_link WHERE media_id=old.idEpisode AND media_type='episode'; "
@@ -322,7 +392,8 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM writer_link WHERE media_id=old.idEpisode AND media_type='episode'; "
               "DELETE FROM art WHERE media_id=old.idEpisode AND media_type='episode'; "
               "DELETE FROM rating WHERE media_id=old.idEpisode AND media_type='episode'; "
-              "DELETE FROM uniqueid WHERE media_id=old.idEpisode AND media_type='episode'; "
+              "DELETE FROM uniqueid WHERE media_id=old.idEpisode AND media_type='episode'; " +
+              GetRevisionSQL(MediaTypeEpisode, "old.idEpisode", true) +
               "END");
   m_pDS->exec("CREATE TRIGGER delete_season AFTER DELETE ON seasons FOR EACH ROW BEGIN "
               "DELETE FROM art WHERE media_id=old.idSeason AND media_type='season'; "
@@ -343,9 +414,42 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM streamdetails WHERE idFile=old.idFile; "
               "END");
 
+  // library revisions for clients listing only what changed, see GetRevision()
+  CreateRevisionTriggers(MediaTypeMovie, "movie", "idMovie");
+  CreateRevisionTriggers(MediaTypeTvShow, "tvshow", "idShow");
+  CreateRevisionTriggers(MediaTypeEpisode, "episode", "idEpisode");
+  CreateRevisionTriggers(MediaTypeMusicVideo, "musicvideo", "idMVideo");
+
+  // playcount, last played and resume points live with the file, BEFORE as files already
+  // has an AFTER UPDATE trigger and MySQL allows only one
+  std::string fileRevisions = GetRevisionSQL(MediaTypeMovie, "idMovie", false, "movie WHERE idFile=%s.idFile") +
+                              GetRevisionSQL(MediaTypeEpisode, "idEpisode", false, "episode WHERE idFile=%s.idFile") +
+                              GetRevisionSQL(MediaTypeMusicVideo, "idMVideo", false, "musicvideo WHERE idFile=%s.idFile");
+  m_pDS->exec("CREATE TRIGGER revision_files_update BEFORE UPDATE ON files FOR EACH ROW BEGIN " +
+              StringUtils::Format(fileRevisions.c_str(), "new", "new", "new") + "END");
+  m_pDS->exec("CREATE TRIGGER revision_bookmark_insert AFTER INSERT ON bookmark FOR EACH ROW BEGIN " +
+              StringUtils::Format(fileRevisions.c_str(), "new", "new", "new") + "END");
+  m_pDS->exec("CREATE TRIGGER revision_bookmark_delete AFTER DELETE ON bookmark FOR EACH ROW BEGIN " +
+              StringUtils::Format(fileRevisions.c_str(), "old", "old", "old") + "END");
+
+  m_pDS->exec("CREATE UNIQUE INDEX ix_navsummary ON navsummary (type(20), media_type(20), item_id)");
+  CreateNavSummaryTriggers();
+
+  // full-text indexes for the search window
+  CreateFullTextIndex("moviesearch", "movie", "idMovie", { ColumnName(VIDEODB_ID_TITLE), ColumnName(VIDEODB_ID_PLOT),
+                                                           ColumnName(VIDEODB_ID_PLOTOUTLINE), ColumnName(VIDEODB_ID_TAGLINE) });
+  CreateFullTextIndex("tvshowsearch", "tvshow", "idShow", { ColumnName(VIDEODB_ID_TV_TITLE) });
+  CreateFullTextIndex("episodesearch", "episode", "idEpisode", { ColumnName(VIDEODB_ID_EPISODE_TITLE), ColumnName(VIDEODB_ID_EPISODE_PLOT) });
+  CreateFullTextIndex("musicvideosearch", "musicvideo", "idMVideo", { ColumnName(VIDEODB_ID_MUSICVIDEO_TITLE) });
+
   CreateViews();
 }
 
+std::string CVideoDatabase::ColumnName(int field)
+{
+  return StringUtils::Format("c%02d", field);
+}
+
 void CVideoDatabase::CreateViews()
 {
   CLog::Log(LOGINFO, "create episode_view");
@@ -529,8 +633,8 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
-    strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
-    m_pDS->query(strSQL);
+    strSQL="select idPath from path where strPath=?";
+    m_pDS->query(strSQL, { field_value(strPath1) });
     if (!m_pDS->eof())
       idPath = m_pDS->fv("path.idPath").get_asInt();
 
@@ -1066,8 +1170,8 @@ int CVideoDatabase::GetFileId(const std::string& strFilenameAndPath)
     if (idPath >= 0)
     {
       std::string strSQL;
-      strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
-      m_pDS->query(strSQL);
+      strSQL="select idFile from files where strFileName=? and idPath=?";
+      m_pDS->query(strSQL, { field_value(strFileName), field_value(idPath) });
       if (m_pDS->num_rows() > 0)
       {
         int idFile = m_pDS->fv("files.idFile").get_asInt();
@@ -2908,35 +3012,35 @@ void CVideoDatabase::SetStreamDetailsForFileId(const CStreamDetails& details, in
   try
   {
     BeginTransaction();
-    m_pDS->exec(PrepareSQL("DELETE FROM streamdetails WHERE idFile = %i", idFile));
+    m_pDS->exec("DELETE FROM streamdetails WHERE idFile = ?", { field_value(idFile) });
 
     for (int i=1; i<=details.GetVideoStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
+      m_pDS->exec("INSERT INTO streamdetails "
         "(idFile, iStreamType, strVideoCodec, fVideoAspect, iVideoWidth, iVideoHeight, iVideoDuration, strStereoMode, strVideoLanguage) "
-        "VALUES (%i,%i,'%s',%f,%i,%i,%i,'%s','%s')",
-        idFile, (int)CStreamDetail::VIDEO,
-        details.GetVideoCodec(i).c_str(), details.GetVideoAspect(i),
-        details.GetVideoWidth(i), details.GetVideoHeight(i), details.GetVideoDuration(i),
-        details.GetStereoMode(i).c_str(),
-        details.GetVideoLanguage(i).c_str()));
+        "VALUES (?,?,?,?,?,?,?,?,?)",
+        { field_value(idFile), field_value((int)CStreamDetail::VIDEO),
+          field_value(details.GetVideoCodec(i)), field_value(details.GetVideoAspect(i)),
+          field_value(details.GetVideoWidth(i)), field_value(details.GetVideoHeight(i)), field_value(details.GetVideoDuration(i)),
+          field_value(details.GetStereoMode(i)),
+          field_value(details.GetVideoLanguage(i)) });
     }
     for (int i=1; i<=details.GetAudioStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
+      m_pDS->exec("INSERT INTO streamdetails "
         "(idFile, iStreamType, strAudioCodec, iAudioChannels, strAudioLanguage) "
-        "VALUES (%i,%i,'%s',%i,'%s')",
-        idFile, (int)CStreamDetail::AUDIO,
-        details.GetAudioCodec(i).c_str(), details.GetAudioChannels(i),
-        details.GetAudioLanguage(i).c_str()));
+        "VALUES (?,?,?,?,?)",
+        { field_value(idFile), field_value((int)CStreamDetail::AUDIO),
+          field_value(details.GetAudioCodec(i)), field_value(details.GetAudioChannels(i)),
+          field_value(details.GetAudioLanguage(i)) });
     }
     for (int i=1; i<=details.GetSubtitleStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
+      m_pDS->exec("INSERT INTO streamdetails "
         "(idFile, iStreamType, strSubtitleLanguage) "
-        "VALUES (%i,%i,'%s')",
-        idFile, (int)CStreamDetail::SUBTITLE,
-        details.GetSubtitleLanguage(i).c_str()));
+        "VALUES (?,?,?)",
+        { field_value(idFile), field_value((int)CStreamDetail::SUBTITLE),
+          field_value(details.GetSubtitleLanguage(i)) });
     }
 
     // update the runtime information, if empty
@@ -3730,8 +3834,7 @@ bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
   std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
   try
   {
-    std::string strSQL = PrepareSQL("SELECT * FROM streamdetails WHERE idFile = %i", tag.m_iFileId);
-    pDS->query(strSQL);
+    pDS->query("SELECT * FROM streamdetails WHERE idFile = ?", { field_value(tag.m_iFileId) });
 
     while (!pDS->eof())
     {
@@ -3905,20 +4008,7 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMovie(const dbiplus::sql_record* cons
     details.m_strPictureURL.Parse();
 
     if (getDetails & VideoDbDetailsShowLink)
-    {
-      // create tvshowlink string
-      std::vector<int> links;
-      GetLinksToTvShow(idMovie, links);
-      for (unsigned int i = 0; i < links.size(); ++i)
-      {
-        std::string strSQL = PrepareSQL("select c%02d from tvshow where idShow=%i",
-          VIDEODB_ID_TV_TITLE, links[i]);
-        m_pDS2->query(strSQL);
-        if (!m_pDS2->eof())
-          details.m_showLink.emplace_back(m_pDS2->fv(0).get_asString());
-      }
-      m_pDS2->close();
-    }
+      GetShowLinks(idMovie, details.m_showLink);
 
     if (getDetails & VideoDbDetailsStream)
       GetStreamDetails(details);
@@ -4121,6 +4211,223 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMusicVideo(const dbiplus::sql_record*
   return details;
 }
 
+void CVideoDatabase::GetShowLinks(int idMovie, std::vector<std::string> &showLinks)
+{
+  // create tvshowlink string
+  std::vector<int> links;
+  GetLinksToTvShow(idMovie, links);
+  for (unsigned int i = 0; i < links.size(); ++i)
+  {
+    std::string strSQL = PrepareSQL("select c%02d from tvshow where idShow=%i",
+      VIDEODB_ID_TV_TITLE, links[i]);
+    m_pDS2->query(strSQL);
+    if (!m_pDS2->eof())
+      showLinks.emplace_back(m_pDS2->fv(0).get_asString());
+  }
+  m_pDS2->close();
+}
+
+void CVideoDatabase::GetDetailsForItems(CFileItemList &items, int getDetails)
+{
+  struct Section
+  {
+    MediaType mediaType;
+    int details;      // the sections GetDetailsFor<type> loads for this media type
+  };
+  static const Section sections[] = {
+    { MediaTypeMovie,      VideoDbDetailsCast | VideoDbDetailsTag | VideoDbDetailsRating | VideoDbDetailsUniqueID | VideoDbDetailsShowLink | VideoDbDetailsStream },
+    { MediaTypeTvShow,     VideoDbDetailsCast | VideoDbDetailsTag | VideoDbDetailsRating | VideoDbDetailsUniqueID },
+    { MediaTypeEpisode,    VideoDbDetailsCast | VideoDbDetailsRating | VideoDbDetailsUniqueID | VideoDbDetailsBookmark | VideoDbDetailsStream },
+    { MediaTypeMusicVideo, VideoDbDetailsTag | VideoDbDetailsStream },
+  };
+
+  if (getDetails == VideoDbDetailsNone)
+    return;
+
+  try
+  {
+    if (!m_pDB.get()) return;
+    if (!m_pDS2.get()) return;
+
+    for (const auto &section : sections)
+    {
+      // collect the tags of this type that miss some of the wanted sections
+      std::map<int, CVideoInfoTag*> tags;
+      int missing = 0;
+      for (const auto &item : items)
+      {
+        if (!item->HasVideoInfoTag())
+          continue;
+        CVideoInfoTag *tag = item->GetVideoInfoTag();
+        if (tag->m_type != section.mediaType || tag->m_iDbId <= 0)
+          continue;
+        int wanted = getDetails & section.details & ~tag->m_parsedDetails;
+        if (wanted == 0 && tag->m_parsedDetails != 0)
+          continue;
+        tags.insert(std::make_pair(tag->m_iDbId, tag));
+        missing |= wanted;
+      }
+      if (tags.empty())
+        continue;
+
+      // fetch the sections keyed on media id in batches
+      auto batchStart = tags.begin();
+      while (batchStart != tags.end())
+      {
+        std::vector<int> ids;
+        auto batchEnd = batchStart;
+        for (; batchEnd != tags.end() && ids.size() < VIDEODB_DETAILS_BATCH_SIZE; ++batchEnd)
+          ids.push_back(batchEnd->first);
+
+        std::vector<std::string> idStrings;
+        for (int id : ids)
+          idStrings.push_back(StringUtils::Format("%i", id));
+        std::string idList = StringUtils::Join(idStrings, ",");
+
+        if (missing & VideoDbDetailsCast)
+        {
+          std::map<int, std::vector<SActorInfo>> cast;
+          GetCastForItems(section.mediaType, ids, cast);
+
+          // episodes inherit the cast of their show
+          std::map<int, std::vector<SActorInfo>> showCast;
+          if (section.mediaType == MediaTypeEpisode)
+          {
+            std::set<int> showIds;
+            for (auto it = batchStart; it != batchEnd; ++it)
+              showIds.insert(it->second->m_iIdShow);
+            GetCastForItems(MediaTypeTvShow, std::vector<int>(showIds.begin(), showIds.end()), showCast);
+          }
+
+          for (auto it = batchStart; it != batchEnd; ++it)
+          {
+            CVideoInfoTag *tag = it->second;
+            if (tag->m_parsedDetails & VideoDbDetailsCast)
+              continue;
+            std::vector<SActorInfo> &tagCast = tag->m_cast;
+            tagCast = std::move(cast[it->first]);
+            if (section.mediaType == MediaTypeEpisode)
+            {
+              for (const auto &actor : showCast[tag->m_iIdShow])
+              {
+                if (std::find_if(tagCast.begin(), tagCast.end(), [&actor](const SActorInfo &a) { return a.strName == actor.strName; }) == tagCast.end())
+                  tagCast.push_back(actor);
+              }
+            }
+          }
+        }
+
+        if (missing & VideoDbDetailsTag)
+        {
+          m_pDS2->query(PrepareSQL("SELECT tag_link.media_id, tag.name FROM tag INNER JOIN tag_link ON tag_link.tag_id = tag.tag_id "
+                                   "WHERE tag_link.media_id IN (%s) AND tag_link.media_type = '%s' ORDER BY tag.tag_id", idList.c_str(), section.mediaType.c_str()));
+          while (!m_pDS2->eof())
+          {
+            auto tag = tags.find(m_pDS2->fv(0).get_asInt());
+            if (tag != tags.end() && !(tag->second->m_parsedDetails & VideoDbDetailsTag))
+              tag->second->m_tags.emplace_back(m_pDS2->fv(1).get_asString());
+            m_pDS2->next();
+          }
+          m_pDS2->close();
+        }
+
+        if (missing & VideoDbDetailsRating)
+        {
+          m_pDS2->query(PrepareSQL("SELECT rating.media_id, rating.rating_type, rating.rating, rating.votes FROM rating "
+                                   "WHERE rating.media_id IN (%s) AND rating.media_type = '%s'", idList.c_str(), section.mediaType.c_str()));
+          while (!m_pDS2->eof())
+          {
+            auto tag = tags.find(m_pDS2->fv(0).get_asInt());
+            if (tag != tags.end() && !(tag->second->m_parsedDetails & VideoDbDetailsRating))
+              tag->second->m_ratings[m_pDS2->fv(1).get_asString()] = CRating(m_pDS2->fv(2).get_asFloat(), m_pDS2->fv(3).get_asInt());
+            m_pDS2->next();
+          }
+          m_pDS2->close();
+        }
+
+        if (missing & VideoDbDetailsUniqueID)
+        {
+          m_pDS2->query(PrepareSQL("SELECT media_id, type, value FROM uniqueid WHERE media_id IN (%s) AND media_type = '%s'",
+                                   idList.c_str(), section.mediaType.c_str()));
+          while (!m_pDS2->eof())
+          {
+            auto tag = tags.find(m_pDS2->fv(0).get_asInt());
+            if (tag != tags.end() && !(tag->second->m_parsedDetails & VideoDbDetailsUniqueID))
+              tag->second->SetUniqueID(m_pDS2->fv(2).get_asString(), m_pDS2->fv(1).get_asString());
+            m_pDS2->next();
+          }
+          m_pDS2->close();
+        }
+
+        batchStart = batchEnd;
+      }
+
+      // the remaining sections are rarely asked for in listings, load them per item
+      for (auto &it : tags)
+      {
+        CVideoInfoTag *tag = it.second;
+        int wanted = getDetails & section.details & ~tag->m_parsedDetails;
+
+        if (wanted & VideoDbDetailsShowLink)
+          GetShowLinks(tag->m_iDbId, tag->m_showLink);
+        if (wanted & VideoDbDetailsBookmark)
+          GetBookMarkForEpisode(*tag, tag->m_EpBookmark);
+        if (wanted & VideoDbDetailsStream)
+          GetStreamDetails(*tag);
+
+        if (tag->m_parsedDetails == 0)
+          tag->m_strPictureURL.Parse();
+        tag->m_parsedDetails |= getDetails;
+      }
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+}
+
+void CVideoDatabase::GetCastForItems(const std::string &media_type, const std::vector<int> &ids, std::map<int, std::vector<SActorInfo>> &cast)
+{
+  if (ids.empty())
+    return;
+
+  std::vector<std::string> idStrings;
+  for (int id : ids)
+    idStrings.push_back(StringUtils::Format("%i", id));
+
+  std::string sql = PrepareSQL("SELECT actor_link.media_id,"
+                               "  actor.name,"
+                               "  actor_link.role,"
+                               "  actor_link.cast_order,"
+                               "  actor.art_urls,"
+                               "  art.url "
+                               "FROM actor_link"
+                               "  JOIN actor ON"
+                               "    actor_link.actor_id=actor.actor_id"
+                               "  LEFT JOIN art ON"
+                               "    art.media_id=actor.actor_id AND art.media_type='actor' AND art.type='thumb' "
+                               "WHERE actor_link.media_id IN (%s) AND actor_link.media_type='%s' "
+                               "ORDER BY actor_link.media_id, actor_link.cast_order", StringUtils::Join(idStrings, ",").c_str(), media_type.c_str());
+  m_pDS2->query(sql);
+  while (!m_pDS2->eof())
+  {
+    std::vector<SActorInfo> &itemCast = cast[m_pDS2->fv(0).get_asInt()];
+    SActorInfo info;
+    info.strName = m_pDS2->fv(1).get_asString();
+    if (std::find_if(itemCast.begin(), itemCast.end(), [&info](const SActorInfo &a) { return a.strName == info.strName; }) == itemCast.end())
+    {
+      info.strRole = m_pDS2->fv(2).get_asString();
+      info.order = m_pDS2->fv(3).get_asInt();
+      info.thumbUrl.ParseString(m_pDS2->fv(4).get_asString());
+      info.thumb = m_pDS2->fv(5).get_asString();
+      itemCast.emplace_back(std::move(info));
+    }
+    m_pDS2->next();
+  }
+  m_pDS2->close();
+}
+
 void CVideoDatabase::GetCast(int media_id, const std::string &media_type, std::vector<SActorInfo> &cast)
 {
   try
@@ -4553,6 +4860,33 @@ bool CVideoDatabase::GetArtTypes(const MediaType &mediaType, std::vector<std::st
   return false;
 }
 
+bool CVideoDatabase::GetArtURLs(std::vector<std::string> &urls)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    int numRows = RunQuery("SELECT DISTINCT url FROM art");
+    if (numRows <= 0)
+      return numRows == 0;
+
+    urls.reserve(urls.size() + numRows);
+    while (!m_pDS->eof())
+    {
+      urls.emplace_back(m_pDS->fv(0).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
 /// \brief GetStackTimes() obtains any saved video times for the stacked file
 /// \retval Returns true if the stack times exist, false otherwise.
 bool CVideoDatabase::GetStackTimes(const std::string &filePath, std::vector<uint64_t> &times)
@@ -5286,11 +5620,17 @@ void CVideoDatabase::UpdateTables(int iVersion)
     m_pDS->exec("DROP TABLE settings");
     m_pDS->exec("ALTER TABLE settingsnew RENAME TO settings");
   }
+
+  if (iVersion < 110)
+    CreateNavSummaryTables();
+
+  if (iVersion < 112)
+    CreateRevisionTable();
 }
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 109;
+  return 112;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
@@ -5670,6 +6010,9 @@ bool CVideoDatabase::GetNavCommon(const std::string& strBaseDir, CFileItemList&
     }
     else
     {
+      if (!countOnly && GetNavSummary(strBaseDir, items, type, idContent, filter))
+        return true;
+
       std::string view, view_id, media_type, extraField, extraJoin;
       if (idContent == VIDEODB_CONTENT_MOVIES)
       {
@@ -5812,6 +6155,109 @@ bool CVideoDatabase::GetNavCommon(const std::string& strBaseDir, CFileItemList&
   return false;
 }
 
+bool CVideoDatabase::GetNavSummary(const std::string& strBaseDir, CFileItemList& items, const char *type, int idContent, const Filter &filter)
+{
+  if (std::find(std::begin(NavSummaryTypes), std::end(NavSummaryTypes), std::string(type)) == std::end(NavSummaryTypes))
+    return false;
+
+  // the summary only covers whole nodes, anything filtered goes through the regular query
+  if (!filter.where.empty() || !filter.join.empty() || !filter.order.empty() || !filter.limit.empty())
+    return false;
+
+  CVideoDbUrl videoUrl;
+  if (!videoUrl.FromString(strBaseDir) || !videoUrl.GetOptions().empty())
+    return false;
+
+  std::string mediaType, mediaId, watched;
+  if (idContent == VIDEODB_CONTENT_MOVIES)
+  {
+    mediaType = MediaTypeMovie;
+    mediaId   = "idMovie";
+    watched   = "count(files.playCount)";
+  }
+  else if (idContent == VIDEODB_CONTENT_TVSHOWS)
+  {
+    mediaType = MediaTypeTvShow;
+    mediaId   = "idShow";
+    watched   = "0";
+  }
+  else if (idContent == VIDEODB_CONTENT_MUSICVIDEOS)
+  {
+    mediaType = MediaTypeMusicVideo;
+    mediaId   = "idMVideo";
+    watched   = "count(files.playCount)";
+  }
+  else
+    return false;
+
+  bool refreshing = false;
+  try
+  {
+    // recompute the rows dropped by the triggers since the node was last listed
+    if (RunQuery(PrepareSQL("SELECT dirty FROM navsummary_state WHERE type='%s' AND media_type='%s'", type, mediaType.c_str())) <= 0)
+      return false;
+    bool dirty = m_pDS->fv(0).get_asInt() != 0;
+    m_pDS->close();
+
+    if (dirty)
+    {
+      std::string join = PrepareSQL("JOIN %s ON %s.%s = %s_link.media_id", mediaType.c_str(), mediaType.c_str(), mediaId.c_str(), type);
+      if (idContent != VIDEODB_CONTENT_TVSHOWS)
+        join += PrepareSQL(" JOIN files ON files.idFile = %s.idFile", mediaType.c_str());
+
+      BeginTransaction();
+      refreshing = true;
+      m_pDS->exec(PrepareSQL("INSERT INTO navsummary (type, media_type, item_id, total, watched) "
+                             "SELECT '%s', '%s', %s_link.%s_id, count(1), %s FROM %s_link %s "
+                             "WHERE %s_link.media_type = '%s' AND %s_link.%s_id NOT IN (SELECT item_id FROM navsummary WHERE type='%s' AND media_type='%s') "
+                             "GROUP BY %s_link.%s_id",
+                             type, mediaType.c_str(), type, type, watched.c_str(), type, join.c_str(),
+                             type, mediaType.c_str(), type, type, type, mediaType.c_str(),
+                             type, type));
+      m_pDS->exec(PrepareSQL("UPDATE navsummary_state SET dirty=0 WHERE type='%s' AND media_type='%s'", type, mediaType.c_str()));
+      refreshing = false;
+      if (!CommitTransaction())
+        return false;
+    }
+
+    if (RunQuery(PrepareSQL("SELECT navsummary.item_id, %s.name, navsummary.total, navsummary.watched FROM navsummary "
+                            "JOIN %s ON %s.%s_id = navsummary.item_id WHERE navsummary.type='%s' AND navsummary.media_type='%s'",
+                            type, type, type, type, type, mediaType.c_str())) < 0)
+      return false;
+
+    CFileItemList nodes;
+    while (!m_pDS->eof())
+    {
+      CFileItemPtr pItem(new CFileItem(m_pDS->fv(1).get_asString()));
+      pItem->GetVideoInfoTag()->m_iDbId = m_pDS->fv(0).get_asInt();
+      pItem->GetVideoInfoTag()->m_type = type;
+
+      CVideoDbUrl itemUrl = videoUrl;
+      std::string path = StringUtils::Format("%i/", m_pDS->fv(0).get_asInt());
+      itemUrl.AppendPath(path);
+      pItem->SetPath(itemUrl.ToString());
+
+      pItem->m_bIsFolder = true;
+      pItem->SetLabelPreformatted(true);
+      if (idContent == VIDEODB_CONTENT_MOVIES || idContent == VIDEODB_CONTENT_MUSICVIDEOS)
+        pItem->GetVideoInfoTag()->SetPlayCount((m_pDS->fv(3).get_asInt() == m_pDS->fv(2).get_asInt()) ? 1 : 0);
+      nodes.Add(pItem);
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    items.Append(nodes);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed for %s nodes", __FUNCTION__, type);
+    if (refreshing)
+      RollbackTransaction();
+  }
+  return false;
+}
+
 bool CVideoDatabase::GetTagsNav(const std::string& strBaseDir, CFileItemList& items, int idContent /* = -1 */, const Filter &filter /* = Filter() */, bool countOnly /* = false */)
 {
   return GetNavCommon(strBaseDir, items, "tag", idContent, filter, countOnly);
@@ -6777,6 +7223,50 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
+    auto addMovie = [&](const dbiplus::sql_record* const record)
+    {
+      CVideoInfoTag movie = GetDetailsForMovie(record);
+      if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
+          g_passwordManager.bMasterUser                                   ||
+          g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
+      {
+        CFileItemPtr pItem(new CFileItem(movie));
+
+        CVideoDbUrl itemUrl = videoUrl;
+        std::string path = StringUtils::Format("%i", movie.m_iDbId);
+        itemUrl.AppendPath(path);
+        pItem->SetPath(itemUrl.ToString());
+
+        pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.GetPlayCount() > 0);
+        items.Add(pItem);
+      }
+    };
+
+    // without sorting the rows are used in the order they're returned, so
+    // read them one at a time instead of holding the whole result in memory
+    if (sortDescription.sortBy == SortByNone)
+    {
+      unsigned int time = XbmcThreads::SystemClockMillis();
+      if (!m_pDS->query_forward_only(strSQL))
+        return false;
+
+      int rows = 0;
+      while (!m_pDS->eof())
+      {
+        addMovie(m_pDS->get_sql_record());
+        rows++;
+        m_pDS->next();
+      }
+      m_pDS->close();
+      CLog::Log(LOGDEBUG, LOGDATABASE, "%s took %d ms for %d items query: %s", __FUNCTION__, XbmcThreads::SystemClockMillis() - time, rows, strSQL.c_str());
+
+      GetDetailsForItems(items, getDetails);
+
+      if (rows > 0)
+        items.SetProperty("total", total < rows ? rows : total);
+      return true;
+    }
+
     int iRowsFound = RunQuery(strSQL);
     if (iRowsFound <= 0)
       return iRowsFound == 0;
@@ -6798,27 +7288,13 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
-
-      CVideoInfoTag movie = GetDetailsForMovie(record, getDetails);
-      if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
-          g_passwordManager.bMasterUser                                   ||
-          g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
-      {
-        CFileItemPtr pItem(new CFileItem(movie));
-
-        CVideoDbUrl itemUrl = videoUrl;
-        std::string path = StringUtils::Format("%i", movie.m_iDbId);
-        itemUrl.AppendPath(path);
-        pItem->SetPath(itemUrl.ToString());
-
-        pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.GetPlayCount() > 0);
-        items.Add(pItem);
-      }
+      addMovie(data.at(targetRow));
     }
 
     // cleanup
     m_pDS->close();
+
+    GetDetailsForItems(items, getDetails);
     return true;
   }
   catch (...)
@@ -6908,7 +7384,7 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
       const dbiplus::sql_record* const record = data.at(targetRow);
       
       CFileItemPtr pItem(new CFileItem());
-      CVideoInfoTag movie = GetDetailsForTvShow(record, getDetails, pItem.get());
+      CVideoInfoTag movie = GetDetailsForTvShow(record, VideoDbDetailsNone, pItem.get());
       if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
            g_passwordManager.bMasterUser                                     ||
            g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
@@ -6927,6 +7403,8 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
 
     // cleanup
     m_pDS->close();
+
+    GetDetailsForItems(items, getDetails);
     return true;
   }
   catch (...)
@@ -7035,7 +7513,7 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
       const dbiplus::sql_record* const record = data.at(targetRow);
 
-      CVideoInfoTag movie = GetDetailsForEpisode(record, getDetails);
+      CVideoInfoTag movie = GetDetailsForEpisode(record);
       if (m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                     ||
           g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
@@ -7062,6 +7540,8 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
 
     // cleanup
     m_pDS->close();
+
+    GetDetailsForItems(items, getDetails);
     return true;
   }
   catch (...)
@@ -7875,7 +8355,7 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
       const dbiplus::sql_record* const record = data.at(targetRow);
       
-      CVideoInfoTag musicvideo = GetDetailsForMusicVideo(record, getDetails);
+      CVideoInfoTag musicvideo = GetDetailsForMusicVideo(record);
       if (!checkLocks || m_profileManager.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE || g_passwordManager.bMasterUser ||
           g_passwordManager.IsDatabasePathUnlocked(musicvideo.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
       {
@@ -7893,6 +8373,8 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
 
     // cleanup
     m_pDS->close();
+
+    GetDetailsForItems(items, getDetails);
     return true;
   }
   catch (...)
@@ -8028,10 +8510,14 @@ void CVideoDatabase::GetMoviesByName(const std::string& strSearch, CFileItemList
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    Filter filter;
+    if (!AppendFullTextSearch("moviesearch", "movie.idMovie", { ColumnName(VIDEODB_ID_TITLE) }, strSearch, filter))
+      filter.AppendWhere(PrepareSQL("movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE, strSearch.c_str()));
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath", VIDEODB_ID_TITLE), filter, strSQL);
     else
-      strSQL = PrepareSQL("select movie.idMovie,movie.c%02d, movie.idSet from movie where movie.c%02d like '%%%s%%'",VIDEODB_ID_TITLE,VIDEODB_ID_TITLE,strSearch.c_str());
+      BuildSQL(PrepareSQL("select movie.idMovie,movie.c%02d, movie.idSet from movie", VIDEODB_ID_TITLE), filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8073,10 +8559,14 @@ void CVideoDatabase::GetTvShowsByName(const std::string& strSearch, CFileItemLis
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    Filter filter;
+    if (!AppendFullTextSearch("tvshowsearch", "tvshow.idShow", { ColumnName(VIDEODB_ID_TV_TITLE) }, strSearch, filter))
+      filter.AppendWhere(PrepareSQL("tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, strSearch.c_str()));
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, VIDEODB_ID_TV_TITLE, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath", VIDEODB_ID_TV_TITLE), filter, strSQL);
     else
-      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where tvshow.c%02d like '%%%s%%'",VIDEODB_ID_TV_TITLE,VIDEODB_ID_TV_TITLE,strSearch.c_str());
+      BuildSQL(PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow", VIDEODB_ID_TV_TITLE), filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8114,10 +8604,14 @@ void CVideoDatabase::GetEpisodesByName(const std::string& strSearch, CFileItemLi
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    Filter filter;
+    if (!AppendFullTextSearch("episodesearch", "episode.idEpisode", { ColumnName(VIDEODB_ID_EPISODE_TITLE) }, strSearch, filter))
+      filter.AppendWhere(PrepareSQL("episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, strSearch.c_str()));
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE), filter, strSQL);
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d like '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE), filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8157,10 +8651,14 @@ void CVideoDatabase::GetMusicVideosByName(const std::string& strSearch, CFileIte
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    Filter filter;
+    if (!AppendFullTextSearch("musicvideosearch", "musicvideo.idMVideo", { ColumnName(VIDEODB_ID_MUSICVIDEO_TITLE) }, strSearch, filter))
+      filter.AppendWhere(PrepareSQL("musicvideo.c%02d LIKE '%%%s%%'", VIDEODB_ID_MUSICVIDEO_TITLE, strSearch.c_str()));
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE musicvideo.c%02d LIKE '%%%s%%'", VIDEODB_ID_MUSICVIDEO_TITLE, VIDEODB_ID_MUSICVIDEO_TITLE, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath", VIDEODB_ID_MUSICVIDEO_TITLE), filter, strSQL);
     else
-      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where musicvideo.c%02d like '%%%s%%'",VIDEODB_ID_MUSICVIDEO_TITLE,VIDEODB_ID_MUSICVIDEO_TITLE,strSearch.c_str());
+      BuildSQL(PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo", VIDEODB_ID_MUSICVIDEO_TITLE), filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8204,10 +8702,14 @@ void CVideoDatabase::GetEpisodesByPlot(const std::string& strSearch, CFileItemLi
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    Filter filter;
+    if (!AppendFullTextSearch("episodesearch", "episode.idEpisode", { ColumnName(VIDEODB_ID_EPISODE_PLOT) }, strSearch, filter))
+      filter.AppendWhere(PrepareSQL("episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_PLOT, strSearch.c_str()));
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE), filter, strSQL);
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE), filter, strSQL);
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8243,10 +8745,14 @@ void CVideoDatabase::GetMoviesByPlot(const std::string& strSearch, CFileItemList
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    Filter filter;
+    if (!AppendFullTextSearch("moviesearch", "movie.idMovie", { ColumnName(VIDEODB_ID_PLOT), ColumnName(VIDEODB_ID_PLOTOUTLINE), ColumnName(VIDEODB_ID_TAGLINE) }, strSearch, filter))
+      filter.AppendWhere(PrepareSQL("(movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%')", VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE, strSearch.c_str()));
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE,VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE,strSearch.c_str());
+      BuildSQL(PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath", VIDEODB_ID_TITLE), filter, strSQL);
     else
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie WHERE (movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%')", VIDEODB_ID_TITLE, VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE, strSearch.c_str());
+      BuildSQL(PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie", VIDEODB_ID_TITLE), filter, strSQL);
 
     m_pDS->query( strSQL );
 
@@ -8450,8 +8956,8 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
     VECSOURCES videoSources(*CMediaSourceSettings::GetInstance().GetSources("video"));
     g_mediaManager.GetRemovableDrives(videoSources);
 
-    int total = m_pDS->num_rows();
-    int current = 0;
+    // files that have to be looked for, by the source they are in
+    std::map<int, std::vector<std::pair<std::string, std::string>>> filesBySource;
 
     while (!m_pDS->eof())
     {
@@ -8468,35 +8974,80 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
       if (URIUtils::IsInArchive(fullPath))
         fullPath = CURL(fullPath).GetHostName();
 
-      // remove optical, non-existing files, files with no matching source
+      // remove optical files and files with no matching source, the others if they don't exist
       bool bIsSource;
-      if (URIUtils::IsOnDVD(fullPath) || !CFile::Exists(fullPath, false) ||
-          CUtil::GetMatchingSource(fullPath, videoSources, bIsSource) < 0)
+      int source = -1;
+      if (URIUtils::IsOnDVD(fullPath) ||
+          (source = CUtil::GetMatchingSource(fullPath, videoSources, bIsSource)) < 0)
         filesToTestForDelete += m_pDS->fv("files.idFile").get_asString() + ",";
+      else
+        filesBySource[source].emplace_back(m_pDS->fv("files.idFile").get_asString(), fullPath);
+
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    // a source that is offline would let every file in it time out, its files
+    // are left to CleanMediaType which asks what to do with them
+    std::vector<std::string> sourcePaths;
+    for (const auto &source : filesBySource)
+      sourcePaths.push_back(videoSources[source.first].strPath);
+
+    CExistsChecker checker;
+    std::vector<CExistsChecker::Result> sourcesOnline = checker.Check(sourcePaths, true);
+
+    std::vector<std::string> fileIDs;
+    std::vector<std::string> filePaths;
+    size_t i = 0;
+    for (const auto &source : filesBySource)
+    {
+      const bool online = sourcesOnline[i++] == CExistsChecker::EXISTS;
+      if (!online)
+        CLog::Log(LOGWARNING, "%s: Source %s is not available, not looking for its %u files", __FUNCTION__,
+                  CURL::GetRedacted(videoSources[source.first].strPath).c_str(), static_cast<unsigned int>(source.second.size()));
 
-      if (handle == NULL && progress != NULL)
+      for (const auto &file : source.second)
       {
-        int percentage = current * 100 / total;
-        if (percentage > progress->GetPercentage())
+        if (online)
         {
-          progress->SetPercentage(percentage);
-          progress->Progress();
+          fileIDs.push_back(file.first);
+          filePaths.push_back(file.second);
         }
-        if (progress->IsCanceled())
+        else
+          filesToTestForDelete += file.first + ",";
+      }
+    }
+
+    std::vector<CExistsChecker::Result> filesExist = checker.Check(filePaths, false,
+      [handle, progress](size_t done, size_t total)
+      {
+        if (handle != NULL)
+          handle->SetPercentage(done * 100 / (float)total);
+        else if (progress != NULL)
         {
-          progress->Close();
-          m_pDS->close();
-          ANNOUNCEMENT::CAnnouncementManager::GetInstance().Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnCleanFinished");
-          return;
+          int percentage = static_cast<int>(done * 100 / total);
+          if (percentage > progress->GetPercentage())
+          {
+            progress->SetPercentage(percentage);
+            progress->Progress();
+          }
+          return !progress->IsCanceled();
         }
-      }
-      else if (handle != NULL)
-        handle->SetPercentage(current * 100 / (float)total);
+        return true;
+      });
 
-      m_pDS->next();
-      current++;
+    if (handle == NULL && progress != NULL && progress->IsCanceled())
+    {
+      progress->Close();
+      ANNOUNCEMENT::CAnnouncementManager::GetInstance().Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnCleanFinished");
+      return;
+    }
+
+    for (i = 0; i < filesExist.size(); i++)
+    {
+      if (filesExist[i] == CExistsChecker::MISSING)
+        filesToTestForDelete += fileIDs[i] + ",";
     }
-    m_pDS->close();
 
     std::string filesToDelete;
 
@@ -9644,7 +10195,12 @@ void CVideoDatabase::InvalidatePathHash(const std::string& strPath)
 bool CVideoDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
-  { // number of items in the db has likely changed, so recalculate
+  {
+    // the scanners batching their writes refresh these once they are done
+    if (InBatch())
+      return true;
+
+    // number of items in the db has likely changed, so recalculate
     GUIINFO::CLibraryGUIInfo& guiInfo = CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider();
     guiInfo.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
     guiInfo.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
@@ -9864,6 +10420,10 @@ bool CVideoDatabase::GetFilter(CDbUrl &videoUrl, Filter &filter, SortDescription
 
     AppendIdLinkFilter("tag", "tag", "movie", "movie", "idMovie", options, filter);
     AppendLinkFilter("tag", "tag", "movie", "movie", "idMovie", options, filter);
+
+    option = options.find("revision");
+    if (option != options.end())
+      filter.AppendWhere(GetChangedSinceCondition("movie_view.idMovie", MediaTypeMovie, (int)option->second.asInteger()));
   }
   else if (type == "tvshows")
   {
@@ -9886,6 +10446,10 @@ bool CVideoDatabase::GetFilter(CDbUrl &videoUrl, Filter &filter, SortDescription
 
       AppendIdLinkFilter("tag", "tag", "tvshow", "tvshow", "idShow", options, filter);
       AppendLinkFilter("tag", "tag", "tvshow", "tvshow", "idShow", options, filter);
+
+      option = options.find("revision");
+      if (option != options.end())
+        filter.AppendWhere(GetChangedSinceCondition("tvshow_view.idShow", MediaTypeTvShow, (int)option->second.asInteger()));
     }
     else if (itemType == "seasons")
     {
@@ -9956,6 +10520,10 @@ bool CVideoDatabase::GetFilter(CDbUrl &videoUrl, Filter &filter, SortDescription
         AppendIdLinkFilter("director", "actor", "episode", "episode", "idEpisode", options, filter);
         AppendLinkFilter("director", "actor", "episode", "episode", "idEpisode", options, filter);
       }
+
+      option = options.find("revision");
+      if (option != options.end())
+        filter.AppendWhere(GetChangedSinceCondition("episode_view.idEpisode", MediaTypeEpisode, (int)option->second.asInteger()));
     }
   }
   else if (type == "musicvideos")
@@ -9998,6 +10566,10 @@ bool CVideoDatabase::GetFilter(CDbUrl &videoUrl, Filter &filter, SortDescription
 
     AppendIdLinkFilter("tag", "tag", "musicvideo", "musicvideo", "idMVideo", options, filter);
     AppendLinkFilter("tag", "tag", "musicvideo", "musicvideo", "idMVideo", options, filter);
+
+    option = options.find("revision");
+    if (option != options.end())
+      filter.AppendWhere(GetChangedSinceCondition("musicvideo_view.idMVideo", MediaTypeMusicVideo, (int)option->second.asInteger()));
   }
   else
     return false;
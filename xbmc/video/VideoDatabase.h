@@ -40,7 +40,7 @@ class CGUIDialogProgressBarHandle;
 namespace dbiplus
 {
   class field_value;
-  typedef std::vector<field_value> sql_record;
+  class sql_record;
 }
 
 #ifndef my_offsetof
@@ -797,6 +797,15 @@ public:
   bool GetSeasonsByWhere(const std::string& strBaseDir, const Filter &filter, CFileItemList& items, bool appendFullShowPath = true, const SortDescription &sortDescription = SortDescription());
   bool GetEpisodesByWhere(const std::string& strBaseDir, const Filter &filter, CFileItemList& items, bool appendFullShowPath = true, const SortDescription &sortDescription = SortDescription(), int getDetails = VideoDbDetailsNone);
   bool GetMusicVideosByWhere(const std::string &baseDir, const Filter &filter, CFileItemList& items, bool checkLocks = true, const SortDescription &sortDescription = SortDescription(), int getDetails = VideoDbDetailsNone);
+
+  /*! \brief Load the requested detail sections (VideoDbDetails flags) for library items that don't have them yet.
+   Cast, tags, ratings and unique ids are fetched for all items of a media type at once
+   instead of one query per item, so callers can list without details and fill in just
+   the items they are about to show.
+   \param items the items to fill in, items without a video library tag are skipped.
+   \param getDetails the detail sections wanted.
+   */
+  void GetDetailsForItems(CFileItemList &items, int getDetails);
   
   // retrieve sorted and limited items
   bool GetSortedVideos(const MediaType &mediaType, const std::string& strBaseDir, const SortDescription &sortDescription, CFileItemList& items, const Filter &filter = Filter());
@@ -842,6 +851,7 @@ public:
   bool GetTvShowNamedSeasons(int showId, std::map<int, std::string> &seasons);
   bool GetTvShowSeasonArt(int mediaId, std::map<int, std::map<std::string, std::string> > &seasonArt);
   bool GetArtTypes(const MediaType &mediaType, std::vector<std::string> &artTypes);
+  bool GetArtURLs(std::vector<std::string> &urls);
 
   int AddTag(const std::string &tag);
   void AddTagToItem(int idItem, int idTag, const std::string &type);
@@ -927,7 +937,17 @@ protected:
   CVideoInfoTag GetDetailsForMusicVideo(const dbiplus::sql_record* const record, int getDetails = VideoDbDetailsNone);
   bool GetPeopleNav(const std::string& strBaseDir, CFileItemList& items, const char *type, int idContent = -1, const Filter &filter = Filter(), bool countOnly = false);
   bool GetNavCommon(const std::string& strBaseDir, CFileItemList& items, const char *type, int idContent=-1, const Filter &filter = Filter(), bool countOnly = false);
+  /*! \brief List a genre, country, studio or tag node from the navsummary table.
+   \return false if the node is filtered or the summary can't be used, in which case the caller runs the full query.
+   */
+  bool GetNavSummary(const std::string& strBaseDir, CFileItemList& items, const char *type, int idContent, const Filter &filter);
+  void CreateNavSummaryTables();
+  void CreateNavSummaryTriggers();
+  /*! \brief Name of the cXX column holding the given VIDEODB_ID_* field */
+  static std::string ColumnName(int field);
   void GetCast(int media_id, const std::string &media_type, std::vector<SActorInfo> &cast);
+  void GetCastForItems(const std::string &media_type, const std::vector<int> &ids, std::map<int, std::vector<SActorInfo>> &cast);
+  void GetShowLinks(int idMovie, std::vector<std::string> &showLinks);
   void GetTags(int media_id, const std::string &media_type, std::vector<std::string> &tags);
   void GetRatings(int media_id, const std::string &media_type, RatingMap &ratings);
   void GetUniqueIDs(int media_id, const std::string &media_type, CVideoInfoTag& details);
@@ -50,6 +50,7 @@
 #include "Util.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
+#include "utils/LibraryChangeJournal.h"
 #include "utils/log.h"
 #include "utils/RegExp.h"
 #include "utils/StringUtils.h"
@@ -58,8 +59,12 @@
 #include "video/VideoLibraryQueue.h"
 #include "video/VideoThumbLoader.h"
 #include "VideoInfoDownloader.h"
+#include "VideoScanPrefetcher.h"
 #include "tags/VideoInfoTagLoaderFactory.h"
 
+#define PREFETCH_LISTINGS 16 // folders listed ahead of the scanner
+#define PREFETCH_LOOKUPS   8 // items of a folder looked up ahead of the scanner
+
 using namespace XFILE;
 using namespace ADDON;
 using namespace KODI::MESSAGING;
@@ -112,6 +117,13 @@ namespace VIDEO
 
       m_database.Open();
 
+      // commit the items added in groups rather than one transaction each
+      m_database.BeginBatch();
+
+      // list folders and look up items on other threads, the database is only written from here
+      m_prefetcher.reset(new CVideoScanPrefetcher(m_bStop, g_advancedSettings.m_videoScannerListingsPerHost,
+                                                  g_advancedSettings.m_videoScannerLookupsPerScraper));
+
       m_bCanInterrupt = true;
 
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Starting scan ..");
@@ -150,8 +162,16 @@ namespace VIDEO
           bCancelled = true;
       }
 
+      m_prefetcher.reset();
+      m_prefetchPaths.clear();
+      m_prefetchedPaths.clear();
+
+      m_database.EndBatch();
+
       if (!bCancelled)
       {
+        CLibraryChangeJournal::GetInstance().MarkScanned(m_strStartDir, m_journalPosition);
+
         if (m_bClean)
           CVideoLibraryQueue::GetInstance().CleanLibrary(m_pathsToClean, false, m_handle);
         else
@@ -188,11 +208,32 @@ namespace VIDEO
     m_pathsToScan.clear();
     m_pathsToClean.clear();
 
+    // anything changing from here on is picked up by the next scan
+    CLibraryChangeJournal &journal = CLibraryChangeJournal::GetInstance();
+    journal.UpdateSources();
+    m_journalPosition = journal.GetPosition();
+    m_useJournal = strDirectory.empty() && !scanAll;
+
     m_database.Open();
     if (strDirectory.empty())
     { // scan all paths in the database.  We do this by scanning all paths in the db, and crossing them off the list as
       // we go.
       m_database.GetPaths(m_pathsToScan);
+
+      // only look at the folders that changed where the change journal knows them all
+      if (m_useJournal)
+      {
+        size_t paths = m_pathsToScan.size();
+        for (std::set<std::string>::iterator it = m_pathsToScan.begin(); it != m_pathsToScan.end();)
+        {
+          if (IsUnchanged(*it))
+            it = m_pathsToScan.erase(it);
+          else
+            ++it;
+        }
+        CLog::Log(LOGDEBUG, "VideoInfoScanner: %u of %u paths left to scan after checking the change journal",
+                  static_cast<unsigned int>(m_pathsToScan.size()), static_cast<unsigned int>(paths));
+      }
     }
     else
     { // scan all the paths of this subtree that is in the database
@@ -249,6 +290,18 @@ namespace VIDEO
     if (it != m_pathsToScan.end())
       m_pathsToScan.erase(it);
 
+    if (IsUnchanged(strDirectory))
+    {
+      CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' as nothing changed below it", CURL::GetRedacted(strDirectory).c_str());
+      return true;
+    }
+
+    if (m_prefetcher)
+    {
+      m_prefetchedPaths.insert(strDirectory);
+      PrefetchListings();
+    }
+
     // load subfolder
     CFileItemList items;
     bool foundDirectly = false;
@@ -278,18 +331,20 @@ namespace VIDEO
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str).c_str(), info->Name().c_str()));
       }
 
-      std::string fastHash;
-      if (g_advancedSettings.m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
-        fastHash = GetFastHash(strDirectory, regexps);
+      m_database.GetPathHash(strDirectory, dbHash);
 
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
+      SPrefetchedListing listing;
+      if (!m_prefetcher || !m_prefetcher->TakeListing(strDirectory, false, listing))
+        GetListing(strDirectory, false, regexps, dbHash, listing);
+
+      std::string fastHash = listing.fastHash;
+      if (!listing.items)
       { // fast hashes match - no need to process anything
         hash = fastHash;
       }
       else
       { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
-                                 DIR_FLAG_DEFAULTS);
+        items.Assign(*listing.items);
         items.Stack();
 
         // check whether to re-use previously computed fast hash
@@ -327,8 +382,12 @@ namespace VIDEO
 
       if (foundDirectly && !settings.parent_name_root)
       {
-        CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
-                                 DIR_FLAG_DEFAULTS);
+        SPrefetchedListing listing;
+        if (m_prefetcher && m_prefetcher->TakeListing(strDirectory, false, listing) && listing.items)
+          items.Assign(*listing.items);
+        else
+          CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
+                                   DIR_FLAG_DEFAULTS);
         items.SetPath(strDirectory);
         GetPathHash(items, hash);
         bSkip = true;
@@ -347,6 +406,20 @@ namespace VIDEO
       }
     }
 
+    if (m_prefetcher && m_prefetcher->CanList())
+    {
+      // list the folders we're about to recurse into, or the shows we're about to enumerate,
+      // while the items of this one are looked up
+      for (int i = items.Size() - 1; i >= 0; --i)
+      {
+        const CFileItemPtr &pItem = items[i];
+        if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() && !IsUnchanged(pItem->GetPath()) &&
+            ((content == CONTENT_TVSHOWS && !bSkip) || (content != CONTENT_TVSHOWS && settings.recurse > 0)))
+          m_prefetchPaths.push_front(std::make_pair(pItem->GetPath(), true));
+      }
+      PrefetchListings();
+    }
+
     if (!bSkip)
     {
       if (RetrieveVideoInfo(items, settings.parent_name_root, content))
@@ -391,9 +464,63 @@ namespace VIDEO
         }
       }
     }
+
+    // nothing below this folder will be scanned again
+    if (m_prefetcher)
+      m_prefetcher->Forget(strDirectory);
     return !m_bStop;
   }
 
+  void CVideoInfoScanner::PrefetchListings()
+  {
+    if (!m_prefetcher || !m_prefetcher->CanList())
+      return;
+
+    // nothing is known about what follows the current folder, so try the next paths to scan
+    if (m_prefetchPaths.empty())
+    {
+      for (std::set<std::string>::const_iterator it = m_pathsToScan.begin();
+           it != m_pathsToScan.end() && m_prefetchPaths.size() < PREFETCH_LISTINGS; ++it)
+      {
+        if (m_prefetchedPaths.find(*it) == m_prefetchedPaths.end())
+          m_prefetchPaths.push_back(std::make_pair(*it, false));
+      }
+    }
+
+    while (!m_prefetchPaths.empty() && m_prefetcher->GetPendingListings() < PREFETCH_LISTINGS)
+    {
+      std::string path = m_prefetchPaths.front().first;
+      bool foundInScan = m_prefetchPaths.front().second;
+      m_prefetchPaths.pop_front();
+
+      if (!m_prefetchedPaths.insert(path).second || URIUtils::IsPlugin(path))
+        continue;
+      if (!foundInScan && m_pathsToScan.find(path) == m_pathsToScan.end())
+        continue;
+
+      SScanSettings settings;
+      bool foundDirectly = false;
+      ScraperPtr info = m_database.GetScraperForPath(path, settings, foundDirectly);
+      CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
+      if (content == CONTENT_NONE || (!m_scanAll && settings.noupdate))
+        continue;
+
+      const std::vector<std::string> &regexps = content == CONTENT_TVSHOWS ? g_advancedSettings.m_tvshowExcludeFromScanRegExps
+                                                                           : g_advancedSettings.m_moviesExcludeFromScanRegExps;
+      if (IsExcluded(path, regexps))
+        continue;
+
+      // shows are listed with all their seasons, the folders holding them on their own
+      bool recursive = content == CONTENT_TVSHOWS && (!foundDirectly || settings.parent_name_root);
+      if (recursive && !foundInScan && m_database.GetTvShowId(path) < 0)
+        continue;
+
+      std::string dbHash;
+      m_database.GetPathHash(path, dbHash);
+      m_prefetcher->PrefetchListing(path, recursive, regexps, dbHash);
+    }
+  }
+
   bool CVideoInfoScanner::RetrieveVideoInfo(CFileItemList& items, bool bDirNames, CONTENT_TYPE content, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress)
   {
     if (pDlgProgress)
@@ -411,12 +538,20 @@ namespace VIDEO
 
     m_database.Open();
 
+    // movies and music videos of the background scan are looked up ahead, a few at a time
+    bool prefetchLookups = m_prefetcher && m_prefetcher->CanLookup() && !pURL && !pDlgProgress &&
+                           (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS);
+    int nextLookup = 0;
+
     bool FoundSomeInfo = false;
     std::vector<int> seenPaths;
     for (int i = 0; i < (int)items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
 
+      if (prefetchLookups)
+        PrefetchLookups(items, nextLookup, i + PREFETCH_LOOKUPS, bDirNames, useLocal);
+
       // we do this since we may have a override per dir
       ScraperPtr info2 = m_database.GetScraperForPath(pItem->m_bIsFolder ? pItem->GetPath() : items.GetPath());
       if (!info2) // skip
@@ -433,8 +568,9 @@ namespace VIDEO
           m_handle->SetPercentage(i*100.f/items.Size());
       }
 
-      // clear our scraper cache
-      info2->ClearCache();
+      // clear our scraper cache, unless the lookup is done ahead and does it itself
+      if (!prefetchLookups || !m_prefetcher->HasLookup(pItem->GetPath()))
+        info2->ClearCache();
 
       INFO_RET ret = INFO_CANCELLED;
       if (info2->Content() == CONTENT_TVSHOWS)
@@ -634,6 +770,10 @@ namespace VIDEO
     if (m_handle)
       m_handle->SetText(pItem->GetMovieName(bDirNames));
 
+    SPrefetchedLookup lookup;
+    if (!pURL && m_prefetcher && m_prefetcher->TakeLookup(pItem->GetPath(), lookup))
+      return AddPrefetchedVideo(pItem, bDirNames, info2, useLocal, lookup);
+
     CInfoScanner::INFO_TYPE result = CInfoScanner::NO_NFO;
     CScraperUrl scrUrl;
     // handle .nfo files
@@ -713,6 +853,10 @@ namespace VIDEO
     if (m_handle)
       m_handle->SetText(pItem->GetMovieName(bDirNames));
 
+    SPrefetchedLookup lookup;
+    if (!pURL && m_prefetcher && m_prefetcher->TakeLookup(pItem->GetPath(), lookup))
+      return AddPrefetchedVideo(pItem, bDirNames, info2, useLocal, lookup);
+
     CInfoScanner::INFO_TYPE result = CInfoScanner::NO_NFO;
     CScraperUrl scrUrl;
     // handle .nfo files
@@ -771,6 +915,69 @@ namespace VIDEO
     return INFO_NOT_FOUND;
   }
 
+  CInfoScanner::INFO_RET
+  CVideoInfoScanner::AddPrefetchedVideo(CFileItem *pItem,
+                                        bool bDirNames,
+                                        const ScraperPtr &scraper,
+                                        bool useLocal,
+                                        const SPrefetchedLookup &lookup)
+  {
+    if (lookup.nfo == CInfoScanner::FULL_NFO)
+    {
+      *pItem->GetVideoInfoTag() = lookup.tag;
+      if (AddVideo(pItem, scraper->Content(), bDirNames, true) < 0)
+        return INFO_ERROR;
+      return INFO_ADDED;
+    }
+
+    // same handling of a failed search as in FindVideo()
+    if (lookup.found < 0 || (lookup.found == 0 && (m_bStop || !DownloadFailed(NULL))))
+    {
+      m_bStop = true;
+      return INFO_CANCELLED;
+    }
+    if (!lookup.hasUrl || !lookup.details)
+      return INFO_NOT_FOUND;
+
+    if (m_handle)
+      m_handle->SetText(lookup.tag.m_strTitle);
+
+    *pItem->GetVideoInfoTag() = lookup.tag;
+    if (AddVideo(pItem, scraper->Content(), bDirNames, useLocal) < 0)
+      return INFO_ERROR;
+    return INFO_ADDED;
+  }
+
+  void CVideoInfoScanner::PrefetchLookups(const CFileItemList &items, int &next, int end, bool bDirNames, bool useLocal)
+  {
+    if (next >= end || next >= items.Size())
+      return;
+
+    // the files of a folder share its scraper
+    ScraperPtr scraper = m_database.GetScraperForPath(items.GetPath());
+    if (!scraper || (scraper->Content() != CONTENT_MOVIES && scraper->Content() != CONTENT_MUSICVIDEOS))
+    {
+      next = items.Size();
+      return;
+    }
+    const std::vector<std::string> &regexps = g_advancedSettings.m_moviesExcludeFromScanRegExps;
+
+    for (; next < end && next < items.Size(); ++next)
+    {
+      const CFileItemPtr &pItem = items[next];
+      if (pItem->m_bIsFolder || !pItem->IsVideo() || pItem->IsNFO() ||
+         (pItem->IsPlayList() && !URIUtils::HasExtension(pItem->GetPath(), ".strm")))
+        continue;
+      if (IsExcluded(pItem->GetPath(), regexps))
+        continue;
+      if (scraper->Content() == CONTENT_MOVIES ? m_database.HasMovieInfo(pItem->GetPath())
+                                               : m_database.HasMusicVideoInfo(pItem->GetPath()))
+        continue;
+
+      m_prefetcher->PrefetchLookup(*pItem, bDirNames, scraper, useLocal);
+    }
+  }
+
   CInfoScanner::INFO_RET
   CVideoInfoScanner::RetrieveInfoForEpisodes(CFileItem *item,
                                              long showID,
@@ -809,6 +1016,7 @@ namespace VIDEO
 
       if (updateSeasonArt)
       {
+        m_database.FlushBatch();
         CVideoInfoDownloader loader(scraper);
         loader.GetArtwork(showInfo);
         GetSeasonThumbs(showInfo, seasonArt, CVideoThumbLoader::GetArtTypes(MediaTypeSeason), useLocal && !item->IsPlugin());
@@ -840,32 +1048,62 @@ namespace VIDEO
       if (it != m_pathsToScan.end())
         m_pathsToScan.erase(it);
 
+      if (IsUnchanged(item->GetPath()))
+      {
+        CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' as nothing changed below it", CURL::GetRedacted(item->GetPath()).c_str());
+        if (m_handle)
+          OnDirectoryScanned(item->GetPath());
+        return false;
+      }
+
+      if (m_prefetcher)
+      {
+        m_prefetchedPaths.insert(item->GetPath());
+        PrefetchListings();
+      }
+
       std::string hash, dbHash;
+      m_database.GetPathHash(item->GetPath(), dbHash);
       if (item->IsPlugin())
       {
         // if plugin has already calculated a hash for directory contents - use it
         // in this case we don't need to get directory listing from plugin for hash checking
         if (item->HasProperty("hash"))
           hash = item->GetProperty("hash").asString();
-      }
-      else if (g_advancedSettings.m_bVideoLibraryUseFastHash)
-        hash = GetRecursiveFastHash(item->GetPath(), regexps);
 
-      if (m_database.GetPathHash(item->GetPath(), dbHash) && !hash.empty() && dbHash == hash)
+        if (!hash.empty() && dbHash == hash)
+        {
+          // hashes match - no need to process anything
+          bSkip = true;
+        }
+        else
+        {
+          int flags = DIR_FLAG_DEFAULTS;
+          if (!hash.empty())
+            flags |= DIR_FLAG_NO_FILE_INFO;
+
+          CUtil::GetRecursiveListing(item->GetPath(), items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(), flags);
+        }
+      }
+      else
       {
-        // fast hashes match - no need to process anything
-        bSkip = true;
+        SPrefetchedListing listing;
+        if (!m_prefetcher || !m_prefetcher->TakeListing(item->GetPath(), true, listing))
+          GetListing(item->GetPath(), true, regexps, dbHash, listing);
+
+        hash = listing.fastHash;
+        if (listing.items)
+          items.Assign(*listing.items);
+        else
+        {
+          // fast hashes match - no need to process anything
+          bSkip = true;
+        }
       }
 
-      // fast hash cannot be computed or we need to rescan. fetch the listing.
+      // fast hash cannot be computed or we need to rescan
       if (!bSkip)
       {
-        int flags = DIR_FLAG_DEFAULTS;
-        if (!hash.empty())
-          flags |= DIR_FLAG_NO_FILE_INFO;
-
-        CUtil::GetRecursiveListing(item->GetPath(), items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(), flags);
-
         // fast hash failed - compute slow one
         if (hash.empty())
         {
@@ -1388,6 +1626,7 @@ namespace VIDEO
         m_database.AddBookMarkToFile(pItem->GetPath(), movieDetails.GetResumePoint(), CBookmark::RESUME);
     }
 
+    m_database.BatchItemDone();
     m_database.Close();
 
     CFileItemPtr itemCopy = CFileItemPtr(new CFileItem(*pItem));
@@ -1637,6 +1876,7 @@ namespace VIDEO
             pDlgProgress->Progress();
           }
 
+          m_database.FlushBatch();
           CVideoInfoDownloader imdb(scraper);
           if (!imdb.GetEpisodeList(url, episodes))
             return INFO_NOT_FOUND;
@@ -1735,6 +1975,7 @@ namespace VIDEO
 
       if (bFound)
       {
+        m_database.FlushBatch();
         CVideoInfoDownloader imdb(scraper);
         CFileItem item;
         item.SetPath(file->strPath);
@@ -1770,6 +2011,8 @@ namespace VIDEO
     if (m_handle && !url.strTitle.empty())
       m_handle->SetText(url.strTitle);
 
+    // don't hold the write lock while waiting on the scraper
+    m_database.FlushBatch();
     CVideoInfoDownloader imdb(scraper);
     bool ret = imdb.GetDetails(url, movieDetails, pDialog);
 
@@ -1849,8 +2092,13 @@ namespace VIDEO
     return true;
   }
 
+  bool CVideoInfoScanner::IsUnchanged(const std::string &path) const
+  {
+    return m_useJournal && CLibraryChangeJournal::GetInstance().IsUnchanged(path);
+  }
+
   std::string CVideoInfoScanner::GetFastHash(const std::string &directory,
-      const std::vector<std::string> &excludes) const
+      const std::vector<std::string> &excludes)
   {
     CDigest digest{CDigest::Type::MD5};
 
@@ -1872,8 +2120,36 @@ namespace VIDEO
     return "";
   }
 
+  void CVideoInfoScanner::GetListing(const std::string &path, bool recursive, const std::vector<std::string> &excludes,
+                                     const std::string &dbHash, SPrefetchedListing &listing)
+  {
+    listing.recursive = recursive;
+    listing.fastHash.clear();
+    if (g_advancedSettings.m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(path))
+      listing.fastHash = recursive ? GetRecursiveFastHash(path, excludes) : GetFastHash(path, excludes);
+
+    if (!listing.fastHash.empty() && StringUtils::EqualsNoCase(listing.fastHash, dbHash))
+    { // fast hashes match - no need to list anything
+      listing.items.reset();
+      return;
+    }
+
+    listing.items = std::make_shared<CFileItemList>();
+    if (recursive)
+    {
+      int flags = DIR_FLAG_DEFAULTS;
+      if (!listing.fastHash.empty())
+        flags |= DIR_FLAG_NO_FILE_INFO;
+
+      CUtil::GetRecursiveListing(path, *listing.items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(), flags);
+    }
+    else
+      CDirectory::GetDirectory(path, *listing.items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
+                               DIR_FLAG_DEFAULTS);
+  }
+
   std::string CVideoInfoScanner::GetRecursiveFastHash(const std::string &directory,
-      const std::vector<std::string> &excludes) const
+      const std::vector<std::string> &excludes)
   {
     CFileItemList items;
     items.Add(CFileItemPtr(new CFileItem(directory, true)));
@@ -2057,6 +2333,7 @@ namespace VIDEO
   int CVideoInfoScanner::FindVideo(const std::string &title, int year, const ScraperPtr &scraper, CScraperUrl &url, CGUIDialogProgress *progress)
   {
     MOVIELIST movielist;
+    m_database.FlushBatch();
     CVideoInfoDownloader imdb(scraper);
     int returncode = imdb.FindMovie(title, year, movielist, progress);
     if (returncode < 0 || (returncode == 0 && (m_bStop || !DownloadFailed(progress))))
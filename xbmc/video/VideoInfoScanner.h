@@ -19,8 +19,12 @@
  *
  */
 
+#include <stdint.h>
+#include <deque>
+#include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "InfoScanner.h"
@@ -34,6 +38,9 @@ class CFileItemList;
 namespace VIDEO
 {
   class IVideoInfoTagLoader;
+  class CVideoScanPrefetcher;
+  struct SPrefetchedListing;
+  struct SPrefetchedLookup;
 
   typedef struct SScanSettings
   {
@@ -113,6 +120,17 @@ namespace VIDEO
 
     bool EnumerateEpisodeItem(const CFileItem *item, EPISODELIST& episodeList);
 
+    /*! \brief Get the fast hash of a folder and list it unless the fast hash matches the database.
+     Doesn't touch the scanner, so that folders can be listed ahead of it on other threads.
+     \param path folder to list.
+     \param recursive whether to list the subfolders as well, as done for tv shows.
+     \param excludes exclude expressions, part of the fast hash.
+     \param dbHash hash stored in the database for the folder.
+     \param listing [out] the fast hash and, unless it matched, the listing.
+     */
+    static void GetListing(const std::string &path, bool recursive, const std::vector<std::string> &excludes,
+                           const std::string &dbHash, SPrefetchedListing &listing);
+
   protected:
     virtual void Process();
     bool DoScan(const std::string& strDirectory) override;
@@ -122,6 +140,27 @@ namespace VIDEO
     INFO_RET RetrieveInfoForMusicVideo(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForEpisodes(CFileItem *item, long showID, const ADDON::ScraperPtr &scraper, bool useLocal, CGUIDialogProgress *progress = NULL);
 
+    /*! \brief Add a movie or music video that was looked up ahead of the scanner.
+     \param pItem the video file.
+     \param bDirNames whether the folder name was used for the lookup.
+     \param scraper scraper the item was looked up with.
+     \param useLocal whether to use local information for artwork etc.
+     \param lookup result of the lookup.
+     */
+    INFO_RET AddPrefetchedVideo(CFileItem *pItem, bool bDirNames, const ADDON::ScraperPtr &scraper, bool useLocal, const SPrefetchedLookup &lookup);
+
+    /*! \brief Queue folders for listing ahead of the scanner, up to the lookahead limit.
+     Takes the folders from the ones found during the scan, or else from the paths still to scan.
+     */
+    void PrefetchListings();
+
+    /*! \brief Queue the lookups of the items following the given one in a folder.
+     \param items the folder listing being processed.
+     \param next [in/out] index of the next item to consider for a lookup.
+     \param end index up to which to queue lookups.
+     */
+    void PrefetchLookups(const CFileItemList &items, int &next, int end, bool bDirNames, bool useLocal);
+
     /*! \brief Update the progress bar with the heading and line and check for cancellation
      \param progress CGUIDialogProgress bar
      \param heading string id of heading
@@ -197,7 +236,7 @@ namespace VIDEO
      \param excludes string array of exclude expressions
      \return the md5 hash of the folder"
      */
-    std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes) const;
+    static std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes);
 
     /*! \brief Retrieve a "fast" hash of the given directory recursively (if available)
      Performs a stat() on the directory, and uses modified time to create a "fast"
@@ -209,7 +248,7 @@ namespace VIDEO
      \param excludes string array of exclude expressions
      \return the md5 hash of the folder
      */
-    std::string GetRecursiveFastHash(const std::string &directory, const std::vector<std::string> &excludes) const;
+    static std::string GetRecursiveFastHash(const std::string &directory, const std::vector<std::string> &excludes);
 
     /*! \brief Decide whether a folder listing could use the "fast" hash
      Fast hashing can be done whenever the folder contains no scannable subfolders, as the
@@ -221,6 +260,11 @@ namespace VIDEO
      */
     bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const;
 
+    /*! \brief Whether a folder can be skipped as the change journal has nothing for it.
+     Only during library updates, full scans and scans of a single folder walk everything.
+     */
+    bool IsUnchanged(const std::string &path) const;
+
     /*! \brief Process a series folder, filling in episode details and adding them to the database.
      @todo Ideally we would return INFO_HAVE_ALREADY if we don't have to update any episodes
      and we should return INFO_NOT_FOUND only if no information is found for any of
@@ -240,9 +284,15 @@ namespace VIDEO
     bool m_bStop;
     bool m_scanAll;
     std::string m_strStartDir;
+    bool m_useJournal = false;        ///< whether folders the change journal has nothing for are skipped
+    uint64_t m_journalPosition = 0;   ///< position in the change journal when the scan started
     CVideoDatabase m_database;
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
+
+    std::unique_ptr<CVideoScanPrefetcher> m_prefetcher;
+    std::deque<std::pair<std::string, bool>> m_prefetchPaths; ///< folders to list ahead, and whether they were found during the scan
+    std::set<std::string> m_prefetchedPaths;                  ///< folders scanned or queued for listing already
   };
 }
 
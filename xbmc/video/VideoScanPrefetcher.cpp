@@ -0,0 +1,273 @@
+/*
+ *      Copyright (C) 2005-2015 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "VideoScanPrefetcher.h"
+
+#include <set>
+#include <utility>
+
+#include "FileItem.h"
+#include "URL.h"
+#include "VideoInfoDownloader.h"
+#include "VideoInfoScanner.h"
+#include "tags/VideoInfoTagLoaderFactory.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/URIUtils.h"
+
+namespace VIDEO
+{
+  /*!
+   \brief Results of the jobs, waiting to be taken by the scanner.
+   Shared with the jobs so that a job finishing after the prefetcher is gone has somewhere to put its result.
+   */
+  struct CVideoScanPrefetcher::CResults
+  {
+    CCriticalSection section;
+    CEvent done;
+    std::set<std::string> pendingListings;
+    std::map<std::string, SPrefetchedListing> listings;
+    std::set<std::string> pendingLookups;
+    std::map<std::string, SPrefetchedLookup> lookups;
+  };
+
+  CVideoScanPrefetcher::CVideoScanPrefetcher(const bool &stop, unsigned int listingsPerHost, unsigned int lookupsPerScraper)
+    : m_results(std::make_shared<CResults>())
+    , m_stop(stop)
+    , m_listingsPerHost(listingsPerHost)
+    , m_lookupsPerScraper(lookupsPerScraper)
+  {
+  }
+
+  CVideoScanPrefetcher::~CVideoScanPrefetcher()
+  {
+    for (auto &it : m_listingQueues)
+      it.second->CancelJobs();
+    for (auto &it : m_lookupQueues)
+      it.second->CancelJobs();
+  }
+
+  CJobQueue& CVideoScanPrefetcher::GetQueue(QueueMap &queues, const std::string &key, unsigned int jobsAtOnce)
+  {
+    auto it = queues.find(key);
+    if (it == queues.end())
+      it = queues.insert(std::make_pair(key, std::unique_ptr<CJobQueue>(new CJobQueue(false, jobsAtOnce, CJob::PRIORITY_LOW)))).first;
+    return *it->second;
+  }
+
+  void CVideoScanPrefetcher::PrefetchListing(const std::string &path, bool recursive, const std::vector<std::string> &excludes, const std::string &dbHash)
+  {
+    if (!CanList())
+      return;
+
+    {
+      CSingleLock lock(m_results->section);
+      if (m_results->listings.find(path) != m_results->listings.end() ||
+          !m_results->pendingListings.insert(path).second)
+        return;
+    }
+
+    CURL url(path);
+    std::string host = url.GetProtocol() + "://" + url.GetHostName();
+
+    std::shared_ptr<CResults> results = m_results;
+    GetQueue(m_listingQueues, host, m_listingsPerHost).Submit([results, path, recursive, excludes, dbHash]()
+    {
+      SPrefetchedListing listing;
+      CVideoInfoScanner::GetListing(path, recursive, excludes, dbHash, listing);
+
+      CSingleLock lock(results->section);
+      // the folder is no longer pending if it was forgotten in the meantime
+      if (results->pendingListings.erase(path))
+        results->listings[path] = std::move(listing);
+      results->done.Set();
+    });
+  }
+
+  bool CVideoScanPrefetcher::TakeListing(const std::string &path, bool recursive, SPrefetchedListing &listing)
+  {
+    CSingleLock lock(m_results->section);
+    while (m_results->pendingListings.find(path) != m_results->pendingListings.end() && !m_stop)
+    {
+      m_results->done.Reset();
+      CSingleExit exit(m_results->section);
+      m_results->done.WaitMSec(100);
+    }
+
+    auto it = m_results->listings.find(path);
+    if (it == m_results->listings.end())
+      return false;
+
+    bool found = it->second.recursive == recursive;
+    if (found)
+      listing = std::move(it->second);
+    m_results->listings.erase(it);
+    return found;
+  }
+
+  unsigned int CVideoScanPrefetcher::GetPendingListings() const
+  {
+    CSingleLock lock(m_results->section);
+    return m_results->pendingListings.size() + m_results->listings.size();
+  }
+
+  void CVideoScanPrefetcher::PrefetchLookup(const CFileItem &item, bool bDirNames, const ADDON::ScraperPtr &scraper, bool useLocal)
+  {
+    if (!CanLookup() || !scraper)
+      return;
+
+    std::string path = item.GetPath();
+    {
+      CSingleLock lock(m_results->section);
+      if (m_results->lookups.find(path) != m_results->lookups.end() ||
+          !m_results->pendingLookups.insert(path).second)
+        return;
+    }
+
+    // xml scrapers keep the state of a lookup in their parser
+    unsigned int jobsAtOnce = scraper->IsPython() ? m_lookupsPerScraper : 1;
+
+    std::shared_ptr<CResults> results = m_results;
+    CFileItemPtr lookupItem(new CFileItem(item));
+    GetQueue(m_lookupQueues, scraper->ID(), jobsAtOnce).Submit([results, path, lookupItem, bDirNames, scraper, useLocal]()
+    {
+      SPrefetchedLookup lookup;
+      Lookup(*lookupItem, bDirNames, scraper, useLocal, lookup);
+
+      CSingleLock lock(results->section);
+      if (results->pendingLookups.erase(path))
+        results->lookups[path] = std::move(lookup);
+      results->done.Set();
+    });
+  }
+
+  bool CVideoScanPrefetcher::TakeLookup(const std::string &path, SPrefetchedLookup &lookup)
+  {
+    CSingleLock lock(m_results->section);
+    while (m_results->pendingLookups.find(path) != m_results->pendingLookups.end() && !m_stop)
+    {
+      m_results->done.Reset();
+      CSingleExit exit(m_results->section);
+      m_results->done.WaitMSec(100);
+    }
+
+    auto it = m_results->lookups.find(path);
+    if (it == m_results->lookups.end())
+      return false;
+
+    lookup = std::move(it->second);
+    m_results->lookups.erase(it);
+    return true;
+  }
+
+  bool CVideoScanPrefetcher::HasLookup(const std::string &path) const
+  {
+    CSingleLock lock(m_results->section);
+    return m_results->pendingLookups.find(path) != m_results->pendingLookups.end() ||
+           m_results->lookups.find(path) != m_results->lookups.end();
+  }
+
+  void CVideoScanPrefetcher::Forget(const std::string &path)
+  {
+    CSingleLock lock(m_results->section);
+    for (auto it = m_results->pendingListings.begin(); it != m_results->pendingListings.end();)
+    {
+      if (URIUtils::PathHasParent(*it, path))
+        it = m_results->pendingListings.erase(it);
+      else
+        ++it;
+    }
+    for (auto it = m_results->listings.begin(); it != m_results->listings.end();)
+    {
+      if (URIUtils::PathHasParent(it->first, path))
+        it = m_results->listings.erase(it);
+      else
+        ++it;
+    }
+    for (auto it = m_results->pendingLookups.begin(); it != m_results->pendingLookups.end();)
+    {
+      if (URIUtils::PathHasParent(*it, path))
+        it = m_results->pendingLookups.erase(it);
+      else
+        ++it;
+    }
+    for (auto it = m_results->lookups.begin(); it != m_results->lookups.end();)
+    {
+      if (URIUtils::PathHasParent(it->first, path))
+        it = m_results->lookups.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  void CVideoScanPrefetcher::Lookup(CFileItem &item, bool bDirNames, const ADDON::ScraperPtr &scraper, bool useLocal, SPrefetchedLookup &lookup)
+  {
+    // same steps as CVideoInfoScanner::RetrieveInfoForMovie, minus the database
+    scraper->ClearCache();
+
+    std::unique_ptr<IVideoInfoTagLoader> loader;
+    if (useLocal)
+    {
+      loader.reset(CVideoInfoTagLoaderFactory::CreateLoader(item, scraper, bDirNames));
+      if (loader)
+      {
+        item.GetVideoInfoTag()->Reset();
+        lookup.nfo = loader->Load(*item.GetVideoInfoTag(), false);
+      }
+    }
+    if (lookup.nfo == CInfoScanner::FULL_NFO)
+    {
+      lookup.tag = *item.GetVideoInfoTag();
+      return;
+    }
+
+    CScraperUrl url;
+    if (lookup.nfo == CInfoScanner::URL_NFO || lookup.nfo == CInfoScanner::COMBINED_NFO)
+      url = loader->ScraperUrl();
+
+    if (url.m_url.empty())
+    {
+      std::string movieTitle = item.GetMovieName(bDirNames);
+      int movieYear = -1; // hint that movie title was not found
+      if (lookup.nfo == CInfoScanner::TITLE_NFO)
+      {
+        movieTitle = item.GetVideoInfoTag()->GetTitle();
+        movieYear = item.GetVideoInfoTag()->GetYear();
+      }
+
+      MOVIELIST movielist;
+      CVideoInfoDownloader imdb(scraper);
+      lookup.found = imdb.FindMovie(movieTitle, movieYear, movielist);
+      if (lookup.found <= 0 || movielist.empty())
+        return;
+      url = movielist[0];
+    }
+    lookup.hasUrl = true;
+
+    CVideoInfoDownloader imdb(scraper);
+    if (imdb.GetDetails(url, lookup.tag))
+    {
+      if (loader && (lookup.nfo == CInfoScanner::COMBINED_NFO || lookup.nfo == CInfoScanner::OVERRIDE_NFO))
+        loader->Load(lookup.tag, true);
+      lookup.details = true;
+    }
+  }
+}
@@ -0,0 +1,136 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2015 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "InfoScanner.h"
+#include "VideoInfoTag.h"
+#include "addons/Scraper.h"
+
+class CFileItem;
+class CFileItemList;
+class CJobQueue;
+
+namespace VIDEO
+{
+  /*!
+   \brief A folder listed ahead of the scanner.
+   */
+  struct SPrefetchedListing
+  {
+    bool recursive = false;                 ///< whether the subfolders were listed as well
+    std::string fastHash;                   ///< fast hash of the folder, empty if it couldn't be computed
+    std::shared_ptr<CFileItemList> items;   ///< the listing, null if the fast hash matched the database
+  };
+
+  /*!
+   \brief An item looked up ahead of the scanner.
+   */
+  struct SPrefetchedLookup
+  {
+    CInfoScanner::INFO_TYPE nfo = CInfoScanner::NO_NFO; ///< result of reading the local nfo
+    int found = 1;          ///< result of the scraper search, >0 on success, <0 on a scraper error, 0 on other errors
+    bool hasUrl = false;    ///< whether the nfo or the search gave a url to get the details from
+    bool details = false;   ///< whether the details were retrieved
+    CVideoInfoTag tag;      ///< the details, or the nfo contents for a full nfo
+  };
+
+  /*!
+   \brief Lists folders and looks up items on the job manager while the scanner works on earlier ones.
+
+   Listings are limited per host so that a NAS isn't swamped, lookups are limited per scraper.
+   The scanner thread stays the only one that writes to the database; it takes the results
+   in its own order and does the work itself for anything that wasn't prefetched.
+   */
+  class CVideoScanPrefetcher
+  {
+  public:
+    /*!
+     \param stop flag of the scanner, waiting for a result is given up once it is set.
+     \param listingsPerHost folders listed at once per host, 0 to not list ahead.
+     \param lookupsPerScraper items looked up at once per scraper, 0 to not look up ahead.
+       Lookups with xml scrapers are always done one at a time.
+     */
+    CVideoScanPrefetcher(const bool &stop, unsigned int listingsPerHost, unsigned int lookupsPerScraper);
+    ~CVideoScanPrefetcher();
+
+    bool CanList() const { return m_listingsPerHost > 0; }
+    bool CanLookup() const { return m_lookupsPerScraper > 0; }
+
+    /*! \brief Queue the listing of a folder.
+     \param path the folder.
+     \param recursive whether to list the subfolders as well, as done for tv shows.
+     \param excludes exclude expressions, part of the fast hash.
+     \param dbHash hash stored for the folder, it isn't listed if its fast hash matches.
+     */
+    void PrefetchListing(const std::string &path, bool recursive, const std::vector<std::string> &excludes, const std::string &dbHash);
+
+    /*! \brief Take the listing of a folder, waiting for it if it is being listed.
+     \return true if the folder was listed ahead in the same way, false if the caller has to list it.
+     */
+    bool TakeListing(const std::string &path, bool recursive, SPrefetchedListing &listing);
+
+    /*! \brief Number of listings queued or not taken yet.
+     */
+    unsigned int GetPendingListings() const;
+
+    /*! \brief Queue the lookup of a movie or music video.
+     \param item the video file.
+     \param bDirNames whether the folder name is used for the lookup.
+     \param scraper scraper to look the item up with.
+     \param useLocal whether a local nfo is used.
+     */
+    void PrefetchLookup(const CFileItem &item, bool bDirNames, const ADDON::ScraperPtr &scraper, bool useLocal);
+
+    /*! \brief Take the lookup of an item, waiting for it if it is being looked up.
+     \return true if the item was looked up ahead, false if the caller has to look it up.
+     */
+    bool TakeLookup(const std::string &path, SPrefetchedLookup &lookup);
+
+    /*! \brief Whether the lookup of an item was queued and not taken yet.
+     */
+    bool HasLookup(const std::string &path) const;
+
+    /*! \brief Drop the results for a folder and everything below it that weren't taken.
+     */
+    void Forget(const std::string &path);
+
+  private:
+    CVideoScanPrefetcher(const CVideoScanPrefetcher&) = delete;
+    CVideoScanPrefetcher& operator=(const CVideoScanPrefetcher&) = delete;
+
+    typedef std::map<std::string, std::unique_ptr<CJobQueue>> QueueMap;
+    CJobQueue& GetQueue(QueueMap &queues, const std::string &key, unsigned int jobsAtOnce);
+
+    static void Lookup(CFileItem &item, bool bDirNames, const ADDON::ScraperPtr &scraper, bool useLocal, SPrefetchedLookup &lookup);
+
+    struct CResults;
+    std::shared_ptr<CResults> m_results;   ///< shared with the jobs, which may outlive us
+    const bool &m_stop;
+    unsigned int m_listingsPerHost;
+    unsigned int m_lookupsPerScraper;
+    QueueMap m_listingQueues;   ///< by protocol and host
+    QueueMap m_lookupQueues;    ///< by scraper
+  };
+}
@@ -23,6 +23,7 @@
 #include "OSScreenSaver.h"
 #include "VideoSync.h"
 #include "WinEvents.h"
+#include "guilib/DirtyRegion.h"
 #include "guilib/DispResource.h"
 #include "Resolution.h"
 #include <memory>
@@ -154,6 +155,14 @@ public:
   // Access render system interface
   CGraphicContext& GetGfxContext();
 
+  /*! \brief Prepare the back buffer for a frame that only redraws the given regions.
+   Window systems that don't preserve the back buffer across swaps may grow the
+   list to cover whatever is stale in the buffer, and can tell the driver which
+   parts of the frame are going to change.
+   \param dirtyRegions the regions about to be redrawn, in screen coordinates.
+   */
+  virtual void SetDamagedRegions(CDirtyRegionList& dirtyRegions) {}
+
 protected:
   void UpdateDesktopResolution(RESOLUTION_INFO& newRes, int screen, int width, int height, float refreshRate, uint32_t dwFlags = 0);
   virtual std::unique_ptr<KODI::WINDOWING::IOSScreenSaver> GetOSScreenSaverImpl() { return nullptr; }
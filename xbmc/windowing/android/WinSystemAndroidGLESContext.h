@@ -40,6 +40,7 @@ public:
 
   bool ResizeWindow(int newWidth, int newHeight, int newLeft, int newTop) override;
   bool SetFullScreen(bool fullScreen, RESOLUTION_INFO& res, bool blankOtherDisplays) override;
+  void SetDamagedRegions(CDirtyRegionList& dirtyRegions) override { m_pGLContext.SetDamagedRegions(dirtyRegions); }
 
   virtual std::unique_ptr<CVideoSync> GetVideoSync(void *clock) override;
 
@@ -42,6 +42,7 @@ public:
                        RESOLUTION_INFO& res) override;
 
   bool SetFullScreen(bool fullScreen, RESOLUTION_INFO& res, bool blankOtherDisplays) override;
+  void SetDamagedRegions(CDirtyRegionList& dirtyRegions) override { m_pGLContext.SetDamagedRegions(dirtyRegions); }
   void PresentRender(bool rendered, bool videoLayer) override;
   EGLDisplay GetEGLDisplay() const;
   EGLSurface GetEGLSurface() const;
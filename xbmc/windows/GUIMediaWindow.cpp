@@ -62,6 +62,7 @@
 #include "settings/Settings.h"
 #include "storage/MediaManager.h"
 #include "threads/IRunnable.h"
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "utils/FileUtils.h"
 #include "utils/LabelFormatter.h"
@@ -346,6 +347,13 @@ bool CGUIMediaWindow::OnMessage(CGUIMessage& message)
     }
     break;
 
+  case GUI_MSG_DIRECTORY_ITEMS:
+    {
+      ShowDirectoryItems();
+      return true;
+    }
+    break;
+
   case GUI_MSG_NOTIFY_ALL:
     { // Message is received even if this window is inactive
       if (message.GetParam1() == GUI_MSG_WINDOW_RESET)
@@ -415,6 +423,7 @@ bool CGUIMediaWindow::OnMessage(CGUIMessage& message)
 
           CFileItemList list(message.GetStringParam());
           list.RemoveDiscCache(GetID());
+          XFILE::CPluginDirectory::ClearCachedListings(message.GetStringParam());
           Update(message.GetStringParam());
         }
         else
@@ -730,7 +739,7 @@ bool CGUIMediaWindow::GetDirectory(const std::string &strDirectory, CFileItemLis
   CFileItemList cachedItems(strDirectory);
   if (!strDirectory.empty() && cachedItems.Load(GetID()))
   {
-    items.Assign(cachedItems);
+    items.Assign(std::move(cachedItems));
   }
   else
   {
@@ -744,7 +753,7 @@ bool CGUIMediaWindow::GetDirectory(const std::string &strDirectory, CFileItemLis
       return false;
     
     // assign fetched directory items
-    items.Assign(dirItems);
+    items.Assign(std::move(dirItems));
 
     // took over a second, and not normally cached, so cache it
     if ((XbmcThreads::SystemClockMillis() - time) > 1000  && items.CacheToDiscIfSlow())
@@ -942,7 +951,10 @@ bool CGUIMediaWindow::Refresh(bool clearCache /* = false */)
     return false;
 
   if (clearCache)
+  {
     m_vecItems->RemoveDiscCache(GetID());
+    XFILE::CPluginDirectory::ClearCachedListings(strCurrentDirectory);
+  }
 
   bool ret = true;
 
@@ -2197,6 +2209,15 @@ bool CGUIMediaWindow::GetDirectoryItems(CURL &url, CFileItemList &items, bool us
     bool ret = true;
     CGetDirectoryItems getItems(m_rootDir, url, items, useDir);
 
+    // show the items as they are read
+    {
+      CSingleLock lock(m_directoryItemsLock);
+      m_directoryItems.reset(new CFileItemList);
+      m_directoryItemsActive = true;
+    }
+    m_previewItems.reset(new CFileItemList(url.Get()));
+    m_rootDir.SetItemsCallback(this);
+
     if (!WaitGetDirectoryItems(getItems))
     {
       // cancelled
@@ -2214,6 +2235,17 @@ bool CGUIMediaWindow::GetDirectoryItems(CURL &url, CFileItemList &items, bool us
       }
     }
 
+    m_rootDir.SetItemsCallback(nullptr);
+    {
+      CSingleLock lock(m_directoryItemsLock);
+      m_directoryItemsActive = false;
+      m_directoryItems.reset();
+    }
+    // Update() binds the complete listing, until then the previous one is shown again
+    if (!m_previewItems->IsEmpty())
+      m_viewControl.SetItems(*m_vecItems);
+    m_previewItems.reset();
+
     m_updateJobActive = false;
     m_rootDir.ReleaseDirImpl();
     return ret;
@@ -2224,6 +2256,49 @@ bool CGUIMediaWindow::GetDirectoryItems(CURL &url, CFileItemList &items, bool us
   }
 }
 
+void CGUIMediaWindow::OnDirectoryItems(const CFileItemList &items)
+{
+  CSingleLock lock(m_directoryItemsLock);
+  if (!m_directoryItemsActive)
+    return;
+
+  // the window picks them up while it waits for the directory, once per frame at most
+  bool notify = m_directoryItems->IsEmpty();
+  m_directoryItems->Append(items);
+  if (notify)
+  {
+    CGUIMessage msg(GUI_MSG_DIRECTORY_ITEMS, GetID(), 0);
+    CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(msg, GetID());
+  }
+}
+
+void CGUIMediaWindow::ShowDirectoryItems()
+{
+  CFileItemList items;
+  {
+    CSingleLock lock(m_directoryItemsLock);
+    if (!m_directoryItemsActive || !m_previewItems)
+      return;
+    items.Append(*m_directoryItems);
+    m_directoryItems->Clear();
+  }
+  if (items.IsEmpty())
+    return;
+
+  bool first = m_previewItems->IsEmpty();
+  items.FillInDefaultIcons();
+  m_previewItems->Append(items);
+
+  // sort all items read so far, so the first page is already in order
+  std::unique_ptr<CGUIViewState> viewState(CGUIViewState::GetViewState(GetID(), *m_previewItems));
+  if (viewState)
+    m_previewItems->Sort(viewState->GetSortMethod());
+
+  m_viewControl.SetItems(*m_previewItems);
+  if (first)
+    m_viewControl.SetSelectedItem(0);
+}
+
 bool CGUIMediaWindow::WaitGetDirectoryItems(CGetDirectoryItems &items)
 {
   bool ret = true;
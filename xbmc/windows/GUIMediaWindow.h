@@ -25,9 +25,11 @@
 #include "filesystem/VirtualDirectory.h"
 #include "guilib/GUIWindow.h"
 #include "playlists/SmartPlayList.h"
+#include "threads/CriticalSection.h"
 #include "view/GUIViewControl.h"
 
 #include <atomic>
+#include <memory>
 
 class CFileItemList;
 class CGUIViewState;
@@ -37,7 +39,7 @@ class CGetDirectoryItems;
 }
 
 // base class for all media windows
-class CGUIMediaWindow : public CGUIWindow
+class CGUIMediaWindow : public CGUIWindow, public XFILE::IDirectoryItemsCallback
 {
 public:
   CGUIMediaWindow(int id, const char *xmlFile);
@@ -174,6 +176,15 @@ protected:
   bool GetDirectoryItems(CURL &url, CFileItemList &items, bool useDir);
   bool WaitGetDirectoryItems(CGetDirectoryItems &items);
 
+  /*! \brief Collects the items of the directory read in the background, see ShowDirectoryItems
+   \param items the next items of the directory
+   */
+  void OnDirectoryItems(const CFileItemList &items) override;
+
+  /*! \brief Shows the items collected so far, sorted like the directory will be, until reading it finished
+   */
+  void ShowDirectoryItems();
+
   /*! \brief Translate the folder to start in from the given quick path
    \param url the folder the user wants
    \return the resulting path */
@@ -235,4 +246,9 @@ protected:
    */
   std::string m_strFilterPath;
   bool m_backgroundLoad = false;
+
+  CCriticalSection m_directoryItemsLock;
+  bool m_directoryItemsActive = false;
+  std::unique_ptr<CFileItemList> m_directoryItems; ///< \brief items read in the background, not shown yet
+  std::unique_ptr<CFileItemList> m_previewItems; ///< \brief items shown while the directory is read
 };
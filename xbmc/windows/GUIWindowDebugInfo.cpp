@@ -20,9 +20,12 @@
 
 #include "GUIWindowDebugInfo.h"
 #include "settings/AdvancedSettings.h"
+#include "addons/AddonResourceUsage.h"
 #include "addons/Skin.h"
 #include "utils/CPUInfo.h"
 #include "utils/log.h"
+#include "utils/MemoryBudget.h"
+#include "utils/Metrics.h"
 #include "CompileInfo.h"
 #include "filesystem/SpecialProtocol.h"
 #include "input/WindowTranslator.h"
@@ -41,6 +44,64 @@
 #include "platform/linux/XMemUtils.h"
 #endif
 
+#include <algorithm>
+#include <vector>
+
+#define DEBUG_INFO_ADDONS 3
+
+namespace
+{
+// the add-ons that used the most CPU time so far
+std::string GetAddonUsage()
+{
+  std::map<std::string, ADDON::AddonResourceUsage> all = ADDON::CAddonResourceUsage::GetAll();
+  std::vector<std::pair<int64_t, std::string>> addons;
+  for (std::map<std::string, ADDON::AddonResourceUsage>::const_iterator it = all.begin(); it != all.end(); ++it)
+  {
+    if (it->second.cpuTime > 0)
+      addons.push_back(std::make_pair(it->second.cpuTime, it->first));
+  }
+  std::sort(addons.rbegin(), addons.rend());
+
+  std::string usage;
+  for (size_t i = 0; i < addons.size() && i < DEBUG_INFO_ADDONS; i++)
+  {
+    if (!usage.empty())
+      usage += ", ";
+    usage += StringUtils::Format("%s %.1fs", addons[i].second.c_str(), addons[i].first / 1000000.0);
+  }
+  return usage;
+}
+
+// the memory of the caches that give it back under memory pressure
+std::string GetCacheUsage()
+{
+  std::string usage;
+  for (const auto &cache : CMemoryBudget::GetInstance().GetStatus())
+  {
+    if (!usage.empty())
+      usage += ", ";
+    usage += StringUtils::Format("%s %zu KB", cache.name.c_str(), cache.usage / 1024);
+  }
+  return usage;
+}
+
+// the metrics that tell why playback or the GUI stutter
+std::string GetMetrics()
+{
+  const CMetrics &metrics = CMetrics::GetInstance();
+  double frameTime = 0.0, droppedFrames = 0.0, jobsQueued = 0.0, queryTime = 0.0, textureHits = 0.0;
+  metrics.GetValue("kodi_gui_frame_time_ms.p95", frameTime);
+  metrics.GetValue("kodi_video_dropped_frames_total", droppedFrames);
+  metrics.GetValue("kodi_jobs_queued", jobsQueued);
+  metrics.GetValue("kodi_database_query_time_ms.p95", queryTime);
+  metrics.GetValue("kodi_texture_cache_hit_ratio", textureHits);
+
+  return StringUtils::Format("frame p95 %.1f ms - dropped %.0f - jobs %.0f - db p95 %.1f ms - textures %.0f%%",
+                             frameTime, droppedFrames, jobsQueued, queryTime, textureHits * 100);
+}
+}
+
 CGUIWindowDebugInfo::CGUIWindowDebugInfo(void)
   : CGUIDialog(WINDOW_DEBUG_INFO, "", DialogModalityType::MODELESS)
 {
@@ -124,6 +185,21 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
                                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetSystemInfoProvider().GetFPS(),
                                 strCores.c_str(), ucAppName.c_str(), dCPU, profiling.c_str());
 #endif
+
+    // reading the thread clocks of running scripts is not free, refresh once a second
+    if (currentTime - m_addonUsageTime >= 1000)
+    {
+      m_addonUsage = GetAddonUsage();
+      m_cacheUsage = GetCacheUsage();
+      m_metrics = GetMetrics();
+      m_addonUsageTime = currentTime;
+    }
+    if (!m_addonUsage.empty())
+      info += "\nADDONS: " + m_addonUsage;
+    if (!m_cacheUsage.empty())
+      info += "\nCACHES: " + m_cacheUsage;
+    if (!m_metrics.empty())
+      info += "\nPERF: " + m_metrics;
   }
 
   // render the skin debug info
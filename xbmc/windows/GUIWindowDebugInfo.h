@@ -21,6 +21,9 @@
  */
 
 #include "guilib/GUIDialog.h"
+
+#include <string>
+
 #ifdef TARGET_POSIX
 #include "platform/linux/LinuxResourceCounter.h"
 #endif
@@ -40,6 +43,10 @@ protected:
   void UpdateVisibility() override;
 private:
   CGUITextLayout *m_layout;
+  std::string m_addonUsage;
+  std::string m_cacheUsage;
+  std::string m_metrics;
+  unsigned int m_addonUsageTime = 0;
 #ifdef TARGET_POSIX
   CLinuxResourceCounter m_resourceCounter;
 #endif